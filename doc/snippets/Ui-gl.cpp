@@ -24,9 +24,14 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
 #include <Magnum/GL/Framebuffer.h>
 #include <Magnum/GL/DefaultFramebuffer.h>
 #include <Magnum/GL/Renderer.h>
+#include <Magnum/Math/Vector3.h>
 
 #include "Magnum/Ui/BaseLayerGL.h"
 #include "Magnum/Ui/BaseLayerAnimator.h"
@@ -35,6 +40,7 @@
 #include "Magnum/Ui/Style.h"
 #include "Magnum/Ui/TextLayerGL.h"
 #include "Magnum/Ui/TextLayerAnimator.h"
+#include "Magnum/Ui/TextureAtlasGL.h"
 #include "Magnum/Ui/UserInterfaceGL.h"
 
 #define DOXYGEN_ELLIPSIS(...) __VA_ARGS__
@@ -110,6 +116,30 @@ textLayer.assignAnimator(animator);
 /* [TextLayerStyleAnimator-setup2] */
 }
 
+{
+Ui::AbstractUserInterface ui{{100, 100}};
+Ui::BaseLayerGL::Shared baseLayerShared{
+    Ui::BaseLayer::Shared::Configuration{1}
+        .addFlags(Ui::BaseLayerSharedFlag::Textured)
+};
+Ui::NodeHandle node{};
+ImageView2D thumbnail{PixelFormat::RGBA8Unorm, {}};
+/* [TextureAtlasGL] */
+Ui::TextureAtlasGL atlas{PixelFormat::RGBA8Unorm, {1024, 1024, 4}};
+
+Ui::BaseLayerGL& layer = ui.setLayerInstance(
+    Containers::pointer<Ui::BaseLayerGL>(ui.createLayer(), baseLayerShared));
+layer.setTexture(atlas.texture());
+
+/* Add images as they get loaded, and draw them all with the same layer */
+Ui::DataHandle data = layer.create(DOXYGEN_ELLIPSIS(0), node);
+if(Containers::Optional<Containers::Pair<Vector3, Vector2>> coordinates =
+    atlas.add(thumbnail))
+    layer.setTextureCoordinates(data, coordinates->first(),
+                                      coordinates->second());
+/* [TextureAtlasGL] */
+}
+
 {
 /* [RendererGL] */
 GL::Renderer::setBlendFunction(
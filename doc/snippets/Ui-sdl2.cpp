@@ -129,3 +129,35 @@ void MyApplication::textInputEvent(TextInputEvent& event) {
 }
 
 /* [AbstractUserInterface-application-events] */
+
+struct MyLatchingApplication: Platform::Application {
+    explicit MyLatchingApplication(const Arguments& arguments);
+    void drawEvent() override;
+    void pointerMoveEvent(PointerMoveEvent& event) override;
+    Ui::AbstractUserInterface _ui;
+};
+
+/* [AbstractUserInterface-application-latching] */
+MyLatchingApplication::MyLatchingApplication(const Arguments& arguments): DOXYGEN_ELLIPSIS(Platform::Application{arguments}, _ui{DOXYGEN_IGNORE({}, {}, {})}) {
+    DOXYGEN_ELLIPSIS()
+
+    _ui.setPointerMoveEventCoalescingEnabled(true);
+}
+
+void MyLatchingApplication::pointerMoveEvent(PointerMoveEvent& event) {
+    _ui.pointerMoveEvent(event);
+    if(_ui.state())
+        redraw();
+}
+
+void MyLatchingApplication::drawEvent() {
+    DOXYGEN_ELLIPSIS()
+
+    /* Dispatches the latest queued move, updates and draws */
+    _ui.draw();
+
+    swapBuffers();
+    if(_ui.state())
+        redraw();
+}
+/* [AbstractUserInterface-application-latching] */
@@ -59,6 +59,7 @@ cmake .. \
     -DMAGNUM_WITH_PLAYER=$BUILD_APPLICATIONS \
     -DMAGNUM_WITH_UI=ON \
     -DMAGNUM_WITH_UI_GALLERY=$BUILD_APPLICATIONS \
+    -DMAGNUM_UI_LARGE_HANDLES=$UI_LARGE_HANDLES \
     -DMAGNUM_BUILD_TESTS=ON \
     -DMAGNUM_BUILD_GL_TESTS=ON \
     -DMAGNUM_BUILD_STATIC=$BUILD_STATIC \
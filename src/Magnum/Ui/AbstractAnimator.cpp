@@ -37,6 +37,8 @@
 
 #include "Magnum/Ui/AbstractLayer.h"
 #include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/MemoryUsage.h"
+#include "Magnum/Ui/Implementation/memoryUsage.h"
 
 namespace Magnum { namespace Ui {
 
@@ -91,6 +93,7 @@ Debug& operator<<(Debug& debug, const AnimationFlag value) {
         /* LCOV_EXCL_START */
         #define _c(value) case AnimationFlag::value: return debug << "::" #value;
         _c(KeepOncePlayed)
+        _c(SkipWhenInvisible)
         #undef _c
         /* LCOV_EXCL_STOP */
     }
@@ -100,7 +103,8 @@ Debug& operator<<(Debug& debug, const AnimationFlag value) {
 
 Debug& operator<<(Debug& debug, const AnimationFlags value) {
     return Containers::enumSetDebugOutput(debug, value, "Ui::AnimationFlags{}", {
-        AnimationFlag::KeepOncePlayed
+        AnimationFlag::KeepOncePlayed,
+        AnimationFlag::SkipWhenInvisible
     });
 }
 
@@ -149,6 +153,14 @@ Debug& operator<<(Debug& debug, const NodeAnimations value) {
 
 namespace {
 
+enum: UnsignedByte {
+    /* The animation is in State::updateList */
+    AnimationScheduleListed = 1 << 0,
+    /* The animation is Scheduled or Paused and not in State::updateList, and
+       is counted in State::idleCount */
+    AnimationScheduleIdle = 1 << 1
+};
+
 union Animation {
     explicit Animation() noexcept: used{} {}
 
@@ -162,7 +174,9 @@ union Animation {
         UnsignedShort generation = 1;
 
         AnimationFlags flags{NoInit};
-        /* One byte free */
+        /* AnimationSchedule* bits. Not overlapping with anything in Free, so
+           it's preserved across removal and recycling. */
+        UnsignedByte schedule = 0;
         UnsignedInt repeatCount;
 
         /* Duration. 0 only when the animation is freed, otherwise it's always
@@ -230,6 +244,28 @@ struct AbstractAnimator::State {
     Containers::Array<LayerDataHandle> layerData;
 
     Nanoseconds time{Math::ZeroInit};
+    Nanoseconds advanceInterval{Math::ZeroInit};
+
+    /* IDs of animations that need to be looked at in the next update(), each
+       marked with AnimationScheduleListed to be present at most once. These
+       are ones that were Playing or Stopped and scheduled for removal in the
+       previous update(), and ones that were created, removed or modified
+       since. Animations that are Scheduled or Paused aren't listed, instead
+       `idleUntil` is the earliest time at which any of them may change state
+       and a full scan over all animations is done once it's reached. The
+       remaining Stopped animations with AnimationFlag::KeepOncePlayed don't
+       need to be looked at at all. Thus, if there's many animations scheduled
+       to start later, update() doesn't need to go through them every time. */
+    Containers::Array<UnsignedInt> updateList;
+    Nanoseconds idleUntil = Nanoseconds::max();
+
+    /* Set by AbstractUserInterface::advanceAnimations() for the duration of
+       the advance, used by update() to skip animations with
+       AnimationFlag::SkipWhenInvisible. Empty otherwise, in which case
+       nothing is skipped. */
+    Containers::BitArrayView visibleNodeMask;
+    Containers::StridedArrayView1D<const NodeHandle> layerDataNodes;
+    UnsignedInt idleCount = 0;
 };
 
 AbstractAnimator::AbstractAnimator(const AnimatorHandle handle): _state{InPlaceInit} {
@@ -268,6 +304,34 @@ void AbstractAnimator::setLayerInternal(const AbstractLayer& layer) {
     _state->layer = layer.handle();
 }
 
+void AbstractAnimator::setVisibleNodesInternal(const Containers::BitArrayView visibleNodeMask, const Containers::StridedArrayView1D<const NodeHandle>& layerDataNodes) {
+    State& state = *_state;
+    state.visibleNodeMask = visibleNodeMask;
+    state.layerDataNodes = layerDataNodes;
+}
+
+bool AbstractAnimator::isVisibleInternal(const UnsignedInt id) const {
+    const State& state = *_state;
+
+    /* Only one of these is non-empty, depending on whether the animator
+       supports NodeAttachment or DataAttachment */
+    NodeHandle node = NodeHandle::Null;
+    if(!state.nodes.isEmpty())
+        node = state.nodes[id];
+    else if(!state.layerData.isEmpty() && state.layerData[id] != LayerDataHandle::Null) {
+        const UnsignedInt dataId = layerDataHandleId(state.layerData[id]);
+        if(dataId < state.layerDataNodes.size())
+            node = state.layerDataNodes[dataId];
+    }
+
+    /* Animations not attached to anything, and nodes that were created after
+       the visibility mask was calculated, are treated as visible */
+    if(node == NodeHandle::Null)
+        return true;
+    const UnsignedInt nodeId = nodeHandleId(node);
+    return nodeId >= state.visibleNodeMask.size() || state.visibleNodeMask[nodeId];
+}
+
 AnimatorStates AbstractAnimator::state() const {
     return _state->state;
 }
@@ -276,10 +340,31 @@ Nanoseconds AbstractAnimator::time() const {
     return _state->time;
 }
 
+Nanoseconds AbstractAnimator::advanceInterval() const {
+    return _state->advanceInterval;
+}
+
+void AbstractAnimator::setAdvanceInterval(const Nanoseconds interval) {
+    CORRADE_ASSERT(interval >= 0_nsec,
+        "Ui::AbstractAnimator::setAdvanceInterval(): expected non-negative interval, got" << interval, );
+    _state->advanceInterval = interval;
+}
+
 std::size_t AbstractAnimator::capacity() const {
     return _state->animations.size();
 }
 
+void AbstractAnimator::reserve(const std::size_t capacity) {
+    State& state = *_state;
+    arrayReserve(state.animations, capacity);
+    arrayReserve(state.updateList, capacity);
+    if(features() & AnimatorFeature::NodeAttachment)
+        arrayReserve(state.nodes, capacity);
+    if(features() & AnimatorFeature::DataAttachment)
+        arrayReserve(state.layerData, capacity);
+    doReserve(capacity);
+}
+
 std::size_t AbstractAnimator::usedCount() const {
     const State& state = *_state;
     std::size_t free = 0;
@@ -289,6 +374,20 @@ std::size_t AbstractAnimator::usedCount() const {
     return state.animations.size() - free;
 }
 
+MemoryUsage AbstractAnimator::memoryUsage() const {
+    const State& state = *_state;
+    MemoryUsage usage;
+    usage.cpuByteCount =
+        Implementation::arrayByteCount(state.animations) +
+        Implementation::arrayByteCount(state.nodes) +
+        Implementation::arrayByteCount(state.layerData) +
+        Implementation::arrayByteCount(state.updateList);
+    usage.capacity = state.animations.size();
+    usage.usedCount = usedCount();
+    doMemoryUsage(usage);
+    return usage;
+}
+
 bool AbstractAnimator::isHandleValid(const AnimatorDataHandle handle) const {
     if(handle == AnimatorDataHandle::Null)
         return false;
@@ -352,6 +451,42 @@ AnimationState animationState(const Animation& animation, const Nanoseconds time
 
 }
 
+Nanoseconds AbstractAnimator::nextAdvanceTime() const {
+    const State& state = *_state;
+    Nanoseconds next = Nanoseconds::max();
+    for(const Animation& animation: state.animations) {
+        /* Animations with zero duration are freed items, skip */
+        if(animation.used.duration == 0_nsec)
+            continue;
+
+        switch(animationState(animation, state.time)) {
+            /* Scheduled animations need an advance once they start playing */
+            case AnimationState::Scheduled:
+                next = Math::min(next, animation.used.played);
+                break;
+            /* Playing animations need an advance after the interval passes,
+               but also exactly at the point where they pause, stop or finish
+               playing in order to have the final state applied */
+            case AnimationState::Playing: {
+                Nanoseconds end = Math::min(animation.used.paused, animation.used.stopped);
+                if(animation.used.repeatCount)
+                    end = Math::min(end, animation.used.played + animation.used.duration*animation.used.repeatCount);
+                next = Math::min(next, Math::min(state.time + state.advanceInterval, end));
+            } break;
+            /* Paused animations need an advance only once they're stopped.
+               If they're never stopped, this is Nanoseconds::max() which
+               doesn't change anything. */
+            case AnimationState::Paused:
+                next = Math::min(next, animation.used.stopped);
+                break;
+            case AnimationState::Stopped:
+                break;
+        }
+    }
+
+    return next;
+}
+
 AnimationHandle AbstractAnimator::create(const Nanoseconds played, const Nanoseconds duration, const UnsignedInt repeatCount, const AnimationFlags flags) {
     CORRADE_ASSERT(duration > 0_nsec,
         "Ui::AbstractAnimator::create(): expected positive duration, got" << duration, {});
@@ -401,6 +536,7 @@ AnimationHandle AbstractAnimator::create(const Nanoseconds played, const Nanosec
         state.nodes[id] = NodeHandle::Null;
     if(features() & AnimatorFeature::DataAttachment)
         state.layerData[id] = LayerDataHandle::Null;
+    scheduleUpdateInternal(id);
 
     /* Mark the animator as needing an advance() call if the new animation
        is being scheduled or played. Creation alone doesn't make it possible to
@@ -481,10 +617,33 @@ void AbstractAnimator::remove(const AnimatorDataHandle handle) {
     removeInternal(animatorDataHandleId(handle));
 }
 
+void AbstractAnimator::scheduleUpdateInternal(const UnsignedInt id) {
+    State& state = *_state;
+    Animation& animation = state.animations[id];
+
+    /* If the animation was idle, it's no longer accounted for in idleCount.
+       The idleUntil value isn't updated, if it was the earliest one, it'll
+       just cause a full scan to happen earlier than needed. */
+    if(animation.used.schedule & AnimationScheduleIdle) {
+        CORRADE_INTERNAL_DEBUG_ASSERT(state.idleCount);
+        animation.used.schedule &= ~AnimationScheduleIdle;
+        --state.idleCount;
+    }
+
+    if(!(animation.used.schedule & AnimationScheduleListed)) {
+        animation.used.schedule |= AnimationScheduleListed;
+        arrayAppend(state.updateList, id);
+    }
+}
+
 void AbstractAnimator::removeInternal(const UnsignedInt id) {
     State& state = *_state;
     Animation& animation = state.animations[id];
 
+    /* Make the next update() drop it from the idle count, it'll then get
+       removed from the update list if not recycled in the meantime */
+    scheduleUpdateInternal(id);
+
     /* Increase the layout generation so existing handles pointing to this
        layout are invalidated */
     ++animation.used.generation;
@@ -548,6 +707,8 @@ void AbstractAnimator::setRepeatCount(const AnimationHandle handle, const Unsign
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::AbstractAnimator::setRepeatCount(): invalid handle" << handle, );
     _state->animations[animationHandleId(handle)].used.repeatCount = count;
+    /* It can however cause a paused animation to become stopped */
+    scheduleUpdateInternal(animationHandleId(handle));
     /* No AnimatorState needs to be updated, it doesn't cause any
        already-stopped animations to start playing */
 }
@@ -556,6 +717,7 @@ void AbstractAnimator::setRepeatCount(const AnimatorDataHandle handle, const Uns
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::AbstractAnimator::setRepeatCount(): invalid handle" << handle, );
     _state->animations[animatorDataHandleId(handle)].used.repeatCount = count;
+    scheduleUpdateInternal(animatorDataHandleId(handle));
     /* No AnimatorState needs to be updated */
 }
 
@@ -613,6 +775,9 @@ void AbstractAnimator::clearFlags(const AnimatorDataHandle handle, const Animati
 
 void AbstractAnimator::setFlagsInternal(const UnsignedInt id, const AnimationFlags flags) {
     _state->animations[id].used.flags = flags;
+    /* Removing AnimationFlag::KeepOncePlayed makes a stopped animation
+       scheduled for removal in the next update() */
+    scheduleUpdateInternal(id);
 }
 
 Nanoseconds AbstractAnimator::played(const AnimationHandle handle) const {
@@ -872,6 +1037,7 @@ void AbstractAnimator::playInternal(const UnsignedInt id, const Nanoseconds time
 
     animation.used.paused = Nanoseconds::max();
     animation.used.stopped = Nanoseconds::max();
+    scheduleUpdateInternal(id);
 
     /* Mark the animator as needing advance() if the animation is now scheduled
        or playing. Can't be paused because the paused time was reset above. */
@@ -901,6 +1067,7 @@ void AbstractAnimator::pauseInternal(const UnsignedInt id, const Nanoseconds tim
     const AnimationState stateBefore = animationState(animation, state.time);
     #endif
     animation.used.paused = time;
+    scheduleUpdateInternal(id);
 
     #ifndef CORRADE_NO_ASSERT
     /* If the animation was scheduled, playing or paused before, it should be
@@ -931,6 +1098,7 @@ void AbstractAnimator::stopInternal(const UnsignedInt id, const Nanoseconds time
     const AnimationState stateBefore = animationState(animation, state.time);
     #endif
     animation.used.stopped = time;
+    scheduleUpdateInternal(id);
 
     #ifndef CORRADE_NO_ASSERT
     /* If the animation was stopped before, it should be now as well, i.e. no
@@ -967,6 +1135,10 @@ void AbstractAnimator::clean(const Containers::BitArrayView animationIdsToRemove
 
 void AbstractAnimator::doClean(Containers::BitArrayView) {}
 
+void AbstractAnimator::doReserve(std::size_t) {}
+
+void AbstractAnimator::doMemoryUsage(MemoryUsage&) const {}
+
 void AbstractAnimator::cleanNodes(const Containers::StridedArrayView1D<const UnsignedShort>& nodeHandleGenerations) {
     CORRADE_ASSERT(features() >= AnimatorFeature::NodeAttachment,
         "Ui::AbstractAnimator::cleanNodes(): feature not supported", );
@@ -1026,11 +1198,12 @@ void AbstractAnimator::cleanData(const Containers::StridedArrayView1D<const Unsi
         /* For used & attached animations compare the generation of the data
            they're attached to. If it differs, remove the animation and mark
            the corresponding index so the implementation can do its own cleanup
-           in doClean(). */
-        /** @todo check that the ID is in bounds and if it's not, remove as
-            well? to avoid OOB access if the animation is accidentally attached
-            to a LayerDataHandle from a different layer that has more data */
-        if(layerDataHandleGeneration(data) != dataHandleGenerations[layerDataHandleId(data)]) {
+           in doClean(). If the ID is out of bounds, the data got released by
+           AbstractLayer::compact() (or the animation was accidentally
+           attached to a LayerDataHandle from a different layer that has more
+           data), remove it as well. */
+        const UnsignedInt id = layerDataHandleId(data);
+        if(id >= dataHandleGenerations.size() || layerDataHandleGeneration(data) != dataHandleGenerations[id]) {
             removeInternal(i);
             animationIdsToRemove.set(i);
         }
@@ -1060,13 +1233,39 @@ Containers::Pair<bool, bool> AbstractAnimator::update(const Nanoseconds time, co
     active.resetAll();
     remove.resetAll();
 
+    /* If the time reached the point where any of the Scheduled or Paused
+       animations may change state, rebuild the update list from scratch to
+       contain all animations. Otherwise go only through the listed
+       animations, the ones that aren't listed are either Scheduled or Paused
+       and stay that way, or Stopped and don't need a removal. */
+    if(time >= state.idleUntil) {
+        arrayResize(state.updateList, NoInit, 0);
+        for(std::size_t i = 0; i != state.animations.size(); ++i) {
+            Animation& animation = state.animations[i];
+            if(animation.used.duration == 0_nsec) {
+                animation.used.schedule = 0;
+            } else {
+                animation.used.schedule = AnimationScheduleListed;
+                arrayAppend(state.updateList, i);
+            }
+        }
+        state.idleUntil = Nanoseconds::max();
+        state.idleCount = 0;
+    }
+
     const Nanoseconds timeBefore = state.time;
     bool cleanNeeded = false;
     bool advanceNeeded = false;
     bool anotherAdvanceNeeded = false;
-    for(std::size_t i = 0; i != state.animations.size(); ++i) {
-        /* Animations with zero duration are freed items, skip */
-        const Animation& animation = state.animations[i];
+    std::size_t listedCount = 0;
+    for(std::size_t j = 0; j != state.updateList.size(); ++j) {
+        const UnsignedInt i = state.updateList[j];
+        Animation& animation = state.animations[i];
+        CORRADE_INTERNAL_DEBUG_ASSERT(animation.used.schedule == AnimationScheduleListed);
+        animation.used.schedule = 0;
+
+        /* Animations with zero duration are freed items, skip. They got
+           listed by removeInternal() and are now dropped from the list. */
         if(animation.used.duration == 0_nsec)
             continue;
 
@@ -1085,6 +1284,14 @@ Containers::Pair<bool, bool> AbstractAnimator::update(const Nanoseconds time, co
             _c(Scheduled,Stopped)
             _c(Playing,Stopped)
             _c(Paused,Stopped)
+                /* Playing animations attached to nodes that aren't visible
+                   are skipped if requested. They stay listed below, so they
+                   get advanced again once the node is visible. */
+                if(stateAfter == AnimationState::Playing &&
+                   (animation.used.flags & AnimationFlag::SkipWhenInvisible) &&
+                   !state.visibleNodeMask.isEmpty() &&
+                   !isVisibleInternal(i))
+                    break;
                 active.set(i);
                 advanceNeeded = true;
                 factors[i] = animationFactor(animation, time, stateAfter);
@@ -1123,7 +1330,31 @@ Containers::Pair<bool, bool> AbstractAnimator::update(const Nanoseconds time, co
            stateAfter == AnimationState::Playing ||
            stateAfter == AnimationState::Paused)
             anotherAdvanceNeeded = true;
+
+        /* Playing animations and animations to be removed stay in the list.
+           The list is compacted in-place, i.e. the index is always less or
+           equal to the one currently being processed. */
+        if(stateAfter == AnimationState::Playing ||
+          (stateAfter == AnimationState::Stopped && !(animation.used.flags & AnimationFlag::KeepOncePlayed))) {
+            animation.used.schedule = AnimationScheduleListed;
+            state.updateList[listedCount++] = i;
+
+        /* Scheduled and Paused animations are removed from the list until the
+           time at which they can change state. A Paused animation that's
+           never stopped doesn't contribute to that time at all. */
+        } else if(stateAfter == AnimationState::Scheduled ||
+                  stateAfter == AnimationState::Paused) {
+            animation.used.schedule = AnimationScheduleIdle;
+            ++state.idleCount;
+            state.idleUntil = Math::min(state.idleUntil, stateAfter == AnimationState::Scheduled ? animation.used.played : animation.used.stopped);
+        }
     }
+    arrayResize(state.updateList, NoInit, listedCount);
+
+    /* The animations that aren't listed but are Scheduled or Paused need
+       another advance as well */
+    if(state.idleCount)
+        anotherAdvanceNeeded = true;
 
     /* Update current time, mark the animator as needing an advance() call only
        if there are any actually active animations left */
@@ -165,7 +165,30 @@ enum class AnimationFlag: UnsignedByte {
      * kept and is only removable directly with
      * @ref AbstractAnimator::remove().
      */
-    KeepOncePlayed = 1 << 0
+    KeepOncePlayed = 1 << 0,
+
+    /**
+     * Skip advancing the animation while it's @ref AnimationState::Playing
+     * and the node it's attached to, or the node the data it's attached to
+     * are attached to, isn't visible. A node isn't visible if it or any of
+     * its parents is @ref NodeFlag::Hidden or if it was culled in the last
+     * @ref AbstractUserInterface::update(), i.e. if it isn't set in
+     * @ref AbstractUserInterface::visibleNodeMask().
+     *
+     * The animation still progresses in time, the skipping only means the
+     * animator isn't asked to apply it, which in turn avoids the layer and
+     * layout updates caused by it. Transitions to
+     * @ref AnimationState::Paused and @ref AnimationState::Stopped are never
+     * skipped, so the paused or final state is always applied, and once the
+     * node becomes visible again the animation is advanced with a factor
+     * corresponding to the current time, i.e. as if it was never skipped.
+     *
+     * Has an effect only if the animator is advanced through
+     * @ref AbstractUserInterface::advanceAnimations() and only for
+     * animations that are attached to a node or to a data, an animation
+     * that isn't attached to anything is always advanced.
+     */
+    SkipWhenInvisible = 1 << 1
 };
 
 /**
@@ -344,6 +367,57 @@ class MAGNUM_UI_EXPORT AbstractAnimator {
          */
         Nanoseconds time() const;
 
+        /**
+         * @brief Advance interval
+         * @m_since_latest
+         *
+         * Initial value is @cpp 0_nsec @ce.
+         * @see @ref setAdvanceInterval(), @ref nextAdvanceTime()
+         */
+        Nanoseconds advanceInterval() const;
+
+        /**
+         * @brief Set advance interval
+         * @m_since_latest
+         *
+         * Declares how often the animator needs to be advanced while it has
+         * @ref AnimationState::Playing animations. Useful for example for
+         * @ref GenericAnimator callbacks that drive something slowly changing,
+         * such as a blinking cursor or a progress indicator updated a few
+         * times a second, where advancing every frame would be wasteful. The
+         * value affects only the result of @ref nextAdvanceTime(), it doesn't
+         * prevent the animator from being advanced more often. Expects that
+         * @p interval is non-negative, @cpp 0_nsec @ce means the animator
+         * needs to be advanced every frame.
+         */
+        void setAdvanceInterval(Nanoseconds interval);
+
+        /**
+         * @brief Time at which the animator needs to be advanced next
+         * @m_since_latest
+         *
+         * Calculated from the state of all animations at @ref time():
+         *
+         * -    for @ref AnimationState::Scheduled animations it's the time at
+         *      which they start playing,
+         * -    for @ref AnimationState::Playing animations it's @ref time()
+         *      plus @ref advanceInterval(), but at most the time at which
+         *      they get paused, stopped or finish playing,
+         * -    for @ref AnimationState::Paused animations it's the time at
+         *      which they get stopped,
+         * -    @ref AnimationState::Stopped animations aren't taken into
+         *      account.
+         *
+         * The smallest of these is returned. If there are no animations
+         * needing an advance, returns @ref Nanoseconds::max(). If the
+         * returned value is equal to @ref time(), the animator should be
+         * advanced in the next frame. The operation is done with a
+         * @f$ \mathcal{O}(n) @f$ complexity where @f$ n @f$ is
+         * @ref capacity().
+         * @see @ref AbstractUserInterface::nextAnimationTime()
+         */
+        Nanoseconds nextAdvanceTime() const;
+
         /**
          * @brief Current capacity of the data storage
          *
@@ -353,6 +427,20 @@ class MAGNUM_UI_EXPORT AbstractAnimator {
          */
         std::size_t capacity() const;
 
+        /**
+         * @brief Reserve animation storage
+         * @m_since_latest
+         *
+         * Grows the internal storage to have space for at least @p capacity
+         * items without reallocating, for example to avoid reallocations
+         * when populating a known amount of items. Doesn't change
+         * @ref capacity() or make any new handles available, these are still
+         * allocated only with @ref create(). Delegates to
+         * @ref doReserve() to reserve also storage in the subclass, if
+         * needed.
+         */
+        void reserve(std::size_t capacity);
+
         /**
          * @brief Count of used items in the data storage
          *
@@ -362,6 +450,19 @@ class MAGNUM_UI_EXPORT AbstractAnimator {
          */
         std::size_t usedCount() const;
 
+        /**
+         * @brief Memory usage
+         * @m_since_latest
+         *
+         * The @ref MemoryUsage::capacity and @ref MemoryUsage::usedCount are
+         * the same as @ref capacity() and @ref usedCount(), the byte counts
+         * include the base animation storage and whatever @ref doMemoryUsage()
+         * adds for the subclass. The operation is done with a
+         * @f$ \mathcal{O}(n) @f$ complexity where @f$ n @f$ is
+         * @ref capacity().
+         */
+        MemoryUsage memoryUsage() const;
+
         /**
          * @brief Whether an animation handle is valid
          *
@@ -1033,8 +1134,10 @@ class MAGNUM_UI_EXPORT AbstractAnimator {
          * that @p dataHandleGenerations contains handle generation counters
          * for all data in layer matching @ref layer() const, where the index
          * is implicitly the handle ID. They're used to decide about data
-         * attachment validity, animations with invalid data attachments are
-         * then removed. Delegates to @ref clean() and subsequently
+         * attachment validity, animations with invalid data attachments or
+         * attached to data with IDs outside of @p dataHandleGenerations, such
+         * as after @ref AbstractLayer::compact(), are then removed. Delegates
+         * to @ref clean() and subsequently
          * @ref doClean(), see their documentation for more information.
          */
         void cleanData(const Containers::StridedArrayView1D<const UnsignedShort>& dataHandleGenerations);
@@ -1062,6 +1165,10 @@ class MAGNUM_UI_EXPORT AbstractAnimator {
          * @ref AnimationState::Stopped at @p time and don't have
          * @ref AnimationFlag::KeepOncePlayed. See documentation of
          * @ref AnimationState values for how the state transition behaves.
+         * When called from @ref AbstractUserInterface::advanceAnimations(),
+         * animations with @ref AnimationFlag::SkipWhenInvisible that are
+         * @ref AnimationState::Playing at @p time and are attached to nodes
+         * that aren't visible don't have their bit set in @p active.
          *
          * If the first return value is @cpp true @ce, the @p active,
          * @p factors and @p remove views are meant to be passed to subclass
@@ -1077,6 +1184,16 @@ class MAGNUM_UI_EXPORT AbstractAnimator {
          * behavior of this function is independent of @ref state() --- it
          * performs the update and fills the output views regardless of what
          * flags are set.
+         *
+         * Apart from clearing the output masks, the operation is done with a
+         * @f$ \mathcal{O}(n) @f$ complexity where @f$ n @f$ is the count of
+         * animations that were playing or scheduled for removal in the
+         * previous call, plus animations that were created, removed or
+         * modified since. Animations that are @ref AnimationState::Scheduled
+         * or @ref AnimationState::Paused are not looked at again until the
+         * earliest time at which any of them may change state, at which point
+         * all animations are gone through, i.e. with a complexity of
+         * @f$ \mathcal{O}(c) @f$ where @f$ c @f$ is @ref capacity().
          * @see @ref state(AnimationHandle) const
          */
         Containers::Pair<bool, bool> update(Nanoseconds time, Containers::MutableBitArrayView active, const Containers::StridedArrayView1D<Float>& factors, Containers::MutableBitArrayView remove);
@@ -1253,6 +1370,8 @@ class MAGNUM_UI_EXPORT AbstractAnimator {
     private:
         /* Calls setLayerInternal() (yeah, it's ew, sorry) */
         friend AbstractLayer;
+        /* Calls setVisibleNodesInternal() */
+        friend AbstractUserInterface;
 
         /** @brief Implementation for @ref features() */
         virtual AnimatorFeatures doFeatures() const = 0;
@@ -1297,8 +1416,37 @@ class MAGNUM_UI_EXPORT AbstractAnimator {
          */
         virtual void doClean(Containers::BitArrayView animationIdsToRemove);
 
+        /**
+         * @brief Reserve storage in the subclass
+         * @param capacity  Capacity to reserve
+         *
+         * Implementation for @ref reserve(), meant to be used to reserve
+         * storage of additional per-item data the subclass maintains, to
+         * avoid reallocations in subsequent @ref create() calls. Called
+         * after the base storage is reserved.
+         *
+         * Default implementation does nothing.
+         */
+        virtual void doReserve(std::size_t capacity);
+
+        /**
+         * @brief Memory usage of the subclass
+         * @param[in,out] usage     Memory usage to add to
+         * @m_since_latest
+         *
+         * Implementation for @ref memoryUsage(), meant to add byte counts of
+         * additional storage the subclass maintains to
+         * @ref MemoryUsage::cpuByteCount and
+         * @relativeref{MemoryUsage,gpuByteCount} of @p usage. Called after
+         * the base storage is counted.
+         *
+         * Default implementation does nothing.
+         */
+        virtual void doMemoryUsage(MemoryUsage& usage) const;
+
         /* Common implementations for foo(AnimationHandle) and
            foo(AnimatorDataHandle) */
+        MAGNUM_UI_LOCAL void scheduleUpdateInternal(UnsignedInt id);
         MAGNUM_UI_LOCAL void removeInternal(UnsignedInt id);
         MAGNUM_UI_LOCAL void setFlagsInternal(UnsignedInt id, AnimationFlags flags);
         MAGNUM_UI_LOCAL void attachInternal(UnsignedInt id, NodeHandle node);
@@ -1311,6 +1459,14 @@ class MAGNUM_UI_EXPORT AbstractAnimator {
         MAGNUM_UI_LOCAL void pauseInternal(UnsignedInt id, Nanoseconds time);
         MAGNUM_UI_LOCAL void stopInternal(UnsignedInt id, Nanoseconds time);
 
+        /* Used by AbstractUserInterface::advanceAnimations() to make update()
+           skip animations with AnimationFlag::SkipWhenInvisible. The
+           `layerDataNodes` are AbstractLayer::nodes() of the layer the
+           animator is associated with, if it supports DataAttachment. The
+           views are expected to be reset back to empty after the advance. */
+        MAGNUM_UI_LOCAL void setVisibleNodesInternal(Containers::BitArrayView visibleNodeMask, const Containers::StridedArrayView1D<const NodeHandle>& layerDataNodes);
+        MAGNUM_UI_LOCAL bool isVisibleInternal(UnsignedInt id) const;
+
         struct State;
         Containers::Pointer<State> _state;
 };
@@ -32,11 +32,14 @@
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Iterable.h>
 #include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Utility/Move.h>
 #include <Magnum/Math/Time.h>
 
 #include "Magnum/Ui/AbstractAnimator.h"
 #include "Magnum/Ui/Event.h"
 #include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/MemoryUsage.h"
+#include "Magnum/Ui/Implementation/memoryUsage.h"
 
 namespace Magnum { namespace Ui {
 
@@ -59,6 +62,7 @@ Debug& operator<<(Debug& debug, const LayerFeature value) {
         _c(Event)
         _c(AnimateData)
         _c(AnimateStyles)
+        _c(IntrinsicSize)
         #undef _c
         /* LCOV_EXCL_STOP */
     }
@@ -79,7 +83,8 @@ Debug& operator<<(Debug& debug, const LayerFeatures value) {
         LayerFeature::Draw,
         LayerFeature::Event,
         LayerFeature::AnimateData,
-        LayerFeature::AnimateStyles
+        LayerFeature::AnimateStyles,
+        LayerFeature::IntrinsicSize
     });
 }
 
@@ -105,6 +110,7 @@ Debug& operator<<(Debug& debug, const LayerState value) {
         _c(NeedsSharedDataUpdate)
         _c(NeedsCompositeOffsetSizeUpdate)
         _c(NeedsDataClean)
+        _c(NeedsIntrinsicSizeUpdate)
         #undef _c
         /* LCOV_EXCL_STOP */
     }
@@ -132,7 +138,8 @@ Debug& operator<<(Debug& debug, const LayerStates value) {
         LayerState::NeedsCommonDataUpdate,
         LayerState::NeedsSharedDataUpdate,
         LayerState::NeedsCompositeOffsetSizeUpdate,
-        LayerState::NeedsDataClean
+        LayerState::NeedsDataClean,
+        LayerState::NeedsIntrinsicSizeUpdate
     });
 }
 
@@ -156,7 +163,12 @@ union Data {
            doesn't make sense to initialize it to anything. */
         NodeHandle node;
 
-        /* Four bytes free */
+        /* Previous and next data attached to the same node, forming a doubly
+           linked list sorted by data ID that starts at NodeData::first. A
+           value of ~UnsignedInt{} means there's no previous / next data. Only
+           meaningful if the node is not null. */
+        UnsignedInt previousInNode;
+        UnsignedInt nextInNode;
     } used;
 
     /* Used only if the Data is among free ones */
@@ -183,6 +195,64 @@ static_assert(
     offsetof(Data::Used, node) == offsetof(Data::Free, node),
     "Data::Used and Free layout not compatible");
 
+/* Data attached to a particular node, indexed by node ID */
+struct NodeData {
+    /* First and last data in the list, ~UnsignedInt{} if there's none */
+    UnsignedInt first;
+    UnsignedInt last;
+    /* Count of data in the list */
+    UnsignedInt count;
+};
+
+/* Inserts a data into its node's list. Data are appended to the end the most
+   often, so the list is walked from the back to find the place to insert the
+   data ID at. */
+void linkNodeData(const Containers::ArrayView<Data> data, Containers::Array<NodeData>& nodeData, const UnsignedInt id) {
+    const UnsignedInt nodeId = nodeHandleId(data[id].used.node);
+    if(nodeId >= nodeData.size()) {
+        for(NodeData& i: arrayAppend(nodeData, NoInit, nodeId + 1 - nodeData.size())) {
+            i.first = i.last = ~UnsignedInt{};
+            i.count = 0;
+        }
+    }
+
+    NodeData& node = nodeData[nodeId];
+    UnsignedInt previous = node.last;
+    while(previous != ~UnsignedInt{} && previous > id)
+        previous = data[previous].used.previousInNode;
+
+    const UnsignedInt next = previous == ~UnsignedInt{} ?
+        node.first : data[previous].used.nextInNode;
+    data[id].used.previousInNode = previous;
+    data[id].used.nextInNode = next;
+    if(previous == ~UnsignedInt{})
+        node.first = id;
+    else
+        data[previous].used.nextInNode = id;
+    if(next == ~UnsignedInt{})
+        node.last = id;
+    else
+        data[next].used.previousInNode = id;
+    ++node.count;
+}
+
+/* Removes a data from its node's list, has to be called while the node is
+   still set */
+void unlinkNodeData(const Containers::ArrayView<Data> data, const Containers::ArrayView<NodeData> nodeData, const UnsignedInt id) {
+    NodeData& node = nodeData[nodeHandleId(data[id].used.node)];
+    const UnsignedInt previous = data[id].used.previousInNode;
+    const UnsignedInt next = data[id].used.nextInNode;
+    if(previous == ~UnsignedInt{})
+        node.first = next;
+    else
+        data[previous].used.nextInNode = next;
+    if(next == ~UnsignedInt{})
+        node.last = previous;
+    else
+        data[next].used.previousInNode = previous;
+    --node.count;
+}
+
 }
 
 struct AbstractLayer::State {
@@ -201,8 +271,43 @@ struct AbstractLayer::State {
        (first/next/last) free data. */
     UnsignedInt firstFree = ~UnsignedInt{};
     UnsignedInt lastFree = ~UnsignedInt{};
+
+    /* Data IDs below compactedDataCount that got released by compact() and
+       are not in the data array anymore. When the storage grows into this
+       range again, the new data start with compactedGeneration instead of 1,
+       which is larger than generations of any handle to a released data, so
+       such handles don't become valid again. If it's equal to
+       `1 << LayerDataHandleGenerationBits`, the new data are disabled. */
+    UnsignedInt compactedDataCount = 0;
+    UnsignedInt compactedGeneration = 1;
+
+    /* Data attached to each node, indexed by node ID. Grown on demand, nodes
+       with IDs outside of the range have no data attached. */
+    Containers::Array<NodeData> nodeData;
+
+    /* Data modified since the last update(), indexed by data ID. Grown on
+       demand, resized to capacity and filled with ones if allDataModified is
+       set in update(), then cleared after. */
+    Containers::BitArray modifiedData;
+    bool allDataModified = false;
+
+    void setDataModified(UnsignedInt id);
 };
 
+void AbstractLayer::State::setDataModified(const UnsignedInt id) {
+    if(allDataModified)
+        return;
+
+    /* Grow the mask with some headroom to not reallocate on every create() */
+    if(id >= modifiedData.size()) {
+        Containers::BitArray grown{ValueInit, Math::max(std::size_t{id} + 1, Math::max(data.size(), modifiedData.size()*2))};
+        for(std::size_t i = 0; i != modifiedData.size(); ++i)
+            if(modifiedData[i]) grown.set(i);
+        modifiedData = Utility::move(grown);
+    }
+    modifiedData.set(id);
+}
+
 AbstractLayer::AbstractLayer(const LayerHandle handle): _state{InPlaceInit} {
     CORRADE_ASSERT(handle != LayerHandle::Null,
         "Ui::AbstractLayer: handle is null", );
@@ -225,6 +330,8 @@ LayerStates AbstractLayer::state() const {
     LayerStates expectedStates = LayerState::NeedsDataUpdate|LayerState::NeedsCommonDataUpdate|LayerState::NeedsSharedDataUpdate;
     if(features() >= LayerFeature::Composite)
         expectedStates |= LayerState::NeedsCompositeOffsetSizeUpdate;
+    if(features() >= LayerFeature::IntrinsicSize)
+        expectedStates |= LayerState::NeedsIntrinsicSizeUpdate;
     #endif
     CORRADE_ASSERT(state <= expectedStates,
         "Ui::AbstractLayer::state(): implementation expected to return a subset of" << expectedStates << "but got" << state, {});
@@ -238,16 +345,33 @@ void AbstractLayer::setNeedsUpdate(const LayerStates state) {
     LayerStates expectedStates = LayerState::NeedsDataUpdate|LayerState::NeedsCommonDataUpdate|LayerState::NeedsSharedDataUpdate;
     if(features() >= LayerFeature::Composite)
         expectedStates |= LayerState::NeedsCompositeOffsetSizeUpdate;
+    if(features() >= LayerFeature::IntrinsicSize)
+        expectedStates |= LayerState::NeedsIntrinsicSizeUpdate;
     #endif
     CORRADE_ASSERT(state && state <= expectedStates,
         "Ui::AbstractLayer::setNeedsUpdate(): expected a non-empty subset of" << expectedStates << "but got" << state, );
     _state->state |= state;
+    if(state >= LayerState::NeedsDataUpdate)
+        _state->allDataModified = true;
+}
+
+void AbstractLayer::setNeedsDataUpdate(const UnsignedInt id) {
+    State& state = *_state;
+    CORRADE_ASSERT(id < state.data.size(),
+        "Ui::AbstractLayer::setNeedsDataUpdate(): index" << id << "out of range for" << state.data.size() << "data", );
+    state.state |= LayerState::NeedsDataUpdate;
+    state.setDataModified(id);
 }
 
 std::size_t AbstractLayer::capacity() const {
     return _state->data.size();
 }
 
+void AbstractLayer::reserve(const std::size_t capacity) {
+    arrayReserve(_state->data, capacity);
+    doReserve(capacity);
+}
+
 std::size_t AbstractLayer::usedCount() const {
     /* The "pointer" chasing in here is a bit nasty, but there's no other way
        to know which data are actually used and which not. The node is Null
@@ -263,6 +387,115 @@ std::size_t AbstractLayer::usedCount() const {
     return state.data.size() - free;
 }
 
+MemoryUsage AbstractLayer::memoryUsage() const {
+    const State& state = *_state;
+    MemoryUsage usage;
+    usage.cpuByteCount =
+        Implementation::arrayByteCount(state.data) +
+        Implementation::arrayByteCount(state.nodeData) +
+        Implementation::arrayByteCount(state.modifiedData);
+    usage.capacity = state.data.size();
+    usage.usedCount = usedCount();
+    doMemoryUsage(usage);
+    return usage;
+}
+
+void AbstractLayer::compact(const Containers::StridedArrayView1D<DataHandle>& mapping) {
+    State& state = *_state;
+    CORRADE_ASSERT(mapping.size() == state.data.size(),
+        "Ui::AbstractLayer::compact(): expected mapping view to have a size of" << state.data.size() << "but got" << mapping.size(), );
+
+    /** @todo have some bump allocator for this */
+    Containers::BitArray freeData{ValueInit, state.data.size()};
+    for(UnsignedInt index = state.firstFree; index != ~UnsignedInt{}; index = state.data[index].free.next)
+        freeData.set(index);
+
+    /* Go through the used data in order and move each to the first slot that
+       isn't disabled. As the slots are taken in the same order, the target
+       slot is never after the source one, so the move can be done in place,
+       and whatever was originally in the target slot is either free or was
+       already moved. Slots that get a different data than before get their
+       generation incremented to invalidate existing handles. If that makes
+       the generation wrap around, the slot becomes disabled and the next one
+       is tried. Disabled slots are not in the free list, so they're skipped
+       as well. */
+    constexpr UnsignedInt DisabledGeneration = 1 << Implementation::LayerDataHandleGenerationBits;
+    Containers::Array<UnsignedInt> previousDataIds{NoInit, state.data.size()};
+    UnsignedInt next = 0;
+    for(std::size_t i = 0; i != state.data.size(); ++i) {
+        if(freeData[i] || state.data[i].used.generation == DisabledGeneration) {
+            mapping[i] = DataHandle::Null;
+            continue;
+        }
+
+        UnsignedInt id;
+        for(;;) {
+            id = next++;
+            if(id == i)
+                break;
+            if(state.data[id].used.generation == DisabledGeneration)
+                continue;
+            if(++state.data[id].used.generation == DisabledGeneration)
+                continue;
+            break;
+        }
+
+        /* The node lists are rebuilt from scratch below, so just the node
+           handle needs to be copied */
+        state.data[id].used.node = state.data[i].used.node;
+        previousDataIds[id] = i;
+        mapping[i] = dataHandle(state.handle, id, state.data[id].used.generation);
+    }
+
+    /* Mark skipped disabled slots */
+    for(UnsignedInt i = 0; i != next; ++i)
+        if(state.data[i].used.generation == DisabledGeneration)
+            previousDataIds[i] = ~UnsignedInt{};
+
+    /* Everything after is released, thus there are no free data anymore.
+       Remember the largest generation in the released range so data created
+       there later don't make handles to the released data valid again. The
+       stored generation is already the next one to be used for free data,
+       for used data it's the generation of the existing handle, so go one
+       above that. Disabled data stay disabled. */
+    if(next != state.data.size()) {
+        UnsignedInt generation = state.compactedGeneration;
+        for(std::size_t i = next; i != state.data.size(); ++i) {
+            const UnsignedInt dataGeneration = state.data[i].used.generation;
+            generation = Math::max(generation, freeData[i] || dataGeneration == DisabledGeneration ? dataGeneration : dataGeneration + 1);
+        }
+        state.compactedGeneration = generation;
+        state.compactedDataCount = Math::max(state.compactedDataCount, UnsignedInt(state.data.size()));
+    }
+    arrayResize(state.data, NoInit, next);
+    arrayShrink(state.data);
+    state.firstFree = state.lastFree = ~UnsignedInt{};
+
+    /* Rebuild the node data lists. The data are linked in order, so each gets
+       appended to the end of its list. */
+    arrayResize(state.nodeData, NoInit, 0);
+    for(std::size_t i = 0; i != state.data.size(); ++i) {
+        if(previousDataIds[i] == ~UnsignedInt{})
+            continue;
+        if(state.data[i].used.node != NodeHandle::Null)
+            linkNodeData(state.data, state.nodeData, i);
+    }
+    arrayShrink(state.nodeData);
+
+    /* All data are treated as modified */
+    state.modifiedData = Containers::BitArray{DirectInit, state.data.size(), true};
+    state.allDataModified = true;
+
+    state.state |= LayerState::NeedsDataUpdate|
+                   LayerState::NeedsAttachmentUpdate|
+                   LayerState::NeedsNodeOffsetSizeUpdate|
+                   LayerState::NeedsDataClean;
+    if(features() >= LayerFeature::Composite)
+        state.state |= LayerState::NeedsCompositeOffsetSizeUpdate;
+
+    doCompact(previousDataIds.prefix(state.data.size()));
+}
+
 bool AbstractLayer::isHandleValid(const LayerDataHandle handle) const {
     if(handle == LayerDataHandle::Null)
         return false;
@@ -288,6 +521,45 @@ bool AbstractLayer::isHandleValid(const DataHandle handle) const {
 }
 
 DataHandle AbstractLayer::create(const NodeHandle node) {
+    const DataHandle handle = createInternal(node);
+
+    State& state = *_state;
+    state.state |= LayerState::NeedsDataUpdate;
+    if(node != NodeHandle::Null) {
+        state.state |= LayerState::NeedsAttachmentUpdate|
+                       LayerState::NeedsNodeOffsetSizeUpdate;
+        if(features() >= LayerFeature::Composite)
+            state.state |= LayerState::NeedsCompositeOffsetSizeUpdate;
+    }
+
+    return handle;
+}
+
+void AbstractLayer::create(const Containers::StridedArrayView1D<const NodeHandle>& nodes, const Containers::StridedArrayView1D<DataHandle>& handles) {
+    CORRADE_ASSERT(handles.size() == nodes.size(),
+        "Ui::AbstractLayer::create(): expected handles view to have a size of" << nodes.size() << "but got" << handles.size(), );
+
+    /* Grow the storage just once. It's conservative as some data may get
+       taken from the free list, but that's fine as it's just capacity. */
+    State& state = *_state;
+    arrayReserve(state.data, state.data.size() + nodes.size());
+    bool attached = false;
+    for(std::size_t i = 0; i != nodes.size(); ++i) {
+        handles[i] = createInternal(nodes[i]);
+        attached = attached || nodes[i] != NodeHandle::Null;
+    }
+
+    /* Update the state just once, same as in create(NodeHandle) */
+    state.state |= LayerState::NeedsDataUpdate;
+    if(attached) {
+        state.state |= LayerState::NeedsAttachmentUpdate|
+                       LayerState::NeedsNodeOffsetSizeUpdate;
+        if(features() >= LayerFeature::Composite)
+            state.state |= LayerState::NeedsCompositeOffsetSizeUpdate;
+    }
+}
+
+DataHandle AbstractLayer::createInternal(const NodeHandle node) {
     State& state = *_state;
 
     /* Find the first free data if there is, update the free index to point to
@@ -303,26 +575,33 @@ DataHandle AbstractLayer::create(const NodeHandle node) {
             state.firstFree = data->free.next;
         }
 
-    /* If there isn't, allocate a new one */
+    /* If there isn't, allocate a new one. If it's in a range released by
+       compact(), it starts with a generation that doesn't match any handle
+       to the released data. If that generation is disabled, the data is
+       skipped and another one allocated. */
     } else {
-        CORRADE_ASSERT(state.data.size() < 1 << Implementation::LayerDataHandleIdBits,
-            "Ui::AbstractLayer::create(): can only have at most" << (1 << Implementation::LayerDataHandleIdBits) << "data", {});
-        data = &arrayAppend(state.data, InPlaceInit);
+        do {
+            CORRADE_ASSERT(state.data.size() < 1 << Implementation::LayerDataHandleIdBits,
+                "Ui::AbstractLayer::create(): can only have at most" << (1 << Implementation::LayerDataHandleIdBits) << "data", {});
+            data = &arrayAppend(state.data, InPlaceInit);
+            if(state.data.size() <= state.compactedDataCount)
+                data->used.generation = UnsignedShort(state.compactedGeneration);
+        } while(data->used.generation == 1 << Implementation::LayerDataHandleGenerationBits);
     }
 
     /* Fill the data. In both above cases the generation is already set
-       appropriately, either initialized to 1, or incremented when it got
-       remove()d (to mark existing handles as invalid) */
-    state.state |= LayerState::NeedsDataUpdate;
+       appropriately, either initialized to 1 or to the generation after
+       compact(), or incremented when it got remove()d (to mark existing
+       handles as invalid). Updating LayerState is caller's
+       responsibility. */
+    const UnsignedInt id = data - state.data;
     if(node != NodeHandle::Null) {
         data->used.node = node;
-        state.state |= LayerState::NeedsAttachmentUpdate|
-                       LayerState::NeedsNodeOffsetSizeUpdate;
-        if(features() >= LayerFeature::Composite)
-            state.state |= LayerState::NeedsCompositeOffsetSizeUpdate;
+        linkNodeData(state.data, state.nodeData, id);
     }
+    state.setDataModified(id);
 
-    return dataHandle(state.handle, (data - state.data), data->used.generation);
+    return dataHandle(state.handle, id, data->used.generation);
 }
 
 void AbstractLayer::remove(const DataHandle handle) {
@@ -364,6 +643,27 @@ void AbstractLayer::remove(const LayerDataHandle handle) {
     removeInternal(layerDataHandleId(handle));
 }
 
+void AbstractLayer::remove(const Containers::StridedArrayView1D<const DataHandle>& handles) {
+    State& state = *_state;
+    /* Checking the handles as they get removed, so a duplicate handle is
+       caught as invalid */
+    bool attached = false;
+    for(std::size_t i = 0; i != handles.size(); ++i) {
+        CORRADE_ASSERT(isHandleValid(handles[i]),
+            "Ui::AbstractLayer::remove(): invalid handle" << handles[i] << "at index" << i, );
+        const UnsignedInt id = dataHandleId(handles[i]);
+        attached = attached || state.data[id].used.node != NodeHandle::Null;
+        removeInternal(id);
+    }
+
+    /* Mark the layer as needing a cleanData() call for any assigned animators
+       and potentially an update() call to refresh node data attachment state,
+       same as in remove(DataHandle) */
+    state.state |= LayerState::NeedsDataClean;
+    if(attached)
+        state.state |= LayerState::NeedsAttachmentUpdate;
+}
+
 void AbstractLayer::removeInternal(const UnsignedInt id) {
     State& state = *_state;
     Data& data = state.data[id];
@@ -373,8 +673,12 @@ void AbstractLayer::removeInternal(const UnsignedInt id) {
     ++data.used.generation;
 
     /* Set the node attachment to null to avoid falsely recognizing this item
-       as used when directly iterating the list */
-    data.used.node = NodeHandle::Null;
+       as used when directly iterating the list. Before that remove it from
+       the node data list, as the free list reuses the same memory. */
+    if(data.used.node != NodeHandle::Null) {
+        unlinkNodeData(state.data, state.nodeData, id);
+        data.used.node = NodeHandle::Null;
+    }
 
     /* Put the data at the end of the free list (while they're allocated from
        the front) to not exhaust the generation counter too fast. If the free
@@ -440,13 +744,22 @@ void AbstractLayer::attachInternal(const UnsignedInt id, const NodeHandle node)
     if(state.data[id].used.node == node)
         return;
 
+    if(state.data[id].used.node != NodeHandle::Null)
+        unlinkNodeData(state.data, state.nodeData, id);
     state.data[id].used.node = node;
+    if(node != NodeHandle::Null)
+        linkNodeData(state.data, state.nodeData, id);
+    state.setDataModified(id);
     state.state |= LayerState::NeedsAttachmentUpdate;
     if(node != NodeHandle::Null) {
         state.state |= LayerState::NeedsNodeOffsetSizeUpdate;
         if(features() >= LayerFeature::Composite)
             state.state |= LayerState::NeedsCompositeOffsetSizeUpdate;
     }
+    /* The data may now contribute to a size of a different node and no
+       longer to the previous one */
+    if(features() >= LayerFeature::IntrinsicSize)
+        state.state |= LayerState::NeedsIntrinsicSizeUpdate;
 }
 
 NodeHandle AbstractLayer::node(DataHandle data) const {
@@ -465,6 +778,23 @@ Containers::StridedArrayView1D<const NodeHandle> AbstractLayer::nodes() const {
     return stridedArrayView(_state->data).slice(&Data::used).slice(&Data::Used::node);
 }
 
+Containers::StridedArrayView1D<const UnsignedInt> AbstractLayer::nodeFirstDataIds() const {
+    return stridedArrayView(_state->nodeData).slice(&NodeData::first);
+}
+
+Containers::StridedArrayView1D<const UnsignedInt> AbstractLayer::nodeDataCounts() const {
+    return stridedArrayView(_state->nodeData).slice(&NodeData::count);
+}
+
+Containers::StridedArrayView1D<const UnsignedInt> AbstractLayer::nodeNextDataIds() const {
+    return stridedArrayView(_state->data).slice(&Data::used).slice(&Data::Used::nextInNode);
+}
+
+Containers::BitArrayView AbstractLayer::modifiedDataMask() const {
+    const State& state = *_state;
+    return Containers::BitArrayView{state.modifiedData}.prefix(Math::min(state.modifiedData.size(), state.data.size()));
+}
+
 Containers::StridedArrayView1D<const UnsignedShort> AbstractLayer::generations() const {
     return stridedArrayView(_state->data).slice(&Data::used).slice(&Data::Used::generation);
 }
@@ -512,6 +842,12 @@ void AbstractLayer::cleanNodes(const Containers::StridedArrayView1D<const Unsign
 
 void AbstractLayer::doClean(Containers::BitArrayView) {}
 
+void AbstractLayer::doReserve(std::size_t) {}
+
+void AbstractLayer::doMemoryUsage(MemoryUsage&) const {}
+
+void AbstractLayer::doCompact(const Containers::StridedArrayView1D<const UnsignedInt>&) {}
+
 void AbstractLayer::cleanData(const Containers::Iterable<AbstractAnimator>& animators) {
     State& state = *_state;
     const Containers::StridedArrayView1D<const UnsignedShort> dataGenerations = stridedArrayView(state.data).slice(&Data::used).slice(&Data::Used::generation);
@@ -611,15 +947,44 @@ void AbstractLayer::update(const LayerStates states, const Containers::StridedAr
     auto& state = *_state;
     CORRADE_ASSERT(!(features() >= LayerFeature::Draw) || state.setSizeCalled,
         "Ui::AbstractLayer::update(): user interface size wasn't set", );
+
+    /* If a data update is requested but not just for particular data marked
+       with setNeedsDataUpdate(), create() or attach(), it's either from the
+       implementation itself or from the user interface. In that case all
+       data are treated as modified. */
+    if(states >= LayerState::NeedsDataUpdate && (!(state.state >= LayerState::NeedsDataUpdate) || doState() >= LayerState::NeedsDataUpdate))
+        state.allDataModified = true;
+    if(state.modifiedData.size() != state.data.size()) {
+        Containers::BitArray modifiedData{ValueInit, state.data.size()};
+        if(!state.allDataModified) for(std::size_t i = 0, iMax = Math::min(state.modifiedData.size(), state.data.size()); i != iMax; ++i)
+            if(state.modifiedData[i]) modifiedData.set(i);
+        state.modifiedData = Utility::move(modifiedData);
+    }
+    if(state.allDataModified)
+        state.modifiedData.setAll();
+
     /* Don't pass the NeedsAttachmentUpdate bit to the implementation as it
        shouldn't need that, just NeedsNodeOpacityUpdate NeedsNodeOrderUpdate
        that's a subset of it */
     doUpdate(states & ~(LayerState::NeedsAttachmentUpdate & ~(LayerState::NeedsNodeOpacityUpdate|LayerState::NeedsNodeOrderUpdate)), dataIds, clipRectIds, clipRectDataCounts, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, clipRectOffsets, clipRectSizes, compositeRectOffsets, compositeRectSizes);
     state.state &= ~states;
+    state.modifiedData.resetAll();
+    state.allDataModified = false;
 }
 
 void AbstractLayer::doUpdate(LayerStates, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Float>&, Containers::BitArrayView, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&) {}
 
+void AbstractLayer::intrinsicSizes(const Containers::StridedArrayView1D<Vector2>& nodeSizes) {
+    CORRADE_ASSERT(features() >= LayerFeature::IntrinsicSize,
+        "Ui::AbstractLayer::intrinsicSizes(): feature not supported", );
+    doIntrinsicSizes(nodeSizes);
+    _state->state &= ~LayerState::NeedsIntrinsicSizeUpdate;
+}
+
+void AbstractLayer::doIntrinsicSizes(const Containers::StridedArrayView1D<Vector2>&) {
+    CORRADE_ASSERT_UNREACHABLE("Ui::AbstractLayer::intrinsicSizes(): feature advertised but not implemented", );
+}
+
 void AbstractLayer::composite(AbstractRenderer& renderer, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes, const std::size_t offset, const std::size_t count) {
     CORRADE_ASSERT(features() & LayerFeature::Composite,
         "Ui::AbstractLayer::composite(): feature not supported", );
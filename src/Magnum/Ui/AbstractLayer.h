@@ -97,6 +97,15 @@ enum class LayerFeature: UnsignedByte {
      * animating styles using @ref AbstractLayer::advanceAnimations(Nanoseconds, Containers::MutableBitArrayView, const Containers::StridedArrayView1D<Float>&, Containers::MutableBitArrayView, const Containers::Iterable<AbstractStyleAnimator>&).
      */
     AnimateStyles = 1 << 6,
+
+    /**
+     * Reporting intrinsic sizes of data contents using
+     * @ref AbstractLayer::intrinsicSizes(). Called from
+     * @ref AbstractUserInterface::update() right before layouters are run, so
+     * the layouters can take the sizes into account in the same update.
+     * @m_since_latest
+     */
+    IntrinsicSize = 1 << 7,
 };
 
 /**
@@ -318,7 +327,26 @@ enum class LayerState: UnsignedShort {
      * If set on a layer, causes @ref UserInterfaceState::NeedsDataClean
      * to be set on the user interface.
      */
-    NeedsDataClean = 1 << 9
+    NeedsDataClean = 1 << 9,
+
+    /**
+     * @ref AbstractLayer::intrinsicSizes() (which is called from
+     * @ref AbstractUserInterface::update()) needs to be called to refresh
+     * intrinsic sizes of nodes the data are attached to after data contents
+     * changed. Can be set only on layers that advertise
+     * @ref LayerFeature::IntrinsicSize, where it's set implicitly after every
+     * @ref AbstractLayer::attach() call that attaches data to a different
+     * node. Can also be returned by @ref AbstractLayer::doState() or be
+     * explicitly set by the layer implementation using
+     * @ref AbstractLayer::setNeedsUpdate(). Is reset next time
+     * @ref AbstractLayer::intrinsicSizes() is called.
+     *
+     * If set on a layer, causes @ref UserInterfaceState::NeedsLayoutUpdate
+     * to be set on the user interface. Never passed to
+     * @ref AbstractLayer::update().
+     * @m_since_latest
+     */
+    NeedsIntrinsicSizeUpdate = 1 << 10
 };
 
 /**
@@ -400,10 +428,17 @@ class MAGNUM_UI_EXPORT AbstractLayer {
          * modified. Expects that @p state is a non-empty subset of
          * @ref LayerState::NeedsDataUpdate,
          * @relativeref{LayerState,NeedsCommonDataUpdate},
-         * @relativeref{LayerState,NeedsSharedDataUpdate}, and if the layer
+         * @relativeref{LayerState,NeedsSharedDataUpdate}, if the layer
          * advertises @ref LayerFeature::Composite, also
-         * @ref LayerState::NeedsCompositeOffsetSizeUpdate. See the flags for
-         * more information.
+         * @ref LayerState::NeedsCompositeOffsetSizeUpdate, and if the layer
+         * advertises @ref LayerFeature::IntrinsicSize, also
+         * @ref LayerState::NeedsIntrinsicSizeUpdate. See the flags for more
+         * information.
+         *
+         * If @p state contains @ref LayerState::NeedsDataUpdate, all data
+         * are marked in @ref modifiedDataMask() for the next @ref update().
+         * Use @ref setNeedsDataUpdate() to mark just particular data as
+         * modified instead.
          * @see @ref state(), @ref update()
          */
         void setNeedsUpdate(LayerStates state);
@@ -417,6 +452,20 @@ class MAGNUM_UI_EXPORT AbstractLayer {
          */
         std::size_t capacity() const;
 
+        /**
+         * @brief Reserve data storage
+         * @m_since_latest
+         *
+         * Grows the internal storage to have space for at least @p capacity
+         * items without reallocating, for example to avoid reallocations
+         * when populating a known amount of items. Doesn't change
+         * @ref capacity() or make any new handles available, these are still
+         * allocated only with @ref create(). Delegates to
+         * @ref doReserve() to reserve also storage in the subclass, if
+         * needed.
+         */
+        void reserve(std::size_t capacity);
+
         /**
          * @brief Count of used items in the data storage
          *
@@ -426,6 +475,50 @@ class MAGNUM_UI_EXPORT AbstractLayer {
          */
         std::size_t usedCount() const;
 
+        /**
+         * @brief Memory usage
+         * @m_since_latest
+         *
+         * The @ref MemoryUsage::capacity and @ref MemoryUsage::usedCount are
+         * the same as @ref capacity() and @ref usedCount(), the byte counts
+         * include the base data storage and whatever @ref doMemoryUsage()
+         * adds for the subclass. State shared among multiple layers, such as
+         * @ref BaseLayer::Shared or @ref TextLayer::Shared, isn't included.
+         * The operation is done with a @f$ \mathcal{O}(n) @f$ complexity
+         * where @f$ n @f$ is @ref capacity().
+         */
+        MemoryUsage memoryUsage() const;
+
+        /**
+         * @brief Compact the data storage
+         * @param[out] mapping  New handles for all data IDs
+         * @m_since_latest
+         *
+         * Renumbers all used data to be densely packed at the front of the
+         * storage, preserving their relative order, and releases the unused
+         * capacity, which makes @ref capacity() equal to @ref usedCount().
+         * Expects that @p mapping
+         * has a size of @ref capacity() before the call. For every data ID
+         * it's filled with a new handle of given data or with
+         * @ref DataHandle::Null if the ID was free. Data that didn't move
+         * keep their original handle, other handles are invalidated and
+         * have to be replaced by the ones from @p mapping. Data created in
+         * the released range after the storage grows again get a generation
+         * that doesn't match any handle to the released data, so the
+         * invalidated handles stay invalid.
+         *
+         * Delegates to @ref doCompact() to compact also storage in the
+         * subclass. Sets @ref LayerState::NeedsAttachmentUpdate and
+         * @ref LayerState::NeedsDataUpdate so everything indexed by the data
+         * ID gets regenerated in the next @ref update(), and
+         * @ref LayerState::NeedsDataClean so animations attached to the
+         * invalidated or released handles get removed in the next
+         * @ref AbstractUserInterface::clean(). The operation is done with a
+         * @f$ \mathcal{O}(n) @f$ complexity where @f$ n @f$ is
+         * @ref capacity().
+         */
+        void compact(const Containers::StridedArrayView1D<DataHandle>& mapping);
+
         /**
          * @brief Whether a data handle is valid
          *
@@ -524,6 +617,72 @@ class MAGNUM_UI_EXPORT AbstractLayer {
          */
         Containers::StridedArrayView1D<const NodeHandle> nodes() const;
 
+        /**
+         * @brief ID of the first data attached to each node
+         * @m_since_latest
+         *
+         * Used internally from @ref AbstractUserInterface::update() to go
+         * through data attached to visible nodes without having to iterate
+         * all data in the layer. Indexed by node ID, items are IDs of data
+         * with the lowest ID attached to given node or @cpp ~UnsignedInt{} @ce
+         * if there's no data attached. The list continues in
+         * @ref nodeNextDataIds(), in an increasing data ID order. The view
+         * has the same size as @ref nodeDataCounts() and can be smaller than
+         * the node count in the user interface, nodes with IDs outside of the
+         * range have no data attached. The lists are updated on every
+         * @ref create(), @ref attach(), @ref remove() and @ref cleanNodes()
+         * call.
+         */
+        Containers::StridedArrayView1D<const UnsignedInt> nodeFirstDataIds() const;
+
+        /**
+         * @brief Count of data attached to each node
+         * @m_since_latest
+         *
+         * Indexed by node ID, has the same size as @ref nodeFirstDataIds().
+         * See its documentation for more information.
+         */
+        Containers::StridedArrayView1D<const UnsignedInt> nodeDataCounts() const;
+
+        /**
+         * @brief ID of the next data attached to the same node
+         * @m_since_latest
+         *
+         * Indexed by data ID, items are IDs of the next data attached to the
+         * same node in an increasing data ID order, or @cpp ~UnsignedInt{} @ce
+         * if given data is the last one. Size of the returned view is the
+         * same as @ref capacity(). Items corresponding to data that aren't
+         * attached to any node or that are freed have unspecified values. See
+         * @ref nodeFirstDataIds() for more information.
+         */
+        Containers::StridedArrayView1D<const UnsignedInt> nodeNextDataIds() const;
+
+        /**
+         * @brief Mask of data modified since the previous update
+         * @m_since_latest
+         *
+         * Meant to be used by @ref doUpdate() implementations to regenerate
+         * only the data that actually changed. A bit is set for data that
+         * were created, attached to a different node or marked with
+         * @ref setNeedsDataUpdate() since the previous @ref update() call,
+         * all bits are set if @ref setNeedsUpdate() was called with
+         * @ref LayerState::NeedsDataUpdate, if the implementation reported
+         * @ref LayerState::NeedsDataUpdate from @ref doState() or if the
+         * @ref update() was called with @ref LayerState::NeedsDataUpdate that
+         * didn't originate from the layer. Bits for removed data may be set
+         * as well.
+         *
+         * The mask is cleared after every @ref update(). It only describes
+         * changes of the data themselves, changes in node offsets, sizes,
+         * opacity, enablement or order are still signalled just with the
+         * @ref LayerStates passed to @ref doUpdate(), which the
+         * implementation should then treat as affecting all data. When called
+         * from @ref doUpdate(), size of the returned view is the same as
+         * @ref capacity(), outside of it the view can be smaller, data
+         * outside of the range weren't modified.
+         */
+        Containers::BitArrayView modifiedDataMask() const;
+
         /**
          * @brief Generation counters for all data
          *
@@ -658,6 +817,25 @@ class MAGNUM_UI_EXPORT AbstractLayer {
          */
         void update(LayerStates state, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes);
 
+        /**
+         * @brief Apply intrinsic sizes of data contents to node sizes
+         * @m_since_latest
+         *
+         * Used internally from @ref AbstractUserInterface::update(). Exposed
+         * just for testing purposes, there should be no need to call this
+         * function directly and doing so may cause internal
+         * @ref AbstractUserInterface state update to misbehave. Expects that
+         * the layer supports @ref LayerFeature::IntrinsicSize. The
+         * @p nodeSizes view should be large enough to contain any valid node
+         * ID. Delegates to @ref doIntrinsicSizes(), see its documentation for
+         * more information about the arguments.
+         *
+         * Calling this function resets
+         * @ref LayerState::NeedsIntrinsicSizeUpdate.
+         * @see @ref features()
+         */
+        void intrinsicSizes(const Containers::StridedArrayView1D<Vector2>& nodeSizes);
+
         /**
          * @brief Composite previously rendered contents
          *
@@ -916,6 +1094,21 @@ class MAGNUM_UI_EXPORT AbstractLayer {
             #endif
         );
 
+        /**
+         * @brief Create multiple data
+         * @param[in] nodes     Nodes to attach to
+         * @param[out] handles  Where to put new data handles
+         * @m_since_latest
+         *
+         * Equivalent to calling @ref create(NodeHandle) for each item in
+         * @p nodes, but with the internal storage grown just once and the
+         * state updated just once for all data. Expects that the @p nodes
+         * and @p handles views have the same size. The subclass is meant to
+         * wrap this function in a public API and perform appropriate
+         * additional initialization work there.
+         */
+        void create(const Containers::StridedArrayView1D<const NodeHandle>& nodes, const Containers::StridedArrayView1D<DataHandle>& handles);
+
         /**
          * @brief Remove a data
          *
@@ -954,6 +1147,31 @@ class MAGNUM_UI_EXPORT AbstractLayer {
          */
         void remove(LayerDataHandle handle);
 
+        /**
+         * @brief Remove multiple data
+         * @m_since_latest
+         *
+         * Equivalent to calling @ref remove(DataHandle) for each item in
+         * @p handles, but with the state updated just once for all data.
+         * Expects that all handles are valid and that there are no
+         * duplicates.
+         */
+        void remove(const Containers::StridedArrayView1D<const DataHandle>& handles);
+
+        /**
+         * @brief Mark particular data as needing an update
+         * @m_since_latest
+         *
+         * Meant to be called by layer implementations when properties of a
+         * single data get modified. Compared to calling
+         * @ref setNeedsUpdate() with @ref LayerState::NeedsDataUpdate it marks
+         * just the data with ID @p id in @ref modifiedDataMask(), allowing
+         * @ref doUpdate() implementations to regenerate only what changed.
+         * Expects that @p id is less than @ref capacity(), the ID validity
+         * isn't checked in any other way.
+         */
+        void setNeedsDataUpdate(UnsignedInt id);
+
         /**
          * @brief Assign a data animator to this layer
          *
@@ -1027,9 +1245,11 @@ class MAGNUM_UI_EXPORT AbstractLayer {
          * implementation is expected to return a subset of
          * @ref LayerState::NeedsDataUpdate,
          * @relativeref{LayerState,NeedsCommonDataUpdate} and
-         * @relativeref{LayerState,NeedsSharedDataUpdate}, and if the layer
+         * @relativeref{LayerState,NeedsSharedDataUpdate}, if the layer
          * advertises @ref LayerFeature::Composite, also
-         * @ref LayerState::NeedsCompositeOffsetSizeUpdate.
+         * @ref LayerState::NeedsCompositeOffsetSizeUpdate, and if the layer
+         * advertises @ref LayerFeature::IntrinsicSize, also
+         * @ref LayerState::NeedsIntrinsicSizeUpdate.
          *
          * Default implementation returns an empty set.
          */
@@ -1077,6 +1297,56 @@ class MAGNUM_UI_EXPORT AbstractLayer {
          */
         virtual void doClean(Containers::BitArrayView dataIdsToRemove);
 
+        /**
+         * @brief Reserve storage in the subclass
+         * @param capacity  Capacity to reserve
+         *
+         * Implementation for @ref reserve(), meant to be used to reserve
+         * storage of additional per-item data the subclass maintains, to
+         * avoid reallocations in subsequent @ref create() calls. Called
+         * after the base storage is reserved.
+         *
+         * Default implementation does nothing.
+         */
+        virtual void doReserve(std::size_t capacity);
+
+        /**
+         * @brief Memory usage of the subclass
+         * @param[in,out] usage     Memory usage to add to
+         * @m_since_latest
+         *
+         * Implementation for @ref memoryUsage(), meant to add byte counts of
+         * additional storage the subclass maintains to
+         * @ref MemoryUsage::cpuByteCount and
+         * @relativeref{MemoryUsage,gpuByteCount} of @p usage. Called after
+         * the base storage is counted. Implementations in subclasses of
+         * other layers are expected to delegate to the parent
+         * implementation as well.
+         *
+         * Default implementation does nothing.
+         */
+        virtual void doMemoryUsage(MemoryUsage& usage) const;
+
+        /**
+         * @brief Compact storage in the subclass
+         * @param previousDataIds   Previous data ID for each new data ID
+         * @m_since_latest
+         *
+         * Implementation for @ref compact(), meant to move additional
+         * per-item data the subclass maintains to their new IDs and release
+         * the unused capacity. The @p previousDataIds view has a size of
+         * the new @ref capacity(), each item is either the same as the
+         * index, greater than the index or @cpp ~UnsignedInt{} @ce for data
+         * with disabled handles that don't contain anything. Thus the items
+         * can be moved in place by iterating the view from the front. Called
+         * after the base storage is compacted. Implementations in subclasses
+         * of other layers are expected to delegate to the parent
+         * implementation as well.
+         *
+         * Default implementation does nothing.
+         */
+        virtual void doCompact(const Containers::StridedArrayView1D<const UnsignedInt>& previousDataIds);
+
         /**
          * @brief Advance data animations in animators assigned to this layer
          * @param[in] time                  Time to which to advance
@@ -1246,6 +1516,14 @@ class MAGNUM_UI_EXPORT AbstractLayer {
          * example when @ref setNeedsUpdate() was called but the layer doesn't
          * have any data currently visible.
          *
+         * If @p state contains @ref LayerState::NeedsDataUpdate, the
+         * @ref modifiedDataMask() has bits set for data that changed since
+         * the previous call. If @p state doesn't contain anything else that
+         * affects all data, such as @ref LayerState::NeedsNodeOffsetSizeUpdate
+         * or @relativeref{LayerState,NeedsNodeOrderUpdate}, the implementation
+         * can regenerate only data from @p dataIds that are present in the
+         * mask and keep the rest from the previous call.
+         *
          * Default implementation does nothing. Data passed to this function
          * are subsequently passed to @ref doComposite() / @ref doDraw() calls
          * as well, the only difference is that @ref doUpdate() gets called
@@ -1255,6 +1533,28 @@ class MAGNUM_UI_EXPORT AbstractLayer {
          */
         virtual void doUpdate(LayerStates state, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes);
 
+        /**
+         * @brief Apply intrinsic sizes of data contents to node sizes
+         * @param[in,out] nodeSizes Node sizes indexed by node ID
+         * @m_since_latest
+         *
+         * Implementation for @ref intrinsicSizes(), which is called from
+         * @ref AbstractUserInterface::update() whenever
+         * @ref UserInterfaceState::NeedsLayoutUpdate or any of the states that
+         * imply it are present in @ref AbstractUserInterface::state(). Called
+         * only if @ref LayerFeature::IntrinsicSize is supported. Is always
+         * called after @ref doClean() and before any
+         * @ref AbstractLayouter::doUpdate() in the same update.
+         *
+         * The @p nodeSizes contain sizes set directly via
+         * @ref AbstractUserInterface::setNodeSize() or already enlarged by
+         * another layer. The implementation is expected to enlarge sizes of
+         * nodes its data are attached to in order to fit the data contents,
+         * and leave sizes of all other nodes unchanged. Layouters then take
+         * the resulting sizes as the input.
+         */
+        virtual void doIntrinsicSizes(const Containers::StridedArrayView1D<Vector2>& nodeSizes);
+
         /**
          * @brief Composite previously rendered contents
          * @param renderer          Renderer instance containing the previously
@@ -1347,7 +1647,11 @@ class MAGNUM_UI_EXPORT AbstractLayer {
          * @p clipRectDataCounts in the range given by @p clipRectOffset and
          * @p clipRectCount is equal to @p count. Unlike @ref doUpdate() or
          * @ref doClean(), this function is never called with an empty
-         * @p count.
+         * @p count. If there's no other layer drawing in between, data for
+         * multiple consecutive top-level nodes are passed in a single call.
+         * That's not done for layers that support
+         * @ref LayerFeature::Composite, where each top-level node is drawn
+         * separately.
          */
         virtual void doDraw(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, std::size_t offset, std::size_t count, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, std::size_t clipRectOffset, std::size_t clipRectCount, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes);
 
@@ -1685,6 +1989,7 @@ class MAGNUM_UI_EXPORT AbstractLayer {
 
         /* Common implementations for foo(DataHandle, ...) and
            foo(LayerDataHandle, ...) */
+        MAGNUM_UI_LOCAL DataHandle createInternal(NodeHandle node);
         MAGNUM_UI_LOCAL void attachInternal(UnsignedInt id, NodeHandle node);
         MAGNUM_UI_LOCAL void removeInternal(UnsignedInt id);
 
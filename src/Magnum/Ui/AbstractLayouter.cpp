@@ -34,6 +34,8 @@
 #include <Magnum/Math/Vector2.h>
 
 #include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/MemoryUsage.h"
+#include "Magnum/Ui/Implementation/memoryUsage.h"
 
 namespace Magnum { namespace Ui {
 
@@ -155,6 +157,11 @@ std::size_t AbstractLayouter::capacity() const {
     return _state->layouts.size();
 }
 
+void AbstractLayouter::reserve(const std::size_t capacity) {
+    arrayReserve(_state->layouts, capacity);
+    doReserve(capacity);
+}
+
 std::size_t AbstractLayouter::usedCount() const {
     /* The node is null only for free layouts, so compared to all other
        usedCount() implementations we can iterate directly instead of going
@@ -168,6 +175,16 @@ std::size_t AbstractLayouter::usedCount() const {
     return state.layouts.size() - free;
 }
 
+MemoryUsage AbstractLayouter::memoryUsage() const {
+    const State& state = *_state;
+    MemoryUsage usage;
+    usage.cpuByteCount = Implementation::arrayByteCount(state.layouts);
+    usage.capacity = state.layouts.size();
+    usage.usedCount = usedCount();
+    doMemoryUsage(usage);
+    return usage;
+}
+
 bool AbstractLayouter::isHandleValid(const LayouterDataHandle handle) const {
     if(handle == LayouterDataHandle::Null)
         return false;
@@ -345,6 +362,10 @@ void AbstractLayouter::cleanNodes(const Containers::StridedArrayView1D<const Uns
 
 void AbstractLayouter::doClean(Containers::BitArrayView) {}
 
+void AbstractLayouter::doReserve(std::size_t) {}
+
+void AbstractLayouter::doMemoryUsage(MemoryUsage&) const {}
+
 void AbstractLayouter::update(const Containers::BitArrayView layoutIdsToUpdate, const Containers::StridedArrayView1D<const UnsignedInt>& topLevelLayoutIds, const Containers::StridedArrayView1D<const NodeHandle>& nodeParents, const Containers::StridedArrayView1D<Vector2>& nodeOffsets, const Containers::StridedArrayView1D<Vector2>& nodeSizes) {
     CORRADE_ASSERT(layoutIdsToUpdate.size() == capacity(),
         "Ui::AbstractLayouter::update(): expected layoutIdsToUpdate to have" << capacity() << "bits but got" << layoutIdsToUpdate.size(), );
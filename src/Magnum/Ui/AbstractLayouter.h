@@ -165,6 +165,20 @@ class MAGNUM_UI_EXPORT AbstractLayouter {
          */
         std::size_t capacity() const;
 
+        /**
+         * @brief Reserve layout storage
+         * @m_since_latest
+         *
+         * Grows the internal storage to have space for at least @p capacity
+         * items without reallocating, for example to avoid reallocations
+         * when populating a known amount of items. Doesn't change
+         * @ref capacity() or make any new handles available, these are still
+         * allocated only with @ref add(). Delegates to
+         * @ref doReserve() to reserve also storage in the subclass, if
+         * needed.
+         */
+        void reserve(std::size_t capacity);
+
         /**
          * @brief Count of used items in the layout storage
          *
@@ -174,6 +188,19 @@ class MAGNUM_UI_EXPORT AbstractLayouter {
          */
         std::size_t usedCount() const;
 
+        /**
+         * @brief Memory usage
+         * @m_since_latest
+         *
+         * The @ref MemoryUsage::capacity and @ref MemoryUsage::usedCount are
+         * the same as @ref capacity() and @ref usedCount(), the byte counts
+         * include the base layout storage and whatever @ref doMemoryUsage()
+         * adds for the subclass. The operation is done with a
+         * @f$ \mathcal{O}(n) @f$ complexity where @f$ n @f$ is
+         * @ref capacity().
+         */
+        MemoryUsage memoryUsage() const;
+
         /**
          * @brief Whether a layout handle is valid
          *
@@ -400,6 +427,34 @@ class MAGNUM_UI_EXPORT AbstractLayouter {
          */
         virtual void doClean(Containers::BitArrayView layoutIdsToRemove);
 
+        /**
+         * @brief Reserve storage in the subclass
+         * @param capacity  Capacity to reserve
+         *
+         * Implementation for @ref reserve(), meant to be used to reserve
+         * storage of additional per-item data the subclass maintains, to
+         * avoid reallocations in subsequent @ref add() calls. Called
+         * after the base storage is reserved.
+         *
+         * Default implementation does nothing.
+         */
+        virtual void doReserve(std::size_t capacity);
+
+        /**
+         * @brief Memory usage of the subclass
+         * @param[in,out] usage     Memory usage to add to
+         * @m_since_latest
+         *
+         * Implementation for @ref memoryUsage(), meant to add byte counts of
+         * additional storage the subclass maintains to
+         * @ref MemoryUsage::cpuByteCount and
+         * @relativeref{MemoryUsage,gpuByteCount} of @p usage. Called after
+         * the base storage is counted.
+         *
+         * Default implementation does nothing.
+         */
+        virtual void doMemoryUsage(MemoryUsage& usage) const;
+
         /**
          * @brief Update selected top-level layouts
          * @param[in] layoutIdsToUpdate Layout IDs to update
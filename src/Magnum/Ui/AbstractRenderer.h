@@ -211,6 +211,29 @@ CORRADE_ENUMSET_OPERATORS(RendererDrawStates)
 A renderer implementation handles GPU-API-specific framebuffer switching,
 clearing and draw state setup. You'll most likely instantiate the class through
 @ref RendererGL, which contains a concrete OpenGL implementation.
+
+@section Ui-AbstractRenderer-subclassing Subclassing
+
+A renderer for a different GPU API implements @ref doFeatures(),
+@ref doSetupFramebuffers() and @ref doTransition(). The interface makes no
+assumptions about how the GPU commands are submitted, so for example a Vulkan
+implementation can record into a command buffer supplied by the application
+for every frame. It would then begin a render pass on a transition to
+@ref RendererTargetState::Draw, and end it on a transition to
+@ref RendererTargetState::Composite or @relativeref{RendererTargetState,Final}.
+On a transition to @relativeref{RendererTargetState,Composite} it would record
+a barrier that makes the framebuffer contents readable by the compositing
+operation. Blending and scissor, if not part of the pipeline state, are then
+set as dynamic state based on the @ref RendererDrawStates passed to
+@ref doTransition().
+
+The layers are GPU-API-specific as well. The API-independent functionality is
+in @ref BaseLayer and @ref TextLayer, while @ref BaseLayerGL and
+@ref TextLayerGL implement just @ref AbstractLayer::doDraw() and
+@ref AbstractLayer::doComposite() on top. Layers for a different GPU API are
+expected to be implemented the same way. As @ref AbstractLayer::doDraw() gets
+no renderer reference, they'd need to keep a reference to the renderer
+instance to access its current command buffer or an equivalent.
 @see @ref AbstractUserInterface::setRendererInstance()
 */
 class MAGNUM_UI_EXPORT AbstractRenderer {
@@ -277,8 +277,8 @@ bool AbstractStyle::apply(UserInterface& ui, const StyleFeatures features, Plugi
     if(features >= StyleFeature::TextLayerImages) {
         CORRADE_ASSERT(ui.hasTextLayer(),
             "Ui::AbstractStyle::apply(): text layer not present in the user interface", {});
-        CORRADE_ASSERT(importerManager,
-            "Ui::AbstractStyle::apply(): importerManager has to be specified for applying text layer style images", {});
+        /* The importer manager isn't checked, as a style may provide the
+           images without importing anything */
     }
     if(features >= StyleFeature::EventLayer) {
         CORRADE_ASSERT(ui.hasEventLayer(),
@@ -420,8 +420,10 @@ class MAGNUM_UI_EXPORT AbstractStyle {
          * @cpp nullptr @ce; and if @ref StyleFeature::TextLayerImages is
          * present in @p features, expects that either the @ref TextLayer is
          * already present in the user interface or that
-         * @ref StyleFeature::TextLayer is included in @p features as well, and
-         * that @p importerManager is not @cpp nullptr @ce. Returns
+         * @ref StyleFeature::TextLayer is included in @p features as well.
+         * The @p importerManager can be @cpp nullptr @ce, it's up to the
+         * style implementation to fail if it needs to import images and no
+         * manager is passed. Returns
          * @cpp true @ce on success, prints a message to
          * @relativeref{Magnum,Error} and returns @cpp false @ce if some
          * run-time error happened during style preparation, such as a plugin
@@ -580,9 +582,11 @@ class MAGNUM_UI_EXPORT AbstractStyle {
          * @ref textLayerGlyphCacheFormat(), with a size at least
          * @ref textLayerGlyphCacheSize() for @p features and padding at least
          * @ref textLayerGlyphCachePadding(), and @p fontManager is guaranteed
-         * to not be @cpp nullptr @ce; and if
-         * @ref StyleFeature::TextLayerImages is present in @p features, the
-         * @p importerManager is guaranteed to not be @cpp nullptr @ce.
+         * to not be @cpp nullptr @ce. The @p importerManager can be
+         * @cpp nullptr @ce even if @ref StyleFeature::TextLayerImages is
+         * present in @p features. If the implementation needs it to import
+         * images, it should print a message to @relativeref{Magnum,Error}
+         * and return @cpp false @ce in that case.
          */
         virtual bool doApply(UserInterface& ui, StyleFeatures features, PluginManager::Manager<Trade::AbstractImporter>* importerManager, PluginManager::Manager<Text::AbstractFont>* fontManager) const = 0;
 
@@ -28,12 +28,14 @@
 
 #include <Corrade/Containers/ArrayTuple.h>
 #include <Corrade/Containers/BitArrayView.h>
-#include <Corrade/Containers/BitArray.h>
 #include <Corrade/Containers/EnumSet.hpp>
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Iterable.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
 #include <Corrade/Containers/Reference.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Magnum/Math/Range.h>
 #include <Magnum/Math/Time.h>
 #include <Magnum/Math/Vector2.h>
 
@@ -43,9 +45,11 @@
 #include "Magnum/Ui/AbstractRenderer.h"
 #include "Magnum/Ui/Event.h"
 #include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/MemoryUsage.h"
 #include "Magnum/Ui/NodeFlags.h"
+#include "Magnum/Ui/UpdateQueue.h"
 #include "Magnum/Ui/Implementation/abstractUserInterface.h"
-#include "Magnum/Ui/Implementation/orderNodesBreadthFirstInto.h"
+#include "Magnum/Ui/Implementation/memoryUsage.h"
 
 namespace Magnum { namespace Ui {
 
@@ -73,6 +77,7 @@ Debug& operator<<(Debug& debug, const UserInterfaceState value) {
         _c(NeedsDataClean)
         _c(NeedsNodeClean)
         _c(NeedsAnimationAdvance)
+        _c(NeedsPointerMoveEventDispatch)
         #undef _c
         /* LCOV_EXCL_STOP */
     }
@@ -80,6 +85,47 @@ Debug& operator<<(Debug& debug, const UserInterfaceState value) {
     return debug << "(" << Debug::nospace << Debug::hex << UnsignedShort(value) << Debug::nospace << ")";
 }
 
+Debug& operator<<(Debug& debug, const UserInterfacePhase value) {
+    debug << "Ui::UserInterfacePhase" << Debug::nospace;
+
+    switch(value) {
+        /* LCOV_EXCL_START */
+        #define _c(value) case UserInterfacePhase::value: return debug << "::" #value;
+        _c(Clean)
+        _c(NodeOrder)
+        _c(Layout)
+        _c(Cull)
+        _c(DataOrder)
+        _c(LayerUpdate)
+        _c(Draw)
+        _c(Composite)
+        #undef _c
+        /* LCOV_EXCL_STOP */
+    }
+
+    return debug << "(" << Debug::nospace << Debug::hex << UnsignedByte(value) << Debug::nospace << ")";
+}
+
+Debug& operator<<(Debug& debug, const UserInterfaceTraceScope value) {
+    debug << "Ui::UserInterfaceTraceScope" << Debug::nospace;
+
+    switch(value) {
+        /* LCOV_EXCL_START */
+        #define _c(value) case UserInterfaceTraceScope::value: return debug << "::" #value;
+        _c(LayerUpdate)
+        _c(LayerComposite)
+        _c(LayerDraw)
+        _c(LayouterUpdate)
+        _c(AnimatorAdvance)
+        _c(LayerAdvanceAnimations)
+        _c(Event)
+        #undef _c
+        /* LCOV_EXCL_STOP */
+    }
+
+    return debug << "(" << Debug::nospace << Debug::hex << UnsignedByte(value) << Debug::nospace << ")";
+}
+
 Debug& operator<<(Debug& debug, const UserInterfaceStates value) {
     return Containers::enumSetDebugOutput(debug, value, "Ui::UserInterfaceStates{}", {
         UserInterfaceState::NeedsNodeClean,
@@ -107,7 +153,8 @@ Debug& operator<<(Debug& debug, const UserInterfaceStates value) {
         UserInterfaceState::NeedsDataAttachmentUpdate,
         /* Implied by NeedsDataAttachmentUpdate, has to be after */
         UserInterfaceState::NeedsDataUpdate,
-        UserInterfaceState::NeedsAnimationAdvance
+        UserInterfaceState::NeedsAnimationAdvance,
+        UserInterfaceState::NeedsPointerMoveEventDispatch
     });
 }
 
@@ -374,6 +421,12 @@ union Node {
         /* Initial node opacity. The actual value passed to layers is
            multiplied with opacity of all parents. */
         Float opacity;
+
+        /* The child / sibling links are only needed when creating and
+           removing nodes, so they're in a separate `NodeLinks` array to keep
+           this struct at 32 bytes, two nodes in a cache line, for the
+           per-frame passes in update(). With MAGNUM_UI_LARGE_HANDLES it's
+           40 bytes due to the larger parent handle. */
     } used;
 
     /* Used only if the Node is among the free ones */
@@ -403,6 +456,28 @@ static_assert(
     offsetof(Node::Used, generation) == offsetof(Node::Free, generation),
     "Node::Used and Free layout not compatible");
 
+/* With 64-bit handles the parent handle is 8 bytes and aligns the whole
+   struct to 8 bytes, making it 40 bytes in total */
+#ifndef MAGNUM_UI_LARGE_HANDLES
+static_assert(sizeof(Node) == 32, "Node not 32 bytes");
+#else
+static_assert(sizeof(Node) == 40, "Node not 40 bytes");
+#endif
+
+/* Doubly linked list of direct children, as IDs into the `nodes` array,
+   ~UnsignedInt{} if there's no first child / next / previous sibling. A node
+   is in the list of its parent only as long as the parent handle is valid,
+   once the parent is removed the children are put into `State::orphanedNodes`
+   and removed in clean(), which makes the cost proportional to the size of the
+   removed subtree and not to the count of all nodes. Stored separately from
+   `Node`, indexed by the same ID, to not pollute the cache in passes that
+   don't need the hierarchy links. */
+struct NodeLinks {
+    UnsignedInt firstChild;
+    UnsignedInt nextSibling;
+    UnsignedInt previousSibling;
+};
+
 /* A doubly linked list is needed in order to have clearNodeOrder() work
    conveniently (so, not "clear node order for a node that's ordered after
    <handle>" like std::forward_list does) and in O(1). */
@@ -442,6 +517,9 @@ struct AbstractUserInterface::State {
     /* Renderer instance */
     Containers::Pointer<AbstractRenderer> renderer;
 
+    /* Update queue instance, optional */
+    Containers::Pointer<UpdateQueue> updateQueue;
+
     /* Layers, indexed by LayerHandle */
     Containers::Array<Layer> layers;
     /* The `Layer` then has a `next` member containing the next layer in the
@@ -499,6 +577,9 @@ struct AbstractUserInterface::State {
 
     /* Nodes, indexed by NodeHandle */
     Containers::Array<Node> nodes;
+    /* Child and sibling links of nodes, indexed by NodeHandle as well, always
+       having the same size as `nodes` */
+    Containers::Array<NodeLinks> nodeLinks;
     /* Indices into the `nodes` array. The `Node` then has a `nextFree`
        member containing the next free index. To avoid repeatedly reusing the
        same handles and exhausting their generation counter too soon, new
@@ -554,11 +635,44 @@ struct AbstractUserInterface::State {
     /* Focused node */
     NodeHandle currentFocusedNode = NodeHandle::Null;
 
+    /* Pointer move event queued by pointerMoveEvent() if coalescing is
+       enabled, together with its unscaled position. Dispatched on the next
+       update() or before any other event. */
+    bool pointerMoveEventCoalescing = false;
+    Containers::Optional<PointerMoveEvent> pendingPointerMoveEvent;
+    Vector2 pendingPointerMoveEventPosition;
+
+    /* Node for which the hover fast path in pointerMoveEventInternal() was
+       last calculated, together with visible node indices leading to it from
+       a top-level node, index of that top-level node in
+       `visibleFrontToBackTopLevelNodeIndices` and the area in which callEvent()
+       can reach it. If `hoverFastPathUnobstructed`
+       is set, no node that's visited before it in callEvent() has event data
+       overlapping its area, which means any position inside its area would
+       reach it first in the hit testing. Reset on every update() that
+       recalculates the visible node event bounds. */
+    NodeHandle hoverFastPathNode = NodeHandle::Null;
+    bool hoverFastPathUnobstructed = false;
+    UnsignedInt hoverFastPathTopLevelIndex = 0;
+    Vector2 hoverFastPathMin, hoverFastPathMax;
+    Containers::Array<UnsignedInt> hoverFastPathVisibleNodeIndices;
+
     /* Data for updates, event handling and drawing, repopulated by clean() and
        update() */
     Containers::ArrayTuple nodeStateStorage;
+    /* Children ranges for each node, as calculated by
+       orderVisibleNodesDepthFirstInto(). Kept in order to be able to patch
+       `visibleNodeIds` and `visibleNodeChildrenCounts` in place with
+       updateVisibleNodesDepthFirstInPlace() if just NodeFlag::Hidden changed
+       on a few nodes since the last update(). */
+    Containers::ArrayView<UnsignedInt> nodeChildrenOffsets;
+    Containers::ArrayView<UnsignedInt> nodeChildren;
     Containers::ArrayView<UnsignedInt> visibleNodeIds;
     Containers::ArrayView<UnsignedInt> visibleNodeChildrenCounts;
+    /* Indexed by node ID, index of given node in `visibleNodeIds`. Contains
+       arbitrary values for nodes that aren't visible, so `visibleNodeIds`
+       has to be checked to verify the node is actually there. */
+    Containers::ArrayView<UnsignedInt> visibleNodeIndices;
     Containers::StridedArrayView1D<UnsignedInt> visibleFrontToBackTopLevelNodeIndices;
     Containers::ArrayView<Vector2> nodeOffsets;
     Containers::ArrayView<Vector2> nodeSizes;
@@ -567,6 +681,15 @@ struct AbstractUserInterface::State {
     Containers::MutableBitArrayView visibleNodeMask;
     Containers::MutableBitArrayView visibleEventNodeMask;
     Containers::MutableBitArrayView visibleEnabledNodeMask;
+    /* Visible nodes that can be focused, i.e. that are Focusable and have
+       their bit set in visibleEventNodeMask, in the order they're in
+       `visibleNodeIds`. A prefix of an allocation that's sized to the node
+       count. */
+    Containers::ArrayView<UnsignedInt> focusChain;
+    /* Indexed by node ID, count of `focusChain` items before given node in
+       `visibleNodeIds`. Contains arbitrary values for nodes that aren't
+       visible, so `visibleNodeIds` has to be checked first. */
+    Containers::ArrayView<UnsignedInt> focusChainOffsets;
     Containers::ArrayView<Vector2> clipRectOffsets;
     Containers::ArrayView<Vector2> clipRectSizes;
     Containers::ArrayView<UnsignedInt> clipRectNodeCounts;
@@ -574,9 +697,6 @@ struct AbstractUserInterface::State {
     Containers::ArrayView<UnsignedInt> topLevelLayoutOffsets;
     Containers::ArrayView<UnsignedByte> topLevelLayoutLayouterIds;
     Containers::ArrayView<UnsignedInt> topLevelLayoutIds;
-    /** @todo this is a separate allocation from layoutStateStorage, unify
-        somehow */
-    Containers::BitArray layoutMasks;
     Containers::ArrayTuple dataStateStorage;
     /* Data offset, clip rect offset, composite rect offset */
     Containers::ArrayView<Containers::Triple<UnsignedInt, UnsignedInt, UnsignedInt>> dataToUpdateLayerOffsets;
@@ -593,10 +713,286 @@ struct AbstractUserInterface::State {
     /* Indexed by node ID in order to make it possible to look up node data by
        node ID, however contains data only for visible nodes */
     Containers::ArrayView<UnsignedInt> visibleNodeEventDataOffsets;
-    Containers::ArrayView<DataHandle> visibleNodeEventData;
+    Containers::ArrayView<UnsignedInt> visibleNodeEventData;
+    /* Indexed by node ID, bounds of all nodes with event data in the subtree
+       of given visible node, to avoid descending into subtrees where the
+       event would not get handled anyway */
+    Containers::ArrayView<Vector2> visibleNodeEventBoundsMin;
+    Containers::ArrayView<Vector2> visibleNodeEventBoundsMax;
     UnsignedInt drawCount = 0, clipRectCount = 0;
+    /* Incremented every time draw() output may change, see drawGeneration() */
+    UnsignedLong drawGeneration = 0;
+
+    /* IDs of non-top-level nodes that had NodeFlag::Hidden changed since the
+       last update(), used to patch the visible node order in place. If
+       `visibleNodesNeedFullUpdate` is set, the node hierarchy, node count or
+       top-level node order changed, there are nested top-level nodes, or
+       there were too many changes, and the visible node order is calculated
+       from scratch instead. */
+    Containers::Array<UnsignedInt> hiddenChangedNodeIds;
+    bool visibleNodesNeedFullUpdate = true;
+    /* Whether root nodes already in the top-level node order were moved or
+       removed from it since the last update(). Unless
+       `visibleNodesNeedFullUpdate` is set as well, the visible ranges of
+       top-level nodes are then just permuted to the new order. */
+    bool visibleNodesNeedTopLevelReorder = false;
+    /* Whether the top-level node order contains nested top-level nodes, which
+       makes the visible hierarchy of a node not contiguous in
+       `visibleNodeIds` */
+    bool hasNestedTopLevelNodes = false;
+
+    /* IDs of nodes that had their offset changed since the last update(),
+       used to recalculate absolute offsets only for subtrees of those nodes.
+       If `nodeOffsetsNeedFullUpdate` is set, node sizes changed, node offsets
+       were changed by animators or there were too many changes, and offsets
+       of all nodes are recalculated instead. */
+    Containers::Array<UnsignedInt> offsetChangedNodeIds;
+    bool nodeOffsetsNeedFullUpdate = true;
+
+    /* IDs of nodes that had their opacity changed since the last update(),
+       used to recalculate absolute opacities only for subtrees of those
+       nodes. If `nodeOpacitiesNeedFullUpdate` is set or the visible node
+       hierarchy changed, opacities of all nodes are recalculated instead. */
+    Containers::Array<UnsignedInt> opacityChangedNodeIds;
+    bool nodeOpacitiesNeedFullUpdate = true;
+
+    /* Union of areas that changed since the last draw(), calculated from
+       old and new rects of subtrees that got an incremental offset or
+       opacity update. If `damageNeedsFull` is set, anything else changed
+       and the whole UI area is considered damaged. */
+    Range2D damageRect;
+    bool damageNeedsFull = true;
+
+    /* Rectangles of opaque top-level nodes, used by
+       cullOccludedVisibleNodesInto() in update() and kept around to avoid
+       allocating it every time */
+    Containers::Array<Containers::Pair<Vector2, Vector2>> occluders;
+
+    /* Layer update executor and its user data, if set. The `layerUpdates`
+       array contains IDs of layers to update together with states to update
+       in the current update() call, kept around to avoid allocating it every
+       time. */
+    void(*layerUpdateExecutor)(UnsignedInt, void(*)(void*, UnsignedInt), void*, void*){};
+    void* layerUpdateExecutorUserData{};
+    Containers::Array<Containers::Pair<UnsignedInt, LayerStates>> layerUpdates;
+
+    /* Set by removeLayer(), which makes the draw order stale even though
+       the layer itself doesn't report any state anymore. Reset in update(). */
+    bool drawOrderNeedsUpdate = true;
+    /* Set by setDisjointTopLevelNodeDrawMerging() */
+    bool disjointTopLevelNodeDrawMerging = false;
+
+    /* Handles of nodes whose parent got removed, to be removed in the next
+       clean(). A handle that's no longer valid at that point was removed
+       explicitly in the meantime and is skipped. */
+    Containers::Array<NodeHandle> orphanedNodes;
+
+    /* Node update statistics, enabled if `nodeUpdateStatisticsFrameCount`
+       is non-zero. The history masks contain `nodeUpdateStatisticsFrameCount`
+       consecutive masks, each having as many bits as there's counts, with
+       the one at `nodeUpdateStatisticsFrameIndex` being the oldest. The
+       updated masks are filled since the last update() and committed to the
+       history and counts in update(). All are grown on demand. */
+    UnsignedInt nodeUpdateStatisticsFrameCount = 0;
+    UnsignedInt nodeUpdateStatisticsFrameIndex = 0;
+    UnsignedLong nodeUpdateStatisticsFrame = 0;
+    Containers::BitArray nodeDataUpdateHistory;
+    Containers::BitArray nodeLayoutUpdateHistory;
+    Containers::BitArray nodeDataUpdatedMask;
+    Containers::BitArray nodeLayoutUpdatedMask;
+    Containers::Array<UnsignedShort> nodeDataUpdateCounts;
+    Containers::Array<UnsignedShort> nodeLayoutUpdateCounts;
+
+    void growNodeUpdateStatistics();
+    void resetNodeUpdateStatistics(UnsignedInt id);
+    void commitNodeUpdateStatistics();
+
+    /* Phase callback and its user data, if set */
+    void(*phaseCallback)(UserInterfacePhase, bool, void*){};
+    void* phaseCallbackUserData{};
+
+    void reportPhase(UserInterfacePhase phase, bool end) {
+        if(phaseCallback) phaseCallback(phase, end, phaseCallbackUserData);
+    }
+
+    /* Trace callback and its user data, if set. Called only with
+       MAGNUM_UI_TRACING, through TraceScope. */
+    void(*traceCallback)(UserInterfaceTraceScope, UnsignedLong, bool, void*){};
+    void* traceCallbackUserData{};
+
+    /* Storage allocator and its user data, if set */
+    Containers::Array<char>(*storageAllocator)(std::size_t, std::size_t, void*){};
+    void* storageAllocatorUserData{};
+
+    /* Count of all allocations done by allocateStorage(),
+       allocateScratchStorage() and resetScratchStorage() */
+    std::size_t storageAllocationCount = 0;
+
+    /* Scratch memory for temporary allocations in update() and
+       advanceAnimations(). Allocations are bumped from `scratchOffset`, if
+       they don't fit they fall back to a dedicated allocation and the scratch
+       memory is then grown to `scratchSizeNeeded` in the next
+       resetScratchStorage() call. It's never shrunk, so once it's large
+       enough, steady-state updates don't allocate anything. */
+    Containers::Array<char> scratch;
+    std::size_t scratchOffset = 0;
+    std::size_t scratchSizeNeeded = 0;
+
+    Containers::Array<char> allocate(const std::size_t size, const std::size_t alignment) {
+        ++storageAllocationCount;
+        if(storageAllocator)
+            return storageAllocator(size, alignment, storageAllocatorUserData);
+        return Containers::Array<char>{NoInit, size};
+    }
+
+    /* Used for all resident ArrayTuple allocations in update() */
+    Containers::ArrayTuple allocateStorage(std::initializer_list<Containers::ArrayTuple::Item> items) {
+        if(!storageAllocator) {
+            ++storageAllocationCount;
+            return Containers::ArrayTuple{items};
+        }
+        return Containers::ArrayTuple{items, [this](const std::size_t size, const std::size_t alignment) {
+            return allocate(size, alignment);
+        }};
+    }
+
+    /* Used for temporary ArrayTuple allocations in update() and
+       advanceAnimations(), which are all freed before the function exits */
+    Containers::ArrayTuple allocateScratchStorage(std::initializer_list<Containers::ArrayTuple::Item> items) {
+        return Containers::ArrayTuple{items, [this](const std::size_t size, const std::size_t alignment) {
+            /* Conservatively assume the worst-case padding for the next time
+               the scratch memory is sized */
+            scratchSizeNeeded += size + alignment - 1;
+
+            const std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(scratch.data());
+            const std::size_t offset = (begin + scratchOffset + alignment - 1)/alignment*alignment - begin;
+            if(offset + size <= scratch.size()) {
+                scratchOffset = offset + size;
+                /* The memory is owned by the scratch, so the deleter does
+                   nothing */
+                return Containers::Array<char>{scratch.data() + offset, size, [](char*, std::size_t) {}};
+            }
+
+            return allocate(size, alignment);
+        }};
+    }
+
+    /* Called at the start of update() and advanceAnimations(), there
+       shouldn't be any scratch allocation alive at that point */
+    void resetScratchStorage() {
+        if(scratchSizeNeeded > scratch.size())
+            scratch = allocate(scratchSizeNeeded, 1);
+        scratchOffset = 0;
+        scratchSizeNeeded = 0;
+    }
 };
 
+namespace {
+
+/* If more than this many nodes have a particular property changed, update()
+   recalculates given state for all nodes instead of patching it in place for
+   each changed node */
+constexpr std::size_t MaxIncrementalUpdateNodeCount = 32;
+
+/* Reports the beginning of a trace scope on construction and its end on
+   destruction, so early returns are handled implicitly. Without
+   MAGNUM_UI_TRACING it's an empty type that the compiler removes
+   completely. */
+#ifdef MAGNUM_UI_TRACING
+struct TraceScope {
+    explicit TraceScope(void(*callback)(UserInterfaceTraceScope, UnsignedLong, bool, void*), void* userData, UserInterfaceTraceScope scope, UnsignedLong handle = 0): callback{callback}, userData{userData}, scope{scope}, handle{handle} {
+        if(callback) callback(scope, handle, false, userData);
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+    ~TraceScope() {
+        if(callback) callback(scope, handle, true, userData);
+    }
+
+    void(*callback)(UserInterfaceTraceScope, UnsignedLong, bool, void*);
+    void* userData;
+    UserInterfaceTraceScope scope;
+    UnsignedLong handle;
+};
+#else
+struct TraceScope {
+    explicit TraceScope(void(*)(UserInterfaceTraceScope, UnsignedLong, bool, void*), void*, UserInterfaceTraceScope, UnsignedLong = 0) {}
+};
+#endif
+
+}
+
+void AbstractUserInterface::State::growNodeUpdateStatistics() {
+    /* Grow with some headroom to not reallocate on every created node */
+    const std::size_t previousCapacity = nodeDataUpdateCounts.size();
+    if(nodes.size() <= previousCapacity)
+        return;
+    const std::size_t capacity = Math::max(nodes.size(), previousCapacity*2);
+
+    const auto grow = [&](Containers::BitArray& mask, const std::size_t frameCount) {
+        Containers::BitArray grown{ValueInit, frameCount*capacity};
+        for(std::size_t frame = 0; frame != frameCount; ++frame)
+            for(std::size_t i = 0; i != previousCapacity; ++i)
+                if(mask[frame*previousCapacity + i])
+                    grown.set(frame*capacity + i);
+        mask = Utility::move(grown);
+    };
+    grow(nodeDataUpdateHistory, nodeUpdateStatisticsFrameCount);
+    grow(nodeLayoutUpdateHistory, nodeUpdateStatisticsFrameCount);
+    grow(nodeDataUpdatedMask, 1);
+    grow(nodeLayoutUpdatedMask, 1);
+
+    Containers::Array<UnsignedShort> dataCounts{ValueInit, capacity};
+    Containers::Array<UnsignedShort> layoutCounts{ValueInit, capacity};
+    Utility::copy(nodeDataUpdateCounts, dataCounts.prefix(previousCapacity));
+    Utility::copy(nodeLayoutUpdateCounts, layoutCounts.prefix(previousCapacity));
+    nodeDataUpdateCounts = Utility::move(dataCounts);
+    nodeLayoutUpdateCounts = Utility::move(layoutCounts);
+}
+
+void AbstractUserInterface::State::resetNodeUpdateStatistics(const UnsignedInt id) {
+    const std::size_t capacity = nodeDataUpdateCounts.size();
+    for(std::size_t frame = 0; frame != nodeUpdateStatisticsFrameCount; ++frame) {
+        nodeDataUpdateHistory.reset(frame*capacity + id);
+        nodeLayoutUpdateHistory.reset(frame*capacity + id);
+    }
+    nodeDataUpdatedMask.reset(id);
+    nodeLayoutUpdatedMask.reset(id);
+    nodeDataUpdateCounts[id] = 0;
+    nodeLayoutUpdateCounts[id] = 0;
+}
+
+void AbstractUserInterface::State::commitNodeUpdateStatistics() {
+    growNodeUpdateStatistics();
+
+    /* Replace the oldest frame in the history with the current one, adjusting
+       the counts by the difference */
+    const std::size_t capacity = nodeDataUpdateCounts.size();
+    const std::size_t offset = nodeUpdateStatisticsFrameIndex*capacity;
+    const auto commit = [&](Containers::BitArray& history, Containers::BitArray& updated, Containers::Array<UnsignedShort>& counts) {
+        for(std::size_t i = 0; i != capacity; ++i) {
+            const bool previous = history[offset + i];
+            if(previous == updated[i])
+                continue;
+            if(previous) {
+                --counts[i];
+                history.reset(offset + i);
+            } else {
+                ++counts[i];
+                history.set(offset + i);
+            }
+        }
+        updated.resetAll();
+    };
+    commit(nodeDataUpdateHistory, nodeDataUpdatedMask, nodeDataUpdateCounts);
+    commit(nodeLayoutUpdateHistory, nodeLayoutUpdatedMask, nodeLayoutUpdateCounts);
+
+    nodeUpdateStatisticsFrameIndex = (nodeUpdateStatisticsFrameIndex + 1) % nodeUpdateStatisticsFrameCount;
+    ++nodeUpdateStatisticsFrame;
+}
+
 AbstractUserInterface::AbstractUserInterface(NoCreateT): _state{InPlaceInit} {}
 
 AbstractUserInterface::AbstractUserInterface(const Vector2& size, const Vector2& windowSize, const Vector2i& framebufferSize): AbstractUserInterface{NoCreate} {
@@ -643,6 +1039,10 @@ AbstractUserInterface& AbstractUserInterface::setSize(const Vector2& size, const
     if(framebufferSizeDifferent && state.renderer)
         state.renderer->setupFramebuffers(framebufferSize);
 
+    /* Any size change means the drawn output is different */
+    if(sizeOrFramebufferSizeDifferent)
+        ++state.drawGeneration;
+
     /* If the size is different, set a state flag to recalculate the set of
        visible nodes. I.e., some might now be outside of the UI area and
        hidden, some might be newly visible.
@@ -655,6 +1055,8 @@ AbstractUserInterface& AbstractUserInterface::setSize(const Vector2& size, const
        no-op anyway.) */
     if(sizeDifferent && state.nodes.size())
         state.state |= UserInterfaceState::NeedsNodeClipUpdate;
+    if(sizeOrFramebufferSizeDifferent)
+        state.damageNeedsFull = true;
 
     /* If the size or framebuffer size is different, set it on all existing
        layers that have an instance (so, also aren't freed) and support
@@ -707,11 +1109,11 @@ UserInterfaceStates AbstractUserInterface::state() const {
         }
     }
 
-    /* Unless UserInterfaceState::NeedsDataAttachmentUpdate is set already, go
+    /* Unless UserInterfaceState::NeedsLayoutUpdate is set already, go
        through all layers and inherit the Needs* flags from them. Invalid
        (removed) layers have instances set to nullptr as well, so this will
        skip them. */
-    if(!(state.state >= (UserInterfaceState::NeedsDataAttachmentUpdate|UserInterfaceState::NeedsDataClean))) for(const Layer& layer: state.layers) {
+    if(!(state.state >= (UserInterfaceState::NeedsLayoutUpdate|UserInterfaceState::NeedsDataClean))) for(const Layer& layer: state.layers) {
         if(const AbstractLayer* const instance = layer.used.instance.get()) {
             const LayerStates layerState = instance->state();
             if(layerState & (LayerState::NeedsDataUpdate|LayerState::NeedsCommonDataUpdate|LayerState::NeedsSharedDataUpdate))
@@ -720,10 +1122,13 @@ UserInterfaceStates AbstractUserInterface::state() const {
                 states |= UserInterfaceState::NeedsDataAttachmentUpdate;
             if(layerState >= LayerState::NeedsDataClean)
                 states |= UserInterfaceState::NeedsDataClean;
+            /* Changed intrinsic sizes need the layout to be recalculated */
+            if(layerState >= LayerState::NeedsIntrinsicSizeUpdate)
+                states |= UserInterfaceState::NeedsLayoutUpdate;
 
             /* There's no broader state than this so if it's set, we can stop
                iterating further */
-            if(states == (UserInterfaceState::NeedsDataAttachmentUpdate|UserInterfaceState::NeedsDataClean))
+            if(states >= (UserInterfaceState::NeedsLayoutUpdate|UserInterfaceState::NeedsDataClean))
                 break;
         }
     }
@@ -746,6 +1151,11 @@ UserInterfaceStates AbstractUserInterface::state() const {
         }
     }
 
+    /* Similarly, NeedsPointerMoveEventDispatch is never set on state.state,
+       it's only implied by a queued event */
+    if(state.pendingPointerMoveEvent)
+        states |= UserInterfaceState::NeedsPointerMoveEventDispatch;
+
     return state.state|states;
 }
 
@@ -753,6 +1163,21 @@ Nanoseconds AbstractUserInterface::animationTime() const {
     return _state->animationTime;
 }
 
+Nanoseconds AbstractUserInterface::nextAnimationTime() const {
+    /* Animators that don't have NeedsAdvance set have only stopped
+       animations, so they don't need to be queried at all. Invalid (removed)
+       animators have instances set to nullptr, so this will skip them. */
+    Nanoseconds next = Nanoseconds::max();
+    for(const Animator& animator: _state->animators) {
+        if(const AbstractAnimator* const instance = animator.used.instance.get()) {
+            if(instance->state() >= AnimatorState::NeedsAdvance)
+                next = Math::min(next, instance->nextAdvanceTime());
+        }
+    }
+
+    return next;
+}
+
 AbstractRenderer& AbstractUserInterface::setRendererInstance(Containers::Pointer<AbstractRenderer>&& instance) {
     State& state = *_state;
     CORRADE_ASSERT(instance,
@@ -784,6 +1209,7 @@ AbstractRenderer& AbstractUserInterface::setRendererInstance(Containers::Pointer
         CORRADE_INTERNAL_ASSERT(!state.framebufferSize.isZero());
         state.renderer->setupFramebuffers(state.framebufferSize);
     }
+    ++state.drawGeneration;
     return *state.renderer;
 }
 
@@ -804,6 +1230,33 @@ AbstractRenderer& AbstractUserInterface::renderer() {
     return const_cast<AbstractRenderer&>(const_cast<const AbstractUserInterface&>(*this).renderer());
 }
 
+UpdateQueue& AbstractUserInterface::setUpdateQueueInstance(Containers::Pointer<UpdateQueue>&& instance) {
+    State& state = *_state;
+    CORRADE_ASSERT(instance,
+        "Ui::AbstractUserInterface::setUpdateQueueInstance(): instance is null", *state.updateQueue);
+    CORRADE_ASSERT(!state.updateQueue,
+        "Ui::AbstractUserInterface::setUpdateQueueInstance(): instance already set", *instance);
+    state.updateQueue = Utility::move(instance);
+    return *state.updateQueue;
+}
+
+bool AbstractUserInterface::hasUpdateQueue() const {
+    return !!_state->updateQueue;
+}
+
+const UpdateQueue& AbstractUserInterface::updateQueue() const {
+    const State& state = *_state;
+    CORRADE_ASSERT(state.updateQueue,
+        "Ui::AbstractUserInterface::updateQueue(): no update queue instance set",
+        /* Dereferencing get() to not hit another assert in Pointer */
+        *state.updateQueue.get());
+    return *state.updateQueue;
+}
+
+UpdateQueue& AbstractUserInterface::updateQueue() {
+    return const_cast<UpdateQueue&>(const_cast<const AbstractUserInterface&>(*this).updateQueue());
+}
+
 std::size_t AbstractUserInterface::layerCapacity() const {
     return _state->layers.size();
 }
@@ -983,6 +1436,13 @@ AbstractLayer& AbstractUserInterface::setLayerInstance(Containers::Pointer<Abstr
     return *layer.used.instance;
 }
 
+bool AbstractUserInterface::hasLayerInstance(const LayerHandle handle) const {
+    const State& state = *_state;
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::AbstractUserInterface::hasLayerInstance(): invalid handle" << handle, {});
+    return !!state.layers[layerHandleId(handle)].used.instance;
+}
+
 const AbstractLayer& AbstractUserInterface::layer(const LayerHandle handle) const {
     const State& state = *_state;
     CORRADE_ASSERT(isHandleValid(handle),
@@ -1068,6 +1528,8 @@ void AbstractUserInterface::removeLayer(const LayerHandle handle) {
     /* Mark the UI as needing an update() call to refresh per-node data
        lists */
     state.state |= UserInterfaceState::NeedsDataAttachmentUpdate;
+    state.drawOrderNeedsUpdate = true;
+    state.damageNeedsFull = true;
 }
 
 void AbstractUserInterface::attachData(const NodeHandle node, const DataHandle data) {
@@ -1629,6 +2091,14 @@ std::size_t AbstractUserInterface::nodeCapacity() const {
     return _state->nodes.size();
 }
 
+void AbstractUserInterface::reserveNodes(const std::size_t capacity) {
+    State& state = *_state;
+    arrayReserve(state.nodes, capacity);
+    arrayReserve(state.nodeLinks, capacity);
+    /* Top-level node order entries are allocated for at most all nodes */
+    arrayReserve(state.nodeOrder, capacity);
+}
+
 std::size_t AbstractUserInterface::nodeUsedCount() const {
     /* The "pointer" chasing in here is a bit nasty, but there's no other way
        to know which nodes are actually used and which not. The parent is Null
@@ -1646,6 +2116,55 @@ std::size_t AbstractUserInterface::nodeUsedCount() const {
     return state.nodes.size() - free;
 }
 
+MemoryUsage AbstractUserInterface::memoryUsage() const {
+    const State& state = *_state;
+    MemoryUsage usage;
+    usage.cpuByteCount =
+        Implementation::arrayByteCount(state.layers) +
+        Implementation::arrayByteCount(state.layouters) +
+        Implementation::arrayByteCount(state.animators) +
+        Implementation::arrayByteCount(state.animatorInstances) +
+        Implementation::arrayByteCount(state.nodes) +
+        Implementation::arrayByteCount(state.nodeLinks) +
+        Implementation::arrayByteCount(state.nodeOrder) +
+        Implementation::arrayByteCount(state.hoverFastPathVisibleNodeIndices) +
+        state.nodeStateStorage.size() +
+        state.layoutStateStorage.size() +
+        state.dataStateStorage.size() +
+        Implementation::arrayByteCount(state.hiddenChangedNodeIds) +
+        Implementation::arrayByteCount(state.offsetChangedNodeIds) +
+        Implementation::arrayByteCount(state.opacityChangedNodeIds) +
+        Implementation::arrayByteCount(state.occluders) +
+        Implementation::arrayByteCount(state.layerUpdates) +
+        Implementation::arrayByteCount(state.orphanedNodes) +
+        Implementation::arrayByteCount(state.nodeDataUpdateHistory) +
+        Implementation::arrayByteCount(state.nodeLayoutUpdateHistory) +
+        Implementation::arrayByteCount(state.nodeDataUpdatedMask) +
+        Implementation::arrayByteCount(state.nodeLayoutUpdatedMask) +
+        Implementation::arrayByteCount(state.nodeDataUpdateCounts) +
+        Implementation::arrayByteCount(state.nodeLayoutUpdateCounts) +
+        Implementation::arrayByteCount(state.scratch);
+    usage.capacity = state.nodes.size();
+    usage.usedCount = nodeUsedCount();
+
+    /* Add memory used by all instances */
+    const auto add = [&usage](const MemoryUsage& instanceUsage) {
+        usage.cpuByteCount += instanceUsage.cpuByteCount;
+        usage.gpuByteCount += instanceUsage.gpuByteCount;
+    };
+    for(const Layer& layer: state.layers)
+        if(layer.used.instance)
+            add(layer.used.instance->memoryUsage());
+    for(const Layouter& layouter: state.layouters)
+        if(layouter.used.instance)
+            add(layouter.used.instance->memoryUsage());
+    for(const Animator& animator: state.animators)
+        if(animator.used.instance)
+            add(animator.used.instance->memoryUsage());
+
+    return usage;
+}
+
 bool AbstractUserInterface::isHandleValid(const NodeHandle handle) const {
     if(handle == NodeHandle::Null)
         return false;
@@ -1669,6 +2188,19 @@ NodeHandle AbstractUserInterface::createNode(const NodeHandle parent, const Vect
     CORRADE_ASSERT(parent == NodeHandle::Null || isHandleValid(parent),
         "Ui::AbstractUserInterface::createNode(): invalid parent handle" << parent, {});
 
+    const NodeHandle handle = createNodeInternal(parent, offset, size, flags);
+
+    /* Mark the UI as needing an update() call to refresh node state. The node
+       hierarchy changed, so the visible node order has to be calculated from
+       scratch. */
+    State& state = *_state;
+    state.state |= UserInterfaceState::NeedsNodeUpdate;
+    state.visibleNodesNeedFullUpdate = true;
+
+    return handle;
+}
+
+NodeHandle AbstractUserInterface::createNodeInternal(const NodeHandle parent, const Vector2& offset, const Vector2& size, const NodeFlags flags) {
     /* Find the first free node if there is, update the free index to
        point to the next one (or none) */
     Node* node;
@@ -1688,6 +2220,7 @@ NodeHandle AbstractUserInterface::createNode(const NodeHandle parent, const Vect
         CORRADE_ASSERT(state.nodes.size() < 1 << Implementation::NodeHandleIdBits,
             "Ui::AbstractUserInterface::createNode(): can only have at most" << (1 << Implementation::NodeHandleIdBits) << "nodes", {});
         node = &arrayAppend(state.nodes, InPlaceInit);
+        arrayAppend(state.nodeLinks, NoInit, 1);
     }
 
     /* Fill the data. In both above cases the generation is already set
@@ -1698,7 +2231,25 @@ NodeHandle AbstractUserInterface::createNode(const NodeHandle parent, const Vect
     node->used.offset = offset;
     node->used.size = size;
     node->used.opacity = 1.0f;
-    const NodeHandle handle = nodeHandle(node - state.nodes, node->used.generation);
+    const UnsignedInt id = node - state.nodes;
+    const NodeHandle handle = nodeHandle(id, node->used.generation);
+
+    /* If the node reuses an ID of a removed node, discard update statistics
+       gathered for the previous one */
+    if(id < state.nodeDataUpdateCounts.size())
+        state.resetNodeUpdateStatistics(id);
+
+    /* Put the node at the front of the parent children list */
+    NodeLinks& links = state.nodeLinks[id];
+    links.firstChild = ~UnsignedInt{};
+    links.previousSibling = ~UnsignedInt{};
+    if(parent != NodeHandle::Null) {
+        NodeLinks& parentLinks = state.nodeLinks[nodeHandleId(parent)];
+        links.nextSibling = parentLinks.firstChild;
+        if(parentLinks.firstChild != ~UnsignedInt{})
+            state.nodeLinks[parentLinks.firstChild].previousSibling = id;
+        parentLinks.firstChild = id;
+    } else links.nextSibling = ~UnsignedInt{};
 
     /* If a root node, implicitly mark it as last in the node order, so
        it's drawn at the front. The setNodeOrder() internally reconnects, so
@@ -1707,10 +2258,31 @@ NodeHandle AbstractUserInterface::createNode(const NodeHandle parent, const Vect
     if(parent == NodeHandle::Null)
         setNodeOrder(handle, NodeHandle::Null);
 
-    /* Mark the UI as needing an update() call to refresh node state */
+    return handle;
+}
+
+void AbstractUserInterface::createNodes(const NodeHandle parent, const Containers::StridedArrayView1D<const Vector2>& offsets, const Containers::StridedArrayView1D<const Vector2>& sizes, const NodeFlags flags, const Containers::StridedArrayView1D<NodeHandle>& handles) {
+    CORRADE_ASSERT(parent == NodeHandle::Null || isHandleValid(parent),
+        "Ui::AbstractUserInterface::createNodes(): invalid parent handle" << parent, );
+    CORRADE_ASSERT(sizes.size() == offsets.size() && handles.size() == offsets.size(),
+        "Ui::AbstractUserInterface::createNodes(): expected sizes and handles views to have a size of" << offsets.size() << "but got" << sizes.size() << "and" << handles.size(), );
+
+    /* Grow the storage just once. It's conservative as some nodes may get
+       taken from the free list, but that's fine as it's just capacity. */
+    State& state = *_state;
+    arrayReserve(state.nodes, state.nodes.size() + offsets.size());
+    arrayReserve(state.nodeLinks, state.nodeLinks.size() + offsets.size());
+    for(std::size_t i = 0; i != offsets.size(); ++i)
+        handles[i] = createNodeInternal(parent, offsets[i], sizes[i], flags);
+
+    /* Mark the UI as needing an update() call to refresh node state, same as
+       in createNode() */
     state.state |= UserInterfaceState::NeedsNodeUpdate;
+    state.visibleNodesNeedFullUpdate = true;
+}
 
-    return handle;
+void AbstractUserInterface::createNodes(const Containers::StridedArrayView1D<const Vector2>& offsets, const Containers::StridedArrayView1D<const Vector2>& sizes, const NodeFlags flags, const Containers::StridedArrayView1D<NodeHandle>& handles) {
+    createNodes(NodeHandle::Null, offsets, sizes, flags, handles);
 }
 
 NodeHandle AbstractUserInterface::createNode(const Vector2& offset, const Vector2& size, const NodeFlags flags) {
@@ -1733,10 +2305,25 @@ void AbstractUserInterface::setNodeOffset(const NodeHandle handle, const Vector2
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::AbstractUserInterface::setNodeOffset(): invalid handle" << handle, );
     State& state = *_state;
-    state.nodes[nodeHandleId(handle)].used.offset = offset;
+    const UnsignedInt id = nodeHandleId(handle);
+    state.nodes[id].used.offset = offset;
 
     /* Mark the UI as needing an update() call to refresh node layout state */
     state.state |= UserInterfaceState::NeedsLayoutUpdate;
+
+    if(state.nodeUpdateStatisticsFrameCount) {
+        state.growNodeUpdateStatistics();
+        state.nodeLayoutUpdatedMask.set(id);
+    }
+
+    /* Remember the node to recalculate just its subtree, unless there's too
+       many such nodes already */
+    if(!state.nodeOffsetsNeedFullUpdate) {
+        if(state.offsetChangedNodeIds.size() == MaxIncrementalUpdateNodeCount)
+            state.nodeOffsetsNeedFullUpdate = true;
+        else
+            arrayAppend(state.offsetChangedNodeIds, id);
+    }
 }
 
 Vector2 AbstractUserInterface::nodeSize(const NodeHandle handle) const {
@@ -1749,10 +2336,19 @@ void AbstractUserInterface::setNodeSize(const NodeHandle handle, const Vector2&
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::AbstractUserInterface::setNodeSize(): invalid handle" << handle, );
     State& state = *_state;
-    state.nodes[nodeHandleId(handle)].used.size = size;
+    const UnsignedInt id = nodeHandleId(handle);
+    state.nodes[id].used.size = size;
 
-    /* Mark the UI as needing an update() call to refresh node layout state */
+    /* Mark the UI as needing an update() call to refresh node layout state.
+       Size changes can affect layouts of other nodes, so everything is
+       recalculated. */
     state.state |= UserInterfaceState::NeedsLayoutUpdate;
+    state.nodeOffsetsNeedFullUpdate = true;
+
+    if(state.nodeUpdateStatisticsFrameCount) {
+        state.growNodeUpdateStatistics();
+        state.nodeLayoutUpdatedMask.set(id);
+    }
 }
 
 Float AbstractUserInterface::nodeOpacity(const NodeHandle handle) const {
@@ -1765,11 +2361,25 @@ void AbstractUserInterface::setNodeOpacity(const NodeHandle handle, const Float
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::AbstractUserInterface::setNodeOpacity(): invalid handle" << handle, );
     State& state = *_state;
-    state.nodes[nodeHandleId(handle)].used.opacity = opacity;
+    const UnsignedInt id = nodeHandleId(handle);
 
     /* Mark the UI as needing an update() call to refresh calculated node
-       opacities */
+       opacities. If the node becomes fully transparent or stops being fully
+       transparent, nodes with NodeFlag::CullTransparent in its subtree may
+       need to be culled or shown again. */
     state.state |= UserInterfaceState::NeedsNodeOpacityUpdate;
+    if((state.nodes[id].used.opacity == 0.0f) != (opacity == 0.0f))
+        state.state |= UserInterfaceState::NeedsNodeClipUpdate;
+    state.nodes[id].used.opacity = opacity;
+
+    /* Remember the node to recalculate just its subtree, unless there's too
+       many such nodes already */
+    if(!state.nodeOpacitiesNeedFullUpdate) {
+        if(state.opacityChangedNodeIds.size() == MaxIncrementalUpdateNodeCount)
+            state.nodeOpacitiesNeedFullUpdate = true;
+        else
+            arrayAppend(state.opacityChangedNodeIds, id);
+    }
 }
 
 NodeFlags AbstractUserInterface::nodeFlags(const NodeHandle handle) const {
@@ -1780,17 +2390,35 @@ NodeFlags AbstractUserInterface::nodeFlags(const NodeHandle handle) const {
 
 void AbstractUserInterface::setNodeFlagsInternal(const UnsignedInt id, const NodeFlags flags) {
     State& state = *_state;
-    if((state.nodes[id].used.flags & NodeFlag::Hidden) != (flags & NodeFlag::Hidden))
+    if((state.nodes[id].used.flags & NodeFlag::Hidden) != (flags & NodeFlag::Hidden)) {
         state.state |= UserInterfaceState::NeedsNodeUpdate;
-    if((state.nodes[id].used.flags & NodeFlag::Clip) != (flags & NodeFlag::Clip))
+
+        /* If the node isn't top-level, remember it to patch the visible node
+           order in place. Otherwise, or if there's already too many such
+           nodes, which would likely make it slower than a full update, the
+           visible node order is calculated from scratch. */
+        if(!state.visibleNodesNeedFullUpdate) {
+            if(state.nodes[id].used.parent == NodeHandle::Null ||
+               state.nodes[id].used.order != ~UnsignedInt{} ||
+               state.hiddenChangedNodeIds.size() == MaxIncrementalUpdateNodeCount)
+                state.visibleNodesNeedFullUpdate = true;
+            else
+                arrayAppend(state.hiddenChangedNodeIds, id);
+        }
+    }
+    if((state.nodes[id].used.flags & (NodeFlag::Clip|NodeFlag::CullTransparent|NodeFlag::Opaque)) != (flags & (NodeFlag::Clip|NodeFlag::CullTransparent|NodeFlag::Opaque))) {
         state.state |= UserInterfaceState::NeedsNodeClipUpdate;
+        state.damageNeedsFull = true;
+    }
     /* Right now Focusable wouldn't need the full NeedsNodeEnabledUpdate, just
        something that triggers state.currentFocusedNode update. But eventually
        there will be focusable node fallbacks / trees (where pressing on a node
        that's not focusable itself but its parent is focuses the parent), which
        then will need the full process as NoEvents and Disabled as well. */
-    if((state.nodes[id].used.flags & (NodeFlag::NoEvents|NodeFlag::Disabled|NodeFlag::Focusable)) != (flags & (NodeFlag::NoEvents|NodeFlag::Disabled|NodeFlag::Focusable)))
+    if((state.nodes[id].used.flags & (NodeFlag::NoEvents|NodeFlag::Disabled|NodeFlag::Focusable)) != (flags & (NodeFlag::NoEvents|NodeFlag::Disabled|NodeFlag::Focusable))) {
         state.state |= UserInterfaceState::NeedsNodeEnabledUpdate;
+        state.damageNeedsFull = true;
+    }
     state.nodes[id].used.flags = flags;
 }
 
@@ -1818,12 +2446,62 @@ void AbstractUserInterface::removeNode(const NodeHandle handle) {
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::AbstractUserInterface::removeNode(): invalid handle" << handle, );
 
-    removeNodeInternal(nodeHandleId(handle));
+    removeNodeSubtreeInternal(nodeHandleId(handle));
+
+    /* Mark the UI as needing a clean() call to refresh node state */
+    _state->state |= UserInterfaceState::NeedsNodeClean;
+}
+
+void AbstractUserInterface::removeNodes(const Containers::StridedArrayView1D<const NodeHandle>& handles) {
+    /* Checking the handles as they get removed, so a duplicate handle is
+       caught as invalid */
+    for(std::size_t i = 0; i != handles.size(); ++i) {
+        CORRADE_ASSERT(isHandleValid(handles[i]),
+            "Ui::AbstractUserInterface::removeNodes(): invalid handle" << handles[i] << "at index" << i, );
+        removeNodeSubtreeInternal(nodeHandleId(handles[i]));
+    }
 
     /* Mark the UI as needing a clean() call to refresh node state */
     _state->state |= UserInterfaceState::NeedsNodeClean;
 }
 
+namespace {
+
+/* Appends direct children of given node to `out`, walking the list from the
+   end to have them in the order they were created in */
+void appendNodeChildrenInto(Containers::Array<NodeHandle>& out, const Containers::ArrayView<const Node> nodes, const Containers::ArrayView<const NodeLinks> nodeLinks, const UnsignedInt id) {
+    UnsignedInt lastChild = nodeLinks[id].firstChild;
+    if(lastChild == ~UnsignedInt{})
+        return;
+    while(nodeLinks[lastChild].nextSibling != ~UnsignedInt{})
+        lastChild = nodeLinks[lastChild].nextSibling;
+    for(UnsignedInt child = lastChild; child != ~UnsignedInt{}; child = nodeLinks[child].previousSibling)
+        arrayAppend(out, nodeHandle(child, nodes[child].used.generation));
+}
+
+}
+
+inline void AbstractUserInterface::removeNodeSubtreeInternal(const UnsignedInt id) {
+    State& state = *_state;
+    const std::size_t offset = state.orphanedNodes.size();
+    removeNodeInternal(id);
+    scheduleNestedNodesForRemovalInternal(offset);
+}
+
+void AbstractUserInterface::scheduleNestedNodesForRemovalInternal(const std::size_t offset) {
+    State& state = *_state;
+
+    /* Go breadth-first through the scheduled nodes starting at `offset` and
+       put their children at the end, so the list contains the whole subtree
+       as it is right now, parents before their children. None of the nodes
+       got removed yet, so their children lists are still intact. Nodes
+       created in the nested subtree only after this point get removed in the
+       clean() after the one that removes their parent. The array may get
+       reallocated during the loop, so it has to be indexed directly. */
+    for(std::size_t i = offset; i != state.orphanedNodes.size(); ++i)
+        appendNodeChildrenInto(state.orphanedNodes, state.nodes, state.nodeLinks, nodeHandleId(state.orphanedNodes[i]));
+}
+
 inline void AbstractUserInterface::removeNodeInternal(const UnsignedInt id) {
     State& state = *_state;
     Node& node = state.nodes[id];
@@ -1857,6 +2535,31 @@ inline void AbstractUserInterface::removeNodeInternal(const UnsignedInt id) {
            NeedsNodeClean) in order to even enter clean(), which calls here */
     }
 
+    /* The node hierarchy changed, the visible node order has to be
+       calculated from scratch */
+    state.visibleNodesNeedFullUpdate = true;
+
+    /* If the parent is still valid, unlink the node from its children list.
+       If it isn't, the parent was removed already and this node is in the
+       `orphanedNodes` list instead. */
+    NodeLinks& links = state.nodeLinks[id];
+    if(node.used.parent != NodeHandle::Null && isHandleValid(node.used.parent)) {
+        if(links.previousSibling != ~UnsignedInt{})
+            state.nodeLinks[links.previousSibling].nextSibling = links.nextSibling;
+        else
+            state.nodeLinks[nodeHandleId(node.used.parent)].firstChild = links.nextSibling;
+        if(links.nextSibling != ~UnsignedInt{})
+            state.nodeLinks[links.nextSibling].previousSibling = links.previousSibling;
+    }
+
+    /* Schedule all direct children for removal. Their parent handle is
+       invalid after this function, so they're not considered being in this
+       node's children list anymore. If called from clean(), this picks up
+       also children that were created after the node itself got scheduled,
+       which are then removed in the next clean(). */
+    appendNodeChildrenInto(state.orphanedNodes, state.nodes, state.nodeLinks, id);
+    links.firstChild = ~UnsignedInt{};
+
     /* Increase the node generation so existing handles pointing to this
        node are invalidated */
     ++node.used.generation;
@@ -2093,6 +2796,7 @@ void AbstractUserInterface::setNodeOrder(const NodeHandle handle, const NodeHand
     /* If the node isn't in the order yet, add it. That happens when calling
        setNodeOrder() for a root node from within createNode(), or when setting
        order on a non-root order for the first time. */
+    bool wasConnected = false;
     if(node.used.order == ~UnsignedInt{}) {
         /* Find the first free slot if there is, update the free index to point
            to the next one (or none) */
@@ -2123,7 +2827,7 @@ void AbstractUserInterface::setNodeOrder(const NodeHandle handle, const NodeHand
 
     /* Otherwise remove it from the previous location in the linked list, if
        connected. The `node.used.order` stays the same -- it's reused. */
-    } else clearNodeOrderInternal(handle);
+    } else wasConnected = clearNodeOrderInternal(handle);
 
     /* At this point, with the node order not being connected (yet or not
        anymore), we can figure out where to connect. The previous node gets
@@ -2246,8 +2950,16 @@ void AbstractUserInterface::setNodeOrder(const NodeHandle handle, const NodeHand
         updateParentLastNestedOrderTo(state.nodes, state.nodeOrder, node.used.parent, order.used.previous, order.used.lastNested);
     }
 
-    /* Mark the UI as needing an update() call to refresh node state */
+    /* Mark the UI as needing an update() call to refresh node state. If a
+       root node that was already connected got just moved, its visible
+       hierarchy is already in the visible node order and only needs to be
+       moved as a whole, otherwise the visible node order is calculated from
+       scratch. */
     state.state |= UserInterfaceState::NeedsNodeUpdate;
+    if(wasConnected && node.used.parent == NodeHandle::Null)
+        state.visibleNodesNeedTopLevelReorder = true;
+    else
+        state.visibleNodesNeedFullUpdate = true;
 }
 
 void AbstractUserInterface::clearNodeOrder(const NodeHandle handle) {
@@ -2265,8 +2977,14 @@ void AbstractUserInterface::clearNodeOrder(const NodeHandle handle) {
     if(!clearNodeOrderInternal(handle))
         return;
 
-    /* Mark the UI as needing an update() call to refresh node state */
+    /* Mark the UI as needing an update() call to refresh node state. For a
+       root node its visible hierarchy only needs to be removed from the
+       visible node order, otherwise it's calculated from scratch. */
     state.state |= UserInterfaceState::NeedsNodeUpdate;
+    if(node.used.parent == NodeHandle::Null)
+        state.visibleNodesNeedTopLevelReorder = true;
+    else
+        state.visibleNodesNeedFullUpdate = true;
 }
 
 void AbstractUserInterface::flattenNodeOrder(const NodeHandle handle) {
@@ -2301,6 +3019,7 @@ void AbstractUserInterface::flattenNodeOrder(const NodeHandle handle) {
         nothing that would affect layouters or cause node offsets/sizes to
         change -- is there a better state flag that would cover this? */
     state.state |= UserInterfaceState::NeedsNodeUpdate;
+    state.visibleNodesNeedFullUpdate = true;
 }
 
 AbstractUserInterface& AbstractUserInterface::clean() {
@@ -2313,47 +3032,39 @@ AbstractUserInterface& AbstractUserInterface::clean() {
     }
 
     State& state = *_state;
+    state.reportPhase(UserInterfacePhase::Clean, false);
 
-    /* Single allocation for all temporary data */
-    Containers::ArrayView<UnsignedInt> childrenOffsets;
-    Containers::ArrayView<UnsignedInt> children;
-    Containers::ArrayView<Int> nodeIds;
-    Containers::ArrayTuple storage{
-        /* Running children offset (+1) for each node including root (+1) */
-        {ValueInit, state.nodes.size() + 2, childrenOffsets},
-        {NoInit, state.nodes.size(), children},
-        /* One more item for the -1 at the front */
-        {NoInit, state.nodes.size() + 1, nodeIds},
-    };
-
-    /* If no node clean is needed, there's no need to build and iterate an
-       ordered list of nodes */
+    /* If no node clean is needed, there's no orphaned nodes to remove */
     if(states >= UserInterfaceState::NeedsNodeClean) {
-        /* 1. Order the whole node hierarchy */
-        /** @todo here it may happen that a handle gets recycled and then
-            parented to some of its original children, leading to an
-            unreachable cycle and a internal assertion inside, see the
-            (skipped) cleanRemoveNestedNodesRecycledHandleOrphanedCycle()
-            test */
-        Implementation::orderNodesBreadthFirstInto(
-            stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::parent),
-            childrenOffsets, children, nodeIds);
-
-        /* 2. Go through the ordered nodes (skipping the first element which is
-           -1) and remove ones that have an invalid parent. Since children are
-           ordered after their parents, they'll get subsequently removed as
-           well.
+        /* 1. Go through the nodes scheduled for removal, which are whole
+           subtrees of removed nodes as they were at the time of removal, and
+           remove them. Nodes that were removed explicitly in the meantime
+           have their handle invalid and are skipped.
+
+           Removing a node puts its direct children at the end of the list
+           again. Those that aren't among the scheduled nodes were created
+           only after the removal, and are kept for the next clean(). The
+           array may get reallocated during the loop, so it has to be indexed
+           directly. */
+        const std::size_t scheduledCount = state.orphanedNodes.size();
+        for(std::size_t i = 0; i != scheduledCount; ++i) {
+            const NodeHandle handle = state.orphanedNodes[i];
+            if(isHandleValid(handle))
+                removeNodeInternal(nodeHandleId(handle));
+        }
 
-           Removed nodes are parented to the root, which prevents them from
-           being removed more than once which would lead to a cycle in the free
-           list. */
-        for(const UnsignedInt id: nodeIds.exceptPrefix(1)) {
-            const Node& node = state.nodes[id];
-            if(node.used.parent != NodeHandle::Null && !isHandleValid(node.used.parent))
-                removeNodeInternal(id);
+        /* Keep only the nodes that are still valid, which are now dangling,
+           and schedule their whole current subtrees as well */
+        std::size_t remainingCount = 0;
+        for(std::size_t i = scheduledCount; i != state.orphanedNodes.size(); ++i) {
+            const NodeHandle handle = state.orphanedNodes[i];
+            if(isHandleValid(handle))
+                state.orphanedNodes[remainingCount++] = handle;
         }
+        arrayResize(state.orphanedNodes, NoInit, remainingCount);
+        scheduleNestedNodesForRemovalInternal(0);
 
-        /* 3. Next perform a clean for layouter node assignments and data and
+        /* 2. Next perform a clean for layouter node assignments and data and
            animation node attachments, keeping only layouts assigned to
            (remaining) valid node handles and data/animations that are either
            not attached or attached to valid node handles. */
@@ -2389,9 +3100,11 @@ AbstractUserInterface& AbstractUserInterface::clean() {
     /* Unmark the UI as needing a clean() call, but keep the Update states
        including ones that bubbled up from layers. States that aren't a subset
        of NeedsNodeClean, such as NeedsRendererSizeSetup, are unaffected.
-       NeedsAnimationAdvance is only propagated from the animators in state(),
-       never present directly in _state->state, so clear it as well. */
-    state.state = states & ~((UserInterfaceState::NeedsNodeClean|UserInterfaceState::NeedsAnimationAdvance) & ~UserInterfaceState::NeedsNodeUpdate);
+       NeedsAnimationAdvance and NeedsPointerMoveEventDispatch are only
+       propagated in state(), never present directly in _state->state, so
+       clear them as well. */
+    state.state = states & ~((UserInterfaceState::NeedsNodeClean|UserInterfaceState::NeedsAnimationAdvance|UserInterfaceState::NeedsPointerMoveEventDispatch) & ~UserInterfaceState::NeedsNodeUpdate);
+    state.reportPhase(UserInterfacePhase::Clean, true);
     return *this;
 }
 
@@ -2400,6 +3113,11 @@ AbstractUserInterface& AbstractUserInterface::advanceAnimations(const Nanosecond
     CORRADE_ASSERT(time >= state.animationTime,
         "Ui::AbstractUserInterface::advanceAnimations(): expected a time at least" << state.animationTime << "but got" << time, *this);
 
+    /* Dispatch a coalesced pointer move event first, if there's any, so
+       animations it triggered or stopped are advanced with the latest input
+       already and not a frame later */
+    flushPendingPointerMoveEvent();
+
     /* Call clean implicitly in order to make the internal state ready for
        animation advance, i.e. no stale nodes or data anywhere. Is a no-op if
        there's nothing to clean. */
@@ -2416,17 +3134,33 @@ AbstractUserInterface& AbstractUserInterface::advanceAnimations(const Nanosecond
     Containers::MutableBitArrayView remove;
     Containers::ArrayView<Float> factors;
     Containers::MutableBitArrayView nodesRemove;
-    Containers::ArrayTuple storage{
+    state.resetScratchStorage();
+    Containers::ArrayTuple storage = state.allocateScratchStorage({
         {NoInit, maxCapacity, active},
         {NoInit, maxCapacity, remove},
         {NoInit, maxCapacity, factors},
         {ValueInit, state.nodes.size(), nodesRemove}
-    };
+    });
 
     /* Get the state including what bubbles from animators, then go through
        them only if there's something to advance */
     const UserInterfaceStates states = this->state();
     if(states >= UserInterfaceState::NeedsAnimationAdvance) {
+        /* Supply node visibility from the last update() to all animators, so
+           animations with AnimationFlag::SkipWhenInvisible attached to nodes
+           that aren't visible can be skipped. Data-attached animators need
+           also the nodes the layer data are attached to. */
+        for(AbstractAnimator& instance: state.animatorInstances) {
+            Containers::StridedArrayView1D<const NodeHandle> layerDataNodes;
+            if(instance.features() >= AnimatorFeature::DataAttachment) {
+                const LayerHandle layer = instance.layer();
+                if(isHandleValid(layer))
+                    if(const AbstractLayer* const layerInstance = state.layers[layerHandleId(layer)].used.instance.get())
+                        layerDataNodes = layerInstance->nodes();
+            }
+            instance.setVisibleNodesInternal(state.visibleNodeMask, layerDataNodes);
+        }
+
         /* Common code for advancing AbstractGenericAnimator instances. It's
            done in three separate loops because generic animators are not
            contiguous in the `state.animatorInstances` array, instead they're
@@ -2436,6 +3170,7 @@ AbstractUserInterface& AbstractUserInterface::advanceAnimations(const Nanosecond
             if(!(instance.state() & AnimatorState::NeedsAdvance))
                 return;
 
+            TraceScope trace{state.traceCallback, state.traceCallbackUserData, UserInterfaceTraceScope::AnimatorAdvance, UnsignedLong(instance.handle())};
             const std::size_t capacity = instance.capacity();
             const Containers::Pair<bool, bool> needsAdvanceClean = instance.update(time,
                 active.prefix(capacity),
@@ -2477,6 +3212,7 @@ AbstractUserInterface& AbstractUserInterface::advanceAnimations(const Nanosecond
             if(!(instance.state() & AnimatorState::NeedsAdvance))
                 continue;
 
+            TraceScope trace{state.traceCallback, state.traceCallbackUserData, UserInterfaceTraceScope::AnimatorAdvance, UnsignedLong(instance.handle())};
             const std::size_t capacity = instance.capacity();
             const Containers::Pair<bool, bool> needsAdvanceClean = instance.update(time,
                 active.prefix(capacity),
@@ -2496,8 +3232,10 @@ AbstractUserInterface& AbstractUserInterface::advanceAnimations(const Nanosecond
         }
 
         /* Propagate to the global state */
-        if(nodeAnimations >= NodeAnimation::OffsetSize)
+        if(nodeAnimations >= NodeAnimation::OffsetSize) {
             state.state |= UserInterfaceState::NeedsLayoutUpdate;
+            state.nodeOffsetsNeedFullUpdate = true;
+        }
         if(nodeAnimations >= NodeAnimation::Enabled)
             state.state |= UserInterfaceState::NeedsNodeEnabledUpdate;
         if(nodeAnimations >= NodeAnimation::Clip)
@@ -2506,7 +3244,7 @@ AbstractUserInterface& AbstractUserInterface::advanceAnimations(const Nanosecond
             state.state |= UserInterfaceState::NeedsNodeClean;
             /** @todo some way to efficiently iterate set bits */
             for(std::size_t i = 0; i != nodesRemove.size(); ++i)
-                if(nodesRemove[i]) removeNodeInternal(i);
+                if(nodesRemove[i]) removeNodeSubtreeInternal(i);
         }
 
         /* Then, for each layer ... */
@@ -2523,6 +3261,7 @@ AbstractUserInterface& AbstractUserInterface::advanceAnimations(const Nanosecond
                 /* If there are any animators partitioned for this layer, it
                    implies that the layer supports data animation */
                 CORRADE_INTERNAL_ASSERT(layer.used.features >= LayerFeature::AnimateData);
+                TraceScope trace{state.traceCallback, state.traceCallbackUserData, UserInterfaceTraceScope::LayerAdvanceAnimations, UnsignedLong(layerHandle(i, layer.used.generation))};
                 state.layers[i].used.instance->advanceAnimations(time,
                     /* Pass the whole arrays, the internals will slice them up
                        as needed before passing to individual animators */
@@ -2539,6 +3278,7 @@ AbstractUserInterface& AbstractUserInterface::advanceAnimations(const Nanosecond
                 /* If there are any animators partitioned for this layer, it
                    implies that the layer supports style animation */
                 CORRADE_INTERNAL_ASSERT(layer.used.features >= LayerFeature::AnimateStyles);
+                TraceScope trace{state.traceCallback, state.traceCallbackUserData, UserInterfaceTraceScope::LayerAdvanceAnimations, UnsignedLong(layerHandle(i, layer.used.generation))};
                 state.layers[i].used.instance->advanceAnimations(time,
                     /* Pass the whole arrays, the internals will slice them up
                        as needed before passing to individual animators */
@@ -2549,6 +3289,11 @@ AbstractUserInterface& AbstractUserInterface::advanceAnimations(const Nanosecond
                     Containers::arrayView(reinterpret_cast<Containers::Reference<AbstractStyleAnimator>*>(const_cast<Containers::Reference<AbstractAnimator>*>(styleAnimators.data())), styleAnimators.size()));
             }
         }
+
+        /* Reset the visibility views so AbstractAnimator::update() called
+           directly doesn't use stale data */
+        for(AbstractAnimator& instance: state.animatorInstances)
+            instance.setVisibleNodesInternal({}, {});
     }
 
     /* Update current time. This is done even if no advance() was called. */
@@ -2561,7 +3306,177 @@ AbstractUserInterface& AbstractUserInterface::advanceAnimations(const Nanosecond
     return *this;
 }
 
+auto AbstractUserInterface::layerUpdateExecutor() const -> void(*)(UnsignedInt, void(*)(void*, UnsignedInt), void*, void*) {
+    return _state->layerUpdateExecutor;
+}
+
+void* AbstractUserInterface::layerUpdateExecutorUserData() const {
+    return _state->layerUpdateExecutorUserData;
+}
+
+AbstractUserInterface& AbstractUserInterface::setLayerUpdateExecutor(void(*executor)(UnsignedInt, void(*)(void*, UnsignedInt), void*, void*), void* userData) {
+    State& state = *_state;
+    state.layerUpdateExecutor = executor;
+    state.layerUpdateExecutorUserData = userData;
+    return *this;
+}
+
+auto AbstractUserInterface::phaseCallback() const -> void(*)(UserInterfacePhase, bool, void*) {
+    return _state->phaseCallback;
+}
+
+void* AbstractUserInterface::phaseCallbackUserData() const {
+    return _state->phaseCallbackUserData;
+}
+
+AbstractUserInterface& AbstractUserInterface::setPhaseCallback(void(*callback)(UserInterfacePhase, bool, void*), void* userData) {
+    State& state = *_state;
+    state.phaseCallback = callback;
+    state.phaseCallbackUserData = userData;
+    return *this;
+}
+
+auto AbstractUserInterface::traceCallback() const -> void(*)(UserInterfaceTraceScope, UnsignedLong, bool, void*) {
+    return _state->traceCallback;
+}
+
+void* AbstractUserInterface::traceCallbackUserData() const {
+    return _state->traceCallbackUserData;
+}
+
+AbstractUserInterface& AbstractUserInterface::setTraceCallback(void(*callback)(UserInterfaceTraceScope, UnsignedLong, bool, void*), void* userData) {
+    State& state = *_state;
+    state.traceCallback = callback;
+    state.traceCallbackUserData = userData;
+    return *this;
+}
+
+auto AbstractUserInterface::storageAllocator() const -> Containers::Array<char>(*)(std::size_t, std::size_t, void*) {
+    return _state->storageAllocator;
+}
+
+void* AbstractUserInterface::storageAllocatorUserData() const {
+    return _state->storageAllocatorUserData;
+}
+
+AbstractUserInterface& AbstractUserInterface::setStorageAllocator(Containers::Array<char>(*allocator)(std::size_t, std::size_t, void*), void* userData) {
+    State& state = *_state;
+    state.storageAllocator = allocator;
+    state.storageAllocatorUserData = userData;
+    return *this;
+}
+
+std::size_t AbstractUserInterface::storageAllocationCount() const {
+    return _state->storageAllocationCount;
+}
+
+bool AbstractUserInterface::isDisjointTopLevelNodeDrawMerging() const {
+    return _state->disjointTopLevelNodeDrawMerging;
+}
+
+AbstractUserInterface& AbstractUserInterface::setDisjointTopLevelNodeDrawMerging(const bool enabled) {
+    State& state = *_state;
+    if(state.disjointTopLevelNodeDrawMerging != enabled) {
+        state.disjointTopLevelNodeDrawMerging = enabled;
+        /* Mark the UI as needing an update() call to rebuild the draw list */
+        state.state |= UserInterfaceState::NeedsDataAttachmentUpdate;
+        state.drawOrderNeedsUpdate = true;
+        state.damageNeedsFull = true;
+    }
+    return *this;
+}
+
+std::size_t AbstractUserInterface::visibleNodeCount() const {
+    return _state->visibleNodeIds.size();
+}
+
+std::size_t AbstractUserInterface::culledNodeCount() const {
+    const State& state = *_state;
+    return state.visibleNodeIds.size() - state.visibleNodeMask.count();
+}
+
+Containers::BitArrayView AbstractUserInterface::visibleNodeMask() const {
+    return _state->visibleNodeMask;
+}
+
+std::size_t AbstractUserInterface::drawCallCount() const {
+    return _state->drawCount;
+}
+
+UnsignedLong AbstractUserInterface::drawGeneration() const {
+    return _state->drawGeneration;
+}
+
+Range2D AbstractUserInterface::damageRect() const {
+    const State& state = *_state;
+    const Range2D area{{}, state.size};
+    if(state.damageNeedsFull)
+        return area;
+    /* If the damage is empty, the intersection is empty as well, no need to
+       special-case that */
+    return Math::intersect(state.damageRect, area);
+}
+
+UnsignedInt AbstractUserInterface::nodeUpdateStatisticsFrameCount() const {
+    return _state->nodeUpdateStatisticsFrameCount;
+}
+
+AbstractUserInterface& AbstractUserInterface::setNodeUpdateStatisticsFrameCount(const UnsignedInt count) {
+    CORRADE_ASSERT(count <= 65535,
+        "Ui::AbstractUserInterface::setNodeUpdateStatisticsFrameCount(): expected at most 65535 frames but got" << count, *this);
+    State& state = *_state;
+    if(state.nodeUpdateStatisticsFrameCount == count)
+        return *this;
+
+    /* Discard everything, it gets allocated again on the next update() */
+    state.nodeUpdateStatisticsFrameCount = count;
+    state.nodeUpdateStatisticsFrameIndex = 0;
+    state.nodeDataUpdateHistory = {};
+    state.nodeLayoutUpdateHistory = {};
+    state.nodeDataUpdatedMask = {};
+    state.nodeLayoutUpdatedMask = {};
+    state.nodeDataUpdateCounts = {};
+    state.nodeLayoutUpdateCounts = {};
+    return *this;
+}
+
+UnsignedLong AbstractUserInterface::nodeUpdateStatisticsFrame() const {
+    return _state->nodeUpdateStatisticsFrame;
+}
+
+Containers::StridedArrayView1D<const UnsignedShort> AbstractUserInterface::nodeDataUpdateCounts() const {
+    const State& state = *_state;
+    return state.nodeDataUpdateCounts.prefix(Math::min(state.nodeDataUpdateCounts.size(), state.nodes.size()));
+}
+
+Containers::StridedArrayView1D<const UnsignedShort> AbstractUserInterface::nodeLayoutUpdateCounts() const {
+    const State& state = *_state;
+    return state.nodeLayoutUpdateCounts.prefix(Math::min(state.nodeLayoutUpdateCounts.size(), state.nodes.size()));
+}
+
+std::size_t AbstractUserInterface::layerDataCount(const LayerHandle handle) const {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::AbstractUserInterface::layerDataCount(): invalid handle" << handle, {});
+    const State& state = *_state;
+    /* If the layer was added after the last update() that populated the
+       offsets, it has no data to update yet */
+    const UnsignedInt layerId = layerHandleId(handle);
+    if(layerId + 1 >= state.dataToUpdateLayerOffsets.size())
+        return 0;
+    return state.dataToUpdateLayerOffsets[layerId + 1].first() - state.dataToUpdateLayerOffsets[layerId].first();
+}
+
 AbstractUserInterface& AbstractUserInterface::update() {
+    /* Apply updates queued from other threads first so the state they cause
+       is taken into account by everything below */
+    if(_state->updateQueue)
+        _state->updateQueue->apply();
+
+    /* Dispatch a coalesced pointer move event first, if there's any, so its
+       effects are included in this update. It calls update() internally
+       again, but the queued event is taken out before that. */
+    flushPendingPointerMoveEvent();
+
     /* Call clean implicitly in order to make the internal state ready for
        update. Is a no-op if there's nothing to clean. */
     clean();
@@ -2584,6 +3499,31 @@ AbstractUserInterface& AbstractUserInterface::update() {
     CORRADE_ASSERT(!state.size.isZero(),
         "Ui::AbstractUserInterface::update(): user interface size wasn't set", *this);
 
+    /* Anything that gets updated here may affect what gets drawn. Not trying
+       to figure out whether the update is actually visible, such as a change
+       in a culled node, a conservative estimate is fine. */
+    ++state.drawGeneration;
+
+    /* The damaged area can be calculated incrementally only if the node
+       hierarchy and layout assignments stay the same and none of the layers
+       or layouters report any change on their own, as there's no way to know
+       which data a layer change affects. The incremental offset and opacity
+       branches below then further decide if they can do that. */
+    if(states >= UserInterfaceState::NeedsLayoutAssignmentUpdate)
+        state.damageNeedsFull = true;
+    if(!state.damageNeedsFull) for(const Layer& layer: state.layers) {
+        if(const AbstractLayer* const instance = layer.used.instance.get()) if(instance->state()) {
+            state.damageNeedsFull = true;
+            break;
+        }
+    }
+    if(!state.damageNeedsFull) for(const Layouter& layouter: state.layouters) {
+        if(const AbstractLayouter* const instance = layouter.used.instance.get()) if(instance->state()) {
+            state.damageNeedsFull = true;
+            break;
+        }
+    }
+
     /* If layout attachment update is desired, calculate the total conservative
        count of layouts in all layouters to size the output arrays.
        Conservative as it includes also freed layouts, however the assumption
@@ -2611,7 +3551,7 @@ AbstractUserInterface& AbstractUserInterface::update() {
           size, which happens for example if setNeedsUpdate() is called on a
           layer but there's nothing attached to any node in the UI at all. The
           same condition is below, and it depends on dataCount being correctly
-          calculated here in order to size visibleNodeDataIds, which then gets
+          calculated here in order to size dataToUpdateIds, which then gets
           sliced in the NeedsDataUpdate branch below. */
        /** @todo FFS this is rather horrible, exhibit 1 of 2 */
        (states >= UserInterfaceState::NeedsDataUpdate && state.layers.size() + 1 != state.dataToUpdateLayerOffsets.size()))
@@ -2625,9 +3565,10 @@ AbstractUserInterface& AbstractUserInterface::update() {
     /** @todo well, not really, there's one more temp array for layout mask
         calculation */
     Containers::MutableBitArrayView visibleNodes;
-    Containers::ArrayView<UnsignedInt> childrenOffsets;
-    Containers::ArrayView<UnsignedInt> children;
+    Containers::ArrayView<UnsignedInt> nodeAncestors;
     Containers::ArrayView<Containers::Triple<UnsignedInt, UnsignedInt, UnsignedInt>> parentsToProcess;
+    Containers::ArrayView<UnsignedInt> previousVisibleNodeIds;
+    Containers::ArrayView<UnsignedInt> previousVisibleNodeChildrenCounts;
     Containers::StridedArrayView2D<LayoutHandle> nodeLayouts;
     Containers::StridedArrayView2D<UnsignedInt> nodeLayoutLevels;
     Containers::ArrayView<UnsignedInt> layoutLevelOffsets;
@@ -2636,20 +3577,21 @@ AbstractUserInterface& AbstractUserInterface::update() {
     Containers::ArrayView<LayoutHandle> levelPartitionedTopLevelLayouts;
     Containers::ArrayView<UnsignedInt> layouterCapacities;
     Containers::ArrayView<Containers::Triple<Vector2, Vector2, UnsignedInt>> clipStack;
-    Containers::ArrayView<UnsignedInt> visibleNodeDataOffsets;
-    Containers::ArrayView<UnsignedInt> visibleNodeDataIds;
     /* Contains a copy of state.visibleEventNodeMask (allocated below) together
        with additional bits set for nodes that need visibility lost events
        emitted. The bits used for visibility lost events are gradually cleared
        to avoid calling the same event multiple times, so this mask isn't
        usable for anything else afterwards. */
     Containers::MutableBitArrayView visibleOrVisibilityLostEventNodeMask;
-    Containers::ArrayTuple storage{
+    state.resetScratchStorage();
+    Containers::ArrayTuple storage = state.allocateScratchStorage({
         {ValueInit, state.nodes.size(), visibleNodes},
-        /* Running children offset (+1) for each node */
-        {ValueInit, state.nodes.size() + 1, childrenOffsets},
-        {NoInit, state.nodes.size(), children},
+        {NoInit, state.nodes.size(), nodeAncestors},
         {NoInit, state.nodes.size(), parentsToProcess},
+        /* Used only if the top-level node order is permuted in place, sized
+           to the current visible node count */
+        {NoInit, state.visibleNodesNeedTopLevelReorder && !state.visibleNodesNeedFullUpdate ? state.visibleNodeIds.size() : 0, previousVisibleNodeIds},
+        {NoInit, state.visibleNodesNeedTopLevelReorder && !state.visibleNodesNeedFullUpdate ? state.visibleNodeIds.size() : 0, previousVisibleNodeChildrenCounts},
         /* Not all nodes have layouts from all layouters, initialize to
            LayoutHandle::Null */
         {ValueInit, {state.nodes.size(), usedLayouterCount}, nodeLayouts},
@@ -2662,49 +3604,116 @@ AbstractUserInterface& AbstractUserInterface::update() {
         {NoInit, layoutCount, topLevelLayoutLevels},
         {NoInit, layoutCount, levelPartitionedTopLevelLayouts},
         {NoInit, state.layouters.size(), layouterCapacities},
-        /* Running data offset (+1) for each item. This array gets overwritten
-           from scratch for each layer so zero-initializing is done inside
-           orderVisibleNodeDataInto() instead. */
-        {NoInit, state.nodes.size() + 1, visibleNodeDataOffsets},
         /* One more item for the stack root, which is the whole UI size */
         {NoInit, state.nodes.size() + 1, clipStack},
-        {NoInit, dataCount, visibleNodeDataIds},
         {NoInit, state.nodes.size(), visibleOrVisibilityLostEventNodeMask},
-    };
+    });
 
     /* If no node update is needed, the data in `state.nodeStateStorage` and
        all views pointing to it is already up-to-date. */
+    state.reportPhase(UserInterfacePhase::NodeOrder, false);
     if(states >= UserInterfaceState::NeedsNodeUpdate) {
-        /* Make a resident allocation for all node-related state */
-        state.nodeStateStorage = Containers::ArrayTuple{
-            {NoInit, state.nodes.size(), state.visibleNodeIds},
-            {NoInit, state.nodes.size(), state.visibleNodeChildrenCounts},
-            {NoInit, state.nodeOrder.size(), state.visibleFrontToBackTopLevelNodeIndices},
-            {NoInit, state.nodes.size(), state.nodeOffsets},
-            {NoInit, state.nodes.size(), state.nodeSizes},
-            {NoInit, state.nodes.size(), state.absoluteNodeOffsets},
-            {NoInit, state.nodes.size(), state.absoluteNodeOpacities},
-            {NoInit, state.nodes.size(), state.visibleNodeMask},
-            {NoInit, state.nodes.size(), state.visibleEventNodeMask},
-            {NoInit, state.nodes.size(), state.visibleEnabledNodeMask},
-            {NoInit, state.nodes.size(), state.clipRectOffsets},
-            {NoInit, state.nodes.size(), state.clipRectSizes},
-            {NoInit, state.nodes.size(), state.clipRectNodeCounts},
-        };
+        /* 1. Order the visible node hierarchy. If just root nodes got
+           reordered or removed from the top-level node order, or
+           NodeFlag::Hidden changed on a few non-top-level nodes since the
+           last time, patch the existing order in place. Everything else in
+           `state.nodeStateStorage` gets recalculated from scratch below
+           anyway, so the allocation can be reused. */
+        if(!state.visibleNodesNeedFullUpdate) {
+            CORRADE_INTERNAL_ASSERT(state.nodeChildren.size() == state.nodes.size());
+
+            /* The views are prefixes of the whole allocation, so expand them
+               back to the full size */
+            const Containers::ArrayView<UnsignedInt> visibleNodeIds{state.visibleNodeIds.data(), state.nodes.size()};
+            const Containers::ArrayView<UnsignedInt> visibleNodeChildrenCounts{state.visibleNodeChildrenCounts.data(), state.nodes.size()};
+            std::size_t visibleCount = state.visibleNodeIds.size();
+
+            /* Permute the visible ranges of top-level nodes first, as the
+               visible node indices from the last update() are valid only for
+               the original order */
+            if(state.visibleNodesNeedTopLevelReorder) {
+                Utility::copy(state.visibleNodeIds, previousVisibleNodeIds);
+                Utility::copy(state.visibleNodeChildrenCounts, previousVisibleNodeChildrenCounts);
+                visibleCount = Implementation::reorderVisibleTopLevelNodesInto(
+                    stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::order),
+                    stridedArrayView(state.nodeOrder).slice(&NodeOrder::used).slice(&NodeOrder::Used::next),
+                    state.firstNodeOrder, state.visibleNodeIndices,
+                    previousVisibleNodeIds, previousVisibleNodeChildrenCounts,
+                    visibleNodeIds, visibleNodeChildrenCounts);
+            }
+            for(const UnsignedInt id: state.hiddenChangedNodeIds)
+                visibleCount = Implementation::updateVisibleNodesDepthFirstInPlace(
+                    stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::parent),
+                    stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::order),
+                    stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::flags),
+                    state.nodeChildrenOffsets, state.nodeChildren, id,
+                    nodeAncestors, parentsToProcess,
+                    visibleNodeIds, visibleNodeChildrenCounts, visibleCount);
+            state.visibleNodeIds = visibleNodeIds.prefix(visibleCount);
+            state.visibleNodeChildrenCounts = visibleNodeChildrenCounts.prefix(visibleCount);
+
+        /* Otherwise make a new resident allocation for all node-related state
+           and order the visible node hierarchy from scratch */
+        } else {
+            state.nodeStateStorage = state.allocateStorage({
+                /* Running children offset (+1) for each node */
+                {ValueInit, state.nodes.size() + 1, state.nodeChildrenOffsets},
+                {NoInit, state.nodes.size(), state.nodeChildren},
+                {NoInit, state.nodes.size(), state.visibleNodeIds},
+                {NoInit, state.nodes.size(), state.visibleNodeChildrenCounts},
+                /* Zero-initialized to not have garbage for nodes that aren't
+                   visible */
+                {ValueInit, state.nodes.size(), state.visibleNodeIndices},
+                {NoInit, state.nodeOrder.size(), state.visibleFrontToBackTopLevelNodeIndices},
+                {NoInit, state.nodes.size(), state.nodeOffsets},
+                {NoInit, state.nodes.size(), state.nodeSizes},
+                {NoInit, state.nodes.size(), state.absoluteNodeOffsets},
+                {NoInit, state.nodes.size(), state.absoluteNodeOpacities},
+                {NoInit, state.nodes.size(), state.visibleNodeMask},
+                {NoInit, state.nodes.size(), state.visibleEventNodeMask},
+                {NoInit, state.nodes.size(), state.visibleEnabledNodeMask},
+                {NoInit, state.nodes.size(), state.focusChain},
+                {NoInit, state.nodes.size(), state.focusChainOffsets},
+                {NoInit, state.nodes.size(), state.clipRectOffsets},
+                {NoInit, state.nodes.size(), state.clipRectSizes},
+                {NoInit, state.nodes.size(), state.clipRectNodeCounts},
+            });
 
-        /* 1. Order the visible node hierarchy. */
-        {
             const std::size_t visibleCount = Implementation::orderVisibleNodesDepthFirstInto(
                 stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::parent),
                 stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::order),
                 stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::flags),
                 stridedArrayView(state.nodeOrder).slice(&NodeOrder::used).slice(&NodeOrder::Used::next),
-                state.firstNodeOrder, visibleNodes, childrenOffsets, children,
+                state.firstNodeOrder, visibleNodes, state.nodeChildrenOffsets, state.nodeChildren,
                 parentsToProcess, state.visibleNodeIds, state.visibleNodeChildrenCounts);
             state.visibleNodeIds = state.visibleNodeIds.prefix(visibleCount);
             state.visibleNodeChildrenCounts = state.visibleNodeChildrenCounts.prefix(visibleCount);
+
+            /* Next time the order can be patched in place, unless there are
+               nested top-level nodes, visibility of which
+               updateVisibleNodesDepthFirstInPlace() doesn't handle */
+            state.hasNestedTopLevelNodes = false;
+            if(state.firstNodeOrder != NodeHandle::Null) {
+                NodeHandle topLevel = state.firstNodeOrder;
+                do {
+                    const Node& topLevelNode = state.nodes[nodeHandleId(topLevel)];
+                    if(topLevelNode.used.parent != NodeHandle::Null) {
+                        state.hasNestedTopLevelNodes = true;
+                        break;
+                    }
+                    topLevel = state.nodeOrder[topLevelNode.used.order].used.next;
+                } while(topLevel != state.firstNodeOrder);
+            }
+            state.visibleNodesNeedFullUpdate = state.hasNestedTopLevelNodes;
         }
 
+        arrayResize(state.hiddenChangedNodeIds, NoInit, 0);
+        state.visibleNodesNeedTopLevelReorder = false;
+
+        /* Build a mapping from node IDs to the visible node list */
+        for(std::size_t i = 0; i != state.visibleNodeIds.size(); ++i)
+            state.visibleNodeIndices[state.visibleNodeIds[i]] = i;
+
         /* 2. Create a front-to-back index map for visible top-level nodes,
            i.e. populate it in a flipped order. */
         {
@@ -2712,6 +3721,8 @@ AbstractUserInterface& AbstractUserInterface::update() {
             state.visibleFrontToBackTopLevelNodeIndices = state.visibleFrontToBackTopLevelNodeIndices.exceptPrefix(state.visibleFrontToBackTopLevelNodeIndices.size() - count);
         }
     }
+    state.reportPhase(UserInterfacePhase::NodeOrder, true);
+    state.reportPhase(UserInterfacePhase::Layout, false);
 
     /* If no layout assignment update is needed, the
        `state.layouterStateStorage` and all views pointing to it are
@@ -2744,11 +3755,11 @@ AbstractUserInterface& AbstractUserInterface::update() {
         }
 
         /* Make a resident allocation for all layout-related state */
-        state.layoutStateStorage = Containers::ArrayTuple{
+        state.layoutStateStorage = state.allocateStorage({
             {NoInit, layoutCount + 1, state.topLevelLayoutOffsets},
             {NoInit, layoutCount, state.topLevelLayoutLayouterIds},
             {NoInit, layoutCount, state.topLevelLayoutIds},
-        };
+        });
 
         /* 4. Discover top-level layouts to be subsequently fed to layouter
            update() calls. */
@@ -2778,14 +3789,15 @@ AbstractUserInterface& AbstractUserInterface::update() {
 
         /* Calculate the total bit count for all layout masks and allocate
            them, together with a temporary mapping array */
-        /** @todo while everything else is tucked into an ArrayTuple, often
-            significantly overallocating, this is not -- have some bump
-            allocators finally */
         std::size_t maskSize = 0;
         for(std::size_t i = 0; i != maxLevelTopLevelLayoutOffsetCount.second() - 1; ++i)
             maskSize += state.layouters[state.topLevelLayoutLayouterIds[i]].used.instance->capacity();
-        state.layoutMasks = Containers::BitArray{ValueInit, maskSize};
-        Containers::Array<std::size_t> layouterLevelMaskOffsets{NoInit, state.layouters.size()*maxLevelTopLevelLayoutOffsetCount.first()};
+        Containers::MutableBitArrayView layoutMasks;
+        Containers::ArrayView<std::size_t> layouterLevelMaskOffsets;
+        Containers::ArrayTuple layoutMaskStorage = state.allocateScratchStorage({
+            {ValueInit, maskSize, layoutMasks},
+            {NoInit, state.layouters.size()*maxLevelTopLevelLayoutOffsetCount.first(), layouterLevelMaskOffsets},
+        });
 
         /* 5. Fill the per-layout-update masks. */
         Implementation::fillLayoutUpdateMasksInto(
@@ -2796,25 +3808,78 @@ AbstractUserInterface& AbstractUserInterface::update() {
             state.topLevelLayoutLayouterIds,
             layouterCapacities,
             stridedArrayView(layouterLevelMaskOffsets).expanded<0, 2>({maxLevelTopLevelLayoutOffsetCount.first(), state.layouters.size()}),
-            state.layoutMasks);
+            layoutMasks);
+    }
+
+    /* If any layer has intrinsic sizes of its data changed, the layout has to
+       be calculated fully, as only the full calculation applies them */
+    if(states >= UserInterfaceState::NeedsLayoutUpdate) for(const Layer& layer: state.layers) {
+        const AbstractLayer* const instance = layer.used.instance.get();
+        if(instance && layer.used.features >= LayerFeature::IntrinsicSize && instance->state() >= LayerState::NeedsIntrinsicSizeUpdate) {
+            state.nodeOffsetsNeedFullUpdate = true;
+            break;
+        }
     }
 
     /* If no layout update is needed, the `state.nodeOffsets`,
        `state.nodeSizes` and `state.absoluteNodeOffsets` are all
-       up-to-date */
-    if(states >= UserInterfaceState::NeedsLayoutUpdate) {
+       up-to-date. If just offsets of a few nodes changed, the visible node set
+       is the same as before, there are no layouts that could depend on the
+       offsets, and visible hierarchy of each node is contiguous, recalculate
+       the absolute offsets only for subtrees of those nodes. */
+    if(states >= UserInterfaceState::NeedsLayoutUpdate &&
+       !(states >= UserInterfaceState::NeedsLayoutAssignmentUpdate) &&
+       !state.nodeOffsetsNeedFullUpdate &&
+       state.topLevelLayoutOffsets.size() == 1 &&
+       !state.hasNestedTopLevelNodes)
+    {
+        for(const UnsignedInt id: state.offsetChangedNodeIds) {
+            state.nodeOffsets[id] = state.nodes[id].used.offset;
+
+            /* If the node isn't visible, there's no absolute offset to
+               update */
+            const UnsignedInt visibleNodeIndex = state.visibleNodeIndices[id];
+            if(visibleNodeIndex >= state.visibleNodeIds.size() || state.visibleNodeIds[visibleNodeIndex] != id)
+                continue;
+
+            /* Nodes are ordered in a way that parents are always before their
+               children, and child subtrees after their parents. Both the
+               area the subtree was at and the area it's at now is
+               damaged. */
+            for(std::size_t i = visibleNodeIndex, iMax = visibleNodeIndex + state.visibleNodeChildrenCounts[visibleNodeIndex] + 1; i != iMax; ++i) {
+                const UnsignedInt subtreeId = state.visibleNodeIds[i];
+                const Node& node = state.nodes[subtreeId];
+                const Vector2 nodeOffset = state.nodeOffsets[subtreeId];
+                state.damageRect = Math::join(state.damageRect, Range2D::fromSize(state.absoluteNodeOffsets[subtreeId], state.nodeSizes[subtreeId]));
+                state.absoluteNodeOffsets[subtreeId] =
+                    node.used.parent == NodeHandle::Null ? nodeOffset :
+                        state.absoluteNodeOffsets[nodeHandleId(node.used.parent)] + nodeOffset;
+                state.damageRect = Math::join(state.damageRect, Range2D::fromSize(state.absoluteNodeOffsets[subtreeId], state.nodeSizes[subtreeId]));
+            }
+        }
+
+    } else if(states >= UserInterfaceState::NeedsLayoutUpdate) {
         /* 6. Copy the explicitly set offset + sizes to the output. */
         Utility::copy(stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::offset), state.nodeOffsets);
         Utility::copy(stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::size), state.nodeSizes);
 
+        /* 6b. Let layers enlarge the node sizes to fit their contents, so the
+           layouters below can take them into account */
+        for(Layer& layer: state.layers) {
+            AbstractLayer* const instance = layer.used.instance.get();
+            if(instance && layer.used.features >= LayerFeature::IntrinsicSize)
+                instance->intrinsicSizes(state.nodeSizes);
+        }
+
         /* 7. Perform layout calculation for all top-level layouts. */
         std::size_t offset = 0;
         for(std::size_t i = 0; i != state.topLevelLayoutOffsets.size() - 1; ++i) {
             AbstractLayouter* const instance = state.layouters[state.topLevelLayoutLayouterIds[i]].used.instance.get();
             CORRADE_INTERNAL_ASSERT(instance);
 
+            TraceScope trace{state.traceCallback, state.traceCallbackUserData, UserInterfaceTraceScope::LayouterUpdate, UnsignedLong(instance->handle())};
             instance->update(
-                state.layoutMasks.sliceSize(offset, instance->capacity()),
+                layoutMasks.sliceSize(offset, instance->capacity()),
                 state.topLevelLayoutIds.slice(
                     state.topLevelLayoutOffsets[i],
                     state.topLevelLayoutOffsets[i + 1]),
@@ -2824,7 +3889,7 @@ AbstractUserInterface& AbstractUserInterface::update() {
 
             offset += instance->capacity();
         }
-        CORRADE_INTERNAL_ASSERT(offset == state.layoutMasks.size());
+        CORRADE_INTERNAL_ASSERT(offset == layoutMasks.size());
 
         /* Call a no-op update() on layouters that have Needs*Update flags but
            have no visible layouts so update() wasn't called for them above */
@@ -2832,9 +3897,13 @@ AbstractUserInterface& AbstractUserInterface::update() {
         for(Layouter& layouter: state.layouters) {
             AbstractLayouter* const instance = layouter.used.instance.get();
             if(instance && instance->state() & LayouterState::NeedsAssignmentUpdate) {
+                Containers::MutableBitArrayView layoutsToUpdate;
+                Containers::ArrayTuple layoutsToUpdateStorage = state.allocateScratchStorage({
+                    {ValueInit, instance->capacity(), layoutsToUpdate}
+                });
+                TraceScope trace{state.traceCallback, state.traceCallbackUserData, UserInterfaceTraceScope::LayouterUpdate, UnsignedLong(instance->handle())};
                 instance->update(
-                    /** @todo yeah and this allocation REALLY isn't great */
-                    Containers::BitArray{ValueInit, instance->capacity()},
+                    layoutsToUpdate,
                     {},
                     stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::parent),
                     state.nodeOffsets, state.nodeSizes);
@@ -2849,22 +3918,58 @@ AbstractUserInterface& AbstractUserInterface::update() {
                 node.used.parent == NodeHandle::Null ? nodeOffset :
                     state.absoluteNodeOffsets[nodeHandleId(node.used.parent)] + nodeOffset;
         }
+
+        /* Next time only the changed subtrees can be updated */
+        state.nodeOffsetsNeedFullUpdate = false;
+        state.damageNeedsFull = true;
     }
+    arrayResize(state.offsetChangedNodeIds, NoInit, 0);
 
     /* If no opacity update is needed, the `state.absoluteNodeOpacities` are
        all up-to-date */
-    if(states >= UserInterfaceState::NeedsNodeOpacityUpdate) {
-        for(const UnsignedInt id: state.visibleNodeIds) {
-            const Node& node = state.nodes[id];
-            const Float nodeOpacity = node.used.opacity;
-            state.absoluteNodeOpacities[id] =
-                node.used.parent == NodeHandle::Null ? nodeOpacity :
-                    state.absoluteNodeOpacities[nodeHandleId(node.used.parent)]*nodeOpacity;
+    const auto updateAbsoluteNodeOpacity = [&](const UnsignedInt id) {
+        const Node& node = state.nodes[id];
+        const Float nodeOpacity = node.used.opacity;
+        state.absoluteNodeOpacities[id] =
+            node.used.parent == NodeHandle::Null ? nodeOpacity :
+                state.absoluteNodeOpacities[nodeHandleId(node.used.parent)]*nodeOpacity;
+    };
+    /* If only node opacities changed since last time and the visible
+       hierarchy of each node is contiguous, recalculate them only for
+       subtrees of the changed nodes */
+    if(states >= UserInterfaceState::NeedsNodeOpacityUpdate &&
+       !(states >= UserInterfaceState::NeedsNodeUpdate) &&
+       !state.nodeOpacitiesNeedFullUpdate &&
+       !state.hasNestedTopLevelNodes)
+    {
+        for(const UnsignedInt id: state.opacityChangedNodeIds) {
+            /* If the node isn't visible, there's no absolute opacity to
+               update */
+            const UnsignedInt visibleNodeIndex = state.visibleNodeIndices[id];
+            if(visibleNodeIndex >= state.visibleNodeIds.size() || state.visibleNodeIds[visibleNodeIndex] != id)
+                continue;
+
+            for(std::size_t i = visibleNodeIndex, iMax = visibleNodeIndex + state.visibleNodeChildrenCounts[visibleNodeIndex] + 1; i != iMax; ++i) {
+                const UnsignedInt subtreeId = state.visibleNodeIds[i];
+                updateAbsoluteNodeOpacity(subtreeId);
+                state.damageRect = Math::join(state.damageRect, Range2D::fromSize(state.absoluteNodeOffsets[subtreeId], state.nodeSizes[subtreeId]));
+            }
         }
+
+    } else if(states >= UserInterfaceState::NeedsNodeOpacityUpdate) {
+        for(const UnsignedInt id: state.visibleNodeIds)
+            updateAbsoluteNodeOpacity(id);
+
+        /* Next time only the changed subtrees can be updated */
+        state.nodeOpacitiesNeedFullUpdate = false;
+        state.damageNeedsFull = true;
     }
+    arrayResize(state.opacityChangedNodeIds, NoInit, 0);
+    state.reportPhase(UserInterfacePhase::Layout, true);
 
     /* If no clip update is needed, the `state.visibleNodeMask` is all
        up-to-date */
+    state.reportPhase(UserInterfacePhase::Cull, false);
     if(states >= UserInterfaceState::NeedsNodeClipUpdate) {
         /* 9. Cull / clip the visible nodes based on their clip rects and the
            offset + size of the whole UI (window / screen area) */
@@ -2885,6 +3990,32 @@ AbstractUserInterface& AbstractUserInterface::update() {
             state.clipRectSizes,
             state.clipRectNodeCounts);
 
+        /* Cull also fully transparent subtrees of nodes that opted in for
+           that */
+        for(std::size_t i = 0; i != state.visibleNodeIds.size(); ++i) {
+            const UnsignedInt id = state.visibleNodeIds[i];
+            if(!(state.nodes[id].used.flags >= NodeFlag::CullTransparent) ||
+               state.absoluteNodeOpacities[id] != 0.0f)
+                continue;
+
+            const std::size_t iMax = i + state.visibleNodeChildrenCounts[i] + 1;
+            for(std::size_t j = i; j != iMax; ++j)
+                state.visibleNodeMask.reset(state.visibleNodeIds[j]);
+            i = iMax - 1;
+        }
+
+        /* Cull nodes fully covered by opaque top-level nodes drawn after
+           them */
+        Implementation::cullOccludedVisibleNodesInto(
+            state.absoluteNodeOffsets,
+            state.nodeSizes,
+            stridedArrayView(state.nodes).slice(&Node::used).slice(&Node::Used::flags),
+            state.visibleNodeIds,
+            state.visibleNodeChildrenCounts,
+            state.visibleFrontToBackTopLevelNodeIndices,
+            state.occluders,
+            state.visibleNodeMask);
+
         /** @todo might want also a layer-specific cull / clip implementation
             that gets called after the "upload" step, for line art, text runs
             and such */
@@ -2919,11 +4050,26 @@ AbstractUserInterface& AbstractUserInterface::update() {
             state.visibleNodeIds,
             state.visibleNodeChildrenCounts,
             state.visibleEnabledNodeMask);
+
+        /* Build the focus chain for nextFocusableNode() and
+           previousFocusableNode(). The view is a prefix of the whole
+           allocation, so expand it back to the full size first. */
+        const Containers::ArrayView<UnsignedInt> focusChain{state.focusChain.data(), state.nodes.size()};
+        std::size_t focusChainCount = 0;
+        for(const UnsignedInt id: state.visibleNodeIds) {
+            state.focusChainOffsets[id] = focusChainCount;
+            if(state.visibleEventNodeMask[id] && state.nodes[id].used.flags >= NodeFlag::Focusable)
+                focusChain[focusChainCount++] = id;
+        }
+        state.focusChain = focusChain.prefix(focusChainCount);
     }
 
+    state.reportPhase(UserInterfacePhase::Cull, true);
+
     /* If no data attachment update is needed, the data in
        `state.dataStateStorage` and all views pointing to it is already
        up-to-date. */
+    state.reportPhase(UserInterfacePhase::DataOrder, false);
     if(states >= UserInterfaceState::NeedsDataAttachmentUpdate ||
        /* Trigger this branch also if NeedsDataUpdate is set but size of
           `state.dataToUpdateLayerOffsets` isn't in sync with `state.layers`
@@ -2932,6 +4078,28 @@ AbstractUserInterface& AbstractUserInterface::update() {
        /** @todo FFS this is rather horrible, exhibit 2 of 2 */
        (states >= UserInterfaceState::NeedsDataUpdate && state.layers.size() + 1 != state.dataToUpdateLayerOffsets.size()))
     {
+        /* If NeedsDataAttachmentUpdate is set only as a consequence of
+           NeedsNodeEnabledUpdate, i.e. just NodeFlag::NoEvents,
+           NodeFlag::Disabled or NodeFlag::Focusable changed, the set of
+           visible nodes and the data attached to them stays the same. Then
+           the data to update and the draw list from the previous update() is
+           kept and only the event data are rebuilt. Otherwise, if the visible
+           node set changed, data were attached or detached in any layer, a
+           layer was removed or added, everything is rebuilt. */
+        bool drawOrderNeedsUpdate =
+            states >= UserInterfaceState::NeedsNodeClipUpdate ||
+            state.drawOrderNeedsUpdate ||
+            state.layers.size() + 1 != state.dataToUpdateLayerOffsets.size();
+        if(!drawOrderNeedsUpdate) for(const Layer& layer: state.layers) {
+            if(const AbstractLayer* const instance = layer.used.instance.get()) {
+                if(instance->state() >= LayerState::NeedsAttachmentUpdate) {
+                    drawOrderNeedsUpdate = true;
+                    break;
+                }
+            }
+        }
+        state.drawOrderNeedsUpdate = false;
+
         /* Make visibleOrVisibilityLostEventNodeMask a copy of
            visibleEventNodeMask with additional bits set for state.current*Node
            that are valid but possibly now hidden or not taking events. This
@@ -2977,8 +4145,13 @@ AbstractUserInterface& AbstractUserInterface::update() {
                 compositingDataCount += layer.used.instance->capacity();
         }
 
-        /* Make a resident allocation for all data-related state */
-        state.dataStateStorage = Containers::ArrayTuple{
+        /* Make a resident allocation for all data-related state, or, if the
+           draw order is kept, just clear the event data counts that are
+           otherwise zero-initialized by the allocation */
+        if(!drawOrderNeedsUpdate) {
+            for(UnsignedInt& i: state.visibleNodeEventDataOffsets)
+                i = 0;
+        } else state.dataStateStorage = state.allocateStorage({
             /* Running data offset (+1) for each item. Populated sequentially
                so it doesn't need to be zero-initialized. */
             {NoInit, state.layers.size() + 1, state.dataToUpdateLayerOffsets},
@@ -2999,9 +4172,12 @@ AbstractUserInterface& AbstractUserInterface::update() {
             /* Running data offset (+1) for each item */
             {ValueInit, state.nodes.size() + 1, state.visibleNodeEventDataOffsets},
             {NoInit, dataCount, state.visibleNodeEventData},
-        };
+            {NoInit, state.nodes.size(), state.visibleNodeEventBoundsMin},
+            {NoInit, state.nodes.size(), state.visibleNodeEventBoundsMax},
+        });
 
-        state.dataToUpdateLayerOffsets[0] = {0, 0, 0};
+        if(drawOrderNeedsUpdate)
+            state.dataToUpdateLayerOffsets[0] = {0, 0, 0};
         if(state.firstLayer != LayerHandle::Null) {
             /* 10. Go through the layer draw order and order data of each layer
                that are assigned to visible nodes into a contiguous range,
@@ -3031,6 +4207,18 @@ AbstractUserInterface& AbstractUserInterface::update() {
             for(UnsignedInt i = 0; i != state.layers.size(); ++i) {
                 const Layer& layerItem = state.layers[i];
 
+                /* If the draw order is kept, only count the event data, and
+                   keep the to-update offsets as well. The features being
+                   non-empty again implies an instance is present. */
+                if(!drawOrderNeedsUpdate) {
+                    if(layerItem.used.features >= LayerFeature::Event)
+                        Implementation::countNodeDataForEventHandlingInto(
+                            layerItem.used.instance->nodeDataCounts(),
+                            state.visibleNodeEventDataOffsets,
+                            visibleOrVisibilityLostEventNodeMask);
+                    continue;
+                }
+
                 if(const AbstractLayer* const instance = layerItem.used.instance.get()) {
                     /* The `state.dataToDrawOffsets` etc views that are sliced
                        below are filled only for the layers that support
@@ -3043,12 +4231,12 @@ AbstractUserInterface& AbstractUserInterface::update() {
                     const Containers::Pair<UnsignedInt, UnsignedInt> out = Implementation::orderVisibleNodeDataInto(
                         state.visibleNodeIds,
                         state.visibleNodeChildrenCounts,
-                        instance->nodes(),
+                        instance->nodeFirstDataIds(),
+                        instance->nodeDataCounts(),
+                        instance->nodeNextDataIds(),
                         layerItem.used.features,
                         state.visibleNodeMask,
                         state.clipRectNodeCounts.prefix(state.clipRectCount),
-                        visibleNodeDataOffsets,
-                        visibleNodeDataIds.prefix(instance->capacity()),
                         state.dataToUpdateIds,
                         state.dataToUpdateClipRectIds,
                         state.dataToUpdateClipRectDataCounts,
@@ -3097,7 +4285,7 @@ AbstractUserInterface& AbstractUserInterface::update() {
                        called. */
                     if(layerItem.used.features >= LayerFeature::Event)
                         Implementation::countNodeDataForEventHandlingInto(
-                            instance->nodes(),
+                            instance->nodeDataCounts(),
                             state.visibleNodeEventDataOffsets,
                             visibleOrVisibilityLostEventNodeMask);
 
@@ -3164,11 +4352,13 @@ AbstractUserInterface& AbstractUserInterface::update() {
                    presence of an instance as well. */
                 if(layerItem.used.features & LayerFeature::Event) {
                     Implementation::orderNodeDataForEventHandlingInto(
-                        layer,
+                        layerId,
                         /* If the Layer::features is non-empty, it means the
-                           instance is present (from which it was taken). No
-                           need to explicitly check that as well. */
-                        layerItem.used.instance->nodes(),
+                           instance is present. No need to explicitly check
+                           that as well. */
+                        layerItem.used.instance->nodeFirstDataIds(),
+                        layerItem.used.instance->nodeDataCounts(),
+                        layerItem.used.instance->nodeNextDataIds(),
                         state.visibleNodeEventDataOffsets,
                         /* Again the visibleOrVisibilityLostEventNodeMask is
                            used instead of state.visibleEventNodeMask to make
@@ -3183,11 +4373,54 @@ AbstractUserInterface& AbstractUserInterface::update() {
             } while(layer != lastLayer);
         }
 
-        /* 13. Compact the draw calls by throwing away the empty ones. This
-           cannot be done in the above loop directly as it'd need to go first
-           by top-level node and then by layer in each. That it used to do in a
-           certain way before which was much slower. */
-        state.drawCount = Implementation::compactDrawsInPlace(
+        /* Calculate bounds of nodes with event data for each visible subtree
+           to make hit testing in callEvent() skip subtrees that don't have
+           anything to call the event on. If there are no layers, the offsets
+           are all zero, resulting in empty bounds for all nodes. */
+        Implementation::nodeEventBoundsInto(
+            state.visibleNodeIds,
+            state.visibleNodeChildrenCounts,
+            state.absoluteNodeOffsets,
+            state.nodeSizes,
+            state.visibleEventNodeMask,
+            state.visibleNodeEventDataOffsets,
+            state.visibleNodeEventBoundsMin,
+            state.visibleNodeEventBoundsMax);
+
+        /* The bounds changed, so the hovered node may no longer be the
+           front-most one at its whole area */
+        state.hoverFastPathNode = NodeHandle::Null;
+
+        /* 13. If enabled, move draws of top-level nodes that don't overlap
+           the previous ones next to each other. Then compact the draw calls
+           by throwing away the empty ones and merging adjacent draws of the
+           same layer. This cannot be done in the above loop directly as it'd
+           need to go first by top-level node and then by layer in each. That
+           it used to do in a certain way before which was much slower. If the
+           draw order is kept, the draw list is already compacted from
+           before. */
+        const Containers::StridedArrayView1D<const LayerFeatures> layerFeatures = stridedArrayView(state.layers)
+            .slice(&Layer::used)
+            .slice(&Layer::Used::features);
+        if(drawOrderNeedsUpdate && state.disjointTopLevelNodeDrawMerging)
+            Implementation::mergeDisjointTopLevelNodeDrawsInPlace(
+                state.visibleNodeIds,
+                state.visibleNodeChildrenCounts,
+                state.absoluteNodeOffsets,
+                state.nodeSizes,
+                state.visibleNodeMask,
+                state.clipRectOffsets.prefix(state.clipRectCount),
+                state.clipRectSizes.prefix(state.clipRectCount),
+                state.clipRectNodeCounts.prefix(state.clipRectCount),
+                layerFeatures,
+                drawLayerCount,
+                state.dataToDrawLayerIds,
+                state.dataToDrawOffsets,
+                state.dataToDrawSizes,
+                state.dataToDrawClipRectOffsets,
+                state.dataToDrawClipRectSizes);
+        if(drawOrderNeedsUpdate) state.drawCount = Implementation::compactDrawsInPlace(
+            layerFeatures,
             state.dataToDrawLayerIds,
             state.dataToDrawOffsets,
             state.dataToDrawSizes,
@@ -3262,6 +4495,37 @@ AbstractUserInterface& AbstractUserInterface::update() {
        doesn't get used. */
     visibleOrVisibilityLostEventNodeMask = {};
 
+    state.reportPhase(UserInterfacePhase::DataOrder, true);
+
+    /* If node update statistics are enabled, record nodes that have data
+       about to be updated in the layers and commit them together with nodes
+       that had their offset or size changed since the last update(). Done
+       before layer states get queried again below, so a layer presenting the
+       statistics can request an update in reaction to a new frame being
+       recorded. */
+    if(state.nodeUpdateStatisticsFrameCount) {
+        state.growNodeUpdateStatistics();
+        for(const Layer& layer: state.layers) {
+            const AbstractLayer* const instance = layer.used.instance.get();
+            if(!instance || !(instance->state() >= LayerState::NeedsDataUpdate))
+                continue;
+
+            /* If no particular data are marked as modified, the whole layer
+               is going to be updated */
+            const Containers::BitArrayView modified = instance->modifiedDataMask();
+            const bool all = !modified.any();
+            const Containers::StridedArrayView1D<const NodeHandle> nodes = instance->nodes();
+            for(std::size_t i = 0; i != nodes.size(); ++i) {
+                if(!all && (i >= modified.size() || !modified[i]))
+                    continue;
+                if(isHandleValid(nodes[i]))
+                    state.nodeDataUpdatedMask.set(nodeHandleId(nodes[i]));
+            }
+        }
+
+        state.commitNodeUpdateStatistics();
+    }
+
     /* 15. Decide what all to update on all layers */
     LayerStates allLayerStateToUpdate;
     LayerStates allCompositeLayerStateToUpdate;
@@ -3293,10 +4557,12 @@ AbstractUserInterface& AbstractUserInterface::update() {
     /* 16. For each layer (if there are actually any) submit an update of
        visible data across all visible top-level nodes. If no data update is
        needed, the data in layers is already up-to-date. */
+    state.reportPhase(UserInterfacePhase::LayerUpdate, false);
     if(states >= UserInterfaceState::NeedsDataUpdate && state.firstLayer != LayerHandle::Null) {
         /* Make the update calls follow layer order so the implementations can
            rely on a consistent order of operations compared to going through
            whatever was the order they were created in */
+        arrayResize(state.layerUpdates, NoInit, 0);
         LayerHandle layer = state.firstLayer;
         do {
             const UnsignedInt layerId = layerHandleId(layer);
@@ -3317,45 +4583,70 @@ AbstractUserInterface& AbstractUserInterface::update() {
 
             /* If the layer has an instance (as layers may have been created
                but without instances set yet) and there's something to update,
-               call update() on it */
-            /** @todo include a bitmask of what data actually changed */
-            if(instance && layerStateToUpdate) instance->update(
-                layerStateToUpdate,
-                state.dataToUpdateIds.slice(
-                    state.dataToUpdateLayerOffsets[layerId].first(),
-                    state.dataToUpdateLayerOffsets[layerId + 1].first()),
-                state.dataToUpdateClipRectIds.slice(
-                    state.dataToUpdateLayerOffsets[layerId].second(),
-                    state.dataToUpdateLayerOffsets[layerId + 1].second()),
-                state.dataToUpdateClipRectDataCounts.slice(
-                    state.dataToUpdateLayerOffsets[layerId].second(),
-                    state.dataToUpdateLayerOffsets[layerId + 1].second()),
-                /** @todo some layer implementations may eventually want
-                    relative offsets, not absolute, provide both? */
-                /** @todo once the changed mask is there, might be useful to
-                    have (opt-in?) offsets relative to the clip rect -- it can
-                    be a different draw anyway, so it might be easier to just
-                    add an extra transform at draw time without triggering a
-                    full data update for all offsets; what changes is the
-                    culling tho, which still needs at least the index buffer
-                    update, not everything */
-                state.absoluteNodeOffsets,
-                state.nodeSizes,
-                state.absoluteNodeOpacities,
-                state.visibleEnabledNodeMask,
-                state.clipRectOffsets.prefix(state.clipRectCount),
-                state.clipRectSizes.prefix(state.clipRectCount),
-                state.dataToUpdateCompositeRectOffsets.slice(
-                    state.dataToUpdateLayerOffsets[layerId].third(),
-                    state.dataToUpdateLayerOffsets[layerId + 1].third()),
-                state.dataToUpdateCompositeRectSizes.slice(
-                    state.dataToUpdateLayerOffsets[layerId].third(),
-                    state.dataToUpdateLayerOffsets[layerId + 1].third()));
+               schedule an update() call on it */
+            if(instance && layerStateToUpdate)
+                arrayAppend(state.layerUpdates, InPlaceInit, layerId, layerStateToUpdate);
 
             layer = layerItem.used.next;
         } while(layer != state.firstLayer);
+
+        /* The task gets called either directly in layer order or, if an
+           executor is set, in an arbitrary order and possibly from multiple
+           threads. Each call touches just a single layer instance, everything
+           else is only read from. */
+        struct LayerUpdateTask {
+            static void run(void* taskState, UnsignedInt i) {
+                State& state = *static_cast<State*>(taskState);
+                const UnsignedInt layerId = state.layerUpdates[i].first();
+
+                /* Which data actually changed is tracked by each layer
+                   itself, available through modifiedDataMask() */
+                state.layers[layerId].used.instance->update(
+                    state.layerUpdates[i].second(),
+                    state.dataToUpdateIds.slice(
+                        state.dataToUpdateLayerOffsets[layerId].first(),
+                        state.dataToUpdateLayerOffsets[layerId + 1].first()),
+                    state.dataToUpdateClipRectIds.slice(
+                        state.dataToUpdateLayerOffsets[layerId].second(),
+                        state.dataToUpdateLayerOffsets[layerId + 1].second()),
+                    state.dataToUpdateClipRectDataCounts.slice(
+                        state.dataToUpdateLayerOffsets[layerId].second(),
+                        state.dataToUpdateLayerOffsets[layerId + 1].second()),
+                    /** @todo some layer implementations may eventually want
+                        relative offsets, not absolute, provide both? */
+                    /** @todo once the changed mask is there, might be useful
+                        to have (opt-in?) offsets relative to the clip rect --
+                        it can be a different draw anyway, so it might be
+                        easier to just add an extra transform at draw time
+                        without triggering a full data update for all offsets;
+                        what changes is the culling tho, which still needs at
+                        least the index buffer update, not everything */
+                    state.absoluteNodeOffsets,
+                    state.nodeSizes,
+                    state.absoluteNodeOpacities,
+                    state.visibleEnabledNodeMask,
+                    state.clipRectOffsets.prefix(state.clipRectCount),
+                    state.clipRectSizes.prefix(state.clipRectCount),
+                    state.dataToUpdateCompositeRectOffsets.slice(
+                        state.dataToUpdateLayerOffsets[layerId].third(),
+                        state.dataToUpdateLayerOffsets[layerId + 1].third()),
+                    state.dataToUpdateCompositeRectSizes.slice(
+                        state.dataToUpdateLayerOffsets[layerId].third(),
+                        state.dataToUpdateLayerOffsets[layerId + 1].third()));
+            }
+        };
+
+        if(state.layerUpdateExecutor && state.layerUpdates.size() > 1)
+            state.layerUpdateExecutor(state.layerUpdates.size(), LayerUpdateTask::run, &state, state.layerUpdateExecutorUserData);
+        else for(UnsignedInt i = 0; i != state.layerUpdates.size(); ++i) {
+            const UnsignedInt layerId = state.layerUpdates[i].first();
+            TraceScope trace{state.traceCallback, state.traceCallbackUserData, UserInterfaceTraceScope::LayerUpdate, UnsignedLong(layerHandle(layerId, state.layers[layerId].used.generation))};
+            LayerUpdateTask::run(&state, i);
+        }
     }
 
+    state.reportPhase(UserInterfacePhase::LayerUpdate, true);
+
     /** @todo layer-specific cull/clip step? */
 
     /* Unmark the UI as needing an update() call. No other states should be
@@ -3370,16 +4661,36 @@ AbstractUserInterface& AbstractUserInterface::update() {
 }
 
 AbstractUserInterface& AbstractUserInterface::draw() {
-    State& state = *_state;
-    CORRADE_ASSERT(state.renderer,
+    CORRADE_ASSERT(_state->renderer,
         "Ui::AbstractUserInterface::draw(): no renderer instance set", *this);
 
     /* Call update implicitly in order to make the internal state ready for
        drawing. Is a no-op if there's nothing to update or clean. */
     update();
 
+    drawInternal();
+    return *this;
+}
+
+AbstractUserInterface& AbstractUserInterface::submit() {
+    CORRADE_ASSERT(_state->renderer,
+        "Ui::AbstractUserInterface::submit(): no renderer instance set", *this);
+    #ifndef CORRADE_NO_ASSERT
+    const UserInterfaceStates states = this->state();
+    #endif
+    CORRADE_ASSERT(!(states & UserInterfaceState::NeedsNodeClean),
+        "Ui::AbstractUserInterface::submit(): update() has to be called first, the user interface has" << (states & UserInterfaceState::NeedsNodeClean), *this);
+
+    drawInternal();
+    return *this;
+}
+
+void AbstractUserInterface::drawInternal() {
+    State& state = *_state;
+
     /* Transition the renderer to the initial state if it was in Final. If it's
        already there, this is a no-op. */
+    state.reportPhase(UserInterfacePhase::Draw, false);
     AbstractRenderer& renderer = *state.renderer;
     renderer.transition(RendererTargetState::Initial, {});
 
@@ -3399,6 +4710,8 @@ AbstractUserInterface& AbstractUserInterface::draw() {
         if(features >= LayerFeature::Composite) {
             renderer.transition(RendererTargetState::Composite, {});
 
+            state.reportPhase(UserInterfacePhase::Composite, false);
+            TraceScope trace{state.traceCallback, state.traceCallbackUserData, UserInterfaceTraceScope::LayerComposite, UnsignedLong(instance.handle())};
             instance.composite(renderer,
                 /* The views should be exactly the same as passed to update()
                    before ... */
@@ -3411,6 +4724,7 @@ AbstractUserInterface& AbstractUserInterface::draw() {
                 /* ... and the offset then being relative to those */
                 state.dataToDrawOffsets[i] - state.dataToUpdateLayerOffsets[layerId].first(),
                 state.dataToDrawSizes[i]);
+            state.reportPhase(UserInterfacePhase::Composite, true);
         }
 
         /* Transition between draw states. If they're the same, it's a no-op in
@@ -3422,6 +4736,7 @@ AbstractUserInterface& AbstractUserInterface::draw() {
             rendererDrawStates |= RendererDrawState::Scissor;
         renderer.transition(RendererTargetState::Draw, rendererDrawStates);
 
+        TraceScope trace{state.traceCallback, state.traceCallbackUserData, UserInterfaceTraceScope::LayerDraw, UnsignedLong(instance.handle())};
         instance.draw(
             /* The views should be exactly the same as passed to update()
                before ... */
@@ -3452,7 +4767,12 @@ AbstractUserInterface& AbstractUserInterface::draw() {
     /* Transition the renderer to the final state. If no layers were drawn,
        it goes just from Initial to Final. */
     renderer.transition(RendererTargetState::Final, {});
-    return *this;
+
+    /* Everything is drawn, next damage is calculated relative to this
+       draw */
+    state.damageRect = {};
+    state.damageNeedsFull = false;
+    state.reportPhase(UserInterfacePhase::Draw, true);
 }
 
 /* Used only in update() but put here to have the loops and other event-related
@@ -3471,8 +4791,8 @@ void AbstractUserInterface::callVisibilityLostEventOnNode(const UnsignedInt node
        want to call visibilityLostEvent() on nodes that no longer accept
        events. */
     for(UnsignedInt j = state.visibleNodeEventDataOffsets[nodeId], jMax = state.visibleNodeEventDataOffsets[nodeId + 1]; j != jMax; ++j) {
-        const DataHandle data = state.visibleNodeEventData[j];
-        state.layers[dataHandleLayerId(data)].used.instance->visibilityLostEvent(dataHandleId(data), event);
+        const UnsignedInt data = state.visibleNodeEventData[j];
+        state.layers[Implementation::nodeEventDataLayerId(data)].used.instance->visibilityLostEvent(Implementation::nodeEventDataId(data), event);
     }
 }
 
@@ -3486,9 +4806,9 @@ template<void(AbstractLayer::*function)(UnsignedInt, FocusEvent&)> bool Abstract
 
     bool acceptedByAnyData = false;
     for(UnsignedInt j = state.visibleNodeEventDataOffsets[nodeId], jMax = state.visibleNodeEventDataOffsets[nodeId + 1]; j != jMax; ++j) {
-        const DataHandle data = state.visibleNodeEventData[j];
+        const UnsignedInt data = state.visibleNodeEventData[j];
         event._accepted = false;
-        ((*state.layers[dataHandleLayerId(data)].used.instance).*function)(dataHandleId(data), event);
+        ((*state.layers[Implementation::nodeEventDataLayerId(data)].used.instance).*function)(Implementation::nodeEventDataId(data), event);
 
         if(event._accepted)
             acceptedByAnyData = true;
@@ -3509,9 +4829,9 @@ template<void(AbstractLayer::*function)(UnsignedInt, KeyEvent&)> bool AbstractUs
 
     bool acceptedByAnyData = false;
     for(UnsignedInt j = state.visibleNodeEventDataOffsets[nodeId], jMax = state.visibleNodeEventDataOffsets[nodeId + 1]; j != jMax; ++j) {
-        const DataHandle data = state.visibleNodeEventData[j];
+        const UnsignedInt data = state.visibleNodeEventData[j];
         event._accepted = false;
-        ((*state.layers[dataHandleLayerId(data)].used.instance).*function)(dataHandleId(data), event);
+        ((*state.layers[Implementation::nodeEventDataLayerId(data)].used.instance).*function)(Implementation::nodeEventDataId(data), event);
         if(event._accepted)
             acceptedByAnyData = true;
 
@@ -3530,9 +4850,9 @@ bool AbstractUserInterface::callTextInputEventOnNode(const UnsignedInt nodeId, T
     State& state = *_state;
     bool acceptedByAnyData = false;
     for(UnsignedInt j = state.visibleNodeEventDataOffsets[nodeId], jMax = state.visibleNodeEventDataOffsets[nodeId + 1]; j != jMax; ++j) {
-        const DataHandle data = state.visibleNodeEventData[j];
+        const UnsignedInt data = state.visibleNodeEventData[j];
         event._accepted = false;
-        state.layers[dataHandleLayerId(data)].used.instance->textInputEvent(dataHandleId(data), event);
+        state.layers[Implementation::nodeEventDataLayerId(data)].used.instance->textInputEvent(Implementation::nodeEventDataId(data), event);
 
         if(event._accepted)
             acceptedByAnyData = true;
@@ -3564,10 +4884,10 @@ template<class Event, void(AbstractLayer::*function)(UnsignedInt, Event&)> bool
     const bool captured = event._captured;
     bool acceptedByAnyData = false;
     for(UnsignedInt j = state.visibleNodeEventDataOffsets[nodeId], jMax = state.visibleNodeEventDataOffsets[nodeId + 1]; j != jMax; ++j) {
-        const DataHandle data = state.visibleNodeEventData[j];
+        const UnsignedInt data = state.visibleNodeEventData[j];
         event._position = globalPositionScaled - state.absoluteNodeOffsets[nodeId];
         event._accepted = false;
-        ((*state.layers[dataHandleLayerId(data)].used.instance).*function)(dataHandleId(data), event);
+        ((*state.layers[Implementation::nodeEventDataLayerId(data)].used.instance).*function)(Implementation::nodeEventDataId(data), event);
         if(event._accepted)
             acceptedByAnyData = true;
 
@@ -3607,17 +4927,16 @@ template<class Event, void(AbstractLayer::*function)(UnsignedInt, Event&)> NodeH
     if(!state.visibleEventNodeMask[nodeId])
         return {};
 
-    /* If the position is outside the node, we got nothing */
-    const Vector2 nodeOffset = state.absoluteNodeOffsets[nodeId];
-    if((globalPositionScaled < nodeOffset).any() ||
-       (globalPositionScaled >= nodeOffset + state.nodeSizes[nodeId]).any())
+    /* If the position is outside the bounds of nodes that have any event
+       data in this subtree, we got nothing. The bounds are clipped to the node
+       rectangle, so this also covers the case of the position being outside
+       the node itself. */
+    if((globalPositionScaled < state.visibleNodeEventBoundsMin[nodeId]).any() ||
+       (globalPositionScaled >= state.visibleNodeEventBoundsMax[nodeId]).any())
         return {};
 
     /* If the position is inside, recurse into *direct* children. If the event
        is handled there, we're done. */
-    /** @todo maintain some info about how many actual event handlers is in
-        particular subtrees, to not have to do complex hit testing when there's
-        nothing to call anyway? especially for move events and such */
     for(UnsignedInt i = 1, iMax = state.visibleNodeChildrenCounts[visibleNodeIndex] + 1; i != iMax; i += state.visibleNodeChildrenCounts[visibleNodeIndex + i] + 1) {
         const NodeHandle called = callEvent<Event, function>(globalPositionScaled, visibleNodeIndex + i, event);
         if(called != NodeHandle::Null)
@@ -3649,6 +4968,12 @@ bool AbstractUserInterface::pointerPressEvent(const Vector2& globalPosition, Poi
     CORRADE_ASSERT(!event._accepted,
         "Ui::AbstractUserInterface::pointerPressEvent(): event already accepted", {});
 
+    /* Dispatch a coalesced pointer move event, if there's any, to preserve
+       the event order. The update() in pointerReleaseEvent() and others does
+       that implicitly. */
+    flushPendingPointerMoveEvent();
+
+    TraceScope trace{_state->traceCallback, _state->traceCallbackUserData, UserInterfaceTraceScope::Event};
     State& state = *_state;
 
     /* This will be invalid if setSize() wasn't called yet, but callEvent() has
@@ -3762,6 +5087,8 @@ bool AbstractUserInterface::pointerReleaseEvent(const Vector2& globalPosition, P
     CORRADE_ASSERT(!event._accepted,
         "Ui::AbstractUserInterface::pointerReleaseEvent(): event already accepted", {});
 
+    TraceScope trace{_state->traceCallback, _state->traceCallbackUserData, UserInterfaceTraceScope::Event};
+
     /* Update so we don't have stale pointerEventCapture{Node,Data}. Otherwise
        the update() gets called only later in callEvent(). */
     update();
@@ -3871,6 +5198,174 @@ bool AbstractUserInterface::pointerMoveEvent(const Vector2& globalPosition, Poin
     CORRADE_ASSERT(!event._accepted,
         "Ui::AbstractUserInterface::pointerMoveEvent(): event already accepted", {});
 
+    State& state = *_state;
+
+    /* Coalesce only primary events that don't change the set of pressed
+       pointers, and only if the node that's going to receive the event
+       doesn't want all of them. As update() wasn't called yet, the captured
+       or hovered node may be stale, so check its validity first. */
+    if(state.pointerMoveEventCoalescing && event.isPrimary() && !event.pointer()) {
+        const NodeHandle node = state.currentCapturedNode != NodeHandle::Null ?
+            state.currentCapturedNode : state.currentHoveredNode;
+        if(node == NodeHandle::Null || !isHandleValid(node) || !(state.nodes[nodeHandleId(node)].used.flags >= NodeFlag::RawPointerMoveEvents)) {
+            /* Replace a queued event if it's from the same pointer, otherwise
+               dispatch it first */
+            UnsignedInt coalescedCount = 0;
+            if(state.pendingPointerMoveEvent) {
+                const PointerMoveEvent& pending = *state.pendingPointerMoveEvent;
+                if(pending.source() == event.source() &&
+                   pending.id() == event.id() &&
+                   pending.pointers() == event.pointers())
+                    coalescedCount = pending._coalescedCount + 1;
+                else
+                    flushPendingPointerMoveEvent();
+            }
+
+            /* The relative position is calculated only once the event is
+               dispatched, so it'll include motion of all events it replaced */
+            state.pendingPointerMoveEvent = event;
+            state.pendingPointerMoveEvent->_coalescedCount = coalescedCount;
+            state.pendingPointerMoveEventPosition = globalPosition;
+            return false;
+        }
+    }
+
+    flushPendingPointerMoveEvent();
+    return pointerMoveEventInternal(globalPosition, event);
+}
+
+void AbstractUserInterface::flushPendingPointerMoveEvent() {
+    State& state = *_state;
+    if(!state.pendingPointerMoveEvent)
+        return;
+
+    /* Take the event out before dispatching, as pointerMoveEventInternal()
+       calls update(), which would attempt to dispatch it again */
+    PointerMoveEvent event = *state.pendingPointerMoveEvent;
+    const Vector2 globalPosition = state.pendingPointerMoveEventPosition;
+    state.pendingPointerMoveEvent = Containers::NullOpt;
+    pointerMoveEventInternal(globalPosition, event);
+}
+
+void AbstractUserInterface::updateHoverFastPath(const NodeHandle node) {
+    State& state = *_state;
+    state.hoverFastPathNode = node;
+    state.hoverFastPathUnobstructed = false;
+    arrayClear(state.hoverFastPathVisibleNodeIndices);
+    if(node == NodeHandle::Null)
+        return;
+
+    /* The node got the event from callEvent(), so it has to be visible */
+    const UnsignedInt nodeId = nodeHandleId(node);
+    const UnsignedInt visibleNodeIndex = state.visibleNodeIndices[nodeId];
+    CORRADE_INTERNAL_ASSERT(visibleNodeIndex < state.visibleNodeIds.size() && state.visibleNodeIds[visibleNodeIndex] == nodeId);
+    const auto contains = [&](const UnsignedInt parentVisibleNodeIndex) {
+        return visibleNodeIndex >= parentVisibleNodeIndex &&
+            visibleNodeIndex <= parentVisibleNodeIndex + state.visibleNodeChildrenCounts[parentVisibleNodeIndex];
+    };
+
+    /* Find the top-level node containing the hovered node and then descend
+       to it, collecting the path. The area in which callEvent() can reach
+       the hovered node is the intersection of event bounds of all nodes on
+       the path, as each of them is checked on the way down. */
+    for(std::size_t i = 0; i != state.visibleFrontToBackTopLevelNodeIndices.size(); ++i) {
+        if(contains(state.visibleFrontToBackTopLevelNodeIndices[i])) {
+            state.hoverFastPathTopLevelIndex = i;
+            arrayAppend(state.hoverFastPathVisibleNodeIndices, state.visibleFrontToBackTopLevelNodeIndices[i]);
+            break;
+        }
+    }
+    CORRADE_INTERNAL_ASSERT(!state.hoverFastPathVisibleNodeIndices.isEmpty());
+    while(state.hoverFastPathVisibleNodeIndices.back() != visibleNodeIndex) {
+        const UnsignedInt parentVisibleNodeIndex = state.hoverFastPathVisibleNodeIndices.back();
+        for(UnsignedInt j = parentVisibleNodeIndex + 1, jMax = parentVisibleNodeIndex + state.visibleNodeChildrenCounts[parentVisibleNodeIndex] + 1; j != jMax; j += state.visibleNodeChildrenCounts[j] + 1) {
+            if(contains(j)) {
+                arrayAppend(state.hoverFastPathVisibleNodeIndices, j);
+                break;
+            }
+        }
+        CORRADE_INTERNAL_ASSERT(state.hoverFastPathVisibleNodeIndices.back() != parentVisibleNodeIndex);
+    }
+
+    Vector2 min{-Constants::inf()};
+    Vector2 max{Constants::inf()};
+    for(const UnsignedInt i: state.hoverFastPathVisibleNodeIndices) {
+        const UnsignedInt id = state.visibleNodeIds[i];
+        min = Math::max(min, state.visibleNodeEventBoundsMin[id]);
+        max = Math::min(max, state.visibleNodeEventBoundsMax[id]);
+    }
+    state.hoverFastPathMin = min;
+    state.hoverFastPathMax = max;
+
+    /* Returns true if given visible node subtree isn't skipped by callEvent()
+       and has event data overlapping the area */
+    const auto overlaps = [&](const UnsignedInt otherVisibleNodeIndex) {
+        const UnsignedInt otherNodeId = state.visibleNodeIds[otherVisibleNodeIndex];
+        return state.visibleEventNodeMask[otherNodeId] &&
+            (state.visibleNodeEventBoundsMin[otherNodeId] < max).all() &&
+            (min < state.visibleNodeEventBoundsMax[otherNodeId]).all();
+    };
+
+    /* Any top-level node in front of the path that overlaps the area makes
+       the fast path unusable ... */
+    for(std::size_t i = 0; i != state.hoverFastPathTopLevelIndex; ++i)
+        if(overlaps(state.visibleFrontToBackTopLevelNodeIndices[i]))
+            return;
+
+    /* ... as well as any children that callEvent() visits before the subtree
+       containing the hovered node. As the bounds are clipped to the node
+       rectangle, children of the hovered node itself make the fast path
+       unusable if they have any event data overlapping the area at all. */
+    for(std::size_t i = 0; i != state.hoverFastPathVisibleNodeIndices.size(); ++i) {
+        const UnsignedInt parentVisibleNodeIndex = state.hoverFastPathVisibleNodeIndices[i];
+        const UnsignedInt nextVisibleNodeIndex = i + 1 != state.hoverFastPathVisibleNodeIndices.size() ? state.hoverFastPathVisibleNodeIndices[i + 1] : ~UnsignedInt{};
+        for(UnsignedInt j = parentVisibleNodeIndex + 1, jMax = parentVisibleNodeIndex + state.visibleNodeChildrenCounts[parentVisibleNodeIndex] + 1; j != jMax && j != nextVisibleNodeIndex; j += state.visibleNodeChildrenCounts[j] + 1)
+            if(overlaps(j))
+                return;
+    }
+
+    state.hoverFastPathUnobstructed = true;
+}
+
+NodeHandle AbstractUserInterface::callPointerMoveEventFromHoveredNode(const Vector2& globalPositionScaled, PointerMoveEvent& event) {
+    State& state = *_state;
+    const Containers::ArrayView<const UnsignedInt> path = state.hoverFastPathVisibleNodeIndices;
+    CORRADE_INTERNAL_ASSERT(!path.isEmpty() && state.visibleNodeIds[path.back()] == nodeHandleId(state.hoverFastPathNode));
+
+    /* Nothing visited before the hovered node in callEvent() overlaps it, so
+       it's the first to get the event */
+    if(callEventOnNode<PointerMoveEvent, &AbstractLayer::pointerMoveEvent>(globalPositionScaled, state.visibleNodeIds[path.back()], event))
+        return state.hoverFastPathNode;
+
+    /* If it isn't accepted there, continue where callEvent() would continue
+       after the hovered node -- with remaining children of each parent and
+       then the parent itself, up to the top-level node ... */
+    for(std::size_t i = path.size() - 1; i != 0; --i) {
+        const UnsignedInt parentVisibleNodeIndex = path[i - 1];
+        for(UnsignedInt j = path[i] + state.visibleNodeChildrenCounts[path[i]] + 1, jMax = parentVisibleNodeIndex + state.visibleNodeChildrenCounts[parentVisibleNodeIndex] + 1; j != jMax; j += state.visibleNodeChildrenCounts[j] + 1) {
+            const NodeHandle called = callEvent<PointerMoveEvent, &AbstractLayer::pointerMoveEvent>(globalPositionScaled, j, event);
+            if(called != NodeHandle::Null)
+                return called;
+        }
+
+        const UnsignedInt parentNodeId = state.visibleNodeIds[parentVisibleNodeIndex];
+        if(callEventOnNode<PointerMoveEvent, &AbstractLayer::pointerMoveEvent>(globalPositionScaled, parentNodeId, event))
+            return nodeHandle(parentNodeId, state.nodes[parentNodeId].used.generation);
+    }
+
+    /* ... and then with remaining top-level nodes */
+    for(std::size_t i = state.hoverFastPathTopLevelIndex + 1; i != state.visibleFrontToBackTopLevelNodeIndices.size(); ++i) {
+        const NodeHandle called = callEvent<PointerMoveEvent, &AbstractLayer::pointerMoveEvent>(globalPositionScaled, state.visibleFrontToBackTopLevelNodeIndices[i], event);
+        if(called != NodeHandle::Null)
+            return called;
+    }
+
+    return {};
+}
+
+bool AbstractUserInterface::pointerMoveEventInternal(const Vector2& globalPosition, PointerMoveEvent& event) {
+    TraceScope trace{_state->traceCallback, _state->traceCallbackUserData, UserInterfaceTraceScope::Event};
+
     /* Update so we don't have stale pointerEventCapture{Node,Data}. Otherwise
        the update() gets called only later in callEvent(). */
     update();
@@ -3926,7 +5421,36 @@ bool AbstractUserInterface::pointerMoveEvent(const Vector2& globalPosition, Poin
         event._captured = false;
         event._hovering = true;
 
-        calledNode = callEvent<PointerMoveEvent, &AbstractLayer::pointerMoveEvent>(globalPositionScaled, event);
+        /* If the pointer is still inside the currently hovered node and
+           nothing in front of it can take the event since the last update(),
+           start directly at the hovered node instead of hit testing
+           everything from the front again. Non-primary events don't affect
+           hover, so they always go through the full hit testing. */
+        bool hitTested = false;
+        if(event.isPrimary() &&
+           state.currentHoveredNode != NodeHandle::Null &&
+           state.currentHoveredNode == state.hoverFastPathNode &&
+           state.hoverFastPathUnobstructed)
+        {
+            if((globalPositionScaled >= state.hoverFastPathMin).all() &&
+               (globalPositionScaled < state.hoverFastPathMax).all())
+            {
+                calledNode = callPointerMoveEventFromHoveredNode(globalPositionScaled, event);
+                hitTested = true;
+            }
+        }
+
+        if(!hitTested) {
+            calledNode = callEvent<PointerMoveEvent, &AbstractLayer::pointerMoveEvent>(globalPositionScaled, event);
+
+            /* If the event is going to change the hovered node, calculate the
+               fast path for it. It's done just once for every hovered node
+               until the next update() that changes the node layout or
+               data. */
+            if(event.isPrimary() && calledNode != state.hoverFastPathNode)
+                updateHoverFastPath(calledNode);
+        }
+
         moveAcceptedByAnyData = calledNode != NodeHandle::Null;
     }
 
@@ -4086,6 +5610,8 @@ bool AbstractUserInterface::focusEvent(const NodeHandle node, FocusEvent& event)
     CORRADE_ASSERT(node == NodeHandle::Null || state.nodes[nodeHandleId(node)].used.flags >= NodeFlag::Focusable,
         "Ui::AbstractUserInterface::focusEvent(): node not focusable", {});
 
+    TraceScope trace{state.traceCallback, state.traceCallbackUserData, UserInterfaceTraceScope::Event};
+
     /* Do an update. That may cause the currently focused node to be cleared,
        for example because it's now in a disabled/hidden hierarchy. */
     update();
@@ -4135,6 +5661,8 @@ bool AbstractUserInterface::focusEvent(const NodeHandle node, FocusEvent& event)
 template<void(AbstractLayer::*function)(UnsignedInt, KeyEvent&)> bool AbstractUserInterface::keyPressOrReleaseEvent(KeyEvent& event) {
     /* Common code for keyPressEvent() and keyReleaseEvent() */
 
+    TraceScope trace{_state->traceCallback, _state->traceCallbackUserData, UserInterfaceTraceScope::Event};
+
     update();
 
     State& state = *_state;
@@ -4208,6 +5736,8 @@ bool AbstractUserInterface::textInputEvent(TextInputEvent& event) {
     CORRADE_ASSERT(!event._accepted,
         "Ui::AbstractUserInterface::textInputEvent(): event already accepted", {});
 
+    TraceScope trace{_state->traceCallback, _state->traceCallbackUserData, UserInterfaceTraceScope::Event};
+
     /* Do an update. That may cause the currently focused node to be cleared,
        for example because it's now in a disabled/hidden hierarchy. */
     update();
@@ -4243,4 +5773,119 @@ Containers::Optional<Vector2> AbstractUserInterface::currentGlobalPointerPositio
     return _state->currentGlobalPointerPosition;
 }
 
+NodeHandle AbstractUserInterface::nextFocusableNode(const NodeHandle node) const {
+    const State& state = *_state;
+    CORRADE_ASSERT(node == NodeHandle::Null || isHandleValid(node),
+        "Ui::AbstractUserInterface::nextFocusableNode(): invalid handle" << node, {});
+
+    if(state.focusChain.isEmpty())
+        return NodeHandle::Null;
+
+    /* If the node isn't in the visible node list from the last update(),
+       start from the beginning */
+    std::size_t index = 0;
+    if(node != NodeHandle::Null) {
+        const UnsignedInt id = nodeHandleId(node);
+        if(id < state.visibleNodeIndices.size() &&
+           state.visibleNodeIndices[id] < state.visibleNodeIds.size() &&
+           state.visibleNodeIds[state.visibleNodeIndices[id]] == id)
+        {
+            index = state.focusChainOffsets[id];
+            /* If the node is in the chain itself, skip it */
+            if(index < state.focusChain.size() && state.focusChain[index] == id)
+                ++index;
+            if(index == state.focusChain.size())
+                index = 0;
+        }
+    }
+
+    const UnsignedInt id = state.focusChain[index];
+    return nodeHandle(id, state.nodes[id].used.generation);
+}
+
+NodeHandle AbstractUserInterface::previousFocusableNode(const NodeHandle node) const {
+    const State& state = *_state;
+    CORRADE_ASSERT(node == NodeHandle::Null || isHandleValid(node),
+        "Ui::AbstractUserInterface::previousFocusableNode(): invalid handle" << node, {});
+
+    if(state.focusChain.isEmpty())
+        return NodeHandle::Null;
+
+    /* If the node isn't in the visible node list from the last update(),
+       start from the end. The offset is the count of focusable nodes before
+       given node, regardless of whether the node itself is focusable, so the
+       previous chain item is always right before it. */
+    std::size_t index = state.focusChain.size() - 1;
+    if(node != NodeHandle::Null) {
+        const UnsignedInt id = nodeHandleId(node);
+        if(id < state.visibleNodeIndices.size() &&
+           state.visibleNodeIndices[id] < state.visibleNodeIds.size() &&
+           state.visibleNodeIds[state.visibleNodeIndices[id]] == id &&
+           state.focusChainOffsets[id] != 0)
+            index = state.focusChainOffsets[id] - 1;
+    }
+
+    const UnsignedInt id = state.focusChain[index];
+    return nodeHandle(id, state.nodes[id].used.generation);
+}
+
+std::size_t AbstractUserInterface::dispatchEvents(const Containers::ArrayView<InputEvent> events) {
+    #ifndef CORRADE_NO_ASSERT
+    for(std::size_t i = 0; i != events.size(); ++i) {
+        CORRADE_ASSERT(!events[i]._accepted,
+            "Ui::AbstractUserInterface::dispatchEvents(): event" << i << "already accepted", {});
+        CORRADE_ASSERT(!i || events[i]._time >= events[i - 1]._time,
+            "Ui::AbstractUserInterface::dispatchEvents(): expected event" << i << "time to be at least" << events[i - 1]._time << "but got" << events[i]._time, {});
+    }
+    #endif
+
+    std::size_t acceptedCount = 0;
+    for(InputEvent& e: events) {
+        switch(e._type) {
+            case InputEventType::PointerPress:
+            case InputEventType::PointerRelease: {
+                PointerEvent event{e._time, e._source, e._pointer, e._primary, e._id};
+                e._accepted = e._type == InputEventType::PointerPress ?
+                    pointerPressEvent(e._globalPosition, event) :
+                    pointerReleaseEvent(e._globalPosition, event);
+            } break;
+            case InputEventType::PointerMove: {
+                PointerMoveEvent event{e._time, e._source, e.pointer(), e._pointers, e._primary, e._id};
+                e._accepted = pointerMoveEvent(e._globalPosition, event);
+            } break;
+            case InputEventType::KeyPress:
+            case InputEventType::KeyRelease: {
+                KeyEvent event{e._time, e._key, e._modifiers};
+                e._accepted = e._type == InputEventType::KeyPress ?
+                    keyPressEvent(event) : keyReleaseEvent(event);
+            } break;
+            case InputEventType::TextInput: {
+                TextInputEvent event{e._time, e._text};
+                e._accepted = textInputEvent(event);
+            } break;
+        }
+
+        if(e._accepted)
+            ++acceptedCount;
+    }
+
+    /* Refresh the state just once at the end, which also dispatches a
+       trailing coalesced move event */
+    if(!events.isEmpty())
+        update();
+
+    return acceptedCount;
+}
+
+bool AbstractUserInterface::isPointerMoveEventCoalescingEnabled() const {
+    return _state->pointerMoveEventCoalescing;
+}
+
+AbstractUserInterface& AbstractUserInterface::setPointerMoveEventCoalescingEnabled(const bool enabled) {
+    _state->pointerMoveEventCoalescing = enabled;
+    if(!enabled)
+        flushPendingPointerMoveEvent();
+    return *this;
+}
+
 }}
@@ -27,7 +27,7 @@
 */
 
 /** @file
- * @brief Class @ref Magnum::Ui::AbstractUserInterface, enum @ref Magnum::Ui::UserInterfaceState, enum set @ref Magnum::Ui::UserInterfaceStates
+ * @brief Class @ref Magnum::Ui::AbstractUserInterface, enum @ref Magnum::Ui::UserInterfaceState, @ref Magnum::Ui::UserInterfacePhase, enum set @ref Magnum::Ui::UserInterfaceStates
  * @m_since_latest
  */
 
@@ -100,7 +100,10 @@ enum class UserInterfaceState: UnsignedShort {
      * presence of the @ref NodeFlag::NoEvents, @ref NodeFlag::Disabled or
      * @ref NodeFlag::Focusable flag; is reset next time
      * @ref AbstractUserInterface::update() is called. Implies
-     * @ref UserInterfaceState::NeedsDataAttachmentUpdate. Implied by
+     * @ref UserInterfaceState::NeedsDataAttachmentUpdate, however if no
+     * other state that affects the visible node set or data attachments is
+     * set, @ref AbstractUserInterface::update() reuses the draw list from
+     * the previous call and rebuilds only the event handling data. Implied by
      * @relativeref{UserInterfaceState,NeedsNodeClipUpdate},
      * @relativeref{UserInterfaceState,NeedsLayoutUpdate},
      * @relativeref{UserInterfaceState,NeedsLayoutAssignmentUpdate},
@@ -119,7 +122,9 @@ enum class UserInterfaceState: UnsignedShort {
      * @relativeref{AbstractUserInterface,setNodeFlags()},
      * @relativeref{AbstractUserInterface,addNodeFlags()} and
      * @relativeref{AbstractUserInterface,clearNodeFlags()} that changes the
-     * presence of the @ref NodeFlag::Clip flag; is reset next time
+     * presence of the @ref NodeFlag::Clip, @ref NodeFlag::CullTransparent
+     * or @ref NodeFlag::Opaque flag and after every @ref AbstractUserInterface::setNodeOpacity() that
+     * changes the opacity from or to @cpp 0.0f @ce; is reset next time
      * @ref AbstractUserInterface::update() is called. Implies
      * @ref UserInterfaceState::NeedsNodeEnabledUpdate. Implied by
      * @relativeref{UserInterfaceState,NeedsLayoutUpdate},
@@ -134,7 +139,8 @@ enum class UserInterfaceState: UnsignedShort {
      * @ref AbstractUserInterface::update() needs to be called to refresh the
      * visible node hierarchy layout after node sizes or offsets changed. Set
      * implicitly if any of the layouters have
-     * @ref LayouterState::NeedsUpdate set and after every
+     * @ref LayouterState::NeedsUpdate set, if any of the layers have
+     * @ref LayerState::NeedsIntrinsicSizeUpdate set and after every
      * @ref AbstractUserInterface::setNodeOffset() and
      * @ref AbstractUserInterface::setNodeSize(), is reset next time
      * @ref AbstractUserInterface::update() is called. Implies
@@ -223,6 +229,18 @@ enum class UserInterfaceState: UnsignedShort {
      * @ref AnimationState::Playing or @ref AnimationState::Paused anymore.
      */
     NeedsAnimationAdvance = 1 << 10,
+
+    /**
+     * @ref AbstractUserInterface::update() needs to be called to dispatch a
+     * pointer move event that was queued by
+     * @ref AbstractUserInterface::pointerMoveEvent() with
+     * @ref AbstractUserInterface::setPointerMoveEventCoalescingEnabled()
+     * enabled. Set implicitly if there's a queued event, is reset next time
+     * @ref AbstractUserInterface::update() or
+     * @ref AbstractUserInterface::advanceAnimations() is called.
+     * @m_since_latest
+     */
+    NeedsPointerMoveEventDispatch = 1 << 11,
 };
 
 /**
@@ -247,6 +265,138 @@ MAGNUM_UI_EXPORT Debug& operator<<(Debug& debug, UserInterfaceStates value);
 
 CORRADE_ENUMSET_OPERATORS(UserInterfaceStates)
 
+/**
+@brief User interface processing phase
+@m_since_latest
+
+Passed to a callback set by @ref AbstractUserInterface::setPhaseCallback(),
+which gets called at the beginning and end of each phase.
+*/
+enum class UserInterfacePhase: UnsignedByte {
+    /**
+     * Removing orphaned nodes and data attached to removed nodes in
+     * @ref AbstractUserInterface::clean(), called also implicitly from
+     * @ref AbstractUserInterface::update().
+     */
+    Clean,
+
+    /**
+     * Ordering visible nodes in @ref AbstractUserInterface::update().
+     */
+    NodeOrder,
+
+    /**
+     * Layout calculation and calculation of absolute node offsets and
+     * opacities in @ref AbstractUserInterface::update().
+     */
+    Layout,
+
+    /**
+     * Culling invisible nodes, calculating clip rectangles and propagating
+     * @ref NodeFlag::Disabled and @ref NodeFlag::NoEvents in
+     * @ref AbstractUserInterface::update().
+     */
+    Cull,
+
+    /**
+     * Ordering data attachments in each layer by draw order and refreshing
+     * event handling state in @ref AbstractUserInterface::update().
+     */
+    DataOrder,
+
+    /**
+     * Calling @ref AbstractLayer::update() on all layers that need it in
+     * @ref AbstractUserInterface::update().
+     */
+    LayerUpdate,
+
+    /**
+     * Submitting draws for all layers in
+     * @ref AbstractUserInterface::draw(). Includes also the
+     * @ref UserInterfacePhase::Composite phase.
+     */
+    Draw,
+
+    /**
+     * A single @ref AbstractLayer::composite() call in
+     * @ref AbstractUserInterface::draw(). Happens inside the
+     * @ref UserInterfacePhase::Draw phase and may happen multiple times in
+     * it.
+     */
+    Composite
+};
+
+/**
+@debugoperatorenum{UserInterfacePhase}
+@m_since_latest
+*/
+MAGNUM_UI_EXPORT Debug& operator<<(Debug& debug, UserInterfacePhase value);
+
+/**
+@brief User interface trace scope
+@m_since_latest
+
+@see @ref AbstractUserInterface::setTraceCallback()
+*/
+enum class UserInterfaceTraceScope: UnsignedByte {
+    /**
+     * A single @ref AbstractLayer::update() call inside the
+     * @ref UserInterfacePhase::LayerUpdate phase. The handle is the
+     * @ref LayerHandle of the layer. Not reported if the updates are
+     * dispatched through @ref AbstractUserInterface::setLayerUpdateExecutor().
+     */
+    LayerUpdate,
+
+    /**
+     * A single @ref AbstractLayer::composite() call inside the
+     * @ref UserInterfacePhase::Composite phase. The handle is the
+     * @ref LayerHandle of the layer.
+     */
+    LayerComposite,
+
+    /**
+     * A single @ref AbstractLayer::draw() call inside the
+     * @ref UserInterfacePhase::Draw phase. The handle is the
+     * @ref LayerHandle of the layer.
+     */
+    LayerDraw,
+
+    /**
+     * A single @ref AbstractLayouter::update() call inside the
+     * @ref UserInterfacePhase::Layout phase. The handle is the
+     * @ref LayouterHandle of the layouter.
+     */
+    LayouterUpdate,
+
+    /**
+     * Advancing a single generic or node animator in
+     * @ref AbstractUserInterface::advanceAnimations(). The handle is the
+     * @ref AnimatorHandle of the animator.
+     */
+    AnimatorAdvance,
+
+    /**
+     * A single @ref AbstractLayer::advanceAnimations() call for data or
+     * style animators assigned to a layer in
+     * @ref AbstractUserInterface::advanceAnimations(). The handle is the
+     * @ref LayerHandle of the layer.
+     */
+    LayerAdvanceAnimations,
+
+    /**
+     * Dispatch of a single pointer, focus, key or text input event. The
+     * handle is zero. May contain @ref UserInterfacePhase scopes from an
+     * implicit @ref AbstractUserInterface::update() call.
+     */
+    Event
+};
+
+/**
+@debugoperatorenum{UserInterfaceTraceScope}
+@m_since_latest
+*/
+MAGNUM_UI_EXPORT Debug& operator<<(Debug& debug, UserInterfaceTraceScope value);
+
 namespace Implementation {
     template<class, class = void> struct PointerEventConverter;
     template<class, class = void> struct PointerMoveEventConverter;
@@ -280,6 +430,44 @@ default-constructed. If timestamps are needed, for example for animations, they
 can be supplied as a second @ref Nanoseconds argument when calling
 @ref pointerPressEvent(Event&, Args&&... args) and others.
 
+@subsection Ui-AbstractUserInterface-application-latching Late input latching
+
+Application classes process all pending platform events first and only then
+call the draw event. If every pointer move is dispatched right away, a node
+that's dragged around gets its position updated many times per frame, each
+time doing a full @ref update(), and what's eventually drawn is the state
+after the last one anyway. With @ref setPointerMoveEventCoalescingEnabled()
+the moves are instead only queued, replacing each other, and the latest one is
+dispatched just once, from the @ref advanceAnimations() or @ref draw() call in
+the draw event, directly before the UI is drawn. The input is thus latched as
+late as possible, and only the layers, layouters and nodes that the dispatched
+event actually touched are updated afterwards.
+
+As a queued event isn't reported as accepted, the application event isn't
+accepted either. The application should however still schedule a redraw,
+which is conveniently done by checking @ref state(), which contains
+@ref UserInterfaceState::NeedsPointerMoveEventDispatch while there's an event
+queued:
+
+@snippet Ui-sdl2.cpp AbstractUserInterface-application-latching
+
+Events that change the set of pressed pointers, secondary events and events
+going to nodes with @ref NodeFlag::RawPointerMoveEvents are dispatched
+immediately, preserving their order relative to the queued event.
+
+@section Ui-AbstractUserInterface-dispatch Layer, layouter and animator dispatch
+
+Layers, layouters and animators are stored type-erased and called through
+virtual functions. The dispatch is however done once per instance in each
+@ref update() and @ref advanceAnimations() call, and once per draw batch in
+@ref draw(), never per node or per data. Each instance then processes all its
+nodes or data in a single call, which is where the actual work happens, and
+@ref LayerFeatures are queried just once when a layer instance is set, with
+the cached value used in all loops afterwards. Having the set of layers known
+at compile time, such as with @ref UserInterfaceGL, thus wouldn't have a
+measurable effect on the overall cost. To see where the time is actually
+spent, use @ref setPhaseCallback() and @ref setTraceCallback().
+
 @section Ui-AbstractUserInterface-dpi DPI awareness
 
 There are three separate concepts for DPI-aware UI rendering:
@@ -441,6 +629,14 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          * If a renderer instance isn't set yet when calling this function, the
          * framebuffer setup is performed in the next
          * @ref setRendererInstance() call instead.
+         *
+         * The size change is meant to be cheap enough to be done every frame
+         * during interactive window resizing. If the ratio between @p size
+         * and @p framebufferSize stays the same, builtin layers only update
+         * their projection without regenerating any data, @ref SnapLayouter
+         * recalculates only layouts snapped directly to the UI and layouts
+         * affected by those, and @ref StackLayouter doesn't need an update at
+         * all unless @ref StackLayouter::setCrossAxisFill() is enabled.
          */
         AbstractUserInterface& setSize(const Vector2& size, const Vector2& windowSize, const Vector2i& framebufferSize);
 
@@ -471,6 +667,26 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          */
         Nanoseconds animationTime() const;
 
+        /**
+         * @brief Time at which animations need to be advanced next
+         * @m_since_latest
+         *
+         * Smallest of @ref AbstractAnimator::nextAdvanceTime() for all
+         * animators that have @ref AnimatorState::NeedsAdvance set, or
+         * @ref Nanoseconds::max() if there are no such animators. If the
+         * returned value is less than or equal to @ref animationTime(),
+         * @ref advanceAnimations() should be called in the next frame.
+         * Otherwise, if nothing else needs a redraw, the application can
+         * sleep until the returned time instead of calling
+         * @ref advanceAnimations() every frame. Use
+         * @ref AbstractAnimator::setAdvanceInterval() to declare that
+         * animations in a particular animator don't need to be advanced
+         * every frame. The operation is done with a @f$ \mathcal{O}(n) @f$
+         * complexity where @f$ n @f$ is the sum of
+         * @ref AbstractAnimator::capacity() for all such animators.
+         */
+        Nanoseconds nextAnimationTime() const;
+
         /** @{
          * @name Renderer management
          */
@@ -528,6 +744,37 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
             return static_cast<const T&>(renderer());
         }
 
+        /**
+         * @brief Set update queue instance
+         * @m_since_latest
+         *
+         * Expects that the instance hasn't been set yet. Once set, commands
+         * pushed to the queue from arbitrary threads get executed at the
+         * start of each @ref update(), before anything else, so their effects
+         * are included in that update. The instance is subsequently available
+         * through @ref updateQueue(). See the @ref UpdateQueue class
+         * documentation for more information.
+         * @see @ref hasUpdateQueue()
+         */
+        UpdateQueue& setUpdateQueueInstance(Containers::Pointer<UpdateQueue>&& instance);
+
+        /**
+         * @brief Whether an update queue instance has been set
+         * @m_since_latest
+         *
+         * @see @ref updateQueue(), @ref setUpdateQueueInstance()
+         */
+        bool hasUpdateQueue() const;
+
+        /**
+         * @brief Update queue instance
+         * @m_since_latest
+         *
+         * Expects that @ref setUpdateQueueInstance() was called.
+         */
+        UpdateQueue& updateQueue();
+        const UpdateQueue& updateQueue() const; /**< @overload */
+
         /**
          * @}
          */
@@ -650,6 +897,16 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
             #endif
         );
 
+        /**
+         * @brief Whether a layer has an instance set
+         * @m_since_latest
+         *
+         * Expects that @p handle is valid.
+         * @see @ref isHandleValid(LayerHandle) const, @ref setLayerInstance(),
+         *      @ref layer()
+         */
+        bool hasLayerInstance(LayerHandle handle) const;
+
         /**
          * @brief Set a layer instance
          * @return Reference to @p instance
@@ -1193,6 +1450,21 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          */
         std::size_t nodeCapacity() const;
 
+        /**
+         * @brief Reserve node storage
+         * @m_since_latest
+         *
+         * Grows the internal node storage to have space for at least
+         * @p capacity nodes without reallocating, for example to avoid
+         * reallocations when populating a known amount of nodes. Doesn't
+         * change @ref nodeCapacity() or make any new handles available,
+         * these are still allocated only with @ref createNode(). Use
+         * @ref AbstractLayer::reserve(), @ref AbstractLayouter::reserve() and
+         * @ref AbstractAnimator::reserve() to reserve storage in layers,
+         * layouters and animators.
+         */
+        void reserveNodes(std::size_t capacity);
+
         /**
          * @brief Count of used items in the node storage
          *
@@ -1203,6 +1475,25 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          */
         std::size_t nodeUsedCount() const;
 
+        /**
+         * @brief Memory usage
+         * @m_since_latest
+         *
+         * The @ref MemoryUsage::capacity and @ref MemoryUsage::usedCount are
+         * the same as @ref nodeCapacity() and @ref nodeUsedCount(). The byte
+         * counts include the internal node, layer, layouter and animator
+         * storage, state calculated in @ref update(), and a sum of
+         * @ref AbstractLayer::memoryUsage(),
+         * @ref AbstractLayouter::memoryUsage() and
+         * @ref AbstractAnimator::memoryUsage() of all instances. Call the
+         * functions on particular instances for a per-instance breakdown.
+         * State shared among multiple layers, such as @ref BaseLayer::Shared
+         * or @ref TextLayer::Shared, isn't included. The operation is done
+         * with a @f$ \mathcal{O}(n) @f$ complexity where @f$ n @f$ is the
+         * sum of the node capacity and capacities of all instances.
+         */
+        MemoryUsage memoryUsage() const;
+
         /**
          * @brief Whether a node handle is valid
          *
@@ -1251,6 +1542,38 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          */
         NodeHandle createNode(const Vector2& offset, const Vector2& size, NodeFlags flags = {});
 
+        /**
+         * @brief Create multiple nodes
+         * @param[in] parent    Parent node to attach to or
+         *      @ref NodeHandle::Null for new root nodes. Expected to be valid
+         *      if not null.
+         * @param[in] offsets   Offsets relative to the parent node
+         * @param[in] sizes     Sizes of the node contents
+         * @param[in] flags     Initial node flags
+         * @param[out] handles Where to put new node handles
+         * @m_since_latest
+         *
+         * Equivalent to calling @ref createNode(NodeHandle, const Vector2&, const Vector2&, NodeFlags)
+         * for each item in @p offsets and @p sizes, but with the internal
+         * storage grown just once and the state updated just once for all
+         * nodes. Expects that the @p offsets, @p sizes and @p handles views
+         * all have the same size.
+         *
+         * Calling this function causes @ref UserInterfaceState::NeedsNodeUpdate
+         * to be set.
+         * @see @ref removeNodes()
+         */
+        void createNodes(NodeHandle parent, const Containers::StridedArrayView1D<const Vector2>& offsets, const Containers::StridedArrayView1D<const Vector2>& sizes, NodeFlags flags, const Containers::StridedArrayView1D<NodeHandle>& handles);
+
+        /**
+         * @brief Create multiple root nodes
+         * @m_since_latest
+         *
+         * Equivalent to calling @ref createNodes(NodeHandle, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, NodeFlags, const Containers::StridedArrayView1D<NodeHandle>&)
+         * with @ref NodeHandle::Null as the parent.
+         */
+        void createNodes(const Containers::StridedArrayView1D<const Vector2>& offsets, const Containers::StridedArrayView1D<const Vector2>& sizes, NodeFlags flags, const Containers::StridedArrayView1D<NodeHandle>& handles);
+
         /**
          * @brief Node parent
          *
@@ -1338,7 +1661,12 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          * is valid. Initially, a node has the opacity set to @cpp 1.0f @ce.
          *
          * Calling this function causes
-         * @ref UserInterfaceState::NeedsNodeOpacityUpdate to be set.
+         * @ref UserInterfaceState::NeedsNodeOpacityUpdate to be set, in
+         * which case only absolute opacities of the node subtree get
+         * recalculated in the next @ref update(). If the opacity changes from
+         * or to @cpp 0.0f @ce, @ref UserInterfaceState::NeedsNodeClipUpdate
+         * is set as well in order to cull nodes with
+         * @ref NodeFlag::CullTransparent.
          * @see @ref isHandleValid(NodeHandle) const
          */
         void setNodeOpacity(NodeHandle handle, Float opacity);
@@ -1410,6 +1738,21 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          */
         void removeNode(NodeHandle handle);
 
+        /**
+         * @brief Remove multiple nodes
+         * @m_since_latest
+         *
+         * Equivalent to calling @ref removeNode() for each item in
+         * @p handles, but with the state updated just once for all nodes.
+         * Expects that all handles are valid and that there are no
+         * duplicates.
+         *
+         * Calling this function causes @ref UserInterfaceState::NeedsNodeClean
+         * to be set.
+         * @see @ref createNodes()
+         */
+        void removeNodes(const Containers::StridedArrayView1D<const NodeHandle>& handles);
+
         /**
          * @}
          */
@@ -1662,7 +2005,11 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          * otherwise it performs a subset of the following depending on the
          * state:
          *
-         * -    Removes nodes with an invalid (removed) parent node
+         * -    Removes nodes with an invalid (removed) parent node, with
+         *      the complexity proportional to the size of the removed
+         *      subtrees. The subtrees are taken as they were at the time
+         *      their parent got removed, nodes created under the removed
+         *      subtrees after that are removed only in the next call.
          * -    Calls @ref AbstractLayer::cleanNodes() with updated node
          *      generations, causing removal of data attached to invalid nodes
          * -    Calls @ref AbstractLayouter::cleanNodes() with updated node
@@ -1698,7 +2045,12 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          * @ref AbstractGenericAnimator::advance(),
          * @ref AbstractNodeAnimator::advance() or layer-specific
          * @ref AbstractLayer::advanceAnimations() on all animator instances
-         * that have @ref AnimatorState::NeedsAdvance set.
+         * that have @ref AnimatorState::NeedsAdvance set. Playing animations
+         * with @ref AnimationFlag::SkipWhenInvisible that are attached to
+         * nodes not present in @ref visibleNodeMask() are skipped. A pointer
+         * move event queued due to
+         * @ref setPointerMoveEventCoalescingEnabled() is dispatched before
+         * the animations are advanced.
          *
          * Calling this function updates @ref animationTime(). Afterwards,
          * @ref state() may still contain
@@ -1719,8 +2071,10 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          * @ref AbstractUserInterface(const Vector2&, const Vector2&, const Vector2i&)
          * constructor was used.
          *
-         * Implicitly calls @ref clean(); called implicitly from @ref draw()
-         * and all event processing functions. If @ref state() contains none of
+         * If an update queue was set with @ref setUpdateQueueInstance(),
+         * first calls @ref UpdateQueue::apply() on it. Then implicitly calls
+         * @ref clean(); called implicitly from @ref draw() and all event
+         * processing functions. If @ref state() contains none of
          * @ref UserInterfaceState::NeedsDataUpdate,
          * @ref UserInterfaceState::NeedsDataAttachmentUpdate,
          * @ref UserInterfaceState::NeedsNodeEnabledUpdate,
@@ -1751,15 +2105,473 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          *      currently focused node is no longer @ref NodeFlag::Focusable.
          * -    Goes in a back to front order through layers that have
          *      instances set and calls @ref AbstractLayer::update() with the
-         *      ordered data
+         *      ordered data, or passes the calls to an executor set by
+         *      @ref setLayerUpdateExecutor()
          *
          * After calling this function, @ref state() is empty apart from
          * @ref UserInterfaceState::NeedsAnimationAdvance, which may be present
          * if there are any animators for which @ref advanceAnimations() should
          * be called.
+         *
+         * Together with @ref submit(), this function forms the CPU-side
+         * prepare phase of a frame, with @ref submit() being the GPU-side
+         * phase. The builtin @ref BaseLayerGL and @ref TextLayerGL only
+         * generate vertex data in @ref AbstractLayer::update(), and upload
+         * them to the GPU in @ref AbstractLayer::draw(), so this function
+         * can be called from a thread different from the one owning the GPU
+         * context. The only exception is on-demand glyph cache filling in
+         * @ref TextLayer, which may upload to the glyph cache texture, the
+         * glyph cache should be thus filled upfront in that case. The calls
+         * aren't internally synchronized in any way however, i.e. neither
+         * this function nor any other function on the instance or its
+         * layers, layouters and animators can be called while
+         * @ref submit() executes, and vice versa.
          */
         AbstractUserInterface& update();
 
+        /**
+         * @brief Layer update executor
+         * @m_since_latest
+         *
+         * @cpp nullptr @ce by default, meaning @ref update() calls
+         * @ref AbstractLayer::update() on all layers sequentially.
+         * @see @ref layerUpdateExecutorUserData(),
+         *      @ref setLayerUpdateExecutor()
+         */
+        auto layerUpdateExecutor() const -> void(*)(UnsignedInt, void(*)(void*, UnsignedInt), void*, void*);
+
+        /**
+         * @brief Layer update executor user data
+         * @m_since_latest
+         *
+         * Contents of the @p userData parameter passed to
+         * @ref setLayerUpdateExecutor().
+         */
+        void* layerUpdateExecutorUserData() const;
+
+        /**
+         * @brief Set a layer update executor
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * By default, @ref update() calls @ref AbstractLayer::update() on all
+         * layers that need it one after another, in the draw order. If an
+         * @p executor is set and there's more than one layer to update,
+         * @ref update() instead calls it with the count of layers to update,
+         * a @p task function, its @p taskState and the @p userData pointer
+         * passed to this function. The executor is then expected to call
+         * @p task with @p taskState and each index in range
+         * @cpp [0, count) @ce exactly once, in an arbitrary order and
+         * possibly from multiple threads concurrently, such as by
+         * distributing the calls to a worker thread pool, and return only
+         * after all calls finished.
+         *
+         * Each task call updates a different layer, with all state shared
+         * between the calls being only read from. Layers that perform GPU
+         * operations in @ref AbstractLayer::doUpdate() can't be updated from
+         * a different thread, however. The builtin @ref BaseLayerGL and
+         * @ref TextLayerGL implementations thus only prepare the data on the
+         * CPU side in @ref AbstractLayer::update() and upload them to the GPU
+         * in the subsequent @ref AbstractLayer::draw() or
+         * @ref AbstractLayer::composite() call, which is always called from
+         * the main thread. Custom layer implementations that are meant to be
+         * used with a multi-threaded executor should do the same, and
+         * shouldn't modify state shared with other layers in their update.
+         *
+         * An exception is @ref TextLayer, which in its update shapes texts
+         * with @ref TextDataFlag::DeferredShaping, texts edited with
+         * @ref TextLayer::Shared::Configuration::setTextInputBatching()
+         * enabled and texts visible again after @ref TextLayer::hibernate(),
+         * and fills the glyph cache if
+         * @ref TextLayer::Shared::setOnDemandGlyphCacheFilling() is enabled.
+         * All that modifies the @ref TextLayer::Shared instance, so
+         * text layers sharing the same instance can't be updated concurrently
+         * if they have such work to do. This is checked with an assertion in
+         * debug builds.
+         *
+         * Set the @p executor to @cpp nullptr @ce to go back to the default
+         * sequential behavior.
+         */
+        AbstractUserInterface& setLayerUpdateExecutor(void(*executor)(UnsignedInt count, void(*task)(void* taskState, UnsignedInt index), void* taskState, void* userData), void* userData = nullptr);
+
+        /**
+         * @brief Phase callback
+         * @m_since_latest
+         *
+         * @cpp nullptr @ce by default.
+         * @see @ref phaseCallbackUserData(), @ref setPhaseCallback()
+         */
+        auto phaseCallback() const -> void(*)(UserInterfacePhase, bool, void*);
+
+        /**
+         * @brief Phase callback user data
+         * @m_since_latest
+         *
+         * Contents of the @p userData parameter passed to
+         * @ref setPhaseCallback().
+         */
+        void* phaseCallbackUserData() const;
+
+        /**
+         * @brief Set a phase callback
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * The @p callback gets called with @p end set to @cpp false @ce at
+         * the beginning and with @p end set to @cpp true @ce at the end of
+         * each @ref UserInterfacePhase in @ref clean(), @ref update() and
+         * @ref draw(), together with the @p userData pointer passed to this
+         * function. The phases in @ref update() are reported only if
+         * @ref update() actually does anything, and always in the order in
+         * which they're listed in the @ref UserInterfacePhase enum, however
+         * not all of them may actually perform any work depending on
+         * @ref state(). It's meant to be used for profiling, such as by
+         * measuring time spent in each phase and feeding it to
+         * @relativeref{Magnum,DebugTools::FrameProfiler}. Counts of processed
+         * items are available through @ref visibleNodeCount(),
+         * @ref culledNodeCount(), @ref drawCallCount() and
+         * @ref layerDataCount() after each frame.
+         *
+         * Set the @p callback to @cpp nullptr @ce to disable it.
+         */
+        AbstractUserInterface& setPhaseCallback(void(*callback)(UserInterfacePhase phase, bool end, void* userData), void* userData = nullptr);
+
+        /**
+         * @brief Trace callback
+         * @m_since_latest
+         *
+         * @cpp nullptr @ce by default.
+         * @see @ref traceCallbackUserData(), @ref setTraceCallback()
+         */
+        auto traceCallback() const -> void(*)(UserInterfaceTraceScope, UnsignedLong, bool, void*);
+
+        /**
+         * @brief Trace callback user data
+         * @m_since_latest
+         *
+         * Contents of the @p userData parameter passed to
+         * @ref setTraceCallback().
+         */
+        void* traceCallbackUserData() const;
+
+        /**
+         * @brief Set a trace callback
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * Complements @ref setPhaseCallback() with a finer granularity. The
+         * @p callback gets called with @p end set to @cpp false @ce at the
+         * beginning and with @p end set to @cpp true @ce at the end of each
+         * @ref UserInterfaceTraceScope, together with a handle of the layer,
+         * layouter or animator the scope is for, cast to an integer, and
+         * the @p userData pointer passed to this function. Scopes are
+         * always properly nested and are never reported from multiple
+         * threads at once. Use @ref TraceRecorder to record the scopes
+         * together with the phases into a timeline.
+         *
+         * The callback is called only if the library is built with
+         * `MAGNUM_UI_TRACING` enabled, otherwise the calls are compiled out
+         * and setting the callback has no effect. Set the @p callback to
+         * @cpp nullptr @ce to disable it.
+         */
+        AbstractUserInterface& setTraceCallback(void(*callback)(UserInterfaceTraceScope scope, UnsignedLong handle, bool end, void* userData), void* userData = nullptr);
+
+        /**
+         * @brief Storage allocator
+         * @m_since_latest
+         *
+         * @cpp nullptr @ce by default, meaning the default heap allocator is
+         * used.
+         * @see @ref storageAllocatorUserData(), @ref setStorageAllocator()
+         */
+        auto storageAllocator() const -> Containers::Array<char>(*)(std::size_t, std::size_t, void*);
+
+        /**
+         * @brief Storage allocator user data
+         * @m_since_latest
+         *
+         * Contents of the @p userData parameter passed to
+         * @ref setStorageAllocator().
+         */
+        void* storageAllocatorUserData() const;
+
+        /**
+         * @brief Set a storage allocator
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * The @p allocator is called with a size and alignment and the
+         * @p userData pointer passed to this function whenever @ref update()
+         * or @ref advanceAnimations() needs to allocate node, layout and data
+         * ordering state or temporary per-frame storage. It's expected to
+         * return an array of at least given size with the memory aligned to at
+         * least given alignment. The array can have a custom deleter, which
+         * is then called once the memory is no longer needed. Memory that was
+         * allocated before the allocator was changed is freed with the
+         * deleter it was allocated with.
+         *
+         * Temporary per-frame storage is bump-allocated from a scratch memory
+         * that's owned by the user interface, grown as needed and reused
+         * across frames. The allocator is thus called for temporary storage
+         * only if the scratch memory isn't large enough yet, see
+         * @ref storageAllocationCount() for more information.
+         *
+         * This allows for example drawing all per-frame memory from a
+         * preallocated arena. Growable node, layer, layouter and animator
+         * storage is still allocated from the heap, use @ref reserveNodes(),
+         * @ref AbstractLayer::reserve(), @ref AbstractLayouter::reserve() and
+         * @ref AbstractAnimator::reserve() to allocate it upfront and avoid
+         * any subsequent heap allocations.
+         *
+         * Set the @p allocator to @cpp nullptr @ce to go back to the default
+         * heap allocator.
+         */
+        AbstractUserInterface& setStorageAllocator(Containers::Array<char>(*allocator)(std::size_t size, std::size_t alignment, void* userData), void* userData = nullptr);
+
+        /**
+         * @brief Storage allocation count
+         * @m_since_latest
+         *
+         * Total count of allocations of node, layout and data ordering state
+         * and temporary per-frame storage done by @ref update() and
+         * @ref advanceAnimations() since the user interface was constructed,
+         * regardless of whether they were done by the default heap allocator
+         * or the allocator set by @ref setStorageAllocator().
+         *
+         * Temporary storage is taken from a scratch memory that's reset at
+         * the start of each @ref update() and @ref advanceAnimations() call.
+         * If the scratch memory is not large enough, a separate allocation is
+         * made and the scratch memory is enlarged in the next call to fit
+         * everything. As it's never shrunk, once the set of nodes, layouts
+         * and data stabilizes, repeated @ref update() and
+         * @ref advanceAnimations() calls that don't need to rebuild the
+         * ordering state don't allocate and this count stays the same.
+         * Allocations done by growable node, layer, layouter and animator
+         * storage and inside layer, layouter and animator implementations
+         * aren't included.
+         */
+        std::size_t storageAllocationCount() const;
+
+        /**
+         * @brief Whether draws of non-overlapping top-level nodes are merged
+         * @m_since_latest
+         *
+         * @see @ref setDisjointTopLevelNodeDrawMerging()
+         */
+        bool isDisjointTopLevelNodeDrawMerging() const;
+
+        /**
+         * @brief Enable or disable merging draws of non-overlapping top-level nodes
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * By default, @ref draw() goes through top-level nodes in a
+         * back-to-front order and for each draws all layers that have data
+         * attached to it, which means the layer draws alternate for each
+         * top-level node. If enabled, @ref update() calculates bounds of each
+         * top-level node hierarchy from its visible nodes and their clip
+         * rects. Draws of top-level nodes that follow each other and don't
+         * overlap are then reordered so each layer draws them together,
+         * reducing the count of @ref AbstractLayer::draw() calls for example
+         * for dashboards made of many side-by-side panels.
+         *
+         * The bounds are calculated only from node offsets and sizes, so if
+         * a layer draws outside of node rectangles, such as text overflowing
+         * a node that doesn't have @ref NodeFlag::Clip set on itself or a
+         * parent, the reordered draws may not overlap in a correct order.
+         * Top-level nodes that have data from layers with
+         * @ref LayerFeature::Composite are never merged. Disabled by default.
+         * Changing the setting adds
+         * @ref UserInterfaceState::NeedsDataAttachmentUpdate to
+         * @ref state().
+         * @see @ref drawCallCount()
+         */
+        AbstractUserInterface& setDisjointTopLevelNodeDrawMerging(bool enabled);
+
+        /**
+         * @brief Count of visible nodes
+         * @m_since_latest
+         *
+         * Count of nodes that aren't @ref NodeFlag::Hidden and don't have
+         * any hidden parent, as calculated by the last @ref update(). Nodes
+         * that are outside of the user interface area or their clip
+         * rectangles are included in this count as well.
+         * @see @ref culledNodeCount()
+         */
+        std::size_t visibleNodeCount() const;
+
+        /**
+         * @brief Count of culled nodes
+         * @m_since_latest
+         *
+         * Count of nodes included in @ref visibleNodeCount() that are
+         * outside of the user interface area or their clip rectangles, as
+         * calculated by the last @ref update(). Data attached to such nodes
+         * aren't drawn.
+         */
+        std::size_t culledNodeCount() const;
+
+        /**
+         * @brief Mask of visible nodes that aren't culled
+         * @m_since_latest
+         *
+         * Indexed by node ID, a bit is set for nodes that are included in
+         * @ref visibleNodeCount() but not in @ref culledNodeCount(), as
+         * calculated by the last @ref update(). The size of the view is
+         * @ref nodeCapacity() at the time of the last @ref update(), nodes
+         * created after that aren't included.
+         */
+        Containers::BitArrayView visibleNodeMask() const;
+
+        /**
+         * @brief Count of draw calls
+         * @m_since_latest
+         *
+         * Count of @ref AbstractLayer::draw() calls done in @ref draw(), as
+         * calculated by the last @ref update().
+         */
+        std::size_t drawCallCount() const;
+
+        /**
+         * @brief Count of data passed to a layer update
+         * @m_since_latest
+         *
+         * Count of data from given layer that are attached to visible nodes
+         * and are passed to @ref AbstractLayer::update(), as calculated by
+         * the last @ref update(). Expects that @p handle is valid.
+         */
+        std::size_t layerDataCount(LayerHandle handle) const;
+
+        /**
+         * @brief Draw output generation
+         * @m_since_latest
+         *
+         * Returns a value that changes every time the output of @ref draw()
+         * may be different from the previous one, i.e. on every
+         * @ref update() that has anything to update, on every
+         * @ref setSize() that changes the size or framebuffer size and when
+         * a renderer instance is set. If the value is equal to a value
+         * returned earlier, drawing the UI again produces the same output as
+         * back then. Layers that advertise @ref LayerFeature::Composite are
+         * however additionally affected by contents underneath the UI, see
+         * @ref RendererGL::compositingFramebufferGeneration() for a way to
+         * track those.
+         *
+         * Meant to be used to cache the whole UI rendering, for example by
+         * drawing it into an offscreen texture only if the generation changed
+         * since the last frame and compositing the texture over the rest of
+         * the application otherwise. Call @ref update() first to make the
+         * value reflect any pending state changes, as it's not updated until
+         * then. Note that an application with running animations calls
+         * @ref advanceAnimations() every frame, which then causes the
+         * generation to change every frame as well.
+         */
+        UnsignedLong drawGeneration() const;
+
+        /**
+         * @brief Area that changed since the last draw
+         * @m_since_latest
+         *
+         * If the only changes since the last @ref draw() were
+         * @ref setNodeOffset() and @ref setNodeOpacity() calls that
+         * @ref update() could apply incrementally, returns a union of node
+         * rectangles of the affected subtrees, including the area they were
+         * at before a move, clipped to the UI area. Returns an empty range if
+         * nothing changed and the whole UI area @cpp {{}, size()} @ce if
+         * anything else changed, such as node sizes, node hierarchy, node
+         * flags, layouts or any data in layers, as there's no way to know
+         * which nodes a layer change affects. It's also the whole UI area
+         * before the first @ref draw() and after a @ref setSize() that
+         * changes any size.
+         *
+         * The value is reset at the end of every @ref draw() and is not
+         * updated until @ref update(), so call it first to make the value
+         * reflect any pending state changes. Meant to be used for partial
+         * redraws where framebuffer bandwidth is the bottleneck, for example
+         * by restricting the application clear and redraw to the damaged
+         * area or by passing it, converted to framebuffer pixels with
+         * @ref framebufferSize() and flipped on Y, to
+         * [EGL_KHR_swap_buffers_with_damage](https://registry.khronos.org/EGL/extensions/KHR/EGL_KHR_swap_buffers_with_damage.txt).
+         * The calculation assumes that layers draw their data only inside
+         * rectangles of nodes the data are attached to.
+         */
+        Range2D damageRect() const;
+
+        /**
+         * @brief Count of frames node update statistics are gathered for
+         * @m_since_latest
+         *
+         * @see @ref setNodeUpdateStatisticsFrameCount()
+         */
+        UnsignedInt nodeUpdateStatisticsFrameCount() const;
+
+        /**
+         * @brief Set count of frames to gather node update statistics for
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * If non-zero, every @ref update() that has anything to update
+         * records which nodes had data attached that were updated by their
+         * layers and which nodes had @ref setNodeOffset() or
+         * @ref setNodeSize() called since the previous such @ref update(),
+         * and keeps the records for the last @p count such updates. These
+         * are then available through @ref nodeDataUpdateCounts() and
+         * @ref nodeLayoutUpdateCounts(), for example to visualize which
+         * nodes are responsible for excessive updates with
+         * @ref PerformanceOverlayLayer. Data are treated as updated if
+         * they're marked in @ref AbstractLayer::modifiedDataMask() or if
+         * the layer has @ref LayerState::NeedsDataUpdate set with no
+         * particular data marked, in which case all data in the layer are
+         * treated as updated.
+         *
+         * Expects that @p count is at most 65535. Changing the count
+         * discards all statistics gathered so far. Setting it to
+         * @cpp 0 @ce, which is the default, disables the gathering
+         * altogether.
+         */
+        AbstractUserInterface& setNodeUpdateStatisticsFrameCount(UnsignedInt count);
+
+        /**
+         * @brief Count of frames node update statistics were gathered in
+         * @m_since_latest
+         *
+         * Incremented on every @ref update() that records node update
+         * statistics, stays the same if
+         * @ref setNodeUpdateStatisticsFrameCount() is @cpp 0 @ce. Meant to
+         * be used to detect whether the statistics changed since the value
+         * was queried last time.
+         */
+        UnsignedLong nodeUpdateStatisticsFrame() const;
+
+        /**
+         * @brief Count of frames in which node data were updated
+         * @m_since_latest
+         *
+         * Indexed by node ID, contains a count of frames out of the last
+         * @ref nodeUpdateStatisticsFrameCount() ones in which data attached
+         * to given node were updated. The size of the view is at most
+         * @ref nodeCapacity(), nodes outside of the range have no updates
+         * recorded. If node update statistics aren't enabled, the view is
+         * empty.
+         * @see @ref setNodeUpdateStatisticsFrameCount()
+         */
+        Containers::StridedArrayView1D<const UnsignedShort> nodeDataUpdateCounts() const;
+
+        /**
+         * @brief Count of frames in which node layout was updated
+         * @m_since_latest
+         *
+         * Indexed by node ID, contains a count of frames out of the last
+         * @ref nodeUpdateStatisticsFrameCount() ones in which
+         * @ref setNodeOffset() or @ref setNodeSize() was called on given
+         * node, causing @ref UserInterfaceState::NeedsLayoutUpdate. The size
+         * of the view is at most @ref nodeCapacity(), nodes outside of the
+         * range have no updates recorded. If node update statistics aren't
+         * enabled, the view is empty.
+         * @see @ref setNodeUpdateStatisticsFrameCount()
+         */
+        Containers::StridedArrayView1D<const UnsignedShort> nodeLayoutUpdateCounts() const;
+
         /**
          * @brief Draw the user interface
          * @return Reference to self (for method chaining)
@@ -1785,9 +2597,27 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          *      -   Calls @ref AbstractLayer::draw()
          * -    Calls @ref AbstractRenderer::transition() with
          *      @ref RendererTargetState::Final
+         *
+         * Equivalent to calling @ref update() followed by @ref submit().
          */
         AbstractUserInterface& draw();
 
+        /**
+         * @brief Submit the prepared user interface for drawing
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * Like @ref draw(), but doesn't call @ref update() implicitly.
+         * Expects that a renderer instance is set and that @ref update() was
+         * called after the last change, i.e. that @ref state() contains no
+         * bits of @ref UserInterfaceState::NeedsNodeClean. Meant to be used
+         * when @ref update() is called from a different thread than the
+         * one owning the GPU context, with this function then only uploading
+         * the prepared data and performing the draws. See @ref update() for
+         * more information about the constraints.
+         */
+        AbstractUserInterface& submit();
+
         /**
          * @brief Handle a pointer press event
          *
@@ -2009,6 +2839,21 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          * Calling @ref PointerMoveEvent::setCaptured() in the leave event has
          * no effect in this case.
          *
+         * If @ref setPointerMoveEventCoalescingEnabled() is enabled, the
+         * event is primary, @ref PointerMoveEvent::pointer() is
+         * @relativeref{Corrade,Containers::NullOpt} and neither the captured
+         * node nor, if there's no captured node, the hovered node has
+         * @ref NodeFlag::RawPointerMoveEvents set, the event is only queued,
+         * replacing a previously queued event with the same source, pointer
+         * ID and pressed pointers, and the function returns @cpp false @ce.
+         * The queued event is then dispatched as described above on the next
+         * @ref update() or @ref advanceAnimations() or before any other event
+         * is handled, with
+         * @ref PointerMoveEvent::relativePosition() and
+         * @relativeref{PointerMoveEvent,coalescedCount()} including all
+         * events it replaced. Events that aren't coalesced are dispatched
+         * immediately, after first dispatching a queued event, if any.
+         *
          * Expects that the event is not accepted yet.
          * @see @ref PointerEvent::isAccepted(),
          *      @ref PointerEvent::setAccepted(), @ref currentCapturedNode(),
@@ -2205,6 +3050,32 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
             return Implementation::TextInputEventConverter<Event>::trigger(*this, event, Utility::forward<Args>(args)...);
         }
 
+        /**
+         * @brief Dispatch a batch of input events
+         * @return Count of events that were accepted
+         * @m_since_latest
+         *
+         * Goes through @p events in order and dispatches each to
+         * @ref pointerPressEvent(), @ref pointerReleaseEvent(),
+         * @ref pointerMoveEvent(), @ref keyPressEvent(),
+         * @ref keyReleaseEvent() or @ref textInputEvent() based on
+         * @ref InputEvent::type(), saving the value returned from the handler
+         * into @ref InputEvent::isAccepted(). The behavior is thus the same as
+         * if the handlers were called one by one, including the
+         * @ref update() performed internally by each of them. If
+         * @ref setPointerMoveEventCoalescingEnabled() is enabled, consecutive
+         * pointer moves in the batch are coalesced as described in
+         * @ref pointerMoveEvent() and reported as not accepted. After all
+         * events are dispatched, @ref update() is called once, dispatching
+         * the last queued pointer move event, if any, and making the state
+         * match the batch outcome.
+         *
+         * Expects that none of the events are accepted yet and that
+         * @ref InputEvent::time() is monotonically non-decreasing, which
+         * makes replays of recorded input deterministic.
+         */
+        std::size_t dispatchEvents(Containers::ArrayView<InputEvent> events);
+
         /**
          * @brief Node pressed by last pointer event
          *
@@ -2290,10 +3161,49 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          *
          * The returned handle may be invalid if the node or any of its parents
          * were removed and @ref clean() wasn't called since.
-         * @see @ref currentPressedNode()
+         * @see @ref currentPressedNode(), @ref nextFocusableNode(),
+         *      @ref previousFocusableNode()
          */
         NodeHandle currentFocusedNode() const;
 
+        /**
+         * @brief Next node that can be focused
+         * @m_since_latest
+         *
+         * Returns the first node after @p node in the order in which the
+         * nodes are drawn that has @ref NodeFlag::Focusable set and that
+         * isn't hidden, culled, or with @ref NodeFlag::NoEvents or
+         * @ref NodeFlag::Disabled set on it or any of its parents, i.e. a node
+         * for which @ref focusEvent() can succeed. Wraps around to the first
+         * such node at the end, and returns @p node itself if it's the only
+         * one. If @p node is @ref NodeHandle::Null or isn't visible, returns
+         * the first such node. If there are no such nodes, returns
+         * @ref NodeHandle::Null. Useful for implementing keyboard focus
+         * navigation, for example with @ref currentFocusedNode() passed as
+         * @p node on @ref Key::Tab.
+         *
+         * The list of focusable nodes is built during @ref update() only if
+         * the set of visible nodes or node flags changes, this function then
+         * has a constant complexity. As it's based on the state from the last
+         * @ref update(), the returned handle may be invalid if the node was
+         * removed since. Expects that @p node is either
+         * @ref NodeHandle::Null or valid.
+         * @see @ref previousFocusableNode()
+         */
+        NodeHandle nextFocusableNode(NodeHandle node) const;
+
+        /**
+         * @brief Previous node that can be focused
+         * @m_since_latest
+         *
+         * Like @ref nextFocusableNode(), but returns the first node before
+         * @p node, wrapping around to the last such node at the beginning.
+         * If @p node is @ref NodeHandle::Null or isn't visible, returns the
+         * last such node. Useful for example for implementing navigation on
+         * @ref Key::Tab with @ref Modifier::Shift.
+         */
+        NodeHandle previousFocusableNode(NodeHandle node) const;
+
         /**
          * @brief Position of last pointer event
          *
@@ -2307,6 +3217,33 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
          */
         Containers::Optional<Vector2> currentGlobalPointerPosition() const;
 
+        /**
+         * @brief Whether pointer move event coalescing is enabled
+         * @m_since_latest
+         *
+         * @see @ref setPointerMoveEventCoalescingEnabled()
+         */
+        bool isPointerMoveEventCoalescingEnabled() const;
+
+        /**
+         * @brief Enable or disable pointer move event coalescing
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * If enabled, primary @ref pointerMoveEvent() calls that don't change
+         * the set of pressed pointers are queued instead of being dispatched
+         * right away, and only the latest queued event is dispatched on the
+         * next @ref update(), which is useful with high-rate pointer devices
+         * that deliver many events per frame. See
+         * @ref Ui-AbstractUserInterface-application-latching for how to use
+         * it to reduce input latency. Nodes that need every event,
+         * such as drawing canvases, can opt out with
+         * @ref NodeFlag::RawPointerMoveEvents. See @ref pointerMoveEvent()
+         * for details. Disabling the coalescing dispatches a queued event, if
+         * there's any. Disabled by default.
+         */
+        AbstractUserInterface& setPointerMoveEventCoalescingEnabled(bool enabled);
+
     private:
         /* Used by set*AnimatorInstance() */
         MAGNUM_UI_LOCAL AbstractAnimator& setAnimatorInstanceInternal(
@@ -2315,12 +3252,20 @@ class MAGNUM_UI_EXPORT AbstractUserInterface {
             #endif
             Containers::Pointer<AbstractAnimator>&& instance, Int type);
         /* Used by removeNode(), advanceAnimations() and clean() */
+        MAGNUM_UI_LOCAL NodeHandle createNodeInternal(NodeHandle parent, const Vector2& offset, const Vector2& size, NodeFlags flags);
         MAGNUM_UI_LOCAL void removeNodeInternal(UnsignedInt id);
+        MAGNUM_UI_LOCAL void removeNodeSubtreeInternal(UnsignedInt id);
+        MAGNUM_UI_LOCAL void scheduleNestedNodesForRemovalInternal(std::size_t offset);
         /* Used by setNodeFlags(), addNodeFlags() and clearNodeFlags() */
         MAGNUM_UI_LOCAL void setNodeFlagsInternal(UnsignedInt id, NodeFlags flags);
         /* Used by removeNodeInternal(), setNodeOrder() and clearNodeOrder() */
         MAGNUM_UI_LOCAL bool clearNodeOrderInternal(NodeHandle handle);
         /* Used by *Event() functions */
+        MAGNUM_UI_LOCAL bool pointerMoveEventInternal(const Vector2& globalPosition, PointerMoveEvent& event);
+        MAGNUM_UI_LOCAL void flushPendingPointerMoveEvent();
+        MAGNUM_UI_LOCAL void updateHoverFastPath(NodeHandle node);
+        MAGNUM_UI_LOCAL NodeHandle callPointerMoveEventFromHoveredNode(const Vector2& globalPositionScaled, PointerMoveEvent& event);
+        MAGNUM_UI_LOCAL void drawInternal();
         MAGNUM_UI_LOCAL void callVisibilityLostEventOnNode(UnsignedInt nodeId, VisibilityLostEvent& event, bool canBePressedOrHovering);
         template<void(AbstractLayer::*function)(UnsignedInt, FocusEvent&)> MAGNUM_UI_LOCAL bool callFocusEventOnNode(UnsignedInt nodeId, FocusEvent& event);
         template<void(AbstractLayer::*function)(UnsignedInt, KeyEvent&)> MAGNUM_UI_LOCAL bool callKeyEventOnNode(UnsignedInt nodeId, KeyEvent& even);
@@ -30,6 +30,7 @@
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Utility/Algorithms.h>
+#include <Magnum/Math/Functions.h>
 
 #include "Magnum/Ui/AbstractUserInterface.h"
 #include "Magnum/Ui/AbstractVisualLayerAnimator.h"
@@ -163,7 +164,7 @@ void AbstractVisualLayer::setStyleInternal(const UnsignedInt id, const UnsignedI
     CORRADE_INTERNAL_DEBUG_ASSERT(_state->styles.size() == capacity());
     _state->styles[id] = style;
     /* _state->calculatedStyles is filled by AbstractVisualLayer::doUpdate() */
-    setNeedsUpdate(LayerState::NeedsDataUpdate);
+    setNeedsDataUpdate(id);
 }
 
 void AbstractVisualLayer::setTransitionedStyle(const AbstractUserInterface& ui, const DataHandle handle, const UnsignedInt style) {
@@ -186,39 +187,143 @@ void AbstractVisualLayer::setTransitionedStyleInternal(const AbstractUserInterfa
     State& state = *_state;
     CORRADE_INTERNAL_DEBUG_ASSERT(state.styles.size() == capacity());
 
-    const Shared::State& sharedState = state.shared;
-    const NodeHandle node = this->node(handle);
+    state.styles[layerDataHandleId(handle)] = styleTransitionFor(ui, node(handle))(style);
+    setNeedsDataUpdate(layerDataHandleId(handle));
+}
+
+UnsignedInt(*AbstractVisualLayer::styleTransitionFor(const AbstractUserInterface& ui, const NodeHandle node) const)(UnsignedInt) {
+    const Shared::State& sharedState = _state->shared;
     const bool hovered = ui.currentHoveredNode() == node;
-    UnsignedInt(*transition)(UnsignedInt);
-    if(ui.currentPressedNode() == node) transition = hovered ?
+    if(ui.currentPressedNode() == node) return hovered ?
         sharedState.styleTransitionToPressedOver :
         sharedState.styleTransitionToPressedOut;
-    else if(ui.currentFocusedNode() == node) transition = hovered ?
+    if(ui.currentFocusedNode() == node) return hovered ?
         sharedState.styleTransitionToFocusedOver :
         sharedState.styleTransitionToFocusedOut;
-    else transition = hovered ?
+    return hovered ?
         sharedState.styleTransitionToInactiveOver :
         sharedState.styleTransitionToInactiveOut;
-    state.styles[layerDataHandleId(handle)] = transition(style);
-    setNeedsUpdate(LayerState::NeedsDataUpdate);
+}
+
+void AbstractVisualLayer::setStyle(const Containers::StridedArrayView1D<const DataHandle>& handles, const Containers::StridedArrayView1D<const UnsignedInt>& styles) {
+    State& state = *_state;
+    CORRADE_ASSERT(handles.size() == styles.size(),
+        "Ui::AbstractVisualLayer::setStyle(): expected styles to have" << handles.size() << "items but got" << styles.size(), );
+    CORRADE_INTERNAL_DEBUG_ASSERT(state.styles.size() == capacity());
+    #ifndef CORRADE_NO_ASSERT
+    const UnsignedInt totalStyleCount = state.shared.styleCount + state.shared.dynamicStyleCount;
+    #endif
+    for(std::size_t i = 0; i != handles.size(); ++i) {
+        CORRADE_ASSERT(isHandleValid(handles[i]),
+            "Ui::AbstractVisualLayer::setStyle(): invalid handle" << handles[i] << "at index" << i, );
+        CORRADE_ASSERT(styles[i] < totalStyleCount,
+            "Ui::AbstractVisualLayer::setStyle(): style" << styles[i] << "at index" << i << "out of range for" << totalStyleCount << "styles", );
+        const UnsignedInt id = dataHandleId(handles[i]);
+        state.styles[id] = styles[i];
+        setNeedsDataUpdate(id);
+    }
+}
+
+void AbstractVisualLayer::setTransitionedStyle(const AbstractUserInterface& ui, const Containers::StridedArrayView1D<const DataHandle>& handles, const Containers::StridedArrayView1D<const UnsignedInt>& styles) {
+    State& state = *_state;
+    CORRADE_ASSERT(handles.size() == styles.size(),
+        "Ui::AbstractVisualLayer::setTransitionedStyle(): expected styles to have" << handles.size() << "items but got" << styles.size(), );
+    CORRADE_INTERNAL_DEBUG_ASSERT(state.styles.size() == capacity());
+
+    /* The pressed, hovered and focused node is at most one each, so instead
+       of querying the UI for every data, pick the transition for the common
+       case of a node that's neither just once and look up a different one
+       only for the rare data attached to those */
+    const NodeHandle pressed = ui.currentPressedNode();
+    const NodeHandle hovered = ui.currentHoveredNode();
+    const NodeHandle focused = ui.currentFocusedNode();
+    UnsignedInt(*const inactiveOut)(UnsignedInt) = state.shared.styleTransitionToInactiveOut;
+    for(std::size_t i = 0; i != handles.size(); ++i) {
+        CORRADE_ASSERT(isHandleValid(handles[i]),
+            "Ui::AbstractVisualLayer::setTransitionedStyle(): invalid handle" << handles[i] << "at index" << i, );
+        CORRADE_ASSERT(styles[i] < state.shared.styleCount,
+            "Ui::AbstractVisualLayer::setTransitionedStyle(): style" << styles[i] << "at index" << i << "out of range for" << state.shared.styleCount << "styles", );
+        const LayerDataHandle handle = dataHandleData(handles[i]);
+        const NodeHandle node = this->node(handle);
+        UnsignedInt(*const transition)(UnsignedInt) =
+            node == pressed || node == hovered || node == focused ?
+                styleTransitionFor(ui, node) : inactiveOut;
+        const UnsignedInt id = layerDataHandleId(handle);
+        state.styles[id] = transition(styles[i]);
+        setNeedsDataUpdate(id);
+    }
+}
+
+void AbstractVisualLayer::remapStyles(const Containers::StridedArrayView1D<const UnsignedInt>& mapping) {
+    State& state = *_state;
+    const UnsignedInt styleCount = state.shared.styleCount;
+    CORRADE_ASSERT(mapping.size() == styleCount,
+        "Ui::AbstractVisualLayer::remapStyles(): expected mapping to have" << styleCount << "items but got" << mapping.size(), );
+    #ifndef CORRADE_NO_ASSERT
+    for(std::size_t i = 0; i != mapping.size(); ++i)
+        CORRADE_ASSERT(mapping[i] < styleCount,
+            "Ui::AbstractVisualLayer::remapStyles(): style" << mapping[i] << "at index" << i << "out of range for" << styleCount << "styles", );
+    #endif
+    CORRADE_INTERNAL_DEBUG_ASSERT(state.styles.size() == capacity());
+
+    /* There's no cheap way to know which data are free, but free data still
+       have the style they were created with, which is in range, so remapping
+       them as well is harmless */
+    for(std::size_t i = 0; i != state.styles.size(); ++i) {
+        const UnsignedInt style = state.styles[i];
+        if(style >= styleCount)
+            continue;
+        const UnsignedInt mapped = mapping[style];
+        if(mapped == style)
+            continue;
+        state.styles[i] = mapped;
+        setNeedsDataUpdate(i);
+    }
 }
 
 UnsignedInt AbstractVisualLayer::dynamicStyleUsedCount() const {
-    return _state->dynamicStylesUsed.count();
+    return _state->dynamicStyleUsedCount;
+}
+
+UnsignedInt AbstractVisualLayer::dynamicStyleUsedMaxCount() const {
+    return _state->dynamicStyleUsedMaxCount;
+}
+
+void AbstractVisualLayer::resetDynamicStyleUsedMaxCount() {
+    State& state = *_state;
+    state.dynamicStyleUsedMaxCount = state.dynamicStyleUsedCount;
 }
 
 Containers::Optional<UnsignedInt> AbstractVisualLayer::allocateDynamicStyle(const AnimationHandle animation) {
     State& state = *_state;
+    const std::size_t size = state.dynamicStylesUsed.size();
+    if(state.dynamicStyleUsedCount == size)
+        return {};
+
+    /* All bits before the hint are set, so start from there and skip whole
+       bytes that are fully used. The view is allocated by the ArrayTuple so
+       it always starts at a byte boundary. */
     /** @todo some builtin "find first unset" API, tzcnt etc */
-    for(std::size_t i = 0; i != state.dynamicStylesUsed.size(); ++i) {
-        if(state.dynamicStylesUsed[i])
-            continue;
-        state.dynamicStylesUsed.set(i);
-        state.dynamicStyleAnimations[i] = animation;
-        return i;
+    const UnsignedByte* const data = static_cast<const UnsignedByte*>(state.dynamicStylesUsed.data());
+    CORRADE_INTERNAL_DEBUG_ASSERT(state.dynamicStylesUsed.offset() == 0);
+    std::size_t i = state.dynamicStyleFreeHint;
+    while(!(i & 7) && i + 8 <= size && data[i >> 3] == 0xff)
+        i += 8;
+    while(state.dynamicStylesUsed[i]) {
+        ++i;
+        if(!(i & 7)) while(i + 8 <= size && data[i >> 3] == 0xff)
+            i += 8;
     }
+    /* Given the used count is less than the size, there has to be a free
+       bit */
+    CORRADE_INTERNAL_DEBUG_ASSERT(i < size);
 
-    return {};
+    state.dynamicStylesUsed.set(i);
+    state.dynamicStyleAnimations[i] = animation;
+    state.dynamicStyleFreeHint = i + 1;
+    ++state.dynamicStyleUsedCount;
+    state.dynamicStyleUsedMaxCount = Math::max(state.dynamicStyleUsedMaxCount, state.dynamicStyleUsedCount);
+    return i;
 }
 
 AnimationHandle AbstractVisualLayer::dynamicStyleAnimation(const UnsignedInt id) const {
@@ -236,6 +341,8 @@ void AbstractVisualLayer::recycleDynamicStyle(const UnsignedInt id) {
         "Ui::AbstractVisualLayer::recycleDynamicStyle(): style" << id << "not allocated", );
     state.dynamicStylesUsed.reset(id);
     state.dynamicStyleAnimations[id] = AnimationHandle::Null;
+    state.dynamicStyleFreeHint = Math::min(state.dynamicStyleFreeHint, id);
+    --state.dynamicStyleUsedCount;
 }
 
 AbstractVisualLayer& AbstractVisualLayer::assignAnimator(AbstractVisualLayerStyleAnimator& animator) {
@@ -290,29 +397,48 @@ void AbstractVisualLayer::doUpdate(const LayerStates states, const Containers::S
         if(UnsignedInt(*const toDisabled)(UnsignedInt) = sharedState.styleTransitionToDisabled) {
             const Containers::StridedArrayView1D<const NodeHandle> nodes = this->nodes();
             const UnsignedInt styleCount = sharedState.styleCount;
+
+            /* Grow the cached disabled state to the current capacity. After
+               compact() the IDs get shuffled, but in that case all data are
+               marked as modified so the old contents don't matter. */
+            if(state.calculatedStylesDisabled.size() != capacity()) {
+                Containers::BitArray calculatedStylesDisabled{ValueInit, capacity()};
+                for(std::size_t i = 0, iMax = Math::min(state.calculatedStylesDisabled.size(), calculatedStylesDisabled.size()); i != iMax; ++i)
+                    if(state.calculatedStylesDisabled[i]) calculatedStylesDisabled.set(i);
+                state.calculatedStylesDisabled = Utility::move(calculatedStylesDisabled);
+            }
+
+            /* If the set of visible data changed, some of them may have been
+               modified while not being visible and their modification bits
+               are already gone, so recalculate everything in that case */
+            const bool incremental = !(states >= LayerState::NeedsNodeOrderUpdate);
+            const Containers::BitArrayView modifiedData = modifiedDataMask();
             for(const UnsignedInt id: dataIds) {
                 const UnsignedInt style = state.styles[id];
+                const bool disabled = !nodesEnabled[nodeHandleId(nodes[id])];
+
+                /* If the style didn't change, the node enablement is the same
+                   as last time and the style isn't dynamic, the calculated
+                   style is still up-to-date, which saves a potentially
+                   expensive function call for the majority of data that
+                   aren't affected by a change in some unrelated subtree.
+                   Dynamic styles are always recalculated as their animation
+                   target style may have changed without the data being
+                   marked as modified, but those are passthrough anyway. A
+                   change of the transition function itself marks all data as
+                   modified. */
+                if(incremental && !modifiedData[id] && style < styleCount && state.calculatedStylesDisabled[id] == disabled)
+                    continue;
+                state.calculatedStylesDisabled.set(id, disabled);
 
                 /* If the style is dynamic, maybe it has an animation with a
                    target style index assigned, which we can use as the
                    (soon-to-be-)current style index to transition from. */
                 const UnsignedInt currentStyle = styleOrAnimationTargetStyle(style);
 
-                /** @todo Doing a function call for all data may be a bit
-                    horrible, also especially if the code inside is a giant
-                    switch that the compiler failed to turn into a LUT. Thus,
-                    ideally, the transition should be done only for nodes that
-                    actually changed their disabled status, which means
-                    recording the previous nodesEnabled state, XORing the
-                    current with it, and then performing transition only when
-                    the XOR is 1. Furthermore, that may often be just a very
-                    tiny portion of nodes, so ideally there would be a way to
-                    quickly get just the subset of *data* IDs that actually
-                    changed (and not node IDs), to iterate over them
-                    directly. */
                 /* Skipping data that have dynamic styles, those are
                    passthrough */
-                if(currentStyle < styleCount && !nodesEnabled[nodeHandleId(nodes[id])]) {
+                if(currentStyle < styleCount && disabled) {
                     const UnsignedInt nextStyle = toDisabled(currentStyle);
                     /** @todo a debug assert? or is it negligible compared to
                         the function call? */
@@ -392,7 +518,7 @@ void AbstractVisualLayer::doPointerPressEvent(const UnsignedInt dataId, PointerE
            one that's the animation target), update it */
         if(nextStyle != currentStyle) {
             style = nextStyle;
-            setNeedsUpdate(LayerState::NeedsDataUpdate);
+            setNeedsDataUpdate(dataId);
         }
     }
 
@@ -437,7 +563,7 @@ void AbstractVisualLayer::doPointerReleaseEvent(const UnsignedInt dataId, Pointe
            one that's the animation target), update it */
         if(nextStyle != currentStyle) {
             style = nextStyle;
-            setNeedsUpdate(LayerState::NeedsDataUpdate);
+            setNeedsDataUpdate(dataId);
         }
     }
 
@@ -477,7 +603,7 @@ void AbstractVisualLayer::doPointerEnterEvent(const UnsignedInt dataId, PointerM
            one that's the animation target), update it */
         if(nextStyle != currentStyle) {
             style = nextStyle;
-            setNeedsUpdate(LayerState::NeedsDataUpdate);
+            setNeedsDataUpdate(dataId);
         }
     }
 }
@@ -506,7 +632,7 @@ void AbstractVisualLayer::doPointerLeaveEvent(const UnsignedInt dataId, PointerM
            one that's the animation target), update it */
         if(nextStyle != currentStyle) {
             style = nextStyle;
-            setNeedsUpdate(LayerState::NeedsDataUpdate);
+            setNeedsDataUpdate(dataId);
         }
     }
 }
@@ -535,7 +661,7 @@ void AbstractVisualLayer::doFocusEvent(const UnsignedInt dataId, FocusEvent& eve
            one that's the animation target), update it */
         if(nextStyle != currentStyle) {
             style = nextStyle;
-            setNeedsUpdate(LayerState::NeedsDataUpdate);
+            setNeedsDataUpdate(dataId);
         }
     }
 
@@ -566,7 +692,7 @@ void AbstractVisualLayer::doBlurEvent(const UnsignedInt dataId, FocusEvent& even
            one that's the animation target), update it */
         if(nextStyle != currentStyle) {
             style = nextStyle;
-            setNeedsUpdate(LayerState::NeedsDataUpdate);
+            setNeedsDataUpdate(dataId);
         }
     }
 
@@ -598,7 +724,7 @@ void AbstractVisualLayer::doVisibilityLostEvent(const UnsignedInt dataId, Visibi
            one that's the animation target), update it */
         if(nextStyle != currentStyle) {
             style = nextStyle;
-            setNeedsUpdate(LayerState::NeedsDataUpdate);
+            setNeedsDataUpdate(dataId);
         }
     }
 }
@@ -224,6 +224,60 @@ class MAGNUM_UI_EXPORT AbstractVisualLayer: public AbstractLayer {
             setTransitionedStyle(ui, handle, UnsignedInt(style));
         }
 
+        /**
+         * @brief Set style index for multiple data
+         * @m_since_latest
+         *
+         * Equivalent to calling @ref setStyle(DataHandle, UnsignedInt) for
+         * each pair of items in @p handles and @p styles, but with the state
+         * updated just once for all data. Expects that both views have the
+         * same size, all handles are valid and all styles are less than
+         * @ref Shared::totalStyleCount().
+         *
+         * Calling this function causes @ref LayerState::NeedsDataUpdate to be
+         * set, unless @p handles are empty.
+         * @see @ref remapStyles()
+         */
+        void setStyle(const Containers::StridedArrayView1D<const DataHandle>& handles, const Containers::StridedArrayView1D<const UnsignedInt>& styles);
+
+        /**
+         * @brief Set style index for multiple data, potentially transitioning them based on user interface state
+         * @m_since_latest
+         *
+         * Equivalent to calling
+         * @ref setTransitionedStyle(const AbstractUserInterface&, DataHandle, UnsignedInt)
+         * for each pair of items in @p handles and @p styles, but with the
+         * user interface node state queried and the layer state updated just
+         * once for all data. Expects that both views have the same size, all
+         * handles are valid and all styles are less than
+         * @ref Shared::styleCount().
+         *
+         * Calling this function causes @ref LayerState::NeedsDataUpdate to be
+         * set, unless @p handles are empty.
+         */
+        void setTransitionedStyle(const AbstractUserInterface& ui, const Containers::StridedArrayView1D<const DataHandle>& handles, const Containers::StridedArrayView1D<const UnsignedInt>& styles);
+
+        /**
+         * @brief Remap styles of all data
+         * @m_since_latest
+         *
+         * For every data in the layer that uses a style index @cpp i @ce less
+         * than @ref Shared::styleCount() replaces the index with
+         * @cpp mapping[i] @ce. Data that currently use a dynamic style are
+         * left untouched, as the dynamic style is owned by a style animation
+         * or by the code that allocated it. Useful for example for switching
+         * a whole UI between a light and dark variant of a style without
+         * having to track and update each data individually. Expects that the
+         * @p mapping size is equal to @ref Shared::styleCount() and all
+         * values in it are less than @ref Shared::styleCount().
+         *
+         * Only data whose style actually changed are marked in
+         * @ref modifiedDataMask(). If there's at least one such data, calling
+         * this function causes @ref LayerState::NeedsDataUpdate to be set.
+         * @see @ref setStyle(const Containers::StridedArrayView1D<const DataHandle>&, const Containers::StridedArrayView1D<const UnsignedInt>&)
+         */
+        void remapStyles(const Containers::StridedArrayView1D<const UnsignedInt>& mapping);
+
         /**
          * @brief Count of used dynamic styles
          *
@@ -234,6 +288,27 @@ class MAGNUM_UI_EXPORT AbstractVisualLayer: public AbstractLayer {
          */
         UnsignedInt dynamicStyleUsedCount() const;
 
+        /**
+         * @brief Max count of used dynamic styles
+         * @m_since_latest
+         *
+         * High-water mark of @ref dynamicStyleUsedCount() since the layer was
+         * created or since @ref resetDynamicStyleUsedMaxCount() was last
+         * called. Useful for tuning @ref Shared::dynamicStyleCount() --- if
+         * it's equal to it, animations may have been failing to allocate a
+         * dynamic style.
+         */
+        UnsignedInt dynamicStyleUsedMaxCount() const;
+
+        /**
+         * @brief Reset the max count of used dynamic styles
+         * @m_since_latest
+         *
+         * Sets @ref dynamicStyleUsedMaxCount() to the current
+         * @ref dynamicStyleUsedCount().
+         */
+        void resetDynamicStyleUsedMaxCount();
+
         /**
          * @brief Allocate a dynamic style index
          *
@@ -247,7 +322,9 @@ class MAGNUM_UI_EXPORT AbstractVisualLayer: public AbstractLayer {
          * When not used anymore, the index should be passed to
          * @ref recycleDynamicStyle() to make it available for allocation
          * again. If there are no free dynamic styles left, returns
-         * @relativeref{Corrade,Containers::NullOpt}.
+         * @relativeref{Corrade,Containers::NullOpt}. The lowest free index is
+         * always returned. The allocation and recycling is amortized
+         * constant-time, with fully used ranges of the pool skipped.
          *
          * If the dynamic style is driven by an animation, its handle can be
          * passed to the @p animation argument to retrieve later with
@@ -262,7 +339,8 @@ class MAGNUM_UI_EXPORT AbstractVisualLayer: public AbstractLayer {
          * animation that has a hovered style as the target, and a press
          * happens, it'll trigger a transition the hovered style to a pressed
          * one, instead of leaving the dynamic style untouched.
-         * @see @ref dynamicStyleUsedCount(), @ref Shared::dynamicStyleCount()
+         * @see @ref dynamicStyleUsedCount(), @ref dynamicStyleUsedMaxCount(),
+         *      @ref Shared::dynamicStyleCount()
          */
         Containers::Optional<UnsignedInt> allocateDynamicStyle(AnimationHandle animation =
             #ifdef DOXYGEN_GENERATING_OUTPUT
@@ -325,6 +403,7 @@ class MAGNUM_UI_EXPORT AbstractVisualLayer: public AbstractLayer {
 
     private:
         MAGNUM_UI_LOCAL void setStyleInternal(UnsignedInt id, UnsignedInt style);
+        MAGNUM_UI_LOCAL UnsignedInt(*styleTransitionFor(const AbstractUserInterface& ui, NodeHandle node) const)(UnsignedInt);
         MAGNUM_UI_LOCAL void setTransitionedStyleInternal(const AbstractUserInterface& ui, LayerDataHandle handle, UnsignedInt style);
         MAGNUM_UI_LOCAL UnsignedInt styleOrAnimationTargetStyle(UnsignedInt style) const;
 
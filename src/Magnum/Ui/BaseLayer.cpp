@@ -26,6 +26,7 @@
 
 #include "BaseLayer.h"
 
+#include <cstring>
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/BitArrayView.h>
 #include <Corrade/Containers/EnumSet.hpp>
@@ -33,6 +34,7 @@
 #include <Corrade/Containers/Iterable.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Utility/Algorithms.h>
+#include <Magnum/Math/Constants.h>
 #include <Magnum/Math/Functions.h>
 #include <Magnum/Math/Matrix3.h>
 #include <Magnum/Math/Swizzle.h>
@@ -41,7 +43,9 @@
 #include "Magnum/Ui/BaseLayerAnimator.h"
 #include "Magnum/Ui/Event.h"
 #include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/MemoryUsage.h"
 #include "Magnum/Ui/Implementation/baseLayerState.h"
+#include "Magnum/Ui/Implementation/memoryUsage.h"
 
 namespace Magnum { namespace Ui {
 
@@ -57,11 +61,16 @@ Debug& operator<<(Debug& debug, const BaseLayerSharedFlag value) {
         _c(NoOutline)
         _c(TextureMask)
         _c(SubdividedQuads)
+        _c(InstancedQuads)
+        _c(NodeRelativePositions)
+        _c(ShaderClipping)
+        _c(AutomaticShaderVariants)
+        _c(CompactVertices)
         #undef _c
         /* LCOV_EXCL_STOP */
     }
 
-    return debug << "(" << Debug::nospace << Debug::hex << UnsignedByte(value) << Debug::nospace << ")";
+    return debug << "(" << Debug::nospace << Debug::hex << UnsignedShort(value) << Debug::nospace << ")";
 }
 
 Debug& operator<<(Debug& debug, const BaseLayerSharedFlags value) {
@@ -72,19 +81,26 @@ Debug& operator<<(Debug& debug, const BaseLayerSharedFlags value) {
         BaseLayerSharedFlag::BackgroundBlur,
         BaseLayerSharedFlag::NoRoundedCorners,
         BaseLayerSharedFlag::NoOutline,
-        BaseLayerSharedFlag::SubdividedQuads
+        BaseLayerSharedFlag::SubdividedQuads,
+        BaseLayerSharedFlag::InstancedQuads,
+        BaseLayerSharedFlag::NodeRelativePositions,
+        BaseLayerSharedFlag::ShaderClipping,
+        BaseLayerSharedFlag::AutomaticShaderVariants,
+        BaseLayerSharedFlag::CompactVertices
     });
 }
 
 BaseLayer::Shared::State::State(Shared& self, const Configuration& configuration): AbstractVisualLayer::Shared::State{self, configuration.styleCount(), configuration.dynamicStyleCount()},
     /* The radius is always at most 31, so can be a byte */
     backgroundBlurRadius{UnsignedByte(configuration.backgroundBlurRadius())},
+    backgroundBlurDownsampling{UnsignedByte(configuration.backgroundBlurDownsampling())},
     flags{configuration.flags()},
     styleUniformCount{configuration.styleUniformCount()}
 {
     styleStorage = Containers::ArrayTuple{
         {NoInit, configuration.styleCount(), styles},
-        {NoInit, configuration.dynamicStyleCount() ? configuration.styleUniformCount() : 0, styleUniforms}
+        {NoInit, configuration.dynamicStyleCount() ? configuration.styleUniformCount() : 0, styleUniforms},
+        {ValueInit, flags >= BaseLayerSharedFlag::AutomaticShaderVariants ? configuration.styleUniformCount() : 0, simpleStyleUniforms}
     };
 }
 
@@ -96,6 +112,16 @@ BaseLayer::Shared::Shared(Containers::Pointer<State>&& state): AbstractVisualLay
         "Ui::BaseLayer::Shared: expected non-zero total style count", );
     CORRADE_ASSERT(!(s.flags & BaseLayerSharedFlag::SubdividedQuads) || !(s.flags & (BaseLayerSharedFlag::NoOutline|BaseLayerSharedFlag::NoRoundedCorners)),
         "Ui::BaseLayer::Shared:" << BaseLayerSharedFlag::SubdividedQuads << "and" << (s.flags & (BaseLayerSharedFlag::NoOutline|BaseLayerSharedFlag::NoRoundedCorners)) << "are mutually exclusive", );
+    CORRADE_ASSERT(!(s.flags & BaseLayerSharedFlag::SubdividedQuads) || !(s.flags & BaseLayerSharedFlag::AutomaticShaderVariants),
+        "Ui::BaseLayer::Shared:" << BaseLayerSharedFlag::SubdividedQuads << "and" << BaseLayerSharedFlag::AutomaticShaderVariants << "are mutually exclusive", );
+    CORRADE_ASSERT(!(s.flags & BaseLayerSharedFlag::SubdividedQuads) || !(s.flags & BaseLayerSharedFlag::InstancedQuads),
+        "Ui::BaseLayer::Shared:" << BaseLayerSharedFlag::SubdividedQuads << "and" << BaseLayerSharedFlag::InstancedQuads << "are mutually exclusive", );
+    CORRADE_ASSERT(!(s.flags & BaseLayerSharedFlag::InstancedQuads) || !(s.flags & BaseLayerSharedFlag::NodeRelativePositions),
+        "Ui::BaseLayer::Shared:" << BaseLayerSharedFlag::InstancedQuads << "and" << BaseLayerSharedFlag::NodeRelativePositions << "are mutually exclusive", );
+    CORRADE_ASSERT(!(s.flags & BaseLayerSharedFlag::InstancedQuads) || !(s.flags & BaseLayerSharedFlag::ShaderClipping),
+        "Ui::BaseLayer::Shared:" << BaseLayerSharedFlag::InstancedQuads << "and" << BaseLayerSharedFlag::ShaderClipping << "are mutually exclusive", );
+    CORRADE_ASSERT(!(s.flags & BaseLayerSharedFlag::CompactVertices) || !(s.flags & (BaseLayerSharedFlag::SubdividedQuads|BaseLayerSharedFlag::InstancedQuads)),
+        "Ui::BaseLayer::Shared:" << BaseLayerSharedFlag::CompactVertices << "and" << (s.flags & (BaseLayerSharedFlag::SubdividedQuads|BaseLayerSharedFlag::InstancedQuads)) << "are mutually exclusive", );
 }
 
 BaseLayer::Shared::Shared(const Configuration& configuration): Shared{Containers::pointer<State>(*this, configuration)} {}
@@ -136,6 +162,11 @@ void BaseLayer::Shared::setStyleInternal(const BaseLayerCommonStyleUniform& comm
        the variable comment for why the uniform isn't used instead. */
     state.smoothness = commonUniform.smoothness;
 
+    /* Remember which uniforms can be drawn with the cheaper shader variant */
+    if(state.flags >= BaseLayerSharedFlag::AutomaticShaderVariants)
+        for(std::size_t i = 0; i != uniforms.size(); ++i)
+            state.simpleStyleUniforms.set(i, Implementation::isSimpleBaseLayerStyleUniform(uniforms[i]));
+
     #ifndef CORRADE_NO_ASSERT
     /* Now it's safe to call update() */
     state.setStyleCalled = true;
@@ -196,6 +227,13 @@ BaseLayer::Shared::Configuration& BaseLayer::Shared::Configuration::setBackgroun
     return *this;
 }
 
+BaseLayer::Shared::Configuration& BaseLayer::Shared::Configuration::setBackgroundBlurDownsampling(const UnsignedInt factor) {
+    CORRADE_ASSERT(factor == 1 || factor == 2 || factor == 4,
+        "Ui::BaseLayer::Shared::Configuration::setBackgroundBlurDownsampling(): expected 1, 2 or 4, got" << factor, *this);
+    _backgroundBlurDownsampling = factor;
+    return *this;
+}
+
 BaseLayer::State::State(Shared::State& shared): AbstractVisualLayer::State{shared}, styleUpdateStamp{shared.styleUpdateStamp} {
     dynamicStyleStorage = Containers::ArrayTuple{
         {ValueInit, shared.dynamicStyleCount, dynamicStyleUniforms},
@@ -231,6 +269,21 @@ BaseLayer& BaseLayer::setBackgroundBlurPassCount(UnsignedInt count) {
     return *this;
 }
 
+auto BaseLayer::vertexExecutor() const -> void(*)(UnsignedInt, void(*)(void*, UnsignedInt), void*, void*) {
+    return static_cast<const State&>(*_state).vertexExecutor;
+}
+
+void* BaseLayer::vertexExecutorUserData() const {
+    return static_cast<const State&>(*_state).vertexExecutorUserData;
+}
+
+BaseLayer& BaseLayer::setVertexExecutor(void(*const executor)(UnsignedInt, void(*)(void*, UnsignedInt), void*, void*), void* const userData) {
+    auto& state = static_cast<State&>(*_state);
+    state.vertexExecutor = executor;
+    state.vertexExecutorUserData = userData;
+    return *this;
+}
+
 BaseLayer& BaseLayer::assignAnimator(BaseLayerStyleAnimator& animator) {
     return static_cast<BaseLayer&>(AbstractVisualLayer::assignAnimator(animator));
 }
@@ -298,6 +351,39 @@ DataHandle BaseLayer::create(const UnsignedInt style, const NodeHandle node) {
     return handle;
 }
 
+void BaseLayer::create(const UnsignedInt style, const Containers::StridedArrayView1D<const NodeHandle>& nodes, const Containers::StridedArrayView1D<DataHandle>& handles) {
+    State& state = static_cast<State&>(*_state);
+    #ifndef CORRADE_NO_ASSERT
+    auto& sharedState = static_cast<Shared::State&>(state.shared);
+    #endif
+    CORRADE_ASSERT(style < sharedState.styleCount + sharedState.dynamicStyleCount,
+        "Ui::BaseLayer::create(): style" << style << "out of range for" << sharedState.styleCount + sharedState.dynamicStyleCount << "styles", );
+
+    AbstractLayer::create(nodes, handles);
+
+    /* Grow the data storage just once to cover the highest ID, the handles
+       allocated from the free list are within the existing size */
+    UnsignedInt maxId = 0;
+    for(const DataHandle handle: handles)
+        maxId = Math::max(maxId, dataHandleId(handle));
+    if(!handles.isEmpty() && maxId >= state.data.size()) {
+        arrayAppend(state.data, NoInit, maxId - state.data.size() + 1);
+        state.styles = stridedArrayView(state.data).slice(&Implementation::BaseLayerData::style);
+        state.calculatedStyles = stridedArrayView(state.data).slice(&Implementation::BaseLayerData::calculatedStyle);
+    }
+
+    for(const DataHandle handle: handles) {
+        Implementation::BaseLayerData& data = state.data[dataHandleId(handle)];
+        data.padding = {};
+        data.outlineWidth = {};
+        data.color = Color3{1.0f};
+        data.style = style;
+        /* calculatedStyle is filled by AbstractVisualLayer::doUpdate() */
+        data.textureCoordinateOffset = {};
+        data.textureCoordinateSize = Vector2{1.0f};
+    }
+}
+
 Color4 BaseLayer::color(const DataHandle handle) const {
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::BaseLayer::color(): invalid handle" << handle, {});
@@ -324,7 +410,7 @@ void BaseLayer::setColor(const LayerDataHandle handle, const Color4& color) {
 
 void BaseLayer::setColorInternal(const UnsignedInt id, const Color4& color) {
     static_cast<State&>(*_state).data[id].color = color;
-    setNeedsUpdate(LayerState::NeedsDataUpdate);
+    setNeedsDataUpdate(id);
 }
 
 void BaseLayer::setOutlineWidth(const DataHandle handle, const Vector4& width) {
@@ -353,7 +439,7 @@ void BaseLayer::setOutlineWidth(const LayerDataHandle handle, const Vector4& wid
 
 void BaseLayer::setOutlineWidthInternal(const UnsignedInt id, const Vector4& width) {
     static_cast<State&>(*_state).data[id].outlineWidth = width;
-    setNeedsUpdate(LayerState::NeedsDataUpdate);
+    setNeedsDataUpdate(id);
 }
 
 Vector4 BaseLayer::padding(const DataHandle handle) const {
@@ -382,7 +468,7 @@ void BaseLayer::setPadding(const LayerDataHandle handle, const Vector4& padding)
 
 void BaseLayer::setPaddingInternal(const UnsignedInt id, const Vector4& padding) {
     static_cast<State&>(*_state).data[id].padding = padding;
-    setNeedsUpdate(LayerState::NeedsDataUpdate);
+    setNeedsDataUpdate(id);
 }
 
 Vector3 BaseLayer::textureCoordinateOffset(const DataHandle handle) const {
@@ -442,7 +528,7 @@ void BaseLayer::setTextureCoordinatesInternal(const UnsignedInt id, const Vector
     Implementation::BaseLayerData& data = state.data[id];
     data.textureCoordinateOffset = offset;
     data.textureCoordinateSize = size;
-    setNeedsUpdate(LayerState::NeedsDataUpdate);
+    setNeedsDataUpdate(id);
 }
 
 LayerFeatures BaseLayer::doFeatures() const {
@@ -450,6 +536,61 @@ LayerFeatures BaseLayer::doFeatures() const {
     return AbstractVisualLayer::doFeatures()|(sharedState.dynamicStyleCount ? LayerFeature::AnimateStyles : LayerFeatures{})|LayerFeature::Draw|(sharedState.flags & BaseLayerSharedFlag::BackgroundBlur ? LayerFeature::Composite : LayerFeatures{});
 }
 
+void BaseLayer::doReserve(const std::size_t capacity) {
+    State& state = static_cast<State&>(*_state);
+    arrayReserve(state.data, capacity);
+    /* The views need to be updated as the reserve may have reallocated */
+    state.styles = stridedArrayView(state.data).slice(&Implementation::BaseLayerData::style);
+    state.calculatedStyles = stridedArrayView(state.data).slice(&Implementation::BaseLayerData::calculatedStyle);
+}
+
+void BaseLayer::doMemoryUsage(MemoryUsage& usage) const {
+    const State& state = static_cast<const State&>(*_state);
+    usage.cpuByteCount +=
+        /* The base struct has its own dynamic style storage */
+        static_cast<const AbstractVisualLayer::State&>(state).dynamicStyleStorage.size() +
+        Implementation::arrayByteCount(state.data) +
+        Implementation::arrayByteCount(state.vertices) +
+        Implementation::arrayByteCount(state.indices) +
+        Implementation::arrayByteCount(state.vertexScratch) +
+        Implementation::arrayByteCount(state.modifiedDataIds) +
+        Implementation::arrayByteCount(state.dataNodeProperties) +
+        Implementation::arrayByteCount(state.dataClipRects) +
+        Implementation::arrayByteCount(state.simpleData) +
+        Implementation::arrayByteCount(state.backgroundBlurVertices) +
+        Implementation::arrayByteCount(state.backgroundBlurIndices) +
+        state.dynamicStyleStorage.size();
+}
+
+void BaseLayer::doCompact(const Containers::StridedArrayView1D<const UnsignedInt>& previousDataIds) {
+    State& state = static_cast<State&>(*_state);
+    for(std::size_t i = 0; i != previousDataIds.size(); ++i)
+        if(previousDataIds[i] != ~UnsignedInt{} && previousDataIds[i] != i)
+            state.data[i] = state.data[previousDataIds[i]];
+    arrayResize(state.data, NoInit, previousDataIds.size());
+    arrayShrink(state.data);
+    /* The views need to be updated as the shrink reallocated */
+    state.styles = stridedArrayView(state.data).slice(&Implementation::BaseLayerData::style);
+    state.calculatedStyles = stridedArrayView(state.data).slice(&Implementation::BaseLayerData::calculatedStyle);
+
+    /* Everything else is indexed by data ID or in draw order and the base
+       implementation marked all data as needing an update, so it's just
+       freed and regenerated in full in the next doUpdate() */
+    state.vertices = {};
+    state.indices = {};
+    state.vertexScratch = {};
+    state.modifiedDataIds = {};
+    state.dataNodeProperties = {};
+    state.dataClipRects = {};
+    state.simpleData = {};
+    state.vertexUpdateBegin = ~std::size_t{};
+    state.vertexUpdateEnd = 0;
+    state.dataNodePropertyUpdateBegin = ~std::size_t{};
+    state.dataNodePropertyUpdateEnd = 0;
+    state.dataClipRectUpdateBegin = ~std::size_t{};
+    state.dataClipRectUpdateEnd = 0;
+}
+
 void BaseLayer::doSetSize(const Vector2& size, const Vector2i& framebufferSize) {
     auto& state = static_cast<State&>(*_state);
     auto& sharedState = static_cast<Shared::State&>(state.shared);
@@ -540,6 +681,10 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
     CORRADE_ASSERT(sharedState.setStyleCalled,
         "Ui::BaseLayer::update(): no style data was set", );
 
+    /* With instanced quads there are no indices, the instance data are
+       directly in the draw order instead */
+    const bool instanced = sharedState.flags >= BaseLayerSharedFlag::InstancedQuads;
+
     /* Fill in indices in desired order if either the data themselves or the
        node order changed. Flattening the logic for less indentation, first the
        less-data-heavy case with just a single quad for every data but a more
@@ -547,7 +692,7 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
     const bool updateIndices =
         states >= LayerState::NeedsNodeOrderUpdate ||
         states >= LayerState::NeedsDataUpdate;
-    if(updateIndices && !(sharedState.flags >= BaseLayerSharedFlag::SubdividedQuads)) {
+    if(updateIndices && !instanced && !(sharedState.flags >= BaseLayerSharedFlag::SubdividedQuads)) {
         arrayResize(state.indices, NoInit, dataIds.size()*6);
         for(UnsignedInt i = 0; i != dataIds.size(); ++i) {
             const UnsignedInt vertexOffset = dataIds[i]*4;
@@ -662,14 +807,341 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
         states >= LayerState::NeedsNodeOffsetSizeUpdate ||
         states >= LayerState::NeedsNodeEnabledUpdate ||
         states >= LayerState::NeedsNodeOpacityUpdate ||
-        states >= LayerState::NeedsDataUpdate;
-    if(updateVertices && !(sharedState.flags >= BaseLayerSharedFlag::SubdividedQuads)) {
-        /* Resize the vertex array to fit all data, make a view on the common
-           type prefix */
+        states >= LayerState::NeedsDataUpdate ||
+        /* Instance data are in draw order, so they have to be regenerated
+           if the order changes */
+        (instanced && states >= LayerState::NeedsNodeOrderUpdate);
+
+    /* Resize the vertex array to fit all data. If the size changes, the whole
+       vertex data need to be updated. Otherwise remember previous vertex
+       contents of all data that get updated to find out what actually
+       changed. */
+    std::size_t dataVertexSize = 0;
+    bool compareVertices = false;
+    /* Data to generate the vertices for. All visible data by default, a
+       subset that was modified since last time if nothing else changed. */
+    Containers::StridedArrayView1D<const UnsignedInt> vertexDataIds = dataIds;
+    if(updateVertices && instanced) {
+        dataVertexSize = sharedState.flags & BaseLayerSharedFlag::Textured ?
+            sizeof(Implementation::BaseLayerTexturedInstance) :
+            sizeof(Implementation::BaseLayerInstance);
+
+        /* All instances are regenerated every time, so save all of them */
+        if(state.vertices.size() != dataIds.size()*dataVertexSize) {
+            arrayResize(state.vertices, NoInit, dataIds.size()*dataVertexSize);
+            state.vertexUpdateBegin = 0;
+            state.vertexUpdateEnd = state.vertices.size();
+        } else {
+            arrayResize(state.vertexScratch, NoInit, state.vertices.size());
+            Utility::copy(state.vertices, state.vertexScratch);
+            compareVertices = true;
+        }
+    } else if(updateVertices) {
+        if(sharedState.flags >= BaseLayerSharedFlag::SubdividedQuads)
+            dataVertexSize = 16*(sharedState.flags & BaseLayerSharedFlag::Textured ?
+                sizeof(Implementation::BaseLayerSubdividedTexturedVertex) :
+                sizeof(Implementation::BaseLayerSubdividedVertex));
+        else
+            dataVertexSize = 4*(sharedState.flags & BaseLayerSharedFlag::Textured ?
+                sizeof(Implementation::BaseLayerTexturedVertex) :
+                sizeof(Implementation::BaseLayerVertex));
+
+        if(state.vertices.size() != capacity()*dataVertexSize) {
+            arrayResize(state.vertices, NoInit, capacity()*dataVertexSize);
+            state.vertexUpdateBegin = 0;
+            state.vertexUpdateEnd = state.vertices.size();
+        } else {
+            /* Vertices are indexed by data ID, so if only the data themselves
+               changed and not node offsets, sizes, opacity, enablement or the
+               set of visible data, vertices of all data that weren't modified
+               stay the same and don't need to be regenerated. A change in the
+               shared style implies all data are marked as modified. With
+               node-relative positions the node opacity isn't baked into the
+               vertices but supplied together with the node offset, so a
+               change in it doesn't need the vertices regenerated either. */
+            LayerStates allDataStates =
+                LayerState::NeedsNodeOffsetSizeUpdate|
+                LayerState::NeedsNodeEnabledUpdate|
+                LayerState::NeedsNodeOrderUpdate|
+                LayerState::NeedsSharedDataUpdate;
+            if(!(sharedState.flags >= BaseLayerSharedFlag::NodeRelativePositions))
+                allDataStates |= LayerState::NeedsNodeOpacityUpdate;
+            if(!(states & allDataStates)) {
+                const Containers::BitArrayView modifiedData = modifiedDataMask();
+                arrayResize(state.modifiedDataIds, NoInit, 0);
+                for(const UnsignedInt dataId: dataIds)
+                    if(modifiedData[dataId])
+                        arrayAppend(state.modifiedDataIds, dataId);
+                vertexDataIds = Containers::arrayView(state.modifiedDataIds);
+            }
+
+            arrayResize(state.vertexScratch, NoInit, vertexDataIds.size()*dataVertexSize);
+            for(std::size_t i = 0; i != vertexDataIds.size(); ++i)
+                Utility::copy(state.vertices.sliceSize(vertexDataIds[i]*dataVertexSize, dataVertexSize),
+                              state.vertexScratch.sliceSize(i*dataVertexSize, dataVertexSize));
+            compareVertices = true;
+        }
+    }
+
+    /* Generate the vertices. Each data writes to a disjoint part of the
+       vertex array, so if there's an executor and enough data, the work is
+       split into tasks that can run in parallel. With instanced quads
+       everything is regenerated, with instances in draw order. */
+    if(updateVertices) {
+        const Containers::StridedArrayView1D<const UnsignedInt> taskDataIds = instanced ? dataIds : vertexDataIds;
+        if(state.vertexExecutor && taskDataIds.size() > Implementation::BaseLayerVertexTaskDataCount) {
+            struct TaskState {
+                BaseLayer& self;
+                const Containers::StridedArrayView1D<const UnsignedInt>& dataIds;
+                const Containers::StridedArrayView1D<const Vector2>& nodeOffsets;
+                const Containers::StridedArrayView1D<const Vector2>& nodeSizes;
+                const Containers::StridedArrayView1D<const Float>& nodeOpacities;
+            } taskState{*this, taskDataIds, nodeOffsets, nodeSizes, nodeOpacities};
+            state.vertexExecutor(UnsignedInt((taskDataIds.size() + Implementation::BaseLayerVertexTaskDataCount - 1)/Implementation::BaseLayerVertexTaskDataCount), [](void* taskStatePointer, UnsignedInt index) {
+                const TaskState& taskState = *static_cast<const TaskState*>(taskStatePointer);
+                const std::size_t begin = std::size_t{index}*Implementation::BaseLayerVertexTaskDataCount;
+                const std::size_t end = Math::min(begin + Implementation::BaseLayerVertexTaskDataCount, taskState.dataIds.size());
+                taskState.self.updateVerticesInternal(taskState.dataIds, begin, end, taskState.nodeOffsets, taskState.nodeSizes, taskState.nodeOpacities);
+            }, &taskState, state.vertexExecutorUserData);
+        } else updateVerticesInternal(taskDataIds, 0, taskDataIds.size(), nodeOffsets, nodeSizes, nodeOpacities);
+    }
+
+    /* Extend the updated vertex range with data whose vertices differ from
+       before */
+    if(compareVertices) for(std::size_t i = 0; i != vertexDataIds.size(); ++i) {
+        const std::size_t offset = (instanced ? i : vertexDataIds[i])*dataVertexSize;
+        if(std::memcmp(state.vertices.data() + offset, state.vertexScratch.data() + i*dataVertexSize, dataVertexSize) != 0) {
+            state.vertexUpdateBegin = Math::min(state.vertexUpdateBegin, offset);
+            state.vertexUpdateEnd = Math::max(state.vertexUpdateEnd, offset + dataVertexSize);
+        }
+    }
+
+    /* With node-relative positions, the node offsets and opacities are
+       supplied for every visible data separately. Again, if the size changes,
+       everything is updated, otherwise only the range of properties that
+       actually changed. Properties of data that aren't visible are left at
+       whatever they were before as they aren't used for anything. */
+    if(updateVertices && sharedState.flags >= BaseLayerSharedFlag::NodeRelativePositions) {
+        const std::size_t dataNodePropertyCount = (capacity() + Implementation::BaseLayerDataOffsetTextureWidth - 1)/Implementation::BaseLayerDataOffsetTextureWidth*Implementation::BaseLayerDataOffsetTextureWidth;
+        if(state.dataNodeProperties.size() != dataNodePropertyCount) {
+            arrayResize(state.dataNodeProperties, ValueInit, dataNodePropertyCount);
+            state.dataNodePropertyUpdateBegin = 0;
+            state.dataNodePropertyUpdateEnd = dataNodePropertyCount;
+        }
+
+        const Containers::StridedArrayView1D<const NodeHandle> nodes = this->nodes();
+        for(const UnsignedInt dataId: dataIds) {
+            const UnsignedInt nodeId = nodeHandleId(nodes[dataId]);
+            const Vector3 properties{nodeOffsets[nodeId], nodeOpacities[nodeId]};
+            if(state.dataNodeProperties[dataId] != properties) {
+                state.dataNodeProperties[dataId] = properties;
+                state.dataNodePropertyUpdateBegin = Math::min(state.dataNodePropertyUpdateBegin, std::size_t{dataId});
+                state.dataNodePropertyUpdateEnd = Math::max(state.dataNodePropertyUpdateEnd, std::size_t{dataId} + 1);
+            }
+        }
+    }
+
+    /* With shader clipping, the clip rect is supplied for every visible data
+       separately, as a min / max corner pair. Clip rects with a zero size
+       mean no clipping. They change only if the set of visible data, their
+       order or the node offsets / sizes change, all of which imply
+       NeedsNodeOrderUpdate. The changed range is tracked the same way as for
+       the node properties above. */
+    if((states >= LayerState::NeedsNodeOrderUpdate ||
+        states >= LayerState::NeedsDataUpdate) &&
+       sharedState.flags >= BaseLayerSharedFlag::ShaderClipping)
+    {
+        const std::size_t dataClipRectCount = (capacity() + Implementation::BaseLayerDataOffsetTextureWidth - 1)/Implementation::BaseLayerDataOffsetTextureWidth*Implementation::BaseLayerDataOffsetTextureWidth;
+        if(state.dataClipRects.size() != dataClipRectCount) {
+            arrayResize(state.dataClipRects, ValueInit, dataClipRectCount);
+            state.dataClipRectUpdateBegin = 0;
+            state.dataClipRectUpdateEnd = dataClipRectCount;
+        }
+
+        std::size_t clipDataOffset = 0;
+        for(std::size_t i = 0; i != clipRectIds.size(); ++i) {
+            const UnsignedInt clipRectId = clipRectIds[i];
+            const Vector2 min = clipRectOffsets[clipRectId];
+            const Vector2 max = min + clipRectSizes[clipRectId];
+            const Vector4 clipRect = clipRectSizes[clipRectId].isZero() ?
+                Vector4{-Constants::inf(), -Constants::inf(), Constants::inf(), Constants::inf()} :
+                Vector4{min.x(), min.y(), max.x(), max.y()};
+            for(const UnsignedInt dataId: dataIds.sliceSize(clipDataOffset, clipRectDataCounts[i])) {
+                if(state.dataClipRects[dataId] != clipRect) {
+                    state.dataClipRects[dataId] = clipRect;
+                    state.dataClipRectUpdateBegin = Math::min(state.dataClipRectUpdateBegin, std::size_t{dataId});
+                    state.dataClipRectUpdateEnd = Math::max(state.dataClipRectUpdateEnd, std::size_t{dataId} + 1);
+                }
+            }
+            clipDataOffset += clipRectDataCounts[i];
+        }
+        CORRADE_INTERNAL_ASSERT(clipDataOffset == dataIds.size());
+    }
+
+    /* With automatic shader variants, remember which visible data can be
+       drawn with the cheaper variant. It depends on the calculated style, the
+       custom outline width and the uniform values, which change with
+       NeedsDataUpdate (which is also set on a shared style change),
+       NeedsNodeEnabledUpdate or, for dynamic styles, NeedsCommonDataUpdate.
+       Data that became visible since last time are covered by
+       NeedsNodeOrderUpdate. */
+    if(sharedState.flags >= BaseLayerSharedFlag::AutomaticShaderVariants &&
+       (states >= LayerState::NeedsDataUpdate ||
+        states >= LayerState::NeedsNodeEnabledUpdate ||
+        states >= LayerState::NeedsNodeOrderUpdate ||
+        states >= LayerState::NeedsCommonDataUpdate))
+    {
+        if(state.simpleData.size() != capacity())
+            state.simpleData = Containers::BitArray{NoInit, capacity()};
+
+        for(const UnsignedInt dataId: dataIds) {
+            const Implementation::BaseLayerData& data = state.data[dataId];
+            /* For dynamic styles the uniform mapping is implicit, same as in
+               updateVerticesInternal() */
+            const bool simpleUniform = data.calculatedStyle < sharedState.styleCount ?
+                sharedState.simpleStyleUniforms[sharedState.styles[data.calculatedStyle].uniform] :
+                Implementation::isSimpleBaseLayerStyleUniform(state.dynamicStyleUniforms[data.calculatedStyle - sharedState.styleCount]);
+            state.simpleData.set(dataId, simpleUniform && data.outlineWidth.isZero());
+        }
+    }
+
+    /* Fill in quads for background blur. They're present only if the layer has
+       background blur (and thus compositing) enabled and need to be updated
+       only if the compositing rects actually changed */
+    if(states >= LayerState::NeedsCompositeOffsetSizeUpdate && sharedState.flags >= BaseLayerSharedFlag::BackgroundBlur) {
+        arrayResize(state.backgroundBlurVertices, NoInit, compositeRectOffsets.size()*4);
+        arrayResize(state.backgroundBlurIndices, NoInit, compositeRectOffsets.size()*6);
+
+        /* Expand the quads to include the total blur radius among all passes,
+           which is calculated as sqrt(passCount*radius*radius), plus extra
+           padding to match smoothness expansion of the rendered quads. The
+           radius is in pixels, convert it to match the [-1, +1] coordinates,
+           i.e. multiply by 2.
+
+           Note that both the `sharedState.backgroundBlurRadius` as well as
+           `sharedState.smoothness` are in pixels so they don't need any
+           additional adjustment, unlike above, where the smoothness is
+           converted to be UI-size-relative.
+
+           If the blur is downsampled, the blur radius in pixels is rounded up
+           to a multiple of the downsampling factor, and there's one more
+           downsampled pixel of padding so the bilinear upsampling doesn't
+           pick up texels outside of the blurred area. */
+        /** @todo exclude the cutoff from this? how does the sqrt count into
+            that? take a max of count*radiusWithCutoff and this? */
+        const UnsignedInt downsampling = sharedState.backgroundBlurDownsampling;
+        const Float blurRadius = (sharedState.backgroundBlurRadius + downsampling - 1)/downsampling*downsampling;
+        const Float upsamplingPadding = downsampling == 1 ? 0.0f : Float(downsampling);
+        const Vector2 blurRadiusPadding = (Math::sqrt(Float(state.backgroundBlurPassCount))*(blurRadius + sharedState.smoothness) + upsamplingPadding)*state.uiSize/Vector2{state.framebufferSize};
+
+        for(std::size_t i = 0; i != compositeRectOffsets.size(); ++i) {
+            const Vector2 min = compositeRectOffsets[i] - blurRadiusPadding;
+            const Vector2 max = compositeRectOffsets[i] + compositeRectSizes[i] + blurRadiusPadding;
+            const UnsignedInt vertexOffset = i*4;
+
+            /* 0---1 0---2 5
+               |   | |  / /|
+               |   | | / / |
+               |   | |/ /  |
+               2---3 1 3---4 */
+            for(UnsignedByte j = 0; j != 4; ++j)
+                /* ✨ */
+                state.backgroundBlurVertices[vertexOffset + j] = Math::lerp(min, max, BitVector2{j});
+
+            UnsignedInt indexOffset = i*6;
+            state.backgroundBlurIndices[indexOffset++] = vertexOffset + 0;
+            state.backgroundBlurIndices[indexOffset++] = vertexOffset + 2;
+            state.backgroundBlurIndices[indexOffset++] = vertexOffset + 1;
+            state.backgroundBlurIndices[indexOffset++] = vertexOffset + 2;
+            state.backgroundBlurIndices[indexOffset++] = vertexOffset + 3;
+            state.backgroundBlurIndices[indexOffset++] = vertexOffset + 1;
+        }
+    }
+
+    /* Sync the style update stamp to not have doState() return NeedsDataUpdate
+       / NeedsCommonDataUpdate again next time it's asked */
+    if(states >= LayerState::NeedsDataUpdate ||
+       states >= LayerState::NeedsCommonDataUpdate)
+        state.styleUpdateStamp = sharedState.styleUpdateStamp;
+}
+
+void BaseLayer::updateVerticesInternal(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const std::size_t begin, const std::size_t end, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities) {
+    auto& state = static_cast<State&>(*_state);
+    auto& sharedState = static_cast<const Shared::State&>(state.shared);
+    /* Mutually exclusive with instanced quads, so used only in the vertex
+       cases below */
+    const bool nodeRelative = sharedState.flags >= BaseLayerSharedFlag::NodeRelativePositions;
+
+    /* First the case with a single instance for every drawn data */
+    if(sharedState.flags >= BaseLayerSharedFlag::InstancedQuads) {
+        /* Make a view on the common type prefix */
+        const std::size_t typeSize = sharedState.flags & BaseLayerSharedFlag::Textured ?
+            sizeof(Implementation::BaseLayerTexturedInstance) :
+            sizeof(Implementation::BaseLayerInstance);
+        const Containers::StridedArrayView1D<Implementation::BaseLayerInstance> instances{
+            state.vertices,
+            reinterpret_cast<Implementation::BaseLayerInstance*>(state.vertices.data()),
+            state.vertices.size()/typeSize,
+            std::ptrdiff_t(typeSize)};
+
+        /* Convert smoothness from a pixel value to the UI coordinates */
+        const Float smoothness = sharedState.smoothness*(state.uiSize/Vector2{state.framebufferSize}).max();
+
+        /* Fill in quad positions, sizes and colors. The padding and
+           smoothness expansion is done the same way as in the non-instanced
+           case below. */
+        const Containers::StridedArrayView1D<const NodeHandle> nodes = this->nodes();
+        for(std::size_t i = begin; i != end; ++i) {
+            const UnsignedInt nodeId = nodeHandleId(nodes[dataIds[i]]);
+            const Implementation::BaseLayerData& data = state.data[dataIds[i]];
+
+            Vector4 padding = data.padding - Vector4{smoothness};
+            if(data.calculatedStyle < sharedState.styleCount)
+                padding += sharedState.styles[data.calculatedStyle].padding;
+            else {
+                CORRADE_INTERNAL_DEBUG_ASSERT(data.calculatedStyle < sharedState.styleCount + sharedState.dynamicStyleCount);
+                padding += state.dynamicStylePaddings[data.calculatedStyle - sharedState.styleCount];
+            }
+
+            const Vector2 offset = nodeOffsets[nodeId];
+            const Vector2 min = offset + padding.xy();
+            const Vector2 max = offset + nodeSizes[nodeId] - Math::gather<'z', 'w'>(padding);
+            Implementation::BaseLayerInstance& instance = instances[i];
+            instance.position = min;
+            instance.size = max - min;
+            instance.outlineWidth = data.outlineWidth;
+            instance.color = data.color*nodeOpacities[nodeId];
+            /* For dynamic styles the uniform mapping is implicit and they're
+               placed right after all non-dynamic styles */
+            instance.styleUniform = data.calculatedStyle < sharedState.styleCount ?
+                sharedState.styles[data.calculatedStyle].uniform :
+                sharedState.styleUniformCount + data.calculatedStyle - sharedState.styleCount;
+        }
+
+        /* Fill in also texture coordinate rectangles if enabled, again
+           matching the non-instanced case below */
+        if(sharedState.flags & BaseLayerSharedFlag::Textured) {
+            const Containers::ArrayView<Implementation::BaseLayerTexturedInstance> texturedInstances = Containers::arrayCast<Implementation::BaseLayerTexturedInstance>(instances).asContiguous();
+
+            for(std::size_t i = begin; i != end; ++i) {
+                const Implementation::BaseLayerData& data = state.data[dataIds[i]];
+
+                const Vector2 paddedQuadSizeWithoutSmoothness = instances[i].size - Vector2{2.0f*smoothness};
+                const Vector2 smoothnessExpansion = data.textureCoordinateSize*smoothness/paddedQuadSizeWithoutSmoothness*Vector2::yScale(-1.0f);
+
+                const Vector2 min = data.textureCoordinateOffset.xy() + Vector2::yAxis(data.textureCoordinateSize.y()) - smoothnessExpansion;
+                const Vector2 max = data.textureCoordinateOffset.xy() + Vector2::xAxis(data.textureCoordinateSize.x()) + smoothnessExpansion;
+                texturedInstances[i].textureCoordinateOffset = {min, data.textureCoordinateOffset.z()};
+                texturedInstances[i].textureCoordinateSize = max - min;
+            }
+        }
+
+    /* Then the case with four vertices for every data */
+    } else if(!(sharedState.flags >= BaseLayerSharedFlag::SubdividedQuads)) {
+        /* Make a view on the common type prefix */
         const std::size_t typeSize = sharedState.flags & BaseLayerSharedFlag::Textured ?
             sizeof(Implementation::BaseLayerTexturedVertex) :
             sizeof(Implementation::BaseLayerVertex);
-        arrayResize(state.vertices, NoInit, capacity()*4*typeSize);
         const Containers::StridedArrayView1D<Implementation::BaseLayerVertex> vertices{
             state.vertices,
             reinterpret_cast<Implementation::BaseLayerVertex*>(state.vertices.data()),
@@ -681,7 +1153,7 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
 
         /* Fill in quad corner positions and colors */
         const Containers::StridedArrayView1D<const NodeHandle> nodes = this->nodes();
-        for(const UnsignedInt dataId: dataIds) {
+        for(const UnsignedInt dataId: dataIds.slice(begin, end)) {
             const UnsignedInt nodeId = nodeHandleId(nodes[dataId]);
             const Implementation::BaseLayerData& data = state.data[dataId];
 
@@ -707,8 +1179,11 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
                |   |
                |   |
                |   |
-               2---3 */
-            const Vector2 offset = nodeOffsets[nodeId];
+               2---3
+
+               With node-relative positions the node offset is applied in the
+               shader instead */
+            const Vector2 offset = nodeRelative ? Vector2{} : nodeOffsets[nodeId];
             const Vector2 min = offset + padding.xy();
             const Vector2 max = offset + nodeSizes[nodeId] - Math::gather<'z', 'w'>(padding);
             const Vector2 sizeHalf = (max - min)*0.5f;
@@ -721,7 +1196,7 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
                 vertex.position = Math::lerp(min, max, BitVector2{i});
                 vertex.centerDistance = Math::lerp(sizeHalfNegative, sizeHalf, BitVector2{i});
                 vertex.outlineWidth = data.outlineWidth;
-                vertex.color = data.color*opacity;
+                vertex.color = data.color*(nodeRelative ? 1.0f : opacity);
                 /* For dynamic styles the uniform mapping is implicit and
                    they're placed right after all non-dynamic styles */
                 vertex.styleUniform = data.calculatedStyle < sharedState.styleCount ?
@@ -734,7 +1209,7 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
         if(sharedState.flags & BaseLayerSharedFlag::Textured) {
             const Containers::ArrayView<Implementation::BaseLayerTexturedVertex> texturedVertices = Containers::arrayCast<Implementation::BaseLayerTexturedVertex>(vertices).asContiguous();
 
-            for(const UnsignedInt dataId: dataIds) {
+            for(const UnsignedInt dataId: dataIds.slice(begin, end)) {
                 const Implementation::BaseLayerData& data = state.data[dataId];
 
                 /* Expand the texture coordinates to match the position
@@ -764,13 +1239,11 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
         }
 
     /* And then again the more data-heavy case with 9 quads for every data */
-    } else if(updateVertices && sharedState.flags >= BaseLayerSharedFlag::SubdividedQuads) {
-        /* Resize the vertex array to fit all data, make a view on the common type
-           prefix */
+    } else {
+        /* Make a view on the common type prefix */
         const std::size_t typeSize = sharedState.flags & BaseLayerSharedFlag::Textured ?
             sizeof(Implementation::BaseLayerSubdividedTexturedVertex) :
             sizeof(Implementation::BaseLayerSubdividedVertex);
-        arrayResize(state.vertices, NoInit, capacity()*16*typeSize);
         const Containers::StridedArrayView1D<Implementation::BaseLayerSubdividedVertex> vertices{
             state.vertices,
             reinterpret_cast<Implementation::BaseLayerSubdividedVertex*>(state.vertices.data()),
@@ -792,7 +1265,7 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
             |   |   |   |
             8---9---13-12 */
         const Containers::StridedArrayView1D<const NodeHandle> nodes = this->nodes();
-        for(const UnsignedInt dataId: dataIds) {
+        for(const UnsignedInt dataId: dataIds.slice(begin, end)) {
             const UnsignedInt nodeId = nodeHandleId(nodes[dataId]);
             const Implementation::BaseLayerData& data = state.data[dataId];
 
@@ -801,7 +1274,7 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
             for(std::size_t i = 0; i != 16; ++i) {
                 Implementation::BaseLayerSubdividedVertex& vertex = vertices[dataId*16 + i];
 
-                vertex.color = data.color*opacity;
+                vertex.color = data.color*(nodeRelative ? 1.0f : opacity);
                 /* For dynamic styles the uniform mapping is implicit and
                    they're placed right after all non-dynamic styles */
                 vertex.styleUniform = data.calculatedStyle < sharedState.styleCount ?
@@ -824,7 +1297,7 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
 
             /* All four vertices in each corner get set to the same position
                and center distance */
-            const Vector2 offset = nodeOffsets[nodeId];
+            const Vector2 offset = nodeRelative ? Vector2{} : nodeOffsets[nodeId];
             const Vector2 min = offset + padding.xy();
             const Vector2 max = offset + nodeSizes[nodeId] - Math::gather<'z', 'w'>(padding);
             const Float sizeHalfY = (max.y() - min.y())*0.5f;
@@ -859,7 +1332,7 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
         if(sharedState.flags & BaseLayerSharedFlag::Textured) {
             const Containers::ArrayView<Implementation::BaseLayerSubdividedTexturedVertex> texturedVertices = Containers::arrayCast<Implementation::BaseLayerSubdividedTexturedVertex>(vertices).asContiguous();
 
-            for(const UnsignedInt dataId: dataIds) {
+            for(const UnsignedInt dataId: dataIds.slice(begin, end)) {
                 const Implementation::BaseLayerData& data = state.data[dataId];
 
                 /* The texture coordinates are Y-flipped compared to the
@@ -896,57 +1369,6 @@ void BaseLayer::doUpdate(const LayerStates states, const Containers::StridedArra
             }
         }
     }
-
-    /* Fill in quads for background blur. They're present only if the layer has
-       background blur (and thus compositing) enabled and need to be updated
-       only if the compositing rects actually changed */
-    if(states >= LayerState::NeedsCompositeOffsetSizeUpdate && sharedState.flags >= BaseLayerSharedFlag::BackgroundBlur) {
-        arrayResize(state.backgroundBlurVertices, NoInit, compositeRectOffsets.size()*4);
-        arrayResize(state.backgroundBlurIndices, NoInit, compositeRectOffsets.size()*6);
-
-        /* Expand the quads to include the total blur radius among all passes,
-           which is calculated as sqrt(passCount*radius*radius), plus extra
-           padding to match smoothness expansion of the rendered quads. The
-           radius is in pixels, convert it to match the [-1, +1] coordinates,
-           i.e. multiply by 2.
-
-           Note that both the `sharedState.backgroundBlurRadius` as well as
-           `sharedState.smoothness` are in pixels so they don't need any
-           additional adjustment, unlike above, where the smoothness is
-           converted to be UI-size-relative. */
-        /** @todo exclude the cutoff from this? how does the sqrt count into
-            that? take a max of count*radiusWithCutoff and this? */
-        const Vector2 blurRadiusPadding = Math::sqrt(Float(state.backgroundBlurPassCount))*(sharedState.backgroundBlurRadius + sharedState.smoothness)*state.uiSize/Vector2{state.framebufferSize};
-
-        for(std::size_t i = 0; i != compositeRectOffsets.size(); ++i) {
-            const Vector2 min = compositeRectOffsets[i] - blurRadiusPadding;
-            const Vector2 max = compositeRectOffsets[i] + compositeRectSizes[i] + blurRadiusPadding;
-            const UnsignedInt vertexOffset = i*4;
-
-            /* 0---1 0---2 5
-               |   | |  / /|
-               |   | | / / |
-               |   | |/ /  |
-               2---3 1 3---4 */
-            for(UnsignedByte j = 0; j != 4; ++j)
-                /* ✨ */
-                state.backgroundBlurVertices[vertexOffset + j] = Math::lerp(min, max, BitVector2{j});
-
-            UnsignedInt indexOffset = i*6;
-            state.backgroundBlurIndices[indexOffset++] = vertexOffset + 0;
-            state.backgroundBlurIndices[indexOffset++] = vertexOffset + 2;
-            state.backgroundBlurIndices[indexOffset++] = vertexOffset + 1;
-            state.backgroundBlurIndices[indexOffset++] = vertexOffset + 2;
-            state.backgroundBlurIndices[indexOffset++] = vertexOffset + 3;
-            state.backgroundBlurIndices[indexOffset++] = vertexOffset + 1;
-        }
-    }
-
-    /* Sync the style update stamp to not have doState() return NeedsDataUpdate
-       / NeedsCommonDataUpdate again next time it's asked */
-    if(states >= LayerState::NeedsDataUpdate ||
-       states >= LayerState::NeedsCommonDataUpdate)
-        state.styleUpdateStamp = sharedState.styleUpdateStamp;
 }
 
 }}
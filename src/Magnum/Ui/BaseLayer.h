@@ -455,6 +455,49 @@ class MAGNUM_UI_EXPORT BaseLayer: public AbstractVisualLayer {
          */
         BaseLayer& setBackgroundBlurPassCount(UnsignedInt count);
 
+        /**
+         * @brief Vertex generation executor
+         * @m_since_latest
+         *
+         * @cpp nullptr @ce by default, meaning vertices are generated
+         * sequentially.
+         * @see @ref vertexExecutorUserData(), @ref setVertexExecutor()
+         */
+        auto vertexExecutor() const -> void(*)(UnsignedInt, void(*)(void*, UnsignedInt), void*, void*);
+
+        /**
+         * @brief Vertex generation executor user data
+         * @m_since_latest
+         *
+         * Contents of the @p userData parameter passed to
+         * @ref setVertexExecutor().
+         */
+        void* vertexExecutorUserData() const;
+
+        /**
+         * @brief Set a vertex generation executor
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * By default, vertex data for all quads that need an update are
+         * generated one after another in @ref update(). If an @p executor is
+         * set and there's more than 1024 quads to update, the work is split
+         * into batches of 1024 quads and the @p executor is called with the
+         * batch count, a @p task function, its @p taskState and the
+         * @p userData pointer passed to this function. The executor is
+         * expected to call @p task with @p taskState and each index in range
+         * @cpp [0, count) @ce exactly once, in an arbitrary order and possibly
+         * from multiple threads concurrently, and return only after all calls
+         * finished. Each batch writes to a disjoint range of the vertex data,
+         * the result is the same as with the sequential generation.
+         *
+         * Set the @p executor to @cpp nullptr @ce to go back to the default
+         * sequential behavior.
+         * @see @ref AbstractUserInterface::setLayerUpdateExecutor(),
+         *      @ref TextLayer::setShapeExecutor()
+         */
+        BaseLayer& setVertexExecutor(void(*executor)(UnsignedInt count, void(*task)(void* taskState, UnsignedInt index), void* taskState, void* userData), void* userData = nullptr);
+
         /**
          * @brief Assign a style animator to this layer
          * @return Reference to self (for method chaining)
@@ -575,6 +618,21 @@ class MAGNUM_UI_EXPORT BaseLayer: public AbstractVisualLayer {
             return create(UnsignedInt(style), node);
         }
 
+        /**
+         * @brief Create multiple quads
+         * @param[in] style     Style index
+         * @param[in] nodes     Nodes to attach to
+         * @param[out] handles  Where to put new data handles
+         * @m_since_latest
+         *
+         * Equivalent to calling @ref create(UnsignedInt, NodeHandle) for
+         * each item in @p nodes, but with the internal storage grown just
+         * once. Expects that @p style is less than
+         * @ref Shared::totalStyleCount() and that the @p nodes and
+         * @p handles views have the same size.
+         */
+        void create(UnsignedInt style, const Containers::StridedArrayView1D<const NodeHandle>& nodes, const Containers::StridedArrayView1D<DataHandle>& handles);
+
         /**
          * @brief Remove a quad
          *
@@ -593,6 +651,16 @@ class MAGNUM_UI_EXPORT BaseLayer: public AbstractVisualLayer {
             AbstractVisualLayer::remove(handle);
         }
 
+        /**
+         * @brief Remove multiple quads
+         * @m_since_latest
+         *
+         * Delegates to @ref AbstractLayer::remove(const Containers::StridedArrayView1D<const DataHandle>&).
+         */
+        void remove(const Containers::StridedArrayView1D<const DataHandle>& handles) {
+            AbstractVisualLayer::remove(handles);
+        }
+
         /**
          * @brief Quad custom base color
          *
@@ -853,6 +921,9 @@ class MAGNUM_UI_EXPORT BaseLayer: public AbstractVisualLayer {
 
         LayerStates doState() const override;
         void doSetSize(const Vector2& size, const Vector2i& framebufferSize) override;
+        void doReserve(std::size_t capacity) override;
+        void doMemoryUsage(MemoryUsage& usage) const override;
+        void doCompact(const Containers::StridedArrayView1D<const UnsignedInt>& previousDataIds) override;
         void doUpdate(LayerStates states, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes) override;
 
     private:
@@ -862,6 +933,7 @@ class MAGNUM_UI_EXPORT BaseLayer: public AbstractVisualLayer {
         MAGNUM_UI_LOCAL Vector3 textureCoordinateOffsetInternal(UnsignedInt id) const;
         MAGNUM_UI_LOCAL Vector2 textureCoordinateSizeInternal(UnsignedInt id) const;
         MAGNUM_UI_LOCAL void setTextureCoordinatesInternal(UnsignedInt id, const Vector3& offset, const Vector2& size);
+        MAGNUM_UI_LOCAL void updateVerticesInternal(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, std::size_t begin, std::size_t end, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities);
 
         /* Can't be MAGNUM_UI_LOCAL otherwise deriving from this class in
            tests causes linker errors */
@@ -876,7 +948,7 @@ class MAGNUM_UI_EXPORT BaseLayer: public AbstractVisualLayer {
     @ref BaseLayer::Shared::Configuration::setFlags(),
     @ref BaseLayer::Shared::flags()
 */
-enum class BaseLayerSharedFlag: UnsignedByte {
+enum class BaseLayerSharedFlag: UnsignedShort {
     /**
      * Textured drawing. If enabled, the @ref BaseLayerStyleUniform::topColor
      * and @relativeref{BaseLayerStyleUniform,bottomColor} is multiplied with a
@@ -913,7 +985,14 @@ enum class BaseLayerSharedFlag: UnsignedByte {
      * Use @ref BaseLayer::Shared::Configuration::setBackgroundBlurRadius() and
      * @ref BaseLayer::setBackgroundBlurPassCount() to control the blur radius
      * and @ref BaseLayerCommonStyleUniform::backgroundBlurAlpha to achieve
-     * additional effects.
+     * additional effects. Use
+     * @ref BaseLayer::Shared::Configuration::setBackgroundBlurDownsampling()
+     * to perform the blur at a lower resolution for less GPU load.
+     *
+     * If the application calls @ref RendererGL::setCompositingFramebufferUnchanged()
+     * before drawing the UI, the @ref BaseLayerGL skips blurring quads that
+     * were blurred with the same framebuffer contents in the previous frame
+     * and weren't blurred over since, reusing the previous result instead.
      *
      * @see @ref BaseLayerSharedFlag::TextureMask
      */
@@ -994,9 +1073,122 @@ enum class BaseLayerSharedFlag: UnsignedByte {
      * wasn't bottlenecked by fragment shading.
      *
      * Mutually exclusive with the @ref BaseLayerSharedFlag::NoRoundedCorners
-     * and @relativeref{BaseLayerSharedFlag,NoOutline} optimizations.
+     * and @relativeref{BaseLayerSharedFlag,NoOutline} optimizations and
+     * with @ref BaseLayerSharedFlag::InstancedQuads.
      */
     SubdividedQuads = 1 << 5,
+
+    /**
+     * Instead of four vertices and six indices for every quad, generate just
+     * a single instance record containing the quad position, size, color,
+     * outline width, style and texture coordinate rectangle, and let the
+     * vertex shader expand it to the quad corners. Reduces the amount of data
+     * uploaded to the GPU roughly four times, and as the records are
+     * generated in the draw order, no index buffer is needed either.
+     *
+     * Mutually exclusive with @ref BaseLayerSharedFlag::SubdividedQuads. In
+     * @ref BaseLayerGL the instanced draws need to start at a particular
+     * instance offset, which is supported only on desktop GL.
+     * @requires_gl42 Extension @gl_extension{ARB,base_instance} in
+     *      @ref BaseLayerGL
+     * @requires_gl Instanced drawing with a base instance offset is not
+     *      available in OpenGL ES or WebGL in @ref BaseLayerGL.
+     * @m_since_latest
+     */
+    InstancedQuads = 1 << 6,
+
+    /**
+     * Generate vertex positions relative to the node the data is attached to
+     * and supply the node offsets and opacities separately, as a single value
+     * per data. When only node offsets change, such as when scrolling or
+     * dragging a node with many data attached, the vertex data stay the same
+     * and only the per-data offsets get uploaded to the GPU, reducing the
+     * upload from four or sixteen vertices to a single three-component vector
+     * for each data. Node opacity changes, such as when fading a node in or
+     * out, additionally don't need the vertex data to be regenerated at all.
+     * In @ref BaseLayerGL the offsets and opacities are stored in a texture
+     * that's indexed using the vertex ID.
+     *
+     * Mutually exclusive with @ref BaseLayerSharedFlag::InstancedQuads, which
+     * already reduces the vertex data to a single record for each data but
+     * has to regenerate them on every draw order change. In @ref BaseLayerGL
+     * it can't be combined with
+     * @ref BaseLayerGL::setVertexBufferStreaming(), as the base vertex offset
+     * used there changes the vertex ID.
+     * @m_since_latest
+     */
+    NodeRelativePositions = 1 << 7,
+
+    /**
+     * Clip the data in the fragment shader instead of using a scissor
+     * rectangle. Each data gets the clip rectangle of the node it's attached
+     * to supplied separately, and the fragment shader discards everything
+     * outside of it. That allows the whole draw range to be drawn with a
+     * single draw call no matter how many different clip rectangles there
+     * are, instead of issuing a separate scissored draw for each. In
+     * @ref BaseLayerGL the clip rectangles are stored in a texture that's
+     * indexed using the vertex ID, and the layer doesn't advertise
+     * @ref LayerFeature::DrawUsesScissor.
+     *
+     * Mutually exclusive with @ref BaseLayerSharedFlag::InstancedQuads. In
+     * @ref BaseLayerGL it can't be combined with
+     * @ref BaseLayerGL::setVertexBufferStreaming(), as the base vertex offset
+     * used there changes the vertex ID.
+     * @m_since_latest
+     */
+    ShaderClipping = 1 << 8,
+
+    /**
+     * Automatically draw data that don't need an outline or rounded corners
+     * with a cheaper shader variant. Compared to
+     * @ref BaseLayerSharedFlag::NoOutline and
+     * @relativeref{BaseLayerSharedFlag,NoRoundedCorners}, which apply to the
+     * whole layer, the decision is made for each data separately, based on
+     * whether the style uniform it uses has a zero
+     * @ref BaseLayerStyleUniform::outlineWidth,
+     * @relativeref{BaseLayerStyleUniform,cornerRadius} and
+     * @relativeref{BaseLayerStyleUniform,innerOutlineCornerRadius} and
+     * whether the custom outline width set with @ref BaseLayer::setOutlineWidth()
+     * is zero as well. In @ref BaseLayerGL, consecutive runs of such data in
+     * the draw order are then drawn with a variant of the shader that has
+     * both features disabled, while the rest is drawn with the full shader.
+     * To avoid excessive shader switching, short runs inside a draw are drawn
+     * with the full shader as well.
+     *
+     * The variant shader is compiled in addition to the full one, so it only
+     * makes sense to enable this flag if a large portion of the data doesn't
+     * need an outline or rounded corners, but a few do. Mutually exclusive
+     * with @ref BaseLayerSharedFlag::SubdividedQuads, which doesn't have
+     * cheaper variants, and has no effect if both
+     * @ref BaseLayerSharedFlag::NoOutline and
+     * @relativeref{BaseLayerSharedFlag,NoRoundedCorners} are enabled already.
+     * @m_since_latest
+     */
+    AutomaticShaderVariants = 1 << 9,
+
+    /**
+     * Store the vertex data on the GPU in a compact format. Positions, center
+     * distances and outline widths are stored as 16-bit fixed-point values
+     * relative to the UI size, texture coordinates as 16-bit fixed-point
+     * values and the color as 8-bit normalized, halving the vertex memory
+     * and the amount of data uploaded to the GPU. The layer itself still
+     * generates the vertex data as floats, the conversion is done by
+     * @ref BaseLayerGL on upload.
+     *
+     * The format can represent positions in the
+     * @f$ [-2, 2) @f$ multiple of the UI size with a precision of
+     * @f$ \frac{1}{16384} @f$ of the UI size, anything outside is clamped.
+     * Similarly, color values outside of the @f$ [0, 1] @f$ range are
+     * clamped, which means it isn't suitable for HDR colors. Because the
+     * fixed-point values depend on the UI size, the whole vertex data get
+     * uploaded again on every UI size change.
+     *
+     * Mutually exclusive with @ref BaseLayerSharedFlag::SubdividedQuads and
+     * @relativeref{BaseLayerSharedFlag,InstancedQuads}, only the default
+     * four-vertex quads have a compact variant.
+     * @m_since_latest
+     */
+    CompactVertices = 1 << 10,
 };
 
 /**
@@ -1270,12 +1462,42 @@ class MAGNUM_UI_EXPORT BaseLayer::Shared::Configuration {
          */
         Configuration& setBackgroundBlurRadius(UnsignedInt radius, Float cutoff = 0.5f/255.0f);
 
+        /**
+         * @brief Background blur downsampling factor
+         * @m_since_latest
+         */
+        UnsignedInt backgroundBlurDownsampling() const {
+            return _backgroundBlurDownsampling;
+        }
+
+        /**
+         * @brief Set background blur downsampling factor
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * Expects that @p factor is @cpp 1 @ce, @cpp 2 @ce or @cpp 4 @ce. If
+         * greater than @cpp 1 @ce, the blur is performed at a half or a
+         * quarter of the framebuffer resolution, with the
+         * @ref setBackgroundBlurRadius() divided by the factor and rounded
+         * up, and the result is bilinearly upsampled when drawing. This
+         * reduces the fill rate and the number of texture samples by a factor
+         * of @f$ f^3 @f$ at the cost of less detail in the blurred image,
+         * which is usually not noticeable with larger blur radii. With a
+         * factor of @cpp 4 @ce, high-frequency content in the framebuffer may
+         * however cause slight aliasing, as the first blur pass samples it
+         * with just bilinear filtering.
+         *
+         * Initial value is @cpp 1 @ce, i.e. no downsampling.
+         */
+        Configuration& setBackgroundBlurDownsampling(UnsignedInt factor);
+
     private:
         UnsignedInt _styleUniformCount, _styleCount;
         UnsignedInt _dynamicStyleCount = 0;
         BaseLayerSharedFlags _flags;
         UnsignedInt _backgroundBlurRadius = 4;
         Float _backgroundBlurCutoff = 0.5f/255.0f;
+        UnsignedInt _backgroundBlurDownsampling = 1;
 };
 
 inline BaseLayer::Shared& BaseLayer::shared() {
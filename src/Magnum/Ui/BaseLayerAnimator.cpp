@@ -67,22 +67,39 @@ Debug& operator<<(Debug& debug, const BaseLayerStyleAnimations value) {
 
 namespace {
 
-struct Animation {
-    /* As the Animation entries get recycled, all fields have to be overwritten
-       always, thus there's no point in initializing them on the first ever
-       construction either */
-    BaseLayerStyleUniform sourceUniform{NoInit}, targetUniform{NoInit};
-    Vector4 sourcePadding{NoInit}, targetPadding{NoInit};
-    UnsignedInt targetStyle, dynamicStyle;
-    bool uniformDifferent;
-    /* 3/7 bytes free */
-    Float(*easing)(Float);
-};
+/* The uniform consists of just colors and four-component vectors, so it can
+   be interpolated as a flat array of floats, which the compiler can
+   vectorize */
+static_assert(sizeof(BaseLayerStyleUniform) == 24*sizeof(Float),
+    "expected BaseLayerStyleUniform to be just floats");
+
+void lerpStyleUniformInto(const BaseLayerStyleUniform& source, const BaseLayerStyleUniform& target, const Float factor, BaseLayerStyleUniform& out) {
+    const Float* const sourceData = reinterpret_cast<const Float*>(&source);
+    const Float* const targetData = reinterpret_cast<const Float*>(&target);
+    Float* const outData = reinterpret_cast<Float*>(&out);
+    for(std::size_t i = 0; i != sizeof(BaseLayerStyleUniform)/sizeof(Float); ++i)
+        outData[i] = Math::lerp(sourceData[i], targetData[i], factor);
+}
 
 }
 
 struct BaseLayerStyleAnimator::State: AbstractVisualLayerStyleAnimator::State {
-    Containers::Array<Animation> animations;
+    /* Animation properties, with each in a separate array so advance() can
+       process them in batches over contiguous memory. The targetStyles and
+       dynamicStyles views in the base point to targetStyleStorage and
+       dynamicStyleStorage. As the entries get recycled, all fields have to be
+       overwritten always, thus there's no point in initializing them on the
+       first ever construction either. */
+    Containers::Array<BaseLayerStyleUniform> sourceUniforms, targetUniforms;
+    Containers::Array<Vector4> sourcePaddings, targetPaddings;
+    Containers::Array<UnsignedInt> targetStyleStorage, dynamicStyleStorage;
+    Containers::Array<bool> uniformDifferent;
+    Containers::Array<Float(*)(Float)> easings;
+
+    /* IDs and eased factors of animations to interpolate in advance(), kept
+       across calls to avoid allocating every time */
+    Containers::Array<UnsignedInt> advanceIds;
+    Containers::Array<Float> advanceFactors;
 };
 
 BaseLayerStyleAnimator::BaseLayerStyleAnimator(AnimatorHandle handle): AbstractVisualLayerStyleAnimator{handle, Containers::pointer<State>()} {}
@@ -136,28 +153,34 @@ void BaseLayerStyleAnimator::createInternal(const AnimationHandle handle, const
         "Ui::BaseLayerStyleAnimator::create(): easing is null", );
 
     const UnsignedInt id = animationHandleId(handle);
-    if(id >= state.animations.size()) {
-        arrayResize(state.animations, NoInit, id + 1);
-        state.targetStyles = stridedArrayView(state.animations).slice(&Animation::targetStyle);
-        state.dynamicStyles = stridedArrayView(state.animations).slice(&Animation::dynamicStyle);
+    if(id >= state.easings.size()) {
+        arrayResize(state.sourceUniforms, NoInit, id + 1);
+        arrayResize(state.targetUniforms, NoInit, id + 1);
+        arrayResize(state.sourcePaddings, NoInit, id + 1);
+        arrayResize(state.targetPaddings, NoInit, id + 1);
+        arrayResize(state.targetStyleStorage, NoInit, id + 1);
+        arrayResize(state.dynamicStyleStorage, NoInit, id + 1);
+        arrayResize(state.uniformDifferent, NoInit, id + 1);
+        arrayResize(state.easings, NoInit, id + 1);
+        state.targetStyles = state.targetStyleStorage;
+        state.dynamicStyles = state.dynamicStyleStorage;
     }
-    Animation& animation = state.animations[id];
-    animation.targetStyle = targetStyle;
-    animation.dynamicStyle = ~UnsignedInt{};
-    animation.easing = easing;
+    state.targetStyleStorage[id] = targetStyle;
+    state.dynamicStyleStorage[id] = ~UnsignedInt{};
+    state.easings[id] = easing;
 
     const Implementation::BaseLayerStyle& sourceStyleData = layerSharedState.styles[sourceStyle];
     const Implementation::BaseLayerStyle& targetStyleData = layerSharedState.styles[targetStyle];
-    animation.sourcePadding = sourceStyleData.padding;
-    animation.targetPadding = targetStyleData.padding;
+    state.sourcePaddings[id] = sourceStyleData.padding;
+    state.targetPaddings[id] = targetStyleData.padding;
 
     /* Remember also if the actual uniform ID is different, if not, we don't
        need to interpolate (or upload) it. The uniform *data* may still be the
        same even if the ID is different, but checking for that is too much work
        and any reasonable style should deduplicate those anyway. */
-    animation.sourceUniform = layerSharedState.styleUniforms[sourceStyleData.uniform];
-    animation.targetUniform = layerSharedState.styleUniforms[targetStyleData.uniform];
-    animation.uniformDifferent = sourceStyleData.uniform != targetStyleData.uniform;
+    state.sourceUniforms[id] = layerSharedState.styleUniforms[sourceStyleData.uniform];
+    state.targetUniforms[id] = layerSharedState.styleUniforms[targetStyleData.uniform];
+    state.uniformDifferent[id] = sourceStyleData.uniform != targetStyleData.uniform;
 }
 
 void BaseLayerStyleAnimator::remove(const AnimationHandle handle) {
@@ -173,41 +196,45 @@ void BaseLayerStyleAnimator::remove(const AnimatorDataHandle handle) {
 auto BaseLayerStyleAnimator::easing(const AnimationHandle handle) const -> Float(*)(Float) {
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::BaseLayerStyleAnimator::easing(): invalid handle" << handle, {});
-    return static_cast<const State&>(*_state).animations[animationHandleId(handle)].easing;
+    return static_cast<const State&>(*_state).easings[animationHandleId(handle)];
 }
 
 auto BaseLayerStyleAnimator::easing(const AnimatorDataHandle handle) const -> Float(*)(Float) {
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::BaseLayerStyleAnimator::easing(): invalid handle" << handle, {});
-    return static_cast<const State&>(*_state).animations[animatorDataHandleId(handle)].easing;
+    return static_cast<const State&>(*_state).easings[animatorDataHandleId(handle)];
 }
 
 Containers::Pair<BaseLayerStyleUniform, BaseLayerStyleUniform> BaseLayerStyleAnimator::uniforms(const AnimationHandle handle) const {
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::BaseLayerStyleAnimator::uniforms(): invalid handle" << handle, {});
-    const Animation& animation = static_cast<const State&>(*_state).animations[animationHandleId(handle)];
-    return {animation.sourceUniform, animation.targetUniform};
+    const State& state = static_cast<const State&>(*_state);
+    const UnsignedInt id = animationHandleId(handle);
+    return {state.sourceUniforms[id], state.targetUniforms[id]};
 }
 
 Containers::Pair<BaseLayerStyleUniform, BaseLayerStyleUniform> BaseLayerStyleAnimator::uniforms(const AnimatorDataHandle handle) const {
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::BaseLayerStyleAnimator::uniforms(): invalid handle" << handle, {});
-    const Animation& animation = static_cast<const State&>(*_state).animations[animatorDataHandleId(handle)];
-    return {animation.sourceUniform, animation.targetUniform};
+    const State& state = static_cast<const State&>(*_state);
+    const UnsignedInt id = animatorDataHandleId(handle);
+    return {state.sourceUniforms[id], state.targetUniforms[id]};
 }
 
 Containers::Pair<Vector4, Vector4> BaseLayerStyleAnimator::paddings(const AnimationHandle handle) const {
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::BaseLayerStyleAnimator::paddings(): invalid handle" << handle, {});
-    const Animation& animation = static_cast<const State&>(*_state).animations[animationHandleId(handle)];
-    return {animation.sourcePadding, animation.targetPadding};
+    const State& state = static_cast<const State&>(*_state);
+    const UnsignedInt id = animationHandleId(handle);
+    return {state.sourcePaddings[id], state.targetPaddings[id]};
 }
 
 Containers::Pair<Vector4, Vector4> BaseLayerStyleAnimator::paddings(const AnimatorDataHandle handle) const {
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::BaseLayerStyleAnimator::paddings(): invalid handle" << handle, {});
-    const Animation& animation = static_cast<const State&>(*_state).animations[animatorDataHandleId(handle)];
-    return {animation.sourcePadding, animation.targetPadding};
+    const State& state = static_cast<const State&>(*_state);
+    const UnsignedInt id = animatorDataHandleId(handle);
+    return {state.sourcePaddings[id], state.targetPaddings[id]};
 }
 
 BaseLayerStyleAnimations BaseLayerStyleAnimator::advance(const Containers::BitArrayView active, const Containers::StridedArrayView1D<const Float>& factors, const Containers::BitArrayView remove, const Containers::ArrayView<BaseLayerStyleUniform> dynamicStyleUniforms, const Containers::StridedArrayView1D<Vector4>& dynamicStylePaddings, const Containers::StridedArrayView1D<UnsignedInt>& dataStyles) {
@@ -226,12 +253,21 @@ BaseLayerStyleAnimations BaseLayerStyleAnimator::advance(const Containers::BitAr
     const BaseLayer::Shared::State& layerSharedState = static_cast<const BaseLayer::Shared::State&>(*state.layerSharedState);
     const Containers::StridedArrayView1D<const LayerDataHandle> layerData = this->layerData();
 
+    /* Make sure the scratch arrays are large enough for all animations */
+    if(state.advanceIds.size() < capacity()) {
+        arrayResize(state.advanceIds, NoInit, capacity());
+        arrayResize(state.advanceFactors, NoInit, capacity());
+    }
+
+    /* 1. Go through all active animations, process the ones that are
+       scheduled for removal, allocate dynamic styles for the running ones and
+       put them to a list to be interpolated below */
     BaseLayerStyleAnimations animations;
+    std::size_t count = 0;
     /** @todo some way to iterate set bits */
     for(std::size_t i = 0; i != active.size(); ++i) {
         if(!active[i]) continue;
 
-        Animation& animation = state.animations[i];
         /* The handle is assumed to be valid if not null, i.e. that appropriate
            dataClean() got called before advance() */
         const LayerDataHandle data = layerData[i];
@@ -243,7 +279,7 @@ BaseLayerStyleAnimations BaseLayerStyleAnimator::advance(const Containers::BitAr
         if(remove[i]) {
             CORRADE_INTERNAL_ASSERT(factors[i] == 1.0f);
             if(data != LayerDataHandle::Null) {
-                dataStyles[layerDataHandleId(data)] = animation.targetStyle;
+                dataStyles[layerDataHandleId(data)] = state.targetStyleStorage[i];
                 animations |= BaseLayerStyleAnimation::Style;
             }
             continue;
@@ -253,7 +289,8 @@ BaseLayerStyleAnimations BaseLayerStyleAnimator::advance(const Containers::BitAr
            and switch to it. Doing it here instead of in create() avoids
            unnecessary pressure on peak used count of dynamic styles,
            especially when there's a lot of animations scheduled. */
-        if(animation.dynamicStyle == ~UnsignedInt{}) {
+        UnsignedInt& dynamicStyle = state.dynamicStyleStorage[i];
+        if(dynamicStyle == ~UnsignedInt{}) {
             /* If dynamic style allocation fails (for example because there's
                too many animations running at the same time), do nothing -- the
                data stays at the original style, causing no random visual
@@ -269,10 +306,10 @@ BaseLayerStyleAnimations BaseLayerStyleAnimator::advance(const Containers::BitAr
             const Containers::Optional<UnsignedInt> style = state.layer->allocateDynamicStyle(animationHandle(handle(), i, generations()[i]));
             if(!style)
                 continue;
-            animation.dynamicStyle = *style;
+            dynamicStyle = *style;
 
             if(data != LayerDataHandle::Null) {
-                dataStyles[layerDataHandleId(data)] = layerSharedState.styleCount + animation.dynamicStyle;
+                dataStyles[layerDataHandleId(data)] = layerSharedState.styleCount + dynamicStyle;
                 animations |= BaseLayerStyleAnimation::Style;
                 /* If the uniform IDs are the same between the source and
                    target style, the uniform interpolation below won't happen.
@@ -282,36 +319,42 @@ BaseLayerStyleAnimations BaseLayerStyleAnimator::advance(const Containers::BitAr
             }
         }
 
-        const Float factor = animation.easing(factors[i]);
-
-        /* Interpolate the uniform. If the source and target uniforms were the
-           same, just copy one of them and don't report that the uniforms got
-           changed. The only exception is the first ever switch to the dynamic
-           uniform in which case the data has to be uploaded. That's handled in
-           the animation.styleDynamic allocation above. */
-        if(animation.uniformDifferent) {
-            BaseLayerStyleUniform uniform{NoInit};
-            #define _c(member) uniform.member = Math::lerp(             \
-                animation.sourceUniform.member,                         \
-                animation.targetUniform.member, factor);
-            _c(topColor)
-            _c(bottomColor)
-            _c(outlineColor)
-            _c(outlineWidth)
-            _c(cornerRadius)
-            _c(innerOutlineCornerRadius)
-            #undef _c
-            dynamicStyleUniforms[animation.dynamicStyle] = uniform;
+        state.advanceIds[count] = i;
+        state.advanceFactors[count] = factors[i];
+        ++count;
+    }
+
+    const Containers::ArrayView<const UnsignedInt> ids = state.advanceIds.prefix(count);
+    const Containers::ArrayView<Float> easedFactors = state.advanceFactors.prefix(count);
+
+    /* 2. Evaluate the easing for all running animations in a batch */
+    for(std::size_t i = 0; i != ids.size(); ++i)
+        easedFactors[i] = state.easings[ids[i]](easedFactors[i]);
+
+    /* 3. Interpolate the uniforms. If the source and target uniforms were the
+       same, just copy one of them and don't report that the uniforms got
+       changed. The only exception is the first ever switch to the dynamic
+       uniform in which case the data has to be uploaded. That's handled in
+       the dynamic style allocation above. */
+    for(std::size_t i = 0; i != ids.size(); ++i) {
+        const UnsignedInt id = ids[i];
+        BaseLayerStyleUniform& uniform = dynamicStyleUniforms[state.dynamicStyleStorage[id]];
+        if(state.uniformDifferent[id]) {
+            lerpStyleUniformInto(state.sourceUniforms[id], state.targetUniforms[id], easedFactors[i], uniform);
             animations |= BaseLayerStyleAnimation::Uniform;
-        } else dynamicStyleUniforms[animation.dynamicStyle] = animation.targetUniform;
-
-        /* Interpolate the padding. Compared to the uniforms, updated padding
-           causes doUpdate() to be triggered on the layer, which is expensive,
-           thus trigger it only if there's actually anything changing. */
-        const Vector4 padding = Math::lerp(animation.sourcePadding,
-                                           animation.targetPadding, factor);
-        if(dynamicStylePaddings[animation.dynamicStyle] != padding) {
-           dynamicStylePaddings[animation.dynamicStyle] = padding;
+        } else uniform = state.targetUniforms[id];
+    }
+
+    /* 4. Interpolate the paddings. Compared to the uniforms, updated padding
+       causes doUpdate() to be triggered on the layer, which is expensive,
+       thus trigger it only if there's actually anything changing. */
+    for(std::size_t i = 0; i != ids.size(); ++i) {
+        const UnsignedInt id = ids[i];
+        const Vector4 padding = Math::lerp(state.sourcePaddings[id],
+                                           state.targetPaddings[id], easedFactors[i]);
+        Vector4& dynamicStylePadding = dynamicStylePaddings[state.dynamicStyleStorage[id]];
+        if(dynamicStylePadding != padding) {
+            dynamicStylePadding = padding;
             animations |= BaseLayerStyleAnimation::Padding;
         }
     }
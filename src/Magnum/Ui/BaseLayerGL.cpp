@@ -26,11 +26,16 @@
 
 #include "BaseLayerGL.h"
 
+#include <cstring>
 #include <Corrade/Containers/BitArrayView.h>
 #include <Corrade/Containers/Iterable.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Corrade/Containers/String.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/Format.h>
 #include <Corrade/Utility/Resource.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
 #include <Magnum/Math/Matrix3.h>
 #include <Magnum/Math/Range.h>
 #include <Magnum/GL/AbstractShaderProgram.h>
@@ -40,16 +45,20 @@
 #include <Magnum/GL/Framebuffer.h>
 #include <Magnum/GL/Mesh.h>
 #include <Magnum/GL/Renderer.h>
+#include <Magnum/GL/Sampler.h>
 #include <Magnum/GL/Shader.h>
 #include <Magnum/GL/Texture.h>
 #include <Magnum/GL/TextureArray.h>
 #include <Magnum/GL/TextureFormat.h>
 #include <Magnum/GL/Version.h>
 
+#include "Magnum/Ui/MemoryUsage.h"
 #include "Magnum/Ui/RendererGL.h"
 #include "Magnum/Ui/Implementation/baseLayerState.h"
 #include "Magnum/Ui/Implementation/blurCoefficients.h"
+#include "Magnum/Ui/Implementation/blurQuads.h"
 #include "Magnum/Ui/Implementation/BlurShaderGL.h"
+#include "Magnum/Ui/Implementation/StreamingBufferGL.h"
 
 #ifdef MAGNUM_BUILD_STATIC
 static void importShaderResources() {
@@ -69,16 +78,22 @@ class BaseShaderGL: public GL::AbstractShaderProgram {
             StyleBufferBinding = 0,
             TextureBinding = 0,
             BackgroundBlurTextureBinding = 1,
+            DataNodePropertiesTextureBinding = 2,
+            DataClipRectTextureBinding = 3,
         };
 
     public:
-        enum Flag: UnsignedByte {
+        enum Flag: UnsignedShort {
             Textured = 1 << 0,
             BackgroundBlur = 1 << 1,
             NoRoundedCorners = 1 << 2,
             NoOutline = 1 << 3,
             TextureMask = 1 << 4,
-            SubdividedQuads = 1 << 5
+            SubdividedQuads = 1 << 5,
+            InstancedQuads = 1 << 6,
+            NodeRelativePositions = 1 << 7,
+            ShaderClipping = 1 << 8,
+            CompactVertices = 1 << 9
         };
 
         typedef Containers::EnumSet<Flag> Flags;
@@ -96,16 +111,33 @@ class BaseShaderGL: public GL::AbstractShaderProgram {
         typedef GL::Attribute<3, Vector4> Color4;
         typedef GL::Attribute<4, UnsignedInt> Style;
         typedef GL::Attribute<5, Vector3> TextureCoordinates;
+        /* Only if InstancedQuads are set, Position and TextureCoordinates
+           are then the top left corner */
+        typedef GL::Attribute<1, Vector2> InstanceSize;
+        typedef GL::Attribute<6, Vector2> InstanceTextureCoordinateSize;
 
+        explicit BaseShaderGL(NoCreateT): GL::AbstractShaderProgram{NoCreate} {}
         explicit BaseShaderGL(UnsignedInt styleCount);
         explicit BaseShaderGL(Flags flags, UnsignedInt styleCount);
 
+        /* The constructor only submits the compilation and linking, which
+           with KHR_parallel_shader_compile then happens in the background
+           while the style is applied and fonts get loaded. This waits for
+           the link to finish, checks it and queries uniform locations. Has
+           to be called before the first draw, does nothing if already
+           called. */
+        void finalize();
+
         BaseShaderGL& setProjection(const Vector2& scaling, const Float pixelScaling) {
             /* XY is Y-flipped scale from the UI size to the 2x2 unit square,
                the shader then translates by (-1, 1) on its own to put the
                origin at center. Z is multiplied with the pixel smoothness
-               value to get the smoothness in actual UI units. */
-            setUniform(_projectionUniform, Vector3{Vector2{2.0f, -2.0f}/scaling, pixelScaling});
+               value to get the smoothness in actual UI units. If not
+               finalized yet, uploaded only in finalize() to not wait for the
+               link here. */
+            _projection = Vector3{Vector2{2.0f, -2.0f}/scaling, pixelScaling};
+            if(!_vert.id())
+                setUniform(_projectionUniform, _projection);
             return *this;
         }
 
@@ -126,9 +158,27 @@ class BaseShaderGL: public GL::AbstractShaderProgram {
             return *this;
         }
 
+        BaseShaderGL& bindDataNodePropertiesTexture(GL::Texture2D& texture) {
+            CORRADE_INTERNAL_ASSERT(_flags & Flag::NodeRelativePositions);
+            texture.bind(DataNodePropertiesTextureBinding);
+            return *this;
+        }
+
+        BaseShaderGL& bindDataClipRectTexture(GL::Texture2D& texture) {
+            CORRADE_INTERNAL_ASSERT(_flags & Flag::ShaderClipping);
+            texture.bind(DataClipRectTextureBinding);
+            return *this;
+        }
+
     private:
         Flags _flags;
+        #if defined(MAGNUM_TARGET_GLES) && !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+        GL::Version _version;
+        #endif
         Int _projectionUniform = 0;
+        Vector3 _projection;
+        /* Present only until finalize() is called */
+        GL::Shader _vert{NoCreate}, _frag{NoCreate};
 };
 
 #ifdef CORRADE_TARGET_CLANG
@@ -144,6 +194,11 @@ BaseShaderGL::BaseShaderGL(const Flags flags, const UnsignedInt styleCount): _fl
     GL::Context& context = GL::Context::current();
     #ifndef MAGNUM_TARGET_GLES
     MAGNUM_ASSERT_GL_EXTENSION_SUPPORTED(GL::Extensions::ARB::explicit_attrib_location);
+    if(flags & Flag::InstancedQuads)
+        MAGNUM_ASSERT_GL_EXTENSION_SUPPORTED(GL::Extensions::ARB::base_instance);
+    #else
+    CORRADE_ASSERT(!(flags & Flag::InstancedQuads),
+        "Ui::BaseLayerGL::Shared:" << BaseLayerSharedFlag::InstancedQuads << "is not supported on OpenGL ES", );
     #endif
 
     #ifdef MAGNUM_BUILD_STATIC
@@ -164,30 +219,55 @@ BaseShaderGL::BaseShaderGL(const Flags flags, const UnsignedInt styleCount): _fl
         #endif
     });
 
-    GL::Shader vert{version, GL::Shader::Type::Vertex};
-    vert.addSource(Utility::format("#define STYLE_COUNT {}\n", styleCount))
+    _vert = GL::Shader{version, GL::Shader::Type::Vertex};
+    _vert.addSource(Utility::format("#define STYLE_COUNT {}\n", styleCount))
         .addSource(flags & Flag::BackgroundBlur ? "#define BACKGROUND_BLUR\n"_s : ""_s)
         .addSource(flags & Flag::Textured ? "#define TEXTURED\n"_s : ""_s)
         .addSource(flags & Flag::NoOutline ? "#define NO_OUTLINE\n"_s : ""_s)
         .addSource(flags & Flag::SubdividedQuads ? "#define SUBDIVIDED_QUADS\n"_s : ""_s)
+        .addSource(flags & Flag::InstancedQuads ? "#define INSTANCED_QUADS\n"_s : ""_s)
+        .addSource(flags & Flag::NodeRelativePositions ? "#define NODE_RELATIVE_POSITIONS\n"_s : ""_s)
+        .addSource(flags & Flag::ShaderClipping ? "#define SHADER_CLIPPING\n"_s : ""_s)
+        .addSource(flags & Flag::CompactVertices ? "#define COMPACT_VERTICES\n"_s : ""_s)
         .addSource(rs.getString("compatibility.glsl"_s))
         .addSource(rs.getString("BaseShader.vert"_s));
 
-    GL::Shader frag{version, GL::Shader::Type::Fragment};
-    frag.addSource(Utility::format("#define STYLE_COUNT {}\n", styleCount))
+    _frag = GL::Shader{version, GL::Shader::Type::Fragment};
+    _frag.addSource(Utility::format("#define STYLE_COUNT {}\n", styleCount))
         .addSource(flags & Flag::BackgroundBlur ? "#define BACKGROUND_BLUR\n"_s : ""_s)
         .addSource(flags & Flag::Textured ? "#define TEXTURED\n"_s : ""_s)
         .addSource(flags & Flag::NoRoundedCorners ? "#define NO_ROUNDED_CORNERS\n"_s : ""_s)
         .addSource(flags & Flag::NoOutline ? "#define NO_OUTLINE\n"_s : ""_s)
         .addSource(flags & Flag::TextureMask ? "#define TEXTURE_MASK\n"_s : ""_s)
         .addSource(flags & Flag::SubdividedQuads ? "#define SUBDIVIDED_QUADS\n"_s : ""_s)
+        .addSource(flags & Flag::ShaderClipping ? "#define SHADER_CLIPPING\n"_s : ""_s)
         .addSource(rs.getString("compatibility.glsl"_s))
         .addSource(rs.getString("BaseShader.frag"_s));
 
-    CORRADE_INTERNAL_ASSERT(vert.compile() && frag.compile());
+    #if defined(MAGNUM_TARGET_GLES) && !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+    _version = version;
+    #endif
+
+    _vert.submitCompile();
+    _frag.submitCompile();
+
+    attachShaders({_vert, _frag});
+    submitLink();
+}
+
+void BaseShaderGL::finalize() {
+    if(!_vert.id())
+        return;
 
-    attachShaders({vert, frag});
-    CORRADE_INTERNAL_ASSERT(link());
+    CORRADE_INTERNAL_ASSERT_OUTPUT(checkLink({_vert, _frag}));
+    _vert = GL::Shader{NoCreate};
+    _frag = GL::Shader{NoCreate};
+
+    #ifndef MAGNUM_TARGET_GLES
+    GL::Context& context = GL::Context::current();
+    #elif !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+    const GL::Version version = _version;
+    #endif
 
     #ifndef MAGNUM_TARGET_GLES
     if(!context.isExtensionSupported<GL::Extensions::ARB::explicit_uniform_location>())
@@ -204,12 +284,18 @@ BaseShaderGL::BaseShaderGL(const Flags flags, const UnsignedInt styleCount): _fl
     if(version < GL::Version::GLES310)
     #endif
     {
-        if(flags & Flag::Textured)
+        if(_flags & Flag::Textured)
             setUniform(uniformLocation("textureData"_s), TextureBinding);
-        if(flags & Flag::BackgroundBlur)
+        if(_flags & Flag::BackgroundBlur)
             setUniform(uniformLocation("backgroundBlurTextureData"_s), BackgroundBlurTextureBinding);
+        if(_flags & Flag::NodeRelativePositions)
+            setUniform(uniformLocation("dataNodePropertiesTextureData"_s), DataNodePropertiesTextureBinding);
+        if(_flags & Flag::ShaderClipping)
+            setUniform(uniformLocation("dataClipRectTextureData"_s), DataClipRectTextureBinding);
         setUniformBlockBinding(uniformBlockIndex("Style"_s), StyleBufferBinding);
     }
+
+    setUniform(_projectionUniform, _projection);
 }
 
 }
@@ -259,8 +345,8 @@ BlurShaderGL::BlurShaderGL(UnsignedInt radius, Float limit) {
         Containers::arrayView(weights).prefix(interpolatedCount),
         Containers::arrayView(offsets).prefix(interpolatedCount));
 
-    GL::Shader vert{version, GL::Shader::Type::Vertex};
-    vert.addSource(rs.getString("compatibility.glsl"_s))
+    _vert = GL::Shader{version, GL::Shader::Type::Vertex};
+    _vert.addSource(rs.getString("compatibility.glsl"_s))
         .addSource(rs.getString("BlurShader.vert"_s));
 
     /* A suffix (*not* prefix, to have a null terminator) is taken for
@@ -273,8 +359,8 @@ BlurShaderGL::BlurShaderGL(UnsignedInt radius, Float limit) {
     const Containers::StringView placeholdersSuffix =
         placeholders.exceptPrefix(placeholders.size() - ((interpolatedCount - 1)*6 + 4));
 
-    GL::Shader frag{version, GL::Shader::Type::Fragment};
-    frag.addSource(rs.getString("compatibility.glsl"_s))
+    _frag = GL::Shader{version, GL::Shader::Type::Fragment};
+    _frag.addSource(rs.getString("compatibility.glsl"_s))
         .addSource(Utility::format(
             "#define COUNT {0}\n"
             "const highp float weights[{0}] = float[]({1});\n"
@@ -299,10 +385,32 @@ BlurShaderGL::BlurShaderGL(UnsignedInt radius, Float limit) {
         .addSource(count % 2 == 1 ? "#define FIRST_TAP_AT_CENTER\n"_s : ""_s)
         .addSource(rs.getString("BlurShader.frag"_s));
 
-    CORRADE_INTERNAL_ASSERT(vert.compile() && frag.compile());
+    #if defined(MAGNUM_TARGET_GLES) && !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+    _version = version;
+    #endif
+
+    _vert.submitCompile();
+    _frag.submitCompile();
+
+    attachShaders({_vert, _frag});
+    submitLink();
+}
+
+void BlurShaderGL::finalize() {
+    using namespace Containers::Literals;
+
+    if(!_vert.id())
+        return;
 
-    attachShaders({vert, frag});
-    CORRADE_INTERNAL_ASSERT(link());
+    CORRADE_INTERNAL_ASSERT_OUTPUT(checkLink({_vert, _frag}));
+    _vert = GL::Shader{NoCreate};
+    _frag = GL::Shader{NoCreate};
+
+    #ifndef MAGNUM_TARGET_GLES
+    GL::Context& context = GL::Context::current();
+    #elif !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+    const GL::Version version = _version;
+    #endif
 
     #ifndef MAGNUM_TARGET_GLES
     if(!context.isExtensionSupported<GL::Extensions::ARB::explicit_uniform_location>())
@@ -329,45 +437,229 @@ BlurShaderGL::BlurShaderGL(UnsignedInt radius, Float limit) {
     {
         setUniform(uniformLocation("textureData"_s), TextureBinding);
     }
+
+    setUniform(_projectionUniform, _projection);
+}
+
+#ifndef MAGNUM_TARGET_GLES
+/* Used by TextLayerGL as well, so no anonymous namespace either */
+namespace Implementation {
+
+bool StreamingBufferGL::isSupported() {
+    return GL::Context::current().isExtensionSupported<GL::Extensions::ARB::buffer_storage>();
+}
+
+StreamingBufferGL::~StreamingBufferGL() {
+    for(GLsync fence: _fences)
+        if(fence) glDeleteSync(fence);
+}
+
+bool StreamingBufferGL::write(const Containers::ArrayView<const char> data, const std::size_t alignment) {
+    /* All draws from the segment written last time are submitted by now, so
+       fence it */
+    if(_data) {
+        if(_fences[_segment])
+            glDeleteSync(_fences[_segment]);
+        _fences[_segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    /* If the data don't fit, create a new buffer. Draws that are still in
+       flight keep the old storage alive until they're done, so the fences can
+       be just discarded. */
+    bool recreated = false;
+    if(data.size() > _segmentSize) {
+        for(GLsync& fence: _fences) {
+            if(fence) glDeleteSync(fence);
+            fence = {};
+        }
+
+        _segmentSize = (data.size()*2 + alignment - 1)/alignment*alignment;
+        _buffer = GL::Buffer{GL::Buffer::TargetHint::Array};
+        _buffer.setStorage({nullptr, _segmentSize*SegmentCount}, GL::Buffer::StorageFlag::MapWrite|GL::Buffer::StorageFlag::MapPersistent|GL::Buffer::StorageFlag::MapCoherent);
+        _data = _buffer.map(0, _segmentSize*SegmentCount, GL::Buffer::MapFlag::Write|GL::Buffer::MapFlag::Persistent|GL::Buffer::MapFlag::Coherent);
+        CORRADE_INTERNAL_ASSERT(_data);
+        _segment = 0;
+        recreated = true;
+
+    /* Otherwise wait until the GPU is done with the next segment */
+    } else {
+        _segment = (_segment + 1) % SegmentCount;
+        if(const GLsync fence = _fences[_segment]) {
+            while(glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED);
+            glDeleteSync(fence);
+            _fences[_segment] = {};
+        }
+    }
+
+    if(!data.isEmpty())
+        Utility::copy(data, Containers::arrayView(_data + segmentOffset(), data.size()));
+    return recreated;
+}
+
 }
+#endif
 
 struct BaseLayerGL::Shared::State: BaseLayer::Shared::State {
     explicit State(Shared& self, const Configuration& configuration);
 
+    UnsignedInt backgroundBlurShaderRadius() const;
+    BlurShaderGL& blurShader();
+    void createBackgroundBlur();
+    Vector2i backgroundBlurTextureSize(const Vector2i& framebufferSize) const;
+
     BaseShaderGL shader;
+    /* Used only if Flag::AutomaticShaderVariants is enabled and not both
+       Flag::NoOutline and Flag::NoRoundedCorners are, `shader` with both of
+       them enabled for drawing data that don't need them */
+    BaseShaderGL variantShader{NoCreate};
     /* In case dynamic styles are present, this buffer is unused and each layer
        has its own copy instead */
     GL::Buffer styleBuffer{NoCreate};
 
-    /* These are created only if Flag::BackgroundBlur is enabled */
+    /* These are created only if Flag::BackgroundBlur is enabled, and only
+       once there's something to composite, in createBackgroundBlur(). Until
+       then, the UI size and framebuffer size from the last doSetSize() are
+       remembered here. */
+    bool backgroundBlurCreated = false;
+    Float backgroundBlurCutoff;
+    Vector2 backgroundBlurSize;
+    Vector2i backgroundBlurFramebufferSize;
     GL::Texture2D backgroundBlurTextureVertical{NoCreate},
                   backgroundBlurTextureHorizontal{NoCreate};
     GL::Framebuffer backgroundBlurFramebufferVertical{NoCreate},
                     backgroundBlurFramebufferHorizontal{NoCreate};
+    /* Compiled on the first use in blurShader(). Unused if
+       backgroundBlurShaderSource is set, the shader from the source (or its
+       source) is used instead. */
     BlurShaderGL backgroundBlurShader{NoCreate};
+    State* backgroundBlurShaderSource{};
+    /* Pass count, compositing framebuffer generation and blur quads for
+       which backgroundBlurTextureHorizontal contains the blurred result. The
+       result doesn't depend on anything else, so it can be reused by any
+       layer sharing this state. If not valid, there's nothing to reuse.
+       Reset in doSetSize() and replaced by any doComposite() that blurs over
+       the quads. */
+    bool backgroundBlurCacheValid = false;
+    UnsignedInt backgroundBlurCachePassCount;
+    UnsignedLong backgroundBlurCacheGeneration;
+    Containers::Array<Vector2> backgroundBlurCacheVertices;
 };
 
-BaseLayerGL::Shared::State::State(Shared& self, const Configuration& configuration): BaseLayer::Shared::State{self, configuration}, shader{
+namespace {
+
+BaseShaderGL::Flags shaderFlags(const BaseLayerSharedFlags flags) {
     #define _c(flag) (flags >= BaseLayerSharedFlag::flag ? BaseShaderGL::Flag::flag : BaseShaderGL::Flags{})
-    _c(BackgroundBlur)|
-    _c(Textured)|
-    _c(NoRoundedCorners)|
-    _c(NoOutline)|
-    _c(TextureMask)|
-    _c(SubdividedQuads),
+    return
+        _c(BackgroundBlur)|
+        _c(Textured)|
+        _c(NoRoundedCorners)|
+        _c(NoOutline)|
+        _c(TextureMask)|
+        _c(SubdividedQuads)|
+        _c(InstancedQuads)|
+        _c(NodeRelativePositions)|
+        _c(ShaderClipping)|
+        _c(CompactVertices);
     #undef _c
-    configuration.styleUniformCount() + configuration.dynamicStyleCount()}
+}
+
+}
+
+BaseLayerGL::Shared::State::State(Shared& self, const Configuration& configuration): BaseLayer::Shared::State{self, configuration}, shader{shaderFlags(flags), configuration.styleUniformCount() + configuration.dynamicStyleCount()},
+    backgroundBlurCutoff{configuration.backgroundBlurCutoff()}
 {
+    /* The variant is compiled together with the main shader so both links
+       can happen in the background */
+    if(flags >= BaseLayerSharedFlag::AutomaticShaderVariants && !(flags >= (BaseLayerSharedFlag::NoOutline|BaseLayerSharedFlag::NoRoundedCorners)))
+        variantShader = BaseShaderGL{shaderFlags(flags)|BaseShaderGL::Flag::NoOutline|BaseShaderGL::Flag::NoRoundedCorners, configuration.styleUniformCount() + configuration.dynamicStyleCount()};
+
     if(!dynamicStyleCount)
         styleBuffer = GL::Buffer{GL::Buffer::TargetHint::Uniform, {nullptr, sizeof(BaseLayerCommonStyleUniform) + sizeof(BaseLayerStyleUniform)*styleUniformCount}};
-    if(configuration.flags() & BaseLayerSharedFlag::BackgroundBlur)
-        backgroundBlurShader = BlurShaderGL{configuration.backgroundBlurRadius(), configuration.backgroundBlurCutoff()};
+    /* The blur shader isn't compiled here but only on the first
+       doComposite(), as the blur is often enabled on a layer that's shown
+       only on some screens */
+}
+
+Vector2i BaseLayerGL::Shared::State::backgroundBlurTextureSize(const Vector2i& framebufferSize) const {
+    /* If downsampling, the blur textures are smaller, rounded up to not lose
+       the last row / column */
+    const UnsignedInt downsampling = backgroundBlurDownsampling;
+    return (framebufferSize + Vector2i{Int(downsampling) - 1})/Int(downsampling);
+}
+
+UnsignedInt BaseLayerGL::Shared::State::backgroundBlurShaderRadius() const {
+    /* With downsampling the radius is in downsampled pixels, round up to not
+       make the blur smaller than requested */
+    return (backgroundBlurRadius + backgroundBlurDownsampling - 1)/backgroundBlurDownsampling;
+}
+
+BlurShaderGL& BaseLayerGL::Shared::State::blurShader() {
+    /* If sharing the shader with another instance, go to the one that owns
+       it. The parameters were checked to match in
+       shareBackgroundBlurShader() already. */
+    State* state = this;
+    while(state->backgroundBlurShaderSource)
+        state = state->backgroundBlurShaderSource;
+
+    /* Compile the shader if not already */
+    if(!state->backgroundBlurShader.id())
+        state->backgroundBlurShader = BlurShaderGL{state->backgroundBlurShaderRadius(), state->backgroundBlurCutoff};
+    return state->backgroundBlurShader;
+}
+
+void BaseLayerGL::Shared::State::createBackgroundBlur() {
+    /* Submit the shader compilation first so it can happen in the background
+       while the textures and framebuffers are created */
+    blurShader();
+
+    /* If downsampling, the blur textures are smaller. The texture
+       coordinates are normalized both in the blur shader and when sampling
+       the blurred texture in the base shader, so nothing else needs to adapt
+       to the size difference. Linear filtering then takes care of both the
+       downsampling of the input and the upsampling of the result. */
+    const Vector2i blurSize = backgroundBlurTextureSize(backgroundBlurFramebufferSize);
+    (backgroundBlurTextureVertical = GL::Texture2D{})
+        .setMinificationFilter(GL::SamplerFilter::Linear, GL::SamplerMipmap::Base)
+        .setMagnificationFilter(GL::SamplerFilter::Linear)
+        .setWrapping(GL::SamplerWrapping::ClampToEdge)
+        .setStorage(1, GL::TextureFormat::RGBA8, blurSize);
+    (backgroundBlurTextureHorizontal = GL::Texture2D{})
+        .setMinificationFilter(GL::SamplerFilter::Linear, GL::SamplerMipmap::Base)
+        .setMagnificationFilter(GL::SamplerFilter::Linear)
+        .setWrapping(GL::SamplerWrapping::ClampToEdge)
+        .setStorage(1, GL::TextureFormat::RGBA8, blurSize);
+
+    (backgroundBlurFramebufferVertical = GL::Framebuffer{{{}, blurSize}})
+        .attachTexture(GL::Framebuffer::ColorAttachment{0}, backgroundBlurTextureVertical, 0);
+    (backgroundBlurFramebufferHorizontal = GL::Framebuffer{{{}, blurSize}})
+        .attachTexture(GL::Framebuffer::ColorAttachment{0}, backgroundBlurTextureHorizontal, 0);
+
+    backgroundBlurCreated = true;
 }
 
 BaseLayerGL::Shared::Shared(const Configuration& configuration): BaseLayer::Shared{Containers::pointer<State>(*this, configuration)} {}
 
 BaseLayerGL::Shared::Shared(NoCreateT) noexcept: BaseLayer::Shared{NoCreate} {}
 
+BaseLayerGL::Shared& BaseLayerGL::Shared::shareBackgroundBlurShader(Shared& other) {
+    auto& state = static_cast<State&>(*_state);
+    auto& otherState = static_cast<State&>(*other._state);
+    CORRADE_ASSERT(state.flags >= BaseLayerSharedFlag::BackgroundBlur && otherState.flags >= BaseLayerSharedFlag::BackgroundBlur,
+        "Ui::BaseLayerGL::Shared::shareBackgroundBlurShader():" << BaseLayerSharedFlag::BackgroundBlur << "not enabled on both instances", *this);
+    CORRADE_ASSERT(state.backgroundBlurShaderRadius() == otherState.backgroundBlurShaderRadius() && state.backgroundBlurCutoff == otherState.backgroundBlurCutoff,
+        "Ui::BaseLayerGL::Shared::shareBackgroundBlurShader(): expected the same effective blur radius and cutoff, got" << state.backgroundBlurShaderRadius() << "and" << state.backgroundBlurCutoff << "but" << otherState.backgroundBlurShaderRadius() << "and" << otherState.backgroundBlurCutoff << "in the other", *this);
+    CORRADE_ASSERT(!state.backgroundBlurShader.id(),
+        "Ui::BaseLayerGL::Shared::shareBackgroundBlurShader(): the blur shader is already created", *this);
+    #ifndef CORRADE_NO_ASSERT
+    for(const State* source = &otherState; source; source = source->backgroundBlurShaderSource)
+        CORRADE_ASSERT(source != &state,
+            "Ui::BaseLayerGL::Shared::shareBackgroundBlurShader(): sharing would form a cycle", *this);
+    #endif
+
+    state.backgroundBlurShaderSource = &otherState;
+    return *this;
+}
+
 BaseLayerGL::Shared& BaseLayerGL::Shared::setStyle(const BaseLayerCommonStyleUniform& commonUniform, const Containers::ArrayView<const BaseLayerStyleUniform> uniforms, const Containers::StridedArrayView1D<const Vector4>& paddings) {
     return static_cast<Shared&>(BaseLayer::Shared::setStyle(commonUniform, uniforms, paddings));
 }
@@ -393,36 +685,59 @@ void BaseLayerGL::Shared::doSetStyle(const BaseLayerCommonStyleUniform& commonUn
     state.styleBuffer.setSubData(sizeof(BaseLayerCommonStyleUniform), uniforms);
 }
 
-struct BaseLayerGL::State: BaseLayer::State {
-    explicit State(Shared::State& shared): BaseLayer::State{shared} {}
-
-    GL::Buffer vertexBuffer{GL::Buffer::TargetHint::Array}, indexBuffer{GL::Buffer::TargetHint::ElementArray};
-    GL::Mesh mesh;
-    Vector2 clipScale;
-
-    /* Used only if Flag::Textured is enabled. Is non-owning if
-       setTexture(GL::Texture2DArray&) was called, owning if
-       setTexture(GL::Texture2DArray&&). */
-    GL::Texture2DArray texture{NoCreate};
-
-    /* Used only if shared.dynamicStyleCount is non-zero, in which case it's
-       created during the first doUpdate(). Even though the size is known in
-       advance, the NoCreate'd state is used to correctly perform the first
-       ever style upload without having to implicitly set any LayerStates. */
-    GL::Buffer styleBuffer{NoCreate};
+namespace {
 
-    /* Used only if Flag::BackgroundBlur is enabled */
-    GL::Buffer backgroundBlurVertexBuffer{NoCreate};
-    GL::Buffer backgroundBlurIndexBuffer{NoCreate};
-    GL::Mesh backgroundBlurMesh{NoCreate};
-};
+/* Attaches the vertex buffer to the mesh. With instanced quads it's
+   attached as a per-instance buffer and the mesh is a non-indexed four-vertex
+   triangle strip, otherwise the index buffer is attached as well. */
+void setupMesh(GL::Mesh& mesh, GL::Buffer& buffer, GL::Buffer& indexBuffer, const BaseLayerSharedFlags flags) {
+    if(flags >= BaseLayerSharedFlag::InstancedQuads) {
+        mesh.setPrimitive(GL::MeshPrimitive::TriangleStrip)
+            .setCount(4);
+        if(flags & BaseLayerSharedFlag::Textured) {
+            mesh.addVertexBufferInstanced(buffer, 1, 0,
+                BaseShaderGL::Position{},
+                BaseShaderGL::InstanceSize{},
+                BaseShaderGL::OutlineWidth{},
+                BaseShaderGL::Color4{},
+                BaseShaderGL::Style{},
+                BaseShaderGL::TextureCoordinates{},
+                BaseShaderGL::InstanceTextureCoordinateSize{});
+        } else {
+            mesh.addVertexBufferInstanced(buffer, 1, 0,
+                BaseShaderGL::Position{},
+                BaseShaderGL::InstanceSize{},
+                BaseShaderGL::OutlineWidth{},
+                BaseShaderGL::Color4{},
+                BaseShaderGL::Style{});
+        }
+        return;
+    }
 
-BaseLayerGL::BaseLayerGL(const LayerHandle handle, Shared& sharedState_): BaseLayer{handle, Containers::pointer<State>(static_cast<Shared::State&>(*sharedState_._state))} {
-    auto& state = static_cast<State&>(*_state);
-    Shared::State& sharedState = static_cast<Shared::State&>(state.shared);
-    if(!(sharedState.flags >= BaseLayerSharedFlag::SubdividedQuads)) {
-        if(sharedState.flags & BaseLayerSharedFlag::Textured) {
-            state.mesh.addVertexBuffer(state.vertexBuffer, 0,
+    mesh.setIndexBuffer(indexBuffer, 0, GL::MeshIndexType::UnsignedInt);
+    /* With compact vertices the fixed-point values are passed as
+       non-normalized integers to the shader, which scales them back */
+    if(flags >= BaseLayerSharedFlag::CompactVertices) {
+        if(flags & BaseLayerSharedFlag::Textured) {
+            mesh.addVertexBuffer(buffer, 0,
+                BaseShaderGL::Position{BaseShaderGL::Position::DataType::Short},
+                BaseShaderGL::CenterDistance{BaseShaderGL::CenterDistance::DataType::Short},
+                BaseShaderGL::OutlineWidth{BaseShaderGL::OutlineWidth::DataType::Short},
+                BaseShaderGL::Color4{BaseShaderGL::Color4::DataType::UnsignedByte, BaseShaderGL::Color4::DataOption::Normalized},
+                BaseShaderGL::Style{},
+                BaseShaderGL::TextureCoordinates{BaseShaderGL::TextureCoordinates::DataType::Short},
+                2);
+        } else {
+            mesh.addVertexBuffer(buffer, 0,
+                BaseShaderGL::Position{BaseShaderGL::Position::DataType::Short},
+                BaseShaderGL::CenterDistance{BaseShaderGL::CenterDistance::DataType::Short},
+                BaseShaderGL::OutlineWidth{BaseShaderGL::OutlineWidth::DataType::Short},
+                BaseShaderGL::Color4{BaseShaderGL::Color4::DataType::UnsignedByte, BaseShaderGL::Color4::DataOption::Normalized},
+                BaseShaderGL::Style{});
+        }
+    } else if(!(flags >= BaseLayerSharedFlag::SubdividedQuads)) {
+        if(flags & BaseLayerSharedFlag::Textured) {
+            mesh.addVertexBuffer(buffer, 0,
                 BaseShaderGL::Position{},
                 BaseShaderGL::CenterDistance{},
                 BaseShaderGL::OutlineWidth{},
@@ -430,7 +745,7 @@ BaseLayerGL::BaseLayerGL(const LayerHandle handle, Shared& sharedState_): BaseLa
                 BaseShaderGL::Style{},
                 BaseShaderGL::TextureCoordinates{});
         } else {
-            state.mesh.addVertexBuffer(state.vertexBuffer, 0,
+            mesh.addVertexBuffer(buffer, 0,
                 BaseShaderGL::Position{},
                 BaseShaderGL::CenterDistance{},
                 BaseShaderGL::OutlineWidth{},
@@ -438,8 +753,8 @@ BaseLayerGL::BaseLayerGL(const LayerHandle handle, Shared& sharedState_): BaseLa
                 BaseShaderGL::Style{});
         }
     } else {
-        if(sharedState.flags & BaseLayerSharedFlag::Textured) {
-            state.mesh.addVertexBuffer(state.vertexBuffer, 0,
+        if(flags & BaseLayerSharedFlag::Textured) {
+            mesh.addVertexBuffer(buffer, 0,
                 BaseShaderGL::Position{},
                 BaseShaderGL::SubdividedQuadOutlineWidth{},
                 BaseShaderGL::Color4{},
@@ -447,7 +762,7 @@ BaseLayerGL::BaseLayerGL(const LayerHandle handle, Shared& sharedState_): BaseLa
                 BaseShaderGL::SubdividedQuadCenterDistanceYTextureScale{},
                 BaseShaderGL::TextureCoordinates{});
         } else {
-            state.mesh.addVertexBuffer(state.vertexBuffer, 0,
+            mesh.addVertexBuffer(buffer, 0,
                 BaseShaderGL::Position{},
                 BaseShaderGL::SubdividedQuadOutlineWidth{},
                 BaseShaderGL::Color4{},
@@ -455,7 +770,151 @@ BaseLayerGL::BaseLayerGL(const LayerHandle handle, Shared& sharedState_): BaseLa
                 BaseShaderGL::SubdividedQuadCenterDistanceY{});
         }
     }
-    state.mesh.setIndexBuffer(state.indexBuffer, 0, GL::MeshIndexType::UnsignedInt);
+}
+
+/* Size of a single vertex or instance in BaseLayer::State::vertices */
+std::size_t vertexTypeSize(const BaseLayerSharedFlags flags) {
+    if(flags >= BaseLayerSharedFlag::InstancedQuads)
+        return flags & BaseLayerSharedFlag::Textured ?
+            sizeof(Implementation::BaseLayerTexturedInstance) :
+            sizeof(Implementation::BaseLayerInstance);
+    if(flags >= BaseLayerSharedFlag::SubdividedQuads)
+        return flags & BaseLayerSharedFlag::Textured ?
+            sizeof(Implementation::BaseLayerSubdividedTexturedVertex) :
+            sizeof(Implementation::BaseLayerSubdividedVertex);
+    return flags & BaseLayerSharedFlag::Textured ?
+        sizeof(Implementation::BaseLayerTexturedVertex) :
+        sizeof(Implementation::BaseLayerVertex);
+}
+
+/* Size of a single vertex or instance in the vertex buffer, different from
+   vertexTypeSize() only with BaseLayerSharedFlag::CompactVertices */
+std::size_t bufferVertexTypeSize(const BaseLayerSharedFlags flags) {
+    if(flags >= BaseLayerSharedFlag::CompactVertices)
+        return flags & BaseLayerSharedFlag::Textured ?
+            sizeof(Implementation::BaseLayerCompactTexturedVertex) :
+            sizeof(Implementation::BaseLayerCompactVertex);
+    return vertexTypeSize(flags);
+}
+
+/* Returns given range of BaseLayer::State::vertices in the format the vertex
+   buffer expects. With BaseLayerSharedFlag::CompactVertices it's converted
+   into `scratch`, which is enlarged if needed, otherwise passed through. */
+Containers::ArrayView<const char> bufferVertexData(Containers::Array<char>& scratch, const BaseLayerSharedFlags flags, const Containers::ArrayView<const char> vertices, const Vector2& uiSize) {
+    if(!(flags >= BaseLayerSharedFlag::CompactVertices))
+        return vertices;
+
+    const std::size_t size = vertices.size()/vertexTypeSize(flags)*bufferVertexTypeSize(flags);
+    if(scratch.size() < size)
+        scratch = Containers::Array<char>{NoInit, size};
+    const Containers::ArrayView<char> out = scratch.prefix(size);
+    if(flags & BaseLayerSharedFlag::Textured)
+        Implementation::compactBaseLayerVerticesInto(
+            Containers::arrayCast<const Implementation::BaseLayerTexturedVertex>(vertices),
+            Containers::arrayCast<Implementation::BaseLayerCompactTexturedVertex>(out),
+            uiSize);
+    else
+        Implementation::compactBaseLayerVerticesInto(
+            Containers::arrayCast<const Implementation::BaseLayerVertex>(vertices),
+            Containers::arrayCast<Implementation::BaseLayerCompactVertex>(out),
+            uiSize);
+    return out;
+}
+
+/* Uploads per-data values indexed by data ID, BaseLayerDataOffsetTextureWidth
+   in each row. The whole texture is recreated if the row count changed,
+   otherwise just the rows that contain the changed range are uploaded. The
+   row count is zero only if there's no data at all, in which case there's
+   also nothing to draw. Returns the uploaded byte count. */
+std::size_t uploadDataTexture(GL::Texture2D& texture, Int& textureRowCount, const GL::TextureFormat format, const PixelFormat pixelFormat, const Containers::ArrayView<const char> data, const std::size_t typeSize, std::size_t& updateBegin, std::size_t& updateEnd) {
+    const std::size_t rowSize = Implementation::BaseLayerDataOffsetTextureWidth*typeSize;
+    const Int rowCount = data.size()/rowSize;
+    std::size_t uploadedByteCount = 0;
+    if(textureRowCount != rowCount && rowCount) {
+        (texture = GL::Texture2D{})
+            .setMinificationFilter(GL::SamplerFilter::Nearest)
+            .setMagnificationFilter(GL::SamplerFilter::Nearest)
+            .setStorage(1, format, {Int(Implementation::BaseLayerDataOffsetTextureWidth), rowCount})
+            .setSubImage(0, {}, ImageView2D{pixelFormat, {Int(Implementation::BaseLayerDataOffsetTextureWidth), rowCount}, data});
+        textureRowCount = rowCount;
+        uploadedByteCount = data.size();
+    } else if(updateBegin < updateEnd) {
+        const std::size_t rowBegin = updateBegin/Implementation::BaseLayerDataOffsetTextureWidth;
+        const std::size_t rowEnd = (updateEnd + Implementation::BaseLayerDataOffsetTextureWidth - 1)/Implementation::BaseLayerDataOffsetTextureWidth;
+        texture.setSubImage(0, {0, Int(rowBegin)}, ImageView2D{pixelFormat, {Int(Implementation::BaseLayerDataOffsetTextureWidth), Int(rowEnd - rowBegin)}, data.slice(rowBegin*rowSize, rowEnd*rowSize)});
+        uploadedByteCount = (rowEnd - rowBegin)*rowSize;
+    }
+    updateBegin = ~std::size_t{};
+    updateEnd = 0;
+    return uploadedByteCount;
+}
+
+}
+
+struct BaseLayerGL::State: BaseLayer::State {
+    explicit State(Shared::State& shared): BaseLayer::State{shared} {}
+
+    GL::Buffer vertexBuffer{GL::Buffer::TargetHint::Array}, indexBuffer{GL::Buffer::TargetHint::ElementArray};
+    GL::Mesh mesh;
+    Vector2 clipScale;
+    /* Byte size of `vertices` that vertexBuffer was last uploaded from. If it
+       still matches, only the range that changed is uploaded. */
+    std::size_t vertexBufferSize = 0;
+    /* Used only if BaseLayerSharedFlag::CompactVertices is enabled, contains
+       the converted vertex data for the last upload */
+    Containers::Array<char> compactVertexScratch;
+    /* Total byte count uploaded in all uploadPendingData() calls */
+    UnsignedLong uploadedByteCount = 0;
+
+    #ifndef MAGNUM_TARGET_GLES
+    /* Used instead of vertexBuffer if setVertexBufferStreaming() is enabled */
+    Containers::Pointer<Implementation::StreamingBufferGL> streamingVertexBuffer;
+    /* Offset of the current streaming buffer segment in instances, used for
+       the base instance with BaseLayerSharedFlag::InstancedQuads. Without
+       instancing the base vertex is set on the mesh directly. */
+    UnsignedInt streamingBaseInstance = 0;
+    #endif
+
+    /* Used only if Flag::Textured is enabled. Is non-owning if
+       setTexture(GL::Texture2DArray&) was called, owning if
+       setTexture(GL::Texture2DArray&&). */
+    GL::Texture2DArray texture{NoCreate};
+
+    /* Used only if Flag::NodeRelativePositions is enabled. Contains
+       `dataNodeProperties`, BaseLayerDataOffsetTextureWidth in each row. If
+       the row count matches, only the rows that changed are uploaded. */
+    GL::Texture2D dataNodePropertiesTexture{NoCreate};
+    Int dataNodePropertiesTextureRowCount = 0;
+
+    /* Used only if Flag::ShaderClipping is enabled. Contains `dataClipRects`,
+       laid out the same way as `dataNodePropertiesTexture`. */
+    GL::Texture2D dataClipRectTexture{NoCreate};
+    Int dataClipRectTextureRowCount = 0;
+
+    /* Used only if shared.dynamicStyleCount is non-zero, in which case it's
+       created during the first upload in doDraw() or doComposite(). Even
+       though the size is known in advance, the NoCreate'd state is used to
+       correctly perform the first ever style upload without having to
+       implicitly set any LayerStates. */
+    GL::Buffer styleBuffer{NoCreate};
+
+    /* Used only if Flag::BackgroundBlur is enabled */
+    GL::Buffer backgroundBlurVertexBuffer{NoCreate};
+    GL::Buffer backgroundBlurIndexBuffer{NoCreate};
+    GL::Mesh backgroundBlurMesh{NoCreate};
+
+    /* States passed to doUpdate() calls since the last upload, and whether
+       the shared style changed in any of them. The GPU upload is deferred to
+       the next doDraw() or doComposite() so doUpdate() doesn't touch GL and
+       can be called from a different thread. */
+    LayerStates pendingUploadStates;
+    bool pendingSharedStyleChanged = false;
+};
+
+BaseLayerGL::BaseLayerGL(const LayerHandle handle, Shared& sharedState_): BaseLayer{handle, Containers::pointer<State>(static_cast<Shared::State&>(*sharedState_._state))} {
+    auto& state = static_cast<State&>(*_state);
+    Shared::State& sharedState = static_cast<Shared::State&>(state.shared);
+    setupMesh(state.mesh, state.vertexBuffer, state.indexBuffer, sharedState.flags);
 
     if(sharedState.flags >= BaseLayerSharedFlag::BackgroundBlur) {
         state.backgroundBlurVertexBuffer = GL::Buffer{GL::Buffer::TargetHint::Array};
@@ -481,8 +940,49 @@ BaseLayerGL& BaseLayerGL::setTexture(GL::Texture2DArray&& texture) {
     return *this;
 }
 
+#ifndef MAGNUM_TARGET_GLES
+bool BaseLayerGL::isVertexBufferStreaming() const {
+    return !!static_cast<const State&>(*_state).streamingVertexBuffer;
+}
+
+BaseLayerGL& BaseLayerGL::setVertexBufferStreaming(const bool enabled) {
+    auto& state = static_cast<State&>(*_state);
+    auto& sharedState = static_cast<Shared::State&>(state.shared);
+    CORRADE_ASSERT(!enabled || Implementation::StreamingBufferGL::isSupported(),
+        "Ui::BaseLayerGL::setVertexBufferStreaming():" << GL::Extensions::ARB::buffer_storage::string() << "is not supported", *this);
+    CORRADE_ASSERT(!enabled || !(sharedState.flags & (BaseLayerSharedFlag::NodeRelativePositions|BaseLayerSharedFlag::ShaderClipping)),
+        "Ui::BaseLayerGL::setVertexBufferStreaming(): can't be used with" << (sharedState.flags & (BaseLayerSharedFlag::NodeRelativePositions|BaseLayerSharedFlag::ShaderClipping)), *this);
+    if(enabled == !!state.streamingVertexBuffer)
+        return *this;
+
+    /* The streaming buffer replaces the regular buffer in the mesh on the
+       first non-empty upload, until then the mesh has the regular buffer
+       attached to have a consistent state. When disabling, the regular buffer
+       gets fully uploaded again. */
+    state.mesh = GL::Mesh{};
+    setupMesh(state.mesh, state.vertexBuffer, state.indexBuffer, sharedState.flags);
+    if(enabled) {
+        state.streamingVertexBuffer.emplace();
+    } else {
+        state.streamingVertexBuffer = nullptr;
+        state.streamingBaseInstance = 0;
+        state.vertexBufferSize = ~std::size_t{};
+    }
+
+    /* Make the next draw upload the vertex and index data again */
+    state.pendingUploadStates |= LayerState::NeedsDataUpdate;
+    return *this;
+}
+#endif
+
+UnsignedLong BaseLayerGL::uploadedByteCount() const {
+    return static_cast<const State&>(*_state).uploadedByteCount;
+}
+
 LayerFeatures BaseLayerGL::doFeatures() const {
-    return BaseLayer::doFeatures()|LayerFeature::DrawUsesBlending|LayerFeature::DrawUsesScissor;
+    /* With shader clipping the scissor isn't used for anything */
+    auto& sharedState = static_cast<const Shared::State&>(_state->shared);
+    return BaseLayer::doFeatures()|LayerFeature::DrawUsesBlending|(sharedState.flags & BaseLayerSharedFlag::ShaderClipping ? LayerFeatures{} : LayerFeature::DrawUsesScissor);
 }
 
 void BaseLayerGL::doSetSize(const Vector2& size, const Vector2i& framebufferSize) {
@@ -493,24 +993,32 @@ void BaseLayerGL::doSetSize(const Vector2& size, const Vector2i& framebufferSize
 
     /** @todo Max or min? Should I even bother with non-square scaling? */
     sharedState.shader.setProjection(size, (size/Vector2{framebufferSize}).max());
+    if(sharedState.variantShader.id())
+        sharedState.variantShader.setProjection(size, (size/Vector2{framebufferSize}).max());
 
     /* For scaling and Y-flipping the clip rects in doDraw() */
     state.clipScale = Vector2{framebufferSize}/size;
 
+    /* Compact vertices are relative to the UI size, so they have to be all
+       converted and uploaded again. The float vertices stay the same, so
+       there's no need to regenerate them. */
+    if(sharedState.flags & BaseLayerSharedFlag::CompactVertices) {
+        state.vertexBufferSize = ~std::size_t{};
+        state.pendingUploadStates |= LayerState::NeedsNodeOffsetSizeUpdate;
+    }
+
+    /* The blur shader, textures and framebuffers are (re)created only on
+       the next doComposite(), so a layer that never composites anything
+       doesn't allocate them at all. If they're created already and the
+       possibly downsampled texture size stays the same, which happens often
+       during interactive window resizing with downsampling enabled, they're
+       reused. */
     if(sharedState.flags & BaseLayerSharedFlag::BackgroundBlur) {
-        sharedState.backgroundBlurShader.setProjection(size);
-
-        (sharedState.backgroundBlurTextureVertical = GL::Texture2D{})
-            .setWrapping(GL::SamplerWrapping::ClampToEdge)
-            .setStorage(1, GL::TextureFormat::RGBA8, framebufferSize);
-        (sharedState.backgroundBlurTextureHorizontal = GL::Texture2D{})
-            .setWrapping(GL::SamplerWrapping::ClampToEdge)
-            .setStorage(1, GL::TextureFormat::RGBA8, framebufferSize);
-
-        (sharedState.backgroundBlurFramebufferVertical = GL::Framebuffer{{{}, framebufferSize}})
-            .attachTexture(GL::Framebuffer::ColorAttachment{0}, sharedState.backgroundBlurTextureVertical, 0);
-        (sharedState.backgroundBlurFramebufferHorizontal = GL::Framebuffer{{{}, framebufferSize}})
-            .attachTexture(GL::Framebuffer::ColorAttachment{0}, sharedState.backgroundBlurTextureHorizontal, 0);
+        if(sharedState.backgroundBlurCreated && sharedState.backgroundBlurTextureSize(framebufferSize) != sharedState.backgroundBlurFramebufferVertical.viewport().size())
+            sharedState.backgroundBlurCreated = false;
+        sharedState.backgroundBlurSize = size;
+        sharedState.backgroundBlurFramebufferSize = framebufferSize;
+        sharedState.backgroundBlurCacheValid = false;
     }
 }
 
@@ -521,30 +1029,120 @@ void BaseLayerGL::doUpdate(const LayerStates states, const Containers::StridedAr
     /* Check whether the shared styles changed before calling into the base
        doUpdate() that syncs the stamps. For dynamic styles, if the style
        changed, it should be accompanied by NeedsCommonDataUpdate being set in
-       order to be correctly handled below. */
+       order to be correctly handled below. The dynamic style change may be
+       also a leftover from a previous update that wasn't uploaded yet. */
     const bool sharedStyleChanged = sharedState.styleUpdateStamp != state.styleUpdateStamp;
-    CORRADE_INTERNAL_ASSERT(!sharedState.dynamicStyleCount || (!sharedStyleChanged && !state.dynamicStyleChanged) || states >= LayerState::NeedsCommonDataUpdate);
+    CORRADE_INTERNAL_ASSERT(!sharedState.dynamicStyleCount || (!sharedStyleChanged && !state.dynamicStyleChanged) || states >= LayerState::NeedsCommonDataUpdate || state.pendingUploadStates >= LayerState::NeedsCommonDataUpdate);
 
     BaseLayer::doUpdate(states, dataIds, clipRectIds, clipRectDataCounts, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, clipRectOffsets, clipRectSizes, compositeRectOffsets, compositeRectSizes);
 
+    /* Only remember what needs to be uploaded, the actual upload is done in
+       uploadPendingData() on the next draw or composite */
+    state.pendingUploadStates |= states;
+    state.pendingSharedStyleChanged = state.pendingSharedStyleChanged || sharedStyleChanged;
+}
+
+void BaseLayerGL::doMemoryUsage(MemoryUsage& usage) const {
+    BaseLayer::doMemoryUsage(usage);
+
+    State& state = static_cast<State&>(*_state);
+    /* Buffer sizes are queried from GL, texture sizes are calculated from
+       the row counts as they can't be queried on ES and WebGL. The blur
+       textures are in the shared state and the texture set in setTexture()
+       isn't owned by the layer, so they're not counted. */
+    const auto bufferSize = [](GL::Buffer& buffer) -> std::size_t {
+        return buffer.id() ? buffer.size() : 0;
+    };
+    usage.gpuByteCount +=
+        bufferSize(state.vertexBuffer) +
+        bufferSize(state.indexBuffer) +
+        bufferSize(state.styleBuffer) +
+        bufferSize(state.backgroundBlurVertexBuffer) +
+        bufferSize(state.backgroundBlurIndexBuffer) +
+        std::size_t(state.dataNodePropertiesTextureRowCount)*Implementation::BaseLayerDataOffsetTextureWidth*sizeof(Vector3) +
+        std::size_t(state.dataClipRectTextureRowCount)*Implementation::BaseLayerDataOffsetTextureWidth*sizeof(Vector4);
+    usage.cpuByteCount += state.compactVertexScratch.size();
+    #ifndef MAGNUM_TARGET_GLES
+    if(state.streamingVertexBuffer)
+        usage.gpuByteCount += bufferSize(state.streamingVertexBuffer->buffer());
+    #endif
+}
+
+void BaseLayerGL::uploadPendingData() {
+    State& state = static_cast<State&>(*_state);
+    Shared::State& sharedState = static_cast<Shared::State&>(state.shared);
+    const LayerStates states = state.pendingUploadStates;
+
     /* The branching here mirrors how BaseLayer::doUpdate() restricts the
-       updates */
-    if(states >= LayerState::NeedsNodeOrderUpdate ||
-       states >= LayerState::NeedsDataUpdate)
+       updates. With instanced quads there's no index buffer, the instance
+       data update on a node order change instead. */
+    const bool instanced = sharedState.flags >= BaseLayerSharedFlag::InstancedQuads;
+    if(!instanced && (states >= LayerState::NeedsNodeOrderUpdate ||
+                      states >= LayerState::NeedsDataUpdate))
     {
         state.indexBuffer.setData(state.indices);
         state.mesh.setCount(state.indices.size());
+        state.uploadedByteCount += state.indices.size()*sizeof(UnsignedInt);
     }
     if(states >= LayerState::NeedsNodeOffsetSizeUpdate ||
        states >= LayerState::NeedsNodeEnabledUpdate ||
-       states >= LayerState::NeedsDataUpdate)
+       states >= LayerState::NeedsNodeOpacityUpdate ||
+       states >= LayerState::NeedsDataUpdate ||
+       (instanced && states >= LayerState::NeedsNodeOrderUpdate))
     {
-        state.vertexBuffer.setData(state.vertices);
+        #ifndef MAGNUM_TARGET_GLES
+        /* With streaming, the whole vertex data are copied to the next
+           segment of the persistently mapped buffer, which is then drawn from
+           by offsetting the base vertex. If the buffer got recreated, the
+           mesh has to be set up again. */
+        if(state.streamingVertexBuffer) {
+            const std::size_t bufferTypeSize = bufferVertexTypeSize(sharedState.flags);
+            const Containers::ArrayView<const char> vertexData = bufferVertexData(state.compactVertexScratch, sharedState.flags, state.vertices, state.uiSize);
+            if(state.streamingVertexBuffer->write(vertexData, bufferTypeSize)) {
+                state.mesh = GL::Mesh{};
+                setupMesh(state.mesh, state.streamingVertexBuffer->buffer(), state.indexBuffer, sharedState.flags);
+            }
+            if(instanced)
+                state.streamingBaseInstance = state.streamingVertexBuffer->segmentOffset()/bufferTypeSize;
+            else
+                state.mesh.setBaseVertex(Int(state.streamingVertexBuffer->segmentOffset()/bufferTypeSize));
+            state.uploadedByteCount += vertexData.size();
+        } else
+        #endif
+        /* Upload the whole vertex data only if their size changed, otherwise
+           just the range that BaseLayer::doUpdate() actually changed. With
+           compact vertices the range is converted first and its offset scaled
+           to the compact vertex size. */
+        if(state.vertexBufferSize != state.vertices.size()) {
+            const Containers::ArrayView<const char> vertexData = bufferVertexData(state.compactVertexScratch, sharedState.flags, state.vertices, state.uiSize);
+            state.vertexBuffer.setData(vertexData);
+            state.vertexBufferSize = state.vertices.size();
+            state.uploadedByteCount += vertexData.size();
+        } else if(state.vertexUpdateBegin < state.vertexUpdateEnd) {
+            const Containers::ArrayView<const char> vertexData = bufferVertexData(state.compactVertexScratch, sharedState.flags, state.vertices.slice(state.vertexUpdateBegin, state.vertexUpdateEnd), state.uiSize);
+            state.vertexBuffer.setSubData(state.vertexUpdateBegin/vertexTypeSize(sharedState.flags)*bufferVertexTypeSize(sharedState.flags), vertexData);
+            state.uploadedByteCount += vertexData.size();
+        }
+        state.vertexUpdateBegin = ~std::size_t{};
+        state.vertexUpdateEnd = 0;
+
+        if(sharedState.flags & BaseLayerSharedFlag::NodeRelativePositions)
+            state.uploadedByteCount += uploadDataTexture(state.dataNodePropertiesTexture, state.dataNodePropertiesTextureRowCount, GL::TextureFormat::RGB32F, PixelFormat::RGB32F, Containers::arrayCast<const char>(state.dataNodeProperties), sizeof(Vector3), state.dataNodePropertyUpdateBegin, state.dataNodePropertyUpdateEnd);
     }
+    /* Clip rects change only with the same states as the index buffer, the
+       branching mirrors BaseLayer::doUpdate() again */
+    if(sharedState.flags & BaseLayerSharedFlag::ShaderClipping &&
+       (states >= LayerState::NeedsNodeOrderUpdate ||
+        states >= LayerState::NeedsDataUpdate))
+        state.uploadedByteCount += uploadDataTexture(state.dataClipRectTexture, state.dataClipRectTextureRowCount, GL::TextureFormat::RGBA32F, PixelFormat::RGBA32F, Containers::arrayCast<const char>(state.dataClipRects), sizeof(Vector4), state.dataClipRectUpdateBegin, state.dataClipRectUpdateEnd);
+    /** @todo track changed ranges for the background blur vertices as well,
+        it's just a single quad for each compositing rect so far less
+        important */
     if(states >= LayerState::NeedsCompositeOffsetSizeUpdate && sharedState.flags & BaseLayerSharedFlag::BackgroundBlur) {
         state.backgroundBlurIndexBuffer.setData(state.backgroundBlurIndices);
         state.backgroundBlurVertexBuffer.setData(state.backgroundBlurVertices);
         state.backgroundBlurMesh.setCount(state.backgroundBlurIndices.size());
+        state.uploadedByteCount += state.backgroundBlurIndices.size()*sizeof(UnsignedInt) + state.backgroundBlurVertices.size()*sizeof(Vector2);
     }
 
     /* If we have dynamic styles and either NeedsCommonDataUpdate is set
@@ -556,17 +1154,22 @@ void BaseLayerGL::doUpdate(const LayerStates states, const Containers::StridedAr
             /** @todo check if DynamicDraw has any effect on perf */
             state.styleBuffer = GL::Buffer{GL::Buffer::TargetHint::Uniform, {nullptr, sizeof(BaseLayerCommonStyleUniform) + sizeof(BaseLayerStyleUniform)*(sharedState.styleUniformCount + sharedState.dynamicStyleCount)}, GL::BufferUsage::DynamicDraw};
         }
-        if(needsFirstUpload || sharedStyleChanged) {
+        if(needsFirstUpload || state.pendingSharedStyleChanged) {
             state.styleBuffer.setSubData(0, {&sharedState.commonStyleUniform, 1});
             /* Skip empty upload if there are just dynamic styles */
             if(!sharedState.styleUniforms.isEmpty())
                 state.styleBuffer.setSubData(sizeof(BaseLayerCommonStyleUniform), sharedState.styleUniforms);
+            state.uploadedByteCount += sizeof(BaseLayerCommonStyleUniform) + sharedState.styleUniforms.size()*sizeof(BaseLayerStyleUniform);
         }
         if(needsFirstUpload || state.dynamicStyleChanged) {
             state.styleBuffer.setSubData(sizeof(BaseLayerCommonStyleUniform) + sizeof(BaseLayerStyleUniform)*sharedState.styleUniformCount, state.dynamicStyleUniforms);
+            state.uploadedByteCount += state.dynamicStyleUniforms.size()*sizeof(BaseLayerStyleUniform);
             state.dynamicStyleChanged = false;
         }
     }
+
+    state.pendingUploadStates = {};
+    state.pendingSharedStyleChanged = false;
 }
 
 void BaseLayerGL::doComposite(AbstractRenderer& renderer, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, std::size_t offset, std::size_t count) {
@@ -574,24 +1177,90 @@ void BaseLayerGL::doComposite(AbstractRenderer& renderer, const Containers::Stri
     Shared::State& sharedState = static_cast<Shared::State&>(state.shared);
     RendererGL& rendererGL = static_cast<RendererGL&>(renderer);
 
+    uploadPendingData();
+
+    /* Create the blur shader and textures on first use or after a size
+       change */
+    if(!sharedState.backgroundBlurCreated)
+        sharedState.createBackgroundBlur();
+
+    /* The shader may be shared with other layers with a different size, so
+       the projection is set every time */
+    BlurShaderGL& blurShader = sharedState.blurShader();
+    blurShader.finalize();
+    blurShader.setProjection(sharedState.backgroundBlurSize);
+
+    /* Merge overlapping quads to not blur the overlapping areas multiple
+       times. Can't be done in doUpdate() already as it doesn't know which
+       quads get composited together, and it's idempotent so running it again
+       on quads merged in a previous frame does nothing. The quads already
+       restrict the blur to just the composited areas, so there's no need to
+       additionally set up a scissor rectangle. */
+    const Containers::ArrayView<Vector2> vertices = state.backgroundBlurVertices.sliceSize(offset*4, count*4);
+    if(mergeOverlappingBlurQuadsInPlace(vertices)) {
+        state.backgroundBlurVertexBuffer.setSubData(offset*4*sizeof(Vector2), vertices);
+        state.uploadedByteCount += vertices.size()*sizeof(Vector2);
+    }
+
+    /* If blurring the same quads of the same compositing framebuffer
+       contents with the same pass count as last time, and nothing was
+       blurred over them since, the output is still in the texture. Skip the
+       blur in that case. */
+    const UnsignedLong generation = rendererGL.compositingFramebufferGeneration();
+    if(sharedState.backgroundBlurCacheValid &&
+       sharedState.backgroundBlurCachePassCount == state.backgroundBlurPassCount &&
+       sharedState.backgroundBlurCacheGeneration == generation &&
+       sharedState.backgroundBlurCacheVertices.size() == vertices.size() &&
+       std::memcmp(sharedState.backgroundBlurCacheVertices.data(), vertices.data(), vertices.size()*sizeof(Vector2)) == 0)
+        return;
+
+    /* Otherwise remember these quads for next time if there's nothing
+       cached yet or if they're blurred over the cached quads, making them
+       invalid. The quads are axis-aligned, with the first vertex being the
+       min and the last the max. */
+    bool replaceCache = !sharedState.backgroundBlurCacheValid;
+    for(std::size_t i = 0; !replaceCache && i != count; ++i) {
+        const Range2D quad{vertices[i*4 + 0], vertices[i*4 + 3]};
+        for(std::size_t j = 0, jMax = sharedState.backgroundBlurCacheVertices.size()/4; j != jMax; ++j) {
+            if(Math::intersects(quad, Range2D{
+                sharedState.backgroundBlurCacheVertices[j*4 + 0],
+                sharedState.backgroundBlurCacheVertices[j*4 + 3]}))
+            {
+                replaceCache = true;
+                break;
+            }
+        }
+    }
+    if(replaceCache) {
+        sharedState.backgroundBlurCacheValid = true;
+        sharedState.backgroundBlurCachePassCount = state.backgroundBlurPassCount;
+        sharedState.backgroundBlurCacheGeneration = generation;
+        if(sharedState.backgroundBlurCacheVertices.size() != vertices.size())
+            sharedState.backgroundBlurCacheVertices = Containers::Array<Vector2>{NoInit, vertices.size()};
+        Utility::copy(vertices, sharedState.backgroundBlurCacheVertices);
+    }
+
     state.backgroundBlurMesh
         .setIndexOffset(offset*6)
         .setCount(count*6);
 
     /* Perform the blur in as many passes as desired. For the first pass the
        input is the compositing framebuffer texture, successive passes take
-       output of the previous horizontal blur for the next vertical blur. */
+       output of the previous horizontal blur for the next vertical blur. The
+       direction is in texels of the (potentially downsampled) blur
+       textures. */
+    const Vector2 blurSize{sharedState.backgroundBlurFramebufferVertical.viewport().size()};
     GL::Texture2D* input = &rendererGL.compositingTexture();
     for(UnsignedInt i = 0; i != state.backgroundBlurPassCount; ++i) {
         sharedState.backgroundBlurFramebufferVertical.bind();
-        sharedState.backgroundBlurShader
-            .setDirection(Vector2::yAxis(1.0f/state.framebufferSize.y()))
+        blurShader
+            .setDirection(Vector2::yAxis(1.0f/blurSize.y()))
             .bindTexture(*input)
             .draw(state.backgroundBlurMesh);
 
         sharedState.backgroundBlurFramebufferHorizontal.bind();
-        sharedState.backgroundBlurShader
-            .setDirection(Vector2::xAxis(1.0f/state.framebufferSize.x()))
+        blurShader
+            .setDirection(Vector2::xAxis(1.0f/blurSize.x()))
             .bindTexture(sharedState.backgroundBlurTextureVertical)
             .draw(state.backgroundBlurMesh);
 
@@ -599,7 +1268,7 @@ void BaseLayerGL::doComposite(AbstractRenderer& renderer, const Containers::Stri
     }
 }
 
-void BaseLayerGL::doDraw(const Containers::StridedArrayView1D<const UnsignedInt>&, const std::size_t offset, const std::size_t count, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const std::size_t clipRectOffset, const std::size_t clipRectCount, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Float>&, Containers::BitArrayView, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes) {
+void BaseLayerGL::doDraw(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const std::size_t offset, const std::size_t count, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const std::size_t clipRectOffset, const std::size_t clipRectCount, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Float>&, Containers::BitArrayView, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes) {
     auto& state = static_cast<State&>(*_state);
     CORRADE_ASSERT(!state.framebufferSize.isZero() && !state.clipScale.isZero(),
         "Ui::BaseLayerGL::draw(): user interface size wasn't set", );
@@ -610,6 +1279,14 @@ void BaseLayerGL::doDraw(const Containers::StridedArrayView1D<const UnsignedInt>
     CORRADE_ASSERT(!(sharedState.flags & BaseLayerSharedFlag::Textured) || state.texture.id(),
         "Ui::BaseLayerGL::draw(): no texture to draw with was set", );
 
+    uploadPendingData();
+
+    /* Wait for the shader compilation submitted in the Shared constructor
+       to finish, if not already */
+    sharedState.shader.finalize();
+    if(sharedState.variantShader.id())
+        sharedState.variantShader.finalize();
+
     /* If there are dynamic styles, bind the layer-specific buffer that
        contains them, otherwise bind the shared buffer */
     sharedState.shader.bindStyleBuffer(sharedState.dynamicStyleCount ?
@@ -617,28 +1294,103 @@ void BaseLayerGL::doDraw(const Containers::StridedArrayView1D<const UnsignedInt>
 
     if(sharedState.flags & BaseLayerSharedFlag::Textured)
         sharedState.shader.bindTexture(state.texture);
-    if(sharedState.flags & BaseLayerSharedFlag::BackgroundBlur)
+    /* If nothing was composited yet, the blur texture isn't created and
+       there's also nothing to sample from */
+    if(sharedState.flags & BaseLayerSharedFlag::BackgroundBlur && sharedState.backgroundBlurCreated)
         sharedState.shader.bindBackgroundBlurTexture(sharedState.backgroundBlurTextureHorizontal);
+    if(sharedState.flags & BaseLayerSharedFlag::NodeRelativePositions)
+        sharedState.shader.bindDataNodePropertiesTexture(state.dataNodePropertiesTexture);
+    if(sharedState.flags & BaseLayerSharedFlag::ShaderClipping)
+        sharedState.shader.bindDataClipRectTexture(state.dataClipRectTexture);
 
     const UnsignedInt drawSize = sharedState.flags >= BaseLayerSharedFlag::SubdividedQuads ? 54 : 6;
 
-    std::size_t clipDataOffset = offset;
-    for(std::size_t i = 0; i != clipRectCount; ++i) {
+    /* Draws a range of data with given shader. With instanced quads the data
+       offset is directly the instance offset, otherwise it's an offset into
+       the index buffer. */
+    const auto drawWith = [&](BaseShaderGL& shader, const std::size_t dataOffset, const std::size_t dataCount) {
+        #ifndef MAGNUM_TARGET_GLES
+        if(sharedState.flags >= BaseLayerSharedFlag::InstancedQuads)
+            state.mesh
+                .setBaseInstance(state.streamingBaseInstance + dataOffset)
+                .setInstanceCount(dataCount);
+        else
+        #endif
+        {
+            state.mesh
+                .setIndexOffset(dataOffset*drawSize)
+                .setCount(dataCount*drawSize);
+        }
+        shader.draw(state.mesh);
+    };
+
+    /* Draws a range of data, with automatic shader variants splitting it
+       into runs of data that can be drawn with the cheaper variant and the
+       rest. Runs that are too short are drawn with the full shader together
+       with the surrounding data. */
+    const auto draw = [&](const std::size_t dataOffset, const std::size_t dataCount) {
+        if(!sharedState.variantShader.id()) {
+            drawWith(sharedState.shader, dataOffset, dataCount);
+            return;
+        }
+
+        const std::size_t end = dataOffset + dataCount;
+        for(std::size_t i = dataOffset; i != end; ) {
+            std::size_t simpleBegin = end, simpleEnd = end;
+            for(std::size_t j = i; j != end; ) {
+                if(!state.simpleData[dataIds[j]]) {
+                    ++j;
+                    continue;
+                }
+
+                std::size_t k = j + 1;
+                while(k != end && state.simpleData[dataIds[k]])
+                    ++k;
+                if(k - j >= Implementation::BaseLayerShaderVariantMinDataCount || (j == dataOffset && k == end)) {
+                    simpleBegin = j;
+                    simpleEnd = k;
+                    break;
+                }
+                j = k;
+            }
+
+            if(simpleBegin != i)
+                drawWith(sharedState.shader, i, simpleBegin - i);
+            if(simpleBegin != simpleEnd)
+                drawWith(sharedState.variantShader, simpleBegin, simpleEnd - simpleBegin);
+            i = simpleEnd;
+        }
+    };
+
+    /* With shader clipping the whole range is drawn at once, the fragment
+       shader discards everything outside of the clip rect of each data */
+    if(sharedState.flags & BaseLayerSharedFlag::ShaderClipping) {
+        draw(offset, count);
+        return;
+    }
+
+    const auto scissorRectangle = [&](const std::size_t i) {
         const UnsignedInt clipRectId = clipRectIds[clipRectOffset + i];
-        const UnsignedInt clipRectDataCount = clipRectDataCounts[clipRectOffset + i];
         const Vector2i clipRectOffset_ = Vector2i{clipRectOffsets[clipRectId]*state.clipScale};
         const Vector2i clipRectSize = clipRectSizes[clipRectId].isZero() ?
             state.framebufferSize : Vector2i{clipRectSizes[clipRectId]*state.clipScale};
-
-        GL::Renderer::setScissor(Range2Di::fromSize(
+        return Range2Di::fromSize(
             {clipRectOffset_.x(), state.framebufferSize.y() - clipRectOffset_.y() - clipRectSize.y()},
-            clipRectSize));
+            clipRectSize);
+    };
 
-        state.mesh
-            .setIndexOffset(clipDataOffset*drawSize)
-            .setCount(clipRectDataCount*drawSize);
-        sharedState.shader
-            .draw(state.mesh);
+    std::size_t clipDataOffset = offset;
+    for(std::size_t i = 0; i != clipRectCount; ) {
+        /* Consecutive clip rects that result in the same scissor rectangle,
+           such as unclipped top-level nodes that got merged into a single
+           draw, are drawn together */
+        const Range2Di scissor = scissorRectangle(i);
+        UnsignedInt clipRectDataCount = clipRectDataCounts[clipRectOffset + i];
+        for(++i; i != clipRectCount && scissorRectangle(i) == scissor; ++i)
+            clipRectDataCount += clipRectDataCounts[clipRectOffset + i];
+
+        GL::Renderer::setScissor(scissor);
+        draw(clipDataOffset, clipRectDataCount);
 
         clipDataOffset += clipRectDataCount;
     }
@@ -103,6 +103,56 @@ class MAGNUM_UI_EXPORT BaseLayerGL: public BaseLayer {
          */
         BaseLayerGL& setTexture(GL::Texture2DArray&& texture);
 
+        #ifndef MAGNUM_TARGET_GLES
+        /**
+         * @brief Whether the vertex buffer is streamed
+         * @m_since_latest
+         *
+         * @requires_gl Persistently mapped buffers are not available in
+         *      OpenGL ES or WebGL.
+         * @see @ref setVertexBufferStreaming()
+         */
+        bool isVertexBufferStreaming() const;
+
+        /**
+         * @brief Set whether the vertex buffer is streamed
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * If enabled, vertex data are written into a persistently mapped
+         * buffer split into three segments used in a round-robin fashion,
+         * with a fence guarding each segment from being overwritten while
+         * it's still being drawn from. That avoids the implicit
+         * synchronization and extra copies some drivers do in
+         * @ref GL::Buffer::setData(), at the cost of copying the whole vertex
+         * data on every change instead of just the ranges that changed.
+         * Expects that @gl_extension{ARB,buffer_storage} is supported when
+         * enabling. Initial value is @cpp false @ce.
+         *
+         * Can't be enabled if the layer was constructed with a shared state
+         * that has @ref BaseLayerSharedFlag::NodeRelativePositions or
+         * @relativeref{BaseLayerSharedFlag,ShaderClipping}, as the streaming
+         * buffer segment offset affects the vertex ID from which the node
+         * offset and clip rect is fetched.
+         * @requires_gl44 Extension @gl_extension{ARB,buffer_storage}
+         * @requires_gl Persistently mapped buffers are not available in
+         *      OpenGL ES or WebGL.
+         */
+        BaseLayerGL& setVertexBufferStreaming(bool enabled);
+        #endif
+
+        /**
+         * @brief Total count of bytes uploaded to the GPU
+         * @m_since_latest
+         *
+         * Includes vertex, index and dynamic style data uploaded by all
+         * @ref doDraw() and @ref doComposite() calls since the layer was
+         * created. Only the ranges of vertex data that actually changed are
+         * uploaded, unless the total vertex data size changes. Subtract a
+         * value saved in a previous frame to get a per-frame byte count.
+         */
+        UnsignedLong uploadedByteCount() const;
+
         /* Overloads to remove a WTF factor from method chaining order */
         #ifndef DOXYGEN_GENERATING_OUTPUT
         BaseLayerGL& setBackgroundBlurPassCount(UnsignedInt count) {
@@ -150,7 +200,11 @@ class MAGNUM_UI_EXPORT BaseLayerGL: public BaseLayer {
 
         void doSetSize(const Vector2& size, const Vector2i& framebufferSize) override;
 
+        void doMemoryUsage(MemoryUsage& usage) const override;
+
         void doUpdate(LayerStates states, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes) override;
+
+        MAGNUM_UI_LOCAL void uploadPendingData();
 };
 
 /**
@@ -160,6 +214,14 @@ Contains shader instances. In order to update or draw the layer it's expected
 that @ref setStyle() was called, in case @ref BaseLayerSharedFlag::Textured is
 enabled additionally it's expected that @ref setTexture() was called on the
 layer as well.
+
+The shaders are compiled and linked asynchronously if
+@gl_extension{KHR,parallel_shader_compile} is supported, with the constructor
+only submitting the work and the first draw of a layer using this instance
+waiting for it to finish. Background blur resources for
+@ref BaseLayerSharedFlag::BackgroundBlur are created only once there's
+anything to composite. Instances with the same blur parameters can use a
+single blur shader through @ref shareBackgroundBlurShader().
 */
 class MAGNUM_UI_EXPORT BaseLayerGL::Shared: public BaseLayer::Shared {
     public:
@@ -175,6 +237,29 @@ class MAGNUM_UI_EXPORT BaseLayerGL::Shared: public BaseLayer::Shared {
          */
         explicit Shared(NoCreateT) noexcept;
 
+        /**
+         * @brief Share the background blur shader with another instance
+         * @return Reference to self (for method chaining)
+         *
+         * Makes this instance use the blur shader of @p other instead of
+         * compiling its own. If @p other is itself sharing the shader with
+         * another instance, the shader of that instance is used. Expects
+         * that @ref BaseLayerSharedFlag::BackgroundBlur is enabled on both,
+         * that both have the same blur cutoff and the same blur radius after
+         * applying the downsampling factor set in
+         * @ref BaseLayer::Shared::Configuration::setBackgroundBlurRadius()
+         * and @relativeref{BaseLayer::Shared::Configuration,setBackgroundBlurDownsampling()},
+         * that this instance hasn't created its own blur shader yet and that
+         * the sharing doesn't form a cycle.
+         *
+         * The @p other instance is expected to stay alive for as long as this
+         * instance is used and to be in the same GL context or a context
+         * sharing objects with it. As the projection is set separately for
+         * every composite, the instances can be used in user interfaces of
+         * different sizes.
+         */
+        Shared& shareBackgroundBlurShader(Shared& other);
+
         /* Overloads to remove a WTF factor from method chaining order */
         #ifndef DOXYGEN_GENERATING_OUTPUT
         MAGNUMEXTRAS_UI_ABSTRACTVISUALLAYER_SHARED_SUBCLASS_IMPLEMENTATION()
@@ -91,10 +91,21 @@ NOPERSPECTIVE in mediump vec3 interpolatedTextureCoordinates;
 #ifdef BACKGROUND_BLUR
 NOPERSPECTIVE in highp vec2 backgroundBlurTextureCoordinates;
 #endif
+#ifdef SHADER_CLIPPING
+flat in highp vec4 clipRect;
+NOPERSPECTIVE in highp vec2 clipPosition;
+#endif
 
 out lowp vec4 fragmentColor;
 
 void main() {
+    /* Discard everything outside of the clip rect, which is what the scissor
+       would do otherwise. An unclipped data has an infinite clip rect. */
+    #ifdef SHADER_CLIPPING
+    if(any(lessThan(clipPosition, clipRect.xy)) || any(greaterThanEqual(clipPosition, clipRect.zw)))
+        discard;
+    #endif
+
     #ifndef SUBDIVIDED_QUADS
     mediump vec2 position = interpolatedCenterDistance;
 
@@ -53,11 +53,51 @@ layout(location = 0)
 uniform highp vec3 projection; /* xy = UI size to unit square scaling,
                                   z = pixel smoothness to UI size scaling */
 
+#ifdef NODE_RELATIVE_POSITIONS
+/* Offset (xy) and opacity (z) of the node each data is attached to, 1024
+   data in a row, indexed by the data ID calculated from the vertex ID */
+#ifdef EXPLICIT_BINDING
+layout(binding = 2)
+#endif
+uniform highp sampler2D dataNodePropertiesTextureData;
+#endif
+
+#ifdef SHADER_CLIPPING
+/* Clip rect min and max corner of the node each data is attached to, laid
+   out the same way as the node offsets */
+#ifdef EXPLICIT_BINDING
+layout(binding = 3)
+#endif
+uniform highp sampler2D dataClipRectTextureData;
+#endif
+
+#ifdef INSTANCED_QUADS
+/* Top left corner and size of the quad, including the smoothness expansion.
+   The actual per-vertex position and center distance is calculated from
+   these in main(). */
+layout(location = 0) in highp vec2 instancePosition;
+layout(location = 1) in mediump vec2 instanceSize;
+#elif !defined(COMPACT_VERTICES)
 layout(location = 0) in highp vec2 position;
+#else
+/* Position, center distance and outline width are 16-bit fixed-point values
+   in units of 1/16384 of the UI size, converted back in main() */
+layout(location = 0) in highp vec2 compactPosition;
+#endif
 #ifndef SUBDIVIDED_QUADS
+#ifndef INSTANCED_QUADS
+#ifndef COMPACT_VERTICES
 layout(location = 1) in mediump vec2 centerDistance;
+#else
+layout(location = 1) in highp vec2 compactCenterDistance;
+#endif
+#endif
 #ifndef NO_OUTLINE
+#ifndef COMPACT_VERTICES
 layout(location = 2) in mediump vec4 outlineWidth;
+#else
+layout(location = 2) in highp vec4 compactOutlineWidth;
+#endif
 #endif
 #else
 #ifndef TEXTURED
@@ -72,7 +112,17 @@ layout(location = 2) in mediump vec2 outlineWidth;
 layout(location = 3) in lowp vec4 color;
 layout(location = 4) in mediump uint style;
 #ifdef TEXTURED
+#ifdef INSTANCED_QUADS
+/* Texture coordinates of the top left corner and the size, again including
+   the smoothness expansion */
+layout(location = 5) in mediump vec3 instanceTextureCoordinateOffset;
+layout(location = 6) in mediump vec2 instanceTextureCoordinateSize;
+#elif !defined(COMPACT_VERTICES)
 layout(location = 5) in mediump vec3 textureCoordinates;
+#else
+/* XY are 16-bit fixed-point values in units of 1/16384, Z is the layer */
+layout(location = 5) in highp vec3 compactTextureCoordinates;
+#endif
 #endif
 
 flat out mediump uint interpolatedStyle;
@@ -83,6 +133,10 @@ NOPERSPECTIVE out mediump vec3 interpolatedTextureCoordinates;
 #ifdef BACKGROUND_BLUR
 NOPERSPECTIVE out highp vec2 backgroundBlurTextureCoordinates;
 #endif
+#ifdef SHADER_CLIPPING
+flat out highp vec4 clipRect;
+NOPERSPECTIVE out highp vec2 clipPosition;
+#endif
 #ifndef SUBDIVIDED_QUADS
 flat out mediump vec2 halfQuadSize;
 flat out mediump vec4 outlineQuadSize;
@@ -97,9 +151,64 @@ NOPERSPECTIVE out mediump float outlineCornerRadius;
 void main() {
     interpolatedStyle = style;
 
+    /* With node-relative positions or shader clipping, fetch the node offset,
+       opacity and clip rect for the data this vertex belongs to, four or
+       sixteen vertices for every data */
+    #if defined(NODE_RELATIVE_POSITIONS) || defined(SHADER_CLIPPING)
+    #ifndef SUBDIVIDED_QUADS
+    highp int dataId = gl_VertexID >> 2;
+    #else
+    highp int dataId = gl_VertexID >> 4;
+    #endif
+    highp ivec2 dataTexel = ivec2(dataId & 1023, dataId >> 10);
+    #endif
+    #ifdef NODE_RELATIVE_POSITIONS
+    highp vec3 nodeProperties = texelFetch(dataNodePropertiesTextureData, dataTexel, 0).xyz;
+    highp vec2 nodeOffset = nodeProperties.xy;
+    lowp vec4 nodeColor = color*nodeProperties.z;
+    #else
+    highp vec2 nodeOffset = vec2(0.0);
+    lowp vec4 nodeColor = color;
+    #endif
+    #ifdef SHADER_CLIPPING
+    clipRect = texelFetch(dataClipRectTextureData, dataTexel, 0);
+    #endif
+
     /* Case with just a single quad -- the position, center distance and
        texture coordinates all already contain the smoothness expansion */
     #ifndef SUBDIVIDED_QUADS
+    /* With instanced quads, expand the corners from the vertex ID, which
+       goes from 0 to 3 for a triangle strip in the same order as the
+       non-instanced vertices:
+
+        0---1
+        |   |
+        |   |
+        |   |
+        2---3 */
+    #ifdef INSTANCED_QUADS
+    mediump vec2 corner = vec2(float(gl_VertexID & 1), float((gl_VertexID >> 1) & 1));
+    highp vec2 position = instancePosition + instanceSize*corner;
+    mediump vec2 centerDistance = (corner - vec2(0.5))*instanceSize;
+    #ifdef TEXTURED
+    mediump vec3 textureCoordinates = vec3(instanceTextureCoordinateOffset.xy + instanceTextureCoordinateSize*corner, instanceTextureCoordinateOffset.z);
+    #endif
+
+    /* With compact vertices, convert the fixed-point values back. The
+       projection is 2/size, so the UI size is derived from it instead of
+       having to supply it in another uniform. */
+    #elif defined(COMPACT_VERTICES)
+    highp vec2 compactScale = vec2(1.0/8192.0)/abs(projection.xy);
+    highp vec2 position = compactPosition*compactScale;
+    mediump vec2 centerDistance = compactCenterDistance*compactScale;
+    #ifndef NO_OUTLINE
+    mediump vec4 outlineWidth = compactOutlineWidth*compactScale.xyxy;
+    #endif
+    #ifdef TEXTURED
+    mediump vec3 textureCoordinates = vec3(compactTextureCoordinates.xy/16384.0, compactTextureCoordinates.z);
+    #endif
+    #endif
+
     /* The halfQuadSize passed to the fragment shader needs to be *without* the
        expansion to correctly know where the edges are */
     halfQuadSize = abs(centerDistance) - vec2(style_smoothness*projection.z);
@@ -114,7 +223,7 @@ void main() {
        fragment shader invocation. Have to extrapolate to again undo the quad
        expansion, i.e. at a top/bottom edge it should still be exactly the
        (alpha-faded) top/bottom color no matter what the smoothness is. */
-    interpolatedColor = mix(styles[style].topColor, styles[style].bottomColor, 0.5*centerDistance.y/halfQuadSize.y + 0.5)*color;
+    interpolatedColor = mix(styles[style].topColor, styles[style].bottomColor, 0.5*centerDistance.y/halfQuadSize.y + 0.5)*nodeColor;
     interpolatedCenterDistance = centerDistance;
     #ifdef TEXTURED
     /* Texture coordinates are already containing the smoothness expansion,
@@ -122,9 +231,13 @@ void main() {
     interpolatedTextureCoordinates = textureCoordinates;
     #endif
 
+    #ifdef SHADER_CLIPPING
+    clipPosition = nodeOffset + position;
+    #endif
+
     /* The projection scales from UI size to the 2x2 unit square and Y-flips,
        the (-1, 1) then translates the origin from top left to center */
-    gl_Position = vec4(projection.xy*position + vec2(-1.0, 1.0), 0.0, 1.0);
+    gl_Position = vec4(projection.xy*(nodeOffset + position) + vec2(-1.0, 1.0), 0.0, 1.0);
 
     /* Case with 16 subdivided quads. They're all initially positioned in the
        corners and get expanded based on corner radii, outline width and
@@ -216,13 +329,17 @@ void main() {
         (cornerId & 1) == 0 ? +1.0 : -1.0,
         (cornerId & 2) == 0 ? +1.0 : -1.0);
 
+    #ifdef SHADER_CLIPPING
+    clipPosition = nodeOffset + shift + position;
+    #endif
+
     /* The projection scales from UI size to the 2x2 unit square and Y-flips,
        the (-1, 1) then translates the origin from top left to center */
-    gl_Position = vec4(projection.xy*(shift + position) + vec2(-1.0, 1.0), 0.0, 1.0);
+    gl_Position = vec4(projection.xy*(nodeOffset + shift + position) + vec2(-1.0, 1.0), 0.0, 1.0);
 
     /* Compared to the non-SUBDIVIDED_QUADS case above, here it's both
        interpolated and extrapolated */
-    interpolatedColor = mix(styles[style].topColor, styles[style].bottomColor, 0.5*(centerDistanceY + shift.y)/abs(centerDistanceY) + 0.5)*color;
+    interpolatedColor = mix(styles[style].topColor, styles[style].bottomColor, 0.5*(centerDistanceY + shift.y)/abs(centerDistanceY) + 0.5)*nodeColor;
 
     #ifdef TEXTURED
     interpolatedTextureCoordinates = textureCoordinates + vec3(shift*textureScale, 0.0);
@@ -26,6 +26,8 @@
 
 #include "Button.h"
 
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Containers/StringView.h>
 #include <Corrade/Utility/Assert.h>
 #include <Magnum/Math/Vector2.h>
@@ -307,4 +309,28 @@ Anchor button(const Anchor& anchor, const Containers::StringView text, const But
     return button(anchor, text, {}, style);
 }
 
+void buttons(UserInterface& ui, const NodeHandle parent, const Containers::StridedArrayView1D<const Vector2>& offsets, const Containers::StridedArrayView1D<const Vector2>& sizes, const Containers::StridedArrayView1D<const Icon>& icons, const Containers::StridedArrayView1D<const Containers::StringView>& texts, const Containers::StridedArrayView1D<const ButtonStyle>& styles, const Containers::StridedArrayView1D<NodeHandle>& nodes) {
+    const std::size_t count = offsets.size();
+    CORRADE_ASSERT(sizes.size() == count && styles.size() == count && nodes.size() == count,
+        "Ui::buttons(): expected offset, size, style and node views to have the same size but got" << count << Debug::nospace << "," << sizes.size() << Debug::nospace << "," << styles.size() << "and" << nodes.size(), );
+    CORRADE_ASSERT((icons.isEmpty() || icons.size() == count) && (texts.isEmpty() || texts.size() == count),
+        "Ui::buttons(): expected icon and text views to be either empty or have a size of" << count << "but got" << icons.size() << "and" << texts.size(), );
+
+    ui.createNodes(parent, offsets, sizes, {}, nodes);
+
+    /* Grow the layer storage just once. It's conservative as some buttons
+       may be without an icon or a text and some data may get taken from the
+       free list, but that's fine as it's just capacity. */
+    BaseLayer& baseLayer = ui.baseLayer();
+    TextLayer& textLayer = ui.textLayer();
+    baseLayer.reserve(baseLayer.usedCount() + count);
+    textLayer.reserve(textLayer.usedCount() + (icons.isEmpty() ? 0 : count) + (texts.isEmpty() ? 0 : count));
+
+    for(std::size_t i = 0; i != count; ++i)
+        buttonInternal(ui, nodes[i],
+            icons.isEmpty() ? Icon::None : icons[i],
+            texts.isEmpty() ? Containers::StringView{} : texts[i],
+            {}, styles[i]);
+}
+
 }}
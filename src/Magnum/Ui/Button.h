@@ -27,7 +27,7 @@
 */
 
 /** @file
- * @brief Class @ref Magnum::Ui::Button, function @ref Magnum::Ui::button(), enum @ref Magnum::Ui::ButtonStyle
+ * @brief Class @ref Magnum::Ui::Button, function @ref Magnum::Ui::button(), @ref Magnum::Ui::buttons(), enum @ref Magnum::Ui::ButtonStyle
  * @m_since_latest
  */
 
@@ -254,6 +254,35 @@ MAGNUM_UI_EXPORT Anchor button(const Anchor& anchor, Icon icon, Containers::Stri
 /** @overload */
 MAGNUM_UI_EXPORT Anchor button(const Anchor& anchor, Icon icon, Containers::StringView text, ButtonStyle style = ButtonStyle::Default);
 
+/**
+@brief Create multiple stateless buttons
+@param[in] ui       User interface to create the buttons in
+@param[in] parent   Parent node to attach to or @ref NodeHandle::Null for
+    top-level buttons. Expected to be valid if not null.
+@param[in] offsets  Button offsets relative to the parent node
+@param[in] sizes    Button sizes
+@param[in] icons    Button icons. If empty, all buttons are created without
+    an icon, otherwise passing @ref Icon::None creates given button without an
+    icon.
+@param[in] texts    Button texts. If empty, all buttons are created without a
+    text, otherwise passing an empty string creates given button without a
+    text.
+@param[in] styles   Button styles
+@param[out] nodes   Where to put created button node handles
+@m_since_latest
+
+Equivalent to calling @ref button(const Anchor&, Icon, Containers::StringView, ButtonStyle)
+with a custom-positioned anchor for each item, but with the node storage and
+the base and text layer storage grown just once and the node state updated
+just once for all buttons. Meant for building whole forms or tables from a
+list of widget descriptions, a list of structures can be passed in via
+@ref Corrade::Containers::StridedArrayView::slice() "slice()". Expects that
+the @p offsets, @p sizes, @p styles and @p nodes views all have the same size
+and the @p icons and @p texts views are either empty or have the same size as
+well.
+*/
+MAGNUM_UI_EXPORT void buttons(UserInterface& ui, NodeHandle parent, const Containers::StridedArrayView1D<const Vector2>& offsets, const Containers::StridedArrayView1D<const Vector2>& sizes, const Containers::StridedArrayView1D<const Icon>& icons, const Containers::StridedArrayView1D<const Containers::StringView>& texts, const Containers::StridedArrayView1D<const ButtonStyle>& styles, const Containers::StridedArrayView1D<NodeHandle>& nodes);
+
 }}
 
 #endif
@@ -270,4 +270,73 @@ Containers::Optional<Vector2> KeyEvent::position() const {
         Containers::optional(_position);
 }
 
+Debug& operator<<(Debug& debug, const InputEventType value) {
+    debug << "Ui::InputEventType" << Debug::nospace;
+
+    switch(value) {
+        /* LCOV_EXCL_START */
+        #define _c(value) case InputEventType::value: return debug << "::" #value;
+        _c(PointerPress)
+        _c(PointerRelease)
+        _c(PointerMove)
+        _c(KeyPress)
+        _c(KeyRelease)
+        _c(TextInput)
+        #undef _c
+        /* LCOV_EXCL_STOP */
+    }
+
+    return debug << "(" << Debug::nospace << Debug::hex << UnsignedByte(value) << Debug::nospace << ")";
+}
+
+InputEvent InputEvent::pointerPress(const Nanoseconds time, const Vector2& globalPosition, const PointerEventSource source, const Pointer pointer, const bool primary, const Long id) {
+    InputEvent out{InputEventType::PointerPress, time};
+    out._globalPosition = globalPosition;
+    out._source = source;
+    out._pointer = pointer;
+    out._primary = primary;
+    out._id = id;
+    return out;
+}
+
+InputEvent InputEvent::pointerRelease(const Nanoseconds time, const Vector2& globalPosition, const PointerEventSource source, const Pointer pointer, const bool primary, const Long id) {
+    InputEvent out = pointerPress(time, globalPosition, source, pointer, primary, id);
+    out._type = InputEventType::PointerRelease;
+    return out;
+}
+
+InputEvent InputEvent::pointerMove(const Nanoseconds time, const Vector2& globalPosition, const PointerEventSource source, const Containers::Optional<Pointer> pointer, const Pointers pointers, const bool primary, const Long id) {
+    InputEvent out{InputEventType::PointerMove, time};
+    out._globalPosition = globalPosition;
+    out._source = source;
+    out._pointer = pointer ? *pointer : Pointer{};
+    out._pointers = pointers;
+    out._primary = primary;
+    out._id = id;
+    return out;
+}
+
+InputEvent InputEvent::keyPress(const Nanoseconds time, const Key key, const Modifiers modifiers) {
+    InputEvent out{InputEventType::KeyPress, time};
+    out._key = key;
+    out._modifiers = modifiers;
+    return out;
+}
+
+InputEvent InputEvent::keyRelease(const Nanoseconds time, const Key key, const Modifiers modifiers) {
+    InputEvent out = keyPress(time, key, modifiers);
+    out._type = InputEventType::KeyRelease;
+    return out;
+}
+
+InputEvent InputEvent::textInput(const Nanoseconds time, const Containers::StringView text) {
+    InputEvent out{InputEventType::TextInput, time};
+    out._text = text;
+    return out;
+}
+
+Containers::Optional<Pointer> InputEvent::pointer() const {
+    return _pointer == Pointer{} ? Containers::NullOpt : Containers::optional(_pointer);
+}
+
 }}
@@ -27,7 +27,7 @@
 */
 
 /** @file
- * @brief Class @ref Magnum::Ui::PointerEvent, @ref Magnum::Ui::PointerMoveEvent, @ref Magnum::Ui::FocusEvent, @ref Magnum::Ui::KeyEvent, @ref Magnum::Ui::TextInputEvent, @ref Magnum::Ui::VisibilityLostEvent, enum @ref Magnum::Ui::Pointer, @ref Magnum::Ui::Key, @ref Magnum::Ui::Modifier, enum set @ref Magnum::Ui::Pointers, @ref Magnum::Ui::Modifiers
+ * @brief Class @ref Magnum::Ui::PointerEvent, @ref Magnum::Ui::PointerMoveEvent, @ref Magnum::Ui::FocusEvent, @ref Magnum::Ui::KeyEvent, @ref Magnum::Ui::TextInputEvent, @ref Magnum::Ui::VisibilityLostEvent, @ref Magnum::Ui::InputEvent, enum @ref Magnum::Ui::Pointer, @ref Magnum::Ui::Key, @ref Magnum::Ui::Modifier, @ref Magnum::Ui::InputEventType, enum set @ref Magnum::Ui::Pointers, @ref Magnum::Ui::Modifiers
  * @m_since_latest
  */
 
@@ -404,6 +404,17 @@ class MAGNUM_UI_EXPORT PointerMoveEvent {
          */
         Vector2 relativePosition() const { return _relativePosition; }
 
+        /**
+         * @brief Count of move events coalesced into this one
+         *
+         * If @ref AbstractUserInterface::setPointerMoveEventCoalescingEnabled()
+         * is enabled, contains the count of preceding move events of the same
+         * pointer that were dropped in favor of this one. The
+         * @ref relativePosition() then includes the motion of all of them.
+         * Is @cpp 0 @ce if no events were coalesced.
+         */
+        UnsignedInt coalescedCount() const { return _coalescedCount; }
+
         /**
          * @brief Whether the event is captured on a node
          *
@@ -488,6 +499,7 @@ class MAGNUM_UI_EXPORT PointerMoveEvent {
         Nanoseconds _time;
         Vector2 _position, _relativePosition;
         Long _id;
+        UnsignedInt _coalescedCount = 0;
         PointerEventSource _source;
         Pointer _pointer; /* NullOpt encoded as Pointer{} to avoid an include */
         Pointers _pointers;
@@ -1064,6 +1076,236 @@ class VisibilityLostEvent {
         bool _hovering = false;
 };
 
+/**
+@brief Input event type
+@m_since_latest
+
+@see @ref InputEvent, @ref AbstractUserInterface::dispatchEvents()
+*/
+enum class InputEventType: UnsignedByte {
+    /**
+     * Pointer press, dispatched to
+     * @ref AbstractUserInterface::pointerPressEvent()
+     */
+    PointerPress = 1,
+
+    /**
+     * Pointer release, dispatched to
+     * @ref AbstractUserInterface::pointerReleaseEvent()
+     */
+    PointerRelease,
+
+    /**
+     * Pointer move, dispatched to
+     * @ref AbstractUserInterface::pointerMoveEvent()
+     */
+    PointerMove,
+
+    /**
+     * Key press, dispatched to
+     * @ref AbstractUserInterface::keyPressEvent()
+     */
+    KeyPress,
+
+    /**
+     * Key release, dispatched to
+     * @ref AbstractUserInterface::keyReleaseEvent()
+     */
+    KeyRelease,
+
+    /**
+     * Text input, dispatched to
+     * @ref AbstractUserInterface::textInputEvent()
+     */
+    TextInput
+};
+
+/**
+@debugoperatorenum{InputEventType}
+@m_since_latest
+*/
+MAGNUM_UI_EXPORT Debug& operator<<(Debug& debug, InputEventType value);
+
+/**
+@brief Recorded input event
+@m_since_latest
+
+A plain description of a pointer, key or text input event together with its
+global position and timestamp, meant to be stored in an array and passed to
+@ref AbstractUserInterface::dispatchEvents(). Useful for example for replaying
+recorded input or for feeding input coming from a remote machine. Unlike
+@ref PointerEvent and other event classes, which are populated with node-local
+properties by @ref AbstractUserInterface during dispatch, this class only
+contains what's needed to create the actual event, and whether it was
+accepted. Properties that don't apply to given @ref type() are
+default-constructed.
+*/
+class MAGNUM_UI_EXPORT InputEvent {
+    public:
+        /**
+         * @brief Pointer press event
+         *
+         * The @p globalPosition has the same meaning as in
+         * @ref AbstractUserInterface::pointerPressEvent(), the remaining
+         * arguments are the same as in
+         * @ref PointerEvent::PointerEvent().
+         */
+        static InputEvent pointerPress(Nanoseconds time, const Vector2& globalPosition, PointerEventSource source, Pointer pointer, bool primary, Long id);
+
+        /**
+         * @brief Pointer release event
+         *
+         * The @p globalPosition has the same meaning as in
+         * @ref AbstractUserInterface::pointerReleaseEvent(), the remaining
+         * arguments are the same as in
+         * @ref PointerEvent::PointerEvent().
+         */
+        static InputEvent pointerRelease(Nanoseconds time, const Vector2& globalPosition, PointerEventSource source, Pointer pointer, bool primary, Long id);
+
+        /**
+         * @brief Pointer move event
+         *
+         * The @p globalPosition has the same meaning as in
+         * @ref AbstractUserInterface::pointerMoveEvent(), the remaining
+         * arguments are the same as in
+         * @ref PointerMoveEvent::PointerMoveEvent().
+         */
+        static InputEvent pointerMove(Nanoseconds time, const Vector2& globalPosition, PointerEventSource source, Containers::Optional<Pointer> pointer, Pointers pointers, bool primary, Long id);
+
+        /**
+         * @brief Key press event
+         *
+         * Arguments are the same as in @ref KeyEvent::KeyEvent().
+         */
+        static InputEvent keyPress(Nanoseconds time, Key key, Modifiers modifiers);
+
+        /**
+         * @brief Key release event
+         *
+         * Arguments are the same as in @ref KeyEvent::KeyEvent().
+         */
+        static InputEvent keyRelease(Nanoseconds time, Key key, Modifiers modifiers);
+
+        /**
+         * @brief Text input event
+         *
+         * Arguments are the same as in
+         * @ref TextInputEvent::TextInputEvent(). Expects that @p text is
+         * valid for the whole lifetime of the instance.
+         */
+        static InputEvent textInput(Nanoseconds time, Containers::StringView text);
+
+        /** @brief Event type */
+        InputEventType type() const { return _type; }
+
+        /** @brief Time at which the event happened */
+        Nanoseconds time() const { return _time; }
+
+        /**
+         * @brief Global event position
+         *
+         * Set only for @ref InputEventType::PointerPress,
+         * @relativeref{InputEventType,PointerRelease} and
+         * @relativeref{InputEventType,PointerMove}.
+         */
+        Vector2 globalPosition() const { return _globalPosition; }
+
+        /**
+         * @brief Pointer event source
+         *
+         * Set only for @ref InputEventType::PointerPress,
+         * @relativeref{InputEventType,PointerRelease} and
+         * @relativeref{InputEventType,PointerMove}.
+         */
+        PointerEventSource source() const { return _source; }
+
+        /**
+         * @brief Pointer type that got pressed, released or changed
+         *
+         * Set only for @ref InputEventType::PointerPress and
+         * @relativeref{InputEventType,PointerRelease}, for
+         * @relativeref{InputEventType,PointerMove} it's
+         * @relativeref{Corrade,Containers::NullOpt} if no pointer changed
+         * in the move.
+         */
+        Containers::Optional<Pointer> pointer() const;
+
+        /**
+         * @brief Pointer types pressed in the event
+         *
+         * Set only for @ref InputEventType::PointerMove.
+         */
+        Pointers pointers() const { return _pointers; }
+
+        /**
+         * @brief Whether the pointer is primary
+         *
+         * Set only for @ref InputEventType::PointerPress,
+         * @relativeref{InputEventType,PointerRelease} and
+         * @relativeref{InputEventType,PointerMove}.
+         */
+        bool isPrimary() const { return _primary; }
+
+        /**
+         * @brief Pointer ID
+         *
+         * Set only for @ref InputEventType::PointerPress,
+         * @relativeref{InputEventType,PointerRelease} and
+         * @relativeref{InputEventType,PointerMove}.
+         */
+        Long id() const { return _id; }
+
+        /**
+         * @brief Key that got pressed or released
+         *
+         * Set only for @ref InputEventType::KeyPress and
+         * @relativeref{InputEventType,KeyRelease}.
+         */
+        Key key() const { return _key; }
+
+        /**
+         * @brief Active keyboard modifiers
+         *
+         * Set only for @ref InputEventType::KeyPress and
+         * @relativeref{InputEventType,KeyRelease}.
+         */
+        Modifiers modifiers() const { return _modifiers; }
+
+        /**
+         * @brief Input text
+         *
+         * Set only for @ref InputEventType::TextInput.
+         */
+        Containers::StringView text() const { return _text; }
+
+        /**
+         * @brief Whether the event was accepted
+         *
+         * Implicitly @cpp false @ce, set by
+         * @ref AbstractUserInterface::dispatchEvents() to the value returned
+         * from the corresponding event handler.
+         */
+        bool isAccepted() const { return _accepted; }
+
+    private:
+        friend AbstractUserInterface;
+
+        explicit InputEvent(InputEventType type, Nanoseconds time) noexcept: _time{time}, _type{type} {}
+
+        Nanoseconds _time;
+        Vector2 _globalPosition;
+        Containers::StringView _text;
+        Long _id{};
+        Key _key{};
+        InputEventType _type;
+        PointerEventSource _source{};
+        Pointer _pointer{};
+        Pointers _pointers;
+        Modifiers _modifiers;
+        bool _primary = false;
+        bool _accepted = false;
+};
+
 }}
 
 #endif
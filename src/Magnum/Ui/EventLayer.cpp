@@ -30,18 +30,16 @@
 #include <Corrade/Containers/BitArrayView.h>
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Function.h>
+#include <Magnum/Math/Time.h>
 #include <Magnum/Platform/Gesture.h>
 
 #include "Magnum/Ui/Handle.h"
 #include "Magnum/Ui/Event.h"
+#include "Magnum/Ui/MemoryUsage.h"
+#include "Magnum/Ui/Implementation/memoryUsage.h"
 
 namespace Magnum { namespace Ui {
 
-/* EventConnection converts DataHandle to LayerDataHandle by taking the lower
-   32 bits. Check that the bit counts didn't get out of sync since that
-   assumption. */
-static_assert(Implementation::LayerDataHandleIdBits + Implementation::LayerDataHandleGenerationBits == 32, "EventConnection DataHandle to LayerDataHandle conversion needs an update");
-
 namespace Implementation {
     enum class EventType: UnsignedByte {
         Enter,
@@ -54,35 +52,66 @@ namespace Implementation {
         MiddleClick,
         RightClick,
         Drag,
-        Pinch
+        Pinch,
+        LongPress
     };
 }
 
 namespace {
 
+struct SharedSlotReference {
+    UnsignedInt id;
+    UnsignedInt payload;
+};
+
 struct Data {
     Containers::FunctionData slot;
     Implementation::EventType eventType;
     bool hasScopedConnection;
-    /* 6+ bytes free */
-    /** @todo ideally this would be inlined directly inside FunctionData.call,
-        somehow -- e.g. an extra template argument to Function that decouples
-        the actual wrapped signature from the call signature */
-    void(*call)();
+    /* If set, slot is empty and the call is dispatched to
+       State::sharedSlots[shared.id] instead */
+    bool hasSharedSlot;
+    /* 1+ bytes free */
+    /* Used only by EventType::LongPress, in microseconds to fit into the
+       padding */
+    UnsignedInt longPressDuration;
+    union {
+        /** @todo ideally this would be inlined directly inside
+            FunctionData.call, somehow -- e.g. an extra template argument to
+            Function that decouples the actual wrapped signature from the call
+            signature */
+        void(*call)();
+        SharedSlotReference shared;
+    };
 };
 
+/* Calls either the per-data slot or the shared one */
+template<class Event> inline void callSlot(Containers::ArrayView<Containers::Function<void(UnsignedInt)>> sharedSlots, Data& data, const Event& event) {
+    if(data.hasSharedSlot)
+        sharedSlots[data.shared.id](data.shared.payload);
+    else
+        reinterpret_cast<void(*)(Containers::FunctionData&, const Event&)>(data.call)(data.slot, event);
+}
+
 }
 
 struct EventLayer::State {
     Containers::Array<Data> data;
+    Containers::Array<Containers::Function<void(UnsignedInt)>> sharedSlots;
 
     Platform::TwoFingerGesture twoFingerGesture;
     UnsignedInt twoFingerGestureData = ~UnsignedInt{};
 
+    /* Data on which a long press is currently tracked, together with time and
+       node-relative position of the press */
+    UnsignedInt longPressData = ~UnsignedInt{};
+    Nanoseconds longPressTime;
+    Vector2 longPressPosition;
+
     UnsignedInt usedScopedConnectionCount = 0;
 };
 
-EventConnection::EventConnection(EventLayer& layer, DataHandle data) noexcept: _layer{layer}, _data{LayerDataHandle(UnsignedLong(data))} {
+EventConnection::EventConnection(EventLayer& layer, DataHandle data) noexcept: _layer{layer}, _data{dataHandleData(data)} {
     layer._state->data[dataHandleId(data)].hasScopedConnection = true;
     ++layer._state->usedScopedConnectionCount;
 }
@@ -134,6 +163,39 @@ EventLayer& EventLayer::operator=(EventLayer&& other) noexcept {
     return *this;
 }
 
+void EventLayer::doReserve(const std::size_t capacity) {
+    arrayReserve(_state->data, capacity);
+}
+
+void EventLayer::doMemoryUsage(MemoryUsage& usage) const {
+    /* Slots that don't fit into the function storage are allocated on the
+       heap, with their size unknown, so they're not counted */
+    usage.cpuByteCount +=
+        Implementation::arrayByteCount(_state->data) +
+        Implementation::arrayByteCount(_state->sharedSlots);
+}
+
+void EventLayer::doCompact(const Containers::StridedArrayView1D<const UnsignedInt>& previousDataIds) {
+    State& state = *_state;
+    /* EventConnection instances hold the data handle and there's no way to
+       update them */
+    CORRADE_ASSERT(!state.usedScopedConnectionCount,
+        "Ui::EventLayer::compact(): can't compact with" << state.usedScopedConnectionCount << "scoped connections active", );
+
+    for(std::size_t i = 0; i != previousDataIds.size(); ++i) {
+        const UnsignedInt previous = previousDataIds[i];
+        if(previous == ~UnsignedInt{} || previous == i)
+            continue;
+        state.data[i] = Utility::move(state.data[previous]);
+        if(state.twoFingerGestureData == previous)
+            state.twoFingerGestureData = i;
+        if(state.longPressData == previous)
+            state.longPressData = i;
+    }
+    arrayResize(state.data, previousDataIds.size());
+    arrayShrink(state.data);
+}
+
 LayerFeatures EventLayer::doFeatures() const {
     return LayerFeature::Event;
 }
@@ -171,10 +233,45 @@ DataHandle EventLayer::create(const NodeHandle node, const Implementation::Event
     data.eventType = eventType;
     data.slot = Utility::move(slot);
     data.hasScopedConnection = false;
+    data.hasSharedSlot = false;
     data.call = call;
     return handle;
 }
 
+UnsignedInt EventLayer::addSharedSlot(Containers::Function<void(UnsignedInt)>&& slot) {
+    CORRADE_ASSERT(slot,
+        "Ui::EventLayer::addSharedSlot(): slot is null", {});
+
+    arrayAppend(_state->sharedSlots, Utility::move(slot));
+    return _state->sharedSlots.size() - 1;
+}
+
+UnsignedInt EventLayer::sharedSlotCount() const {
+    return _state->sharedSlots.size();
+}
+
+DataHandle EventLayer::createShared(const NodeHandle node, const Implementation::EventType eventType, const UnsignedInt sharedSlot, const UnsignedInt payload) {
+    State& state = *_state;
+    CORRADE_ASSERT(sharedSlot < state.sharedSlots.size(),
+        /* Same reasoning as in create() for not mentioning the function */
+        "Ui::EventLayer: shared slot" << sharedSlot << "out of range for" << state.sharedSlots.size() << "shared slots", {});
+
+    const DataHandle handle = AbstractLayer::create(node);
+    const UnsignedInt id = dataHandleId(handle);
+    if(id >= state.data.size())
+        arrayResize(state.data, id + 1);
+
+    /* The slot is left empty, either from the zero-initialization above or
+       from removeInternal() */
+    Data& data = state.data[id];
+    data.eventType = eventType;
+    data.hasScopedConnection = false;
+    data.hasSharedSlot = true;
+    data.shared.id = sharedSlot;
+    data.shared.payload = payload;
+    return handle;
+}
+
 DataHandle EventLayer::onPress(const NodeHandle node, Containers::Function<void()>&& slot) {
     return create(node, Implementation::EventType::Press, Utility::move(slot),
         reinterpret_cast<void(*)()>(
@@ -348,6 +445,43 @@ DataHandle EventLayer::onPinch(const NodeHandle node, Containers::Function<void(
         })));
 }
 
+DataHandle EventLayer::onLongPress(const NodeHandle node, const Nanoseconds duration, Containers::Function<void()>&& slot) {
+    CORRADE_ASSERT(duration > Nanoseconds{} && Long(duration) <= Long(~UnsignedInt{})*1000,
+        "Ui::EventLayer::onLongPress(): expected a positive duration fitting into 32 bits in microseconds", {});
+    const DataHandle handle = create(node, Implementation::EventType::LongPress, Utility::move(slot),
+        reinterpret_cast<void(*)()>(
+            #ifndef CORRADE_MSVC2015_COMPATIBILITY
+            +
+            #else
+            static_cast<void(*)(Containers::FunctionData&, const Vector2&)>
+            #endif
+        ([](Containers::FunctionData& slot, const Vector2&) {
+            static_cast<Containers::Function<void()>&>(slot)();
+        })));
+    /* create() returns a null handle only on a graceful assert */
+    if(handle != DataHandle::Null)
+        _state->data[dataHandleId(handle)].longPressDuration = Long(duration)/1000;
+    return handle;
+}
+
+DataHandle EventLayer::onLongPress(const NodeHandle node, const Nanoseconds duration, Containers::Function<void(const Vector2&)>&& slot) {
+    CORRADE_ASSERT(duration > Nanoseconds{} && Long(duration) <= Long(~UnsignedInt{})*1000,
+        "Ui::EventLayer::onLongPress(): expected a positive duration fitting into 32 bits in microseconds", {});
+    const DataHandle handle = create(node, Implementation::EventType::LongPress, Utility::move(slot),
+        reinterpret_cast<void(*)()>(
+            #ifndef CORRADE_MSVC2015_COMPATIBILITY
+            +
+            #else
+            static_cast<void(*)(Containers::FunctionData&, const Vector2&)>
+            #endif
+        ([](Containers::FunctionData& slot, const Vector2& position) {
+            static_cast<Containers::Function<void(const Vector2&)>&>(slot)(position);
+        })));
+    if(handle != DataHandle::Null)
+        _state->data[dataHandleId(handle)].longPressDuration = Long(duration)/1000;
+    return handle;
+}
+
 DataHandle EventLayer::onEnter(const NodeHandle node, Containers::Function<void()>&& slot) {
     return create(node, Implementation::EventType::Enter, Utility::move(slot),
         reinterpret_cast<void(*)()>(
@@ -400,6 +534,42 @@ DataHandle EventLayer::onBlur(const NodeHandle node, Containers::Function<void()
         })));
 }
 
+DataHandle EventLayer::onPress(const NodeHandle node, const UnsignedInt sharedSlot, const UnsignedInt payload) {
+    return createShared(node, Implementation::EventType::Press, sharedSlot, payload);
+}
+
+DataHandle EventLayer::onRelease(const NodeHandle node, const UnsignedInt sharedSlot, const UnsignedInt payload) {
+    return createShared(node, Implementation::EventType::Release, sharedSlot, payload);
+}
+
+DataHandle EventLayer::onTapOrClick(const NodeHandle node, const UnsignedInt sharedSlot, const UnsignedInt payload) {
+    return createShared(node, Implementation::EventType::TapOrClick, sharedSlot, payload);
+}
+
+DataHandle EventLayer::onMiddleClick(const NodeHandle node, const UnsignedInt sharedSlot, const UnsignedInt payload) {
+    return createShared(node, Implementation::EventType::MiddleClick, sharedSlot, payload);
+}
+
+DataHandle EventLayer::onRightClick(const NodeHandle node, const UnsignedInt sharedSlot, const UnsignedInt payload) {
+    return createShared(node, Implementation::EventType::RightClick, sharedSlot, payload);
+}
+
+DataHandle EventLayer::onEnter(const NodeHandle node, const UnsignedInt sharedSlot, const UnsignedInt payload) {
+    return createShared(node, Implementation::EventType::Enter, sharedSlot, payload);
+}
+
+DataHandle EventLayer::onLeave(const NodeHandle node, const UnsignedInt sharedSlot, const UnsignedInt payload) {
+    return createShared(node, Implementation::EventType::Leave, sharedSlot, payload);
+}
+
+DataHandle EventLayer::onFocus(const NodeHandle node, const UnsignedInt sharedSlot, const UnsignedInt payload) {
+    return createShared(node, Implementation::EventType::Focus, sharedSlot, payload);
+}
+
+DataHandle EventLayer::onBlur(const NodeHandle node, const UnsignedInt sharedSlot, const UnsignedInt payload) {
+    return createShared(node, Implementation::EventType::Blur, sharedSlot, payload);
+}
+
 void EventLayer::remove(DataHandle handle) {
     AbstractLayer::remove(handle);
     removeInternal(dataHandleId(handle));
@@ -429,6 +599,8 @@ void EventLayer::removeInternal(const UnsignedInt id) {
         state.twoFingerGestureData = ~UnsignedInt{};
         state.twoFingerGesture = Platform::TwoFingerGesture{};
     }
+    if(data.eventType == Implementation::EventType::LongPress && state.longPressData == id)
+        state.longPressData = ~UnsignedInt{};
 }
 
 void EventLayer::doClean(const Containers::BitArrayView dataIdsToRemove) {
@@ -482,7 +654,22 @@ void EventLayer::doPointerPressEvent(const UnsignedInt dataId, PointerEvent& eve
     if(data.eventType == Implementation::EventType::Press &&
         event.pointer() & (Pointer::MouseLeft|Pointer::Finger|Pointer::Pen))
     {
-        reinterpret_cast<void(*)(Containers::FunctionData&, const PointerEvent&)>(data.call)(data.slot, event);
+        callSlot(state.sharedSlots, data, event);
+        event.setAccepted();
+        return;
+    }
+
+    /* Remember when and where a long press started, accept the event so the
+       node gets captured and receives the subsequent moves and release */
+    /** @todo similarly to onPinch(), this will be broken if there's more than
+        one onLongPress() attached to the same node, as only the last one gets
+        remembered */
+    if(data.eventType == Implementation::EventType::LongPress &&
+        event.pointer() & (Pointer::MouseLeft|Pointer::Finger|Pointer::Pen))
+    {
+        state.longPressData = dataId;
+        state.longPressTime = event.time();
+        state.longPressPosition = event.position();
         event.setAccepted();
         return;
     }
@@ -529,7 +716,21 @@ void EventLayer::doPointerReleaseEvent(const UnsignedInt dataId, PointerEvent& e
     if(data.eventType == Implementation::EventType::Release &&
         event.pointer() & (Pointer::MouseLeft|Pointer::Finger|Pointer::Pen))
     {
-        reinterpret_cast<void(*)(Containers::FunctionData&, const PointerEvent&)>(data.call)(data.slot, event);
+        callSlot(state.sharedSlots, data, event);
+        event.setAccepted();
+        return;
+    }
+
+    /* Fire a long press if it was held long enough, and stop tracking it in
+       any case */
+    if(data.eventType == Implementation::EventType::LongPress &&
+        event.pointer() & (Pointer::MouseLeft|Pointer::Finger|Pointer::Pen))
+    {
+        if(state.longPressData == dataId) {
+            state.longPressData = ~UnsignedInt{};
+            if(event.isHovering() && event.time() - state.longPressTime >= Nanoseconds{Long(data.longPressDuration)*1000})
+                reinterpret_cast<void(*)(Containers::FunctionData&, const Vector2&)>(data.call)(data.slot, state.longPressPosition);
+        }
         event.setAccepted();
         return;
     }
@@ -551,7 +752,8 @@ void EventLayer::doPointerReleaseEvent(const UnsignedInt dataId, PointerEvent& e
 void EventLayer::doPointerTapOrClickEvent(const UnsignedInt dataId, PointerEvent& event) {
     /* event is guaranteed to be primary by AbstractLayer */
 
-    Data& data = _state->data[dataId];
+    State& state = *_state;
+    Data& data = state.data[dataId];
     if((data.eventType == Implementation::EventType::TapOrClick &&
             event.pointer() & (Pointer::MouseLeft|Pointer::Finger|Pointer::Pen)) ||
        (data.eventType == Implementation::EventType::MiddleClick &&
@@ -559,7 +761,7 @@ void EventLayer::doPointerTapOrClickEvent(const UnsignedInt dataId, PointerEvent
        (data.eventType == Implementation::EventType::RightClick &&
             event.pointer() == Pointer::MouseRight))
     {
-        reinterpret_cast<void(*)(Containers::FunctionData&, const PointerEvent&)>(data.call)(data.slot, event);
+        callSlot(state.sharedSlots, data, event);
         event.setAccepted();
     }
 }
@@ -604,6 +806,24 @@ void EventLayer::doPointerMoveEvent(const UnsignedInt dataId, PointerMoveEvent&
         event.setAccepted();
     }
 
+    /* Fire a long press on the first move after it was held long enough,
+       cancel it if the pointer leaves the node. The slot is called at most
+       once, as the tracking is stopped right after. */
+    if(data.eventType == Implementation::EventType::LongPress &&
+        (event.pointers() & (Pointer::MouseLeft|Pointer::Finger|Pointer::Pen)) &&
+        event.isCaptured())
+    {
+        if(state.longPressData == dataId) {
+            if(!event.isHovering())
+                state.longPressData = ~UnsignedInt{};
+            else if(event.time() - state.longPressTime >= Nanoseconds{Long(data.longPressDuration)*1000}) {
+                state.longPressData = ~UnsignedInt{};
+                reinterpret_cast<void(*)(Containers::FunctionData&, const Vector2&)>(data.call)(data.slot, state.longPressPosition);
+            }
+        }
+        event.setAccepted();
+    }
+
     /* Accept also a move that's needed in order to synthesize an enter/leave
        event */
     if(data.eventType == Implementation::EventType::Enter ||
@@ -614,9 +834,10 @@ void EventLayer::doPointerMoveEvent(const UnsignedInt dataId, PointerMoveEvent&
 void EventLayer::doPointerEnterEvent(const UnsignedInt dataId, PointerMoveEvent& event) {
     /* event is guaranteed to be primary by AbstractLayer */
 
-    Data& data = _state->data[dataId];
+    State& state = *_state;
+    Data& data = state.data[dataId];
     if(data.eventType == Implementation::EventType::Enter) {
-        reinterpret_cast<void(*)(Containers::FunctionData&, const PointerMoveEvent&)>(data.call)(data.slot, event);
+        callSlot(state.sharedSlots, data, event);
         /* Accept status is ignored on enter/leave events, no need to call
            setAccepted() */
     }
@@ -625,26 +846,29 @@ void EventLayer::doPointerEnterEvent(const UnsignedInt dataId, PointerMoveEvent&
 void EventLayer::doPointerLeaveEvent(const UnsignedInt dataId, PointerMoveEvent& event) {
     /* event is guaranteed to be primary by AbstractLayer */
 
-    Data& data = _state->data[dataId];
+    State& state = *_state;
+    Data& data = state.data[dataId];
     if(data.eventType == Implementation::EventType::Leave) {
-        reinterpret_cast<void(*)(Containers::FunctionData&, const PointerMoveEvent&)>(data.call)(data.slot, event);
+        callSlot(state.sharedSlots, data, event);
         /* Accept status is ignored on enter/leave events, no need to call
            setAccepted() */
     }
 }
 
 void EventLayer::doFocusEvent(const UnsignedInt dataId, FocusEvent& event) {
-    Data& data = _state->data[dataId];
+    State& state = *_state;
+    Data& data = state.data[dataId];
     if(data.eventType == Implementation::EventType::Focus) {
-        reinterpret_cast<void(*)(Containers::FunctionData&, const FocusEvent&)>(data.call)(data.slot, event);
+        callSlot(state.sharedSlots, data, event);
         event.setAccepted();
     }
 }
 
 void EventLayer::doBlurEvent(const UnsignedInt dataId, FocusEvent& event) {
-    Data& data = _state->data[dataId];
+    State& state = *_state;
+    Data& data = state.data[dataId];
     if(data.eventType == Implementation::EventType::Blur) {
-        reinterpret_cast<void(*)(Containers::FunctionData&, const FocusEvent&)>(data.call)(data.slot, event);
+        callSlot(state.sharedSlots, data, event);
         /* Accept status is ignored on blur events, no need to call
            setAccepted() */
     }
@@ -660,6 +884,8 @@ void EventLayer::doVisibilityLostEvent(const UnsignedInt dataId, VisibilityLostE
         state.twoFingerGestureData = ~UnsignedInt{};
         state.twoFingerGesture = Platform::TwoFingerGesture{};
     }
+    if(data.eventType == Implementation::EventType::LongPress && state.longPressData == dataId)
+        state.longPressData = ~UnsignedInt{};
 }
 
 }}
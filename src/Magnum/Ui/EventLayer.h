@@ -104,9 +104,9 @@ class MAGNUM_UI_EXPORT EventConnection {
     private:
         friend EventLayer;
 
-        /* LayerDataHandle is the lower 32 bits of DataHandle. Not using
-           dataHandleData() to avoid dependency on Handle.h, additionally
-           checked with a static_assert() in the source file. */
+        /* Takes a DataHandle instead of a LayerDataHandle to avoid a
+           dependency on Handle.h in the header, the LayerDataHandle is
+           extracted with dataHandleData() in the source file. */
         explicit EventConnection(EventLayer& layer, DataHandle data) noexcept;
 
         Containers::Reference<EventLayer> _layer;
@@ -441,6 +441,53 @@ class MAGNUM_UI_EXPORT EventLayer: public AbstractLayer {
             return EventConnection{*this, onPinch(node, Utility::move(slot))};
         }
 
+        /**
+         * @brief Connect to a long press
+         * @m_since_latest
+         *
+         * The @p slot, optionally receiving a node-relative position at which
+         * the press happened, is called when a @ref Pointer::MouseLeft,
+         * primary @ref Pointer::Finger or @ref Pointer::Pen is pressed on the
+         * @p node and held for at least @p duration without leaving the node
+         * area. Expects that the @p slot is not @cpp nullptr @ce and that
+         * @p duration is positive and fits into 32 bits when expressed in
+         * microseconds, i.e. is at most a bit over an hour.
+         *
+         * As the layer has no notion of time apart from
+         * @ref PointerEvent::time() and @ref PointerMoveEvent::time(), the
+         * slot is called on the first pointer move or release event on the
+         * node that's at least @p duration after the press, and at most once
+         * for every press. A move outside of the node area cancels the long
+         * press. The state is tracked for just one press at a time and
+         * doesn't involve any allocation.
+         *
+         * The returned @ref DataHandle is automatically removed once @p node
+         * or any of its parents is removed, it's the caller responsibility to
+         * ensure it doesn't outlive the state captured in the @p slot. See
+         * @ref onLongPressScoped() for a scoped alternative.
+         */
+        DataHandle onLongPress(NodeHandle node, Nanoseconds duration, Containers::Function<void()>&& slot);
+
+        /** @overload */
+        DataHandle onLongPress(NodeHandle node, Nanoseconds duration, Containers::Function<void(const Vector2& position)>&& slot);
+
+        /**
+         * @brief Scoped connection to a long press
+         * @m_since_latest
+         *
+         * Compared to @ref onLongPress() the connection is removed
+         * automatically when the returned @ref EventConnection gets
+         * destroyed.
+         */
+        EventConnection onLongPressScoped(NodeHandle node, Nanoseconds duration, Containers::Function<void()>&& slot) {
+            return EventConnection{*this, onLongPress(node, duration, Utility::move(slot))};
+        }
+
+        /** @overload */
+        EventConnection onLongPressScoped(NodeHandle node, Nanoseconds duration, Containers::Function<void(const Vector2& position)>&& slot) {
+            return EventConnection{*this, onLongPress(node, duration, Utility::move(slot))};
+        }
+
         /**
          * @brief Connect to a pointer enter
          *
@@ -539,6 +586,116 @@ class MAGNUM_UI_EXPORT EventLayer: public AbstractLayer {
             return EventConnection{*this, onBlur(node, Utility::move(slot))};
         }
 
+        /**
+         * @brief Add a shared slot
+         *
+         * Returns an ID that can be passed to the @ref onPress(NodeHandle, UnsignedInt, UnsignedInt)
+         * etc. overloads. Compared to connecting a dedicated
+         * @relativeref{Corrade,Containers::Function} to each node, a shared
+         * slot is stored just once and each connection stores only the
+         * shared slot ID and an arbitrary @p payload that's passed to
+         * the @p slot when the event happens, such as a row index in a
+         * large grid of clickable cells. Such connections don't contribute
+         * to @ref usedAllocatedConnectionCount() and are all dispatched
+         * through the same function object. Expects that the @p slot is not
+         * @cpp nullptr @ce.
+         *
+         * Shared slots are kept until the layer is destroyed, it's the caller
+         * responsibility to ensure they don't outlive the state captured in
+         * them.
+         * @see @ref sharedSlotCount()
+         * @todo some way to remove shared slots once no data reference them
+         */
+        UnsignedInt addSharedSlot(Containers::Function<void(UnsignedInt payload)>&& slot);
+
+        /**
+         * @brief Count of shared slots
+         *
+         * @see @ref addSharedSlot()
+         */
+        UnsignedInt sharedSlotCount() const;
+
+        /**
+         * @brief Connect a shared slot to a finger / pen tap or left mouse press
+         *
+         * Like @ref onPress(NodeHandle, Containers::Function<void()>&&), but
+         * calls a slot added with @ref addSharedSlot() with @p payload.
+         * Expects that @p sharedSlot is less than @ref sharedSlotCount().
+         */
+        DataHandle onPress(NodeHandle node, UnsignedInt sharedSlot, UnsignedInt payload);
+
+        /**
+         * @brief Connect a shared slot to a finger / pen tap or left mouse release
+         *
+         * Like @ref onRelease(NodeHandle, Containers::Function<void()>&&), but
+         * calls a slot added with @ref addSharedSlot() with @p payload.
+         * Expects that @p sharedSlot is less than @ref sharedSlotCount().
+         */
+        DataHandle onRelease(NodeHandle node, UnsignedInt sharedSlot, UnsignedInt payload);
+
+        /**
+         * @brief Connect a shared slot to a finger / pen tap or left mouse click
+         *
+         * Like @ref onTapOrClick(NodeHandle, Containers::Function<void()>&&), but
+         * calls a slot added with @ref addSharedSlot() with @p payload.
+         * Expects that @p sharedSlot is less than @ref sharedSlotCount().
+         */
+        DataHandle onTapOrClick(NodeHandle node, UnsignedInt sharedSlot, UnsignedInt payload);
+
+        /**
+         * @brief Connect a shared slot to a middle mouse click
+         *
+         * Like @ref onMiddleClick(NodeHandle, Containers::Function<void()>&&), but
+         * calls a slot added with @ref addSharedSlot() with @p payload.
+         * Expects that @p sharedSlot is less than @ref sharedSlotCount().
+         */
+        DataHandle onMiddleClick(NodeHandle node, UnsignedInt sharedSlot, UnsignedInt payload);
+
+        /**
+         * @brief Connect a shared slot to a right mouse click
+         *
+         * Like @ref onRightClick(NodeHandle, Containers::Function<void()>&&), but
+         * calls a slot added with @ref addSharedSlot() with @p payload.
+         * Expects that @p sharedSlot is less than @ref sharedSlotCount().
+         */
+        DataHandle onRightClick(NodeHandle node, UnsignedInt sharedSlot, UnsignedInt payload);
+
+        /**
+         * @brief Connect a shared slot to a pointer enter
+         *
+         * Like @ref onEnter(NodeHandle, Containers::Function<void()>&&), but
+         * calls a slot added with @ref addSharedSlot() with @p payload.
+         * Expects that @p sharedSlot is less than @ref sharedSlotCount().
+         */
+        DataHandle onEnter(NodeHandle node, UnsignedInt sharedSlot, UnsignedInt payload);
+
+        /**
+         * @brief Connect a shared slot to a pointer leave
+         *
+         * Like @ref onLeave(NodeHandle, Containers::Function<void()>&&), but
+         * calls a slot added with @ref addSharedSlot() with @p payload.
+         * Expects that @p sharedSlot is less than @ref sharedSlotCount().
+         */
+        DataHandle onLeave(NodeHandle node, UnsignedInt sharedSlot, UnsignedInt payload);
+
+        /**
+         * @brief Connect a shared slot to a focus
+         *
+         * Like @ref onFocus(NodeHandle, Containers::Function<void()>&&), but
+         * calls a slot added with @ref addSharedSlot() with @p payload.
+         * Expects that @p sharedSlot is less than @ref sharedSlotCount().
+         */
+        DataHandle onFocus(NodeHandle node, UnsignedInt sharedSlot, UnsignedInt payload);
+
+        /**
+         * @brief Connect a shared slot to a blur
+         *
+         * Like @ref onBlur(NodeHandle, Containers::Function<void()>&&), but
+         * calls a slot added with @ref addSharedSlot() with @p payload.
+         * Expects that @p sharedSlot is less than @ref sharedSlotCount().
+         */
+        DataHandle onBlur(NodeHandle node, UnsignedInt sharedSlot, UnsignedInt payload);
+
         /**
          * @brief Remove a connection
          *
@@ -569,10 +726,14 @@ class MAGNUM_UI_EXPORT EventLayer: public AbstractLayer {
 
         /* Used internally from all templated create() overloads below */
         MAGNUM_UI_LOCAL DataHandle create(NodeHandle node, Implementation::EventType eventType, Containers::FunctionData&& slot, void(*call)());
+        MAGNUM_UI_LOCAL DataHandle createShared(NodeHandle node, Implementation::EventType eventType, UnsignedInt sharedSlot, UnsignedInt payload);
         MAGNUM_UI_LOCAL void removeInternal(UnsignedInt id);
 
         MAGNUM_UI_LOCAL LayerFeatures doFeatures() const override;
         MAGNUM_UI_LOCAL void doClean(Containers::BitArrayView dataIdsToRemove) override;
+        MAGNUM_UI_LOCAL void doReserve(std::size_t capacity) override;
+        MAGNUM_UI_LOCAL void doMemoryUsage(MemoryUsage& usage) const override;
+        MAGNUM_UI_LOCAL void doCompact(const Containers::StridedArrayView1D<const UnsignedInt>& previousDataIds) override;
 
         MAGNUM_UI_LOCAL void doPointerPressEvent(UnsignedInt dataId, PointerEvent& event) override;
         MAGNUM_UI_LOCAL void doPointerReleaseEvent(UnsignedInt dataId, PointerEvent& event) override;
@@ -105,8 +105,13 @@ constexpr UnsignedInt layerHandleGeneration(LayerHandle handle) {
 
 namespace Implementation {
     enum: UnsignedInt {
+        #ifndef MAGNUM_UI_LARGE_HANDLES
         LayerDataHandleIdBits = 20,
         LayerDataHandleGenerationBits = 12
+        #else
+        LayerDataHandleIdBits = 24,
+        LayerDataHandleGenerationBits = 15
+        #endif
     };
 }
 
@@ -114,12 +119,18 @@ namespace Implementation {
 @brief Layer data handle
 @m_since_latest
 
-Uses 20 bits for storing an ID and 12 bits for a generation.
+Uses 20 bits for storing an ID and 12 bits for a generation. If the library
+is built with `MAGNUM_UI_LARGE_HANDLES` enabled, the handle is 64-bit and uses
+24 bits for an ID and 15 bits for a generation instead.
 @see @ref AbstractLayer::create(), @ref AbstractLayer::remove(),
     @ref layerDataHandle(), @ref layerDataHandleId(),
     @ref layerDataHandleGeneration()
 */
+#if !defined(MAGNUM_UI_LARGE_HANDLES) || defined(DOXYGEN_GENERATING_OUTPUT)
 enum class LayerDataHandle: UnsignedInt {
+#else
+enum class LayerDataHandle: UnsignedLong {
+#endif
     Null = 0    /**< Null handle */
 };
 
@@ -139,7 +150,7 @@ operation.
 */
 constexpr LayerDataHandle layerDataHandle(UnsignedInt id, UnsignedInt generation) {
     return (CORRADE_CONSTEXPR_DEBUG_ASSERT(id < (1 << Implementation::LayerDataHandleIdBits) && generation < (1 << Implementation::LayerDataHandleGenerationBits),
-        "Ui::layerDataHandle(): expected index to fit into" << Implementation::LayerDataHandleIdBits << "bits and generation into" << Implementation::LayerDataHandleGenerationBits << Debug::nospace << ", got" << Debug::hex << id << "and" << Debug::hex << generation), LayerDataHandle(id|(generation << Implementation::LayerDataHandleIdBits)));
+        "Ui::layerDataHandle(): expected index to fit into" << Implementation::LayerDataHandleIdBits << "bits and generation into" << Implementation::LayerDataHandleGenerationBits << Debug::nospace << ", got" << Debug::hex << id << "and" << Debug::hex << generation), LayerDataHandle(id|(UnsignedLong(generation) << Implementation::LayerDataHandleIdBits)));
 }
 
 /**
@@ -153,7 +164,7 @@ Expects that @p handle is not @ref LayerDataHandle::Null. Use
 constexpr UnsignedInt layerDataHandleId(LayerDataHandle handle) {
     return (CORRADE_CONSTEXPR_DEBUG_ASSERT(handle != LayerDataHandle::Null,
         "Ui::layerDataHandleId(): the handle is null"),
-        UnsignedInt(handle) & ((1 << Implementation::LayerDataHandleIdBits) - 1));
+        UnsignedLong(handle) & ((1 << Implementation::LayerDataHandleIdBits) - 1));
 }
 
 /**
@@ -165,7 +176,7 @@ non-zero generation. Use @ref layerDataHandleId() for extracting the ID and
 @ref layerDataHandle() for an inverse operation.
 */
 constexpr UnsignedInt layerDataHandleGeneration(LayerDataHandle handle) {
-    return UnsignedInt(handle) >> Implementation::LayerDataHandleIdBits;
+    return UnsignedLong(handle) >> Implementation::LayerDataHandleIdBits;
 }
 
 /**
@@ -174,7 +185,9 @@ constexpr UnsignedInt layerDataHandleGeneration(LayerDataHandle handle) {
 
 A combination of a @ref LayerHandle and a @ref LayerDataHandle. Uses 8 bits for
 storing a layer ID, 8 bits for a layer generation, 20 bits for storing a data
-ID and 12 bits for a data generation.
+ID and 12 bits for a data generation. If the library is built with
+`MAGNUM_UI_LARGE_HANDLES` enabled, the data ID uses 24 bits and the data
+generation 15 bits instead.
 @see @ref AbstractLayer::create(), @ref AbstractLayer::remove(),
     @ref dataHandle(), @ref dataHandleId(),
     @ref dataHandleGeneration()
@@ -236,7 +249,7 @@ Use @ref dataHandleLayer() for extracting the layer handle and
 @ref dataHandle(LayerHandle, LayerDataHandle) for an inverse operation.
 */
 constexpr LayerDataHandle dataHandleData(DataHandle handle) {
-    return LayerDataHandle(UnsignedLong(handle));
+    return LayerDataHandle(UnsignedLong(handle) & ((1ull << (Implementation::LayerDataHandleIdBits + Implementation::LayerDataHandleGenerationBits)) - 1));
 }
 
 /**
@@ -279,7 +292,7 @@ operation.
 @see @ref dataHandleData()
 */
 constexpr UnsignedInt dataHandleId(DataHandle handle) {
-    return (CORRADE_CONSTEXPR_DEBUG_ASSERT(LayerDataHandle(UnsignedLong(handle)) != LayerDataHandle::Null,
+    return (CORRADE_CONSTEXPR_DEBUG_ASSERT(LayerDataHandle(UnsignedLong(handle) & ((1ull << (Implementation::LayerDataHandleIdBits + Implementation::LayerDataHandleGenerationBits)) - 1)) != LayerDataHandle::Null,
         "Ui::dataHandleId(): the data portion of" << handle << "is null"),
         UnsignedLong(handle) & ((1 << Implementation::LayerDataHandleIdBits) - 1));
 }
@@ -301,8 +314,13 @@ constexpr UnsignedInt dataHandleGeneration(DataHandle handle) {
 
 namespace Implementation {
     enum: UnsignedInt {
+        #ifndef MAGNUM_UI_LARGE_HANDLES
         NodeHandleIdBits = 20,
         NodeHandleGenerationBits = 12
+        #else
+        NodeHandleIdBits = 24,
+        NodeHandleGenerationBits = 15
+        #endif
     };
 }
 
@@ -310,12 +328,18 @@ namespace Implementation {
 @brief Node handle
 @m_since_latest
 
-Uses 20 bits for storing an ID and 12 bits for a generation.
+Uses 20 bits for storing an ID and 12 bits for a generation. If the library
+is built with `MAGNUM_UI_LARGE_HANDLES` enabled, the handle is 64-bit and uses
+24 bits for an ID and 15 bits for a generation instead.
 @see @ref AbstractUserInterface::createNode(),
     @ref AbstractUserInterface::removeNode(), @ref nodeHandle(),
     @ref nodeHandleId(), @ref nodeHandleGeneration()
 */
+#if !defined(MAGNUM_UI_LARGE_HANDLES) || defined(DOXYGEN_GENERATING_OUTPUT)
 enum class NodeHandle: UnsignedInt {
+#else
+enum class NodeHandle: UnsignedLong {
+#endif
     Null = 0    /**< Null handle */
 };
 
@@ -334,7 +358,7 @@ Expects that the ID fits into 20 bits and the generation into 12 bits. Use
 */
 constexpr NodeHandle nodeHandle(UnsignedInt id, UnsignedInt generation) {
     return (CORRADE_CONSTEXPR_DEBUG_ASSERT(id < (1 << Implementation::NodeHandleIdBits) && generation < (1 << Implementation::NodeHandleGenerationBits),
-        "Ui::nodeHandle(): expected index to fit into" << Implementation::NodeHandleIdBits << "bits and generation into" << Implementation::NodeHandleGenerationBits << Debug::nospace << ", got" << Debug::hex << id << "and" << Debug::hex << generation), NodeHandle(id|(generation << Implementation::NodeHandleIdBits)));
+        "Ui::nodeHandle(): expected index to fit into" << Implementation::NodeHandleIdBits << "bits and generation into" << Implementation::NodeHandleGenerationBits << Debug::nospace << ", got" << Debug::hex << id << "and" << Debug::hex << generation), NodeHandle(id|(UnsignedLong(generation) << Implementation::NodeHandleIdBits)));
 }
 
 /**
@@ -348,7 +372,7 @@ for an inverse operation.
 constexpr UnsignedInt nodeHandleId(NodeHandle handle) {
     return (CORRADE_CONSTEXPR_DEBUG_ASSERT(handle != NodeHandle::Null,
         "Ui::nodeHandleId(): the handle is null"),
-        UnsignedInt(handle) & ((1 << Implementation::NodeHandleIdBits) - 1));
+        UnsignedLong(handle) & ((1 << Implementation::NodeHandleIdBits) - 1));
 }
 
 /**
@@ -360,7 +384,7 @@ non-zero generation. Use @ref nodeHandleId() for extracting the ID and
 @ref nodeHandle() for an inverse operation.
 */
 constexpr UnsignedInt nodeHandleGeneration(NodeHandle handle) {
-    return UnsignedInt(handle) >> Implementation::NodeHandleIdBits;
+    return UnsignedLong(handle) >> Implementation::NodeHandleIdBits;
 }
 
 namespace Implementation {
@@ -431,8 +455,13 @@ constexpr UnsignedInt layouterHandleGeneration(LayouterHandle handle) {
 
 namespace Implementation {
     enum: UnsignedInt {
+        #ifndef MAGNUM_UI_LARGE_HANDLES
         LayouterDataHandleIdBits = 20,
         LayouterDataHandleGenerationBits = 12
+        #else
+        LayouterDataHandleIdBits = 24,
+        LayouterDataHandleGenerationBits = 15
+        #endif
     };
 }
 
@@ -440,12 +469,18 @@ namespace Implementation {
 @brief Layouter data handle
 @m_since_latest
 
-Uses 20 bits for storing an ID and 12 bits for a generation.
+Uses 20 bits for storing an ID and 12 bits for a generation. If the library
+is built with `MAGNUM_UI_LARGE_HANDLES` enabled, the handle is 64-bit and uses
+24 bits for an ID and 15 bits for a generation instead.
 @see @ref AbstractLayouter::add(), @ref AbstractLayouter::remove(),
     @ref layouterDataHandle(), @ref layouterDataHandleId(),
     @ref layouterDataHandleGeneration()
 */
+#if !defined(MAGNUM_UI_LARGE_HANDLES) || defined(DOXYGEN_GENERATING_OUTPUT)
 enum class LayouterDataHandle: UnsignedInt {
+#else
+enum class LayouterDataHandle: UnsignedLong {
+#endif
     Null = 0    /**< Null handle */
 };
 
@@ -465,7 +500,7 @@ inverse operation.
 */
 constexpr LayouterDataHandle layouterDataHandle(UnsignedInt id, UnsignedInt generation) {
     return (CORRADE_CONSTEXPR_DEBUG_ASSERT(id < (1 << Implementation::LayouterDataHandleIdBits) && generation < (1 << Implementation::LayouterDataHandleGenerationBits),
-        "Ui::layouterDataHandle(): expected index to fit into" << Implementation::LayouterDataHandleIdBits << "bits and generation into" << Implementation::LayouterDataHandleGenerationBits << Debug::nospace << ", got" << Debug::hex << id << "and" << Debug::hex << generation), LayouterDataHandle(id|(generation << Implementation::LayouterDataHandleIdBits)));
+        "Ui::layouterDataHandle(): expected index to fit into" << Implementation::LayouterDataHandleIdBits << "bits and generation into" << Implementation::LayouterDataHandleGenerationBits << Debug::nospace << ", got" << Debug::hex << id << "and" << Debug::hex << generation), LayouterDataHandle(id|(UnsignedLong(generation) << Implementation::LayouterDataHandleIdBits)));
 }
 
 /**
@@ -479,7 +514,7 @@ Expects that @p handle is not @ref LayouterDataHandle::Null. Use
 constexpr UnsignedInt layouterDataHandleId(LayouterDataHandle handle) {
     return (CORRADE_CONSTEXPR_DEBUG_ASSERT(handle != LayouterDataHandle::Null,
         "Ui::layouterDataHandleId(): the handle is null"),
-        UnsignedInt(handle) & ((1 << Implementation::LayouterDataHandleIdBits) - 1));
+        UnsignedLong(handle) & ((1 << Implementation::LayouterDataHandleIdBits) - 1));
 }
 
 /**
@@ -491,7 +526,7 @@ a non-zero generation. Use @ref layouterDataHandleId() for extracting the ID
 and @ref layouterDataHandle() for an inverse operation.
 */
 constexpr UnsignedInt layouterDataHandleGeneration(LayouterDataHandle handle) {
-    return UnsignedInt(handle) >> Implementation::LayouterDataHandleIdBits;
+    return UnsignedLong(handle) >> Implementation::LayouterDataHandleIdBits;
 }
 
 /**
@@ -500,7 +535,9 @@ constexpr UnsignedInt layouterDataHandleGeneration(LayouterDataHandle handle) {
 
 A combination of a @ref LayouterHandle and a @ref LayouterDataHandle. Uses 8
 bits for storing a layouter ID, 8 bits for a layouter generation, 20 bits for
-storing a layouter data ID and 12 bits for a layouter data generation.
+storing a layouter data ID and 12 bits for a layouter data generation. If the
+library is built with `MAGNUM_UI_LARGE_HANDLES` enabled, the layouter data ID
+uses 24 bits and the layouter data generation 15 bits instead.
 @see @ref AbstractLayouter::add(), @ref AbstractLayouter::remove(),
     @ref layoutHandle(), @ref layoutHandleId(),
     @ref layoutHandleGeneration()
@@ -564,7 +601,7 @@ Use @ref layoutHandleLayouter() for extracting the layouter handle and
 @ref layoutHandle(LayouterHandle, LayouterDataHandle) for an inverse operation.
 */
 constexpr LayouterDataHandle layoutHandleData(LayoutHandle handle) {
-    return LayouterDataHandle(UnsignedLong(handle));
+    return LayouterDataHandle(UnsignedLong(handle) & ((1ull << (Implementation::LayouterDataHandleIdBits + Implementation::LayouterDataHandleGenerationBits)) - 1));
 }
 
 /**
@@ -608,7 +645,7 @@ operation.
 @see @ref layoutHandleData()
 */
 constexpr UnsignedInt layoutHandleId(LayoutHandle handle) {
-    return (CORRADE_CONSTEXPR_DEBUG_ASSERT(LayouterDataHandle(UnsignedLong(handle)) != LayouterDataHandle::Null,
+    return (CORRADE_CONSTEXPR_DEBUG_ASSERT(LayouterDataHandle(UnsignedLong(handle) & ((1ull << (Implementation::LayouterDataHandleIdBits + Implementation::LayouterDataHandleGenerationBits)) - 1)) != LayouterDataHandle::Null,
         "Ui::layoutHandleId(): the data portion of" << handle << "is null"),
         UnsignedLong(handle) & ((1 << Implementation::LayouterDataHandleIdBits) - 1));
 }
@@ -696,8 +733,13 @@ constexpr UnsignedInt animatorHandleGeneration(AnimatorHandle handle) {
 
 namespace Implementation {
     enum: UnsignedInt {
+        #ifndef MAGNUM_UI_LARGE_HANDLES
         AnimatorDataHandleIdBits = 20,
         AnimatorDataHandleGenerationBits = 12
+        #else
+        AnimatorDataHandleIdBits = 24,
+        AnimatorDataHandleGenerationBits = 15
+        #endif
     };
 }
 
@@ -705,12 +747,18 @@ namespace Implementation {
 @brief Animator data handle
 @m_since_latest
 
-Uses 20 bits for storing an ID and 12 bits for a generation.
+Uses 20 bits for storing an ID and 12 bits for a generation. If the library
+is built with `MAGNUM_UI_LARGE_HANDLES` enabled, the handle is 64-bit and uses
+24 bits for an ID and 15 bits for a generation instead.
 @see @ref AbstractAnimator::create(), @ref AbstractAnimator::remove(),
     @ref animatorDataHandle(), @ref animatorDataHandleId(),
     @ref animatorDataHandleGeneration()
 */
+#if !defined(MAGNUM_UI_LARGE_HANDLES) || defined(DOXYGEN_GENERATING_OUTPUT)
 enum class AnimatorDataHandle: UnsignedInt {
+#else
+enum class AnimatorDataHandle: UnsignedLong {
+#endif
     Null = 0    /**< Null handle */
 };
 
@@ -730,7 +778,7 @@ inverse operation.
 */
 constexpr AnimatorDataHandle animatorDataHandle(UnsignedInt id, UnsignedInt generation) {
     return (CORRADE_CONSTEXPR_DEBUG_ASSERT(id < (1 << Implementation::AnimatorDataHandleIdBits) && generation < (1 << Implementation::AnimatorDataHandleGenerationBits),
-        "Ui::animatorDataHandle(): expected index to fit into" << Implementation::AnimatorDataHandleIdBits << "bits and generation into" << Implementation::AnimatorDataHandleGenerationBits << Debug::nospace << ", got" << Debug::hex << id << "and" << Debug::hex << generation), AnimatorDataHandle(id|(generation << Implementation::AnimatorDataHandleIdBits)));
+        "Ui::animatorDataHandle(): expected index to fit into" << Implementation::AnimatorDataHandleIdBits << "bits and generation into" << Implementation::AnimatorDataHandleGenerationBits << Debug::nospace << ", got" << Debug::hex << id << "and" << Debug::hex << generation), AnimatorDataHandle(id|(UnsignedLong(generation) << Implementation::AnimatorDataHandleIdBits)));
 }
 
 /**
@@ -744,7 +792,7 @@ Expects that @p handle is not @ref AnimatorDataHandle::Null. Use
 constexpr UnsignedInt animatorDataHandleId(AnimatorDataHandle handle) {
     return (CORRADE_CONSTEXPR_DEBUG_ASSERT(handle != AnimatorDataHandle::Null,
         "Ui::animatorDataHandleId(): the handle is null"),
-        UnsignedInt(handle) & ((1 << Implementation::AnimatorDataHandleIdBits) - 1));
+        UnsignedLong(handle) & ((1 << Implementation::AnimatorDataHandleIdBits) - 1));
 }
 
 /**
@@ -756,7 +804,7 @@ a non-zero generation. Use @ref animatorDataHandleId() for extracting the ID
 and @ref animatorDataHandle() for an inverse operation.
 */
 constexpr UnsignedInt animatorDataHandleGeneration(AnimatorDataHandle handle) {
-    return UnsignedInt(handle) >> Implementation::AnimatorDataHandleIdBits;
+    return UnsignedLong(handle) >> Implementation::AnimatorDataHandleIdBits;
 }
 
 /**
@@ -766,7 +814,9 @@ constexpr UnsignedInt animatorDataHandleGeneration(AnimatorDataHandle handle) {
 A combination of an @ref AnimatorHandle and an @ref AnimatorDataHandle.
 Uses 8 bits for storing an animator ID, 8 bits for an animator generation, 20
 bits for storing an animator data ID and 12 bits for an animator data
-generation.
+generation. If the library is built with `MAGNUM_UI_LARGE_HANDLES` enabled,
+the animator data ID uses 24 bits and the animator data generation 15 bits
+instead.
 @see @ref AbstractAnimator::create(), @ref AbstractAnimator::remove(),
     @ref animationHandle(), @ref animationHandleId(),
     @ref animationHandleGeneration()
@@ -832,7 +882,7 @@ Use @ref animationHandleAnimator() for extracting the animator handle and
 operation.
 */
 constexpr AnimatorDataHandle animationHandleData(AnimationHandle handle) {
-    return AnimatorDataHandle(UnsignedLong(handle));
+    return AnimatorDataHandle(UnsignedLong(handle) & ((1ull << (Implementation::AnimatorDataHandleIdBits + Implementation::AnimatorDataHandleGenerationBits)) - 1));
 }
 
 /**
@@ -877,7 +927,7 @@ operation.
 @see @ref animationHandleData()
 */
 constexpr UnsignedInt animationHandleId(AnimationHandle handle) {
-    return (CORRADE_CONSTEXPR_DEBUG_ASSERT(AnimatorDataHandle(UnsignedLong(handle)) != AnimatorDataHandle::Null,
+    return (CORRADE_CONSTEXPR_DEBUG_ASSERT(AnimatorDataHandle(UnsignedLong(handle) & ((1ull << (Implementation::AnimatorDataHandleIdBits + Implementation::AnimatorDataHandleGenerationBits)) - 1)) != AnimatorDataHandle::Null,
         "Ui::animationHandleId(): the data portion of" << handle << "is null"),
         UnsignedLong(handle) & ((1 << Implementation::AnimatorDataHandleIdBits) - 1));
 }
@@ -26,8 +26,11 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <Corrade/Utility/Assert.h>
 #include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/GL/Shader.h>
 #include <Magnum/GL/Texture.h>
+#include <Magnum/GL/Version.h>
 #include <Magnum/Math/Vector2.h>
 
 #include "Magnum/Ui/visibility.h"
@@ -60,15 +63,25 @@ BlurShaderGL: public GL::AbstractShaderProgram {
         explicit BlurShaderGL(NoCreateT): GL::AbstractShaderProgram{NoCreate} {}
         explicit BlurShaderGL(UnsignedInt radius, Float limit);
 
+        /* The constructor only submits the compilation and linking, this
+           waits for it to finish, checks it and queries uniform locations.
+           Has to be called before setDirection() and the first draw, does
+           nothing if already called. */
+        void finalize();
+
         BlurShaderGL& setProjection(const Vector2& scaling) {
             /* Y-flipped scale from the UI size to the 2x2 unit square, the
                shader then translates by (-1, 1) on its own to put the
-               origin at center */
-            setUniform(_projectionUniform, Vector2{2.0f, -2.0f}/scaling);
+               origin at center. If not finalized yet, uploaded only in
+               finalize() to not wait for the link here. */
+            _projection = Vector2{2.0f, -2.0f}/scaling;
+            if(!_vert.id())
+                setUniform(_projectionUniform, _projection);
             return *this;
         }
 
         BlurShaderGL& setDirection(const Vector2& direction) {
+            CORRADE_INTERNAL_ASSERT(!_vert.id());
             /* If we check just the center pixel, the direction isn't used by
                the shader at all */
             if(_sampleCount != 1)
@@ -83,8 +96,14 @@ BlurShaderGL: public GL::AbstractShaderProgram {
 
     private:
         UnsignedInt _sampleCount;
+        #if defined(MAGNUM_TARGET_GLES) && !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+        GL::Version _version;
+        #endif
         Int _projectionUniform = 0,
             _directionUniform = 1;
+        Vector2 _projection;
+        /* Present only until finalize() is called */
+        GL::Shader _vert{NoCreate}, _frag{NoCreate};
 };
 
 }}
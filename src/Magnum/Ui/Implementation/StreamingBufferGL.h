@@ -0,0 +1,87 @@
+#ifndef Magnum_Ui_Implementation_StreamingBufferGL_h
+#define Magnum_Ui_Implementation_StreamingBufferGL_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Magnum/configure.h>
+
+#ifndef MAGNUM_TARGET_GLES
+#include <Corrade/Containers/ArrayView.h>
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/OpenGL.h>
+
+/* Used by BaseLayerGL and TextLayerGL for streaming vertex data. Implemented
+   in BaseLayerGL.cpp, similarly to BlurShaderGL. */
+
+namespace Magnum { namespace Ui { namespace Implementation {
+
+/* A persistently mapped buffer split into three segments that are written in
+   a round-robin fashion. Each segment is guarded by a fence, so it doesn't
+   get overwritten while the GPU may still be drawing from it, and writing
+   into it is a plain memory copy without any implicit synchronization in the
+   driver. Requires ARB_buffer_storage. */
+class StreamingBufferGL {
+    public:
+        enum: UnsignedInt { SegmentCount = 3 };
+
+        static bool isSupported();
+
+        explicit StreamingBufferGL() = default;
+
+        StreamingBufferGL(const StreamingBufferGL&) = delete;
+        StreamingBufferGL(StreamingBufferGL&&) = delete;
+        /* Deletes all pending fences */
+        ~StreamingBufferGL();
+        StreamingBufferGL& operator=(const StreamingBufferGL&) = delete;
+        StreamingBufferGL& operator=(StreamingBufferGL&&) = delete;
+
+        /* Buffer to attach to a mesh. Not created until the first write() of
+           non-empty data, and recreated every time write() returns true. */
+        GL::Buffer& buffer() { return _buffer; }
+
+        /* Byte offset of the segment that was written in the last write() */
+        std::size_t segmentOffset() const { return _segment*_segmentSize; }
+
+        /* Fences the segment written by the previous call, as all draws from
+           it were submitted already, and copies the data to the next segment,
+           waiting until the GPU is done with it. If the data don't fit, the
+           buffer is recreated with twice the space, with segment sizes being
+           a multiple of alignment. Returns true in that case, meaning that all
+           meshes referencing buffer() need to be set up again. */
+        bool write(Containers::ArrayView<const char> data, std::size_t alignment);
+
+    private:
+        GL::Buffer _buffer{NoCreate};
+        char* _data{};
+        std::size_t _segmentSize{};
+        UnsignedInt _segment{};
+        GLsync _fences[SegmentCount]{};
+};
+
+}}}
+#endif
+
+#endif
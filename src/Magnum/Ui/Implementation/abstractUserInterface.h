@@ -29,11 +29,14 @@
 #include <cstring> /* std::memset() */
 #include <Corrade/Containers/BitArrayView.h>
 #include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Pair.h>
 #include <Corrade/Containers/Reference.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Containers/Triple.h>
 #include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/Move.h>
 #include <Magnum/Magnum.h>
+#include <Magnum/Math/Constants.h>
 #include <Magnum/Math/Functions.h>
 
 #include "Magnum/Ui/AbstractAnimator.h" /* AnimatorFeatures */
@@ -178,6 +181,210 @@ std::size_t orderVisibleNodesDepthFirstInto(const Containers::StridedArrayView1D
     return outputOffset;
 }
 
+/* Patches the `visibleNodeIds` and `visibleNodeChildrenCounts` arrays filled
+   by orderVisibleNodesDepthFirstInto() in place after the NodeFlag::Hidden
+   flag of node `id` changed, returning the new size of the filled prefix. The
+   `childrenOffsets` and `children` arrays are expected to be the ones filled
+   by orderVisibleNodesDepthFirstInto() as well, i.e. the node hierarchy and
+   top-level node order can't have changed since. The `visibleNodeIds` and
+   `visibleNodeChildrenCounts` views are expected to span the whole capacity,
+   with `visibleCount` being the size of the currently filled prefix.
+
+   If the node is hidden and currently visible, its subtree gets removed and
+   children counts of all its parents are adjusted. If the node isn't hidden,
+   all its parents are visible and it's not in the visible set yet, its
+   visible subtree gets inserted at a position given by its ID relative to
+   its siblings, matching what orderVisibleNodesDepthFirstInto() would
+   produce. Otherwise, such as when a node was hidden and then made visible
+   again, or when any of its parents is hidden, nothing is done. The operation
+   thus gives the same result if called repeatedly for the same node, and the
+   same result for a set of nodes regardless of the order in which it's called
+   for them.
+
+   The node is expected to not be a top-level node, and the visible hierarchy
+   is expected to not contain any nested top-level nodes, as their visibility
+   could change as well, which this function doesn't handle. The `ancestors`
+   and `parentsToProcess` arrays are temporary storage. */
+std::size_t updateVisibleNodesDepthFirstInPlace(const Containers::StridedArrayView1D<const NodeHandle>& nodeParents, const Containers::StridedArrayView1D<const UnsignedInt>& nodeOrder, const Containers::StridedArrayView1D<const NodeFlags>& nodeFlags, const Containers::ArrayView<const UnsignedInt> childrenOffsets, const Containers::ArrayView<const UnsignedInt> children, const UnsignedInt id, const Containers::ArrayView<UnsignedInt> ancestors, const Containers::ArrayView<Containers::Triple<UnsignedInt, UnsignedInt, UnsignedInt>> parentsToProcess, const Containers::StridedArrayView1D<UnsignedInt>& visibleNodeIds, const Containers::StridedArrayView1D<UnsignedInt>& visibleNodeChildrenCounts, const std::size_t visibleCount) {
+    CORRADE_INTERNAL_ASSERT(
+        nodeOrder.size() == nodeParents.size() &&
+        nodeFlags.size() == nodeParents.size() &&
+        childrenOffsets.size() == nodeParents.size() + 1 &&
+        children.size() == nodeParents.size() &&
+        ancestors.size() == nodeParents.size() &&
+        parentsToProcess.size() == nodeParents.size() &&
+        visibleNodeIds.size() == nodeParents.size() &&
+        visibleNodeChildrenCounts.size() == nodeParents.size() &&
+        visibleCount <= nodeParents.size());
+    CORRADE_INTERNAL_ASSERT(nodeParents[id] != NodeHandle::Null && nodeOrder[id] == ~UnsignedInt{});
+
+    /* Gather the node and all its parents, with the root node being last */
+    std::size_t ancestorCount = 0;
+    for(UnsignedInt i = id; ; ) {
+        ancestors[ancestorCount++] = i;
+        const NodeHandle parent = nodeParents[i];
+        if(parent == NodeHandle::Null)
+            break;
+        i = nodeHandleId(parent);
+    }
+
+    /* Find the root node among visible top-level nodes. If it's not there,
+       it's either hidden or not in the top-level node order, and nothing in
+       its hierarchy is visible. */
+    const UnsignedInt rootId = ancestors[ancestorCount - 1];
+    std::size_t index = 0;
+    while(index != visibleCount && visibleNodeIds[index] != rootId)
+        index += visibleNodeChildrenCounts[index] + 1;
+    if(index == visibleCount)
+        return visibleCount;
+
+    /* Descend to the node, replacing parent IDs in `ancestors` with their
+       indices in the visible node list along the way. Children of each node
+       are ordered by their IDs, so siblings with lower IDs are skipped. */
+    for(std::size_t level = ancestorCount - 1; level; --level) {
+        const UnsignedInt childId = ancestors[level - 1];
+        ancestors[level] = index;
+        const std::size_t end = index + visibleNodeChildrenCounts[index] + 1;
+        std::size_t child = index + 1;
+        while(child != end && visibleNodeIds[child] < childId)
+            child += visibleNodeChildrenCounts[child] + 1;
+
+        /* The child is visible, continue with it */
+        if(child != end && visibleNodeIds[child] == childId) {
+            index = child;
+            continue;
+        }
+
+        /* The child isn't visible. If it's one of the parents, the node isn't
+           visible either. If it's the node itself but it's hidden, there's
+           nothing to do either. */
+        if(level != 1 || (nodeFlags[id] & NodeFlag::Hidden))
+            return visibleCount;
+
+        /* Otherwise put the visible subtree of the node after the currently
+           filled prefix, in the same way as orderVisibleNodesDepthFirstInto()
+           does it ... */
+        std::size_t outputOffset = visibleCount;
+        {
+            std::size_t parentsToProcessOffset = 0;
+            visibleNodeIds[outputOffset] = id;
+            parentsToProcess[parentsToProcessOffset++] = {id, UnsignedInt(outputOffset++), childrenOffsets[id]};
+
+            while(parentsToProcessOffset) {
+                const UnsignedInt parentId = parentsToProcess[parentsToProcessOffset - 1].first();
+                UnsignedInt& childrenOffset = parentsToProcess[parentsToProcessOffset - 1].third();
+
+                if(childrenOffset == childrenOffsets[parentId + 1]) {
+                    const UnsignedInt firstChildOutputOffset = parentsToProcess[parentsToProcessOffset - 1].second();
+                    visibleNodeChildrenCounts[firstChildOutputOffset] = outputOffset - firstChildOutputOffset - 1;
+                    --parentsToProcessOffset;
+                    continue;
+                }
+
+                CORRADE_INTERNAL_DEBUG_ASSERT(childrenOffset < childrenOffsets[parentId + 1]);
+
+                const UnsignedInt subtreeChildId = children[childrenOffset];
+                if(!(nodeFlags[subtreeChildId] & NodeFlag::Hidden)) {
+                    visibleNodeIds[outputOffset] = subtreeChildId;
+                    parentsToProcess[parentsToProcessOffset++] = {subtreeChildId, UnsignedInt(outputOffset++), childrenOffsets[subtreeChildId]};
+                }
+
+                ++childrenOffset;
+            }
+        }
+        CORRADE_INTERNAL_ASSERT(outputOffset <= nodeParents.size());
+
+        /* ... and then rotate it to the insertion point by reversing the part
+           after the insertion point, the subtree, and then both together.
+           Children counts are relative so they don't need any adjustment. */
+        const auto reverse = [](const Containers::StridedArrayView1D<UnsignedInt>& view) {
+            for(std::size_t i = 0, iMax = view.size()/2; i != iMax; ++i)
+                Utility::swap(view[i], view[view.size() - i - 1]);
+        };
+        reverse(visibleNodeIds.slice(child, visibleCount));
+        reverse(visibleNodeIds.slice(visibleCount, outputOffset));
+        reverse(visibleNodeIds.slice(child, outputOffset));
+        reverse(visibleNodeChildrenCounts.slice(child, visibleCount));
+        reverse(visibleNodeChildrenCounts.slice(visibleCount, outputOffset));
+        reverse(visibleNodeChildrenCounts.slice(child, outputOffset));
+
+        /* Finally, add the subtree size to all parents, which are all before
+           the insertion point and thus unaffected by the rotation */
+        const std::size_t count = outputOffset - visibleCount;
+        for(std::size_t i = 1; i != ancestorCount; ++i)
+            visibleNodeChildrenCounts[ancestors[i]] += count;
+
+        return outputOffset;
+    }
+
+    /* The node is visible. If it's not hidden, there's nothing to do. */
+    if(!(nodeFlags[id] & NodeFlag::Hidden))
+        return visibleCount;
+
+    /* Otherwise remove its subtree, shift the rest to fill the space and
+       subtract the subtree size from all parents */
+    const std::size_t count = visibleNodeChildrenCounts[index] + 1;
+    for(std::size_t i = index + count; i != visibleCount; ++i) {
+        visibleNodeIds[i - count] = visibleNodeIds[i];
+        visibleNodeChildrenCounts[i - count] = visibleNodeChildrenCounts[i];
+    }
+    for(std::size_t i = 1; i != ancestorCount; ++i)
+        visibleNodeChildrenCounts[ancestors[i]] -= count;
+
+    return visibleCount - count;
+}
+
+/* Fills `visibleNodeIds` and `visibleNodeChildrenCounts` from
+   `previousVisibleNodeIds` and `previousVisibleNodeChildrenCounts` filled by
+   orderVisibleNodesDepthFirstInto() after only the top-level node order
+   changed since, i.e. when top-level nodes that were already in the order got
+   moved or removed from it. Returns the size of the filled prefix.
+
+   The visible hierarchy of each top-level node is a contiguous range, so the
+   ranges are just copied in the new top-level order instead of ordering the
+   whole hierarchy from scratch. Ranges of nodes that are no longer in the
+   order are dropped. The `visibleNodeIndices` array is the mapping from node
+   IDs to indices in `previousVisibleNodeIds`, with values for nodes that
+   aren't visible being arbitrary. The top-level nodes in the order are
+   expected to be only root nodes, nested top-level nodes aren't handled, and
+   no top-level node that wasn't in the order before can be added. */
+std::size_t reorderVisibleTopLevelNodesInto(const Containers::StridedArrayView1D<const UnsignedInt>& nodeOrder, const Containers::StridedArrayView1D<const NodeHandle>& nodeOrderNext, const NodeHandle firstNodeOrder, const Containers::ArrayView<const UnsignedInt> visibleNodeIndices, const Containers::StridedArrayView1D<const UnsignedInt>& previousVisibleNodeIds, const Containers::StridedArrayView1D<const UnsignedInt>& previousVisibleNodeChildrenCounts, const Containers::StridedArrayView1D<UnsignedInt>& visibleNodeIds, const Containers::StridedArrayView1D<UnsignedInt>& visibleNodeChildrenCounts) {
+    CORRADE_INTERNAL_ASSERT(
+        visibleNodeIndices.size() == nodeOrder.size() &&
+        previousVisibleNodeChildrenCounts.size() == previousVisibleNodeIds.size() &&
+        visibleNodeIds.size() == nodeOrder.size() &&
+        visibleNodeChildrenCounts.size() == nodeOrder.size());
+
+    /* If there are no top-level nodes, nothing is visible and thus nothing to
+       do */
+    if(firstNodeOrder == NodeHandle::Null)
+        return 0;
+
+    std::size_t outputOffset = 0;
+    NodeHandle topLevel = firstNodeOrder;
+    do {
+        const UnsignedInt topLevelId = nodeHandleId(topLevel);
+
+        /* If the top-level node is visible, copy its whole range. If it's
+           not, it's hidden and so is its whole hierarchy. */
+        const UnsignedInt index = visibleNodeIndices[topLevelId];
+        if(index < previousVisibleNodeIds.size() && previousVisibleNodeIds[index] == topLevelId) {
+            const std::size_t count = previousVisibleNodeChildrenCounts[index] + 1;
+            CORRADE_INTERNAL_DEBUG_ASSERT(outputOffset + count <= visibleNodeIds.size());
+            Utility::copy(previousVisibleNodeIds.sliceSize(index, count),
+                visibleNodeIds.sliceSize(outputOffset, count));
+            Utility::copy(previousVisibleNodeChildrenCounts.sliceSize(index, count),
+                visibleNodeChildrenCounts.sliceSize(outputOffset, count));
+            outputOffset += count;
+        }
+
+        CORRADE_INTERNAL_DEBUG_ASSERT(nodeOrder[topLevelId] != ~UnsignedInt{});
+        topLevel = nodeOrderNext[nodeOrder[topLevelId]];
+    } while(topLevel != firstNodeOrder);
+
+    return outputOffset;
+}
+
 std::size_t visibleTopLevelNodeIndicesInto(const Containers::StridedArrayView1D<const UnsignedInt>& visibleNodeChildrenCounts, const Containers::StridedArrayView1D<UnsignedInt>& visibleTopLevelNodeIndices) {
     UnsignedInt offset = 0;
     for(UnsignedInt visibleTopLevelNodeIndex = 0; visibleTopLevelNodeIndex != visibleNodeChildrenCounts.size(); visibleTopLevelNodeIndex += visibleNodeChildrenCounts[visibleTopLevelNodeIndex] + 1)
@@ -616,11 +823,28 @@ UnsignedInt cullVisibleNodesInto(const Vector2& uiOffset, const Vector2& uiSize,
                 clipRectNodeCounts[clipRectsOffset] += nodePlusChildrenCount;
             }
 
-        /* If the node isn't a clipping node, just continue to the next one
-           after */
+        /* If the node isn't a clipping node, continue to the next one after.
+           As the clip stack doesn't change until a next clipping node, end of
+           the current clip rect or the end of the top-level node, go through
+           all such nodes in a tight loop without the clip stack handling
+           below. That's the common case for long lists of rows inside a
+           single scroll area, for example. */
         } else {
-            ++i;
-            ++clipRectNodeCounts[clipRectsOffset];
+            const std::size_t end = Math::min(std::size_t(clipStack[clipStackDepth - 1].third()), topLevelNodeEnd);
+            std::size_t next = i + 1;
+            for(; next != end; ++next) {
+                const UnsignedInt nextNodeId = visibleNodeIds[next];
+                if(nodeFlags[nextNodeId] & NodeFlag::Clip)
+                    break;
+
+                const Vector2 nextMin = absoluteNodeOffsets[nextNodeId];
+                const Vector2 nextMax = nextMin + nodeSizes[nextNodeId];
+                if((parentMax > nextMin).all() && (parentMin < nextMax).all())
+                    visibleNodeMask.set(nextNodeId);
+            }
+
+            clipRectNodeCounts[clipRectsOffset] += next - i;
+            i = next;
         }
 
         /* Save the visibility status */
@@ -681,6 +905,85 @@ UnsignedInt cullVisibleNodesInto(const Vector2& uiOffset, const Vector2& uiSize,
     return clipRectsOffset + 1;
 }
 
+/* Goes through visible top-level nodes front to back and resets bits in
+   `visibleNodeMask` for nodes that are fully inside the rectangle of any
+   visible top-level node with NodeFlag::Opaque in front of them. Meant to be
+   called after cullVisibleNodesInto(). The `occluders` array is used as a
+   scratch storage for the occluding rectangles, cleared on entry and meant to
+   be reused across calls to avoid allocations. */
+void cullOccludedVisibleNodesInto(const Containers::StridedArrayView1D<const Vector2>& absoluteNodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const NodeFlags>& nodeFlags, const Containers::StridedArrayView1D<const UnsignedInt>& visibleNodeIds, const Containers::StridedArrayView1D<const UnsignedInt>& visibleNodeChildrenCounts, const Containers::StridedArrayView1D<const UnsignedInt>& visibleFrontToBackTopLevelNodeIndices, Containers::Array<Containers::Pair<Vector2, Vector2>>& occluders, const Containers::MutableBitArrayView visibleNodeMask) {
+    CORRADE_INTERNAL_ASSERT(
+        nodeSizes.size() == absoluteNodeOffsets.size() &&
+        nodeFlags.size() == absoluteNodeOffsets.size() &&
+        visibleNodeChildrenCounts.size() == visibleNodeIds.size() &&
+        visibleNodeMask.size() == absoluteNodeOffsets.size());
+
+    arrayResize(occluders, NoInit, 0);
+
+    for(const UnsignedInt topLevelNodeIndex: visibleFrontToBackTopLevelNodeIndices) {
+        /* Cull nodes of this top-level hierarchy that are fully covered by any
+           of the occluders in front. The top-level node itself isn't
+           considered an occluder for its own children. */
+        if(!occluders.isEmpty()) {
+            for(std::size_t i = topLevelNodeIndex, iMax = topLevelNodeIndex + visibleNodeChildrenCounts[topLevelNodeIndex] + 1; i != iMax; ++i) {
+                const UnsignedInt nodeId = visibleNodeIds[i];
+                if(!visibleNodeMask[nodeId])
+                    continue;
+
+                const Vector2 min = absoluteNodeOffsets[nodeId];
+                const Vector2 max = min + nodeSizes[nodeId];
+                for(const Containers::Pair<Vector2, Vector2>& occluder: occluders) {
+                    if((min >= occluder.first()).all() &&
+                       (max <= occluder.second()).all()) {
+                        visibleNodeMask.reset(nodeId);
+                        break;
+                    }
+                }
+            }
+        }
+
+        /* If the top-level node is opaque and still visible, it occludes
+           everything behind it */
+        const UnsignedInt topLevelNodeId = visibleNodeIds[topLevelNodeIndex];
+        if(nodeFlags[topLevelNodeId] >= NodeFlag::Opaque &&
+           visibleNodeMask[topLevelNodeId]) {
+            const Vector2 min = absoluteNodeOffsets[topLevelNodeId];
+            arrayAppend(occluders, InPlaceInit, min, min + nodeSizes[topLevelNodeId]);
+        }
+    }
+}
+
+/* The `nodeFirstDataIds`, `nodeDataCounts` and `nodeNextDataIds` arrays get
+   filled with per-node lists of attached data, in the same form as
+   AbstractLayer::nodeFirstDataIds(), nodeDataCounts() and nodeNextDataIds()
+   maintain them incrementally. I.e., `nodeFirstDataIds[i]` is the lowest ID of
+   data attached to node with ID `i` or ~UnsignedInt{} if there's none,
+   `nodeNextDataIds[j]` is then the next data attached to the same node as data
+   `j`, in increasing data ID order. Used for building the lists from scratch
+   in tests and benchmarks. */
+void nodeDataInto(const Containers::StridedArrayView1D<const NodeHandle>& dataNodes, const Containers::StridedArrayView1D<UnsignedInt>& nodeFirstDataIds, const Containers::StridedArrayView1D<UnsignedInt>& nodeDataCounts, const Containers::StridedArrayView1D<UnsignedInt>& nodeNextDataIds) {
+    CORRADE_INTERNAL_ASSERT(
+        nodeDataCounts.size() == nodeFirstDataIds.size() &&
+        nodeNextDataIds.size() == dataNodes.size());
+
+    for(std::size_t i = 0; i != nodeFirstDataIds.size(); ++i) {
+        nodeFirstDataIds[i] = ~UnsignedInt{};
+        nodeDataCounts[i] = 0;
+    }
+
+    /* Go through the data in reverse and prepend each to its node's list,
+       which results in the lists being in increasing data ID order */
+    for(std::size_t i = dataNodes.size(); i != 0; --i) {
+        const NodeHandle node = dataNodes[i - 1];
+        if(node == NodeHandle::Null)
+            continue;
+        const UnsignedInt nodeId = nodeHandleId(node);
+        nodeNextDataIds[i - 1] = nodeFirstDataIds[nodeId];
+        nodeFirstDataIds[nodeId] = i - 1;
+        ++nodeDataCounts[nodeId];
+    }
+}
+
 /* The `dataToUpdateLayerOffsets` and `dataToUpdateIds` arrays get filled with
    data and node IDs in the desired draw order, clustered by layer ID, with
    `dataToUpdateLayerOffsets[i]` to `dataToUpdateLayerOffsets[i + 1]` being the
@@ -695,15 +998,17 @@ UnsignedInt cullVisibleNodesInto(const Vector2& uiOffset, const Vector2& uiSize,
    draw data, with their total count being the second return value of this
    function.
 
-   The `visibleNodeDataOffsets` and `visibleNodeDataIds` arrays are temporary
-   storage -- they get filled with data IDs for visible nodes, with  `visibleNodeDataOffsets[i]` to
-   `visibleNodeDataOffsets[i + 1]` being the range of data in
-   `visibleNodeDataIds` corresponding to visible node at index `i`. */
-Containers::Pair<UnsignedInt, UnsignedInt> orderVisibleNodeDataInto(const Containers::StridedArrayView1D<const UnsignedInt>& visibleNodeIds, const Containers::StridedArrayView1D<const UnsignedInt>& visibleNodeChildrenCounts, const Containers::StridedArrayView1D<const NodeHandle>& dataNodes, LayerFeatures layerFeatures, const Containers::BitArrayView visibleNodeMask, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectNodeCounts, const Containers::ArrayView<UnsignedInt> visibleNodeDataOffsets, const Containers::ArrayView<UnsignedInt> visibleNodeDataIds, const Containers::StridedArrayView1D<UnsignedInt>& dataToUpdateIds, const Containers::StridedArrayView1D<UnsignedInt>& dataToUpdateClipRectIds, const Containers::StridedArrayView1D<UnsignedInt>& dataToUpdateClipRectDataCounts, UnsignedInt offset, UnsignedInt clipRectOffset, const Containers::StridedArrayView1D<UnsignedInt>& dataToDrawOffsets, const Containers::StridedArrayView1D<UnsignedInt>& dataToDrawSizes, const Containers::StridedArrayView1D<UnsignedInt>& dataToDrawClipRectOffsets, const Containers::StridedArrayView1D<UnsignedInt>& dataToDrawClipRectSizes) {
+   The `nodeFirstDataIds`, `nodeDataCounts` and `nodeNextDataIds` are the
+   per-node data lists of given layer, coming from AbstractLayer or
+   `nodeDataInto()` above. The node views can be smaller than
+   `visibleNodeMask`, nodes outside of their range are treated as having no
+   data. Data attached to nodes that aren't in `visibleNodeMask` are skipped.
+   Thus the cost is proportional to the count of visible nodes and data
+   attached to them, not to the total data count in the layer. */
+Containers::Pair<UnsignedInt, UnsignedInt> orderVisibleNodeDataInto(const Containers::StridedArrayView1D<const UnsignedInt>& visibleNodeIds, const Containers::StridedArrayView1D<const UnsignedInt>& visibleNodeChildrenCounts, const Containers::StridedArrayView1D<const UnsignedInt>& nodeFirstDataIds, const Containers::StridedArrayView1D<const UnsignedInt>& nodeDataCounts, const Containers::StridedArrayView1D<const UnsignedInt>& nodeNextDataIds, LayerFeatures layerFeatures, const Containers::BitArrayView visibleNodeMask, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectNodeCounts, const Containers::StridedArrayView1D<UnsignedInt>& dataToUpdateIds, const Containers::StridedArrayView1D<UnsignedInt>& dataToUpdateClipRectIds, const Containers::StridedArrayView1D<UnsignedInt>& dataToUpdateClipRectDataCounts, UnsignedInt offset, UnsignedInt clipRectOffset, const Containers::StridedArrayView1D<UnsignedInt>& dataToDrawOffsets, const Containers::StridedArrayView1D<UnsignedInt>& dataToDrawSizes, const Containers::StridedArrayView1D<UnsignedInt>& dataToDrawClipRectOffsets, const Containers::StridedArrayView1D<UnsignedInt>& dataToDrawClipRectSizes) {
     CORRADE_INTERNAL_ASSERT(
         visibleNodeChildrenCounts.size() == visibleNodeIds.size() &&
-        visibleNodeDataOffsets.size() == visibleNodeMask.size() + 1 &&
-        visibleNodeDataIds.size() == dataNodes.size() &&
+        nodeDataCounts.size() == nodeFirstDataIds.size() &&
         offset <= dataToUpdateIds.size() &&
         dataToUpdateClipRectDataCounts.size() == dataToUpdateClipRectIds.size()  &&
         clipRectOffset <= dataToUpdateClipRectIds.size() &&
@@ -722,50 +1027,7 @@ Containers::Pair<UnsignedInt, UnsignedInt> orderVisibleNodeDataInto(const Contai
         return {};
     }
 
-    /* Zero out the visibleNodeDataOffsets array */
-    std::memset(visibleNodeDataOffsets.data(), 0, visibleNodeDataOffsets.size()*sizeof(UnsignedInt));
-
-    /* Count how much data belongs to each visible node, skipping the first
-       element ...*/
-    for(const NodeHandle node: dataNodes) {
-        if(node == NodeHandle::Null)
-            continue;
-        const UnsignedInt id = nodeHandleId(node);
-        if(visibleNodeMask[id])
-            ++visibleNodeDataOffsets[id + 1];
-    }
-
-    /* ... then convert the counts to a running offset. Now
-       `[visibleNodeDataOffsets[i + 1], visibleNodeDataOffsets[i + 2])` is a
-       range in which the `visibleNodeDataIds` array contains a list of data
-       handles for visible node with ID `i`. The last element (containing the
-       end offset) is omitted at this step. */
-    {
-        UnsignedInt visibleNodeDataCount = 0;
-        for(UnsignedInt& i: visibleNodeDataOffsets) {
-            const UnsignedInt nextOffset = visibleNodeDataCount + i;
-            i = visibleNodeDataCount;
-            visibleNodeDataCount = nextOffset;
-        }
-    }
-
-    /* Go through the data list again, convert that to data handle ranges. The
-       `visibleNodeDataOffsets` array gets shifted by one element by the
-       process, thus now
-       `[visibleNodeDataOffsets[i], visibleNodeDataOffsets[i + 1])` is a range
-       in which the `visibleNodeDataIds` array contains a list of data handles
-       for visible node with ID `i`. The last array element is now containing
-       the end offset. */
-    for(std::size_t i = 0; i != dataNodes.size(); ++i) {
-        const NodeHandle node = dataNodes[i];
-        if(node == NodeHandle::Null)
-            continue;
-        const UnsignedInt id = nodeHandleId(node);
-        if(visibleNodeMask[id])
-            visibleNodeDataIds[visibleNodeDataOffsets[id + 1]++] = i;
-    }
-
-    /* Now populate the "to update" and "to draw" arrays. The "to update"
+    /* Populate the "to update" and "to draw" arrays. The "to update"
        arrays contain a list of data IDs and corresponding node IDs for each
        layer, the "to draw" arrays then are ranges into these. The draws need
        to be first ordered by top-level node ID for correct back-to-front
@@ -787,9 +1049,11 @@ Containers::Pair<UnsignedInt, UnsignedInt> orderVisibleNodeDataInto(const Contai
            and then all data of each, and copy their IDs to the output range */
         for(UnsignedInt i = 0, iMax = visibleNodeChildrenCounts[visibleTopLevelNodeIndex] + 1; i != iMax; ++i) {
             const UnsignedInt visibleNodeId = visibleNodeIds[visibleTopLevelNodeIndex + i];
+            if(!visibleNodeMask[visibleNodeId] || visibleNodeId >= nodeFirstDataIds.size())
+                continue;
 
-            for(UnsignedInt j = visibleNodeDataOffsets[visibleNodeId], jMax = visibleNodeDataOffsets[visibleNodeId + 1]; j != jMax; ++j) {
-                dataToUpdateIds[offset] = visibleNodeDataIds[j];
+            for(UnsignedInt j = nodeFirstDataIds[visibleNodeId]; j != ~UnsignedInt{}; j = nodeNextDataIds[j]) {
+                dataToUpdateIds[offset] = j;
                 ++offset;
             }
         }
@@ -801,8 +1065,10 @@ Containers::Pair<UnsignedInt, UnsignedInt> orderVisibleNodeDataInto(const Contai
             const UnsignedInt visibleNodeId = visibleNodeIds[visibleTopLevelNodeIndex + i];
 
             /* For each node, add the count of data attached to that node to
-               the output. Which, on the other hand, *can* be zero. */
-            dataToUpdateClipRectDataCounts[clipRectOffset] += visibleNodeDataOffsets[visibleNodeId + 1] - visibleNodeDataOffsets[visibleNodeId];
+               the output. Which, on the other hand, *can* be zero, and is
+               always zero for nodes that got culled. */
+            if(visibleNodeMask[visibleNodeId] && visibleNodeId < nodeDataCounts.size())
+                dataToUpdateClipRectDataCounts[clipRectOffset] += nodeDataCounts[visibleNodeId];
             ++clipRectNodeCount;
 
             /* If we exhausted all nodes for this clip rect, move to the next
@@ -852,25 +1118,40 @@ Containers::Pair<UnsignedInt, UnsignedInt> orderVisibleNodeDataInto(const Contai
 }
 
 /* Counts how much data belongs to each visible node, skipping the first
-   element. Should be called for `dataNodes` from all layers that have
-   LayerFeature::Event, the `visibleNodeEventDataOffsets` array then converted
-   to an offset array and passed to `orderNodeDataForEventHandling()` below. */
-void countNodeDataForEventHandlingInto(const Containers::StridedArrayView1D<const NodeHandle>& dataNodes, const Containers::ArrayView<UnsignedInt> visibleNodeEventDataOffsets, const Containers::BitArrayView visibleNodeMask) {
-    CORRADE_INTERNAL_ASSERT(
-        visibleNodeEventDataOffsets.size() == visibleNodeMask.size() + 1);
+   element. Should be called for per-node data counts from all layers that
+   have LayerFeature::Event, the `visibleNodeEventDataOffsets` array then
+   converted to an offset array and passed to `orderNodeDataForEventHandling()`
+   below. */
+void countNodeDataForEventHandlingInto(const Containers::StridedArrayView1D<const UnsignedInt>& nodeDataCounts, const Containers::ArrayView<UnsignedInt> visibleNodeEventDataOffsets, const Containers::BitArrayView visibleNodeMask) {
+    CORRADE_INTERNAL_ASSERT(visibleNodeEventDataOffsets.size() == visibleNodeMask.size() + 1);
+
+    for(std::size_t i = 0, iMax = Math::min(nodeDataCounts.size(), visibleNodeMask.size()); i != iMax; ++i)
+        if(visibleNodeMask[i])
+            visibleNodeEventDataOffsets[i + 1] += nodeDataCounts[i];
+}
 
-    for(const NodeHandle node: dataNodes) {
-        if(node == NodeHandle::Null)
-            continue;
-        const UnsignedInt id = nodeHandleId(node);
-        if(visibleNodeMask[id])
-            ++visibleNodeEventDataOffsets[id + 1];
-    }
+/* Event data for a node are stored as a layer ID and a data ID packed into
+   32 bits. Compared to storing a (generation-less) DataHandle it's half the
+   size, making the per-node lists touch less memory in event dispatch, and
+   unpacking it is just a shift and a mask. */
+static_assert(LayerHandleIdBits + LayerDataHandleIdBits <= 32, "layer and data ID doesn't fit into 32 bits");
+
+constexpr UnsignedInt nodeEventData(const UnsignedInt layerId, const UnsignedInt dataId) {
+    return (layerId << LayerDataHandleIdBits)|dataId;
+}
+
+constexpr UnsignedInt nodeEventDataLayerId(const UnsignedInt data) {
+    return data >> LayerDataHandleIdBits;
 }
 
-/* The `dataNodes` array is expected to be the same as passed into
-   `orderVisibleNodeDataInto()`. The array indices together with `layer` are
-   used to form (generation-less) data handles in the output.
+constexpr UnsignedInt nodeEventDataId(const UnsignedInt data) {
+    return data & ((1 << LayerDataHandleIdBits) - 1);
+}
+
+/* The `nodeFirstDataIds`, `nodeDataCounts` and `nodeNextDataIds` views are
+   expected to be the same as passed into `orderVisibleNodeDataInto()`. The
+   data IDs together with
+   `layerId` are used to form packed nodeEventData() in the output.
 
    The `visibleNodeEventDataOffsets` is expected to be the output of
    `orderVisibleNodeDataInto()` above with an additional first zero element,
@@ -879,33 +1160,226 @@ void countNodeDataForEventHandlingInto(const Containers::StridedArrayView1D<cons
    `visibleNodeEventDataOffsets[i]` to `visibleNodeEventDataOffsets[i + 1]`
    then being the range of data in `visibleNodeEventData` corresponding to node
    `i`. */
-void orderNodeDataForEventHandlingInto(const LayerHandle layer, const Containers::StridedArrayView1D<const NodeHandle>& dataNodes, const Containers::ArrayView<UnsignedInt> visibleNodeEventDataOffsets, const Containers::BitArrayView visibleEventNodeMask, const Containers::ArrayView<DataHandle> visibleNodeEventData) {
+void orderNodeDataForEventHandlingInto(const UnsignedInt layerId, const Containers::StridedArrayView1D<const UnsignedInt>& nodeFirstDataIds, const Containers::StridedArrayView1D<const UnsignedInt>& nodeDataCounts, const Containers::StridedArrayView1D<const UnsignedInt>& nodeNextDataIds, const Containers::ArrayView<UnsignedInt> visibleNodeEventDataOffsets, const Containers::BitArrayView visibleEventNodeMask, const Containers::ArrayView<UnsignedInt> visibleNodeEventData) {
     CORRADE_INTERNAL_ASSERT(
+        nodeDataCounts.size() == nodeFirstDataIds.size() &&
         visibleNodeEventDataOffsets.size() == visibleEventNodeMask.size() + 1);
 
-    /* Go through the data list in reverse, convert that to data handle ranges.
-       The `visibleNodeEventDataOffsets` array gets shifted by one element by
-       the process, thus now
+    /* Go through data of each visible node in reverse, convert that to data
+       handle ranges. The `visibleNodeEventDataOffsets` array gets shifted by
+       one element by the process, thus now
        `[visibleNodeEventDataOffsets[i], visibleNodeEventDataOffsets[i + 1])`
        is a range in which the `visibleNodeDataIds` array contains a list of
        data handles for visible node with ID `i`. The last array element is now
-       containing the end offset. */
-    for(std::size_t i = dataNodes.size(); i != 0; --i) {
-        const NodeHandle node = dataNodes[i - 1];
-        if(node == NodeHandle::Null)
+       containing the end offset. The lists are in increasing data ID order,
+       so they're written from the end of the range. */
+    for(std::size_t i = 0, iMax = Math::min(nodeFirstDataIds.size(), visibleEventNodeMask.size()); i != iMax; ++i) {
+        if(!visibleEventNodeMask[i])
+            continue;
+        UnsignedInt& offset = visibleNodeEventDataOffsets[i + 1];
+        offset += nodeDataCounts[i];
+        UnsignedInt out = offset;
+        for(UnsignedInt j = nodeFirstDataIds[i]; j != ~UnsignedInt{}; j = nodeNextDataIds[j])
+            visibleNodeEventData[--out] = nodeEventData(layerId, j);
+    }
+}
+
+/* The `visibleNodeIds` and `visibleNodeChildrenCounts` are outputs of
+   orderVisibleNodesDepthFirstInto() above, `visibleNodeEventDataOffsets` is
+   the output of orderNodeDataForEventHandlingInto() above. For every visible
+   node, `nodeEventBoundsMin` and `nodeEventBoundsMax` get filled with a
+   bounding rectangle of all nodes in its subtree (including the node itself)
+   that are in `visibleEventNodeMask` and have any event data, clipped to
+   rectangles of the node and all nodes in between, as the event handling
+   recursion never reaches them outside of those. If there's no such node, the
+   min is set to positive infinity and max to negative infinity, thus
+   containing no point.
+
+   The event handling then can skip the whole subtree if the event position
+   lies outside of the bounds instead of testing each node in it. Items
+   corresponding to nodes that aren't visible are left untouched. */
+void nodeEventBoundsInto(const Containers::StridedArrayView1D<const UnsignedInt>& visibleNodeIds, const Containers::StridedArrayView1D<const UnsignedInt>& visibleNodeChildrenCounts, const Containers::StridedArrayView1D<const Vector2>& absoluteNodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::BitArrayView visibleEventNodeMask, const Containers::ArrayView<const UnsignedInt> visibleNodeEventDataOffsets, const Containers::StridedArrayView1D<Vector2>& nodeEventBoundsMin, const Containers::StridedArrayView1D<Vector2>& nodeEventBoundsMax) {
+    CORRADE_INTERNAL_ASSERT(
+        visibleNodeChildrenCounts.size() == visibleNodeIds.size() &&
+        nodeSizes.size() == absoluteNodeOffsets.size() &&
+        visibleEventNodeMask.size() == absoluteNodeOffsets.size() &&
+        visibleNodeEventDataOffsets.size() == absoluteNodeOffsets.size() + 1 &&
+        nodeEventBoundsMin.size() == absoluteNodeOffsets.size() &&
+        nodeEventBoundsMax.size() == absoluteNodeOffsets.size());
+
+    /* Children are always after their parents in the visible node list, so
+       going backwards means the bounds of all children are calculated by the
+       time the parent is reached */
+    for(std::size_t i = visibleNodeIds.size(); i != 0; --i) {
+        const std::size_t visibleNodeIndex = i - 1;
+        const UnsignedInt id = visibleNodeIds[visibleNodeIndex];
+        const Vector2 nodeMin = absoluteNodeOffsets[id];
+        const Vector2 nodeMax = nodeMin + nodeSizes[id];
+
+        Vector2 min{Constants::inf()};
+        Vector2 max{-Constants::inf()};
+        if(visibleEventNodeMask[id] && visibleNodeEventDataOffsets[id] != visibleNodeEventDataOffsets[id + 1]) {
+            min = nodeMin;
+            max = nodeMax;
+        }
+
+        /* Join with bounds of all direct children. Empty children bounds are
+           infinite in the opposite direction so they don't affect the
+           result. */
+        for(std::size_t j = visibleNodeIndex + 1, jMax = visibleNodeIndex + visibleNodeChildrenCounts[visibleNodeIndex] + 1; j != jMax; j += visibleNodeChildrenCounts[j] + 1) {
+            const UnsignedInt childId = visibleNodeIds[j];
+            min = Math::min(min, nodeEventBoundsMin[childId]);
+            max = Math::max(max, nodeEventBoundsMax[childId]);
+        }
+
+        /* Clip to the node rectangle. Again, if the bounds are empty, they
+           stay empty after. */
+        nodeEventBoundsMin[id] = Math::max(min, nodeMin);
+        nodeEventBoundsMax[id] = Math::min(max, nodeMax);
+    }
+}
+
+/* Merges draws of consecutive top-level nodes that don't overlap each other.
+   Expects the `dataToDraw*` views to be the same as filled by
+   orderVisibleNodeDataInto() for all layers, i.e. `drawLayerCount` draws for
+   every visible top-level node and before compactDrawsInPlace() is called.
+
+   The bounds of each top-level node are a union of all its visible
+   (non-culled) nodes intersected with their clip rects. Draws of a top-level
+   node get moved to the draws of first top-level node in a sequence if its
+   bounds don't intersect a union of bounds of all top-level nodes in the
+   sequence. As data of a single layer are ordered by top-level node in
+   orderVisibleNodeDataInto(), the moved draw ranges are adjacent to the
+   ones they're merged with. Checking against the union instead of each
+   top-level node separately keeps this O(n) at the cost of giving up on some
+   merging opportunities. Top-level nodes that have any draws in layers with
+   LayerFeature::Composite end the sequence, as compositing of one would see
+   draws of the others reordered after it.
+
+   The moved draws are left with zero size, compactDrawsInPlace() is then
+   expected to be called to discard them. */
+void mergeDisjointTopLevelNodeDrawsInPlace(const Containers::StridedArrayView1D<const UnsignedInt>& visibleNodeIds, const Containers::StridedArrayView1D<const UnsignedInt>& visibleNodeChildrenCounts, const Containers::StridedArrayView1D<const Vector2>& absoluteNodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::BitArrayView visibleNodeMask, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectNodeCounts, const Containers::StridedArrayView1D<const LayerFeatures>& layerFeatures, const UnsignedInt drawLayerCount, const Containers::StridedArrayView1D<const UnsignedByte>& dataToDrawLayerIds, const Containers::StridedArrayView1D<UnsignedInt>& dataToDrawOffsets, const Containers::StridedArrayView1D<UnsignedInt>& dataToDrawSizes, const Containers::StridedArrayView1D<UnsignedInt>& dataToDrawClipRectOffsets, const Containers::StridedArrayView1D<UnsignedInt>& dataToDrawClipRectSizes) {
+    CORRADE_INTERNAL_ASSERT(
+        visibleNodeChildrenCounts.size() == visibleNodeIds.size() &&
+        clipRectSizes.size() == clipRectOffsets.size() &&
+        dataToDrawOffsets.size() == dataToDrawLayerIds.size() &&
+        dataToDrawSizes.size() == dataToDrawLayerIds.size() &&
+        dataToDrawClipRectOffsets.size() == dataToDrawLayerIds.size() &&
+        dataToDrawClipRectSizes.size() == dataToDrawLayerIds.size());
+
+    /* Nothing to draw, nothing to do. Also avoids a division by zero below. */
+    if(!drawLayerCount || dataToDrawLayerIds.isEmpty())
+        return;
+
+    /* Position of the first top-level node draws in the current sequence or
+       ~std::size_t{} if there's no sequence, and a union of its bounds */
+    std::size_t sequenceDrawOffset = ~std::size_t{};
+    Vector2 sequenceMin, sequenceMax;
+
+    std::size_t drawOffset = 0;
+    UnsignedInt clipRectIndex = 0;
+    UnsignedInt clipRectNodeCount = 0;
+    for(UnsignedInt visibleTopLevelNodeIndex = 0; visibleTopLevelNodeIndex != visibleNodeChildrenCounts.size(); visibleTopLevelNodeIndex += visibleNodeChildrenCounts[visibleTopLevelNodeIndex] + 1) {
+        /* Calculate bounds of all visible nodes in the top-level hierarchy,
+           going through the clip rects in sync */
+        Vector2 min{Constants::inf()};
+        Vector2 max{-Constants::inf()};
+        for(UnsignedInt i = 0, iMax = visibleNodeChildrenCounts[visibleTopLevelNodeIndex] + 1; i != iMax; ++i) {
+            const UnsignedInt nodeId = visibleNodeIds[visibleTopLevelNodeIndex + i];
+            if(visibleNodeMask[nodeId]) {
+                Vector2 nodeMin = absoluteNodeOffsets[nodeId];
+                Vector2 nodeMax = nodeMin + nodeSizes[nodeId];
+                /* A zero-size clip rect means no clipping */
+                if(!clipRectSizes[clipRectIndex].isZero()) {
+                    nodeMin = Math::max(nodeMin, clipRectOffsets[clipRectIndex]);
+                    nodeMax = Math::min(nodeMax, clipRectOffsets[clipRectIndex] + clipRectSizes[clipRectIndex]);
+                }
+                min = Math::min(min, nodeMin);
+                max = Math::max(max, nodeMax);
+            }
+
+            if(++clipRectNodeCount == clipRectNodeCounts[clipRectIndex]) {
+                ++clipRectIndex;
+                clipRectNodeCount = 0;
+            }
+        }
+
+        /* Check whether the top-level node draws anything and whether it
+           draws with a compositing layer */
+        bool drawsAnything = false;
+        bool composites = false;
+        for(std::size_t i = drawOffset, iMax = drawOffset + drawLayerCount; i != iMax; ++i) {
+            if(!dataToDrawSizes[i])
+                continue;
+            drawsAnything = true;
+            if(layerFeatures[dataToDrawLayerIds[i]] >= LayerFeature::Composite)
+                composites = true;
+        }
+
+        /* If it doesn't draw anything, it doesn't affect the sequence in any
+           way */
+        if(!drawsAnything) {
+            drawOffset += drawLayerCount;
             continue;
-        const UnsignedInt id = nodeHandleId(node);
-        if(visibleEventNodeMask[id])
-            /* The DataHandle generation isn't used for anything, only data and
-               layer ID is extracted out of the handle, so can be arbitrary
-               (but not 0, as that'd make dataHandleId() assert). */
-            visibleNodeEventData[visibleNodeEventDataOffsets[id + 1]++] = dataHandle(layer, i - 1, 0xfff);
+        }
+
+        /* If it's in a sequence and doesn't overlap with it, move the draws
+           to the first top-level node in the sequence */
+        if(!composites && sequenceDrawOffset != ~std::size_t{} &&
+           ((max <= sequenceMin).any() || (min >= sequenceMax).any()))
+        {
+            for(std::size_t i = 0; i != drawLayerCount; ++i) {
+                const std::size_t from = drawOffset + i;
+                if(!dataToDrawSizes[from])
+                    continue;
+
+                const std::size_t to = sequenceDrawOffset + i;
+                CORRADE_INTERNAL_DEBUG_ASSERT(dataToDrawLayerIds[to] == dataToDrawLayerIds[from]);
+                if(dataToDrawSizes[to]) {
+                    CORRADE_INTERNAL_DEBUG_ASSERT(
+                        dataToDrawOffsets[to] + dataToDrawSizes[to] == dataToDrawOffsets[from] &&
+                        dataToDrawClipRectOffsets[to] + dataToDrawClipRectSizes[to] == dataToDrawClipRectOffsets[from]);
+                    dataToDrawSizes[to] += dataToDrawSizes[from];
+                    dataToDrawClipRectSizes[to] += dataToDrawClipRectSizes[from];
+                } else {
+                    dataToDrawOffsets[to] = dataToDrawOffsets[from];
+                    dataToDrawSizes[to] = dataToDrawSizes[from];
+                    dataToDrawClipRectOffsets[to] = dataToDrawClipRectOffsets[from];
+                    dataToDrawClipRectSizes[to] = dataToDrawClipRectSizes[from];
+                }
+
+                dataToDrawOffsets[from] = 0;
+                dataToDrawSizes[from] = 0;
+                dataToDrawClipRectOffsets[from] = 0;
+                dataToDrawClipRectSizes[from] = 0;
+            }
+
+            sequenceMin = Math::min(sequenceMin, min);
+            sequenceMax = Math::max(sequenceMax, max);
+
+        /* Otherwise start a new sequence, unless the node composites */
+        } else if(!composites) {
+            sequenceDrawOffset = drawOffset;
+            sequenceMin = min;
+            sequenceMax = max;
+        } else sequenceDrawOffset = ~std::size_t{};
+
+        drawOffset += drawLayerCount;
     }
+
+    CORRADE_INTERNAL_ASSERT(drawOffset == dataToDrawLayerIds.size());
 }
 
-/* Reduces the three arrays by throwing away items where size is 0. Returns the
-   resulting size. */
-UnsignedInt compactDrawsInPlace(const Containers::StridedArrayView1D<UnsignedByte>& dataToDrawLayerIds, const Containers::StridedArrayView1D<UnsignedInt>& dataToDrawOffsets, const Containers::StridedArrayView1D<UnsignedInt>& dataToDrawSizes, const Containers::StridedArrayView1D<UnsignedInt>& dataToDrawClipRectOffsets, const Containers::StridedArrayView1D<UnsignedInt>& dataToDrawClipRectSizes) {
+/* Reduces the three arrays by throwing away items where size is 0 and merging
+   draws of the same layer that follow each other. Returns the resulting size.
+
+   Data and clip rects of a single layer are ordered by top-level node in
+   orderVisibleNodeDataInto(), so if two draws of the same layer end up next
+   to each other after removing the empty ones, their ranges are adjacent and
+   can be drawn as one without affecting the draw order. That's not done for
+   layers that advertise LayerFeature::Composite, as the compositing operation
+   for the second draw has to see the output of the first. */
+UnsignedInt compactDrawsInPlace(const Containers::StridedArrayView1D<const LayerFeatures>& layerFeatures, const Containers::StridedArrayView1D<UnsignedByte>& dataToDrawLayerIds, const Containers::StridedArrayView1D<UnsignedInt>& dataToDrawOffsets, const Containers::StridedArrayView1D<UnsignedInt>& dataToDrawSizes, const Containers::StridedArrayView1D<UnsignedInt>& dataToDrawClipRectOffsets, const Containers::StridedArrayView1D<UnsignedInt>& dataToDrawClipRectSizes) {
     CORRADE_INTERNAL_ASSERT(
         dataToDrawOffsets.size() == dataToDrawLayerIds.size() &&
         dataToDrawSizes.size() == dataToDrawLayerIds.size() &&
@@ -918,6 +1392,19 @@ UnsignedInt compactDrawsInPlace(const Containers::StridedArrayView1D<UnsignedByt
             continue;
         }
 
+        /* If the previous non-empty draw is from the same non-compositing
+           layer and the ranges are adjacent, extend it instead */
+        if(offset &&
+           dataToDrawLayerIds[offset - 1] == dataToDrawLayerIds[i] &&
+           !(layerFeatures[dataToDrawLayerIds[i]] >= LayerFeature::Composite) &&
+           dataToDrawOffsets[offset - 1] + dataToDrawSizes[offset - 1] == dataToDrawOffsets[i] &&
+           dataToDrawClipRectOffsets[offset - 1] + dataToDrawClipRectSizes[offset - 1] == dataToDrawClipRectOffsets[i])
+        {
+            dataToDrawSizes[offset - 1] += dataToDrawSizes[i];
+            dataToDrawClipRectSizes[offset - 1] += dataToDrawClipRectSizes[i];
+            continue;
+        }
+
         /* Don't copy to itself */
         if(i != offset) {
             dataToDrawLayerIds[offset] = dataToDrawLayerIds[i];
@@ -930,26 +1417,6 @@ UnsignedInt compactDrawsInPlace(const Containers::StridedArrayView1D<UnsignedByt
         ++offset;
     }
 
-    /** @todo optimization step where draws of the same layer following each
-        other are merged into one (with the assumption that the draw order is
-        kept), that allows imgui-level efficiency where the whole UI with all
-        widgets can be drawn in a single call, assuming most of the content
-        (text, backgrounds, ...) is implemented in a single layer
-
-        this would require that UserInterface populates the to-update data in
-        the draw order, not in the layer ID order */
-
-    /** @todo top-level nodes that have mutually disjoint bounding rect for all
-        (clipped) subnodes can be also be drawn together without worrying about
-        incorrect draw order -- however it needs some algorithm that is better
-        than O(n^2) in finding mutually disjoint sets, plus also things like
-        two top-level nodes being disjoint but between them is ordered another
-        that overlaps with both
-
-        so pick just nodes that are disjoint in a sequence, and stop when
-        something overlaps? that's still O(n^2) though, every new node
-        considered has to be checked with all previous */
-
     return offset;
 }
 
@@ -32,6 +32,7 @@
    implementations */
 
 #include <Corrade/Containers/ArrayTuple.h>
+#include <Corrade/Containers/BitArray.h>
 #include <Corrade/Containers/BitArrayView.h>
 #include <Corrade/Containers/Reference.h>
 #include <Corrade/Containers/StridedArrayView.h>
@@ -104,12 +105,28 @@ struct AbstractVisualLayer::State {
     Containers::ArrayTuple dynamicStyleStorage;
     Containers::MutableBitArrayView dynamicStylesUsed;
     Containers::ArrayView<AnimationHandle> dynamicStyleAnimations;
+    /* Count of set bits in dynamicStylesUsed, to not have to go through the
+       whole bit array in dynamicStyleUsedCount(). The dynamicStyleFreeHint is
+       a lower bound on the first unset bit, all bits before it are guaranteed
+       to be set, so the allocation doesn't need to go through the whole
+       prefix every time. The max count is for tuning the pool size. */
+    UnsignedInt dynamicStyleUsedCount = 0,
+        dynamicStyleFreeHint = 0,
+        dynamicStyleUsedMaxCount = 0;
 
     /* These views are assumed to point to subclass own data and maintained to
        have its size always match layer capacity. The `calculatedStyles` are a
        copy of `styles` with additional transitions applied for disabled
        nodes, which is performed in the layer doUpdate(). */
     Containers::StridedArrayView1D<UnsignedInt> styles, calculatedStyles;
+    /* Whether given data was attached to a disabled node when its
+       `calculatedStyles` entry was last calculated. Together with
+       modifiedDataMask() it allows doUpdate() to skip calling the disabled
+       style transition for data whose style and node enablement didn't
+       change. Lazily resized to layer capacity in doUpdate(), new data are
+       always marked as modified so their bits don't need to be initialized
+       to anything specific. */
+    Containers::BitArray calculatedStylesDisabled;
     /* 99% of internal accesses to the Shared instance need the State struct,
        so saving it directly to avoid an extra indirection, In some cases the
        public API reference is needed (mainly for user-side access, such as
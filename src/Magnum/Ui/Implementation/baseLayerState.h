@@ -31,6 +31,10 @@
    eventually possibly also 3rd party renderer implementations */
 
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/BitArray.h>
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Packing.h>
 
 #include "Magnum/Ui/BaseLayer.h"
 #include "Magnum/Ui/Implementation/abstractVisualLayerState.h"
@@ -39,6 +43,17 @@ namespace Magnum { namespace Ui {
 
 namespace Implementation {
 
+/* Whether given uniform can be drawn with the shader variant that has both
+   outline and rounded corners disabled, used with
+   BaseLayerSharedFlag::AutomaticShaderVariants. A zero outline width isn't
+   enough as a non-zero inner outline corner radius makes the outline show in
+   the corners. */
+inline bool isSimpleBaseLayerStyleUniform(const BaseLayerStyleUniform& uniform) {
+    return uniform.outlineWidth.isZero() &&
+           uniform.cornerRadius.isZero() &&
+           uniform.innerOutlineCornerRadius.isZero();
+}
+
 struct BaseLayerStyle {
     /* Uniform index corresponding to given style */
     UnsignedInt uniform;
@@ -62,13 +77,17 @@ struct BaseLayer::Shared::State: AbstractVisualLayer::Shared::State {
        so the second and subsequent passes don't tap outside. The radius is
        always at most 31, so can be a byte. */
     UnsignedByte backgroundBlurRadius;
+    /* Used by BaseLayerGL to blur at a lower resolution, and for padding the
+       blur area so the upsampling doesn't sample unblurred texels. Is always
+       1, 2 or 4. */
+    UnsignedByte backgroundBlurDownsampling;
 
     BaseLayerSharedFlags flags;
 
     #ifndef CORRADE_NO_ASSERT
     bool setStyleCalled = false;
     #endif
-    /* 1 byte free, 2 bytes free w/ CORRADE_NO_ASSERT */
+    /* 1 byte free w/ CORRADE_NO_ASSERT */
 
     /* Can't be inferred from styleUniforms.size() as those are non-empty only
        if dynamicStyleCount is non-zero */
@@ -85,6 +104,10 @@ struct BaseLayer::Shared::State: AbstractVisualLayer::Shared::State {
     /* Uniform values to be copied to layer-specific uniform buffers. Empty
        and unused if dynamicStyleCount is 0. */
     Containers::ArrayView<BaseLayerStyleUniform> styleUniforms;
+    /* Which of the (non-dynamic) uniforms can be drawn with the cheaper
+       shader variant, with isSimpleBaseLayerStyleUniform(). Empty and unused
+       if BaseLayerSharedFlag::AutomaticShaderVariants isn't enabled. */
+    Containers::MutableBitArrayView simpleStyleUniforms;
     BaseLayerCommonStyleUniform commonStyleUniform{NoInit};
 };
 
@@ -134,11 +157,108 @@ struct BaseLayerSubdividedTexturedVertex {
     Vector3 textureCoordinates;
 };
 
+/* Used if BaseLayerSharedFlag::InstancedQuads is enabled. The position and
+   size already contain the smoothness expansion, the shader then expands the
+   quad corners from these based on gl_VertexID. */
+struct BaseLayerInstance {
+    Vector2 position;
+    Vector2 size;
+    Vector4 outlineWidth;
+    Color4 color;
+    UnsignedInt styleUniform;
+};
+
+struct BaseLayerTexturedInstance {
+    BaseLayerInstance instance;
+    /* Texture coordinates of the top left corner, with the smoothness
+       expansion. This and the size are Y-flipped, same as with
+       BaseLayerTexturedVertex. */
+    Vector3 textureCoordinateOffset;
+    Vector2 textureCoordinateSize;
+};
+
+/* Used in the GPU vertex buffer instead of BaseLayerVertex and
+   BaseLayerTexturedVertex if BaseLayerSharedFlag::CompactVertices is enabled,
+   converted from them with compactBaseLayerVerticesInto() on upload. The
+   position, center distance and outline width are in units of
+   1/BaseLayerCompactVertexScale of the UI size, the shader derives the UI size
+   from the projection to convert them back. */
+struct BaseLayerCompactVertex {
+    Vector2s position;
+    Vector2s centerDistance;
+    Vector4s outlineWidth;
+    Color4ub color;
+    UnsignedInt styleUniform;
+};
+
+struct BaseLayerCompactTexturedVertex {
+    BaseLayerCompactVertex vertex;
+    /* XY in units of 1/BaseLayerCompactVertexScale, Z is the layer. Followed
+       by two bytes of padding. */
+    Vector3s textureCoordinates;
+};
+
+/* Has to match the value used in BaseShader.vert */
+constexpr Float BaseLayerCompactVertexScale = 16384.0f;
+
+static_assert(sizeof(BaseLayerCompactVertex) == 24 && sizeof(BaseLayerCompactTexturedVertex) == 32,
+    "expected compact vertices to be tightly packed");
+
+template<std::size_t size> inline Math::Vector<size, Short> compactBaseLayerFixedPoint(const Math::Vector<size, Float>& value) {
+    return Math::Vector<size, Short>{Math::round(Math::clamp(value*BaseLayerCompactVertexScale, -32768.0f, 32767.0f))};
+}
+
+inline void compactBaseLayerVertexInto(const BaseLayerVertex& vertex, BaseLayerCompactVertex& out, const Vector2& inverseUiSize) {
+    out.position = compactBaseLayerFixedPoint(vertex.position*inverseUiSize);
+    out.centerDistance = compactBaseLayerFixedPoint(vertex.centerDistance*inverseUiSize);
+    out.outlineWidth = compactBaseLayerFixedPoint(vertex.outlineWidth*Vector4{inverseUiSize.x(), inverseUiSize.y(), inverseUiSize.x(), inverseUiSize.y()});
+    out.color = Math::pack<Color4ub>(Math::clamp(vertex.color, 0.0f, 1.0f));
+    out.styleUniform = vertex.styleUniform;
+}
+
+inline void compactBaseLayerVerticesInto(const Containers::ArrayView<const BaseLayerVertex> vertices, const Containers::ArrayView<BaseLayerCompactVertex> out, const Vector2& uiSize) {
+    CORRADE_INTERNAL_ASSERT(out.size() == vertices.size());
+    const Vector2 inverseUiSize = 1.0f/uiSize;
+    for(std::size_t i = 0; i != vertices.size(); ++i)
+        compactBaseLayerVertexInto(vertices[i], out[i], inverseUiSize);
+}
+
+inline void compactBaseLayerVerticesInto(const Containers::ArrayView<const BaseLayerTexturedVertex> vertices, const Containers::ArrayView<BaseLayerCompactTexturedVertex> out, const Vector2& uiSize) {
+    CORRADE_INTERNAL_ASSERT(out.size() == vertices.size());
+    const Vector2 inverseUiSize = 1.0f/uiSize;
+    for(std::size_t i = 0; i != vertices.size(); ++i) {
+        compactBaseLayerVertexInto(vertices[i].vertex, out[i].vertex, inverseUiSize);
+        out[i].textureCoordinates = {
+            compactBaseLayerFixedPoint(vertices[i].textureCoordinates.xy()),
+            Short(vertices[i].textureCoordinates.z())
+        };
+    }
+}
+
 static_assert(
     offsetof(BaseLayerSubdividedTexturedVertex, vertex) == 0 &&
     offsetof(BaseLayerSubdividedTexturedVertex, textureScale) == offsetof(BaseLayerSubdividedVertex, centerDistanceY) + sizeof(BaseLayerSubdividedVertex::centerDistanceY),
     "expected textureScale to immediately follow centerDistanceY");
 
+/* Count of data whose vertices are generated by a single task if
+   BaseLayer::setVertexExecutor() is set. Smaller amounts of data aren't worth
+   the executor overhead and are generated directly. */
+constexpr std::size_t BaseLayerVertexTaskDataCount = 1024;
+
+/* Minimal count of consecutive data drawn with the cheaper shader variant if
+   BaseLayerSharedFlag::AutomaticShaderVariants is enabled. Shorter runs are
+   drawn with the full shader together with their neighbors, as the extra
+   draw call and program switch would cost more than what's saved, unless
+   they span the whole draw. */
+constexpr std::size_t BaseLayerShaderVariantMinDataCount = 16;
+
+/* Count of per-data values in a single row of the offset texture with
+   BaseLayerSharedFlag::NodeRelativePositions and the clip rect texture with
+   BaseLayerSharedFlag::ShaderClipping. The arrays are always padded to a
+   multiple of this so they can be uploaded as whole rows. Has to match the
+   width used in BaseShader.vert. */
+constexpr std::size_t BaseLayerDataOffsetTextureWidth = 1024;
+
 }
 
 struct BaseLayer::State: AbstractVisualLayer::State {
@@ -166,9 +286,46 @@ struct BaseLayer::State: AbstractVisualLayer::State {
 
     Containers::Array<Implementation::BaseLayerData> data;
     /* Is either Implementation::BaseLayerVertex or BaseLayerTexturedVertex
-       based on whether texturing is enabled */
+       based on whether texturing is enabled, or their subdivided variants.
+       With BaseLayerSharedFlag::InstancedQuads it's either BaseLayerInstance
+       or BaseLayerTexturedInstance, one for each drawn data in draw order
+       instead of four or sixteen for each data in data ID order. */
     Containers::Array<char> vertices;
+    /* Empty with BaseLayerSharedFlag::InstancedQuads */
     Containers::Array<UnsignedInt> indices;
+    /* Byte range of `vertices` that changed in doUpdate() calls since it was
+       last reset, extended to the whole array if its size changed. Meant to
+       be reset by the renderer once the range is uploaded, an empty range is
+       marked by begin being larger than end. Previous contents of vertices
+       of all updated data are saved to `vertexScratch` to know what changed. */
+    std::size_t vertexUpdateBegin = ~std::size_t{};
+    std::size_t vertexUpdateEnd = 0;
+    Containers::Array<char> vertexScratch;
+    /* IDs of visible data that were modified since the last doUpdate(), used
+       to regenerate just their vertices if nothing else changed */
+    Containers::Array<UnsignedInt> modifiedDataIds;
+    /* Offsets (XY) and opacities (Z) of nodes the data are attached to,
+       indexed by data ID, used only with
+       BaseLayerSharedFlag::NodeRelativePositions. The size is capacity()
+       rounded up to BaseLayerDataOffsetTextureWidth. The range that changed
+       is tracked in the same way as for vertices, but in elements instead of
+       bytes. */
+    Containers::Array<Vector3> dataNodeProperties;
+    std::size_t dataNodePropertyUpdateBegin = ~std::size_t{};
+    std::size_t dataNodePropertyUpdateEnd = 0;
+    /* Clip rect min and max corners of the nodes the data are attached to,
+       indexed by data ID, used only with BaseLayerSharedFlag::ShaderClipping.
+       Sized and tracked the same way as `dataNodeProperties`. */
+    Containers::Array<Vector4> dataClipRects;
+    std::size_t dataClipRectUpdateBegin = ~std::size_t{};
+    std::size_t dataClipRectUpdateEnd = 0;
+    /* Whether given data can be drawn with the cheaper shader variant,
+       indexed by data ID, used only with
+       BaseLayerSharedFlag::AutomaticShaderVariants. The size is capacity(),
+       only bits of visible data are filled. */
+    Containers::BitArray simpleData;
+    void(*vertexExecutor)(UnsignedInt, void(*)(void*, UnsignedInt), void*, void*){};
+    void* vertexExecutorUserData{};
 
     /* Used for scaling the smoothness expansion to actual pixels, for clipping
        rects in BaseLayerGL and for expanding compositing rects for blur radius
@@ -0,0 +1,84 @@
+#ifndef Magnum_Ui_Implementation_blurQuads_h
+#define Magnum_Ui_Implementation_blurQuads_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Magnum/Math/BitVector.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Range.h>
+
+/* Extracted out of BaseLayerGL for easier testing */
+
+namespace Magnum { namespace Ui { namespace {
+
+/* Merges overlapping blur quads in order to not blur the overlapping areas
+   multiple times. Each quad is four vertices going from the min to the max
+   corner in the order given by Math::lerp(min, max, BitVector2{i}), i.e.
+   the first vertex is the min and the last is the max.
+
+   Two overlapping quads are merged into their bounding box only if its area
+   isn't larger than area of the two quads combined, as otherwise it'd blur
+   more than without merging. The merged quad replaces the first of the two,
+   the second gets collapsed to a zero-area quad to keep the index buffer
+   valid. Zero-area quads are skipped, which makes the operation idempotent.
+   As a merged quad can overlap other quads that it didn't overlap before,
+   the process is repeated until nothing gets merged anymore. Returns true if
+   any quads were modified and thus need to be uploaded again. */
+bool mergeOverlappingBlurQuadsInPlace(const Containers::ArrayView<Vector2> vertices) {
+    CORRADE_INTERNAL_ASSERT(vertices.size() % 4 == 0);
+    const std::size_t count = vertices.size()/4;
+
+    bool modified = false;
+    for(bool merged = true; merged; ) {
+        merged = false;
+        for(std::size_t i = 0; i != count; ++i) {
+            Range2D a{vertices[i*4 + 0], vertices[i*4 + 3]};
+            if(!a.size().product())
+                continue;
+
+            for(std::size_t j = i + 1; j != count; ++j) {
+                const Range2D b{vertices[j*4 + 0], vertices[j*4 + 3]};
+                if(!b.size().product() || !Math::intersects(a, b))
+                    continue;
+
+                const Range2D joined = Math::join(a, b);
+                if(joined.size().product() > a.size().product() + b.size().product())
+                    continue;
+
+                for(UnsignedByte k = 0; k != 4; ++k) {
+                    vertices[i*4 + k] = Math::lerp(joined.min(), joined.max(), BitVector2{k});
+                    vertices[j*4 + k] = joined.min();
+                }
+                a = joined;
+                merged = modified = true;
+            }
+        }
+    }
+
+    return modified;
+}
+
+}}}
+
+#endif
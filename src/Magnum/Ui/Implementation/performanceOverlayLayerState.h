@@ -0,0 +1,77 @@
+#ifndef Magnum_Ui_Implementation_performanceOverlayLayerState_h
+#define Magnum_Ui_Implementation_performanceOverlayLayerState_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/* Definition of the PerformanceOverlayLayer::State struct to be used by both
+   PerformanceOverlayLayer and PerformanceOverlayLayerGL as well as the tests */
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Reference.h>
+#include <Magnum/Math/Color.h>
+
+#include "Magnum/Ui/PerformanceOverlayLayer.h"
+
+namespace Magnum { namespace Ui {
+
+namespace Implementation {
+
+struct PerformanceOverlayLayerVertex {
+    Vector2 position;
+    /* Premultiplied */
+    Color4 color;
+};
+
+}
+
+struct PerformanceOverlayLayer::State {
+    explicit State(AbstractUserInterface& ui): ui{ui} {}
+    /* Derived by PerformanceOverlayLayerGL::State, same reasoning as in
+       AbstractVisualLayer::State */
+    virtual ~State() = default;
+
+    Containers::Reference<AbstractUserInterface> ui;
+
+    /* Compared to AbstractUserInterface::nodeUpdateStatisticsFrame() in
+       doState(), returning LayerState::NeedsDataUpdate if it differs */
+    UnsignedLong statisticsFrame = ~UnsignedLong{};
+
+    PerformanceOverlayMode mode = PerformanceOverlayMode::DataUpdates;
+    Color4 color{0.8f, 0.16f, 0.16f, 0.8f};
+
+    /* Four vertices and six indices for each drawn node, regenerated on
+       every doUpdate() */
+    Containers::Array<Implementation::PerformanceOverlayLayerVertex> vertices;
+    Containers::Array<UnsignedInt> indices;
+
+    /* Per-node scratch data, kept around to avoid allocating them every
+       time */
+    Containers::Array<UnsignedInt> nodeDataCounts;
+};
+
+}}
+
+#endif
@@ -31,12 +31,19 @@
    this header gets published) eventually possibly also 3rd party renderer
    implementations */
 
+#include <atomic>
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/BitArray.h>
+#include <Corrade/Containers/Pair.h>
 #include <Corrade/Containers/Reference.h>
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Packing.h>
 #include <Magnum/Math/Range.h>
 #include <Magnum/Text/AbstractFont.h>
 #include <Magnum/Text/AbstractShaper.h>
 #include <Magnum/Text/Alignment.h>
+#include <Magnum/Text/Feature.h>
 
 #include "Magnum/Ui/TextLayer.h"
 #include "Magnum/Ui/TextProperties.h"
@@ -46,17 +53,68 @@ namespace Magnum { namespace Ui {
 
 namespace Implementation {
 
+/* Shaper instance configured for a particular script, language and shape
+   direction, to not have to reconfigure it when switching between texts with
+   different properties */
+struct TextLayerFontShaper {
+    Containers::Pointer<Text::AbstractShaper> shaper;
+    /* Null-terminated, same as in TextProperties */
+    char language[16];
+    Text::Script script;
+    Text::ShapeDirection direction;
+};
+
+/* Max count of shaper instances kept for each font */
+/** @todo make configurable if it turns out to be useful */
+enum: std::size_t {
+    TextLayerFontShaperPoolSize = 4
+};
+
+/* Printable ASCII characters, from ' ' to '~', handled by the simple shaping
+   path */
+enum: std::size_t {
+    TextLayerSimpleShapeCharacterCount = '~' - ' ' + 1
+};
+
+/* Size of a single TextLayerFont::coverage block */
+enum: std::size_t {
+    TextLayerFontCoverageBlockSize = 4096
+};
+
+struct TextLayerSimpleShapeGlyph {
+    UnsignedInt id;
+    Float advance;
+};
+
 struct TextLayerFont {
     Containers::Pointer<Text::AbstractFont> fontStorage;
     /* Is null for instance-less fonts */
     Text::AbstractFont* font;
-    /* The instance is cached to use for subsequent shaping operations. To keep
+    /* Shaper instances are cached to use for subsequent shaping operations,
+       at most TextLayerFontShaperPoolSize of them, each configured for
+       different properties. Ordered from the most recently used. To keep
        things simple, every Font item has its own even though they might come
        from the same AbstractFont originally. */
-    Containers::Pointer<Text::AbstractShaper> shaper;
+    Containers::Array<TextLayerFontShaper> shapers;
     /* Size at which to render divided by `font->size()` */
     Float scale;
     UnsignedInt glyphCacheFontId;
+    /* Used if TextLayer::Shared::Configuration::setSimpleShaping() is
+       enabled, populated on first use. Glyph IDs and advances of printable
+       ASCII characters indexed by `character - ' '`, with the ID being ~0 if
+       the character doesn't shape to a single glyph. Kerning is indexed by
+       `first*TextLayerSimpleShapeCharacterCount + second`, NaN if the pair
+       wasn't shaped yet and infinity if it doesn't shape to two glyphs. */
+    Containers::Array<TextLayerSimpleShapeGlyph> simpleShapeGlyphs;
+    Containers::Array<Float> simpleShapeKerning;
+    /* Set by TextLayer::Shared::setFontFallbacks() */
+    Containers::Array<FontHandle> fallbacks;
+    /* Which codepoints the font has a glyph for, in blocks of
+       TextLayerFontCoverageBlockSize codepoints populated on first query.
+       Each block has two bits per codepoint, the even one set if the
+       codepoint was queried already and the odd one set if the font has a
+       glyph for it. Empty if the font was never queried. */
+    Containers::Array<Containers::BitArray> coverage;
 };
 
 struct TextLayerStyle {
@@ -125,6 +183,59 @@ struct TextLayer::Shared::State: AbstractVisualLayer::Shared::State {
        different total feature count. */
     Containers::Array<TextFeatureValue> styleFeatures;
 
+    /* LRU cache of shaped text, disabled if shapeCacheSize is 0. The lookup
+       is a linear search in shapeCacheHashes, which is fast enough for the
+       hundreds of entries the cache is meant for, and avoids any extra
+       bookkeeping on eviction. Entries get replaced but never removed, so
+       the shapeCache size is the count of used entries. */
+    UnsignedInt shapeCacheSize;
+    /* Whether simple text is shaped from TextLayerFont::simpleShapeGlyphs
+       instead of going through the shaper */
+    bool simpleShaping;
+    /* Whether glyph runs are allocated with a power-of-two capacity and reused
+       instead of always being put at the end */
+    bool glyphRunReuse;
+    /* Whether text input events only edit the text and the reshape is done
+       in the next doUpdate() */
+    bool textInputBatching;
+    /* Whether glyph instances are generated instead of glyph quad vertices */
+    bool instancedGlyphs;
+    /* Whether glyphs missing from the glyph cache are added on demand */
+    bool onDemandGlyphCacheFilling = false;
+    /* Whether the glyph cache contains a distance field */
+    bool distanceFieldGlyphs;
+    /* Whether the renderer stores glyph vertices in a compact format */
+    bool compactVertices;
+    UnsignedInt shapeCacheFirst = ~UnsignedInt{};
+    UnsignedInt shapeCacheLast = ~UnsignedInt{};
+    Containers::Array<UnsignedLong> shapeCacheHashes;
+    Containers::Array<Implementation::TextLayerShapeCacheEntry> shapeCache;
+
+    #ifndef CORRADE_NO_ASSERT
+    /* Set while a layer shapes texts or fills the glyph cache in doUpdate(),
+       both of which modify the shaper, shape cache and missing glyph list
+       above and below. Used to detect layers sharing this state being
+       updated concurrently by a layer update executor. */
+    std::atomic<bool> updateShapingInProgress{false};
+    #endif
+
+    /* Pairs of font ID and a font-specific glyph ID that were missing from
+       the glyph cache when shaping with onDemandGlyphCacheFilling enabled.
+       Can contain duplicates. Added to the cache, in a single batch for each
+       font, and cleared by the first doUpdate() of any layer sharing this
+       state that has glyph runs waiting for them. */
+    Containers::Array<Containers::Pair<UnsignedInt, UnsignedInt>> missingGlyphs;
+
+    /* Returns an index of an entry matching given key or ~UnsignedInt{} if
+       there's none, marking the found entry as most recently used */
+    UnsignedInt shapeCacheFind(Containers::ArrayView<const char> key, UnsignedLong hash);
+    /* Adds a new entry with space for given glyph count, replacing the least
+       recently used one if the cache is full. The entry is marked as most
+       recently used and its index returned. */
+    UnsignedInt shapeCacheAdd(Containers::Array<char>&& key, UnsignedLong hash, UnsignedInt glyphCount, Text::ShapeDirection direction);
+    /* Moves an entry to the front of the LRU list */
+    void shapeCacheUse(UnsignedInt id);
+
     Containers::ArrayTuple styleStorage;
 
     /* Uniform mapping, fonts, alignments, font features and padding values
@@ -149,7 +260,8 @@ namespace Implementation {
 struct TextLayerGlyphData {
     /* (Aligned) position relative to the node origin */
     Vector2 position;
-    /* Cache-global glyph ID */
+    /* Cache-global glyph ID, or font-specific if the run has
+       TextLayerGlyphRun::pendingGlyphIdFont set */
     UnsignedInt glyphId;
     /* Cluster ID for cursor positioning in editable text. Initially abused for
        saving glyph offset + advance (i.e., two Vector2) *somewehere* without
@@ -158,19 +270,66 @@ struct TextLayerGlyphData {
     UnsignedInt glyphCluster;
 };
 
+/* Shaper output remembered in TextLayer::Shared::State::shapeCache. Glyph
+   IDs are font-specific, offsets and advances are as returned from the
+   shaper, i.e. before applying the font scale and alignment. */
+struct TextLayerShapeCacheGlyph {
+    Vector2 offset;
+    Vector2 advance;
+    UnsignedInt id;
+};
+
+struct TextLayerShapeCacheEntry {
+    /* Font handle, script, language, shape direction, features and the text
+       itself serialized for an exact comparison. Hash of it is stored in
+       TextLayer::Shared::State::shapeCacheHashes. */
+    Containers::Array<char> key;
+    Containers::Array<TextLayerShapeCacheGlyph> glyphs;
+    /* Direction the shaper reported after shaping */
+    Text::ShapeDirection direction;
+    /* 3 bytes free */
+    /* Previous (more recently used) and next (less recently used) entry, or
+       ~UnsignedInt{} if there's none */
+    UnsignedInt previous, next;
+};
+
 struct TextLayerGlyphRun {
     /* If set to ~UnsignedInt{}, given run is unused and gets removed during
        the next recompaction in doUpdate(). */
     UnsignedInt glyphOffset;
     UnsignedInt glyphCount;
+    /* Count of glyphs allocated for the run. Same as glyphCount unless
+       TextLayer::Shared::Configuration::setGlyphRunReuse() is enabled, in
+       which case it's glyphCount rounded up to a power of two. */
+    UnsignedInt glyphCapacity;
     /* Backreference to the `TextLayerData` so the `glyphRun` can be updated
-       there when recompacting */
+       there when recompacting. With glyph run reuse enabled, unused runs are
+       marked by setting this to ~UnsignedInt{} instead of glyphOffset, as
+       their glyph data stay allocated for reuse. */
     UnsignedInt data;
+    /* If not ~UnsignedInt{}, the glyph IDs in the run are font-specific for
+       font with this ID, waiting for missing glyphs to be added to the glyph
+       cache in the next doUpdate() to be converted to cache-global. Set by
+       TextLayer::shapeTextInternal() if on-demand glyph cache filling is
+       enabled and some glyphs weren't in the cache. If set to
+       TextLayerGlyphRunPendingGlyphIdFontPerGlyph, the text was shaped with
+       font fallbacks and the font ID for each glyph is stored in the
+       otherwise unused TextLayerGlyphData::glyphCluster, as fallbacks are
+       never used for editable text. */
+    UnsignedInt pendingGlyphIdFont;
+};
+
+enum: UnsignedInt {
+    TextLayerGlyphRunPendingGlyphIdFontPerGlyph = ~UnsignedInt{} - 1
 };
 
 struct TextLayerTextRun {
     UnsignedInt textOffset;
     UnsignedInt textSize;
+    /* Same as textSize unless TextLayer::Shared::Configuration::setGlyphRunReuse()
+       is enabled, in which case it's rounded up to a power of two and edits
+       that fit are done in place */
+    UnsignedInt textCapacity;
     /* Backreference to the `TextLayerData` so the `textRun` can be updated
        there when recompacting */
     UnsignedInt data;
@@ -194,12 +353,68 @@ struct TextLayerTextRun {
     UnsignedByte direction;
 };
 
+/* Text with TextDataFlag::DeferredShaping waiting to be shaped in the next
+   doUpdate() */
+struct TextLayerDeferredShape {
+    /* Backreference to the `TextLayerData`, or ~UnsignedInt{} if the data was
+       removed or its text was set again since */
+    UnsignedInt data;
+    UnsignedInt style;
+    /* Points to TextLayer::State::deferredShapeTextData */
+    UnsignedInt textOffset, textSize;
+    /* Points to TextLayer::State::deferredShapeFeatures */
+    UnsignedInt featureOffset, featureCount;
+
+    /* Subset of TextProperties, same as in TextLayerTextRun */
+    char language[16];
+    Text::Script script;
+    FontHandle font;
+    Text::Alignment alignment;
+    UnsignedByte direction;
+
+    /* Filled by the shape executor tasks, if `shaped` isn't set the text gets
+       shaped directly in shapeTextInternal() instead */
+    bool shaped;
+    Text::ShapeDirection shapedDirection;
+    Containers::Array<TextLayerShapeCacheGlyph> glyphs;
+};
+
+/* Source of a text with TextDataFlag::Hibernatable, from which it's reshaped
+   after TextLayer::hibernate() */
+struct TextLayerHibernationSource {
+    /* Backreference to the `TextLayerData`, or ~UnsignedInt{} if the data was
+       removed or its text was set again since */
+    UnsignedInt data;
+    UnsignedInt style;
+    /* Points to TextLayer::State::hibernationSourceTextData */
+    UnsignedInt textOffset, textSize;
+    /* Points to TextLayer::State::hibernationSourceFeatures */
+    UnsignedInt featureOffset, featureCount;
+
+    /* Subset of TextProperties, same as in TextLayerDeferredShape */
+    char language[16];
+    Text::Script script;
+    FontHandle font;
+    Text::Alignment alignment;
+    UnsignedByte direction;
+
+    /* Set by TextLayer::hibernate(), reset once the text is reshaped in
+       doUpdate() */
+    bool hibernated;
+};
+
 struct TextLayerData {
     Vector4 padding;
     UnsignedInt glyphRun;
     /* Used only if flags contain TextDataFlag::Editable, otherwise set to
        ~UnsignedInt{} */
     UnsignedInt textRun;
+    /* Used only if flags contain TextDataFlag::DeferredShaping and the text
+       wasn't shaped yet, otherwise set to ~UnsignedInt{} */
+    UnsignedInt deferredShape;
+    /* Used only if flags contain TextDataFlag::Hibernatable, otherwise set to
+       ~UnsignedInt{} */
+    UnsignedInt hibernationSource;
     /* calculatedStyle is filled by AbstractVisualLayer::doUpdate() */
     UnsignedInt style, calculatedStyle;
     /* Ratio of the style size and font size, for appropriately scaling the
@@ -234,6 +449,80 @@ struct TextLayerVertex {
     UnsignedInt styleUniform;
 };
 
+/* Used in the GPU vertex buffer instead of TextLayerVertex if
+   TextLayer::Shared::Configuration::setCompactVertices() is enabled, converted
+   from it with compactTextLayerVerticesInto() on upload. The position is in
+   units of 1/TextLayerCompactVertexScale of the UI size, the shader derives
+   the UI size from the projection to convert it back. */
+struct TextLayerCompactVertex {
+    Vector2s position;
+    /* XY in units of 1/65535, Z is the layer */
+    Vector3us textureCoordinates;
+    Color4ub color;
+    /* 2 bytes free */
+    UnsignedInt styleUniform;
+};
+
+/* Has to match the value used in TextShader.vert */
+constexpr Float TextLayerCompactVertexScale = 16384.0f;
+
+static_assert(sizeof(TextLayerCompactVertex) == 20,
+    "expected the compact vertex to be tightly packed");
+
+inline void compactTextLayerVerticesInto(const Containers::ArrayView<const TextLayerVertex> vertices, const Containers::ArrayView<TextLayerCompactVertex> out, const Vector2& uiSize) {
+    CORRADE_INTERNAL_ASSERT(out.size() == vertices.size());
+    const Vector2 scale = TextLayerCompactVertexScale/uiSize;
+    for(std::size_t i = 0; i != vertices.size(); ++i) {
+        const TextLayerVertex& vertex = vertices[i];
+        TextLayerCompactVertex& compact = out[i];
+        compact.position = Vector2s{Math::round(Math::clamp(vertex.position*scale, -32768.0f, 32767.0f))};
+        compact.textureCoordinates = {
+            Math::pack<Vector2us>(Math::clamp(vertex.textureCoordinates.xy(), 0.0f, 1.0f)),
+            UnsignedShort(vertex.textureCoordinates.z())
+        };
+        compact.color = Math::pack<Color4ub>(Math::clamp(vertex.color, 0.0f, 1.0f));
+        compact.styleUniform = vertex.styleUniform;
+    }
+}
+
+/* Used instead of TextLayerVertex if TextLayer::Shared::Configuration::
+   setInstancedGlyphs() is enabled. The position is the glyph origin relative
+   to the UI, already aligned and Y-flipped. The renderer then takes glyph
+   offset, rectangle and layer from the glyph cache based on the ID and
+   scales them with `scale`. */
+struct TextLayerGlyphInstance {
+    Vector2 position;
+    Float scale;
+    UnsignedInt glyphId;
+    /* Already multiplied with the node opacity */
+    Color4ub color;
+    UnsignedInt styleUniform;
+};
+
+/* Count of data whose vertices are generated by a single task if
+   TextLayer::setVertexExecutor() is set. Smaller amounts of data aren't worth
+   the executor overhead and are generated directly. */
+constexpr std::size_t TextLayerVertexTaskDataCount = 256;
+
+/* Count of glyphs in a chunk that's compared and copied as a whole when
+   updating vertex or instance data of a single text. For very long texts where
+   only a part changes, such as when appending to a log, only the changed
+   chunks are then copied and included in the updated range. */
+constexpr UnsignedInt TextLayerGlyphChunkSize = 1024;
+
+/* Range of data to generate vertices for in a single task, their first
+   instance if instanced glyphs are enabled, scratch memory and the range of
+   vertices or instances that changed. Each glyph run is generated into
+   `vertexScratch` or `glyphInstanceScratch` first and copied to the layer
+   vertices only if it differs. */
+struct TextLayerVertexTask {
+    std::size_t dataBegin, dataEnd;
+    UnsignedInt instanceOffset;
+    UnsignedInt vertexUpdateBegin, vertexUpdateEnd;
+    Containers::Array<TextLayerVertex> vertexScratch;
+    Containers::Array<TextLayerGlyphInstance> glyphInstanceScratch;
+};
+
 struct TextLayerEditingVertex {
     Vector2 position;
     Vector2 centerDistance;
@@ -292,6 +581,13 @@ struct TextLayer::State: AbstractVisualLayer::State {
        (editing) part */
     bool dynamicStyleChanged = false;
     bool dynamicEditingStyleChanged = false;
+    /* Range of dynamic style IDs that changed since the last upload, used by
+       TextLayerGL to upload just the changed part of the dynamic style and
+       dynamic editing style uniforms including the selection text uniforms
+       associated with them. If empty while any of the above is set, the whole
+       range is uploaded. */
+    UnsignedInt dynamicStyleChangedBegin = ~UnsignedInt{},
+        dynamicStyleChangedEnd = 0;
 
     /* Glyph / text data. Only the items referenced from `glyphRuns` /
        `textRuns` are valid, the rest is unused space that gets recompacted
@@ -308,15 +604,74 @@ struct TextLayer::State: AbstractVisualLayer::State {
     Containers::Array<Implementation::TextLayerGlyphRun> glyphRuns;
     Containers::Array<Implementation::TextLayerTextRun> textRuns;
 
+    /* With glyph run reuse enabled, indices of unused glyph runs for each
+       power-of-two capacity, and a total capacity of all of them. Cleared
+       on each recompaction in doUpdate(), which then happens only once the
+       unused capacity is over half of `glyphData`. */
+    Containers::Array<UnsignedInt> freeGlyphRuns[32];
+    std::size_t freeGlyphCount = 0;
+
+    /* Glyph runs that had TextLayerGlyphRun::pendingGlyphIdFont set when
+       shaped, to be processed in the next doUpdate(). Can contain duplicates
+       and runs that were since removed or reshaped without missing glyphs,
+       those are skipped. */
+    Containers::Array<UnsignedInt> glyphRunsWithPendingGlyphIds;
+
     /* Data for each text. Index to `glyphRus` and optionally `textRuns` above,
        a style index and other properties. */
     Containers::Array<Implementation::TextLayerData> data;
 
+    /* Texts with TextDataFlag::DeferredShaping waiting for the next
+       doUpdate(), together with their strings and features. Emptied in each
+       doUpdate(). */
+    Containers::Array<Implementation::TextLayerDeferredShape> deferredShapes;
+    /* Editable texts modified by text input events with
+       TextLayer::Shared::Configuration::setTextInputBatching() enabled that
+       weren't reshaped yet. Entries set to ~UnsignedInt{} got reshaped or
+       removed by other means in the meantime. Usually there's just one, the
+       text of the focused node, so the membership check is a linear
+       search. Emptied in each doUpdate(). */
+    Containers::Array<UnsignedInt> pendingEditShapes;
+    Containers::Array<char> deferredShapeTextData;
+    Containers::Array<Text::FeatureRange> deferredShapeFeatures;
+
+    /* Sources of texts with TextDataFlag::Hibernatable, together with their
+       strings and features. Unused sources are removed during recompaction in
+       doUpdate(). */
+    Containers::Array<Implementation::TextLayerHibernationSource> hibernationSources;
+    Containers::Array<char> hibernationSourceTextData;
+    Containers::Array<Text::FeatureRange> hibernationSourceFeatures;
+    /* Count of sources that have `hibernated` set, to not have to go through
+       all visible data in doUpdate() if there are none */
+    UnsignedInt hibernatedCount = 0;
+    /* Shaper instances used by the shape executor tasks, kept between
+       updates to not have to create them every time */
+    Containers::Array<Containers::Pointer<Text::AbstractShaper>> deferredShapers;
+    void(*shapeExecutor)(UnsignedInt, void(*)(void*, UnsignedInt), void*, void*){};
+    void* shapeExecutorUserData{};
+    /* Max count of deferred texts shaped in a single doUpdate(), 0 means
+       no limit */
+    UnsignedInt deferredShapeBudget = 0;
+
     /* Vertex data, ultimately built from `glyphData` combined with color and
        style index from `data`; vertex data for cursor and selection
        rectangles */
     Containers::Array<Implementation::TextLayerVertex> vertices;
     Containers::Array<Implementation::TextLayerEditingVertex> editingVertices;
+    /* Range of `vertices` that changed in doUpdate() calls since it was last
+       reset, extended to the whole array if its size changed. Meant to be
+       reset by the renderer once the range is uploaded, an empty range is
+       marked by begin being larger than end. Merged from `vertexTasks`,
+       which there's just one of if no vertex executor is set. */
+    UnsignedInt vertexUpdateBegin = ~UnsignedInt{};
+    UnsignedInt vertexUpdateEnd = 0;
+    Containers::Array<Implementation::TextLayerVertexTask> vertexTasks;
+    void(*vertexExecutor)(UnsignedInt, void(*)(void*, UnsignedInt), void*, void*){};
+    void* vertexExecutorUserData{};
+    /* Used instead of the above if instanced glyphs are enabled. One instance
+       for each drawn glyph in draw order instead of four vertices for each
+       glyph in glyph data order, the update range is then in instances. */
+    Containers::Array<Implementation::TextLayerGlyphInstance> glyphInstances;
 
     /* Index data, used to draw from `vertices` and `editingVertices`. In draw
        order, the `indexDrawOffsets` then point into `indices` /
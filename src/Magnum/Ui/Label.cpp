@@ -26,6 +26,7 @@
 
 #include "Label.h"
 
+#include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Containers/StringView.h>
 #include <Corrade/Utility/Assert.h>
 #include <Magnum/Math/Vector2.h>
@@ -174,4 +175,154 @@ Anchor label(const Anchor& anchor, const Icon icon, const LabelStyle style) {
     return anchor;
 }
 
+void labels(UserInterface& ui, const NodeHandle parent, const Containers::StridedArrayView1D<const Vector2>& offsets, const Containers::StridedArrayView1D<const Vector2>& sizes, const Containers::StridedArrayView1D<const Icon>& icons, const Containers::StridedArrayView1D<const Containers::StringView>& texts, const Containers::StridedArrayView1D<const LabelStyle>& styles, const Containers::StridedArrayView1D<NodeHandle>& nodes) {
+    const std::size_t count = offsets.size();
+    CORRADE_ASSERT(sizes.size() == count && styles.size() == count && nodes.size() == count,
+        "Ui::labels(): expected offset, size, style and node views to have the same size but got" << count << Debug::nospace << "," << sizes.size() << Debug::nospace << "," << styles.size() << "and" << nodes.size(), );
+    CORRADE_ASSERT((icons.isEmpty() || icons.size() == count) && (texts.isEmpty() || texts.size() == count),
+        "Ui::labels(): expected icon and text views to be either empty or have a size of" << count << "but got" << icons.size() << "and" << texts.size(), );
+
+    ui.createNodes(parent, offsets, sizes, {}, nodes);
+
+    /* Grow the layer storage just once. It's conservative as some labels
+       may be empty and some data may get taken from the free list, but
+       that's fine as it's just capacity. */
+    TextLayer& textLayer = ui.textLayer();
+    textLayer.reserve(textLayer.usedCount() + count);
+
+    for(std::size_t i = 0; i != count; ++i) {
+        const Icon icon = icons.isEmpty() ? Icon::None : icons[i];
+        if(icon != Icon::None)
+            textLayer.createGlyph(textLayerStyleIcon(styles[i]), icon, {}, nodes[i]);
+        else if(!texts.isEmpty() && texts[i])
+            textLayer.create(textLayerStyleText(styles[i]), texts[i], TextProperties{}, nodes[i]);
+    }
+}
+
+
+LabelPool::LabelPool(UserInterface& ui, const NodeHandle parent, const Containers::StridedArrayView1D<const Vector2>& offsets, const Containers::StridedArrayView1D<const Vector2>& sizes, const Containers::StridedArrayView1D<const Containers::StringView>& texts, const TextProperties& textProperties, const LabelStyle style): _ui{ui} {
+    const std::size_t count = offsets.size();
+    CORRADE_ASSERT(sizes.size() == count && texts.size() == count,
+        "Ui::LabelPool: expected offset, size and text views to have the same size but got" << count << Debug::nospace << "," << sizes.size() << "and" << texts.size(), );
+
+    _nodes = Containers::Array<NodeHandle>{NoInit, count};
+    _data = Containers::Array<LayerDataHandle>{ValueInit, count};
+    _styles = Containers::Array<LabelStyle>{DirectInit, count, style};
+
+    ui.createNodes(parent, offsets, sizes, {}, _nodes);
+
+    /* Grow the layer storage just once, same as in labels() */
+    TextLayer& textLayer = ui.textLayer();
+    textLayer.reserve(textLayer.usedCount() + count);
+
+    const TextStyle textStyle = textLayerStyleText(style);
+    for(std::size_t i = 0; i != count; ++i) if(texts[i])
+        _data[i] = dataHandleData(textLayer.create(textStyle, texts[i], textProperties, _nodes[i]));
+}
+
+LabelPool::LabelPool(UserInterface& ui, const NodeHandle parent, const Containers::StridedArrayView1D<const Vector2>& offsets, const Containers::StridedArrayView1D<const Vector2>& sizes, const Containers::StridedArrayView1D<const Containers::StringView>& texts, const LabelStyle style): LabelPool{ui, parent, offsets, sizes, texts, {}, style} {}
+
+LabelPool::LabelPool(NoCreateT, UserInterface& ui) noexcept: _ui{ui} {}
+
+LabelPool::LabelPool(LabelPool&& other) noexcept: _ui{other._ui}, _nodes{Utility::move(other._nodes)}, _data{Utility::move(other._data)}, _styles{Utility::move(other._styles)} {}
+
+LabelPool::~LabelPool() {
+    /* Removing the nodes implicitly removes the attached text data as well */
+    if(!_nodes.isEmpty())
+        _ui->removeNodes(_nodes);
+}
+
+LabelPool& LabelPool::operator=(LabelPool&& other) noexcept {
+    Utility::swap(other._ui, _ui);
+    Utility::swap(other._nodes, _nodes);
+    Utility::swap(other._data, _data);
+    Utility::swap(other._styles, _styles);
+    return *this;
+}
+
+LabelPool& LabelPool::setStyle(const std::size_t id, const LabelStyle style) {
+    CORRADE_ASSERT(id < _nodes.size(),
+        "Ui::LabelPool::setStyle(): index" << id << "out of range for" << _nodes.size() << "labels", *this);
+    _styles[id] = style;
+    if(_data[id] != LayerDataHandle::Null)
+        _ui->textLayer().setStyle(_data[id], textLayerStyleText(style));
+    return *this;
+}
+
+LabelPool& LabelPool::setStyles(const LabelStyle style) {
+    TextLayer& textLayer = _ui->textLayer();
+    const TextStyle textStyle = textLayerStyleText(style);
+    for(std::size_t i = 0; i != _nodes.size(); ++i) {
+        _styles[i] = style;
+        if(_data[i] != LayerDataHandle::Null)
+            textLayer.setStyle(_data[i], textStyle);
+    }
+    return *this;
+}
+
+LabelPool& LabelPool::setStyles(const Containers::StridedArrayView1D<const LabelStyle>& styles) {
+    CORRADE_ASSERT(styles.size() == _nodes.size(),
+        "Ui::LabelPool::setStyles(): expected" << _nodes.size() << "styles but got" << styles.size(), *this);
+    TextLayer& textLayer = _ui->textLayer();
+    for(std::size_t i = 0; i != _nodes.size(); ++i) {
+        _styles[i] = styles[i];
+        if(_data[i] != LayerDataHandle::Null)
+            textLayer.setStyle(_data[i], textLayerStyleText(styles[i]));
+    }
+    return *this;
+}
+
+LabelPool& LabelPool::setText(const std::size_t id, const Containers::StringView text, const TextProperties& textProperties) {
+    CORRADE_ASSERT(id < _nodes.size(),
+        "Ui::LabelPool::setText(): index" << id << "out of range for" << _nodes.size() << "labels", *this);
+    TextLayer& textLayer = _ui->textLayer();
+
+    if(text) {
+        if(_data[id] == LayerDataHandle::Null)
+            _data[id] = dataHandleData(textLayer.create(textLayerStyleText(_styles[id]), text, textProperties, _nodes[id]));
+        else
+            textLayer.setText(_data[id], text, textProperties);
+    } else if(_data[id] != LayerDataHandle::Null) {
+        textLayer.remove(_data[id]);
+        _data[id] = LayerDataHandle::Null;
+    }
+
+    return *this;
+}
+
+LabelPool& LabelPool::setText(const std::size_t id, const Containers::StringView text) {
+    return setText(id, text, {});
+}
+
+LabelPool& LabelPool::setTexts(const Containers::StridedArrayView1D<const Containers::StringView>& texts, const TextProperties& textProperties) {
+    CORRADE_ASSERT(texts.size() == _nodes.size(),
+        "Ui::LabelPool::setTexts(): expected" << _nodes.size() << "texts but got" << texts.size(), *this);
+    TextLayer& textLayer = _ui->textLayer();
+
+    /* Grow the layer storage just once for all labels that are currently
+       empty and will get a text */
+    std::size_t created = 0;
+    for(std::size_t i = 0; i != _nodes.size(); ++i)
+        if(texts[i] && _data[i] == LayerDataHandle::Null) ++created;
+    if(created)
+        textLayer.reserve(textLayer.usedCount() + created);
+
+    for(std::size_t i = 0; i != _nodes.size(); ++i)
+        setText(i, texts[i], textProperties);
+
+    return *this;
+}
+
+LabelPool& LabelPool::setTexts(const Containers::StridedArrayView1D<const Containers::StringView>& texts) {
+    return setTexts(texts, {});
+}
+
+DataHandle LabelPool::data(const std::size_t id) const {
+    CORRADE_ASSERT(id < _nodes.size(),
+        "Ui::LabelPool::data(): index" << id << "out of range for" << _nodes.size() << "labels", {});
+    /* The data is implicitly from the text layer */
+    return _data[id] == LayerDataHandle::Null ? DataHandle::Null :
+        dataHandle(_ui->textLayer().handle(), _data[id]);
+}
+
 }}
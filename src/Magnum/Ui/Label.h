@@ -27,10 +27,12 @@
 */
 
 /** @file
- * @brief Class @ref Magnum::Ui::Label, function @ref Magnum::Ui::label(), enum @ref Magnum::Ui::LabelStyle
+ * @brief Class @ref Magnum::Ui::Label, @ref Magnum::Ui::LabelPool, function @ref Magnum::Ui::label(), @ref Magnum::Ui::labels(), enum @ref Magnum::Ui::LabelStyle
  * @m_since_latest
  */
 
+#include <Corrade/Containers/Array.h>
+
 #include "Magnum/Ui/Widget.h"
 
 namespace Magnum { namespace Ui {
@@ -204,6 +206,195 @@ MAGNUM_UI_EXPORT Anchor label(const Anchor& anchor, Containers::StringView text,
 /** @overload */
 MAGNUM_UI_EXPORT Anchor label(const Anchor& anchor, Containers::StringView text, LabelStyle style = LabelStyle::Default);
 
+/**
+@brief Create multiple stateless labels
+@param[in] ui       User interface to create the labels in
+@param[in] parent   Parent node to attach to or @ref NodeHandle::Null for
+    top-level labels. Expected to be valid if not null.
+@param[in] offsets  Label offsets relative to the parent node
+@param[in] sizes    Label sizes
+@param[in] icons    Label icons. If empty or if the item is @ref Icon::None,
+    a text label is created from @p texts instead.
+@param[in] texts    Label texts. If empty, or if the item is an empty string
+    and there's no icon, given label is empty. Items for which @p icons
+    isn't @ref Icon::None are ignored.
+@param[in] styles   Label styles
+@param[out] nodes   Where to put created label node handles
+@m_since_latest
+
+Equivalent to calling @ref label(const Anchor&, Icon, LabelStyle) or
+@ref label(const Anchor&, Containers::StringView, LabelStyle) with a
+custom-positioned anchor for each item, but with the node storage and the text
+layer storage grown just once and the node state updated just once for all
+labels. See @ref buttons() for more information. Expects that the
+@p offsets, @p sizes, @p styles and @p nodes views all have the same size and
+the @p icons and @p texts views are either empty or have the same size as
+well.
+*/
+MAGNUM_UI_EXPORT void labels(UserInterface& ui, NodeHandle parent, const Containers::StridedArrayView1D<const Vector2>& offsets, const Containers::StridedArrayView1D<const Vector2>& sizes, const Containers::StridedArrayView1D<const Icon>& icons, const Containers::StridedArrayView1D<const Containers::StringView>& texts, const Containers::StridedArrayView1D<const LabelStyle>& styles, const Containers::StridedArrayView1D<NodeHandle>& nodes);
+
+
+/**
+@brief Pool of text labels
+@m_since_latest
+
+Manages a batch of text labels that are created, restyled, retexted and
+removed together. Compared to having an array of @ref Label instances, the
+node handles, text layer data handles and styles are stored in separate
+contiguous arrays instead of being interleaved in per-widget instances, the
+nodes are created with a single @ref AbstractUserInterface::createNodes() call
+and removed with a single @ref AbstractUserInterface::removeNodes() call, and
+the text layer storage is grown just once on construction. Useful for example
+for large lists or tables where all items share the same kind of content.
+
+Individual labels are addressed by their index in the pool, which matches the
+order of the views passed to the constructor.
+@see @ref labels()
+*/
+class MAGNUM_UI_EXPORT LabelPool {
+    public:
+        /**
+         * @brief Constructor
+         * @param ui                User interface to create the labels in
+         * @param parent            Parent node to attach to or
+         *      @ref NodeHandle::Null for top-level labels. Expected to be
+         *      valid if not null.
+         * @param offsets           Label offsets relative to the parent node
+         * @param sizes             Label sizes
+         * @param texts             Label texts. Items that are empty strings
+         *      make given label empty.
+         * @param textProperties    Text shaping and layouting properties
+         * @param style             Style used for all labels
+         *
+         * Expects that the @p offsets, @p sizes and @p texts views all have
+         * the same size.
+         */
+        #ifdef DOXYGEN_GENERATING_OUTPUT
+        explicit LabelPool(UserInterface& ui, NodeHandle parent, const Containers::StridedArrayView1D<const Vector2>& offsets, const Containers::StridedArrayView1D<const Vector2>& sizes, const Containers::StridedArrayView1D<const Containers::StringView>& texts, const TextProperties& textProperties = {}, LabelStyle style = LabelStyle::Default);
+        #else
+        /* To avoid having to include TextProperties.h */
+        explicit LabelPool(UserInterface& ui, NodeHandle parent, const Containers::StridedArrayView1D<const Vector2>& offsets, const Containers::StridedArrayView1D<const Vector2>& sizes, const Containers::StridedArrayView1D<const Containers::StringView>& texts, const TextProperties& textProperties, LabelStyle style = LabelStyle::Default);
+        explicit LabelPool(UserInterface& ui, NodeHandle parent, const Containers::StridedArrayView1D<const Vector2>& offsets, const Containers::StridedArrayView1D<const Vector2>& sizes, const Containers::StridedArrayView1D<const Containers::StringView>& texts, LabelStyle style = LabelStyle::Default);
+        #endif
+
+        /**
+         * @brief Construct with no underlying nodes
+         *
+         * The instance is equivalent to a moved-out state, i.e. having a
+         * zero @ref size(). Move another instance over it to make it useful.
+         */
+        explicit LabelPool(NoCreateT, UserInterface& ui) noexcept;
+
+        /** @brief Copying is not allowed */
+        LabelPool(const LabelPool&) = delete;
+
+        /**
+         * @brief Move constructor
+         *
+         * Performs a destructive move, i.e. the original instance is left
+         * with a zero @ref size().
+         */
+        LabelPool(LabelPool&& other) noexcept;
+
+        /**
+         * @brief Destructor
+         *
+         * Removes all label nodes with
+         * @ref AbstractUserInterface::removeNodes(). Expects that the nodes
+         * weren't removed by other means, such as by removing their parent,
+         * before.
+         */
+        ~LabelPool();
+
+        /** @brief Copying is not allowed */
+        LabelPool& operator=(const LabelPool&) = delete;
+
+        /** @brief Move assignment */
+        LabelPool& operator=(LabelPool&& other) noexcept;
+
+        /** @brief User interface instance */
+        UserInterface& ui() const { return *_ui; }
+
+        /** @brief Count of labels in the pool */
+        std::size_t size() const { return _nodes.size(); }
+
+        /** @brief Label node handles */
+        Containers::ArrayView<const NodeHandle> nodes() const { return _nodes; }
+
+        /** @brief Label styles */
+        Containers::ArrayView<const LabelStyle> styles() const { return _styles; }
+
+        /**
+         * @brief Set style of a label
+         * @return Reference to self (for method chaining)
+         *
+         * Expects that @p id is less than @ref size(). Like with
+         * @ref Label::setStyle(), calling this function doesn't change the
+         * font if the new style uses a different one, you have to call
+         * @ref setText() afterwards to make it pick it up.
+         */
+        LabelPool& setStyle(std::size_t id, LabelStyle style);
+
+        /**
+         * @brief Set style of all labels
+         * @return Reference to self (for method chaining)
+         */
+        LabelPool& setStyles(LabelStyle style);
+
+        /**
+         * @brief Set styles of all labels
+         * @return Reference to self (for method chaining)
+         *
+         * Expects that the @p styles view has the same size as @ref size().
+         */
+        LabelPool& setStyles(const Containers::StridedArrayView1D<const LabelStyle>& styles);
+
+        /**
+         * @brief Set text of a label
+         * @return Reference to self (for method chaining)
+         *
+         * Expects that @p id is less than @ref size(). Passing an empty
+         * @p text makes the label empty.
+         */
+        #ifdef DOXYGEN_GENERATING_OUTPUT
+        LabelPool& setText(std::size_t id, Containers::StringView text, const TextProperties& textProperties = {});
+        #else
+        /* To avoid having to include TextProperties.h */
+        LabelPool& setText(std::size_t id, Containers::StringView text, const TextProperties& textProperties);
+        LabelPool& setText(std::size_t id, Containers::StringView text);
+        #endif
+
+        /**
+         * @brief Set texts of all labels
+         * @return Reference to self (for method chaining)
+         *
+         * Expects that the @p texts view has the same size as @ref size().
+         * Items that are empty strings make given label empty. The text
+         * layer storage is grown just once for all newly non-empty labels.
+         */
+        #ifdef DOXYGEN_GENERATING_OUTPUT
+        LabelPool& setTexts(const Containers::StridedArrayView1D<const Containers::StringView>& texts, const TextProperties& textProperties = {});
+        #else
+        /* To avoid having to include TextProperties.h */
+        LabelPool& setTexts(const Containers::StridedArrayView1D<const Containers::StringView>& texts, const TextProperties& textProperties);
+        LabelPool& setTexts(const Containers::StridedArrayView1D<const Containers::StringView>& texts);
+        #endif
+
+        /**
+         * @brief Text data of a label or @ref DataHandle::Null
+         *
+         * Expects that @p id is less than @ref size(). Exposed mainly for
+         * testing purposes, not meant to be modified directly.
+         */
+        DataHandle data(std::size_t id) const;
+
+    private:
+        Containers::Reference<UserInterface> _ui;
+        Containers::Array<NodeHandle> _nodes;
+        Containers::Array<LayerDataHandle> _data;
+        Containers::Array<LabelStyle> _styles;
+};
+
 }}
 
 #endif
@@ -0,0 +1,80 @@
+#ifndef Magnum_Ui_MemoryUsage_h
+#define Magnum_Ui_MemoryUsage_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+/** @file
+ * @brief Struct @ref Magnum::Ui::MemoryUsage
+ * @m_since_latest
+ */
+
+#include <cstddef>
+
+#include "Magnum/Ui/Ui.h"
+
+namespace Magnum { namespace Ui {
+
+/**
+@brief Memory usage
+@m_since_latest
+
+Returned from @ref AbstractUserInterface::memoryUsage(),
+@ref AbstractLayer::memoryUsage(), @ref AbstractLayouter::memoryUsage() and
+@ref AbstractAnimator::memoryUsage(). The byte counts include allocated
+capacity of growable arrays, not just the part that's currently used, but
+don't include the fixed-size instance state or any general-purpose allocator
+overhead. GPU byte counts are sizes of buffers and textures the instance
+allocated, they don't include any driver-internal overhead or memory shared
+among multiple instances such as glyph caches.
+*/
+struct MemoryUsage {
+    /** @brief Count of bytes allocated in CPU memory */
+    std::size_t cpuByteCount = 0;
+
+    /** @brief Count of bytes allocated in GPU memory */
+    std::size_t gpuByteCount = 0;
+
+    /**
+     * @brief Capacity of the item storage
+     *
+     * Count of nodes, data, layouts or animations the storage has space for,
+     * depending on where the value comes from.
+     */
+    std::size_t capacity = 0;
+
+    /**
+     * @brief Count of used items in the storage
+     *
+     * Always at most @ref capacity. A large difference between the two on a
+     * long-running application may indicate handles getting created and
+     * removed in bulk, or handles not being removed at all if the count
+     * grows.
+     */
+    std::size_t usedCount = 0;
+};
+
+}}
+
+#endif
@@ -0,0 +1,217 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "NodeAnimator.h"
+
+#include <Corrade/Containers/BitArrayView.h>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Time.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "Magnum/Ui/Handle.h"
+
+namespace Magnum { namespace Ui {
+
+namespace {
+
+/* Shared by NodeOffsetAnimator and NodeSizeAnimator. The values are in
+   separate contiguous arrays instead of an array of structs in order to have
+   doAdvance() touch only what it needs. */
+struct NodeVector2AnimatorState {
+    Containers::Array<Vector2> from;
+    Containers::Array<Vector2> to;
+    Containers::Array<Float(*)(Float)> easings;
+};
+
+void reserveInternal(NodeVector2AnimatorState& state, const std::size_t capacity) {
+    arrayReserve(state.from, capacity);
+    arrayReserve(state.to, capacity);
+    arrayReserve(state.easings, capacity);
+}
+
+void createInternal(NodeVector2AnimatorState& state, const UnsignedInt id, const Vector2& from, const Vector2& to, Float(*const easing)(Float)) {
+    if(id >= state.from.size()) {
+        arrayResize(state.from, NoInit, id + 1);
+        arrayResize(state.to, NoInit, id + 1);
+        arrayResize(state.easings, NoInit, id + 1);
+    }
+
+    state.from[id] = from;
+    state.to[id] = to;
+    state.easings[id] = easing;
+}
+
+/* Returns true if any node was animated */
+bool advanceInternal(const NodeVector2AnimatorState& state, const Containers::StridedArrayView1D<const NodeHandle>& nodes, const Containers::BitArrayView active, const Containers::StridedArrayView1D<const Float>& factors, const Containers::StridedArrayView1D<Vector2>& nodeValues) {
+    bool animated = false;
+    /** @todo some way to iterate set bits */
+    for(std::size_t i = 0; i != active.size(); ++i) {
+        if(!active[i])
+            continue;
+
+        const NodeHandle node = nodes[i];
+        if(node == NodeHandle::Null)
+            continue;
+
+        nodeValues[nodeHandleId(node)] = Math::lerp(state.from[i], state.to[i], state.easings[i](factors[i]));
+        animated = true;
+    }
+
+    return animated;
+}
+
+}
+
+struct NodeOffsetAnimator::State: NodeVector2AnimatorState {};
+
+NodeOffsetAnimator::NodeOffsetAnimator(AnimatorHandle handle): AbstractNodeAnimator{handle}, _state{InPlaceInit} {}
+
+NodeOffsetAnimator::NodeOffsetAnimator(NodeOffsetAnimator&&) noexcept = default;
+
+NodeOffsetAnimator::~NodeOffsetAnimator() = default;
+
+NodeOffsetAnimator& NodeOffsetAnimator::operator=(NodeOffsetAnimator&&) noexcept = default;
+
+AnimationHandle NodeOffsetAnimator::create(const Vector2& from, const Vector2& to, Float(*const easing)(Float), const Nanoseconds played, const Nanoseconds duration, const NodeHandle node, const UnsignedInt repeatCount, const AnimationFlags flags) {
+    CORRADE_ASSERT(easing,
+        "Ui::NodeOffsetAnimator::create(): easing is null", {});
+
+    const AnimationHandle handle = AbstractNodeAnimator::create(played, duration, node, repeatCount, flags);
+    createInternal(*_state, animationHandleId(handle), from, to, easing);
+    return handle;
+}
+
+void NodeOffsetAnimator::remove(AnimationHandle handle) {
+    /* The data are trivial, nothing to clean up on our side */
+    AbstractNodeAnimator::remove(handle);
+}
+
+void NodeOffsetAnimator::remove(AnimatorDataHandle handle) {
+    AbstractNodeAnimator::remove(handle);
+}
+
+Containers::Pair<Vector2, Vector2> NodeOffsetAnimator::offsets(const AnimationHandle handle) const {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::NodeOffsetAnimator::offsets(): invalid handle" << handle, {});
+    const UnsignedInt id = animationHandleId(handle);
+    return {_state->from[id], _state->to[id]};
+}
+
+Containers::Pair<Vector2, Vector2> NodeOffsetAnimator::offsets(const AnimatorDataHandle handle) const {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::NodeOffsetAnimator::offsets(): invalid handle" << handle, {});
+    const UnsignedInt id = animatorDataHandleId(handle);
+    return {_state->from[id], _state->to[id]};
+}
+
+auto NodeOffsetAnimator::easing(const AnimationHandle handle) const -> Float(*)(Float) {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::NodeOffsetAnimator::easing(): invalid handle" << handle, {});
+    return _state->easings[animationHandleId(handle)];
+}
+
+auto NodeOffsetAnimator::easing(const AnimatorDataHandle handle) const -> Float(*)(Float) {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::NodeOffsetAnimator::easing(): invalid handle" << handle, {});
+    return _state->easings[animatorDataHandleId(handle)];
+}
+
+void NodeOffsetAnimator::doReserve(const std::size_t capacity) {
+    reserveInternal(*_state, capacity);
+}
+
+NodeAnimations NodeOffsetAnimator::doAdvance(const Containers::BitArrayView active, const Containers::StridedArrayView1D<const Float>& factors, const Containers::StridedArrayView1D<Vector2>& nodeOffsets, const Containers::StridedArrayView1D<Vector2>&, const Containers::StridedArrayView1D<NodeFlags>&, Containers::MutableBitArrayView) {
+    return advanceInternal(*_state, nodes(), active, factors, nodeOffsets) ?
+        NodeAnimation::OffsetSize : NodeAnimations{};
+}
+
+struct NodeSizeAnimator::State: NodeVector2AnimatorState {};
+
+NodeSizeAnimator::NodeSizeAnimator(AnimatorHandle handle): AbstractNodeAnimator{handle}, _state{InPlaceInit} {}
+
+NodeSizeAnimator::NodeSizeAnimator(NodeSizeAnimator&&) noexcept = default;
+
+NodeSizeAnimator::~NodeSizeAnimator() = default;
+
+NodeSizeAnimator& NodeSizeAnimator::operator=(NodeSizeAnimator&&) noexcept = default;
+
+AnimationHandle NodeSizeAnimator::create(const Vector2& from, const Vector2& to, Float(*const easing)(Float), const Nanoseconds played, const Nanoseconds duration, const NodeHandle node, const UnsignedInt repeatCount, const AnimationFlags flags) {
+    CORRADE_ASSERT(easing,
+        "Ui::NodeSizeAnimator::create(): easing is null", {});
+
+    const AnimationHandle handle = AbstractNodeAnimator::create(played, duration, node, repeatCount, flags);
+    createInternal(*_state, animationHandleId(handle), from, to, easing);
+    return handle;
+}
+
+void NodeSizeAnimator::remove(AnimationHandle handle) {
+    /* The data are trivial, nothing to clean up on our side */
+    AbstractNodeAnimator::remove(handle);
+}
+
+void NodeSizeAnimator::remove(AnimatorDataHandle handle) {
+    AbstractNodeAnimator::remove(handle);
+}
+
+Containers::Pair<Vector2, Vector2> NodeSizeAnimator::sizes(const AnimationHandle handle) const {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::NodeSizeAnimator::sizes(): invalid handle" << handle, {});
+    const UnsignedInt id = animationHandleId(handle);
+    return {_state->from[id], _state->to[id]};
+}
+
+Containers::Pair<Vector2, Vector2> NodeSizeAnimator::sizes(const AnimatorDataHandle handle) const {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::NodeSizeAnimator::sizes(): invalid handle" << handle, {});
+    const UnsignedInt id = animatorDataHandleId(handle);
+    return {_state->from[id], _state->to[id]};
+}
+
+auto NodeSizeAnimator::easing(const AnimationHandle handle) const -> Float(*)(Float) {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::NodeSizeAnimator::easing(): invalid handle" << handle, {});
+    return _state->easings[animationHandleId(handle)];
+}
+
+auto NodeSizeAnimator::easing(const AnimatorDataHandle handle) const -> Float(*)(Float) {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::NodeSizeAnimator::easing(): invalid handle" << handle, {});
+    return _state->easings[animatorDataHandleId(handle)];
+}
+
+void NodeSizeAnimator::doReserve(const std::size_t capacity) {
+    reserveInternal(*_state, capacity);
+}
+
+NodeAnimations NodeSizeAnimator::doAdvance(const Containers::BitArrayView active, const Containers::StridedArrayView1D<const Float>& factors, const Containers::StridedArrayView1D<Vector2>&, const Containers::StridedArrayView1D<Vector2>& nodeSizes, const Containers::StridedArrayView1D<NodeFlags>&, Containers::MutableBitArrayView) {
+    return advanceInternal(*_state, nodes(), active, factors, nodeSizes) ?
+        NodeAnimation::OffsetSize : NodeAnimations{};
+}
+
+}}
@@ -0,0 +1,297 @@
+#ifndef Magnum_Ui_NodeAnimator_h
+#define Magnum_Ui_NodeAnimator_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Class @ref Magnum::Ui::NodeOffsetAnimator, @ref Magnum::Ui::NodeSizeAnimator
+ * @m_since_latest
+ */
+
+#include "Magnum/Ui/AbstractAnimator.h"
+
+namespace Magnum { namespace Ui {
+
+/**
+@brief Node offset animator
+@m_since_latest
+
+Interpolates node offsets between two values. Compared to doing the same with
+a @ref GenericNodeAnimator, the source and target values and easing functions
+are stored in contiguous arrays and all animations are evaluated in a single
+loop without any type-erased function call per animation, making it suitable
+for animating many nodes at once.
+
+@section Ui-NodeOffsetAnimator-setup Setting up an animator instance
+
+The animator doesn't have any shared state or configuration, so it's just
+about constructing it from a fresh @ref AbstractUserInterface::createAnimator()
+handle and passing it to @relativeref{AbstractUserInterface,setNodeAnimatorInstance()}.
+
+@code{.cpp}
+Ui::NodeOffsetAnimator& animator = ui.setNodeAnimatorInstance(
+    Containers::pointer<Ui::NodeOffsetAnimator>(ui.createAnimator()));
+@endcode
+
+@section Ui-NodeOffsetAnimator-create Creating animations
+
+An animation is created by calling @ref create() with the source and target
+offset, an easing function from @ref Animation::BasicEasing "Animation::Easing"
+or a custom one, time at which it's meant to be played, its duration and the
+node to animate. Once the animation is stopped, the node has exactly the
+target offset, assuming the easing function maps @cpp 1.0f @ce to itself.
+
+@code{.cpp}
+animator.create({-100.0f, 0.0f}, {0.0f, 0.0f}, Animation::Easing::cubicOut,
+    now, 0.5_sec, node);
+@endcode
+
+As with all other animations, they're implicitly removed once they're played,
+and also when the node they're attached to is removed. Animations that are
+attached to a null node don't do anything.
+@see @ref NodeSizeAnimator
+*/
+class MAGNUM_UI_EXPORT NodeOffsetAnimator: public AbstractNodeAnimator {
+    public:
+        /**
+         * @brief Constructor
+         * @param handle    Handle returned by
+         *      @ref AbstractUserInterface::createAnimator()
+         */
+        explicit NodeOffsetAnimator(AnimatorHandle handle);
+
+        /** @brief Copying is not allowed */
+        NodeOffsetAnimator(const NodeOffsetAnimator&) = delete;
+
+        /** @copydoc AbstractAnimator::AbstractAnimator(AbstractAnimator&&) */
+        NodeOffsetAnimator(NodeOffsetAnimator&&) noexcept;
+
+        ~NodeOffsetAnimator();
+
+        /** @brief Copying is not allowed */
+        NodeOffsetAnimator& operator=(const NodeOffsetAnimator&) = delete;
+
+        /** @brief Move assignment */
+        NodeOffsetAnimator& operator=(NodeOffsetAnimator&&) noexcept;
+
+        /**
+         * @brief Create an animation
+         * @param from          Source offset
+         * @param to            Target offset
+         * @param easing        Easing function between @cpp 0.0f @ce and
+         *      @cpp 1.0f @ce. Pick one from
+         *      @ref Animation::BasicEasing "Animation::Easing" or supply a
+         *      custom one.
+         * @param played        Time at which the animation is played. Use
+         *      @ref Nanoseconds::max() for creating a stopped animation.
+         * @param duration      Duration of a single play of the animation
+         * @param node          Node the animation is attached to. Use
+         *      @ref NodeHandle::Null to create an animation that isn't
+         *      attached to any node.
+         * @param repeatCount   Repeat count. Use @cpp 0 @ce for an
+         *      indefinitely repeating animation.
+         * @param flags         Flags
+         *
+         * Expects that @p easing is not @cpp nullptr @ce. Delegates to
+         * @ref AbstractAnimator::create(Nanoseconds, Nanoseconds, NodeHandle, UnsignedInt, AnimationFlags),
+         * see its documentation for more information.
+         */
+        AnimationHandle create(const Vector2& from, const Vector2& to, Float(*easing)(Float), Nanoseconds played, Nanoseconds duration, NodeHandle node, UnsignedInt repeatCount = 1, AnimationFlags flags = {});
+
+        /**
+         * @brief Remove an animation
+         *
+         * Expects that @p handle is valid. Delegates to
+         * @ref AbstractAnimator::remove(AnimationHandle), see its
+         * documentation for more information.
+         */
+        void remove(AnimationHandle handle);
+
+        /**
+         * @brief Remove an animation assuming it belongs to this animator
+         *
+         * Compared to @ref remove(AnimationHandle) delegates to
+         * @ref AbstractAnimator::remove(AnimatorDataHandle) instead.
+         */
+        void remove(AnimatorDataHandle handle);
+
+        /**
+         * @brief Animation source and target offset
+         *
+         * Expects that @p handle is valid.
+         */
+        Containers::Pair<Vector2, Vector2> offsets(AnimationHandle handle) const;
+
+        /**
+         * @brief Animation source and target offset assuming it belongs to this animator
+         *
+         * Like @ref offsets(AnimationHandle) const but without checking that
+         * @p handle indeed belongs to this animator. See its documentation
+         * for more information.
+         */
+        Containers::Pair<Vector2, Vector2> offsets(AnimatorDataHandle handle) const;
+
+        /**
+         * @brief Animation easing function
+         *
+         * Expects that @p handle is valid. The returned pointer is never
+         * @cpp nullptr @ce.
+         */
+        auto easing(AnimationHandle handle) const -> Float(*)(Float);
+
+        /**
+         * @brief Animation easing function assuming it belongs to this animator
+         *
+         * Like @ref easing(AnimationHandle) const but without checking that
+         * @p handle indeed belongs to this animator. See its documentation
+         * for more information.
+         */
+        auto easing(AnimatorDataHandle handle) const -> Float(*)(Float);
+
+    private:
+        MAGNUM_UI_LOCAL void doReserve(std::size_t capacity) override;
+        MAGNUM_UI_LOCAL NodeAnimations doAdvance(Containers::BitArrayView active, const Containers::StridedArrayView1D<const Float>& factors, const Containers::StridedArrayView1D<Vector2>& nodeOffsets, const Containers::StridedArrayView1D<Vector2>& nodeSizes, const Containers::StridedArrayView1D<NodeFlags>& nodeFlags, Containers::MutableBitArrayView nodesRemove) override;
+
+        struct State;
+        Containers::Pointer<State> _state;
+};
+
+/**
+@brief Node size animator
+@m_since_latest
+
+Interpolates node sizes between two values. Apart from animating the node
+size instead of the offset, it's equivalent to @ref NodeOffsetAnimator, see
+its documentation for more information.
+*/
+class MAGNUM_UI_EXPORT NodeSizeAnimator: public AbstractNodeAnimator {
+    public:
+        /**
+         * @brief Constructor
+         * @param handle    Handle returned by
+         *      @ref AbstractUserInterface::createAnimator()
+         */
+        explicit NodeSizeAnimator(AnimatorHandle handle);
+
+        /** @brief Copying is not allowed */
+        NodeSizeAnimator(const NodeSizeAnimator&) = delete;
+
+        /** @copydoc AbstractAnimator::AbstractAnimator(AbstractAnimator&&) */
+        NodeSizeAnimator(NodeSizeAnimator&&) noexcept;
+
+        ~NodeSizeAnimator();
+
+        /** @brief Copying is not allowed */
+        NodeSizeAnimator& operator=(const NodeSizeAnimator&) = delete;
+
+        /** @brief Move assignment */
+        NodeSizeAnimator& operator=(NodeSizeAnimator&&) noexcept;
+
+        /**
+         * @brief Create an animation
+         * @param from          Source size
+         * @param to            Target size
+         * @param easing        Easing function between @cpp 0.0f @ce and
+         *      @cpp 1.0f @ce. Pick one from
+         *      @ref Animation::BasicEasing "Animation::Easing" or supply a
+         *      custom one.
+         * @param played        Time at which the animation is played. Use
+         *      @ref Nanoseconds::max() for creating a stopped animation.
+         * @param duration      Duration of a single play of the animation
+         * @param node          Node the animation is attached to. Use
+         *      @ref NodeHandle::Null to create an animation that isn't
+         *      attached to any node.
+         * @param repeatCount   Repeat count. Use @cpp 0 @ce for an
+         *      indefinitely repeating animation.
+         * @param flags         Flags
+         *
+         * Expects that @p easing is not @cpp nullptr @ce. Delegates to
+         * @ref AbstractAnimator::create(Nanoseconds, Nanoseconds, NodeHandle, UnsignedInt, AnimationFlags),
+         * see its documentation for more information.
+         */
+        AnimationHandle create(const Vector2& from, const Vector2& to, Float(*easing)(Float), Nanoseconds played, Nanoseconds duration, NodeHandle node, UnsignedInt repeatCount = 1, AnimationFlags flags = {});
+
+        /**
+         * @brief Remove an animation
+         *
+         * Expects that @p handle is valid. Delegates to
+         * @ref AbstractAnimator::remove(AnimationHandle), see its
+         * documentation for more information.
+         */
+        void remove(AnimationHandle handle);
+
+        /**
+         * @brief Remove an animation assuming it belongs to this animator
+         *
+         * Compared to @ref remove(AnimationHandle) delegates to
+         * @ref AbstractAnimator::remove(AnimatorDataHandle) instead.
+         */
+        void remove(AnimatorDataHandle handle);
+
+        /**
+         * @brief Animation source and target size
+         *
+         * Expects that @p handle is valid.
+         */
+        Containers::Pair<Vector2, Vector2> sizes(AnimationHandle handle) const;
+
+        /**
+         * @brief Animation source and target size assuming it belongs to this animator
+         *
+         * Like @ref sizes(AnimationHandle) const but without checking that
+         * @p handle indeed belongs to this animator. See its documentation
+         * for more information.
+         */
+        Containers::Pair<Vector2, Vector2> sizes(AnimatorDataHandle handle) const;
+
+        /**
+         * @brief Animation easing function
+         *
+         * Expects that @p handle is valid. The returned pointer is never
+         * @cpp nullptr @ce.
+         */
+        auto easing(AnimationHandle handle) const -> Float(*)(Float);
+
+        /**
+         * @brief Animation easing function assuming it belongs to this animator
+         *
+         * Like @ref easing(AnimationHandle) const but without checking that
+         * @p handle indeed belongs to this animator. See its documentation
+         * for more information.
+         */
+        auto easing(AnimatorDataHandle handle) const -> Float(*)(Float);
+
+    private:
+        MAGNUM_UI_LOCAL void doReserve(std::size_t capacity) override;
+        MAGNUM_UI_LOCAL NodeAnimations doAdvance(Containers::BitArrayView active, const Containers::StridedArrayView1D<const Float>& factors, const Containers::StridedArrayView1D<Vector2>& nodeOffsets, const Containers::StridedArrayView1D<Vector2>& nodeSizes, const Containers::StridedArrayView1D<NodeFlags>& nodeFlags, Containers::MutableBitArrayView nodesRemove) override;
+
+        struct State;
+        Containers::Pointer<State> _state;
+};
+
+}}
+
+#endif
@@ -41,6 +41,9 @@ Debug& operator<<(Debug& debug, const NodeFlag value) {
         _c(NoEvents)
         _c(Disabled)
         _c(Focusable)
+        _c(RawPointerMoveEvents)
+        _c(CullTransparent)
+        _c(Opaque)
         #undef _c
         /* LCOV_EXCL_STOP */
     }
@@ -55,7 +58,10 @@ Debug& operator<<(Debug& debug, const NodeFlags value) {
         NodeFlag::Disabled,
         /* Implied by Disabled, has to be after */
         NodeFlag::NoEvents,
-        NodeFlag::Focusable
+        NodeFlag::Focusable,
+        NodeFlag::RawPointerMoveEvents,
+        NodeFlag::CullTransparent,
+        NodeFlag::Opaque
     });
 }
 
@@ -119,6 +119,45 @@ enum class NodeFlag: UnsignedByte {
      * @ref UserInterfaceState::NeedsNodeEnabledUpdate to be set.
      */
     Focusable = 1 << 4,
+
+    /**
+     * Pointer move events happening on the node are dispatched immediately
+     * even if @ref AbstractUserInterface::setPointerMoveEventCoalescingEnabled()
+     * is enabled. Meant to be used for example for drawing canvases that need
+     * every intermediate position. Only the flag on the currently captured
+     * node or, if no node is captured, the currently hovered node is
+     * considered, parent nodes have no effect.
+     * @m_since_latest
+     */
+    RawPointerMoveEvents = 1 << 5,
+
+    /**
+     * The node, all nested nodes and all attached data are culled if the
+     * absolute node opacity, i.e. the opacity set with
+     * @ref AbstractUserInterface::setNodeOpacity() multiplied with opacity
+     * of all parents, is @cpp 0.0f @ce. The culled nodes are then not passed
+     * to @ref AbstractLayer::update() and @ref AbstractLayer::draw() and are
+     * excluded from event processing, same as nodes culled for being
+     * outside of the clip rectangle. Nested top-level nodes are not culled
+     * unless they have this flag as well. Useful for example for fade-out
+     * animations of large panels to not waste any work once they're
+     * invisible.
+     * @m_since_latest
+     */
+    CullTransparent = 1 << 6,
+
+    /**
+     * The node is drawn fully opaque, covering everything below it in its
+     * whole area. Nodes drawn before a top-level node with this flag that are
+     * fully inside its area are culled, i.e. not passed to
+     * @ref AbstractLayer::update() and @ref AbstractLayer::draw() and
+     * excluded from event processing, same as nodes culled for being outside
+     * of the clip rectangle. It's the responsibility of the user to ensure
+     * the node indeed covers its area fully, the library doesn't check that
+     * in any way. The flag has no effect on nodes that aren't top-level.
+     * @m_since_latest
+     */
+    Opaque = 1 << 7,
 };
 
 /**
@@ -0,0 +1,196 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "PerformanceOverlayLayer.h"
+
+#include <Corrade/Containers/BitArray.h>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "Magnum/Ui/AbstractUserInterface.h"
+#include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/MemoryUsage.h"
+#include "Magnum/Ui/Implementation/memoryUsage.h"
+#include "Magnum/Ui/Implementation/performanceOverlayLayerState.h"
+
+namespace Magnum { namespace Ui {
+
+Debug& operator<<(Debug& debug, const PerformanceOverlayMode value) {
+    debug << "Ui::PerformanceOverlayMode" << Debug::nospace;
+
+    switch(value) {
+        /* LCOV_EXCL_START */
+        #define _c(value) case PerformanceOverlayMode::value: return debug << "::" #value;
+        _c(DataUpdates)
+        _c(LayoutUpdates)
+        _c(Overdraw)
+        #undef _c
+        /* LCOV_EXCL_STOP */
+    }
+
+    return debug << "(" << Debug::nospace << Debug::hex << UnsignedByte(value) << Debug::nospace << ")";
+}
+
+PerformanceOverlayLayer::PerformanceOverlayLayer(const LayerHandle handle, Containers::Pointer<State>&& state, const UnsignedInt frameCount): AbstractLayer{handle}, _state{Utility::move(state)} {
+    _state->ui->setNodeUpdateStatisticsFrameCount(frameCount);
+}
+
+PerformanceOverlayLayer::PerformanceOverlayLayer(const LayerHandle handle, AbstractUserInterface& ui, const UnsignedInt frameCount): PerformanceOverlayLayer{handle, Containers::pointer<State>(ui), frameCount} {}
+
+PerformanceOverlayLayer::PerformanceOverlayLayer(PerformanceOverlayLayer&&) noexcept = default;
+
+PerformanceOverlayLayer::~PerformanceOverlayLayer() = default;
+
+PerformanceOverlayLayer& PerformanceOverlayLayer::operator=(PerformanceOverlayLayer&&) noexcept = default;
+
+PerformanceOverlayMode PerformanceOverlayLayer::mode() const {
+    return _state->mode;
+}
+
+PerformanceOverlayLayer& PerformanceOverlayLayer::setMode(const PerformanceOverlayMode mode) {
+    _state->mode = mode;
+    setNeedsUpdate(LayerState::NeedsDataUpdate);
+    return *this;
+}
+
+Color4 PerformanceOverlayLayer::color() const {
+    return _state->color;
+}
+
+PerformanceOverlayLayer& PerformanceOverlayLayer::setColor(const Color4& color) {
+    _state->color = color;
+    setNeedsUpdate(LayerState::NeedsDataUpdate);
+    return *this;
+}
+
+DataHandle PerformanceOverlayLayer::create(const NodeHandle node) {
+    return AbstractLayer::create(node);
+}
+
+LayerFeatures PerformanceOverlayLayer::doFeatures() const {
+    return LayerFeature::Draw;
+}
+
+LayerStates PerformanceOverlayLayer::doState() const {
+    /* If the user interface recorded a new frame of statistics since the
+       last update, the heatmap needs to be regenerated */
+    const State& state = *_state;
+    return state.ui->nodeUpdateStatisticsFrame() != state.statisticsFrame ?
+        LayerState::NeedsDataUpdate : LayerStates{};
+}
+
+void PerformanceOverlayLayer::doUpdate(LayerStates, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>&, Containers::BitArrayView, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&) {
+    State& state = *_state;
+    const AbstractUserInterface& ui = *state.ui;
+    state.statisticsFrame = ui.nodeUpdateStatisticsFrame();
+
+    /* The whole heatmap is regenerated every time, as the statistics change
+       for possibly all nodes in every frame */
+    arrayResize(state.vertices, NoInit, 0);
+    arrayResize(state.indices, NoInit, 0);
+
+    /* If no overlay data is visible, there's nothing to draw */
+    if(dataIds.isEmpty())
+        return;
+
+    /* Gather the per-node values. For data and layout updates they're
+       directly the counts from the user interface, for overdraw it's the
+       count of data attached to each node from all drawing layers except
+       this one. */
+    Containers::StridedArrayView1D<const UnsignedShort> counts;
+    Float scale;
+    if(state.mode == PerformanceOverlayMode::Overdraw) {
+        if(state.nodeDataCounts.size() < nodeOffsets.size())
+            state.nodeDataCounts = Containers::Array<UnsignedInt>{NoInit, nodeOffsets.size()};
+        Utility::fill(state.nodeDataCounts, 0u);
+        for(LayerHandle layer = ui.layerFirst(); layer != LayerHandle::Null; layer = ui.layerNext(layer)) {
+            if(layer == handle() || !ui.hasLayerInstance(layer))
+                continue;
+            const AbstractLayer& instance = ui.layer(layer);
+            if(!(instance.features() >= LayerFeature::Draw))
+                continue;
+            for(const NodeHandle node: instance.nodes())
+                if(ui.isHandleValid(node) && nodeHandleId(node) < nodeOffsets.size())
+                    ++state.nodeDataCounts[nodeHandleId(node)];
+        }
+        scale = 0.25f;
+    } else {
+        counts = state.mode == PerformanceOverlayMode::DataUpdates ?
+            ui.nodeDataUpdateCounts() : ui.nodeLayoutUpdateCounts();
+        /* If the statistics got disabled in the meantime, there's nothing to
+           show */
+        if(!ui.nodeUpdateStatisticsFrameCount())
+            return;
+        scale = 1.0f/ui.nodeUpdateStatisticsFrameCount();
+    }
+
+    /* Nodes the overlay itself is attached to are excluded, as they'd
+       otherwise cover everything else */
+    Containers::BitArray overlayNodes{ValueInit, nodeOffsets.size()};
+    const Containers::StridedArrayView1D<const NodeHandle> nodes = this->nodes();
+    for(const UnsignedInt id: dataIds)
+        overlayNodes.set(nodeHandleId(nodes[id]));
+
+    /* Generate a quad for every visible node with a non-zero value */
+    const Containers::BitArrayView visibleNodes = ui.visibleNodeMask();
+    for(std::size_t i = 0, iMax = Math::min(nodeOffsets.size(), visibleNodes.size()); i != iMax; ++i) {
+        if(!visibleNodes[i] || overlayNodes[i])
+            continue;
+
+        const Float value = Math::min(1.0f, scale*(state.mode == PerformanceOverlayMode::Overdraw ?
+            state.nodeDataCounts[i] : i < counts.size() ? counts[i] : 0));
+        if(value == 0.0f)
+            continue;
+
+        const UnsignedInt vertexOffset = state.vertices.size();
+        const Vector2 min = nodeOffsets[i];
+        const Vector2 max = min + nodeSizes[i];
+        for(UnsignedByte j = 0; j != 4; ++j)
+            arrayAppend(state.vertices, Implementation::PerformanceOverlayLayerVertex{Math::lerp(min, max, BitVector2{j}), state.color*value});
+        /* Same winding as in BaseLayer */
+        arrayAppend(state.indices, {
+            vertexOffset + 0,
+            vertexOffset + 2,
+            vertexOffset + 1,
+            vertexOffset + 2,
+            vertexOffset + 3,
+            vertexOffset + 1
+        });
+    }
+}
+
+void PerformanceOverlayLayer::doMemoryUsage(MemoryUsage& usage) const {
+    const State& state = *_state;
+    usage.cpuByteCount +=
+        Implementation::arrayByteCount(state.vertices) +
+        Implementation::arrayByteCount(state.indices) +
+        Implementation::arrayByteCount(state.nodeDataCounts);
+}
+
+}}
@@ -0,0 +1,219 @@
+#ifndef Magnum_Ui_PerformanceOverlayLayer_h
+#define Magnum_Ui_PerformanceOverlayLayer_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Class @ref Magnum::Ui::PerformanceOverlayLayer, enum @ref Magnum::Ui::PerformanceOverlayMode
+ * @m_since_latest
+ */
+
+#include "Magnum/Ui/AbstractLayer.h"
+
+namespace Magnum { namespace Ui {
+
+/**
+@brief Performance overlay mode
+@m_since_latest
+
+@see @ref PerformanceOverlayLayer::setMode()
+*/
+enum class PerformanceOverlayMode: UnsignedByte {
+    /**
+     * Heatmap of how many of the recorded frames had data attached to given
+     * node updated by their layers, as reported by
+     * @ref AbstractUserInterface::nodeDataUpdateCounts(). As layers upload
+     * to the GPU exactly the data they updated, this shows uploads as well.
+     */
+    DataUpdates,
+
+    /**
+     * Heatmap of how many of the recorded frames had offset or size of
+     * given node changed, causing
+     * @ref UserInterfaceState::NeedsLayoutUpdate, as reported by
+     * @ref AbstractUserInterface::nodeLayoutUpdateCounts().
+     */
+    LayoutUpdates,
+
+    /**
+     * Overdraw visualization. Each node is shown with a quarter of the
+     * overlay color for every data attached to it from layers that
+     * advertise @ref LayerFeature::Draw, saturating at four. Overlapping
+     * nodes are blended over each other, making areas that are drawn over
+     * many times brighter.
+     */
+    Overdraw
+};
+
+/**
+@debugoperatorenum{PerformanceOverlayMode}
+@m_since_latest
+*/
+MAGNUM_UI_EXPORT Debug& operator<<(Debug& debug, PerformanceOverlayMode value);
+
+/**
+@brief Performance overlay layer
+@m_since_latest
+
+Debugging aid visualizing which nodes cause updates. Enables node update
+statistics in the user interface with
+@ref AbstractUserInterface::setNodeUpdateStatisticsFrameCount() and draws a
+translucent quad over every visible node with opacity proportional to its
+value in given @ref PerformanceOverlayMode.
+
+The layer is meant to be created last to be drawn after all other layers,
+with a single data created for a top-level node that's frontmost in the
+node order, has @ref NodeFlag::NoEvents set and covers the whole UI. The
+heatmap of all nodes is then drawn in place of that data, excluding the node
+itself. Toggling the overlay is then a matter of setting or clearing
+@ref NodeFlag::Hidden on the node, switching between the visualizations is
+done with @ref setMode().
+
+The statistics are refreshed only when the user interface has something to
+update, so if nothing changes, the overlay stays showing the last recorded
+state. This class doesn't implement drawing on its own, use the
+@ref PerformanceOverlayLayerGL subclass.
+*/
+class MAGNUM_UI_EXPORT PerformanceOverlayLayer: public AbstractLayer {
+    public:
+        /** @brief Copying is not allowed */
+        PerformanceOverlayLayer(const PerformanceOverlayLayer&) = delete;
+
+        /**
+         * @brief Move constructor
+         *
+         * Performs a destructive move, i.e. the original object isn't usable
+         * afterwards anymore.
+         */
+        PerformanceOverlayLayer(PerformanceOverlayLayer&&) noexcept;
+
+        ~PerformanceOverlayLayer() override;
+
+        /** @brief Copying is not allowed */
+        PerformanceOverlayLayer& operator=(const PerformanceOverlayLayer&) = delete;
+
+        /** @brief Move assignment */
+        PerformanceOverlayLayer& operator=(PerformanceOverlayLayer&&) noexcept;
+
+        /**
+         * @brief Visualization mode
+         *
+         * @see @ref setMode()
+         */
+        PerformanceOverlayMode mode() const;
+
+        /**
+         * @brief Set visualization mode
+         * @return Reference to self (for method chaining)
+         *
+         * Default is @ref PerformanceOverlayMode::DataUpdates. Calling this
+         * function causes @ref LayerState::NeedsDataUpdate to be set.
+         */
+        PerformanceOverlayLayer& setMode(PerformanceOverlayMode mode);
+
+        /**
+         * @brief Overlay color
+         *
+         * @see @ref setColor()
+         */
+        Color4 color() const;
+
+        /**
+         * @brief Set overlay color
+         * @return Reference to self (for method chaining)
+         *
+         * Color used for nodes with the maximal value, expected to have a
+         * premultiplied alpha. Nodes with lower values use the color scaled
+         * proportionally. Default is a translucent red,
+         * @cpp {0.8f, 0.16f, 0.16f, 0.8f} @ce. Calling this function causes
+         * @ref LayerState::NeedsDataUpdate to be set.
+         */
+        PerformanceOverlayLayer& setColor(const Color4& color);
+
+        /**
+         * @brief Create an overlay
+         * @param node      Node to attach to
+         * @return New data handle
+         *
+         * In place of the data the heatmap of all visible nodes is drawn.
+         * Delegates to @ref AbstractLayer::create().
+         */
+        DataHandle create(NodeHandle node =
+            #ifdef DOXYGEN_GENERATING_OUTPUT
+            NodeHandle::Null
+            #else
+            NodeHandle{} /* To not have to include Handle.h */
+            #endif
+        );
+
+        /**
+         * @brief Remove an overlay
+         *
+         * Delegates to @ref AbstractLayer::remove(DataHandle).
+         */
+        void remove(DataHandle handle) {
+            AbstractLayer::remove(handle);
+        }
+
+        /**
+         * @brief Remove an overlay assuming it belongs to this layer
+         *
+         * Delegates to @ref AbstractLayer::remove(LayerDataHandle).
+         */
+        void remove(LayerDataHandle handle) {
+            AbstractLayer::remove(handle);
+        }
+
+    #ifdef DOXYGEN_GENERATING_OUTPUT
+    private:
+    #else
+    protected:
+    #endif
+        struct State;
+
+        /* Enables node update statistics for frameCount frames in the user
+           interface referenced by the state */
+        MAGNUM_UI_LOCAL explicit PerformanceOverlayLayer(LayerHandle handle, Containers::Pointer<State>&& state, UnsignedInt frameCount);
+        /* Used by tests to avoid having to include / allocate the state */
+        explicit PerformanceOverlayLayer(LayerHandle handle, AbstractUserInterface& ui, UnsignedInt frameCount);
+
+        /* These can't be MAGNUM_UI_LOCAL otherwise deriving from this class
+           in tests causes linker errors */
+
+        /* Advertises LayerFeature::Draw but *does not* implement doDraw(),
+           that's on the subclass */
+        LayerFeatures doFeatures() const override;
+
+        LayerStates doState() const override;
+        void doUpdate(LayerStates states, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes) override;
+        void doMemoryUsage(MemoryUsage& usage) const override;
+
+        Containers::Pointer<State> _state;
+};
+
+}}
+
+#endif
@@ -0,0 +1,186 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "PerformanceOverlayLayerGL.h"
+
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/Utility/Resource.h>
+#include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Extensions.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/Shader.h>
+#include <Magnum/GL/Version.h>
+
+#include "Magnum/Ui/MemoryUsage.h"
+#include "Magnum/Ui/Implementation/performanceOverlayLayerState.h"
+
+#ifdef MAGNUM_BUILD_STATIC
+static void importShaderResources() {
+    CORRADE_RESOURCE_INITIALIZE(MagnumUi_RESOURCES)
+}
+#endif
+
+namespace Magnum { namespace Ui {
+
+using namespace Containers::Literals;
+
+namespace {
+
+class PerformanceOverlayShaderGL: public GL::AbstractShaderProgram {
+    public:
+        typedef GL::Attribute<0, Vector2> Position;
+        typedef GL::Attribute<1, Vector4> Color4;
+
+        explicit PerformanceOverlayShaderGL();
+
+        PerformanceOverlayShaderGL& setProjection(const Vector2& scaling) {
+            /* Y-flipped scale from the UI size to the 2x2 unit square, the
+               shader then translates by (-1, 1) on its own to put the origin
+               at center */
+            setUniform(_projectionUniform, Vector2{2.0f, -2.0f}/scaling);
+            return *this;
+        }
+
+    private:
+        Int _projectionUniform = 0;
+};
+
+PerformanceOverlayShaderGL::PerformanceOverlayShaderGL() {
+    GL::Context& context = GL::Context::current();
+    #ifndef MAGNUM_TARGET_GLES
+    MAGNUM_ASSERT_GL_EXTENSION_SUPPORTED(GL::Extensions::ARB::explicit_attrib_location);
+    #endif
+
+    #ifdef MAGNUM_BUILD_STATIC
+    if(!Utility::Resource::hasGroup("MagnumUi"_s))
+        importShaderResources();
+    #endif
+
+    Utility::Resource rs{"MagnumUi"_s};
+
+    const GL::Version version = context.supportedVersion({
+        #ifndef MAGNUM_TARGET_GLES
+        GL::Version::GL330
+        #else
+        GL::Version::GLES300
+            #ifndef MAGNUM_TARGET_WEBGL
+            , GL::Version::GLES310
+            #endif
+        #endif
+    });
+
+    /* A debugging aid, so it waits for the link right away instead of
+       deferring it to the first draw like the other shaders */
+    GL::Shader vert{version, GL::Shader::Type::Vertex};
+    vert.addSource(rs.getString("compatibility.glsl"_s))
+        .addSource(rs.getString("PerformanceOverlayShader.vert"_s));
+
+    GL::Shader frag{version, GL::Shader::Type::Fragment};
+    frag.addSource(rs.getString("compatibility.glsl"_s))
+        .addSource(rs.getString("PerformanceOverlayShader.frag"_s));
+
+    vert.submitCompile();
+    frag.submitCompile();
+
+    attachShaders({vert, frag});
+    submitLink();
+    CORRADE_INTERNAL_ASSERT_OUTPUT(checkLink({vert, frag}));
+
+    #ifndef MAGNUM_TARGET_GLES
+    if(!context.isExtensionSupported<GL::Extensions::ARB::explicit_uniform_location>())
+    #elif !defined(MAGNUM_TARGET_WEBGL)
+    if(version < GL::Version::GLES310)
+    #endif
+    {
+        _projectionUniform = uniformLocation("projection"_s);
+    }
+}
+
+}
+
+struct PerformanceOverlayLayerGL::State: PerformanceOverlayLayer::State {
+    explicit State(AbstractUserInterface& ui): PerformanceOverlayLayer::State{ui} {
+        mesh.addVertexBuffer(vertexBuffer, 0,
+                PerformanceOverlayShaderGL::Position{},
+                PerformanceOverlayShaderGL::Color4{})
+            .setIndexBuffer(indexBuffer, 0, GL::MeshIndexType::UnsignedInt);
+    }
+
+    PerformanceOverlayShaderGL shader;
+    GL::Buffer vertexBuffer{GL::Buffer::TargetHint::Array};
+    GL::Buffer indexBuffer{GL::Buffer::TargetHint::ElementArray};
+    GL::Mesh mesh;
+
+    /* The GPU upload is deferred to the next doDraw() so doUpdate() doesn't
+       touch GL and can be called from a different thread */
+    bool pendingUpload = false;
+};
+
+PerformanceOverlayLayerGL::PerformanceOverlayLayerGL(const LayerHandle handle, AbstractUserInterface& ui, const UnsignedInt frameCount): PerformanceOverlayLayer{handle, Containers::pointer<State>(ui), frameCount} {}
+
+LayerFeatures PerformanceOverlayLayerGL::doFeatures() const {
+    return PerformanceOverlayLayer::doFeatures()|LayerFeature::DrawUsesBlending;
+}
+
+void PerformanceOverlayLayerGL::doSetSize(const Vector2& size, const Vector2i&) {
+    static_cast<State&>(*_state).shader.setProjection(size);
+}
+
+void PerformanceOverlayLayerGL::doUpdate(const LayerStates states, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, const Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes) {
+    PerformanceOverlayLayer::doUpdate(states, dataIds, clipRectIds, clipRectDataCounts, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, clipRectOffsets, clipRectSizes, compositeRectOffsets, compositeRectSizes);
+    static_cast<State&>(*_state).pendingUpload = true;
+}
+
+void PerformanceOverlayLayerGL::doMemoryUsage(MemoryUsage& usage) const {
+    PerformanceOverlayLayer::doMemoryUsage(usage);
+
+    State& state = static_cast<State&>(*_state);
+    usage.gpuByteCount +=
+        std::size_t(state.vertexBuffer.size()) +
+        std::size_t(state.indexBuffer.size());
+}
+
+void PerformanceOverlayLayerGL::doDraw(const Containers::StridedArrayView1D<const UnsignedInt>&, std::size_t, std::size_t, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const UnsignedInt>&, std::size_t, std::size_t, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Float>&, Containers::BitArrayView, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&) {
+    State& state = static_cast<State&>(*_state);
+
+    if(state.pendingUpload) {
+        state.vertexBuffer.setData(state.vertices);
+        state.indexBuffer.setData(state.indices);
+        state.mesh.setCount(state.indices.size());
+        state.pendingUpload = false;
+    }
+
+    /* The whole heatmap is drawn for any overlay data, independently of the
+       passed data range. Clipping isn't done either, the overlay is meant to
+       be attached to a node covering the whole UI. */
+    if(!state.indices.isEmpty())
+        state.shader.draw(state.mesh);
+}
+
+}}
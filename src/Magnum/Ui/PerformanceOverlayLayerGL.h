@@ -0,0 +1,100 @@
+#ifndef Magnum_Ui_PerformanceOverlayLayerGL_h
+#define Magnum_Ui_PerformanceOverlayLayerGL_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Class @ref Magnum::Ui::PerformanceOverlayLayerGL
+ * @m_since_latest
+ */
+
+#include "Magnum/configure.h"
+
+#ifdef MAGNUM_TARGET_GL
+#include "Magnum/Ui/PerformanceOverlayLayer.h"
+
+namespace Magnum { namespace Ui {
+
+/**
+@brief OpenGL implementation of the performance overlay layer
+@m_since_latest
+
+The layer assumes @ref RendererGL is set on the user interface (or
+@ref UserInterfaceGL used, which does so automatically), see its documentation
+for more information about GL state expectations. The layer produces geometry
+in a counter-clockwise winding, so @ref GL::Renderer::Feature::FaceCulling can
+stay enabled when drawing it. Example usage, showing the overlay on a press
+of a key:
+
+@code{.cpp}
+Ui::PerformanceOverlayLayerGL& overlay = ui.setLayerInstance(
+    Containers::pointer<Ui::PerformanceOverlayLayerGL>(ui.createLayer(), ui));
+Ui::NodeHandle overlayNode = ui.createNode({}, ui.size(),
+    Ui::NodeFlag::NoEvents|Ui::NodeFlag::Hidden);
+overlay.create(overlayNode);
+
+// toggle the overlay
+ui.setNodeFlags(overlayNode, ui.nodeFlags(overlayNode) ^ Ui::NodeFlag::Hidden);
+@endcode
+
+@note This class is available only if Magnum is compiled with
+    @ref MAGNUM_TARGET_GL enabled (done by default). See @ref building-features
+    for more information.
+*/
+class MAGNUM_UI_EXPORT PerformanceOverlayLayerGL: public PerformanceOverlayLayer {
+    public:
+        /**
+         * @brief Constructor
+         * @param handle        Layer handle returned from
+         *      @ref AbstractUserInterface::createLayer()
+         * @param ui            User interface the layer is subsequently set
+         *      to with @ref AbstractUserInterface::setLayerInstance()
+         * @param frameCount    Count of frames to gather the node update
+         *      statistics for
+         *
+         * Calls @ref AbstractUserInterface::setNodeUpdateStatisticsFrameCount()
+         * on @p ui with @p frameCount.
+         */
+        explicit PerformanceOverlayLayerGL(LayerHandle handle, AbstractUserInterface& ui, UnsignedInt frameCount = 60);
+
+    private:
+        struct State;
+
+        /* These can't be MAGNUM_UI_LOCAL otherwise deriving from this class
+           causes linker errors */
+        LayerFeatures doFeatures() const override;
+        void doSetSize(const Vector2& size, const Vector2i& framebufferSize) override;
+        void doUpdate(LayerStates states, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes) override;
+        void doMemoryUsage(MemoryUsage& usage) const override;
+        void doDraw(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, std::size_t offset, std::size_t count, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, std::size_t clipRectOffset, std::size_t clipRectCount, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes) override;
+};
+
+}}
+#else
+#error this header is available only in the OpenGL build
+#endif
+
+#endif
@@ -57,15 +57,29 @@ Debug& operator<<(Debug& debug, const RendererGL::Flags value) {
 }
 
 struct RendererGL::State {
-    explicit State(Flags flags): flags{flags} {}
+    explicit State(Flags flags, GL::TextureFormat compositingFramebufferFormat): flags{flags}, compositingFramebufferFormat{compositingFramebufferFormat} {}
 
     bool scissorUsed = false;
+    /* Set by setCompositingFramebufferUnchanged(), reset on transition to
+       the final state */
+    bool compositingFramebufferUnchanged = false;
     Flags flags;
+    GL::TextureFormat compositingFramebufferFormat;
     GL::Texture2D compositingTexture{NoCreate};
     GL::Framebuffer compositingFramebuffer{NoCreate};
+    /* Current generation, generation at the start of the last draw and the
+       next unused generation value */
+    UnsignedLong compositingFramebufferGeneration = 0;
+    UnsignedLong compositingFramebufferInitialGeneration = 0;
+    UnsignedLong compositingFramebufferNextGeneration = 1;
 };
 
-RendererGL::RendererGL(const Flags flags): _state{InPlaceInit, flags} {}
+RendererGL::RendererGL(const Flags flags): _state{InPlaceInit, flags, GL::TextureFormat::RGBA8} {}
+
+RendererGL::RendererGL(const Flags flags, const GL::TextureFormat compositingFramebufferFormat): _state{InPlaceInit, flags, compositingFramebufferFormat} {
+    CORRADE_ASSERT(flags & Flag::CompositingFramebuffer,
+        "Ui::RendererGL: compositing framebuffer format specified but" << Flag::CompositingFramebuffer << "not enabled", );
+}
 
 RendererGL::RendererGL(RendererGL&&) noexcept = default;
 
@@ -75,6 +89,13 @@ RendererGL& RendererGL::operator=(RendererGL&&) noexcept = default;
 
 RendererGL::Flags RendererGL::flags() const { return _state->flags; }
 
+GL::TextureFormat RendererGL::compositingFramebufferFormat() const {
+    const State& state = *_state;
+    CORRADE_ASSERT(state.flags & Flag::CompositingFramebuffer,
+        "Ui::RendererGL::compositingFramebufferFormat(): compositing framebuffer not enabled", {});
+    return state.compositingFramebufferFormat;
+}
+
 const GL::Framebuffer& RendererGL::compositingFramebuffer() const {
     const State& state = *_state;
     CORRADE_ASSERT(state.flags & Flag::CompositingFramebuffer,
@@ -101,6 +122,21 @@ GL::Texture2D& RendererGL::compositingTexture() {
     return const_cast<GL::Texture2D&>(const_cast<const RendererGL&>(*this).compositingTexture());
 }
 
+UnsignedLong RendererGL::compositingFramebufferGeneration() const {
+    const State& state = *_state;
+    CORRADE_ASSERT(state.flags & Flag::CompositingFramebuffer,
+        "Ui::RendererGL::compositingFramebufferGeneration(): compositing framebuffer not enabled", {});
+    return state.compositingFramebufferGeneration;
+}
+
+RendererGL& RendererGL::setCompositingFramebufferUnchanged() {
+    State& state = *_state;
+    CORRADE_ASSERT(state.flags & Flag::CompositingFramebuffer,
+        "Ui::RendererGL::setCompositingFramebufferUnchanged(): compositing framebuffer not enabled", *this);
+    state.compositingFramebufferUnchanged = true;
+    return *this;
+}
+
 RendererFeatures RendererGL::doFeatures() const {
     return _state->flags & Flag::CompositingFramebuffer ?
         RendererFeature::Composite : RendererFeatures{};
@@ -111,11 +147,16 @@ void RendererGL::doSetupFramebuffers(const Vector2i& size) {
         would however mean the compositor needs to be aware that there's just a
         subset of the texture being used */
     if(_state->flags & Flag::CompositingFramebuffer) {
+        /* The new framebuffer has undefined contents */
+        _state->compositingFramebufferUnchanged = false;
+        _state->compositingFramebufferGeneration =
+            _state->compositingFramebufferInitialGeneration =
+                _state->compositingFramebufferNextGeneration++;
         (_state->compositingTexture = GL::Texture2D{})
             .setMinificationFilter(GL::SamplerFilter::Linear, GL::SamplerMipmap::Base)
             .setMagnificationFilter(GL::SamplerFilter::Linear)
             .setWrapping(GL::SamplerWrapping::ClampToEdge)
-            .setStorage(1, GL::TextureFormat::RGBA8, size);
+            .setStorage(1, _state->compositingFramebufferFormat, size);
         (_state->compositingFramebuffer = GL::Framebuffer{{{}, size}})
             .attachTexture(GL::Framebuffer::ColorAttachment{0}, _state->compositingTexture, 0);
     }
@@ -148,12 +189,21 @@ void RendererGL::doTransition(RendererTargetState, const RendererTargetState tar
     }
 
     /* Reset the scissor rect back to the whole framebuffer if scissor test was
-       used by any layer in this draw */
+       used by any layer in this draw. Update the compositing framebuffer
+       generation -- at the start it's the same as at the start of previous
+       draw if the contents were marked as unchanged, and any draw makes it
+       different. */
     if(targetStateTo == RendererTargetState::Initial) {
         state.scissorUsed = false;
+        if(!state.compositingFramebufferUnchanged)
+            state.compositingFramebufferInitialGeneration = state.compositingFramebufferNextGeneration++;
+        state.compositingFramebufferGeneration = state.compositingFramebufferInitialGeneration;
+    } else if(targetStateTo == RendererTargetState::Draw) {
+        state.compositingFramebufferGeneration = state.compositingFramebufferNextGeneration++;
     } else if(targetStateTo == RendererTargetState::Final) {
         if(state.scissorUsed)
             GL::Renderer::setScissor(Range2Di::fromSize({}, framebufferSize()));
+        state.compositingFramebufferUnchanged = false;
     }
 }
 
@@ -91,8 +91,9 @@ class MAGNUM_UI_EXPORT RendererGL: public AbstractRenderer {
              * contents and a source for compositing operations implemented by
              * various layers.
              *
-             * The framebuffer, with a single @ref GL::TextureFormat::RGBA8
-             * color attachment, is created on the first call to
+             * The framebuffer, with a single color attachment of
+             * @ref GL::TextureFormat::RGBA8 or a format passed to
+             * @ref RendererGL(Flags, GL::TextureFormat), is created on the first call to
              * @ref setupFramebuffers(), which is called as a
              * consequence of @ref AbstractUserInterface::setSize() or a
              * user interface constructor taking a size parameter, and is
@@ -118,6 +119,23 @@ class MAGNUM_UI_EXPORT RendererGL: public AbstractRenderer {
         /** @brief Constructor */
         explicit RendererGL(Flags flags = {});
 
+        /**
+         * @brief Construct with a custom compositing framebuffer format
+         * @m_since_latest
+         *
+         * Expects that @p flags contain @ref Flag::CompositingFramebuffer.
+         * The @p compositingFramebufferFormat is used for the
+         * @ref compositingTexture() instead of the default
+         * @ref GL::TextureFormat::RGBA8, it has to be color-renderable.
+         * Meant to be used for reducing memory use of the compositing
+         * framebuffer on memory-constrained devices with high-DPI screens,
+         * for example with @ref GL::TextureFormat::RGB565 if the content
+         * underneath the UI doesn't need an alpha channel, halving the
+         * memory use.
+         * @see @ref compositingFramebufferFormat()
+         */
+        explicit RendererGL(Flags flags, GL::TextureFormat compositingFramebufferFormat);
+
         /** @brief Copying is not allowed */
         RendererGL(const RendererGL&) = delete;
 
@@ -140,6 +158,17 @@ class MAGNUM_UI_EXPORT RendererGL: public AbstractRenderer {
         /** @brief Renderer flags */
         Flags flags() const;
 
+        /**
+         * @brief Compositing framebuffer format
+         * @m_since_latest
+         *
+         * Format of the @ref compositingTexture(),
+         * @ref GL::TextureFormat::RGBA8 unless a different one was passed to
+         * @ref RendererGL(Flags, GL::TextureFormat). Expects that the
+         * renderer was constructed with @ref Flag::CompositingFramebuffer.
+         */
+        GL::TextureFormat compositingFramebufferFormat() const;
+
         /**
          * @brief Compositing framebuffer instance
          *
@@ -167,8 +196,8 @@ class MAGNUM_UI_EXPORT RendererGL: public AbstractRenderer {
          * were set up with @ref setupFramebuffers(), which is called as a
          * consequence of @ref AbstractUserInterface::setSize() or a
          * user interface constructor taking a size parameter. The texture is
-         * implicitly set to a single @ref GL::TextureFormat::RGBA8 level of
-         * @ref framebufferSize(), with both minification and magnification
+         * implicitly set to a single level of @ref framebufferSize() in
+         * @ref compositingFramebufferFormat(), with both minification and magnification
          * filter being @ref GL::SamplerFilter::Linear and with
          * @ref GL::SamplerWrapping::ClampToEdge.
          *
@@ -182,6 +211,44 @@ class MAGNUM_UI_EXPORT RendererGL: public AbstractRenderer {
         GL::Texture2D& compositingTexture();
         const GL::Texture2D& compositingTexture() const; /**< @overload */
 
+        /**
+         * @brief Compositing framebuffer contents generation
+         * @m_since_latest
+         *
+         * Returns a value that changes every time contents of the
+         * @ref compositingFramebuffer() may have changed, i.e. at the start of
+         * every @ref AbstractUserInterface::draw() unless
+         * @ref setCompositingFramebufferUnchanged() was called before, after
+         * every layer draw and after framebuffer setup. If the value is equal
+         * to a value returned earlier, the framebuffer contents are
+         * guaranteed to be the same as back then. Meant to be queried from
+         * @ref AbstractLayer::doComposite() implementations to decide whether
+         * results of a compositing operation from the previous frame can be
+         * reused. Expects that the renderer was constructed with
+         * @ref Flag::CompositingFramebuffer.
+         */
+        UnsignedLong compositingFramebufferGeneration() const;
+
+        /**
+         * @brief Mark the compositing framebuffer contents as unchanged
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * Expects that the renderer was constructed with
+         * @ref Flag::CompositingFramebuffer. Meant to be called by the
+         * application before @ref AbstractUserInterface::draw() if all
+         * content it drew underneath the UI to the @ref compositingFramebuffer()
+         * is the same as in the previous frame. The
+         * @ref compositingFramebufferGeneration() at the start of the draw is
+         * then the same as at the start of the previous draw, allowing
+         * compositing operations that happen before any layer draws to reuse
+         * their results from the previous frame, such as
+         * @ref BaseLayerSharedFlag::BackgroundBlur skipping the blur passes.
+         * The mark is reset at the end of each
+         * @ref AbstractUserInterface::draw().
+         */
+        RendererGL& setCompositingFramebufferUnchanged();
+
     private:
         MAGNUM_UI_LOCAL RendererFeatures doFeatures() const override;
         MAGNUM_UI_LOCAL void doSetupFramebuffers(const Vector2i& size) override;
@@ -35,6 +35,8 @@
 
 #include "Magnum/Ui/Anchor.h"
 #include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/MemoryUsage.h"
+#include "Magnum/Ui/Implementation/memoryUsage.h"
 #include "Magnum/Ui/Implementation/orderNodesBreadthFirstInto.h"
 #include "Magnum/Ui/Implementation/snapLayouter.h"
 #include "Magnum/Ui/UserInterface.h"
@@ -108,8 +110,26 @@ struct Layout {
     NodeHandle target;
     Snaps snap{NoInit};
     /* 3 bytes free */
+
+    /* Inputs and outputs of the last calculation, used to skip the
+       calculation if neither the inputs nor the layouter-wide padding,
+       margin and UI size changed since. The results are valid only if
+       `generation` matches State::generation. */
+    UnsignedInt generation;
+    Vector2 nodeOffset{NoInit};
+    Vector2 nodeSize{NoInit};
+    Vector2 targetOffset{NoInit};
+    Vector2 targetSize{NoInit};
+    Vector2 outputOffset{NoInit};
+    Vector2 outputSize{NoInit};
 };
 
+/* Unlike Vector2::operator==(), which is fuzzy, this checks for exact
+   equality as the cached results have to match exactly */
+inline bool equalExact(const Vector2& a, const Vector2& b) {
+    return a.x() == b.x() && a.y() == b.y();
+}
+
 }
 
 struct SnapLayouter::State {
@@ -117,6 +137,20 @@ struct SnapLayouter::State {
     Vector2 margin;
     Containers::Array<Layout> layouts;
     Vector2 uiSize;
+
+    /* Incremented every time padding or margin changes, which invalidates
+       all cached layout results. Newly added layouts have their generation
+       set to 0 so they're always calculated. A UI size change doesn't need
+       to invalidate everything, as the UI size is the target size of layouts
+       snapped to the UI and thus already a part of the cached inputs. */
+    UnsignedInt generation = 1;
+    /* Count of layouts calculated in the last doUpdate(), excluding those
+       that used cached results */
+    UnsignedInt calculatedLayoutCount = 0;
+
+    /* Update executor and its user data, if set */
+    void(*updateExecutor)(UnsignedInt, void(*)(void*, UnsignedInt), void*, void*){};
+    void* updateExecutorUserData{};
 };
 
 SnapLayouter::SnapLayouter(const LayouterHandle handle): AbstractLayouter{handle}, _state{InPlaceInit} {}
@@ -131,6 +165,7 @@ Vector4 SnapLayouter::padding() const { return _state->padding; }
 
 SnapLayouter& SnapLayouter::setPadding(const Vector4& padding) {
     _state->padding = padding;
+    ++_state->generation;
     setNeedsUpdate();
     return *this;
 }
@@ -147,6 +182,7 @@ Vector2 SnapLayouter::margin() const { return _state->margin; }
 
 SnapLayouter& SnapLayouter::setMargin(const Vector2& margin) {
     _state->margin = margin;
+    ++_state->generation;
     setNeedsUpdate();
     return *this;
 }
@@ -190,14 +226,48 @@ LayoutHandle SnapLayouter::add(const NodeHandle node, const Snaps snap, const No
     Layout& layout = state.layouts[id];
     layout.snap = snap;
     layout.target = target;
+    layout.generation = 0;
     return handle;
 }
 
+auto SnapLayouter::updateExecutor() const -> void(*)(UnsignedInt, void(*)(void*, UnsignedInt), void*, void*) {
+    return _state->updateExecutor;
+}
+
+void* SnapLayouter::updateExecutorUserData() const {
+    return _state->updateExecutorUserData;
+}
+
+SnapLayouter& SnapLayouter::setUpdateExecutor(void(*executor)(UnsignedInt, void(*)(void*, UnsignedInt), void*, void*), void* userData) {
+    State& state = *_state;
+    state.updateExecutor = executor;
+    state.updateExecutorUserData = userData;
+    return *this;
+}
+
+void SnapLayouter::doReserve(const std::size_t capacity) {
+    arrayReserve(_state->layouts, capacity);
+}
+
+void SnapLayouter::doMemoryUsage(MemoryUsage& usage) const {
+    usage.cpuByteCount += Implementation::arrayByteCount(_state->layouts);
+}
+
+std::size_t SnapLayouter::calculatedLayoutCount() const {
+    return _state->calculatedLayoutCount;
+}
+
 void SnapLayouter::doSetSize(const Vector2& size) {
     State& state = *_state;
     state.uiSize = size;
 
-    /* Mark the layouter as needing an update. This could also be set only if
+    /* Not incrementing the generation here, so only layouts snapped directly
+       to the UI, and transitively layouts snapped to those if their offset
+       or size changes as a result, get recalculated in the next doUpdate().
+       Everything else reuses the cached results, which makes interactive
+       window resizing cheap.
+
+       Mark the layouter as needing an update. This could also be set only if
        there are any layouts snapped directly to the UI itself, but right now
        I'd say that's >90% of use cases so it doesn't make sense to try to
        make the rest more efficient -- for that there would need to be some
@@ -213,7 +283,7 @@ void SnapLayouter::doSetSize(const Vector2& size) {
 }
 
 void SnapLayouter::doUpdate(const Containers::BitArrayView layoutIdsToUpdate, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const NodeHandle>& nodeParents, const Containers::StridedArrayView1D<Vector2>& nodeOffsets, const Containers::StridedArrayView1D<Vector2>& nodeSizes) {
-    const State& state = *_state;
+    State& state = *_state;
 
     /* Order layouts breadth first in dependency order to ensure the parent
        node offset / size is known when calculating child node layout */
@@ -256,55 +326,169 @@ void SnapLayouter::doUpdate(const Containers::BitArrayView layoutIdsToUpdate, co
         layouts,
         layoutIds);
 
-    const Containers::StridedArrayView1D<const NodeHandle> nodes = this->nodes();
-
-    /* Go through the layouts in their dependency order, skipping the first
-       item which was -1 */
-    for(const std::size_t i: layoutIds.prefix(count)) {
-        const Layout& layout = _state->layouts[i];
-        const UnsignedInt nodeId = nodeHandleId(nodes[i]);
-
-        /* If the target is null, we're snapping to the whole UI */
-        Snaps snap = layout.snap;
-        Vector2 targetOffset{NoInit}, targetSize{NoInit};
-        if(layout.target == NodeHandle::Null) {
-            /* This was ensured by the snap() helper itself, which makes the
-               parent null if the target is null */
-            CORRADE_INTERNAL_DEBUG_ASSERT(nodeParents[nodeId] == NodeHandle::Null);
-            snap |= Snap::Inside;
-            targetOffset = {};
-            targetSize = state.uiSize;
-
-        /* Otherwise we're snapping relative to the parent node, which should
-           have the layout already calculated at this point thanks to the
-           dependency ordering */
-        } else {
-            const UnsignedInt nodeTargetId = nodeHandleId(layout.target);
-            targetSize = nodeSizes[nodeTargetId];
-            /* If the nodes are siblings, include the target offset in the
-               calculation */
-            if(nodeParents[nodeId] == nodeParents[nodeTargetId])
-                targetOffset = nodeOffsets[nodeTargetId];
-            /* Otherwise, if the target is a parent, don't */
-            else if(nodeParents[nodeId] == layout.target)
-                targetOffset = Vector2{};
-            /* There's no other possible case, again ensured by the SnapLayout
-               or the snap() helper, which makes the node either a sibling or
-               a child of the target */
-            else CORRADE_INTERNAL_DEBUG_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+    /* Calculates a single layout, and optionally a whole group of
+       independent layouts, if an executor is used */
+    struct Task {
+        State& state;
+        const Containers::StridedArrayView1D<const NodeHandle> nodes;
+        const Containers::StridedArrayView1D<const NodeHandle>& nodeParents;
+        const Containers::StridedArrayView1D<Vector2>& nodeOffsets;
+        const Containers::StridedArrayView1D<Vector2>& nodeSizes;
+        Containers::ArrayView<const UnsignedInt> groupOffsets;
+        Containers::ArrayView<const UnsignedInt> groupLayoutIds;
+        Containers::ArrayView<UnsignedInt> groupCalculatedLayoutCounts;
+
+        /* Returns true if the layout was calculated, false if the cached
+           result was used */
+        bool calculate(const UnsignedInt i) const {
+            Layout& layout = state.layouts[i];
+            const UnsignedInt nodeId = nodeHandleId(nodes[i]);
+
+            /* If the target is null, we're snapping to the whole UI */
+            Snaps snap = layout.snap;
+            Vector2 targetOffset{NoInit}, targetSize{NoInit};
+            if(layout.target == NodeHandle::Null) {
+                /* This was ensured by the snap() helper itself, which makes
+                   the parent null if the target is null */
+                CORRADE_INTERNAL_DEBUG_ASSERT(nodeParents[nodeId] == NodeHandle::Null);
+                snap |= Snap::Inside;
+                targetOffset = {};
+                targetSize = state.uiSize;
+
+            /* Otherwise we're snapping relative to the parent node, which
+               should have the layout already calculated at this point thanks
+               to the dependency ordering */
+            } else {
+                const UnsignedInt nodeTargetId = nodeHandleId(layout.target);
+                targetSize = nodeSizes[nodeTargetId];
+                /* If the nodes are siblings, include the target offset in the
+                   calculation */
+                if(nodeParents[nodeId] == nodeParents[nodeTargetId])
+                    targetOffset = nodeOffsets[nodeTargetId];
+                /* Otherwise, if the target is a parent, don't */
+                else if(nodeParents[nodeId] == layout.target)
+                    targetOffset = Vector2{};
+                /* There's no other possible case, again ensured by the
+                   SnapLayout or the snap() helper, which makes the node
+                   either a sibling or a child of the target */
+                else CORRADE_INTERNAL_DEBUG_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+            }
+
+            /* If the layout was calculated with the same inputs before, reuse
+               the result. The target offset and size are the output of
+               another layout if the target is laid out as well, so any change
+               in it propagates to all layouts snapped to it. */
+            if(layout.generation == state.generation &&
+               equalExact(layout.nodeOffset, nodeOffsets[nodeId]) &&
+               equalExact(layout.nodeSize, nodeSizes[nodeId]) &&
+               equalExact(layout.targetOffset, targetOffset) &&
+               equalExact(layout.targetSize, targetSize))
+            {
+                nodeOffsets[nodeId] = layout.outputOffset;
+                nodeSizes[nodeId] = layout.outputSize;
+                return false;
+            }
+
+            layout.generation = state.generation;
+            layout.nodeOffset = nodeOffsets[nodeId];
+            layout.nodeSize = nodeSizes[nodeId];
+            layout.targetOffset = targetOffset;
+            layout.targetSize = targetSize;
+
+            const Containers::Pair<Vector2, Vector2> out = Implementation::snap(snap,
+                targetOffset, targetSize,
+                state.padding,
+                state.margin,
+                nodeSizes[nodeId]);
+
+            /* The original node offset is added to the calculated layout,
+               size may be (partially) replaced */
+            nodeOffsets[nodeId] += out.first();
+            nodeSizes[nodeId] = out.second();
+
+            layout.outputOffset = nodeOffsets[nodeId];
+            layout.outputSize = nodeSizes[nodeId];
+            return true;
+        }
+
+        static void run(void* const taskState, const UnsignedInt group) {
+            const Task& task = *static_cast<const Task*>(taskState);
+            UnsignedInt calculatedLayoutCount = 0;
+            for(UnsignedInt j = task.groupOffsets[group], jMax = task.groupOffsets[group + 1]; j != jMax; ++j)
+                calculatedLayoutCount += task.calculate(task.groupLayoutIds[j]);
+            task.groupCalculatedLayoutCounts[group] = calculatedLayoutCount;
         }
+    } task{state, this->nodes(), nodeParents, nodeOffsets, nodeSizes, {}, {}, {}};
+
+    /* If there's no executor, go through the layouts in their dependency
+       order directly */
+    const Containers::ArrayView<const UnsignedInt> orderedLayoutIds = layoutIds.prefix(count);
+    if(!state.updateExecutor) {
+        state.calculatedLayoutCount = 0;
+        for(const UnsignedInt i: orderedLayoutIds)
+            state.calculatedLayoutCount += task.calculate(i);
+        return;
+    }
 
-        const Containers::Pair<Vector2, Vector2> out = Implementation::snap(snap,
-            targetOffset, targetSize,
-            state.padding,
-            state.margin,
-            nodeSizes[nodeId]);
+    /* Otherwise partition the layouts into groups that don't depend on each
+       other. A layout reads only its target node offset and size and writes
+       only its own node, so it has to be in the same group as the layout that
+       calculated the target node, if any. Going in the dependency order
+       ensures the target node group is known at that point. Layouts snapped
+       to the UI itself or to nodes not laid out in this update start a new
+       group. */
+    Containers::ArrayView<UnsignedInt> nodeGroups;
+    Containers::ArrayView<UnsignedInt> layoutGroups;
+    Containers::ArrayView<UnsignedInt> groupOffsets;
+    Containers::ArrayView<UnsignedInt> groupLayoutIds;
+    Containers::ArrayView<UnsignedInt> groupCalculatedLayoutCounts;
+    Containers::ArrayTuple groupStorage{
+        /* Group index + 1 for each node, zero if the node isn't laid out in
+           this update */
+        {ValueInit, nodeParents.size(), nodeGroups},
+        {NoInit, count, layoutGroups},
+        /* +1 for the last offset, +1 for the running offset during fill */
+        {ValueInit, count + 2, groupOffsets},
+        {NoInit, count, groupLayoutIds},
+        {NoInit, count, groupCalculatedLayoutCounts},
+    };
+    UnsignedInt groupCount = 0;
+    for(std::size_t j = 0; j != count; ++j) {
+        const UnsignedInt i = orderedLayoutIds[j];
+        const NodeHandle target = state.layouts[i].target;
+        const UnsignedInt targetGroup = target == NodeHandle::Null ? 0 : nodeGroups[nodeHandleId(target)];
+        const UnsignedInt group = targetGroup ? targetGroup - 1 : groupCount++;
+        nodeGroups[nodeHandleId(task.nodes[i])] = group + 1;
+        layoutGroups[j] = group;
+        ++groupOffsets[group + 2];
+    }
 
-        /* The original node offset is added to the calculated layout, size
-           may be (partially) replaced */
-        nodeOffsets[nodeId] += out.first();
-        nodeSizes[nodeId] = out.second();
+    /* If everything is in a single group, there's nothing to parallelize */
+    if(groupCount <= 1) {
+        state.calculatedLayoutCount = 0;
+        for(const UnsignedInt i: orderedLayoutIds)
+            state.calculatedLayoutCount += task.calculate(i);
+        return;
     }
+
+    /* Turn the counts into offsets and fill the groups, preserving the
+       dependency order in each */
+    for(UnsignedInt group = 0, offset = 0; group != groupCount; ++group) {
+        const UnsignedInt nextOffset = offset + groupOffsets[group + 2];
+        groupOffsets[group + 2] = offset;
+        offset = nextOffset;
+    }
+    for(std::size_t j = 0; j != count; ++j)
+        groupLayoutIds[groupOffsets[layoutGroups[j] + 2]++] = orderedLayoutIds[j];
+
+    task.groupOffsets = groupOffsets.exceptPrefix(1).prefix(groupCount + 1);
+    task.groupLayoutIds = groupLayoutIds;
+    task.groupCalculatedLayoutCounts = groupCalculatedLayoutCounts.prefix(groupCount);
+    state.updateExecutor(groupCount, Task::run, &task, state.updateExecutorUserData);
+
+    state.calculatedLayoutCount = 0;
+    for(const UnsignedInt i: task.groupCalculatedLayoutCounts)
+        state.calculatedLayoutCount += i;
 }
 
 AbstractSnapLayout::AbstractSnapLayout(AbstractUserInterface& ui, SnapLayouter& layouter, const Snaps snapFirst, const NodeHandle target, const Snaps snapNext): _ui{ui}, _layouter{layouter}, _targetFirst{target}, _snapFirst{snapFirst}, _snapNext{snapNext} {
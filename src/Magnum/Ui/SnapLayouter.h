@@ -314,6 +314,69 @@ class MAGNUM_UI_EXPORT SnapLayouter: public AbstractLayouter {
          */
         SnapLayouter& setMargin(Float margin);
 
+        /**
+         * @brief Update executor
+         * @m_since_latest
+         *
+         * @cpp nullptr @ce by default, meaning all layouts are calculated
+         * sequentially.
+         * @see @ref updateExecutorUserData(), @ref setUpdateExecutor()
+         */
+        auto updateExecutor() const -> void(*)(UnsignedInt, void(*)(void*, UnsignedInt), void*, void*);
+
+        /**
+         * @brief Update executor user data
+         * @m_since_latest
+         *
+         * Contents of the @p userData parameter passed to
+         * @ref setUpdateExecutor().
+         */
+        void* updateExecutorUserData() const;
+
+        /**
+         * @brief Set an update executor
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * By default, @ref update() calculates all layouts one after another
+         * in their dependency order. If an @p executor is set, the layouts
+         * are first partitioned into groups that don't depend on each other,
+         * i.e. a layout is put into the same group as the layout calculated
+         * for its target node, if there's any, and into a new group
+         * otherwise. If there's more than one group, the @p executor is then
+         * called with the group count, a @p task function, its @p taskState
+         * and the @p userData pointer passed to this function. The executor is
+         * expected to call @p task with @p taskState and each index in range
+         * @cpp [0, count) @ce exactly once, in an arbitrary order and possibly
+         * from multiple threads concurrently, and return only after all calls
+         * finished. Each task call calculates layouts of a single group in
+         * their dependency order, with different groups writing to different
+         * nodes.
+         *
+         * Set the @p executor to @cpp nullptr @ce to go back to the default
+         * sequential behavior.
+         * @see @ref AbstractUserInterface::setLayerUpdateExecutor()
+         */
+        SnapLayouter& setUpdateExecutor(void(*executor)(UnsignedInt count, void(*task)(void* taskState, UnsignedInt index), void* taskState, void* userData), void* userData = nullptr);
+
+        /**
+         * @brief Count of layouts calculated in the last update
+         * @m_since_latest
+         *
+         * The layouter remembers the inputs and results of each layout
+         * calculation, i.e. the node offset and size, the target node offset
+         * and size, together with the @ref padding(), @ref margin() and user
+         * interface size. If none of them changed since the last time, the
+         * previous result is reused instead of calculating the layout again.
+         * As the target offset and size is a result of another layout if the
+         * target is laid out as well, a change in a single layout propagates
+         * only to layouts that snap to it, directly or indirectly. This
+         * function returns the count of layouts that were actually calculated
+         * in the last @ref update() call, excluding those that reused
+         * previous results.
+         */
+        std::size_t calculatedLayoutCount() const;
+
         /**
          * @brief Layout snap
          *
@@ -387,6 +450,8 @@ class MAGNUM_UI_EXPORT SnapLayouter: public AbstractLayouter {
         MAGNUM_UI_LOCAL LayoutHandle add(NodeHandle node, Snaps snap, NodeHandle target);
 
         MAGNUM_UI_LOCAL void doSetSize(const Vector2& size) override;
+        MAGNUM_UI_LOCAL void doReserve(std::size_t capacity) override;
+        MAGNUM_UI_LOCAL void doMemoryUsage(MemoryUsage& usage) const override;
         MAGNUM_UI_LOCAL void doUpdate(Containers::BitArrayView layoutIdsToUpdate, const Containers::StridedArrayView1D<const UnsignedInt>& topLevelLayoutIds, const Containers::StridedArrayView1D<const NodeHandle>& nodeParents, const Containers::StridedArrayView1D<Vector2>& nodeOffsets, const Containers::StridedArrayView1D<Vector2>& nodeSizes) override;
 
         struct State;
@@ -0,0 +1,315 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "StackLayouter.h"
+
+#include <Corrade/Containers/ArrayTuple.h>
+#include <Corrade/Containers/BitArrayView.h>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Magnum/Math/Swizzle.h>
+
+#include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/MemoryUsage.h"
+#include "Magnum/Ui/Implementation/memoryUsage.h"
+#include "Magnum/Ui/Implementation/orderNodesBreadthFirstInto.h"
+
+namespace Magnum { namespace Ui {
+
+Debug& operator<<(Debug& debug, const StackDirection value) {
+    const bool packed = debug.immediateFlags() >= Debug::Flag::Packed;
+
+    if(!packed)
+        debug << "Ui::StackDirection" << Debug::nospace;
+
+    switch(value) {
+        /* LCOV_EXCL_START */
+        #define _c(value) case StackDirection::value: return debug << (packed ? "" : "::") << Debug::nospace << #value;
+        _c(Vertical)
+        _c(Horizontal)
+        #undef _c
+        /* LCOV_EXCL_STOP */
+    }
+
+    return debug << (packed ? "" : "(") << Debug::nospace << Debug::hex << UnsignedByte(value) << Debug::nospace << (packed ? "" : ")");
+}
+
+namespace {
+
+constexpr UnsignedInt NoLayout = ~UnsignedInt{};
+
+struct Layout {
+    /* Previous and next layout in the stack or NoLayout if this is the first /
+       last one. The layouts form a single global list, layouts of a
+       particular parent node are extracted from it in doUpdate(). */
+    UnsignedInt previous;
+    UnsignedInt next;
+};
+
+}
+
+struct StackLayouter::State {
+    Vector4 padding;
+    Float spacing = 0.0f;
+    StackDirection direction = StackDirection::Vertical;
+    bool crossAxisFill = false;
+    Containers::Array<Layout> layouts;
+    UnsignedInt first = NoLayout;
+    UnsignedInt last = NoLayout;
+    Vector2 uiSize;
+};
+
+StackLayouter::StackLayouter(const LayouterHandle handle): AbstractLayouter{handle}, _state{InPlaceInit} {}
+
+StackLayouter::StackLayouter(StackLayouter&&) noexcept = default;
+
+StackLayouter::~StackLayouter() = default;
+
+StackLayouter& StackLayouter::operator=(StackLayouter&&) noexcept = default;
+
+StackDirection StackLayouter::direction() const { return _state->direction; }
+
+StackLayouter& StackLayouter::setDirection(const StackDirection direction) {
+    _state->direction = direction;
+    setNeedsUpdate();
+    return *this;
+}
+
+Vector4 StackLayouter::padding() const { return _state->padding; }
+
+StackLayouter& StackLayouter::setPadding(const Vector4& padding) {
+    _state->padding = padding;
+    setNeedsUpdate();
+    return *this;
+}
+
+StackLayouter& StackLayouter::setPadding(const Vector2& padding) {
+    return setPadding(Math::gather<'x', 'y', 'x', 'y'>(padding));
+}
+
+StackLayouter& StackLayouter::setPadding(const Float padding) {
+    return setPadding(Vector4{padding});
+}
+
+Float StackLayouter::spacing() const { return _state->spacing; }
+
+StackLayouter& StackLayouter::setSpacing(const Float spacing) {
+    _state->spacing = spacing;
+    setNeedsUpdate();
+    return *this;
+}
+
+bool StackLayouter::crossAxisFill() const { return _state->crossAxisFill; }
+
+StackLayouter& StackLayouter::setCrossAxisFill(const bool fill) {
+    _state->crossAxisFill = fill;
+    setNeedsUpdate();
+    return *this;
+}
+
+LayoutHandle StackLayouter::add(const NodeHandle node, const LayoutHandle before) {
+    CORRADE_ASSERT(before == LayoutHandle::Null || isHandleValid(before),
+        "Ui::StackLayouter::add(): invalid before handle" << before, {});
+    State& state = *_state;
+
+    const LayoutHandle handle = AbstractLayouter::add(node);
+    const UnsignedInt id = layoutHandleId(handle);
+    if(id >= state.layouts.size())
+        arrayAppend(state.layouts, NoInit, id - state.layouts.size() + 1);
+
+    Layout& layout = state.layouts[id];
+    /* Insert before the given layout ... */
+    if(before != LayoutHandle::Null) {
+        const UnsignedInt beforeId = layoutHandleId(before);
+        Layout& beforeLayout = state.layouts[beforeId];
+        layout.previous = beforeLayout.previous;
+        layout.next = beforeId;
+        if(beforeLayout.previous == NoLayout)
+            state.first = id;
+        else
+            state.layouts[beforeLayout.previous].next = id;
+        beforeLayout.previous = id;
+
+    /* ... or at the end */
+    } else {
+        layout.previous = state.last;
+        layout.next = NoLayout;
+        if(state.last == NoLayout)
+            state.first = id;
+        else
+            state.layouts[state.last].next = id;
+        state.last = id;
+    }
+
+    return handle;
+}
+
+void StackLayouter::remove(const LayoutHandle handle) {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::StackLayouter::remove(): invalid handle" << handle, );
+    unlink(layoutHandleId(handle));
+    AbstractLayouter::remove(handle);
+}
+
+void StackLayouter::remove(const LayouterDataHandle handle) {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::StackLayouter::remove(): invalid handle" << handle, );
+    unlink(layouterDataHandleId(handle));
+    AbstractLayouter::remove(handle);
+}
+
+void StackLayouter::unlink(const UnsignedInt id) {
+    State& state = *_state;
+    const Layout& layout = state.layouts[id];
+    if(layout.previous == NoLayout)
+        state.first = layout.next;
+    else
+        state.layouts[layout.previous].next = layout.next;
+    if(layout.next == NoLayout)
+        state.last = layout.previous;
+    else
+        state.layouts[layout.next].previous = layout.previous;
+}
+
+void StackLayouter::doClean(const Containers::BitArrayView layoutIdsToRemove) {
+    /** @todo some way to iterate set bits */
+    for(std::size_t i = 0; i != layoutIdsToRemove.size(); ++i)
+        if(layoutIdsToRemove[i]) unlink(i);
+}
+
+void StackLayouter::doReserve(const std::size_t capacity) {
+    arrayReserve(_state->layouts, capacity);
+}
+
+void StackLayouter::doMemoryUsage(MemoryUsage& usage) const {
+    usage.cpuByteCount += Implementation::arrayByteCount(_state->layouts);
+}
+
+void StackLayouter::doSetSize(const Vector2& size) {
+    State& state = *_state;
+    state.uiSize = size;
+
+    /* Layouts stacked directly in the UI depend on its size only if cross
+       axis fill is enabled, otherwise the stacking is done purely from node
+       sizes and a UI size change can be ignored, which makes interactive
+       window resizing cheap. Whether there are any layouts stacked directly
+       in the UI isn't known here as that'd need the node parents, so in case
+       of cross axis fill it's always updated. */
+    if(state.crossAxisFill)
+        setNeedsUpdate();
+}
+
+void StackLayouter::doUpdate(const Containers::BitArrayView layoutIdsToUpdate, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const NodeHandle>& nodeParents, const Containers::StridedArrayView1D<Vector2>& nodeOffsets, const Containers::StridedArrayView1D<Vector2>& nodeSizes) {
+    const State& state = *_state;
+    const Containers::StridedArrayView1D<const NodeHandle> nodes = this->nodes();
+
+    /* Parent nodes have to be processed before their children in order to
+       have their size known in case cross axis fill is enabled, so order the
+       nodes breadth-first. Additionally extract layouts of each parent into
+       a contiguous range, preserving the order they have in the list. */
+    /** @todo The childrenOffsets and children have a non-overlapping lifetime
+        with parentOffsets and parentLayoutIds, but handling that manually is
+        too messy */
+    Containers::ArrayView<UnsignedInt> childrenOffsets;
+    Containers::ArrayView<UnsignedInt> children;
+    Containers::ArrayView<Int> nodeIdsBreadthFirst;
+    Containers::ArrayView<UnsignedInt> parentOffsets;
+    Containers::ArrayView<UnsignedInt> parentLayoutIds;
+    Containers::ArrayTuple storage{
+        /* +1 for the last offset, +1 for root nodes */
+        {ValueInit, nodeParents.size() + 2, childrenOffsets},
+        {NoInit, nodeParents.size(), children},
+        /* +1 for the first element which is -1 indicating a root */
+        {NoInit, nodeParents.size() + 1, nodeIdsBreadthFirst},
+        /* +1 for layouts stacked in the UI itself, +1 for the last offset, +1
+           for the running offset during fill */
+        {ValueInit, nodeParents.size() + 3, parentOffsets},
+        {NoInit, layoutIdsToUpdate.size(), parentLayoutIds},
+    };
+    Implementation::orderNodesBreadthFirstInto(
+        nodeParents,
+        childrenOffsets, children, nodeIdsBreadthFirst);
+
+    /* Count layouts in each parent, index 0 is the UI itself ... */
+    for(UnsignedInt i = state.first; i != NoLayout; i = state.layouts[i].next) {
+        if(!layoutIdsToUpdate[i])
+            continue;
+        const NodeHandle parent = nodeParents[nodeHandleId(nodes[i])];
+        ++parentOffsets[(parent == NodeHandle::Null ? 0 : nodeHandleId(parent) + 1) + 2];
+    }
+
+    /* ... convert the counts to offsets ... */
+    for(UnsignedInt i = 2, offset = 0; i != parentOffsets.size(); ++i) {
+        const UnsignedInt nextOffset = offset + parentOffsets[i];
+        parentOffsets[i] = offset;
+        offset = nextOffset;
+    }
+
+    /* ... and fill the layout IDs in the list order. After this,
+       `[parentOffsets[i + 1], parentOffsets[i + 2])` is the range of layouts
+       for parent `i`, with `i` being 0 for the UI itself and node ID + 1
+       otherwise. */
+    for(UnsignedInt i = state.first; i != NoLayout; i = state.layouts[i].next) {
+        if(!layoutIdsToUpdate[i])
+            continue;
+        const NodeHandle parent = nodeParents[nodeHandleId(nodes[i])];
+        parentLayoutIds[parentOffsets[(parent == NodeHandle::Null ? 0 : nodeHandleId(parent) + 1) + 2]++] = i;
+    }
+
+    /* Main and cross axis index, the padding has the leading values in the
+       first two components and trailing in the other two */
+    const UnsignedInt main = state.direction == StackDirection::Vertical ? 1 : 0;
+    const UnsignedInt cross = 1 - main;
+
+    /* Go through the parents in the breadth-first order and stack each of them
+       in a single pass. The first item is -1, i.e. the UI itself. */
+    for(const Int parentId: nodeIdsBreadthFirst) {
+        const UnsignedInt begin = parentOffsets[parentId + 2];
+        const UnsignedInt end = parentOffsets[parentId + 3];
+        if(begin == end)
+            continue;
+
+        const Vector2 parentSize = parentId == -1 ? state.uiSize : nodeSizes[parentId];
+        const Float crossSize = parentSize[cross] - state.padding[cross] - state.padding[cross + 2];
+        Float position = state.padding[main];
+        for(UnsignedInt j = begin; j != end; ++j) {
+            const UnsignedInt nodeId = nodeHandleId(nodes[parentLayoutIds[j]]);
+            Vector2& nodeOffset = nodeOffsets[nodeId];
+            Vector2& nodeSize = nodeSizes[nodeId];
+
+            /* The original node offset is added to the calculated position,
+               the size is replaced only on the cross axis if filling */
+            nodeOffset[main] += position;
+            nodeOffset[cross] += state.padding[cross];
+            if(state.crossAxisFill)
+                nodeSize[cross] = crossSize;
+
+            position += nodeSize[main] + state.spacing;
+        }
+    }
+}
+
+}}
@@ -0,0 +1,243 @@
+#ifndef Magnum_Ui_StackLayouter_h
+#define Magnum_Ui_StackLayouter_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+/** @file
+ * @brief Class @ref Magnum::Ui::StackLayouter, enum @ref Magnum::Ui::StackDirection
+ * @m_since_latest
+ */
+
+#include "Magnum/Ui/AbstractLayouter.h"
+
+namespace Magnum { namespace Ui {
+
+/**
+@brief Stack layouter direction
+@m_since_latest
+
+@see @ref StackLayouter::setDirection()
+*/
+enum class StackDirection: UnsignedByte {
+    /**
+     * Nodes are stacked vertically from top to bottom, each placed below the
+     * previous one.
+     */
+    Vertical,
+
+    /**
+     * Nodes are stacked horizontally from left to right, each placed after
+     * the previous one.
+     */
+    Horizontal
+};
+
+/**
+@debugoperatorenum{StackDirection}
+@m_since_latest
+*/
+MAGNUM_UI_EXPORT Debug& operator<<(Debug& debug, StackDirection value);
+
+/**
+@brief Stack layouter
+@m_since_latest
+
+Places nodes one after another along the main axis given by @ref direction(),
+in the order in which they were added, taking @ref padding() of the parent
+node and @ref spacing() between the nodes into account. Nodes sharing the
+same parent form a single stack, nodes with no parent are stacked inside the
+user interface itself. Node sizes along the main axis are taken as-is, along
+the cross axis they're optionally stretched to fill the parent, see
+@ref setCrossAxisFill(). The node's own offset is added on top of the
+calculated position.
+
+The layouts are kept in a doubly-linked list, meaning both @ref add() and
+@ref remove() are @f$ \mathcal{O}(1) @f$ regardless of the position in the
+stack, and the whole stack is laid out in a single pass over the list in
+@ref update(). Hidden nodes don't take any space in the stack.
+
+The layouter has a single direction, padding and spacing for all layouts it
+contains. If different parts of the user interface need different settings,
+create multiple layouter instances.
+@see @ref SnapLayouter
+*/
+class MAGNUM_UI_EXPORT StackLayouter: public AbstractLayouter {
+    public:
+        /**
+         * @brief Constructor
+         * @param handle    Layouter handle returned from
+         *      @ref AbstractUserInterface::createLayouter()
+         */
+        explicit StackLayouter(LayouterHandle handle);
+
+        /** @brief Copying is not allowed */
+        StackLayouter(const StackLayouter&) = delete;
+
+        /**
+         * @brief Move constructor
+         *
+         * Performs a destructive move, i.e. the original object isn't usable
+         * afterwards anymore.
+         */
+        StackLayouter(StackLayouter&&) noexcept;
+
+        virtual ~StackLayouter();
+
+        /** @brief Copying is not allowed */
+        StackLayouter& operator=(const StackLayouter&) = delete;
+
+        /** @brief Move assignment */
+        StackLayouter& operator=(StackLayouter&&) noexcept;
+
+        /** @brief Stack direction */
+        StackDirection direction() const;
+
+        /**
+         * @brief Set stack direction
+         * @return Reference to self (for method chaining)
+         *
+         * Applied globally to all layouts. Initially the direction is
+         * @ref StackDirection::Vertical.
+         *
+         * Calling this function causes @ref LayouterState::NeedsUpdate to be
+         * set.
+         */
+        StackLayouter& setDirection(StackDirection direction);
+
+        /** @brief Left, top, right and bottom padding inside a parent node */
+        Vector4 padding() const;
+
+        /**
+         * @brief Set different left, top, right and bottom padding inside a parent node
+         * @return Reference to self (for method chaining)
+         *
+         * Applied globally to all layouts. The first node in a stack is placed
+         * after the leading padding on the main axis, and all nodes are placed
+         * after the leading padding on the cross axis. Initially the padding
+         * is @cpp {0.0f, 0.0f, 0.0f, 0.0f} @ce.
+         *
+         * Calling this function causes @ref LayouterState::NeedsUpdate to be
+         * set.
+         * @see @ref setPadding(const Vector2&), @ref setPadding(Float)
+         */
+        StackLayouter& setPadding(const Vector4& padding);
+
+        /**
+         * @brief Set different horizontal and vertical padding inside a parent node
+         * @return Reference to self (for method chaining)
+         *
+         * Same as calling @ref setPadding(const Vector4&) with the left, right
+         * and top, bottom components being the same.
+         * @see @ref setPadding(Float)
+         */
+        StackLayouter& setPadding(const Vector2& padding);
+
+        /**
+         * @brief Set padding inside a parent node
+         * @return Reference to self (for method chaining)
+         *
+         * Same as calling @ref setPadding(const Vector4&) with all values
+         * being the same.
+         * @see @ref setPadding(const Vector2&)
+         */
+        StackLayouter& setPadding(Float padding);
+
+        /** @brief Spacing between nodes along the main axis */
+        Float spacing() const;
+
+        /**
+         * @brief Set spacing between nodes along the main axis
+         * @return Reference to self (for method chaining)
+         *
+         * Applied globally to all layouts. Initially the spacing is
+         * @cpp 0.0f @ce.
+         *
+         * Calling this function causes @ref LayouterState::NeedsUpdate to be
+         * set.
+         */
+        StackLayouter& setSpacing(Float spacing);
+
+        /** @brief Whether nodes fill the parent along the cross axis */
+        bool crossAxisFill() const;
+
+        /**
+         * @brief Set whether nodes fill the parent along the cross axis
+         * @return Reference to self (for method chaining)
+         *
+         * If enabled, node size along the cross axis is set to the parent
+         * size minus the padding. If disabled, the node size is kept as-is.
+         * Initially disabled.
+         *
+         * Calling this function causes @ref LayouterState::NeedsUpdate to be
+         * set.
+         */
+        StackLayouter& setCrossAxisFill(bool fill);
+
+        /**
+         * @brief Add a layout
+         * @param node      Node to add the layout to
+         * @param before    Layout to insert the new one before or
+         *      @ref LayoutHandle::Null to put it at the end
+         * @return New layout handle
+         *
+         * Delegates to @ref AbstractLayouter::add() and then inserts the
+         * layout into the stack in @f$ \mathcal{O}(1) @f$ time. Expects that
+         * @p before is either @ref LayoutHandle::Null or valid. The @p before
+         * layout is meant to be attached to a node with the same parent as
+         * @p node, otherwise the relative order of the two doesn't matter.
+         */
+        LayoutHandle add(NodeHandle node, LayoutHandle before = LayoutHandle::Null);
+
+        /**
+         * @brief Remove a layout
+         *
+         * Removes the layout from the stack in @f$ \mathcal{O}(1) @f$ time
+         * and then delegates to @ref AbstractLayouter::remove(LayoutHandle).
+         */
+        void remove(LayoutHandle handle);
+
+        /**
+         * @brief Remove a layout assuming it belongs to this layouter
+         *
+         * Removes the layout from the stack in @f$ \mathcal{O}(1) @f$ time
+         * and then delegates to @ref AbstractLayouter::remove(LayouterDataHandle).
+         */
+        void remove(LayouterDataHandle handle);
+
+    private:
+        MAGNUM_UI_LOCAL void unlink(UnsignedInt id);
+
+        MAGNUM_UI_LOCAL void doSetSize(const Vector2& size) override;
+        MAGNUM_UI_LOCAL void doClean(Containers::BitArrayView layoutIdsToRemove) override;
+        MAGNUM_UI_LOCAL void doReserve(std::size_t capacity) override;
+        MAGNUM_UI_LOCAL void doMemoryUsage(MemoryUsage& usage) const override;
+        MAGNUM_UI_LOCAL void doUpdate(Containers::BitArrayView layoutIdsToUpdate, const Containers::StridedArrayView1D<const UnsignedInt>& topLevelLayoutIds, const Containers::StridedArrayView1D<const NodeHandle>& nodeParents, const Containers::StridedArrayView1D<Vector2>& nodeOffsets, const Containers::StridedArrayView1D<Vector2>& nodeSizes) override;
+
+        struct State;
+        Containers::Pointer<State> _state;
+};
+
+}}
+
+#endif
@@ -40,8 +40,6 @@
 #include <Magnum/Text/AbstractGlyphCache.h>
 #include <Magnum/Text/Alignment.h>
 #include <Magnum/TextureTools/Atlas.h>
-#include <Magnum/Trade/AbstractImporter.h>
-#include <Magnum/Trade/ImageData.h>
 
 #include "Magnum/Ui/BaseLayer.h"
 #include "Magnum/Ui/EventLayer.h"
@@ -643,7 +641,7 @@ Vector3i McssDarkStyle::doTextLayerGlyphCacheSize(StyleFeatures) const {
     return {512, 512, 1};
 }
 
-bool McssDarkStyle::doApply(UserInterface& ui, const StyleFeatures features, PluginManager::Manager<Trade::AbstractImporter>* importerManager, PluginManager::Manager<Text::AbstractFont>* fontManager) const {
+bool McssDarkStyle::doApply(UserInterface& ui, const StyleFeatures features, PluginManager::Manager<Trade::AbstractImporter>*, PluginManager::Manager<Text::AbstractFont>* fontManager) const {
     /* Base layer style */
     if(features >= StyleFeature::BaseLayer) {
         ui.baseLayer().shared()
@@ -667,6 +665,8 @@ bool McssDarkStyle::doApply(UserInterface& ui, const StyleFeatures features, Plu
        MSVC says iconFont might be used uninitialized without the {}. It won't,
        the thing is just stupid. */
     Ui::FontHandle iconFont{};
+    Containers::Pointer<Text::AbstractFont> font;
+    bool glyphCacheBaked = false;
     if(features & (StyleFeature::TextLayer|StyleFeature::TextLayerImages)) {
         #ifdef MAGNUM_BUILD_STATIC
         if(!Utility::Resource::hasGroup("MagnumUi"_s))
@@ -675,8 +675,33 @@ bool McssDarkStyle::doApply(UserInterface& ui, const StyleFeatures features, Plu
 
         TextLayer::Shared& shared = ui.textLayer().shared();
         Text::AbstractGlyphCache& glyphCache = shared.glyphCache();
-        /* The Icon enum reserves 0 for an invalid glyph, so add 1 */
-        const UnsignedInt iconFontId = glyphCache.addFont(Implementation::IconCount + 1);
+
+        /* The main font is used only by the text layer style below, but if
+           there's baked glyph cache data it has to be opened already here to
+           associate it with the deserialized glyphs */
+        if(features >= StyleFeature::TextLayer) {
+            const Utility::Resource rs{"MagnumUi"_s};
+            font = fontManager->loadAndInstantiate("TrueTypeFont");
+            if(!font || !font->openData(rs.getRaw("SourceSansPro-Regular.ttf"_s), 16.0f*2*(Vector2{ui.framebufferSize()}/ui.size()).max())) {
+                Error{} << "Ui::McssDarkStyle::apply(): cannot open a font";
+                return {};
+            }
+        }
+
+        /* The baked data contain the icon font first and the main font second,
+           in the same order as they'd be added here and below. The Icon enum
+           reserves 0 for an invalid glyph, so add 1. */
+        UnsignedInt iconFontId;
+        Containers::Optional<UnsignedInt> bakedFontId;
+        const Text::AbstractFont* const bakedFonts[]{nullptr, font.get()};
+        if(font && !_glyphCacheData.isEmpty() && (bakedFontId = shared.deserializeGlyphCache(_glyphCacheData, bakedFonts))) {
+            iconFontId = *bakedFontId;
+            glyphCacheBaked = true;
+        } else {
+            if(font && !_glyphCacheData.isEmpty())
+                Warning{} << "Ui::McssDarkStyle::apply(): cannot use the baked glyph cache data, filling the cache from scratch";
+            iconFontId = glyphCache.addFont(Implementation::IconCount + 1);
+        }
         /* The input is 64x64 squares, which are meant to be shown as 24x24
            squares in the UI units */
         /** @todo some DPI-aware machinery here, such as picking one of
@@ -692,17 +717,16 @@ bool McssDarkStyle::doApply(UserInterface& ui, const StyleFeatures features, Plu
     if(features >= StyleFeature::TextLayer) {
         TextLayer::Shared& shared = ui.textLayer().shared();
         Text::AbstractGlyphCache& glyphCache = shared.glyphCache();
-        const Utility::Resource rs{"MagnumUi"_s};
 
-        Containers::Pointer<Text::AbstractFont> font = fontManager->loadAndInstantiate("TrueTypeFont");
-        if(!font || !font->openData(rs.getRaw("SourceSansPro-Regular.ttf"_s), 16.0f*2*(Vector2{ui.framebufferSize()}/ui.size()).max())) {
-            Error{} << "Ui::McssDarkStyle::apply(): cannot open a font";
-            return {};
-        }
+        /* Pre-fill the cache with the most common characters. With baked
+           data the cache is pre-filled already. On-demand filling isn't
+           enabled as it would upload to the glyph cache texture in update(),
+           which is otherwise free of GL calls and thus can be called from a
+           thread different from the GL one or with a parallel layer update
+           executor. */
         /** @todo fail if this fails, once the function doesn't return void */
-        /** @todo configurable way to fill the cache, or switch to on-demand
-            by default once AbstractFont can fill the cache with glyph IDs */
-        font->fillGlyphCache(glyphCache,
+        /** @todo configurable way to fill the cache */
+        if(!glyphCacheBaked) font->fillGlyphCache(glyphCache,
             "abcdefghijklmnopqrstuvwxyz"
             "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
             "0123456789 _.,-+=*:;?!@$&#/\\|`\"'<>()[]{}%…");
@@ -749,40 +773,27 @@ bool McssDarkStyle::doApply(UserInterface& ui, const StyleFeatures features, Plu
                 Implementation::styleTransitionToDisabled>();
     }
 
-    /* Text layer images */
-    if(features >= StyleFeature::TextLayerImages) {
+    /* Text layer images, unless they were in the baked glyph cache data
+       already */
+    if(features >= StyleFeature::TextLayerImages && !(glyphCacheBaked && ui.textLayer().shared().glyphCache().glyphId(ui.textLayer().shared().glyphCacheFontId(iconFont), 1))) {
         TextLayer::Shared& shared = ui.textLayer().shared();
         Text::AbstractGlyphCache& glyphCache = shared.glyphCache();
         const Utility::Resource rs{"MagnumUi"_s};
 
-        Containers::Pointer<Trade::AbstractImporter> importer = importerManager->loadAndInstantiate("AnyImageImporter");
-        Containers::Optional<Trade::ImageData2D> image;
-        if(!importer || !importer->openMemory(rs.getRaw("icons.png")) || !(image = importer->image2D(0))) {
-            Error{} << "Ui::McssDarkStyle::apply(): cannot open an icon atlas";
-            return {};
-        }
-
-        /* The image is originally grayscale 8-bit, expect that it's still
-           imported with 8-bit channels. The importer can be globally
-           configured to import them with more channels (which is fine, for
-           example in testing context, where we might always want to compare to
-           a RGBA image even if the on-disk representation has the alpha
-           dropped), in which case just the red channel is taken, but it's
-           important that it isn't expanded to 16 bits or to floats, for
-           example. */
-        if(pixelFormatChannelFormat(image->format()) != PixelFormat::R8Unorm) {
-            Error{} << "Ui::McssDarkStyle::apply(): expected" << PixelFormat::R8Unorm << "icons but got an image with" << image->format();
-            return {};
-        }
-        const std::size_t channelSize = image->pixelSize()/pixelFormatChannelCount(image->format());
-
-        /* At the moment it's a single row of square icons, with the image
-           height denoting the square size, and the order matching the Icon
+        /* The icons are stored as raw 8-bit single-channel pixels, bottom row
+           first, so they can be copied to the glyph cache as-is without having
+           to decode an image and load an importer plugin for it. At the moment
+           it's a single row of 64x64 squares, with the order matching the Icon
            enum. Reserve space for all of them in the glyph cache. */
-        const Vector2i imageSize{image->size().y()};
-        CORRADE_INTERNAL_ASSERT(image->size().x() % image->size().y() == 0);
+        const Vector2i imageSize{64};
+        const ImageView2D image{PixelFormat::R8Unorm, {Int(Implementation::IconCount)*imageSize.x(), imageSize.y()}, rs.getRaw("icons.bin"_s)};
         Vector3i offsets[Implementation::IconCount];
-        if(!glyphCache.atlas().add(Containers::stridedArrayView(&imageSize, 1).broadcasted<0>(Implementation::IconCount), offsets)) {
+        /* The atlas returns the range it filled, which is what gets flushed
+           below. Compared to joining the rectangles of individual icons it
+           includes also the layers they were placed to, so an array glyph
+           cache uploads only the slices it needs to. */
+        const Containers::Optional<Range3Di> updated = glyphCache.atlas().add(Containers::stridedArrayView(&imageSize, 1).broadcasted<0>(Implementation::IconCount), offsets);
+        if(!updated) {
             Error{} << "Ui::McssDarkStyle::apply(): cannot fit" << Implementation::IconCount << "icons into the glyph cache";
             return {};
         }
@@ -791,32 +802,27 @@ bool McssDarkStyle::doApply(UserInterface& ui, const StyleFeatures features, Plu
         const UnsignedInt iconFontId = shared.glyphCacheFontId(iconFont);
 
         /* Copy the image data */
-        Containers::StridedArrayView3D<const char> src = image->pixels();
+        Containers::StridedArrayView3D<const char> src = image.pixels();
         Containers::StridedArrayView4D<char> dst = glyphCache.image().pixels();
-        Range2Di updated;
         for(UnsignedInt i = 0; i != Implementation::IconCount; ++i) {
             Range2Di rectangle = Range2Di::fromSize(offsets[i].xy(),
                                                     imageSize);
             /* The Icon enum reserves 0 for an invalid glyph, so add 1 */
-            glyphCache.addGlyph(iconFontId, i + 1, {}, rectangle);
+            glyphCache.addGlyph(iconFontId, i + 1, {}, offsets[i].z(), rectangle);
 
-            /* Copy assuming all input images have the same pixel format */
             const Containers::Size3D size{
                 std::size_t(imageSize.y()),
                 std::size_t(imageSize.x()),
-                channelSize};
+                1};
             Utility::copy(
                 src.sliceSize({0, std::size_t(i*imageSize.x()), 0}, size),
                 dst[offsets[i].z()].sliceSize({std::size_t(offsets[i].y()),
                                                 std::size_t(offsets[i].x()),
                                                 0}, size));
-
-            /* Maintain a range that was updated in the glyph cache */
-            updated = Math::join(updated, rectangle);
         }
 
         /* Reflect the image data update to the actual GPU-side texture */
-        glyphCache.flushImage(updated);
+        glyphCache.flushImage(*updated);
     }
 
     /* Event layer */
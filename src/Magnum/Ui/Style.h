@@ -31,6 +31,8 @@
  * @m_since_latest
  */
 
+#include <Corrade/Containers/ArrayView.h>
+
 #include "Magnum/Ui/AbstractStyle.h"
 
 namespace Magnum { namespace Ui {
@@ -77,6 +79,44 @@ namespace Implementation {
 @m_since_latest
 */
 class MAGNUM_UI_EXPORT McssDarkStyle: public AbstractStyle {
+    public:
+        /**
+         * @brief Baked glyph cache data
+         * @m_since_latest
+         *
+         * Empty by default.
+         * @see @ref setGlyphCacheData()
+         */
+        Containers::ArrayView<const char> glyphCacheData() const {
+            return _glyphCacheData;
+        }
+
+        /**
+         * @brief Set baked glyph cache data
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * Expects @p data produced by @ref TextLayer::Shared::serializeGlyphCache()
+         * on a glyph cache this style was previously applied to with
+         * @ref StyleFeature::TextLayer, optionally together with
+         * @ref StyleFeature::TextLayerImages, with the same DPI scaling and no
+         * other fonts added to the cache. If non-empty and
+         * @ref StyleFeature::TextLayer is applied, the glyphs and icons are
+         * deserialized from @p data instead of rasterizing the font and
+         * copying the icon image. The font plugin is still loaded, as it's
+         * needed for text shaping. If the data can't be used, a message is
+         * printed to @relativeref{Magnum,Warning} and the glyph cache is
+         * filled from scratch.
+         *
+         * The data are copied to the glyph cache during @ref apply(), so the
+         * view, which can for example point to a memory-mapped file, only
+         * needs to stay in scope until then.
+         */
+        McssDarkStyle& setGlyphCacheData(Containers::ArrayView<const char> data) {
+            _glyphCacheData = data;
+            return *this;
+        }
+
     private:
         MAGNUM_UI_LOCAL StyleFeatures doFeatures() const override;
         MAGNUM_UI_LOCAL UnsignedInt doBaseLayerStyleUniformCount() const override;
@@ -87,6 +127,8 @@ class MAGNUM_UI_EXPORT McssDarkStyle: public AbstractStyle {
         MAGNUM_UI_LOCAL UnsignedInt doTextLayerEditingStyleCount() const override;
         MAGNUM_UI_LOCAL Vector3i doTextLayerGlyphCacheSize(StyleFeatures features) const override;
         MAGNUM_UI_LOCAL bool doApply(UserInterface& ui, StyleFeatures features, PluginManager::Manager<Trade::AbstractImporter>* importerManager, PluginManager::Manager<Text::AbstractFont>* fontManager) const override;
+
+        Containers::ArrayView<const char> _glyphCacheData;
 };
 
 }}
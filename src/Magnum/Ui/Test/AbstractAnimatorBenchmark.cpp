@@ -0,0 +1,340 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Containers/BitArray.h>
+#include <Corrade/Containers/BitArrayView.h>
+#include <Corrade/Containers/Iterable.h>
+#include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Animation/Easing.h>
+#include <Magnum/Math/Time.h>
+#include <Magnum/Text/AbstractFont.h>
+#include <Magnum/Text/AbstractGlyphCache.h>
+#include <Magnum/Text/AbstractShaper.h>
+#include <Magnum/Text/Alignment.h>
+
+#include "Magnum/Ui/BaseLayer.h"
+#include "Magnum/Ui/BaseLayerAnimator.h"
+#include "Magnum/Ui/GenericAnimator.h"
+#include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/TextLayer.h"
+#include "Magnum/Ui/TextLayerAnimator.h"
+#include "Magnum/Ui/TextProperties.h"
+
+namespace Magnum { namespace Ui { namespace Test { namespace {
+
+struct AbstractAnimatorBenchmark: TestSuite::Tester {
+    explicit AbstractAnimatorBenchmark();
+
+    void createRemove();
+    void updateAdvance();
+
+    void baseLayerStyleAdvance();
+    void textLayerStyleAdvance();
+};
+
+using namespace Math::Literals;
+
+const struct {
+    const char* name;
+    UnsignedInt count;
+} CountData[]{
+    {"1k animations", 1000},
+    {"10k animations", 10000},
+    {"100k animations", 100000},
+};
+
+const struct {
+    const char* name;
+    AnimationState state;
+    UnsignedInt count;
+} UpdateAdvanceData[]{
+    {"1k playing", AnimationState::Playing, 1000},
+    {"10k playing", AnimationState::Playing, 10000},
+    {"100k playing", AnimationState::Playing, 100000},
+    {"1k scheduled", AnimationState::Scheduled, 1000},
+    {"10k scheduled", AnimationState::Scheduled, 10000},
+    {"100k scheduled", AnimationState::Scheduled, 100000},
+    {"1k stopped", AnimationState::Stopped, 1000},
+    {"10k stopped", AnimationState::Stopped, 10000},
+    {"100k stopped", AnimationState::Stopped, 100000},
+};
+
+/* The whole dynamic style pool is used by the animations */
+const struct {
+    const char* name;
+    UnsignedInt count;
+} StyleAdvanceData[]{
+    {"100 animations", 100},
+    {"1k animations", 1000},
+    {"10k animations", 10000},
+};
+
+AbstractAnimatorBenchmark::AbstractAnimatorBenchmark() {
+    addInstancedBenchmarks({&AbstractAnimatorBenchmark::createRemove}, 10,
+        Containers::arraySize(CountData));
+
+    addInstancedBenchmarks({&AbstractAnimatorBenchmark::updateAdvance}, 10,
+        Containers::arraySize(UpdateAdvanceData));
+
+    addInstancedBenchmarks({&AbstractAnimatorBenchmark::baseLayerStyleAdvance,
+                            &AbstractAnimatorBenchmark::textLayerStyleAdvance}, 10,
+        Containers::arraySize(StyleAdvanceData));
+}
+
+void AbstractAnimatorBenchmark::createRemove() {
+    auto&& data = CountData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Measuring just the base class bookkeeping, without any per-animation
+       storage an animator subclass would have */
+    struct: AbstractAnimator {
+        using AbstractAnimator::AbstractAnimator;
+        using AbstractAnimator::create;
+        using AbstractAnimator::remove;
+
+        AnimatorFeatures doFeatures() const override { return {}; }
+    } animator{animatorHandle(0, 1)};
+
+    Containers::Array<AnimationHandle> handles{NoInit, data.count};
+
+    /* The first round is done outside of the benchmark loop in order to
+       measure just reuse of the already allocated capacity and not the
+       growth */
+    for(UnsignedInt i = 0; i != data.count; ++i)
+        handles[i] = animator.create(0_nsec, 10_nsec);
+    for(UnsignedInt i = 0; i != data.count; ++i)
+        animator.remove(handles[i]);
+
+    CORRADE_BENCHMARK(5) {
+        for(UnsignedInt i = 0; i != data.count; ++i)
+            handles[i] = animator.create(0_nsec, 10_nsec);
+        for(UnsignedInt i = 0; i != data.count; ++i)
+            animator.remove(handles[i]);
+    }
+
+    CORRADE_COMPARE(animator.usedCount(), 0);
+    CORRADE_COMPARE(animator.capacity(), data.count);
+}
+
+void AbstractAnimatorBenchmark::updateAdvance() {
+    auto&& data = UpdateAdvanceData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    GenericAnimator animator{animatorHandle(0, 1)};
+
+    /* The animations are checked at times 100 to at most 150 nanoseconds.
+       Scheduled animations start after that, stopped end before that and are
+       kept so they still occupy the capacity, playing animations span the
+       whole range. */
+    Nanoseconds played;
+    Nanoseconds duration;
+    AnimationFlags flags;
+    if(data.state == AnimationState::Playing) {
+        played = 0_nsec;
+        duration = 1000_nsec;
+    } else if(data.state == AnimationState::Scheduled) {
+        played = 1000_nsec;
+        duration = 1000_nsec;
+    } else if(data.state == AnimationState::Stopped) {
+        played = 0_nsec;
+        duration = 10_nsec;
+        flags = AnimationFlag::KeepOncePlayed;
+    } else CORRADE_INTERNAL_ASSERT_UNREACHABLE();
+
+    Float sum = 0.0f;
+    for(UnsignedInt i = 0; i != data.count; ++i)
+        animator.create([&sum](Float factor) {
+            sum += factor;
+        }, Animation::Easing::linear, played, duration, 1, flags);
+
+    Containers::BitArray active{NoInit, animator.capacity()};
+    Containers::Array<Float> factors{NoInit, animator.capacity()};
+    Containers::BitArray remove{NoInit, animator.capacity()};
+
+    /* Make the animator go through all animations once so the benchmark
+       measures the steady state */
+    Nanoseconds time = 100_nsec;
+    if(animator.update(time, active, factors, remove).first())
+        animator.advance(active, factors);
+
+    std::size_t advancedCount = 0;
+    CORRADE_BENCHMARK(5) {
+        time += 1_nsec;
+        if(animator.update(time, active, factors, remove).first()) {
+            animator.advance(active, factors);
+            ++advancedCount;
+        }
+    }
+
+    CORRADE_COMPARE(advancedCount, data.state == AnimationState::Playing ? 5 : 0);
+    CORRADE_COMPARE(animator.usedCount(), data.count);
+    CORRADE_VERIFY(sum >= 0.0f);
+}
+
+void AbstractAnimatorBenchmark::baseLayerStyleAdvance() {
+    auto&& data = StyleAdvanceData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    struct LayerShared: BaseLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): BaseLayer::Shared{configuration} {}
+
+        void doSetStyle(const BaseLayerCommonStyleUniform&, Containers::ArrayView<const BaseLayerStyleUniform>) override {}
+    } shared{BaseLayer::Shared::Configuration{2}
+        .setDynamicStyleCount(data.count)
+    };
+    shared.setStyle(
+        BaseLayerCommonStyleUniform{},
+        {BaseLayerStyleUniform{}
+            .setColor(Color4{0.25f})
+            .setOutlineWidth(Vector4{1.0f}),
+         BaseLayerStyleUniform{}
+            .setColor(Color4{0.75f})
+            .setOutlineWidth(Vector4{3.0f})},
+        {{}, Vector4{2.0f}});
+
+    BaseLayer layer{layerHandle(0, 1), shared};
+
+    BaseLayerStyleAnimator animator{animatorHandle(0, 1)};
+    layer.assignAnimator(animator);
+
+    for(UnsignedInt i = 0; i != data.count; ++i)
+        animator.create(0, 1, Animation::Easing::linear, 0_nsec, 1000_nsec, layer.create(0));
+
+    Containers::BitArray activeStorage{NoInit, animator.capacity()};
+    Containers::Array<Float> factorStorage{NoInit, animator.capacity()};
+    Containers::BitArray removeStorage{NoInit, animator.capacity()};
+
+    /* The first advance allocates the dynamic styles, do it outside of the
+       benchmark loop to measure just the interpolation */
+    Nanoseconds time = 100_nsec;
+    layer.advanceAnimations(time, activeStorage, factorStorage, removeStorage, {animator});
+    CORRADE_COMPARE(layer.dynamicStyleUsedCount(), data.count);
+
+    CORRADE_BENCHMARK(5) {
+        time += 1_nsec;
+        layer.advanceAnimations(time, activeStorage, factorStorage, removeStorage, {animator});
+    }
+
+    CORRADE_COMPARE(layer.dynamicStyleUsedCount(), data.count);
+    CORRADE_COMPARE(layer.dynamicStyleUniforms()[0].topColor, Color4{0.3025f});
+}
+
+struct EmptyShaper: Text::AbstractShaper {
+    using Text::AbstractShaper::AbstractShaper;
+
+    UnsignedInt doShape(Containers::StringView, UnsignedInt, UnsignedInt, Containers::ArrayView<const Text::FeatureRange>) override {
+        return 0;
+    }
+    void doGlyphIdsInto(const Containers::StridedArrayView1D<UnsignedInt>&) const override {}
+    void doGlyphOffsetsAdvancesInto(const Containers::StridedArrayView1D<Vector2>&, const Containers::StridedArrayView1D<Vector2>&) const override {}
+    void doGlyphClustersInto(const Containers::StridedArrayView1D<UnsignedInt>&) const override {}
+};
+
+void AbstractAnimatorBenchmark::textLayerStyleAdvance() {
+    auto&& data = StyleAdvanceData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return true; }
+        void doClose() override {}
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<EmptyShaper>(*this); }
+    } font;
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
+    cache.addFont(67, &font);
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{2}
+        .setDynamicStyleCount(data.count)
+    };
+    shared.setGlyphCache(cache);
+
+    FontHandle fontHandle = shared.addFont(font, 1.0f);
+
+    shared.setStyle(
+        TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}
+            .setColor(Color4{0.25f}),
+         TextLayerStyleUniform{}
+            .setColor(Color4{0.75f})},
+        {0, 1},
+        {fontHandle, fontHandle},
+        {Text::Alignment::MiddleCenter,
+         Text::Alignment::MiddleCenter},
+        {}, {}, {},
+        {-1, -1},
+        {-1, -1},
+        {{}, Vector4{2.0f}});
+
+    TextLayer layer{layerHandle(0, 1), shared};
+
+    TextLayerStyleAnimator animator{animatorHandle(0, 1)};
+    layer.assignAnimator(animator);
+
+    for(UnsignedInt i = 0; i != data.count; ++i)
+        animator.create(0, 1, Animation::Easing::linear, 0_nsec, 1000_nsec, layer.create(0, "", {}));
+
+    Containers::BitArray activeStorage{NoInit, animator.capacity()};
+    Containers::Array<Float> factorStorage{NoInit, animator.capacity()};
+    Containers::BitArray removeStorage{NoInit, animator.capacity()};
+
+    /* The first advance allocates the dynamic styles, do it outside of the
+       benchmark loop to measure just the interpolation */
+    Nanoseconds time = 100_nsec;
+    layer.advanceAnimations(time, activeStorage, factorStorage, removeStorage, {animator});
+    CORRADE_COMPARE(layer.dynamicStyleUsedCount(), data.count);
+
+    CORRADE_BENCHMARK(5) {
+        time += 1_nsec;
+        layer.advanceAnimations(time, activeStorage, factorStorage, removeStorage, {animator});
+    }
+
+    CORRADE_COMPARE(layer.dynamicStyleUsedCount(), data.count);
+    CORRADE_COMPARE(layer.dynamicStyleUniforms()[0].color, Color4{0.3025f});
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Ui::Test::AbstractAnimatorBenchmark)
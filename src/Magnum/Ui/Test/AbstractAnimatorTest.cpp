@@ -34,6 +34,7 @@
 #include <Corrade/Containers/StringStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Compare/String.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/Format.h>
@@ -44,6 +45,7 @@
 #include "Magnum/Ui/AbstractAnimator.h"
 #include "Magnum/Ui/AbstractLayer.h"
 #include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/MemoryUsage.h"
 #include "Magnum/Ui/NodeFlags.h"
 
 namespace Magnum { namespace Ui { namespace Test { namespace {
@@ -90,6 +92,8 @@ struct AbstractAnimatorTest: TestSuite::Tester {
     void createNoHandlesLeft();
     void createInvalid();
     void createNodeAttachment();
+    void reserve();
+    void memoryUsage();
     void createNodeAttachmentInvalidFeatures();
     void createDataAttachment();
     void createDataAttachmentNoLayerSet();
@@ -130,8 +134,13 @@ struct AbstractAnimatorTest: TestSuite::Tester {
 
     void update();
     void updateEmpty();
+    void updateIdle();
     void updateInvalid();
 
+    void nextAdvanceTime();
+    void nextAdvanceTimeEmpty();
+    void advanceIntervalInvalid();
+
     void advanceGeneric();
     void advanceGenericInvalid();
     void advanceNode();
@@ -364,6 +373,8 @@ AbstractAnimatorTest::AbstractAnimatorTest() {
               &AbstractAnimatorTest::createNoHandlesLeft,
               &AbstractAnimatorTest::createInvalid,
               &AbstractAnimatorTest::createNodeAttachment,
+              &AbstractAnimatorTest::reserve,
+              &AbstractAnimatorTest::memoryUsage,
               &AbstractAnimatorTest::createNodeAttachmentInvalidFeatures,
               &AbstractAnimatorTest::createDataAttachment,
               &AbstractAnimatorTest::createDataAttachmentNoLayerSet,
@@ -411,8 +422,13 @@ AbstractAnimatorTest::AbstractAnimatorTest() {
 
     addTests({&AbstractAnimatorTest::update,
               &AbstractAnimatorTest::updateEmpty,
+              &AbstractAnimatorTest::updateIdle,
               &AbstractAnimatorTest::updateInvalid,
 
+              &AbstractAnimatorTest::nextAdvanceTime,
+              &AbstractAnimatorTest::nextAdvanceTimeEmpty,
+              &AbstractAnimatorTest::advanceIntervalInvalid,
+
               &AbstractAnimatorTest::advanceGeneric,
               &AbstractAnimatorTest::advanceGenericInvalid,
               &AbstractAnimatorTest::advanceNode,
@@ -453,8 +469,8 @@ void AbstractAnimatorTest::debugAnimationFlag() {
 
 void AbstractAnimatorTest::debugAnimationFlags() {
     std::ostringstream out;
-    Debug{&out} << (AnimationFlag::KeepOncePlayed|AnimationFlag(0xe0)) << AnimationFlags{};
-    CORRADE_COMPARE(out.str(), "Ui::AnimationFlag::KeepOncePlayed|Ui::AnimationFlag(0xe0) Ui::AnimationFlags{}\n");
+    Debug{&out} << (AnimationFlag::KeepOncePlayed|AnimationFlag::SkipWhenInvisible|AnimationFlag(0xe0)) << AnimationFlags{};
+    CORRADE_COMPARE(out.str(), "Ui::AnimationFlag::KeepOncePlayed|Ui::AnimationFlag::SkipWhenInvisible|Ui::AnimationFlag(0xe0) Ui::AnimationFlags{}\n");
 }
 
 void AbstractAnimatorTest::debugAnimationState() {
@@ -1004,27 +1020,27 @@ void AbstractAnimatorTest::createRemoveHandleRecycle() {
     animator.pause(first, 50_nsec);
     animator.stop(third, -30_nsec);
     if(data.features & AnimatorFeature::NodeAttachment) {
-        animator.attach(second, NodeHandle(0xabc12345));
-        animator.attach(fourth, NodeHandle(0x123abcde));
-        CORRADE_COMPARE(animator.node(second), NodeHandle(0xabc12345));
-        CORRADE_COMPARE(animator.node(fourth), NodeHandle(0x123abcde));
+        animator.attach(second, nodeHandle(0x12345, 0xabc));
+        animator.attach(fourth, nodeHandle(0xabcde, 0x123));
+        CORRADE_COMPARE(animator.node(second), nodeHandle(0x12345, 0xabc));
+        CORRADE_COMPARE(animator.node(fourth), nodeHandle(0xabcde, 0x123));
         CORRADE_COMPARE_AS(animator.nodes(), Containers::arrayView({
             NodeHandle::Null,
-            NodeHandle(0xabc12345),
+            nodeHandle(0x12345, 0xabc),
             NodeHandle::Null,
-            NodeHandle(0x123abcde)
+            nodeHandle(0xabcde, 0x123)
         }), TestSuite::Compare::Container);
     }
     if(data.features & AnimatorFeature::DataAttachment) {
-        animator.attach(second, LayerDataHandle(0xabc12345));
-        animator.attach(fourth, LayerDataHandle(0x123abcde));
-        CORRADE_COMPARE(dataHandleData(animator.data(second)), LayerDataHandle(0xabc12345));
-        CORRADE_COMPARE(dataHandleData(animator.data(fourth)), LayerDataHandle(0x123abcde));
+        animator.attach(second, layerDataHandle(0x12345, 0xabc));
+        animator.attach(fourth, layerDataHandle(0xabcde, 0x123));
+        CORRADE_COMPARE(dataHandleData(animator.data(second)), layerDataHandle(0x12345, 0xabc));
+        CORRADE_COMPARE(dataHandleData(animator.data(fourth)), layerDataHandle(0xabcde, 0x123));
         CORRADE_COMPARE_AS(animator.layerData(), Containers::arrayView({
             LayerDataHandle::Null,
-            LayerDataHandle(0xabc12345),
+            layerDataHandle(0x12345, 0xabc),
             LayerDataHandle::Null,
-            LayerDataHandle(0x123abcde)
+            layerDataHandle(0xabcde, 0x123)
         }), TestSuite::Compare::Container);
     }
 
@@ -1046,14 +1062,14 @@ void AbstractAnimatorTest::createRemoveHandleRecycle() {
     if(data.features & AnimatorFeature::NodeAttachment)
         CORRADE_COMPARE_AS(animator.nodes(), Containers::arrayView({
             NodeHandle::Null,
-            NodeHandle(0xabc12345),
+            nodeHandle(0x12345, 0xabc),
             NodeHandle::Null,
             NodeHandle::Null
         }), TestSuite::Compare::Container);
     if(data.features & AnimatorFeature::DataAttachment)
         CORRADE_COMPARE_AS(animator.layerData(), Containers::arrayView({
             LayerDataHandle::Null,
-            LayerDataHandle(0xabc12345),
+            layerDataHandle(0x12345, 0xabc),
             LayerDataHandle::Null,
             LayerDataHandle::Null
         }), TestSuite::Compare::Container);
@@ -1094,13 +1110,13 @@ void AbstractAnimatorTest::createRemoveHandleRecycle() {
     CORRADE_COMPARE(animator.stopped(fourth2), Nanoseconds::max());
     if(data.features & AnimatorFeature::NodeAttachment) {
         CORRADE_COMPARE(animator.node(first2), NodeHandle::Null);
-        CORRADE_COMPARE(animator.node(second), NodeHandle(0xabc12345));
+        CORRADE_COMPARE(animator.node(second), nodeHandle(0x12345, 0xabc));
         CORRADE_COMPARE(animator.node(third2), NodeHandle::Null);
         CORRADE_COMPARE(animator.node(fourth2), NodeHandle::Null);
     }
     if(data.features & AnimatorFeature::DataAttachment) {
         CORRADE_COMPARE(dataHandleData(animator.data(first2)), LayerDataHandle::Null);
-        CORRADE_COMPARE(dataHandleData(animator.data(second)), LayerDataHandle(0xabc12345));
+        CORRADE_COMPARE(dataHandleData(animator.data(second)), layerDataHandle(0x12345, 0xabc));
         CORRADE_COMPARE(dataHandleData(animator.data(third2)), LayerDataHandle::Null);
         CORRADE_COMPARE(dataHandleData(animator.data(fourth2)), LayerDataHandle::Null);
     }
@@ -1217,8 +1233,13 @@ void AbstractAnimatorTest::createNoHandlesLeft() {
     animator.create(17_nsec, 65_nsec);
     /* Number is hardcoded in the expected message but not elsewhere in order
        to give a heads-up when modifying the handle ID bit count */
+    #ifndef MAGNUM_UI_LARGE_HANDLES
     CORRADE_COMPARE(out.str(),
         "Ui::AbstractAnimator::create(): can only have at most 1048576 animations\n");
+    #else
+    CORRADE_COMPARE(out.str(),
+        "Ui::AbstractAnimator::create(): can only have at most 16777216 animations\n");
+    #endif
 }
 
 void AbstractAnimatorTest::createInvalid() {
@@ -1254,24 +1275,24 @@ void AbstractAnimatorTest::createNodeAttachment() {
     } animator{animatorHandle(0, 1)};
 
     /* Default overload */
-    AnimationHandle first = animator.create(15_nsec, 37_nsec, NodeHandle(0xabcde123), 155, AnimationFlag::KeepOncePlayed);
+    AnimationHandle first = animator.create(15_nsec, 37_nsec, nodeHandle(0xde123, 0xabc), 155, AnimationFlag::KeepOncePlayed);
     CORRADE_COMPARE(animator.duration(first), 37_nsec);
     CORRADE_COMPARE(animator.repeatCount(first), 155);
     CORRADE_COMPARE(animator.flags(first), AnimationFlag::KeepOncePlayed);
     CORRADE_COMPARE(animator.played(first), 15_nsec);
     CORRADE_COMPARE(animator.paused(first), Nanoseconds::max());
     CORRADE_COMPARE(animator.stopped(first), Nanoseconds::max());
-    CORRADE_COMPARE(animator.node(first), NodeHandle(0xabcde123));
+    CORRADE_COMPARE(animator.node(first), nodeHandle(0xde123, 0xabc));
 
     /* Overload with implicit repeat count */
-    AnimationHandle second = animator.create(-655_nsec, 12_nsec, NodeHandle(0x12345abc), AnimationFlag(0xe0));
+    AnimationHandle second = animator.create(-655_nsec, 12_nsec, nodeHandle(0x45abc, 0x123), AnimationFlag(0xe0));
     CORRADE_COMPARE(animator.duration(second), 12_nsec);
     CORRADE_COMPARE(animator.repeatCount(second), 1);
     CORRADE_COMPARE(animator.flags(second), AnimationFlag(0xe0));
     CORRADE_COMPARE(animator.played(second), -655_nsec);
     CORRADE_COMPARE(animator.paused(second), Nanoseconds::max());
     CORRADE_COMPARE(animator.stopped(second), Nanoseconds::max());
-    CORRADE_COMPARE(animator.node(second), NodeHandle(0x12345abc));
+    CORRADE_COMPARE(animator.node(second), nodeHandle(0x45abc, 0x123));
 
     /* Null handles should be accepted too */
     AnimationHandle third = animator.create(12_nsec, 24_nsec, NodeHandle::Null, 0);
@@ -1290,13 +1311,82 @@ void AbstractAnimatorTest::createNodeAttachment() {
 
     /* The node attachments should be reflected here as well */
     CORRADE_COMPARE_AS(animator.nodes(), Containers::arrayView({
-        NodeHandle(0xabcde123),
-        NodeHandle(0x12345abc),
+        nodeHandle(0xde123, 0xabc),
+        nodeHandle(0x45abc, 0x123),
         NodeHandle::Null,
         NodeHandle::Null
     }), TestSuite::Compare::Container);
 }
 
+void AbstractAnimatorTest::reserve() {
+    struct: AbstractAnimator {
+        using AbstractAnimator::AbstractAnimator;
+        using AbstractAnimator::create;
+
+        AnimatorFeatures doFeatures() const override {
+            /* Reserves also the node attachment array */
+            return AnimatorFeature::NodeAttachment;
+        }
+        void doReserve(std::size_t capacity) override {
+            reserved = capacity;
+        }
+
+        std::size_t reserved = 0;
+    } animator{animatorHandle(0, 1)};
+
+    /* Reserving delegates to the implementation but doesn't make any new
+       handles available */
+    animator.reserve(35);
+    CORRADE_COMPARE(animator.reserved, 35);
+    CORRADE_COMPARE(animator.capacity(), 0);
+    CORRADE_COMPARE(animator.usedCount(), 0);
+
+    /* Creating works as before */
+    AnimationHandle first = animator.create(15_nsec, 37_nsec, nodeHandle(0xde123, 0xabc));
+    CORRADE_COMPARE(first, animationHandle(animator.handle(), 0, 1));
+    CORRADE_COMPARE(animator.capacity(), 1);
+    CORRADE_COMPARE(animator.usedCount(), 1);
+    CORRADE_COMPARE(animator.node(first), nodeHandle(0xde123, 0xabc));
+}
+
+void AbstractAnimatorTest::memoryUsage() {
+    struct: AbstractAnimator {
+        using AbstractAnimator::AbstractAnimator;
+        using AbstractAnimator::create;
+        using AbstractAnimator::remove;
+
+        AnimatorFeatures doFeatures() const override {
+            /* Counts also the node attachment array */
+            return AnimatorFeature::NodeAttachment;
+        }
+        void doMemoryUsage(MemoryUsage& usage) const override {
+            usage.cpuByteCount += 1000;
+            usage.gpuByteCount += 2000;
+        }
+    } animator{animatorHandle(0, 1)};
+
+    /* With nothing allocated, there's just what the subclass adds */
+    MemoryUsage empty = animator.memoryUsage();
+    CORRADE_COMPARE(empty.cpuByteCount, 1000);
+    CORRADE_COMPARE(empty.gpuByteCount, 2000);
+    CORRADE_COMPARE(empty.capacity, 0);
+    CORRADE_COMPARE(empty.usedCount, 0);
+
+    animator.create(15_nsec, 37_nsec, nodeHandle(0xde123, 0xabc));
+    AnimationHandle second = animator.create(15_nsec, 37_nsec, nodeHandle(0xde124, 0xabc));
+    animator.create(15_nsec, 37_nsec, nodeHandle(0xde125, 0xabc));
+    animator.remove(second);
+
+    /* The base storage is counted in addition, capacity and used count is the
+       same as the dedicated queries */
+    MemoryUsage usage = animator.memoryUsage();
+    CORRADE_COMPARE_AS(usage.cpuByteCount, 1000,
+        TestSuite::Compare::Greater);
+    CORRADE_COMPARE(usage.gpuByteCount, 2000);
+    CORRADE_COMPARE(usage.capacity, 3);
+    CORRADE_COMPARE(usage.usedCount, 2);
+}
+
 void AbstractAnimatorTest::createNodeAttachmentInvalidFeatures() {
     CORRADE_SKIP_IF_NO_ASSERT();
 
@@ -1344,44 +1434,44 @@ void AbstractAnimatorTest::createDataAttachment() {
     animator.setLayer(layer);
 
     /* Default overload */
-    AnimationHandle first = animator.create(15_nsec, 37_nsec, dataHandle(animator.layer(), LayerDataHandle(0xabcde123)), 155, AnimationFlag::KeepOncePlayed);
+    AnimationHandle first = animator.create(15_nsec, 37_nsec, dataHandle(animator.layer(), layerDataHandle(0xde123, 0xabc)), 155, AnimationFlag::KeepOncePlayed);
     CORRADE_COMPARE(animator.duration(first), 37_nsec);
     CORRADE_COMPARE(animator.repeatCount(first), 155);
     CORRADE_COMPARE(animator.flags(first), AnimationFlag::KeepOncePlayed);
     CORRADE_COMPARE(animator.played(first), 15_nsec);
     CORRADE_COMPARE(animator.paused(first), Nanoseconds::max());
     CORRADE_COMPARE(animator.stopped(first), Nanoseconds::max());
-    CORRADE_COMPARE(animator.data(first), dataHandle(animator.layer(), LayerDataHandle(0xabcde123)));
+    CORRADE_COMPARE(animator.data(first), dataHandle(animator.layer(), layerDataHandle(0xde123, 0xabc)));
 
     /* LayerDataHandle variant */
-    AnimationHandle second = animator.create(-37_nsec, 122_nsec, LayerDataHandle(0x123abcde), 12, AnimationFlag(0xc0));
+    AnimationHandle second = animator.create(-37_nsec, 122_nsec, layerDataHandle(0xabcde, 0x123), 12, AnimationFlag(0xc0));
     CORRADE_COMPARE(animator.duration(second), 122_nsec);
     CORRADE_COMPARE(animator.repeatCount(second), 12);
     CORRADE_COMPARE(animator.flags(second), AnimationFlag(0xc0));
     CORRADE_COMPARE(animator.played(second), -37_nsec);
     CORRADE_COMPARE(animator.paused(second), Nanoseconds::max());
     CORRADE_COMPARE(animator.stopped(second), Nanoseconds::max());
-    CORRADE_COMPARE(animator.data(second), dataHandle(animator.layer(), LayerDataHandle(0x123abcde)));
+    CORRADE_COMPARE(animator.data(second), dataHandle(animator.layer(), layerDataHandle(0xabcde, 0x123)));
 
     /* Overload with implicit repeat count */
-    AnimationHandle third = animator.create(-655_nsec, 12_nsec, dataHandle(animator.layer(), LayerDataHandle(0x12345abc)), AnimationFlag(0xe0));
+    AnimationHandle third = animator.create(-655_nsec, 12_nsec, dataHandle(animator.layer(), layerDataHandle(0x45abc, 0x123)), AnimationFlag(0xe0));
     CORRADE_COMPARE(animator.duration(third), 12_nsec);
     CORRADE_COMPARE(animator.repeatCount(third), 1);
     CORRADE_COMPARE(animator.flags(third), AnimationFlag(0xe0));
     CORRADE_COMPARE(animator.played(third), -655_nsec);
     CORRADE_COMPARE(animator.paused(third), Nanoseconds::max());
     CORRADE_COMPARE(animator.stopped(third), Nanoseconds::max());
-    CORRADE_COMPARE(animator.data(third), dataHandle(animator.layer(), LayerDataHandle(0x12345abc)));
+    CORRADE_COMPARE(animator.data(third), dataHandle(animator.layer(), layerDataHandle(0x45abc, 0x123)));
 
     /* LayerDataHandle variant */
-    AnimationHandle fourth = animator.create(3_nsec, 777_nsec, LayerDataHandle(0xabc12345), AnimationFlag(0x70));
+    AnimationHandle fourth = animator.create(3_nsec, 777_nsec, layerDataHandle(0x12345, 0xabc), AnimationFlag(0x70));
     CORRADE_COMPARE(animator.duration(fourth), 777_nsec);
     CORRADE_COMPARE(animator.repeatCount(fourth), 1);
     CORRADE_COMPARE(animator.flags(fourth), AnimationFlag(0x70));
     CORRADE_COMPARE(animator.played(fourth), 3_nsec);
     CORRADE_COMPARE(animator.paused(fourth), Nanoseconds::max());
     CORRADE_COMPARE(animator.stopped(fourth), Nanoseconds::max());
-    CORRADE_COMPARE(animator.data(fourth), dataHandle(animator.layer(), LayerDataHandle(0xabc12345)));
+    CORRADE_COMPARE(animator.data(fourth), dataHandle(animator.layer(), layerDataHandle(0x12345, 0xabc)));
 
     /* Null handles should be accepted too */
     AnimationHandle fifth1 = animator.create(12_nsec, 24_nsec, DataHandle::Null, 0);
@@ -1412,10 +1502,10 @@ void AbstractAnimatorTest::createDataAttachment() {
 
     /* The data attachments should be reflected here as well */
     CORRADE_COMPARE_AS(animator.layerData(), Containers::arrayView({
-        LayerDataHandle(0xabcde123),
-        LayerDataHandle(0x123abcde),
-        LayerDataHandle(0x12345abc),
-        LayerDataHandle(0xabc12345),
+        layerDataHandle(0xde123, 0xabc),
+        layerDataHandle(0xabcde, 0x123),
+        layerDataHandle(0x45abc, 0x123),
+        layerDataHandle(0x12345, 0xabc),
         LayerDataHandle::Null,
         LayerDataHandle::Null,
         LayerDataHandle::Null,
@@ -1530,11 +1620,11 @@ void AbstractAnimatorTest::removeInvalid() {
     Error redirectError{&out};
     animator.remove(AnimationHandle::Null);
     /* Valid animator, invalid data */
-    animator.remove(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
+    animator.remove(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)));
     /* Invalid animator, valid data */
     animator.remove(animationHandle(AnimatorHandle::Null, animationHandleData(handle)));
     /* AnimatorDataHandle directly */
-    animator.remove(AnimatorDataHandle(0x123abcde));
+    animator.remove(animatorDataHandle(0xabcde, 0x123));
     CORRADE_COMPARE_AS(out.str(),
         "Ui::AbstractAnimator::remove(): invalid handle Ui::AnimationHandle::Null\n"
         "Ui::AbstractAnimator::remove(): invalid handle Ui::AnimationHandle({0x0, 0x1}, {0xabcde, 0x123})\n"
@@ -1648,18 +1738,18 @@ void AbstractAnimatorTest::propertiesInvalid() {
     animator.state(AnimationHandle::Null);
     animator.factor(AnimationHandle::Null);
     /* Valid animator, invalid data */
-    animator.duration(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
-    animator.repeatCount(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
-    animator.setRepeatCount(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)), 0);
-    animator.flags(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
-    animator.setFlags(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)), {});
-    animator.addFlags(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)), {});
-    animator.clearFlags(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)), {});
-    animator.played(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
-    animator.paused(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
-    animator.stopped(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
-    animator.state(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
-    animator.factor(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
+    animator.duration(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)));
+    animator.repeatCount(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)));
+    animator.setRepeatCount(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)), 0);
+    animator.flags(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)));
+    animator.setFlags(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)), {});
+    animator.addFlags(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)), {});
+    animator.clearFlags(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)), {});
+    animator.played(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)));
+    animator.paused(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)));
+    animator.stopped(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)));
+    animator.state(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)));
+    animator.factor(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)));
     /* Invalid animator, valid data */
     animator.duration(animationHandle(AnimatorHandle::Null, animationHandleData(handle)));
     animator.repeatCount(animationHandle(AnimatorHandle::Null, animationHandleData(handle)));
@@ -1674,18 +1764,18 @@ void AbstractAnimatorTest::propertiesInvalid() {
     animator.state(animationHandle(AnimatorHandle::Null, animationHandleData(handle)));
     animator.factor(animationHandle(AnimatorHandle::Null, animationHandleData(handle)));
     /* AnimatorDataHandle directly */
-    animator.duration(AnimatorDataHandle(0x123abcde));
-    animator.repeatCount(AnimatorDataHandle(0x123abcde));
-    animator.setRepeatCount(AnimatorDataHandle(0x123abcde), 0);
-    animator.flags(AnimatorDataHandle(0x123abcde));
-    animator.setFlags(AnimatorDataHandle(0x123abcde), {});
-    animator.addFlags(AnimatorDataHandle(0x123abcde), {});
-    animator.clearFlags(AnimatorDataHandle(0x123abcde), {});
-    animator.played(AnimatorDataHandle(0x123abcde));
-    animator.paused(AnimatorDataHandle(0x123abcde));
-    animator.stopped(AnimatorDataHandle(0x123abcde));
-    animator.state(AnimatorDataHandle(0x123abcde));
-    animator.factor(AnimatorDataHandle(0x123abcde));
+    animator.duration(animatorDataHandle(0xabcde, 0x123));
+    animator.repeatCount(animatorDataHandle(0xabcde, 0x123));
+    animator.setRepeatCount(animatorDataHandle(0xabcde, 0x123), 0);
+    animator.flags(animatorDataHandle(0xabcde, 0x123));
+    animator.setFlags(animatorDataHandle(0xabcde, 0x123), {});
+    animator.addFlags(animatorDataHandle(0xabcde, 0x123), {});
+    animator.clearFlags(animatorDataHandle(0xabcde, 0x123), {});
+    animator.played(animatorDataHandle(0xabcde, 0x123));
+    animator.paused(animatorDataHandle(0xabcde, 0x123));
+    animator.stopped(animatorDataHandle(0xabcde, 0x123));
+    animator.state(animatorDataHandle(0xabcde, 0x123));
+    animator.factor(animatorDataHandle(0xabcde, 0x123));
     CORRADE_COMPARE_AS(out.str(),
         "Ui::AbstractAnimator::duration(): invalid handle Ui::AnimationHandle::Null\n"
         "Ui::AbstractAnimator::repeatCount(): invalid handle Ui::AnimationHandle::Null\n"
@@ -1822,14 +1912,14 @@ void AbstractAnimatorTest::attachNodeInvalid() {
     animator.attach(AnimationHandle::Null, nodeHandle(2865, 0xcec));
     animator.node(AnimationHandle::Null);
     /* Valid animator, invalid data */
-    animator.attach(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)), nodeHandle(2865, 0xcec));
-    animator.node(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
+    animator.attach(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)), nodeHandle(2865, 0xcec));
+    animator.node(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)));
     /* Invalid animator, valid data */
     animator.attach(animationHandle(AnimatorHandle::Null, animationHandleData(handle)), nodeHandle(2865, 0xcec));
     animator.node(animationHandle(AnimatorHandle::Null, animationHandleData(handle)));
     /* AnimatorDataHandle directly */
-    animator.attach(AnimatorDataHandle(0x123abcde), nodeHandle(2865, 0xcec));
-    animator.node(AnimatorDataHandle(0x123abcde));
+    animator.attach(animatorDataHandle(0xabcde, 0x123), nodeHandle(2865, 0xcec));
+    animator.node(animatorDataHandle(0xabcde, 0x123));
     CORRADE_COMPARE_AS(out.str(),
         "Ui::AbstractAnimator::attach(): invalid handle Ui::AnimationHandle::Null\n"
         "Ui::AbstractAnimator::node(): invalid handle Ui::AnimationHandle::Null\n"
@@ -1992,17 +2082,17 @@ void AbstractAnimatorTest::attachDataInvalid() {
     animator.attach(AnimationHandle::Null, layerDataHandle(2865, 0xcec));
     animator.data(AnimationHandle::Null);
     /* Valid animator, invalid data */
-    animator.attach(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)), dataHandle(animator.layer(), 2865, 0xcec));
-    animator.attach(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)), layerDataHandle(2865, 0xcec));
-    animator.data(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
+    animator.attach(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)), dataHandle(animator.layer(), 2865, 0xcec));
+    animator.attach(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)), layerDataHandle(2865, 0xcec));
+    animator.data(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)));
     /* Invalid animator, valid data */
     animator.attach(animationHandle(AnimatorHandle::Null, animationHandleData(handle)), dataHandle(animator.layer(), 2865, 0xcec));
     animator.attach(animationHandle(AnimatorHandle::Null, animationHandleData(handle)), layerDataHandle(2865, 0xcec));
     animator.data(animationHandle(AnimatorHandle::Null, animationHandleData(handle)));
     /* AnimatorDataHandle directly */
-    animator.attach(AnimatorDataHandle(0x123abcde), dataHandle(animator.layer(), 2865, 0xcec));
-    animator.attach(AnimatorDataHandle(0x123abcde), layerDataHandle(2865, 0xcec));
-    animator.data(AnimatorDataHandle(0x123abcde));
+    animator.attach(animatorDataHandle(0xabcde, 0x123), dataHandle(animator.layer(), 2865, 0xcec));
+    animator.attach(animatorDataHandle(0xabcde, 0x123), layerDataHandle(2865, 0xcec));
+    animator.data(animatorDataHandle(0xabcde, 0x123));
     CORRADE_COMPARE_AS(out.str(),
         "Ui::AbstractAnimator::attach(): invalid handle Ui::AnimationHandle::Null\n"
         "Ui::AbstractAnimator::attach(): invalid handle Ui::AnimationHandle::Null\n"
@@ -2741,17 +2831,17 @@ void AbstractAnimatorTest::playPauseStopInvalid() {
     animator.pause(AnimationHandle::Null, 0_nsec);
     animator.stop(AnimationHandle::Null, 0_nsec);
     /* Valid animator, invalid data */
-    animator.play(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)), 0_nsec);
-    animator.pause(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)), 0_nsec);
-    animator.stop(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)), 0_nsec);
+    animator.play(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)), 0_nsec);
+    animator.pause(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)), 0_nsec);
+    animator.stop(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)), 0_nsec);
     /* Invalid animator, valid data */
     animator.play(animationHandle(AnimatorHandle::Null, animationHandleData(handle)), 0_nsec);
     animator.pause(animationHandle(AnimatorHandle::Null, animationHandleData(handle)), 0_nsec);
     animator.stop(animationHandle(AnimatorHandle::Null, animationHandleData(handle)), 0_nsec);
     /* AnimatorDataHandle directly */
-    animator.play(AnimatorDataHandle(0x123abcde), 0_nsec);
-    animator.pause(AnimatorDataHandle(0x123abcde), 0_nsec);
-    animator.stop(AnimatorDataHandle(0x123abcde), 0_nsec);
+    animator.play(animatorDataHandle(0xabcde, 0x123), 0_nsec);
+    animator.pause(animatorDataHandle(0xabcde, 0x123), 0_nsec);
+    animator.stop(animatorDataHandle(0xabcde, 0x123), 0_nsec);
     CORRADE_COMPARE_AS(out.str(),
         "Ui::AbstractAnimator::play(): invalid handle Ui::AnimationHandle::Null\n"
         "Ui::AbstractAnimator::pause(): invalid handle Ui::AnimationHandle::Null\n"
@@ -3351,6 +3441,79 @@ void AbstractAnimatorTest::updateEmpty() {
     CORRADE_COMPARE(animator.state(), AnimatorStates{});
 }
 
+void AbstractAnimatorTest::updateIdle() {
+    /* Scheduled and paused animations aren't looked at in update() until
+       they can change state. Verify that they're looked at again if they get
+       modified or removed in the meantime. */
+
+    struct: AbstractAnimator {
+        using AbstractAnimator::AbstractAnimator;
+        using AbstractAnimator::create;
+        using AbstractAnimator::remove;
+
+        AnimatorFeatures doFeatures() const override { return {}; }
+    } animator{animatorHandle(0, 1)};
+
+    AnimationHandle scheduled1 = animator.create(100_nsec, 10_nsec);
+    AnimationHandle playing = animator.create(0_nsec, 50_nsec);
+    AnimationHandle scheduled2 = animator.create(200_nsec, 10_nsec);
+
+    Containers::BitArray active{NoInit, 3};
+    Containers::BitArray remove{NoInit, 3};
+    Float factors[3];
+
+    CORRADE_COMPARE(animator.update(10_nsec, active, factors, remove), Containers::pair(true, false));
+    CORRADE_COMPARE_AS(active, Containers::stridedArrayView({
+        false, true, false
+    }).sliceBit(0), TestSuite::Compare::Container);
+    CORRADE_COMPARE(factors[1], 0.2f);
+    CORRADE_COMPARE(animator.state(), AnimatorState::NeedsAdvance);
+
+    /* Playing the second scheduled animation earlier than the first makes it
+       picked up even though it's before the time originally calculated */
+    animator.play(scheduled2, 20_nsec);
+    CORRADE_COMPARE(animator.update(25_nsec, active, factors, remove), Containers::pair(true, false));
+    CORRADE_COMPARE_AS(active, Containers::stridedArrayView({
+        false, true, true
+    }).sliceBit(0), TestSuite::Compare::Container);
+    CORRADE_COMPARE(factors[1], 0.5f);
+    CORRADE_COMPARE(factors[2], 0.5f);
+    CORRADE_COMPARE(animator.state(), AnimatorState::NeedsAdvance);
+
+    /* Removing the first scheduled animation doesn't make it considered
+       anymore */
+    animator.remove(scheduled1);
+    CORRADE_COMPARE(animator.update(35_nsec, active, factors, remove), Containers::pair(true, true));
+    CORRADE_COMPARE_AS(active, Containers::stridedArrayView({
+        false, true, true
+    }).sliceBit(0), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(remove, Containers::stridedArrayView({
+        false, false, true
+    }).sliceBit(0), TestSuite::Compare::Container);
+    CORRADE_COMPARE(factors[1], 0.7f);
+    CORRADE_COMPARE(factors[2], 1.0f);
+    CORRADE_COMPARE(animator.state(), AnimatorState::NeedsAdvance);
+
+    /* Once the playing animation stops, there's nothing left to advance */
+    animator.remove(scheduled2);
+    CORRADE_COMPARE(animator.update(60_nsec, active, factors, remove), Containers::pair(true, true));
+    CORRADE_COMPARE_AS(active, Containers::stridedArrayView({
+        false, true, false
+    }).sliceBit(0), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(remove, Containers::stridedArrayView({
+        false, true, false
+    }).sliceBit(0), TestSuite::Compare::Container);
+    CORRADE_COMPARE(factors[1], 1.0f);
+    CORRADE_COMPARE(animator.state(), AnimatorStates{});
+
+    /* A stopped animation not yet removed is reported again */
+    CORRADE_COMPARE(animator.update(70_nsec, active, factors, remove), Containers::pair(false, true));
+    CORRADE_COMPARE_AS(remove, Containers::stridedArrayView({
+        false, true, false
+    }).sliceBit(0), TestSuite::Compare::Container);
+    CORRADE_VERIFY(animator.isHandleValid(playing));
+}
+
 void AbstractAnimatorTest::updateInvalid() {
     CORRADE_SKIP_IF_NO_ASSERT();
 
@@ -3392,6 +3555,89 @@ void AbstractAnimatorTest::updateInvalid() {
         TestSuite::Compare::String);
 }
 
+void AbstractAnimatorTest::nextAdvanceTime() {
+    struct: AbstractAnimator {
+        using AbstractAnimator::AbstractAnimator;
+        using AbstractAnimator::create;
+        using AbstractAnimator::remove;
+
+        AnimatorFeatures doFeatures() const override { return {}; }
+    } animator{animatorHandle(0, 1)};
+    CORRADE_COMPARE(animator.advanceInterval(), 0_nsec);
+
+    /* Scheduled animation needs an advance once it starts playing */
+    animator.create(100_nsec, 50_nsec);
+    CORRADE_COMPARE(animator.nextAdvanceTime(), 100_nsec);
+
+    /* Playing animation needs an advance every frame by default */
+    AnimationHandle playing = animator.create(0_nsec, 1000_nsec, 0);
+    CORRADE_COMPARE(animator.nextAdvanceTime(), 0_nsec);
+
+    /* With an interval it's after the interval passes */
+    animator.setAdvanceInterval(30_nsec);
+    CORRADE_COMPARE(animator.advanceInterval(), 30_nsec);
+    CORRADE_COMPARE(animator.nextAdvanceTime(), 30_nsec);
+
+    /* But if the animation finishes playing before, it's the finish time */
+    animator.remove(playing);
+    animator.create(0_nsec, 20_nsec);
+    CORRADE_COMPARE(animator.nextAdvanceTime(), 20_nsec);
+
+    /* Or when it gets stopped or paused */
+    AnimationHandle stopped = animator.create(0_nsec, 1000_nsec);
+    animator.stop(stopped, 15_nsec);
+    CORRADE_COMPARE(animator.nextAdvanceTime(), 15_nsec);
+    AnimationHandle paused = animator.create(0_nsec, 1000_nsec);
+    animator.pause(paused, 10_nsec);
+    CORRADE_COMPARE(animator.nextAdvanceTime(), 10_nsec);
+
+    /* After an update, the finished and stopped animation aren't taken into
+       account anymore, the paused needs an advance only once it's stopped,
+       which is never */
+    CORRADE_COMPARE(animator.capacity(), 4);
+    Containers::BitArray mask{NoInit, 4};
+    Float factors[4];
+    animator.update(25_nsec, mask, factors, mask);
+    CORRADE_COMPARE(animator.state(paused), AnimationState::Paused);
+    CORRADE_COMPARE(animator.nextAdvanceTime(), 100_nsec);
+
+    animator.stop(paused, 70_nsec);
+    CORRADE_COMPARE(animator.nextAdvanceTime(), 70_nsec);
+
+    /* Once the scheduled animation plays, it's the interval again */
+    animator.update(120_nsec, mask, factors, mask);
+    CORRADE_COMPARE(animator.nextAdvanceTime(), 150_nsec);
+
+    /* And after everything is stopped there's nothing to advance */
+    animator.update(200_nsec, mask, factors, mask);
+    CORRADE_COMPARE(animator.nextAdvanceTime(), Nanoseconds::max());
+}
+
+void AbstractAnimatorTest::nextAdvanceTimeEmpty() {
+    struct: AbstractAnimator {
+        using AbstractAnimator::AbstractAnimator;
+
+        AnimatorFeatures doFeatures() const override { return {}; }
+    } animator{animatorHandle(0, 1)};
+
+    CORRADE_COMPARE(animator.nextAdvanceTime(), Nanoseconds::max());
+}
+
+void AbstractAnimatorTest::advanceIntervalInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractAnimator {
+        using AbstractAnimator::AbstractAnimator;
+
+        AnimatorFeatures doFeatures() const override { return {}; }
+    } animator{animatorHandle(0, 1)};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    animator.setAdvanceInterval(-1_nsec);
+    CORRADE_COMPARE(out.str(), "Ui::AbstractAnimator::setAdvanceInterval(): expected non-negative interval, got Nanoseconds(-1)\n");
+}
+
 void AbstractAnimatorTest::advanceGeneric() {
     struct: AbstractGenericAnimator {
         using AbstractGenericAnimator::AbstractGenericAnimator;
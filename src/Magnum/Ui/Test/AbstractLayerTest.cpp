@@ -26,6 +26,7 @@
 
 #include <sstream>
 #include <Corrade/Containers/BitArrayView.h>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Iterable.h>
 #include <Corrade/Containers/StridedArrayView.h>
@@ -33,8 +34,10 @@
 #include <Corrade/Containers/StringStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Compare/String.h>
 #include <Corrade/Utility/DebugStl.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Math/Time.h>
 #include <Magnum/Math/Vector2.h>
 
@@ -43,6 +46,7 @@
 #include "Magnum/Ui/AbstractRenderer.h"
 #include "Magnum/Ui/Event.h"
 #include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/MemoryUsage.h"
 
 namespace Magnum { namespace Ui { namespace Test { namespace {
 
@@ -67,14 +71,25 @@ struct AbstractLayerTest: TestSuite::Tester {
 
     void setNeedsUpdate();
     void setNeedsUpdateInvalid();
+    void setNeedsDataUpdateInvalid();
 
     void createRemove();
     void createRemoveHandleRecycle();
     void createRemoveHandleDisable();
     void createNoHandlesLeft();
     void createAttached();
+    void createRemoveMultiple();
+    void reserve();
+    void memoryUsage();
+    void compact();
+    void compactDisabledHandles();
+    void compactDataAnimators();
+    void compactDataAnimatorsReleased();
+    void compactInvalid();
+    void createRemoveMultipleInvalid();
     void removeInvalid();
     void attach();
+    void attachNodeData();
     void attachInvalid();
 
     void setSize();
@@ -119,6 +134,7 @@ struct AbstractLayerTest: TestSuite::Tester {
     void update();
     void updateComposite();
     void updateEmpty();
+    void updateModifiedData();
     void updateNotImplemented();
     void updateStateFiltering();
     void updateInvalidState();
@@ -134,6 +150,11 @@ struct AbstractLayerTest: TestSuite::Tester {
     void compositeNotImplemented();
     void compositeInvalidSizes();
 
+    void intrinsicSizes();
+    void intrinsicSizesAttach();
+    void intrinsicSizesNotSupported();
+    void intrinsicSizesNotImplemented();
+
     void draw();
     void drawEmpty();
     void drawNotSupported();
@@ -231,14 +252,25 @@ AbstractLayerTest::AbstractLayerTest() {
         Containers::arraySize(StateQuerySetNeedsUpdateData));
 
     addTests({&AbstractLayerTest::setNeedsUpdateInvalid,
+              &AbstractLayerTest::setNeedsDataUpdateInvalid,
 
               &AbstractLayerTest::createRemove,
               &AbstractLayerTest::createRemoveHandleRecycle,
               &AbstractLayerTest::createRemoveHandleDisable,
               &AbstractLayerTest::createNoHandlesLeft,
               &AbstractLayerTest::createAttached,
+              &AbstractLayerTest::createRemoveMultiple,
+              &AbstractLayerTest::reserve,
+              &AbstractLayerTest::memoryUsage,
+              &AbstractLayerTest::compact,
+              &AbstractLayerTest::compactDisabledHandles,
+              &AbstractLayerTest::compactDataAnimators,
+              &AbstractLayerTest::compactDataAnimatorsReleased,
+              &AbstractLayerTest::compactInvalid,
+              &AbstractLayerTest::createRemoveMultipleInvalid,
               &AbstractLayerTest::removeInvalid,
               &AbstractLayerTest::attach,
+              &AbstractLayerTest::attachNodeData,
               &AbstractLayerTest::attachInvalid,
 
               &AbstractLayerTest::setSize,
@@ -283,6 +315,7 @@ AbstractLayerTest::AbstractLayerTest() {
               &AbstractLayerTest::update,
               &AbstractLayerTest::updateComposite,
               &AbstractLayerTest::updateEmpty,
+              &AbstractLayerTest::updateModifiedData,
               &AbstractLayerTest::updateNotImplemented});
 
     addInstancedTests({&AbstractLayerTest::updateStateFiltering},
@@ -302,6 +335,11 @@ AbstractLayerTest::AbstractLayerTest() {
               &AbstractLayerTest::compositeNotImplemented,
               &AbstractLayerTest::compositeInvalidSizes,
 
+              &AbstractLayerTest::intrinsicSizes,
+              &AbstractLayerTest::intrinsicSizesAttach,
+              &AbstractLayerTest::intrinsicSizesNotSupported,
+              &AbstractLayerTest::intrinsicSizesNotImplemented,
+
               &AbstractLayerTest::draw,
               &AbstractLayerTest::drawEmpty,
               &AbstractLayerTest::drawNotSupported,
@@ -347,8 +385,8 @@ void AbstractLayerTest::debugFeature() {
 
 void AbstractLayerTest::debugFeatures() {
     std::ostringstream out;
-    Debug{&out} << (LayerFeature::Draw|LayerFeature(0x80)) << LayerFeatures{};
-    CORRADE_COMPARE(out.str(), "Ui::LayerFeature::Draw|Ui::LayerFeature(0x80) Ui::LayerFeatures{}\n");
+    Debug{&out} << (LayerFeature::Event|LayerFeature(0x02)) << LayerFeatures{};
+    CORRADE_COMPARE(out.str(), "Ui::LayerFeature::Event|Ui::LayerFeature(0x2) Ui::LayerFeatures{}\n");
 }
 
 void AbstractLayerTest::debugFeaturesSupersets() {
@@ -598,6 +636,27 @@ void AbstractLayerTest::setNeedsUpdateInvalid() {
         TestSuite::Compare::String);
 }
 
+void AbstractLayerTest::setNeedsDataUpdateInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+        using AbstractLayer::create;
+        using AbstractLayer::setNeedsDataUpdate;
+
+        LayerFeatures doFeatures() const override { return {}; }
+    } layer{layerHandle(0, 1)};
+
+    layer.create();
+    layer.create();
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    layer.setNeedsDataUpdate(2);
+    CORRADE_COMPARE(out.str(),
+        "Ui::AbstractLayer::setNeedsDataUpdate(): index 2 out of range for 2 data\n");
+}
+
 void AbstractLayerTest::createRemove() {
     struct: AbstractLayer {
         using AbstractLayer::AbstractLayer;
@@ -669,14 +728,14 @@ void AbstractLayerTest::createRemoveHandleRecycle() {
     CORRADE_COMPARE(layer.node(fourth), NodeHandle::Null);
 
     /* Attach some handles to an arbitrary node to populate their internals */
-    layer.attach(first, NodeHandle(0xabc12345));
-    layer.attach(third, NodeHandle(0x123abcde));
-    CORRADE_COMPARE(layer.node(first), NodeHandle(0xabc12345));
-    CORRADE_COMPARE(layer.node(third), NodeHandle(0x123abcde));
+    layer.attach(first, nodeHandle(0x12345, 0xabc));
+    layer.attach(third, nodeHandle(0xabcde, 0x123));
+    CORRADE_COMPARE(layer.node(first), nodeHandle(0x12345, 0xabc));
+    CORRADE_COMPARE(layer.node(third), nodeHandle(0xabcde, 0x123));
     CORRADE_COMPARE_AS(layer.nodes(), Containers::arrayView({
-        NodeHandle(0xabc12345),
+        nodeHandle(0x12345, 0xabc),
         NodeHandle::Null,
-        NodeHandle(0x123abcde),
+        nodeHandle(0xabcde, 0x123),
         NodeHandle::Null
     }), TestSuite::Compare::Container);
 
@@ -810,8 +869,13 @@ void AbstractLayerTest::createNoHandlesLeft() {
     layer.create();
     /* Number is hardcoded in the expected message but not elsewhere in order
        to give a heads-up when modifying the handle ID bit count */
+    #ifndef MAGNUM_UI_LARGE_HANDLES
     CORRADE_COMPARE(out.str(),
         "Ui::AbstractLayer::create(): can only have at most 1048576 data\n");
+    #else
+    CORRADE_COMPARE(out.str(),
+        "Ui::AbstractLayer::create(): can only have at most 16777216 data\n");
+    #endif
 }
 
 void AbstractLayerTest::createAttached() {
@@ -847,6 +911,440 @@ void AbstractLayerTest::createAttached() {
     }), TestSuite::Compare::Container);
 }
 
+void AbstractLayerTest::reserve() {
+    struct Layer: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+        using AbstractLayer::create;
+
+        LayerFeatures doFeatures() const override { return {}; }
+        void doReserve(std::size_t capacity) override {
+            reserved = capacity;
+        }
+
+        std::size_t reserved = 0;
+    } layer{layerHandle(0xab, 0x12)};
+
+    /* Reserving delegates to the implementation but doesn't make any new
+       handles available */
+    layer.reserve(17);
+    CORRADE_COMPARE(layer.reserved, 17);
+    CORRADE_COMPARE(layer.capacity(), 0);
+    CORRADE_COMPARE(layer.usedCount(), 0);
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Creating works as before */
+    DataHandle first = layer.create();
+    DataHandle second = layer.create();
+    CORRADE_COMPARE(first, dataHandle(layer.handle(), 0, 1));
+    CORRADE_COMPARE(second, dataHandle(layer.handle(), 1, 1));
+    CORRADE_COMPARE(layer.capacity(), 2);
+    CORRADE_COMPARE(layer.usedCount(), 2);
+
+    /* Reserving less than what's used is a no-op on the base, but still
+       delegates */
+    layer.reserve(1);
+    CORRADE_COMPARE(layer.reserved, 1);
+    CORRADE_COMPARE(layer.capacity(), 2);
+    CORRADE_VERIFY(layer.isHandleValid(first));
+    CORRADE_VERIFY(layer.isHandleValid(second));
+}
+
+void AbstractLayerTest::memoryUsage() {
+    struct Layer: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+        using AbstractLayer::create;
+        using AbstractLayer::remove;
+
+        LayerFeatures doFeatures() const override { return {}; }
+        void doMemoryUsage(MemoryUsage& usage) const override {
+            usage.cpuByteCount += 1000;
+            usage.gpuByteCount += 2000;
+        }
+    } layer{layerHandle(0xab, 0x12)};
+
+    /* With nothing allocated, there's just what the subclass adds */
+    MemoryUsage empty = layer.memoryUsage();
+    CORRADE_COMPARE(empty.cpuByteCount, 1000);
+    CORRADE_COMPARE(empty.gpuByteCount, 2000);
+    CORRADE_COMPARE(empty.capacity, 0);
+    CORRADE_COMPARE(empty.usedCount, 0);
+
+    layer.create();
+    DataHandle second = layer.create();
+    layer.create();
+    layer.remove(second);
+
+    /* The base storage is counted in addition, capacity and used count is the
+       same as the dedicated queries */
+    MemoryUsage usage = layer.memoryUsage();
+    CORRADE_COMPARE_AS(usage.cpuByteCount, 1000,
+        TestSuite::Compare::Greater);
+    CORRADE_COMPARE(usage.gpuByteCount, 2000);
+    CORRADE_COMPARE(usage.capacity, 3);
+    CORRADE_COMPARE(usage.usedCount, 2);
+    CORRADE_COMPARE(usage.capacity, layer.capacity());
+    CORRADE_COMPARE(usage.usedCount, layer.usedCount());
+}
+
+void AbstractLayerTest::compact() {
+    struct Layer: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+        using AbstractLayer::create;
+        using AbstractLayer::remove;
+
+        LayerFeatures doFeatures() const override { return {}; }
+        void doCompact(const Containers::StridedArrayView1D<const UnsignedInt>& previousDataIds) override {
+            /* The base storage is compacted already */
+            CORRADE_COMPARE(capacity(), previousDataIds.size());
+            for(UnsignedInt i: previousDataIds)
+                arrayAppend(called, i);
+        }
+
+        Containers::Array<UnsignedInt> called;
+    } layer{layerHandle(0xab, 0x12)};
+
+    NodeHandle node1 = nodeHandle(0, 0xcde);
+    NodeHandle node2 = nodeHandle(2, 0xcef);
+    DataHandle first = layer.create(node1);
+    DataHandle second = layer.create();
+    DataHandle third = layer.create(node2);
+    DataHandle fourth = layer.create(node1);
+    DataHandle fifth = layer.create();
+    DataHandle sixth = layer.create(node2);
+    layer.remove(second);
+    layer.remove(fifth);
+    CORRADE_COMPARE(layer.capacity(), 6);
+    CORRADE_COMPARE(layer.usedCount(), 4);
+
+    DataHandle mapping[6];
+    layer.compact(mapping);
+    CORRADE_COMPARE_AS(Containers::arrayView(mapping), Containers::arrayView({
+        /* Data that didn't move keep their handle */
+        first,
+        DataHandle::Null,
+        /* Moved data get the generation of the slot incremented */
+        dataHandle(layer.handle(), 1, 2),
+        dataHandle(layer.handle(), 2, 2),
+        DataHandle::Null,
+        dataHandle(layer.handle(), 3, 2),
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(layer.called, Containers::arrayView({
+        0u, 2u, 3u, 5u
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(layer.capacity(), 4);
+    CORRADE_COMPARE(layer.usedCount(), 4);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate|LayerState::NeedsAttachmentUpdate|LayerState::NeedsNodeOffsetSizeUpdate|LayerState::NeedsDataClean);
+    CORRADE_COMPARE_AS(layer.modifiedDataMask(), Containers::stridedArrayView({
+        true, true, true, true
+    }).sliceBit(0), TestSuite::Compare::Container);
+
+    /* Old handles of moved data are invalid */
+    CORRADE_VERIFY(layer.isHandleValid(first));
+    CORRADE_VERIFY(!layer.isHandleValid(third));
+    CORRADE_VERIFY(!layer.isHandleValid(fourth));
+    CORRADE_VERIFY(!layer.isHandleValid(sixth));
+    CORRADE_VERIFY(layer.isHandleValid(mapping[2]));
+    CORRADE_VERIFY(layer.isHandleValid(mapping[3]));
+    CORRADE_VERIFY(layer.isHandleValid(mapping[5]));
+
+    /* Node attachments are preserved, the per-node lists are rebuilt for the
+       new IDs */
+    CORRADE_COMPARE_AS(layer.nodes(), Containers::arrayView({
+        node1, node2, node1, node2
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(layer.nodeFirstDataIds(), Containers::arrayView({
+        0u, ~UnsignedInt{}, 1u
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(layer.nodeDataCounts(), Containers::arrayView({
+        2u, 0u, 2u
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(layer.nodeNextDataIds()[0], 2);
+    CORRADE_COMPARE(layer.nodeNextDataIds()[1], 3);
+    CORRADE_COMPARE(layer.nodeNextDataIds()[2], ~UnsignedInt{});
+    CORRADE_COMPARE(layer.nodeNextDataIds()[3], ~UnsignedInt{});
+
+    /* There are no free slots anymore, so a new data grows the capacity. The
+       slots were released by compact(), so the generation continues after
+       the largest generation used by handles to the released data, to not
+       make the old fifth and sixth handles valid again. */
+    DataHandle seventh = layer.create();
+    DataHandle eighth = layer.create();
+    DataHandle ninth = layer.create();
+    CORRADE_COMPARE(seventh, dataHandle(layer.handle(), 4, 2));
+    CORRADE_COMPARE(eighth, dataHandle(layer.handle(), 5, 2));
+    /* Past the range released by compact() it starts from 1 again */
+    CORRADE_COMPARE(ninth, dataHandle(layer.handle(), 6, 1));
+    CORRADE_COMPARE(layer.capacity(), 7);
+    CORRADE_COMPARE(layer.usedCount(), 7);
+    CORRADE_VERIFY(!layer.isHandleValid(fifth));
+    CORRADE_VERIFY(!layer.isHandleValid(sixth));
+}
+
+void AbstractLayerTest::compactDisabledHandles() {
+    struct Layer: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+        using AbstractLayer::create;
+        using AbstractLayer::remove;
+
+        LayerFeatures doFeatures() const override { return {}; }
+        void doCompact(const Containers::StridedArrayView1D<const UnsignedInt>& previousDataIds) override {
+            for(UnsignedInt i: previousDataIds)
+                arrayAppend(called, i);
+        }
+
+        Containers::Array<UnsignedInt> called;
+    } layer{layerHandle(0xab, 0x12)};
+
+    /* Exhaust the generation of the first slot */
+    for(std::size_t i = 0; i != (1 << Implementation::LayerDataHandleGenerationBits) - 1; ++i)
+        layer.remove(layer.create());
+
+    DataHandle second = layer.create();
+    DataHandle third = layer.create();
+    CORRADE_COMPARE(second, dataHandle(layer.handle(), 1, 1));
+    CORRADE_COMPARE(third, dataHandle(layer.handle(), 2, 1));
+    layer.remove(second);
+
+    /* The disabled slot stays where it is and is skipped, the third data gets
+       moved to the free slot after */
+    DataHandle mapping[3];
+    layer.compact(mapping);
+    CORRADE_COMPARE_AS(Containers::arrayView(mapping), Containers::arrayView({
+        DataHandle::Null,
+        DataHandle::Null,
+        dataHandle(layer.handle(), 1, 3),
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(layer.called, Containers::arrayView({
+        ~UnsignedInt{}, 2u
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(layer.capacity(), 2);
+    CORRADE_COMPARE(layer.usedCount(), 2);
+    CORRADE_VERIFY(!layer.isHandleValid(third));
+    CORRADE_VERIFY(layer.isHandleValid(mapping[2]));
+}
+
+void AbstractLayerTest::compactDataAnimators() {
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+        using AbstractLayer::create;
+        using AbstractLayer::remove;
+
+        LayerFeatures doFeatures() const override { return {}; }
+    } layer{layerHandle(0, 1)};
+
+    struct: AbstractGenericAnimator {
+        using AbstractGenericAnimator::AbstractGenericAnimator;
+        using AbstractGenericAnimator::setLayer;
+        using AbstractGenericAnimator::create;
+
+        AnimatorFeatures doFeatures() const override {
+            return AnimatorFeature::DataAttachment;
+        }
+        void doClean(Containers::BitArrayView animationIdsToRemove) override {
+            ++called;
+            CORRADE_COMPARE_AS(animationIdsToRemove, Containers::stridedArrayView({
+                /* The first data didn't move, the third and fourth did, the
+                   fourth got released */
+                false, true, true, false
+            }).sliceBit(0), TestSuite::Compare::Container);
+        }
+        void doAdvance(Containers::BitArrayView, const Containers::StridedArrayView1D<const Float>&) override {}
+
+        Int called = 0;
+    } animator{animatorHandle(0, 1)};
+    animator.setLayer(layer);
+
+    DataHandle first = layer.create();
+    DataHandle second = layer.create();
+    DataHandle third = layer.create();
+    DataHandle fourth = layer.create();
+    layer.remove(second);
+
+    AnimationHandle animation1 = animator.create(0_nsec, 1_nsec, first);
+    AnimationHandle animation2 = animator.create(0_nsec, 1_nsec, third);
+    AnimationHandle animation3 = animator.create(0_nsec, 1_nsec, fourth);
+
+    DataHandle mapping[4];
+    layer.compact(mapping);
+    CORRADE_COMPARE(layer.capacity(), 3);
+
+    /* Animation attached to the new handle of a moved data stays */
+    AnimationHandle animation4 = animator.create(0_nsec, 1_nsec, mapping[3]);
+
+    /* Growing the storage again before the clean puts a new data at the ID of
+       the released fourth data, which shouldn't make the animation attached
+       to it valid again */
+    DataHandle fifth = layer.create();
+    CORRADE_COMPARE(dataHandleId(fifth), 3);
+    CORRADE_VERIFY(!layer.isHandleValid(fourth));
+
+    layer.cleanData({animator});
+    CORRADE_COMPARE(animator.called, 1);
+    CORRADE_VERIFY(animator.isHandleValid(animation1));
+    CORRADE_VERIFY(!animator.isHandleValid(animation2));
+    CORRADE_VERIFY(!animator.isHandleValid(animation3));
+    CORRADE_VERIFY(animator.isHandleValid(animation4));
+}
+
+void AbstractLayerTest::compactDataAnimatorsReleased() {
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+        using AbstractLayer::create;
+        using AbstractLayer::remove;
+
+        LayerFeatures doFeatures() const override { return {}; }
+    } layer{layerHandle(0, 1)};
+
+    struct: AbstractGenericAnimator {
+        using AbstractGenericAnimator::AbstractGenericAnimator;
+        using AbstractGenericAnimator::setLayer;
+        using AbstractGenericAnimator::create;
+
+        AnimatorFeatures doFeatures() const override {
+            return AnimatorFeature::DataAttachment;
+        }
+        void doClean(Containers::BitArrayView animationIdsToRemove) override {
+            ++called;
+            CORRADE_COMPARE_AS(animationIdsToRemove, Containers::stridedArrayView({
+                false, true
+            }).sliceBit(0), TestSuite::Compare::Container);
+        }
+        void doAdvance(Containers::BitArrayView, const Containers::StridedArrayView1D<const Float>&) override {}
+
+        Int called = 0;
+    } animator{animatorHandle(0, 1)};
+    animator.setLayer(layer);
+
+    DataHandle first = layer.create();
+    DataHandle second = layer.create();
+    DataHandle third = layer.create();
+    layer.remove(second);
+
+    AnimationHandle animation1 = animator.create(0_nsec, 1_nsec, first);
+    AnimationHandle animation2 = animator.create(0_nsec, 1_nsec, third);
+
+    /* The third data moves to ID 1, its original ID is out of range after
+       the compaction. The animation attached to it should get removed without
+       accessing anything out of bounds. */
+    DataHandle mapping[3];
+    layer.compact(mapping);
+    CORRADE_COMPARE(layer.capacity(), 2);
+    CORRADE_COMPARE(dataHandleId(third), 2);
+
+    layer.cleanData({animator});
+    CORRADE_COMPARE(animator.called, 1);
+    CORRADE_VERIFY(animator.isHandleValid(animation1));
+    CORRADE_VERIFY(!animator.isHandleValid(animation2));
+}
+
+void AbstractLayerTest::compactInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+        using AbstractLayer::create;
+
+        LayerFeatures doFeatures() const override { return {}; }
+    } layer{layerHandle(0, 1)};
+
+    layer.create();
+    layer.create();
+
+    DataHandle mapping[3];
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    layer.compact(mapping);
+    CORRADE_COMPARE(out.str(),
+        "Ui::AbstractLayer::compact(): expected mapping view to have a size of 2 but got 3\n");
+}
+
+void AbstractLayerTest::createRemoveMultiple() {
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+        using AbstractLayer::create;
+        using AbstractLayer::remove;
+
+        LayerFeatures doFeatures() const override { return {}; }
+    } layer{layerHandle(0xab, 0x12)};
+
+    /* Create one data and remove it to have something in the free list */
+    layer.remove(layer.create());
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    layer.cleanData({});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Creating with all nodes null causes only NeedsDataUpdate */
+    DataHandle notAttached[2];
+    layer.create(Containers::arrayView({NodeHandle::Null, NodeHandle::Null}), notAttached);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+    CORRADE_COMPARE(layer.capacity(), 2);
+    CORRADE_COMPARE(layer.usedCount(), 2);
+    /* The first one is recycled from the free list */
+    CORRADE_COMPARE(notAttached[0], dataHandle(layer.handle(), 0, 2));
+    CORRADE_COMPARE(notAttached[1], dataHandle(layer.handle(), 1, 1));
+
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* If any node is non-null, it causes NeedsAttachmentUpdate and everything
+       related to updating node-related state as well */
+    NodeHandle node = nodeHandle(9872, 0xbeb);
+    DataHandle attached[3];
+    layer.create(Containers::arrayView({NodeHandle::Null, node, node}), attached);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate|LayerState::NeedsAttachmentUpdate|LayerState::NeedsNodeOffsetSizeUpdate|LayerState::NeedsNodeEnabledUpdate);
+    CORRADE_COMPARE(layer.capacity(), 5);
+    CORRADE_COMPARE(layer.usedCount(), 5);
+    CORRADE_COMPARE_AS(layer.nodes(), Containers::arrayView({
+        NodeHandle::Null,
+        NodeHandle::Null,
+        NodeHandle::Null,
+        node,
+        node
+    }), TestSuite::Compare::Container);
+
+    layer.update(LayerState::NeedsDataUpdate|LayerState::NeedsNodeOffsetSizeUpdate|LayerState::NeedsNodeEnabledUpdate|LayerState::NeedsAttachmentUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Removing just non-attached data causes only NeedsDataClean */
+    layer.remove(Containers::arrayView({notAttached[1], attached[0]}));
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataClean);
+    CORRADE_COMPARE(layer.usedCount(), 3);
+    CORRADE_VERIFY(!layer.isHandleValid(notAttached[1]));
+    CORRADE_VERIFY(!layer.isHandleValid(attached[0]));
+
+    /* Removing attached data causes NeedsAttachmentUpdate as well */
+    layer.remove(Containers::arrayView({attached[2]}));
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataClean|LayerState::NeedsAttachmentUpdate);
+    CORRADE_COMPARE(layer.usedCount(), 2);
+    CORRADE_VERIFY(layer.isHandleValid(attached[1]));
+    CORRADE_VERIFY(!layer.isHandleValid(attached[2]));
+}
+
+void AbstractLayerTest::createRemoveMultipleInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+        using AbstractLayer::create;
+        using AbstractLayer::remove;
+
+        LayerFeatures doFeatures() const override { return {}; }
+    } layer{layerHandle(0, 1)};
+
+    DataHandle handle = layer.create();
+    DataHandle handles[2];
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    layer.create(Containers::arrayView({NodeHandle::Null, NodeHandle::Null, NodeHandle::Null}), handles);
+    layer.remove(Containers::arrayView({handle, handle}));
+    CORRADE_COMPARE_AS(out.str(),
+        "Ui::AbstractLayer::create(): expected handles view to have a size of 3 but got 2\n"
+        "Ui::AbstractLayer::remove(): invalid handle Ui::DataHandle({0x0, 0x1}, {0x0, 0x1}) at index 1\n",
+        TestSuite::Compare::String);
+}
+
 void AbstractLayerTest::removeInvalid() {
     CORRADE_SKIP_IF_NO_ASSERT();
 
@@ -864,11 +1362,11 @@ void AbstractLayerTest::removeInvalid() {
     Error redirectError{&out};
     layer.remove(DataHandle::Null);
     /* Valid layer, invalid data */
-    layer.remove(dataHandle(layer.handle(), LayerDataHandle(0x123abcde)));
+    layer.remove(dataHandle(layer.handle(), layerDataHandle(0xabcde, 0x123)));
     /* Invalid layer, valid data */
     layer.remove(dataHandle(LayerHandle::Null, dataHandleData(handle)));
     /* LayerDataHandle directly */
-    layer.remove(LayerDataHandle(0x123abcde));
+    layer.remove(layerDataHandle(0xabcde, 0x123));
     CORRADE_COMPARE_AS(out.str(),
         "Ui::AbstractLayer::remove(): invalid handle Ui::DataHandle::Null\n"
         "Ui::AbstractLayer::remove(): invalid handle Ui::DataHandle({0x0, 0x1}, {0xabcde, 0x123})\n"
@@ -976,6 +1474,93 @@ void AbstractLayerTest::attach() {
     }), TestSuite::Compare::Container);
 }
 
+void AbstractLayerTest::attachNodeData() {
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+        using AbstractLayer::create;
+        using AbstractLayer::remove;
+
+        LayerFeatures doFeatures() const override { return {}; }
+    } layer{layerHandle(0, 1)};
+
+    /* Initially there are no nodes with any data */
+    CORRADE_COMPARE(layer.nodeFirstDataIds().size(), 0);
+    CORRADE_COMPARE(layer.nodeDataCounts().size(), 0);
+
+    NodeHandle node1 = nodeHandle(1, 0xcec);
+    NodeHandle node3 = nodeHandle(3, 0xded);
+
+    DataHandle first = layer.create(node3);
+    DataHandle second = layer.create();
+    DataHandle third = layer.create(node1);
+    DataHandle fourth = layer.create(node3);
+    DataHandle fifth = layer.create();
+
+    /* The per-node views are enlarged to fit the highest attached node ID */
+    CORRADE_COMPARE_AS(layer.nodeDataCounts(), Containers::arrayView<UnsignedInt>({
+        0, 1, 0, 2
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(layer.nodeFirstDataIds(), Containers::arrayView<UnsignedInt>({
+        ~UnsignedInt{}, dataHandleId(third), ~UnsignedInt{}, dataHandleId(first)
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(layer.nodeNextDataIds().size(), 5);
+    CORRADE_COMPARE(layer.nodeNextDataIds()[dataHandleId(first)], dataHandleId(fourth));
+    CORRADE_COMPARE(layer.nodeNextDataIds()[dataHandleId(third)], ~UnsignedInt{});
+    CORRADE_COMPARE(layer.nodeNextDataIds()[dataHandleId(fourth)], ~UnsignedInt{});
+
+    /* Attaching data with a lower ID than what's already in the list inserts
+       it in the middle, attaching data with a higher ID appends to the end */
+    layer.attach(second, node3);
+    layer.attach(fifth, node1);
+    CORRADE_COMPARE_AS(layer.nodeDataCounts(), Containers::arrayView<UnsignedInt>({
+        0, 2, 0, 3
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(layer.nodeFirstDataIds(), Containers::arrayView<UnsignedInt>({
+        ~UnsignedInt{}, dataHandleId(third), ~UnsignedInt{}, dataHandleId(first)
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(layer.nodeNextDataIds()[dataHandleId(first)], dataHandleId(second));
+    CORRADE_COMPARE(layer.nodeNextDataIds()[dataHandleId(second)], dataHandleId(fourth));
+    CORRADE_COMPARE(layer.nodeNextDataIds()[dataHandleId(fourth)], ~UnsignedInt{});
+    CORRADE_COMPARE(layer.nodeNextDataIds()[dataHandleId(third)], dataHandleId(fifth));
+    CORRADE_COMPARE(layer.nodeNextDataIds()[dataHandleId(fifth)], ~UnsignedInt{});
+
+    /* Detaching and removing takes the data out of the list */
+    layer.attach(second, NodeHandle::Null);
+    layer.remove(first);
+    CORRADE_COMPARE_AS(layer.nodeDataCounts(), Containers::arrayView<UnsignedInt>({
+        0, 2, 0, 1
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(layer.nodeFirstDataIds(), Containers::arrayView<UnsignedInt>({
+        ~UnsignedInt{}, dataHandleId(third), ~UnsignedInt{}, dataHandleId(fourth)
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(layer.nodeNextDataIds()[dataHandleId(fourth)], ~UnsignedInt{});
+
+    /* Attaching to a different node moves the data to a different list, the
+       node generation doesn't matter */
+    layer.attach(fourth, nodeHandle(1, 0xaba));
+    CORRADE_COMPARE_AS(layer.nodeDataCounts(), Containers::arrayView<UnsignedInt>({
+        0, 3, 0, 0
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(layer.nodeFirstDataIds(), Containers::arrayView<UnsignedInt>({
+        ~UnsignedInt{}, dataHandleId(third), ~UnsignedInt{}, ~UnsignedInt{}
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(layer.nodeNextDataIds()[dataHandleId(third)], dataHandleId(fourth));
+    CORRADE_COMPARE(layer.nodeNextDataIds()[dataHandleId(fourth)], dataHandleId(fifth));
+    CORRADE_COMPARE(layer.nodeNextDataIds()[dataHandleId(fifth)], ~UnsignedInt{});
+
+    /* Creating a new data recycles the first one, which gets added to the
+       list again */
+    DataHandle sixth = layer.create(node3);
+    CORRADE_COMPARE(dataHandleId(sixth), dataHandleId(first));
+    CORRADE_COMPARE_AS(layer.nodeDataCounts(), Containers::arrayView<UnsignedInt>({
+        0, 3, 0, 1
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(layer.nodeFirstDataIds(), Containers::arrayView<UnsignedInt>({
+        ~UnsignedInt{}, dataHandleId(third), ~UnsignedInt{}, dataHandleId(sixth)
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(layer.nodeNextDataIds()[dataHandleId(sixth)], ~UnsignedInt{});
+}
+
 void AbstractLayerTest::attachInvalid() {
     CORRADE_SKIP_IF_NO_ASSERT();
 
@@ -993,14 +1578,14 @@ void AbstractLayerTest::attachInvalid() {
     layer.attach(DataHandle::Null, nodeHandle(2865, 0xcec));
     layer.node(DataHandle::Null);
     /* Valid layer, invalid data */
-    layer.attach(dataHandle(layer.handle(), LayerDataHandle(0x123abcde)), nodeHandle(2865, 0xcec));
-    layer.node(dataHandle(layer.handle(), LayerDataHandle(0x123abcde)));
+    layer.attach(dataHandle(layer.handle(), layerDataHandle(0xabcde, 0x123)), nodeHandle(2865, 0xcec));
+    layer.node(dataHandle(layer.handle(), layerDataHandle(0xabcde, 0x123)));
     /* Invalid layer, valid data */
     layer.attach(dataHandle(LayerHandle::Null, dataHandleData(handle)), nodeHandle(2865, 0xcec));
     layer.node(dataHandle(LayerHandle::Null, dataHandleData(handle)));
     /* LayerDataHandle directly */
-    layer.attach(LayerDataHandle(0x123abcde), nodeHandle(2865, 0xcec));
-    layer.node(LayerDataHandle(0x123abcde));
+    layer.attach(layerDataHandle(0xabcde, 0x123), nodeHandle(2865, 0xcec));
+    layer.node(layerDataHandle(0xabcde, 0x123));
     CORRADE_COMPARE_AS(out.str(),
         "Ui::AbstractLayer::attach(): invalid handle Ui::DataHandle::Null\n"
         "Ui::AbstractLayer::node(): invalid handle Ui::DataHandle::Null\n"
@@ -1324,6 +1909,14 @@ void AbstractLayerTest::cleanNodes() {
     CORRADE_VERIFY(layer.isHandleValid(fifth));
     CORRADE_VERIFY(!layer.isHandleValid(sixth));
     CORRADE_VERIFY(!layer.isHandleValid(seventh));
+
+    /* The removed data are taken out of the per-node lists as well, only the
+       fifth data stays attached */
+    CORRADE_COMPARE_AS(layer.nodeDataCounts(), Containers::arrayView<UnsignedInt>({
+        0, 0, 0, 1, 0, 0, 0, 0
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(layer.nodeFirstDataIds()[3], dataHandleId(fifth));
+    CORRADE_COMPARE(layer.nodeNextDataIds()[dataHandleId(fifth)], ~UnsignedInt{});
 }
 
 void AbstractLayerTest::cleanNodesEmpty() {
@@ -1379,8 +1972,9 @@ void AbstractLayerTest::cleanDataAnimators() {
             CORRADE_COMPARE_AS(animationIdsToRemove, Containers::stridedArrayView({
                 /* First and third is attached to removed data, fourth is not
                    attached to anything. fifth was attached to an invalid
-                   handle in the first place */
-                true, false, true, false, true
+                   handle in the first place, sixth to an ID that's out of
+                   range */
+                true, false, true, false, true, true
             }).sliceBit(0), TestSuite::Compare::Container);
         }
         void doAdvance(Containers::BitArrayView, const Containers::StridedArrayView1D<const Float>&) override {}
@@ -1437,12 +2031,11 @@ void AbstractLayerTest::cleanDataAnimators() {
     AnimationHandle animation12 = animator1.create(0_nsec, 1_nsec, third);
     AnimationHandle animation13 = animator1.create(0_nsec, 1_nsec, fifth);
     AnimationHandle animation14 = animator1.create(0_nsec, 1_nsec);
-    /* The ID however has to be in range, otherwise it'll assert on an OOB
-       access */
-    /** @todo this might be possible to hit in practice (accidentally attaching
-        to a LayerDataHandle from a different layer that has more items), have
-        some graceful handling? */
     AnimationHandle animation15 = animator1.create(0_nsec, 1_nsec, layerDataHandle(5, 0x12));
+    /* An ID that's out of range, such as when accidentally attaching to a
+       LayerDataHandle from a different layer that has more items or after
+       compact(), is treated as invalid as well */
+    AnimationHandle animation16 = animator1.create(0_nsec, 1_nsec, layerDataHandle(7, 1));
 
     /* One animation attached to the same data as in the first animator, one
        animation attached but then removed */
@@ -1461,6 +2054,7 @@ void AbstractLayerTest::cleanDataAnimators() {
     CORRADE_VERIFY(!animator1.isHandleValid(animation13));
     CORRADE_VERIFY(animator1.isHandleValid(animation14));
     CORRADE_VERIFY(!animator1.isHandleValid(animation15));
+    CORRADE_VERIFY(!animator1.isHandleValid(animation16));
     CORRADE_VERIFY(animator2.isHandleValid(animation21));
     CORRADE_VERIFY(!animator2.isHandleValid(animation22));
     CORRADE_VERIFY(!animator2.isHandleValid(animation23));
@@ -2323,6 +2917,85 @@ void AbstractLayerTest::updateEmpty() {
     CORRADE_COMPARE(layer.called, 1);
 }
 
+void AbstractLayerTest::updateModifiedData() {
+    struct Layer: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+        using AbstractLayer::create;
+        using AbstractLayer::setNeedsDataUpdate;
+
+        LayerFeatures doFeatures() const override { return {}; }
+
+        LayerStates doState() const override { return extraState; }
+
+        void doUpdate(LayerStates, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Float>&, Containers::BitArrayView, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&) override {
+            /* The mask is always the same size as capacity here */
+            CORRADE_COMPARE(modifiedDataMask().size(), capacity());
+            arrayResize(modified, NoInit, 0);
+            for(std::size_t i = 0; i != capacity(); ++i)
+                arrayAppend(modified, modifiedDataMask()[i]);
+        }
+
+        LayerStates extraState;
+        Containers::Array<bool> modified;
+    } layer{layerHandle(0, 1)};
+
+    /* Created data are all marked as modified, regardless of whether they're
+       attached */
+    layer.create(nodeHandle(0, 1));
+    DataHandle second = layer.create();
+    layer.create(nodeHandle(1, 1));
+    CORRADE_COMPARE_AS(layer.modifiedDataMask(), Containers::stridedArrayView({
+        true, true, true
+    }).sliceBit(0), TestSuite::Compare::Container);
+
+    /* The update passes the same to doUpdate() and clears it after */
+    layer.update(layer.state(), {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE_AS(layer.modified, Containers::arrayView({
+        true, true, true
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(layer.modifiedDataMask().count(), 0);
+
+    /* Attaching and explicitly marking just particular data marks only
+       those */
+    layer.attach(second, nodeHandle(2, 1));
+    layer.setNeedsDataUpdate(2);
+    CORRADE_VERIFY(layer.state() >= LayerState::NeedsDataUpdate);
+    layer.update(layer.state(), {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE_AS(layer.modified, Containers::arrayView({
+        false, true, true
+    }), TestSuite::Compare::Container);
+
+    /* Calling setNeedsUpdate() without any particular data marks all of
+       them */
+    layer.setNeedsDataUpdate(0);
+    layer.setNeedsUpdate(LayerState::NeedsDataUpdate);
+    layer.update(layer.state(), {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE_AS(layer.modified, Containers::arrayView({
+        true, true, true
+    }), TestSuite::Compare::Container);
+
+    /* Same if the data update is coming from doState() ... */
+    layer.setNeedsDataUpdate(0);
+    layer.extraState = LayerState::NeedsDataUpdate;
+    layer.update(layer.state(), {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE_AS(layer.modified, Containers::arrayView({
+        true, true, true
+    }), TestSuite::Compare::Container);
+
+    /* ... or from outside */
+    layer.extraState = {};
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE_AS(layer.modified, Containers::arrayView({
+        true, true, true
+    }), TestSuite::Compare::Container);
+
+    /* Updating without a data update passes an empty mask */
+    layer.update(LayerState::NeedsNodeOffsetSizeUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE_AS(layer.modified, Containers::arrayView({
+        false, false, false
+    }), TestSuite::Compare::Container);
+}
+
 void AbstractLayerTest::updateNotImplemented() {
     struct: AbstractLayer {
         using AbstractLayer::AbstractLayer;
@@ -2927,6 +3600,108 @@ void AbstractLayerTest::compositeInvalidSizes() {
         TestSuite::Compare::String);
 }
 
+void AbstractLayerTest::intrinsicSizes() {
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+
+        LayerFeatures doFeatures() const override {
+            return LayerFeature::IntrinsicSize;
+        }
+
+        void doIntrinsicSizes(const Containers::StridedArrayView1D<Vector2>& nodeSizes) override {
+            ++called;
+            CORRADE_COMPARE(nodeSizes.size(), 3);
+            nodeSizes[1] = Math::max(nodeSizes[1], Vector2{5.0f, 6.0f});
+        }
+
+        Int called = 0;
+    } layer{layerHandle(0, 1)};
+
+    /* The state is allowed to be set only if the feature is advertised */
+    layer.setNeedsUpdate(LayerState::NeedsIntrinsicSizeUpdate);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsIntrinsicSizeUpdate);
+
+    Vector2 nodeSizes[]{
+        {1.0f, 2.0f},
+        {3.0f, 7.0f},
+        {5.0f, 6.0f},
+    };
+    layer.intrinsicSizes(nodeSizes);
+    CORRADE_COMPARE(layer.called, 1);
+    CORRADE_COMPARE_AS(Containers::arrayView(nodeSizes), Containers::arrayView<Vector2>({
+        {1.0f, 2.0f},
+        {5.0f, 7.0f},
+        {5.0f, 6.0f},
+    }), TestSuite::Compare::Container);
+
+    /* The state is reset after */
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+}
+
+void AbstractLayerTest::intrinsicSizesAttach() {
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+
+        LayerFeatures doFeatures() const override {
+            return LayerFeature::IntrinsicSize;
+        }
+
+        void doIntrinsicSizes(const Containers::StridedArrayView1D<Vector2>&) override {}
+    } layer{layerHandle(0, 1)};
+
+    DataHandle data = layer.create();
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* Attaching to a different node makes the intrinsic sizes refreshed */
+    layer.intrinsicSizes({});
+    layer.attach(data, nodeHandle(0xabcde, 0x123));
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate|LayerState::NeedsNodeOffsetSizeUpdate|LayerState::NeedsAttachmentUpdate|LayerState::NeedsIntrinsicSizeUpdate);
+
+    /* Attaching to the same node again doesn't */
+    layer.intrinsicSizes({});
+    layer.attach(data, nodeHandle(0xabcde, 0x123));
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate|LayerState::NeedsNodeOffsetSizeUpdate|LayerState::NeedsAttachmentUpdate);
+
+    /* Detaching does */
+    layer.attach(data, NodeHandle::Null);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate|LayerState::NeedsNodeOffsetSizeUpdate|LayerState::NeedsAttachmentUpdate|LayerState::NeedsIntrinsicSizeUpdate);
+}
+
+void AbstractLayerTest::intrinsicSizesNotSupported() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+
+        LayerFeatures doFeatures() const override { return {}; }
+    } layer{layerHandle(0, 1)};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    layer.intrinsicSizes({});
+    layer.setNeedsUpdate(LayerState::NeedsIntrinsicSizeUpdate);
+    CORRADE_COMPARE(out.str(),
+        "Ui::AbstractLayer::intrinsicSizes(): feature not supported\n"
+        "Ui::AbstractLayer::setNeedsUpdate(): expected a non-empty subset of Ui::LayerState::NeedsDataUpdate|Ui::LayerState::NeedsCommonDataUpdate|Ui::LayerState::NeedsSharedDataUpdate but got Ui::LayerState::NeedsIntrinsicSizeUpdate\n");
+}
+
+void AbstractLayerTest::intrinsicSizesNotImplemented() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+
+        LayerFeatures doFeatures() const override {
+            return LayerFeature::IntrinsicSize;
+        }
+    } layer{layerHandle(0, 1)};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    layer.intrinsicSizes({});
+    CORRADE_COMPARE(out.str(), "Ui::AbstractLayer::intrinsicSizes(): feature advertised but not implemented\n");
+}
+
 void AbstractLayerTest::draw() {
     struct: AbstractLayer {
         using AbstractLayer::AbstractLayer;
@@ -30,12 +30,14 @@
 #include <Corrade/Containers/StringStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Compare/String.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
 #include <Magnum/Math/Vector2.h>
 
 #include "Magnum/Ui/AbstractLayouter.h"
 #include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/MemoryUsage.h"
 
 namespace Magnum { namespace Ui { namespace Test { namespace {
 
@@ -52,6 +54,8 @@ struct AbstractLayouterTest: TestSuite::Tester {
     void constructMove();
 
     void addRemove();
+    void reserve();
+    void memoryUsage();
     void addRemoveHandleRecycle();
     void addRemoveHandleDisable();
     void addNullNode();
@@ -86,6 +90,8 @@ AbstractLayouterTest::AbstractLayouterTest() {
               &AbstractLayouterTest::constructMove,
 
               &AbstractLayouterTest::addRemove,
+              &AbstractLayouterTest::reserve,
+              &AbstractLayouterTest::memoryUsage,
               &AbstractLayouterTest::addRemoveHandleRecycle,
               &AbstractLayouterTest::addRemoveHandleDisable,
               &AbstractLayouterTest::addNullNode,
@@ -231,6 +237,70 @@ void AbstractLayouterTest::addRemove() {
     CORRADE_COMPARE(layouter.usedCount(), 0);
 }
 
+void AbstractLayouterTest::reserve() {
+    struct Layouter: AbstractLayouter {
+        using AbstractLayouter::AbstractLayouter;
+        using AbstractLayouter::add;
+
+        void doReserve(std::size_t capacity) override {
+            reserved = capacity;
+        }
+        void doUpdate(Containers::BitArrayView, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const NodeHandle>&, const Containers::StridedArrayView1D<Vector2>&, const  Containers::StridedArrayView1D<Vector2>&) override {}
+
+        std::size_t reserved = 0;
+    } layouter{layouterHandle(0xab, 0x12)};
+
+    /* Reserving delegates to the implementation but doesn't make any new
+       handles available */
+    layouter.reserve(23);
+    CORRADE_COMPARE(layouter.reserved, 23);
+    CORRADE_COMPARE(layouter.capacity(), 0);
+    CORRADE_COMPARE(layouter.usedCount(), 0);
+    CORRADE_COMPARE(layouter.state(), LayouterStates{});
+
+    /* Adding works as before */
+    LayoutHandle first = layouter.add(nodeHandle(0x12345, 0xabc));
+    CORRADE_COMPARE(first, layoutHandle(layouter.handle(), 0, 1));
+    CORRADE_COMPARE(layouter.capacity(), 1);
+    CORRADE_COMPARE(layouter.usedCount(), 1);
+    CORRADE_COMPARE(layouter.node(first), nodeHandle(0x12345, 0xabc));
+}
+
+void AbstractLayouterTest::memoryUsage() {
+    struct Layouter: AbstractLayouter {
+        using AbstractLayouter::AbstractLayouter;
+        using AbstractLayouter::add;
+        using AbstractLayouter::remove;
+
+        void doMemoryUsage(MemoryUsage& usage) const override {
+            usage.cpuByteCount += 1000;
+            usage.gpuByteCount += 2000;
+        }
+        void doUpdate(Containers::BitArrayView, const Containers::StridedArrayView1D<const UnsignedInt>&, const Containers::StridedArrayView1D<const NodeHandle>&, const Containers::StridedArrayView1D<Vector2>&, const  Containers::StridedArrayView1D<Vector2>&) override {}
+    } layouter{layouterHandle(0xab, 0x12)};
+
+    /* With nothing allocated, there's just what the subclass adds */
+    MemoryUsage empty = layouter.memoryUsage();
+    CORRADE_COMPARE(empty.cpuByteCount, 1000);
+    CORRADE_COMPARE(empty.gpuByteCount, 2000);
+    CORRADE_COMPARE(empty.capacity, 0);
+    CORRADE_COMPARE(empty.usedCount, 0);
+
+    layouter.add(nodeHandle(0x12345, 0xabc));
+    LayoutHandle second = layouter.add(nodeHandle(0x12346, 0xabc));
+    layouter.add(nodeHandle(0x12347, 0xabc));
+    layouter.remove(second);
+
+    /* The base storage is counted in addition, capacity and used count is the
+       same as the dedicated queries */
+    MemoryUsage usage = layouter.memoryUsage();
+    CORRADE_COMPARE_AS(usage.cpuByteCount, 1000,
+        TestSuite::Compare::Greater);
+    CORRADE_COMPARE(usage.gpuByteCount, 2000);
+    CORRADE_COMPARE(usage.capacity, 3);
+    CORRADE_COMPARE(usage.usedCount, 2);
+}
+
 void AbstractLayouterTest::addRemoveHandleRecycle() {
     struct: AbstractLayouter {
         using AbstractLayouter::AbstractLayouter;
@@ -412,8 +482,13 @@ void AbstractLayouterTest::addNoHandlesLeft() {
     layouter.add(nodeHandle(0x1, 0x2));
     /* Number is hardcoded in the expected message but not elsewhere in order
        to give a heads-up when modifying the handle ID bit count */
+    #ifndef MAGNUM_UI_LARGE_HANDLES
     CORRADE_COMPARE(out.str(),
         "Ui::AbstractLayouter::add(): can only have at most 1048576 layouts\n");
+    #else
+    CORRADE_COMPARE(out.str(),
+        "Ui::AbstractLayouter::add(): can only have at most 16777216 layouts\n");
+    #endif
 }
 
 void AbstractLayouterTest::removeInvalid() {
@@ -433,11 +508,11 @@ void AbstractLayouterTest::removeInvalid() {
     Error redirectError{&out};
     layouter.remove(LayoutHandle::Null);
     /* Valid layouter, invalid data */
-    layouter.remove(layoutHandle(layouter.handle(), LayouterDataHandle(0x123abcde)));
+    layouter.remove(layoutHandle(layouter.handle(), layouterDataHandle(0xabcde, 0x123)));
     /* Invalid layouter, valid data */
     layouter.remove(layoutHandle(LayouterHandle::Null, layoutHandleData(handle)));
     /* LayouterDataHandle directly */
-    layouter.remove(LayouterDataHandle(0x123abcde));
+    layouter.remove(layouterDataHandle(0xabcde, 0x123));
     CORRADE_COMPARE_AS(out.str(),
         "Ui::AbstractLayouter::remove(): invalid handle Ui::LayoutHandle::Null\n"
         "Ui::AbstractLayouter::remove(): invalid handle Ui::LayoutHandle({0x0, 0x1}, {0xabcde, 0x123})\n"
@@ -462,11 +537,11 @@ void AbstractLayouterTest::nodeInvalid() {
     Error redirectError{&out};
     layouter.node(LayoutHandle::Null);
     /* Valid layer, invalid data */
-    layouter.node(layoutHandle(layouter.handle(), LayouterDataHandle(0x123abcde)));
+    layouter.node(layoutHandle(layouter.handle(), layouterDataHandle(0xabcde, 0x123)));
     /* Invalid layer, valid data */
     layouter.node(layoutHandle(LayouterHandle::Null, layoutHandleData(handle)));
     /* LayerDataHandle directly */
-    layouter.node(LayouterDataHandle(0x123abcde));
+    layouter.node(layouterDataHandle(0xabcde, 0x123));
     CORRADE_COMPARE_AS(out.str(),
         "Ui::AbstractLayouter::node(): invalid handle Ui::LayoutHandle::Null\n"
         "Ui::AbstractLayouter::node(): invalid handle Ui::LayoutHandle({0xab, 0x12}, {0xabcde, 0x123})\n"
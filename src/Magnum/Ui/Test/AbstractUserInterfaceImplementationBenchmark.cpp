@@ -0,0 +1,580 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstring>
+#include <Corrade/Containers/BitArray.h>
+#include <Corrade/Containers/Pair.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "Magnum/Ui/AbstractLayer.h" /* LayerFeatures */
+#include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/Implementation/abstractUserInterface.h"
+
+namespace Magnum { namespace Ui { namespace Test { namespace {
+
+struct AbstractUserInterfaceImplementationBenchmark: TestSuite::Tester {
+    explicit AbstractUserInterfaceImplementationBenchmark();
+
+    void orderVisibleNodesDepthFirst();
+    void cullVisibleNodes();
+    void nodeData();
+    void orderVisibleNodeData();
+    void discoverTopLevelLayoutNodes();
+    void fillLayoutUpdateMasks();
+    void compositeRects();
+};
+
+enum class Hierarchy {
+    /* Single top-level node with all other nodes being its direct children */
+    Flat,
+    /* Single top-level node with all other nodes forming a single branch */
+    Deep,
+    /* All nodes are top-level */
+    Wide,
+    /* Single top-level node with each other node having a random parent
+       among the preceding nodes */
+    Random
+};
+
+const struct {
+    const char* name;
+    Hierarchy hierarchy;
+    UnsignedInt nodeCount;
+} HierarchyData[]{
+    {"flat, 1k nodes", Hierarchy::Flat, 1000},
+    {"flat, 32k nodes", Hierarchy::Flat, 32000},
+    {"flat, 1M nodes", Hierarchy::Flat, 1000000},
+    {"deep, 1k nodes", Hierarchy::Deep, 1000},
+    {"deep, 32k nodes", Hierarchy::Deep, 32000},
+    {"deep, 1M nodes", Hierarchy::Deep, 1000000},
+    {"wide, 1k nodes", Hierarchy::Wide, 1000},
+    {"wide, 32k nodes", Hierarchy::Wide, 32000},
+    {"wide, 1M nodes", Hierarchy::Wide, 1000000},
+    {"random, 1k nodes", Hierarchy::Random, 1000},
+    {"random, 32k nodes", Hierarchy::Random, 32000},
+    {"random, 1M nodes", Hierarchy::Random, 1000000},
+};
+
+/* Nodes are placed in a grid of this width, with the UI size covering only
+   its upper part. Thus with 1k nodes all are visible, with 32k nodes half of
+   them gets culled and with 1M nodes only a small portion is visible. */
+constexpr UnsignedInt GridWidth = 1000;
+constexpr Vector2 UiSize{1000.0f, 16.0f};
+
+struct Nodes {
+    Containers::Array<NodeHandle> parents;
+    Containers::Array<UnsignedInt> order;
+    Containers::Array<NodeFlags> flags;
+    Containers::Array<NodeHandle> orderNext;
+    NodeHandle firstNodeOrder;
+    /* Absolute offsets, not calculated from the hierarchy in any way */
+    Containers::Array<Vector2> offsets;
+    Containers::Array<Vector2> sizes;
+};
+
+Nodes createNodes(const Hierarchy hierarchy, const UnsignedInt count) {
+    /* Handle generations aren't used for anything but have to be consistent
+       with `firstNodeOrder` */
+    Nodes nodes;
+    nodes.parents = Containers::Array<NodeHandle>{NoInit, count};
+    nodes.order = Containers::Array<UnsignedInt>{DirectInit, count, ~UnsignedInt{}};
+    nodes.flags = Containers::Array<NodeFlags>{ValueInit, count};
+    nodes.offsets = Containers::Array<Vector2>{NoInit, count};
+    nodes.sizes = Containers::Array<Vector2>{DirectInit, count, Vector2{1.0f}};
+
+    /* A simple LCG to have the random hierarchy deterministic */
+    UnsignedInt seed = 0x1234567;
+    for(UnsignedInt i = 0; i != count; ++i) {
+        NodeHandle parent = NodeHandle::Null;
+        if(i != 0) switch(hierarchy) {
+            case Hierarchy::Flat:
+                parent = nodeHandle(0, 1);
+                break;
+            case Hierarchy::Deep:
+                parent = nodeHandle(i - 1, 1);
+                break;
+            case Hierarchy::Wide:
+                break;
+            case Hierarchy::Random:
+                seed = seed*1103515245u + 12345u;
+                parent = nodeHandle((seed >> 8) % i, 1);
+                break;
+        }
+
+        nodes.parents[i] = parent;
+        nodes.offsets[i] = {Float(i % GridWidth), Float(i / GridWidth)};
+    }
+
+    /* All top-level nodes are in order in a cyclic list. If there's just a
+       single top-level node, it covers all others and clips them. */
+    if(hierarchy == Hierarchy::Wide) {
+        nodes.orderNext = Containers::Array<NodeHandle>{NoInit, count};
+        for(UnsignedInt i = 0; i != count; ++i) {
+            nodes.order[i] = i;
+            nodes.orderNext[i] = nodeHandle((i + 1) % count, 1);
+        }
+    } else {
+        nodes.order[0] = 0;
+        nodes.orderNext = Containers::Array<NodeHandle>{InPlaceInit, {nodeHandle(0, 1)}};
+        nodes.flags[0] = NodeFlag::Clip;
+        nodes.sizes[0] = {Float(GridWidth), Float(count/GridWidth + 1)};
+    }
+    nodes.firstNodeOrder = nodeHandle(0, 1);
+
+    return nodes;
+}
+
+/* Wrappers for calculating inputs to the benchmarked algorithms */
+
+std::size_t orderVisibleNodes(const Nodes& nodes, const Containers::StridedArrayView1D<UnsignedInt>& visibleNodeIds, const Containers::StridedArrayView1D<UnsignedInt>& visibleNodeChildrenCounts) {
+    const std::size_t count = nodes.parents.size();
+    Containers::BitArray visibleNodes{ValueInit, count};
+    Containers::Array<UnsignedInt> childrenOffsets{ValueInit, count + 1};
+    Containers::Array<UnsignedInt> children{NoInit, count};
+    Containers::Array<Containers::Triple<UnsignedInt, UnsignedInt, UnsignedInt>> parentsToProcess{NoInit, count};
+    return Implementation::orderVisibleNodesDepthFirstInto(
+        nodes.parents,
+        nodes.order,
+        nodes.flags,
+        nodes.orderNext,
+        nodes.firstNodeOrder,
+        visibleNodes,
+        childrenOffsets,
+        children,
+        parentsToProcess,
+        visibleNodeIds,
+        visibleNodeChildrenCounts);
+}
+
+UnsignedInt cullNodes(const Nodes& nodes, const Containers::StridedArrayView1D<const UnsignedInt>& visibleNodeIds, const Containers::StridedArrayView1D<const UnsignedInt>& visibleNodeChildrenCounts, const Containers::MutableBitArrayView visibleNodeMask, const Containers::StridedArrayView1D<Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<Vector2>& clipRectSizes, const Containers::StridedArrayView1D<UnsignedInt>& clipRectNodeCounts) {
+    Containers::Array<Containers::Triple<Vector2, Vector2, UnsignedInt>> clipStack{NoInit, visibleNodeIds.size() + 1};
+    return Implementation::cullVisibleNodesInto(
+        {}, UiSize,
+        nodes.offsets,
+        nodes.sizes,
+        nodes.flags,
+        clipStack,
+        visibleNodeIds,
+        visibleNodeChildrenCounts,
+        visibleNodeMask,
+        clipRectOffsets,
+        clipRectSizes,
+        clipRectNodeCounts);
+}
+
+std::size_t topLevelNodeCount(const Containers::StridedArrayView1D<const UnsignedInt>& visibleNodeChildrenCounts) {
+    std::size_t count = 0;
+    for(std::size_t i = 0; i < visibleNodeChildrenCounts.size(); i += visibleNodeChildrenCounts[i] + 1)
+        ++count;
+    return count;
+}
+
+/* A visible node hierarchy with clip rects and with a single data attached
+   to each node, in reverse order to not have the data and nodes trivially
+   matching */
+struct VisibleNodeData {
+    explicit VisibleNodeData(const Nodes& nodes);
+
+    Containers::Array<UnsignedInt> visibleNodeIds;
+    Containers::Array<UnsignedInt> visibleNodeChildrenCounts;
+    Containers::BitArray visibleNodeMask;
+    Containers::Array<Vector2> clipRectOffsets;
+    Containers::Array<Vector2> clipRectSizes;
+    Containers::Array<UnsignedInt> clipRectNodeCounts;
+    Containers::Array<NodeHandle> dataNodes;
+};
+
+VisibleNodeData::VisibleNodeData(const Nodes& nodes) {
+    const std::size_t count = nodes.parents.size();
+    visibleNodeIds = Containers::Array<UnsignedInt>{NoInit, count};
+    visibleNodeChildrenCounts = Containers::Array<UnsignedInt>{NoInit, count};
+    const std::size_t visibleCount = orderVisibleNodes(nodes, visibleNodeIds, visibleNodeChildrenCounts);
+    arrayResize(visibleNodeIds, visibleCount);
+    arrayResize(visibleNodeChildrenCounts, visibleCount);
+
+    visibleNodeMask = Containers::BitArray{NoInit, count};
+    clipRectOffsets = Containers::Array<Vector2>{NoInit, visibleCount};
+    clipRectSizes = Containers::Array<Vector2>{NoInit, visibleCount};
+    clipRectNodeCounts = Containers::Array<UnsignedInt>{NoInit, visibleCount};
+    const UnsignedInt clipRectCount = cullNodes(nodes, visibleNodeIds, visibleNodeChildrenCounts, visibleNodeMask, clipRectOffsets, clipRectSizes, clipRectNodeCounts);
+    arrayResize(clipRectOffsets, clipRectCount);
+    arrayResize(clipRectSizes, clipRectCount);
+    arrayResize(clipRectNodeCounts, clipRectCount);
+
+    dataNodes = Containers::Array<NodeHandle>{NoInit, count};
+    for(std::size_t i = 0; i != count; ++i)
+        dataNodes[i] = nodeHandle(count - i - 1, 1);
+}
+
+AbstractUserInterfaceImplementationBenchmark::AbstractUserInterfaceImplementationBenchmark() {
+    addInstancedBenchmarks({&AbstractUserInterfaceImplementationBenchmark::orderVisibleNodesDepthFirst,
+                            &AbstractUserInterfaceImplementationBenchmark::cullVisibleNodes,
+                            &AbstractUserInterfaceImplementationBenchmark::nodeData,
+                            &AbstractUserInterfaceImplementationBenchmark::orderVisibleNodeData,
+                            &AbstractUserInterfaceImplementationBenchmark::discoverTopLevelLayoutNodes,
+                            &AbstractUserInterfaceImplementationBenchmark::fillLayoutUpdateMasks,
+                            &AbstractUserInterfaceImplementationBenchmark::compositeRects}, 10,
+        Containers::arraySize(HierarchyData));
+}
+
+void AbstractUserInterfaceImplementationBenchmark::orderVisibleNodesDepthFirst() {
+    auto&& data = HierarchyData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const Nodes nodes = createNodes(data.hierarchy, data.nodeCount);
+
+    Containers::BitArray visibleNodes{NoInit, data.nodeCount};
+    Containers::Array<UnsignedInt> childrenOffsets{NoInit, data.nodeCount + 1};
+    Containers::Array<UnsignedInt> children{NoInit, data.nodeCount};
+    Containers::Array<Containers::Triple<UnsignedInt, UnsignedInt, UnsignedInt>> parentsToProcess{NoInit, data.nodeCount};
+    Containers::Array<UnsignedInt> visibleNodeIds{NoInit, data.nodeCount};
+    Containers::Array<UnsignedInt> visibleNodeChildrenCounts{NoInit, data.nodeCount};
+
+    /* The zero-initialization of the temporaries is a part of the cost, as
+       AbstractUserInterface has to do it too */
+    std::size_t count = 0;
+    CORRADE_BENCHMARK(5) {
+        Containers::MutableBitArrayView{visibleNodes}.resetAll();
+        std::memset(childrenOffsets.data(), 0, childrenOffsets.size()*sizeof(UnsignedInt));
+        count = Implementation::orderVisibleNodesDepthFirstInto(
+            nodes.parents,
+            nodes.order,
+            nodes.flags,
+            nodes.orderNext,
+            nodes.firstNodeOrder,
+            visibleNodes,
+            childrenOffsets,
+            children,
+            parentsToProcess,
+            visibleNodeIds,
+            visibleNodeChildrenCounts);
+    }
+
+    /* There are no hidden nodes, so everything is visible */
+    CORRADE_COMPARE(count, data.nodeCount);
+}
+
+void AbstractUserInterfaceImplementationBenchmark::cullVisibleNodes() {
+    auto&& data = HierarchyData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const Nodes nodes = createNodes(data.hierarchy, data.nodeCount);
+
+    Containers::Array<UnsignedInt> visibleNodeIds{NoInit, data.nodeCount};
+    Containers::Array<UnsignedInt> visibleNodeChildrenCounts{NoInit, data.nodeCount};
+    const std::size_t visibleCount = orderVisibleNodes(nodes, visibleNodeIds, visibleNodeChildrenCounts);
+
+    Containers::Array<Containers::Triple<Vector2, Vector2, UnsignedInt>> clipStack{NoInit, visibleCount + 1};
+    Containers::BitArray visibleNodeMask{NoInit, data.nodeCount};
+    Containers::Array<Vector2> clipRectOffsets{NoInit, visibleCount};
+    Containers::Array<Vector2> clipRectSizes{NoInit, visibleCount};
+    Containers::Array<UnsignedInt> clipRectNodeCounts{NoInit, visibleCount};
+
+    UnsignedInt clipRectCount = 0;
+    CORRADE_BENCHMARK(5) {
+        clipRectCount = Implementation::cullVisibleNodesInto(
+            {}, UiSize,
+            nodes.offsets,
+            nodes.sizes,
+            nodes.flags,
+            clipStack,
+            visibleNodeIds.prefix(visibleCount),
+            visibleNodeChildrenCounts.prefix(visibleCount),
+            visibleNodeMask,
+            clipRectOffsets,
+            clipRectSizes,
+            clipRectNodeCounts);
+    }
+
+    CORRADE_COMPARE_AS(clipRectCount, 0,
+        TestSuite::Compare::Greater);
+    CORRADE_COMPARE_AS(visibleNodeMask.count(), 0,
+        TestSuite::Compare::Greater);
+}
+
+void AbstractUserInterfaceImplementationBenchmark::nodeData() {
+    auto&& data = HierarchyData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const Nodes nodes = createNodes(data.hierarchy, data.nodeCount);
+    const VisibleNodeData visible{nodes};
+
+    Containers::Array<UnsignedInt> nodeFirstDataIds{NoInit, data.nodeCount};
+    Containers::Array<UnsignedInt> nodeDataCounts{NoInit, data.nodeCount};
+    Containers::Array<UnsignedInt> nodeNextDataIds{NoInit, data.nodeCount};
+    CORRADE_BENCHMARK(5) {
+        Implementation::nodeDataInto(
+            visible.dataNodes,
+            nodeFirstDataIds,
+            nodeDataCounts,
+            nodeNextDataIds);
+    }
+
+    /* Each node has exactly one data attached */
+    for(UnsignedInt i = 0; i != data.nodeCount; ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(nodeDataCounts[i], 1);
+    }
+}
+
+void AbstractUserInterfaceImplementationBenchmark::orderVisibleNodeData() {
+    auto&& data = HierarchyData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const Nodes nodes = createNodes(data.hierarchy, data.nodeCount);
+    const VisibleNodeData visible{nodes};
+
+    /* The node data lists are maintained by the layers in the UI, so they're
+       calculated outside of the benchmark loop */
+    const std::size_t drawCount = topLevelNodeCount(visible.visibleNodeChildrenCounts);
+    Containers::Array<UnsignedInt> nodeFirstDataIds{NoInit, data.nodeCount};
+    Containers::Array<UnsignedInt> nodeDataCounts{NoInit, data.nodeCount};
+    Containers::Array<UnsignedInt> nodeNextDataIds{NoInit, data.nodeCount};
+    Implementation::nodeDataInto(visible.dataNodes, nodeFirstDataIds, nodeDataCounts, nodeNextDataIds);
+    Containers::Array<UnsignedInt> dataToUpdateIds{NoInit, data.nodeCount};
+    Containers::Array<UnsignedInt> dataToUpdateClipRectIds{NoInit, visible.clipRectNodeCounts.size()};
+    Containers::Array<UnsignedInt> dataToUpdateClipRectDataCounts{NoInit, visible.clipRectNodeCounts.size()};
+    Containers::Array<UnsignedInt> dataToDrawOffsets{NoInit, drawCount};
+    Containers::Array<UnsignedInt> dataToDrawSizes{NoInit, drawCount};
+    Containers::Array<UnsignedInt> dataToDrawClipRectOffsets{NoInit, drawCount};
+    Containers::Array<UnsignedInt> dataToDrawClipRectSizes{NoInit, drawCount};
+
+    Containers::Pair<UnsignedInt, UnsignedInt> out;
+    CORRADE_BENCHMARK(5) {
+        out = Implementation::orderVisibleNodeDataInto(
+            visible.visibleNodeIds,
+            visible.visibleNodeChildrenCounts,
+            nodeFirstDataIds,
+            nodeDataCounts,
+            nodeNextDataIds,
+            LayerFeature::Draw,
+            visible.visibleNodeMask,
+            visible.clipRectNodeCounts,
+            dataToUpdateIds,
+            dataToUpdateClipRectIds,
+            dataToUpdateClipRectDataCounts,
+            0, 0,
+            dataToDrawOffsets,
+            dataToDrawSizes,
+            dataToDrawClipRectOffsets,
+            dataToDrawClipRectSizes);
+    }
+
+    /* Each visible node has exactly one data attached */
+    CORRADE_COMPARE(out.first(), visible.visibleNodeMask.count());
+}
+
+void AbstractUserInterfaceImplementationBenchmark::discoverTopLevelLayoutNodes() {
+    auto&& data = HierarchyData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const Nodes nodes = createNodes(data.hierarchy, data.nodeCount);
+
+    Containers::Array<UnsignedInt> visibleNodeIds{NoInit, data.nodeCount};
+    Containers::Array<UnsignedInt> visibleNodeChildrenCounts{NoInit, data.nodeCount};
+    const std::size_t visibleCount = orderVisibleNodes(nodes, visibleNodeIds, visibleNodeChildrenCounts);
+
+    /* The first layouter has a layout assigned to every node, the second
+       layouter to every fourth node. The layout handle generation isn't used
+       for anything, similarly to what AbstractUserInterface does. */
+    const std::size_t layoutCount = data.nodeCount + (data.nodeCount + 3)/4;
+    Containers::Array<LayoutHandle> nodeLayouts{ValueInit, data.nodeCount*2};
+    for(UnsignedInt i = 0; i != data.nodeCount; ++i) {
+        nodeLayouts[i*2 + 0] = layoutHandle(layouterHandle(0, 1), i, 0xfff);
+        if(i % 4 == 0)
+            nodeLayouts[i*2 + 1] = layoutHandle(layouterHandle(1, 1), i/4, 0xfff);
+    }
+
+    Containers::Array<UnsignedInt> nodeLayoutLevels{NoInit, data.nodeCount*2};
+    Containers::Array<UnsignedInt> layoutLevelOffsets{NoInit, layoutCount + 1};
+    Containers::Array<LayoutHandle> topLevelLayouts{NoInit, layoutCount};
+    Containers::Array<UnsignedInt> topLevelLayoutLevels{NoInit, layoutCount};
+    Containers::Array<LayoutHandle> levelPartitionedTopLevelLayouts{NoInit, layoutCount};
+    Containers::Array<UnsignedInt> topLevelLayoutOffsets{NoInit, layoutCount + 1};
+    Containers::Array<UnsignedByte> topLevelLayoutLayouterIds{NoInit, layoutCount};
+    Containers::Array<UnsignedInt> topLevelLayoutIds{NoInit, layoutCount};
+
+    /* The zero-initialization of the temporaries is a part of the cost, as
+       AbstractUserInterface has to do it too */
+    Containers::Pair<UnsignedInt, std::size_t> out;
+    CORRADE_BENCHMARK(5) {
+        std::memset(nodeLayoutLevels.data(), 0, nodeLayoutLevels.size()*sizeof(UnsignedInt));
+        std::memset(layoutLevelOffsets.data(), 0, layoutLevelOffsets.size()*sizeof(UnsignedInt));
+        out = Implementation::discoverTopLevelLayoutNodesInto(
+            nodes.parents,
+            visibleNodeIds.prefix(visibleCount),
+            2,
+            Containers::stridedArrayView(nodeLayouts).expanded<0, 2>({data.nodeCount, 2}),
+            Containers::stridedArrayView(nodeLayoutLevels).expanded<0, 2>({data.nodeCount, 2}),
+            layoutLevelOffsets,
+            topLevelLayouts,
+            topLevelLayoutLevels,
+            levelPartitionedTopLevelLayouts,
+            topLevelLayoutOffsets,
+            topLevelLayoutLayouterIds,
+            topLevelLayoutIds);
+    }
+
+    /* There's always at least one top-level layout from each layouter */
+    CORRADE_COMPARE_AS(out.second(), 2,
+        TestSuite::Compare::GreaterOrEqual);
+}
+
+void AbstractUserInterfaceImplementationBenchmark::fillLayoutUpdateMasks() {
+    auto&& data = HierarchyData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const Nodes nodes = createNodes(data.hierarchy, data.nodeCount);
+
+    Containers::Array<UnsignedInt> visibleNodeIds{NoInit, data.nodeCount};
+    Containers::Array<UnsignedInt> visibleNodeChildrenCounts{NoInit, data.nodeCount};
+    const std::size_t visibleCount = orderVisibleNodes(nodes, visibleNodeIds, visibleNodeChildrenCounts);
+
+    /* Same layout assignment as in discoverTopLevelLayoutNodes() above */
+    const std::size_t layoutCount = data.nodeCount + (data.nodeCount + 3)/4;
+    const UnsignedInt layouterCapacities[]{
+        data.nodeCount,
+        (data.nodeCount + 3)/4
+    };
+    Containers::Array<LayoutHandle> nodeLayouts{ValueInit, data.nodeCount*2};
+    for(UnsignedInt i = 0; i != data.nodeCount; ++i) {
+        nodeLayouts[i*2 + 0] = layoutHandle(layouterHandle(0, 1), i, 0xfff);
+        if(i % 4 == 0)
+            nodeLayouts[i*2 + 1] = layoutHandle(layouterHandle(1, 1), i/4, 0xfff);
+    }
+
+    Containers::Array<UnsignedInt> nodeLayoutLevels{ValueInit, data.nodeCount*2};
+    Containers::Array<UnsignedInt> layoutLevelOffsets{ValueInit, layoutCount + 1};
+    Containers::Array<LayoutHandle> topLevelLayouts{NoInit, layoutCount};
+    Containers::Array<UnsignedInt> topLevelLayoutLevels{NoInit, layoutCount};
+    Containers::Array<LayoutHandle> levelPartitionedTopLevelLayouts{NoInit, layoutCount};
+    Containers::Array<UnsignedInt> topLevelLayoutOffsets{NoInit, layoutCount + 1};
+    Containers::Array<UnsignedByte> topLevelLayoutLayouterIds{NoInit, layoutCount};
+    Containers::Array<UnsignedInt> topLevelLayoutIds{NoInit, layoutCount};
+    const Containers::Pair<UnsignedInt, std::size_t> maxLevelTopLevelLayoutOffsetCount = Implementation::discoverTopLevelLayoutNodesInto(
+        nodes.parents,
+        visibleNodeIds.prefix(visibleCount),
+        2,
+        Containers::stridedArrayView(nodeLayouts).expanded<0, 2>({data.nodeCount, 2}),
+        Containers::stridedArrayView(nodeLayoutLevels).expanded<0, 2>({data.nodeCount, 2}),
+        layoutLevelOffsets,
+        topLevelLayouts,
+        topLevelLayoutLevels,
+        levelPartitionedTopLevelLayouts,
+        topLevelLayoutOffsets,
+        topLevelLayoutLayouterIds,
+        topLevelLayoutIds);
+
+    /* Calculate the total bit count for all layout masks the same way as
+       AbstractUserInterface does */
+    std::size_t maskSize = 0;
+    for(std::size_t i = 0; i != maxLevelTopLevelLayoutOffsetCount.second() - 1; ++i)
+        maskSize += layouterCapacities[topLevelLayoutLayouterIds[i]];
+    Containers::BitArray masks{NoInit, maskSize};
+    Containers::Array<std::size_t> layouterLevelMaskOffsets{NoInit, 2*maxLevelTopLevelLayoutOffsetCount.first()};
+
+    CORRADE_BENCHMARK(5) {
+        Containers::MutableBitArrayView{masks}.resetAll();
+        Implementation::fillLayoutUpdateMasksInto(
+            Containers::stridedArrayView(nodeLayouts).expanded<0, 2>({data.nodeCount, 2}),
+            Containers::stridedArrayView(nodeLayoutLevels).expanded<0, 2>({data.nodeCount, 2}),
+            layoutLevelOffsets,
+            topLevelLayoutOffsets.prefix(maxLevelTopLevelLayoutOffsetCount.second()),
+            topLevelLayoutLayouterIds.prefix(maxLevelTopLevelLayoutOffsetCount.second() - 1),
+            layouterCapacities,
+            Containers::stridedArrayView(layouterLevelMaskOffsets).expanded<0, 2>({maxLevelTopLevelLayoutOffsetCount.first(), 2}),
+            masks);
+    }
+
+    /* Each visible layout is updated exactly once */
+    CORRADE_COMPARE(masks.count(), layoutCount);
+}
+
+void AbstractUserInterfaceImplementationBenchmark::compositeRects() {
+    auto&& data = HierarchyData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const Nodes nodes = createNodes(data.hierarchy, data.nodeCount);
+    const VisibleNodeData visible{nodes};
+
+    /* Order the data for draw first */
+    const std::size_t drawCount = topLevelNodeCount(visible.visibleNodeChildrenCounts);
+    Containers::Array<UnsignedInt> nodeFirstDataIds{NoInit, data.nodeCount};
+    Containers::Array<UnsignedInt> nodeDataCounts{NoInit, data.nodeCount};
+    Containers::Array<UnsignedInt> nodeNextDataIds{NoInit, data.nodeCount};
+    Implementation::nodeDataInto(visible.dataNodes, nodeFirstDataIds, nodeDataCounts, nodeNextDataIds);
+    Containers::Array<UnsignedInt> dataToUpdateIds{NoInit, data.nodeCount};
+    Containers::Array<UnsignedInt> dataToUpdateClipRectIds{NoInit, visible.clipRectNodeCounts.size()};
+    Containers::Array<UnsignedInt> dataToUpdateClipRectDataCounts{NoInit, visible.clipRectNodeCounts.size()};
+    Containers::Array<UnsignedInt> dataToDrawOffsets{NoInit, drawCount};
+    Containers::Array<UnsignedInt> dataToDrawSizes{NoInit, drawCount};
+    Containers::Array<UnsignedInt> dataToDrawClipRectOffsets{NoInit, drawCount};
+    Containers::Array<UnsignedInt> dataToDrawClipRectSizes{NoInit, drawCount};
+    const Containers::Pair<UnsignedInt, UnsignedInt> dataClipRectCount = Implementation::orderVisibleNodeDataInto(
+        visible.visibleNodeIds,
+        visible.visibleNodeChildrenCounts,
+        nodeFirstDataIds,
+        nodeDataCounts,
+        nodeNextDataIds,
+        LayerFeature::Draw|LayerFeature::Composite,
+        visible.visibleNodeMask,
+        visible.clipRectNodeCounts,
+        dataToUpdateIds,
+        dataToUpdateClipRectIds,
+        dataToUpdateClipRectDataCounts,
+        0, 0,
+        dataToDrawOffsets,
+        dataToDrawSizes,
+        dataToDrawClipRectOffsets,
+        dataToDrawClipRectSizes);
+
+    /* Then calculate composite rects for all of them at once */
+    Containers::Array<Vector2> compositeRectOffsets{NoInit, dataClipRectCount.first()};
+    Containers::Array<Vector2> compositeRectSizes{NoInit, dataClipRectCount.first()};
+    CORRADE_BENCHMARK(5) {
+        Implementation::compositeRectsInto(
+            {}, UiSize,
+            dataToUpdateIds.prefix(dataClipRectCount.first()),
+            dataToUpdateClipRectIds.prefix(dataClipRectCount.second()),
+            dataToUpdateClipRectDataCounts.prefix(dataClipRectCount.second()),
+            visible.dataNodes,
+            nodes.offsets,
+            nodes.sizes,
+            visible.clipRectOffsets,
+            visible.clipRectSizes,
+            compositeRectOffsets,
+            compositeRectSizes);
+    }
+
+    CORRADE_COMPARE_AS(compositeRectOffsets.size(), 0,
+        TestSuite::Compare::Greater);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Ui::Test::AbstractUserInterfaceImplementationBenchmark)
@@ -49,6 +49,9 @@ struct AbstractUserInterfaceImplementationTest: TestSuite::Tester {
     void orderVisibleNodesDepthFirstSingleBranch();
     void orderVisibleNodesDepthFirstNoTopLevelNodes();
 
+    void updateVisibleNodesDepthFirst();
+    void reorderVisibleTopLevelNodes();
+
     void visibleTopLevelNodeIndices();
 
     void propagateNodeFlagToChildren();
@@ -67,12 +70,16 @@ struct AbstractUserInterfaceImplementationTest: TestSuite::Tester {
     void cullVisibleNodesEdges();
     void cullVisibleNodes();
     void cullVisibleNodesNoTopLevelNodes();
+    void cullOccludedVisibleNodes();
 
+    void nodeData();
     void orderVisibleNodeData();
     void orderVisibleNodeDataNoTopLevelNodes();
 
     void countOrderNodeDataForEventHandling();
+    void nodeEventBounds();
 
+    void mergeDisjointTopLevelNodeDraws();
     void compactDraws();
 
     void compositeRectsEdges();
@@ -481,6 +488,9 @@ AbstractUserInterfaceImplementationTest::AbstractUserInterfaceImplementationTest
               &AbstractUserInterfaceImplementationTest::orderVisibleNodesDepthFirstSingleBranch,
               &AbstractUserInterfaceImplementationTest::orderVisibleNodesDepthFirstNoTopLevelNodes,
 
+              &AbstractUserInterfaceImplementationTest::updateVisibleNodesDepthFirst,
+              &AbstractUserInterfaceImplementationTest::reorderVisibleTopLevelNodes,
+
               &AbstractUserInterfaceImplementationTest::visibleTopLevelNodeIndices,
 
               &AbstractUserInterfaceImplementationTest::propagateNodeFlagToChildren,
@@ -508,12 +518,16 @@ AbstractUserInterfaceImplementationTest::AbstractUserInterfaceImplementationTest
         Containers::arraySize(CullVisibleNodesData));
 
     addTests({&AbstractUserInterfaceImplementationTest::cullVisibleNodesNoTopLevelNodes,
+              &AbstractUserInterfaceImplementationTest::cullOccludedVisibleNodes,
 
+              &AbstractUserInterfaceImplementationTest::nodeData,
               &AbstractUserInterfaceImplementationTest::orderVisibleNodeData,
               &AbstractUserInterfaceImplementationTest::orderVisibleNodeDataNoTopLevelNodes,
 
               &AbstractUserInterfaceImplementationTest::countOrderNodeDataForEventHandling,
+              &AbstractUserInterfaceImplementationTest::nodeEventBounds,
 
+              &AbstractUserInterfaceImplementationTest::mergeDisjointTopLevelNodeDraws,
               &AbstractUserInterfaceImplementationTest::compactDraws,
 
               &AbstractUserInterfaceImplementationTest::compositeRectsEdges,
@@ -797,6 +811,271 @@ void AbstractUserInterfaceImplementationTest::orderVisibleNodesDepthFirstNoTopLe
     CORRADE_COMPARE(count, 0);
 }
 
+void AbstractUserInterfaceImplementationTest::updateVisibleNodesDepthFirst() {
+    struct Node {
+        NodeHandle parent;
+        UnsignedInt order;
+        NodeFlags flags;
+    } nodes[]{
+        {NodeHandle::Null, 0, {}},                          /* 0 */
+        {nodeHandle(0, 0x1), ~UnsignedInt{}, {}},           /* 1 */
+        {nodeHandle(0, 0x1), ~UnsignedInt{}, {}},           /* 2 */
+        {nodeHandle(1, 0x1), ~UnsignedInt{}, {}},           /* 3 */
+        {nodeHandle(2, 0x1), ~UnsignedInt{}, {}},           /* 4 */
+        {nodeHandle(1, 0x1), ~UnsignedInt{}, NodeFlag::Hidden}, /* 5 */
+        {nodeHandle(5, 0x1), ~UnsignedInt{}, {}},           /* 6 */
+        {NodeHandle::Null, 1, {}},                          /* 7 */
+        {nodeHandle(7, 0x1), ~UnsignedInt{}, {}},           /* 8 */
+        /* Root node that isn't in the order, the children are never visible */
+        {NodeHandle::Null, 0xfefe, {}},                     /* 9 */
+        {nodeHandle(9, 0x1), ~UnsignedInt{}, NodeFlag::Hidden}, /* 10 */
+        /* Forward parent reference */
+        {nodeHandle(12, 0x1), ~UnsignedInt{}, {}},          /* 11 */
+        {nodeHandle(0, 0x1), ~UnsignedInt{}, {}},           /* 12 */
+    };
+    const struct NodeOrder {
+        NodeHandle next;
+    } nodeOrder[]{
+        {nodeHandle(7, 0x1)},                               /* 0 */
+        {nodeHandle(0, 0x1)},                               /* 1 */
+    };
+    const NodeHandle firstNodeOrder = nodeHandle(0, 0x1);
+
+    /* Calculates the visible node order from scratch, used to verify the
+       in-place update produces the same result. The children offsets are
+       cached for the in-place updates. */
+    UnsignedInt childrenOffsets[Containers::arraySize(nodes) + 1];
+    UnsignedInt children[Containers::arraySize(nodes)];
+    Containers::Triple<UnsignedInt, UnsignedInt, UnsignedInt> parentsToProcess[Containers::arraySize(nodes)];
+    const auto orderVisibleNodes = [&](const Containers::ArrayView<Containers::Pair<UnsignedInt, UnsignedInt>> out) {
+        char visibleNodes[2]{};
+        for(UnsignedInt& i: childrenOffsets) i = 0;
+        return Implementation::orderVisibleNodesDepthFirstInto(
+            Containers::stridedArrayView(nodes).slice(&Node::parent),
+            Containers::stridedArrayView(nodes).slice(&Node::order),
+            Containers::stridedArrayView(nodes).slice(&Node::flags),
+            Containers::stridedArrayView(nodeOrder).slice(&NodeOrder::next),
+            firstNodeOrder,
+            Containers::MutableBitArrayView{visibleNodes, 0, Containers::arraySize(nodes)},
+            childrenOffsets, children, parentsToProcess,
+            Containers::stridedArrayView(out).slice(&Containers::Pair<UnsignedInt, UnsignedInt>::first),
+            Containers::stridedArrayView(out).slice(&Containers::Pair<UnsignedInt, UnsignedInt>::second));
+    };
+
+    Containers::Pair<UnsignedInt, UnsignedInt> out[Containers::arraySize(nodes)];
+    std::size_t count = orderVisibleNodes(out);
+    CORRADE_COMPARE_AS(Containers::arrayView(out).prefix(count), (Containers::arrayView<Containers::Pair<UnsignedInt, UnsignedInt>>({
+        {0, 6},
+            {1, 1},
+                {3, 0},
+            {2, 1},
+                {4, 0},
+            {12, 1},
+                {11, 0},
+        {7, 1},
+            {8, 0},
+    })), TestSuite::Compare::Container);
+
+    Containers::Pair<UnsignedInt, UnsignedInt> expected[Containers::arraySize(nodes)];
+    UnsignedInt cachedChildrenOffsets[Containers::arraySize(nodes) + 1];
+    UnsignedInt cachedChildren[Containers::arraySize(nodes)];
+    Utility::copy(Containers::arrayView(childrenOffsets), cachedChildrenOffsets);
+    Utility::copy(Containers::arrayView(children), cachedChildren);
+    UnsignedInt ancestors[Containers::arraySize(nodes)];
+    const auto update = [&](UnsignedInt id, NodeFlags flags) {
+        nodes[id].flags = flags;
+        count = Implementation::updateVisibleNodesDepthFirstInPlace(
+            Containers::stridedArrayView(nodes).slice(&Node::parent),
+            Containers::stridedArrayView(nodes).slice(&Node::order),
+            Containers::stridedArrayView(nodes).slice(&Node::flags),
+            cachedChildrenOffsets, cachedChildren, id, ancestors,
+            parentsToProcess,
+            Containers::stridedArrayView(out).slice(&Containers::Pair<UnsignedInt, UnsignedInt>::first),
+            Containers::stridedArrayView(out).slice(&Containers::Pair<UnsignedInt, UnsignedInt>::second),
+            count);
+        return orderVisibleNodes(expected);
+    };
+
+    /* Hiding a node with children removes the whole subtree */
+    {
+        std::size_t expectedCount = update(1, NodeFlag::Hidden);
+        CORRADE_COMPARE(count, 7);
+        CORRADE_COMPARE_AS(Containers::arrayView(out).prefix(count),
+            Containers::arrayView(expected).prefix(expectedCount),
+            TestSuite::Compare::Container);
+
+    /* Showing a child of a hidden node doesn't change anything */
+    } {
+        std::size_t expectedCount = update(5, {});
+        CORRADE_COMPARE(count, 7);
+        CORRADE_COMPARE_AS(Containers::arrayView(out).prefix(count),
+            Containers::arrayView(expected).prefix(expectedCount),
+            TestSuite::Compare::Container);
+
+    /* Showing the hidden node again inserts the subtree including the child
+       that was made visible above in between its siblings */
+    } {
+        std::size_t expectedCount = update(1, {});
+        CORRADE_COMPARE(count, 11);
+        CORRADE_COMPARE_AS(Containers::arrayView(out).prefix(count),
+            Containers::arrayView(expected).prefix(expectedCount),
+            TestSuite::Compare::Container);
+
+    /* Updating an already visible node again does nothing */
+    } {
+        std::size_t expectedCount = update(1, {});
+        CORRADE_COMPARE(count, 11);
+        CORRADE_COMPARE_AS(Containers::arrayView(out).prefix(count),
+            Containers::arrayView(expected).prefix(expectedCount),
+            TestSuite::Compare::Container);
+
+    /* Hiding a leaf in the last top-level node */
+    } {
+        std::size_t expectedCount = update(8, NodeFlag::Hidden);
+        CORRADE_COMPARE(count, 10);
+        CORRADE_COMPARE_AS(Containers::arrayView(out).prefix(count),
+            Containers::arrayView(expected).prefix(expectedCount),
+            TestSuite::Compare::Container);
+
+    /* Hiding a node under a forward parent reference, and then the last child
+       of the first top-level node */
+    } {
+        update(11, NodeFlag::Hidden);
+        std::size_t expectedCount = update(12, NodeFlag::Hidden);
+        CORRADE_COMPARE(count, 8);
+        CORRADE_COMPARE_AS(Containers::arrayView(out).prefix(count),
+            Containers::arrayView(expected).prefix(expectedCount),
+            TestSuite::Compare::Container);
+
+    /* Showing them in the opposite order, the second shows the whole
+       subtree */
+    } {
+        update(11, {});
+        std::size_t expectedCount = update(12, {});
+        CORRADE_COMPARE(count, 10);
+        CORRADE_COMPARE_AS(Containers::arrayView(out).prefix(count),
+            Containers::arrayView(expected).prefix(expectedCount),
+            TestSuite::Compare::Container);
+
+    /* Showing a node under a root that isn't in the order does nothing */
+    } {
+        std::size_t expectedCount = update(10, {});
+        CORRADE_COMPARE(count, 10);
+        CORRADE_COMPARE_AS(Containers::arrayView(out).prefix(count),
+            Containers::arrayView(expected).prefix(expectedCount),
+            TestSuite::Compare::Container);
+    }
+}
+
+void AbstractUserInterfaceImplementationTest::reorderVisibleTopLevelNodes() {
+    const struct Node {
+        NodeHandle parent;
+        UnsignedInt order;
+        NodeFlags flags;
+    } nodes[]{
+        {NodeHandle::Null, 0, {}},                          /* 0 */
+        {nodeHandle(0, 0x1), ~UnsignedInt{}, {}},           /* 1 */
+        {nodeHandle(1, 0x1), ~UnsignedInt{}, {}},           /* 2 */
+        {NodeHandle::Null, 1, {}},                          /* 3 */
+        {nodeHandle(3, 0x1), ~UnsignedInt{}, {}},           /* 4 */
+        /* Hidden top-level node, its hierarchy is never visible */
+        {NodeHandle::Null, 2, NodeFlag::Hidden},            /* 5 */
+        {nodeHandle(5, 0x1), ~UnsignedInt{}, {}},           /* 6 */
+        {NodeHandle::Null, 3, {}},                          /* 7 */
+    };
+    struct NodeOrder {
+        NodeHandle next;
+    } nodeOrder[]{
+        {nodeHandle(3, 0x1)},                               /* 0 */
+        {nodeHandle(5, 0x1)},                               /* 1 */
+        {nodeHandle(7, 0x1)},                               /* 2 */
+        {nodeHandle(0, 0x1)},                               /* 3 */
+    };
+    NodeHandle firstNodeOrder = nodeHandle(0, 0x1);
+
+    /* Calculates the visible node order from scratch, used to verify the
+       reordering produces the same result */
+    const auto orderVisibleNodes = [&](const Containers::ArrayView<Containers::Pair<UnsignedInt, UnsignedInt>> out) {
+        char visibleNodes[1]{};
+        UnsignedInt childrenOffsets[Containers::arraySize(nodes) + 1]{};
+        UnsignedInt children[Containers::arraySize(nodes)];
+        Containers::Triple<UnsignedInt, UnsignedInt, UnsignedInt> parentsToProcess[Containers::arraySize(nodes)];
+        return Implementation::orderVisibleNodesDepthFirstInto(
+            Containers::stridedArrayView(nodes).slice(&Node::parent),
+            Containers::stridedArrayView(nodes).slice(&Node::order),
+            Containers::stridedArrayView(nodes).slice(&Node::flags),
+            Containers::stridedArrayView(nodeOrder).slice(&NodeOrder::next),
+            firstNodeOrder,
+            Containers::MutableBitArrayView{visibleNodes, 0, Containers::arraySize(nodes)},
+            childrenOffsets, children, parentsToProcess,
+            Containers::stridedArrayView(out).slice(&Containers::Pair<UnsignedInt, UnsignedInt>::first),
+            Containers::stridedArrayView(out).slice(&Containers::Pair<UnsignedInt, UnsignedInt>::second));
+    };
+
+    Containers::Pair<UnsignedInt, UnsignedInt> out[Containers::arraySize(nodes)];
+    std::size_t count = orderVisibleNodes(out);
+    CORRADE_COMPARE_AS(Containers::arrayView(out).prefix(count), (Containers::arrayView<Containers::Pair<UnsignedInt, UnsignedInt>>({
+        {0, 2},
+            {1, 1},
+                {2, 0},
+        {3, 1},
+            {4, 0},
+        {7, 0},
+    })), TestSuite::Compare::Container);
+
+    /* Visible node indices contain arbitrary values for nodes that aren't
+       visible */
+    UnsignedInt visibleNodeIndices[Containers::arraySize(nodes)];
+    for(UnsignedInt& i: visibleNodeIndices) i = 0;
+    Containers::Pair<UnsignedInt, UnsignedInt> previous[Containers::arraySize(nodes)];
+    Containers::Pair<UnsignedInt, UnsignedInt> expected[Containers::arraySize(nodes)];
+    const auto reorder = [&]() {
+        for(std::size_t i = 0; i != count; ++i)
+            visibleNodeIndices[out[i].first()] = i;
+        Utility::copy(Containers::arrayView(out).prefix(count), Containers::arrayView(previous).prefix(count));
+        count = Implementation::reorderVisibleTopLevelNodesInto(
+            Containers::stridedArrayView(nodes).slice(&Node::order),
+            Containers::stridedArrayView(nodeOrder).slice(&NodeOrder::next),
+            firstNodeOrder, visibleNodeIndices,
+            Containers::stridedArrayView(previous).prefix(count).slice(&Containers::Pair<UnsignedInt, UnsignedInt>::first),
+            Containers::stridedArrayView(previous).prefix(count).slice(&Containers::Pair<UnsignedInt, UnsignedInt>::second),
+            Containers::stridedArrayView(out).slice(&Containers::Pair<UnsignedInt, UnsignedInt>::first),
+            Containers::stridedArrayView(out).slice(&Containers::Pair<UnsignedInt, UnsignedInt>::second));
+        return orderVisibleNodes(expected);
+    };
+
+    /* Reversing the order, including the hidden node, permutes the ranges */
+    {
+        nodeOrder[3].next = nodeHandle(5, 0x1);
+        nodeOrder[2].next = nodeHandle(3, 0x1);
+        nodeOrder[1].next = nodeHandle(0, 0x1);
+        nodeOrder[0].next = nodeHandle(7, 0x1);
+        firstNodeOrder = nodeHandle(7, 0x1);
+        std::size_t expectedCount = reorder();
+        CORRADE_COMPARE(count, 6);
+        CORRADE_COMPARE_AS(Containers::arrayView(out).prefix(count),
+            Containers::arrayView(expected).prefix(expectedCount),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE(out[0].first(), 7);
+
+    /* Removing a node from the order drops its range */
+    } {
+        nodeOrder[2].next = nodeHandle(0, 0x1);
+        std::size_t expectedCount = reorder();
+        CORRADE_COMPARE(count, 4);
+        CORRADE_COMPARE_AS(Containers::arrayView(out).prefix(count),
+            Containers::arrayView(expected).prefix(expectedCount),
+            TestSuite::Compare::Container);
+
+    /* Removing all nodes from the order results in nothing visible */
+    } {
+        firstNodeOrder = NodeHandle::Null;
+        std::size_t expectedCount = reorder();
+        CORRADE_COMPARE(count, 0);
+        CORRADE_COMPARE(expectedCount, 0);
+    }
+}
+
 void AbstractUserInterfaceImplementationTest::visibleTopLevelNodeIndices() {
     /* Mostly like the output in the orderVisibleNodesDepthFirst() case */
     UnsignedInt visibleNodeChildrenCounts[]{
@@ -1797,6 +2076,113 @@ void AbstractUserInterfaceImplementationTest::cullVisibleNodesNoTopLevelNodes()
     }).sliceBit(0), TestSuite::Compare::Container);
 }
 
+void AbstractUserInterfaceImplementationTest::cullOccludedVisibleNodes() {
+    const Vector2 absoluteNodeOffsets[]{
+        {0.0f, 0.0f},   /* 0, top-level */
+        {10.0f, 10.0f}, /* 1, child of 0, fully covered by 4 */
+        {90.0f, 90.0f}, /* 2, child of 0, partially covered by 4 */
+        {50.0f, 0.0f},  /* 3, top-level, fully covered by 4 */
+        {0.0f, 0.0f},   /* 4, top-level, opaque */
+        {0.0f, 0.0f},   /* 5, child of 4, not affected by its parent */
+        {60.0f, 60.0f}, /* 6, top-level in front of 4 */
+        {0.0f, 0.0f},   /* 7, top-level, opaque but culled */
+    };
+    const Vector2 nodeSizes[]{
+        {100.0f, 100.0f},
+        {20.0f, 20.0f},
+        {20.0f, 20.0f},
+        {20.0f, 20.0f},
+        {80.0f, 80.0f},
+        {10.0f, 10.0f},
+        {40.0f, 40.0f},
+        {200.0f, 200.0f},
+    };
+    const NodeFlags nodeFlags[]{
+        {},
+        {},
+        {},
+        {},
+        NodeFlag::Opaque,
+        /* Not a top-level node, so this has no effect */
+        NodeFlag::Opaque,
+        {},
+        NodeFlag::Opaque,
+    };
+    const UnsignedInt visibleNodeIds[]{0, 1, 2, 3, 4, 5, 6, 7};
+    const UnsignedInt visibleNodeChildrenCounts[]{2, 0, 0, 0, 1, 0, 0, 0};
+    const UnsignedInt visibleFrontToBackTopLevelNodeIndices[]{7, 6, 4, 3, 0};
+
+    /* Node 7 is culled already */
+    UnsignedByte visibleNodeMaskData[1]{0x7f};
+    Containers::MutableBitArrayView visibleNodeMask{visibleNodeMaskData, 0, 8};
+
+    /* The scratch storage is cleared on entry */
+    Containers::Array<Containers::Pair<Vector2, Vector2>> occluders;
+    arrayAppend(occluders, InPlaceInit, Vector2{}, Vector2{1000.0f});
+
+    Implementation::cullOccludedVisibleNodesInto(
+        absoluteNodeOffsets,
+        nodeSizes,
+        nodeFlags,
+        visibleNodeIds,
+        visibleNodeChildrenCounts,
+        visibleFrontToBackTopLevelNodeIndices,
+        occluders,
+        visibleNodeMask);
+    CORRADE_COMPARE_AS(visibleNodeMask, Containers::stridedArrayView({
+        true, false, true, false, true, true, true, false
+    }).sliceBit(0), TestSuite::Compare::Container);
+    CORRADE_COMPARE(occluders.size(), 1);
+}
+
+void AbstractUserInterfaceImplementationTest::nodeData() {
+    /* Node generations don't matter in any way, the same node ID can even
+       have different generations */
+    const NodeHandle dataNodes[]{
+        nodeHandle(3, 0xeee),   /* 0 */
+        NodeHandle{},           /* 1 */
+        nodeHandle(1, 0xaba),   /* 2 */
+        nodeHandle(3, 0x000),   /* 3 */
+        NodeHandle{},           /* 4 */
+        nodeHandle(0, 0xccc),   /* 5 */
+        nodeHandle(3, 0xfef),   /* 6 */
+    };
+
+    /* Filled with garbage to verify the lists get initialized */
+    UnsignedInt nodeFirstDataIds[5]{
+        0xcccccccc, 0xcccccccc, 0xcccccccc, 0xcccccccc, 0xcccccccc
+    };
+    UnsignedInt nodeDataCounts[5]{
+        0xcccccccc, 0xcccccccc, 0xcccccccc, 0xcccccccc, 0xcccccccc
+    };
+    UnsignedInt nodeNextDataIds[7]{
+        0xcccccccc, 0xcccccccc, 0xcccccccc, 0xcccccccc,
+        0xcccccccc, 0xcccccccc, 0xcccccccc
+    };
+    Implementation::nodeDataInto(dataNodes, nodeFirstDataIds, nodeDataCounts, nodeNextDataIds);
+    CORRADE_COMPARE_AS(Containers::arrayView(nodeFirstDataIds), Containers::arrayView<UnsignedInt>({
+        5,              /* Node 0, data 5 */
+        2,              /* Node 1, data 2 */
+        ~UnsignedInt{}, /* Node 2, nothing */
+        0,              /* Node 3, data 0, 3 and 6 */
+        ~UnsignedInt{}, /* Node 4, nothing */
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(Containers::arrayView(nodeDataCounts), Containers::arrayView<UnsignedInt>({
+        1, 1, 0, 3, 0
+    }), TestSuite::Compare::Container);
+    /* Data for the same node are in increasing ID order, items for data not
+       attached anywhere are left untouched */
+    CORRADE_COMPARE_AS(Containers::arrayView(nodeNextDataIds), Containers::arrayView<UnsignedInt>({
+        3,
+        0xcccccccc,
+        ~UnsignedInt{},
+        6,
+        0xcccccccc,
+        ~UnsignedInt{},
+        ~UnsignedInt{}
+    }), TestSuite::Compare::Container);
+}
+
 void AbstractUserInterfaceImplementationTest::orderVisibleNodeData() {
     /* Ordered visible node hierarchy */
     const Containers::Pair<UnsignedInt, UnsignedInt> visibleNodeIdsChildrenCount[]{
@@ -1897,8 +2283,9 @@ void AbstractUserInterfaceImplementationTest::orderVisibleNodeData() {
         {Containers::arrayView(layer5NodeAttachments), LayerFeature::Draw|LayerFeature::Event}
     };
 
-    UnsignedInt visibleNodeDataOffsets[15]{};
-    UnsignedInt visibleNodeDataIds[18];
+    UnsignedInt nodeFirstDataIds[14];
+    UnsignedInt nodeDataCounts[14];
+    UnsignedInt nodeNextDataIds[18];
     UnsignedInt dataToUpdateIds[18];
     Containers::Pair<UnsignedInt, UnsignedInt> dataToUpdateClipRectIdsDataCounts[Containers::arraySize(layers)*Containers::arraySize(clipRectNodeCounts)];
     Containers::Pair<UnsignedInt, UnsignedInt> dataOffsetsSizesToDraw[Containers::arraySize(layers)*4];
@@ -1911,15 +2298,16 @@ void AbstractUserInterfaceImplementationTest::orderVisibleNodeData() {
     UnsignedInt clipRectOffset = 0;
     for(const auto& layer: layers) {
         CORRADE_ITERATION(dataToUpdateLayerOffsets.size() - 1);
+        Implementation::nodeDataInto(layer.first(), nodeFirstDataIds, nodeDataCounts, Containers::arrayView(nodeNextDataIds).prefix(layer.first().size()));
         auto out = Implementation::orderVisibleNodeDataInto(
             Containers::stridedArrayView(visibleNodeIdsChildrenCount).slice(&Containers::Pair<UnsignedInt, UnsignedInt>::first),
             Containers::stridedArrayView(visibleNodeIdsChildrenCount).slice(&Containers::Pair<UnsignedInt, UnsignedInt>::second),
-            layer.first(),
+            nodeFirstDataIds,
+            nodeDataCounts,
+            nodeNextDataIds,
             layer.second(),
             Containers::BitArrayView{visibleNodeMask, 0, 14},
             clipRectNodeCounts,
-            visibleNodeDataOffsets,
-            Containers::arrayView(visibleNodeDataIds).prefix(layer.first().size()),
             dataToUpdateIds,
             Containers::stridedArrayView(dataToUpdateClipRectIdsDataCounts)
                 .slice(&Containers::Pair<UnsignedInt, UnsignedInt>::first),
@@ -2082,20 +2470,20 @@ void AbstractUserInterfaceImplementationTest::orderVisibleNodeData() {
 }
 
 void AbstractUserInterfaceImplementationTest::orderVisibleNodeDataNoTopLevelNodes() {
-    NodeHandle dataNodes[3];
     UnsignedByte visibleNodeMaskData[1];
     Containers::BitArrayView visibleNodeMask{visibleNodeMaskData, 0, 3};
-    UnsignedInt visibleNodeDataOffsets[4];
-    UnsignedInt visibleNodeDataIds[3];
+    UnsignedInt nodeFirstDataIds[3]{};
+    UnsignedInt nodeDataCounts[3]{};
+    UnsignedInt nodeNextDataIds[3];
     Containers::Pair<UnsignedInt, UnsignedInt> count = Implementation::orderVisibleNodeDataInto(
         nullptr,
         nullptr,
-        dataNodes,
+        nodeFirstDataIds,
+        nodeDataCounts,
+        nodeNextDataIds,
         {},
         visibleNodeMask,
         nullptr,
-        visibleNodeDataOffsets,
-        visibleNodeDataIds,
         nullptr,
         nullptr,
         nullptr,
@@ -2152,11 +2540,18 @@ void AbstractUserInterfaceImplementationTest::countOrderNodeDataForEventHandling
         {layer2NodeAttachments, layer2},
     };
 
+    /* Build the node data mapping for all layers */
+    UnsignedInt nodeFirstDataIds[Containers::arraySize(layers)][14];
+    UnsignedInt nodeDataCounts[Containers::arraySize(layers)][14];
+    UnsignedInt nodeNextDataIds[Containers::arraySize(layers)][7];
+    for(std::size_t i = 0; i != Containers::arraySize(layers); ++i)
+        Implementation::nodeDataInto(layers[i].first(), nodeFirstDataIds[i], nodeDataCounts[i], Containers::arrayView(nodeNextDataIds[i]).prefix(layers[i].first().size()));
+
     /* First count the event data for all layers */
     UnsignedInt visibleNodeEventDataOffsets[15]{};
-    for(const auto& layer: layers) {
-        CORRADE_ITERATION(layer.second());
-        Implementation::countNodeDataForEventHandlingInto(layer.first(), visibleNodeEventDataOffsets, visibleEventNodeMask);
+    for(std::size_t i = 0; i != Containers::arraySize(layers); ++i) {
+        CORRADE_ITERATION(layers[i].second());
+        Implementation::countNodeDataForEventHandlingInto(nodeDataCounts[i], visibleNodeEventDataOffsets, visibleEventNodeMask);
     }
     CORRADE_COMPARE_AS(Containers::arrayView(visibleNodeEventDataOffsets), Containers::arrayView<UnsignedInt>({
         0,
@@ -2204,12 +2599,14 @@ void AbstractUserInterfaceImplementationTest::countOrderNodeDataForEventHandling
     }), TestSuite::Compare::Container);
 
     /* Then order the data for all layers */
-    DataHandle visibleNodeEventData[9];
-    for(const auto& layer: layers) {
-        CORRADE_ITERATION(layer.second());
+    UnsignedInt visibleNodeEventData[9];
+    for(std::size_t i = 0; i != Containers::arraySize(layers); ++i) {
+        CORRADE_ITERATION(layers[i].second());
         Implementation::orderNodeDataForEventHandlingInto(
-            layer.second(),
-            layer.first(),
+            layerHandleId(layers[i].second()),
+            nodeFirstDataIds[i],
+            nodeDataCounts[i],
+            nodeNextDataIds[i],
             visibleNodeEventDataOffsets,
             visibleEventNodeMask,
             visibleNodeEventData);
@@ -2234,21 +2631,206 @@ void AbstractUserInterfaceImplementationTest::countOrderNodeDataForEventHandling
     }), TestSuite::Compare::Container);
     CORRADE_COMPARE_AS(Containers::arrayView(visibleNodeEventData).prefix(Containers::arrayView(visibleNodeEventDataOffsets).back()), Containers::arrayView({
         /* Node 2 */
-        dataHandle(layer3, 0, 0xfff),
-        dataHandle(layer2, 6, 0xfff),
+        Implementation::nodeEventData(3, 0),
+        Implementation::nodeEventData(2, 6),
         /* Node 3. Order of items from the same layer matches inverse data ID
            order, not the order in which they were created or attached. */
-        dataHandle(layer5, 2, 0xfff),
-        dataHandle(layer5, 1, 0xfff),
-        dataHandle(layer2, 3, 0xfff),
+        Implementation::nodeEventData(5, 2),
+        Implementation::nodeEventData(5, 1),
+        Implementation::nodeEventData(2, 3),
         /* Node 4 */
-        dataHandle(layer2, 2, 0xfff),
+        Implementation::nodeEventData(2, 2),
         /* Node 7 */
-        dataHandle(layer3, 2, 0xfff),
+        Implementation::nodeEventData(3, 2),
         /* Node 8 isn't visible */
         /* Node 12 */
-        dataHandle(layer2, 4, 0xfff)
+        Implementation::nodeEventData(2, 4)
     }), TestSuite::Compare::Container);
+
+    /* The packed data unpack back to the original IDs */
+    CORRADE_COMPARE(Implementation::nodeEventDataLayerId(visibleNodeEventData[1]), 2);
+    CORRADE_COMPARE(Implementation::nodeEventDataId(visibleNodeEventData[1]), 6);
+    CORRADE_COMPARE(Implementation::nodeEventDataLayerId(Implementation::nodeEventData(0xff, 0xfffff)), 0xff);
+    CORRADE_COMPARE(Implementation::nodeEventDataId(Implementation::nodeEventData(0xff, 0xfffff)), 0xfffff);
+}
+
+void AbstractUserInterfaceImplementationTest::nodeEventBounds() {
+    const struct Node {
+        Vector2 offset;
+        Vector2 size;
+    } nodes[]{
+        /* Top-level node without data, with two children */
+        {{  0.0f,  0.0f}, {100.0f, 100.0f}},    /* 0 */
+        /* Child with data */
+        {{ 10.0f, 10.0f}, { 20.0f,  20.0f}},    /* 1 */
+        /* Child without data that's partially outside of the parent */
+        {{ 50.0f, 50.0f}, { 80.0f,  80.0f}},    /* 2 */
+        /* Child of node 2 with data, partially outside of node 0 */
+        {{ 90.0f, 60.0f}, { 30.0f,  10.0f}},    /* 3 */
+        /* Top-level node without data */
+        {{200.0f,  0.0f}, { 10.0f,  10.0f}},    /* 4 */
+        /* Top-level node with data but not accepting events */
+        {{  0.0f,  0.0f}, {  5.0f,   5.0f}},    /* 5 */
+        /* Node that isn't visible */
+        {{  0.0f,  0.0f}, {  5.0f,   5.0f}},    /* 6 */
+    };
+
+    const Containers::Pair<UnsignedInt, UnsignedInt> visibleNodeIdsChildrenCount[]{
+        {0, 3},
+            {1, 0},
+            {2, 1},
+                {3, 0},
+        {4, 0},
+        {5, 0},
+    };
+
+    /* Node 1, 3 and 5 have one data each */
+    const UnsignedInt visibleNodeEventDataOffsets[]{
+        0, 0, 1, 1, 2, 2, 3, 3
+    };
+    const char visibleEventNodeMask[]{0x1f};
+
+    Vector2 boundsMin[Containers::arraySize(nodes)];
+    Vector2 boundsMax[Containers::arraySize(nodes)];
+    /* Items for nodes that aren't visible should stay untouched */
+    boundsMin[6] = Vector2{1337.0f};
+    boundsMax[6] = Vector2{-1337.0f};
+    Implementation::nodeEventBoundsInto(
+        Containers::stridedArrayView(visibleNodeIdsChildrenCount).slice(&Containers::Pair<UnsignedInt, UnsignedInt>::first),
+        Containers::stridedArrayView(visibleNodeIdsChildrenCount).slice(&Containers::Pair<UnsignedInt, UnsignedInt>::second),
+        Containers::stridedArrayView(nodes).slice(&Node::offset),
+        Containers::stridedArrayView(nodes).slice(&Node::size),
+        Containers::BitArrayView{visibleEventNodeMask, 0, Containers::arraySize(nodes)},
+        visibleNodeEventDataOffsets,
+        boundsMin,
+        boundsMax);
+    CORRADE_COMPARE_AS(Containers::arrayView(boundsMin), Containers::arrayView<Vector2>({
+        /* Union of node 1 and the part of node 3 inside node 0 */
+        {10.0f, 10.0f},
+        {10.0f, 10.0f},
+        /* Node 3 and its part that's inside node 2 */
+        {90.0f, 60.0f},
+        {90.0f, 60.0f},
+        /* Empty */
+        Vector2{Constants::inf()},
+        Vector2{Constants::inf()},
+        Vector2{1337.0f},
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(Containers::arrayView(boundsMax), Containers::arrayView<Vector2>({
+        {100.0f, 70.0f},
+        {30.0f, 30.0f},
+        {120.0f, 70.0f},
+        {120.0f, 70.0f},
+        Vector2{-Constants::inf()},
+        Vector2{-Constants::inf()},
+        Vector2{-1337.0f},
+    }), TestSuite::Compare::Container);
+}
+
+void AbstractUserInterfaceImplementationTest::mergeDisjointTopLevelNodeDraws() {
+    /* Node 2 clips node 3, which is thus outside of it. The visible node
+       mask and the clip rects aren't calculated but set directly. */
+    const Containers::Pair<Vector2, Vector2> nodeOffsetsSizes[]{
+        {{ 0.0f,  0.0f}, {10.0f, 10.0f}},   /* 0, top-level */
+        {{10.0f,  0.0f}, {10.0f, 10.0f}},   /* 1, top-level, right of 0 */
+        {{ 0.0f, 20.0f}, {10.0f, 10.0f}},   /* 2, top-level, below 0 */
+        {{ 5.0f,  5.0f}, {10.0f, 10.0f}},   /* 3, child of 2, clipped away */
+        {{15.0f,  5.0f}, {10.0f, 10.0f}},   /* 4, top-level, overlaps 1 */
+        {{30.0f,  0.0f}, { 5.0f,  5.0f}},   /* 5, top-level, composited */
+        {{40.0f,  0.0f}, { 5.0f,  5.0f}},   /* 6, top-level */
+    };
+    const UnsignedInt visibleNodeIds[]{0, 1, 2, 3, 4, 5, 6};
+    const UnsignedInt visibleNodeChildrenCounts[]{0, 0, 1, 0, 0, 0, 0};
+    const char visibleNodeMask[]{0x7f};
+    const Containers::Pair<Vector2, Vector2> clipRectOffsetsSizes[]{
+        {{}, {}},                           /* nodes 0, 1, 2 */
+        {{0.0f, 20.0f}, {10.0f, 10.0f}},    /* node 3 */
+        {{}, {}},                           /* nodes 4, 5, 6 */
+    };
+    const UnsignedInt clipRectNodeCounts[]{3, 1, 3};
+
+    /* Layer 5 is compositing */
+    const LayerFeatures layerFeatures[]{
+        {}, {},
+        LayerFeature::Draw,
+        LayerFeature::Draw,
+        {},
+        LayerFeature::Draw|LayerFeature::Composite,
+    };
+
+    /* Three drawing layers for each of the six top-level nodes */
+    Containers::Triple<UnsignedByte, Containers::Pair<UnsignedInt, UnsignedInt>, Containers::Pair<UnsignedInt, UnsignedInt>> draws[]{
+        {2, {0, 1}, {0, 1}},    /* Node 0 */
+        {3, {0, 0}, {0, 0}},
+        {5, {0, 0}, {0, 0}},
+        {2, {1, 2}, {1, 1}},    /* Node 1 */
+        {3, {0, 1}, {0, 1}},
+        {5, {0, 0}, {0, 0}},
+        {2, {3, 2}, {2, 2}},    /* Node 2 and 3 */
+        {3, {1, 3}, {1, 2}},
+        {5, {0, 0}, {0, 0}},
+        {2, {5, 1}, {4, 1}},    /* Node 4 */
+        {3, {0, 0}, {0, 0}},
+        {5, {0, 0}, {0, 0}},
+        {2, {6, 1}, {5, 1}},    /* Node 5 */
+        {3, {0, 0}, {0, 0}},
+        {5, {0, 1}, {0, 1}},
+        {2, {7, 1}, {6, 1}},    /* Node 6 */
+        {3, {4, 1}, {3, 1}},
+        {5, {0, 0}, {0, 0}},
+    };
+
+    Implementation::mergeDisjointTopLevelNodeDrawsInPlace(
+        visibleNodeIds,
+        visibleNodeChildrenCounts,
+        Containers::stridedArrayView(nodeOffsetsSizes).slice(&Containers::Pair<Vector2, Vector2>::first),
+        Containers::stridedArrayView(nodeOffsetsSizes).slice(&Containers::Pair<Vector2, Vector2>::second),
+        Containers::BitArrayView{visibleNodeMask, 0, Containers::arraySize(nodeOffsetsSizes)},
+        Containers::stridedArrayView(clipRectOffsetsSizes).slice(&Containers::Pair<Vector2, Vector2>::first),
+        Containers::stridedArrayView(clipRectOffsetsSizes).slice(&Containers::Pair<Vector2, Vector2>::second),
+        clipRectNodeCounts,
+        layerFeatures,
+        3,
+        Containers::stridedArrayView(draws)
+            .slice(&Containers::Triple<UnsignedByte, Containers::Pair<UnsignedInt, UnsignedInt>, Containers::Pair<UnsignedInt, UnsignedInt>>::first),
+        Containers::stridedArrayView(draws)
+            .slice(&Containers::Triple<UnsignedByte, Containers::Pair<UnsignedInt, UnsignedInt>, Containers::Pair<UnsignedInt, UnsignedInt>>::second)
+            .slice(&Containers::Pair<UnsignedInt, UnsignedInt>::first),
+        Containers::stridedArrayView(draws)
+            .slice(&Containers::Triple<UnsignedByte, Containers::Pair<UnsignedInt, UnsignedInt>, Containers::Pair<UnsignedInt, UnsignedInt>>::second)
+            .slice(&Containers::Pair<UnsignedInt, UnsignedInt>::second),
+        Containers::stridedArrayView(draws)
+            .slice(&Containers::Triple<UnsignedByte, Containers::Pair<UnsignedInt, UnsignedInt>, Containers::Pair<UnsignedInt, UnsignedInt>>::third)
+            .slice(&Containers::Pair<UnsignedInt, UnsignedInt>::first),
+        Containers::stridedArrayView(draws)
+            .slice(&Containers::Triple<UnsignedByte, Containers::Pair<UnsignedInt, UnsignedInt>, Containers::Pair<UnsignedInt, UnsignedInt>>::third)
+            .slice(&Containers::Pair<UnsignedInt, UnsignedInt>::second));
+    CORRADE_COMPARE_AS(Containers::arrayView(draws), (Containers::arrayView<Containers::Triple<UnsignedByte, Containers::Pair<UnsignedInt, UnsignedInt>, Containers::Pair<UnsignedInt, UnsignedInt>>>({
+        /* Node 0, 1 and 2 don't overlap (and node 3 is clipped away), so
+           they're all merged together */
+        {2, {0, 5}, {0, 4}},
+        {3, {0, 4}, {0, 3}},
+        {5, {0, 0}, {0, 0}},
+        {2, {0, 0}, {0, 0}},
+        {3, {0, 0}, {0, 0}},
+        {5, {0, 0}, {0, 0}},
+        {2, {0, 0}, {0, 0}},
+        {3, {0, 0}, {0, 0}},
+        {5, {0, 0}, {0, 0}},
+        /* Node 4 overlaps node 1 and so starts a new sequence */
+        {2, {5, 1}, {4, 1}},
+        {3, {0, 0}, {0, 0}},
+        {5, {0, 0}, {0, 0}},
+        /* Node 5 doesn't overlap but is composited, so it's kept as-is and
+           ends the sequence */
+        {2, {6, 1}, {5, 1}},
+        {3, {0, 0}, {0, 0}},
+        {5, {0, 1}, {0, 1}},
+        /* Node 6 thus starts a new sequence as well */
+        {2, {7, 1}, {6, 1}},
+        {3, {4, 1}, {3, 1}},
+        {5, {0, 0}, {0, 0}},
+    })), TestSuite::Compare::Container);
 }
 
 void AbstractUserInterfaceImplementationTest::compactDraws() {
@@ -2261,10 +2843,22 @@ void AbstractUserInterfaceImplementationTest::compactDraws() {
         {3, {0, 226}, {26, 78}},
         {4, {0, 6777}, {1, 233}},
         {4, {0, 0}, {0, 0}},
-        {4, {6777, 2}, {233, 16}}
+        {4, {6777, 2}, {233, 16}},
+        {5, {10, 4}, {3, 2}},
+        {5, {14, 1}, {5, 1}}
+    };
+
+    /* Layer 5 is compositing, so its draws shouldn't get merged */
+    const LayerFeatures layerFeatures[]{
+        {}, {}, {}, {},
+        LayerFeature::Draw,
+        LayerFeature::Draw|LayerFeature::Composite,
+        {}, {},
+        LayerFeature::Draw
     };
 
     UnsignedInt count = Implementation::compactDrawsInPlace(
+        layerFeatures,
         Containers::stridedArrayView(draws)
             .slice(&Containers::Triple<UnsignedByte, Containers::Pair<UnsignedInt, UnsignedInt>, Containers::Pair<UnsignedInt, UnsignedInt>>::first),
         Containers::stridedArrayView(draws)
@@ -2286,9 +2880,12 @@ void AbstractUserInterfaceImplementationTest::compactDraws() {
         {3, {226, 762}, {27, 46}},
         {8, {18, 2}, {1, 33}},
         {3, {0, 226}, {26, 78}},
-        /* These two *could* get merged together eventually. So far aren't. */
-        {4, {0, 6777}, {1, 233}},
-        {4, {6777, 2}, {233, 16}}
+        /* These two are adjacent and from the same layer, so they get
+           merged */
+        {4, {0, 6779}, {1, 249}},
+        /* These are adjacent as well but the layer is compositing */
+        {5, {10, 4}, {3, 2}},
+        {5, {14, 1}, {5, 1}}
     })), TestSuite::Compare::Container);
 }
 
@@ -276,14 +276,14 @@ void AbstractVisualLayerStyleAnimatorTest::propertiesInvalid() {
     animator.targetStyle(AnimationHandle::Null);
     animator.dynamicStyle(AnimationHandle::Null);
     /* Valid animator, invalid data */
-    animator.targetStyle(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
-    animator.dynamicStyle(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
+    animator.targetStyle(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)));
+    animator.dynamicStyle(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)));
     /* Invalid animator, valid data */
     animator.targetStyle(animationHandle(AnimatorHandle::Null, animationHandleData(handle)));
     animator.dynamicStyle(animationHandle(AnimatorHandle::Null, animationHandleData(handle)));
     /* AnimatorDataHandle directly */
-    animator.targetStyle(AnimatorDataHandle(0x123abcde));
-    animator.dynamicStyle(AnimatorDataHandle(0x123abcde));
+    animator.targetStyle(animatorDataHandle(0xabcde, 0x123));
+    animator.dynamicStyle(animatorDataHandle(0xabcde, 0x123));
     CORRADE_COMPARE_AS(out.str(),
         "Ui::AbstractVisualLayerStyleAnimator::targetStyle(): invalid handle Ui::AnimationHandle::Null\n"
         "Ui::AbstractVisualLayerStyleAnimator::dynamicStyle(): invalid handle Ui::AnimationHandle::Null\n"
@@ -65,10 +65,14 @@ struct AbstractVisualLayerTest: TestSuite::Tester {
     template<class T> void setStyle();
     void setTransitionedStyle();
     void setTransitionedStyleInEvent();
+    void setStyleMultiple();
+    void setTransitionedStyleMultiple();
+    void remapStyles();
     void invalidHandle();
     void styleOutOfRange();
 
     void dynamicStyleAllocateRecycle();
+    void dynamicStyleAllocateRecycleMany();
     void dynamicStyleAllocateNoDynamicStyles();
     void dynamicStyleRecycleInvalid();
 
@@ -78,6 +82,7 @@ struct AbstractVisualLayerTest: TestSuite::Tester {
     void eventStyleTransitionNodeNoLongerFocusable();
     void eventStyleTransitionNoHover();
     void eventStyleTransitionDisabled();
+    void eventStyleTransitionDisabledIncremental();
     void eventStyleTransitionNoCapture();
     void eventStyleTransitionOutOfRange();
     void eventStyleTransitionDynamicStyle();
@@ -306,12 +311,16 @@ AbstractVisualLayerTest::AbstractVisualLayerTest() {
 
     addTests({&AbstractVisualLayerTest::setTransitionedStyle,
               &AbstractVisualLayerTest::setTransitionedStyleInEvent,
+              &AbstractVisualLayerTest::setStyleMultiple,
+              &AbstractVisualLayerTest::setTransitionedStyleMultiple,
+              &AbstractVisualLayerTest::remapStyles,
               &AbstractVisualLayerTest::invalidHandle});
 
     addInstancedTests({&AbstractVisualLayerTest::styleOutOfRange},
         Containers::arraySize(StyleOutOfRangeData));
 
     addTests({&AbstractVisualLayerTest::dynamicStyleAllocateRecycle,
+              &AbstractVisualLayerTest::dynamicStyleAllocateRecycleMany,
               &AbstractVisualLayerTest::dynamicStyleAllocateNoDynamicStyles,
               &AbstractVisualLayerTest::dynamicStyleRecycleInvalid});
 
@@ -327,6 +336,8 @@ AbstractVisualLayerTest::AbstractVisualLayerTest() {
     addInstancedTests({&AbstractVisualLayerTest::eventStyleTransitionDisabled},
         Containers::arraySize(EventStyleTransitionDisabledData));
 
+    addTests({&AbstractVisualLayerTest::eventStyleTransitionDisabledIncremental});
+
     addInstancedTests({&AbstractVisualLayerTest::eventStyleTransitionNoCapture},
         Containers::arraySize(EventStyleTransitionNoCaptureData));
 
@@ -1177,6 +1188,128 @@ void AbstractVisualLayerTest::setTransitionedStyleInEvent() {
     }
 }
 
+void AbstractVisualLayerTest::setStyleMultiple() {
+    StyleLayerShared shared{5, 2};
+    StyleLayer layer{layerHandle(0, 1), shared};
+
+    DataHandle data0 = layer.create(0);
+    DataHandle data1 = layer.create(1);
+    DataHandle data2 = layer.create(2);
+    DataHandle data3 = layer.create(3);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Empty views do nothing */
+    layer.setStyle(Containers::StridedArrayView1D<const DataHandle>{}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Setting styles of a subset, in random order and including a dynamic
+       style, marks just those as modified */
+    DataHandle handles[]{data3, data0, data2};
+    UnsignedInt styles[]{6, 4, 3};
+    layer.setStyle(handles, styles);
+    CORRADE_COMPARE(layer.style(data0), 4);
+    CORRADE_COMPARE(layer.style(data1), 1);
+    CORRADE_COMPARE(layer.style(data2), 3);
+    CORRADE_COMPARE(layer.style(data3), 6);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+    CORRADE_COMPARE_AS(layer.modifiedDataMask(), Containers::stridedArrayView({
+        true, false, true, true
+    }).sliceBit(0), TestSuite::Compare::Container);
+}
+
+void AbstractVisualLayerTest::setTransitionedStyleMultiple() {
+    AbstractUserInterface ui{{100, 100}};
+
+    /* Each transition maps to a distinct style, leaving the original one as
+       an offset so the test can verify which transition got used */
+    StyleLayerShared shared{36, 0};
+    shared.setStyleTransition(
+        [](UnsignedInt style) -> UnsignedInt { return style % 6 + 0*6; },
+        [](UnsignedInt style) -> UnsignedInt { return style % 6 + 1*6; },
+        [](UnsignedInt style) -> UnsignedInt { return style % 6 + 2*6; },
+        [](UnsignedInt style) -> UnsignedInt { return style % 6 + 3*6; },
+        [](UnsignedInt style) -> UnsignedInt { return style % 6 + 4*6; },
+        [](UnsignedInt style) -> UnsignedInt { return style % 6 + 5*6; },
+        [](UnsignedInt) -> UnsignedInt {
+            CORRADE_FAIL("This shouldn't be called");
+            CORRADE_INTERNAL_ASSERT_UNREACHABLE();
+        });
+    StyleLayer& layer = ui.setLayerInstance(Containers::pointer<StyleLayer>(ui.createLayer(), shared));
+
+    NodeHandle node0 = ui.createNode({}, {100, 50}, NodeFlag::Focusable);
+    NodeHandle node1 = ui.createNode({0, 50}, {100, 50});
+    NodeHandle node2 = ui.createNode({}, {10, 10});
+    DataHandle data0 = layer.create(0, node0);
+    DataHandle data1 = layer.create(0, node1);
+    DataHandle data2 = layer.create(0, node2);
+    /* Not attached anywhere */
+    DataHandle data3 = layer.create(0);
+
+    /* Focus node 0, hover node 1 */
+    {
+        FocusEvent event{{}};
+        CORRADE_VERIFY(ui.focusEvent(node0, event));
+    } {
+        PointerMoveEvent event{{}, PointerEventSource::Mouse, {}, {}, true, 0};
+        CORRADE_VERIFY(ui.pointerMoveEvent({50, 75}, event));
+    }
+    CORRADE_COMPARE(ui.currentPressedNode(), NodeHandle::Null);
+    CORRADE_COMPARE(ui.currentHoveredNode(), node1);
+    CORRADE_COMPARE(ui.currentFocusedNode(), node0);
+
+    /* Clear the state flags */
+    ui.update();
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* The bulk variant should pick the same transition as the single-handle
+       one for each data */
+    DataHandle handles[]{data2, data3, data0, data1};
+    UnsignedInt styles[]{3, 4, 1, 2};
+    layer.setTransitionedStyle(ui, handles, styles);
+    CORRADE_COMPARE(layer.style(data0), 1 + 2*6);
+    CORRADE_COMPARE(layer.style(data1), 2 + 1*6);
+    CORRADE_COMPARE(layer.style(data2), 3 + 0*6);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+    UnsignedInt data3Style = layer.style(data3);
+    layer.setTransitionedStyle(ui, data3, 4);
+    CORRADE_COMPARE(layer.style(data3), data3Style);
+}
+
+void AbstractVisualLayerTest::remapStyles() {
+    StyleLayerShared shared{4, 2};
+    StyleLayer layer{layerHandle(0, 1), shared};
+
+    DataHandle data0 = layer.create(0);
+    DataHandle data1 = layer.create(1);
+    DataHandle data2 = layer.create(3);
+    /* Dynamic style, stays untouched */
+    DataHandle data3 = layer.create(5);
+    DataHandle data4 = layer.create(2);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Identity mapping doesn't mark anything as modified */
+    layer.remapStyles(Containers::arrayView<UnsignedInt>({0, 1, 2, 3}));
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Style 2 stays as is, so data 4 isn't marked as modified */
+    layer.remapStyles(Containers::arrayView<UnsignedInt>({1, 3, 2, 0}));
+    CORRADE_COMPARE(layer.style(data0), 1);
+    CORRADE_COMPARE(layer.style(data1), 3);
+    CORRADE_COMPARE(layer.style(data2), 0);
+    CORRADE_COMPARE(layer.style(data3), 5);
+    CORRADE_COMPARE(layer.style(data4), 2);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+    CORRADE_COMPARE_AS(layer.modifiedDataMask(), Containers::stridedArrayView({
+        true, true, true, false, false
+    }).sliceBit(0), TestSuite::Compare::Container);
+}
+
 void AbstractVisualLayerTest::invalidHandle() {
     CORRADE_SKIP_IF_NO_ASSERT();
 
@@ -1188,8 +1321,12 @@ void AbstractVisualLayerTest::invalidHandle() {
 
     struct Layer: AbstractVisualLayer {
         explicit Layer(LayerHandle handle, Shared& shared): AbstractVisualLayer{handle, shared} {}
+
+        using AbstractVisualLayer::create;
     } layer{layerHandle(0, 1), shared};
 
+    DataHandle handle = layer.create();
+
     std::ostringstream out;
     Error redirectError{&out};
     layer.style(DataHandle::Null);
@@ -1198,13 +1335,17 @@ void AbstractVisualLayerTest::invalidHandle() {
     layer.setStyle(LayerDataHandle::Null, 0);
     layer.setTransitionedStyle(ui, DataHandle::Null, 0);
     layer.setTransitionedStyle(ui, LayerDataHandle::Null, 0);
+    layer.setStyle(Containers::arrayView({handle, DataHandle::Null}), Containers::arrayView<UnsignedInt>({0, 0}));
+    layer.setTransitionedStyle(ui, Containers::arrayView({handle, DataHandle::Null}), Containers::arrayView<UnsignedInt>({0, 0}));
     CORRADE_COMPARE(out.str(),
         "Ui::AbstractVisualLayer::style(): invalid handle Ui::DataHandle::Null\n"
         "Ui::AbstractVisualLayer::style(): invalid handle Ui::LayerDataHandle::Null\n"
         "Ui::AbstractVisualLayer::setStyle(): invalid handle Ui::DataHandle::Null\n"
         "Ui::AbstractVisualLayer::setStyle(): invalid handle Ui::LayerDataHandle::Null\n"
         "Ui::AbstractVisualLayer::setTransitionedStyle(): invalid handle Ui::DataHandle::Null\n"
-        "Ui::AbstractVisualLayer::setTransitionedStyle(): invalid handle Ui::LayerDataHandle::Null\n");
+        "Ui::AbstractVisualLayer::setTransitionedStyle(): invalid handle Ui::LayerDataHandle::Null\n"
+        "Ui::AbstractVisualLayer::setStyle(): invalid handle Ui::DataHandle::Null at index 1\n"
+        "Ui::AbstractVisualLayer::setTransitionedStyle(): invalid handle Ui::DataHandle::Null at index 1\n");
 }
 
 void AbstractVisualLayerTest::styleOutOfRange() {
@@ -1233,11 +1374,23 @@ void AbstractVisualLayerTest::styleOutOfRange() {
     layer.setStyle(dataHandleData(layerData), 3);
     layer.setTransitionedStyle(ui, layerData, data.styleCount);
     layer.setTransitionedStyle(ui, dataHandleData(layerData), data.styleCount);
+    layer.setStyle(Containers::arrayView({layerData, layerData}), Containers::arrayView<UnsignedInt>({0, 3}));
+    layer.setTransitionedStyle(ui, Containers::arrayView({layerData, layerData}), Containers::arrayView<UnsignedInt>({0, data.styleCount}));
+    layer.setStyle(Containers::arrayView({layerData, layerData}), Containers::arrayView<UnsignedInt>({0}));
+    layer.setTransitionedStyle(ui, Containers::arrayView({layerData, layerData}), Containers::arrayView<UnsignedInt>({0}));
+    layer.remapStyles(Containers::arrayView<UnsignedInt>({0}));
+    layer.remapStyles(Containers::arrayView({0u, data.styleCount, 0u}).prefix(data.styleCount));
     CORRADE_COMPARE(out.str(), Utility::formatString(
         "Ui::AbstractVisualLayer::setStyle(): style 3 out of range for 3 styles\n"
         "Ui::AbstractVisualLayer::setStyle(): style 3 out of range for 3 styles\n"
         "Ui::AbstractVisualLayer::setTransitionedStyle(): style {0} out of range for {0} styles\n"
-        "Ui::AbstractVisualLayer::setTransitionedStyle(): style {0} out of range for {0} styles\n", data.styleCount));
+        "Ui::AbstractVisualLayer::setTransitionedStyle(): style {0} out of range for {0} styles\n"
+        "Ui::AbstractVisualLayer::setStyle(): style 3 at index 1 out of range for 3 styles\n"
+        "Ui::AbstractVisualLayer::setTransitionedStyle(): style {0} at index 1 out of range for {0} styles\n"
+        "Ui::AbstractVisualLayer::setStyle(): expected styles to have 2 items but got 1\n"
+        "Ui::AbstractVisualLayer::setTransitionedStyle(): expected styles to have 2 items but got 1\n"
+        "Ui::AbstractVisualLayer::remapStyles(): expected mapping to have {0} items but got 1\n"
+        "Ui::AbstractVisualLayer::remapStyles(): style {0} at index 1 out of range for {0} styles\n", data.styleCount));
 }
 
 void AbstractVisualLayerTest::dynamicStyleAllocateRecycle() {
@@ -1253,6 +1406,7 @@ void AbstractVisualLayerTest::dynamicStyleAllocateRecycle() {
 
     CORRADE_COMPARE(shared.dynamicStyleCount(), 5);
     CORRADE_COMPARE(layer.dynamicStyleUsedCount(), 0);
+    CORRADE_COMPARE(layer.dynamicStyleUsedMaxCount(), 0);
 
     Containers::Optional<UnsignedInt> first = layer.allocateDynamicStyle();
     CORRADE_COMPARE(first, 0);
@@ -1260,10 +1414,10 @@ void AbstractVisualLayerTest::dynamicStyleAllocateRecycle() {
     CORRADE_COMPARE(layer.dynamicStyleAnimation(0), AnimationHandle::Null);
 
     /* Remember an associated animation handle */
-    Containers::Optional<UnsignedInt> second = layer.allocateDynamicStyle(AnimationHandle(0x12ab34567cde));
+    Containers::Optional<UnsignedInt> second = layer.allocateDynamicStyle(animationHandle(AnimatorHandle(0x12ab), 0x67cde, 0x345));
     CORRADE_COMPARE(second, 1);
     CORRADE_COMPARE(layer.dynamicStyleUsedCount(), 2);
-    CORRADE_COMPARE(layer.dynamicStyleAnimation(1), AnimationHandle(0x12ab34567cde));
+    CORRADE_COMPARE(layer.dynamicStyleAnimation(1), animationHandle(AnimatorHandle(0x12ab), 0x67cde, 0x345));
 
     Containers::Optional<UnsignedInt> third = layer.allocateDynamicStyle();
     CORRADE_COMPARE(third, 2);
@@ -1288,6 +1442,8 @@ void AbstractVisualLayerTest::dynamicStyleAllocateRecycle() {
     layer.recycleDynamicStyle(*fourth);
     CORRADE_COMPARE(layer.dynamicStyleUsedCount(), 1);
     CORRADE_COMPARE(layer.dynamicStyleAnimation(*fourth), AnimationHandle::Null);
+    /* The max count stays at the high-water mark */
+    CORRADE_COMPARE(layer.dynamicStyleUsedMaxCount(), 4);
 
     /* Allocating new ones simply picks up the first free */
     Containers::Optional<UnsignedInt> second2 = layer.allocateDynamicStyle();
@@ -1313,6 +1469,51 @@ void AbstractVisualLayerTest::dynamicStyleAllocateRecycle() {
 
     /* It's not possible to allocate any more at this point */
     CORRADE_COMPARE(layer.allocateDynamicStyle(), Containers::NullOpt);
+    CORRADE_COMPARE(layer.dynamicStyleUsedMaxCount(), 5);
+
+    /* Resetting the max count sets it to the current count */
+    layer.recycleDynamicStyle(*third2);
+    layer.recycleDynamicStyle(*first2);
+    CORRADE_COMPARE(layer.dynamicStyleUsedCount(), 3);
+    CORRADE_COMPARE(layer.dynamicStyleUsedMaxCount(), 5);
+    layer.resetDynamicStyleUsedMaxCount();
+    CORRADE_COMPARE(layer.dynamicStyleUsedMaxCount(), 3);
+
+    /* The lowest free index is picked again, even if a higher one was
+       recycled last */
+    CORRADE_COMPARE(layer.allocateDynamicStyle(), 0);
+    CORRADE_COMPARE(layer.allocateDynamicStyle(), 2);
+    CORRADE_COMPARE(layer.dynamicStyleUsedMaxCount(), 5);
+}
+
+void AbstractVisualLayerTest::dynamicStyleAllocateRecycleMany() {
+    struct LayerShared: AbstractVisualLayer::Shared {
+        explicit LayerShared(UnsignedInt styleCount, UnsignedInt dynamicStyleCount): AbstractVisualLayer::Shared{styleCount, dynamicStyleCount} {}
+    } shared{3, 37};
+
+    struct Layer: AbstractVisualLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): AbstractVisualLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+
+    /* Allocate all, which goes over several whole bytes and ends in the
+       middle of one */
+    for(UnsignedInt i = 0; i != 37; ++i)
+        CORRADE_COMPARE(layer.allocateDynamicStyle(), i);
+    CORRADE_COMPARE(layer.allocateDynamicStyle(), Containers::NullOpt);
+    CORRADE_COMPARE(layer.dynamicStyleUsedCount(), 37);
+
+    /* Recycle a few in various bytes, the lowest is picked each time,
+       skipping the fully used bytes */
+    layer.recycleDynamicStyle(35);
+    layer.recycleDynamicStyle(17);
+    layer.recycleDynamicStyle(24);
+    CORRADE_COMPARE(layer.dynamicStyleUsedCount(), 34);
+    CORRADE_COMPARE(layer.allocateDynamicStyle(), 17);
+    CORRADE_COMPARE(layer.allocateDynamicStyle(), 24);
+    CORRADE_COMPARE(layer.allocateDynamicStyle(), 35);
+    CORRADE_COMPARE(layer.allocateDynamicStyle(), Containers::NullOpt);
+    CORRADE_COMPARE(layer.dynamicStyleUsedCount(), 37);
+    CORRADE_COMPARE(layer.dynamicStyleUsedMaxCount(), 37);
 }
 
 void AbstractVisualLayerTest::dynamicStyleAllocateNoDynamicStyles() {
@@ -2982,6 +3183,73 @@ void AbstractVisualLayerTest::eventStyleTransitionDisabled() {
     CORRADE_COMPARE(StyleIndex(layer.stateData().calculatedStyles[dataHandleId(dataWhite)]), StyleIndex::White);
 }
 
+void AbstractVisualLayerTest::eventStyleTransitionDisabledIncremental() {
+    AbstractUserInterface ui{{100, 100}};
+
+    NodeHandle nodeGreen = ui.createNode({}, {100, 100});
+    NodeHandle nodeRed = ui.createNode({}, {100, 100});
+    NodeHandle nodeBlue = ui.createNode({}, {100, 100});
+
+    StyleLayerShared shared{StyleCount, 0};
+    StyleLayer& layer = ui.setLayerInstance(Containers::pointer<StyleLayer>(ui.createLayer(), shared));
+    DataHandle dataGreen = layer.create(StyleIndex::Green, nodeGreen);
+    DataHandle dataRed = layer.create(StyleIndex::Red, nodeRed);
+    DataHandle dataBlue = layer.create(StyleIndex::Blue, nodeBlue);
+
+    static Int called;
+    called = 0;
+    shared.setStyleTransition(
+        nullptr,
+        nullptr,
+        nullptr,
+        nullptr,
+        nullptr,
+        nullptr,
+        [](UnsignedInt s) {
+            ++called;
+            return UnsignedInt(styleIndexTransitionToDisabled(StyleIndex(s)));
+        });
+
+    /* Nothing is disabled initially, so the transition isn't called at all */
+    ui.update();
+    CORRADE_COMPARE(called, 0);
+
+    /* Disabling a node calls the transition just for its data */
+    ui.addNodeFlags(nodeRed, NodeFlag::Disabled);
+    CORRADE_COMPARE(ui.state(), UserInterfaceState::NeedsNodeEnabledUpdate);
+    ui.update();
+    CORRADE_COMPARE(called, 1);
+    CORRADE_COMPARE(StyleIndex(layer.stateData().calculatedStyles[dataHandleId(dataRed)]), StyleIndex::RedBlueDisabled);
+
+    /* Disabling another doesn't recalculate the already disabled one */
+    ui.addNodeFlags(nodeBlue, NodeFlag::Disabled);
+    ui.update();
+    CORRADE_COMPARE(called, 2);
+    CORRADE_COMPARE(StyleIndex(layer.stateData().calculatedStyles[dataHandleId(dataRed)]), StyleIndex::RedBlueDisabled);
+    CORRADE_COMPARE(StyleIndex(layer.stateData().calculatedStyles[dataHandleId(dataBlue)]), StyleIndex::RedBlueDisabled);
+
+    /* Changing style of a disabled data recalculates just that one */
+    layer.setStyle(dataBlue, StyleIndex::Green);
+    ui.update();
+    CORRADE_COMPARE(called, 3);
+    CORRADE_COMPARE(StyleIndex(layer.stateData().calculatedStyles[dataHandleId(dataBlue)]), StyleIndex::GreenDisabled);
+
+    /* Enabling a node goes back to the original style without calling the
+       transition */
+    ui.clearNodeFlags(nodeRed, NodeFlag::Disabled);
+    ui.update();
+    CORRADE_COMPARE(called, 3);
+    CORRADE_COMPARE(StyleIndex(layer.stateData().calculatedStyles[dataHandleId(dataGreen)]), StyleIndex::Green);
+    CORRADE_COMPARE(StyleIndex(layer.stateData().calculatedStyles[dataHandleId(dataRed)]), StyleIndex::Red);
+    CORRADE_COMPARE(StyleIndex(layer.stateData().calculatedStyles[dataHandleId(dataBlue)]), StyleIndex::GreenDisabled);
+
+    /* A change in the set of visible data recalculates everything */
+    ui.setNodeOffset(nodeGreen, {1.0f, 0.0f});
+    ui.update();
+    CORRADE_COMPARE(called, 4);
+    CORRADE_COMPARE(StyleIndex(layer.stateData().calculatedStyles[dataHandleId(dataBlue)]), StyleIndex::GreenDisabled);
+}
+
 void AbstractVisualLayerTest::eventStyleTransitionNoCapture() {
     auto&& data = EventStyleTransitionNoCaptureData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
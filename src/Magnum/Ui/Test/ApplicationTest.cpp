@@ -54,6 +54,10 @@ struct ApplicationTest: TestSuite::Tester {
     void keyPressEvent();
     void keyReleaseEvent();
     void textInputEvent();
+
+    void pointerMoveEventBenchmark();
+    void keyPressEventBenchmark();
+    void textInputEventBenchmark();
 };
 
 enum class CustomPointerEventSource {
@@ -533,6 +537,14 @@ const struct {
     {"", true}
 };
 
+const struct {
+    const char* name;
+    bool converted;
+} EventBenchmarkData[]{
+    {"Ui event", false},
+    {"application event", true}
+};
+
 ApplicationTest::ApplicationTest() {
     addInstancedTests({&ApplicationTest::pointerPressEvent},
         Containers::arraySize(PointerPressReleaseEventData));
@@ -564,6 +576,11 @@ ApplicationTest::ApplicationTest() {
 
     addInstancedTests({&ApplicationTest::textInputEvent},
         Containers::arraySize(TextInputEventData));
+
+    addInstancedBenchmarks({&ApplicationTest::pointerMoveEventBenchmark,
+                            &ApplicationTest::keyPressEventBenchmark,
+                            &ApplicationTest::textInputEventBenchmark}, 100,
+        Containers::arraySize(EventBenchmarkData));
 }
 
 void ApplicationTest::pointerPressEvent() {
@@ -1327,12 +1344,14 @@ void ApplicationTest::textInputEvent() {
         }
         void doTextInputEvent(UnsignedInt, TextInputEvent& event) override {
             CORRADE_COMPARE(event.text(), "hello");
+            textData = event.text().data();
             event.setAccepted(accept);
             ++called;
         }
 
         bool accept;
         Int called = 0;
+        const char* textData = nullptr;
     };
     Layer& layer = ui.setLayerInstance(Containers::pointer<Layer>(ui.createLayer(), data.accept));
     NodeHandle node = ui.createNode({}, ui.size(), NodeFlag::Focusable);
@@ -1344,11 +1363,121 @@ void ApplicationTest::textInputEvent() {
     CORRADE_VERIFY(ui.focusEvent(node, focusEvent));
     CORRADE_COMPARE(ui.currentFocusedNode(), node);
 
-    CustomTextInputEvent e{"hello"};
+    const Containers::StringView text = "hello";
+    CustomTextInputEvent e{text};
     /* Should return true only if it's accepted */
     CORRADE_COMPARE(ui.textInputEvent(e), data.accept);
     CORRADE_COMPARE(layer.called, 1);
     CORRADE_COMPARE(e.accepted, data.accept);
+    /* The text should be passed through without any copy */
+    CORRADE_COMPARE(static_cast<const void*>(layer.textData), static_cast<const void*>(text.data()));
+}
+
+/* Accepts all events the benchmarks below submit. Enter and leave events
+   caused by the pointer moves are ignored. */
+struct BenchmarkLayer: AbstractLayer {
+    using AbstractLayer::AbstractLayer;
+    using AbstractLayer::create;
+
+    LayerFeatures doFeatures() const override {
+        return LayerFeature::Event;
+    }
+    void doPointerMoveEvent(UnsignedInt, PointerMoveEvent& event) override {
+        event.setAccepted();
+        ++called;
+    }
+    void doFocusEvent(UnsignedInt, FocusEvent& event) override {
+        event.setAccepted();
+    }
+    void doKeyPressEvent(UnsignedInt, KeyEvent& event) override {
+        event.setAccepted();
+        ++called;
+    }
+    void doTextInputEvent(UnsignedInt, TextInputEvent& event) override {
+        event.setAccepted();
+        ++called;
+    }
+
+    Int called = 0;
+};
+
+void ApplicationTest::pointerMoveEventBenchmark() {
+    auto&& data = EventBenchmarkData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    AbstractUserInterface ui{{100, 100}};
+    BenchmarkLayer& layer = ui.setLayerInstance(Containers::pointer<BenchmarkLayer>(ui.createLayer()));
+    layer.create(ui.createNode({}, ui.size()));
+
+    /* Compared to the Ui event, the application event goes through the
+       source and pointer translation. Both are constructed on stack for every
+       call, same as in the application event handlers. */
+    CORRADE_BENCHMARK(1000) {
+        if(data.converted) {
+            CustomPointerMoveEvent e{CustomPointerEventSource::Mouse, {}, CustomPointer::MouseLeft, true, 0, {50.0f, 50.0f}};
+            ui.pointerMoveEvent(e);
+        } else {
+            PointerMoveEvent e{{}, PointerEventSource::Mouse, {}, Pointer::MouseLeft, true, 0};
+            ui.pointerMoveEvent({50.0f, 50.0f}, e);
+        }
+    }
+
+    CORRADE_COMPARE(layer.called, 100*1000);
+}
+
+void ApplicationTest::keyPressEventBenchmark() {
+    auto&& data = EventBenchmarkData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    AbstractUserInterface ui{{100, 100}};
+    BenchmarkLayer& layer = ui.setLayerInstance(Containers::pointer<BenchmarkLayer>(ui.createLayer()));
+    layer.create(ui.createNode({}, ui.size()));
+
+    /* Have to first submit an event that actually makes a node hovered, to
+       have something to call the event on */
+    PointerMoveEvent moveEvent{{}, PointerEventSource::Mouse, {}, {}, true, 0};
+    CORRADE_VERIFY(ui.pointerMoveEvent({50.0f, 50.0f}, moveEvent));
+    layer.called = 0;
+
+    CORRADE_BENCHMARK(1000) {
+        if(data.converted) {
+            CustomKeyEvent e{CustomKeyEvent::Key::Enter, CustomKeyEvent::Modifier::Shift|CustomKeyEvent::Modifier::Ctrl};
+            ui.keyPressEvent(e);
+        } else {
+            KeyEvent e{{}, Key::Enter, Modifier::Shift|Modifier::Ctrl};
+            ui.keyPressEvent(e);
+        }
+    }
+
+    CORRADE_COMPARE(layer.called, 100*1000);
+}
+
+void ApplicationTest::textInputEventBenchmark() {
+    auto&& data = EventBenchmarkData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    AbstractUserInterface ui{{100, 100}};
+    BenchmarkLayer& layer = ui.setLayerInstance(Containers::pointer<BenchmarkLayer>(ui.createLayer()));
+    NodeHandle node = ui.createNode({}, ui.size(), NodeFlag::Focusable);
+    layer.create(node);
+
+    /* Have to first submit an event that actually makes a node focused, to
+       have something to call the event on */
+    FocusEvent focusEvent{{}};
+    CORRADE_VERIFY(ui.focusEvent(node, focusEvent));
+
+    /* Neither of the two copies the text */
+    CORRADE_BENCHMARK(1000) {
+        if(data.converted) {
+            CustomTextInputEvent e{"hello"};
+            ui.textInputEvent(e);
+        } else {
+            TextInputEvent e{{}, "hello"};
+            ui.textInputEvent(e);
+        }
+    }
+
+    CORRADE_COMPARE(layer.called, 100*1000);
 }
 
 }}}}
@@ -50,6 +50,11 @@ struct BaseLayerGLBenchmark: GL::OpenGLTester {
     void vertex();
     void fragment();
 
+    void createRemove();
+    void updateVertices();
+    void updateStyle();
+    void compositeBlur();
+
     private:
         GL::Texture2D _color{NoCreate};
         GL::Framebuffer _framebuffer{NoCreate};
@@ -109,6 +114,38 @@ const struct {
         0, FragmentBenchmarkSize.x()*0.5f, FragmentBenchmarkSize.x()*0.5f, {}},
 };
 
+/* Count of data the CPU-side benchmarks operate on, and size of a square
+   grid they're placed in */
+constexpr Int DataGridSize = 128;
+
+const struct {
+    const char* name;
+    BaseLayerSharedFlags flags;
+} UpdateData[]{
+    {"quads", {}},
+    {"subdivided quads", BaseLayerSharedFlag::SubdividedQuads},
+};
+
+const struct {
+    const char* name;
+    UnsignedInt dynamicStyleCount;
+} UpdateStyleData[]{
+    {"", 0},
+    {"dynamic styles", 1},
+};
+
+const struct {
+    const char* name;
+    UnsignedInt radius;
+    UnsignedInt passCount;
+} CompositeBlurData[]{
+    {"radius 1", 1, 1},
+    {"radius 4", 4, 1},
+    {"radius 16", 16, 1},
+    {"radius 31", 31, 1},
+    {"radius 4, 4 passes", 4, 4},
+};
+
 BaseLayerGLBenchmark::BaseLayerGLBenchmark() {
     addInstancedBenchmarks({&BaseLayerGLBenchmark::vertex}, 10,
         Containers::arraySize(VertexData),
@@ -121,6 +158,26 @@ BaseLayerGLBenchmark::BaseLayerGLBenchmark() {
         &BaseLayerGLBenchmark::setupFragment,
         &BaseLayerGLBenchmark::teardown,
         BenchmarkType::GpuTime);
+
+    addBenchmarks({&BaseLayerGLBenchmark::createRemove}, 10,
+        &BaseLayerGLBenchmark::setupVertex,
+        &BaseLayerGLBenchmark::teardown);
+
+    addInstancedBenchmarks({&BaseLayerGLBenchmark::updateVertices}, 10,
+        Containers::arraySize(UpdateData),
+        &BaseLayerGLBenchmark::setupVertex,
+        &BaseLayerGLBenchmark::teardown);
+
+    addInstancedBenchmarks({&BaseLayerGLBenchmark::updateStyle}, 10,
+        Containers::arraySize(UpdateStyleData),
+        &BaseLayerGLBenchmark::setupVertex,
+        &BaseLayerGLBenchmark::teardown);
+
+    addInstancedBenchmarks({&BaseLayerGLBenchmark::compositeBlur}, 10,
+        Containers::arraySize(CompositeBlurData),
+        &BaseLayerGLBenchmark::setupFragment,
+        &BaseLayerGLBenchmark::teardown,
+        BenchmarkType::GpuTime);
 }
 
 void BaseLayerGLBenchmark::setupVertex() {
@@ -258,6 +315,140 @@ void BaseLayerGLBenchmark::fragment() {
         TestSuite::Compare::around(Color4{1.0f/255.0f, 1.0f/255.0f}));
 }
 
+void BaseLayerGLBenchmark::createRemove() {
+    AbstractUserInterface ui{VertexBenchmarkSize};
+    ui.setRendererInstance(Containers::pointer<RendererGL>());
+
+    BaseLayerGL::Shared shared{BaseLayer::Shared::Configuration{1}};
+    shared.setStyle(BaseLayerCommonStyleUniform{}, {
+        BaseLayerStyleUniform{}
+    }, {});
+
+    BaseLayerGL& layer = ui.setLayerInstance(Containers::pointer<BaseLayerGL>(ui.createLayer(), shared));
+
+    /* The data aren't attached to any node to measure just the layer itself.
+       The update() afterwards cleans up the removed data so each iteration
+       starts from the same state. */
+    DataHandle handles[DataGridSize*DataGridSize];
+    CORRADE_BENCHMARK(10) {
+        for(DataHandle& handle: handles)
+            handle = layer.create(0);
+        for(DataHandle handle: handles)
+            layer.remove(handle);
+        ui.update();
+    }
+
+    CORRADE_COMPARE(layer.usedCount(), 0);
+}
+
+void BaseLayerGLBenchmark::updateVertices() {
+    auto&& data = UpdateData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    AbstractUserInterface ui{VertexBenchmarkSize};
+    ui.setRendererInstance(Containers::pointer<RendererGL>());
+
+    BaseLayerGL::Shared shared{BaseLayer::Shared::Configuration{1}
+        .setFlags(data.flags)
+    };
+    shared.setStyle(BaseLayerCommonStyleUniform{}, {
+        BaseLayerStyleUniform{}
+    }, {});
+
+    BaseLayerGL& layer = ui.setLayerInstance(Containers::pointer<BaseLayerGL>(ui.createLayer(), shared));
+
+    NodeHandle root = ui.createNode({}, ui.size());
+    for(Int x = 0; x != DataGridSize; ++x)
+        for(Int y = 0; y != DataGridSize; ++y) {
+            NodeHandle node = ui.createNode(root, {Float(x), Float(y)}, Vector2{1.0f});
+            layer.create(0, node);
+        }
+    ui.update();
+
+    /* Moving the root node causes the vertices of all data to be
+       regenerated */
+    std::size_t iteration = 0;
+    CORRADE_BENCHMARK(10) {
+        ++iteration;
+        ui.setNodeOffset(root, {Float(iteration & 1), 0.0f});
+        ui.update();
+    }
+
+    CORRADE_COMPARE(ui.state(), UserInterfaceStates{});
+}
+
+void BaseLayerGLBenchmark::updateStyle() {
+    auto&& data = UpdateStyleData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    AbstractUserInterface ui{VertexBenchmarkSize};
+    ui.setRendererInstance(Containers::pointer<RendererGL>());
+
+    BaseLayerGL::Shared shared{BaseLayer::Shared::Configuration{2}
+        .setDynamicStyleCount(data.dynamicStyleCount)
+    };
+    shared.setStyle(BaseLayerCommonStyleUniform{}, {
+        BaseLayerStyleUniform{},
+        BaseLayerStyleUniform{}
+    }, {});
+
+    BaseLayerGL& layer = ui.setLayerInstance(Containers::pointer<BaseLayerGL>(ui.createLayer(), shared));
+
+    NodeHandle root = ui.createNode({}, ui.size());
+    DataHandle handles[DataGridSize*DataGridSize];
+    for(Int x = 0; x != DataGridSize; ++x)
+        for(Int y = 0; y != DataGridSize; ++y) {
+            NodeHandle node = ui.createNode(root, {Float(x), Float(y)}, Vector2{1.0f});
+            handles[y*DataGridSize + x] = layer.create(0, node);
+        }
+    ui.update();
+
+    /* Switching the style of all data and updating */
+    std::size_t iteration = 0;
+    CORRADE_BENCHMARK(10) {
+        ++iteration;
+        for(DataHandle handle: handles)
+            layer.setStyle(handle, iteration & 1);
+        ui.update();
+    }
+
+    CORRADE_COMPARE(ui.state(), UserInterfaceStates{});
+}
+
+void BaseLayerGLBenchmark::compositeBlur() {
+    auto&& data = CompositeBlurData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Renders a single blurred data over the whole size to benchmark mainly
+       the compositing operation */
+
+    AbstractUserInterface ui{FragmentBenchmarkSize};
+    ui.setRendererInstance(Containers::pointer<RendererGL>(RendererGL::Flag::CompositingFramebuffer));
+
+    BaseLayerGL::Shared shared{BaseLayer::Shared::Configuration{1}
+        .addFlags(BaseLayerSharedFlag::BackgroundBlur)
+        .setBackgroundBlurRadius(data.radius)
+    };
+    shared.setStyle(BaseLayerCommonStyleUniform{}, {
+        BaseLayerStyleUniform{}
+            .setColor(0xff3366_rgbf)
+    }, {});
+
+    BaseLayerGL& layer = ui.setLayerInstance(Containers::pointer<BaseLayerGL>(ui.createLayer(), shared));
+    layer.setBackgroundBlurPassCount(data.passCount);
+
+    NodeHandle node = ui.createNode({}, Vector2{FragmentBenchmarkSize});
+    layer.create(0, node);
+
+    ui.update();
+    CORRADE_COMPARE(ui.state(), UserInterfaceStates{});
+
+    CORRADE_BENCHMARK(20)
+        ui.draw();
+
+    MAGNUM_VERIFY_NO_GL_ERROR();
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Ui::Test::BaseLayerGLBenchmark)
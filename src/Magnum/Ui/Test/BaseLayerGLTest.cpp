@@ -39,6 +39,8 @@
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/DebugTools/CompareImage.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Extensions.h>
 #include <Magnum/GL/Framebuffer.h>
 #include <Magnum/GL/Texture.h>
 #include <Magnum/GL/TextureArray.h>
@@ -68,6 +70,7 @@ struct BaseLayerGLTest: GL::OpenGLTester {
        context */
     void sharedConstructCopy();
     void sharedConstructMove();
+    void sharedShareBackgroundBlurShaderInvalid();
 
     void construct();
     void constructDerived();
@@ -106,6 +109,7 @@ struct BaseLayerGLTest: GL::OpenGLTester {
     template<BaseLayerSharedFlag flag = BaseLayerSharedFlag{}> void renderCompositeTextured();
     /* Composite node rectangles aren't affected by the SubdividedQuads flag */
     void renderCompositeNodeRects();
+    void renderCompositeSharedBlurShader();
 
     void drawSetup();
     void drawTeardown();
@@ -850,18 +854,27 @@ const struct {
 const struct {
     const char* name;
     const char* filename;
+    BaseLayerSharedFlags flags;
     bool clip;
     bool singleTopLevel;
     bool flipOrder;
 } DrawClippingData[]{
     {"clipping disabled", "clipping-disabled.png",
-        false, false, false},
+        {}, false, false, false},
     {"clipping top-level nodes", "clipping-enabled.png",
-        true, false, false},
+        {}, true, false, false},
     {"clipping top-level nodes, different node order", "clipping-enabled.png",
-        true, false, true},
+        {}, true, false, true},
     {"single top-level node with clipping subnodes", "clipping-enabled.png",
-        true, true, false},
+        {}, true, true, false},
+    {"shader clipping disabled", "clipping-disabled.png",
+        BaseLayerSharedFlag::ShaderClipping, false, false, false},
+    {"shader clipping top-level nodes", "clipping-enabled.png",
+        BaseLayerSharedFlag::ShaderClipping, true, false, false},
+    {"shader clipping top-level nodes, different node order", "clipping-enabled.png",
+        BaseLayerSharedFlag::ShaderClipping, true, false, true},
+    {"shader clipping single top-level node with clipping subnodes", "clipping-enabled.png",
+        BaseLayerSharedFlag::ShaderClipping, true, true, false},
 };
 
 BaseLayerGLTest::BaseLayerGLTest() {
@@ -869,6 +882,7 @@ BaseLayerGLTest::BaseLayerGLTest() {
               &BaseLayerGLTest::sharedConstructComposite,
               &BaseLayerGLTest::sharedConstructCopy,
               &BaseLayerGLTest::sharedConstructMove,
+              &BaseLayerGLTest::sharedShareBackgroundBlurShaderInvalid,
 
               &BaseLayerGLTest::construct,
               &BaseLayerGLTest::constructDerived,
@@ -887,7 +901,11 @@ BaseLayerGLTest::BaseLayerGLTest() {
     /* MSVC needs explicit type due to default template args */
     addInstancedTests<BaseLayerGLTest>({
         &BaseLayerGLTest::render,
-        &BaseLayerGLTest::render<BaseLayerSharedFlag::SubdividedQuads>},
+        &BaseLayerGLTest::render<BaseLayerSharedFlag::SubdividedQuads>,
+        &BaseLayerGLTest::render<BaseLayerSharedFlag::InstancedQuads>,
+        &BaseLayerGLTest::render<BaseLayerSharedFlag::NodeRelativePositions>,
+        &BaseLayerGLTest::render<BaseLayerSharedFlag::AutomaticShaderVariants>,
+        &BaseLayerGLTest::render<BaseLayerSharedFlag::CompactVertices>},
         Containers::arraySize(RenderData),
         &BaseLayerGLTest::renderSetup,
         &BaseLayerGLTest::renderTeardown);
@@ -922,7 +940,9 @@ BaseLayerGLTest::BaseLayerGLTest() {
 
     addInstancedTests<BaseLayerGLTest>({
         &BaseLayerGLTest::renderTextured,
-        &BaseLayerGLTest::renderTextured<BaseLayerSharedFlag::SubdividedQuads>},
+        &BaseLayerGLTest::renderTextured<BaseLayerSharedFlag::SubdividedQuads>,
+        &BaseLayerGLTest::renderTextured<BaseLayerSharedFlag::InstancedQuads>,
+        &BaseLayerGLTest::renderTextured<BaseLayerSharedFlag::CompactVertices>},
         Containers::arraySize(RenderTexturedData),
         &BaseLayerGLTest::renderSetup,
         &BaseLayerGLTest::renderTeardown);
@@ -981,6 +1001,10 @@ BaseLayerGLTest::BaseLayerGLTest() {
         &BaseLayerGLTest::renderOrDrawCompositeSetup,
         &BaseLayerGLTest::renderOrDrawCompositeTeardown);
 
+    addTests({&BaseLayerGLTest::renderCompositeSharedBlurShader},
+        &BaseLayerGLTest::renderOrDrawCompositeSetup,
+        &BaseLayerGLTest::renderOrDrawCompositeTeardown);
+
     addInstancedTests({&BaseLayerGLTest::drawOrder},
         Containers::arraySize(DrawOrderData),
         &BaseLayerGLTest::drawSetup,
@@ -1043,6 +1067,43 @@ void BaseLayerGLTest::sharedConstructMove() {
     CORRADE_VERIFY(std::is_nothrow_move_assignable<BaseLayerGL::Shared>::value);
 }
 
+void BaseLayerGLTest::sharedShareBackgroundBlurShaderInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    BaseLayerGL::Shared noBlur{BaseLayer::Shared::Configuration{1}};
+    BaseLayerGL::Shared blur{BaseLayer::Shared::Configuration{1}
+        .addFlags(BaseLayerSharedFlag::BackgroundBlur)
+        .setBackgroundBlurRadius(8)};
+    /* Same effective radius with downsampling, shouldn't assert */
+    BaseLayerGL::Shared blurDownsampled{BaseLayer::Shared::Configuration{1}
+        .addFlags(BaseLayerSharedFlag::BackgroundBlur)
+        .setBackgroundBlurRadius(15)
+        .setBackgroundBlurDownsampling(2)};
+    BaseLayerGL::Shared blurDifferentRadius{BaseLayer::Shared::Configuration{1}
+        .addFlags(BaseLayerSharedFlag::BackgroundBlur)
+        .setBackgroundBlurRadius(9)};
+    BaseLayerGL::Shared blurDifferentCutoff{BaseLayer::Shared::Configuration{1}
+        .addFlags(BaseLayerSharedFlag::BackgroundBlur)
+        .setBackgroundBlurRadius(8, 0.25f)};
+    blurDownsampled.shareBackgroundBlurShader(blur);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    noBlur.shareBackgroundBlurShader(blur);
+    blur.shareBackgroundBlurShader(noBlur);
+    blur.shareBackgroundBlurShader(blurDifferentRadius);
+    blur.shareBackgroundBlurShader(blurDifferentCutoff);
+    blur.shareBackgroundBlurShader(blur);
+    blur.shareBackgroundBlurShader(blurDownsampled);
+    CORRADE_COMPARE(out.str(),
+        "Ui::BaseLayerGL::Shared::shareBackgroundBlurShader(): Ui::BaseLayerSharedFlag::BackgroundBlur not enabled on both instances\n"
+        "Ui::BaseLayerGL::Shared::shareBackgroundBlurShader(): Ui::BaseLayerSharedFlag::BackgroundBlur not enabled on both instances\n"
+        "Ui::BaseLayerGL::Shared::shareBackgroundBlurShader(): expected the same effective blur radius and cutoff, got 8 and 0.00196078 but 9 and 0.00196078 in the other\n"
+        "Ui::BaseLayerGL::Shared::shareBackgroundBlurShader(): expected the same effective blur radius and cutoff, got 8 and 0.00196078 but 8 and 0.25 in the other\n"
+        "Ui::BaseLayerGL::Shared::shareBackgroundBlurShader(): sharing would form a cycle\n"
+        "Ui::BaseLayerGL::Shared::shareBackgroundBlurShader(): sharing would form a cycle\n");
+}
+
 void BaseLayerGLTest::construct() {
     BaseLayerGL::Shared shared{BaseLayer::Shared::Configuration{3}};
 
@@ -1194,7 +1255,20 @@ void BaseLayerGLTest::renderTeardown() {
 template<BaseLayerSharedFlag flag> void BaseLayerGLTest::render() {
     auto&& data = RenderData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
-    setTestCaseTemplateName(flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" : "");
+    setTestCaseTemplateName(
+        flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" :
+        flag == BaseLayerSharedFlag::InstancedQuads ? "Flag::InstancedQuads" :
+        flag == BaseLayerSharedFlag::NodeRelativePositions ? "Flag::NodeRelativePositions" :
+        flag == BaseLayerSharedFlag::AutomaticShaderVariants ? "Flag::AutomaticShaderVariants" :
+        flag == BaseLayerSharedFlag::CompactVertices ? "Flag::CompactVertices" : "");
+
+    #ifndef MAGNUM_TARGET_GLES
+    if(flag == BaseLayerSharedFlag::InstancedQuads && !GL::Context::current().isExtensionSupported<GL::Extensions::ARB::base_instance>())
+        CORRADE_SKIP(GL::Extensions::ARB::base_instance::string() << "is not supported.");
+    #else
+    if(flag == BaseLayerSharedFlag::InstancedQuads)
+        CORRADE_SKIP(flag << "is not supported on OpenGL ES.");
+    #endif
 
     if(flag == BaseLayerSharedFlag::SubdividedQuads && (data.flags & (BaseLayerSharedFlag::NoOutline|BaseLayerSharedFlag::NoRoundedCorners)))
         CORRADE_SKIP(flag << "and" << data.flags << "are mutually exclusive");
@@ -1494,7 +1568,18 @@ template<BaseLayerSharedFlag flag> void BaseLayerGLTest::renderChangeStyle() {
 template<BaseLayerSharedFlag flag> void BaseLayerGLTest::renderTextured() {
     auto&& data = RenderTexturedData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
-    setTestCaseTemplateName(flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" : "");
+    setTestCaseTemplateName(
+        flag == BaseLayerSharedFlag::SubdividedQuads ? "Flag::SubdividedQuads" :
+        flag == BaseLayerSharedFlag::InstancedQuads ? "Flag::InstancedQuads" :
+        flag == BaseLayerSharedFlag::CompactVertices ? "Flag::CompactVertices" : "");
+
+    #ifndef MAGNUM_TARGET_GLES
+    if(flag == BaseLayerSharedFlag::InstancedQuads && !GL::Context::current().isExtensionSupported<GL::Extensions::ARB::base_instance>())
+        CORRADE_SKIP(GL::Extensions::ARB::base_instance::string() << "is not supported.");
+    #else
+    if(flag == BaseLayerSharedFlag::InstancedQuads)
+        CORRADE_SKIP(flag << "is not supported on OpenGL ES.");
+    #endif
 
     if(!(_manager.load("AnyImageImporter") & PluginManager::LoadState::Loaded) ||
        !(_manager.load("StbImageImporter") & PluginManager::LoadState::Loaded))
@@ -1556,7 +1641,13 @@ template<BaseLayerSharedFlag flag> void BaseLayerGLTest::renderTextured() {
     if(GL::Context::current().detectedDriver() & GL::Context::DetectedDriver::SwiftShader)
         CORRADE_SKIP("UBOs with dynamically indexed arrays don't seem to work on SwiftShader, can't test.");
     #endif
-    {
+    /* The fixed-point texture coordinates with compact vertices may cause
+       minor differences in the filtered output */
+    if(flag == BaseLayerSharedFlag::CompactVertices) {
+        CORRADE_COMPARE_WITH(_framebuffer.read({{}, RenderSize}, {PixelFormat::RGBA8Unorm}),
+            Utility::Path::join({UI_TEST_DIR, "BaseLayerTestFiles", data.expectedFilename}),
+            (DebugTools::CompareImageToFile{_manager, 1.0f, 0.01f}));
+    } else {
         CORRADE_EXPECT_FAIL_IF(flag == BaseLayerSharedFlag::SubdividedQuads && data.expectedFilename == "textured-colored.png"_s,
             "A single differing pixel with" << BaseLayerSharedFlag::SubdividedQuads << "enabled, not sure why");
         CORRADE_COMPARE_WITH(_framebuffer.read({{}, RenderSize}, {PixelFormat::RGBA8Unorm}),
@@ -2303,6 +2394,84 @@ void BaseLayerGLTest::renderCompositeNodeRects() {
 
 constexpr Vector2i DrawSize{64, 64};
 
+void BaseLayerGLTest::renderCompositeSharedBlurShader() {
+    if(!(_manager.load("AnyImageImporter") & PluginManager::LoadState::Loaded) ||
+       !(_manager.load("StbImageImporter") & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP("AnyImageImporter / StbImageImporter plugins not found.");
+
+    /* Same as the "background blur, 50% opacity, radius 31" case in
+       renderComposite(), except that the blur shader is created and first
+       used by another layer in a differently sized UI. The second layer
+       should use the same shader, only setting its own projection to it. */
+    const BaseLayerGL::Shared::Configuration configuration = BaseLayerGL::Shared::Configuration{2}
+        .addFlags(BaseLayerSharedFlag::BackgroundBlur)
+        .setBackgroundBlurRadius(31);
+    const BaseLayerCommonStyleUniform styleCommon = BaseLayerCommonStyleUniform{}
+        .setSmoothness(1.0f);
+    const BaseLayerStyleUniform styleUniforms[]{
+        BaseLayerStyleUniform{},
+        BaseLayerStyleUniform{}
+            .setCornerRadius(12.0f)
+            /* Premultiplied alpha */
+            .setColor(0xffffffff_rgbaf*0.5f)
+    };
+
+    BaseLayerGL::Shared anotherLayerShared{configuration};
+    anotherLayerShared.setStyle(styleCommon, styleUniforms, {});
+
+    AbstractUserInterface anotherUi{RenderSize*2};
+    anotherUi.setRendererInstance(Containers::pointer<RendererGL>(RendererGL::Flag::CompositingFramebuffer));
+
+    BaseLayerGL& anotherLayer = anotherUi.setLayerInstance(Containers::pointer<BaseLayerGL>(anotherUi.createLayer(), anotherLayerShared));
+    anotherLayer.create(1, anotherUi.createNode({16.0f, 16.0f}, {224.0f, 96.0f}));
+
+    anotherUi.draw();
+    MAGNUM_VERIFY_NO_GL_ERROR();
+
+    BaseLayerGL::Shared layerShared{configuration};
+    layerShared
+        .shareBackgroundBlurShader(anotherLayerShared)
+        .setStyle(styleCommon, styleUniforms, {});
+
+    AbstractUserInterface ui{RenderSize};
+    RendererGL& renderer = ui.setRendererInstance(Containers::pointer<RendererGL>(RendererGL::Flag::CompositingFramebuffer));
+
+    /* Upload (a crop of) the blur source image as a framebuffer background */
+    Containers::Pointer<Trade::AbstractImporter> importer = _manager.loadAndInstantiate("AnyImageImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(UI_TEST_DIR, "BaseLayerTestFiles/blur-input.png")));
+
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->format(), PixelFormat::RGBA8Unorm);
+    CORRADE_COMPARE_AS(image->size(), RenderSize,
+        TestSuite::Compare::GreaterOrEqual);
+
+    Image2D imageCropped{PixelFormat::RGBA8Unorm, RenderSize, Containers::Array<char>{NoInit, std::size_t(RenderSize.product()*4)}};
+    Utility::copy(image->pixels<Color4ub>().prefix({
+        std::size_t(RenderSize.y()),
+        std::size_t(RenderSize.x()),
+    }), imageCropped.pixels<Color4ub>());
+
+    renderer.compositingTexture().setSubImage(0, {}, imageCropped);
+
+    BaseLayerGL& layer = ui.setLayerInstance(Containers::pointer<BaseLayerGL>(ui.createLayer(), layerShared));
+    layer.create(1, ui.createNode({8.0f, 8.0f}, {112.0f, 48.0f}));
+
+    ui.draw();
+
+    MAGNUM_VERIFY_NO_GL_ERROR();
+
+    #if defined(MAGNUM_TARGET_GLES) && !defined(MAGNUM_TARGET_WEBGL)
+    /* Same problem is with all builtin shaders, so this doesn't seem to be a
+       bug in the base layer shader code */
+    if(GL::Context::current().detectedDriver() & GL::Context::DetectedDriver::SwiftShader)
+        CORRADE_SKIP("UBOs with dynamically indexed arrays don't seem to work on SwiftShader, can't test.");
+    #endif
+    CORRADE_COMPARE_WITH(renderer.compositingFramebuffer().read({{}, RenderSize}, {PixelFormat::RGBA8Unorm}),
+        Utility::Path::join(UI_TEST_DIR, "BaseLayerTestFiles/composite-background-blur-50-r31.png"),
+        DebugTools::CompareImageToFile{_manager});
+}
+
 void BaseLayerGLTest::drawSetup() {
     _color = GL::Texture2D{};
     _color.setStorage(1, GL::TextureFormat::RGBA8, DrawSize);
@@ -2468,7 +2637,8 @@ void BaseLayerGLTest::drawClipping() {
     AbstractUserInterface ui{{640.0f, 6400.0f}, {1.0f, 1.0f}, DrawSize};
     ui.setRendererInstance(Containers::pointer<RendererGL>());
 
-    BaseLayerGL::Shared layerShared{BaseLayer::Shared::Configuration{3}};
+    BaseLayerGL::Shared layerShared{BaseLayer::Shared::Configuration{3}
+        .setFlags(data.flags)};
     layerShared.setStyle(BaseLayerCommonStyleUniform{}, {
         BaseLayerStyleUniform{}         /* 0, red */
             .setColor(0xff0000_rgbf),
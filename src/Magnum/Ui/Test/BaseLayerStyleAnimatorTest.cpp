@@ -537,17 +537,17 @@ void BaseLayerStyleAnimatorTest::propertiesInvalid() {
     animator.uniforms(AnimationHandle::Null);
     animator.paddings(AnimationHandle::Null);
     /* Valid animator, invalid data */
-    animator.easing(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
-    animator.uniforms(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
-    animator.paddings(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
+    animator.easing(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)));
+    animator.uniforms(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)));
+    animator.paddings(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)));
     /* Invalid animator, valid data */
     animator.easing(animationHandle(AnimatorHandle::Null, animationHandleData(handle)));
     animator.uniforms(animationHandle(AnimatorHandle::Null, animationHandleData(handle)));
     animator.paddings(animationHandle(AnimatorHandle::Null, animationHandleData(handle)));
     /* AnimatorDataHandle directly */
-    animator.easing(AnimatorDataHandle(0x123abcde));
-    animator.uniforms(AnimatorDataHandle(0x123abcde));
-    animator.paddings(AnimatorDataHandle(0x123abcde));
+    animator.easing(animatorDataHandle(0xabcde, 0x123));
+    animator.uniforms(animatorDataHandle(0xabcde, 0x123));
+    animator.paddings(animatorDataHandle(0xabcde, 0x123));
     CORRADE_COMPARE_AS(out.str(),
         "Ui::BaseLayerStyleAnimator::easing(): invalid handle Ui::AnimationHandle::Null\n"
         "Ui::BaseLayerStyleAnimator::uniforms(): invalid handle Ui::AnimationHandle::Null\n"
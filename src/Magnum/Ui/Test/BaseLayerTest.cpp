@@ -26,14 +26,18 @@
 
 #include <new>
 #include <sstream> /** @todo remove once Debug is stream-free */
+#include <Corrade/Containers/BitArray.h>
 #include <Corrade/Containers/BitArrayView.h>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/StridedBitArrayView.h>
 #include <Corrade/Containers/StringStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/String.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+#include <Magnum/Math/Constants.h>
 
 #include "Magnum/Ui/AbstractUserInterface.h"
 #include "Magnum/Ui/BaseLayer.h"
@@ -124,6 +128,14 @@ struct BaseLayerTest: TestSuite::Tester {
 
     void updateEmpty();
     void updateDataOrder();
+    void updateVertexUpdateRange();
+    void updateModifiedDataOnly();
+    void updateNodeRelativePositions();
+    void updateShaderClipping();
+    void updateAutomaticShaderVariants();
+    void updateInstancedQuads();
+    void compactVertices();
+    void updateVertexExecutor();
     void updateNoStyleSet();
 
     void sharedNeedsUpdateStatePropagatedToLayers();
@@ -397,6 +409,18 @@ const struct {
     {"dynamic styles", 1, 2},
 };
 
+const struct {
+    const char* name;
+    BaseLayerSharedFlags flags;
+} UpdateVertexExecutorData[]{
+    {"", {}},
+    {"textured", BaseLayerSharedFlag::Textured},
+    {"subdivided quads", BaseLayerSharedFlag::SubdividedQuads},
+    {"subdivided quads, textured", BaseLayerSharedFlag::SubdividedQuads|BaseLayerSharedFlag::Textured},
+    {"instanced quads", BaseLayerSharedFlag::InstancedQuads},
+    {"instanced quads, textured", BaseLayerSharedFlag::InstancedQuads|BaseLayerSharedFlag::Textured},
+};
+
 const struct {
     const char* name;
     UnsignedInt styleCount, dynamicStyleCount;
@@ -508,6 +532,17 @@ BaseLayerTest::BaseLayerTest() {
     addInstancedTests({&BaseLayerTest::updateDataOrder},
         Containers::arraySize(UpdateDataOrderData));
 
+    addTests({&BaseLayerTest::updateVertexUpdateRange,
+              &BaseLayerTest::updateModifiedDataOnly,
+              &BaseLayerTest::updateNodeRelativePositions,
+              &BaseLayerTest::updateShaderClipping,
+              &BaseLayerTest::updateAutomaticShaderVariants,
+              &BaseLayerTest::updateInstancedQuads,
+              &BaseLayerTest::compactVertices});
+
+    addInstancedTests({&BaseLayerTest::updateVertexExecutor},
+        Containers::arraySize(UpdateVertexExecutorData));
+
     addInstancedTests({&BaseLayerTest::updateNoStyleSet},
         Containers::arraySize(UpdateNoStyleSetData));
 
@@ -864,8 +899,8 @@ void BaseLayerTest::sharedDebugFlag() {
 
 void BaseLayerTest::sharedDebugFlags() {
     std::ostringstream out;
-    Debug{&out} << (BaseLayerSharedFlag::BackgroundBlur|BaseLayerSharedFlag(0x80)) << BaseLayerSharedFlags{};
-    CORRADE_COMPARE(out.str(), "Ui::BaseLayerSharedFlag::BackgroundBlur|Ui::BaseLayerSharedFlag(0x80) Ui::BaseLayerSharedFlags{}\n");
+    Debug{&out} << (BaseLayerSharedFlag::BackgroundBlur|BaseLayerSharedFlag::NodeRelativePositions) << BaseLayerSharedFlags{};
+    CORRADE_COMPARE(out.str(), "Ui::BaseLayerSharedFlag::BackgroundBlur|Ui::BaseLayerSharedFlag::NodeRelativePositions Ui::BaseLayerSharedFlags{}\n");
 }
 
 void BaseLayerTest::sharedDebugFlagSupersets() {
@@ -930,17 +965,20 @@ void BaseLayerTest::sharedConfigurationSetters() {
     CORRADE_COMPARE(configuration.flags(), BaseLayerSharedFlags{});
     CORRADE_COMPARE(configuration.backgroundBlurRadius(), 4);
     CORRADE_COMPARE(configuration.backgroundBlurCutoff(), 0.5f/255.0f);
+    CORRADE_COMPARE(configuration.backgroundBlurDownsampling(), 1);
 
     configuration
         .setDynamicStyleCount(9)
         .setFlags(BaseLayerSharedFlag::BackgroundBlur)
         .addFlags(BaseLayerSharedFlag(0xe0))
         .clearFlags(BaseLayerSharedFlag(0x70))
-        .setBackgroundBlurRadius(16, 0.1f);
+        .setBackgroundBlurRadius(16, 0.1f)
+        .setBackgroundBlurDownsampling(4);
     CORRADE_COMPARE(configuration.dynamicStyleCount(), 9);
     CORRADE_COMPARE(configuration.flags(), BaseLayerSharedFlag::BackgroundBlur|BaseLayerSharedFlag(0x80));
     CORRADE_COMPARE(configuration.backgroundBlurRadius(), 16);
     CORRADE_COMPARE(configuration.backgroundBlurCutoff(), 0.1f);
+    CORRADE_COMPARE(configuration.backgroundBlurDownsampling(), 4);
 }
 
 void BaseLayerTest::sharedConfigurationSettersInvalid() {
@@ -956,7 +994,13 @@ void BaseLayerTest::sharedConfigurationSettersInvalid() {
     std::ostringstream out;
     Error redirectError{&out};
     configuration.setBackgroundBlurRadius(32);
-    CORRADE_COMPARE(out.str(), "Ui::BaseLayer::Shared::Configuration::setBackgroundBlurRadius(): radius 32 too large\n");
+    configuration.setBackgroundBlurDownsampling(0);
+    configuration.setBackgroundBlurDownsampling(3);
+    CORRADE_COMPARE_AS(out.str(),
+        "Ui::BaseLayer::Shared::Configuration::setBackgroundBlurRadius(): radius 32 too large\n"
+        "Ui::BaseLayer::Shared::Configuration::setBackgroundBlurDownsampling(): expected 1, 2 or 4, got 0\n"
+        "Ui::BaseLayer::Shared::Configuration::setBackgroundBlurDownsampling(): expected 1, 2 or 4, got 3\n",
+        TestSuite::Compare::String);
 }
 
 void BaseLayerTest::sharedConstruct() {
@@ -1053,11 +1097,23 @@ void BaseLayerTest::sharedConstructInvalid() {
     Shared{Shared::Configuration{1}.addFlags(BaseLayerSharedFlag::SubdividedQuads|BaseLayerSharedFlag::NoRoundedCorners)};
     Shared{Shared::Configuration{1}.addFlags(BaseLayerSharedFlag::SubdividedQuads|BaseLayerSharedFlag::NoOutline)};
     Shared{Shared::Configuration{1}.addFlags(BaseLayerSharedFlag::SubdividedQuads|BaseLayerSharedFlag::NoOutline|BaseLayerSharedFlag::NoRoundedCorners)};
+    Shared{Shared::Configuration{1}.addFlags(BaseLayerSharedFlag::SubdividedQuads|BaseLayerSharedFlag::AutomaticShaderVariants)};
+    Shared{Shared::Configuration{1}.addFlags(BaseLayerSharedFlag::SubdividedQuads|BaseLayerSharedFlag::InstancedQuads)};
+    Shared{Shared::Configuration{1}.addFlags(BaseLayerSharedFlag::InstancedQuads|BaseLayerSharedFlag::NodeRelativePositions)};
+    Shared{Shared::Configuration{1}.addFlags(BaseLayerSharedFlag::InstancedQuads|BaseLayerSharedFlag::ShaderClipping)};
+    Shared{Shared::Configuration{1}.addFlags(BaseLayerSharedFlag::CompactVertices|BaseLayerSharedFlag::SubdividedQuads)};
+    Shared{Shared::Configuration{1}.addFlags(BaseLayerSharedFlag::CompactVertices|BaseLayerSharedFlag::InstancedQuads)};
     CORRADE_COMPARE_AS(out.str(),
         "Ui::BaseLayer::Shared: expected non-zero total style count\n"
         "Ui::BaseLayer::Shared: Ui::BaseLayerSharedFlag::SubdividedQuads and Ui::BaseLayerSharedFlag::NoRoundedCorners are mutually exclusive\n"
         "Ui::BaseLayer::Shared: Ui::BaseLayerSharedFlag::SubdividedQuads and Ui::BaseLayerSharedFlag::NoOutline are mutually exclusive\n"
-        "Ui::BaseLayer::Shared: Ui::BaseLayerSharedFlag::SubdividedQuads and Ui::BaseLayerSharedFlag::NoRoundedCorners|Ui::BaseLayerSharedFlag::NoOutline are mutually exclusive\n",
+        "Ui::BaseLayer::Shared: Ui::BaseLayerSharedFlag::SubdividedQuads and Ui::BaseLayerSharedFlag::NoRoundedCorners|Ui::BaseLayerSharedFlag::NoOutline are mutually exclusive\n"
+        "Ui::BaseLayer::Shared: Ui::BaseLayerSharedFlag::SubdividedQuads and Ui::BaseLayerSharedFlag::AutomaticShaderVariants are mutually exclusive\n"
+        "Ui::BaseLayer::Shared: Ui::BaseLayerSharedFlag::SubdividedQuads and Ui::BaseLayerSharedFlag::InstancedQuads are mutually exclusive\n"
+        "Ui::BaseLayer::Shared: Ui::BaseLayerSharedFlag::InstancedQuads and Ui::BaseLayerSharedFlag::NodeRelativePositions are mutually exclusive\n"
+        "Ui::BaseLayer::Shared: Ui::BaseLayerSharedFlag::InstancedQuads and Ui::BaseLayerSharedFlag::ShaderClipping are mutually exclusive\n"
+        "Ui::BaseLayer::Shared: Ui::BaseLayerSharedFlag::CompactVertices and Ui::BaseLayerSharedFlag::SubdividedQuads are mutually exclusive\n"
+        "Ui::BaseLayer::Shared: Ui::BaseLayerSharedFlag::CompactVertices and Ui::BaseLayerSharedFlag::InstancedQuads are mutually exclusive\n",
         TestSuite::Compare::String);
 }
 
@@ -2688,6 +2744,595 @@ void BaseLayerTest::updateDataOrder() {
     }
 }
 
+void BaseLayerTest::updateVertexUpdateRange() {
+    struct LayerShared: BaseLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): BaseLayer::Shared{configuration} {}
+
+        void doSetStyle(const BaseLayerCommonStyleUniform&, Containers::ArrayView<const BaseLayerStyleUniform>) override {}
+    } shared{BaseLayer::Shared::Configuration{1}};
+    shared.setStyle(
+        BaseLayerCommonStyleUniform{},
+        {BaseLayerStyleUniform{}},
+        {});
+
+    struct Layer: BaseLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): BaseLayer{handle, shared} {}
+        BaseLayer::State& stateData() {
+            return static_cast<BaseLayer::State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
+
+    layer.create(0, nodeHandle(0, 0));
+    DataHandle data1 = layer.create(0, nodeHandle(1, 0));
+    layer.create(0, nodeHandle(2, 0));
+
+    const auto resetRange = [&]() {
+        layer.stateData().vertexUpdateBegin = ~std::size_t{};
+        layer.stateData().vertexUpdateEnd = 0;
+    };
+
+    const std::size_t dataSize = 4*sizeof(Implementation::BaseLayerVertex);
+    Vector2 nodeOffsets[3];
+    Vector2 nodeSizes[3]{{10.0f, 10.0f}, {10.0f, 10.0f}, {10.0f, 10.0f}};
+    Float nodeOpacities[3]{1.0f, 1.0f, 1.0f};
+    UnsignedByte nodesEnabledData[1]{};
+    Containers::BitArrayView nodesEnabled{nodesEnabledData, 0, 3};
+    UnsignedInt dataIds[]{0, 1, 2};
+
+    /* Initially the vertex data get allocated, so the range is everything */
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.stateData().vertices.size(), layer.capacity()*dataSize);
+    CORRADE_COMPARE(layer.stateData().vertexUpdateBegin, 0);
+    CORRADE_COMPARE(layer.stateData().vertexUpdateEnd, layer.capacity()*dataSize);
+
+    /* Updating again with nothing changed results in an empty range */
+    resetRange();
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.stateData().vertexUpdateBegin, ~std::size_t{});
+    CORRADE_COMPARE(layer.stateData().vertexUpdateEnd, 0);
+
+    /* Changing a color of the second data updates just its vertices */
+    layer.setColor(data1, 0xff3366_rgbf);
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.stateData().vertexUpdateBegin, 1*dataSize);
+    CORRADE_COMPARE(layer.stateData().vertexUpdateEnd, 2*dataSize);
+
+    /* Moving the third node extends the range, as it wasn't reset */
+    nodeOffsets[2] = {15.0f, 3.0f};
+    layer.update(LayerState::NeedsNodeOffsetSizeUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.stateData().vertexUpdateBegin, 1*dataSize);
+    CORRADE_COMPARE(layer.stateData().vertexUpdateEnd, 3*dataSize);
+
+    /* Moving the first node after a reset gives just the first range */
+    resetRange();
+    nodeOffsets[0] = {2.0f, 7.0f};
+    layer.update(LayerState::NeedsNodeOffsetSizeUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.stateData().vertexUpdateBegin, 0);
+    CORRADE_COMPARE(layer.stateData().vertexUpdateEnd, 1*dataSize);
+}
+
+void BaseLayerTest::updateModifiedDataOnly() {
+    struct LayerShared: BaseLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): BaseLayer::Shared{configuration} {}
+
+        void doSetStyle(const BaseLayerCommonStyleUniform&, Containers::ArrayView<const BaseLayerStyleUniform>) override {}
+    } shared{BaseLayer::Shared::Configuration{1}};
+    shared.setStyle(
+        BaseLayerCommonStyleUniform{},
+        {BaseLayerStyleUniform{}},
+        {});
+
+    struct Layer: BaseLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): BaseLayer{handle, shared} {}
+        BaseLayer::State& stateData() {
+            return static_cast<BaseLayer::State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
+
+    DataHandle data0 = layer.create(0, nodeHandle(0, 0));
+    DataHandle data1 = layer.create(0, nodeHandle(1, 0));
+
+    Vector2 nodeOffsets[2];
+    Vector2 nodeSizes[2]{{10.0f, 10.0f}, {10.0f, 10.0f}};
+    Float nodeOpacities[2]{1.0f, 1.0f};
+    UnsignedByte nodesEnabledData[1]{};
+    Containers::BitArrayView nodesEnabled{nodesEnabledData, 0, 2};
+    UnsignedInt dataIds[]{0, 1};
+
+    const auto vertices = [&]() {
+        return Containers::arrayCast<const Implementation::BaseLayerVertex>(layer.stateData().vertices);
+    };
+
+    layer.update(LayerState::NeedsDataUpdate|LayerState::NeedsNodeOrderUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.modifiedDataMask().count(), 0);
+    CORRADE_COMPARE(vertices()[0*4].position, (Vector2{0.0f, 0.0f}));
+    CORRADE_COMPARE(vertices()[1*4].position, (Vector2{0.0f, 0.0f}));
+
+    /* Pretend the node offsets changed, but pass just a data update with the
+       second data modified. Only the second data get regenerated, the first
+       is left untouched, which is how it's observable here. */
+    nodeOffsets[0] = {3.0f, 4.0f};
+    nodeOffsets[1] = {5.0f, 6.0f};
+    layer.setColor(data1, 0xff3366ff_rgbaf);
+    CORRADE_COMPARE_AS(layer.modifiedDataMask(), Containers::stridedArrayView({
+        false, true
+    }).sliceBit(0), TestSuite::Compare::Container);
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(vertices()[0*4].position, (Vector2{0.0f, 0.0f}));
+    CORRADE_COMPARE(vertices()[0*4].color, 0xffffffff_rgbaf);
+    CORRADE_COMPARE(vertices()[1*4].position, (Vector2{5.0f, 6.0f}));
+    CORRADE_COMPARE(vertices()[1*4].color, 0xff3366ff_rgbaf);
+
+    /* With node offsets marked as changed everything gets regenerated */
+    layer.setPadding(data0, {});
+    layer.update(LayerState::NeedsDataUpdate|LayerState::NeedsNodeOffsetSizeUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(vertices()[0*4].position, (Vector2{3.0f, 4.0f}));
+    CORRADE_COMPARE(vertices()[1*4].position, (Vector2{5.0f, 6.0f}));
+
+    /* A data update not coming from particular data marks everything as
+       modified as well */
+    nodeOffsets[0] = {7.0f, 8.0f};
+    nodeOffsets[1] = {9.0f, 1.0f};
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(vertices()[0*4].position, (Vector2{7.0f, 8.0f}));
+    CORRADE_COMPARE(vertices()[1*4].position, (Vector2{9.0f, 1.0f}));
+}
+
+void BaseLayerTest::updateNodeRelativePositions() {
+    struct LayerShared: BaseLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): BaseLayer::Shared{configuration} {}
+
+        void doSetStyle(const BaseLayerCommonStyleUniform&, Containers::ArrayView<const BaseLayerStyleUniform>) override {}
+    } shared{BaseLayer::Shared::Configuration{1}
+        .addFlags(BaseLayerSharedFlag::NodeRelativePositions)};
+    shared.setStyle(
+        BaseLayerCommonStyleUniform{},
+        {BaseLayerStyleUniform{}},
+        {});
+
+    struct Layer: BaseLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): BaseLayer{handle, shared} {}
+        BaseLayer::State& stateData() {
+            return static_cast<BaseLayer::State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
+
+    /* Data 1 is attached to node 2, data 2 to node 0 */
+    layer.create(0, nodeHandle(1, 0));
+    layer.create(0, nodeHandle(2, 0));
+    layer.create(0, nodeHandle(0, 0));
+
+    Vector2 nodeOffsets[3]{{1.0f, 2.0f}, {3.0f, 4.0f}, {5.0f, 6.0f}};
+    Vector2 nodeSizes[3]{{10.0f, 10.0f}, {20.0f, 20.0f}, {30.0f, 30.0f}};
+    Float nodeOpacities[3]{1.0f, 1.0f, 1.0f};
+    UnsignedByte nodesEnabledData[1]{};
+    Containers::BitArrayView nodesEnabled{nodesEnabledData, 0, 3};
+    /* Data 0 isn't visible */
+    UnsignedInt dataIds[]{2, 1};
+
+    const auto vertices = [&]() {
+        return Containers::arrayCast<const Implementation::BaseLayerVertex>(layer.stateData().vertices);
+    };
+
+    /* The positions don't include the node offset, the offsets and opacities
+       are padded to a whole texture row and the whole range is marked as
+       changed */
+    layer.update(LayerState::NeedsDataUpdate|LayerState::NeedsNodeOrderUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(vertices()[1*4 + 0].position, (Vector2{0.0f, 0.0f}));
+    CORRADE_COMPARE(vertices()[1*4 + 3].position, (Vector2{30.0f, 30.0f}));
+    CORRADE_COMPARE(vertices()[2*4 + 0].position, (Vector2{0.0f, 0.0f}));
+    CORRADE_COMPARE(vertices()[2*4 + 3].position, (Vector2{10.0f, 10.0f}));
+    CORRADE_COMPARE(layer.stateData().dataNodeProperties.size(), Implementation::BaseLayerDataOffsetTextureWidth);
+    CORRADE_COMPARE(layer.stateData().dataNodeProperties[0], (Vector3{0.0f, 0.0f, 0.0f}));
+    CORRADE_COMPARE(layer.stateData().dataNodeProperties[1], (Vector3{5.0f, 6.0f, 1.0f}));
+    CORRADE_COMPARE(layer.stateData().dataNodeProperties[2], (Vector3{1.0f, 2.0f, 1.0f}));
+    CORRADE_COMPARE(layer.stateData().dataNodePropertyUpdateBegin, 0);
+    CORRADE_COMPARE(layer.stateData().dataNodePropertyUpdateEnd, Implementation::BaseLayerDataOffsetTextureWidth);
+
+    /* Reset the ranges like a renderer would do after an upload */
+    layer.stateData().vertexUpdateBegin = ~std::size_t{};
+    layer.stateData().vertexUpdateEnd = 0;
+    layer.stateData().dataNodePropertyUpdateBegin = ~std::size_t{};
+    layer.stateData().dataNodePropertyUpdateEnd = 0;
+
+    /* Moving the node data 1 is attached to changes just its offset, vertex
+       data stay the same */
+    nodeOffsets[2] = {7.0f, 8.0f};
+    layer.update(LayerState::NeedsNodeOffsetSizeUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(vertices()[1*4 + 0].position, (Vector2{0.0f, 0.0f}));
+    CORRADE_COMPARE(layer.stateData().dataNodeProperties[1], (Vector3{7.0f, 8.0f, 1.0f}));
+    CORRADE_COMPARE(layer.stateData().dataNodeProperties[2], (Vector3{1.0f, 2.0f, 1.0f}));
+    CORRADE_COMPARE(layer.stateData().dataNodePropertyUpdateBegin, 1);
+    CORRADE_COMPARE(layer.stateData().dataNodePropertyUpdateEnd, 2);
+    CORRADE_VERIFY(layer.stateData().vertexUpdateBegin > layer.stateData().vertexUpdateEnd);
+
+    /* Resizing the node changes the vertices but not the offset */
+    layer.stateData().dataNodePropertyUpdateBegin = ~std::size_t{};
+    layer.stateData().dataNodePropertyUpdateEnd = 0;
+    nodeSizes[0] = {15.0f, 15.0f};
+    layer.update(LayerState::NeedsNodeOffsetSizeUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(vertices()[2*4 + 3].position, (Vector2{15.0f, 15.0f}));
+    CORRADE_COMPARE(layer.stateData().vertexUpdateBegin, 2*4*sizeof(Implementation::BaseLayerVertex));
+    CORRADE_COMPARE(layer.stateData().vertexUpdateEnd, 3*4*sizeof(Implementation::BaseLayerVertex));
+    CORRADE_VERIFY(layer.stateData().dataNodePropertyUpdateBegin > layer.stateData().dataNodePropertyUpdateEnd);
+
+    /* Changing node opacity doesn't touch the vertices at all, the color
+       doesn't include it and only the per-data opacity changes */
+    layer.stateData().vertexUpdateBegin = ~std::size_t{};
+    layer.stateData().vertexUpdateEnd = 0;
+    const Color4 color = vertices()[2*4 + 0].color;
+    nodeOpacities[0] = 0.5f;
+    layer.update(LayerState::NeedsNodeOpacityUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(vertices()[2*4 + 0].color, color);
+    CORRADE_COMPARE(layer.stateData().dataNodeProperties[1], (Vector3{7.0f, 8.0f, 1.0f}));
+    CORRADE_COMPARE(layer.stateData().dataNodeProperties[2], (Vector3{1.0f, 2.0f, 0.5f}));
+    CORRADE_COMPARE(layer.stateData().dataNodePropertyUpdateBegin, 2);
+    CORRADE_COMPARE(layer.stateData().dataNodePropertyUpdateEnd, 3);
+    CORRADE_VERIFY(layer.stateData().vertexUpdateBegin > layer.stateData().vertexUpdateEnd);
+}
+
+void BaseLayerTest::updateShaderClipping() {
+    struct LayerShared: BaseLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): BaseLayer::Shared{configuration} {}
+
+        void doSetStyle(const BaseLayerCommonStyleUniform&, Containers::ArrayView<const BaseLayerStyleUniform>) override {}
+    } shared{BaseLayer::Shared::Configuration{1}
+        .addFlags(BaseLayerSharedFlag::ShaderClipping)};
+    shared.setStyle(
+        BaseLayerCommonStyleUniform{},
+        {BaseLayerStyleUniform{}},
+        {});
+
+    struct Layer: BaseLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): BaseLayer{handle, shared} {}
+        BaseLayer::State& stateData() {
+            return static_cast<BaseLayer::State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
+
+    layer.create(0, nodeHandle(0, 0));
+    layer.create(0, nodeHandle(1, 0));
+    layer.create(0, nodeHandle(2, 0));
+    layer.create(0, nodeHandle(3, 0));
+
+    Vector2 nodeOffsets[4];
+    Vector2 nodeSizes[4]{{10.0f, 10.0f}, {10.0f, 10.0f}, {10.0f, 10.0f}, {10.0f, 10.0f}};
+    Float nodeOpacities[4]{1.0f, 1.0f, 1.0f, 1.0f};
+    UnsignedByte nodesEnabledData[1]{};
+    Containers::BitArrayView nodesEnabled{nodesEnabledData, 0, 4};
+    /* Data 3 isn't visible, data 0 and 2 share the second clip rect, data 1
+       is unclipped */
+    UnsignedInt dataIds[]{1, 2, 0};
+    UnsignedInt clipRectIds[]{1, 0};
+    UnsignedInt clipRectDataCounts[]{1, 2};
+    Vector2 clipRectOffsets[]{{1.0f, 2.0f}, {}};
+    Vector2 clipRectSizes[]{{3.0f, 4.0f}, {}};
+
+    layer.update(LayerState::NeedsDataUpdate|LayerState::NeedsNodeOrderUpdate, dataIds, clipRectIds, clipRectDataCounts, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, clipRectOffsets, clipRectSizes, {}, {});
+    CORRADE_COMPARE(layer.stateData().dataClipRects.size(), Implementation::BaseLayerDataOffsetTextureWidth);
+    CORRADE_COMPARE(layer.stateData().dataClipRects[0], (Vector4{1.0f, 2.0f, 4.0f, 6.0f}));
+    CORRADE_COMPARE(layer.stateData().dataClipRects[1], (Vector4{-Constants::inf(), -Constants::inf(), Constants::inf(), Constants::inf()}));
+    CORRADE_COMPARE(layer.stateData().dataClipRects[2], (Vector4{1.0f, 2.0f, 4.0f, 6.0f}));
+    CORRADE_COMPARE(layer.stateData().dataClipRects[3], Vector4{});
+    CORRADE_COMPARE(layer.stateData().dataClipRectUpdateBegin, 0);
+    CORRADE_COMPARE(layer.stateData().dataClipRectUpdateEnd, Implementation::BaseLayerDataOffsetTextureWidth);
+
+    /* Reset the range like a renderer would do after an upload */
+    layer.stateData().dataClipRectUpdateBegin = ~std::size_t{};
+    layer.stateData().dataClipRectUpdateEnd = 0;
+
+    /* Changing the clip rect updates only the data that use it */
+    clipRectOffsets[0] = {2.0f, 3.0f};
+    layer.update(LayerState::NeedsNodeOffsetSizeUpdate, dataIds, clipRectIds, clipRectDataCounts, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, clipRectOffsets, clipRectSizes, {}, {});
+    CORRADE_COMPARE(layer.stateData().dataClipRects[0], (Vector4{2.0f, 3.0f, 5.0f, 7.0f}));
+    CORRADE_COMPARE(layer.stateData().dataClipRects[2], (Vector4{2.0f, 3.0f, 5.0f, 7.0f}));
+    CORRADE_COMPARE(layer.stateData().dataClipRectUpdateBegin, 0);
+    CORRADE_COMPARE(layer.stateData().dataClipRectUpdateEnd, 3);
+
+    /* Nothing changes if the clip rects stay the same */
+    layer.stateData().dataClipRectUpdateBegin = ~std::size_t{};
+    layer.stateData().dataClipRectUpdateEnd = 0;
+    layer.update(LayerState::NeedsNodeOrderUpdate, dataIds, clipRectIds, clipRectDataCounts, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, clipRectOffsets, clipRectSizes, {}, {});
+    CORRADE_VERIFY(layer.stateData().dataClipRectUpdateBegin > layer.stateData().dataClipRectUpdateEnd);
+}
+
+void BaseLayerTest::updateAutomaticShaderVariants() {
+    struct LayerShared: BaseLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): BaseLayer::Shared{configuration} {}
+
+        void doSetStyle(const BaseLayerCommonStyleUniform&, Containers::ArrayView<const BaseLayerStyleUniform>) override {}
+    } shared{BaseLayer::Shared::Configuration{4, 5}
+        .setDynamicStyleCount(1)
+        .addFlags(BaseLayerSharedFlag::AutomaticShaderVariants)};
+    /* Style 4 maps to uniform 0 as well */
+    shared.setStyle(
+        BaseLayerCommonStyleUniform{},
+        {BaseLayerStyleUniform{},
+         BaseLayerStyleUniform{}
+            .setOutlineWidth(1.0f),
+         BaseLayerStyleUniform{}
+            .setCornerRadius({0.0f, 0.0f, 2.0f, 0.0f}),
+         /* Makes the outline show in the corners even with zero width */
+         BaseLayerStyleUniform{}
+            .setInnerOutlineCornerRadius(3.0f)},
+        {0, 1, 2, 3, 0},
+        {});
+
+    struct Layer: BaseLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): BaseLayer{handle, shared} {}
+        BaseLayer::State& stateData() {
+            return static_cast<BaseLayer::State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
+
+    layer.create(0, nodeHandle(0, 0));
+    layer.create(1, nodeHandle(0, 0));
+    layer.create(2, nodeHandle(0, 0));
+    layer.create(3, nodeHandle(0, 0));
+    layer.create(4, nodeHandle(0, 0));
+    DataHandle withOutline = layer.create(4, nodeHandle(0, 0));
+    layer.setOutlineWidth(withOutline, 0.5f);
+    /* Dynamic style, initially a default one */
+    DataHandle dynamic = layer.create(5, nodeHandle(0, 0));
+    /* Not visible, so not filled */
+    layer.create(0, nodeHandle(0, 0));
+
+    Vector2 nodeOffsets[1];
+    Vector2 nodeSizes[1];
+    Float nodeOpacities[1]{};
+    UnsignedByte nodesEnabledData[1]{};
+    Containers::BitArrayView nodesEnabled{nodesEnabledData, 0, 1};
+    UnsignedInt dataIds[]{6, 5, 4, 3, 2, 1, 0};
+
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.stateData().simpleData.size(), layer.capacity());
+    CORRADE_VERIFY(layer.stateData().simpleData[0]);
+    CORRADE_VERIFY(!layer.stateData().simpleData[1]);
+    CORRADE_VERIFY(!layer.stateData().simpleData[2]);
+    CORRADE_VERIFY(!layer.stateData().simpleData[3]);
+    CORRADE_VERIFY(layer.stateData().simpleData[4]);
+    CORRADE_VERIFY(!layer.stateData().simpleData[5]);
+    CORRADE_VERIFY(layer.stateData().simpleData[6]);
+
+    /* Changing the dynamic style to one with a rounded corner is reflected
+       with just a common data update */
+    layer.setDynamicStyle(0, BaseLayerStyleUniform{}
+        .setCornerRadius(1.0f), {});
+    layer.update(LayerState::NeedsCommonDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_VERIFY(!layer.stateData().simpleData[dataHandleId(dynamic)]);
+
+    /* Resetting the custom outline width makes the data simple again */
+    layer.setOutlineWidth(withOutline, 0.0f);
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_VERIFY(layer.stateData().simpleData[dataHandleId(withOutline)]);
+}
+
+void BaseLayerTest::updateInstancedQuads() {
+    struct LayerShared: BaseLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): BaseLayer::Shared{configuration} {}
+
+        void doSetStyle(const BaseLayerCommonStyleUniform&, Containers::ArrayView<const BaseLayerStyleUniform>) override {}
+    } shared{BaseLayer::Shared::Configuration{2}
+        .addFlags(BaseLayerSharedFlag::InstancedQuads|BaseLayerSharedFlag::Textured)};
+    shared.setStyle(
+        BaseLayerCommonStyleUniform{}
+            .setSmoothness(1.0f),
+        {BaseLayerStyleUniform{}, BaseLayerStyleUniform{}},
+        {{}, {2.0f, 1.0f, 0.0f, 3.0f}});
+
+    struct Layer: BaseLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): BaseLayer{handle, shared} {}
+        BaseLayer::State& stateData() {
+            return static_cast<BaseLayer::State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    /* UI size twice the framebuffer size, so the smoothness is 2 units */
+    layer.setSize({200, 200}, {100, 100});
+
+    layer.create(0, nodeHandle(0, 0));
+    DataHandle data1 = layer.create(1, nodeHandle(1, 0));
+    layer.setColor(data1, 0xff3366_rgbf);
+    layer.setOutlineWidth(data1, {1.0f, 2.0f, 3.0f, 4.0f});
+    layer.setTextureCoordinates(data1, {0.5f, 0.25f, 7.0f}, {0.25f, 0.5f});
+    layer.create(0, nodeHandle(2, 0));
+
+    Vector2 nodeOffsets[3]{{}, {10.0f, 20.0f}, {50.0f, 60.0f}};
+    Vector2 nodeSizes[3]{{5.0f, 5.0f}, {22.0f, 14.0f}, {30.0f, 40.0f}};
+    Float nodeOpacities[3]{1.0f, 0.5f, 1.0f};
+    UnsignedByte nodesEnabledData[1]{};
+    Containers::BitArrayView nodesEnabled{nodesEnabledData, 0, 3};
+    /* Only two data drawn, in a reverse order */
+    UnsignedInt dataIds[]{2, 1};
+
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+
+    /* There are no indices, and one instance per drawn data in the draw
+       order */
+    CORRADE_COMPARE(layer.stateData().indices.size(), 0);
+    CORRADE_COMPARE(layer.stateData().vertices.size(), 2*sizeof(Implementation::BaseLayerTexturedInstance));
+    Containers::ArrayView<const Implementation::BaseLayerTexturedInstance> instances = Containers::arrayCast<const Implementation::BaseLayerTexturedInstance>(layer.stateData().vertices);
+
+    /* The position and size include the padding and smoothness expansion */
+    CORRADE_COMPARE(instances[0].instance.position, (Vector2{48.0f, 58.0f}));
+    CORRADE_COMPARE(instances[0].instance.size, (Vector2{34.0f, 44.0f}));
+    CORRADE_COMPARE(instances[0].instance.styleUniform, 0);
+    CORRADE_COMPARE(instances[0].instance.color, 0xffffffff_rgbaf);
+    CORRADE_COMPARE(instances[1].instance.position, (Vector2{10.0f, 19.0f}));
+    CORRADE_COMPARE(instances[1].instance.size, (Vector2{24.0f, 14.0f}));
+    CORRADE_COMPARE(instances[1].instance.outlineWidth, (Vector4{1.0f, 2.0f, 3.0f, 4.0f}));
+    CORRADE_COMPARE(instances[1].instance.styleUniform, 1);
+    CORRADE_COMPARE(instances[1].instance.color, 0xff3366ff_rgbaf*0.5f);
+
+    /* The texture coordinates are Y-flipped and expanded proportionally to
+       the smoothness */
+    CORRADE_COMPARE(instances[1].textureCoordinateOffset, (Vector3{0.475f, 0.85f, 7.0f}));
+    CORRADE_COMPARE(instances[1].textureCoordinateSize, (Vector2{0.3f, -0.7f}));
+
+    /* Changing just the node order regenerates the instances */
+    UnsignedInt dataIdsReordered[]{1, 2};
+    layer.stateData().vertexUpdateBegin = ~std::size_t{};
+    layer.stateData().vertexUpdateEnd = 0;
+    layer.update(LayerState::NeedsNodeOrderUpdate, dataIdsReordered, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(instances[0].instance.position, (Vector2{10.0f, 19.0f}));
+    CORRADE_COMPARE(instances[1].instance.position, (Vector2{48.0f, 58.0f}));
+    CORRADE_COMPARE(layer.stateData().vertexUpdateBegin, 0);
+    CORRADE_COMPARE(layer.stateData().vertexUpdateEnd, 2*sizeof(Implementation::BaseLayerTexturedInstance));
+}
+
+void BaseLayerTest::compactVertices() {
+    /* The conversion is done in BaseLayerGL on upload, so it's tested
+       directly here. UI size is 200x100, so 1/16384 of it is 0.012207 and
+       0.0061035 units. */
+    Implementation::BaseLayerTexturedVertex vertices[2];
+    vertices[0].vertex.position = {50.0f, 75.0f};
+    vertices[0].vertex.centerDistance = {-25.0f, 12.5f};
+    vertices[0].vertex.outlineWidth = {1.0f, 2.0f, 3.0f, 4.0f};
+    vertices[0].vertex.color = 0xff336680_rgbaf;
+    vertices[0].vertex.styleUniform = 7;
+    vertices[0].textureCoordinates = {0.25f, 0.75f, 3.0f};
+    /* Values outside of the representable range get clamped */
+    vertices[1].vertex.position = {-500.0f, 1000.0f};
+    vertices[1].vertex.centerDistance = {};
+    vertices[1].vertex.outlineWidth = {};
+    vertices[1].vertex.color = Color4{2.0f, -1.0f, 0.5f, 1.0f};
+    vertices[1].vertex.styleUniform = 0;
+    vertices[1].textureCoordinates = {-3.0f, 1.0f, 0.0f};
+
+    Implementation::BaseLayerCompactTexturedVertex out[2];
+    Implementation::compactBaseLayerVerticesInto(vertices, out, {200.0f, 100.0f});
+    CORRADE_COMPARE(out[0].vertex.position, (Vector2s{4096, 12288}));
+    CORRADE_COMPARE(out[0].vertex.centerDistance, (Vector2s{-2048, 2048}));
+    CORRADE_COMPARE(out[0].vertex.outlineWidth, (Vector4s{82, 328, 246, 655}));
+    CORRADE_COMPARE(out[0].vertex.color, 0xff336680_rgba);
+    CORRADE_COMPARE(out[0].vertex.styleUniform, 7);
+    CORRADE_COMPARE(out[0].textureCoordinates, (Vector3s{4096, 12288, 3}));
+    CORRADE_COMPARE(out[1].vertex.position, (Vector2s{-32768, 32767}));
+    CORRADE_COMPARE(out[1].vertex.color, (Color4ub{255, 0, 128, 255}));
+    CORRADE_COMPARE(out[1].textureCoordinates, (Vector3s{-32768, 16384, 0}));
+}
+
+void BaseLayerTest::updateVertexExecutor() {
+    auto&& data = UpdateVertexExecutorData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    struct LayerShared: BaseLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): BaseLayer::Shared{configuration} {}
+
+        void doSetStyle(const BaseLayerCommonStyleUniform&, Containers::ArrayView<const BaseLayerStyleUniform>) override {}
+    } shared{BaseLayer::Shared::Configuration{2}
+        .addFlags(data.flags)};
+    shared.setStyle(
+        BaseLayerCommonStyleUniform{}
+            .setSmoothness(1.0f),
+        {BaseLayerStyleUniform{}, BaseLayerStyleUniform{}},
+        {{}, {2.0f, 1.0f, 0.0f, 3.0f}});
+
+    struct Layer: BaseLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): BaseLayer{handle, shared} {}
+        BaseLayer::State& stateData() {
+            return static_cast<BaseLayer::State&>(*_state);
+        }
+    };
+
+    /* One layer generating the vertices directly, another through the
+       executor, the results should be the same */
+    Layer sequential{layerHandle(0, 1), shared};
+    Layer parallel{layerHandle(1, 1), shared};
+    CORRADE_VERIFY(!parallel.vertexExecutor());
+
+    Containers::Array<UnsignedInt> executorCalls;
+    parallel.setVertexExecutor([](UnsignedInt count, void(*task)(void*, UnsignedInt), void* taskState, void* userData) {
+        arrayAppend(*static_cast<Containers::Array<UnsignedInt>*>(userData), count);
+        /* Going in reverse to verify the order doesn't matter */
+        for(UnsignedInt i = count; i != 0; --i)
+            task(taskState, i - 1);
+    }, &executorCalls);
+    CORRADE_VERIFY(parallel.vertexExecutor());
+    CORRADE_COMPARE(parallel.vertexExecutorUserData(), &executorCalls);
+
+    /* Enough data for three tasks, the last one not full */
+    constexpr std::size_t count = Implementation::BaseLayerVertexTaskDataCount*2 + 100;
+    Containers::Array<Vector2> nodeOffsets{NoInit, count};
+    Containers::Array<Vector2> nodeSizes{NoInit, count};
+    Containers::Array<Float> nodeOpacities{NoInit, count};
+    Containers::BitArray nodesEnabled{ValueInit, count};
+    Containers::Array<UnsignedInt> dataIds{NoInit, count};
+    for(Layer* layer: {&sequential, &parallel}) {
+        /* Required to be called before update() (because
+           AbstractUserInterface guarantees the same on a higher level) */
+        layer->setSize({200, 200}, {100, 100});
+        for(std::size_t i = 0; i != count; ++i) {
+            DataHandle handle = layer->create(UnsignedInt(i % 2), nodeHandle(UnsignedInt(i), 0));
+            layer->setColor(handle, Color4{i/Float(count), 0.5f, 1.0f, 0.75f});
+            layer->setOutlineWidth(handle, Float(i % 5));
+            if(shared.flags() & BaseLayerSharedFlag::Textured)
+                layer->setTextureCoordinates(handle, {0.25f, 0.5f, Float(i % 3)}, {0.5f, 0.25f});
+        }
+    }
+    for(std::size_t i = 0; i != count; ++i) {
+        nodeOffsets[i] = {Float(i % 100), Float(i/100)};
+        nodeSizes[i] = {10.0f + i % 7, 20.0f + i % 3};
+        nodeOpacities[i] = 1.0f - (i % 4)*0.25f;
+        if(i % 3) nodesEnabled.set(i);
+        /* Draw order different from the data order */
+        dataIds[i] = UnsignedInt((i*7) % count);
+    }
+
+    sequential.update(LayerState::NeedsDataUpdate|LayerState::NeedsNodeOrderUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    parallel.update(LayerState::NeedsDataUpdate|LayerState::NeedsNodeOrderUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE_AS(executorCalls, Containers::arrayView<UnsignedInt>({
+        3
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(parallel.stateData().vertices,
+        sequential.stateData().vertices,
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(parallel.stateData().vertexUpdateBegin, sequential.stateData().vertexUpdateBegin);
+    CORRADE_COMPARE(parallel.stateData().vertexUpdateEnd, sequential.stateData().vertexUpdateEnd);
+
+    /* Updating with node offsets changed regenerates everything again */
+    for(std::size_t i = 0; i != count; ++i)
+        nodeOffsets[i] += Vector2{0.5f};
+    sequential.update(LayerState::NeedsNodeOffsetSizeUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    parallel.update(LayerState::NeedsNodeOffsetSizeUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE_AS(executorCalls, Containers::arrayView<UnsignedInt>({
+        3, 3
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(parallel.stateData().vertices,
+        sequential.stateData().vertices,
+        TestSuite::Compare::Container);
+
+    /* Fewer data than a single task handles are generated directly */
+    sequential.update(LayerState::NeedsDataUpdate|LayerState::NeedsNodeOrderUpdate, dataIds.prefix(100), {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    parallel.update(LayerState::NeedsDataUpdate|LayerState::NeedsNodeOrderUpdate, dataIds.prefix(100), {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE_AS(executorCalls, Containers::arrayView<UnsignedInt>({
+        3, 3
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(parallel.stateData().vertices,
+        sequential.stateData().vertices,
+        TestSuite::Compare::Container);
+}
+
 void BaseLayerTest::updateNoStyleSet() {
     auto&& data = UpdateNoStyleSetData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -506,6 +506,7 @@ void BlurShaderGLTest::render() {
         .setSubImage(0, {}, *image);
 
     BlurShaderGL shader{data.radius, data.limit};
+    shader.finalize();
     /* Internally this divides {2, -2}, resulting in an identity to match other
        vertex shaders in this test */
     shader.setProjection({2.0f, -2.0f});
@@ -737,6 +738,7 @@ void BlurShaderGLTest::benchmark() {
         .setSubImage(0, {}, ImageView2D{PixelFormat::RGBA8Unorm, BenchmarkSize, Containers::Array<Color4ub>{DirectInit, std::size_t(BenchmarkSize.product()), 0x336699ff_rgba}});
 
     BlurShaderGL shader{data.radius, data.limit};
+    shader.finalize();
     /* Internally this divides {2, -2}, resulting in an identity to match other
        vertex shaders in this test */
     shader.setProjection({2.0f, -2.0f});
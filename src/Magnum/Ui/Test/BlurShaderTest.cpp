@@ -26,9 +26,12 @@
 
 #include <Corrade/Containers/Array.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
+#include <Corrade/Utility/Algorithms.h>
 
 #include "Magnum/Ui/Implementation/blurCoefficients.h"
+#include "Magnum/Ui/Implementation/blurQuads.h"
 
 namespace Magnum { namespace Ui { namespace {
 
@@ -39,6 +42,8 @@ struct BlurShaderTest: TestSuite::Tester {
     void blurCoefficientsLimitTooLarge();
 
     void interpolatedBlurCoefficients();
+
+    void mergeOverlappingBlurQuads();
 };
 
 const struct {
@@ -69,6 +74,8 @@ BlurShaderTest::BlurShaderTest() {
 
     addInstancedTests({&BlurShaderTest::interpolatedBlurCoefficients},
         Containers::arraySize(InterpolatedBlurCoefficientsData));
+
+    addTests({&BlurShaderTest::mergeOverlappingBlurQuads});
 }
 
 void BlurShaderTest::blurCoefficients() {
@@ -187,6 +194,44 @@ void BlurShaderTest::interpolatedBlurCoefficients() {
     }
 }
 
+void BlurShaderTest::mergeOverlappingBlurQuads() {
+    const auto quad = [](const Range2D& range) {
+        return Containers::array<Vector2>({
+            range.min(),
+            {range.max().x(), range.min().y()},
+            {range.min().x(), range.max().y()},
+            range.max()
+        });
+    };
+
+    Containers::Array<Vector2> vertices{NoInit, 5*4};
+    /* Gets merged with quad 3 first, and then with quad 1, which it didn't
+       overlap originally */
+    Utility::copy(quad({{0.0f, 0.0f}, {10.0f, 10.0f}}), vertices.sliceSize(0, 4));
+    Utility::copy(quad({{14.0f, 0.0f}, {20.0f, 10.0f}}), vertices.sliceSize(4, 4));
+    /* Overlaps the merged quad but merging would blur a much larger area */
+    Utility::copy(quad({{9.0f, 9.0f}, {12.0f, 40.0f}}), vertices.sliceSize(8, 4));
+    Utility::copy(quad({{5.0f, 0.0f}, {15.0f, 10.0f}}), vertices.sliceSize(12, 4));
+    /* Doesn't overlap anything */
+    Utility::copy(quad({{20.0f, 20.0f}, {30.0f, 30.0f}}), vertices.sliceSize(16, 4));
+
+    CORRADE_VERIFY(mergeOverlappingBlurQuadsInPlace(vertices));
+
+    Containers::Array<Vector2> expected{NoInit, 5*4};
+    Utility::copy(quad({{0.0f, 0.0f}, {20.0f, 10.0f}}), expected.sliceSize(0, 4));
+    Utility::copy(quad({{0.0f, 0.0f}, {0.0f, 0.0f}}), expected.sliceSize(4, 4));
+    Utility::copy(quad({{9.0f, 9.0f}, {12.0f, 40.0f}}), expected.sliceSize(8, 4));
+    Utility::copy(quad({{0.0f, 0.0f}, {0.0f, 0.0f}}), expected.sliceSize(12, 4));
+    Utility::copy(quad({{20.0f, 20.0f}, {30.0f, 30.0f}}), expected.sliceSize(16, 4));
+    CORRADE_COMPARE_AS(vertices, expected,
+        TestSuite::Compare::Container);
+
+    /* Running again on the merged quads does nothing */
+    CORRADE_VERIFY(!mergeOverlappingBlurQuadsInPlace(vertices));
+    CORRADE_COMPARE_AS(vertices, expected,
+        TestSuite::Compare::Container);
+}
+
 }}}
 
 CORRADE_TEST_MAIN(Magnum::Ui::BlurShaderTest)
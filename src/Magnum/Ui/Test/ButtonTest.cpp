@@ -25,6 +25,8 @@
 */
 
 #include <sstream> /** @todo remove once Debug is stream-free */
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/StringView.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
 
@@ -48,6 +50,8 @@ struct ButtonTest: WidgetTester {
     void constructIconText();
     void constructIconTextTextProperties();
     void constructNoCreate();
+    void constructMultiple();
+    void constructMultipleInvalidSize();
 
     void setStyle();
     void setStyleWhileActive();
@@ -86,6 +90,8 @@ ButtonTest::ButtonTest() {
         &ButtonTest::constructIconText,
         &ButtonTest::constructIconTextTextProperties,
         &ButtonTest::constructNoCreate,
+        &ButtonTest::constructMultiple,
+        &ButtonTest::constructMultipleInvalidSize,
     }, &WidgetTester::setup,
        &WidgetTester::teardown);
 
@@ -351,6 +357,85 @@ void ButtonTest::constructNoCreate() {
     CORRADE_COMPARE(button.textData(), DataHandle::Null);
 }
 
+void ButtonTest::constructMultiple() {
+    using namespace Containers::Literals;
+
+    struct ButtonData {
+        Vector2 offset, size;
+        Icon icon;
+        Containers::StringView text;
+        ButtonStyle style;
+    } buttonData[]{
+        {{0.0f, 0.0f}, {32.0f, 16.0f}, Icon::Yes, "hello!"_s, ButtonStyle::Primary},
+        {{0.0f, 16.0f}, {24.0f, 16.0f}, Icon::None, "hi"_s, ButtonStyle::Flat},
+        {{0.0f, 32.0f}, {16.0f, 16.0f}, Icon::No, ""_s, ButtonStyle::Danger},
+        {{0.0f, 48.0f}, {8.0f, 16.0f}, Icon::None, ""_s, ButtonStyle::Default},
+    };
+    Containers::StridedArrayView1D<const ButtonData> buttonDataView = buttonData;
+
+    NodeHandle nodes[4];
+    buttons(ui, rootNode,
+        buttonDataView.slice(&ButtonData::offset),
+        buttonDataView.slice(&ButtonData::size),
+        buttonDataView.slice(&ButtonData::icon),
+        buttonDataView.slice(&ButtonData::text),
+        buttonDataView.slice(&ButtonData::style),
+        nodes);
+    for(std::size_t i = 0; i != Containers::arraySize(buttonData); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_VERIFY(ui.isHandleValid(nodes[i]));
+        CORRADE_COMPARE(ui.nodeParent(nodes[i]), rootNode);
+        CORRADE_COMPARE(ui.nodeOffset(nodes[i]), buttonData[i].offset);
+        CORRADE_COMPARE(ui.nodeSize(nodes[i]), buttonData[i].size);
+    }
+
+    /* Can only verify that the data were created, nothing else. Visually
+       tested in StyleGLTest. Each button has a background, two have an icon
+       and two have a text. */
+    CORRADE_COMPARE(ui.baseLayer().usedCount(), 4);
+    CORRADE_COMPARE(ui.textLayer().usedCount(), 4);
+
+    /* Empty icon and text views create just the backgrounds */
+    NodeHandle emptyNodes[2];
+    const Vector2 offsets[]{{}, {}};
+    const Vector2 sizes[]{{16.0f, 16.0f}, {16.0f, 16.0f}};
+    const ButtonStyle styles[]{ButtonStyle::Success, ButtonStyle::Warning};
+    buttons(ui, rootNode, offsets, sizes, nullptr, nullptr, styles, emptyNodes);
+    CORRADE_VERIFY(ui.isHandleValid(emptyNodes[0]));
+    CORRADE_VERIFY(ui.isHandleValid(emptyNodes[1]));
+    CORRADE_COMPARE(ui.baseLayer().usedCount(), 6);
+    CORRADE_COMPARE(ui.textLayer().usedCount(), 4);
+}
+
+void ButtonTest::constructMultipleInvalidSize() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    const Vector2 vectors[3]{};
+    const Vector2 vectorsInvalid[2]{};
+    const Icon icons[3]{};
+    const Icon iconsInvalid[2]{};
+    const Containers::StringView texts[3]{};
+    const Containers::StringView textsInvalid[4]{};
+    const ButtonStyle styles[3]{};
+    const ButtonStyle stylesInvalid[2]{};
+    NodeHandle nodes[3];
+    NodeHandle nodesInvalid[4];
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    buttons(ui, rootNode, vectors, vectorsInvalid, icons, texts, styles, nodes);
+    buttons(ui, rootNode, vectors, vectors, icons, texts, stylesInvalid, nodes);
+    buttons(ui, rootNode, vectors, vectors, icons, texts, styles, nodesInvalid);
+    buttons(ui, rootNode, vectors, vectors, iconsInvalid, texts, styles, nodes);
+    buttons(ui, rootNode, vectors, vectors, icons, textsInvalid, styles, nodes);
+    CORRADE_COMPARE(out.str(),
+        "Ui::buttons(): expected offset, size, style and node views to have the same size but got 3, 2, 3 and 3\n"
+        "Ui::buttons(): expected offset, size, style and node views to have the same size but got 3, 3, 2 and 3\n"
+        "Ui::buttons(): expected offset, size, style and node views to have the same size but got 3, 3, 3 and 4\n"
+        "Ui::buttons(): expected icon and text views to be either empty or have a size of 3 but got 2 and 3\n"
+        "Ui::buttons(): expected icon and text views to be either empty or have a size of 3 but got 3 and 4\n");
+}
+
 void ButtonTest::setStyle() {
     auto&& data = SetStyleData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -0,0 +1,245 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Containers/Function.h>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Magnum/Math/Time.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "Magnum/Ui/AbstractUserInterface.h"
+#include "Magnum/Ui/EventLayer.h"
+#include "Magnum/Ui/Event.h"
+#include "Magnum/Ui/Handle.h"
+
+namespace Magnum { namespace Ui { namespace Test { namespace {
+
+struct EventLayerBenchmark: TestSuite::Tester {
+    explicit EventLayerBenchmark();
+
+    void pointerMove();
+    void pointerMoveHover();
+    void pointerMoveCaptured();
+    void pointerPressRelease();
+};
+
+enum class Shape {
+    /* A single branch of nodes each filling the previous one, with two leaf
+       nodes splitting the innermost one into a left and right half */
+    Deep,
+    /* A single node with a square grid of children */
+    Wide
+};
+
+const struct {
+    const char* name;
+    Shape shape;
+    UnsignedInt nodeCount;
+    UnsignedInt layerCount;
+} HierarchyData[]{
+    {"deep, 100 nodes, 1 layer", Shape::Deep, 100, 1},
+    {"deep, 1k nodes, 1 layer", Shape::Deep, 1000, 1},
+    {"deep, 1k nodes, 4 layers", Shape::Deep, 1000, 4},
+    {"wide, 1k nodes, 1 layer", Shape::Wide, 1000, 1},
+    {"wide, 10k nodes, 1 layer", Shape::Wide, 10000, 1},
+    {"wide, 10k nodes, 4 layers", Shape::Wide, 10000, 4},
+};
+
+/* Creates nodes of given shape, with each node having a press, enter and
+   leave handler in each of the event layers. The first and second positions
+   are in two different neighboring leaf nodes. */
+struct Hierarchy {
+    explicit Hierarchy(Shape shape, UnsignedInt nodeCount, UnsignedInt layerCount);
+
+    AbstractUserInterface ui{{1000, 1000}};
+    Containers::Array<NodeHandle> nodes;
+    NodeHandle firstNode, secondNode;
+    Vector2 first, second;
+    UnsignedInt pressCount = 0,
+        enterCount = 0,
+        leaveCount = 0;
+};
+
+Hierarchy::Hierarchy(const Shape shape, const UnsignedInt nodeCount, const UnsignedInt layerCount) {
+    const NodeHandle root = arrayAppend(nodes, ui.createNode({}, {1000.0f, 1000.0f}));
+    switch(shape) {
+        case Shape::Deep: {
+            NodeHandle parent = root;
+            for(UnsignedInt i = 3; i < nodeCount; ++i)
+                parent = arrayAppend(nodes, ui.createNode(parent, {}, {1000.0f, 1000.0f}));
+            firstNode = arrayAppend(nodes, ui.createNode(parent, {}, {500.0f, 1000.0f}));
+            secondNode = arrayAppend(nodes, ui.createNode(parent, {500.0f, 0.0f}, {500.0f, 1000.0f}));
+            first = {250.0f, 500.0f};
+            second = {750.0f, 500.0f};
+        } break;
+        case Shape::Wide: {
+            UnsignedInt width = 1;
+            while(width*width < nodeCount - 1)
+                ++width;
+            const Vector2 size{1000.0f/width};
+            for(UnsignedInt i = 0; i != nodeCount - 1; ++i) {
+                const NodeHandle node = arrayAppend(nodes, ui.createNode(root, size*Vector2{Float(i % width), Float(i / width)}, size));
+                if(i == 0)
+                    firstNode = node;
+                else if(i == 1)
+                    secondNode = node;
+            }
+            first = size*Vector2{0.5f, 0.5f};
+            second = size*Vector2{1.5f, 0.5f};
+        } break;
+    }
+
+    CORRADE_INTERNAL_ASSERT(nodes.size() == nodeCount);
+
+    for(UnsignedInt i = 0; i != layerCount; ++i) {
+        EventLayer& layer = ui.setLayerInstance(Containers::pointer<EventLayer>(ui.createLayer()));
+        for(const NodeHandle node: nodes) {
+            layer.onPress(node, [this]{
+                ++pressCount;
+            });
+            layer.onEnter(node, [this]{
+                ++enterCount;
+            });
+            layer.onLeave(node, [this]{
+                ++leaveCount;
+            });
+        }
+    }
+}
+
+EventLayerBenchmark::EventLayerBenchmark() {
+    addInstancedBenchmarks({&EventLayerBenchmark::pointerMove,
+                            &EventLayerBenchmark::pointerMoveHover,
+                            &EventLayerBenchmark::pointerMoveCaptured,
+                            &EventLayerBenchmark::pointerPressRelease}, 10,
+        Containers::arraySize(HierarchyData));
+}
+
+void EventLayerBenchmark::pointerMove() {
+    auto&& data = HierarchyData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Hierarchy hierarchy{data.shape, data.nodeCount, data.layerCount};
+
+    /* The initial event does the implicit update() and makes the node
+       hovered, which isn't meant to be measured */
+    {
+        PointerMoveEvent event{{}, PointerEventSource::Mouse, {}, {}, true, 0};
+        CORRADE_VERIFY(hierarchy.ui.pointerMoveEvent(hierarchy.first, event));
+    }
+
+    /* Moving inside the same node, i.e. without any hover change */
+    UnsignedInt i = 0;
+    CORRADE_BENCHMARK(5) {
+        PointerMoveEvent event{{}, PointerEventSource::Mouse, {}, {}, true, 0};
+        hierarchy.ui.pointerMoveEvent(hierarchy.first + Vector2{Float(i++ % 2)}, event);
+    }
+
+    CORRADE_COMPARE(hierarchy.ui.currentHoveredNode(), hierarchy.firstNode);
+    CORRADE_COMPARE(hierarchy.enterCount, data.layerCount);
+    CORRADE_COMPARE(hierarchy.leaveCount, 0);
+}
+
+void EventLayerBenchmark::pointerMoveHover() {
+    auto&& data = HierarchyData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Hierarchy hierarchy{data.shape, data.nodeCount, data.layerCount};
+
+    {
+        PointerMoveEvent event{{}, PointerEventSource::Mouse, {}, {}, true, 0};
+        CORRADE_VERIFY(hierarchy.ui.pointerMoveEvent(hierarchy.first, event));
+    }
+
+    /* Moving between two nodes, causing a leave and enter each time */
+    UnsignedInt i = 0;
+    CORRADE_BENCHMARK(5) {
+        PointerMoveEvent event{{}, PointerEventSource::Mouse, {}, {}, true, 0};
+        hierarchy.ui.pointerMoveEvent(i++ % 2 ? hierarchy.first : hierarchy.second, event);
+    }
+
+    CORRADE_COMPARE(hierarchy.ui.currentHoveredNode(), hierarchy.secondNode);
+    CORRADE_COMPARE(hierarchy.enterCount, data.layerCount*6);
+    CORRADE_COMPARE(hierarchy.leaveCount, data.layerCount*5);
+}
+
+void EventLayerBenchmark::pointerMoveCaptured() {
+    auto&& data = HierarchyData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Hierarchy hierarchy{data.shape, data.nodeCount, data.layerCount};
+
+    {
+        PointerMoveEvent event{{}, PointerEventSource::Mouse, {}, {}, true, 0};
+        CORRADE_VERIFY(hierarchy.ui.pointerMoveEvent(hierarchy.first, event));
+    } {
+        PointerEvent event{{}, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0};
+        CORRADE_VERIFY(hierarchy.ui.pointerPressEvent(hierarchy.first, event));
+    }
+    CORRADE_COMPARE(hierarchy.ui.currentCapturedNode(), hierarchy.firstNode);
+
+    /* Dragging in and out of the captured node. The events go directly to the
+       captured node without any hit testing, the node gets only a leave and
+       enter without the other node getting hovered. */
+    UnsignedInt i = 0;
+    CORRADE_BENCHMARK(5) {
+        PointerMoveEvent event{{}, PointerEventSource::Mouse, {}, Pointer::MouseLeft, true, 0};
+        hierarchy.ui.pointerMoveEvent(i++ % 2 ? hierarchy.first : hierarchy.second, event);
+    }
+
+    CORRADE_COMPARE(hierarchy.ui.currentCapturedNode(), hierarchy.firstNode);
+    CORRADE_COMPARE(hierarchy.ui.currentHoveredNode(), NodeHandle::Null);
+    CORRADE_COMPARE(hierarchy.enterCount, data.layerCount*3);
+    CORRADE_COMPARE(hierarchy.leaveCount, data.layerCount*3);
+}
+
+void EventLayerBenchmark::pointerPressRelease() {
+    auto&& data = HierarchyData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Hierarchy hierarchy{data.shape, data.nodeCount, data.layerCount};
+
+    /* The initial event does the implicit update(), which isn't meant to be
+       measured */
+    {
+        PointerMoveEvent event{{}, PointerEventSource::Mouse, {}, {}, true, 0};
+        CORRADE_VERIFY(hierarchy.ui.pointerMoveEvent(hierarchy.first, event));
+    }
+
+    CORRADE_BENCHMARK(5) {
+        PointerEvent press{{}, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0};
+        hierarchy.ui.pointerPressEvent(hierarchy.first, press);
+        PointerEvent release{{}, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0};
+        hierarchy.ui.pointerReleaseEvent(hierarchy.first, release);
+    }
+
+    CORRADE_COMPARE(hierarchy.ui.currentCapturedNode(), NodeHandle::Null);
+    CORRADE_COMPARE(hierarchy.pressCount, data.layerCount*5);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Ui::Test::EventLayerBenchmark)
@@ -26,12 +26,15 @@
 
 #include <sstream> /** @todo remove once Debug is stream-free */
 #include <Corrade/Containers/Function.h>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
 #include <Magnum/Math/Complex.h>
+#include <Magnum/Math/Time.h>
 
 #include "Magnum/Ui/AbstractUserInterface.h"
 #include "Magnum/Ui/EventLayer.h"
@@ -58,12 +61,17 @@ struct EventLayerTest: TestSuite::Tester {
     void destructScopedConnectionsActive();
 
     void invalidSlot();
+    void invalidSharedSlot();
+    void invalidLongPressDuration();
 
     void call();
 
     void connect();
     void connectScoped();
 
+    void compact();
+    void compactScopedConnectionsActive();
+
     void press();
     void release();
     void releasePress();
@@ -90,6 +98,8 @@ struct EventLayerTest: TestSuite::Tester {
     void pinchPressMoveRelease();
     void pinchFromUserInterface();
 
+    void longPressFromUserInterface();
+
     void enter();
     void enterMove();
     void leave();
@@ -103,6 +113,9 @@ struct EventLayerTest: TestSuite::Tester {
     void remove();
     void removeScoped();
     void cleanNodes();
+
+    void sharedSlot();
+    void sharedSlotRemoveRecycle();
 };
 
 using namespace Math::Literals;
@@ -264,6 +277,8 @@ EventLayerTest::EventLayerTest() {
               &EventLayerTest::destructScopedConnectionsActive,
 
               &EventLayerTest::invalidSlot,
+              &EventLayerTest::invalidSharedSlot,
+              &EventLayerTest::invalidLongPressDuration,
 
               &EventLayerTest::call});
 
@@ -271,7 +286,10 @@ EventLayerTest::EventLayerTest() {
                        &EventLayerTest::connectScoped},
         Containers::arraySize(ConnectData));
 
-    addTests({&EventLayerTest::press,
+    addTests({&EventLayerTest::compact,
+              &EventLayerTest::compactScopedConnectionsActive,
+
+              &EventLayerTest::press,
               &EventLayerTest::release,
               &EventLayerTest::releasePress,
               &EventLayerTest::pressReleaseFromUserInterface,
@@ -297,6 +315,8 @@ EventLayerTest::EventLayerTest() {
               &EventLayerTest::pinchPressMoveRelease,
               &EventLayerTest::pinchFromUserInterface,
 
+              &EventLayerTest::longPressFromUserInterface,
+
               &EventLayerTest::enter,
               &EventLayerTest::enterMove,
               &EventLayerTest::leave,
@@ -309,7 +329,10 @@ EventLayerTest::EventLayerTest() {
 
               &EventLayerTest::remove,
               &EventLayerTest::removeScoped,
-              &EventLayerTest::cleanNodes});
+              &EventLayerTest::cleanNodes,
+
+              &EventLayerTest::sharedSlot,
+              &EventLayerTest::sharedSlotRemoveRecycle});
 }
 
 void EventLayerTest::eventConnectionConstruct() {
@@ -585,6 +608,37 @@ void EventLayerTest::invalidSlot() {
     CORRADE_COMPARE(out.str(), "Ui::EventLayer: slot is null\n");
 }
 
+void EventLayerTest::invalidSharedSlot() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    EventLayer layer{layerHandle(0, 1)};
+    layer.addSharedSlot([](UnsignedInt) {});
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    layer.addSharedSlot(nullptr);
+    layer.onTapOrClick(nodeHandle(0, 1), 1, 0);
+    CORRADE_COMPARE(out.str(),
+        "Ui::EventLayer::addSharedSlot(): slot is null\n"
+        "Ui::EventLayer: shared slot 1 out of range for 1 shared slots\n");
+}
+
+void EventLayerTest::invalidLongPressDuration() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    EventLayer layer{layerHandle(0, 1)};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    layer.onLongPress(nodeHandle(0, 1), 0.0_sec, []{});
+    layer.onLongPress(nodeHandle(0, 1), -1.0_sec, [](const Vector2&){});
+    layer.onLongPress(nodeHandle(0, 1), 7200.0_sec, []{});
+    CORRADE_COMPARE(out.str(),
+        "Ui::EventLayer::onLongPress(): expected a positive duration fitting into 32 bits in microseconds\n"
+        "Ui::EventLayer::onLongPress(): expected a positive duration fitting into 32 bits in microseconds\n"
+        "Ui::EventLayer::onLongPress(): expected a positive duration fitting into 32 bits in microseconds\n");
+}
+
 void EventLayerTest::connect() {
     auto&& data = ConnectData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -663,6 +717,51 @@ void EventLayerTest::connectScoped() {
     CORRADE_COMPARE(functorOutput, 2*3*5*7*5);
 }
 
+void EventLayerTest::compact() {
+    EventLayer layer{layerHandle(0x96, 0xef)};
+
+    Int called = 0;
+    DataHandle first = layer.onPress(nodeHandle(0, 1), [&called]{
+        called += 1;
+    });
+    DataHandle second = layer.onPress(nodeHandle(2, 3), [&called]{
+        called += 10;
+    });
+    layer.onPress(nodeHandle(4, 5), [&called]{
+        called += 100;
+    });
+    layer.remove(first);
+    layer.remove(second);
+
+    DataHandle mapping[3];
+    layer.compact(mapping);
+    CORRADE_COMPARE(mapping[2], dataHandle(layer.handle(), 0, 2));
+    CORRADE_COMPARE(layer.capacity(), 1);
+    CORRADE_COMPARE(layer.node(mapping[2]), nodeHandle(4, 5));
+
+    /* The slot is moved together with the data */
+    PointerEvent event{{}, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0};
+    layer.pointerPressEvent(0, event);
+    CORRADE_COMPARE(called, 100);
+}
+
+void EventLayerTest::compactScopedConnectionsActive() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    EventLayer layer{layerHandle(0x96, 0xef)};
+
+    layer.onPress(nodeHandle(0, 1), []{});
+    EventConnection connection = layer.onPressScoped(nodeHandle(2, 3), []{});
+
+    DataHandle mapping[2];
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    layer.compact(mapping);
+    CORRADE_COMPARE(out.str(),
+        "Ui::EventLayer::compact(): can't compact with 1 scoped connections active\n");
+}
+
 void EventLayerTest::press() {
     EventLayer layer{layerHandle(0, 1)};
 
@@ -2517,6 +2616,107 @@ void EventLayerTest::pinchFromUserInterface() {
     }
 }
 
+void EventLayerTest::longPressFromUserInterface() {
+    /* "Integration" test to verify onLongPress() behavior with the whole
+       event pipeline in AbstractUserInterface */
+
+    AbstractUserInterface ui{{100, 100}};
+
+    EventLayer& layer = ui.setLayerInstance(Containers::pointer<EventLayer>(ui.createLayer()));
+
+    NodeHandle node = ui.createNode({25, 50}, {50, 25});
+    NodeHandle another = ui.createNode({25, 0}, {50, 25});
+
+    Int called = 0, positionCalled = 0;
+    layer.onLongPress(another, 0.5_sec, [&called]{
+        ++called;
+    });
+    layer.onLongPress(node, 0.5_sec, [&positionCalled](const Vector2& position){
+        CORRADE_COMPARE(position, (Vector2{25.0f, 20.0f}));
+        ++positionCalled;
+    });
+
+    /* A press is accepted and captures the node, a move shortly after
+       doesn't fire the long press yet */
+    {
+        PointerEvent event{1.0_sec, PointerEventSource::Touch, Pointer::Finger, true, 0};
+        CORRADE_VERIFY(ui.pointerPressEvent({50, 70}, event));
+        CORRADE_COMPARE(ui.currentCapturedNode(), node);
+    } {
+        PointerMoveEvent event{1.2_sec, PointerEventSource::Touch, {}, Pointer::Finger, true, 0};
+        CORRADE_VERIFY(ui.pointerMoveEvent({52, 70}, event));
+        CORRADE_COMPARE(positionCalled, 0);
+
+    /* A move after the duration fires it, with the press position */
+    } {
+        PointerMoveEvent event{1.6_sec, PointerEventSource::Touch, {}, Pointer::Finger, true, 0};
+        CORRADE_VERIFY(ui.pointerMoveEvent({54, 70}, event));
+        CORRADE_COMPARE(positionCalled, 1);
+
+    /* But only once */
+    } {
+        PointerMoveEvent event{2.0_sec, PointerEventSource::Touch, {}, Pointer::Finger, true, 0};
+        CORRADE_VERIFY(ui.pointerMoveEvent({55, 70}, event));
+        CORRADE_COMPARE(positionCalled, 1);
+    } {
+        PointerEvent event{2.1_sec, PointerEventSource::Touch, Pointer::Finger, true, 0};
+        CORRADE_VERIFY(ui.pointerReleaseEvent({55, 70}, event));
+        CORRADE_COMPARE(positionCalled, 1);
+    }
+
+    /* Leaving the node area cancels the long press, even if the pointer gets
+       back */
+    {
+        PointerEvent event{3.0_sec, PointerEventSource::Touch, Pointer::Finger, true, 0};
+        CORRADE_VERIFY(ui.pointerPressEvent({50, 70}, event));
+    } {
+        PointerMoveEvent event{3.1_sec, PointerEventSource::Touch, {}, Pointer::Finger, true, 0};
+        CORRADE_VERIFY(ui.pointerMoveEvent({10, 10}, event));
+    } {
+        PointerMoveEvent event{4.0_sec, PointerEventSource::Touch, {}, Pointer::Finger, true, 0};
+        CORRADE_VERIFY(ui.pointerMoveEvent({50, 70}, event));
+    } {
+        PointerEvent event{4.0_sec, PointerEventSource::Touch, Pointer::Finger, true, 0};
+        CORRADE_VERIFY(ui.pointerReleaseEvent({50, 70}, event));
+        CORRADE_COMPARE(positionCalled, 1);
+    }
+
+    /* Without any move in between, it fires on a release that's late
+       enough ... */
+    {
+        PointerEvent event{5.0_sec, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0};
+        CORRADE_VERIFY(ui.pointerPressEvent({50, 70}, event));
+    } {
+        PointerEvent event{5.6_sec, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0};
+        CORRADE_VERIFY(ui.pointerReleaseEvent({50, 70}, event));
+        CORRADE_COMPARE(positionCalled, 2);
+    }
+
+    /* ... but not on a release that's too early */
+    {
+        PointerEvent event{6.0_sec, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0};
+        CORRADE_VERIFY(ui.pointerPressEvent({50, 70}, event));
+    } {
+        PointerEvent event{6.1_sec, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0};
+        CORRADE_VERIFY(ui.pointerReleaseEvent({50, 70}, event));
+        CORRADE_COMPARE(positionCalled, 2);
+    }
+
+    /* The other overload on another node, which isn't affected by any of the
+       above */
+    CORRADE_COMPARE(called, 0);
+    {
+        PointerEvent event{7.0_sec, PointerEventSource::Pen, Pointer::Pen, true, 0};
+        CORRADE_VERIFY(ui.pointerPressEvent({50, 10}, event));
+        CORRADE_COMPARE(ui.currentCapturedNode(), another);
+    } {
+        PointerMoveEvent event{7.5_sec, PointerEventSource::Pen, {}, Pointer::Pen, true, 0};
+        CORRADE_VERIFY(ui.pointerMoveEvent({51, 10}, event));
+        CORRADE_COMPARE(called, 1);
+        CORRADE_COMPARE(positionCalled, 2);
+    }
+}
+
 void EventLayerTest::enter() {
     EventLayer layer{layerHandle(0, 1)};
 
@@ -3175,6 +3375,100 @@ void EventLayerTest::cleanNodes() {
     CORRADE_VERIFY(layer.isHandleValid(anotherNonTrivial));
 }
 
+void EventLayerTest::sharedSlot() {
+    /* "Integration" test to verify shared slot behavior with the whole event
+       pipeline in AbstractUserInterface */
+
+    AbstractUserInterface ui{{100, 100}};
+
+    EventLayer& layer = ui.setLayerInstance(Containers::pointer<EventLayer>(ui.createLayer()));
+
+    Containers::Array<UnsignedInt> clicked;
+    Containers::Array<UnsignedInt> entered;
+    UnsignedInt clickSlot = layer.addSharedSlot([&clicked](UnsignedInt payload) {
+        arrayAppend(clicked, payload);
+    });
+    UnsignedInt enterSlot = layer.addSharedSlot([&entered](UnsignedInt payload) {
+        arrayAppend(entered, payload);
+    });
+    CORRADE_COMPARE(clickSlot, 0);
+    CORRADE_COMPARE(enterSlot, 1);
+    CORRADE_COMPARE(layer.sharedSlotCount(), 2);
+
+    /* A 4x4 grid of cells, each connected to the same two slots with its
+       index as a payload */
+    for(UnsignedInt i = 0; i != 16; ++i) {
+        NodeHandle node = ui.createNode({Float(i%4)*25.0f, Float(i/4)*25.0f}, {25.0f, 25.0f});
+        layer.onTapOrClick(node, clickSlot, i);
+        layer.onEnter(node, enterSlot, i*10);
+    }
+    CORRADE_COMPARE(layer.usedCount(), 32);
+    /* None of these allocate */
+    CORRADE_COMPARE(layer.usedAllocatedConnectionCount(), 0);
+
+    {
+        PointerEvent event{{}, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0};
+        CORRADE_VERIFY(ui.pointerPressEvent({60.0f, 35.0f}, event));
+    } {
+        PointerEvent event{{}, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0};
+        CORRADE_VERIFY(ui.pointerReleaseEvent({60.0f, 35.0f}, event));
+    }
+    CORRADE_COMPARE_AS(clicked, Containers::arrayView<UnsignedInt>({
+        6
+    }), TestSuite::Compare::Container);
+
+    {
+        PointerMoveEvent event{{}, PointerEventSource::Mouse, {}, {}, true, 0};
+        CORRADE_VERIFY(ui.pointerMoveEvent({10.0f, 90.0f}, event));
+    }
+    CORRADE_COMPARE_AS(entered, Containers::arrayView<UnsignedInt>({
+        120
+    }), TestSuite::Compare::Container);
+}
+
+void EventLayerTest::sharedSlotRemoveRecycle() {
+    EventLayer layer{layerHandle(0, 1)};
+
+    UnsignedInt sharedCalled = 0;
+    UnsignedInt lastPayload = 0;
+    UnsignedInt sharedSlot = layer.addSharedSlot([&](UnsignedInt payload) {
+        ++sharedCalled;
+        lastPayload = payload;
+    });
+
+    DataHandle shared = layer.onPress(nodeHandle(0, 1), sharedSlot, 1337);
+    layer.remove(shared);
+
+    /* A regular connection reusing the same slot calls the per-data slot and
+       not the shared one */
+    Int called = 0;
+    DataHandle regular = layer.onPress(nodeHandle(0, 1), [&called]{
+        ++called;
+    });
+    CORRADE_COMPARE(dataHandleId(regular), dataHandleId(shared));
+    {
+        PointerEvent event{{}, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0};
+        layer.pointerPressEvent(dataHandleId(regular), event);
+        CORRADE_VERIFY(event.isAccepted());
+    }
+    CORRADE_COMPARE(called, 1);
+    CORRADE_COMPARE(sharedCalled, 0);
+
+    /* And vice versa, a shared connection reusing a regular one */
+    layer.remove(regular);
+    DataHandle shared2 = layer.onPress(nodeHandle(0, 1), sharedSlot, 42);
+    CORRADE_COMPARE(dataHandleId(shared2), dataHandleId(regular));
+    CORRADE_COMPARE(layer.usedAllocatedConnectionCount(), 0);
+    {
+        PointerEvent event{{}, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0};
+        layer.pointerPressEvent(dataHandleId(shared2), event);
+        CORRADE_VERIFY(event.isAccepted());
+    }
+    CORRADE_COMPARE(called, 1);
+    CORRADE_COMPARE(sharedCalled, 1);
+    CORRADE_COMPARE(lastPayload, 42);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Ui::Test::EventLayerTest)
@@ -44,6 +44,7 @@ struct EventTest: TestSuite::Tester {
     void debugKey();
     void debugModifier();
     void debugModifiers();
+    void debugInputEventType();
 
     void pointer();
     void pointerInvalid();
@@ -59,6 +60,11 @@ struct EventTest: TestSuite::Tester {
     void textInput();
 
     void visibilityLost();
+
+    void inputPointer();
+    void inputPointerMove();
+    void inputKey();
+    void inputTextInput();
 };
 
 using namespace Containers::Literals;
@@ -71,6 +77,7 @@ EventTest::EventTest() {
               &EventTest::debugKey,
               &EventTest::debugModifier,
               &EventTest::debugModifiers,
+              &EventTest::debugInputEventType,
 
               &EventTest::pointer,
               &EventTest::pointerInvalid,
@@ -85,7 +92,12 @@ EventTest::EventTest() {
               &EventTest::key,
               &EventTest::textInput,
 
-              &EventTest::visibilityLost});
+              &EventTest::visibilityLost,
+
+              &EventTest::inputPointer,
+              &EventTest::inputPointerMove,
+              &EventTest::inputKey,
+              &EventTest::inputTextInput});
 }
 
 void EventTest::debugPointerEventSource() {
@@ -124,6 +136,12 @@ void EventTest::debugModifiers() {
     CORRADE_COMPARE(out.str(), "Ui::Modifier::Shift|Ui::Modifier::Ctrl|Ui::Modifier(0x80) Ui::Modifiers{}\n");
 }
 
+void EventTest::debugInputEventType() {
+    std::ostringstream out;
+    Debug{&out} << InputEventType::KeyRelease << InputEventType(0xde);
+    CORRADE_COMPARE(out.str(), "Ui::InputEventType::KeyRelease Ui::InputEventType(0xde)\n");
+}
+
 void EventTest::pointer() {
     PointerEvent event{1234567_nsec, PointerEventSource::Mouse, Pointer::MouseMiddle, true, 1ll << 36};
     CORRADE_COMPARE(event.time(), 1234567_nsec);
@@ -376,6 +394,77 @@ void EventTest::visibilityLost() {
     /* No accept status in this one */
 }
 
+void EventTest::inputPointer() {
+    InputEvent press = InputEvent::pointerPress(1234567_nsec, {3.0f, 4.0f}, PointerEventSource::Touch, Pointer::Finger, false, 1ll << 36);
+    CORRADE_COMPARE(press.type(), InputEventType::PointerPress);
+    CORRADE_COMPARE(press.time(), 1234567_nsec);
+    CORRADE_COMPARE(press.globalPosition(), (Vector2{3.0f, 4.0f}));
+    CORRADE_COMPARE(press.source(), PointerEventSource::Touch);
+    CORRADE_COMPARE(press.pointer(), Pointer::Finger);
+    CORRADE_COMPARE(press.pointers(), Pointers{});
+    CORRADE_VERIFY(!press.isPrimary());
+    CORRADE_COMPARE(press.id(), 1ll << 36);
+    CORRADE_COMPARE(press.key(), Key{});
+    CORRADE_COMPARE(press.modifiers(), Modifiers{});
+    CORRADE_COMPARE(press.text(), "");
+    CORRADE_VERIFY(!press.isAccepted());
+
+    InputEvent release = InputEvent::pointerRelease(1234567_nsec, {3.0f, 4.0f}, PointerEventSource::Mouse, Pointer::MouseRight, true, 0);
+    CORRADE_COMPARE(release.type(), InputEventType::PointerRelease);
+    CORRADE_COMPARE(release.time(), 1234567_nsec);
+    CORRADE_COMPARE(release.globalPosition(), (Vector2{3.0f, 4.0f}));
+    CORRADE_COMPARE(release.source(), PointerEventSource::Mouse);
+    CORRADE_COMPARE(release.pointer(), Pointer::MouseRight);
+    CORRADE_VERIFY(release.isPrimary());
+    CORRADE_COMPARE(release.id(), 0);
+    CORRADE_VERIFY(!release.isAccepted());
+}
+
+void EventTest::inputPointerMove() {
+    InputEvent move1 = InputEvent::pointerMove(1234567_nsec, {3.0f, 4.0f}, PointerEventSource::Pen, Pointer::Eraser, Pointer::Pen|Pointer::Eraser, true, 36);
+    CORRADE_COMPARE(move1.type(), InputEventType::PointerMove);
+    CORRADE_COMPARE(move1.time(), 1234567_nsec);
+    CORRADE_COMPARE(move1.globalPosition(), (Vector2{3.0f, 4.0f}));
+    CORRADE_COMPARE(move1.source(), PointerEventSource::Pen);
+    CORRADE_COMPARE(move1.pointer(), Pointer::Eraser);
+    CORRADE_COMPARE(move1.pointers(), Pointer::Pen|Pointer::Eraser);
+    CORRADE_VERIFY(move1.isPrimary());
+    CORRADE_COMPARE(move1.id(), 36);
+    CORRADE_VERIFY(!move1.isAccepted());
+
+    InputEvent move2 = InputEvent::pointerMove(1234567_nsec, {3.0f, 4.0f}, PointerEventSource::Mouse, {}, Pointer::MouseLeft, true, 0);
+    CORRADE_COMPARE(move2.pointer(), Containers::NullOpt);
+    CORRADE_COMPARE(move2.pointers(), Pointer::MouseLeft);
+}
+
+void EventTest::inputKey() {
+    InputEvent press = InputEvent::keyPress(1234567_nsec, Key::Delete, Modifier::Ctrl|Modifier::Alt);
+    CORRADE_COMPARE(press.type(), InputEventType::KeyPress);
+    CORRADE_COMPARE(press.time(), 1234567_nsec);
+    CORRADE_COMPARE(press.key(), Key::Delete);
+    CORRADE_COMPARE(press.modifiers(), Modifier::Ctrl|Modifier::Alt);
+    CORRADE_COMPARE(press.globalPosition(), Vector2{});
+    CORRADE_COMPARE(press.source(), PointerEventSource{});
+    CORRADE_COMPARE(press.pointer(), Containers::NullOpt);
+    CORRADE_VERIFY(!press.isAccepted());
+
+    InputEvent release = InputEvent::keyRelease(1234567_nsec, Key::Esc, {});
+    CORRADE_COMPARE(release.type(), InputEventType::KeyRelease);
+    CORRADE_COMPARE(release.key(), Key::Esc);
+    CORRADE_COMPARE(release.modifiers(), Modifiers{});
+}
+
+void EventTest::inputTextInput() {
+    /* The input string view isn't copied anywhere */
+    InputEvent event = InputEvent::textInput(1234567_nsec, "hello!"_s.exceptSuffix(1));
+    CORRADE_COMPARE(event.type(), InputEventType::TextInput);
+    CORRADE_COMPARE(event.time(), 1234567_nsec);
+    CORRADE_COMPARE(event.text(), "hello");
+    CORRADE_COMPARE(event.text().flags(), Containers::StringViewFlag::Global);
+    CORRADE_COMPARE(event.key(), Key{});
+    CORRADE_VERIFY(!event.isAccepted());
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Ui::Test::EventTest)
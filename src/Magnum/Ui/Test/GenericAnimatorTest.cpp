@@ -560,11 +560,11 @@ void GenericAnimatorTest::propertiesInvalid() {
     Error redirectError{&out};
     animator.easing(AnimationHandle::Null);
     /* Valid animator, invalid data */
-    animator.easing(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
+    animator.easing(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)));
     /* Invalid animator, valid data */
     animator.easing(animationHandle(AnimatorHandle::Null, animationHandleData(handle)));
     /* AnimatorDataHandle directly */
-    animator.easing(AnimatorDataHandle(0x123abcde));
+    animator.easing(animatorDataHandle(0xabcde, 0x123));
     CORRADE_COMPARE_AS(out.str(),
         "Ui::GenericAnimator::easing(): invalid handle Ui::AnimationHandle::Null\n"
         "Ui::GenericAnimator::easing(): invalid handle Ui::AnimationHandle({0x0, 0x1}, {0xabcde, 0x123})\n"
@@ -584,11 +584,11 @@ void GenericAnimatorTest::propertiesInvalidNode() {
     Error redirectError{&out};
     animator.easing(AnimationHandle::Null);
     /* Valid animator, invalid data */
-    animator.easing(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
+    animator.easing(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)));
     /* Invalid animator, valid data */
     animator.easing(animationHandle(AnimatorHandle::Null, animationHandleData(handle)));
     /* AnimatorDataHandle directly */
-    animator.easing(AnimatorDataHandle(0x123abcde));
+    animator.easing(animatorDataHandle(0xabcde, 0x123));
     CORRADE_COMPARE_AS(out.str(),
         "Ui::GenericNodeAnimator::easing(): invalid handle Ui::AnimationHandle::Null\n"
         "Ui::GenericNodeAnimator::easing(): invalid handle Ui::AnimationHandle({0x0, 0x1}, {0xabcde, 0x123})\n"
@@ -615,11 +615,11 @@ void GenericAnimatorTest::propertiesInvalidData() {
     Error redirectError{&out};
     animator.easing(AnimationHandle::Null);
     /* Valid animator, invalid data */
-    animator.easing(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
+    animator.easing(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)));
     /* Invalid animator, valid data */
     animator.easing(animationHandle(AnimatorHandle::Null, animationHandleData(handle)));
     /* AnimatorDataHandle directly */
-    animator.easing(AnimatorDataHandle(0x123abcde));
+    animator.easing(animatorDataHandle(0xabcde, 0x123));
     CORRADE_COMPARE_AS(out.str(),
         "Ui::GenericDataAnimator::easing(): invalid handle Ui::AnimationHandle::Null\n"
         "Ui::GenericDataAnimator::easing(): invalid handle Ui::AnimationHandle({0x0, 0x1}, {0xabcde, 0x123})\n"
@@ -161,6 +161,7 @@ void HandleTest::debugLayer() {
 void HandleTest::layerData() {
     CORRADE_COMPARE(LayerDataHandle::Null, LayerDataHandle{});
     CORRADE_COMPARE(layerDataHandle(0, 0), LayerDataHandle::Null);
+    #ifndef MAGNUM_UI_LARGE_HANDLES
     CORRADE_COMPARE(layerDataHandle(0xabcde, 0x123), LayerDataHandle(0x123abcde));
     CORRADE_COMPARE(layerDataHandle(0xfffff, 0xfff), LayerDataHandle(0xffffffff));
     CORRADE_COMPARE(layerDataHandleId(LayerDataHandle(0x123abcde)), 0xabcde);
@@ -171,6 +172,18 @@ void HandleTest::layerData() {
     constexpr UnsignedInt id = layerDataHandleId(handle);
     constexpr UnsignedInt generation = layerDataHandleGeneration(handle);
     CORRADE_COMPARE(handle, LayerDataHandle(0x123abcde));
+    #else
+    CORRADE_COMPARE(layerDataHandle(0xabcde, 0x123), LayerDataHandle(0x1230abcde));
+    CORRADE_COMPARE(layerDataHandle(0xffffff, 0x7fff), LayerDataHandle(0x7fffffffff));
+    CORRADE_COMPARE(layerDataHandleId(LayerDataHandle(0x1230abcde)), 0xabcde);
+    CORRADE_COMPARE(layerDataHandleGeneration(LayerDataHandle::Null), 0);
+    CORRADE_COMPARE(layerDataHandleGeneration(LayerDataHandle(0x1230abcde)), 0x123);
+
+    constexpr LayerDataHandle handle = layerDataHandle(0xabcde, 0x123);
+    constexpr UnsignedInt id = layerDataHandleId(handle);
+    constexpr UnsignedInt generation = layerDataHandleGeneration(handle);
+    CORRADE_COMPARE(handle, LayerDataHandle(0x1230abcde));
+    #endif
     CORRADE_COMPARE(id, 0xabcde);
     CORRADE_COMPARE(generation, 0x123);
 }
@@ -180,6 +193,7 @@ void HandleTest::layerDataInvalid() {
 
     std::ostringstream out;
     Error redirectError{&out};
+    #ifndef MAGNUM_UI_LARGE_HANDLES
     layerDataHandle(0x100000, 0x1);
     layerDataHandle(0x1, 0x1000);
     layerDataHandleId(LayerDataHandle::Null);
@@ -188,6 +202,16 @@ void HandleTest::layerDataInvalid() {
         "Ui::layerDataHandle(): expected index to fit into 20 bits and generation into 12, got 0x1 and 0x1000\n"
         "Ui::layerDataHandleId(): the handle is null\n",
         TestSuite::Compare::String);
+    #else
+    layerDataHandle(0x1000000, 0x1);
+    layerDataHandle(0x1, 0x8000);
+    layerDataHandleId(LayerDataHandle::Null);
+    CORRADE_COMPARE_AS(out.str(),
+        "Ui::layerDataHandle(): expected index to fit into 24 bits and generation into 15, got 0x1000000 and 0x1\n"
+        "Ui::layerDataHandle(): expected index to fit into 24 bits and generation into 15, got 0x1 and 0x8000\n"
+        "Ui::layerDataHandleId(): the handle is null\n",
+        TestSuite::Compare::String);
+    #endif
 }
 
 void HandleTest::debugLayerData() {
@@ -199,6 +223,7 @@ void HandleTest::debugLayerData() {
 void HandleTest::data() {
     CORRADE_COMPARE(DataHandle::Null, DataHandle{});
     CORRADE_COMPARE(dataHandle(LayerHandle::Null, 0, 0), DataHandle::Null);
+    #ifndef MAGNUM_UI_LARGE_HANDLES
     CORRADE_COMPARE(dataHandle(LayerHandle(0x12ab), 0x34567, 0xcde), DataHandle(0x12abcde34567));
     CORRADE_COMPARE(dataHandle(LayerHandle(0xffff), 0xfffff, 0xfff), DataHandle(0xffffffffffff));
     CORRADE_COMPARE(dataHandle(LayerHandle::Null, LayerDataHandle::Null), DataHandle::Null);
@@ -226,6 +251,35 @@ void HandleTest::data() {
     CORRADE_COMPARE(handle2, DataHandle(0x12abcde34567));
     CORRADE_COMPARE(layer, LayerHandle(0x12ab));
     CORRADE_COMPARE(data, LayerDataHandle(0xcde34567));
+    #else
+    CORRADE_COMPARE(dataHandle(LayerHandle(0x12ab), 0x34567, 0xcde), DataHandle(0x9558cde034567));
+    CORRADE_COMPARE(dataHandle(LayerHandle(0xffff), 0xffffff, 0x7fff), DataHandle(0x7fffffffffffff));
+    CORRADE_COMPARE(dataHandle(LayerHandle::Null, LayerDataHandle::Null), DataHandle::Null);
+    CORRADE_COMPARE(dataHandle(LayerHandle(0x12ab), LayerDataHandle(0xcde034567)), DataHandle(0x9558cde034567));
+    CORRADE_COMPARE(dataHandleLayer(DataHandle::Null), LayerHandle::Null);
+    CORRADE_COMPARE(dataHandleLayer(DataHandle(0x9558cde034567)), LayerHandle(0x12ab));
+    CORRADE_COMPARE(dataHandleData(DataHandle::Null), LayerDataHandle::Null);
+    CORRADE_COMPARE(dataHandleData(DataHandle(0x9558cde034567)), LayerDataHandle(0xcde034567));
+    CORRADE_COMPARE(dataHandleLayerId(DataHandle(0x9558cde034567)), 0xab);
+    CORRADE_COMPARE(dataHandleLayerGeneration(DataHandle::Null), 0);
+    CORRADE_COMPARE(dataHandleLayerGeneration(DataHandle(0x9558cde034567)), 0x12);
+    CORRADE_COMPARE(dataHandleId(DataHandle(0x9558cde034567)), 0x34567);
+    CORRADE_COMPARE(dataHandleGeneration(DataHandle::Null), 0);
+    CORRADE_COMPARE(dataHandleGeneration(DataHandle(0x9558cde034567)), 0xcde);
+
+    constexpr DataHandle handle1 = dataHandle(LayerHandle(0x12ab), 0x34567, 0xcde);
+    constexpr DataHandle handle2 = dataHandle(LayerHandle(0x12ab), LayerDataHandle(0xcde034567));
+    constexpr LayerHandle layer = dataHandleLayer(handle1);
+    constexpr LayerDataHandle data = dataHandleData(handle1);
+    constexpr UnsignedInt layerId = dataHandleLayerId(handle1);
+    constexpr UnsignedInt layerGeneration = dataHandleLayerGeneration(handle1);
+    constexpr UnsignedInt id = dataHandleId(handle1);
+    constexpr UnsignedInt generation = dataHandleGeneration(handle1);
+    CORRADE_COMPARE(handle1, DataHandle(0x9558cde034567));
+    CORRADE_COMPARE(handle2, DataHandle(0x9558cde034567));
+    CORRADE_COMPARE(layer, LayerHandle(0x12ab));
+    CORRADE_COMPARE(data, LayerDataHandle(0xcde034567));
+    #endif
     CORRADE_COMPARE(layerId, 0xab);
     CORRADE_COMPARE(layerGeneration, 0x12);
     CORRADE_COMPARE(id, 0x34567);
@@ -237,6 +291,7 @@ void HandleTest::dataInvalid() {
 
     std::ostringstream out;
     Error redirectError{&out};
+    #ifndef MAGNUM_UI_LARGE_HANDLES
     dataHandle(LayerHandle::Null, 0x100000, 0x1);
     dataHandle(LayerHandle::Null, 0x1, 0x1000);
     dataHandleLayerId(dataHandle(LayerHandle::Null, 0x1, 0x1));
@@ -251,6 +306,22 @@ void HandleTest::dataInvalid() {
         "Ui::dataHandleId(): the data portion of Ui::DataHandle({0x1, 0x1}, Null) is null\n"
         "Ui::dataHandleId(): the data portion of Ui::DataHandle::Null is null\n",
         TestSuite::Compare::String);
+    #else
+    dataHandle(LayerHandle::Null, 0x1000000, 0x1);
+    dataHandle(LayerHandle::Null, 0x1, 0x8000);
+    dataHandleLayerId(dataHandle(LayerHandle::Null, 0x1, 0x1));
+    dataHandleLayerId(DataHandle::Null);
+    dataHandleId(dataHandle(layerHandle(0x1, 0x1), LayerDataHandle::Null));
+    dataHandleId(DataHandle::Null);
+    CORRADE_COMPARE_AS(out.str(),
+        "Ui::dataHandle(): expected index to fit into 24 bits and generation into 15, got 0x1000000 and 0x1\n"
+        "Ui::dataHandle(): expected index to fit into 24 bits and generation into 15, got 0x1 and 0x8000\n"
+        "Ui::dataHandleLayerId(): the layer portion of Ui::DataHandle(Null, {0x1, 0x1}) is null\n"
+        "Ui::dataHandleLayerId(): the layer portion of Ui::DataHandle::Null is null\n"
+        "Ui::dataHandleId(): the data portion of Ui::DataHandle({0x1, 0x1}, Null) is null\n"
+        "Ui::dataHandleId(): the data portion of Ui::DataHandle::Null is null\n",
+        TestSuite::Compare::String);
+    #endif
 }
 
 void HandleTest::debugData() {
@@ -262,6 +333,7 @@ void HandleTest::debugData() {
 void HandleTest::node() {
     CORRADE_COMPARE(NodeHandle::Null, NodeHandle{});
     CORRADE_COMPARE(nodeHandle(0, 0), NodeHandle::Null);
+    #ifndef MAGNUM_UI_LARGE_HANDLES
     CORRADE_COMPARE(nodeHandle(0xabcde, 0x123), NodeHandle(0x123abcde));
     CORRADE_COMPARE(nodeHandle(0xfffff, 0xfff), NodeHandle(0xffffffff));
     CORRADE_COMPARE(nodeHandleId(NodeHandle(0x123abcde)), 0xabcde);
@@ -272,6 +344,18 @@ void HandleTest::node() {
     constexpr UnsignedInt id = nodeHandleId(handle);
     constexpr UnsignedInt generation = nodeHandleGeneration(handle);
     CORRADE_COMPARE(handle, NodeHandle(0x123abcde));
+    #else
+    CORRADE_COMPARE(nodeHandle(0xabcde, 0x123), NodeHandle(0x1230abcde));
+    CORRADE_COMPARE(nodeHandle(0xffffff, 0x7fff), NodeHandle(0x7fffffffff));
+    CORRADE_COMPARE(nodeHandleId(NodeHandle(0x1230abcde)), 0xabcde);
+    CORRADE_COMPARE(nodeHandleGeneration(NodeHandle::Null), 0);
+    CORRADE_COMPARE(nodeHandleGeneration(NodeHandle(0x1230abcde)), 0x123);
+
+    constexpr NodeHandle handle = nodeHandle(0xabcde, 0x123);
+    constexpr UnsignedInt id = nodeHandleId(handle);
+    constexpr UnsignedInt generation = nodeHandleGeneration(handle);
+    CORRADE_COMPARE(handle, NodeHandle(0x1230abcde));
+    #endif
     CORRADE_COMPARE(id, 0xabcde);
     CORRADE_COMPARE(generation, 0x123);
 }
@@ -281,6 +365,7 @@ void HandleTest::nodeInvalid() {
 
     std::ostringstream out;
     Error redirectError{&out};
+    #ifndef MAGNUM_UI_LARGE_HANDLES
     nodeHandle(0x100000, 0x1);
     nodeHandle(0x1, 0x1000);
     nodeHandleId(NodeHandle::Null);
@@ -289,6 +374,16 @@ void HandleTest::nodeInvalid() {
         "Ui::nodeHandle(): expected index to fit into 20 bits and generation into 12, got 0x1 and 0x1000\n"
         "Ui::nodeHandleId(): the handle is null\n",
         TestSuite::Compare::String);
+    #else
+    nodeHandle(0x1000000, 0x1);
+    nodeHandle(0x1, 0x8000);
+    nodeHandleId(NodeHandle::Null);
+    CORRADE_COMPARE_AS(out.str(),
+        "Ui::nodeHandle(): expected index to fit into 24 bits and generation into 15, got 0x1000000 and 0x1\n"
+        "Ui::nodeHandle(): expected index to fit into 24 bits and generation into 15, got 0x1 and 0x8000\n"
+        "Ui::nodeHandleId(): the handle is null\n",
+        TestSuite::Compare::String);
+    #endif
 }
 
 void HandleTest::debugNode() {
@@ -338,6 +433,7 @@ void HandleTest::debugLayouter() {
 void HandleTest::layouterData() {
     CORRADE_COMPARE(LayouterDataHandle::Null, LayouterDataHandle{});
     CORRADE_COMPARE(layouterDataHandle(0, 0), LayouterDataHandle::Null);
+    #ifndef MAGNUM_UI_LARGE_HANDLES
     CORRADE_COMPARE(layouterDataHandle(0xabcde, 0x123), LayouterDataHandle(0x123abcde));
     CORRADE_COMPARE(layouterDataHandle(0xfffff, 0xfff), LayouterDataHandle(0xffffffff));
     CORRADE_COMPARE(layouterDataHandleId(LayouterDataHandle(0x123abcde)), 0xabcde);
@@ -348,6 +444,18 @@ void HandleTest::layouterData() {
     constexpr UnsignedInt id = layouterDataHandleId(handle);
     constexpr UnsignedInt generation = layouterDataHandleGeneration(handle);
     CORRADE_COMPARE(handle, LayouterDataHandle(0x123abcde));
+    #else
+    CORRADE_COMPARE(layouterDataHandle(0xabcde, 0x123), LayouterDataHandle(0x1230abcde));
+    CORRADE_COMPARE(layouterDataHandle(0xffffff, 0x7fff), LayouterDataHandle(0x7fffffffff));
+    CORRADE_COMPARE(layouterDataHandleId(LayouterDataHandle(0x1230abcde)), 0xabcde);
+    CORRADE_COMPARE(layouterDataHandleGeneration(LayouterDataHandle::Null), 0);
+    CORRADE_COMPARE(layouterDataHandleGeneration(LayouterDataHandle(0x1230abcde)), 0x123);
+
+    constexpr LayouterDataHandle handle = layouterDataHandle(0xabcde, 0x123);
+    constexpr UnsignedInt id = layouterDataHandleId(handle);
+    constexpr UnsignedInt generation = layouterDataHandleGeneration(handle);
+    CORRADE_COMPARE(handle, LayouterDataHandle(0x1230abcde));
+    #endif
     CORRADE_COMPARE(id, 0xabcde);
     CORRADE_COMPARE(generation, 0x123);
 }
@@ -357,6 +465,7 @@ void HandleTest::layouterDataInvalid() {
 
     std::ostringstream out;
     Error redirectError{&out};
+    #ifndef MAGNUM_UI_LARGE_HANDLES
     layouterDataHandle(0x100000, 0x1);
     layouterDataHandle(0x1, 0x1000);
     layouterDataHandleId(LayouterDataHandle::Null);
@@ -365,6 +474,16 @@ void HandleTest::layouterDataInvalid() {
         "Ui::layouterDataHandle(): expected index to fit into 20 bits and generation into 12, got 0x1 and 0x1000\n"
         "Ui::layouterDataHandleId(): the handle is null\n",
         TestSuite::Compare::String);
+    #else
+    layouterDataHandle(0x1000000, 0x1);
+    layouterDataHandle(0x1, 0x8000);
+    layouterDataHandleId(LayouterDataHandle::Null);
+    CORRADE_COMPARE_AS(out.str(),
+        "Ui::layouterDataHandle(): expected index to fit into 24 bits and generation into 15, got 0x1000000 and 0x1\n"
+        "Ui::layouterDataHandle(): expected index to fit into 24 bits and generation into 15, got 0x1 and 0x8000\n"
+        "Ui::layouterDataHandleId(): the handle is null\n",
+        TestSuite::Compare::String);
+    #endif
 }
 
 void HandleTest::debugLayouterData() {
@@ -376,6 +495,7 @@ void HandleTest::debugLayouterData() {
 void HandleTest::layout() {
     CORRADE_COMPARE(LayoutHandle::Null, LayoutHandle{});
     CORRADE_COMPARE(layoutHandle(LayouterHandle::Null, 0, 0), LayoutHandle::Null);
+    #ifndef MAGNUM_UI_LARGE_HANDLES
     CORRADE_COMPARE(layoutHandle(LayouterHandle(0x12ab), 0x34567, 0xcde), LayoutHandle(0x12abcde34567));
     CORRADE_COMPARE(layoutHandle(LayouterHandle(0xffff), 0xfffff, 0xfff), LayoutHandle(0xffffffffffff));
     CORRADE_COMPARE(layoutHandle(LayouterHandle::Null, LayouterDataHandle::Null), LayoutHandle::Null);
@@ -403,6 +523,35 @@ void HandleTest::layout() {
     CORRADE_COMPARE(handle2, LayoutHandle(0x12abcde34567));
     CORRADE_COMPARE(layouter, LayouterHandle(0x12ab));
     CORRADE_COMPARE(data, LayouterDataHandle(0xcde34567));
+    #else
+    CORRADE_COMPARE(layoutHandle(LayouterHandle(0x12ab), 0x34567, 0xcde), LayoutHandle(0x9558cde034567));
+    CORRADE_COMPARE(layoutHandle(LayouterHandle(0xffff), 0xffffff, 0x7fff), LayoutHandle(0x7fffffffffffff));
+    CORRADE_COMPARE(layoutHandle(LayouterHandle::Null, LayouterDataHandle::Null), LayoutHandle::Null);
+    CORRADE_COMPARE(layoutHandle(LayouterHandle(0x12ab), LayouterDataHandle(0xcde034567)), LayoutHandle(0x9558cde034567));
+    CORRADE_COMPARE(layoutHandleLayouter(LayoutHandle::Null), LayouterHandle::Null);
+    CORRADE_COMPARE(layoutHandleLayouter(LayoutHandle(0x9558cde034567)), LayouterHandle(0x12ab));
+    CORRADE_COMPARE(layoutHandleData(LayoutHandle::Null), LayouterDataHandle::Null);
+    CORRADE_COMPARE(layoutHandleData(LayoutHandle(0x9558cde034567)), LayouterDataHandle(0xcde034567));
+    CORRADE_COMPARE(layoutHandleLayouterId(LayoutHandle(0x9558cde034567)), 0xab);
+    CORRADE_COMPARE(layoutHandleLayouterGeneration(LayoutHandle::Null), 0);
+    CORRADE_COMPARE(layoutHandleLayouterGeneration(LayoutHandle(0x9558cde034567)), 0x12);
+    CORRADE_COMPARE(layoutHandleId(LayoutHandle(0x9558cde034567)), 0x34567);
+    CORRADE_COMPARE(layoutHandleGeneration(LayoutHandle::Null), 0);
+    CORRADE_COMPARE(layoutHandleGeneration(LayoutHandle(0x9558cde034567)), 0xcde);
+
+    constexpr LayoutHandle handle1 = layoutHandle(LayouterHandle(0x12ab), 0x34567, 0xcde);
+    constexpr LayoutHandle handle2 = layoutHandle(LayouterHandle(0x12ab), LayouterDataHandle(0xcde034567));
+    constexpr LayouterHandle layouter = layoutHandleLayouter(handle1);
+    constexpr LayouterDataHandle data = layoutHandleData(handle1);
+    constexpr UnsignedInt layouterId = layoutHandleLayouterId(handle1);
+    constexpr UnsignedInt layouterGeneration = layoutHandleLayouterGeneration(handle1);
+    constexpr UnsignedInt id = layoutHandleId(handle1);
+    constexpr UnsignedInt generation = layoutHandleGeneration(handle1);
+    CORRADE_COMPARE(handle1, LayoutHandle(0x9558cde034567));
+    CORRADE_COMPARE(handle2, LayoutHandle(0x9558cde034567));
+    CORRADE_COMPARE(layouter, LayouterHandle(0x12ab));
+    CORRADE_COMPARE(data, LayouterDataHandle(0xcde034567));
+    #endif
     CORRADE_COMPARE(layouterId, 0xab);
     CORRADE_COMPARE(layouterGeneration, 0x12);
     CORRADE_COMPARE(id, 0x34567);
@@ -414,6 +563,7 @@ void HandleTest::layoutInvalid() {
 
     std::ostringstream out;
     Error redirectError{&out};
+    #ifndef MAGNUM_UI_LARGE_HANDLES
     layoutHandle(LayouterHandle::Null, 0x100000, 0x1);
     layoutHandle(LayouterHandle::Null, 0x1, 0x1000);
     layoutHandleLayouterId(layoutHandle(LayouterHandle::Null, 0x1, 0x1));
@@ -428,6 +578,22 @@ void HandleTest::layoutInvalid() {
         "Ui::layoutHandleId(): the data portion of Ui::LayoutHandle({0x1, 0x1}, Null) is null\n"
         "Ui::layoutHandleId(): the data portion of Ui::LayoutHandle::Null is null\n",
         TestSuite::Compare::String);
+    #else
+    layoutHandle(LayouterHandle::Null, 0x1000000, 0x1);
+    layoutHandle(LayouterHandle::Null, 0x1, 0x8000);
+    layoutHandleLayouterId(layoutHandle(LayouterHandle::Null, 0x1, 0x1));
+    layoutHandleLayouterId(LayoutHandle::Null);
+    layoutHandleId(layoutHandle(layouterHandle(0x1, 0x1), LayouterDataHandle::Null));
+    layoutHandleId(LayoutHandle::Null);
+    CORRADE_COMPARE_AS(out.str(),
+        "Ui::layoutHandle(): expected index to fit into 24 bits and generation into 15, got 0x1000000 and 0x1\n"
+        "Ui::layoutHandle(): expected index to fit into 24 bits and generation into 15, got 0x1 and 0x8000\n"
+        "Ui::layoutHandleLayouterId(): the layouter portion of Ui::LayoutHandle(Null, {0x1, 0x1}) is null\n"
+        "Ui::layoutHandleLayouterId(): the layouter portion of Ui::LayoutHandle::Null is null\n"
+        "Ui::layoutHandleId(): the data portion of Ui::LayoutHandle({0x1, 0x1}, Null) is null\n"
+        "Ui::layoutHandleId(): the data portion of Ui::LayoutHandle::Null is null\n",
+        TestSuite::Compare::String);
+    #endif
 }
 
 void HandleTest::debugLayout() {
@@ -477,6 +643,7 @@ void HandleTest::debugAnimator() {
 void HandleTest::animatorData() {
     CORRADE_COMPARE(AnimatorDataHandle::Null, AnimatorDataHandle{});
     CORRADE_COMPARE(animatorDataHandle(0, 0), AnimatorDataHandle::Null);
+    #ifndef MAGNUM_UI_LARGE_HANDLES
     CORRADE_COMPARE(animatorDataHandle(0xabcde, 0x123), AnimatorDataHandle(0x123abcde));
     CORRADE_COMPARE(animatorDataHandle(0xfffff, 0xfff), AnimatorDataHandle(0xffffffff));
     CORRADE_COMPARE(animatorDataHandleId(AnimatorDataHandle(0x123abcde)), 0xabcde);
@@ -487,6 +654,18 @@ void HandleTest::animatorData() {
     constexpr UnsignedInt id = animatorDataHandleId(handle);
     constexpr UnsignedInt generation = animatorDataHandleGeneration(handle);
     CORRADE_COMPARE(handle, AnimatorDataHandle(0x123abcde));
+    #else
+    CORRADE_COMPARE(animatorDataHandle(0xabcde, 0x123), AnimatorDataHandle(0x1230abcde));
+    CORRADE_COMPARE(animatorDataHandle(0xffffff, 0x7fff), AnimatorDataHandle(0x7fffffffff));
+    CORRADE_COMPARE(animatorDataHandleId(AnimatorDataHandle(0x1230abcde)), 0xabcde);
+    CORRADE_COMPARE(animatorDataHandleGeneration(AnimatorDataHandle::Null), 0);
+    CORRADE_COMPARE(animatorDataHandleGeneration(AnimatorDataHandle(0x1230abcde)), 0x123);
+
+    constexpr AnimatorDataHandle handle = animatorDataHandle(0xabcde, 0x123);
+    constexpr UnsignedInt id = animatorDataHandleId(handle);
+    constexpr UnsignedInt generation = animatorDataHandleGeneration(handle);
+    CORRADE_COMPARE(handle, AnimatorDataHandle(0x1230abcde));
+    #endif
     CORRADE_COMPARE(id, 0xabcde);
     CORRADE_COMPARE(generation, 0x123);
 }
@@ -496,6 +675,7 @@ void HandleTest::animatorDataInvalid() {
 
     std::ostringstream out;
     Error redirectError{&out};
+    #ifndef MAGNUM_UI_LARGE_HANDLES
     animatorDataHandle(0x100000, 0x1);
     animatorDataHandle(0x1, 0x1000);
     animatorDataHandleId(AnimatorDataHandle::Null);
@@ -504,6 +684,16 @@ void HandleTest::animatorDataInvalid() {
         "Ui::animatorDataHandle(): expected index to fit into 20 bits and generation into 12, got 0x1 and 0x1000\n"
         "Ui::animatorDataHandleId(): the handle is null\n",
         TestSuite::Compare::String);
+    #else
+    animatorDataHandle(0x1000000, 0x1);
+    animatorDataHandle(0x1, 0x8000);
+    animatorDataHandleId(AnimatorDataHandle::Null);
+    CORRADE_COMPARE_AS(out.str(),
+        "Ui::animatorDataHandle(): expected index to fit into 24 bits and generation into 15, got 0x1000000 and 0x1\n"
+        "Ui::animatorDataHandle(): expected index to fit into 24 bits and generation into 15, got 0x1 and 0x8000\n"
+        "Ui::animatorDataHandleId(): the handle is null\n",
+        TestSuite::Compare::String);
+    #endif
 }
 
 void HandleTest::debugAnimatorData() {
@@ -515,6 +705,7 @@ void HandleTest::debugAnimatorData() {
 void HandleTest::animation() {
     CORRADE_COMPARE(AnimationHandle::Null, AnimationHandle{});
     CORRADE_COMPARE(animationHandle(AnimatorHandle::Null, 0, 0), AnimationHandle::Null);
+    #ifndef MAGNUM_UI_LARGE_HANDLES
     CORRADE_COMPARE(animationHandle(AnimatorHandle(0x12ab), 0x34567, 0xcde), AnimationHandle(0x12abcde34567));
     CORRADE_COMPARE(animationHandle(AnimatorHandle(0xffff), 0xfffff, 0xfff), AnimationHandle(0xffffffffffff));
     CORRADE_COMPARE(animationHandle(AnimatorHandle::Null, AnimatorDataHandle::Null), AnimationHandle::Null);
@@ -542,6 +733,35 @@ void HandleTest::animation() {
     CORRADE_COMPARE(handle2, AnimationHandle(0x12abcde34567));
     CORRADE_COMPARE(animator, AnimatorHandle(0x12ab));
     CORRADE_COMPARE(data, AnimatorDataHandle(0xcde34567));
+    #else
+    CORRADE_COMPARE(animationHandle(AnimatorHandle(0x12ab), 0x34567, 0xcde), AnimationHandle(0x9558cde034567));
+    CORRADE_COMPARE(animationHandle(AnimatorHandle(0xffff), 0xffffff, 0x7fff), AnimationHandle(0x7fffffffffffff));
+    CORRADE_COMPARE(animationHandle(AnimatorHandle::Null, AnimatorDataHandle::Null), AnimationHandle::Null);
+    CORRADE_COMPARE(animationHandle(AnimatorHandle(0x12ab), AnimatorDataHandle(0xcde034567)), AnimationHandle(0x9558cde034567));
+    CORRADE_COMPARE(animationHandleAnimator(AnimationHandle::Null), AnimatorHandle::Null);
+    CORRADE_COMPARE(animationHandleAnimator(AnimationHandle(0x9558cde034567)), AnimatorHandle(0x12ab));
+    CORRADE_COMPARE(animationHandleData(AnimationHandle::Null), AnimatorDataHandle::Null);
+    CORRADE_COMPARE(animationHandleData(AnimationHandle(0x9558cde034567)), AnimatorDataHandle(0xcde034567));
+    CORRADE_COMPARE(animationHandleAnimatorId(AnimationHandle(0x9558cde034567)), 0xab);
+    CORRADE_COMPARE(animationHandleAnimatorGeneration(AnimationHandle::Null), 0);
+    CORRADE_COMPARE(animationHandleAnimatorGeneration(AnimationHandle(0x9558cde034567)), 0x12);
+    CORRADE_COMPARE(animationHandleId(AnimationHandle(0x9558cde034567)), 0x34567);
+    CORRADE_COMPARE(animationHandleGeneration(AnimationHandle::Null), 0);
+    CORRADE_COMPARE(animationHandleGeneration(AnimationHandle(0x9558cde034567)), 0xcde);
+
+    constexpr AnimationHandle handle1 = animationHandle(AnimatorHandle(0x12ab), 0x34567, 0xcde);
+    constexpr AnimationHandle handle2 = animationHandle(AnimatorHandle(0x12ab), AnimatorDataHandle(0xcde034567));
+    constexpr AnimatorHandle animator = animationHandleAnimator(handle1);
+    constexpr AnimatorDataHandle data = animationHandleData(handle1);
+    constexpr UnsignedInt animatorId = animationHandleAnimatorId(handle1);
+    constexpr UnsignedInt animatorGeneration = animationHandleAnimatorGeneration(handle1);
+    constexpr UnsignedInt id = animationHandleId(handle1);
+    constexpr UnsignedInt generation = animationHandleGeneration(handle1);
+    CORRADE_COMPARE(handle1, AnimationHandle(0x9558cde034567));
+    CORRADE_COMPARE(handle2, AnimationHandle(0x9558cde034567));
+    CORRADE_COMPARE(animator, AnimatorHandle(0x12ab));
+    CORRADE_COMPARE(data, AnimatorDataHandle(0xcde034567));
+    #endif
     CORRADE_COMPARE(animatorId, 0xab);
     CORRADE_COMPARE(animatorGeneration, 0x12);
     CORRADE_COMPARE(id, 0x34567);
@@ -553,6 +773,7 @@ void HandleTest::animationInvalid() {
 
     std::ostringstream out;
     Error redirectError{&out};
+    #ifndef MAGNUM_UI_LARGE_HANDLES
     animationHandle(AnimatorHandle::Null, 0x100000, 0x1);
     animationHandle(AnimatorHandle::Null, 0x1, 0x1000);
     animationHandleAnimatorId(animationHandle(AnimatorHandle::Null, 0x1, 0x1));
@@ -567,6 +788,22 @@ void HandleTest::animationInvalid() {
         "Ui::animationHandleId(): the data portion of Ui::AnimationHandle({0x1, 0x1}, Null) is null\n"
         "Ui::animationHandleId(): the data portion of Ui::AnimationHandle::Null is null\n",
         TestSuite::Compare::String);
+    #else
+    animationHandle(AnimatorHandle::Null, 0x1000000, 0x1);
+    animationHandle(AnimatorHandle::Null, 0x1, 0x8000);
+    animationHandleAnimatorId(animationHandle(AnimatorHandle::Null, 0x1, 0x1));
+    animationHandleAnimatorId(AnimationHandle::Null);
+    animationHandleId(animationHandle(animatorHandle(0x1, 0x1), AnimatorDataHandle::Null));
+    animationHandleId(AnimationHandle::Null);
+    CORRADE_COMPARE_AS(out.str(),
+        "Ui::animationHandle(): expected index to fit into 24 bits and generation into 15, got 0x1000000 and 0x1\n"
+        "Ui::animationHandle(): expected index to fit into 24 bits and generation into 15, got 0x1 and 0x8000\n"
+        "Ui::animationHandleAnimatorId(): the animator portion of Ui::AnimationHandle(Null, {0x1, 0x1}) is null\n"
+        "Ui::animationHandleAnimatorId(): the animator portion of Ui::AnimationHandle::Null is null\n"
+        "Ui::animationHandleId(): the data portion of Ui::AnimationHandle({0x1, 0x1}, Null) is null\n"
+        "Ui::animationHandleId(): the data portion of Ui::AnimationHandle::Null is null\n",
+        TestSuite::Compare::String);
+    #endif
 }
 
 void HandleTest::debugAnimation() {
@@ -25,6 +25,9 @@
 */
 
 #include <sstream> /** @todo remove once Debug is stream-free */
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/StringView.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
 
@@ -45,6 +48,8 @@ struct LabelTest: WidgetTester {
     void constructText();
     void constructTextTextProperties();
     void constructNoCreate();
+    void constructMultiple();
+    void constructMultipleInvalidSize();
 
     void setStyle();
 
@@ -60,6 +65,10 @@ struct LabelTest: WidgetTester {
     void setTextFromEmpty();
     void setTextEmpty();
     void setTextEmptyFromIcon();
+
+    void pool();
+    void poolNoCreate();
+    void poolInvalid();
 };
 
 const struct {
@@ -80,7 +89,9 @@ LabelTest::LabelTest() {
         &LabelTest::constructIcon,
         &LabelTest::constructText,
         &LabelTest::constructTextTextProperties,
-        &LabelTest::constructNoCreate
+        &LabelTest::constructNoCreate,
+        &LabelTest::constructMultiple,
+        &LabelTest::constructMultipleInvalidSize
     }, &WidgetTester::setup,
        &WidgetTester::teardown);
 
@@ -101,7 +112,11 @@ LabelTest::LabelTest() {
         &LabelTest::setTextFromIcon,
         &LabelTest::setTextFromEmpty,
         &LabelTest::setTextEmpty,
-        &LabelTest::setTextEmptyFromIcon
+        &LabelTest::setTextEmptyFromIcon,
+
+        &LabelTest::pool,
+        &LabelTest::poolNoCreate,
+        &LabelTest::poolInvalid
     }, &WidgetTester::setup,
        &WidgetTester::teardown);
 }
@@ -227,6 +242,84 @@ void LabelTest::constructNoCreate() {
     CORRADE_COMPARE(label.data(), DataHandle::Null);
 }
 
+void LabelTest::constructMultiple() {
+    using namespace Containers::Literals;
+
+    struct LabelData {
+        Vector2 offset, size;
+        Icon icon;
+        Containers::StringView text;
+        LabelStyle style;
+    } labelData[]{
+        {{0.0f, 0.0f}, {32.0f, 16.0f}, Icon::None, "hello!"_s, LabelStyle::Primary},
+        /* The text is ignored if there's an icon */
+        {{0.0f, 16.0f}, {24.0f, 16.0f}, Icon::Yes, "hi"_s, LabelStyle::Dim},
+        {{0.0f, 32.0f}, {16.0f, 16.0f}, Icon::No, ""_s, LabelStyle::Danger},
+        {{0.0f, 48.0f}, {8.0f, 16.0f}, Icon::None, ""_s, LabelStyle::Default},
+    };
+    Containers::StridedArrayView1D<const LabelData> labelDataView = labelData;
+
+    NodeHandle nodes[4];
+    labels(ui, rootNode,
+        labelDataView.slice(&LabelData::offset),
+        labelDataView.slice(&LabelData::size),
+        labelDataView.slice(&LabelData::icon),
+        labelDataView.slice(&LabelData::text),
+        labelDataView.slice(&LabelData::style),
+        nodes);
+    for(std::size_t i = 0; i != Containers::arraySize(labelData); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_VERIFY(ui.isHandleValid(nodes[i]));
+        CORRADE_COMPARE(ui.nodeParent(nodes[i]), rootNode);
+        CORRADE_COMPARE(ui.nodeOffset(nodes[i]), labelData[i].offset);
+        CORRADE_COMPARE(ui.nodeSize(nodes[i]), labelData[i].size);
+    }
+
+    /* Can only verify that the data were created, nothing else. Visually
+       tested in StyleGLTest. The last label is empty. */
+    CORRADE_COMPARE(ui.textLayer().usedCount(), 3);
+
+    /* An empty icon view creates just texts */
+    NodeHandle textNodes[2];
+    const Vector2 offsets[]{{}, {}};
+    const Vector2 sizes[]{{16.0f, 16.0f}, {16.0f, 16.0f}};
+    const Containers::StringView texts[]{"a"_s, "b"_s};
+    const LabelStyle styles[]{LabelStyle::Success, LabelStyle::Warning};
+    labels(ui, rootNode, offsets, sizes, nullptr, texts, styles, textNodes);
+    CORRADE_VERIFY(ui.isHandleValid(textNodes[0]));
+    CORRADE_VERIFY(ui.isHandleValid(textNodes[1]));
+    CORRADE_COMPARE(ui.textLayer().usedCount(), 5);
+}
+
+void LabelTest::constructMultipleInvalidSize() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    const Vector2 vectors[3]{};
+    const Vector2 vectorsInvalid[2]{};
+    const Icon icons[3]{};
+    const Icon iconsInvalid[2]{};
+    const Containers::StringView texts[3]{};
+    const Containers::StringView textsInvalid[4]{};
+    const LabelStyle styles[3]{};
+    const LabelStyle stylesInvalid[2]{};
+    NodeHandle nodes[3];
+    NodeHandle nodesInvalid[4];
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    labels(ui, rootNode, vectorsInvalid, vectors, icons, texts, styles, nodes);
+    labels(ui, rootNode, vectors, vectors, icons, texts, stylesInvalid, nodes);
+    labels(ui, rootNode, vectors, vectors, icons, texts, styles, nodesInvalid);
+    labels(ui, rootNode, vectors, vectors, iconsInvalid, texts, styles, nodes);
+    labels(ui, rootNode, vectors, vectors, icons, textsInvalid, styles, nodes);
+    CORRADE_COMPARE(out.str(),
+        "Ui::labels(): expected offset, size, style and node views to have the same size but got 2, 3, 3 and 3\n"
+        "Ui::labels(): expected offset, size, style and node views to have the same size but got 3, 3, 2 and 3\n"
+        "Ui::labels(): expected offset, size, style and node views to have the same size but got 3, 3, 3 and 4\n"
+        "Ui::labels(): expected icon and text views to be either empty or have a size of 3 but got 2 and 3\n"
+        "Ui::labels(): expected icon and text views to be either empty or have a size of 3 but got 3 and 4\n");
+}
+
 void LabelTest::setStyle() {
     auto&& data = SetStyleData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -385,6 +478,126 @@ void LabelTest::setTextEmptyFromIcon() {
     CORRADE_COMPARE(ui.textLayer().usedCount(), 0);
 }
 
+
+void LabelTest::pool() {
+    using namespace Containers::Literals;
+
+    const Vector2 offsets[]{{0.0f, 0.0f}, {0.0f, 16.0f}, {0.0f, 32.0f}};
+    const Vector2 sizes[]{{32.0f, 16.0f}, {24.0f, 16.0f}, {16.0f, 16.0f}};
+    const Containers::StringView texts[]{"hello!"_s, ""_s, "hi"_s};
+
+    Containers::Optional<LabelPool> pool{InPlaceInit, ui, rootNode, offsets, sizes, texts, LabelStyle::Dim};
+    CORRADE_COMPARE(&pool->ui(), &ui);
+    CORRADE_COMPARE(pool->size(), 3);
+    for(std::size_t i = 0; i != pool->size(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_VERIFY(ui.isHandleValid(pool->nodes()[i]));
+        CORRADE_COMPARE(ui.nodeParent(pool->nodes()[i]), rootNode);
+        CORRADE_COMPARE(ui.nodeOffset(pool->nodes()[i]), offsets[i]);
+        CORRADE_COMPARE(ui.nodeSize(pool->nodes()[i]), sizes[i]);
+        CORRADE_COMPARE(pool->styles()[i], LabelStyle::Dim);
+    }
+
+    /* The label with an empty text has no data */
+    CORRADE_VERIFY(ui.isHandleValid(pool->data(0)));
+    CORRADE_COMPARE(pool->data(1), DataHandle::Null);
+    CORRADE_VERIFY(ui.isHandleValid(pool->data(2)));
+    CORRADE_COMPARE(ui.textLayer().usedCount(), 2);
+
+    /* Changing a single style affects just that one */
+    UnsignedInt previousStyle = ui.textLayer().style(pool->data(0));
+    pool->setStyle(0, LabelStyle::Success);
+    CORRADE_COMPARE(pool->styles()[0], LabelStyle::Success);
+    CORRADE_COMPARE(pool->styles()[2], LabelStyle::Dim);
+    CORRADE_COMPARE_AS(ui.textLayer().style(pool->data(0)),
+        previousStyle,
+        TestSuite::Compare::NotEqual);
+    CORRADE_COMPARE(ui.textLayer().style(pool->data(2)), previousStyle);
+
+    /* Changing all styles at once */
+    pool->setStyles(LabelStyle::Danger);
+    CORRADE_COMPARE(pool->styles()[0], LabelStyle::Danger);
+    CORRADE_COMPARE(pool->styles()[1], LabelStyle::Danger);
+    CORRADE_COMPARE(pool->styles()[2], LabelStyle::Danger);
+    CORRADE_COMPARE(ui.textLayer().style(pool->data(0)), ui.textLayer().style(pool->data(2)));
+
+    const LabelStyle styles[]{LabelStyle::Info, LabelStyle::Warning, LabelStyle::Primary};
+    pool->setStyles(styles);
+    CORRADE_COMPARE(pool->styles()[0], LabelStyle::Info);
+    CORRADE_COMPARE(pool->styles()[1], LabelStyle::Warning);
+    CORRADE_COMPARE(pool->styles()[2], LabelStyle::Primary);
+    CORRADE_COMPARE_AS(ui.textLayer().style(pool->data(0)),
+        ui.textLayer().style(pool->data(2)),
+        TestSuite::Compare::NotEqual);
+
+    /* Setting a text to an empty label creates the data, setting an empty
+       text removes it */
+    pool->setText(1, "yes");
+    CORRADE_VERIFY(ui.isHandleValid(pool->data(1)));
+    pool->setText(0, "");
+    CORRADE_COMPARE(pool->data(0), DataHandle::Null);
+    CORRADE_COMPARE(ui.textLayer().usedCount(), 2);
+
+    /* Setting all texts at once */
+    const Containers::StringView newTexts[]{"a"_s, "b"_s, ""_s};
+    DataHandle data1 = pool->data(1);
+    pool->setTexts(newTexts);
+    CORRADE_VERIFY(ui.isHandleValid(pool->data(0)));
+    /* Existing data get reused */
+    CORRADE_COMPARE(pool->data(1), data1);
+    CORRADE_COMPARE(pool->data(2), DataHandle::Null);
+    CORRADE_COMPARE(ui.textLayer().usedCount(), 2);
+
+    /* Moving transfers the ownership */
+    NodeHandle node0 = pool->nodes()[0];
+    LabelPool moved = Utility::move(*pool);
+    CORRADE_COMPARE(pool->size(), 0);
+    CORRADE_COMPARE(moved.size(), 3);
+    CORRADE_COMPARE(moved.nodes()[0], node0);
+
+    /* Destructing the moved-out instance does nothing */
+    pool = Containers::NullOpt;
+    CORRADE_VERIFY(ui.isHandleValid(node0));
+}
+
+void LabelTest::poolNoCreate() {
+    LabelPool pool{NoCreate, ui};
+    CORRADE_COMPARE(&pool.ui(), &ui);
+    CORRADE_COMPARE(pool.size(), 0);
+    CORRADE_VERIFY(pool.nodes().isEmpty());
+    CORRADE_VERIFY(pool.styles().isEmpty());
+}
+
+void LabelTest::poolInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    const Vector2 vectors[2]{};
+    const Vector2 vectorsInvalid[3]{};
+    const Containers::StringView texts[2]{};
+    const Containers::StringView textsInvalid[3]{};
+    const LabelStyle stylesInvalid[3]{};
+
+    LabelPool pool{ui, rootNode, vectors, vectors, texts};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    LabelPool{ui, rootNode, vectors, vectorsInvalid, texts};
+    LabelPool{ui, rootNode, vectors, vectors, textsInvalid};
+    pool.setStyle(2, LabelStyle::Dim);
+    pool.setStyles(stylesInvalid);
+    pool.setText(2, "hey");
+    pool.setTexts(textsInvalid);
+    pool.data(2);
+    CORRADE_COMPARE(out.str(),
+        "Ui::LabelPool: expected offset, size and text views to have the same size but got 2, 3 and 2\n"
+        "Ui::LabelPool: expected offset, size and text views to have the same size but got 2, 2 and 3\n"
+        "Ui::LabelPool::setStyle(): index 2 out of range for 2 labels\n"
+        "Ui::LabelPool::setStyles(): expected 2 styles but got 3\n"
+        "Ui::LabelPool::setText(): index 2 out of range for 2 labels\n"
+        "Ui::LabelPool::setTexts(): expected 2 texts but got 3\n"
+        "Ui::LabelPool::data(): index 2 out of range for 2 labels\n");
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Ui::Test::LabelTest)
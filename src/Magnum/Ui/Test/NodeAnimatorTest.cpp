@@ -0,0 +1,256 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+#include <sstream> /** @todo remove once Debug is stream-free */
+#include <Corrade/Containers/BitArray.h>
+#include <Corrade/Containers/BitArrayView.h>
+#include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/StringStl.h> /** @todo remove once Debug is stream-free */
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+
+#include "Magnum/Animation/Easing.h"
+#include "Magnum/Math/Time.h"
+#include "Magnum/Math/Vector2.h"
+#include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/NodeAnimator.h"
+#include "Magnum/Ui/NodeFlags.h"
+
+namespace Magnum { namespace Ui { namespace Test { namespace {
+
+struct NodeAnimatorTest: TestSuite::Tester {
+    explicit NodeAnimatorTest();
+
+    void construct();
+    void constructSize();
+
+    void createRemove();
+    void createRemoveSize();
+    void createInvalid();
+    void propertiesInvalid();
+
+    void advance();
+    void advanceSize();
+    void advanceEmpty();
+};
+
+using namespace Math::Literals;
+
+NodeAnimatorTest::NodeAnimatorTest() {
+    addTests({&NodeAnimatorTest::construct,
+              &NodeAnimatorTest::constructSize,
+
+              &NodeAnimatorTest::createRemove,
+              &NodeAnimatorTest::createRemoveSize,
+              &NodeAnimatorTest::createInvalid,
+              &NodeAnimatorTest::propertiesInvalid,
+
+              &NodeAnimatorTest::advance,
+              &NodeAnimatorTest::advanceSize,
+              &NodeAnimatorTest::advanceEmpty});
+}
+
+void NodeAnimatorTest::construct() {
+    NodeOffsetAnimator animator{animatorHandle(0xab, 0x12)};
+    CORRADE_COMPARE(animator.features(), AnimatorFeature::NodeAttachment);
+    CORRADE_COMPARE(animator.handle(), animatorHandle(0xab, 0x12));
+}
+
+void NodeAnimatorTest::constructSize() {
+    NodeSizeAnimator animator{animatorHandle(0xab, 0x12)};
+    CORRADE_COMPARE(animator.features(), AnimatorFeature::NodeAttachment);
+    CORRADE_COMPARE(animator.handle(), animatorHandle(0xab, 0x12));
+}
+
+void NodeAnimatorTest::createRemove() {
+    NodeOffsetAnimator animator{animatorHandle(0, 1)};
+
+    AnimationHandle first = animator.create({1.0f, 2.0f}, {3.0f, 4.0f}, Animation::Easing::bounceOut, 137_nsec, 277_nsec, nodeHandle(0xabcde, 0x123), 3, AnimationFlag::KeepOncePlayed);
+    CORRADE_COMPARE(animator.duration(first), 277_nsec);
+    CORRADE_COMPARE(animator.played(first), 137_nsec);
+    CORRADE_COMPARE(animator.repeatCount(first), 3);
+    CORRADE_COMPARE(animator.flags(first), AnimationFlag::KeepOncePlayed);
+    CORRADE_COMPARE(animator.node(first), nodeHandle(0xabcde, 0x123));
+    CORRADE_COMPARE(animator.offsets(first), Containers::pair(Vector2{1.0f, 2.0f}, Vector2{3.0f, 4.0f}));
+    CORRADE_COMPARE(animator.offsets(animationHandleData(first)), Containers::pair(Vector2{1.0f, 2.0f}, Vector2{3.0f, 4.0f}));
+    CORRADE_COMPARE(animator.easing(first), Animation::Easing::bounceOut);
+    CORRADE_COMPARE(animator.easing(animationHandleData(first)), Animation::Easing::bounceOut);
+
+    AnimationHandle second = animator.create({}, {5.0f, 6.0f}, Animation::Easing::smootherstep, 226_nsec, 191_nsec, NodeHandle::Null);
+    CORRADE_COMPARE(animator.node(second), NodeHandle::Null);
+    CORRADE_COMPARE(animator.offsets(second), Containers::pair(Vector2{}, Vector2{5.0f, 6.0f}));
+    CORRADE_COMPARE(animator.easing(second), Animation::Easing::smootherstep);
+    CORRADE_COMPARE(animator.usedCount(), 2);
+
+    animator.remove(first);
+    CORRADE_COMPARE(animator.usedCount(), 1);
+
+    animator.remove(animationHandleData(second));
+    CORRADE_COMPARE(animator.usedCount(), 0);
+}
+
+void NodeAnimatorTest::createRemoveSize() {
+    NodeSizeAnimator animator{animatorHandle(0, 1)};
+    animator.reserve(2);
+
+    AnimationHandle first = animator.create({1.0f, 2.0f}, {3.0f, 4.0f}, Animation::Easing::bounceOut, 137_nsec, 277_nsec, nodeHandle(0xabcde, 0x123), 3, AnimationFlag::KeepOncePlayed);
+    CORRADE_COMPARE(animator.duration(first), 277_nsec);
+    CORRADE_COMPARE(animator.node(first), nodeHandle(0xabcde, 0x123));
+    CORRADE_COMPARE(animator.sizes(first), Containers::pair(Vector2{1.0f, 2.0f}, Vector2{3.0f, 4.0f}));
+    CORRADE_COMPARE(animator.sizes(animationHandleData(first)), Containers::pair(Vector2{1.0f, 2.0f}, Vector2{3.0f, 4.0f}));
+    CORRADE_COMPARE(animator.easing(first), Animation::Easing::bounceOut);
+    CORRADE_COMPARE(animator.easing(animationHandleData(first)), Animation::Easing::bounceOut);
+
+    /* The slot is recycled with the new values */
+    animator.remove(first);
+    AnimationHandle first2 = animator.create({}, {5.0f, 6.0f}, Animation::Easing::step, 0_nsec, 1_nsec, NodeHandle::Null);
+    CORRADE_COMPARE(animationHandleId(first2), animationHandleId(first));
+    CORRADE_COMPARE(animator.sizes(first2), Containers::pair(Vector2{}, Vector2{5.0f, 6.0f}));
+    CORRADE_COMPARE(animator.easing(first2), Animation::Easing::step);
+}
+
+void NodeAnimatorTest::createInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    NodeOffsetAnimator animator{animatorHandle(0, 1)};
+    NodeSizeAnimator sizeAnimator{animatorHandle(0, 1)};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    animator.create({}, {}, nullptr, 0_nsec, 1_nsec, NodeHandle::Null);
+    sizeAnimator.create({}, {}, nullptr, 0_nsec, 1_nsec, NodeHandle::Null);
+    CORRADE_COMPARE(out.str(),
+        "Ui::NodeOffsetAnimator::create(): easing is null\n"
+        "Ui::NodeSizeAnimator::create(): easing is null\n");
+}
+
+void NodeAnimatorTest::propertiesInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    NodeOffsetAnimator animator{animatorHandle(0, 1)};
+    NodeSizeAnimator sizeAnimator{animatorHandle(0, 1)};
+
+    AnimationHandle handle = animator.create({}, {}, Animation::Easing::linear, 0_nsec, 1_nsec, NodeHandle::Null);
+    animator.remove(handle);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    animator.offsets(AnimationHandle::Null);
+    animator.offsets(handle);
+    animator.offsets(animatorDataHandle(0xabcde, 0x123));
+    animator.easing(AnimationHandle::Null);
+    animator.easing(animatorDataHandle(0xabcde, 0x123));
+    sizeAnimator.sizes(AnimationHandle::Null);
+    sizeAnimator.sizes(animatorDataHandle(0xabcde, 0x123));
+    sizeAnimator.easing(AnimationHandle::Null);
+    sizeAnimator.easing(animatorDataHandle(0xabcde, 0x123));
+    CORRADE_COMPARE(out.str(),
+        "Ui::NodeOffsetAnimator::offsets(): invalid handle Ui::AnimationHandle::Null\n"
+        "Ui::NodeOffsetAnimator::offsets(): invalid handle Ui::AnimationHandle({0x0, 0x1}, {0x0, 0x1})\n"
+        "Ui::NodeOffsetAnimator::offsets(): invalid handle Ui::AnimatorDataHandle(0xabcde, 0x123)\n"
+        "Ui::NodeOffsetAnimator::easing(): invalid handle Ui::AnimationHandle::Null\n"
+        "Ui::NodeOffsetAnimator::easing(): invalid handle Ui::AnimatorDataHandle(0xabcde, 0x123)\n"
+        "Ui::NodeSizeAnimator::sizes(): invalid handle Ui::AnimationHandle::Null\n"
+        "Ui::NodeSizeAnimator::sizes(): invalid handle Ui::AnimatorDataHandle(0xabcde, 0x123)\n"
+        "Ui::NodeSizeAnimator::easing(): invalid handle Ui::AnimationHandle::Null\n"
+        "Ui::NodeSizeAnimator::easing(): invalid handle Ui::AnimatorDataHandle(0xabcde, 0x123)\n");
+}
+
+void NodeAnimatorTest::advance() {
+    NodeOffsetAnimator animator{animatorHandle(0, 1)};
+
+    /* Node 2 gets animated, the animation with a null node does nothing, the
+       inactive one isn't touched */
+    animator.create({10.0f, 20.0f}, {30.0f, 40.0f}, Animation::Easing::linear, 0_nsec, 10_nsec, nodeHandle(2, 1));
+    animator.create({}, {100.0f, 100.0f}, Animation::Easing::linear, 0_nsec, 10_nsec, NodeHandle::Null);
+    animator.create({}, {100.0f, 100.0f}, Animation::Easing::linear, 0_nsec, 10_nsec, nodeHandle(0, 1));
+    /* Easing gets applied to the factor */
+    animator.create({0.0f, 0.0f}, {8.0f, 16.0f}, Animation::Easing::quadraticIn, 0_nsec, 10_nsec, nodeHandle(1, 1));
+
+    const UnsignedByte activeData[]{0x0b};
+    const Float factors[]{0.25f, 0.5f, 1.0f, 0.5f};
+    Vector2 nodeOffsets[3]{{-1.0f, -1.0f}, {-1.0f, -1.0f}, {-1.0f, -1.0f}};
+    Vector2 nodeSizes[3]{{-1.0f, -1.0f}, {-1.0f, -1.0f}, {-1.0f, -1.0f}};
+    NodeFlags nodeFlags[3];
+    Containers::BitArray nodesRemove{ValueInit, 3};
+    CORRADE_COMPARE(animator.advance(Containers::BitArrayView{activeData, 0, 4}, factors, nodeOffsets, nodeSizes, nodeFlags, nodesRemove), NodeAnimation::OffsetSize);
+    CORRADE_COMPARE_AS(Containers::arrayView(nodeOffsets), Containers::arrayView<Vector2>({
+        {-1.0f, -1.0f},
+        {2.0f, 4.0f},
+        {15.0f, 25.0f},
+    }), TestSuite::Compare::Container);
+    /* Sizes are left untouched */
+    CORRADE_COMPARE_AS(Containers::arrayView(nodeSizes), Containers::arrayView<Vector2>({
+        {-1.0f, -1.0f},
+        {-1.0f, -1.0f},
+        {-1.0f, -1.0f},
+    }), TestSuite::Compare::Container);
+}
+
+void NodeAnimatorTest::advanceSize() {
+    NodeSizeAnimator animator{animatorHandle(0, 1)};
+
+    animator.create({10.0f, 20.0f}, {30.0f, 40.0f}, Animation::Easing::linear, 0_nsec, 10_nsec, nodeHandle(1, 1));
+
+    const UnsignedByte activeData[]{0x01};
+    const Float factors[]{0.75f};
+    Vector2 nodeOffsets[2]{{-1.0f, -1.0f}, {-1.0f, -1.0f}};
+    Vector2 nodeSizes[2]{{-1.0f, -1.0f}, {-1.0f, -1.0f}};
+    NodeFlags nodeFlags[2];
+    Containers::BitArray nodesRemove{ValueInit, 2};
+    CORRADE_COMPARE(animator.advance(Containers::BitArrayView{activeData, 0, 1}, factors, nodeOffsets, nodeSizes, nodeFlags, nodesRemove), NodeAnimation::OffsetSize);
+    CORRADE_COMPARE_AS(Containers::arrayView(nodeSizes), Containers::arrayView<Vector2>({
+        {-1.0f, -1.0f},
+        {25.0f, 35.0f},
+    }), TestSuite::Compare::Container);
+    /* Offsets are left untouched */
+    CORRADE_COMPARE_AS(Containers::arrayView(nodeOffsets), Containers::arrayView<Vector2>({
+        {-1.0f, -1.0f},
+        {-1.0f, -1.0f},
+    }), TestSuite::Compare::Container);
+}
+
+void NodeAnimatorTest::advanceEmpty() {
+    NodeOffsetAnimator animator{animatorHandle(0, 1)};
+
+    /* Only an animation with a null node is active, so nothing gets
+       reported as animated */
+    animator.create({}, {100.0f, 100.0f}, Animation::Easing::linear, 0_nsec, 10_nsec, NodeHandle::Null);
+
+    const UnsignedByte activeData[]{0x01};
+    const Float factors[]{0.5f};
+    Vector2 nodeOffsets[1]{{-1.0f, -1.0f}};
+    Vector2 nodeSizes[1];
+    NodeFlags nodeFlags[1];
+    Containers::BitArray nodesRemove{ValueInit, 1};
+    CORRADE_COMPARE(animator.advance(Containers::BitArrayView{activeData, 0, 1}, factors, nodeOffsets, nodeSizes, nodeFlags, nodesRemove), NodeAnimations{});
+    CORRADE_COMPARE(nodeOffsets[0], (Vector2{-1.0f, -1.0f}));
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Ui::Test::NodeAnimatorTest)
@@ -0,0 +1,351 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <sstream>
+#include <type_traits>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+#include <Magnum/Math/Color.h>
+
+#include "Magnum/Ui/AbstractUserInterface.h"
+#include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/NodeFlags.h"
+#include "Magnum/Ui/PerformanceOverlayLayer.h"
+#include "Magnum/Ui/Implementation/performanceOverlayLayerState.h"
+
+namespace Magnum { namespace Ui { namespace Test { namespace {
+
+struct PerformanceOverlayLayerTest: TestSuite::Tester {
+    explicit PerformanceOverlayLayerTest();
+
+    void debugMode();
+
+    void construct();
+    void constructCopy();
+    void constructMove();
+
+    void setMode();
+    void setColor();
+
+    void updateDataUpdates();
+    void updateLayoutUpdates();
+    void updateOverdraw();
+    void updateNoStatistics();
+};
+
+PerformanceOverlayLayerTest::PerformanceOverlayLayerTest() {
+    addTests({&PerformanceOverlayLayerTest::debugMode,
+
+              &PerformanceOverlayLayerTest::construct,
+              &PerformanceOverlayLayerTest::constructCopy,
+              &PerformanceOverlayLayerTest::constructMove,
+
+              &PerformanceOverlayLayerTest::setMode,
+              &PerformanceOverlayLayerTest::setColor,
+
+              &PerformanceOverlayLayerTest::updateDataUpdates,
+              &PerformanceOverlayLayerTest::updateLayoutUpdates,
+              &PerformanceOverlayLayerTest::updateOverdraw,
+              &PerformanceOverlayLayerTest::updateNoStatistics});
+}
+
+struct OverlayLayer: PerformanceOverlayLayer {
+    explicit OverlayLayer(LayerHandle handle, AbstractUserInterface& ui, UnsignedInt frameCount): PerformanceOverlayLayer{handle, ui, frameCount} {}
+
+    Containers::StridedArrayView1D<const Vector2> positions() const {
+        return stridedArrayView(_state->vertices).slice(&Implementation::PerformanceOverlayLayerVertex::position);
+    }
+    Containers::StridedArrayView1D<const Color4> colors() const {
+        return stridedArrayView(_state->vertices).slice(&Implementation::PerformanceOverlayLayerVertex::color);
+    }
+    Containers::ArrayView<const UnsignedInt> indices() const {
+        return _state->indices;
+    }
+};
+
+struct DataLayer: AbstractLayer {
+    explicit DataLayer(LayerHandle handle, LayerFeatures features = LayerFeature::Draw): AbstractLayer{handle}, features{features} {}
+
+    using AbstractLayer::create;
+    using AbstractLayer::setNeedsDataUpdate;
+
+    LayerFeatures doFeatures() const override { return features; }
+
+    LayerFeatures features;
+};
+
+void PerformanceOverlayLayerTest::debugMode() {
+    std::ostringstream out;
+    Debug{&out} << PerformanceOverlayMode::LayoutUpdates << PerformanceOverlayMode(0xbe);
+    CORRADE_COMPARE(out.str(), "Ui::PerformanceOverlayMode::LayoutUpdates Ui::PerformanceOverlayMode(0xbe)\n");
+}
+
+void PerformanceOverlayLayerTest::construct() {
+    AbstractUserInterface ui{{100, 100}};
+    CORRADE_COMPARE(ui.nodeUpdateStatisticsFrameCount(), 0);
+
+    OverlayLayer layer{layerHandle(137, 0xfe), ui, 17};
+    CORRADE_COMPARE(layer.handle(), layerHandle(137, 0xfe));
+    CORRADE_COMPARE(layer.features(), LayerFeature::Draw);
+    CORRADE_COMPARE(layer.mode(), PerformanceOverlayMode::DataUpdates);
+    CORRADE_COMPARE(layer.color(), (Color4{0.8f, 0.16f, 0.16f, 0.8f}));
+
+    /* Node update statistics get enabled in the user interface */
+    CORRADE_COMPARE(ui.nodeUpdateStatisticsFrameCount(), 17);
+
+    /* The layer needs an update to catch up with the statistics, even though
+       none were recorded yet */
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+}
+
+void PerformanceOverlayLayerTest::constructCopy() {
+    CORRADE_VERIFY(!std::is_copy_constructible<PerformanceOverlayLayer>{});
+    CORRADE_VERIFY(!std::is_copy_assignable<PerformanceOverlayLayer>{});
+}
+
+void PerformanceOverlayLayerTest::constructMove() {
+    AbstractUserInterface ui{{100, 100}};
+
+    OverlayLayer a{layerHandle(137, 0xfe), ui, 17};
+    a.setMode(PerformanceOverlayMode::Overdraw);
+
+    OverlayLayer b{Utility::move(a)};
+    CORRADE_COMPARE(b.handle(), layerHandle(137, 0xfe));
+    CORRADE_COMPARE(b.mode(), PerformanceOverlayMode::Overdraw);
+
+    OverlayLayer c{layerHandle(0, 2), ui, 17};
+    c = Utility::move(b);
+    CORRADE_COMPARE(c.handle(), layerHandle(137, 0xfe));
+    CORRADE_COMPARE(c.mode(), PerformanceOverlayMode::Overdraw);
+
+    CORRADE_VERIFY(std::is_nothrow_move_constructible<PerformanceOverlayLayer>::value);
+    CORRADE_VERIFY(std::is_nothrow_move_assignable<PerformanceOverlayLayer>::value);
+}
+
+void PerformanceOverlayLayerTest::setMode() {
+    AbstractUserInterface ui{{100, 100}};
+
+    OverlayLayer& layer = ui.setLayerInstance(Containers::pointer<OverlayLayer>(ui.createLayer(), ui, 4));
+    ui.update();
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    layer.setMode(PerformanceOverlayMode::Overdraw);
+    CORRADE_COMPARE(layer.mode(), PerformanceOverlayMode::Overdraw);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+}
+
+void PerformanceOverlayLayerTest::setColor() {
+    AbstractUserInterface ui{{100, 100}};
+
+    OverlayLayer& layer = ui.setLayerInstance(Containers::pointer<OverlayLayer>(ui.createLayer(), ui, 4));
+    ui.update();
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    layer.setColor({0.0f, 0.5f, 1.0f, 1.0f});
+    CORRADE_COMPARE(layer.color(), (Color4{0.0f, 0.5f, 1.0f, 1.0f}));
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+}
+
+void PerformanceOverlayLayerTest::updateDataUpdates() {
+    AbstractUserInterface ui{{100, 100}};
+
+    OverlayLayer& overlay = ui.setLayerInstance(Containers::pointer<OverlayLayer>(ui.createLayer(), ui, 4));
+    DataLayer& layer = ui.setLayerInstance(Containers::pointer<DataLayer>(ui.createLayer()));
+
+    NodeHandle node1 = ui.createNode({10.0f, 10.0f}, {10.0f, 10.0f});
+    NodeHandle node2 = ui.createNode({30.0f, 10.0f}, {20.0f, 10.0f});
+    /* Outside of the UI area, thus not drawn even though it has updates */
+    NodeHandle culled = ui.createNode({200.0f, 10.0f}, {10.0f, 10.0f});
+    /* The overlay node is excluded from the heatmap */
+    NodeHandle overlayNode = ui.createNode({}, {100.0f, 100.0f});
+    overlay.create(overlayNode);
+    DataHandle data1 = layer.create(node1);
+    layer.create(node2);
+    layer.create(culled);
+
+    /* All data were just created, so they're all updated in the first
+       frame */
+    ui.update();
+    CORRADE_COMPARE(ui.nodeUpdateStatisticsFrame(), 1);
+    CORRADE_COMPARE(overlay.state(), LayerStates{});
+    CORRADE_COMPARE_AS(overlay.positions(), Containers::arrayView<Vector2>({
+        {10.0f, 10.0f}, {20.0f, 10.0f}, {10.0f, 20.0f}, {20.0f, 20.0f},
+        {30.0f, 10.0f}, {50.0f, 10.0f}, {30.0f, 20.0f}, {50.0f, 20.0f},
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(overlay.colors(), Containers::arrayView<Color4>({
+        {0.2f, 0.04f, 0.04f, 0.2f}, {0.2f, 0.04f, 0.04f, 0.2f},
+        {0.2f, 0.04f, 0.04f, 0.2f}, {0.2f, 0.04f, 0.04f, 0.2f},
+        {0.2f, 0.04f, 0.04f, 0.2f}, {0.2f, 0.04f, 0.04f, 0.2f},
+        {0.2f, 0.04f, 0.04f, 0.2f}, {0.2f, 0.04f, 0.04f, 0.2f},
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(overlay.indices(), Containers::arrayView<UnsignedInt>({
+        0, 2, 1, 2, 3, 1,
+        4, 6, 5, 6, 7, 5
+    }), TestSuite::Compare::Container);
+
+    /* Until a new frame is recorded, the overlay doesn't need an update */
+    layer.setNeedsDataUpdate(dataHandleId(data1));
+    CORRADE_COMPARE(overlay.state(), LayerStates{});
+
+    /* Data of the first node updated in two frames out of four, the second
+       node in one */
+    ui.update();
+    CORRADE_COMPARE(ui.nodeUpdateStatisticsFrame(), 2);
+    CORRADE_COMPARE(overlay.state(), LayerStates{});
+    CORRADE_COMPARE_AS(overlay.colors(), Containers::arrayView<Color4>({
+        {0.4f, 0.08f, 0.08f, 0.4f}, {0.4f, 0.08f, 0.08f, 0.4f},
+        {0.4f, 0.08f, 0.08f, 0.4f}, {0.4f, 0.08f, 0.08f, 0.4f},
+        {0.2f, 0.04f, 0.04f, 0.2f}, {0.2f, 0.04f, 0.04f, 0.2f},
+        {0.2f, 0.04f, 0.04f, 0.2f}, {0.2f, 0.04f, 0.04f, 0.2f},
+    }), TestSuite::Compare::Container);
+
+    /* Hiding the overlay node makes it not draw anything */
+    ui.addNodeFlags(overlayNode, NodeFlag::Hidden);
+    ui.update();
+    CORRADE_COMPARE(overlay.positions().size(), 0);
+    CORRADE_COMPARE(overlay.indices().size(), 0);
+}
+
+void PerformanceOverlayLayerTest::updateLayoutUpdates() {
+    AbstractUserInterface ui{{100, 100}};
+
+    OverlayLayer& overlay = ui.setLayerInstance(Containers::pointer<OverlayLayer>(ui.createLayer(), ui, 2));
+    DataLayer& layer = ui.setLayerInstance(Containers::pointer<DataLayer>(ui.createLayer()));
+
+    NodeHandle node1 = ui.createNode({10.0f, 10.0f}, {10.0f, 10.0f});
+    NodeHandle node2 = ui.createNode({30.0f, 10.0f}, {20.0f, 10.0f});
+    NodeHandle overlayNode = ui.createNode({}, {100.0f, 100.0f});
+    overlay.create(overlayNode);
+    layer.create(node1);
+    layer.create(node2);
+
+    overlay.setMode(PerformanceOverlayMode::LayoutUpdates)
+        .setColor({0.0f, 1.0f, 0.0f, 1.0f});
+
+    /* No layout changes yet, so nothing is drawn */
+    ui.update();
+    CORRADE_COMPARE(overlay.positions().size(), 0);
+
+    /* The second node resized in one frame out of two */
+    ui.setNodeSize(node2, {20.0f, 20.0f});
+    ui.update();
+    CORRADE_COMPARE_AS(overlay.positions(), Containers::arrayView<Vector2>({
+        {30.0f, 10.0f}, {50.0f, 10.0f}, {30.0f, 30.0f}, {50.0f, 30.0f},
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(overlay.colors(), Containers::arrayView<Color4>({
+        {0.0f, 0.5f, 0.0f, 0.5f}, {0.0f, 0.5f, 0.0f, 0.5f},
+        {0.0f, 0.5f, 0.0f, 0.5f}, {0.0f, 0.5f, 0.0f, 0.5f},
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(overlay.indices(), Containers::arrayView<UnsignedInt>({
+        0, 2, 1, 2, 3, 1
+    }), TestSuite::Compare::Container);
+
+    /* Two more frames with the first node moved push the resize out of the
+       window */
+    ui.setNodeOffset(node1, {15.0f, 10.0f});
+    ui.update();
+    ui.setNodeOffset(node1, {10.0f, 10.0f});
+    ui.update();
+    CORRADE_COMPARE_AS(overlay.positions(), Containers::arrayView<Vector2>({
+        {10.0f, 10.0f}, {20.0f, 10.0f}, {10.0f, 20.0f}, {20.0f, 20.0f},
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(overlay.colors(), Containers::arrayView<Color4>({
+        {0.0f, 1.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f, 1.0f},
+        {0.0f, 1.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f, 1.0f},
+    }), TestSuite::Compare::Container);
+}
+
+void PerformanceOverlayLayerTest::updateOverdraw() {
+    AbstractUserInterface ui{{100, 100}};
+
+    OverlayLayer& overlay = ui.setLayerInstance(Containers::pointer<OverlayLayer>(ui.createLayer(), ui, 4));
+    DataLayer& layer1 = ui.setLayerInstance(Containers::pointer<DataLayer>(ui.createLayer()));
+    DataLayer& layer2 = ui.setLayerInstance(Containers::pointer<DataLayer>(ui.createLayer()));
+    /* Data from layers that don't draw aren't counted */
+    DataLayer& eventLayer = ui.setLayerInstance(Containers::pointer<DataLayer>(ui.createLayer(), LayerFeature::Event));
+    /* Layers without an instance are skipped */
+    ui.createLayer();
+
+    NodeHandle node1 = ui.createNode({10.0f, 10.0f}, {10.0f, 10.0f});
+    NodeHandle node2 = ui.createNode({30.0f, 10.0f}, {20.0f, 10.0f});
+    NodeHandle overlayNode = ui.createNode({}, {100.0f, 100.0f});
+    overlay.create(overlayNode);
+    layer1.create(node1);
+    layer2.create(node1);
+    layer1.create(node2);
+    eventLayer.create(node2);
+    eventLayer.create(node2);
+
+    overlay.setMode(PerformanceOverlayMode::Overdraw)
+        .setColor({1.0f, 1.0f, 1.0f, 1.0f});
+    ui.update();
+    CORRADE_COMPARE_AS(overlay.positions(), Containers::arrayView<Vector2>({
+        {10.0f, 10.0f}, {20.0f, 10.0f}, {10.0f, 20.0f}, {20.0f, 20.0f},
+        {30.0f, 10.0f}, {50.0f, 10.0f}, {30.0f, 20.0f}, {50.0f, 20.0f},
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(overlay.colors(), Containers::arrayView<Color4>({
+        {0.5f, 0.5f, 0.5f, 0.5f}, {0.5f, 0.5f, 0.5f, 0.5f},
+        {0.5f, 0.5f, 0.5f, 0.5f}, {0.5f, 0.5f, 0.5f, 0.5f},
+        {0.25f, 0.25f, 0.25f, 0.25f}, {0.25f, 0.25f, 0.25f, 0.25f},
+        {0.25f, 0.25f, 0.25f, 0.25f}, {0.25f, 0.25f, 0.25f, 0.25f},
+    }), TestSuite::Compare::Container);
+}
+
+void PerformanceOverlayLayerTest::updateNoStatistics() {
+    AbstractUserInterface ui{{100, 100}};
+
+    OverlayLayer& overlay = ui.setLayerInstance(Containers::pointer<OverlayLayer>(ui.createLayer(), ui, 4));
+    DataLayer& layer = ui.setLayerInstance(Containers::pointer<DataLayer>(ui.createLayer()));
+
+    NodeHandle node = ui.createNode({10.0f, 10.0f}, {10.0f, 10.0f});
+    overlay.create(ui.createNode({}, {100.0f, 100.0f}));
+    layer.create(node);
+
+    ui.update();
+    CORRADE_COMPARE(overlay.positions().size(), 4);
+
+    /* If the statistics get disabled, the data and layout update modes draw
+       nothing */
+    ui.setNodeUpdateStatisticsFrameCount(0);
+    overlay.setMode(PerformanceOverlayMode::LayoutUpdates);
+    ui.update();
+    CORRADE_COMPARE(overlay.positions().size(), 0);
+
+    overlay.setMode(PerformanceOverlayMode::DataUpdates);
+    ui.update();
+    CORRADE_COMPARE(overlay.positions().size(), 0);
+
+    /* Overdraw doesn't depend on them */
+    overlay.setMode(PerformanceOverlayMode::Overdraw);
+    ui.update();
+    CORRADE_COMPARE(overlay.positions().size(), 4);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Ui::Test::PerformanceOverlayLayerTest)
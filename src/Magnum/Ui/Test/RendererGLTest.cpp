@@ -31,6 +31,7 @@
 #include <Magnum/GL/DefaultFramebuffer.h>
 #include <Magnum/GL/OpenGLTester.h>
 #include <Magnum/GL/Texture.h>
+#include <Magnum/GL/TextureFormat.h>
 #include <Magnum/Math/Vector4.h>
 
 #include "Magnum/Ui/RendererGL.h"
@@ -42,6 +43,7 @@ struct RendererGLTest: GL::OpenGLTester {
 
     void construct();
     void constructCompositingFramebuffer();
+    void constructCompositingFramebufferFormat();
     void constructCopy();
     void constructMove();
 
@@ -53,11 +55,13 @@ struct RendererGLTest: GL::OpenGLTester {
     void transition();
     void transitionCompositing();
     void transitionNoScissor();
+    void transitionCompositingFramebufferGeneration();
 };
 
 RendererGLTest::RendererGLTest() {
     addTests({&RendererGLTest::construct,
               &RendererGLTest::constructCompositingFramebuffer,
+              &RendererGLTest::constructCompositingFramebufferFormat,
               &RendererGLTest::constructCopy,
               &RendererGLTest::constructMove,
 
@@ -66,7 +70,8 @@ RendererGLTest::RendererGLTest() {
 
     addTests({&RendererGLTest::transition,
               &RendererGLTest::transitionCompositing,
-              &RendererGLTest::transitionNoScissor},
+              &RendererGLTest::transitionNoScissor,
+              &RendererGLTest::transitionCompositingFramebufferGeneration},
               &RendererGLTest::setupTeardown,
               &RendererGLTest::setupTeardown);
 }
@@ -82,9 +87,23 @@ void RendererGLTest::constructCompositingFramebuffer() {
     CORRADE_COMPARE(renderer.flags(), RendererGL::Flag::CompositingFramebuffer);
     CORRADE_COMPARE(renderer.features(), RendererFeature::Composite);
 
+    CORRADE_COMPARE(renderer.compositingFramebufferFormat(), GL::TextureFormat::RGBA8);
+
     /* Queries tested in compositingFramebuffer() as they need also size set */
 }
 
+void RendererGLTest::constructCompositingFramebufferFormat() {
+    RendererGL renderer{RendererGL::Flag::CompositingFramebuffer, GL::TextureFormat::RGBA4};
+    CORRADE_COMPARE(renderer.flags(), RendererGL::Flag::CompositingFramebuffer);
+    CORRADE_COMPARE(renderer.features(), RendererFeature::Composite);
+    CORRADE_COMPARE(renderer.compositingFramebufferFormat(), GL::TextureFormat::RGBA4);
+
+    /* The framebuffer should be usable with the custom format */
+    renderer.setupFramebuffers({200, 300});
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    CORRADE_COMPARE(renderer.compositingFramebuffer().checkStatus(GL::FramebufferTarget::Draw), GL::Framebuffer::Status::Complete);
+}
+
 void RendererGLTest::constructCopy() {
     CORRADE_VERIFY(!std::is_copy_constructible<RendererGL>{});
     CORRADE_VERIFY(!std::is_copy_assignable<RendererGL>{});
@@ -335,6 +354,54 @@ void RendererGLTest::transitionNoScissor() {
     CORRADE_COMPARE(currentScissorRect, (Vector4i{0, 1, 2, 3}));
 }
 
+void RendererGLTest::transitionCompositingFramebufferGeneration() {
+    RendererGL renderer{RendererGL::Flag::CompositingFramebuffer};
+    renderer.setupFramebuffers({15, 37});
+    UnsignedLong initial = renderer.compositingFramebufferGeneration();
+
+    /* First draw, the Initial -> Initial transition does nothing */
+    renderer.transition(RendererTargetState::Initial, {});
+    CORRADE_COMPARE(renderer.compositingFramebufferGeneration(), initial);
+
+    /* Compositing doesn't change the contents, drawing does */
+    renderer.transition(RendererTargetState::Composite, {});
+    CORRADE_COMPARE(renderer.compositingFramebufferGeneration(), initial);
+    renderer.transition(RendererTargetState::Draw, {});
+    UnsignedLong drawn = renderer.compositingFramebufferGeneration();
+    CORRADE_VERIFY(drawn != initial);
+    renderer.transition(RendererTargetState::Composite, {});
+    CORRADE_COMPARE(renderer.compositingFramebufferGeneration(), drawn);
+    renderer.transition(RendererTargetState::Draw, {});
+    CORRADE_VERIFY(renderer.compositingFramebufferGeneration() != drawn);
+    CORRADE_VERIFY(renderer.compositingFramebufferGeneration() != initial);
+    renderer.transition(RendererTargetState::Final, {});
+
+    /* Second draw with the contents marked as unchanged starts with the same
+       generation as the first */
+    renderer.setCompositingFramebufferUnchanged();
+    renderer.transition(RendererTargetState::Initial, {});
+    CORRADE_COMPARE(renderer.compositingFramebufferGeneration(), initial);
+    renderer.transition(RendererTargetState::Draw, {});
+    CORRADE_VERIFY(renderer.compositingFramebufferGeneration() != initial);
+    CORRADE_VERIFY(renderer.compositingFramebufferGeneration() != drawn);
+    renderer.transition(RendererTargetState::Final, {});
+
+    /* Third draw without the mark, which got reset at the end of the previous
+       draw, starts with a new generation */
+    renderer.transition(RendererTargetState::Initial, {});
+    UnsignedLong third = renderer.compositingFramebufferGeneration();
+    CORRADE_VERIFY(third != initial);
+    CORRADE_VERIFY(third != drawn);
+    renderer.transition(RendererTargetState::Final, {});
+
+    /* Framebuffer setup makes the contents undefined, discarding the mark */
+    renderer.setCompositingFramebufferUnchanged();
+    renderer.setupFramebuffers({16, 38});
+    renderer.transition(RendererTargetState::Initial, {});
+    CORRADE_VERIFY(renderer.compositingFramebufferGeneration() != third);
+    renderer.transition(RendererTargetState::Final, {});
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Ui::Test::RendererGLTest)
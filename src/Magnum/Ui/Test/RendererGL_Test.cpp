@@ -29,6 +29,7 @@
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/String.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+#include <Magnum/GL/TextureFormat.h>
 
 #include "Magnum/Ui/RendererGL.h"
 
@@ -41,6 +42,7 @@ struct RendererGL_Test: TestSuite::Tester {
     void debugFlags();
 
     void construct();
+    void constructCompositingFramebufferFormatNotEnabled();
 
     void compositingFramebufferTextureNotEnabled();
 };
@@ -50,6 +52,7 @@ RendererGL_Test::RendererGL_Test() {
               &RendererGL_Test::debugFlags,
 
               &RendererGL_Test::construct,
+              &RendererGL_Test::constructCompositingFramebufferFormatNotEnabled,
 
               &RendererGL_Test::compositingFramebufferTextureNotEnabled});
 }
@@ -73,6 +76,15 @@ void RendererGL_Test::construct() {
     CORRADE_COMPARE(renderer.currentDrawStates(), RendererDrawStates{});
 }
 
+void RendererGL_Test::constructCompositingFramebufferFormatNotEnabled() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    RendererGL{{}, GL::TextureFormat::RGBA4};
+    CORRADE_COMPARE(out.str(), "Ui::RendererGL: compositing framebuffer format specified but Ui::RendererGL::Flag::CompositingFramebuffer not enabled\n");
+}
+
 void RendererGL_Test::compositingFramebufferTextureNotEnabled() {
     CORRADE_SKIP_IF_NO_ASSERT();
 
@@ -85,11 +97,17 @@ void RendererGL_Test::compositingFramebufferTextureNotEnabled() {
     crenderer.compositingFramebuffer();
     renderer.compositingTexture();
     crenderer.compositingTexture();
+    renderer.compositingFramebufferFormat();
+    renderer.compositingFramebufferGeneration();
+    renderer.setCompositingFramebufferUnchanged();
     CORRADE_COMPARE_AS(out.str(),
         "Ui::RendererGL::compositingFramebuffer(): compositing framebuffer not enabled\n"
         "Ui::RendererGL::compositingFramebuffer(): compositing framebuffer not enabled\n"
         "Ui::RendererGL::compositingTexture(): compositing framebuffer not enabled\n"
-        "Ui::RendererGL::compositingTexture(): compositing framebuffer not enabled\n",
+        "Ui::RendererGL::compositingTexture(): compositing framebuffer not enabled\n"
+        "Ui::RendererGL::compositingFramebufferFormat(): compositing framebuffer not enabled\n"
+        "Ui::RendererGL::compositingFramebufferGeneration(): compositing framebuffer not enabled\n"
+        "Ui::RendererGL::setCompositingFramebufferUnchanged(): compositing framebuffer not enabled\n",
         TestSuite::Compare::String);
 }
 
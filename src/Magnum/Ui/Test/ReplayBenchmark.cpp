@@ -0,0 +1,587 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <algorithm> /* std::sort() */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/Utility/Arguments.h>
+#include <Corrade/Utility/Format.h>
+#include <Corrade/Utility/Move.h>
+#include <Corrade/Utility/Path.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Time.h>
+
+#include "Magnum/Ui/Anchor.h"
+#include "Magnum/Ui/Button.h"
+#include "Magnum/Ui/Event.h"
+#include "Magnum/Ui/Label.h"
+#include "Magnum/Ui/Test/WidgetTester.hpp"
+
+/* Replays a UI session recorded into a compact binary log headlessly,
+   without any GPU involvement, and prints per-frame CPU timings and
+   allocation counts as JSON or CSV, meant to be used for reproducing
+   performance issues in CI. If no log is supplied, a synthetic session with
+   a grid of buttons and labels, pointer sweeps, clicks, key and text input
+   and widget churn is generated and optionally saved as well. The layers are
+   the same stubbed-out base and text layers as in WidgetTester, so only the
+   UI bookkeeping and layer data preparation is measured. */
+
+/* Counting allocations going through operator new. Allocations done by
+   growable arrays directly with malloc() aren't included. Has to be in the
+   global namespace to replace the default implementation. */
+namespace {
+    std::size_t allocationCount = 0;
+}
+
+void* operator new(std::size_t size) {
+    ++allocationCount;
+    void* const out = std::malloc(size ? size : 1);
+    if(!out) std::abort();
+    return out;
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+namespace Magnum { namespace Ui { namespace Test { namespace {
+
+using namespace Containers::Literals;
+using namespace Math::Literals;
+
+/* The log starts with a header containing the magic, a version and the UI
+   size, followed by a sequence of commands, each being a single byte
+   identifying the command followed by its payload. Values are stored in the
+   machine byte order, the log isn't meant to be portable across
+   architectures. Nodes are referenced by the order in which they were
+   created, with 0 being the root node spanning the whole UI. */
+constexpr char LogMagic[]{'U', 'I', 'R', 'L'};
+constexpr UnsignedByte LogVersion = 1;
+
+enum class Command: UnsignedByte {
+    /* UnsignedInt parent, Vector2 offset, Vector2 size */
+    Node = 1,
+    /* UnsignedInt parent, Vector2 offset, Vector2 size, UnsignedByte style,
+       UnsignedInt text size, text */
+    Button,
+    /* Same as Button */
+    Label,
+    /* UnsignedInt node */
+    Remove,
+    /* InputEventType type, Long time, then a type-specific payload, see
+       SessionLog::event() */
+    Event,
+    /* Long time passed to advanceAnimations() */
+    Frame
+};
+
+class SessionLog {
+    public:
+        explicit SessionLog(const Vector2& size);
+
+        Containers::ArrayView<const char> data() const { return _data; }
+
+        UnsignedInt node(UnsignedInt parent, const Vector2& offset, const Vector2& size);
+        UnsignedInt button(UnsignedInt parent, const Vector2& offset, const Vector2& size, Containers::StringView text, ButtonStyle style);
+        UnsignedInt label(UnsignedInt parent, const Vector2& offset, const Vector2& size, Containers::StringView text, LabelStyle style);
+        void remove(UnsignedInt node);
+        void event(const InputEvent& event);
+        void frame(Nanoseconds time);
+
+    private:
+        template<class T> void write(const T& value) {
+            arrayAppend(_data, Containers::arrayView(reinterpret_cast<const char*>(&value), sizeof(T)));
+        }
+        void write(Containers::StringView text) {
+            write(UnsignedInt(text.size()));
+            arrayAppend(_data, Containers::arrayView(text.data(), text.size()));
+        }
+        UnsignedInt widget(Command command, UnsignedInt parent, const Vector2& offset, const Vector2& size, Containers::StringView text, UnsignedByte style);
+
+        Containers::Array<char> _data;
+        /* The root node is implicit */
+        UnsignedInt _nodeCount = 1;
+};
+
+SessionLog::SessionLog(const Vector2& size) {
+    arrayAppend(_data, Containers::arrayView(LogMagic));
+    write(LogVersion);
+    write(size);
+}
+
+UnsignedInt SessionLog::node(const UnsignedInt parent, const Vector2& offset, const Vector2& size) {
+    write(Command::Node);
+    write(parent);
+    write(offset);
+    write(size);
+    return _nodeCount++;
+}
+
+UnsignedInt SessionLog::widget(const Command command, const UnsignedInt parent, const Vector2& offset, const Vector2& size, const Containers::StringView text, const UnsignedByte style) {
+    write(command);
+    write(parent);
+    write(offset);
+    write(size);
+    write(style);
+    write(text);
+    return _nodeCount++;
+}
+
+UnsignedInt SessionLog::button(const UnsignedInt parent, const Vector2& offset, const Vector2& size, const Containers::StringView text, const ButtonStyle style) {
+    return widget(Command::Button, parent, offset, size, text, UnsignedByte(style));
+}
+
+UnsignedInt SessionLog::label(const UnsignedInt parent, const Vector2& offset, const Vector2& size, const Containers::StringView text, const LabelStyle style) {
+    return widget(Command::Label, parent, offset, size, text, UnsignedByte(style));
+}
+
+void SessionLog::remove(const UnsignedInt node) {
+    write(Command::Remove);
+    write(node);
+}
+
+void SessionLog::event(const InputEvent& event) {
+    write(Command::Event);
+    write(event.type());
+    write(Long(event.time()));
+    switch(event.type()) {
+        case InputEventType::PointerPress:
+        case InputEventType::PointerRelease:
+        case InputEventType::PointerMove:
+            write(event.globalPosition());
+            write(event.source());
+            write(event.pointer() ? *event.pointer() : Pointer{});
+            write(event.pointers());
+            write(UnsignedByte(event.isPrimary()));
+            write(event.id());
+            return;
+        case InputEventType::KeyPress:
+        case InputEventType::KeyRelease:
+            write(event.key());
+            write(event.modifiers());
+            return;
+        case InputEventType::TextInput:
+            write(event.text());
+            return;
+    }
+
+    CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+}
+
+void SessionLog::frame(const Nanoseconds time) {
+    write(Command::Frame);
+    write(Long(time));
+}
+
+/* Sequential reader of the log, exiting on truncated or invalid data */
+class SessionLogReader {
+    public:
+        explicit SessionLogReader(Containers::ArrayView<const char> data): _data{data} {}
+
+        bool atEnd() const { return _offset == _data.size(); }
+
+        template<class T> T read() {
+            if(_data.size() - _offset < sizeof(T))
+                Fatal{} << "Truncated session log at offset" << _offset;
+            T out;
+            std::memcpy(&out, _data.data() + _offset, sizeof(T));
+            _offset += sizeof(T);
+            return out;
+        }
+
+        Containers::StringView readText() {
+            const UnsignedInt size = read<UnsignedInt>();
+            if(_data.size() - _offset < size)
+                Fatal{} << "Truncated session log at offset" << _offset;
+            const Containers::StringView out{_data.data() + _offset, size};
+            _offset += size;
+            return out;
+        }
+
+    private:
+        Containers::ArrayView<const char> _data;
+        std::size_t _offset = 0;
+};
+
+/* Time spent applying node and data changes, dispatching events, advancing
+   animations and updating the UI in microseconds, and the count of
+   allocations done in the frame */
+struct FrameStats {
+    Double phases[4];
+    std::size_t allocations;
+    std::size_t events;
+};
+
+constexpr Containers::StringView PhaseNames[]{
+    "commands"_s, "events"_s, "animations"_s, "update"_s
+};
+
+struct Session {
+    Vector2 size;
+    std::size_t nodeCount = 0;
+    Containers::Array<FrameStats> frames;
+};
+
+Session replay(Containers::ArrayView<const char> data) {
+    SessionLogReader reader{data};
+    char magic[4];
+    for(char& c: magic)
+        c = reader.read<char>();
+    if(std::memcmp(magic, LogMagic, sizeof(LogMagic)) != 0)
+        Fatal{} << "Not a UI session log";
+    const UnsignedByte version = reader.read<UnsignedByte>();
+    if(version != LogVersion)
+        Fatal{} << "Expected session log version" << LogVersion << "but got" << version;
+
+    Session session;
+    session.size = reader.read<Vector2>();
+
+    TestBaseLayerShared baseLayerShared;
+    TestTextLayerShared textLayerShared;
+    TestUserInterface ui{NoCreate};
+    ui.setBaseLayerInstance(Containers::pointer<TestBaseLayer>(ui.createLayer(), baseLayerShared))
+      .setTextLayerInstance(Containers::pointer<TestTextLayer>(ui.createLayer(), textLayerShared))
+      .setSize(session.size);
+
+    Containers::Array<NodeHandle> nodes;
+    arrayAppend(nodes, ui.createNode({}, ui.size()));
+    const auto nodeAt = [&](UnsignedInt index) {
+        if(index >= nodes.size())
+            Fatal{} << "Session log references node" << index << "but only" << nodes.size() << "were created";
+        return nodes[index];
+    };
+
+    using Clock = std::chrono::steady_clock;
+    const auto microseconds = [](Clock::time_point begin, Clock::time_point end) {
+        return std::chrono::duration<Double, std::micro>(end - begin).count();
+    };
+
+    /* Events are collected and dispatched in a single batch before the next
+       command that isn't an event, preserving their order relative to node
+       and data changes */
+    Containers::Array<InputEvent> events;
+    FrameStats frame{};
+    std::size_t allocationsBefore = allocationCount;
+    const auto dispatchEvents = [&]() {
+        if(events.isEmpty()) return;
+        const Clock::time_point begin = Clock::now();
+        ui.dispatchEvents(events);
+        frame.phases[1] += microseconds(begin, Clock::now());
+        frame.events += events.size();
+        arrayClear(events);
+    };
+
+    while(!reader.atEnd()) {
+        const Command command = reader.read<Command>();
+        if(command != Command::Event)
+            dispatchEvents();
+
+        switch(command) {
+            case Command::Node:
+            case Command::Button:
+            case Command::Label: {
+                const NodeHandle parent = nodeAt(reader.read<UnsignedInt>());
+                const Vector2 offset = reader.read<Vector2>();
+                const Vector2 size = reader.read<Vector2>();
+                UnsignedByte style{};
+                Containers::StringView text;
+                if(command != Command::Node) {
+                    style = reader.read<UnsignedByte>();
+                    text = reader.readText();
+                }
+
+                const Clock::time_point begin = Clock::now();
+                if(command == Command::Node)
+                    arrayAppend(nodes, ui.createNode(parent, offset, size));
+                else if(command == Command::Button)
+                    arrayAppend(nodes, button({ui, parent, offset, size}, text, ButtonStyle(style)));
+                else
+                    arrayAppend(nodes, label({ui, parent, offset, size}, text, LabelStyle(style)));
+                frame.phases[0] += microseconds(begin, Clock::now());
+            } break;
+            case Command::Remove: {
+                const NodeHandle node = nodeAt(reader.read<UnsignedInt>());
+                const Clock::time_point begin = Clock::now();
+                ui.removeNode(node);
+                frame.phases[0] += microseconds(begin, Clock::now());
+            } break;
+            case Command::Event: {
+                const InputEventType type = reader.read<InputEventType>();
+                const Nanoseconds time{reader.read<Long>()};
+                switch(type) {
+                    case InputEventType::PointerPress:
+                    case InputEventType::PointerRelease:
+                    case InputEventType::PointerMove: {
+                        const Vector2 position = reader.read<Vector2>();
+                        const PointerEventSource source = reader.read<PointerEventSource>();
+                        const Pointer pointer = reader.read<Pointer>();
+                        const Pointers pointers = reader.read<Pointers>();
+                        const bool primary = reader.read<UnsignedByte>();
+                        const Long id = reader.read<Long>();
+                        if(type == InputEventType::PointerPress)
+                            arrayAppend(events, InputEvent::pointerPress(time, position, source, pointer, primary, id));
+                        else if(type == InputEventType::PointerRelease)
+                            arrayAppend(events, InputEvent::pointerRelease(time, position, source, pointer, primary, id));
+                        else
+                            arrayAppend(events, InputEvent::pointerMove(time, position, source, pointer == Pointer{} ? Containers::NullOpt : Containers::optional(pointer), pointers, primary, id));
+                    } break;
+                    case InputEventType::KeyPress:
+                    case InputEventType::KeyRelease: {
+                        const Key key = reader.read<Key>();
+                        const Modifiers modifiers = reader.read<Modifiers>();
+                        arrayAppend(events, type == InputEventType::KeyPress ?
+                            InputEvent::keyPress(time, key, modifiers) :
+                            InputEvent::keyRelease(time, key, modifiers));
+                    } break;
+                    case InputEventType::TextInput:
+                        arrayAppend(events, InputEvent::textInput(time, reader.readText()));
+                        break;
+                    default:
+                        Fatal{} << "Invalid session log event" << type;
+                }
+            } break;
+            case Command::Frame: {
+                const Nanoseconds time{reader.read<Long>()};
+
+                const Clock::time_point begin = Clock::now();
+                ui.advanceAnimations(time);
+                const Clock::time_point advanced = Clock::now();
+                ui.update();
+                const Clock::time_point updated = Clock::now();
+                frame.phases[2] += microseconds(begin, advanced);
+                frame.phases[3] += microseconds(advanced, updated);
+
+                frame.allocations = allocationCount - allocationsBefore;
+                arrayAppend(session.frames, frame);
+                frame = {};
+                allocationsBefore = allocationCount;
+            } break;
+            default:
+                Fatal{} << "Invalid session log command" << UnsignedByte(command);
+        }
+    }
+
+    session.nodeCount = ui.nodeUsedCount();
+
+    /* Remove the nodes while the layers are still alive */
+    ui.removeNode(nodes[0]);
+    ui.clean();
+
+    return session;
+}
+
+/* A synthetic session. A grid of buttons with a label above each, a pointer
+   sweeping over them in a zig-zag pattern with several moves per frame,
+   clicks, key and text input, and a row of widgets recreated periodically.
+   Deterministic, so it produces the same log every time. */
+void generateSession(SessionLog& log, const Vector2ui& grid, const UnsignedInt frames, const UnsignedInt movesPerFrame) {
+    constexpr Vector2 cellSize{64.0f, 48.0f};
+
+    /* The widgets are placed into a row node so a whole row can be removed
+       and recreated at once */
+    Containers::Array<UnsignedInt> rows;
+    const auto createRow = [&](UnsignedInt y) {
+        const UnsignedInt row = log.node(0, {0.0f, Float(y)*cellSize.y()}, {Float(grid.x())*cellSize.x(), cellSize.y()});
+        for(UnsignedInt x = 0; x != grid.x(); ++x) {
+            const Vector2 offset{Float(x)*cellSize.x(), 0.0f};
+            log.label(row, offset, {cellSize.x(), 16.0f}, "Label"_s, LabelStyle::Default);
+            log.button(row, offset + Vector2::yAxis(16.0f), {cellSize.x(), cellSize.y() - 16.0f}, "Button"_s, ButtonStyle((x + y) % 6));
+        }
+        return row;
+    };
+    for(UnsignedInt y = 0; y != grid.y(); ++y)
+        arrayAppend(rows, createRow(y));
+
+    const Vector2 size = Vector2{grid}*cellSize;
+    for(UnsignedInt i = 0; i != frames; ++i) {
+        /* 60 FPS */
+        const Nanoseconds time{Long(i)*16666667ll};
+
+        /* Zig-zag over the whole grid in 240 frames */
+        const Float t = Float(i % 240)/240.0f;
+        const bool pressed = i % 30 >= 20 && i % 30 < 25;
+        for(UnsignedInt j = 0; j != movesPerFrame; ++j) {
+            const Float tj = t + Float(j)/(240.0f*movesPerFrame);
+            const Vector2 position{
+                size.x()*(1.0f - Math::abs(1.0f - 2.0f*Math::fmod(tj*8.0f, 1.0f))),
+                size.y()*tj};
+            log.event(InputEvent::pointerMove(time, position, PointerEventSource::Mouse, {}, pressed ? Pointer::MouseLeft : Pointers{}, true, 0));
+        }
+
+        /* Drag with a press on the 20th frame and release on the 25th of
+           each 30-frame period */
+        const Vector2 position{
+            size.x()*(1.0f - Math::abs(1.0f - 2.0f*Math::fmod(t*8.0f, 1.0f))),
+            size.y()*t};
+        if(i % 30 == 20)
+            log.event(InputEvent::pointerPress(time, position, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0));
+        else if(i % 30 == 25)
+            log.event(InputEvent::pointerRelease(time, position, PointerEventSource::Mouse, Pointer::MouseLeft, true, 0));
+
+        if(i % 10 == 5) {
+            log.event(InputEvent::keyPress(time, Key::A, {}));
+            log.event(InputEvent::textInput(time, "a"_s));
+            log.event(InputEvent::keyRelease(time, Key::A, {}));
+        }
+
+        /* Recreate a row every 50 frames */
+        if(i % 50 == 49 && !rows.isEmpty()) {
+            const UnsignedInt y = (i/50) % rows.size();
+            log.remove(rows[y]);
+            rows[y] = createRow(y);
+        }
+
+        log.frame(time);
+    }
+}
+
+template<class ...Args> void appendFormatted(Containers::Array<char>& out, const char* format, const Args&... args) {
+    const Containers::String formatted = Utility::format(format, args...);
+    arrayAppend(out, Containers::arrayView(formatted.data(), formatted.size()));
+}
+
+int run(int argc, char** argv) {
+    Utility::Arguments args;
+    args.addOption("replay").setHelp("replay", "session log to replay instead of generating a synthetic session", "FILE")
+        .addOption("record").setHelp("record", "save the generated session log to a file", "FILE")
+        .addOption("grid", "10 10").setHelp("grid", "widget grid size of the synthetic session")
+        .addOption("frames", "600").setHelp("frames", "frame count of the synthetic session")
+        .addOption("moves", "8").setHelp("moves", "pointer moves per frame in the synthetic session")
+        .addOption("warmup", "10").setHelp("warmup", "count of frames excluded from the statistics")
+        .addOption("format", "json").setHelp("format", "output format, either json or csv")
+        .addOption("output").setHelp("output", "file to write the output to instead of standard output", "FILE")
+        .setGlobalHelp("Replays a recorded UI session, printing per-frame CPU timings and allocation counts.")
+        .parse(argc, argv);
+
+    const Containers::StringView format = args.value<Containers::StringView>("format");
+    if(format != "json"_s && format != "csv"_s)
+        Fatal{} << "Expected either json or csv output format, got" << format;
+
+    Containers::Array<char> data;
+    const Containers::StringView replayFile = args.value<Containers::StringView>("replay");
+    if(!replayFile.isEmpty()) {
+        Containers::Optional<Containers::Array<char>> file = Utility::Path::read(replayFile);
+        if(!file)
+            return 1;
+        data = *Utility::move(file);
+    } else {
+        const Vector2ui grid = args.value<Vector2ui>("grid");
+        SessionLog log{Vector2{grid}*Vector2{64.0f, 48.0f}};
+        generateSession(log, grid, args.value<UnsignedInt>("frames"), args.value<UnsignedInt>("moves"));
+        arrayAppend(data, log.data());
+
+        const Containers::StringView recordFile = args.value<Containers::StringView>("record");
+        if(!recordFile.isEmpty() && !Utility::Path::write(recordFile, data))
+            return 1;
+    }
+
+    const Session session = replay(data);
+    const UnsignedInt warmup = Math::min(args.value<UnsignedInt>("warmup"), UnsignedInt(session.frames.size()));
+    const Containers::ArrayView<const FrameStats> frames = session.frames.exceptPrefix(warmup);
+
+    Containers::Array<char> out;
+    if(format == "csv"_s) {
+        appendFormatted(out, "frame,commands,events,animations,update,eventCount,allocations\n");
+        for(std::size_t i = 0; i != frames.size(); ++i) {
+            const FrameStats& frame = frames[i];
+            appendFormatted(out, "{},{:.3f},{:.3f},{:.3f},{:.3f},{},{}\n", i, frame.phases[0], frame.phases[1], frame.phases[2], frame.phases[3], frame.events, frame.allocations);
+        }
+    } else {
+        std::size_t allocations = 0, maxAllocations = 0, events = 0;
+        for(const FrameStats& frame: frames) {
+            allocations += frame.allocations;
+            maxAllocations = Math::max(maxAllocations, frame.allocations);
+            events += frame.events;
+        }
+
+        appendFormatted(out,
+            "{{\n"
+            "  \"session\": {{\n"
+            "    \"size\": [{}, {}],\n"
+            "    \"frames\": {},\n"
+            "    \"warmup\": {},\n"
+            "    \"logSize\": {}\n"
+            "  }},\n"
+            "  \"nodes\": {},\n"
+            "  \"events\": {},\n"
+            "  \"allocations\": {{\"total\": {}, \"max\": {}}},\n"
+            "  \"unit\": \"us\",\n"
+            "  \"phases\": {{",
+            session.size.x(), session.size.y(), frames.size(), warmup, data.size(),
+            session.nodeCount, events, allocations, maxAllocations);
+
+        /* Min, median, mean and max for every phase */
+        Containers::Array<Double> sorted{NoInit, frames.size()};
+        for(std::size_t p = 0; p != Containers::arraySize(PhaseNames); ++p) {
+            appendFormatted(out, "{}\n    \"{}\": ", p ? "," : "", PhaseNames[p]);
+            if(frames.isEmpty()) {
+                appendFormatted(out, "null");
+                continue;
+            }
+
+            Double sum = 0.0;
+            for(std::size_t i = 0; i != frames.size(); ++i) {
+                sorted[i] = frames[i].phases[p];
+                sum += sorted[i];
+            }
+            std::sort(sorted.begin(), sorted.end());
+            appendFormatted(out, "{{\"min\": {:.3f}, \"median\": {:.3f}, \"mean\": {:.3f}, \"max\": {:.3f}}}",
+                sorted.front(), sorted[sorted.size()/2], sum/sorted.size(), sorted.back());
+        }
+
+        appendFormatted(out, "\n  }},\n  \"frames\": [");
+        for(std::size_t i = 0; i != frames.size(); ++i) {
+            const FrameStats& frame = frames[i];
+            appendFormatted(out, "{}\n    [{:.3f}, {:.3f}, {:.3f}, {:.3f}, {}, {}]", i ? "," : "", frame.phases[0], frame.phases[1], frame.phases[2], frame.phases[3], frame.events, frame.allocations);
+        }
+        appendFormatted(out, "\n  ]\n}}\n");
+    }
+
+    const Containers::StringView output = args.value<Containers::StringView>("output");
+    if(output.isEmpty()) {
+        std::fwrite(out.data(), 1, out.size(), stdout);
+        return 0;
+    }
+
+    return Utility::Path::write(output, out) ? 0 : 1;
+}
+
+}}}}
+
+int main(int argc, char** argv) {
+    return Magnum::Ui::Test::run(argc, argv);
+}
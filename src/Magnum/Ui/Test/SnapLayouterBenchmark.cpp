@@ -0,0 +1,256 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstring>
+#include <Corrade/Containers/BitArray.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "Magnum/Ui/AbstractUserInterface.h"
+#include "Magnum/Ui/Anchor.h"
+#include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/SnapLayouter.h"
+#include "Magnum/Ui/Implementation/orderNodesBreadthFirstInto.h"
+#include "Magnum/Ui/Implementation/snapLayouter.h"
+
+namespace Magnum { namespace Ui { namespace Test { namespace {
+
+struct SnapLayouterBenchmark: TestSuite::Tester {
+    explicit SnapLayouterBenchmark();
+
+    void orderLayoutsBreadthFirst();
+    void update();
+    void updateCached();
+};
+
+enum class Shape {
+    /* A list, with the first row snapped inside a container node and each
+       next row snapped below the previous one */
+    Chain,
+    /* A square grid, with the first cell of each row snapped below the first
+       cell of the previous row and each other cell snapped to the right of
+       the previous cell */
+    Grid,
+    /* Each node filling the previous one, forming a single branch */
+    Deep
+};
+
+const struct {
+    const char* name;
+    Shape shape;
+    UnsignedInt layoutCount;
+} ShapeData[]{
+    {"chain, 1k layouts", Shape::Chain, 1000},
+    {"chain, 10k layouts", Shape::Chain, 10000},
+    {"chain, 100k layouts", Shape::Chain, 100000},
+    {"grid, 1k layouts", Shape::Grid, 1024},
+    {"grid, 10k layouts", Shape::Grid, 10000},
+    {"grid, 100k layouts", Shape::Grid, 99856},
+    {"deep, 1k layouts", Shape::Deep, 1000},
+    {"deep, 10k layouts", Shape::Deep, 10000},
+    {"deep, 100k layouts", Shape::Deep, 100000},
+};
+
+struct Interface: AbstractUserInterface {
+    explicit Interface(NoCreateT): AbstractUserInterface{NoCreate} {}
+};
+
+/* Creates layouts of given shape together with the node parent, offset and
+   size arrays the UI would pass to the layouter update. Node 0 is a container
+   without a layout. */
+struct Layouts {
+    explicit Layouts(Shape shape, UnsignedInt count);
+
+    Interface ui{NoCreate};
+    SnapLayouter* layouter;
+    Containers::Array<NodeHandle> layoutTargets;
+    Containers::Array<NodeHandle> nodeParents;
+    Containers::Array<Vector2> nodeOffsets;
+    Containers::Array<Vector2> nodeSizes;
+    Containers::BitArray layoutIdsToUpdate;
+};
+
+Layouts::Layouts(const Shape shape, const UnsignedInt count) {
+    layouter = &ui.setLayouterInstance(Containers::pointer<SnapLayouter>(ui.createLayouter()));
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level) */
+    layouter->setSize({1000.0f, 1000.0f});
+
+    const NodeHandle container = ui.createNode({}, {1000.0f, 1000.0f});
+    const Vector2 size{10.0f, 10.0f};
+    NodeHandle previous = container;
+    switch(shape) {
+        case Shape::Chain:
+            previous = snap(ui, *layouter, Snap::Top|Snap::Inside, container, size);
+            for(UnsignedInt i = 1; i != count; ++i)
+                previous = snap(ui, *layouter, Snap::Bottom, previous, size);
+            break;
+        case Shape::Grid: {
+            UnsignedInt width = 1;
+            while(width*width < count)
+                ++width;
+            NodeHandle rowStart = container;
+            for(UnsignedInt i = 0; i != count; ++i) {
+                if(i == 0)
+                    rowStart = previous = snap(ui, *layouter, Snap::TopLeft|Snap::Inside, container, size);
+                else if(i % width == 0)
+                    rowStart = previous = snap(ui, *layouter, Snap::Bottom|Snap::Left|Snap::InsideX, rowStart, size);
+                else
+                    previous = snap(ui, *layouter, Snap::Right|Snap::Top|Snap::InsideY, previous, size);
+            }
+        } break;
+        case Shape::Deep:
+            for(UnsignedInt i = 0; i != count; ++i)
+                previous = snap(ui, *layouter, Snap::Fill, previous, {});
+            break;
+    }
+
+    CORRADE_INTERNAL_ASSERT(layouter->usedCount() == count);
+    CORRADE_INTERNAL_ASSERT(ui.nodeCapacity() == count + 1);
+
+    nodeParents = Containers::Array<NodeHandle>{NoInit, ui.nodeCapacity()};
+    nodeOffsets = Containers::Array<Vector2>{NoInit, ui.nodeCapacity()};
+    nodeSizes = Containers::Array<Vector2>{NoInit, ui.nodeCapacity()};
+    nodeParents[0] = NodeHandle::Null;
+    nodeOffsets[0] = ui.nodeOffset(container);
+    nodeSizes[0] = ui.nodeSize(container);
+    layoutTargets = Containers::Array<NodeHandle>{NoInit, layouter->capacity()};
+    for(UnsignedInt i = 0; i != layouter->capacity(); ++i) {
+        /* Layouts are created in the same order as nodes, with the container
+           being the first node */
+        const NodeHandle node = layouter->nodes()[i];
+        CORRADE_INTERNAL_ASSERT(nodeHandleId(node) == i + 1);
+        nodeParents[i + 1] = ui.nodeParent(node);
+        nodeOffsets[i + 1] = ui.nodeOffset(node);
+        nodeSizes[i + 1] = ui.nodeSize(node);
+        layoutTargets[i] = layouter->target(layouterDataHandle(i, 1));
+    }
+
+    layoutIdsToUpdate = Containers::BitArray{DirectInit, layouter->capacity(), true};
+}
+
+SnapLayouterBenchmark::SnapLayouterBenchmark() {
+    addInstancedBenchmarks({&SnapLayouterBenchmark::orderLayoutsBreadthFirst,
+                            &SnapLayouterBenchmark::update,
+                            &SnapLayouterBenchmark::updateCached}, 10,
+        Containers::arraySize(ShapeData));
+}
+
+void SnapLayouterBenchmark::orderLayoutsBreadthFirst() {
+    auto&& data = ShapeData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const Layouts layouts{data.shape, data.layoutCount};
+    const std::size_t nodeCount = layouts.nodeParents.size();
+
+    /* The node order is calculated outside of the benchmark loop as it's
+       measured in AbstractUserInterfaceImplementationBenchmark already */
+    Containers::Array<UnsignedInt> childrenOffsets{ValueInit, nodeCount + 2};
+    Containers::Array<UnsignedInt> children{NoInit, nodeCount};
+    Containers::Array<Int> nodeIdsBreadthFirst{NoInit, nodeCount + 1};
+    Implementation::orderNodesBreadthFirstInto(
+        layouts.nodeParents,
+        childrenOffsets, children, nodeIdsBreadthFirst);
+
+    /* The zero-initialization of layoutOffsets is a part of the cost, as
+       SnapLayouter::doUpdate() has to do it too */
+    Containers::Array<UnsignedInt> layoutOffsets{NoInit, nodeCount + 2};
+    Containers::Array<UnsignedInt> layoutList{NoInit, data.layoutCount};
+    Containers::Array<UnsignedInt> layoutIds{NoInit, data.layoutCount};
+    std::size_t count = 0;
+    CORRADE_BENCHMARK(5) {
+        std::memset(layoutOffsets.data(), 0, layoutOffsets.size()*sizeof(UnsignedInt));
+        count = Implementation::orderLayoutsBreadthFirstInto(
+            layouts.layoutIdsToUpdate,
+            layouts.layoutTargets,
+            nodeIdsBreadthFirst,
+            layoutOffsets,
+            layoutList,
+            layoutIds);
+    }
+
+    CORRADE_COMPARE(count, data.layoutCount);
+}
+
+void SnapLayouterBenchmark::update() {
+    auto&& data = ShapeData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Layouts layouts{data.shape, data.layoutCount};
+
+    /* The layouter modifies the offsets and sizes in place, so each iteration
+       starts from a copy of the original values, which is what the UI does
+       as well. The cached results are invalidated in each iteration by
+       changing the margin, so all layouts get calculated again. */
+    Containers::Array<Vector2> nodeOffsets{NoInit, layouts.nodeOffsets.size()};
+    Containers::Array<Vector2> nodeSizes{NoInit, layouts.nodeSizes.size()};
+    Float margin = 0.0f;
+    CORRADE_BENCHMARK(5) {
+        layouts.layouter->setMargin(margin += 1.0f);
+        Utility::copy(layouts.nodeOffsets, nodeOffsets);
+        Utility::copy(layouts.nodeSizes, nodeSizes);
+        layouts.layouter->update(layouts.layoutIdsToUpdate, {}, layouts.nodeParents, nodeOffsets, nodeSizes);
+    }
+
+    /* The deep hierarchy fills the container, the others place the last
+       node away from its origin */
+    if(data.shape == Shape::Deep)
+        CORRADE_COMPARE(nodeSizes.back(), (Vector2{1000.0f, 1000.0f}));
+    else
+        CORRADE_VERIFY(!nodeOffsets.back().isZero());
+}
+
+void SnapLayouterBenchmark::updateCached() {
+    auto&& data = ShapeData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Layouts layouts{data.shape, data.layoutCount};
+
+    /* Same as above, but with the layouts calculated once before, so the
+       loop measures just the ordering and the cache lookup */
+    Containers::Array<Vector2> nodeOffsets{NoInit, layouts.nodeOffsets.size()};
+    Containers::Array<Vector2> nodeSizes{NoInit, layouts.nodeSizes.size()};
+    Utility::copy(layouts.nodeOffsets, nodeOffsets);
+    Utility::copy(layouts.nodeSizes, nodeSizes);
+    layouts.layouter->update(layouts.layoutIdsToUpdate, {}, layouts.nodeParents, nodeOffsets, nodeSizes);
+
+    CORRADE_BENCHMARK(5) {
+        Utility::copy(layouts.nodeOffsets, nodeOffsets);
+        Utility::copy(layouts.nodeSizes, nodeSizes);
+        layouts.layouter->update(layouts.layoutIdsToUpdate, {}, layouts.nodeParents, nodeOffsets, nodeSizes);
+    }
+
+    if(data.shape == Shape::Deep)
+        CORRADE_COMPARE(nodeSizes.back(), (Vector2{1000.0f, 1000.0f}));
+    else
+        CORRADE_VERIFY(!nodeOffsets.back().isZero());
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Ui::Test::SnapLayouterBenchmark)
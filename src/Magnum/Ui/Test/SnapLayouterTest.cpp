@@ -80,6 +80,7 @@ struct SnapLayouterTest: TestSuite::Tester {
 
     void updateEmpty();
     void updateDataOrder();
+    void updateIncremental();
 };
 
 const struct {
@@ -209,10 +210,12 @@ const struct {
     const char* name;
     bool setMarginPaddingLater;
     bool recycledLayouts;
+    bool executor;
 } UpdateDataOrderData[]{
-    {"", false, false},
-    {"margin & padding set later", true, false},
-    {"layouts recycled in shuffled order", false, true},
+    {"", false, false, false},
+    {"margin & padding set later", true, false, false},
+    {"layouts recycled in shuffled order", false, true, false},
+    {"update executor", false, false, true},
 };
 
 SnapLayouterTest::SnapLayouterTest() {
@@ -261,6 +264,8 @@ SnapLayouterTest::SnapLayouterTest() {
 
     addInstancedTests({&SnapLayouterTest::updateDataOrder},
         Containers::arraySize(UpdateDataOrderData));
+
+    addTests({&SnapLayouterTest::updateIncremental});
 }
 
 void SnapLayouterTest::debugSnap() {
@@ -1104,6 +1109,23 @@ void SnapLayouterTest::updateDataOrder() {
     /* The size also */
     ui.setSize({500, 400});
 
+    /* With an executor the layouts get split into independent groups. Run
+       them in a reverse order to verify the groups really don't depend on
+       each other. */
+    Int executorCalled = 0;
+    if(data.executor) {
+        layouter.setUpdateExecutor([](UnsignedInt count, void(*task)(void*, UnsignedInt), void* taskState, void* userData) {
+            /* layout1 is snapped to the UI, layout2 and layout3 to nodes that
+               aren't laid out, layout4 and layout5 depend on layout3 */
+            CORRADE_COMPARE(count, 3);
+            for(UnsignedInt i = count; i != 0; --i)
+                task(taskState, i - 1);
+            ++*static_cast<Int*>(userData);
+        }, &executorCalled);
+        CORRADE_VERIFY(layouter.updateExecutor());
+        CORRADE_COMPARE(layouter.updateExecutorUserData(), &executorCalled);
+    }
+
     /* Add a dummy second layouter because that's the easiest way verify the
        calculated node offsets / sizes */
     struct DummyLayouter: AbstractLayouter {
@@ -1152,6 +1174,62 @@ void SnapLayouterTest::updateDataOrder() {
     dummyLayouter.add(layout5);
     ui.update();
     CORRADE_COMPARE(dummyLayouter.called, 1);
+    CORRADE_COMPARE(executorCalled, data.executor ? 1 : 0);
+}
+
+void SnapLayouterTest::updateIncremental() {
+    struct Interface: AbstractUserInterface {
+        explicit Interface(NoCreateT): AbstractUserInterface{NoCreate} {}
+    } ui{NoCreate};
+    ui.setSize({500, 400});
+    SnapLayouter& layouter = ui.setLayouterInstance(Containers::pointer<SnapLayouter>(ui.createLayouter()));
+    CORRADE_COMPARE(layouter.calculatedLayoutCount(), 0);
+
+    /* Two layouts snapped to the UI, one with a child snapped inside it and a
+       sibling snapped to the child */
+    AbstractAnchor panel = Ui::snap(ui, layouter, Snap::Left, {100.0f, 300.0f});
+    AbstractAnchor child = Ui::snap(ui, layouter, Snap::Top|Snap::Inside, panel, {80.0f, 20.0f});
+    AbstractAnchor sibling = Ui::snap(ui, layouter, Snap::Bottom, child, {80.0f, 20.0f});
+    AbstractAnchor other = Ui::snap(ui, layouter, Snap::Right, {50.0f, 50.0f});
+
+    /* Initially everything is calculated */
+    ui.update();
+    CORRADE_COMPARE(layouter.calculatedLayoutCount(), 4);
+
+    /* Changing a node that nothing snaps to recalculates just it */
+    ui.setNodeSize(other, {60.0f, 60.0f});
+    ui.update();
+    CORRADE_COMPARE(layouter.calculatedLayoutCount(), 1);
+
+    /* Changing a node in the middle of the chain recalculates it and what's
+       snapped to it, but not the parent */
+    ui.setNodeSize(child, {80.0f, 30.0f});
+    ui.update();
+    CORRADE_COMPARE(layouter.calculatedLayoutCount(), 2);
+
+    /* Changing the parent offset recalculates just the parent, as the child
+       is positioned relative to it and depends only on its size */
+    ui.setNodeOffset(panel, {5.0f, 0.0f});
+    ui.update();
+    CORRADE_COMPARE(layouter.calculatedLayoutCount(), 1);
+
+    /* Changing the parent size recalculates the child and transitively also
+       the sibling snapped to it */
+    ui.setNodeSize(panel, {120.0f, 300.0f});
+    ui.update();
+    CORRADE_COMPARE(layouter.calculatedLayoutCount(), 3);
+
+    /* Changing the padding recalculates everything */
+    layouter.setPadding(2.0f);
+    ui.update();
+    CORRADE_COMPARE(layouter.calculatedLayoutCount(), 4);
+
+    /* Changing the UI size recalculates just the two layouts snapped to the
+       UI. The panel size doesn't change, so the child and the sibling
+       snapped to it aren't recalculated. */
+    ui.setSize({600, 400});
+    ui.update();
+    CORRADE_COMPARE(layouter.calculatedLayoutCount(), 2);
 }
 
 }}}}
@@ -0,0 +1,498 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <sstream>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/BitArray.h>
+#include <Corrade/Containers/BitArrayView.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/StringStl.h> /** @todo remove once Debug is stream-free */
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/String.h>
+#include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+#include <Magnum/Math/Vector4.h>
+
+#include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/StackLayouter.h"
+
+namespace Magnum { namespace Ui { namespace Test { namespace {
+
+struct StackLayouterTest: TestSuite::Tester {
+    explicit StackLayouterTest();
+
+    void debugDirection();
+    void debugDirectionPacked();
+
+    void construct();
+    void constructCopy();
+    void constructMove();
+
+    void setDirection();
+    void setPadding();
+    void setSpacing();
+    void setCrossAxisFill();
+    void setSize();
+
+    void addRemove();
+    void addInvalid();
+    void removeInvalid();
+    void clean();
+
+    void update();
+};
+
+const struct {
+    const char* name;
+    StackDirection direction;
+    bool fill;
+    Vector2 expectedOffsets[5];
+    Vector2 expectedSizes[5];
+} UpdateData[]{
+    {"vertical", StackDirection::Vertical, false, {
+        {1.0f, 2.0f},
+        {1.0f, 17.0f},
+        {1.0f, 2.0f},
+        {1.5f, 13.25f},
+        {}
+    }, {
+        {30.0f, 10.0f},
+        {40.0f, 20.0f},
+        {5.0f, 6.0f},
+        {7.0f, 8.0f},
+        {1.0f, 1.0f}
+    }},
+    {"vertical, cross axis fill", StackDirection::Vertical, true, {
+        {1.0f, 2.0f},
+        {1.0f, 17.0f},
+        {1.0f, 2.0f},
+        {1.5f, 13.25f},
+        {}
+    }, {
+        {96.0f, 10.0f},
+        {96.0f, 20.0f},
+        {92.0f, 6.0f},
+        {92.0f, 8.0f},
+        {1.0f, 1.0f}
+    }},
+    {"horizontal", StackDirection::Horizontal, false, {
+        {1.0f, 2.0f},
+        {36.0f, 2.0f},
+        {1.0f, 2.0f},
+        {11.5f, 2.25f},
+        {}
+    }, {
+        {30.0f, 10.0f},
+        {40.0f, 20.0f},
+        {5.0f, 6.0f},
+        {7.0f, 8.0f},
+        {1.0f, 1.0f}
+    }},
+    {"horizontal, cross axis fill", StackDirection::Horizontal, true, {
+        {1.0f, 2.0f},
+        {36.0f, 2.0f},
+        {1.0f, 2.0f},
+        {11.5f, 2.25f},
+        {}
+    }, {
+        {30.0f, 74.0f},
+        {40.0f, 74.0f},
+        {5.0f, 68.0f},
+        {7.0f, 68.0f},
+        {1.0f, 1.0f}
+    }},
+};
+
+StackLayouterTest::StackLayouterTest() {
+    addTests({&StackLayouterTest::debugDirection,
+              &StackLayouterTest::debugDirectionPacked,
+
+              &StackLayouterTest::construct,
+              &StackLayouterTest::constructCopy,
+              &StackLayouterTest::constructMove,
+
+              &StackLayouterTest::setDirection,
+              &StackLayouterTest::setPadding,
+              &StackLayouterTest::setSpacing,
+              &StackLayouterTest::setCrossAxisFill,
+              &StackLayouterTest::setSize,
+
+              &StackLayouterTest::addRemove,
+              &StackLayouterTest::addInvalid,
+              &StackLayouterTest::removeInvalid,
+              &StackLayouterTest::clean});
+
+    addInstancedTests({&StackLayouterTest::update},
+        Containers::arraySize(UpdateData));
+}
+
+void StackLayouterTest::debugDirection() {
+    std::ostringstream out;
+    Debug{&out} << StackDirection::Horizontal << StackDirection(0xbe);
+    CORRADE_COMPARE(out.str(), "Ui::StackDirection::Horizontal Ui::StackDirection(0xbe)\n");
+}
+
+void StackLayouterTest::debugDirectionPacked() {
+    std::ostringstream out;
+    /* Last is not packed, ones before should not make any flags persistent */
+    Debug{&out} << Debug::packed << StackDirection::Horizontal << Debug::packed << StackDirection(0xbe) << StackDirection::Vertical;
+    CORRADE_COMPARE(out.str(), "Horizontal 0xbe Ui::StackDirection::Vertical\n");
+}
+
+void StackLayouterTest::construct() {
+    StackLayouter layouter{layouterHandle(0xab, 0x12)};
+    CORRADE_COMPARE(layouter.handle(), layouterHandle(0xab, 0x12));
+    CORRADE_COMPARE(layouter.direction(), StackDirection::Vertical);
+    CORRADE_COMPARE(layouter.padding(), Vector4{});
+    CORRADE_COMPARE(layouter.spacing(), 0.0f);
+    CORRADE_VERIFY(!layouter.crossAxisFill());
+}
+
+void StackLayouterTest::constructCopy() {
+    CORRADE_VERIFY(!std::is_copy_constructible<StackLayouter>{});
+    CORRADE_VERIFY(!std::is_copy_assignable<StackLayouter>{});
+}
+
+void StackLayouterTest::constructMove() {
+    StackLayouter a{layouterHandle(0xab, 0x12)};
+    a.setPadding(1.0f);
+    a.setSpacing(3.0f);
+
+    StackLayouter b{Utility::move(a)};
+    CORRADE_COMPARE(b.handle(), layouterHandle(0xab, 0x12));
+    CORRADE_COMPARE(b.padding(), Vector4{1.0f});
+    CORRADE_COMPARE(b.spacing(), 3.0f);
+
+    StackLayouter c{layouterHandle(3, 5)};
+    c = Utility::move(b);
+    CORRADE_COMPARE(c.handle(), layouterHandle(0xab, 0x12));
+    CORRADE_COMPARE(c.padding(), Vector4{1.0f});
+    CORRADE_COMPARE(c.spacing(), 3.0f);
+
+    CORRADE_VERIFY(std::is_nothrow_move_constructible<StackLayouter>::value);
+    CORRADE_VERIFY(std::is_nothrow_move_assignable<StackLayouter>::value);
+}
+
+void StackLayouterTest::setDirection() {
+    StackLayouter layouter{layouterHandle(0, 1)};
+    CORRADE_COMPARE(layouter.state(), LayouterStates{});
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layouter.setSize({1, 1});
+
+    /* Clear the state flags */
+    layouter.update({}, {}, {}, {}, {});
+    CORRADE_COMPARE(layouter.state(), LayouterStates{});
+
+    layouter.setDirection(StackDirection::Horizontal);
+    CORRADE_COMPARE(layouter.direction(), StackDirection::Horizontal);
+    CORRADE_COMPARE(layouter.state(), LayouterState::NeedsUpdate);
+}
+
+void StackLayouterTest::setPadding() {
+    StackLayouter layouter{layouterHandle(0, 1)};
+    CORRADE_COMPARE(layouter.padding(), Vector4{});
+    CORRADE_COMPARE(layouter.state(), LayouterStates{});
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layouter.setSize({1, 1});
+
+    /* Each side separately */
+    layouter.setPadding({1.0f, 3.0f, 2.0f, 4.0f});
+    CORRADE_COMPARE(layouter.padding(), (Vector4{1.0f, 3.0f, 2.0f, 4.0f}));
+    CORRADE_COMPARE(layouter.state(), LayouterState::NeedsUpdate);
+
+    /* Clear the state flags */
+    layouter.update({}, {}, {}, {}, {});
+    CORRADE_COMPARE(layouter.state(), LayouterStates{});
+
+    /* Horizontal and vertical */
+    layouter.setPadding({1.0f, 3.0f});
+    CORRADE_COMPARE(layouter.padding(), (Vector4{1.0f, 3.0f, 1.0f, 3.0f}));
+    CORRADE_COMPARE(layouter.state(), LayouterState::NeedsUpdate);
+
+    /* Clear the state flags */
+    layouter.update({}, {}, {}, {}, {});
+    CORRADE_COMPARE(layouter.state(), LayouterStates{});
+
+    /* All sides the same */
+    layouter.setPadding(1.0f);
+    CORRADE_COMPARE(layouter.padding(), Vector4{1.0f});
+    CORRADE_COMPARE(layouter.state(), LayouterState::NeedsUpdate);
+}
+
+void StackLayouterTest::setSpacing() {
+    StackLayouter layouter{layouterHandle(0, 1)};
+    CORRADE_COMPARE(layouter.state(), LayouterStates{});
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layouter.setSize({1, 1});
+
+    /* Clear the state flags */
+    layouter.update({}, {}, {}, {}, {});
+    CORRADE_COMPARE(layouter.state(), LayouterStates{});
+
+    layouter.setSpacing(2.5f);
+    CORRADE_COMPARE(layouter.spacing(), 2.5f);
+    CORRADE_COMPARE(layouter.state(), LayouterState::NeedsUpdate);
+}
+
+void StackLayouterTest::setCrossAxisFill() {
+    StackLayouter layouter{layouterHandle(0, 1)};
+    CORRADE_COMPARE(layouter.state(), LayouterStates{});
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layouter.setSize({1, 1});
+
+    /* Clear the state flags */
+    layouter.update({}, {}, {}, {}, {});
+    CORRADE_COMPARE(layouter.state(), LayouterStates{});
+
+    layouter.setCrossAxisFill(true);
+    CORRADE_VERIFY(layouter.crossAxisFill());
+    CORRADE_COMPARE(layouter.state(), LayouterState::NeedsUpdate);
+}
+
+void StackLayouterTest::setSize() {
+    StackLayouter layouter{layouterHandle(0, 1)};
+    layouter.setSize({1, 1});
+
+    /* Clear the state flags */
+    layouter.update({}, {}, {}, {}, {});
+    CORRADE_COMPARE(layouter.state(), LayouterStates{});
+
+    /* Without cross axis fill the layouts don't depend on the UI size, so
+       setting it doesn't trigger an update */
+    layouter.setSize({100.0f, 80.0f});
+    CORRADE_COMPARE(layouter.state(), LayouterStates{});
+
+    /* With cross axis fill it does */
+    layouter.setCrossAxisFill(true);
+    layouter.update({}, {}, {}, {}, {});
+    CORRADE_COMPARE(layouter.state(), LayouterStates{});
+
+    layouter.setSize({120.0f, 80.0f});
+    CORRADE_COMPARE(layouter.state(), LayouterState::NeedsUpdate);
+}
+
+/* Updates all valid layouts in the layouter and returns the Y offsets of
+   the four root nodes, which have heights 1, 2, 4 and 8 */
+Containers::Array<Float> stackedOffsets(StackLayouter& layouter) {
+    Containers::BitArray layoutIdsToUpdate{ValueInit, layouter.capacity()};
+    for(std::size_t i = 0; i != layouter.capacity(); ++i)
+        if(layouter.nodes()[i] != NodeHandle::Null)
+            layoutIdsToUpdate.set(i);
+
+    const NodeHandle nodeParents[4]{};
+    Vector2 nodeOffsets[4]{};
+    Vector2 nodeSizes[]{
+        {1.0f, 1.0f},
+        {1.0f, 2.0f},
+        {1.0f, 4.0f},
+        {1.0f, 8.0f},
+    };
+    layouter.update(layoutIdsToUpdate, {}, nodeParents, nodeOffsets, nodeSizes);
+
+    return Containers::Array<Float>{InPlaceInit, {
+        nodeOffsets[0].y(),
+        nodeOffsets[1].y(),
+        nodeOffsets[2].y(),
+        nodeOffsets[3].y()
+    }};
+}
+
+void StackLayouterTest::addRemove() {
+    StackLayouter layouter{layouterHandle(0, 1)};
+    layouter.setSize({100.0f, 100.0f});
+
+    LayoutHandle a = layouter.add(nodeHandle(0, 1));
+    LayoutHandle b = layouter.add(nodeHandle(1, 1));
+    /* Inserting before the first layout */
+    LayoutHandle c = layouter.add(nodeHandle(2, 1), a);
+    /* Inserting before the last layout */
+    LayoutHandle d = layouter.add(nodeHandle(3, 1), b);
+    CORRADE_COMPARE(layouter.usedCount(), 4);
+
+    /* The order is c, a, d, b */
+    CORRADE_COMPARE_AS(stackedOffsets(layouter), Containers::arrayView({
+        4.0f, 13.0f, 0.0f, 5.0f
+    }), TestSuite::Compare::Container);
+
+    /* Removing from the middle and the front, the order is now d, b. The
+       unused nodes keep a zero offset. */
+    layouter.remove(a);
+    layouter.remove(c);
+    CORRADE_COMPARE(layouter.usedCount(), 2);
+    CORRADE_COMPARE_AS(stackedOffsets(layouter), Containers::arrayView({
+        0.0f, 8.0f, 0.0f, 0.0f
+    }), TestSuite::Compare::Container);
+
+    /* Removing from the back, the order is now d */
+    layouter.remove(layoutHandleData(b));
+    CORRADE_COMPARE(layouter.usedCount(), 1);
+    CORRADE_COMPARE_AS(stackedOffsets(layouter), Containers::arrayView({
+        0.0f, 0.0f, 0.0f, 0.0f
+    }), TestSuite::Compare::Container);
+
+    /* Adding with recycled IDs before the only item and then at the end, the
+       order is now a2, d, b2 */
+    LayoutHandle a2 = layouter.add(nodeHandle(0, 1), d);
+    LayoutHandle b2 = layouter.add(nodeHandle(1, 1));
+    CORRADE_COMPARE(layouter.usedCount(), 3);
+    CORRADE_VERIFY(layouter.isHandleValid(a2));
+    CORRADE_VERIFY(layouter.isHandleValid(b2));
+    CORRADE_COMPARE_AS(stackedOffsets(layouter), Containers::arrayView({
+        0.0f, 9.0f, 0.0f, 1.0f
+    }), TestSuite::Compare::Container);
+
+    /* Removing everything and adding again works too */
+    layouter.remove(d);
+    layouter.remove(b2);
+    layouter.remove(a2);
+    CORRADE_COMPARE(layouter.usedCount(), 0);
+    layouter.add(nodeHandle(2, 1));
+    layouter.add(nodeHandle(1, 1));
+    CORRADE_COMPARE_AS(stackedOffsets(layouter), Containers::arrayView({
+        0.0f, 4.0f, 0.0f, 0.0f
+    }), TestSuite::Compare::Container);
+}
+
+void StackLayouterTest::addInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    StackLayouter layouter{layouterHandle(0, 1)};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    layouter.add(nodeHandle(0, 1), layoutHandle(layouter.handle(), 0xabcde, 0x123));
+    layouter.add(nodeHandle(0, 1), layoutHandle(LayouterHandle::Null, 0, 1));
+    CORRADE_COMPARE_AS(out.str(),
+        "Ui::StackLayouter::add(): invalid before handle Ui::LayoutHandle({0x0, 0x1}, {0xabcde, 0x123})\n"
+        "Ui::StackLayouter::add(): invalid before handle Ui::LayoutHandle(Null, {0x0, 0x1})\n",
+        TestSuite::Compare::String);
+}
+
+void StackLayouterTest::removeInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    StackLayouter layouter{layouterHandle(0, 1)};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    layouter.remove(LayoutHandle::Null);
+    layouter.remove(LayouterDataHandle::Null);
+    CORRADE_COMPARE_AS(out.str(),
+        "Ui::StackLayouter::remove(): invalid handle Ui::LayoutHandle::Null\n"
+        "Ui::StackLayouter::remove(): invalid handle Ui::LayouterDataHandle::Null\n",
+        TestSuite::Compare::String);
+}
+
+void StackLayouterTest::clean() {
+    StackLayouter layouter{layouterHandle(0, 1)};
+    layouter.setSize({100.0f, 100.0f});
+
+    layouter.add(nodeHandle(0, 1));
+    layouter.add(nodeHandle(1, 1));
+    layouter.add(nodeHandle(2, 1));
+    layouter.add(nodeHandle(3, 1));
+
+    /* Node 1 and 2 get removed, which should remove the layouts from the
+       stack as well */
+    UnsignedShort nodeHandleGenerations[]{1, 2, 2, 1};
+    layouter.cleanNodes(nodeHandleGenerations);
+    CORRADE_COMPARE(layouter.usedCount(), 2);
+    CORRADE_COMPARE_AS(stackedOffsets(layouter), Containers::arrayView({
+        0.0f, 0.0f, 0.0f, 1.0f
+    }), TestSuite::Compare::Container);
+}
+
+void StackLayouterTest::update() {
+    auto&& data = UpdateData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    StackLayouter layouter{layouterHandle(0, 1)};
+    layouter.setSize({100.0f, 80.0f});
+    layouter
+        /* left, top, right, bottom */
+        .setPadding({1.0f, 2.0f, 3.0f, 4.0f})
+        .setSpacing(5.0f)
+        .setDirection(data.direction)
+        .setCrossAxisFill(data.fill);
+
+    /* Node 0, 1 and 4 are top-level, node 2 and 3 are children of node 1.
+       Node 4 is not among the layouts to update, i.e. not visible, so it
+       doesn't take any space. Node 2 is added before node 3. */
+    LayoutHandle layout0 = layouter.add(nodeHandle(0, 1));
+    LayoutHandle layout1 = layouter.add(nodeHandle(1, 1));
+    LayoutHandle layout4 = layouter.add(nodeHandle(4, 1));
+    LayoutHandle layout3 = layouter.add(nodeHandle(3, 1));
+    LayoutHandle layout2 = layouter.add(nodeHandle(2, 1), layout3);
+    CORRADE_COMPARE(layoutHandleId(layout0), 0);
+    CORRADE_COMPARE(layoutHandleId(layout1), 1);
+    CORRADE_COMPARE(layoutHandleId(layout4), 2);
+    CORRADE_COMPARE(layoutHandleId(layout3), 3);
+    CORRADE_COMPARE(layoutHandleId(layout2), 4);
+
+    const NodeHandle nodeParents[]{
+        NodeHandle::Null,
+        NodeHandle::Null,
+        nodeHandle(1, 1),
+        nodeHandle(1, 1),
+        NodeHandle::Null,
+    };
+    /* The original offset should be added to the calculated one */
+    Vector2 nodeOffsets[]{
+        {},
+        {},
+        {},
+        {0.5f, 0.25f},
+        {},
+    };
+    Vector2 nodeSizes[]{
+        {30.0f, 10.0f},
+        {40.0f, 20.0f},
+        {5.0f, 6.0f},
+        {7.0f, 8.0f},
+        {1.0f, 1.0f},
+    };
+    /* Layout 2, i.e. for node 4, isn't updated */
+    const UnsignedByte layoutIdsToUpdate[]{0x1b};
+    layouter.update(Containers::BitArrayView{layoutIdsToUpdate, 0, 5}, {}, nodeParents, nodeOffsets, nodeSizes);
+    CORRADE_COMPARE_AS(Containers::arrayView(nodeOffsets),
+        Containers::arrayView(data.expectedOffsets),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(Containers::arrayView(nodeSizes),
+        Containers::arrayView(data.expectedSizes),
+        TestSuite::Compare::Container);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Ui::Test::StackLayouterTest)
@@ -24,26 +24,56 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <cstdio>
 #include <Corrade/Containers/BitArrayView.h>
 #include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Corrade/Containers/Reference.h>
 #include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/StringView.h>
 #include <Corrade/Utility/Arguments.h>
 #include <Magnum/Mesh.h>
 #include <Magnum/VertexFormat.h>
 #include <Magnum/DebugTools/ColorMap.h>
-#include <Magnum/DebugTools/FrameProfiler.h>
-#include <Magnum/GL/DefaultFramebuffer.h>
+#include <Magnum/GL/Buffer.h>
 #include <Magnum/GL/Mesh.h>
 #include <Magnum/Math/Matrix3.h>
 #include <Magnum/Math/Color.h>
 #include <Magnum/Math/ConfigurationValue.h>
+#include <Magnum/Shaders/FlatGL.h>
+
+#ifndef UI_STRESS_TEST_HEADLESS
+#include <Magnum/DebugTools/FrameProfiler.h>
+#include <Magnum/GL/DefaultFramebuffer.h>
 #ifdef CORRADE_TARGET_EMSCRIPTEN
 #include <Magnum/Platform/EmscriptenApplication.h>
 #else
 #include <Magnum/Platform/Sdl2Application.h>
 #endif
-#include <Magnum/Shaders/FlatGL.h>
+#else
+#include <algorithm> /* std::sort() */
+#include <chrono>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Utility/Format.h>
+#include <Corrade/Utility/Path.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Extensions.h>
+#include <Magnum/GL/Framebuffer.h>
+#include <Magnum/GL/Renderbuffer.h>
+#include <Magnum/GL/RenderbufferFormat.h>
+#include <Magnum/GL/TimeQuery.h>
+/* Same platform selection as in GL::OpenGLTester */
+#if defined(CORRADE_TARGET_APPLE) && !defined(MAGNUM_TARGET_EGL)
+#include <Magnum/Platform/WindowlessCglApplication.h>
+#elif defined(CORRADE_TARGET_UNIX) && (!defined(MAGNUM_TARGET_EGL) || defined(MAGNUM_TARGET_DESKTOP_GLES))
+#include <Magnum/Platform/WindowlessGlxApplication.h>
+#elif defined(CORRADE_TARGET_WINDOWS) && (!defined(MAGNUM_TARGET_GLES) || defined(MAGNUM_TARGET_DESKTOP_GLES))
+#include <Magnum/Platform/WindowlessWglApplication.h>
+#else
+#include <Magnum/Platform/WindowlessEglApplication.h>
+#endif
+#endif
 
 #include "Magnum/Ui/AbstractLayer.h"
 #include "Magnum/Ui/AbstractUserInterface.h"
@@ -51,24 +81,13 @@
 #include "Magnum/Ui/Handle.h"
 #include "Magnum/Ui/RendererGL.h"
 
-namespace Magnum { namespace Ui { namespace Test { namespace {
-
-class StressTest: public Platform::Application {
-    public:
-        explicit StressTest(const Arguments& arguments);
+/* The same file is built twice -- as an interactive application showing the
+   output in a window and FrameProfilerGL statistics in the console, and with
+   UI_STRESS_TEST_HEADLESS defined as a windowless application that runs a
+   given count of frames and prints per-phase timings as JSON or CSV, meant
+   to be used for performance regression tracking. */
 
-    private:
-        void drawEvent() override;
-
-        AbstractUserInterface _ui;
-        LayerHandle _firstLayer;
-        bool _triggerDataUpdate,
-            _triggerNodeClipUpdate,
-            _triggerNodeLayoutUpdate,
-            _triggerNodeUpdate;
-
-        DebugTools::FrameProfilerGL _profiler;
-};
+namespace Magnum { namespace Ui { namespace Test { namespace {
 
 using namespace Containers::Literals;
 using namespace Math::Literals;
@@ -78,6 +97,11 @@ class Layer: public AbstractLayer {
         explicit Layer(LayerHandle handle, bool skipVertexDataUpdate, bool skipIndexDataUpdate, bool events);
 
         DataHandle create(const Color4ub& color, NodeHandle node);
+        using AbstractLayer::remove;
+
+        Color4ub color(DataHandle handle) const {
+            return _colors[dataHandleId(handle)];
+        }
 
     private:
         LayerFeatures doFeatures() const override {
@@ -195,8 +219,21 @@ void Layer::doDraw(const Containers::StridedArrayView1D<const UnsignedInt>&, std
         .draw(_mesh);
 }
 
-StressTest::StressTest(const Arguments& arguments): Platform::Application{arguments, NoCreate}, _ui{NoCreate} {
-    Utility::Arguments args;
+/* Scenario options shared by both the interactive and the headless variant */
+struct Options {
+    Vector2ui size;
+    UnsignedInt count, depth, churn;
+    Float clip;
+    bool triggerDataUpdate,
+        triggerNodeClipUpdate,
+        triggerNodeLayoutUpdate,
+        triggerNodeUpdate;
+    bool skipVertexDataUpdate,
+        skipIndexDataUpdate,
+        advertiseEvents;
+};
+
+void addOptions(Utility::Arguments& args) {
     args.addSkippedPrefix("magnum", "engine-specific options")
         .addBooleanOption("data-update").setHelp("data-update", "trigger NeedsDataUpdate every frame")
         /** @todo drop once there's a distinction between data, position and
@@ -211,40 +248,64 @@ StressTest::StressTest(const Arguments& arguments): Platform::Application{argume
         /** @todo other triggers */
         .addOption("size", "1000 1000").setHelp("size", "node grid size")
         .addOption("count", "1").setHelp("count", "count of data per node")
-        .parse(arguments.argc, arguments.argv);
+        .addOption("depth", "1").setHelp("depth", "count of nested child nodes under each grid node")
+        .addOption("churn", "0").setHelp("churn", "count of data removed and recreated every frame");
+}
 
-    _triggerDataUpdate = args.isSet("data-update");
-    _triggerNodeClipUpdate = args.isSet("node-clip-update");
-    _triggerNodeLayoutUpdate = args.isSet("node-layout-update");
-    _triggerNodeUpdate = args.isSet("node-update");
-    bool skipVertexDataUpdate = args.isSet("skip-vertex-data-update");
-    bool skipIndexDataUpdate = args.isSet("skip-index-data-update");
-    bool advertiseEvents = args.isSet("advertise-events");
+Options parseOptions(const Utility::Arguments& args) {
+    Options options;
+    options.triggerDataUpdate = args.isSet("data-update");
+    options.triggerNodeClipUpdate = args.isSet("node-clip-update");
+    options.triggerNodeLayoutUpdate = args.isSet("node-layout-update");
+    options.triggerNodeUpdate = args.isSet("node-update");
+    options.skipVertexDataUpdate = args.isSet("skip-vertex-data-update");
+    options.skipIndexDataUpdate = args.isSet("skip-index-data-update");
+    options.advertiseEvents = args.isSet("advertise-events");
+    options.clip = args.value<Float>("clip");
+
+    options.size = args.value<Vector2ui>("size");
+    options.depth = args.value<UnsignedInt>("depth");
+    const std::size_t nodeCount = std::size_t(options.size.x()/2)*options.size.y()*(1 + options.depth);
+    if(nodeCount > 1000000)
+        Fatal{} << "At most a million nodes is allowed, got" << nodeCount << "for a grid of" << options.size << "and depth" << options.depth;
+
+    options.count = args.value<UnsignedInt>("count");
+    if(options.count > 128)
+        Fatal{} << "At most 128 layers is allowed, got" << options.count;
+
+    options.churn = args.value<UnsignedInt>("churn");
+
+    return options;
+}
 
-    const Vector2ui size = args.value<Vector2ui>("size");
-    if(size.product() > 1000000)
-        Fatal{} << "At most a million nodes is allowed, got" << size;
+/* The UI with all nodes and data, and per-frame triggers of the updates */
+class Scene {
+    public:
+        explicit Scene(const Options& options, const Vector2& windowSize, const Vector2i& framebufferSize);
 
-    const UnsignedInt count = args.value<UnsignedInt>("count");
-    if(count > 128)
-        Fatal{} << "At most 128 layers is allowed, got" << count;
+        AbstractUserInterface& ui() { return _ui; }
 
-    create(Configuration{}
-        .setTitle("Magnum::Ui Stress Test"_s));
+        std::size_t dataCount() const { return _dataCount; }
 
-    _profiler = DebugTools::FrameProfilerGL{
-        DebugTools::FrameProfilerGL::Value::FrameTime|
-        DebugTools::FrameProfilerGL::Value::GpuDuration|
-        DebugTools::FrameProfilerGL::Value::CpuDuration, 50};
+        /* Performs the data churn and update triggers for a single frame */
+        void trigger();
 
+    private:
+        const Options& _options;
+        AbstractUserInterface _ui;
+        Containers::Array<Containers::Reference<Layer>> _layers;
+        Containers::Array<DataHandle> _churnData;
+        std::size_t _churnOffset = 0;
+        std::size_t _dataCount = 0;
+};
+
+Scene::Scene(const Options& options, const Vector2& windowSize, const Vector2i& framebufferSize): _options(options), _ui{NoCreate} {
     _ui
-        .setSize(Vector2{size}*args.value<Float>("clip"), Vector2{windowSize()}, framebufferSize())
+        .setSize(Vector2{options.size}*options.clip, windowSize, framebufferSize)
         .setRendererInstance(Containers::pointer<Ui::RendererGL>());
 
-    Containers::Array<Containers::Reference<Layer>> layers;
-    for(UnsignedInt i = 0; i != count*2; ++i)
-        arrayAppend(layers,  _ui.setLayerInstance(Containers::pointer<Layer>(_ui.createLayer(), skipVertexDataUpdate, skipIndexDataUpdate, advertiseEvents)));
-    _firstLayer = layers[0]->handle();
+    for(UnsignedInt i = 0; i != options.count*2; ++i)
+        arrayAppend(_layers, _ui.setLayerInstance(Containers::pointer<Layer>(_ui.createLayer(), options.skipVertexDataUpdate, options.skipIndexDataUpdate, options.advertiseEvents)));
 
     const Containers::StaticArrayView<256, const Vector3ub> colors = DebugTools::ColorMap::turbo();
 
@@ -252,25 +313,89 @@ StressTest::StressTest(const Arguments& arguments): Platform::Application{argume
     NodeHandle view = _ui.createNode(window, {}, _ui.size());
 
     UnsignedInt i = 0;
-    for(UnsignedInt y = 0; y != size.y(); ++y) {
-        for(UnsignedInt x = 0; x != size.x()/2; ++x) {
+    for(UnsignedInt y = 0; y != options.size.y(); ++y) {
+        for(UnsignedInt x = 0; x != options.size.x()/2; ++x) {
             NodeHandle node = _ui.createNode(view, {Float(x)*2, Float(y)}, {2.0f, 1.0f});
-            NodeHandle nodeSub = _ui.createNode(node, {0.0f, 0.0f}, {1.0f, 1.0f});
             Color4ub color = colors[(i*117) % colors.size()];
             ColorHsv hsv = color.toHsv();
-            for(UnsignedInt j = 0; j != count; ++j)
-                layers[j]->create(color, node);
-            for(UnsignedInt j = 0; j != count; ++j)
-                layers[count + j]->create(Color4ub::fromHsv({hsv.hue, hsv.saturation*0.25f, hsv.value}), nodeSub);
+            for(UnsignedInt j = 0; j != options.count; ++j) {
+                const DataHandle data = _layers[j]->create(color, node);
+                /* Data in the first layer are the ones getting churned */
+                if(j == 0 && options.churn)
+                    arrayAppend(_churnData, data);
+            }
+
+            NodeHandle parent = node;
+            for(UnsignedInt d = 0; d != options.depth; ++d) {
+                NodeHandle nodeSub = _ui.createNode(parent, {0.0f, 0.0f}, {1.0f, 1.0f});
+                for(UnsignedInt j = 0; j != options.count; ++j)
+                    _layers[options.count + j]->create(Color4ub::fromHsv({hsv.hue, hsv.saturation*0.25f, hsv.value}), nodeSub);
+                parent = nodeSub;
+            }
             ++i;
         }
     }
 
-    UnsignedInt capacity = 0;
-    for(UnsignedInt j = 0; j != count*2; ++j)
-        capacity += layers[j]->capacity();
+    for(UnsignedInt j = 0; j != options.count*2; ++j)
+        _dataCount += _layers[j]->capacity();
+}
+
+void Scene::trigger() {
+    /* Remove and recreate given count of data in the first layer, going over
+       all of them in a round-robin fashion */
+    if(!_churnData.isEmpty()) {
+        Layer& layer = *_layers[0];
+        for(UnsignedInt i = 0; i != _options.churn; ++i) {
+            DataHandle& data = _churnData[_churnOffset];
+            const NodeHandle node = layer.node(data);
+            const Color4ub color = layer.color(data);
+            layer.remove(data);
+            data = layer.create(color, node);
+            _churnOffset = (_churnOffset + 1) % _churnData.size();
+        }
+    }
+
+    NodeHandle node = nodeHandle(Math::min(std::size_t{56}, _ui.nodeCapacity() - 1), 1);
+    if(_options.triggerNodeUpdate)
+        _ui.setNodeFlags(node, ~_ui.nodeFlags(node));
+    if(_options.triggerNodeClipUpdate)
+        _ui.setNodeSize(nodeHandle(0, 1), _ui.nodeSize(nodeHandle(0, 1)));
+    if(_options.triggerNodeLayoutUpdate)
+        _ui.setNodeOffset(nodeHandle(0, 1), _ui.nodeOffset(nodeHandle(0, 1)));
+    if(_options.triggerDataUpdate)
+        _layers[0]->setNeedsUpdate(LayerState::NeedsDataUpdate);
+}
+
+#ifndef UI_STRESS_TEST_HEADLESS
+class StressTest: public Platform::Application {
+    public:
+        explicit StressTest(const Arguments& arguments);
+
+    private:
+        void drawEvent() override;
+
+        Options _options;
+        Containers::Pointer<Scene> _scene;
+        DebugTools::FrameProfilerGL _profiler;
+};
+
+StressTest::StressTest(const Arguments& arguments): Platform::Application{arguments, NoCreate} {
+    Utility::Arguments args;
+    addOptions(args);
+    args.parse(arguments.argc, arguments.argv);
+    _options = parseOptions(args);
+
+    create(Configuration{}
+        .setTitle("Magnum::Ui Stress Test"_s));
+
+    _profiler = DebugTools::FrameProfilerGL{
+        DebugTools::FrameProfilerGL::Value::FrameTime|
+        DebugTools::FrameProfilerGL::Value::GpuDuration|
+        DebugTools::FrameProfilerGL::Value::CpuDuration, 50};
+
+    _scene.emplace(_options, Vector2{windowSize()}, framebufferSize());
 
-    Debug{} << _ui.nodeCapacity() << "nodes total," << capacity << "data attachments";
+    Debug{} << _scene->ui().nodeCapacity() << "nodes total," << _scene->dataCount() << "data attachments";
 
     #ifndef CORRADE_TARGET_EMSCRIPTEN
     setSwapInterval(0);
@@ -282,17 +407,8 @@ void StressTest::drawEvent() {
 
     _profiler.beginFrame();
 
-    NodeHandle node = nodeHandle(Math::min(std::size_t{56}, _ui.nodeCapacity() - 1), 1);
-    if(_triggerNodeUpdate)
-        _ui.setNodeFlags(node, ~_ui.nodeFlags(node));
-    else if(_triggerNodeClipUpdate)
-        _ui.setNodeSize(nodeHandle(0, 1), _ui.nodeSize(nodeHandle(0, 1)));
-    else if(_triggerNodeLayoutUpdate)
-        _ui.setNodeOffset(nodeHandle(0, 1), _ui.nodeOffset(nodeHandle(0, 1)));
-    else if(_triggerDataUpdate)
-        _ui.layer<Layer>(_firstLayer).setNeedsUpdate(LayerState::NeedsDataUpdate);
-
-    _ui.draw();
+    _scene->trigger();
+    _scene->ui().draw();
 
     _profiler.endFrame();
     _profiler.printStatistics(50);
@@ -300,7 +416,202 @@ void StressTest::drawEvent() {
     swapBuffers();
     redraw();
 }
+#else
+class StressTest: public Platform::WindowlessApplication {
+    public:
+        explicit StressTest(const Arguments& arguments);
+
+        int exec() override;
+
+    private:
+        Options _options;
+        Vector2i _framebufferSize;
+        UnsignedInt _frames, _warmup;
+        Containers::String _format, _output;
+};
+
+StressTest::StressTest(const Arguments& arguments): Platform::WindowlessApplication{arguments, NoCreate} {
+    Utility::Arguments args;
+    addOptions(args);
+    args.addOption("framebuffer-size", "1000 1000").setHelp("framebuffer-size", "size of the offscreen framebuffer")
+        .addOption("frames", "100").setHelp("frames", "count of measured frames")
+        .addOption("warmup", "10").setHelp("warmup", "count of frames to run before measuring")
+        .addOption("format", "json").setHelp("format", "output format, either json or csv")
+        .addOption("output").setHelp("output", "file to write the output to instead of standard output", "FILE")
+        .parse(arguments.argc, arguments.argv);
+    _options = parseOptions(args);
+
+    _framebufferSize = args.value<Vector2i>("framebuffer-size");
+    _frames = args.value<UnsignedInt>("frames");
+    _warmup = args.value<UnsignedInt>("warmup");
+    _format = args.value<Containers::StringView>("format");
+    _output = args.value<Containers::StringView>("output");
+    if(_format != "json"_s && _format != "csv"_s)
+        Fatal{} << "Expected either json or csv output format, got" << _format;
+
+    createContext();
+}
+
+/* Trigger, clean, update, draw and GPU time of a single frame, all in
+   microseconds. GPU time is negative if not available. */
+typedef Math::Vector<5, Double> FrameTimes;
+
+constexpr Containers::StringView PhaseNames[]{
+    "trigger"_s, "clean"_s, "update"_s, "draw"_s, "gpu"_s
+};
+
+template<class ...Args> void appendFormatted(Containers::Array<char>& out, const char* format, const Args&... args) {
+    const Containers::String formatted = Utility::format(format, args...);
+    arrayAppend(out, Containers::arrayView(formatted.data(), formatted.size()));
+}
+
+int StressTest::exec() {
+    #ifndef MAGNUM_TARGET_GLES2
+    constexpr GL::RenderbufferFormat format = GL::RenderbufferFormat::RGBA8;
+    #else
+    constexpr GL::RenderbufferFormat format = GL::RenderbufferFormat::RGBA4;
+    #endif
+    GL::Renderbuffer color;
+    color.setStorage(format, _framebufferSize);
+    GL::Framebuffer framebuffer{{{}, _framebufferSize}};
+    framebuffer
+        .attachRenderbuffer(GL::Framebuffer::ColorAttachment{0}, color)
+        .bind();
+
+    #ifndef MAGNUM_TARGET_GLES
+    const bool gpuTime = GL::Context::current().isExtensionSupported<GL::Extensions::ARB::timer_query>();
+    #else
+    const bool gpuTime = GL::Context::current().isExtensionSupported<GL::Extensions::EXT::disjoint_timer_query>();
+    #endif
+    GL::TimeQuery query{GL::TimeQuery::Target::TimeElapsed};
+
+    Scene scene{_options, Vector2{_framebufferSize}, _framebufferSize};
+    AbstractUserInterface& ui = scene.ui();
+
+    /* Each phase is measured separately. The clean() and update() are
+       implicitly called from draw() as well, calling them explicitly before
+       makes draw() measure just the draw itself. */
+    using Clock = std::chrono::steady_clock;
+    const auto microseconds = [](Clock::time_point begin, Clock::time_point end) {
+        return std::chrono::duration<Double, std::micro>(end - begin).count();
+    };
+    Containers::Array<FrameTimes> frames;
+    arrayReserve(frames, _frames);
+    for(UnsignedInt i = 0; i != _warmup + _frames; ++i) {
+        framebuffer.clear(GL::FramebufferClear::Color);
+
+        const Clock::time_point begin = Clock::now();
+        scene.trigger();
+        const Clock::time_point triggered = Clock::now();
+        ui.clean();
+        const Clock::time_point cleaned = Clock::now();
+        ui.update();
+        const Clock::time_point updated = Clock::now();
+        if(gpuTime) query.begin();
+        ui.draw();
+        if(gpuTime) query.end();
+        const Clock::time_point drawn = Clock::now();
+
+        if(i < _warmup) continue;
+
+        arrayAppend(frames, FrameTimes{
+            microseconds(begin, triggered),
+            microseconds(triggered, cleaned),
+            microseconds(cleaned, updated),
+            microseconds(updated, drawn),
+            /* Waits for the query result to be available */
+            gpuTime ? query.result<UnsignedLong>()/1000.0 : -1.0
+        });
+    }
+
+    Containers::Array<char> out;
+    if(_format == "csv"_s) {
+        appendFormatted(out, "frame,trigger,clean,update,draw,gpu\n");
+        for(std::size_t i = 0; i != frames.size(); ++i) {
+            const FrameTimes& times = frames[i];
+            appendFormatted(out, "{},{:.3f},{:.3f},{:.3f},{:.3f},", i, times[0], times[1], times[2], times[3]);
+            if(times[4] >= 0.0)
+                appendFormatted(out, "{:.3f}", times[4]);
+            appendFormatted(out, "\n");
+        }
+    } else {
+        appendFormatted(out,
+            "{{\n"
+            "  \"scenario\": {{\n"
+            "    \"size\": [{}, {}],\n"
+            "    \"count\": {},\n"
+            "    \"depth\": {},\n"
+            "    \"churn\": {},\n"
+            "    \"clip\": {},\n"
+            "    \"triggers\": [",
+            _options.size.x(), _options.size.y(),
+            _options.count, _options.depth, _options.churn, _options.clip);
+        const char* separator = "";
+        for(const Containers::Pair<bool, const char*>& trigger: {
+            Containers::pair(_options.triggerDataUpdate, "data-update"),
+            Containers::pair(_options.triggerNodeClipUpdate, "node-clip-update"),
+            Containers::pair(_options.triggerNodeLayoutUpdate, "node-layout-update"),
+            Containers::pair(_options.triggerNodeUpdate, "node-update")
+        }) {
+            if(!trigger.first()) continue;
+            appendFormatted(out, "{}\"{}\"", separator, trigger.second());
+            separator = ", ";
+        }
+        appendFormatted(out,
+            "],\n"
+            "    \"frames\": {},\n"
+            "    \"warmup\": {}\n"
+            "  }},\n"
+            "  \"nodes\": {},\n"
+            "  \"data\": {},\n"
+            "  \"unit\": \"us\",\n"
+            "  \"phases\": {{",
+            _frames, _warmup, ui.nodeUsedCount(), scene.dataCount());
+
+        /* Min, median, mean and max for every phase */
+        Containers::Array<Double> sorted{NoInit, frames.size()};
+        for(std::size_t p = 0; p != Containers::arraySize(PhaseNames); ++p) {
+            appendFormatted(out, "{}\n    \"{}\": ", p ? "," : "", PhaseNames[p]);
+            if(frames.isEmpty() || frames[0][p] < 0.0) {
+                appendFormatted(out, "null");
+                continue;
+            }
+
+            Double sum = 0.0;
+            for(std::size_t i = 0; i != frames.size(); ++i) {
+                sorted[i] = frames[i][p];
+                sum += sorted[i];
+            }
+            std::sort(sorted.begin(), sorted.end());
+            appendFormatted(out, "{{\"min\": {:.3f}, \"median\": {:.3f}, \"mean\": {:.3f}, \"max\": {:.3f}}}",
+                sorted.front(), sorted[sorted.size()/2], sum/sorted.size(), sorted.back());
+        }
+
+        appendFormatted(out, "\n  }},\n  \"frames\": [");
+        for(std::size_t i = 0; i != frames.size(); ++i) {
+            const FrameTimes& times = frames[i];
+            appendFormatted(out, "{}\n    [{:.3f}, {:.3f}, {:.3f}, {:.3f}, ", i ? "," : "", times[0], times[1], times[2], times[3]);
+            if(times[4] >= 0.0)
+                appendFormatted(out, "{:.3f}]", times[4]);
+            else
+                appendFormatted(out, "null]");
+        }
+        appendFormatted(out, "\n  ]\n}}\n");
+    }
+
+    if(_output.isEmpty()) {
+        std::fwrite(out.data(), 1, out.size(), stdout);
+        return 0;
+    }
+
+    return Utility::Path::write(_output, out) ? 0 : 1;
+}
+#endif
 
 }}}}
 
+#ifndef UI_STRESS_TEST_HEADLESS
 MAGNUM_APPLICATION_MAIN(Magnum::Ui::Test::StressTest)
+#else
+MAGNUM_WINDOWLESSAPPLICATION_MAIN(Magnum::Ui::Test::StressTest)
+#endif
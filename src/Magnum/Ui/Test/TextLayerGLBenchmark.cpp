@@ -24,12 +24,15 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <Corrade/Containers/String.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Magnum/Image.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Extensions.h>
 #include <Magnum/GL/Framebuffer.h>
 #include <Magnum/GL/OpenGLTester.h>
 #include <Magnum/GL/Texture.h>
@@ -53,6 +56,12 @@ struct TextLayerGLBenchmark: GL::OpenGLTester {
     void teardown();
     void fragment();
 
+    void createRemove();
+    void setText();
+    void updateVertices();
+    void updateRecompaction();
+    void updateUpload();
+
     private:
         GL::Texture2D _color{NoCreate};
         GL::Framebuffer _framebuffer{NoCreate};
@@ -72,12 +81,138 @@ const struct {
     {"cursor quad, dynamic styles", 1, true, ""},
 };
 
+const struct {
+    const char* name;
+    std::size_t textSize;
+    UnsignedInt shapeCacheSize;
+} CreateRemoveData[]{
+    {"1 byte", 1, 0},
+    {"16 bytes", 16, 0},
+    {"256 bytes", 256, 0},
+    {"16 bytes, shape cache", 16, 16},
+    {"256 bytes, shape cache", 256, 16},
+};
+
+const struct {
+    const char* name;
+    std::size_t textSize;
+    bool glyphRunReuse;
+} SetTextData[]{
+    {"16 bytes", 16, false},
+    {"16 bytes, glyph run reuse", 16, true},
+    {"256 bytes", 256, false},
+    {"256 bytes, glyph run reuse", 256, true},
+};
+
+const struct {
+    const char* name;
+    UnsignedInt glyphCount;
+    bool instancedGlyphs;
+} UpdateVerticesData[]{
+    {"1k glyphs", 1000, false},
+    {"1k glyphs, instanced", 1000, true},
+    {"100k glyphs", 100000, false},
+    {"100k glyphs, instanced", 100000, true},
+};
+
+const struct {
+    const char* name;
+    bool glyphRunReuse;
+} UpdateRecompactionData[]{
+    {"", false},
+    {"glyph run reuse", true},
+};
+
+const struct {
+    const char* name;
+    bool instancedGlyphs;
+    bool vertexBufferStreaming;
+} UpdateUploadData[]{
+    {"", false, false},
+    {"instanced", true, false},
+    #ifndef MAGNUM_TARGET_GLES
+    {"vertex buffer streaming", false, true},
+    {"instanced, vertex buffer streaming", true, true},
+    #endif
+};
+
+/* Count of data the CPU-side benchmarks operate on, and count of glyphs in
+   each data in the vertex, recompaction and upload benchmarks */
+constexpr UnsignedInt DataCount = 1000;
+constexpr UnsignedInt GlyphsPerData = 100;
+
+/* Shaper producing one glyph for each byte, all advancing by one unit to
+   make the vertex data non-degenerate */
+struct BenchmarkShaper: Text::AbstractShaper {
+    using Text::AbstractShaper::AbstractShaper;
+
+    UnsignedInt doShape(Containers::StringView string, UnsignedInt, UnsignedInt, Containers::ArrayView<const Text::FeatureRange>) override {
+        return string.size();
+    }
+    void doGlyphIdsInto(const Containers::StridedArrayView1D<UnsignedInt>& ids) const override {
+        for(UnsignedInt& id: ids)
+            id = 0;
+    }
+    void doGlyphOffsetsAdvancesInto(const Containers::StridedArrayView1D<Vector2>& offsets, const Containers::StridedArrayView1D<Vector2>& advances) const override {
+        for(std::size_t i = 0; i != offsets.size(); ++i) {
+            offsets[i] = {};
+            advances[i] = {1.0f, 0.0f};
+        }
+    }
+    void doGlyphClustersInto(const Containers::StridedArrayView1D<UnsignedInt>& clusters) const override {
+        for(std::size_t i = 0; i != clusters.size(); ++i)
+            clusters[i] = i;
+    }
+};
+
+struct BenchmarkFont: Text::AbstractFont {
+    Text::FontFeatures doFeatures() const override { return {}; }
+    bool doIsOpened() const override { return _opened; }
+    Properties doOpenFile(Containers::StringView, Float size) override {
+        _opened = true;
+        return {size, 8.0f, -4.0f, 16.0f, 1};
+    }
+    void doClose() override { _opened = false; }
+
+    void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+    Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+    Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+    Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<BenchmarkShaper>(*this); }
+
+    bool _opened = false;
+};
+
 TextLayerGLBenchmark::TextLayerGLBenchmark() {
     addInstancedBenchmarks({&TextLayerGLBenchmark::fragment}, 10,
         Containers::arraySize(FragmentData),
         &TextLayerGLBenchmark::setup,
         &TextLayerGLBenchmark::teardown,
         BenchmarkType::GpuTime);
+
+    addInstancedBenchmarks({&TextLayerGLBenchmark::createRemove}, 10,
+        Containers::arraySize(CreateRemoveData),
+        &TextLayerGLBenchmark::setup,
+        &TextLayerGLBenchmark::teardown);
+
+    addInstancedBenchmarks({&TextLayerGLBenchmark::setText}, 10,
+        Containers::arraySize(SetTextData),
+        &TextLayerGLBenchmark::setup,
+        &TextLayerGLBenchmark::teardown);
+
+    addInstancedBenchmarks({&TextLayerGLBenchmark::updateVertices}, 10,
+        Containers::arraySize(UpdateVerticesData),
+        &TextLayerGLBenchmark::setup,
+        &TextLayerGLBenchmark::teardown);
+
+    addInstancedBenchmarks({&TextLayerGLBenchmark::updateRecompaction}, 10,
+        Containers::arraySize(UpdateRecompactionData),
+        &TextLayerGLBenchmark::setup,
+        &TextLayerGLBenchmark::teardown);
+
+    addInstancedBenchmarks({&TextLayerGLBenchmark::updateUpload}, 10,
+        Containers::arraySize(UpdateUploadData),
+        &TextLayerGLBenchmark::setup,
+        &TextLayerGLBenchmark::teardown);
 }
 
 constexpr Vector2i BenchmarkSize{2048, 2048};
@@ -221,6 +356,229 @@ void TextLayerGLBenchmark::fragment() {
     }
 }
 
+void TextLayerGLBenchmark::createRemove() {
+    auto&& data = CreateRemoveData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    BenchmarkFont font;
+    font.openFile({}, 16.0f);
+
+    Text::GlyphCacheGL cache{PixelFormat::R8Unorm, {32, 32}, {}};
+    cache.addGlyph(cache.addFont(font.glyphCount(), &font), 0, {}, {{}, {1, 1}});
+
+    TextLayerGL::Shared shared{TextLayer::Shared::Configuration{1}
+        .setShapeCacheSize(data.shapeCacheSize)};
+    shared.setGlyphCache(cache);
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {shared.addFont(font, 16.0f)},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
+
+    AbstractUserInterface ui{BenchmarkSize};
+    ui.setRendererInstance(Containers::pointer<RendererGL>());
+    TextLayerGL& layer = ui.setLayerInstance(Containers::pointer<TextLayerGL>(ui.createLayer(), shared));
+
+    const Containers::String text{DirectInit, data.textSize, 'a'};
+
+    /* The data aren't attached to any node to measure just the layer itself.
+       The update() afterwards recompacts the glyph data of the removed texts
+       so each iteration starts from the same state. */
+    DataHandle handles[DataCount];
+    CORRADE_BENCHMARK(10) {
+        for(DataHandle& handle: handles)
+            handle = layer.create(0, text, {});
+        for(DataHandle handle: handles)
+            layer.remove(handle);
+        ui.update();
+    }
+
+    CORRADE_COMPARE(layer.usedCount(), 0);
+}
+
+void TextLayerGLBenchmark::setText() {
+    auto&& data = SetTextData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    BenchmarkFont font;
+    font.openFile({}, 16.0f);
+
+    Text::GlyphCacheGL cache{PixelFormat::R8Unorm, {32, 32}, {}};
+    cache.addGlyph(cache.addFont(font.glyphCount(), &font), 0, {}, {{}, {1, 1}});
+
+    TextLayerGL::Shared shared{TextLayer::Shared::Configuration{1}
+        .setGlyphRunReuse(data.glyphRunReuse)};
+    shared.setGlyphCache(cache);
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {shared.addFont(font, 16.0f)},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
+
+    AbstractUserInterface ui{BenchmarkSize};
+    ui.setRendererInstance(Containers::pointer<RendererGL>());
+    TextLayerGL& layer = ui.setLayerInstance(Containers::pointer<TextLayerGL>(ui.createLayer(), shared));
+
+    /* Two texts of the same size to alternate between. The shape cache isn't
+       enabled to measure the actual shaping and layouting. */
+    const Containers::String texts[]{
+        Containers::String{DirectInit, data.textSize, 'a'},
+        Containers::String{DirectInit, data.textSize, 'b'},
+    };
+
+    DataHandle handles[DataCount];
+    for(DataHandle& handle: handles)
+        handle = layer.create(0, texts[0], {});
+    ui.update();
+
+    std::size_t iteration = 0;
+    CORRADE_BENCHMARK(10) {
+        ++iteration;
+        for(DataHandle handle: handles)
+            layer.setText(handle, texts[iteration & 1], {});
+        ui.update();
+    }
+
+    CORRADE_COMPARE(layer.glyphCount(handles[0]), UnsignedInt(data.textSize));
+}
+
+void TextLayerGLBenchmark::updateVertices() {
+    auto&& data = UpdateVerticesData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    BenchmarkFont font;
+    font.openFile({}, 16.0f);
+
+    Text::GlyphCacheGL cache{PixelFormat::R8Unorm, {32, 32}, {}};
+    cache.addGlyph(cache.addFont(font.glyphCount(), &font), 0, {}, {{}, {1, 1}});
+
+    TextLayerGL::Shared shared{TextLayer::Shared::Configuration{1}
+        .setInstancedGlyphs(data.instancedGlyphs)};
+    shared.setGlyphCache(cache);
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {shared.addFont(font, 16.0f)},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
+
+    AbstractUserInterface ui{BenchmarkSize};
+    ui.setRendererInstance(Containers::pointer<RendererGL>());
+    TextLayerGL& layer = ui.setLayerInstance(Containers::pointer<TextLayerGL>(ui.createLayer(), shared));
+
+    const Containers::String text{DirectInit, GlyphsPerData, 'a'};
+    NodeHandle node = ui.createNode({}, Vector2{BenchmarkSize});
+    for(UnsignedInt i = 0; i != data.glyphCount/GlyphsPerData; ++i)
+        layer.create(0, text, {}, node);
+    ui.update();
+
+    /* Moving the node causes the vertices of all glyphs to be regenerated,
+       but nothing to be reshaped */
+    std::size_t iteration = 0;
+    CORRADE_BENCHMARK(10) {
+        ++iteration;
+        ui.setNodeOffset(node, {Float(iteration & 1), 0.0f});
+        ui.update();
+    }
+
+    CORRADE_COMPARE(ui.state(), UserInterfaceStates{});
+}
+
+void TextLayerGLBenchmark::updateRecompaction() {
+    auto&& data = UpdateRecompactionData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    BenchmarkFont font;
+    font.openFile({}, 16.0f);
+
+    Text::GlyphCacheGL cache{PixelFormat::R8Unorm, {32, 32}, {}};
+    cache.addGlyph(cache.addFont(font.glyphCount(), &font), 0, {}, {{}, {1, 1}});
+
+    TextLayerGL::Shared shared{TextLayer::Shared::Configuration{1}
+        .setGlyphRunReuse(data.glyphRunReuse)};
+    shared.setGlyphCache(cache);
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {shared.addFont(font, 16.0f)},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
+
+    AbstractUserInterface ui{BenchmarkSize};
+    ui.setRendererInstance(Containers::pointer<RendererGL>());
+    TextLayerGL& layer = ui.setLayerInstance(Containers::pointer<TextLayerGL>(ui.createLayer(), shared));
+
+    /* The first text alternates between two sizes that both fit into the
+       same glyph run capacity. Without glyph run reuse each change appends a
+       new run and recompaction then moves glyphs of all other texts. */
+    const Containers::String texts[]{
+        Containers::String{DirectInit, GlyphsPerData, 'a'},
+        Containers::String{DirectInit, GlyphsPerData/2, 'b'},
+    };
+    DataHandle first = layer.create(0, texts[0], {});
+    for(UnsignedInt i = 1; i != DataCount; ++i)
+        layer.create(0, texts[0], {});
+    ui.update();
+
+    std::size_t iteration = 0;
+    CORRADE_BENCHMARK(10) {
+        ++iteration;
+        layer.setText(first, texts[iteration & 1], {});
+        ui.update();
+    }
+
+    CORRADE_COMPARE(layer.usedCount(), DataCount);
+}
+
+void TextLayerGLBenchmark::updateUpload() {
+    auto&& data = UpdateUploadData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    #ifndef MAGNUM_TARGET_GLES
+    if(data.vertexBufferStreaming && !GL::Context::current().isExtensionSupported<GL::Extensions::ARB::buffer_storage>())
+        CORRADE_SKIP(GL::Extensions::ARB::buffer_storage::string() << "is not supported.");
+    #endif
+
+    BenchmarkFont font;
+    font.openFile({}, 16.0f);
+
+    Text::GlyphCacheGL cache{PixelFormat::R8Unorm, {32, 32}, {}};
+    cache.addGlyph(cache.addFont(font.glyphCount(), &font), 0, {}, {{}, {1, 1}});
+
+    TextLayerGL::Shared shared{TextLayer::Shared::Configuration{1}
+        .setInstancedGlyphs(data.instancedGlyphs)};
+    shared.setGlyphCache(cache);
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {shared.addFont(font, 16.0f)},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
+
+    AbstractUserInterface ui{BenchmarkSize};
+    ui.setRendererInstance(Containers::pointer<RendererGL>());
+    TextLayerGL& layer = ui.setLayerInstance(Containers::pointer<TextLayerGL>(ui.createLayer(), shared));
+    #ifndef MAGNUM_TARGET_GLES
+    layer.setVertexBufferStreaming(data.vertexBufferStreaming);
+    #endif
+
+    const Containers::String text{DirectInit, GlyphsPerData, 'a'};
+    NodeHandle node = ui.createNode({}, Vector2{BenchmarkSize});
+    for(UnsignedInt i = 0; i != DataCount; ++i)
+        layer.create(0, text, {}, node);
+    ui.draw();
+
+    /* Moving the node causes all vertex data to be regenerated and uploaded
+       in the draw() that follows. Waiting for the GPU to finish to not have
+       the driver queue up uploads across iterations. */
+    std::size_t iteration = 0;
+    CORRADE_BENCHMARK(10) {
+        ++iteration;
+        ui.setNodeOffset(node, {Float(iteration & 1), 0.0f});
+        ui.draw();
+        GL::Renderer::finish();
+    }
+
+    MAGNUM_VERIFY_NO_GL_ERROR();
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Ui::Test::TextLayerGLBenchmark)
@@ -83,6 +83,7 @@ struct TextLayerGLTest: GL::OpenGLTester {
     void renderSetup();
     void renderTeardown();
     void render();
+    void renderCompactVertices();
     void renderEdgeSmoothness();
     void renderAlignmentPadding();
     void renderCustomColor();
@@ -845,6 +846,10 @@ TextLayerGLTest::TextLayerGLTest() {
         &TextLayerGLTest::renderSetup,
         &TextLayerGLTest::renderTeardown);
 
+    addTests({&TextLayerGLTest::renderCompactVertices},
+        &TextLayerGLTest::renderSetup,
+        &TextLayerGLTest::renderTeardown);
+
     addInstancedTests({&TextLayerGLTest::renderEdgeSmoothness},
         Containers::arraySize(RenderEdgeSmoothnessData),
         &TextLayerGLTest::renderSetup,
@@ -1202,6 +1207,63 @@ void TextLayerGLTest::render() {
         DebugTools::CompareImageToFile{_importerManager});
 }
 
+void TextLayerGLTest::renderCompactVertices() {
+    if(!(_fontManager.load("StbTrueTypeFont") & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP("StbTrueTypeFont plugin not found.");
+
+    /* Start with a different size to verify the compact vertices get
+       converted again after a size change */
+    AbstractUserInterface ui{Vector2{RenderSize}*2.0f, Vector2{RenderSize}, RenderSize};
+    ui.setRendererInstance(Containers::pointer<RendererGL>());
+
+    /* Opened in the constructor together with cache filling to circumvent
+       stb_truetype's extreme rasterization slowness */
+    CORRADE_VERIFY(_font && _font->isOpened());
+
+    TextLayerGL::Shared layerShared{TextLayer::Shared::Configuration{1}
+        .setCompactVertices(true)};
+    CORRADE_VERIFY(layerShared.hasCompactVertices());
+    layerShared.setGlyphCache(_fontGlyphCache);
+    FontHandle fontHandle = layerShared.addFont(*_font, 32.0f);
+    layerShared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}
+            .setColor(0x3bd267_rgbf)},
+        {fontHandle},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
+
+    LayerHandle layer = ui.createLayer();
+    ui.setLayerInstance(Containers::pointer<TextLayerGL>(layer, layerShared));
+
+    NodeHandle node = ui.createNode({8.0f, 8.0f}, {112.0f, 48.0f});
+    ui.layer<TextLayerGL>(layer).create(0, "Maggi", {}, node);
+    ui.draw();
+
+    /* Changing just the UI size doesn't regenerate the vertex data, but the
+       compact vertices have to be converted again for the new size */
+    _framebuffer.clear(GL::FramebufferClear::Color);
+    ui.setSize(Vector2{RenderSize}, Vector2{RenderSize}, RenderSize);
+    ui.draw();
+
+    MAGNUM_VERIFY_NO_GL_ERROR();
+
+    if(!(_importerManager.load("AnyImageImporter") & PluginManager::LoadState::Loaded) ||
+       !(_importerManager.load("StbImageImporter") & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP("AnyImageImporter / StbImageImporter plugins not found.");
+
+    #if defined(MAGNUM_TARGET_GLES) && !defined(MAGNUM_TARGET_WEBGL)
+    /* Same problem is with all builtin shaders, so this doesn't seem to be a
+       bug in the text layer shader code */
+    if(GL::Context::current().detectedDriver() & GL::Context::DetectedDriver::SwiftShader)
+        CORRADE_SKIP("UBOs with dynamically indexed arrays don't seem to work on SwiftShader, can't test.");
+    #endif
+    /* The fixed-point texture coordinates may cause minor differences in the
+       filtered output */
+    CORRADE_COMPARE_WITH(_framebuffer.read({{}, RenderSize}, {PixelFormat::RGBA8Unorm}),
+        Utility::Path::join(UI_TEST_DIR, "TextLayerTestFiles/colored.png"),
+        (DebugTools::CompareImageToFile{_importerManager, 1.0f, 0.01f}));
+}
+
 void TextLayerGLTest::renderEdgeSmoothness() {
     auto&& data = RenderEdgeSmoothnessData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
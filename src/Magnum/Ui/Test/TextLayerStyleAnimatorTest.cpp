@@ -892,14 +892,14 @@ void TextLayerStyleAnimatorTest::propertiesInvalid() {
     animator.selectionPaddings(AnimationHandle::Null);
     animator.selectionTextUniforms(AnimationHandle::Null);
     /* Valid animator, invalid data */
-    animator.easing(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
-    animator.uniforms(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
-    animator.paddings(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
-    animator.cursorUniforms(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
-    animator.cursorPaddings(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
-    animator.selectionUniforms(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
-    animator.selectionPaddings(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
-    animator.selectionTextUniforms(animationHandle(animator.handle(), AnimatorDataHandle(0x123abcde)));
+    animator.easing(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)));
+    animator.uniforms(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)));
+    animator.paddings(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)));
+    animator.cursorUniforms(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)));
+    animator.cursorPaddings(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)));
+    animator.selectionUniforms(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)));
+    animator.selectionPaddings(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)));
+    animator.selectionTextUniforms(animationHandle(animator.handle(), animatorDataHandle(0xabcde, 0x123)));
     /* Invalid animator, valid data */
     animator.easing(animationHandle(AnimatorHandle::Null, animationHandleData(handle)));
     animator.uniforms(animationHandle(AnimatorHandle::Null, animationHandleData(handle)));
@@ -910,14 +910,14 @@ void TextLayerStyleAnimatorTest::propertiesInvalid() {
     animator.selectionPaddings(animationHandle(AnimatorHandle::Null, animationHandleData(handle)));
     animator.selectionTextUniforms(animationHandle(AnimatorHandle::Null, animationHandleData(handle)));
     /* AnimatorDataHandle directly */
-    animator.easing(AnimatorDataHandle(0x123abcde));
-    animator.uniforms(AnimatorDataHandle(0x123abcde));
-    animator.paddings(AnimatorDataHandle(0x123abcde));
-    animator.cursorUniforms(AnimatorDataHandle(0x123abcde));
-    animator.cursorPaddings(AnimatorDataHandle(0x123abcde));
-    animator.selectionUniforms(AnimatorDataHandle(0x123abcde));
-    animator.selectionPaddings(AnimatorDataHandle(0x123abcde));
-    animator.selectionTextUniforms(AnimatorDataHandle(0x123abcde));
+    animator.easing(animatorDataHandle(0xabcde, 0x123));
+    animator.uniforms(animatorDataHandle(0xabcde, 0x123));
+    animator.paddings(animatorDataHandle(0xabcde, 0x123));
+    animator.cursorUniforms(animatorDataHandle(0xabcde, 0x123));
+    animator.cursorPaddings(animatorDataHandle(0xabcde, 0x123));
+    animator.selectionUniforms(animatorDataHandle(0xabcde, 0x123));
+    animator.selectionPaddings(animatorDataHandle(0xabcde, 0x123));
+    animator.selectionTextUniforms(animatorDataHandle(0xabcde, 0x123));
     CORRADE_COMPARE_AS(out.str(),
         "Ui::TextLayerStyleAnimator::easing(): invalid handle Ui::AnimationHandle::Null\n"
         "Ui::TextLayerStyleAnimator::uniforms(): invalid handle Ui::AnimationHandle::Null\n"
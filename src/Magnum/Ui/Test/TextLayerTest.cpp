@@ -24,12 +24,17 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <cstring>
 #include <new>
 #include <sstream> /** @todo remove once Debug is stream-free */
+#include <Corrade/Containers/BitArray.h>
 #include <Corrade/Containers/StridedBitArrayView.h>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Containers/String.h>
+#include <Corrade/Containers/Triple.h>
 #include <Corrade/Containers/StringStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
@@ -38,6 +43,8 @@
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/FormatStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+#include <Corrade/Utility/Unicode.h>
+#include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Math/Range.h>
 #include <Magnum/Text/AbstractGlyphCache.h>
@@ -45,6 +52,7 @@
 #include <Magnum/Text/Direction.h>
 #include <Magnum/Text/Feature.h>
 #include <Magnum/Text/Script.h>
+#include <Magnum/TextureTools/Atlas.h>
 
 #include "Magnum/Ui/AbstractUserInterface.h"
 #include "Magnum/Ui/Event.h"
@@ -108,6 +116,8 @@ struct TextLayerTest: TestSuite::Tester {
     void sharedSetGlyphCache();
     void sharedSetGlyphCacheAlreadySet();
     void sharedNoGlyphCache();
+    void sharedSerializeGlyphCache();
+    void sharedDeserializeGlyphCacheInvalid();
 
     void sharedAddFont();
     void sharedAddFontTakeOwnership();
@@ -118,6 +128,8 @@ struct TextLayerTest: TestSuite::Tester {
     void sharedAddInstancelessFontHasInstance();
     void sharedFontInvalidHandle();
     void sharedFontNoInstance();
+    void sharedFontFallbacks();
+    void sharedFontFallbacksInvalid();
 
     void sharedSetStyle();
     void sharedSetStyleImplicitFeatures();
@@ -160,6 +172,7 @@ struct TextLayerTest: TestSuite::Tester {
 
     void setCursor();
     void setCursorInvalid();
+    void cursorForPosition();
     void updateText();
     void updateTextInvalid();
     void editText();
@@ -168,11 +181,32 @@ struct TextLayerTest: TestSuite::Tester {
     void createSetTextTextProperties();
     void createSetTextTextPropertiesEditable();
     void createSetTextTextPropertiesEditableInvalid();
+    void createSetTextShapeCache();
+    void createSetTextShapeCacheSerialize();
+    void sharedDeserializeShapeCacheInvalid();
+    void createSetTextSimpleShaping();
+    void createSetTextFontFallbacks();
+    void createSetTextMultiLine();
+    void sharedMeasureText();
+    void sharedMeasureTextInvalid();
+    void createSetTextShaperPool();
+    void createSetTextDeferredShaping();
+    void createSetTextDeferredShapingEditable();
+    void createSetTextDeferredShapingBudget();
+    void createSetTextDeferredShapingConcurrentUpdate();
+    void createSetTextHibernate();
+    void createSetTextHibernateInvalid();
+    void createSetTextGlyphRunReuse();
+    void updateTextGlyphRunReuse();
+    void createSetTextOnDemandGlyphCacheFilling();
+    void glyphCacheUseCounts();
+    void glyphCacheUseCountsInvalid();
 
     void createSetUpdateTextFromLayerItself();
 
     void setColor();
     void setPadding();
+    void intrinsicSizes();
 
     void invalidHandle();
     void invalidFontHandle();
@@ -191,12 +225,18 @@ struct TextLayerTest: TestSuite::Tester {
     void updateAlignmentGlyph();
     void updatePadding();
     void updatePaddingGlyph();
+    void updateVertexUpdateRange();
+    void updateVertexUpdateRangeChunks();
+    void updateClipGlyphCulling();
+    void updateInstancedGlyphs();
+    void updateVertexExecutor();
     void updateNoStyleSet();
     void updateNoEditingStyleSet();
 
     void sharedNeedsUpdateStatePropagatedToLayers();
 
     void keyTextEvent();
+    void textInputEventBatching();
 };
 
 using namespace Math::Literals;
@@ -548,6 +588,14 @@ const struct {
     {"editable", TextDataFlag::Editable}
 };
 
+const struct {
+    const char* name;
+    bool instancedGlyphs;
+} UpdateVertexExecutorData[]{
+    {"", false},
+    {"instanced glyphs", true},
+};
+
 const struct {
     const char* name;
     UnsignedInt styleCount, dynamicStyleCount;
@@ -584,6 +632,32 @@ const struct {
         "vertical shape direction for an editable text is not implemented yet, sorry"},
 };
 
+/* Positions relative to the left edge of the text for
+   TextLayerTest::cursorForPosition(), with glyph edges at 0, 2, 4, 10, 12
+   and 14 */
+constexpr Float CursorForPositionPositions[]{
+    -5.0f, 0.5f, 1.5f, 2.9f, 6.5f, 7.5f, 11.0f, 13.5f, 20.0f
+};
+
+const struct {
+    const char* name;
+    Text::ShapeDirection direction;
+    Text::Alignment alignment;
+    Float textOffset, extraPaddingOffset;
+    UnsignedInt expected[Containers::arraySize(CursorForPositionPositions)];
+} CursorForPositionData[]{
+    {"LTR, left", Text::ShapeDirection::LeftToRight, Text::Alignment::LineLeft,
+        1.0f, 2.0f, {0, 0, 1, 1, 2, 3, 4, 5, 5}},
+    {"LTR, center", Text::ShapeDirection::LeftToRight, Text::Alignment::LineCenter,
+        4.0f, 1.0f, {0, 0, 1, 1, 2, 3, 4, 5, 5}},
+    {"LTR, right", Text::ShapeDirection::LeftToRight, Text::Alignment::LineRight,
+        7.0f, 0.0f, {0, 0, 1, 1, 2, 3, 4, 5, 5}},
+    {"RTL, left", Text::ShapeDirection::RightToLeft, Text::Alignment::LineLeft,
+        1.0f, 2.0f, {5, 5, 4, 4, 3, 2, 1, 0, 0}},
+    {"RTL, right", Text::ShapeDirection::RightToLeft, Text::Alignment::LineRight,
+        7.0f, 0.0f, {5, 5, 4, 4, 3, 2, 1, 0, 0}},
+};
+
 const struct {
     TestSuite::TestCaseDescriptionSourceLocation name;
     Text::ShapeDirection shapeDirection;
@@ -1249,6 +1323,8 @@ TextLayerTest::TextLayerTest() {
     addTests({&TextLayerTest::sharedSetGlyphCache,
               &TextLayerTest::sharedSetGlyphCacheAlreadySet,
               &TextLayerTest::sharedNoGlyphCache,
+              &TextLayerTest::sharedSerializeGlyphCache,
+              &TextLayerTest::sharedDeserializeGlyphCacheInvalid,
 
               &TextLayerTest::sharedAddFont,
               &TextLayerTest::sharedAddFontTakeOwnership,
@@ -1258,7 +1334,9 @@ TextLayerTest::TextLayerTest() {
               &TextLayerTest::sharedAddFontNoHandlesLeft,
               &TextLayerTest::sharedAddInstancelessFontHasInstance,
               &TextLayerTest::sharedFontInvalidHandle,
-              &TextLayerTest::sharedFontNoInstance});
+              &TextLayerTest::sharedFontNoInstance,
+              &TextLayerTest::sharedFontFallbacks,
+              &TextLayerTest::sharedFontFallbacksInvalid});
 
     addInstancedTests({&TextLayerTest::sharedSetStyle,
                        &TextLayerTest::sharedSetStyleImplicitFeatures,
@@ -1319,8 +1397,12 @@ TextLayerTest::TextLayerTest() {
         Containers::arraySize(CreateUpdateNoStyleSetData));
 
     addTests({&TextLayerTest::setCursor,
-              &TextLayerTest::setCursorInvalid,
-              &TextLayerTest::updateText,
+              &TextLayerTest::setCursorInvalid});
+
+    addInstancedTests({&TextLayerTest::cursorForPosition},
+        Containers::arraySize(CursorForPositionData));
+
+    addTests({&TextLayerTest::updateText,
               &TextLayerTest::updateTextInvalid});
 
     addInstancedTests({&TextLayerTest::editText},
@@ -1337,10 +1419,32 @@ TextLayerTest::TextLayerTest() {
     addInstancedTests({&TextLayerTest::createSetTextTextPropertiesEditableInvalid},
         Containers::arraySize(CreateSetTextTextPropertiesEditableInvalidData));
 
+    addTests({&TextLayerTest::createSetTextShapeCache,
+              &TextLayerTest::createSetTextShapeCacheSerialize,
+              &TextLayerTest::sharedDeserializeShapeCacheInvalid,
+              &TextLayerTest::createSetTextSimpleShaping,
+              &TextLayerTest::createSetTextFontFallbacks,
+              &TextLayerTest::createSetTextMultiLine,
+              &TextLayerTest::sharedMeasureText,
+              &TextLayerTest::sharedMeasureTextInvalid,
+              &TextLayerTest::createSetTextShaperPool,
+              &TextLayerTest::createSetTextDeferredShaping,
+              &TextLayerTest::createSetTextDeferredShapingEditable,
+              &TextLayerTest::createSetTextDeferredShapingBudget,
+              &TextLayerTest::createSetTextDeferredShapingConcurrentUpdate,
+              &TextLayerTest::createSetTextHibernate,
+              &TextLayerTest::createSetTextHibernateInvalid,
+              &TextLayerTest::createSetTextGlyphRunReuse,
+              &TextLayerTest::updateTextGlyphRunReuse,
+              &TextLayerTest::createSetTextOnDemandGlyphCacheFilling,
+              &TextLayerTest::glyphCacheUseCounts,
+              &TextLayerTest::glyphCacheUseCountsInvalid});
+
     addRepeatedTests({&TextLayerTest::createSetUpdateTextFromLayerItself}, 10);
 
     addTests({&TextLayerTest::setColor,
               &TextLayerTest::setPadding,
+              &TextLayerTest::intrinsicSizes,
 
               &TextLayerTest::invalidHandle,
               &TextLayerTest::invalidFontHandle,
@@ -1364,6 +1468,14 @@ TextLayerTest::TextLayerTest() {
                        &TextLayerTest::updatePaddingGlyph},
         Containers::arraySize(UpdateAlignmentPaddingData));
 
+    addTests({&TextLayerTest::updateVertexUpdateRange,
+              &TextLayerTest::updateVertexUpdateRangeChunks,
+              &TextLayerTest::updateClipGlyphCulling,
+              &TextLayerTest::updateInstancedGlyphs});
+
+    addInstancedTests({&TextLayerTest::updateVertexExecutor},
+        Containers::arraySize(UpdateVertexExecutorData));
+
     addInstancedTests({&TextLayerTest::updateNoStyleSet,
                        &TextLayerTest::updateNoEditingStyleSet},
         Containers::arraySize(CreateUpdateNoStyleSetData));
@@ -1371,7 +1483,8 @@ TextLayerTest::TextLayerTest() {
     addInstancedTests({&TextLayerTest::sharedNeedsUpdateStatePropagatedToLayers},
         Containers::arraySize(SharedNeedsUpdateStatePropagatedToLayersData));
 
-    addTests({&TextLayerTest::keyTextEvent});
+    addTests({&TextLayerTest::keyTextEvent,
+              &TextLayerTest::textInputEventBatching});
 }
 
 using namespace Containers::Literals;
@@ -1652,8 +1765,8 @@ void TextLayerTest::debugDataFlag() {
 
 void TextLayerTest::debugDataFlags() {
     std::ostringstream out;
-    Debug{&out} << (TextDataFlag::Editable|TextDataFlag(0xa0)) << TextDataFlags{};
-    CORRADE_COMPARE(out.str(), "Ui::TextDataFlag::Editable|Ui::TextDataFlag(0xa0) Ui::TextDataFlags{}\n");
+    Debug{&out} << (TextDataFlag::Editable|TextDataFlag::DeferredShaping|TextDataFlag(0xa0)) << TextDataFlags{};
+    CORRADE_COMPARE(out.str(), "Ui::TextDataFlag::Editable|Ui::TextDataFlag::DeferredShaping|Ui::TextDataFlag(0xa0) Ui::TextDataFlags{}\n");
 }
 
 void TextLayerTest::debugEdit() {
@@ -1758,6 +1871,36 @@ void TextLayerTest::sharedConfigurationSetters() {
     CORRADE_COMPARE(zeroStyles.dynamicStyleCount(), 11);
     CORRADE_COMPARE(zeroStyles.hasEditingStyles(), false);
 
+    /* Shape cache is disabled by default */
+    CORRADE_COMPARE(configuration.shapeCacheSize(), 0);
+    configuration.setShapeCacheSize(256);
+    CORRADE_COMPARE(configuration.shapeCacheSize(), 256);
+
+    /* Glyph run reuse is disabled by default */
+    CORRADE_VERIFY(!configuration.hasGlyphRunReuse());
+    configuration.setGlyphRunReuse(true);
+    CORRADE_VERIFY(configuration.hasGlyphRunReuse());
+
+    /* Text input batching is disabled by default */
+    CORRADE_VERIFY(!configuration.hasTextInputBatching());
+    configuration.setTextInputBatching(true);
+    CORRADE_VERIFY(configuration.hasTextInputBatching());
+
+    /* Instanced glyphs are disabled by default */
+    CORRADE_VERIFY(!configuration.hasInstancedGlyphs());
+    configuration.setInstancedGlyphs(true);
+    CORRADE_VERIFY(configuration.hasInstancedGlyphs());
+
+    /* Distance field glyphs are disabled by default */
+    CORRADE_VERIFY(!configuration.hasDistanceFieldGlyphs());
+    configuration.setDistanceFieldGlyphs(true);
+    CORRADE_VERIFY(configuration.hasDistanceFieldGlyphs());
+
+    /* Compact vertices are disabled by default */
+    CORRADE_VERIFY(!configuration.hasCompactVertices());
+    configuration.setCompactVertices(true);
+    CORRADE_VERIFY(configuration.hasCompactVertices());
+
     zeroStyles.setDynamicStyleCount(11, true);
     CORRADE_COMPARE(zeroStyles.editingStyleCount(), 0);
     CORRADE_COMPARE(zeroStyles.dynamicStyleCount(), 11);
@@ -1812,6 +1955,8 @@ void TextLayerTest::sharedConstruct() {
     } shared{TextLayer::Shared::Configuration{3, 5}
         .setEditingStyleCount(2, 7)
         .setDynamicStyleCount(4)
+        .setDistanceFieldGlyphs(true)
+        .setCompactVertices(true)
     };
     CORRADE_COMPARE(shared.styleUniformCount(), 3);
     CORRADE_COMPARE(shared.styleCount(), 5);
@@ -1819,6 +1964,8 @@ void TextLayerTest::sharedConstruct() {
     CORRADE_COMPARE(shared.editingStyleCount(), 7);
     CORRADE_COMPARE(shared.dynamicStyleCount(), 4);
     CORRADE_VERIFY(shared.hasEditingStyles());
+    CORRADE_VERIFY(shared.hasDistanceFieldGlyphs());
+    CORRADE_VERIFY(shared.hasCompactVertices());
 
     CORRADE_VERIFY(!shared.hasGlyphCache());
 
@@ -1971,9 +2118,177 @@ void TextLayerTest::sharedNoGlyphCache() {
     shared.glyphCache();
     /* Const overload */
     const_cast<const Shared&>(shared).glyphCache();
+    shared.serializeGlyphCache();
+    shared.deserializeGlyphCache(nullptr);
     CORRADE_COMPARE(out.str(),
         "Ui::TextLayer::Shared::glyphCache(): no glyph cache set\n"
-        "Ui::TextLayer::Shared::glyphCache(): no glyph cache set\n");
+        "Ui::TextLayer::Shared::glyphCache(): no glyph cache set\n"
+        "Ui::TextLayer::Shared::serializeGlyphCache(): no glyph cache set\n"
+        "Ui::TextLayer::Shared::deserializeGlyphCache(): no glyph cache set\n");
+}
+
+void TextLayerTest::sharedSerializeGlyphCache() {
+    struct GlyphCache: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {
+            ++setImageCalled;
+        }
+
+        int setImageCalled = 0;
+    };
+
+    struct Shared: TextLayer::Shared {
+        explicit Shared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    };
+
+    /* Default padding is 1, resetting to 0 for simplicity */
+    GlyphCache sourceCache{PixelFormat::R8Unorm, {16, 16}, {}};
+    UnsignedInt sourceFont0 = sourceCache.addFont(4);
+    UnsignedInt sourceFont1 = sourceCache.addFont(10);
+    sourceCache.addGlyph(sourceFont1, 7, {1, 2}, {{2, 3}, {5, 5}});
+    sourceCache.addGlyph(sourceFont0, 3, {}, {{8, 0}, {9, 4}});
+    {
+        Containers::StridedArrayView3D<char> pixels = sourceCache.image().pixels()[0];
+        for(std::size_t y = 0; y != pixels.size()[0]; ++y)
+            for(std::size_t x = 0; x != pixels.size()[1]; ++x)
+                pixels[y][x][0] = char(y*16 + x);
+    }
+
+    Shared sourceShared{TextLayer::Shared::Configuration{1}};
+    sourceShared.setGlyphCache(sourceCache);
+    Containers::Array<char> data = sourceShared.serializeGlyphCache();
+    CORRADE_VERIFY(!data.isEmpty());
+
+    /* The destination already has a font, the deserialized ones are added
+       after */
+    GlyphCache cache{PixelFormat::R8Unorm, {16, 16}, {}};
+    cache.addFont(2);
+
+    Shared shared{TextLayer::Shared::Configuration{1}};
+    shared.setGlyphCache(cache);
+    Containers::Optional<UnsignedInt> firstFont = shared.deserializeGlyphCache(data);
+    CORRADE_VERIFY(firstFont);
+    CORRADE_COMPARE(*firstFont, 1);
+    CORRADE_COMPARE(cache.setImageCalled, 1);
+    CORRADE_COMPARE(cache.fontCount(), 3);
+    CORRADE_COMPARE(cache.fontGlyphCount(1), 4);
+    CORRADE_COMPARE(cache.fontGlyphCount(2), 10);
+    CORRADE_COMPARE(cache.glyphCount(), 3);
+
+    /* The glyphs keep their offset and size and the pixel data get copied to
+       wherever they got placed */
+    const Containers::StridedArrayView3D<const char> sourcePixels = sourceCache.image().pixels()[0];
+    const Containers::StridedArrayView3D<const char> pixels = cache.image().pixels()[0];
+    for(const Containers::Pair<UnsignedInt, UnsignedInt>& fontGlyph: {
+        Containers::pair(sourceFont1, 7u),
+        Containers::pair(sourceFont0, 3u)
+    }) {
+        CORRADE_ITERATION(fontGlyph.first(), fontGlyph.second());
+        const UnsignedInt sourceGlyphId = sourceCache.glyphId(fontGlyph.first(), fontGlyph.second());
+        const UnsignedInt glyphId = cache.glyphId(*firstFont + fontGlyph.first(), fontGlyph.second());
+        CORRADE_VERIFY(glyphId);
+
+        const Containers::Triple<Vector2i, Int, Range2Di> sourceGlyph = sourceCache.glyph(sourceGlyphId);
+        const Containers::Triple<Vector2i, Int, Range2Di> glyph = cache.glyph(glyphId);
+        CORRADE_COMPARE(glyph.first(), sourceGlyph.first());
+        CORRADE_COMPARE(glyph.second(), 0);
+        CORRADE_COMPARE(glyph.third().size(), sourceGlyph.third().size());
+        for(Int y = 0; y != glyph.third().sizeY(); ++y) {
+            for(Int x = 0; x != glyph.third().sizeX(); ++x) {
+                CORRADE_ITERATION(Vector2i{x, y});
+                CORRADE_COMPARE(
+                    Int(pixels[glyph.third().bottom() + y][glyph.third().left() + x][0]),
+                    Int(sourcePixels[sourceGlyph.third().bottom() + y][sourceGlyph.third().left() + x][0]));
+            }
+        }
+    }
+
+    /* The glyphs are known to the atlas, so a new glyph doesn't overlap
+       them */
+    Vector3i offset;
+    const Vector2i size{2, 2};
+    CORRADE_VERIFY(cache.atlas().add(Containers::stridedArrayView(&size, 1), Containers::stridedArrayView(&offset, 1)));
+    const Range2Di newGlyph = Range2Di::fromSize(offset.xy(), size);
+    for(UnsignedInt i = 1; i != cache.glyphCount(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_VERIFY(!Math::intersects(newGlyph, cache.glyph(i).third()));
+    }
+}
+
+void TextLayerTest::sharedDeserializeGlyphCacheInvalid() {
+    struct GlyphCache: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    };
+
+    struct Shared: TextLayer::Shared {
+        explicit Shared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    };
+
+    GlyphCache sourceCache{PixelFormat::R8Unorm, {16, 16}, {}};
+    sourceCache.addGlyph(sourceCache.addFont(4), 3, {}, {{8, 0}, {16, 16}});
+    Shared sourceShared{TextLayer::Shared::Configuration{1}};
+    sourceShared.setGlyphCache(sourceCache);
+    Containers::Array<char> data = sourceShared.serializeGlyphCache();
+
+    GlyphCache sourceCacheRG{PixelFormat::RG8Unorm, {16, 16}, {}};
+    Shared sourceSharedRG{TextLayer::Shared::Configuration{1}};
+    sourceSharedRG.setGlyphCache(sourceCacheRG);
+    Containers::Array<char> dataRG = sourceSharedRG.serializeGlyphCache();
+
+    Containers::Array<char> dataInvalidMagic{NoInit, data.size()};
+    Utility::copy(data, dataInvalidMagic);
+    dataInvalidMagic[0] = 'X';
+
+    /* The glyph is 8x16, which doesn't fit into a cache that has only 4
+       columns left */
+    GlyphCache cache{PixelFormat::R8Unorm, {16, 16}, {}};
+    {
+        Vector3i offset;
+        const Vector2i size{12, 16};
+        CORRADE_VERIFY(cache.atlas().add(Containers::stridedArrayView(&size, 1), Containers::stridedArrayView(&offset, 1)));
+    }
+    Shared shared{TextLayer::Shared::Configuration{1}};
+    shared.setGlyphCache(cache);
+
+    const Text::AbstractFont* fonts[2]{};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!shared.deserializeGlyphCache(data.prefix(19)));
+    CORRADE_VERIFY(!shared.deserializeGlyphCache(dataInvalidMagic));
+    CORRADE_VERIFY(!shared.deserializeGlyphCache(dataRG));
+    CORRADE_VERIFY(!shared.deserializeGlyphCache(data, fonts));
+    CORRADE_VERIFY(!shared.deserializeGlyphCache(data.prefix(24)));
+    CORRADE_VERIFY(!shared.deserializeGlyphCache(data.exceptSuffix(1)));
+    CORRADE_VERIFY(!shared.deserializeGlyphCache(data));
+    CORRADE_COMPARE_AS(out.str(),
+        "Ui::TextLayer::Shared::deserializeGlyphCache(): expected at least 20 bytes but got 19\n"
+        "Ui::TextLayer::Shared::deserializeGlyphCache(): invalid header\n"
+        "Ui::TextLayer::Shared::deserializeGlyphCache(): expected PixelFormat::R8Unorm data but got PixelFormat::RG8Unorm\n"
+        "Ui::TextLayer::Shared::deserializeGlyphCache(): expected 1 fonts but got 2\n"
+        "Ui::TextLayer::Shared::deserializeGlyphCache(): expected at least 48 bytes for 1 fonts and 1 glyphs but got 24\n"
+        "Ui::TextLayer::Shared::deserializeGlyphCache(): expected 176 bytes but got 175\n"
+        "Ui::TextLayer::Shared::deserializeGlyphCache(): cannot fit 1 glyphs into the glyph cache\n",
+        TestSuite::Compare::String);
+
+    /* Nothing got added to the cache */
+    CORRADE_COMPARE(cache.fontCount(), 0);
+    CORRADE_COMPARE(cache.glyphCount(), 1);
 }
 
 void TextLayerTest::sharedAddFont() {
@@ -2428,6 +2743,143 @@ void TextLayerTest::sharedFontNoInstance() {
     CORRADE_COMPARE(out.str(), "Ui::TextLayer::Shared::font(): Ui::FontHandle(0x1, 0x1) is an instance-less font\n");
 }
 
+void TextLayerTest::sharedFontFallbacks() {
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return _opened; }
+        Properties doOpenFile(Containers::StringView, Float size) override {
+            _opened = true;
+            return {size, 8.0f, -4.0f, 16.0f, 67};
+        }
+        void doClose() override { _opened = false; }
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return {}; }
+
+        bool _opened = false;
+    } font1, font2, font3;
+    font1.openFile({}, 16.0f);
+    font2.openFile({}, 16.0f);
+    font3.openFile({}, 8.0f);
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
+    cache.addFont(67, &font1);
+    cache.addFont(67, &font2);
+    cache.addFont(67, &font3);
+
+    struct Shared: TextLayer::Shared {
+        explicit Shared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{3, 5}};
+    shared.setGlyphCache(cache);
+
+    /* All three have the scale of 0.5 */
+    FontHandle first = shared.addFont(font1, 8.0f);
+    FontHandle second = shared.addFont(font2, 8.0f);
+    FontHandle third = shared.addFont(font3, 4.0f);
+    CORRADE_COMPARE(shared.fontFallbacks(first).size(), 0);
+
+    shared.setFontFallbacks(first, {third, second});
+    CORRADE_COMPARE_AS(shared.fontFallbacks(first), Containers::arrayView({
+        third, second
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(shared.fontFallbacks(second).size(), 0);
+
+    /* Setting them again replaces the previous */
+    shared.setFontFallbacks(first, {second});
+    CORRADE_COMPARE_AS(shared.fontFallbacks(first), Containers::arrayView({
+        second
+    }), TestSuite::Compare::Container);
+
+    /* Empty view removes them */
+    shared.setFontFallbacks(first, {});
+    CORRADE_COMPARE(shared.fontFallbacks(first).size(), 0);
+}
+
+void TextLayerTest::sharedFontFallbacksInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return _opened; }
+        Properties doOpenFile(Containers::StringView, Float size) override {
+            _opened = true;
+            return {size, 8.0f, -4.0f, 16.0f, 67};
+        }
+        void doClose() override { _opened = false; }
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return {}; }
+
+        bool _opened = false;
+    } font1, font2;
+    font1.openFile({}, 16.0f);
+    font2.openFile({}, 16.0f);
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
+    cache.addFont(67, &font1);
+    cache.addFont(67, &font2);
+    UnsignedInt glyphCacheInstanceLessFontId = cache.addFont(233);
+
+    struct Shared: TextLayer::Shared {
+        explicit Shared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{3, 5}};
+    shared.setGlyphCache(cache);
+
+    FontHandle first = shared.addFont(font1, 8.0f);
+    /* Scale of 1.0 instead of 0.5 */
+    FontHandle second = shared.addFont(font2, 16.0f);
+    FontHandle instanceless = shared.addInstancelessFont(glyphCacheInstanceLessFontId, 0.5f);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    shared.setFontFallbacks(FontHandle(0x12ab), {});
+    shared.setFontFallbacks(FontHandle::Null, {});
+    shared.setFontFallbacks(instanceless, {});
+    shared.setFontFallbacks(first, {FontHandle(0x12ab)});
+    shared.setFontFallbacks(first, {FontHandle::Null});
+    shared.setFontFallbacks(first, {instanceless});
+    shared.setFontFallbacks(first, {first});
+    shared.setFontFallbacks(first, {second});
+    shared.fontFallbacks(FontHandle(0x12ab));
+    shared.fontFallbacks(FontHandle::Null);
+    CORRADE_COMPARE_AS(out.str(),
+        "Ui::TextLayer::Shared::setFontFallbacks(): invalid handle Ui::FontHandle(0x12ab, 0x0)\n"
+        "Ui::TextLayer::Shared::setFontFallbacks(): invalid handle Ui::FontHandle::Null\n"
+        "Ui::TextLayer::Shared::setFontFallbacks(): Ui::FontHandle(0x2, 0x1) is an instance-less font\n"
+        "Ui::TextLayer::Shared::setFontFallbacks(): invalid fallback handle Ui::FontHandle(0x12ab, 0x0) at index 0\n"
+        "Ui::TextLayer::Shared::setFontFallbacks(): invalid fallback handle Ui::FontHandle::Null at index 0\n"
+        "Ui::TextLayer::Shared::setFontFallbacks(): fallback Ui::FontHandle(0x2, 0x1) at index 0 is an instance-less font\n"
+        "Ui::TextLayer::Shared::setFontFallbacks(): fallback at index 0 is the font itself\n"
+        "Ui::TextLayer::Shared::setFontFallbacks(): expected fallback Ui::FontHandle(0x1, 0x1) at index 0 to have a scale of 0.5 but got 1\n"
+        "Ui::TextLayer::Shared::fontFallbacks(): invalid handle Ui::FontHandle(0x12ab, 0x0)\n"
+        "Ui::TextLayer::Shared::fontFallbacks(): invalid handle Ui::FontHandle::Null\n",
+        TestSuite::Compare::String);
+}
+
 void TextLayerTest::sharedSetStyle() {
     auto&& data = SharedSetStyleData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -6444,6 +6896,123 @@ void TextLayerTest::setCursorInvalid() {
         TestSuite::Compare::String);
 }
 
+void TextLayerTest::cursorForPosition() {
+    auto&& data = CursorForPositionData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Each byte is one glyph with an advance of 2, except for the third which
+       has an advance of 6. In the RTL case the glyphs are produced in a
+       reverse order, with clusters descending. */
+    struct Shaper: Text::AbstractShaper {
+        explicit Shaper(Text::AbstractFont& font, Text::ShapeDirection direction): Text::AbstractShaper{font}, direction{direction} {}
+
+        UnsignedInt doShape(Containers::StringView text, UnsignedInt, UnsignedInt, Containers::ArrayView<const Text::FeatureRange>) override {
+            _textSize = text.size();
+            return text.size();
+        }
+        Text::ShapeDirection doDirection() const override {
+            return direction;
+        }
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<UnsignedInt>& ids) const override {
+            for(UnsignedInt& i: ids)
+                i = 0;
+        }
+        void doGlyphOffsetsAdvancesInto(const Containers::StridedArrayView1D<Vector2>& offsets, const Containers::StridedArrayView1D<Vector2>& advances) const override {
+            for(std::size_t i = 0; i != offsets.size(); ++i) {
+                const UnsignedInt cluster = direction == Text::ShapeDirection::RightToLeft ? _textSize - i - 1 : i;
+                offsets[i] = {};
+                advances[i] = {cluster == 2 ? 6.0f : 2.0f, 0.0f};
+            }
+        }
+        void doGlyphClustersInto(const Containers::StridedArrayView1D<UnsignedInt>& clusters) const override {
+            for(std::size_t i = 0; i != clusters.size(); ++i)
+                clusters[i] = direction == Text::ShapeDirection::RightToLeft ? _textSize - i - 1 : i;
+        }
+
+        Text::ShapeDirection direction;
+
+        private:
+            UnsignedInt _textSize = 0;
+    };
+
+    struct Font: Text::AbstractFont {
+        explicit Font(Text::ShapeDirection direction): direction{direction} {}
+
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return true; }
+        void doClose() override {}
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<Shaper>(*this, direction); }
+
+        Text::ShapeDirection direction;
+    } font{data.direction};
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
+    cache.addFont(67, &font);
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{1}};
+    shared.setGlyphCache(cache);
+    /* Interestingly enough, these two can't be chained together as on some
+       compilers it'd call addFont() before setGlyphCache(), causing an
+       assert */
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {shared.addFont(font, 1.0f)},
+        {data.alignment},
+        {}, {}, {}, {}, {}, {Vector4{1.0f, 0.0f, 3.0f, 0.0f}});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+
+    /* Just to be sure the query isn't picking up the first ever data
+       always */
+    layer.create(0, "", {});
+    DataHandle text = layer.create(0, "hello", {}, TextDataFlag::Editable);
+    CORRADE_COMPARE(layer.size(text).x(), 14.0f);
+
+    /* The style padding is taken from the calculated style, which is filled
+       only by update() */
+    layer.setSize({1, 1}, {1, 1});
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+
+    /* The node is 24 units wide, with the style padding of 1 on the left and
+       3 on the right the text can be either at 1, 5 or 9. The visual glyph
+       edges are then at 0, 2, 4, 10, 12 and 14 relative to that. */
+    const Vector2 nodeSize{24.0f, 10.0f};
+    for(std::size_t i = 0; i != Containers::arraySize(data.expected); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(layer.cursorForPosition(text, {data.textOffset + CursorForPositionPositions[i], 5.0f}, nodeSize), data.expected[i]);
+    }
+
+    /* LayerDataHandle overload */
+    CORRADE_COMPARE(layer.cursorForPosition(dataHandleData(text), {data.textOffset + 6.5f, 5.0f}, nodeSize), data.expected[4]);
+
+    /* Padding set on the data is taken into account as well, the Y position
+       is ignored */
+    layer.setPadding(text, {2.0f, 0.0f, 0.0f, 0.0f});
+    CORRADE_COMPARE(layer.cursorForPosition(text, {data.textOffset + data.extraPaddingOffset + 6.5f, 1000.0f}, nodeSize), data.expected[4]);
+
+    /* Empty text gives back the only possible position */
+    layer.setText(text, "", {});
+    CORRADE_COMPARE(layer.cursorForPosition(text, {5.0f, 5.0f}, nodeSize), 0u);
+}
+
 void TextLayerTest::updateText() {
     struct: Text::AbstractFont {
         Text::FontFeatures doFeatures() const override { return {}; }
@@ -6972,7 +7541,8 @@ void TextLayerTest::createSetTextTextProperties() {
     CORRADE_COMPARE(font.setDirectionCalled, 1);
     CORRADE_COMPARE(font.shapeCalled, 1);
 
-    /* setText() should do the same */
+    /* setText() should do the same. The shaper is already configured for the
+       same properties so it isn't set again. */
     layer.setText(text, "hello", TextProperties{}
         .setScript(Text::Script::HanifiRohingya)
         .setLanguage("eh-UH")
@@ -6981,17 +7551,17 @@ void TextLayerTest::createSetTextTextProperties() {
             {Text::Feature::DiscretionaryLigatures, 3, 5},
             {Text::Feature::Kerning, false}
         }));
-    CORRADE_COMPARE(font.setScriptCalled, 2);
-    CORRADE_COMPARE(font.setLanguageCalled, 2);
-    CORRADE_COMPARE(font.setDirectionCalled, 2);
+    CORRADE_COMPARE(font.setScriptCalled, 1);
+    CORRADE_COMPARE(font.setLanguageCalled, 1);
+    CORRADE_COMPARE(font.setDirectionCalled, 1);
     CORRADE_COMPARE(font.shapeCalled, 2);
 
     /* createGlyph() doesn't call shape() at all */
     DataHandle glyph = layer.createGlyph(0, 0, {});
     layer.setGlyph(glyph, 0, {});
-    CORRADE_COMPARE(font.setScriptCalled, 2);
-    CORRADE_COMPARE(font.setLanguageCalled, 2);
-    CORRADE_COMPARE(font.setDirectionCalled, 2);
+    CORRADE_COMPARE(font.setScriptCalled, 1);
+    CORRADE_COMPARE(font.setLanguageCalled, 1);
+    CORRADE_COMPARE(font.setDirectionCalled, 1);
     CORRADE_COMPARE(font.shapeCalled, 2);
 }
 
@@ -7163,15 +7733,16 @@ void TextLayerTest::createSetTextTextPropertiesEditable() {
     CORRADE_COMPARE(font.setDirectionCalled, 1);
     CORRADE_COMPARE(font.shapeCalled, 1);
 
-    /* updateText() should pass the same */
+    /* updateText() should pass the same, which means the shaper is already
+       configured and isn't set again */
     layer.updateText(text, 0, 0, 5, "!", 6);
     CORRADE_COMPARE(layer.text(text), "hello!");
     CORRADE_COMPARE(layer.cursor(text), Containers::pair(6u, 6u));
-    CORRADE_COMPARE(font.setScriptCalled, 2);
-    CORRADE_COMPARE(font.setLanguageCalled, 2);
-    CORRADE_COMPARE(font.setDirectionCalled, 2);
-    CORRADE_COMPARE(font.shapeCalled, 2);
-
+    CORRADE_COMPARE(font.setScriptCalled, 1);
+    CORRADE_COMPARE(font.setLanguageCalled, 1);
+    CORRADE_COMPARE(font.setDirectionCalled, 1);
+    CORRADE_COMPARE(font.shapeCalled, 2);
+
     /* setText() with different properties should overwrite the previous */
     font.expectedScript = Text::Script::EgyptianHieroglyphs;
     font.expectedLanguage = "eg-HE";
@@ -7193,19 +7764,19 @@ void TextLayerTest::createSetTextTextPropertiesEditable() {
     CORRADE_COMPARE(layer.textProperties(dataHandleData(text)).shapeDirection(), Text::ShapeDirection::Unspecified);
     CORRADE_COMPARE(layer.textProperties(dataHandleData(text)).layoutDirection(), Text::LayoutDirection::HorizontalTopToBottom);
     CORRADE_VERIFY(layer.textProperties(dataHandleData(text)).features().isEmpty());
-    CORRADE_COMPARE(font.setScriptCalled, 3);
-    CORRADE_COMPARE(font.setLanguageCalled, 3);
-    CORRADE_COMPARE(font.setDirectionCalled, 3);
+    CORRADE_COMPARE(font.setScriptCalled, 2);
+    CORRADE_COMPARE(font.setLanguageCalled, 2);
+    CORRADE_COMPARE(font.setDirectionCalled, 2);
     CORRADE_COMPARE(font.shapeCalled, 3);
 
     /* editText() should behave same as updateText(), i.e. pass what was saved
-       above */
+       above, which again means no reconfiguration */
     layer.editText(text, TextEdit::InsertBeforeCursor, "!");
     CORRADE_COMPARE(layer.text(text), "hello?!");
     CORRADE_COMPARE(layer.cursor(text), Containers::pair(7u, 7u));
-    CORRADE_COMPARE(font.setScriptCalled, 4);
-    CORRADE_COMPARE(font.setLanguageCalled, 4);
-    CORRADE_COMPARE(font.setDirectionCalled, 4);
+    CORRADE_COMPARE(font.setScriptCalled, 2);
+    CORRADE_COMPARE(font.setLanguageCalled, 2);
+    CORRADE_COMPARE(font.setDirectionCalled, 2);
     CORRADE_COMPARE(font.shapeCalled, 4);
 }
 
@@ -7281,25 +7852,53 @@ void TextLayerTest::createSetTextTextPropertiesEditableInvalid() {
     data.expected), TestSuite::Compare::String);
 }
 
-void TextLayerTest::createSetUpdateTextFromLayerItself() {
+void TextLayerTest::createSetTextShapeCache() {
+    struct Shaper: ThreeGlyphShaper {
+        explicit Shaper(Text::AbstractFont& font, int& shapeCalled): ThreeGlyphShaper{font}, shapeCalled(shapeCalled) {}
+
+        UnsignedInt doShape(Containers::StringView text, UnsignedInt begin, UnsignedInt end, Containers::ArrayView<const Text::FeatureRange> features) override {
+            ++shapeCalled;
+            return ThreeGlyphShaper::doShape(text, begin, end, features);
+        }
+
+        int& shapeCalled;
+    };
+
     struct: Text::AbstractFont {
         Text::FontFeatures doFeatures() const override { return {}; }
-        bool doIsOpened() const override { return true; }
-        void doClose() override {}
+        bool doIsOpened() const override { return _opened; }
+        Properties doOpenFile(Containers::StringView, Float size) override {
+            _opened = true;
+            return {size, 8.0f, -4.0f, 16.0f, 98};
+        }
+        void doClose() override { _opened = false; }
 
         void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
         Vector2 doGlyphSize(UnsignedInt) override { return {}; }
         Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
-        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<ThreeGlyphShaper>(*this); }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override {
+            return Containers::pointer<Shaper>(*this, shapeCalled);
+        }
+
+        int shapeCalled = 0;
+
+        bool _opened = false;
     } font;
+    font.openFile({}, 16.0f);
 
     struct: Text::AbstractGlyphCache {
         using Text::AbstractGlyphCache::AbstractGlyphCache;
 
         Text::GlyphCacheFeatures doFeatures() const override { return {}; }
         void doSetImage(const Vector2i&, const ImageView2D&) override {}
-    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
-    cache.addFont(98, &font);
+    /* Default padding is 1, resetting to 0 for simplicity */
+    } cache{PixelFormat::R8Unorm, {32, 32}, {}};
+    {
+        UnsignedInt fontId = cache.addFont(font.glyphCount(), &font);
+        cache.addGlyph(fontId, 22, {}, {});
+        cache.addGlyph(fontId, 13, {}, {});
+        cache.addGlyph(fontId, 97, {}, {});
+    }
 
     struct LayerShared: TextLayer::Shared {
         explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
@@ -7308,62 +7907,127 @@ void TextLayerTest::createSetUpdateTextFromLayerItself() {
 
         void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
         void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
-    } shared{TextLayer::Shared::Configuration{1}};
+    } shared{TextLayer::Shared::Configuration{1}
+        .setShapeCacheSize(2)};
     shared.setGlyphCache(cache);
-    /* Interestingly enough, these two can't be chained together as on some
-       compilers it'd call addFont() before setGlyphCache(), causing an
-       assert */
+    CORRADE_COMPARE(shared.shapeCacheSize(), 2);
+    CORRADE_COMPARE(shared.shapeCacheUsedCount(), 0);
+
+    /* The font is scaled to 0.5 */
+    FontHandle fontHandle = shared.addFont(font, 8.0f);
     shared.setStyle(TextLayerCommonStyleUniform{},
         {TextLayerStyleUniform{}},
-        {shared.addFont(font, 1.0f)},
+        {fontHandle},
         {Text::Alignment::MiddleCenter},
         {}, {}, {}, {}, {}, {});
 
     struct Layer: TextLayer {
         explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+
+        const State& stateData() const {
+            return static_cast<const State&>(*_state);
+        }
     } layer{layerHandle(0, 1), shared};
 
-    /* Assuming the implementation stores all texts in one large array, this
-       working correctly relies on arrayAppend() detecting if the view being
-       copied is a slice of the array itself. If it wouldn't, inevitably it'd
-       happen that garbage gets copied, or it blows up due to invalid memory
-       access.
+    const auto glyphs = [&](DataHandle handle) {
+        const Implementation::TextLayerGlyphRun& run = layer.stateData().glyphRuns[layer.stateData().data[dataHandleId(handle)].glyphRun];
+        return stridedArrayView(layer.stateData().glyphData).sliceSize(run.glyphOffset, run.glyphCount);
+    };
 
-       To make sure this indeed gets hit, the test is repeated a few times with
-       varying string sizes to minimize the chance of realloc() growing
-       in-place every time. */
-    DataHandle first = layer.create(0, "hello there" + " how is everyone"_s*testCaseRepeatId(), {}, TextDataFlag::Editable);
-    DataHandle firstCopy = layer.create(0, layer.text(first), {}, TextDataFlag::Editable);
-    DataHandle second = layer.create(0, "hiya", {}, TextDataFlag::Editable);
-    DataHandle third = layer.create(0, "hey hey", {}, TextDataFlag::Editable);
-    layer.setText(second, layer.text(third), {});
-    layer.updateText(third, 0, 0, 7, layer.text(first).exceptPrefix(5), 0);
+    /* First text gets shaped */
+    DataHandle first = layer.create(0, "hello", {});
+    CORRADE_COMPARE(font.shapeCalled, 1);
+    CORRADE_COMPARE(shared.shapeCacheUsedCount(), 1);
 
-    CORRADE_COMPARE(layer.text(first), "hello there" + " how is everyone"_s*testCaseRepeatId());
-    CORRADE_COMPARE(layer.text(firstCopy), "hello there" + " how is everyone"_s*testCaseRepeatId());
-    CORRADE_COMPARE(layer.text(second), "hey hey");
-    CORRADE_COMPARE(layer.text(third), "hey hey there" + " how is everyone"_s*testCaseRepeatId());
+    /* Second text with the same properties is taken from the cache, with the
+       output being the same */
+    DataHandle second = layer.create(0, "hello", {});
+    CORRADE_COMPARE(font.shapeCalled, 1);
+    CORRADE_COMPARE(shared.shapeCacheUsedCount(), 1);
+    CORRADE_COMPARE_AS(glyphs(second).slice(&Implementation::TextLayerGlyphData::glyphId),
+        glyphs(first).slice(&Implementation::TextLayerGlyphData::glyphId),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(glyphs(second).slice(&Implementation::TextLayerGlyphData::position),
+        glyphs(first).slice(&Implementation::TextLayerGlyphData::position),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(layer.size(second), layer.size(first));
+
+    /* Different text properties are a different entry. The cache is now
+       (Latin "hello", "hello"). */
+    layer.setText(second, "hello", TextProperties{}
+        .setScript(Text::Script::Latin));
+    CORRADE_COMPARE(font.shapeCalled, 2);
+    CORRADE_COMPARE(shared.shapeCacheUsedCount(), 2);
+
+    /* A different text replaces the least recently used entry, which is the
+       first "hello". The cache is now ("hey", Latin "hello"). */
+    layer.create(0, "hey", {});
+    CORRADE_COMPARE(font.shapeCalled, 3);
+    CORRADE_COMPARE(shared.shapeCacheUsedCount(), 2);
+
+    /* So it's shaped again, replacing Latin "hello". The cache is now
+       ("hello", "hey"). */
+    layer.create(0, "hello", {});
+    CORRADE_COMPARE(font.shapeCalled, 4);
+
+    /* Using "hey" marks it as most recently used, "hello" stays in */
+    layer.create(0, "hey", {});
+    layer.create(0, "hello", {});
+    CORRADE_COMPARE(font.shapeCalled, 4);
+
+    /* Editable text is never cached */
+    layer.create(0, "hey", {}, TextDataFlag::Editable);
+    CORRADE_COMPARE(font.shapeCalled, 5);
+    CORRADE_COMPARE(shared.shapeCacheUsedCount(), 2);
 }
 
-void TextLayerTest::setColor() {
+void TextLayerTest::createSetTextShapeCacheSerialize() {
+    struct Shaper: ThreeGlyphShaper {
+        explicit Shaper(Text::AbstractFont& font, int& shapeCalled): ThreeGlyphShaper{font}, shapeCalled(shapeCalled) {}
+
+        UnsignedInt doShape(Containers::StringView text, UnsignedInt begin, UnsignedInt end, Containers::ArrayView<const Text::FeatureRange> features) override {
+            ++shapeCalled;
+            return ThreeGlyphShaper::doShape(text, begin, end, features);
+        }
+
+        int& shapeCalled;
+    };
+
     struct: Text::AbstractFont {
         Text::FontFeatures doFeatures() const override { return {}; }
-        bool doIsOpened() const override { return true; }
-        void doClose() override {}
+        bool doIsOpened() const override { return _opened; }
+        Properties doOpenFile(Containers::StringView, Float size) override {
+            _opened = true;
+            return {size, 8.0f, -4.0f, 16.0f, 98};
+        }
+        void doClose() override { _opened = false; }
 
         void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
         Vector2 doGlyphSize(UnsignedInt) override { return {}; }
         Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
-        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<OneGlyphShaper>(*this); }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override {
+            return Containers::pointer<Shaper>(*this, shapeCalled);
+        }
+
+        int shapeCalled = 0;
+
+        bool _opened = false;
     } font;
+    font.openFile({}, 16.0f);
 
     struct: Text::AbstractGlyphCache {
         using Text::AbstractGlyphCache::AbstractGlyphCache;
 
         Text::GlyphCacheFeatures doFeatures() const override { return {}; }
         void doSetImage(const Vector2i&, const ImageView2D&) override {}
-    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
-    cache.addFont(67, &font);
+    /* Default padding is 1, resetting to 0 for simplicity */
+    } cache{PixelFormat::R8Unorm, {32, 32}, {}};
+    {
+        UnsignedInt fontId = cache.addFont(font.glyphCount(), &font);
+        cache.addGlyph(fontId, 22, {}, {});
+        cache.addGlyph(fontId, 13, {}, {});
+        cache.addGlyph(fontId, 97, {}, {});
+    }
 
     struct LayerShared: TextLayer::Shared {
         explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
@@ -7372,72 +8036,219 @@ void TextLayerTest::setColor() {
 
         void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
         void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
-    } shared{TextLayer::Shared::Configuration{1}};
-    shared.setGlyphCache(cache);
-    /* Interestingly enough, these two can't be chained together as on some
-       compilers it'd call addFont() before setGlyphCache(), causing an
-       assert */
-    shared.setStyle(TextLayerCommonStyleUniform{},
-        {TextLayerStyleUniform{}},
-        {shared.addFont(font, 1.0f)},
-        {Text::Alignment::MiddleCenter},
-        {}, {}, {}, {}, {}, {});
+    };
 
     struct Layer: TextLayer {
         explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
-    } layer{layerHandle(0, 1), shared};
 
-    /* Required to be called before update() (because AbstractUserInterface
-       guarantees the same on a higher level), not needed for anything here */
-    layer.setSize({1, 1}, {1, 1});
+        const State& stateData() const {
+            return static_cast<const State&>(*_state);
+        }
+    };
 
-    /* Just to be sure the setters aren't picking up the first ever data
-       always */
-    layer.create(0, "", {});
+    /* Both shared instances have the same font set up */
+    LayerShared sourceShared{TextLayer::Shared::Configuration{1}
+        .setShapeCacheSize(4)};
+    LayerShared shared{TextLayer::Shared::Configuration{1}
+        .setShapeCacheSize(2)};
+    for(LayerShared* i: {&sourceShared, &shared}) {
+        i->setGlyphCache(cache);
+        FontHandle fontHandle = i->addFont(font, 8.0f);
+        i->setStyle(TextLayerCommonStyleUniform{},
+            {TextLayerStyleUniform{}},
+            {fontHandle},
+            {Text::Alignment::MiddleCenter},
+            {}, {}, {}, {}, {}, {});
+    }
 
-    /* There's nothing that would work differently for createGlyph() */
-    DataHandle data = layer.create(0, "", {});
-    CORRADE_COMPARE(layer.color(data), 0xffffffff_rgbaf);
-    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+    /* An empty cache serializes to just a header */
+    Containers::Array<char> empty = sourceShared.serializeShapeCache();
+    CORRADE_COMPARE(empty.size(), 12);
 
-    /* Clear the state flags */
-    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
-    CORRADE_COMPARE(layer.state(), LayerStates{});
+    Layer sourceLayer{layerHandle(0, 1), sourceShared};
+    DataHandle sourceHello = sourceLayer.create(0, "hello", {});
+    DataHandle sourceHey = sourceLayer.create(0, "hey", {});
+    sourceLayer.create(0, "hi", {});
+    CORRADE_COMPARE(font.shapeCalled, 3);
+    CORRADE_COMPARE(sourceShared.shapeCacheUsedCount(), 3);
 
-    /* Setting a color marks the layer as dirty */
-    layer.setColor(data, 0xaabbccdd_rgbaf);
-    CORRADE_COMPARE(layer.color(data), 0xaabbccdd_rgbaf);
-    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+    /* Use "hey" and "hello" again, so "hi" is the least recently used */
+    sourceLayer.create(0, "hey", {});
+    sourceLayer.create(0, "hello", {});
+    CORRADE_COMPARE(font.shapeCalled, 3);
 
-    /* Clear the state flags */
-    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
-    CORRADE_COMPARE(layer.state(), LayerStates{});
+    Containers::Array<char> data = sourceShared.serializeShapeCache();
 
-    /* Testing also the other overload */
-    layer.setColor(dataHandleData(data), 0x11223344_rgbaf);
-    CORRADE_COMPARE(layer.color(dataHandleData(data)), 0x11223344_rgbaf);
-    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+    /* The destination cache has space for only two, so "hi" gets replaced by
+       the more recently used ones */
+    CORRADE_VERIFY(shared.deserializeShapeCache(data));
+    CORRADE_COMPARE(shared.shapeCacheUsedCount(), 2);
+
+    /* Deserializing again doesn't add anything */
+    CORRADE_VERIFY(shared.deserializeShapeCache(data));
+    CORRADE_COMPARE(shared.shapeCacheUsedCount(), 2);
+
+    /* Neither text needs to be shaped and the output is the same */
+    Layer layer{layerHandle(0, 2), shared};
+    DataHandle hello = layer.create(0, "hello", {});
+    DataHandle hey = layer.create(0, "hey", {});
+    CORRADE_COMPARE(font.shapeCalled, 3);
+    for(const Containers::Pair<DataHandle, DataHandle>& i: {
+        Containers::pair(sourceHello, hello),
+        Containers::pair(sourceHey, hey)
+    }) {
+        const Implementation::TextLayerGlyphRun& sourceRun = sourceLayer.stateData().glyphRuns[sourceLayer.stateData().data[dataHandleId(i.first())].glyphRun];
+        const Implementation::TextLayerGlyphRun& run = layer.stateData().glyphRuns[layer.stateData().data[dataHandleId(i.second())].glyphRun];
+        const Containers::StridedArrayView1D<const Implementation::TextLayerGlyphData> sourceGlyphs = stridedArrayView(sourceLayer.stateData().glyphData).sliceSize(sourceRun.glyphOffset, sourceRun.glyphCount);
+        const Containers::StridedArrayView1D<const Implementation::TextLayerGlyphData> glyphs = stridedArrayView(layer.stateData().glyphData).sliceSize(run.glyphOffset, run.glyphCount);
+        CORRADE_COMPARE_AS(glyphs.slice(&Implementation::TextLayerGlyphData::glyphId),
+            sourceGlyphs.slice(&Implementation::TextLayerGlyphData::glyphId),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(glyphs.slice(&Implementation::TextLayerGlyphData::position),
+            sourceGlyphs.slice(&Implementation::TextLayerGlyphData::position),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE(layer.size(i.second()), sourceLayer.size(i.first()));
+    }
+
+    /* The least recently used "hi" was dropped */
+    layer.create(0, "hi", {});
+    CORRADE_COMPARE(font.shapeCalled, 4);
+
+    /* Deserializing into a disabled cache does nothing but succeeds */
+    LayerShared disabledShared{TextLayer::Shared::Configuration{1}};
+    CORRADE_VERIFY(disabledShared.deserializeShapeCache(data));
+    CORRADE_COMPARE(disabledShared.shapeCacheUsedCount(), 0);
 }
 
-void TextLayerTest::setPadding() {
+void TextLayerTest::sharedDeserializeShapeCacheInvalid() {
+    struct Shared: TextLayer::Shared {
+        explicit Shared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{1}
+        .setShapeCacheSize(4)};
+
+    Containers::Array<char> data = shared.serializeShapeCache();
+    CORRADE_COMPARE(data.size(), 12);
+
+    Containers::Array<char> dataInvalidMagic{NoInit, data.size()};
+    Utility::copy(data, dataInvalidMagic);
+    dataInvalidMagic[0] = 'X';
+
+    /* Claiming there's one entry, with the entry either missing or having a
+       5-byte key and 1 glyph but no data for them */
+    Containers::Array<char> dataOneEntry{ValueInit, data.size() + 12};
+    Utility::copy(data, dataOneEntry.prefix(data.size()));
+    {
+        const UnsignedInt entryCount = 1;
+        const UnsignedInt entry[]{5, 1, 0};
+        std::memcpy(dataOneEntry.data() + 8, &entryCount, 4);
+        std::memcpy(dataOneEntry.data() + 12, entry, 12);
+    }
+
+    Containers::Array<char> dataTrailing{ValueInit, data.size() + 1};
+    Utility::copy(data, dataTrailing.prefix(data.size()));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!shared.deserializeShapeCache(data.prefix(11)));
+    CORRADE_VERIFY(!shared.deserializeShapeCache(dataInvalidMagic));
+    CORRADE_VERIFY(!shared.deserializeShapeCache(dataOneEntry.prefix(12)));
+    CORRADE_VERIFY(!shared.deserializeShapeCache(dataOneEntry));
+    CORRADE_VERIFY(!shared.deserializeShapeCache(dataTrailing));
+    CORRADE_COMPARE_AS(out.str(),
+        "Ui::TextLayer::Shared::deserializeShapeCache(): expected at least 12 bytes but got 11\n"
+        "Ui::TextLayer::Shared::deserializeShapeCache(): invalid header\n"
+        "Ui::TextLayer::Shared::deserializeShapeCache(): expected at least 24 bytes for entry 0 but got 12\n"
+        "Ui::TextLayer::Shared::deserializeShapeCache(): expected at least 49 bytes for entry 0 but got 24\n"
+        "Ui::TextLayer::Shared::deserializeShapeCache(): expected 12 bytes but got 13\n",
+        TestSuite::Compare::String);
+
+    /* Nothing got added */
+    CORRADE_COMPARE(shared.shapeCacheUsedCount(), 0);
+}
+
+void TextLayerTest::createSetTextSimpleShaping() {
+    /* Maps each character to a glyph with the ID being the character code and
+       the advance derived from it, except for "fi" which is a ligature and
+       "AV" which has a kerning */
+    struct Shaper: Text::AbstractShaper {
+        explicit Shaper(Text::AbstractFont& font, int& shapeCalled): Text::AbstractShaper{font}, shapeCalled(shapeCalled) {}
+
+        UnsignedInt doShape(Containers::StringView text, UnsignedInt begin, UnsignedInt end, Containers::ArrayView<const Text::FeatureRange>) override {
+            ++shapeCalled;
+            arrayResize(_glyphs, 0);
+            const Containers::StringView slice = text.slice(begin, end);
+            for(std::size_t i = 0; i != slice.size(); ++i) {
+                if(slice[i] == 'f' && i + 1 != slice.size() && slice[i + 1] == 'i') {
+                    arrayAppend(_glyphs, InPlaceInit, 1000u, 3.0f);
+                    ++i;
+                } else if(slice[i] == 'A' && i + 1 != slice.size() && slice[i + 1] == 'V')
+                    arrayAppend(_glyphs, InPlaceInit, UnsignedInt(slice[i]), Float(slice[i])/16.0f - 1.0f);
+                else
+                    arrayAppend(_glyphs, InPlaceInit, UnsignedInt(slice[i]), Float(slice[i])/16.0f);
+            }
+            return _glyphs.size();
+        }
+        Text::ShapeDirection doDirection() const override {
+            return Text::ShapeDirection::LeftToRight;
+        }
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<UnsignedInt>& ids) const override {
+            for(std::size_t i = 0; i != ids.size(); ++i)
+                ids[i] = _glyphs[i].first();
+        }
+        void doGlyphOffsetsAdvancesInto(const Containers::StridedArrayView1D<Vector2>& offsets, const Containers::StridedArrayView1D<Vector2>& advances) const override {
+            for(std::size_t i = 0; i != offsets.size(); ++i) {
+                offsets[i] = {};
+                advances[i] = {_glyphs[i].second(), 0.0f};
+            }
+        }
+        void doGlyphClustersInto(const Containers::StridedArrayView1D<UnsignedInt>& clusters) const override {
+            /* Not exactly correct with the ligature, but good enough for
+               the editable text that's tested here */
+            for(std::size_t i = 0; i != clusters.size(); ++i)
+                clusters[i] = i;
+        }
+
+        int& shapeCalled;
+        Containers::Array<Containers::Pair<UnsignedInt, Float>> _glyphs;
+    };
+
     struct: Text::AbstractFont {
         Text::FontFeatures doFeatures() const override { return {}; }
-        bool doIsOpened() const override { return true; }
-        void doClose() override {}
+        bool doIsOpened() const override { return _opened; }
+        Properties doOpenFile(Containers::StringView, Float size) override {
+            _opened = true;
+            return {size, 8.0f, -4.0f, 16.0f, 1024};
+        }
+        void doClose() override { _opened = false; }
 
         void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
         Vector2 doGlyphSize(UnsignedInt) override { return {}; }
         Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
-        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<OneGlyphShaper>(*this); }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override {
+            return Containers::pointer<Shaper>(*this, shapeCalled);
+        }
+
+        int shapeCalled = 0;
+
+        bool _opened = false;
     } font;
+    font.openFile({}, 16.0f);
 
     struct: Text::AbstractGlyphCache {
         using Text::AbstractGlyphCache::AbstractGlyphCache;
 
         Text::GlyphCacheFeatures doFeatures() const override { return {}; }
         void doSetImage(const Vector2i&, const ImageView2D&) override {}
-    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
-    cache.addFont(67, &font);
+    /* Default padding is 1, resetting to 0 for simplicity */
+    } cache{PixelFormat::R8Unorm, {32, 32}, {}};
+    {
+        UnsignedInt fontId = cache.addFont(font.glyphCount(), &font);
+        for(UnsignedInt glyph: {UnsignedInt(' '), UnsignedInt('A'), UnsignedInt('V'), UnsignedInt('e'), UnsignedInt('f'), UnsignedInt('h'), UnsignedInt('i'), UnsignedInt('s'), UnsignedInt('y'), 1000u})
+            cache.addGlyph(fontId, glyph, {}, {});
+    }
 
     struct LayerShared: TextLayer::Shared {
         explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
@@ -7446,73 +8257,226 @@ void TextLayerTest::setPadding() {
 
         void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
         void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
-    } shared{TextLayer::Shared::Configuration{1}};
-    shared.setGlyphCache(cache);
-    /* Interestingly enough, these two can't be chained together as on some
-       compilers it'd call addFont() before setGlyphCache(), causing an
-       assert */
-    shared.setStyle(TextLayerCommonStyleUniform{},
-        {TextLayerStyleUniform{}},
-        {shared.addFont(font, 1.0f)},
-        {Text::Alignment::MiddleCenter},
-        {}, {}, {}, {}, {}, {});
+    };
+
+    /* The output is compared against a layer that's shaping everything with
+       the shaper */
+    LayerShared shared{TextLayer::Shared::Configuration{1}
+        .setSimpleShaping(true)};
+    LayerShared sharedShaper{TextLayer::Shared::Configuration{1}};
+    CORRADE_VERIFY(shared.hasSimpleShaping());
+    CORRADE_VERIFY(!sharedShaper.hasSimpleShaping());
+    for(LayerShared* s: {&shared, &sharedShaper}) {
+        s->setGlyphCache(cache);
+        /* The font is scaled to 0.5 */
+        FontHandle fontHandle = s->addFont(font, 8.0f);
+        s->setStyle(TextLayerCommonStyleUniform{},
+            {TextLayerStyleUniform{}},
+            {fontHandle},
+            {Text::Alignment::MiddleCenter},
+            {}, {}, {}, {}, {}, {});
+    }
 
     struct Layer: TextLayer {
         explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
-    } layer{layerHandle(0, 1), shared};
-
-    /* Required to be called before update() (because AbstractUserInterface
-       guarantees the same on a higher level), not needed for anything here */
-    layer.setSize({1, 1}, {1, 1});
 
-    /* Just to be sure the setters aren't picking up the first ever data
-       always */
-    layer.create(0, "", {});
+        const State& stateData() const {
+            return static_cast<const State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared},
+      layerShaper{layerHandle(0, 1), sharedShaper};
 
-    /* There's nothing that would work differently for createGlyph() */
-    DataHandle data = layer.create(0, "", {});
-    CORRADE_COMPARE(layer.padding(data), Vector4{0.0f});
-    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+    const auto glyphs = [](const Layer& layer, DataHandle handle) {
+        const Implementation::TextLayerGlyphRun& run = layer.stateData().glyphRuns[layer.stateData().data[dataHandleId(handle)].glyphRun];
+        return stridedArrayView(layer.stateData().glyphData).sliceSize(run.glyphOffset, run.glyphCount);
+    };
+    const auto compare = [&](DataHandle handle, DataHandle handleShaper) {
+        CORRADE_COMPARE_AS(glyphs(layer, handle).slice(&Implementation::TextLayerGlyphData::glyphId),
+            glyphs(layerShaper, handleShaper).slice(&Implementation::TextLayerGlyphData::glyphId),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(glyphs(layer, handle).slice(&Implementation::TextLayerGlyphData::position),
+            glyphs(layerShaper, handleShaper).slice(&Implementation::TextLayerGlyphData::position),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE(layer.size(handle), layerShaper.size(handleShaper));
+    };
 
-    /* Clear the state flags */
-    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
-    CORRADE_COMPARE(layer.state(), LayerStates{});
+    /* First simple text shapes all printable ASCII characters to fill the
+       table, plus each pair of adjacent characters, which is "AV", "VA",
+       "A ", " h", "he", "ey" */
+    DataHandle first = layer.create(0, "AVA hey", {});
+    DataHandle firstShaper = layerShaper.create(0, "AVA hey", {});
+    CORRADE_COMPARE(font.shapeCalled, 95 + 6 + 1);
+    compare(first, firstShaper);
+
+    /* Subsequent simple text with the same pairs doesn't call the shaper at
+       all, and neither does measuring it */
+    font.shapeCalled = 0;
+    DataHandle second = layer.create(0, "A hey", {});
+    DataHandle secondShaper = layerShaper.create(0, "A hey", {});
+    CORRADE_COMPARE(font.shapeCalled, 1);
+    compare(second, secondShaper);
+    CORRADE_COMPARE(shared.measureText(0, "A hey", {}), sharedShaper.measureText(0, "A hey", {}));
+    CORRADE_COMPARE(font.shapeCalled, 2);
 
-    /* Setting a padding marks the layer as dirty */
-    layer.setPadding(data, {2.0f, 4.0f, 3.0f, 1.0f});
-    CORRADE_COMPARE(layer.padding(data), (Vector4{2.0f, 4.0f, 3.0f, 1.0f}));
-    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+    /* Explicitly specified Latin script, English and left-to-right direction
+       is simple as well */
+    font.shapeCalled = 0;
+    layer.setText(second, "A hey", TextProperties{}
+        .setScript(Text::Script::Latin)
+        .setLanguage("en")
+        .setShapeDirection(Text::ShapeDirection::LeftToRight));
+    CORRADE_COMPARE(font.shapeCalled, 0);
+    compare(second, secondShaper);
+
+    /* Multi-line text goes through the simple path line by line */
+    font.shapeCalled = 0;
+    DataHandle multiLine = layer.create(0, "AVA
+hey", {});
+    DataHandle multiLineShaper = layerShaper.create(0, "AVA
+hey", {});
+    CORRADE_COMPARE(font.shapeCalled, 2);
+    compare(multiLine, multiLineShaper);
+
+    /* A ligature pair gets shaped once and then known to be unsupported, the
+       text falls back to the shaper */
+    font.shapeCalled = 0;
+    DataHandle ligature = layer.create(0, "fish", {});
+    DataHandle ligatureShaper = layerShaper.create(0, "fish", {});
+    /* "fi" and then the whole text in each layer */
+    CORRADE_COMPARE(font.shapeCalled, 1 + 1 + 1);
+    CORRADE_COMPARE(glyphs(layer, ligature).size(), 3);
+    compare(ligature, ligatureShaper);
+
+    font.shapeCalled = 0;
+    layer.setText(ligature, "fish", {});
+    CORRADE_COMPARE(font.shapeCalled, 1);
 
-    /* Clear the state flags */
-    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
-    CORRADE_COMPARE(layer.state(), LayerStates{});
+    /* Non-ASCII text, font features, or a different script, language or
+       direction falls back to the shaper as well */
+    font.shapeCalled = 0;
+    layer.setText(ligature, "h\xc3\xa9", {});
+    layer.setText(ligature, "hey", TextProperties{}
+        .setFeatures({{Text::Feature::Kerning, false}}));
+    layer.setText(ligature, "hey", TextProperties{}
+        .setScript(Text::Script::Greek));
+    layer.setText(ligature, "hey", TextProperties{}
+        .setLanguage("cs"));
+    layer.setText(ligature, "hey", TextProperties{}
+        .setShapeDirection(Text::ShapeDirection::RightToLeft));
+    CORRADE_COMPARE(font.shapeCalled, 5);
+
+    /* Editable text goes through the simple path too, with each glyph
+       corresponding to one byte */
+    font.shapeCalled = 0;
+    DataHandle editable = layer.create(0, "AVA", {}, TextDataFlag::Editable);
+    CORRADE_COMPARE(font.shapeCalled, 0);
+    CORRADE_COMPARE_AS(glyphs(layer, editable).slice(&Implementation::TextLayerGlyphData::glyphCluster), Containers::arrayView({
+        0u, 1u, 2u
+    }), TestSuite::Compare::Container);
+}
 
-    /* Testing also the other overload */
-    layer.setPadding(dataHandleData(data), {1.0f, 2.0f, 3.0f, 4.0f});
-    CORRADE_COMPARE(layer.padding(dataHandleData(data)), (Vector4{1.0f, 2.0f, 3.0f, 4.0f}));
-    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+void TextLayerTest::createSetTextFontFallbacks() {
+    /* Produces a glyph for each character that's in given range, with the
+       advance being different for each font */
+    struct Shaper: Text::AbstractShaper {
+        explicit Shaper(Text::AbstractFont& font, char32_t first, char32_t last, Float advance, int& shapeCalled): Text::AbstractShaper{font}, _first{first}, _last{last}, _advance{advance}, shapeCalled(shapeCalled) {}
+
+        UnsignedInt doShape(Containers::StringView text, UnsignedInt begin, UnsignedInt end, Containers::ArrayView<const Text::FeatureRange>) override {
+            ++shapeCalled;
+            arrayResize(_glyphs, 0);
+            for(std::size_t i = begin; i < end; ) {
+                const Containers::Pair<char32_t, std::size_t> next = Utility::Unicode::nextChar(text, i);
+                arrayAppend(_glyphs, next.first() >= _first && next.first() <= _last ? UnsignedInt(next.first() - _first + 1) : 0u);
+                i = next.second();
+            }
+            return _glyphs.size();
+        }
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<UnsignedInt>& ids) const override {
+            for(std::size_t i = 0; i != ids.size(); ++i)
+                ids[i] = _glyphs[i];
+        }
+        void doGlyphOffsetsAdvancesInto(const Containers::StridedArrayView1D<Vector2>& offsets, const Containers::StridedArrayView1D<Vector2>& advances) const override {
+            for(std::size_t i = 0; i != offsets.size(); ++i) {
+                offsets[i] = {};
+                advances[i] = {_advance, 0.0f};
+            }
+        }
+        void doGlyphClustersInto(const Containers::StridedArrayView1D<UnsignedInt>& clusters) const override {
+            for(std::size_t i = 0; i != clusters.size(); ++i)
+                clusters[i] = i;
+        }
 
-    /* Clear the state flags */
-    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
-    CORRADE_COMPARE(layer.state(), LayerStates{});
+        char32_t _first, _last;
+        Float _advance;
+        int& shapeCalled;
+        Containers::Array<UnsignedInt> _glyphs;
+    };
 
-    /* Single-value padding */
-    layer.setPadding(data, 4.0f);
-    CORRADE_COMPARE(layer.padding(data), Vector4{4.0f});
-    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+    struct FallbackFont: Text::AbstractFont {
+        explicit FallbackFont(char32_t first, char32_t last, Float advance): _first{first}, _last{last}, _advance{advance} {}
 
-    /* Clear the state flags */
-    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
-    CORRADE_COMPARE(layer.state(), LayerStates{});
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return _opened; }
+        Properties doOpenFile(Containers::StringView, Float size) override {
+            _opened = true;
+            return {size, 8.0f, -4.0f, 16.0f, 512};
+        }
+        void doClose() override { _opened = false; }
 
-    /* Testing also the other overload */
-    layer.setPadding(dataHandleData(data), 3.0f);
-    CORRADE_COMPARE(layer.padding(dataHandleData(data)), Vector4{3.0f});
-    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
-}
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>& characters, const Containers::StridedArrayView1D<UnsignedInt>& glyphs) override {
+            glyphIdsQueried += characters.size();
+            for(std::size_t i = 0; i != characters.size(); ++i)
+                glyphs[i] = characters[i] >= _first && characters[i] <= _last ? UnsignedInt(characters[i] - _first + 1) : 0u;
+        }
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        bool doFillGlyphCache(Text::AbstractGlyphCache& cache, const Containers::StridedArrayView1D<const UnsignedInt>& glyphs) override {
+            ++fillCalled;
+            UnsignedInt fontId = *cache.findFont(*this);
+            for(UnsignedInt glyph: glyphs)
+                cache.addGlyph(fontId, glyph, {}, {});
+            return true;
+        }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override {
+            return Containers::pointer<Shaper>(*this, _first, _last, _advance, shapeCalled);
+        }
 
-void TextLayerTest::invalidHandle() {
-    CORRADE_SKIP_IF_NO_ASSERT();
+        char32_t _first, _last;
+        Float _advance;
+        int glyphIdsQueried = 0;
+        int shapeCalled = 0;
+        int fillCalled = 0;
+
+        bool _opened = false;
+    };
+
+    /* The primary font has just the printable ASCII, the fallback has Latin
+       Extended-A and all of printable ASCII as well, the other fallback
+       isn't used for anything */
+    FallbackFont fontPrimary{U' ', U'~', 1.0f};
+    FallbackFont fontFallback{U' ', U'\u017f', 2.0f};
+    FallbackFont fontUnused{U'\u0400', U'\u04ff', 4.0f};
+    fontPrimary.openFile({}, 16.0f);
+    fontFallback.openFile({}, 16.0f);
+    fontUnused.openFile({}, 16.0f);
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    /* Default padding is 1, resetting to 0 for simplicity */
+    } cache{PixelFormat::R8Unorm, {32, 32}, {}};
+    UnsignedInt primaryFontId = cache.addFont(fontPrimary.glyphCount(), &fontPrimary);
+    UnsignedInt fallbackFontId = cache.addFont(fontFallback.glyphCount(), &fontFallback);
+    cache.addFont(fontUnused.glyphCount(), &fontUnused);
+    cache.addGlyph(primaryFontId, fontPrimary.glyphId(U'a'), {}, {});
+    cache.addGlyph(primaryFontId, fontPrimary.glyphId(U' '), {}, {});
+    cache.addGlyph(fallbackFontId, fontFallback.glyphId(U'\u011b'), {}, {}); /* ě */
+    cache.addGlyph(fallbackFontId, fontFallback.glyphId(U'\u0161'), {}, {}); /* š */
+    cache.addGlyph(fallbackFontId, fontFallback.glyphId(U' '), {}, {});
+    fontPrimary.glyphIdsQueried = 0;
+    fontFallback.glyphIdsQueried = 0;
 
     struct LayerShared: TextLayer::Shared {
         explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
@@ -7522,98 +8486,177 @@ void TextLayerTest::invalidHandle() {
         void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
         void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
     } shared{TextLayer::Shared::Configuration{1}};
+    shared.setGlyphCache(cache);
+
+    /* All fonts are scaled to 0.5 */
+    FontHandle primary = shared.addFont(fontPrimary, 8.0f);
+    FontHandle fallback = shared.addFont(fontFallback, 8.0f);
+    FontHandle unused = shared.addFont(fontUnused, 8.0f);
+    shared.setFontFallbacks(primary, {unused, fallback});
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {primary},
+        {Text::Alignment::LineLeft},
+        {}, {}, {}, {}, {}, {});
 
     struct Layer: TextLayer {
         explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+
+        const State& stateData() const {
+            return static_cast<const State&>(*_state);
+        }
     } layer{layerHandle(0, 1), shared};
 
-    std::ostringstream out;
-    Error redirectError{&out};
-    layer.flags(DataHandle::Null);
-    layer.flags(LayerDataHandle::Null);
-    layer.glyphCount(DataHandle::Null);
-    layer.glyphCount(LayerDataHandle::Null);
-    layer.size(DataHandle::Null);
-    layer.size(LayerDataHandle::Null);
-    layer.cursor(DataHandle::Null);
-    layer.cursor(LayerDataHandle::Null);
-    layer.setCursor(DataHandle::Null, 0);
-    layer.setCursor(LayerDataHandle::Null, 0);
-    layer.textProperties(DataHandle::Null);
-    layer.textProperties(LayerDataHandle::Null);
-    layer.text(DataHandle::Null);
-    layer.text(LayerDataHandle::Null);
-    layer.setText(DataHandle::Null, "", {});
-    layer.setText(LayerDataHandle::Null, "", {});
-    layer.updateText(DataHandle::Null, 0, 0, 0, {}, 0);
-    layer.updateText(LayerDataHandle::Null, 0, 0, 0, {}, 0);
-    layer.editText(DataHandle::Null, TextEdit::MoveCursorLeft, {});
-    layer.editText(LayerDataHandle::Null, TextEdit::MoveCursorLeft, {});
-    layer.setGlyph(DataHandle::Null, 0, {});
-    layer.setGlyph(LayerDataHandle::Null, 0, {});
-    layer.color(DataHandle::Null);
-    layer.color(LayerDataHandle::Null);
-    layer.setColor(DataHandle::Null, {});
-    layer.setColor(LayerDataHandle::Null, {});
-    layer.padding(DataHandle::Null);
-    layer.padding(LayerDataHandle::Null);
-    layer.setPadding(DataHandle::Null, {});
-    layer.setPadding(LayerDataHandle::Null, {});
-    CORRADE_COMPARE_AS(out.str(),
-        "Ui::TextLayer::flags(): invalid handle Ui::DataHandle::Null\n"
-        "Ui::TextLayer::flags(): invalid handle Ui::LayerDataHandle::Null\n"
-        "Ui::TextLayer::glyphCount(): invalid handle Ui::DataHandle::Null\n"
-        "Ui::TextLayer::glyphCount(): invalid handle Ui::LayerDataHandle::Null\n"
-        "Ui::TextLayer::size(): invalid handle Ui::DataHandle::Null\n"
-        "Ui::TextLayer::size(): invalid handle Ui::LayerDataHandle::Null\n"
-        "Ui::TextLayer::cursor(): invalid handle Ui::DataHandle::Null\n"
-        "Ui::TextLayer::cursor(): invalid handle Ui::LayerDataHandle::Null\n"
-        "Ui::TextLayer::setCursor(): invalid handle Ui::DataHandle::Null\n"
-        "Ui::TextLayer::setCursor(): invalid handle Ui::LayerDataHandle::Null\n"
-        "Ui::TextLayer::textProperties(): invalid handle Ui::DataHandle::Null\n"
-        "Ui::TextLayer::textProperties(): invalid handle Ui::LayerDataHandle::Null\n"
-        "Ui::TextLayer::text(): invalid handle Ui::DataHandle::Null\n"
-        "Ui::TextLayer::text(): invalid handle Ui::LayerDataHandle::Null\n"
-        "Ui::TextLayer::setText(): invalid handle Ui::DataHandle::Null\n"
-        "Ui::TextLayer::setText(): invalid handle Ui::LayerDataHandle::Null\n"
-        "Ui::TextLayer::updateText(): invalid handle Ui::DataHandle::Null\n"
-        "Ui::TextLayer::updateText(): invalid handle Ui::LayerDataHandle::Null\n"
-        "Ui::TextLayer::editText(): invalid handle Ui::DataHandle::Null\n"
-        "Ui::TextLayer::editText(): invalid handle Ui::LayerDataHandle::Null\n"
-        "Ui::TextLayer::setGlyph(): invalid handle Ui::DataHandle::Null\n"
-        "Ui::TextLayer::setGlyph(): invalid handle Ui::LayerDataHandle::Null\n"
-        "Ui::TextLayer::color(): invalid handle Ui::DataHandle::Null\n"
-        "Ui::TextLayer::color(): invalid handle Ui::LayerDataHandle::Null\n"
-        "Ui::TextLayer::setColor(): invalid handle Ui::DataHandle::Null\n"
-        "Ui::TextLayer::setColor(): invalid handle Ui::LayerDataHandle::Null\n"
-        "Ui::TextLayer::padding(): invalid handle Ui::DataHandle::Null\n"
-        "Ui::TextLayer::padding(): invalid handle Ui::LayerDataHandle::Null\n"
-        "Ui::TextLayer::setPadding(): invalid handle Ui::DataHandle::Null\n"
-        "Ui::TextLayer::setPadding(): invalid handle Ui::LayerDataHandle::Null\n",
-        TestSuite::Compare::String);
+    const auto glyphs = [&](DataHandle handle) {
+        const Implementation::TextLayerGlyphRun& run = layer.stateData().glyphRuns[layer.stateData().data[dataHandleId(handle)].glyphRun];
+        return stridedArrayView(layer.stateData().glyphData).sliceSize(run.glyphOffset, run.glyphCount);
+    };
+
+    /* The "a" is taken from the primary font, "ě" and "š" from the fallback
+       one, the space stays in the fallback run and the final "a" goes back
+       to the primary font. Each run gets shaped with its own font. */
+    DataHandle text = layer.create(0, "a\xc4\x9b \xc5\xa1\x61", {});
+    CORRADE_COMPARE(fontPrimary.shapeCalled, 2);
+    CORRADE_COMPARE(fontFallback.shapeCalled, 1);
+    CORRADE_COMPARE(fontUnused.shapeCalled, 0);
+    CORRADE_COMPARE_AS(glyphs(text).slice(&Implementation::TextLayerGlyphData::glyphId), Containers::arrayView({
+        cache.glyphId(primaryFontId, fontPrimary.glyphId(U'a')),
+        cache.glyphId(fallbackFontId, fontFallback.glyphId(U'\u011b')),
+        cache.glyphId(fallbackFontId, fontFallback.glyphId(U' ')),
+        cache.glyphId(fallbackFontId, fontFallback.glyphId(U'\u0161')),
+        cache.glyphId(primaryFontId, fontPrimary.glyphId(U'a')),
+    }), TestSuite::Compare::Container);
+    /* The fallback font glyphs have twice the advance */
+    CORRADE_COMPARE_AS(glyphs(text).slice(&Implementation::TextLayerGlyphData::position), Containers::arrayView<Vector2>({
+        {0.0f, 0.0f},
+        {0.5f, 0.0f},
+        {1.5f, 0.0f},
+        {2.5f, 0.0f},
+        {3.5f, 0.0f},
+    }), TestSuite::Compare::Container);
+    /* Measuring gives the same result */
+    CORRADE_COMPARE(shared.measureText(0, "a\xc4\x9b \xc5\xa1\x61", {}).size(), layer.size(text));
+
+    /* The font coverage got queried just once for each character and font,
+       so a text with the same characters doesn't query anything */
+    fontPrimary.glyphIdsQueried = 0;
+    fontFallback.glyphIdsQueried = 0;
+    fontUnused.glyphIdsQueried = 0;
+    layer.setText(text, "a\xc5\xa1 \xc4\x9b", {});
+    CORRADE_COMPARE(fontPrimary.glyphIdsQueried, 0);
+    CORRADE_COMPARE(fontFallback.glyphIdsQueried, 0);
+    CORRADE_COMPARE(fontUnused.glyphIdsQueried, 0);
+
+    /* A space after a primary font run stays in it */
+    fontPrimary.shapeCalled = 0;
+    fontFallback.shapeCalled = 0;
+    layer.setText(text, "a \xc4\x9b", {});
+    CORRADE_COMPARE(fontPrimary.shapeCalled, 1);
+    CORRADE_COMPARE(fontFallback.shapeCalled, 1);
+    CORRADE_COMPARE_AS(glyphs(text).slice(&Implementation::TextLayerGlyphData::glyphId), Containers::arrayView({
+        cache.glyphId(primaryFontId, fontPrimary.glyphId(U'a')),
+        cache.glyphId(primaryFontId, fontPrimary.glyphId(U' ')),
+        cache.glyphId(fallbackFontId, fontFallback.glyphId(U'\u011b')),
+    }), TestSuite::Compare::Container);
+
+    /* Characters that no font has are shaped with the primary font. With no
+       fallback needed it's a single run. */
+    fontPrimary.shapeCalled = 0;
+    fontFallback.shapeCalled = 0;
+    layer.setText(text, "a\xe2\x98\x83", {});
+    CORRADE_COMPARE(fontPrimary.shapeCalled, 1);
+    CORRADE_COMPARE(fontFallback.shapeCalled, 0);
+    CORRADE_COMPARE(glyphs(text).size(), 2);
+
+    /* Multi-line text is split into runs on each line */
+    fontPrimary.shapeCalled = 0;
+    fontFallback.shapeCalled = 0;
+    layer.setText(text, "\xc4\x9b\na", {});
+    CORRADE_COMPARE(fontPrimary.shapeCalled, 1);
+    CORRADE_COMPARE(fontFallback.shapeCalled, 1);
+    CORRADE_COMPARE_AS(glyphs(text).slice(&Implementation::TextLayerGlyphData::glyphId), Containers::arrayView({
+        cache.glyphId(fallbackFontId, fontFallback.glyphId(U'\u011b')),
+        cache.glyphId(primaryFontId, fontPrimary.glyphId(U'a')),
+    }), TestSuite::Compare::Container);
+
+    /* Editable text doesn't use fallbacks, the "ě" is the invalid glyph */
+    fontPrimary.shapeCalled = 0;
+    fontFallback.shapeCalled = 0;
+    DataHandle editable = layer.create(0, "a\xc4\x9b", {}, TextDataFlag::Editable);
+    CORRADE_COMPARE(fontPrimary.shapeCalled, 1);
+    CORRADE_COMPARE(fontFallback.shapeCalled, 0);
+    CORRADE_COMPARE_AS(glyphs(editable).slice(&Implementation::TextLayerGlyphData::glyphId), Containers::arrayView({
+        cache.glyphId(primaryFontId, fontPrimary.glyphId(U'a')),
+        0u
+    }), TestSuite::Compare::Container);
+
+    /* With on-demand glyph cache filling, glyphs of both fonts stay
+       font-specific until the next update, which fills both fonts and
+       converts each glyph with the font it came from */
+    shared.setOnDemandGlyphCacheFilling(true);
+    DataHandle missing = layer.create(0, "b\xc5\x99", {}); /* bř */
+    CORRADE_COMPARE_AS(glyphs(missing).slice(&Implementation::TextLayerGlyphData::glyphId), Containers::arrayView({
+        fontPrimary.glyphId(U'b'),
+        fontFallback.glyphId(U'\u0159'),
+    }), TestSuite::Compare::Container);
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(fontPrimary.fillCalled, 1);
+    CORRADE_COMPARE(fontFallback.fillCalled, 1);
+    CORRADE_COMPARE_AS(glyphs(missing).slice(&Implementation::TextLayerGlyphData::glyphId), Containers::arrayView({
+        cache.glyphId(primaryFontId, fontPrimary.glyphId(U'b')),
+        cache.glyphId(fallbackFontId, fontFallback.glyphId(U'\u0159')),
+    }), TestSuite::Compare::Container);
+    CORRADE_VERIFY(cache.glyphId(primaryFontId, fontPrimary.glyphId(U'b')));
+    CORRADE_VERIFY(cache.glyphId(fallbackFontId, fontFallback.glyphId(U'\u0159')));
 }
 
-void TextLayerTest::invalidFontHandle() {
-    CORRADE_SKIP_IF_NO_ASSERT();
+void TextLayerTest::createSetTextMultiLine() {
+    struct Shaper: ThreeGlyphShaper {
+        explicit Shaper(Text::AbstractFont& font, int& shapeCalled): ThreeGlyphShaper{font}, shapeCalled(shapeCalled) {}
+
+        UnsignedInt doShape(Containers::StringView text, UnsignedInt begin, UnsignedInt end, Containers::ArrayView<const Text::FeatureRange> features) override {
+            ++shapeCalled;
+            return ThreeGlyphShaper::doShape(text, begin, end, features);
+        }
+
+        int& shapeCalled;
+    };
 
     struct: Text::AbstractFont {
         Text::FontFeatures doFeatures() const override { return {}; }
-        bool doIsOpened() const override { return true; }
-        void doClose() override {}
+        bool doIsOpened() const override { return _opened; }
+        Properties doOpenFile(Containers::StringView, Float size) override {
+            _opened = true;
+            return {size, 8.0f, -4.0f, 16.0f, 98};
+        }
+        void doClose() override { _opened = false; }
 
         void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
         Vector2 doGlyphSize(UnsignedInt) override { return {}; }
         Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
-        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<OneGlyphShaper>(*this); }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override {
+            return Containers::pointer<Shaper>(*this, shapeCalled);
+        }
+
+        int shapeCalled = 0;
+
+        bool _opened = false;
     } font;
+    font.openFile({}, 16.0f);
 
     struct: Text::AbstractGlyphCache {
         using Text::AbstractGlyphCache::AbstractGlyphCache;
 
         Text::GlyphCacheFeatures doFeatures() const override { return {}; }
         void doSetImage(const Vector2i&, const ImageView2D&) override {}
-    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
-    cache.addFont(67, &font);
+    /* Default padding is 1, resetting to 0 for simplicity */
+    } cache{PixelFormat::R8Unorm, {32, 32}, {}};
+    {
+        UnsignedInt fontId = cache.addFont(font.glyphCount(), &font);
+        cache.addGlyph(fontId, 22, {}, {});
+        cache.addGlyph(fontId, 13, {}, {});
+        cache.addGlyph(fontId, 97, {}, {});
+    }
 
     struct LayerShared: TextLayer::Shared {
         explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
@@ -7622,57 +8665,109 @@ void TextLayerTest::invalidFontHandle() {
 
         void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
         void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
-    } shared{TextLayer::Shared::Configuration{1}};
+    } shared{TextLayer::Shared::Configuration{1}
+        .setShapeCacheSize(4)};
     shared.setGlyphCache(cache);
-    /* Interestingly enough, these two can't be chained together as on some
-       compilers it'd call addFont() before setGlyphCache(), causing an
-       assert */
+
+    /* The font is scaled to 0.5, so the line advance is 8 */
     shared.setStyle(TextLayerCommonStyleUniform{},
         {TextLayerStyleUniform{}},
-        {shared.addFont(font, 1.0f)},
-        {Text::Alignment{}},
+        {shared.addFont(font, 8.0f)},
+        {Text::Alignment::MiddleCenter},
         {}, {}, {}, {}, {}, {});
 
     struct Layer: TextLayer {
         explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+
+        const State& stateData() const {
+            return static_cast<const State&>(*_state);
+        }
     } layer{layerHandle(0, 1), shared};
 
-    DataHandle data = layer.create(0, "", {});
+    const auto glyphs = [&](DataHandle handle) {
+        const Implementation::TextLayerGlyphRun& run = layer.stateData().glyphRuns[layer.stateData().data[dataHandleId(handle)].glyphRun];
+        return stridedArrayView(layer.stateData().glyphData).sliceSize(run.glyphOffset, run.glyphCount);
+    };
 
-    std::ostringstream out;
-    Error redirectError{&out};
-    layer.create(0, "", FontHandle(0x12ab));
-    layer.createGlyph(0, 0, FontHandle(0x12ab));
-    layer.setText(data, "", FontHandle(0x12ab));
-    layer.setGlyph(data, 0, FontHandle(0x12ab));
-    CORRADE_COMPARE(out.str(),
-        "Ui::TextLayer::create(): invalid handle Ui::FontHandle(0x12ab, 0x0)\n"
-        "Ui::TextLayer::createGlyph(): invalid handle Ui::FontHandle(0x12ab, 0x0)\n"
-        "Ui::TextLayer::setText(): invalid handle Ui::FontHandle(0x12ab, 0x0)\n"
-        "Ui::TextLayer::setGlyph(): invalid handle Ui::FontHandle(0x12ab, 0x0)\n");
+    /* Each line is shaped separately and the line breaks don't produce any
+       glyphs */
+    DataHandle text = layer.create(0, "hi\nhey", {});
+    CORRADE_COMPARE(font.shapeCalled, 2);
+    CORRADE_COMPARE(shared.shapeCacheUsedCount(), 2);
+    CORRADE_COMPARE(layer.glyphCount(text), 5);
+    /* The shaper restarts its glyph cycle on each line */
+    CORRADE_COMPARE_AS(glyphs(text).slice(&Implementation::TextLayerGlyphData::glyphId), Containers::arrayView<UnsignedInt>({
+        1, 2, 1, 2, 3
+    }), TestSuite::Compare::Container);
+    /* The second line is one line advance below the first, the first glyph
+       of each line has the same offset */
+    CORRADE_COMPARE(glyphs(text)[2].position.y(), glyphs(text)[0].position.y() - 8.0f);
+    /* The width is of the longer line, the height is ascent and descent
+       scaled to 0.5 plus the line advance for the second line */
+    CORRADE_COMPARE(layer.size(text), (Vector2{4.5f, 14.0f}));
+
+    /* Changing just the second line reshapes only that one */
+    layer.setText(text, "hi\nhello", {});
+    CORRADE_COMPARE(font.shapeCalled, 3);
+    CORRADE_COMPARE(shared.shapeCacheUsedCount(), 3);
+    CORRADE_COMPARE(layer.glyphCount(text), 7);
+
+    /* Appending lines reshapes only the ones not in the cache. An empty line
+       produces no glyphs but still takes space. */
+    layer.setText(text, "hi\nhello\n\nhey", {});
+    CORRADE_COMPARE(font.shapeCalled, 4);
+    CORRADE_COMPARE(shared.shapeCacheUsedCount(), 4);
+    CORRADE_COMPARE(layer.glyphCount(text), 10);
+    CORRADE_COMPARE(glyphs(text)[7].position.y(), glyphs(text)[0].position.y() - 24.0f);
 }
 
-void TextLayerTest::nonEditableText() {
-    CORRADE_SKIP_IF_NO_ASSERT();
+void TextLayerTest::sharedMeasureText() {
+    struct Shaper: ThreeGlyphShaper {
+        explicit Shaper(Text::AbstractFont& font, int& shapeCalled): ThreeGlyphShaper{font}, shapeCalled(shapeCalled) {}
+
+        UnsignedInt doShape(Containers::StringView text, UnsignedInt begin, UnsignedInt end, Containers::ArrayView<const Text::FeatureRange> features) override {
+            ++shapeCalled;
+            return ThreeGlyphShaper::doShape(text, begin, end, features);
+        }
+
+        int& shapeCalled;
+    };
 
     struct: Text::AbstractFont {
         Text::FontFeatures doFeatures() const override { return {}; }
-        bool doIsOpened() const override { return true; }
-        void doClose() override {}
+        bool doIsOpened() const override { return _opened; }
+        Properties doOpenFile(Containers::StringView, Float size) override {
+            _opened = true;
+            return {size, 8.0f, -4.0f, 16.0f, 98};
+        }
+        void doClose() override { _opened = false; }
 
         void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
         Vector2 doGlyphSize(UnsignedInt) override { return {}; }
         Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
-        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<OneGlyphShaper>(*this); }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override {
+            return Containers::pointer<Shaper>(*this, shapeCalled);
+        }
+
+        int shapeCalled = 0;
+
+        bool _opened = false;
     } font;
+    font.openFile({}, 16.0f);
 
     struct: Text::AbstractGlyphCache {
         using Text::AbstractGlyphCache::AbstractGlyphCache;
 
         Text::GlyphCacheFeatures doFeatures() const override { return {}; }
         void doSetImage(const Vector2i&, const ImageView2D&) override {}
-    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
-    cache.addFont(67, &font);
+    /* Default padding is 1, resetting to 0 for simplicity */
+    } cache{PixelFormat::R8Unorm, {32, 32}, {}};
+    {
+        UnsignedInt fontId = cache.addFont(font.glyphCount(), &font);
+        cache.addGlyph(fontId, 22, {}, {});
+        cache.addGlyph(fontId, 13, {}, {});
+        cache.addGlyph(fontId, 97, {}, {});
+    }
 
     struct LayerShared: TextLayer::Shared {
         explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
@@ -7681,55 +8776,49 @@ void TextLayerTest::nonEditableText() {
 
         void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
         void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
-    } shared{TextLayer::Shared::Configuration{1}};
+    } shared{TextLayer::Shared::Configuration{1}
+        .setShapeCacheSize(4)};
     shared.setGlyphCache(cache);
-    /* Interestingly enough, these two can't be chained together as on some
-       compilers it'd call addFont() before setGlyphCache(), causing an
-       assert */
+
+    /* The font is scaled to 0.5 */
     shared.setStyle(TextLayerCommonStyleUniform{},
         {TextLayerStyleUniform{}},
-        {shared.addFont(font, 1.0f)},
-        {Text::Alignment{}},
+        {shared.addFont(font, 8.0f)},
+        {Text::Alignment::MiddleCenter},
         {}, {}, {}, {}, {}, {});
 
     struct Layer: TextLayer {
         explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
     } layer{layerHandle(0, 1), shared};
 
-    DataHandle text = layer.create(0, "", {});
-    DataHandle glyph = layer.createGlyph(0, 0, {});
+    /* The advances are 2, 3 and 4, scaled to 0.5, the height is ascent and
+       descent scaled to 0.5. The rectangle is centered. */
+    Range2D rectangle = shared.measureText(0, "hey", {});
+    CORRADE_COMPARE(rectangle, (Range2D{{-2.25f, -3.0f}, {2.25f, 3.0f}}));
+    CORRADE_COMPARE(font.shapeCalled, 1);
+    CORRADE_COMPARE(shared.shapeCacheUsedCount(), 1);
+    CORRADE_COMPARE(layer.usedCount(), 0);
 
-    std::ostringstream out;
-    Error redirectError{&out};
-    layer.cursor(text);
-    layer.cursor(glyph);
-    layer.setCursor(text, 0);
-    layer.setCursor(glyph, 0);
-    layer.textProperties(text);
-    layer.textProperties(glyph);
-    layer.text(text);
-    layer.text(glyph);
-    layer.updateText(text, 0, 0, 0, {}, 0);
-    layer.updateText(glyph, 0, 0, 0, {}, 0);
-    layer.editText(text, TextEdit::MoveCursorLeft, {});
-    layer.editText(glyph, TextEdit::MoveCursorLeft, {});
-    CORRADE_COMPARE_AS(out.str(),
-        "Ui::TextLayer::cursor(): text doesn't have Ui::TextDataFlag::Editable set\n"
-        "Ui::TextLayer::cursor(): text doesn't have Ui::TextDataFlag::Editable set\n"
-        "Ui::TextLayer::setCursor(): text doesn't have Ui::TextDataFlag::Editable set\n"
-        "Ui::TextLayer::setCursor(): text doesn't have Ui::TextDataFlag::Editable set\n"
-        "Ui::TextLayer::textProperties(): text doesn't have Ui::TextDataFlag::Editable set\n"
-        "Ui::TextLayer::textProperties(): text doesn't have Ui::TextDataFlag::Editable set\n"
-        "Ui::TextLayer::text(): text doesn't have Ui::TextDataFlag::Editable set\n"
-        "Ui::TextLayer::text(): text doesn't have Ui::TextDataFlag::Editable set\n"
-        "Ui::TextLayer::updateText(): text doesn't have Ui::TextDataFlag::Editable set\n"
-        "Ui::TextLayer::updateText(): text doesn't have Ui::TextDataFlag::Editable set\n"
-        "Ui::TextLayer::editText(): text doesn't have Ui::TextDataFlag::Editable set\n"
-        "Ui::TextLayer::editText(): text doesn't have Ui::TextDataFlag::Editable set\n",
-        TestSuite::Compare::String);
+    /* Creating the same text afterwards gives the same size and doesn't shape
+       again */
+    DataHandle text = layer.create(0, "hey", {});
+    CORRADE_COMPARE(layer.size(text), rectangle.size());
+    CORRADE_COMPARE(font.shapeCalled, 1);
+
+    /* Multi-line text is measured the same as it'd be created, reusing the
+       already cached line */
+    rectangle = shared.measureText(0, "hi\nhey", {});
+    CORRADE_COMPARE(rectangle.size(), (Vector2{4.5f, 14.0f}));
+    CORRADE_COMPARE(font.shapeCalled, 2);
+    layer.setText(text, "hi\nhey", {});
+    CORRADE_COMPARE(layer.size(text), rectangle.size());
+    CORRADE_COMPARE(font.shapeCalled, 2);
+
+    /* Alignment from the properties is used instead of the style one */
+    CORRADE_COMPARE(shared.measureText(0, "hey", TextProperties{}.setAlignment(Text::Alignment::BottomLeft)), (Range2D{{0.0f, 0.0f}, {4.5f, 6.0f}}));
 }
 
-void TextLayerTest::noSharedStyleFonts() {
+void TextLayerTest::sharedMeasureTextInvalid() {
     CORRADE_SKIP_IF_NO_ASSERT();
 
     struct: Text::AbstractFont {
@@ -7740,7 +8829,7 @@ void TextLayerTest::noSharedStyleFonts() {
         void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
         Vector2 doGlyphSize(UnsignedInt) override { return {}; }
         Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
-        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<OneGlyphShaper>(*this); }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<ThreeGlyphShaper>(*this); }
     } font;
 
     struct: Text::AbstractGlyphCache {
@@ -7749,7 +8838,8 @@ void TextLayerTest::noSharedStyleFonts() {
         Text::GlyphCacheFeatures doFeatures() const override { return {}; }
         void doSetImage(const Vector2i&, const ImageView2D&) override {}
     } cache{PixelFormat::R8Unorm, {32, 32, 2}};
-    cache.addFont(67, &font);
+    cache.addFont(98, &font);
+    UnsignedInt instancelessFontId = cache.addFont(67);
 
     struct LayerShared: TextLayer::Shared {
         explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
@@ -7758,58 +8848,80 @@ void TextLayerTest::noSharedStyleFonts() {
 
         void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
         void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
-    } shared{TextLayer::Shared::Configuration{4}
-        .setDynamicStyleCount(2)
-    };
+    } shared{TextLayer::Shared::Configuration{2}}, sharedNoStyle{TextLayer::Shared::Configuration{1}};
     shared.setGlyphCache(cache);
-
-    FontHandle fontHandle = shared.addFont(font, 1.0f);
-
+    FontHandle instancelessFont = shared.addInstancelessFont(instancelessFontId, 1.0f);
     shared.setStyle(TextLayerCommonStyleUniform{},
-        {TextLayerStyleUniform{}, TextLayerStyleUniform{}, TextLayerStyleUniform{}, TextLayerStyleUniform{}},
-        {fontHandle, FontHandle::Null, fontHandle, FontHandle::Null},
-        {Text::Alignment{}, Text::Alignment{}, Text::Alignment{}, Text::Alignment{}},
+        {TextLayerStyleUniform{}, TextLayerStyleUniform{}},
+        {shared.addFont(font, 1.0f), FontHandle::Null},
+        {Text::Alignment::MiddleCenter, Text::Alignment::MiddleCenter},
         {}, {}, {}, {}, {}, {});
 
-    struct Layer: TextLayer {
-        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
-    } layer{layerHandle(0, 1), shared};
-
-    DataHandle layerData = layer.create(1, "", fontHandle);
-    DataHandle layerDataDynamic = layer.create(5, "", fontHandle);
-
     std::ostringstream out;
     Error redirectError{&out};
-    layer.create(1, "", {});
-    layer.create(4, "", {});
-    layer.createGlyph(3, 0, {});
-    layer.createGlyph(5, 0, {});
-    layer.setText(layerData, "", {});
-    layer.setText(layerDataDynamic, "", {});
-    layer.setGlyph(layerData, 1, {});
-    layer.setGlyph(layerDataDynamic, 1, {});
+    sharedNoStyle.measureText(0, "hello", {});
+    shared.measureText(2, "hello", {});
+    shared.measureText(1, "hello", {});
+    shared.measureText(0, "hello", TextProperties{}.setFont(FontHandle(0x12ab)));
+    shared.measureText(0, "hello", TextProperties{}.setFont(instancelessFont));
     CORRADE_COMPARE_AS(out.str(),
-        "Ui::TextLayer::create(): style 1 has no font set and no custom font was supplied\n"
-        "Ui::TextLayer::create(): dynamic style 0 has no font set and no custom font was supplied\n"
-        "Ui::TextLayer::createGlyph(): style 3 has no font set and no custom font was supplied\n"
-        "Ui::TextLayer::createGlyph(): dynamic style 1 has no font set and no custom font was supplied\n"
-        "Ui::TextLayer::setText(): style 1 has no font set and no custom font was supplied\n"
-        "Ui::TextLayer::setText(): dynamic style 1 has no font set and no custom font was supplied\n"
-        "Ui::TextLayer::setGlyph(): style 1 has no font set and no custom font was supplied\n"
-        "Ui::TextLayer::setGlyph(): dynamic style 1 has no font set and no custom font was supplied\n",
+        "Ui::TextLayer::Shared::measureText(): no style data was set\n"
+        "Ui::TextLayer::Shared::measureText(): style 2 out of range for 2 styles\n"
+        "Ui::TextLayer::Shared::measureText(): style 1 has no font set and no custom font was supplied\n"
+        "Ui::TextLayer::Shared::measureText(): invalid handle Ui::FontHandle(0x12ab, 0x0)\n"
+        "Ui::TextLayer::Shared::measureText(): Ui::FontHandle(0x1, 0x1) is an instance-less font\n",
         TestSuite::Compare::String);
 }
 
-void TextLayerTest::noFontInstance() {
-    CORRADE_SKIP_IF_NO_ASSERT();
+void TextLayerTest::createSetTextShaperPool() {
+    struct Shaper: ThreeGlyphShaper {
+        explicit Shaper(Text::AbstractFont& font, Containers::Array<Text::Script>& scripts): ThreeGlyphShaper{font}, scripts(scripts) {}
+
+        bool doSetScript(Text::Script script) override {
+            arrayAppend(scripts, script);
+            return true;
+        }
+
+        Containers::Array<Text::Script>& scripts;
+    };
+
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return _opened; }
+        Properties doOpenFile(Containers::StringView, Float size) override {
+            _opened = true;
+            return {size, 8.0f, -4.0f, 16.0f, 98};
+        }
+        void doClose() override { _opened = false; }
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override {
+            ++createShaperCalled;
+            return Containers::pointer<Shaper>(*this, scripts);
+        }
+
+        int createShaperCalled = 0;
+        Containers::Array<Text::Script> scripts;
+
+        bool _opened = false;
+    } font;
+    font.openFile({}, 16.0f);
 
     struct: Text::AbstractGlyphCache {
         using Text::AbstractGlyphCache::AbstractGlyphCache;
 
         Text::GlyphCacheFeatures doFeatures() const override { return {}; }
         void doSetImage(const Vector2i&, const ImageView2D&) override {}
-    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
-    UnsignedInt glyphCacheInstanceLessFontId = cache.addFont(233);
+    /* Default padding is 1, resetting to 0 for simplicity */
+    } cache{PixelFormat::R8Unorm, {32, 32}, {}};
+    {
+        UnsignedInt fontId = cache.addFont(font.glyphCount(), &font);
+        cache.addGlyph(fontId, 22, {}, {});
+        cache.addGlyph(fontId, 13, {}, {});
+        cache.addGlyph(fontId, 97, {}, {});
+    }
 
     struct LayerShared: TextLayer::Shared {
         explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
@@ -7821,61 +8933,120 @@ void TextLayerTest::noFontInstance() {
     } shared{TextLayer::Shared::Configuration{1}};
     shared.setGlyphCache(cache);
 
-    FontHandle fontHandle1 = shared.addInstancelessFont(glyphCacheInstanceLessFontId, 0.1f);
-    FontHandle fontHandle2 = shared.addInstancelessFont(glyphCacheInstanceLessFontId, 0.1f);
+    FontHandle fontHandle = shared.addFont(font, 8.0f);
     shared.setStyle(TextLayerCommonStyleUniform{},
         {TextLayerStyleUniform{}},
-        {fontHandle1},
-        {Text::Alignment{}},
+        {fontHandle},
+        {Text::Alignment::MiddleCenter},
         {}, {}, {}, {}, {}, {});
 
     struct Layer: TextLayer {
         explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
     } layer{layerHandle(0, 1), shared};
 
-    DataHandle data = layer.createGlyph(0, 0, {});
-
-    std::ostringstream out;
-    Error redirectError{&out};
-    layer.create(0, "", {});
-    layer.create(0, "", fontHandle2);
-    layer.setText(data, "", {});
-    layer.setText(data, "", fontHandle2);
-    CORRADE_COMPARE(out.str(),
-        "Ui::TextLayer::create(): Ui::FontHandle(0x0, 0x1) is an instance-less font\n"
-        "Ui::TextLayer::create(): Ui::FontHandle(0x1, 0x1) is an instance-less font\n"
-        "Ui::TextLayer::setText(): Ui::FontHandle(0x0, 0x1) is an instance-less font\n"
-        "Ui::TextLayer::setText(): Ui::FontHandle(0x1, 0x1) is an instance-less font\n");
+    /* Each new combination of properties creates a new shaper, switching back
+       to a previous one doesn't reconfigure anything */
+    layer.create(0, "hello", TextProperties{}.setScript(Text::Script::Latin));
+    layer.create(0, "hello", TextProperties{}.setScript(Text::Script::Arabic));
+    layer.create(0, "hello", TextProperties{}.setScript(Text::Script::Latin));
+    CORRADE_COMPARE(font.createShaperCalled, 2);
+    CORRADE_COMPARE_AS(font.scripts, Containers::arrayView({
+        Text::Script::Latin,
+        Text::Script::Arabic
+    }), TestSuite::Compare::Container);
+
+    /* Language or direction are a part of the key as well */
+    layer.create(0, "hello", TextProperties{}
+        .setScript(Text::Script::Latin)
+        .setLanguage("cs"));
+    layer.create(0, "hello", TextProperties{}
+        .setScript(Text::Script::Latin)
+        .setShapeDirection(Text::ShapeDirection::RightToLeft));
+    CORRADE_COMPARE(font.createShaperCalled, 4);
+    CORRADE_COMPARE_AS(font.scripts, Containers::arrayView({
+        Text::Script::Latin,
+        Text::Script::Arabic,
+        Text::Script::Latin,
+        Text::Script::Latin
+    }), TestSuite::Compare::Container);
+
+    /* The pool is full now, so the least recently used shaper, which is the
+       Arabic one, gets reconfigured */
+    layer.create(0, "hello", TextProperties{}.setScript(Text::Script::Greek));
+    layer.create(0, "hello", TextProperties{}.setScript(Text::Script::Latin));
+    CORRADE_COMPARE(font.createShaperCalled, 4);
+    CORRADE_COMPARE_AS(font.scripts, Containers::arrayView({
+        Text::Script::Latin,
+        Text::Script::Arabic,
+        Text::Script::Latin,
+        Text::Script::Latin,
+        Text::Script::Greek
+    }), TestSuite::Compare::Container);
+
+    /* Arabic is thus not in the pool anymore, the least recently used shaper
+       is now the Czech one */
+    layer.create(0, "hello", TextProperties{}.setScript(Text::Script::Arabic));
+    CORRADE_COMPARE(font.createShaperCalled, 4);
+    CORRADE_COMPARE_AS(font.scripts, Containers::arrayView({
+        Text::Script::Latin,
+        Text::Script::Arabic,
+        Text::Script::Latin,
+        Text::Script::Latin,
+        Text::Script::Greek,
+        Text::Script::Arabic
+    }), TestSuite::Compare::Container);
 }
 
-void TextLayerTest::styleOutOfRange() {
-    auto&& data = StyleOutOfRangeData[testCaseInstanceId()];
-    setTestCaseDescription(data.name);
+void TextLayerTest::createSetTextDeferredShaping() {
+    struct Shaper: ThreeGlyphShaper {
+        explicit Shaper(Text::AbstractFont& font, int& shapeCalled): ThreeGlyphShaper{font}, shapeCalled(shapeCalled) {}
 
-    CORRADE_SKIP_IF_NO_ASSERT();
+        UnsignedInt doShape(Containers::StringView text, UnsignedInt begin, UnsignedInt end, Containers::ArrayView<const Text::FeatureRange> features) override {
+            ++shapeCalled;
+            return ThreeGlyphShaper::doShape(text, begin, end, features);
+        }
+
+        int& shapeCalled;
+    };
 
     struct: Text::AbstractFont {
         Text::FontFeatures doFeatures() const override { return {}; }
-        bool doIsOpened() const override { return true; }
-        void doClose() override {}
+        bool doIsOpened() const override { return _opened; }
+        Properties doOpenFile(Containers::StringView, Float size) override {
+            _opened = true;
+            return {size, 8.0f, -4.0f, 16.0f, 98};
+        }
+        void doClose() override { _opened = false; }
 
         void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
         Vector2 doGlyphSize(UnsignedInt) override { return {}; }
         Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
-        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override {
+            ++createShaperCalled;
+            return Containers::pointer<Shaper>(*this, shapeCalled);
+        }
+
+        int createShaperCalled = 0;
+        int shapeCalled = 0;
+
+        bool _opened = false;
     } font;
+    font.openFile({}, 16.0f);
 
     struct: Text::AbstractGlyphCache {
         using Text::AbstractGlyphCache::AbstractGlyphCache;
 
         Text::GlyphCacheFeatures doFeatures() const override { return {}; }
         void doSetImage(const Vector2i&, const ImageView2D&) override {}
-    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
-    cache.addFont(56, &font);
+    /* Default padding is 1, resetting to 0 for simplicity */
+    } cache{PixelFormat::R8Unorm, {32, 32}, {}};
+    {
+        UnsignedInt fontId = cache.addFont(font.glyphCount(), &font);
+        cache.addGlyph(fontId, 22, {}, {});
+        cache.addGlyph(fontId, 13, {}, {});
+        cache.addGlyph(fontId, 97, {}, {});
+    }
 
-    /* In this case the uniform count is higher than the style count, which is
-       unlikely to happen in practice. It's to verify the check happens against
-       the style count, not uniform count. */
     struct LayerShared: TextLayer::Shared {
         explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
 
@@ -7883,47 +9054,127 @@ void TextLayerTest::styleOutOfRange() {
 
         void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
         void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
-    } shared{TextLayer::Shared::Configuration{6, data.styleCount}
-        .setDynamicStyleCount(data.dynamicStyleCount)
-    };
+    } shared{TextLayer::Shared::Configuration{1}};
     shared.setGlyphCache(cache);
 
-    FontHandle fontHandle = shared.addFont(font, 1.0f);
-
-    shared.setStyle(
-        TextLayerCommonStyleUniform{},
-        Containers::arrayView({TextLayerStyleUniform{}, TextLayerStyleUniform{}, TextLayerStyleUniform{}, TextLayerStyleUniform{}, TextLayerStyleUniform{}, TextLayerStyleUniform{}}),
-        Containers::arrayView({0u, 1u, 2u}).prefix(data.styleCount),
-        Containers::arrayView({fontHandle, fontHandle, fontHandle}).prefix(data.styleCount),
-        Containers::arrayView({Text::Alignment{}, Text::Alignment{}, Text::Alignment{}}).prefix(data.styleCount),
+    FontHandle fontHandle = shared.addFont(font, 8.0f);
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {fontHandle},
+        {Text::Alignment::MiddleCenter},
         {}, {}, {}, {}, {}, {});
 
     struct Layer: TextLayer {
         explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
     } layer{layerHandle(0, 1), shared};
 
-    std::ostringstream out;
-    Error redirectError{&out};
-    layer.create(3, "", {});
-    layer.createGlyph(3, 0, {});
-    CORRADE_COMPARE(out.str(),
-        "Ui::TextLayer::create(): style 3 out of range for 3 styles\n"
-        "Ui::TextLayer::createGlyph(): style 3 out of range for 3 styles\n");
+    /* Nothing is shaped on creation, the data has no glyphs */
+    DataHandle first = layer.create(0, "hello", {}, TextDataFlag::DeferredShaping);
+    CORRADE_COMPARE(layer.flags(first), TextDataFlag::DeferredShaping);
+    CORRADE_COMPARE(font.shapeCalled, 0);
+    CORRADE_COMPARE(layer.glyphCount(first), 0);
+    CORRADE_COMPARE(layer.size(first), Vector2{});
+    CORRADE_COMPARE_AS(layer.state(), LayerState::NeedsDataUpdate,
+        TestSuite::Compare::GreaterOrEqual);
+
+    /* Data removed before the update don't get shaped at all */
+    DataHandle removed = layer.create(0, "hey", {}, TextDataFlag::DeferredShaping);
+    layer.remove(removed);
+
+    /* The text gets shaped in the update */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(font.shapeCalled, 1);
+    CORRADE_COMPARE(layer.glyphCount(first), 5);
+    Vector2 firstSize = layer.size(first);
+    CORRADE_VERIFY(!firstSize.isZero());
+
+    /* Setting a text keeps the previous one until the next update, setting it
+       again before the update replaces the pending text */
+    layer.setText(first, "hey", {});
+    layer.setText(first, "hi", {});
+    CORRADE_COMPARE(font.shapeCalled, 1);
+    CORRADE_COMPARE(layer.glyphCount(first), 5);
+    CORRADE_COMPARE(layer.size(first), firstSize);
+
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(font.shapeCalled, 2);
+    CORRADE_COMPARE(layer.glyphCount(first), 2);
+
+    /* Setting a text without the flag shapes it directly and cancels what's
+       pending */
+    layer.setText(first, "hello", {}, TextDataFlag::DeferredShaping);
+    layer.setText(first, "hey", {}, {});
+    CORRADE_COMPARE(font.shapeCalled, 3);
+    CORRADE_COMPARE(layer.glyphCount(first), 3);
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(font.shapeCalled, 3);
+    CORRADE_COMPARE(layer.glyphCount(first), 3);
+
+    /* With an executor, each text is shaped in a separate task with a
+       dedicated shaper */
+    Containers::Array<UnsignedInt> executorCalls;
+    layer.setShapeExecutor([](UnsignedInt count, void(*task)(void*, UnsignedInt), void* taskState, void* userData) {
+        arrayAppend(*static_cast<Containers::Array<UnsignedInt>*>(userData), count);
+        /* Going in reverse to verify the order doesn't matter */
+        for(UnsignedInt i = count; i != 0; --i)
+            task(taskState, i - 1);
+    }, &executorCalls);
+    CORRADE_VERIFY(layer.shapeExecutor());
+    CORRADE_COMPARE(layer.shapeExecutorUserData(), &executorCalls);
+
+    int createShaperCalled = font.createShaperCalled;
+    DataHandle second = layer.create(0, "hello", {}, TextDataFlag::DeferredShaping);
+    DataHandle third = layer.create(0, "hi", {}, TextDataFlag::DeferredShaping);
+    layer.setText(first, "hello!", {}, TextDataFlag::DeferredShaping);
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE_AS(executorCalls, Containers::arrayView<UnsignedInt>({
+        3
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(font.createShaperCalled, createShaperCalled + 3);
+    CORRADE_COMPARE(font.shapeCalled, 6);
+    CORRADE_COMPARE(layer.glyphCount(first), 6);
+    CORRADE_COMPARE(layer.glyphCount(second), 5);
+    CORRADE_COMPARE(layer.glyphCount(third), 2);
+    /* The result is the same as when shaped directly */
+    CORRADE_COMPARE(layer.size(second), firstSize);
+
+    /* The shapers are reused next time, and a single text isn't passed to the
+       executor */
+    layer.setText(second, "hey", {});
+    layer.setText(third, "hey", {});
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    layer.setText(third, "hello", {});
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE_AS(executorCalls, Containers::arrayView<UnsignedInt>({
+        3, 2
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(font.createShaperCalled, createShaperCalled + 3);
+    CORRADE_COMPARE(font.shapeCalled, 9);
+    CORRADE_COMPARE(layer.glyphCount(second), 3);
+    CORRADE_COMPARE(layer.glyphCount(third), 5);
 }
 
-void TextLayerTest::glyphOutOfRange() {
+void TextLayerTest::createSetTextDeferredShapingEditable() {
     CORRADE_SKIP_IF_NO_ASSERT();
 
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return true; }
+        void doClose() override {}
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<OneGlyphShaper>(*this); }
+    } font;
+
     struct: Text::AbstractGlyphCache {
         using Text::AbstractGlyphCache::AbstractGlyphCache;
 
         Text::GlyphCacheFeatures doFeatures() const override { return {}; }
         void doSetImage(const Vector2i&, const ImageView2D&) override {}
     } cache{PixelFormat::R8Unorm, {32, 32, 2}};
-
-    /* Add one more font to verify it's checking the right one */
-    cache.addFont(57);
-    UnsignedInt glyphCacheFontId = cache.addFont(56);
+    cache.addFont(67, &font);
 
     struct LayerShared: TextLayer::Shared {
         explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
@@ -7932,33 +9183,32 @@ void TextLayerTest::glyphOutOfRange() {
 
         void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
         void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
-    } shared{TextLayer::Shared::Configuration{2, 3}};
+    } shared{TextLayer::Shared::Configuration{1}};
     shared.setGlyphCache(cache);
-
-    FontHandle fontHandle = shared.addInstancelessFont(glyphCacheFontId, 1.0f);
+    /* Can't be chained together, see createSetTextTextPropertiesEditableInvalid() */
     shared.setStyle(TextLayerCommonStyleUniform{},
-        {TextLayerStyleUniform{}, TextLayerStyleUniform{}},
-        {0, 1, 0},
-        {fontHandle, fontHandle, fontHandle},
-        {Text::Alignment{}, Text::Alignment{}, Text::Alignment{}},
+        {TextLayerStyleUniform{}},
+        {shared.addFont(font, 1.0f)},
+        {Text::Alignment::MiddleCenter},
         {}, {}, {}, {}, {}, {});
 
     struct Layer: TextLayer {
         explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
     } layer{layerHandle(0, 1), shared};
 
-    DataHandle data = layer.createGlyph(2, 55, {});
+    DataHandle handle = layer.create(0, "hello", {});
 
     std::ostringstream out;
     Error redirectError{&out};
-    layer.createGlyph(2, 56, {});
-    layer.setGlyph(data, 56, {});
-    CORRADE_COMPARE(out.str(),
-        "Ui::TextLayer::createGlyph(): glyph 56 out of range for 56 glyphs in glyph cache font 1\n"
-        "Ui::TextLayer::setGlyph(): glyph 56 out of range for 56 glyphs in glyph cache font 1\n");
+    layer.create(0, "hello", {}, TextDataFlag::Editable|TextDataFlag::DeferredShaping);
+    layer.setText(handle, "hello", {}, TextDataFlag::Editable|TextDataFlag::DeferredShaping);
+    CORRADE_COMPARE_AS(out.str(),
+        "Ui::TextLayer::create(): deferred shaping of an editable text is not implemented yet, sorry\n"
+        "Ui::TextLayer::setText(): deferred shaping of an editable text is not implemented yet, sorry\n",
+        TestSuite::Compare::String);
 }
 
-void TextLayerTest::updateEmpty() {
+void TextLayerTest::createSetTextDeferredShapingBudget() {
     struct: Text::AbstractFont {
         Text::FontFeatures doFeatures() const override { return {}; }
         bool doIsOpened() const override { return true; }
@@ -7967,7 +9217,7 @@ void TextLayerTest::updateEmpty() {
         void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
         Vector2 doGlyphSize(UnsignedInt) override { return {}; }
         Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
-        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<ThreeGlyphShaper>(*this); }
     } font;
 
     struct: Text::AbstractGlyphCache {
@@ -7976,7 +9226,7 @@ void TextLayerTest::updateEmpty() {
         Text::GlyphCacheFeatures doFeatures() const override { return {}; }
         void doSetImage(const Vector2i&, const ImageView2D&) override {}
     } cache{PixelFormat::R8Unorm, {32, 32, 2}};
-    cache.addFont(56, &font);
+    cache.addFont(98, &font);
 
     struct LayerShared: TextLayer::Shared {
         explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
@@ -7987,69 +9237,175 @@ void TextLayerTest::updateEmpty() {
         void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
     } shared{TextLayer::Shared::Configuration{1}};
     shared.setGlyphCache(cache);
-
-    FontHandle fontHandle = shared.addFont(font, 1.0f);
-    shared.setStyle(
-        TextLayerCommonStyleUniform{},
+    shared.setStyle(TextLayerCommonStyleUniform{},
         {TextLayerStyleUniform{}},
-        {fontHandle},
+        {shared.addFont(font, 1.0f)},
         {Text::Alignment::MiddleCenter},
         {}, {}, {}, {}, {}, {});
 
     struct Layer: TextLayer {
         explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
-
-        LayerFeatures doFeatures() const override { return {}; }
     } layer{layerHandle(0, 1), shared};
 
-    /* Shouldn't crash or do anything weird */
-    layer.update(LayerState::NeedsNodeEnabledUpdate|LayerState::NeedsNodeOpacityUpdate|LayerState::NeedsNodeOrderUpdate|LayerState::NeedsNodeOffsetSizeUpdate|LayerState::NeedsAttachmentUpdate|LayerState::NeedsDataUpdate|LayerState::NeedsCommonDataUpdate|LayerState::NeedsSharedDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
-    CORRADE_VERIFY(true);
-}
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
 
-void TextLayerTest::updateCleanDataOrder() {
-    auto&& data = UpdateCleanDataOrderData[testCaseInstanceId()];
-    setTestCaseDescription(data.name);
+    /* No budget by default */
+    CORRADE_COMPARE(layer.deferredShapeBudget(), 0);
+    layer.setDeferredShapeBudget(2);
+    CORRADE_COMPARE(layer.deferredShapeBudget(), 2);
+
+    DataHandle first = layer.create(0, "hello", {}, TextDataFlag::DeferredShaping);
+    DataHandle removed = layer.create(0, "hey", {}, TextDataFlag::DeferredShaping);
+    DataHandle second = layer.create(0, "hi", {}, TextDataFlag::DeferredShaping);
+    DataHandle third = layer.create(0, "heya", {}, TextDataFlag::DeferredShaping);
+    DataHandle fourth = layer.create(0, "yo", {}, TextDataFlag::DeferredShaping);
+    /* Removed data don't count towards the budget */
+    layer.remove(removed);
+
+    /* The first update shapes only the first two texts, the rest stays
+       without glyphs and the layer still needs an update */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.glyphCount(first), 5);
+    CORRADE_COMPARE(layer.glyphCount(second), 2);
+    CORRADE_COMPARE(layer.glyphCount(third), 0);
+    CORRADE_COMPARE(layer.glyphCount(fourth), 0);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
 
-    /* Does just extremely basic verification that the vertex and index data
-       get filled with correct contents and in correct order. The actual visual
-       output is checked in TextLayerGLTest. */
+    /* Setting a text of one that's still pending cancels it and puts the new
+       one after the remaining ones, together with newly created texts */
+    layer.setText(third, "hello!", {});
+    DataHandle fifth = layer.create(0, "hello", {}, TextDataFlag::DeferredShaping);
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.glyphCount(fourth), 2);
+    CORRADE_COMPARE(layer.glyphCount(third), 6);
+    CORRADE_COMPARE(layer.glyphCount(fifth), 0);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* The last one gets shaped in the third update, after which no update is
+       needed anymore */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.glyphCount(fifth), 5);
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Resetting the budget shapes everything at once again */
+    layer.setDeferredShapeBudget(0);
+    layer.setText(first, "hey", {});
+    layer.setText(second, "hey", {});
+    layer.setText(third, "hey", {});
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.glyphCount(first), 3);
+    CORRADE_COMPARE(layer.glyphCount(second), 3);
+    CORRADE_COMPARE(layer.glyphCount(third), 3);
+}
+
+void TextLayerTest::createSetTextDeferredShapingConcurrentUpdate() {
+    CORRADE_SKIP_IF_NO_ASSERT();
 
     struct: Text::AbstractFont {
         Text::FontFeatures doFeatures() const override { return {}; }
-        bool doIsOpened() const override { return _opened; }
-        Properties doOpenFile(Containers::StringView, Float size) override {
-            _opened = true;
-            return {size, 8.0f, -4.0f, 16.0f, 98};
-        }
-        void doClose() override { _opened = false; }
+        bool doIsOpened() const override { return true; }
+        void doClose() override {}
 
         void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
         Vector2 doGlyphSize(UnsignedInt) override { return {}; }
         Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
-        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<ThreeGlyphShaper>(*this); }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<OneGlyphShaper>(*this); }
+    } font;
 
-        bool _opened = false;
-    } threeGlyphFont;
-    threeGlyphFont.openFile({}, 16.0f);
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
+    cache.addFont(67, &font);
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{1}};
+    shared.setGlyphCache(cache);
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {shared.addFont(font, 1.0f)},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared}, anotherLayer{layerHandle(1, 1), shared};
+
+    /* Pretending a parallel layer update executor is updating the other
+       layer while this one is running its shape executor. Without any
+       deferred text the other layer doesn't touch the shared state and so can
+       be updated. */
+    layer.setShapeExecutor([](UnsignedInt count, void(*task)(void*, UnsignedInt), void* taskState, void* userData) {
+        static_cast<Layer*>(userData)->update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+        for(UnsignedInt i = 0; i != count; ++i)
+            task(taskState, i);
+    }, &anotherLayer);
+    layer.create(0, "hello", {}, TextDataFlag::DeferredShaping);
+    layer.create(0, "hey", {}, TextDataFlag::DeferredShaping);
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+
+    DataHandle another = anotherLayer.create(0, "hi", {}, TextDataFlag::DeferredShaping);
+    layer.create(0, "hello", {}, TextDataFlag::DeferredShaping);
+    layer.create(0, "hey", {}, TextDataFlag::DeferredShaping);
+
+    std::ostringstream out;
+    {
+        Error redirectError{&out};
+        layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    }
+    CORRADE_COMPARE_AS(out.str(),
+        "Ui::TextLayer::update(): another layer using the same shared state is shaping at the same time, layers sharing a TextLayer::Shared can't be updated in parallel\n",
+        TestSuite::Compare::String);
+
+    /* Once the first layer finishes, the other can be updated again */
+    CORRADE_COMPARE(anotherLayer.glyphCount(another), 0);
+    anotherLayer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(anotherLayer.glyphCount(another), 1);
+}
+
+void TextLayerTest::createSetTextHibernate() {
+    struct Shaper: ThreeGlyphShaper {
+        explicit Shaper(Text::AbstractFont& font, int& shapeCalled): ThreeGlyphShaper{font}, shapeCalled(shapeCalled) {}
+
+        UnsignedInt doShape(Containers::StringView text, UnsignedInt begin, UnsignedInt end, Containers::ArrayView<const Text::FeatureRange> features) override {
+            ++shapeCalled;
+            return ThreeGlyphShaper::doShape(text, begin, end, features);
+        }
+
+        int& shapeCalled;
+    };
 
     struct: Text::AbstractFont {
         Text::FontFeatures doFeatures() const override { return {}; }
         bool doIsOpened() const override { return _opened; }
         Properties doOpenFile(Containers::StringView, Float size) override {
             _opened = true;
-            return {size, 1.0f, -0.5f, 2.0f, 67};
+            return {size, 8.0f, -4.0f, 16.0f, 98};
         }
         void doClose() override { _opened = false; }
 
         void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
         Vector2 doGlyphSize(UnsignedInt) override { return {}; }
         Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
-        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<OneGlyphShaper>(*this); }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override {
+            return Containers::pointer<Shaper>(*this, shapeCalled);
+        }
+
+        int shapeCalled = 0;
 
         bool _opened = false;
-    } oneGlyphFont;
-    oneGlyphFont.openFile({}, 2.0f);
+    } font;
+    font.openFile({}, 16.0f);
 
     struct: Text::AbstractGlyphCache {
         using Text::AbstractGlyphCache::AbstractGlyphCache;
@@ -8057,21 +9413,12 @@ void TextLayerTest::updateCleanDataOrder() {
         Text::GlyphCacheFeatures doFeatures() const override { return {}; }
         void doSetImage(const Vector2i&, const ImageView2D&) override {}
     /* Default padding is 1, resetting to 0 for simplicity */
-    } cache{PixelFormat::R8Unorm, {32, 32, 3}, {}};
-
-    /* +--+--+
-       |66|13|
-       +-----+
-       | 97  |
-       +-----+ */
+    } cache{PixelFormat::R8Unorm, {32, 32}, {}};
     {
-        UnsignedInt fontId = cache.addFont(threeGlyphFont.glyphCount(), &threeGlyphFont);
-        cache.addGlyph(fontId, 97, {8, 4}, 2, {{}, {32, 16}});
-        /* Glyph 22 deliberately omitted */
-        cache.addGlyph(fontId, 13, {4, -8}, 0, {{16, 16}, {32, 32}});
-    } {
-        UnsignedInt fontId = cache.addFont(oneGlyphFont.glyphCount(), &oneGlyphFont);
-        cache.addGlyph(fontId, 66, {}, 1, {{0, 16}, {16, 32}});
+        UnsignedInt fontId = cache.addFont(font.glyphCount(), &font);
+        cache.addGlyph(fontId, 22, {}, {});
+        cache.addGlyph(fontId, 13, {}, {});
+        cache.addGlyph(fontId, 97, {}, {});
     }
 
     struct LayerShared: TextLayer::Shared {
@@ -8081,112 +9428,21 @@ void TextLayerTest::updateCleanDataOrder() {
 
         void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
         void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
-    } shared{TextLayer::Shared::Configuration{6, data.styleCount}
-        .setEditingStyleCount(data.editingStyleCount ? 4 : 0, data.editingStyleCount)
-        .setDynamicStyleCount(data.dynamicStyleCount, data.hasEditingStyles)
-    };
+    } shared{TextLayer::Shared::Configuration{1}};
     shared.setGlyphCache(cache);
 
-    /* The three-glyph font is scaled to 0.5, the one-glyph to 2.0 */
-    FontHandle threeGlyphFontHandle = shared.addFont(threeGlyphFont, 8.0f);
-    FontHandle oneGlyphFontHandle = shared.addFont(oneGlyphFont, 4.0f);
-
-    if(data.styleCount == 6) {
-        shared.setStyle(TextLayerCommonStyleUniform{},
-            /* Last two uniforms only get referenced by editing styles */
-            {TextLayerStyleUniform{}, TextLayerStyleUniform{},
-             TextLayerStyleUniform{}, TextLayerStyleUniform{},
-             TextLayerStyleUniform{}, TextLayerStyleUniform{}},
-            /* Style 5 doesn't get used (gets transitioned to 2), use an
-               otherwise unused uniform index and weird padding to verify it
-               doesn't get picked. The font handle should however match style 2
-               as it can't be transitioned. */
-            {1, 2, 0, 1, 1, 3},
-            {oneGlyphFontHandle, oneGlyphFontHandle, threeGlyphFontHandle, threeGlyphFontHandle, threeGlyphFontHandle, threeGlyphFontHandle},
-            {Text::Alignment::MiddleCenter, Text::Alignment::BottomRight, Text::Alignment::MiddleCenter, Text::Alignment::LineLeft, Text::Alignment::TopCenter, Text::Alignment::MiddleCenter},
-            /* Features affect only create() / createGlyph() / setText() /
-               setGlyph(), not update(); tested in
-               createSetTextTextProperties() */
-            {}, {}, {},
-            {-1,
-             data.editingStyle1.first(), /* used by data7 */
-             data.editingStyle2.first(), /* used by data3 if not dynamic */
-             data.editingStyle3.first(), /* used by data9 */
-             -1,
-             -1},
-            {-1,
-             data.editingStyle1.second(),
-             data.editingStyle2.second(),
-             data.editingStyle3.second(),
-             -1,
-             -1},
-            {{}, {}, data.paddingFromStyle, {}, data.paddingFromStyle, Vector4{666}});
-    } else if(data.styleCount == 4) {
-        shared.setStyle(TextLayerCommonStyleUniform{},
-            /* Last two uniforms only get referenced by editing styles */
-            {TextLayerStyleUniform{}, TextLayerStyleUniform{},
-             TextLayerStyleUniform{}, TextLayerStyleUniform{},
-             TextLayerStyleUniform{}, TextLayerStyleUniform{}},
-            {1, 2, 0, 1},
-            {oneGlyphFontHandle, oneGlyphFontHandle, threeGlyphFontHandle, threeGlyphFontHandle},
-            {Text::Alignment::MiddleCenter, Text::Alignment::BottomRight, Text::Alignment::MiddleCenter, Text::Alignment::LineLeft},
-            /* Features affect only create() / createGlyph() / setText() /
-               setGlyph(), not update(); tested in
-               createSetTextTextProperties() */
-            {}, {}, {},
-            {-1,
-             data.editingStyle1.first(),  /* used by data7 */
-             data.editingStyle2.first(),  /* used by data3 if not dynamic */
-             data.editingStyle3.first()}, /* used by data9 */
-            {-1,
-             data.editingStyle1.second(),
-             data.editingStyle2.second(),
-             data.editingStyle3.second()},
-            {{}, {}, data.paddingFromStyle, {}});
-    } else CORRADE_INTERNAL_ASSERT_UNREACHABLE();
-
-    if(data.editingStyleCount == 3)
-        shared.setEditingStyle(TextLayerCommonEditingStyleUniform{},
-            {TextLayerEditingStyleUniform{}, TextLayerEditingStyleUniform{}, TextLayerEditingStyleUniform{}, TextLayerEditingStyleUniform{}},
-            {2, 0, 3},
-            {5,    /* Style 0 overrides the selection text uniform */
-             -1,   /* Style 1 is only used for cursor, so this is unused */
-             3},   /* Style 2 is used for selection but doesn't override,
-                      redirect to an otherwise-unused slot as well */
-            {{0.03f, 0.04f, 0.05f, 0.06f},
-             {0.06f, 0.07f, 0.08f, 0.09f},
-             {0.01f, 0.02f, 0.03f, 0.04f}});
-    else if(data.editingStyleCount == 2)
-        shared.setEditingStyle(TextLayerCommonEditingStyleUniform{},
-            {TextLayerEditingStyleUniform{}, TextLayerEditingStyleUniform{}, TextLayerEditingStyleUniform{}, TextLayerEditingStyleUniform{}},
-            {0, 3},
-            {-1,   /* Style 0 is only used for cursor, so this is unused */
-             3},   /* Style 1 is used for selection but doesn't override,
-                      redirect to an otherwise-unused slot as well */
-            {{0.06f, 0.07f, 0.08f, 0.09f},
-             {0.01f, 0.02f, 0.03f, 0.04f}});
-    else if(data.editingStyleCount == 0) {
-        if(data.hasEditingStyles)
-            shared.setEditingStyle(TextLayerCommonEditingStyleUniform{},
-                {},
-                {},
-                {});
-    } else CORRADE_INTERNAL_ASSERT_UNREACHABLE();
-
-    shared.setStyleTransition(
-        nullptr,
-        nullptr,
-        nullptr,
-        [](UnsignedInt style) {
-            return style == 5 ? 2u : style;
-        }
-    );
+    FontHandle fontHandle = shared.addFont(font, 8.0f);
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {fontHandle},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
 
     struct Layer: TextLayer {
         explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
 
-        const State& stateData() const {
-            return static_cast<const State&>(*_state);
+        State& stateData() {
+            return static_cast<State&>(*_state);
         }
     } layer{layerHandle(0, 1), shared};
 
@@ -8194,61 +9450,1683 @@ void TextLayerTest::updateCleanDataOrder() {
        guarantees the same on a higher level), not needed for anything here */
     layer.setSize({1, 1}, {1, 1});
 
-    if(data.styleCount < 6 && data.dynamicStyleCount) {
-        /* Dynamic style 0 and 1 is style 4 and 5, which is used by data3 and
-           data5 (so the same case as with padding from non-dynamic style or
-           from data) */
-        CORRADE_COMPARE(data.styleCount + 0, 4);
-        /* Again, features affect only create() / createGlyph() / setText() /
-           setGlyph(), not update(); tested in createSetTextTextProperties() */
-        layer.setDynamicStyle(0, TextLayerStyleUniform{}, threeGlyphFontHandle, Text::Alignment::TopCenter, {}, data.paddingFromStyle);
-        /* setDynamicStyleWithCursor() / setDynamicStyleWithSelection() doesn't
-           affect update() any differently than the combined version, these
-           were tested well enough in dynamicStyleEditingStyles() above so it's
-           just the full-blown function used.
+    DataHandle first = layer.create(0, "hello", {}, TextDataFlag::Hibernatable, nodeHandle(0, 0));
+    DataHandle second = layer.create(0, "hey", {}, nodeHandle(1, 0));
+    CORRADE_COMPARE(layer.flags(first), TextDataFlag::Hibernatable);
+    CORRADE_COMPARE(font.shapeCalled, 2);
+    CORRADE_VERIFY(!layer.isHibernated(first));
+    CORRADE_VERIFY(!layer.isHibernated(second));
 
-           The data.expectEditingDataPresent is checked to handle the case
-           where dynamic editing styles are present but they're not meant to
-           be used. */
-        if((data.editingStyleCount || data.hasEditingStyles) && data.expectEditingDataPresent)
-            layer.setDynamicStyleWithCursorSelection(1,
-                TextLayerStyleUniform{},
-                threeGlyphFontHandle,
-                Text::Alignment::MiddleCenter,
-                {},
-                data.paddingFromStyle,
-                TextLayerEditingStyleUniform{},
-                    /* Padding like original dynamic editing style 1 */
-                    {0.06f, 0.07f, 0.08f, 0.09f},
-                TextLayerEditingStyleUniform{},
-                    /* Not bothering with a non-trivial selection style -- the
-                       actual dynamic uniform ID used is the same in both cases
-                       so it doesn't matter */
-                    {},
-                    /* Padding like original dynamic editing style 0 */
-                    {0.03f, 0.04f, 0.05f, 0.06f});
-        else
-            layer.setDynamicStyle(1, TextLayerStyleUniform{}, threeGlyphFontHandle, Text::Alignment::MiddleCenter, {}, data.paddingFromStyle);
-    }
+    Vector2 nodeOffsets[2]{};
+    Vector2 nodeSizes[2]{{2.0f, 2.0f}, {4.0f, 4.0f}};
+    Float nodeOpacities[2]{1.0f, 1.0f};
+    UnsignedByte nodesEnabledData[1]{};
+    Containers::BitArrayView nodesEnabled{nodesEnabledData, 0, 2};
 
-    /* Two node handles to attach the data to */
-    NodeHandle node6 = nodeHandle(6, 0);
-    NodeHandle node15 = nodeHandle(15, 0);
+    UnsignedInt dataIds[]{0, 1};
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.glyphCount(first), 5);
+    CORRADE_COMPARE(layer.stateData().glyphData.size(), 8);
+    CORRADE_COMPARE(layer.stateData().vertices.size(), 8*4);
+    Vector2 firstSize = layer.size(first);
+    CORRADE_VERIFY(!firstSize.isZero());
+
+    /* Hibernating frees the glyphs but keeps the size */
+    layer.hibernate(first);
+    CORRADE_VERIFY(layer.isHibernated(first));
+    CORRADE_COMPARE(layer.glyphCount(first), 0);
+    CORRADE_COMPARE(layer.size(first), firstSize);
+    CORRADE_COMPARE_AS(layer.state(), LayerState::NeedsDataUpdate,
+        TestSuite::Compare::GreaterOrEqual);
 
-    /* Create 10 data handles. Only four get filled and actually used. */
-    layer.create(0, "", {});                            /* 0, quad 0 */
-    layer.create(0, "", {});                            /* 1, quad 1 */
-    layer.create(0, "", {});                            /* 2, quad 2 */
-    /* Node 6 is disabled, so style 5 should get transitioned to 2 if not
-       dynamic */
-    DataHandle data3 = layer.create(5, "hello",         /* 3, quad 3 to 7 */
-        {}, data.flags, node6);
-    layer.create(0, "", {});                            /* 4, quad 8 */
-    /* Node 6 is disabled, but style 4 has no disabled transition so this stays
-       the same */
-    DataHandle data5 = layer.createGlyph(4, 13,         /* 5, quad 9 */
-        Text::Alignment::TopCenter, node6);
-    layer.create(0, "", {});                            /* 6, quad 10 */
+    /* Hibernating again does nothing */
+    layer.hibernate(first);
+    CORRADE_VERIFY(layer.isHibernated(first));
+
+    /* While the data isn't visible, the text isn't reshaped and the glyph
+       data get recompacted to just the visible text */
+    UnsignedInt dataIdsSecond[]{1};
+    layer.update(LayerState::NeedsDataUpdate, dataIdsSecond, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(font.shapeCalled, 2);
+    CORRADE_VERIFY(layer.isHibernated(first));
+    CORRADE_COMPARE(layer.stateData().glyphData.size(), 3);
+    CORRADE_COMPARE(layer.stateData().vertices.size(), 3*4);
+
+    /* Once it's visible again, it gets reshaped, even if just the node order
+       changed */
+    layer.update(LayerState::NeedsNodeOrderUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(font.shapeCalled, 3);
+    CORRADE_VERIFY(!layer.isHibernated(first));
+    CORRADE_COMPARE(layer.glyphCount(first), 5);
+    CORRADE_COMPARE(layer.size(first), firstSize);
+    CORRADE_COMPARE(layer.stateData().glyphData.size(), 8);
+    CORRADE_COMPARE(layer.stateData().vertices.size(), 8*4);
+
+    /* Setting a text without the flag discards the hibernated state and the
+       source, which is then not reshaped anymore */
+    layer.hibernate(first);
+    layer.setText(first, "hi", {});
+    CORRADE_COMPARE(font.shapeCalled, 4);
+    CORRADE_VERIFY(!layer.isHibernated(first));
+    CORRADE_COMPARE(layer.glyphCount(first), 2);
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(font.shapeCalled, 4);
+    CORRADE_COMPARE(layer.stateData().hibernationSources.size(), 0);
+    CORRADE_COMPARE(layer.stateData().hibernationSourceTextData.size(), 0);
+
+    /* Removing hibernated data discards the source as well */
+    DataHandle third = layer.create(0, "hello", {}, TextDataFlag::Hibernatable);
+    layer.hibernate(third);
+    layer.remove(third);
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(font.shapeCalled, 5);
+    CORRADE_COMPARE(layer.stateData().hibernationSources.size(), 0);
+    CORRADE_COMPARE(layer.stateData().hibernatedCount, 0);
+}
+
+void TextLayerTest::createSetTextHibernateInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return true; }
+        void doClose() override {}
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<OneGlyphShaper>(*this); }
+    } font;
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
+    cache.addFont(67, &font);
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{1}};
+    shared.setGlyphCache(cache);
+    /* Can't be chained together, see createSetTextTextPropertiesEditableInvalid() */
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {shared.addFont(font, 1.0f)},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+
+    DataHandle handle = layer.create(0, "hello", {});
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    layer.create(0, "hello", {}, TextDataFlag::Editable|TextDataFlag::Hibernatable);
+    layer.setText(handle, "hello", {}, TextDataFlag::Editable|TextDataFlag::Hibernatable);
+    layer.hibernate(handle);
+    CORRADE_COMPARE_AS(out.str(),
+        "Ui::TextLayer::create(): hibernation of an editable text is not implemented yet, sorry\n"
+        "Ui::TextLayer::setText(): hibernation of an editable text is not implemented yet, sorry\n"
+        "Ui::TextLayer::hibernate(): text doesn't have Ui::TextDataFlag::Hibernatable set\n",
+        TestSuite::Compare::String);
+}
+
+void TextLayerTest::createSetTextGlyphRunReuse() {
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return true; }
+        void doClose() override {}
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<ThreeGlyphShaper>(*this); }
+    } font;
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
+    cache.addFont(98, &font);
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{1}
+        .setGlyphRunReuse(true)};
+    shared.setGlyphCache(cache);
+    CORRADE_VERIFY(shared.hasGlyphRunReuse());
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {shared.addFont(font, 1.0f)},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+
+        const State& stateData() const {
+            return static_cast<const State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    const auto glyphRunOffsets = [&]() {
+        return stridedArrayView(layer.stateData().glyphRuns).slice(&Implementation::TextLayerGlyphRun::glyphOffset);
+    };
+    const auto glyphRunCapacities = [&]() {
+        return stridedArrayView(layer.stateData().glyphRuns).slice(&Implementation::TextLayerGlyphRun::glyphCapacity);
+    };
+    const auto glyphRunData = [&]() {
+        return stridedArrayView(layer.stateData().glyphRuns).slice(&Implementation::TextLayerGlyphRun::data);
+    };
+
+    /* The shaper produces a glyph for each byte, capacity is rounded up to a
+       power of two */
+    DataHandle first = layer.create(0, "hello", {});
+    DataHandle second = layer.create(0, "hey", {});
+    CORRADE_COMPARE(layer.stateData().glyphData.size(), 8 + 4);
+    CORRADE_COMPARE_AS(glyphRunOffsets(), Containers::arrayView<UnsignedInt>({
+        0, 8
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(glyphRunCapacities(), Containers::arrayView<UnsignedInt>({
+        8, 4
+    }), TestSuite::Compare::Container);
+
+    /* A text that fits into the capacity is shaped in place */
+    layer.setText(first, "hi", {});
+    CORRADE_COMPARE(layer.glyphCount(first), 2);
+    CORRADE_COMPARE(layer.stateData().data[dataHandleId(first)].glyphRun, 0);
+    CORRADE_COMPARE(layer.stateData().glyphData.size(), 8 + 4);
+
+    /* A text that doesn't fit gets a new run, the original one is freed */
+    layer.setText(first, "hello world", {});
+    CORRADE_COMPARE(layer.glyphCount(first), 11);
+    CORRADE_COMPARE(layer.stateData().data[dataHandleId(first)].glyphRun, 2);
+    CORRADE_COMPARE(layer.stateData().glyphData.size(), 8 + 4 + 16);
+    CORRADE_COMPARE(layer.stateData().freeGlyphCount, 8);
+    CORRADE_COMPARE_AS(glyphRunData(), Containers::arrayView<UnsignedInt>({
+        ~UnsignedInt{}, dataHandleId(second), dataHandleId(first)
+    }), TestSuite::Compare::Container);
+
+    /* A new text of the same capacity reuses the freed run */
+    DataHandle third = layer.create(0, "bye!!", {});
+    CORRADE_COMPARE(layer.stateData().data[dataHandleId(third)].glyphRun, 0);
+    CORRADE_COMPARE(layer.stateData().glyphData.size(), 8 + 4 + 16);
+    CORRADE_COMPARE(layer.stateData().freeGlyphCount, 0);
+    CORRADE_COMPARE_AS(glyphRunData(), Containers::arrayView<UnsignedInt>({
+        dataHandleId(third), dataHandleId(second), dataHandleId(first)
+    }), TestSuite::Compare::Container);
+
+    /* Removing the second text makes 4 out of 28 glyphs unused, which isn't
+       enough for a recompaction */
+    layer.remove(second);
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.stateData().glyphData.size(), 8 + 4 + 16);
+    CORRADE_COMPARE(layer.stateData().freeGlyphCount, 4);
+    CORRADE_COMPARE_AS(glyphRunOffsets(), Containers::arrayView<UnsignedInt>({
+        0, 8, 12
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(glyphRunData(), Containers::arrayView<UnsignedInt>({
+        dataHandleId(third), ~UnsignedInt{}, dataHandleId(first)
+    }), TestSuite::Compare::Container);
+
+    /* Removing the first one makes it 20 out of 28, which is over half and
+       everything unused gets removed */
+    layer.remove(first);
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.stateData().glyphData.size(), 8);
+    CORRADE_COMPARE(layer.stateData().freeGlyphCount, 0);
+    CORRADE_COMPARE_AS(glyphRunOffsets(), Containers::arrayView<UnsignedInt>({
+        0
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(glyphRunData(), Containers::arrayView<UnsignedInt>({
+        dataHandleId(third)
+    }), TestSuite::Compare::Container);
+
+    /* The free lists got cleared, so a new text goes to the end again */
+    DataHandle fourth = layer.create(0, "hey", {});
+    CORRADE_COMPARE(layer.stateData().data[dataHandleId(fourth)].glyphRun, 1);
+    CORRADE_COMPARE_AS(glyphRunOffsets(), Containers::arrayView<UnsignedInt>({
+        0, 8
+    }), TestSuite::Compare::Container);
+}
+
+void TextLayerTest::updateTextGlyphRunReuse() {
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return true; }
+        void doClose() override {}
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<ThreeGlyphShaper>(*this); }
+    } font;
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
+    cache.addFont(98, &font);
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{1}
+        .setGlyphRunReuse(true)};
+    shared.setGlyphCache(cache);
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {shared.addFont(font, 1.0f)},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+
+        const State& stateData() const {
+            return static_cast<const State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
+
+    const auto textRunOffsets = [&]() {
+        return stridedArrayView(layer.stateData().textRuns).slice(&Implementation::TextLayerTextRun::textOffset);
+    };
+    const auto textRunCapacities = [&]() {
+        return stridedArrayView(layer.stateData().textRuns).slice(&Implementation::TextLayerTextRun::textCapacity);
+    };
+
+    /* Text capacity is rounded up to a power of two like with glyphs */
+    DataHandle first = layer.create(0, "hello", {}, TextDataFlag::Editable);
+    DataHandle second = layer.create(0, "bb", {}, TextDataFlag::Editable);
+    CORRADE_COMPARE(layer.stateData().textData.size(), 8 + 2);
+    CORRADE_COMPARE_AS(textRunOffsets(), Containers::arrayView<UnsignedInt>({
+        0, 8
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(textRunCapacities(), Containers::arrayView<UnsignedInt>({
+        8, 2
+    }), TestSuite::Compare::Container);
+
+    /* Edits that fit into the capacity are done in place, reusing the glyph
+       run as well */
+    layer.updateText(first, 1, 3, 0, "", 0);
+    CORRADE_COMPARE(layer.text(first), "ho");
+    layer.updateText(first, 0, 0, 1, "ell", 4);
+    CORRADE_COMPARE(layer.text(first), "hello");
+    layer.editText(first, TextEdit::InsertBeforeCursor, "l!");
+    CORRADE_COMPARE(layer.text(first), "helll!o");
+    CORRADE_COMPARE(layer.cursor(first), Containers::pair(6u, 6u));
+    layer.editText(first, TextEdit::RemoveBeforeCursor, {});
+    CORRADE_COMPARE(layer.text(first), "helllo");
+    CORRADE_COMPARE(layer.glyphCount(first), 6);
+    CORRADE_COMPARE(layer.stateData().textRuns.size(), 2);
+    CORRADE_COMPARE(layer.stateData().data[dataHandleId(first)].textRun, 0);
+    CORRADE_COMPARE(layer.stateData().data[dataHandleId(first)].glyphRun, 0);
+    CORRADE_COMPARE(layer.stateData().textData.size(), 8 + 2);
+
+    /* An edit that doesn't fit gets a new text run with the capacity grown */
+    layer.editText(first, TextEdit::InsertAfterCursor, "???");
+    CORRADE_COMPARE(layer.text(first), "helll???o");
+    CORRADE_COMPARE(layer.stateData().data[dataHandleId(first)].textRun, 2);
+    CORRADE_COMPARE(layer.stateData().textData.size(), 8 + 2 + 16);
+    CORRADE_COMPARE_AS(textRunOffsets(), Containers::arrayView<UnsignedInt>({
+        ~UnsignedInt{}, 8, 10
+    }), TestSuite::Compare::Container);
+
+    /* Recompaction preserves the capacity */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.stateData().textData.size(), 2 + 16);
+    CORRADE_COMPARE_AS(textRunOffsets(), Containers::arrayView<UnsignedInt>({
+        0, 2
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(textRunCapacities(), Containers::arrayView<UnsignedInt>({
+        2, 16
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(layer.text(second), "bb");
+    CORRADE_COMPARE(layer.text(first), "helll???o");
+
+    /* Inserting text coming from the layer itself isn't done in place, as
+       it could get overwritten */
+    layer.updateText(first, 0, 0, 0, layer.text(second), 2);
+    CORRADE_COMPARE(layer.text(first), "bbhelll???o");
+    CORRADE_COMPARE(layer.stateData().data[dataHandleId(first)].textRun, 2);
+}
+
+void TextLayerTest::createSetTextOnDemandGlyphCacheFilling() {
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return _opened; }
+        Properties doOpenFile(Containers::StringView, Float size) override {
+            _opened = true;
+            return {size, 8.0f, -4.0f, 16.0f, 98};
+        }
+        void doClose() override { _opened = false; }
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        bool doFillGlyphCache(Text::AbstractGlyphCache& cache, const Containers::StridedArrayView1D<const UnsignedInt>& glyphs) override {
+            ++fillCalled;
+            UnsignedInt fontId = *cache.findFont(*this);
+            for(UnsignedInt glyph: glyphs) {
+                arrayAppend(filledGlyphs, glyph);
+                cache.addGlyph(fontId, glyph, {}, {});
+            }
+            return true;
+        }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<ThreeGlyphShaper>(*this); }
+
+        int fillCalled = 0;
+        Containers::Array<UnsignedInt> filledGlyphs;
+
+        bool _opened = false;
+    } font;
+    font.openFile({}, 16.0f);
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    /* Default padding is 1, resetting to 0 for simplicity */
+    } cache{PixelFormat::R8Unorm, {32, 32}, {}};
+    /* Only one of the three glyphs produced by the shaper is in the cache,
+       getting cache-global ID 1 */
+    cache.addGlyph(cache.addFont(font.glyphCount(), &font), 13, {}, {});
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{1}};
+    shared.setGlyphCache(cache);
+    CORRADE_VERIFY(!shared.hasOnDemandGlyphCacheFilling());
+
+    shared.setOnDemandGlyphCacheFilling(true);
+    CORRADE_VERIFY(shared.hasOnDemandGlyphCacheFilling());
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {shared.addFont(font, 16.0f)},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+
+        const State& stateData() const {
+            return static_cast<const State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    const auto glyphIds = [&](DataHandle handle) {
+        const Implementation::TextLayerGlyphRun& run = layer.stateData().glyphRuns[layer.stateData().data[dataHandleId(handle)].glyphRun];
+        return stridedArrayView(layer.stateData().glyphData).sliceSize(run.glyphOffset, run.glyphCount).slice(&Implementation::TextLayerGlyphData::glyphId);
+    };
+
+    /* Until the next update, the glyphs are kept as font-specific IDs and
+       nothing is filled */
+    DataHandle first = layer.create(0, "hello", {});
+    DataHandle second = layer.create(0, "hey", {});
+    CORRADE_COMPARE(font.fillCalled, 0);
+    CORRADE_COMPARE_AS(glyphIds(first), Containers::arrayView<UnsignedInt>({
+        22, 13, 97, 22, 13
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(glyphIds(second), Containers::arrayView<UnsignedInt>({
+        22, 13, 97
+    }), TestSuite::Compare::Container);
+
+    /* The update fills all missing glyphs at once, without duplicates, and
+       converts the IDs to cache-global */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(font.fillCalled, 1);
+    CORRADE_COMPARE_AS(font.filledGlyphs, Containers::arrayView<UnsignedInt>({
+        22, 97
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(glyphIds(first), Containers::arrayView<UnsignedInt>({
+        2, 1, 3, 2, 1
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(glyphIds(second), Containers::arrayView<UnsignedInt>({
+        2, 1, 3
+    }), TestSuite::Compare::Container);
+
+    /* A text with all glyphs already present is converted right away and
+       the next update doesn't fill anything */
+    DataHandle third = layer.create(0, "bye", {});
+    CORRADE_COMPARE_AS(glyphIds(third), Containers::arrayView<UnsignedInt>({
+        2, 1, 3
+    }), TestSuite::Compare::Container);
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(font.fillCalled, 1);
+}
+
+void TextLayerTest::glyphCacheUseCounts() {
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return _opened; }
+        Properties doOpenFile(Containers::StringView, Float size) override {
+            _opened = true;
+            return {size, 8.0f, -4.0f, 16.0f, 98};
+        }
+        void doClose() override { _opened = false; }
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<ThreeGlyphShaper>(*this); }
+
+        bool _opened = false;
+    } font;
+    font.openFile({}, 16.0f);
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    /* Default padding is 1, resetting to 0 for simplicity */
+    } cache{PixelFormat::R8Unorm, {32, 32}, {}};
+    {
+        /* Cache-global IDs 1, 2, 3, 4 */
+        UnsignedInt fontId = cache.addFont(font.glyphCount(), &font);
+        cache.addGlyph(fontId, 22, {}, {});
+        cache.addGlyph(fontId, 13, {}, {});
+        cache.addGlyph(fontId, 97, {}, {});
+        cache.addGlyph(fontId, 55, {}, {});
+    }
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{1}};
+    shared.setGlyphCache(cache);
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {shared.addFont(font, 16.0f)},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+    } layer1{layerHandle(0, 1), shared},
+      layer2{layerHandle(1, 1), shared};
+
+    /* Font glyphs 22, 13, 97, 22, 13 */
+    DataHandle first = layer1.create(0, "hello", {});
+    /* Font glyphs 22, 13 */
+    layer1.create(0, "hi", {});
+    /* Font glyph 55 */
+    layer2.createGlyph(0, 55, {});
+
+    UnsignedInt counts[5]{};
+    layer1.glyphCacheUseCountsInto(counts);
+    CORRADE_COMPARE_AS(Containers::arrayView(counts), Containers::arrayView<UnsignedInt>({
+        0, 3, 3, 1, 0
+    }), TestSuite::Compare::Container);
+
+    /* The counts are added to what's in the view already */
+    layer2.glyphCacheUseCountsInto(counts);
+    CORRADE_COMPARE_AS(Containers::arrayView(counts), Containers::arrayView<UnsignedInt>({
+        0, 3, 3, 1, 1
+    }), TestSuite::Compare::Container);
+
+    /* Removed texts are not counted, even though the glyph data are still
+       there until the next recompaction */
+    layer1.remove(first);
+    UnsignedInt countsAfterRemove[5]{};
+    layer1.glyphCacheUseCountsInto(countsAfterRemove);
+    CORRADE_COMPARE_AS(Containers::arrayView(countsAfterRemove), Containers::arrayView<UnsignedInt>({
+        0, 1, 1, 0, 0
+    }), TestSuite::Compare::Container);
+}
+
+void TextLayerTest::glyphCacheUseCountsInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32}};
+    cache.addGlyph(cache.addFont(15), 3, {}, {});
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } sharedNoCache{TextLayer::Shared::Configuration{1}},
+      shared{TextLayer::Shared::Configuration{1}};
+    shared.setGlyphCache(cache);
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+    } layerNoCache{layerHandle(0, 1), sharedNoCache},
+      layer{layerHandle(0, 1), shared};
+
+    UnsignedInt counts[3];
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    layerNoCache.glyphCacheUseCountsInto(counts);
+    layer.glyphCacheUseCountsInto(counts);
+    CORRADE_COMPARE_AS(out.str(),
+        "Ui::TextLayer::glyphCacheUseCountsInto(): no glyph cache set\n"
+        "Ui::TextLayer::glyphCacheUseCountsInto(): expected a view with 2 elements but got 3\n",
+        TestSuite::Compare::String);
+}
+
+void TextLayerTest::createSetUpdateTextFromLayerItself() {
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return true; }
+        void doClose() override {}
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<ThreeGlyphShaper>(*this); }
+    } font;
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
+    cache.addFont(98, &font);
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{1}};
+    shared.setGlyphCache(cache);
+    /* Interestingly enough, these two can't be chained together as on some
+       compilers it'd call addFont() before setGlyphCache(), causing an
+       assert */
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {shared.addFont(font, 1.0f)},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+
+    /* Assuming the implementation stores all texts in one large array, this
+       working correctly relies on arrayAppend() detecting if the view being
+       copied is a slice of the array itself. If it wouldn't, inevitably it'd
+       happen that garbage gets copied, or it blows up due to invalid memory
+       access.
+
+       To make sure this indeed gets hit, the test is repeated a few times with
+       varying string sizes to minimize the chance of realloc() growing
+       in-place every time. */
+    DataHandle first = layer.create(0, "hello there" + " how is everyone"_s*testCaseRepeatId(), {}, TextDataFlag::Editable);
+    DataHandle firstCopy = layer.create(0, layer.text(first), {}, TextDataFlag::Editable);
+    DataHandle second = layer.create(0, "hiya", {}, TextDataFlag::Editable);
+    DataHandle third = layer.create(0, "hey hey", {}, TextDataFlag::Editable);
+    layer.setText(second, layer.text(third), {});
+    layer.updateText(third, 0, 0, 7, layer.text(first).exceptPrefix(5), 0);
+
+    CORRADE_COMPARE(layer.text(first), "hello there" + " how is everyone"_s*testCaseRepeatId());
+    CORRADE_COMPARE(layer.text(firstCopy), "hello there" + " how is everyone"_s*testCaseRepeatId());
+    CORRADE_COMPARE(layer.text(second), "hey hey");
+    CORRADE_COMPARE(layer.text(third), "hey hey there" + " how is everyone"_s*testCaseRepeatId());
+}
+
+void TextLayerTest::setColor() {
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return true; }
+        void doClose() override {}
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<OneGlyphShaper>(*this); }
+    } font;
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
+    cache.addFont(67, &font);
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{1}};
+    shared.setGlyphCache(cache);
+    /* Interestingly enough, these two can't be chained together as on some
+       compilers it'd call addFont() before setGlyphCache(), causing an
+       assert */
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {shared.addFont(font, 1.0f)},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
+
+    /* Just to be sure the setters aren't picking up the first ever data
+       always */
+    layer.create(0, "", {});
+
+    /* There's nothing that would work differently for createGlyph() */
+    DataHandle data = layer.create(0, "", {});
+    CORRADE_COMPARE(layer.color(data), 0xffffffff_rgbaf);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Setting a color marks the layer as dirty */
+    layer.setColor(data, 0xaabbccdd_rgbaf);
+    CORRADE_COMPARE(layer.color(data), 0xaabbccdd_rgbaf);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Testing also the other overload */
+    layer.setColor(dataHandleData(data), 0x11223344_rgbaf);
+    CORRADE_COMPARE(layer.color(dataHandleData(data)), 0x11223344_rgbaf);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+}
+
+void TextLayerTest::setPadding() {
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return true; }
+        void doClose() override {}
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<OneGlyphShaper>(*this); }
+    } font;
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
+    cache.addFont(67, &font);
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{1}};
+    shared.setGlyphCache(cache);
+    /* Interestingly enough, these two can't be chained together as on some
+       compilers it'd call addFont() before setGlyphCache(), causing an
+       assert */
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {shared.addFont(font, 1.0f)},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
+
+    /* Just to be sure the setters aren't picking up the first ever data
+       always */
+    layer.create(0, "", {});
+
+    /* There's nothing that would work differently for createGlyph() */
+    DataHandle data = layer.create(0, "", {});
+    CORRADE_COMPARE(layer.padding(data), Vector4{0.0f});
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Setting a padding marks the layer as dirty */
+    layer.setPadding(data, {2.0f, 4.0f, 3.0f, 1.0f});
+    CORRADE_COMPARE(layer.padding(data), (Vector4{2.0f, 4.0f, 3.0f, 1.0f}));
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Testing also the other overload */
+    layer.setPadding(dataHandleData(data), {1.0f, 2.0f, 3.0f, 4.0f});
+    CORRADE_COMPARE(layer.padding(dataHandleData(data)), (Vector4{1.0f, 2.0f, 3.0f, 4.0f}));
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Single-value padding */
+    layer.setPadding(data, 4.0f);
+    CORRADE_COMPARE(layer.padding(data), Vector4{4.0f});
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+
+    /* Clear the state flags */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Testing also the other overload */
+    layer.setPadding(dataHandleData(data), 3.0f);
+    CORRADE_COMPARE(layer.padding(dataHandleData(data)), Vector4{3.0f});
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+}
+
+void TextLayerTest::intrinsicSizes() {
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return true; }
+        void doClose() override {}
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<OneGlyphShaper>(*this); }
+    } font;
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
+    cache.addFont(67, &font);
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{1}};
+    shared.setGlyphCache(cache);
+    /* Interestingly enough, these two can't be chained together as on some
+       compilers it'd call addFont() before setGlyphCache(), causing an
+       assert. The style padding is deliberately non-zero to verify it's not
+       taken into account. */
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {shared.addFont(font, 1.0f)},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {Vector4{100.0f}});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+    CORRADE_VERIFY(layer.features() >= LayerFeature::IntrinsicSize);
+
+    /* Data without the flag don't mark the layer for an intrinsic size
+       update */
+    DataHandle plain = layer.create(0, "hello", {}, nodeHandle(2, 1));
+    CORRADE_VERIFY(!(layer.state() >= LayerState::NeedsIntrinsicSizeUpdate));
+
+    /* Removed data, data with the flag attached to no node and data without
+       the flag shouldn't affect anything */
+    DataHandle removed = layer.create(0, "hello", {}, TextDataFlag::SizeToContent, nodeHandle(0, 1));
+    DataHandle sized = layer.create(0, "hello", {}, TextDataFlag::SizeToContent, nodeHandle(1, 1));
+    layer.create(0, "hello", {}, TextDataFlag::SizeToContent);
+    layer.remove(removed);
+    CORRADE_VERIFY(layer.state() >= LayerState::NeedsIntrinsicSizeUpdate);
+
+    layer.setPadding(sized, {1.0f, 2.0f, 3.0f, 4.0f});
+    const Vector2 size = layer.size(sized);
+    CORRADE_VERIFY(size.x() > 0.0f);
+
+    /* The node size is enlarged only where the text doesn't fit already */
+    Vector2 nodeSizes[]{
+        {0.5f, 0.5f},
+        {1.0f, 100.0f},
+        {0.5f, 0.5f},
+    };
+    layer.intrinsicSizes(nodeSizes);
+    CORRADE_COMPARE_AS(Containers::arrayView(nodeSizes), Containers::arrayView<Vector2>({
+        {0.5f, 0.5f},
+        {size.x() + 4.0f, 100.0f},
+        {0.5f, 0.5f},
+    }), TestSuite::Compare::Container);
+    CORRADE_VERIFY(!(layer.state() >= LayerState::NeedsIntrinsicSizeUpdate));
+
+    /* Changing padding of data without the flag doesn't mark the layer */
+    layer.setPadding(plain, 2.0f);
+    CORRADE_VERIFY(!(layer.state() >= LayerState::NeedsIntrinsicSizeUpdate));
+
+    /* Changing the text of data with the flag does */
+    layer.setText(sized, "hey", {});
+    CORRADE_VERIFY(layer.state() >= LayerState::NeedsIntrinsicSizeUpdate);
+    layer.intrinsicSizes(nodeSizes);
+
+    /* Clearing the flag does as well, and the data then don't contribute to
+       the node size anymore */
+    layer.setText(sized, "hey", {}, {});
+    CORRADE_VERIFY(layer.state() >= LayerState::NeedsIntrinsicSizeUpdate);
+    nodeSizes[1] = {1.0f, 100.0f};
+    layer.intrinsicSizes(nodeSizes);
+    CORRADE_COMPARE(nodeSizes[1], (Vector2{1.0f, 100.0f}));
+}
+
+void TextLayerTest::invalidHandle() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{1}};
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    layer.flags(DataHandle::Null);
+    layer.flags(LayerDataHandle::Null);
+    layer.glyphCount(DataHandle::Null);
+    layer.glyphCount(LayerDataHandle::Null);
+    layer.size(DataHandle::Null);
+    layer.size(LayerDataHandle::Null);
+    layer.hibernate(DataHandle::Null);
+    layer.hibernate(LayerDataHandle::Null);
+    layer.isHibernated(DataHandle::Null);
+    layer.isHibernated(LayerDataHandle::Null);
+    layer.cursor(DataHandle::Null);
+    layer.cursor(LayerDataHandle::Null);
+    layer.setCursor(DataHandle::Null, 0);
+    layer.setCursor(LayerDataHandle::Null, 0);
+    layer.cursorForPosition(DataHandle::Null, {}, {});
+    layer.cursorForPosition(LayerDataHandle::Null, {}, {});
+    layer.textProperties(DataHandle::Null);
+    layer.textProperties(LayerDataHandle::Null);
+    layer.text(DataHandle::Null);
+    layer.text(LayerDataHandle::Null);
+    layer.setText(DataHandle::Null, "", {});
+    layer.setText(LayerDataHandle::Null, "", {});
+    layer.updateText(DataHandle::Null, 0, 0, 0, {}, 0);
+    layer.updateText(LayerDataHandle::Null, 0, 0, 0, {}, 0);
+    layer.editText(DataHandle::Null, TextEdit::MoveCursorLeft, {});
+    layer.editText(LayerDataHandle::Null, TextEdit::MoveCursorLeft, {});
+    layer.setGlyph(DataHandle::Null, 0, {});
+    layer.setGlyph(LayerDataHandle::Null, 0, {});
+    layer.color(DataHandle::Null);
+    layer.color(LayerDataHandle::Null);
+    layer.setColor(DataHandle::Null, {});
+    layer.setColor(LayerDataHandle::Null, {});
+    layer.padding(DataHandle::Null);
+    layer.padding(LayerDataHandle::Null);
+    layer.setPadding(DataHandle::Null, {});
+    layer.setPadding(LayerDataHandle::Null, {});
+    CORRADE_COMPARE_AS(out.str(),
+        "Ui::TextLayer::flags(): invalid handle Ui::DataHandle::Null\n"
+        "Ui::TextLayer::flags(): invalid handle Ui::LayerDataHandle::Null\n"
+        "Ui::TextLayer::glyphCount(): invalid handle Ui::DataHandle::Null\n"
+        "Ui::TextLayer::glyphCount(): invalid handle Ui::LayerDataHandle::Null\n"
+        "Ui::TextLayer::size(): invalid handle Ui::DataHandle::Null\n"
+        "Ui::TextLayer::size(): invalid handle Ui::LayerDataHandle::Null\n"
+        "Ui::TextLayer::hibernate(): invalid handle Ui::DataHandle::Null\n"
+        "Ui::TextLayer::hibernate(): invalid handle Ui::LayerDataHandle::Null\n"
+        "Ui::TextLayer::isHibernated(): invalid handle Ui::DataHandle::Null\n"
+        "Ui::TextLayer::isHibernated(): invalid handle Ui::LayerDataHandle::Null\n"
+        "Ui::TextLayer::cursor(): invalid handle Ui::DataHandle::Null\n"
+        "Ui::TextLayer::cursor(): invalid handle Ui::LayerDataHandle::Null\n"
+        "Ui::TextLayer::setCursor(): invalid handle Ui::DataHandle::Null\n"
+        "Ui::TextLayer::setCursor(): invalid handle Ui::LayerDataHandle::Null\n"
+        "Ui::TextLayer::cursorForPosition(): invalid handle Ui::DataHandle::Null\n"
+        "Ui::TextLayer::cursorForPosition(): invalid handle Ui::LayerDataHandle::Null\n"
+        "Ui::TextLayer::textProperties(): invalid handle Ui::DataHandle::Null\n"
+        "Ui::TextLayer::textProperties(): invalid handle Ui::LayerDataHandle::Null\n"
+        "Ui::TextLayer::text(): invalid handle Ui::DataHandle::Null\n"
+        "Ui::TextLayer::text(): invalid handle Ui::LayerDataHandle::Null\n"
+        "Ui::TextLayer::setText(): invalid handle Ui::DataHandle::Null\n"
+        "Ui::TextLayer::setText(): invalid handle Ui::LayerDataHandle::Null\n"
+        "Ui::TextLayer::updateText(): invalid handle Ui::DataHandle::Null\n"
+        "Ui::TextLayer::updateText(): invalid handle Ui::LayerDataHandle::Null\n"
+        "Ui::TextLayer::editText(): invalid handle Ui::DataHandle::Null\n"
+        "Ui::TextLayer::editText(): invalid handle Ui::LayerDataHandle::Null\n"
+        "Ui::TextLayer::setGlyph(): invalid handle Ui::DataHandle::Null\n"
+        "Ui::TextLayer::setGlyph(): invalid handle Ui::LayerDataHandle::Null\n"
+        "Ui::TextLayer::color(): invalid handle Ui::DataHandle::Null\n"
+        "Ui::TextLayer::color(): invalid handle Ui::LayerDataHandle::Null\n"
+        "Ui::TextLayer::setColor(): invalid handle Ui::DataHandle::Null\n"
+        "Ui::TextLayer::setColor(): invalid handle Ui::LayerDataHandle::Null\n"
+        "Ui::TextLayer::padding(): invalid handle Ui::DataHandle::Null\n"
+        "Ui::TextLayer::padding(): invalid handle Ui::LayerDataHandle::Null\n"
+        "Ui::TextLayer::setPadding(): invalid handle Ui::DataHandle::Null\n"
+        "Ui::TextLayer::setPadding(): invalid handle Ui::LayerDataHandle::Null\n",
+        TestSuite::Compare::String);
+}
+
+void TextLayerTest::invalidFontHandle() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return true; }
+        void doClose() override {}
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<OneGlyphShaper>(*this); }
+    } font;
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
+    cache.addFont(67, &font);
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{1}};
+    shared.setGlyphCache(cache);
+    /* Interestingly enough, these two can't be chained together as on some
+       compilers it'd call addFont() before setGlyphCache(), causing an
+       assert */
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {shared.addFont(font, 1.0f)},
+        {Text::Alignment{}},
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+
+    DataHandle data = layer.create(0, "", {});
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    layer.create(0, "", FontHandle(0x12ab));
+    layer.createGlyph(0, 0, FontHandle(0x12ab));
+    layer.setText(data, "", FontHandle(0x12ab));
+    layer.setGlyph(data, 0, FontHandle(0x12ab));
+    CORRADE_COMPARE(out.str(),
+        "Ui::TextLayer::create(): invalid handle Ui::FontHandle(0x12ab, 0x0)\n"
+        "Ui::TextLayer::createGlyph(): invalid handle Ui::FontHandle(0x12ab, 0x0)\n"
+        "Ui::TextLayer::setText(): invalid handle Ui::FontHandle(0x12ab, 0x0)\n"
+        "Ui::TextLayer::setGlyph(): invalid handle Ui::FontHandle(0x12ab, 0x0)\n");
+}
+
+void TextLayerTest::nonEditableText() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return true; }
+        void doClose() override {}
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<OneGlyphShaper>(*this); }
+    } font;
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
+    cache.addFont(67, &font);
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{1}};
+    shared.setGlyphCache(cache);
+    /* Interestingly enough, these two can't be chained together as on some
+       compilers it'd call addFont() before setGlyphCache(), causing an
+       assert */
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {shared.addFont(font, 1.0f)},
+        {Text::Alignment{}},
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+
+    DataHandle text = layer.create(0, "", {});
+    DataHandle glyph = layer.createGlyph(0, 0, {});
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    layer.cursor(text);
+    layer.cursor(glyph);
+    layer.setCursor(text, 0);
+    layer.setCursor(glyph, 0);
+    layer.cursorForPosition(text, {}, {});
+    layer.cursorForPosition(glyph, {}, {});
+    layer.textProperties(text);
+    layer.textProperties(glyph);
+    layer.text(text);
+    layer.text(glyph);
+    layer.updateText(text, 0, 0, 0, {}, 0);
+    layer.updateText(glyph, 0, 0, 0, {}, 0);
+    layer.editText(text, TextEdit::MoveCursorLeft, {});
+    layer.editText(glyph, TextEdit::MoveCursorLeft, {});
+    CORRADE_COMPARE_AS(out.str(),
+        "Ui::TextLayer::cursor(): text doesn't have Ui::TextDataFlag::Editable set\n"
+        "Ui::TextLayer::cursor(): text doesn't have Ui::TextDataFlag::Editable set\n"
+        "Ui::TextLayer::setCursor(): text doesn't have Ui::TextDataFlag::Editable set\n"
+        "Ui::TextLayer::setCursor(): text doesn't have Ui::TextDataFlag::Editable set\n"
+        "Ui::TextLayer::cursorForPosition(): text doesn't have Ui::TextDataFlag::Editable set\n"
+        "Ui::TextLayer::cursorForPosition(): text doesn't have Ui::TextDataFlag::Editable set\n"
+        "Ui::TextLayer::textProperties(): text doesn't have Ui::TextDataFlag::Editable set\n"
+        "Ui::TextLayer::textProperties(): text doesn't have Ui::TextDataFlag::Editable set\n"
+        "Ui::TextLayer::text(): text doesn't have Ui::TextDataFlag::Editable set\n"
+        "Ui::TextLayer::text(): text doesn't have Ui::TextDataFlag::Editable set\n"
+        "Ui::TextLayer::updateText(): text doesn't have Ui::TextDataFlag::Editable set\n"
+        "Ui::TextLayer::updateText(): text doesn't have Ui::TextDataFlag::Editable set\n"
+        "Ui::TextLayer::editText(): text doesn't have Ui::TextDataFlag::Editable set\n"
+        "Ui::TextLayer::editText(): text doesn't have Ui::TextDataFlag::Editable set\n",
+        TestSuite::Compare::String);
+}
+
+void TextLayerTest::noSharedStyleFonts() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return true; }
+        void doClose() override {}
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<OneGlyphShaper>(*this); }
+    } font;
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
+    cache.addFont(67, &font);
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{4}
+        .setDynamicStyleCount(2)
+    };
+    shared.setGlyphCache(cache);
+
+    FontHandle fontHandle = shared.addFont(font, 1.0f);
+
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}, TextLayerStyleUniform{}, TextLayerStyleUniform{}, TextLayerStyleUniform{}},
+        {fontHandle, FontHandle::Null, fontHandle, FontHandle::Null},
+        {Text::Alignment{}, Text::Alignment{}, Text::Alignment{}, Text::Alignment{}},
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+
+    DataHandle layerData = layer.create(1, "", fontHandle);
+    DataHandle layerDataDynamic = layer.create(5, "", fontHandle);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    layer.create(1, "", {});
+    layer.create(4, "", {});
+    layer.createGlyph(3, 0, {});
+    layer.createGlyph(5, 0, {});
+    layer.setText(layerData, "", {});
+    layer.setText(layerDataDynamic, "", {});
+    layer.setGlyph(layerData, 1, {});
+    layer.setGlyph(layerDataDynamic, 1, {});
+    CORRADE_COMPARE_AS(out.str(),
+        "Ui::TextLayer::create(): style 1 has no font set and no custom font was supplied\n"
+        "Ui::TextLayer::create(): dynamic style 0 has no font set and no custom font was supplied\n"
+        "Ui::TextLayer::createGlyph(): style 3 has no font set and no custom font was supplied\n"
+        "Ui::TextLayer::createGlyph(): dynamic style 1 has no font set and no custom font was supplied\n"
+        "Ui::TextLayer::setText(): style 1 has no font set and no custom font was supplied\n"
+        "Ui::TextLayer::setText(): dynamic style 1 has no font set and no custom font was supplied\n"
+        "Ui::TextLayer::setGlyph(): style 1 has no font set and no custom font was supplied\n"
+        "Ui::TextLayer::setGlyph(): dynamic style 1 has no font set and no custom font was supplied\n",
+        TestSuite::Compare::String);
+}
+
+void TextLayerTest::noFontInstance() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
+    UnsignedInt glyphCacheInstanceLessFontId = cache.addFont(233);
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{1}};
+    shared.setGlyphCache(cache);
+
+    FontHandle fontHandle1 = shared.addInstancelessFont(glyphCacheInstanceLessFontId, 0.1f);
+    FontHandle fontHandle2 = shared.addInstancelessFont(glyphCacheInstanceLessFontId, 0.1f);
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {fontHandle1},
+        {Text::Alignment{}},
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+
+    DataHandle data = layer.createGlyph(0, 0, {});
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    layer.create(0, "", {});
+    layer.create(0, "", fontHandle2);
+    layer.setText(data, "", {});
+    layer.setText(data, "", fontHandle2);
+    CORRADE_COMPARE(out.str(),
+        "Ui::TextLayer::create(): Ui::FontHandle(0x0, 0x1) is an instance-less font\n"
+        "Ui::TextLayer::create(): Ui::FontHandle(0x1, 0x1) is an instance-less font\n"
+        "Ui::TextLayer::setText(): Ui::FontHandle(0x0, 0x1) is an instance-less font\n"
+        "Ui::TextLayer::setText(): Ui::FontHandle(0x1, 0x1) is an instance-less font\n");
+}
+
+void TextLayerTest::styleOutOfRange() {
+    auto&& data = StyleOutOfRangeData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return true; }
+        void doClose() override {}
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return {}; }
+    } font;
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
+    cache.addFont(56, &font);
+
+    /* In this case the uniform count is higher than the style count, which is
+       unlikely to happen in practice. It's to verify the check happens against
+       the style count, not uniform count. */
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{6, data.styleCount}
+        .setDynamicStyleCount(data.dynamicStyleCount)
+    };
+    shared.setGlyphCache(cache);
+
+    FontHandle fontHandle = shared.addFont(font, 1.0f);
+
+    shared.setStyle(
+        TextLayerCommonStyleUniform{},
+        Containers::arrayView({TextLayerStyleUniform{}, TextLayerStyleUniform{}, TextLayerStyleUniform{}, TextLayerStyleUniform{}, TextLayerStyleUniform{}, TextLayerStyleUniform{}}),
+        Containers::arrayView({0u, 1u, 2u}).prefix(data.styleCount),
+        Containers::arrayView({fontHandle, fontHandle, fontHandle}).prefix(data.styleCount),
+        Containers::arrayView({Text::Alignment{}, Text::Alignment{}, Text::Alignment{}}).prefix(data.styleCount),
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    layer.create(3, "", {});
+    layer.createGlyph(3, 0, {});
+    CORRADE_COMPARE(out.str(),
+        "Ui::TextLayer::create(): style 3 out of range for 3 styles\n"
+        "Ui::TextLayer::createGlyph(): style 3 out of range for 3 styles\n");
+}
+
+void TextLayerTest::glyphOutOfRange() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
+
+    /* Add one more font to verify it's checking the right one */
+    cache.addFont(57);
+    UnsignedInt glyphCacheFontId = cache.addFont(56);
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{2, 3}};
+    shared.setGlyphCache(cache);
+
+    FontHandle fontHandle = shared.addInstancelessFont(glyphCacheFontId, 1.0f);
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}, TextLayerStyleUniform{}},
+        {0, 1, 0},
+        {fontHandle, fontHandle, fontHandle},
+        {Text::Alignment{}, Text::Alignment{}, Text::Alignment{}},
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+    } layer{layerHandle(0, 1), shared};
+
+    DataHandle data = layer.createGlyph(2, 55, {});
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    layer.createGlyph(2, 56, {});
+    layer.setGlyph(data, 56, {});
+    CORRADE_COMPARE(out.str(),
+        "Ui::TextLayer::createGlyph(): glyph 56 out of range for 56 glyphs in glyph cache font 1\n"
+        "Ui::TextLayer::setGlyph(): glyph 56 out of range for 56 glyphs in glyph cache font 1\n");
+}
+
+void TextLayerTest::updateEmpty() {
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return true; }
+        void doClose() override {}
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return {}; }
+    } font;
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
+    cache.addFont(56, &font);
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{1}};
+    shared.setGlyphCache(cache);
+
+    FontHandle fontHandle = shared.addFont(font, 1.0f);
+    shared.setStyle(
+        TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {fontHandle},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+
+        LayerFeatures doFeatures() const override { return {}; }
+    } layer{layerHandle(0, 1), shared};
+
+    /* Shouldn't crash or do anything weird */
+    layer.update(LayerState::NeedsNodeEnabledUpdate|LayerState::NeedsNodeOpacityUpdate|LayerState::NeedsNodeOrderUpdate|LayerState::NeedsNodeOffsetSizeUpdate|LayerState::NeedsAttachmentUpdate|LayerState::NeedsDataUpdate|LayerState::NeedsCommonDataUpdate|LayerState::NeedsSharedDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_VERIFY(true);
+}
+
+void TextLayerTest::updateCleanDataOrder() {
+    auto&& data = UpdateCleanDataOrderData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Does just extremely basic verification that the vertex and index data
+       get filled with correct contents and in correct order. The actual visual
+       output is checked in TextLayerGLTest. */
+
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return _opened; }
+        Properties doOpenFile(Containers::StringView, Float size) override {
+            _opened = true;
+            return {size, 8.0f, -4.0f, 16.0f, 98};
+        }
+        void doClose() override { _opened = false; }
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<ThreeGlyphShaper>(*this); }
+
+        bool _opened = false;
+    } threeGlyphFont;
+    threeGlyphFont.openFile({}, 16.0f);
+
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return _opened; }
+        Properties doOpenFile(Containers::StringView, Float size) override {
+            _opened = true;
+            return {size, 1.0f, -0.5f, 2.0f, 67};
+        }
+        void doClose() override { _opened = false; }
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<OneGlyphShaper>(*this); }
+
+        bool _opened = false;
+    } oneGlyphFont;
+    oneGlyphFont.openFile({}, 2.0f);
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    /* Default padding is 1, resetting to 0 for simplicity */
+    } cache{PixelFormat::R8Unorm, {32, 32, 3}, {}};
+
+    /* +--+--+
+       |66|13|
+       +-----+
+       | 97  |
+       +-----+ */
+    {
+        UnsignedInt fontId = cache.addFont(threeGlyphFont.glyphCount(), &threeGlyphFont);
+        cache.addGlyph(fontId, 97, {8, 4}, 2, {{}, {32, 16}});
+        /* Glyph 22 deliberately omitted */
+        cache.addGlyph(fontId, 13, {4, -8}, 0, {{16, 16}, {32, 32}});
+    } {
+        UnsignedInt fontId = cache.addFont(oneGlyphFont.glyphCount(), &oneGlyphFont);
+        cache.addGlyph(fontId, 66, {}, 1, {{0, 16}, {16, 32}});
+    }
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{6, data.styleCount}
+        .setEditingStyleCount(data.editingStyleCount ? 4 : 0, data.editingStyleCount)
+        .setDynamicStyleCount(data.dynamicStyleCount, data.hasEditingStyles)
+    };
+    shared.setGlyphCache(cache);
+
+    /* The three-glyph font is scaled to 0.5, the one-glyph to 2.0 */
+    FontHandle threeGlyphFontHandle = shared.addFont(threeGlyphFont, 8.0f);
+    FontHandle oneGlyphFontHandle = shared.addFont(oneGlyphFont, 4.0f);
+
+    if(data.styleCount == 6) {
+        shared.setStyle(TextLayerCommonStyleUniform{},
+            /* Last two uniforms only get referenced by editing styles */
+            {TextLayerStyleUniform{}, TextLayerStyleUniform{},
+             TextLayerStyleUniform{}, TextLayerStyleUniform{},
+             TextLayerStyleUniform{}, TextLayerStyleUniform{}},
+            /* Style 5 doesn't get used (gets transitioned to 2), use an
+               otherwise unused uniform index and weird padding to verify it
+               doesn't get picked. The font handle should however match style 2
+               as it can't be transitioned. */
+            {1, 2, 0, 1, 1, 3},
+            {oneGlyphFontHandle, oneGlyphFontHandle, threeGlyphFontHandle, threeGlyphFontHandle, threeGlyphFontHandle, threeGlyphFontHandle},
+            {Text::Alignment::MiddleCenter, Text::Alignment::BottomRight, Text::Alignment::MiddleCenter, Text::Alignment::LineLeft, Text::Alignment::TopCenter, Text::Alignment::MiddleCenter},
+            /* Features affect only create() / createGlyph() / setText() /
+               setGlyph(), not update(); tested in
+               createSetTextTextProperties() */
+            {}, {}, {},
+            {-1,
+             data.editingStyle1.first(), /* used by data7 */
+             data.editingStyle2.first(), /* used by data3 if not dynamic */
+             data.editingStyle3.first(), /* used by data9 */
+             -1,
+             -1},
+            {-1,
+             data.editingStyle1.second(),
+             data.editingStyle2.second(),
+             data.editingStyle3.second(),
+             -1,
+             -1},
+            {{}, {}, data.paddingFromStyle, {}, data.paddingFromStyle, Vector4{666}});
+    } else if(data.styleCount == 4) {
+        shared.setStyle(TextLayerCommonStyleUniform{},
+            /* Last two uniforms only get referenced by editing styles */
+            {TextLayerStyleUniform{}, TextLayerStyleUniform{},
+             TextLayerStyleUniform{}, TextLayerStyleUniform{},
+             TextLayerStyleUniform{}, TextLayerStyleUniform{}},
+            {1, 2, 0, 1},
+            {oneGlyphFontHandle, oneGlyphFontHandle, threeGlyphFontHandle, threeGlyphFontHandle},
+            {Text::Alignment::MiddleCenter, Text::Alignment::BottomRight, Text::Alignment::MiddleCenter, Text::Alignment::LineLeft},
+            /* Features affect only create() / createGlyph() / setText() /
+               setGlyph(), not update(); tested in
+               createSetTextTextProperties() */
+            {}, {}, {},
+            {-1,
+             data.editingStyle1.first(),  /* used by data7 */
+             data.editingStyle2.first(),  /* used by data3 if not dynamic */
+             data.editingStyle3.first()}, /* used by data9 */
+            {-1,
+             data.editingStyle1.second(),
+             data.editingStyle2.second(),
+             data.editingStyle3.second()},
+            {{}, {}, data.paddingFromStyle, {}});
+    } else CORRADE_INTERNAL_ASSERT_UNREACHABLE();
+
+    if(data.editingStyleCount == 3)
+        shared.setEditingStyle(TextLayerCommonEditingStyleUniform{},
+            {TextLayerEditingStyleUniform{}, TextLayerEditingStyleUniform{}, TextLayerEditingStyleUniform{}, TextLayerEditingStyleUniform{}},
+            {2, 0, 3},
+            {5,    /* Style 0 overrides the selection text uniform */
+             -1,   /* Style 1 is only used for cursor, so this is unused */
+             3},   /* Style 2 is used for selection but doesn't override,
+                      redirect to an otherwise-unused slot as well */
+            {{0.03f, 0.04f, 0.05f, 0.06f},
+             {0.06f, 0.07f, 0.08f, 0.09f},
+             {0.01f, 0.02f, 0.03f, 0.04f}});
+    else if(data.editingStyleCount == 2)
+        shared.setEditingStyle(TextLayerCommonEditingStyleUniform{},
+            {TextLayerEditingStyleUniform{}, TextLayerEditingStyleUniform{}, TextLayerEditingStyleUniform{}, TextLayerEditingStyleUniform{}},
+            {0, 3},
+            {-1,   /* Style 0 is only used for cursor, so this is unused */
+             3},   /* Style 1 is used for selection but doesn't override,
+                      redirect to an otherwise-unused slot as well */
+            {{0.06f, 0.07f, 0.08f, 0.09f},
+             {0.01f, 0.02f, 0.03f, 0.04f}});
+    else if(data.editingStyleCount == 0) {
+        if(data.hasEditingStyles)
+            shared.setEditingStyle(TextLayerCommonEditingStyleUniform{},
+                {},
+                {},
+                {});
+    } else CORRADE_INTERNAL_ASSERT_UNREACHABLE();
+
+    shared.setStyleTransition(
+        nullptr,
+        nullptr,
+        nullptr,
+        [](UnsignedInt style) {
+            return style == 5 ? 2u : style;
+        }
+    );
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+
+        const State& stateData() const {
+            return static_cast<const State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
+
+    if(data.styleCount < 6 && data.dynamicStyleCount) {
+        /* Dynamic style 0 and 1 is style 4 and 5, which is used by data3 and
+           data5 (so the same case as with padding from non-dynamic style or
+           from data) */
+        CORRADE_COMPARE(data.styleCount + 0, 4);
+        /* Again, features affect only create() / createGlyph() / setText() /
+           setGlyph(), not update(); tested in createSetTextTextProperties() */
+        layer.setDynamicStyle(0, TextLayerStyleUniform{}, threeGlyphFontHandle, Text::Alignment::TopCenter, {}, data.paddingFromStyle);
+        /* setDynamicStyleWithCursor() / setDynamicStyleWithSelection() doesn't
+           affect update() any differently than the combined version, these
+           were tested well enough in dynamicStyleEditingStyles() above so it's
+           just the full-blown function used.
+
+           The data.expectEditingDataPresent is checked to handle the case
+           where dynamic editing styles are present but they're not meant to
+           be used. */
+        if((data.editingStyleCount || data.hasEditingStyles) && data.expectEditingDataPresent)
+            layer.setDynamicStyleWithCursorSelection(1,
+                TextLayerStyleUniform{},
+                threeGlyphFontHandle,
+                Text::Alignment::MiddleCenter,
+                {},
+                data.paddingFromStyle,
+                TextLayerEditingStyleUniform{},
+                    /* Padding like original dynamic editing style 1 */
+                    {0.06f, 0.07f, 0.08f, 0.09f},
+                TextLayerEditingStyleUniform{},
+                    /* Not bothering with a non-trivial selection style -- the
+                       actual dynamic uniform ID used is the same in both cases
+                       so it doesn't matter */
+                    {},
+                    /* Padding like original dynamic editing style 0 */
+                    {0.03f, 0.04f, 0.05f, 0.06f});
+        else
+            layer.setDynamicStyle(1, TextLayerStyleUniform{}, threeGlyphFontHandle, Text::Alignment::MiddleCenter, {}, data.paddingFromStyle);
+    }
+
+    /* Two node handles to attach the data to */
+    NodeHandle node6 = nodeHandle(6, 0);
+    NodeHandle node15 = nodeHandle(15, 0);
+
+    /* Create 10 data handles. Only four get filled and actually used. */
+    layer.create(0, "", {});                            /* 0, quad 0 */
+    layer.create(0, "", {});                            /* 1, quad 1 */
+    layer.create(0, "", {});                            /* 2, quad 2 */
+    /* Node 6 is disabled, so style 5 should get transitioned to 2 if not
+       dynamic */
+    DataHandle data3 = layer.create(5, "hello",         /* 3, quad 3 to 7 */
+        {}, data.flags, node6);
+    layer.create(0, "", {});                            /* 4, quad 8 */
+    /* Node 6 is disabled, but style 4 has no disabled transition so this stays
+       the same */
+    DataHandle data5 = layer.createGlyph(4, 13,         /* 5, quad 9 */
+        Text::Alignment::TopCenter, node6);
+    layer.create(0, "", {});                            /* 6, quad 10 */
     DataHandle data7 = layer.create(1, "ahoy",          /* 7, quad 11 */
         Text::Alignment::BottomRight, data.flags, node15);
     layer.create(0, "", {});                            /* 8, quad 12 */
@@ -8836,70 +11714,259 @@ void TextLayerTest::updateCleanDataOrder() {
         CORRADE_COMPARE(layer.text(data9), "hi");
     }
 
-    /* Indices for remaining 3 visible glyphs */
+    /* Indices for remaining 3 visible glyphs */
+    CORRADE_COMPARE_AS(layer.stateData().indices, Containers::arrayView<UnsignedInt>({
+        /* (Possibly editable) text 9, "hi", quads 7 to 8 */
+        7*4 + 0, 7*4 + 1, 7*4 + 2, 7*4 + 2, 7*4 + 1, 7*4 + 3,
+        8*4 + 0, 8*4 + 1, 8*4 + 2, 8*4 + 2, 8*4 + 1, 8*4 + 3,
+        /* (Possibly editable) text 7, "ahoy", quad 5 */
+        5*4 + 0, 5*4 + 1, 5*4 + 2, 5*4 + 2, 5*4 + 1, 5*4 + 3,
+        /* Text 3, "hello" is removed now */
+        /* Glyph 5 is removed now */
+    }), TestSuite::Compare::Container);
+    if(data.expectEditingDataPresent)
+        CORRADE_COMPARE_AS(layer.stateData().editingIndices, Containers::arrayView<UnsignedInt>({
+            /* Cursor for text 9, "hi", quad 3 */
+            3*4 + 0,  3*4 + 2,  3*4 + 1,  3*4 + 2,  3*4 + 3,  3*4 + 1,
+            /* Selection for text 7, quad 0 */
+            0*4 + 0,  0*4 + 2,  0*4 + 1,  0*4 + 2,  0*4 + 3,  0*4 + 1,
+        }), TestSuite::Compare::Container);
+    else
+        CORRADE_COMPARE_AS(layer.stateData().editingIndices, Containers::arrayView<UnsignedInt>({
+        }), TestSuite::Compare::Container);
+
+    /* For drawing data 9 and 7 it needs to draw the first 2 quads in the
+       index buffer, then next 1 quad. For editing there's a cursor quad for
+       data 9 and a selection quad for data 7. */
+    if(data.expectEditingDataPresent)
+        CORRADE_COMPARE_AS(layer.stateData().indexDrawOffsets, (Containers::arrayView<Containers::Pair<UnsignedInt, UnsignedInt>>({
+            {0, 0}, {2*6, 6}, {3*6, 12}
+        })), TestSuite::Compare::Container);
+    else
+        CORRADE_COMPARE_AS(layer.stateData().indexDrawOffsets, (Containers::arrayView<Containers::Pair<UnsignedInt, UnsignedInt>>({
+            {0, 0}, {2*6, 0}, {3*6, 0}
+        })), TestSuite::Compare::Container);
+
+    /* Vertices for all remaining 9 glyphs */
+    CORRADE_COMPARE(layer.stateData().vertices.size(), 9*4);
+    /* (Possibly editable) text 7, quad 5 */
+    for(std::size_t i = 0; i != 1*4; ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(layer.stateData().vertices[5*4 + i].color, 0x11223344_rgbaf*0.9f);
+        /* Created with style 1, which is mapped to uniform 2. The selection
+           doesn't override the text uniform, so it's always the same. */
+        CORRADE_COMPARE(layer.stateData().vertices[5*4 + i].styleUniform, 2);
+    }
+    /* (Possibly editable) text 9, quads 7 to 8 */
+    for(std::size_t i = 0; i != 2*4; ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(layer.stateData().vertices[7*4 + i].color, 0x663399ff_rgbaf*0.9f);
+        /* Created with style 3, which is mapped to uniform 1. There's only a
+           cursor, which doesn't override the text uniform, so it's always the
+           same. */
+        CORRADE_COMPARE(layer.stateData().vertices[7*4 + i].styleUniform, 1);
+    }
+
+    Containers::StridedArrayView1D<const Vector2> positions = stridedArrayView(layer.stateData().vertices).slice(&Implementation::TextLayerVertex::position);
+    Containers::StridedArrayView1D<const Vector3> textureCoordinates = stridedArrayView(layer.stateData().vertices).slice(&Implementation::TextLayerVertex::textureCoordinates);
+
+    /* Text 7 and 9, now quads 5 and 7 to 8 */
+    CORRADE_COMPARE_AS(positions.sliceSize(5*4, 1*4), Containers::arrayView<Vector2>({
+        {23.f - 2.0f       + 0.0f, 9.0f + 0.0f        - 0.0f},
+        {23.f - 2.0f       + 32.f, 9.0f + 0.0f        - 0.0f},
+        {23.f - 2.0f       + 0.0f, 9.0f + 0.0f        - 32.f},
+        {23.f - 2.0f       + 32.f, 9.0f + 0.0f        - 32.f},
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(positions.sliceSize(7*4, 2*4), Containers::arrayView<Vector2>({
+        {3.0f + 0.0f,              6.5f - 0.5f},
+        {3.0f + 0.0f,              6.5f - 0.5f},
+        {3.0f + 0.0f,              6.5f - 0.5f},
+        {3.0f + 0.0f,              6.5f - 0.5f},
+
+        {3.0f + 1.5f + 2.f + 0.0f, 6.5f - 1.0f + 4.0f - 0.0f},
+        {3.0f + 1.5f + 2.f + 8.0f, 6.5f - 1.0f + 4.0f - 0.0f},
+        {3.0f + 1.5f + 2.f + 0.0f, 6.5f - 1.0f + 4.0f - 8.0f},
+        {3.0f + 1.5f + 2.f + 8.0f, 6.5f - 1.0f + 4.0f - 8.0f},
+    }), TestSuite::Compare::Container);
+
+    /* Glyph 22, now only at quad 7 */
+    CORRADE_COMPARE_AS(textureCoordinates.sliceSize(7*4, 4), Containers::arrayView<Vector3>({
+        {},
+        {},
+        {},
+        {},
+    }), TestSuite::Compare::Container);
+
+    /* Glyph 13, now only at quad 8 */
+    CORRADE_COMPARE_AS(textureCoordinates.sliceSize(8*4, 4), Containers::arrayView<Vector3>({
+        {0.5f, 0.5f, 0.0f},
+        {1.0f, 0.5f, 0.0f},
+        {0.5f, 1.0f, 0.0f},
+        {1.0f, 1.0f, 0.0f},
+    }), TestSuite::Compare::Container);
+
+    /* Glyph 66, now at quad 5 */
+    CORRADE_COMPARE_AS(textureCoordinates.sliceSize(5*4, 4), Containers::arrayView<Vector3>({
+        {0.0f, 0.5f, 1.0f},
+        {0.5f, 0.5f, 1.0f},
+        {0.0f, 1.0f, 1.0f},
+        {0.5f, 1.0f, 1.0f},
+    }), TestSuite::Compare::Container);
+
+    if(data.expectEditingDataPresent) {
+        for(std::size_t i = 0; i != 4; ++i) {
+            CORRADE_ITERATION(i);
+
+            /* Text 7 selection, now quad 0 */
+            CORRADE_COMPARE(layer.stateData().editingVertices[0*4 + i].opacity, 0.9f);
+            CORRADE_COMPARE(layer.stateData().editingVertices[0*4 + i].styleUniform, 0);
+
+            /* Text 9 cursor, now quad 3 */
+            CORRADE_COMPARE(layer.stateData().editingVertices[3*4 + i].opacity, 0.9f);
+            CORRADE_COMPARE(layer.stateData().editingVertices[3*4 + i].styleUniform, 3);
+        }
+
+        Containers::StridedArrayView1D<const Vector2> editingPositions = stridedArrayView(layer.stateData().editingVertices).slice(&Implementation::TextLayerEditingVertex::position);
+        Containers::StridedArrayView1D<const Vector2> editingCenterDistances = stridedArrayView(layer.stateData().editingVertices).slice(&Implementation::TextLayerEditingVertex::centerDistance);
+
+        /* Text 7 selection, now quad 0 */
+        CORRADE_COMPARE_AS(editingPositions.sliceSize(0*4, 1*4), Containers::arrayView<Vector2>({
+            /** @todo here it again incorrectly marks the begin including the
+                base X offset */
+            {23.f - 2.0f        - 0.06f, 9.0f - 3.0f        - 0.07f},
+            {23.f               + 0.08f, 9.0f - 3.0f        - 0.07f},
+            {23.f - 2.0f        - 0.06f, 9.0f               + 0.09f},
+            {23.f               + 0.08f, 9.0f               + 0.09f},
+        }), TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(editingCenterDistances.sliceSize(0*4, 1*4), Containers::arrayView<Vector2>({
+            {-1.0f              - 0.07f, -1.5f              - 0.08f},
+            {+1.0f              + 0.07f, -1.5f              - 0.08f},
+            {-1.0f              - 0.07f, +1.5f              + 0.08f},
+            {+1.0f              + 0.07f, +1.5f              + 0.08f},
+        }), TestSuite::Compare::Container);
+
+        /* Text 9 cursor, now quad 3, Again ordered ZYXW instead of XYZW
+           because the text is RTL. */
+        CORRADE_COMPARE_AS(editingPositions.sliceSize(3*4, 1*4), Containers::arrayView<Vector2>({
+            {3.0f + 1.5f        - 0.03f, 6.5f - 4.0f        - 0.02f},
+            {3.0f + 1.5f        + 0.01f, 6.5f - 4.0f        - 0.02f},
+            {3.0f + 1.5f        - 0.03f, 6.5f + 2.0f        + 0.04f},
+            {3.0f + 1.5f        + 0.01f, 6.5f + 2.0f        + 0.04f},
+        }), TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(editingCenterDistances.sliceSize(3*4, 1*4), Containers::arrayView<Vector2>({
+            { 0.0f              - 0.02f, -3.0f              - 0.03f},
+            { 0.0f              + 0.02f, -3.0f              - 0.03f},
+            { 0.0f              - 0.02f, +3.0f              + 0.03f},
+            { 0.0f              + 0.02f, +3.0f              + 0.03f},
+        }), TestSuite::Compare::Container);
+    }
+
+    /* Removing a text marks the corresponding run as unused, the next update()
+       then recompacts it */
+    layer.remove(data7);
+    /* state() can additionally contain LayerState::NeedsNodeOffsetSizeUpdate
+       if we didn't pass it to the update() above, so test just that it
+       contains at least these flags */
+    CORRADE_COMPARE_AS(layer.state(),
+        LayerState::NeedsNodeEnabledUpdate|LayerState::NeedsAttachmentUpdate|LayerState::NeedsDataClean,
+        TestSuite::Compare::GreaterOrEqual);
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().glyphRuns).slice(&Implementation::TextLayerGlyphRun::glyphOffset), Containers::arrayView({
+        0u, 1u, 2u, 3u, 4u, 0xffffffffu, 6u, 7u
+    }), TestSuite::Compare::Container);
+    if(data.flags >= TextDataFlag::Editable)
+        CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().textRuns).slice(&Implementation::TextLayerTextRun::textOffset), Containers::arrayView({
+            0xffffffffu, 4u
+        }), TestSuite::Compare::Container);
+
+    /* Again this explicitly adds NeedsDataUpdate to force recompaction */
+    UnsignedInt dataIdsPostRemoval[]{9};
+    layer.update(data.states|LayerState::NeedsDataUpdate, dataIdsPostRemoval, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+
+    /* There should be just 7 glyph runs, assigned to the remaining 7 data */
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().data).slice(&Implementation::TextLayerData::glyphRun), Containers::arrayView({
+        0u, 1u, 2u, 3u /* free data */, 3u, 5u /* free data */, 4u,
+        5u /* free data */, 5u, 6u, 10u /* free data */
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().glyphRuns).slice(&Implementation::TextLayerGlyphRun::glyphOffset), Containers::arrayView({
+        0u, 1u, 2u, 3u, 4u, 5u, 6u
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().glyphRuns).slice(&Implementation::TextLayerGlyphRun::glyphCount), Containers::arrayView({
+        1u, 1u, 1u, 1u, 1u, 1u, 2u
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().glyphRuns).slice(&Implementation::TextLayerGlyphRun::data), Containers::arrayView({
+        0u, 1u, 2u, 4u, 6u, 8u, 9u
+    }), TestSuite::Compare::Container);
+
+    /* The glyph count queries should still match */
+    CORRADE_COMPARE(layer.glyphCount(data9), 2u);
+
+    /* And 1 text run, assigned to the remining text */
+    if(data.flags >= TextDataFlag::Editable) {
+        CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().data).slice(&Implementation::TextLayerData::textRun), Containers::arrayView({
+            0xffffffffu, 0xffffffffu, 0xffffffffu, 0u /* free data */,
+            0xffffffffu, 0xffffffffu, 0xffffffffu, 0u /* free data */,
+            0xffffffffu, 0u, 3u /* free data */
+        }), TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().textRuns).slice(&Implementation::TextLayerTextRun::textOffset), Containers::arrayView({
+            0u
+        }), TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().textRuns).slice(&Implementation::TextLayerTextRun::textSize), Containers::arrayView({
+            2u
+        }), TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().textRuns).slice(&Implementation::TextLayerTextRun::data), Containers::arrayView({
+            9u
+        }), TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(layer.stateData().textData,
+            "hi",
+            TestSuite::Compare::String);
+
+        /* The text queries should still match also */
+        CORRADE_COMPARE(layer.text(data9), "hi");
+    }
+
+    /* Indices for remaining 2 visible glyphs */
     CORRADE_COMPARE_AS(layer.stateData().indices, Containers::arrayView<UnsignedInt>({
-        /* (Possibly editable) text 9, "hi", quads 7 to 8 */
+        /* Text 9, "hi", quads 6 to 7 */
+        6*4 + 0, 6*4 + 1, 6*4 + 2, 6*4 + 2, 6*4 + 1, 6*4 + 3,
         7*4 + 0, 7*4 + 1, 7*4 + 2, 7*4 + 2, 7*4 + 1, 7*4 + 3,
-        8*4 + 0, 8*4 + 1, 8*4 + 2, 8*4 + 2, 8*4 + 1, 8*4 + 3,
-        /* (Possibly editable) text 7, "ahoy", quad 5 */
-        5*4 + 0, 5*4 + 1, 5*4 + 2, 5*4 + 2, 5*4 + 1, 5*4 + 3,
-        /* Text 3, "hello" is removed now */
+        /* Text 7, "ahoy", is removed now */
+        /* Text 3, "hello", is removed now */
         /* Glyph 5 is removed now */
     }), TestSuite::Compare::Container);
     if(data.expectEditingDataPresent)
         CORRADE_COMPARE_AS(layer.stateData().editingIndices, Containers::arrayView<UnsignedInt>({
-            /* Cursor for text 9, "hi", quad 3 */
-            3*4 + 0,  3*4 + 2,  3*4 + 1,  3*4 + 2,  3*4 + 3,  3*4 + 1,
-            /* Selection for text 7, quad 0 */
-            0*4 + 0,  0*4 + 2,  0*4 + 1,  0*4 + 2,  0*4 + 3,  0*4 + 1,
+            /* Cursor for text 9, "hi", quad 1 (selection would be quad 0) */
+            1*4 + 0,  1*4 + 2,  1*4 + 1,  1*4 + 2,  1*4 + 3,  1*4 + 1,
         }), TestSuite::Compare::Container);
     else
         CORRADE_COMPARE_AS(layer.stateData().editingIndices, Containers::arrayView<UnsignedInt>({
         }), TestSuite::Compare::Container);
 
-    /* For drawing data 9 and 7 it needs to draw the first 2 quads in the
-       index buffer, then next 1 quad. For editing there's a cursor quad for
-       data 9 and a selection quad for data 7. */
+    /* For drawing data 9 it needs to draw the first 2 quads in the index
+       buffer. For editing just the data 9 cursor quad. */
     if(data.expectEditingDataPresent)
         CORRADE_COMPARE_AS(layer.stateData().indexDrawOffsets, (Containers::arrayView<Containers::Pair<UnsignedInt, UnsignedInt>>({
-            {0, 0}, {2*6, 6}, {3*6, 12}
+            {0, 0}, {2*6, 6}
         })), TestSuite::Compare::Container);
     else
         CORRADE_COMPARE_AS(layer.stateData().indexDrawOffsets, (Containers::arrayView<Containers::Pair<UnsignedInt, UnsignedInt>>({
-            {0, 0}, {2*6, 0}, {3*6, 0}
+            {0, 0}, {2*6, 0}
         })), TestSuite::Compare::Container);
 
-    /* Vertices for all remaining 9 glyphs */
-    CORRADE_COMPARE(layer.stateData().vertices.size(), 9*4);
-    /* (Possibly editable) text 7, quad 5 */
-    for(std::size_t i = 0; i != 1*4; ++i) {
-        CORRADE_ITERATION(i);
-        CORRADE_COMPARE(layer.stateData().vertices[5*4 + i].color, 0x11223344_rgbaf*0.9f);
-        /* Created with style 1, which is mapped to uniform 2. The selection
-           doesn't override the text uniform, so it's always the same. */
-        CORRADE_COMPARE(layer.stateData().vertices[5*4 + i].styleUniform, 2);
-    }
-    /* (Possibly editable) text 9, quads 7 to 8 */
+    /* Vertices for all remaining 8 glyphs */
+    CORRADE_COMPARE(layer.stateData().vertices.size(), 8*4);
+    /* (Possibly editable) text 9, quads 6 to 7 */
     for(std::size_t i = 0; i != 2*4; ++i) {
         CORRADE_ITERATION(i);
-        CORRADE_COMPARE(layer.stateData().vertices[7*4 + i].color, 0x663399ff_rgbaf*0.9f);
+        CORRADE_COMPARE(layer.stateData().vertices[6*4 + i].color, 0x663399ff_rgbaf*0.9f);
         /* Created with style 3, which is mapped to uniform 1. There's only a
            cursor, which doesn't override the text uniform, so it's always the
            same. */
-        CORRADE_COMPARE(layer.stateData().vertices[7*4 + i].styleUniform, 1);
+        CORRADE_COMPARE(layer.stateData().vertices[6*4 + i].styleUniform, 1);
     }
 
-    Containers::StridedArrayView1D<const Vector2> positions = stridedArrayView(layer.stateData().vertices).slice(&Implementation::TextLayerVertex::position);
-    Containers::StridedArrayView1D<const Vector3> textureCoordinates = stridedArrayView(layer.stateData().vertices).slice(&Implementation::TextLayerVertex::textureCoordinates);
-
-    /* Text 7 and 9, now quads 5 and 7 to 8 */
-    CORRADE_COMPARE_AS(positions.sliceSize(5*4, 1*4), Containers::arrayView<Vector2>({
-        {23.f - 2.0f       + 0.0f, 9.0f + 0.0f        - 0.0f},
-        {23.f - 2.0f       + 32.f, 9.0f + 0.0f        - 0.0f},
-        {23.f - 2.0f       + 0.0f, 9.0f + 0.0f        - 32.f},
-        {23.f - 2.0f       + 32.f, 9.0f + 0.0f        - 32.f},
-    }), TestSuite::Compare::Container);
-    CORRADE_COMPARE_AS(positions.sliceSize(7*4, 2*4), Containers::arrayView<Vector2>({
+    /* Text 9, now quad 6 to 7 */
+    CORRADE_COMPARE_AS(positions.sliceSize(6*4, 2*4), Containers::arrayView<Vector2>({
         {3.0f + 0.0f,              6.5f - 0.5f},
         {3.0f + 0.0f,              6.5f - 0.5f},
         {3.0f + 0.0f,              6.5f - 0.5f},
@@ -8911,244 +11978,328 @@ void TextLayerTest::updateCleanDataOrder() {
         {3.0f + 1.5f + 2.f + 8.0f, 6.5f - 1.0f + 4.0f - 8.0f},
     }), TestSuite::Compare::Container);
 
-    /* Glyph 22, now only at quad 7 */
-    CORRADE_COMPARE_AS(textureCoordinates.sliceSize(7*4, 4), Containers::arrayView<Vector3>({
+    /* Glyph 22, now only at quad 6 */
+    CORRADE_COMPARE_AS(textureCoordinates.sliceSize(6*4, 4), Containers::arrayView<Vector3>({
         {},
         {},
         {},
         {},
     }), TestSuite::Compare::Container);
 
-    /* Glyph 13, now only at quad 8 */
-    CORRADE_COMPARE_AS(textureCoordinates.sliceSize(8*4, 4), Containers::arrayView<Vector3>({
+    /* Glyph 13, now only at quad 7 */
+    CORRADE_COMPARE_AS(textureCoordinates.sliceSize(7*4, 4), Containers::arrayView<Vector3>({
         {0.5f, 0.5f, 0.0f},
         {1.0f, 0.5f, 0.0f},
         {0.5f, 1.0f, 0.0f},
         {1.0f, 1.0f, 0.0f},
     }), TestSuite::Compare::Container);
 
-    /* Glyph 66, now at quad 5 */
-    CORRADE_COMPARE_AS(textureCoordinates.sliceSize(5*4, 4), Containers::arrayView<Vector3>({
-        {0.0f, 0.5f, 1.0f},
-        {0.5f, 0.5f, 1.0f},
-        {0.0f, 1.0f, 1.0f},
-        {0.5f, 1.0f, 1.0f},
-    }), TestSuite::Compare::Container);
-
     if(data.expectEditingDataPresent) {
         for(std::size_t i = 0; i != 4; ++i) {
             CORRADE_ITERATION(i);
 
-            /* Text 7 selection, now quad 0 */
-            CORRADE_COMPARE(layer.stateData().editingVertices[0*4 + i].opacity, 0.9f);
-            CORRADE_COMPARE(layer.stateData().editingVertices[0*4 + i].styleUniform, 0);
-
-            /* Text 9 cursor, now quad 3 */
-            CORRADE_COMPARE(layer.stateData().editingVertices[3*4 + i].opacity, 0.9f);
-            CORRADE_COMPARE(layer.stateData().editingVertices[3*4 + i].styleUniform, 3);
+            /* Text 9 cursor, now quad 1 */
+            CORRADE_COMPARE(layer.stateData().editingVertices[1*4 + i].opacity, 0.9f);
+            CORRADE_COMPARE(layer.stateData().editingVertices[1*4 + i].styleUniform, 3);
         }
 
         Containers::StridedArrayView1D<const Vector2> editingPositions = stridedArrayView(layer.stateData().editingVertices).slice(&Implementation::TextLayerEditingVertex::position);
         Containers::StridedArrayView1D<const Vector2> editingCenterDistances = stridedArrayView(layer.stateData().editingVertices).slice(&Implementation::TextLayerEditingVertex::centerDistance);
 
-        /* Text 7 selection, now quad 0 */
-        CORRADE_COMPARE_AS(editingPositions.sliceSize(0*4, 1*4), Containers::arrayView<Vector2>({
-            /** @todo here it again incorrectly marks the begin including the
-                base X offset */
-            {23.f - 2.0f        - 0.06f, 9.0f - 3.0f        - 0.07f},
-            {23.f               + 0.08f, 9.0f - 3.0f        - 0.07f},
-            {23.f - 2.0f        - 0.06f, 9.0f               + 0.09f},
-            {23.f               + 0.08f, 9.0f               + 0.09f},
-        }), TestSuite::Compare::Container);
-        CORRADE_COMPARE_AS(editingCenterDistances.sliceSize(0*4, 1*4), Containers::arrayView<Vector2>({
-            {-1.0f              - 0.07f, -1.5f              - 0.08f},
-            {+1.0f              + 0.07f, -1.5f              - 0.08f},
-            {-1.0f              - 0.07f, +1.5f              + 0.08f},
-            {+1.0f              + 0.07f, +1.5f              + 0.08f},
-        }), TestSuite::Compare::Container);
-
-        /* Text 9 cursor, now quad 3, Again ordered ZYXW instead of XYZW
+        /* Text 9 cursor, now quad 1. Again ordered ZYXW instead of XYZW
            because the text is RTL. */
-        CORRADE_COMPARE_AS(editingPositions.sliceSize(3*4, 1*4), Containers::arrayView<Vector2>({
+        CORRADE_COMPARE_AS(editingPositions.sliceSize(1*4, 1*4), Containers::arrayView<Vector2>({
             {3.0f + 1.5f        - 0.03f, 6.5f - 4.0f        - 0.02f},
             {3.0f + 1.5f        + 0.01f, 6.5f - 4.0f        - 0.02f},
             {3.0f + 1.5f        - 0.03f, 6.5f + 2.0f        + 0.04f},
             {3.0f + 1.5f        + 0.01f, 6.5f + 2.0f        + 0.04f},
         }), TestSuite::Compare::Container);
-        CORRADE_COMPARE_AS(editingCenterDistances.sliceSize(3*4, 1*4), Containers::arrayView<Vector2>({
+        CORRADE_COMPARE_AS(editingCenterDistances.sliceSize(1*4, 1*4), Containers::arrayView<Vector2>({
             { 0.0f              - 0.02f, -3.0f              - 0.03f},
             { 0.0f              + 0.02f, -3.0f              - 0.03f},
             { 0.0f              - 0.02f, +3.0f              + 0.03f},
             { 0.0f              + 0.02f, +3.0f              + 0.03f},
         }), TestSuite::Compare::Container);
     }
+}
+
+void TextLayerTest::updateAlignment() {
+    auto&& data = UpdateAlignmentPaddingData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return _opened; }
+        Properties doOpenFile(Containers::StringView, Float) override {
+            _opened = true;
+            /* Font size and line height shouldn't be used for any alignment,
+               ascent / descent should */
+            return {100.0f, 3.5f, -2.0f, 200.0f, 1};
+        }
+        void doClose() override { _opened = false; }
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override {
+            struct Shaper: Text::AbstractShaper {
+                using Text::AbstractShaper::AbstractShaper;
+
+                UnsignedInt doShape(Containers::StringView text, UnsignedInt, UnsignedInt, Containers::ArrayView<const Text::FeatureRange>) override {
+                    return text.size();
+                }
+                bool doSetDirection(Text::ShapeDirection direction) override {
+                    _direction = direction;
+                    return true;
+                }
+                Text::ShapeDirection doDirection() const override {
+                    return _direction;
+                }
+                void doGlyphIdsInto(const Containers::StridedArrayView1D<UnsignedInt>& ids) const override {
+                    for(std::size_t i = 0; i != ids.size(); ++i)
+                        ids[i] = 0;
+                }
+                void doGlyphOffsetsAdvancesInto(const Containers::StridedArrayView1D<Vector2>& offsets, const Containers::StridedArrayView1D<Vector2>& advances) const override {
+                    for(std::size_t i = 0; i != offsets.size(); ++i) {
+                        offsets[i] = {};
+                        advances[i] = {1.5f, 0.0f};
+                    }
+                }
+                void doGlyphClustersInto(const Containers::StridedArrayView1D<UnsignedInt>& clusters) const override {
+                    /* Just a trivial 1:1 mapping */
+                    for(std::size_t i = 0; i != clusters.size(); ++i)
+                        clusters[i] = i;
+                }
+
+                private:
+                    Text::ShapeDirection _direction = Text::ShapeDirection::Unspecified;
+            };
+            return Containers::pointer<Shaper>(*this);
+        }
+
+        bool _opened = false;
+    } font;
+    font.openFile({}, 100.0f);
+
+    /* A trivial glyph cache. While font's ascent/descent goes both above and
+       below the line, this is just above. */
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    /* Default padding is 1, resetting to 0 for simplicity */
+    } cache{PixelFormat::R8Unorm, {32, 32}, {}};
+    cache.addGlyph(cache.addFont(1, &font), 0, {}, {{}, {1, 2}});
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{1}
+        .setEditingStyleCount(1)
+    };
+    shared.setGlyphCache(cache);
+
+    /* Font scaled 2x, so all metrics coming from the font or the cache should
+       be scaled 2x */
+    FontHandle fontHandle = shared.addFont(font, 200.0f);
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {fontHandle},
+        /* Alignment supplied in the style; alignment in TextProperties tested
+           in updatePadding() below, combination of both with a subset of the
+           alignment values in updateCleanDataOrder() above */
+        {data.alignment},
+        /* Features affect only create() / createGlyph() / setText() /
+           setGlyph(), not update(); tested in createSetTextTextProperties() */
+        {}, {}, {},
+        {0}, {0},
+        {});
+    shared.setEditingStyle(TextLayerCommonEditingStyleUniform{},
+        {TextLayerEditingStyleUniform{}},
+        {},
+        /* The padding should be added to the selection / cursor rectangle but
+           without shifting the whole text in any way */
+        {{0.1f, 0.2f, 0.3f, 0.4f}});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+
+        const State& stateData() const {
+            return static_cast<const State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
+
+    NodeHandle node3 = nodeHandle(3, 0);
+
+    /* 3 chars, size x2, so the bounding box is 9x11 */
+    DataHandle node3Data = layer.create(0,
+        "hey",
+        /* Direction passed from TextProperties, direction returned from the
+           shaper tested in updatePadding() below */
+        TextProperties{}.setShapeDirection(data.shapeDirection),
+        TextDataFlag::Editable,
+        node3);
+    layer.setCursor(node3Data, 1, 3);
+
+    Vector2 nodeOffsets[4];
+    Vector2 nodeSizes[4];
+    Float nodeOpacities[4]{};
+    UnsignedByte nodesEnabledData[1]{};
+    Containers::BitArrayView nodesEnabled{nodesEnabledData, 0, 4};
+    nodeOffsets[3] = {50.5f, 20.5f};
+    nodeSizes[3] = {200.8f, 100.4f};
+    UnsignedInt dataIds[]{0};
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+
+    /* 2--3
+       |  |
+       0--1 */
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().vertices).slice(&Implementation::TextLayerVertex::position), Containers::arrayView<Vector2>({
+        Vector2{0.0f, 0.0f} + data.offset,
+        Vector2{2.0f, 0.0f} + data.offset,
+        Vector2{0.0f, -4.0f} + data.offset,
+        Vector2{2.0f, -4.0f} + data.offset,
+
+        Vector2{3.0f, 0.0f} + data.offset,
+        Vector2{5.0f, 0.0f} + data.offset,
+        Vector2{3.0f, -4.0f} + data.offset,
+        Vector2{5.0f, -4.0f} + data.offset,
 
-    /* Removing a text marks the corresponding run as unused, the next update()
-       then recompacts it */
-    layer.remove(data7);
-    /* state() can additionally contain LayerState::NeedsNodeOffsetSizeUpdate
-       if we didn't pass it to the update() above, so test just that it
-       contains at least these flags */
-    CORRADE_COMPARE_AS(layer.state(),
-        LayerState::NeedsNodeEnabledUpdate|LayerState::NeedsAttachmentUpdate|LayerState::NeedsDataClean,
-        TestSuite::Compare::GreaterOrEqual);
-    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().glyphRuns).slice(&Implementation::TextLayerGlyphRun::glyphOffset), Containers::arrayView({
-        0u, 1u, 2u, 3u, 4u, 0xffffffffu, 6u, 7u
+        Vector2{6.0f, 0.0f} + data.offset,
+        Vector2{8.0f, 0.0f} + data.offset,
+        Vector2{6.0f, -4.0f} + data.offset,
+        Vector2{8.0f, -4.0f} + data.offset,
     }), TestSuite::Compare::Container);
-    if(data.flags >= TextDataFlag::Editable)
-        CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().textRuns).slice(&Implementation::TextLayerTextRun::textOffset), Containers::arrayView({
-            0xffffffffu, 4u
-        }), TestSuite::Compare::Container);
 
-    /* Again this explicitly adds NeedsDataUpdate to force recompaction */
-    UnsignedInt dataIdsPostRemoval[]{9};
-    layer.update(data.states|LayerState::NeedsDataUpdate, dataIdsPostRemoval, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    /* 0--1
+       |  |
+       2--3 */
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().editingVertices).slice(&Implementation::TextLayerEditingVertex::position), Containers::arrayView<Vector2>({
+        /* Selection containing glyph 1 and 2 (advance of 1.5*2), plus
+           padding; ascent 3.5*2, descent 2.0*2 */
+        Vector2{3.0f        - data.editingPaddingL, -7.0f - 0.2f} + data.offset,
+        Vector2{6.0f + 3.0f + data.editingPaddingR, -7.0f - 0.2f} + data.offset,
+        Vector2{3.0f        - data.editingPaddingL,  4.0f + 0.4f} + data.offset,
+        Vector2{6.0f + 3.0f + data.editingPaddingR,  4.0f + 0.4f} + data.offset,
 
-    /* There should be just 7 glyph runs, assigned to the remaining 7 data */
-    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().data).slice(&Implementation::TextLayerData::glyphRun), Containers::arrayView({
-        0u, 1u, 2u, 3u /* free data */, 3u, 5u /* free data */, 4u,
-        5u /* free data */, 5u, 6u, 10u /* free data */
-    }), TestSuite::Compare::Container);
-    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().glyphRuns).slice(&Implementation::TextLayerGlyphRun::glyphOffset), Containers::arrayView({
-        0u, 1u, 2u, 3u, 4u, 5u, 6u
-    }), TestSuite::Compare::Container);
-    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().glyphRuns).slice(&Implementation::TextLayerGlyphRun::glyphCount), Containers::arrayView({
-        1u, 1u, 1u, 1u, 1u, 1u, 2u
-    }), TestSuite::Compare::Container);
-    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().glyphRuns).slice(&Implementation::TextLayerGlyphRun::data), Containers::arrayView({
-        0u, 1u, 2u, 4u, 6u, 8u, 9u
+        /* Cursor before glyph 1, plus padding */
+        Vector2{3.0f        - data.editingPaddingL, -7.0f - 0.2f} + data.offset,
+        Vector2{3.0f        + data.editingPaddingR, -7.0f - 0.2f} + data.offset,
+        Vector2{3.0f        - data.editingPaddingL,  4.0f + 0.4f} + data.offset,
+        Vector2{3.0f        + data.editingPaddingR,  4.0f + 0.4f} + data.offset,
     }), TestSuite::Compare::Container);
+}
 
-    /* The glyph count queries should still match */
-    CORRADE_COMPARE(layer.glyphCount(data9), 2u);
+void TextLayerTest::updateAlignmentGlyph() {
+    auto&& data = UpdateAlignmentPaddingData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
 
-    /* And 1 text run, assigned to the remining text */
-    if(data.flags >= TextDataFlag::Editable) {
-        CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().data).slice(&Implementation::TextLayerData::textRun), Containers::arrayView({
-            0xffffffffu, 0xffffffffu, 0xffffffffu, 0u /* free data */,
-            0xffffffffu, 0xffffffffu, 0xffffffffu, 0u /* free data */,
-            0xffffffffu, 0u, 3u /* free data */
-        }), TestSuite::Compare::Container);
-        CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().textRuns).slice(&Implementation::TextLayerTextRun::textOffset), Containers::arrayView({
-            0u
-        }), TestSuite::Compare::Container);
-        CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().textRuns).slice(&Implementation::TextLayerTextRun::textSize), Containers::arrayView({
-            2u
-        }), TestSuite::Compare::Container);
-        CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().textRuns).slice(&Implementation::TextLayerTextRun::data), Containers::arrayView({
-            9u
-        }), TestSuite::Compare::Container);
-        CORRADE_COMPARE_AS(layer.stateData().textData,
-            "hi",
-            TestSuite::Compare::String);
+    /* A trivial glyph cache. Goes both above and below the line to verify
+       vertical alignment. */
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
 
-        /* The text queries should still match also */
-        CORRADE_COMPARE(layer.text(data9), "hi");
-    }
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    /* Default padding is 1, resetting to 0 for simplicity */
+    } cache{PixelFormat::R8Unorm, {32, 32}, {}};
 
-    /* Indices for remaining 2 visible glyphs */
-    CORRADE_COMPARE_AS(layer.stateData().indices, Containers::arrayView<UnsignedInt>({
-        /* Text 9, "hi", quads 6 to 7 */
-        6*4 + 0, 6*4 + 1, 6*4 + 2, 6*4 + 2, 6*4 + 1, 6*4 + 3,
-        7*4 + 0, 7*4 + 1, 7*4 + 2, 7*4 + 2, 7*4 + 1, 7*4 + 3,
-        /* Text 7, "ahoy", is removed now */
-        /* Text 3, "hello", is removed now */
-        /* Glyph 5 is removed now */
-    }), TestSuite::Compare::Container);
-    if(data.expectEditingDataPresent)
-        CORRADE_COMPARE_AS(layer.stateData().editingIndices, Containers::arrayView<UnsignedInt>({
-            /* Cursor for text 9, "hi", quad 1 (selection would be quad 0) */
-            1*4 + 0,  1*4 + 2,  1*4 + 1,  1*4 + 2,  1*4 + 3,  1*4 + 1,
-        }), TestSuite::Compare::Container);
-    else
-        CORRADE_COMPARE_AS(layer.stateData().editingIndices, Containers::arrayView<UnsignedInt>({
-        }), TestSuite::Compare::Container);
+    UnsignedInt glyphCacheFontId = cache.addFont(18);
+    cache.addGlyph(glyphCacheFontId, 17, {-2, -3}, {{}, {3, 4}});
 
-    /* For drawing data 9 it needs to draw the first 2 quads in the index
-       buffer. For editing just the data 9 cursor quad. */
-    if(data.expectEditingDataPresent)
-        CORRADE_COMPARE_AS(layer.stateData().indexDrawOffsets, (Containers::arrayView<Containers::Pair<UnsignedInt, UnsignedInt>>({
-            {0, 0}, {2*6, 6}
-        })), TestSuite::Compare::Container);
-    else
-        CORRADE_COMPARE_AS(layer.stateData().indexDrawOffsets, (Containers::arrayView<Containers::Pair<UnsignedInt, UnsignedInt>>({
-            {0, 0}, {2*6, 0}
-        })), TestSuite::Compare::Container);
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
 
-    /* Vertices for all remaining 8 glyphs */
-    CORRADE_COMPARE(layer.stateData().vertices.size(), 8*4);
-    /* (Possibly editable) text 9, quads 6 to 7 */
-    for(std::size_t i = 0; i != 2*4; ++i) {
-        CORRADE_ITERATION(i);
-        CORRADE_COMPARE(layer.stateData().vertices[6*4 + i].color, 0x663399ff_rgbaf*0.9f);
-        /* Created with style 3, which is mapped to uniform 1. There's only a
-           cursor, which doesn't override the text uniform, so it's always the
-           same. */
-        CORRADE_COMPARE(layer.stateData().vertices[6*4 + i].styleUniform, 1);
-    }
+        using TextLayer::Shared::setGlyphCache;
 
-    /* Text 9, now quad 6 to 7 */
-    CORRADE_COMPARE_AS(positions.sliceSize(6*4, 2*4), Containers::arrayView<Vector2>({
-        {3.0f + 0.0f,              6.5f - 0.5f},
-        {3.0f + 0.0f,              6.5f - 0.5f},
-        {3.0f + 0.0f,              6.5f - 0.5f},
-        {3.0f + 0.0f,              6.5f - 0.5f},
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{1}};
+    shared.setGlyphCache(cache);
 
-        {3.0f + 1.5f + 2.f + 0.0f, 6.5f - 1.0f + 4.0f - 0.0f},
-        {3.0f + 1.5f + 2.f + 8.0f, 6.5f - 1.0f + 4.0f - 0.0f},
-        {3.0f + 1.5f + 2.f + 0.0f, 6.5f - 1.0f + 4.0f - 8.0f},
-        {3.0f + 1.5f + 2.f + 8.0f, 6.5f - 1.0f + 4.0f - 8.0f},
-    }), TestSuite::Compare::Container);
+    /* Font scaled 2x, so all metrics coming from the the cache should be
+       scaled 2x */
+    FontHandle fontHandle = shared.addInstancelessFont(glyphCacheFontId, 2.0f);
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {fontHandle},
+        /* Alignment supplied in the style; alignment in TextProperties tested
+           in updatePaddingGlyph() below, combination of both with a subset of
+           the alignment values in updateCleanDataOrder() above */
+        {data.alignment},
+        /* Features affect only create() / createGlyph() / setText() /
+           setGlyph(), not update(); tested in createSetTextTextProperties() */
+        {}, {}, {},
+        /* Editing styles aren't used for single glyphs */
+        {}, {},
+        {});
 
-    /* Glyph 22, now only at quad 6 */
-    CORRADE_COMPARE_AS(textureCoordinates.sliceSize(6*4, 4), Containers::arrayView<Vector3>({
-        {},
-        {},
-        {},
-        {},
-    }), TestSuite::Compare::Container);
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
 
-    /* Glyph 13, now only at quad 7 */
-    CORRADE_COMPARE_AS(textureCoordinates.sliceSize(7*4, 4), Containers::arrayView<Vector3>({
-        {0.5f, 0.5f, 0.0f},
-        {1.0f, 0.5f, 0.0f},
-        {0.5f, 1.0f, 0.0f},
-        {1.0f, 1.0f, 0.0f},
-    }), TestSuite::Compare::Container);
+        const State& stateData() const {
+            return static_cast<const State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
 
-    if(data.expectEditingDataPresent) {
-        for(std::size_t i = 0; i != 4; ++i) {
-            CORRADE_ITERATION(i);
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
 
-            /* Text 9 cursor, now quad 1 */
-            CORRADE_COMPARE(layer.stateData().editingVertices[1*4 + i].opacity, 0.9f);
-            CORRADE_COMPARE(layer.stateData().editingVertices[1*4 + i].styleUniform, 3);
-        }
+    NodeHandle node3 = nodeHandle(3, 0);
 
-        Containers::StridedArrayView1D<const Vector2> editingPositions = stridedArrayView(layer.stateData().editingVertices).slice(&Implementation::TextLayerEditingVertex::position);
-        Containers::StridedArrayView1D<const Vector2> editingCenterDistances = stridedArrayView(layer.stateData().editingVertices).slice(&Implementation::TextLayerEditingVertex::centerDistance);
+    /* Size x2, so the bounding box is 6x8 */
+    layer.createGlyph(
+        0,
+        17,
+        /* There's no way to detect the direction as no shaper is used, so
+           compared to updateAlignment() / updatePadding() this is always
+           passed in via TextProperties */
+        TextProperties{}.setShapeDirection(data.shapeDirection),
+        node3);
 
-        /* Text 9 cursor, now quad 1. Again ordered ZYXW instead of XYZW
-           because the text is RTL. */
-        CORRADE_COMPARE_AS(editingPositions.sliceSize(1*4, 1*4), Containers::arrayView<Vector2>({
-            {3.0f + 1.5f        - 0.03f, 6.5f - 4.0f        - 0.02f},
-            {3.0f + 1.5f        + 0.01f, 6.5f - 4.0f        - 0.02f},
-            {3.0f + 1.5f        - 0.03f, 6.5f + 2.0f        + 0.04f},
-            {3.0f + 1.5f        + 0.01f, 6.5f + 2.0f        + 0.04f},
-        }), TestSuite::Compare::Container);
-        CORRADE_COMPARE_AS(editingCenterDistances.sliceSize(1*4, 1*4), Containers::arrayView<Vector2>({
-            { 0.0f              - 0.02f, -3.0f              - 0.03f},
-            { 0.0f              + 0.02f, -3.0f              - 0.03f},
-            { 0.0f              - 0.02f, +3.0f              + 0.03f},
-            { 0.0f              + 0.02f, +3.0f              + 0.03f},
-        }), TestSuite::Compare::Container);
-    }
+    Vector2 nodeOffsets[4];
+    Vector2 nodeSizes[4];
+    Float nodeOpacities[4]{};
+    UnsignedByte nodesEnabledData[1]{};
+    Containers::BitArrayView nodesEnabled{nodesEnabledData, 0, 4};
+    nodeOffsets[3] = {50.5f, 20.5f};
+    nodeSizes[3] = {200.8f, 100.4f};
+    UnsignedInt dataIds[]{0};
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+
+    /* 2--3
+       |  |
+       0--1 */
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().vertices).slice(&Implementation::TextLayerVertex::position), Containers::arrayView<Vector2>({
+        Vector2{0.0f, 0.0f} + data.offsetGlyph,
+        Vector2{6.0f, 0.0f} + data.offsetGlyph,
+        Vector2{0.0f, -8.0f} + data.offsetGlyph,
+        Vector2{6.0f, -8.0f} + data.offsetGlyph
+    }), TestSuite::Compare::Container);
 }
 
-void TextLayerTest::updateAlignment() {
+void TextLayerTest::updatePadding() {
     auto&& data = UpdateAlignmentPaddingData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
 
+    /* Same as updateAlignment(), except that the node offset & size is
+       different and only matches the original if padding is applied
+       correctly from both the data and the style. Additionally, in comparison
+       to updateAlignment(), shape direction is returned from the shaper
+       directly instead of being passed from TextProperties, and the
+       style-supplied alignment is a bogus value and padding from the
+       TextProperties is used instead. */
+
     struct: Text::AbstractFont {
         Text::FontFeatures doFeatures() const override { return {}; }
         bool doIsOpened() const override { return _opened; }
@@ -9165,14 +12316,10 @@ void TextLayerTest::updateAlignment() {
         Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
         Containers::Pointer<Text::AbstractShaper> doCreateShaper() override {
             struct Shaper: Text::AbstractShaper {
-                using Text::AbstractShaper::AbstractShaper;
-
-                UnsignedInt doShape(Containers::StringView text, UnsignedInt, UnsignedInt, Containers::ArrayView<const Text::FeatureRange>) override {
-                    return text.size();
-                }
-                bool doSetDirection(Text::ShapeDirection direction) override {
-                    _direction = direction;
-                    return true;
+                explicit Shaper(Text::AbstractFont& font, Text::ShapeDirection direction): Text::AbstractShaper{font}, _direction{direction} {}
+
+                UnsignedInt doShape(Containers::StringView text, UnsignedInt, UnsignedInt, Containers::ArrayView<const Text::FeatureRange>) override {
+                    return text.size();
                 }
                 Text::ShapeDirection doDirection() const override {
                     return _direction;
@@ -9193,14 +12340,17 @@ void TextLayerTest::updateAlignment() {
                         clusters[i] = i;
                 }
 
-                private:
-                    Text::ShapeDirection _direction = Text::ShapeDirection::Unspecified;
+                Text::ShapeDirection _direction;
             };
-            return Containers::pointer<Shaper>(*this);
+            return Containers::pointer<Shaper>(*this, direction);
         }
 
+        Text::ShapeDirection direction;
         bool _opened = false;
     } font;
+    /* Direction returned from the shaper, direction passed through from
+       TextProperties tested in updateAlignment() above */
+    font.direction = data.shapeDirection;
     font.openFile({}, 100.0f);
 
     /* A trivial glyph cache. While font's ascent/descent goes both above and
@@ -9232,15 +12382,14 @@ void TextLayerTest::updateAlignment() {
     shared.setStyle(TextLayerCommonStyleUniform{},
         {TextLayerStyleUniform{}},
         {fontHandle},
-        /* Alignment supplied in the style; alignment in TextProperties tested
-           in updatePadding() below, combination of both with a subset of the
-           alignment values in updateCleanDataOrder() above */
-        {data.alignment},
+        /* Alignment set to an arbitrary value, the one from TextProperties
+           should get used instead */
+        {Text::Alignment::BottomRight},
         /* Features affect only create() / createGlyph() / setText() /
            setGlyph(), not update(); tested in createSetTextTextProperties() */
         {}, {}, {},
         {0}, {0},
-        {});
+        {{10.0f, 5.0f, 20.0f, 10.0f}});
     shared.setEditingStyle(TextLayerCommonEditingStyleUniform{},
         {TextLayerEditingStyleUniform{}},
         {},
@@ -9263,13 +12412,8 @@ void TextLayerTest::updateAlignment() {
     NodeHandle node3 = nodeHandle(3, 0);
 
     /* 3 chars, size x2, so the bounding box is 9x11 */
-    DataHandle node3Data = layer.create(0,
-        "hey",
-        /* Direction passed from TextProperties, direction returned from the
-           shaper tested in updatePadding() below */
-        TextProperties{}.setShapeDirection(data.shapeDirection),
-        TextDataFlag::Editable,
-        node3);
+    DataHandle node3Data = layer.create(0, "hey", data.alignment, TextDataFlag::Editable, node3);
+    layer.setPadding(node3Data, {20.0f, 5.0f, 50.0f, 30.0f});
     layer.setCursor(node3Data, 1, 3);
 
     Vector2 nodeOffsets[4];
@@ -9277,8 +12421,8 @@ void TextLayerTest::updateAlignment() {
     Float nodeOpacities[4]{};
     UnsignedByte nodesEnabledData[1]{};
     Containers::BitArrayView nodesEnabled{nodesEnabledData, 0, 4};
-    nodeOffsets[3] = {50.5f, 20.5f};
-    nodeSizes[3] = {200.8f, 100.4f};
+    nodeOffsets[3] = {20.5f, 10.5f};
+    nodeSizes[3] = {300.8f, 150.4f};
     UnsignedInt dataIds[]{0};
     layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
 
@@ -9321,10 +12465,16 @@ void TextLayerTest::updateAlignment() {
     }), TestSuite::Compare::Container);
 }
 
-void TextLayerTest::updateAlignmentGlyph() {
+void TextLayerTest::updatePaddingGlyph() {
     auto&& data = UpdateAlignmentPaddingData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
 
+    /* Same as updateAlignmentGlyph(), except that the node offset & size is
+       different and only matches the original if padding is applied
+       correctly from both the data and the style. Additionally, in comparison
+       to updateAlignmentGlyph(), the style-supplied alignment is a bogus value
+       and padding from the TextProperties is used instead. */
+
     /* A trivial glyph cache. Goes both above and below the line to verify
        vertical alignment. */
     struct: Text::AbstractGlyphCache {
@@ -9354,16 +12504,15 @@ void TextLayerTest::updateAlignmentGlyph() {
     shared.setStyle(TextLayerCommonStyleUniform{},
         {TextLayerStyleUniform{}},
         {fontHandle},
-        /* Alignment supplied in the style; alignment in TextProperties tested
-           in updatePaddingGlyph() below, combination of both with a subset of
-           the alignment values in updateCleanDataOrder() above */
-        {data.alignment},
+        /* Alignment set to an arbitrary value, the one from TextProperties
+           should get used instead */
+        {Text::Alignment::BottomRight},
         /* Features affect only create() / createGlyph() / setText() /
            setGlyph(), not update(); tested in createSetTextTextProperties() */
         {}, {}, {},
         /* Editing styles aren't used for single glyphs */
         {}, {},
-        {});
+        {{10.0f, 5.0f, 20.0f, 10.0f}});
 
     struct Layer: TextLayer {
         explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
@@ -9380,22 +12529,23 @@ void TextLayerTest::updateAlignmentGlyph() {
     NodeHandle node3 = nodeHandle(3, 0);
 
     /* Size x2, so the bounding box is 6x8 */
-    layer.createGlyph(
-        0,
-        17,
-        /* There's no way to detect the direction as no shaper is used, so
-           compared to updateAlignment() / updatePadding() this is always
-           passed in via TextProperties */
-        TextProperties{}.setShapeDirection(data.shapeDirection),
+    DataHandle node3Data = layer.createGlyph(0, 17,
+        TextProperties{}
+            .setAlignment(data.alignment)
+            /* There's no way to detect the direction as no shaper is used, so
+               compared to updateAlignment() / updatePadding() this is always
+               passed in via TextProperties */
+            .setShapeDirection(data.shapeDirection),
         node3);
+    layer.setPadding(node3Data, {20.0f, 5.0f, 50.0f, 30.0f});
 
     Vector2 nodeOffsets[4];
     Vector2 nodeSizes[4];
     Float nodeOpacities[4]{};
     UnsignedByte nodesEnabledData[1]{};
     Containers::BitArrayView nodesEnabled{nodesEnabledData, 0, 4};
-    nodeOffsets[3] = {50.5f, 20.5f};
-    nodeSizes[3] = {200.8f, 100.4f};
+    nodeOffsets[3] = {20.5f, 10.5f};
+    nodeSizes[3] = {300.8f, 150.4f};
     UnsignedInt dataIds[]{0};
     layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
 
@@ -9410,73 +12560,337 @@ void TextLayerTest::updateAlignmentGlyph() {
     }), TestSuite::Compare::Container);
 }
 
-void TextLayerTest::updatePadding() {
-    auto&& data = UpdateAlignmentPaddingData[testCaseInstanceId()];
-    setTestCaseDescription(data.name);
+void TextLayerTest::updateVertexUpdateRange() {
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
 
-    /* Same as updateAlignment(), except that the node offset & size is
-       different and only matches the original if padding is applied
-       correctly from both the data and the style. Additionally, in comparison
-       to updateAlignment(), shape direction is returned from the shaper
-       directly instead of being passed from TextProperties, and the
-       style-supplied alignment is a bogus value and padding from the
-       TextProperties is used instead. */
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    /* Default padding is 1, resetting to 0 for simplicity */
+    } cache{PixelFormat::R8Unorm, {32, 32}, {}};
+
+    UnsignedInt glyphCacheFontId = cache.addFont(18);
+    cache.addGlyph(glyphCacheFontId, 17, {-2, -3}, {{}, {3, 4}});
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{1}};
+    shared.setGlyphCache(cache);
+
+    FontHandle fontHandle = shared.addInstancelessFont(glyphCacheFontId, 1.0f);
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {fontHandle},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+
+        State& stateData() {
+            return static_cast<State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
+
+    layer.createGlyph(0, 17, {}, nodeHandle(0, 0));
+    DataHandle data1 = layer.createGlyph(0, 17, {}, nodeHandle(1, 0));
+    layer.createGlyph(0, 17, {}, nodeHandle(2, 0));
+
+    const auto resetRange = [&]() {
+        layer.stateData().vertexUpdateBegin = ~UnsignedInt{};
+        layer.stateData().vertexUpdateEnd = 0;
+    };
+
+    Vector2 nodeOffsets[3];
+    Vector2 nodeSizes[3];
+    Float nodeOpacities[3]{1.0f, 1.0f, 1.0f};
+    UnsignedByte nodesEnabledData[1]{};
+    Containers::BitArrayView nodesEnabled{nodesEnabledData, 0, 3};
+    UnsignedInt dataIds[]{0, 1, 2};
+
+    /* Initially the vertex data get allocated, so the range is everything */
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.stateData().vertices.size(), 3*4);
+    CORRADE_COMPARE(layer.stateData().vertexUpdateBegin, 0);
+    CORRADE_COMPARE(layer.stateData().vertexUpdateEnd, 3*4);
+
+    /* Updating again with nothing changed results in an empty range */
+    resetRange();
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.stateData().vertexUpdateBegin, ~UnsignedInt{});
+    CORRADE_COMPARE(layer.stateData().vertexUpdateEnd, 0);
+
+    /* Changing a color of the second data updates just its vertices */
+    layer.setColor(data1, 0xff3366_rgbf);
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.stateData().vertexUpdateBegin, 1*4);
+    CORRADE_COMPARE(layer.stateData().vertexUpdateEnd, 2*4);
+
+    /* Moving the third node extends the range, as it wasn't reset */
+    nodeOffsets[2] = {15.0f, 3.0f};
+    layer.update(LayerState::NeedsNodeOffsetSizeUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.stateData().vertexUpdateBegin, 1*4);
+    CORRADE_COMPARE(layer.stateData().vertexUpdateEnd, 3*4);
+
+    /* Moving the first node after a reset gives just the first range */
+    resetRange();
+    nodeOffsets[0] = {2.0f, 7.0f};
+    layer.update(LayerState::NeedsNodeOffsetSizeUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.stateData().vertexUpdateBegin, 0);
+    CORRADE_COMPARE(layer.stateData().vertexUpdateEnd, 1*4);
+}
+
+void TextLayerTest::updateVertexUpdateRangeChunks() {
+    /* One glyph for each byte with a constant advance, `b` is glyph 1 and
+       everything else glyph 0 */
+    struct Shaper: Text::AbstractShaper {
+        using Text::AbstractShaper::AbstractShaper;
+
+        UnsignedInt doShape(Containers::StringView text, UnsignedInt, UnsignedInt, Containers::ArrayView<const Text::FeatureRange>) override {
+            _text = text;
+            return text.size();
+        }
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<UnsignedInt>& ids) const override {
+            for(std::size_t i = 0; i != ids.size(); ++i)
+                ids[i] = _text[i] == 'b' ? 1 : 0;
+        }
+        void doGlyphOffsetsAdvancesInto(const Containers::StridedArrayView1D<Vector2>& offsets, const Containers::StridedArrayView1D<Vector2>& advances) const override {
+            for(std::size_t i = 0; i != offsets.size(); ++i) {
+                offsets[i] = {};
+                advances[i] = {1.0f, 0.0f};
+            }
+        }
+        void doGlyphClustersInto(const Containers::StridedArrayView1D<UnsignedInt>&) const override {
+            CORRADE_FAIL("This shouldn't be called.");
+        }
+
+        private:
+            Containers::StringView _text;
+    };
 
     struct: Text::AbstractFont {
         Text::FontFeatures doFeatures() const override { return {}; }
         bool doIsOpened() const override { return _opened; }
-        Properties doOpenFile(Containers::StringView, Float) override {
+        Properties doOpenFile(Containers::StringView, Float size) override {
             _opened = true;
-            /* Font size and line height shouldn't be used for any alignment,
-               ascent / descent should */
-            return {100.0f, 3.5f, -2.0f, 200.0f, 1};
+            return {size, 1.0f, -1.0f, 2.0f, 2};
         }
         void doClose() override { _opened = false; }
 
         void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
         Vector2 doGlyphSize(UnsignedInt) override { return {}; }
         Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
-        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override {
-            struct Shaper: Text::AbstractShaper {
-                explicit Shaper(Text::AbstractFont& font, Text::ShapeDirection direction): Text::AbstractShaper{font}, _direction{direction} {}
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<Shaper>(*this); }
 
-                UnsignedInt doShape(Containers::StringView text, UnsignedInt, UnsignedInt, Containers::ArrayView<const Text::FeatureRange>) override {
-                    return text.size();
-                }
-                Text::ShapeDirection doDirection() const override {
-                    return _direction;
-                }
-                void doGlyphIdsInto(const Containers::StridedArrayView1D<UnsignedInt>& ids) const override {
-                    for(std::size_t i = 0; i != ids.size(); ++i)
-                        ids[i] = 0;
-                }
-                void doGlyphOffsetsAdvancesInto(const Containers::StridedArrayView1D<Vector2>& offsets, const Containers::StridedArrayView1D<Vector2>& advances) const override {
-                    for(std::size_t i = 0; i != offsets.size(); ++i) {
-                        offsets[i] = {};
-                        advances[i] = {1.5f, 0.0f};
-                    }
-                }
-                void doGlyphClustersInto(const Containers::StridedArrayView1D<UnsignedInt>& clusters) const override {
-                    /* Just a trivial 1:1 mapping */
-                    for(std::size_t i = 0; i != clusters.size(); ++i)
-                        clusters[i] = i;
-                }
+        bool _opened = false;
+    } font;
+    font.openFile({}, 1.0f);
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    /* Default padding is 1, resetting to 0 for simplicity */
+    } cache{PixelFormat::R8Unorm, {32, 32}, {}};
+
+    UnsignedInt glyphCacheFontId = cache.addFont(2, &font);
+    cache.addGlyph(glyphCacheFontId, 0, {}, {{}, {2, 2}});
+    cache.addGlyph(glyphCacheFontId, 1, {}, {{2, 0}, {4, 2}});
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{1}};
+    shared.setGlyphCache(cache);
+    /* Interestingly enough, these two can't be chained together as on some
+       compilers it'd call addFont() before setGlyphCache(), causing an
+       assert */
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {shared.addFont(font, 1.0f)},
+        /* Aligned to the left so a change in the glyphs doesn't shift the
+           whole text */
+        {Text::Alignment::LineLeft},
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+
+        State& stateData() {
+            return static_cast<State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
+
+    /* A text spanning two full chunks and a part of a third */
+    const UnsignedInt size = Implementation::TextLayerGlyphChunkSize*2 + 100;
+    Containers::String text{ValueInit, size};
+    for(char& c: text)
+        c = 'a';
+    DataHandle data = layer.create(0, text, {}, nodeHandle(0, 0));
+
+    Vector2 nodeOffsets[1];
+    Vector2 nodeSizes[1];
+    Float nodeOpacities[1]{1.0f};
+    UnsignedByte nodesEnabledData[1]{};
+    Containers::BitArrayView nodesEnabled{nodesEnabledData, 0, 1};
+    UnsignedInt dataIds[]{0};
+
+    /* Initially the vertex data get allocated, so the range is everything */
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.stateData().vertices.size(), size*4);
+    CORRADE_COMPARE(layer.stateData().vertexUpdateBegin, 0);
+    CORRADE_COMPARE(layer.stateData().vertexUpdateEnd, size*4);
+
+    /* Changing a glyph in the middle chunk updates just that chunk */
+    layer.stateData().vertexUpdateBegin = ~UnsignedInt{};
+    layer.stateData().vertexUpdateEnd = 0;
+    text[Implementation::TextLayerGlyphChunkSize + 500] = 'b';
+    layer.setText(data, text, {});
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.stateData().vertexUpdateBegin, Implementation::TextLayerGlyphChunkSize*4);
+    CORRADE_COMPARE(layer.stateData().vertexUpdateEnd, Implementation::TextLayerGlyphChunkSize*2*4);
+
+    /* Changing a glyph in the last, partial, chunk updates to the end */
+    layer.stateData().vertexUpdateBegin = ~UnsignedInt{};
+    layer.stateData().vertexUpdateEnd = 0;
+    text[size - 1] = 'b';
+    layer.setText(data, text, {});
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.stateData().vertexUpdateBegin, Implementation::TextLayerGlyphChunkSize*2*4);
+    CORRADE_COMPARE(layer.stateData().vertexUpdateEnd, size*4);
+
+    /* Setting the same text again updates nothing */
+    layer.stateData().vertexUpdateBegin = ~UnsignedInt{};
+    layer.stateData().vertexUpdateEnd = 0;
+    layer.setText(data, text, {});
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.stateData().vertexUpdateBegin, ~UnsignedInt{});
+    CORRADE_COMPARE(layer.stateData().vertexUpdateEnd, 0);
+}
+
+void TextLayerTest::updateClipGlyphCulling() {
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    /* Default padding is 1, resetting to 0 for simplicity */
+    } cache{PixelFormat::R8Unorm, {32, 32}, {}};
+
+    UnsignedInt glyphCacheFontId = cache.addFont(18);
+    cache.addGlyph(glyphCacheFontId, 17, {-2, -3}, {{}, {3, 4}});
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{1}};
+    shared.setGlyphCache(cache);
+
+    FontHandle fontHandle = shared.addInstancelessFont(glyphCacheFontId, 1.0f);
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {fontHandle},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+
+        const State& stateData() const {
+            return static_cast<const State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
 
-                Text::ShapeDirection _direction;
-            };
-            return Containers::pointer<Shaper>(*this, direction);
-        }
+    layer.createGlyph(0, 17, {}, nodeHandle(0, 0));
+    layer.createGlyph(0, 17, {}, nodeHandle(1, 0));
+    layer.createGlyph(0, 17, {}, nodeHandle(2, 0));
+
+    /* The first two nodes are clipped by the first clip rect, the third by a
+       zero-size one, meaning no clipping. The second node is outside of the
+       clip rect. */
+    Vector2 nodeOffsets[]{
+        {10.0f, 10.0f},
+        {100.0f, 10.0f},
+        {100.0f, 100.0f},
+    };
+    Vector2 nodeSizes[]{
+        {10.0f, 10.0f},
+        {10.0f, 10.0f},
+        {10.0f, 10.0f},
+    };
+    Float nodeOpacities[3]{1.0f, 1.0f, 1.0f};
+    UnsignedByte nodesEnabledData[1]{};
+    Containers::BitArrayView nodesEnabled{nodesEnabledData, 0, 3};
+    UnsignedInt dataIds[]{0, 1, 2};
+    UnsignedInt clipRectIds[]{0, 1};
+    UnsignedInt clipRectDataCounts[]{2, 1};
+    Vector2 clipRectOffsets[]{
+        {0.0f, 0.0f},
+        {},
+    };
+    Vector2 clipRectSizes[]{
+        {50.0f, 50.0f},
+        {},
+    };
 
-        Text::ShapeDirection direction;
-        bool _opened = false;
-    } font;
-    /* Direction returned from the shaper, direction passed through from
-       TextProperties tested in updateAlignment() above */
-    font.direction = data.shapeDirection;
-    font.openFile({}, 100.0f);
+    /* Only quads of the first and third glyph are drawn, the draw offset for
+       the second data is an empty range */
+    layer.update(LayerState::NeedsDataUpdate, dataIds, clipRectIds, clipRectDataCounts, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, clipRectOffsets, clipRectSizes, {}, {});
+    CORRADE_COMPARE(layer.stateData().vertices.size(), 3*4);
+    CORRADE_COMPARE_AS(layer.stateData().indices, Containers::arrayView<UnsignedInt>({
+        0*4 + 0, 0*4 + 1, 0*4 + 2, 0*4 + 2, 0*4 + 1, 0*4 + 3,
+        2*4 + 0, 2*4 + 1, 2*4 + 2, 2*4 + 2, 2*4 + 1, 2*4 + 3,
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(layer.stateData().indexDrawOffsets, (Containers::arrayView<Containers::Pair<UnsignedInt, UnsignedInt>>({
+        {0, 0}, {6, 0}, {6, 0}, {2*6, 0}
+    })), TestSuite::Compare::Container);
 
-    /* A trivial glyph cache. While font's ascent/descent goes both above and
-       below the line, this is just above. */
+    /* Moving the second node partially inside the clip rect makes it drawn
+       again */
+    nodeOffsets[1] = {45.0f, 10.0f};
+    layer.update(LayerState::NeedsNodeOffsetSizeUpdate, dataIds, clipRectIds, clipRectDataCounts, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, clipRectOffsets, clipRectSizes, {}, {});
+    CORRADE_COMPARE_AS(layer.stateData().indices, Containers::arrayView<UnsignedInt>({
+        0*4 + 0, 0*4 + 1, 0*4 + 2, 0*4 + 2, 0*4 + 1, 0*4 + 3,
+        1*4 + 0, 1*4 + 1, 1*4 + 2, 1*4 + 2, 1*4 + 1, 1*4 + 3,
+        2*4 + 0, 2*4 + 1, 2*4 + 2, 2*4 + 2, 2*4 + 1, 2*4 + 3,
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(layer.stateData().indexDrawOffsets, (Containers::arrayView<Containers::Pair<UnsignedInt, UnsignedInt>>({
+        {0, 0}, {6, 0}, {2*6, 0}, {3*6, 0}
+    })), TestSuite::Compare::Container);
+
+    /* Without any clip rects passed, nothing is culled */
+    nodeOffsets[1] = {100.0f, 10.0f};
+    layer.update(LayerState::NeedsNodeOffsetSizeUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.stateData().indices.size(), 3*6);
+}
+
+void TextLayerTest::updateInstancedGlyphs() {
     struct: Text::AbstractGlyphCache {
         using Text::AbstractGlyphCache::AbstractGlyphCache;
 
@@ -9484,7 +12898,10 @@ void TextLayerTest::updatePadding() {
         void doSetImage(const Vector2i&, const ImageView2D&) override {}
     /* Default padding is 1, resetting to 0 for simplicity */
     } cache{PixelFormat::R8Unorm, {32, 32}, {}};
-    cache.addGlyph(cache.addFont(1, &font), 0, {}, {{}, {1, 2}});
+
+    UnsignedInt glyphCacheFontId = cache.addFont(18);
+    UnsignedInt glyph17 = cache.addGlyph(glyphCacheFontId, 17, {-2, -3}, {{}, {3, 4}});
+    UnsignedInt glyph22 = cache.addGlyph(glyphCacheFontId, 22, {1, 1}, {{4, 0}, {6, 2}});
 
     struct LayerShared: TextLayer::Shared {
         explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
@@ -9493,37 +12910,26 @@ void TextLayerTest::updatePadding() {
 
         void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
         void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
-    } shared{TextLayer::Shared::Configuration{1}
-        .setEditingStyleCount(1)
-    };
+    } shared{TextLayer::Shared::Configuration{2, 3}
+        .setInstancedGlyphs(true)};
     shared.setGlyphCache(cache);
+    CORRADE_VERIFY(shared.hasInstancedGlyphs());
 
-    /* Font scaled 2x, so all metrics coming from the font or the cache should
-       be scaled 2x */
-    FontHandle fontHandle = shared.addFont(font, 200.0f);
+    FontHandle fontHandle = shared.addInstancelessFont(glyphCacheFontId, 2.0f);
     shared.setStyle(TextLayerCommonStyleUniform{},
-        {TextLayerStyleUniform{}},
-        {fontHandle},
-        /* Alignment set to an arbitrary value, the one from TextProperties
-           should get used instead */
-        {Text::Alignment::BottomRight},
-        /* Features affect only create() / createGlyph() / setText() /
-           setGlyph(), not update(); tested in createSetTextTextProperties() */
-        {}, {}, {},
-        {0}, {0},
-        {{10.0f, 5.0f, 20.0f, 10.0f}});
-    shared.setEditingStyle(TextLayerCommonEditingStyleUniform{},
-        {TextLayerEditingStyleUniform{}},
-        {},
-        /* The padding should be added to the selection / cursor rectangle but
-           without shifting the whole text in any way */
-        {{0.1f, 0.2f, 0.3f, 0.4f}});
+        {TextLayerStyleUniform{}, TextLayerStyleUniform{}},
+        {1, 0, 1},
+        {fontHandle, fontHandle, fontHandle},
+        {Text::Alignment::MiddleCenter,
+         Text::Alignment::MiddleCenter,
+         Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
 
     struct Layer: TextLayer {
         explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
 
-        const State& stateData() const {
-            return static_cast<const State&>(*_state);
+        State& stateData() {
+            return static_cast<State&>(*_state);
         }
     } layer{layerHandle(0, 1), shared};
 
@@ -9531,74 +12937,78 @@ void TextLayerTest::updatePadding() {
        guarantees the same on a higher level), not needed for anything here */
     layer.setSize({1, 1}, {1, 1});
 
-    NodeHandle node3 = nodeHandle(3, 0);
-
-    /* 3 chars, size x2, so the bounding box is 9x11 */
-    DataHandle node3Data = layer.create(0, "hey", data.alignment, TextDataFlag::Editable, node3);
-    layer.setPadding(node3Data, {20.0f, 5.0f, 50.0f, 30.0f});
-    layer.setCursor(node3Data, 1, 3);
+    DataHandle first = layer.createGlyph(0, 17, {}, nodeHandle(0, 0));
+    layer.createGlyph(1, 22, {}, nodeHandle(1, 0));
+    layer.setColor(first, 0xff3366_rgbf);
 
-    Vector2 nodeOffsets[4];
-    Vector2 nodeSizes[4];
-    Float nodeOpacities[4]{};
+    Vector2 nodeOffsets[2]{{10.0f, 20.0f}, {30.0f, 40.0f}};
+    Vector2 nodeSizes[2]{{2.0f, 2.0f}, {4.0f, 4.0f}};
+    Float nodeOpacities[2]{1.0f, 0.5f};
     UnsignedByte nodesEnabledData[1]{};
-    Containers::BitArrayView nodesEnabled{nodesEnabledData, 0, 4};
-    nodeOffsets[3] = {20.5f, 10.5f};
-    nodeSizes[3] = {300.8f, 150.4f};
-    UnsignedInt dataIds[]{0};
-    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
-
-    /* 2--3
-       |  |
-       0--1 */
-    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().vertices).slice(&Implementation::TextLayerVertex::position), Containers::arrayView<Vector2>({
-        Vector2{0.0f, 0.0f} + data.offset,
-        Vector2{2.0f, 0.0f} + data.offset,
-        Vector2{0.0f, -4.0f} + data.offset,
-        Vector2{2.0f, -4.0f} + data.offset,
+    Containers::BitArrayView nodesEnabled{nodesEnabledData, 0, 2};
 
-        Vector2{3.0f, 0.0f} + data.offset,
-        Vector2{5.0f, 0.0f} + data.offset,
-        Vector2{3.0f, -4.0f} + data.offset,
-        Vector2{5.0f, -4.0f} + data.offset,
+    const auto positions = [&]() {
+        return stridedArrayView(layer.stateData().glyphInstances).slice(&Implementation::TextLayerGlyphInstance::position);
+    };
+    const auto glyphIds = [&]() {
+        return stridedArrayView(layer.stateData().glyphInstances).slice(&Implementation::TextLayerGlyphInstance::glyphId);
+    };
+    const auto colors = [&]() {
+        return stridedArrayView(layer.stateData().glyphInstances).slice(&Implementation::TextLayerGlyphInstance::color);
+    };
+    const auto styleUniforms = [&]() {
+        return stridedArrayView(layer.stateData().glyphInstances).slice(&Implementation::TextLayerGlyphInstance::styleUniform);
+    };
 
-        Vector2{6.0f, 0.0f} + data.offset,
-        Vector2{8.0f, 0.0f} + data.offset,
-        Vector2{6.0f, -4.0f} + data.offset,
-        Vector2{8.0f, -4.0f} + data.offset,
+    /* There's one instance for each drawn glyph and no glyph indices. The
+       color is premultiplied with the node opacity and packed. */
+    UnsignedInt dataIds[]{0, 1};
+    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.stateData().indices.size(), 0);
+    CORRADE_COMPARE(layer.stateData().glyphInstances.size(), 2);
+    CORRADE_COMPARE(layer.stateData().vertexUpdateBegin, 0);
+    CORRADE_COMPARE(layer.stateData().vertexUpdateEnd, 2);
+    CORRADE_COMPARE_AS(glyphIds(), Containers::arrayView({
+        glyph17, glyph22
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().glyphInstances).slice(&Implementation::TextLayerGlyphInstance::scale), Containers::arrayView({
+        2.0f, 2.0f
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(colors(), Containers::arrayView({
+        0xff3366ff_rgba, 0x80808080_rgba
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(styleUniforms(), Containers::arrayView<UnsignedInt>({
+        1, 0
     }), TestSuite::Compare::Container);
+    Containers::Array<Vector2> positionsInitial{InPlaceInit, {positions()[0], positions()[1]}};
 
-    /* 0--1
-       |  |
-       2--3 */
-    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().editingVertices).slice(&Implementation::TextLayerEditingVertex::position), Containers::arrayView<Vector2>({
-        /* Selection containing glyph 1 and 2 (advance of 1.5*2), plus
-           padding; ascent 3.5*2, descent 2.0*2 */
-        Vector2{3.0f        - data.editingPaddingL, -7.0f - 0.2f} + data.offset,
-        Vector2{6.0f + 3.0f + data.editingPaddingR, -7.0f - 0.2f} + data.offset,
-        Vector2{3.0f        - data.editingPaddingL,  4.0f + 0.4f} + data.offset,
-        Vector2{6.0f + 3.0f + data.editingPaddingR,  4.0f + 0.4f} + data.offset,
+    /* Drawing in a different order results in the instances being shuffled
+       as well, even if just the node order changes */
+    UnsignedInt dataIdsReversed[]{1, 0};
+    layer.update(LayerState::NeedsNodeOrderUpdate, dataIdsReversed, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.stateData().indices.size(), 0);
+    CORRADE_COMPARE_AS(glyphIds(), Containers::arrayView({
+        glyph22, glyph17
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(positions(), Containers::arrayView({
+        positionsInitial[1], positionsInitial[0]
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(styleUniforms(), Containers::arrayView<UnsignedInt>({
+        0, 1
+    }), TestSuite::Compare::Container);
 
-        /* Cursor before glyph 1, plus padding */
-        Vector2{3.0f        - data.editingPaddingL, -7.0f - 0.2f} + data.offset,
-        Vector2{3.0f        + data.editingPaddingR, -7.0f - 0.2f} + data.offset,
-        Vector2{3.0f        - data.editingPaddingL,  4.0f + 0.4f} + data.offset,
-        Vector2{3.0f        + data.editingPaddingR,  4.0f + 0.4f} + data.offset,
+    /* Drawing just one results in just one instance */
+    UnsignedInt dataIdsSecond[]{1};
+    layer.update(LayerState::NeedsNodeOrderUpdate, dataIdsSecond, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE_AS(glyphIds(), Containers::arrayView({
+        glyph22
     }), TestSuite::Compare::Container);
 }
 
-void TextLayerTest::updatePaddingGlyph() {
-    auto&& data = UpdateAlignmentPaddingData[testCaseInstanceId()];
+void TextLayerTest::updateVertexExecutor() {
+    auto&& data = UpdateVertexExecutorData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
 
-    /* Same as updateAlignmentGlyph(), except that the node offset & size is
-       different and only matches the original if padding is applied
-       correctly from both the data and the style. Additionally, in comparison
-       to updateAlignmentGlyph(), the style-supplied alignment is a bogus value
-       and padding from the TextProperties is used instead. */
-
-    /* A trivial glyph cache. Goes both above and below the line to verify
-       vertical alignment. */
     struct: Text::AbstractGlyphCache {
         using Text::AbstractGlyphCache::AbstractGlyphCache;
 
@@ -9607,8 +13017,9 @@ void TextLayerTest::updatePaddingGlyph() {
     /* Default padding is 1, resetting to 0 for simplicity */
     } cache{PixelFormat::R8Unorm, {32, 32}, {}};
 
-    UnsignedInt glyphCacheFontId = cache.addFont(18);
+    UnsignedInt glyphCacheFontId = cache.addFont(23);
     cache.addGlyph(glyphCacheFontId, 17, {-2, -3}, {{}, {3, 4}});
+    cache.addGlyph(glyphCacheFontId, 22, {1, 1}, {{4, 0}, {6, 2}});
 
     struct LayerShared: TextLayer::Shared {
         explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
@@ -9617,69 +13028,112 @@ void TextLayerTest::updatePaddingGlyph() {
 
         void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
         void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
-    } shared{TextLayer::Shared::Configuration{1}};
+    } shared{TextLayer::Shared::Configuration{2}
+        .setInstancedGlyphs(data.instancedGlyphs)};
     shared.setGlyphCache(cache);
 
-    /* Font scaled 2x, so all metrics coming from the the cache should be
-       scaled 2x */
     FontHandle fontHandle = shared.addInstancelessFont(glyphCacheFontId, 2.0f);
     shared.setStyle(TextLayerCommonStyleUniform{},
-        {TextLayerStyleUniform{}},
-        {fontHandle},
-        /* Alignment set to an arbitrary value, the one from TextProperties
-           should get used instead */
-        {Text::Alignment::BottomRight},
-        /* Features affect only create() / createGlyph() / setText() /
-           setGlyph(), not update(); tested in createSetTextTextProperties() */
-        {}, {}, {},
-        /* Editing styles aren't used for single glyphs */
-        {}, {},
-        {{10.0f, 5.0f, 20.0f, 10.0f}});
+        {TextLayerStyleUniform{}, TextLayerStyleUniform{}},
+        {fontHandle, fontHandle},
+        {Text::Alignment::MiddleCenter, Text::Alignment::TopRight},
+        {}, {}, {}, {}, {}, {{}, {1.0f, 2.0f, 3.0f, 4.0f}});
 
     struct Layer: TextLayer {
         explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
 
-        const State& stateData() const {
-            return static_cast<const State&>(*_state);
+        State& stateData() {
+            return static_cast<State&>(*_state);
         }
-    } layer{layerHandle(0, 1), shared};
-
-    /* Required to be called before update() (because AbstractUserInterface
-       guarantees the same on a higher level), not needed for anything here */
-    layer.setSize({1, 1}, {1, 1});
-
-    NodeHandle node3 = nodeHandle(3, 0);
+    };
 
-    /* Size x2, so the bounding box is 6x8 */
-    DataHandle node3Data = layer.createGlyph(0, 17,
-        TextProperties{}
-            .setAlignment(data.alignment)
-            /* There's no way to detect the direction as no shaper is used, so
-               compared to updateAlignment() / updatePadding() this is always
-               passed in via TextProperties */
-            .setShapeDirection(data.shapeDirection),
-        node3);
-    layer.setPadding(node3Data, {20.0f, 5.0f, 50.0f, 30.0f});
+    /* One layer generating the vertices directly, another through the
+       executor, the results should be the same */
+    Layer sequential{layerHandle(0, 1), shared};
+    Layer parallel{layerHandle(1, 1), shared};
+    CORRADE_VERIFY(!parallel.vertexExecutor());
+
+    Containers::Array<UnsignedInt> executorCalls;
+    parallel.setVertexExecutor([](UnsignedInt count, void(*task)(void*, UnsignedInt), void* taskState, void* userData) {
+        arrayAppend(*static_cast<Containers::Array<UnsignedInt>*>(userData), count);
+        /* Going in reverse to verify the order doesn't matter */
+        for(UnsignedInt i = count; i != 0; --i)
+            task(taskState, i - 1);
+    }, &executorCalls);
+    CORRADE_VERIFY(parallel.vertexExecutor());
+    CORRADE_COMPARE(parallel.vertexExecutorUserData(), &executorCalls);
+
+    /* Enough data for three tasks, the last one not full */
+    constexpr std::size_t count = Implementation::TextLayerVertexTaskDataCount*2 + 50;
+    Containers::Array<Vector2> nodeOffsets{NoInit, count};
+    Containers::Array<Vector2> nodeSizes{NoInit, count};
+    Containers::Array<Float> nodeOpacities{NoInit, count};
+    Containers::BitArray nodesEnabled{ValueInit, count};
+    Containers::Array<UnsignedInt> dataIds{NoInit, count};
+    for(Layer* layer: {&sequential, &parallel}) {
+        /* Required to be called before update() (because
+           AbstractUserInterface guarantees the same on a higher level) */
+        layer->setSize({1, 1}, {1, 1});
+        for(std::size_t i = 0; i != count; ++i) {
+            DataHandle handle = layer->createGlyph(UnsignedInt(i % 2), i % 3 ? 17u : 22u, {}, nodeHandle(UnsignedInt(i), 0));
+            layer->setColor(handle, Color4{i/Float(count), 0.5f, 1.0f, 0.75f});
+        }
+    }
+    for(std::size_t i = 0; i != count; ++i) {
+        nodeOffsets[i] = {Float(i % 100), Float(i/100)};
+        nodeSizes[i] = {10.0f + i % 7, 20.0f + i % 3};
+        nodeOpacities[i] = 1.0f - (i % 4)*0.25f;
+        if(i % 3) nodesEnabled.set(i);
+        /* Draw order different from the data order */
+        dataIds[i] = UnsignedInt((i*7) % count);
+    }
 
-    Vector2 nodeOffsets[4];
-    Vector2 nodeSizes[4];
-    Float nodeOpacities[4]{};
-    UnsignedByte nodesEnabledData[1]{};
-    Containers::BitArrayView nodesEnabled{nodesEnabledData, 0, 4};
-    nodeOffsets[3] = {20.5f, 10.5f};
-    nodeSizes[3] = {300.8f, 150.4f};
-    UnsignedInt dataIds[]{0};
-    layer.update(LayerState::NeedsDataUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    const auto vertexData = [&](Layer& layer) {
+        return data.instancedGlyphs ?
+            Containers::arrayCast<const char>(Containers::arrayView(layer.stateData().glyphInstances)) :
+            Containers::arrayCast<const char>(Containers::arrayView(layer.stateData().vertices));
+    };
 
-    /* 2--3
-       |  |
-       0--1 */
-    CORRADE_COMPARE_AS(stridedArrayView(layer.stateData().vertices).slice(&Implementation::TextLayerVertex::position), Containers::arrayView<Vector2>({
-        Vector2{0.0f, 0.0f} + data.offsetGlyph,
-        Vector2{6.0f, 0.0f} + data.offsetGlyph,
-        Vector2{0.0f, -8.0f} + data.offsetGlyph,
-        Vector2{6.0f, -8.0f} + data.offsetGlyph
+    sequential.update(LayerState::NeedsDataUpdate|LayerState::NeedsNodeOrderUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    parallel.update(LayerState::NeedsDataUpdate|LayerState::NeedsNodeOrderUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE_AS(executorCalls, Containers::arrayView<UnsignedInt>({
+        3
     }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(vertexData(parallel),
+        vertexData(sequential),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(parallel.stateData().vertexUpdateBegin, sequential.stateData().vertexUpdateBegin);
+    CORRADE_COMPARE(parallel.stateData().vertexUpdateEnd, sequential.stateData().vertexUpdateEnd);
+
+    /* Moving a few nodes after a reset results in the same updated range in
+       both, merged from all tasks */
+    for(Layer* layer: {&sequential, &parallel}) {
+        layer->stateData().vertexUpdateBegin = ~UnsignedInt{};
+        layer->stateData().vertexUpdateEnd = 0;
+    }
+    nodeOffsets[dataIds[3]] += Vector2{0.5f};
+    nodeOffsets[dataIds[count - 3]] += Vector2{0.5f};
+    sequential.update(LayerState::NeedsNodeOffsetSizeUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    parallel.update(LayerState::NeedsNodeOffsetSizeUpdate, dataIds, {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE_AS(executorCalls, Containers::arrayView<UnsignedInt>({
+        3, 3
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(vertexData(parallel),
+        vertexData(sequential),
+        TestSuite::Compare::Container);
+    CORRADE_VERIFY(sequential.stateData().vertexUpdateBegin < sequential.stateData().vertexUpdateEnd);
+    CORRADE_COMPARE(parallel.stateData().vertexUpdateBegin, sequential.stateData().vertexUpdateBegin);
+    CORRADE_COMPARE(parallel.stateData().vertexUpdateEnd, sequential.stateData().vertexUpdateEnd);
+
+    /* Fewer data than a single task handles are generated directly */
+    sequential.update(LayerState::NeedsDataUpdate|LayerState::NeedsNodeOrderUpdate, dataIds.prefix(100), {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    parallel.update(LayerState::NeedsDataUpdate|LayerState::NeedsNodeOrderUpdate, dataIds.prefix(100), {}, {}, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, {}, {}, {}, {});
+    CORRADE_COMPARE_AS(executorCalls, Containers::arrayView<UnsignedInt>({
+        3, 3
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(vertexData(parallel),
+        vertexData(sequential),
+        TestSuite::Compare::Container);
 }
 
 void TextLayerTest::updateNoStyleSet() {
@@ -10191,6 +13645,117 @@ void TextLayerTest::keyTextEvent() {
     }
 }
 
+void TextLayerTest::textInputEventBatching() {
+    struct: Text::AbstractFont {
+        Text::FontFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return true; }
+        void doClose() override {}
+
+        void doGlyphIdsInto(const Containers::StridedArrayView1D<const char32_t>&, const Containers::StridedArrayView1D<UnsignedInt>&) override {}
+        Vector2 doGlyphSize(UnsignedInt) override { return {}; }
+        Vector2 doGlyphAdvance(UnsignedInt) override { return {}; }
+        Containers::Pointer<Text::AbstractShaper> doCreateShaper() override { return Containers::pointer<ThreeGlyphShaper>(*this); }
+    } font;
+
+    struct: Text::AbstractGlyphCache {
+        using Text::AbstractGlyphCache::AbstractGlyphCache;
+
+        Text::GlyphCacheFeatures doFeatures() const override { return {}; }
+        void doSetImage(const Vector2i&, const ImageView2D&) override {}
+    } cache{PixelFormat::R8Unorm, {32, 32, 2}};
+    cache.addFont(98, &font);
+
+    struct LayerShared: TextLayer::Shared {
+        explicit LayerShared(const Configuration& configuration): TextLayer::Shared{configuration} {}
+
+        using TextLayer::Shared::setGlyphCache;
+
+        void doSetStyle(const TextLayerCommonStyleUniform&, Containers::ArrayView<const TextLayerStyleUniform>) override {}
+        void doSetEditingStyle(const TextLayerCommonEditingStyleUniform&, Containers::ArrayView<const TextLayerEditingStyleUniform>) override {}
+    } shared{TextLayer::Shared::Configuration{1}
+        .setTextInputBatching(true)};
+    shared.setGlyphCache(cache);
+    shared.setStyle(TextLayerCommonStyleUniform{},
+        {TextLayerStyleUniform{}},
+        {shared.addFont(font, 1.0f)},
+        {Text::Alignment::MiddleCenter},
+        {}, {}, {}, {}, {}, {});
+    CORRADE_VERIFY(shared.hasTextInputBatching());
+
+    struct Layer: TextLayer {
+        explicit Layer(LayerHandle handle, Shared& shared): TextLayer{handle, shared} {}
+
+        const State& stateData() const {
+            return static_cast<const State&>(*_state);
+        }
+    } layer{layerHandle(0, 1), shared};
+
+    /* Required to be called before update() (because AbstractUserInterface
+       guarantees the same on a higher level), not needed for anything here */
+    layer.setSize({1, 1}, {1, 1});
+
+    DataHandle first = layer.create(0, "hello", {}, TextDataFlag::Editable);
+    DataHandle second = layer.create(0, "bb", {}, TextDataFlag::Editable);
+    DataHandle removed = layer.create(0, "ccc", {}, TextDataFlag::Editable);
+    layer.setCursor(first, 5);
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+
+    /* Multiple text input events only modify the text and cursor, the glyphs
+       are still the original ones */
+    {
+        TextInputEvent a{{}, " wor"};
+        TextInputEvent b{{}, "ld"};
+        layer.textInputEvent(dataHandleId(first), a);
+        layer.textInputEvent(dataHandleId(first), b);
+        CORRADE_VERIFY(a.isAccepted());
+        CORRADE_VERIFY(b.isAccepted());
+    }
+    CORRADE_COMPARE(layer.text(first), "hello world");
+    CORRADE_COMPARE(layer.cursor(first), Containers::pair(11u, 11u));
+    CORRADE_COMPARE(layer.glyphCount(first), 5);
+    CORRADE_COMPARE(layer.state(), LayerState::NeedsDataUpdate);
+    /* The text is recorded just once */
+    CORRADE_COMPARE_AS(layer.stateData().pendingEditShapes, Containers::arrayView<UnsignedInt>({
+        dataHandleId(first)
+    }), TestSuite::Compare::Container);
+
+    /* A pending edit of a text that gets removed, or set to a different text
+       in the meantime, is discarded */
+    {
+        TextInputEvent a{{}, "!"};
+        TextInputEvent b{{}, "?"};
+        layer.textInputEvent(dataHandleId(second), a);
+        layer.textInputEvent(dataHandleId(removed), b);
+    }
+    CORRADE_COMPARE(layer.text(second), "bb!");
+    layer.setText(second, "x", {});
+    layer.remove(removed);
+    CORRADE_COMPARE_AS(layer.stateData().pendingEditShapes, Containers::arrayView<UnsignedInt>({
+        dataHandleId(first), ~UnsignedInt{}, ~UnsignedInt{}
+    }), TestSuite::Compare::Container);
+
+    /* A non-deferred edit shapes the text right away, which makes the
+       pending entry unnecessary as well */
+    DataHandle third = layer.create(0, "dd", {}, TextDataFlag::Editable);
+    {
+        TextInputEvent a{{}, "e"};
+        layer.textInputEvent(dataHandleId(third), a);
+    }
+    CORRADE_COMPARE(layer.glyphCount(third), 2);
+    layer.editText(third, TextEdit::InsertBeforeCursor, "f");
+    CORRADE_COMPARE(layer.text(third), "ddef");
+    CORRADE_COMPARE(layer.glyphCount(third), 4);
+
+    /* The update shapes the pending texts and empties the list */
+    layer.update(LayerState::NeedsDataUpdate, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {});
+    CORRADE_COMPARE(layer.glyphCount(first), 11);
+    CORRADE_COMPARE(layer.glyphCount(second), 1);
+    CORRADE_COMPARE(layer.glyphCount(third), 4);
+    CORRADE_COMPARE(layer.stateData().pendingEditShapes.size(), 0);
+    CORRADE_COMPARE(layer.state(), LayerStates{});
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Ui::Test::TextLayerTest)
@@ -0,0 +1,143 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+#include <Corrade/Containers/Iterable.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Magnum/Image.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/GL/OpenGLTester.h>
+#include <Magnum/GL/PixelFormat.h>
+#include <Magnum/GL/TextureArray.h>
+#include <Magnum/GL/TextureFormat.h>
+#include <Magnum/Math/Vector3.h>
+#include <Magnum/TextureTools/Atlas.h>
+
+#include "Magnum/Ui/TextureAtlasGL.h"
+
+namespace Magnum { namespace Ui { namespace Test { namespace {
+
+struct TextureAtlasGLTest: GL::OpenGLTester {
+    explicit TextureAtlasGLTest();
+
+    void construct();
+    void constructInternalFormat();
+    void constructCopy();
+    void constructMove();
+
+    void add();
+};
+
+TextureAtlasGLTest::TextureAtlasGLTest() {
+    addTests({&TextureAtlasGLTest::construct,
+              &TextureAtlasGLTest::constructInternalFormat,
+              &TextureAtlasGLTest::constructCopy,
+              &TextureAtlasGLTest::constructMove,
+
+              &TextureAtlasGLTest::add});
+}
+
+void TextureAtlasGLTest::construct() {
+    TextureAtlasGL atlas{PixelFormat::RGBA8Unorm, {16, 8, 2}};
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    CORRADE_COMPARE(atlas.format(), PixelFormat::RGBA8Unorm);
+    CORRADE_COMPARE(atlas.size(), (Vector3i{16, 8, 2}));
+    CORRADE_VERIFY(atlas.texture().id());
+    #ifndef MAGNUM_TARGET_GLES
+    CORRADE_COMPARE(atlas.texture().imageSize(0), (Vector3i{16, 8, 2}));
+    #endif
+}
+
+void TextureAtlasGLTest::constructInternalFormat() {
+    TextureAtlasGL atlas{GL::TextureFormat::SRGB8Alpha8, PixelFormat::RGBA8Unorm, {16, 8, 2}};
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    CORRADE_COMPARE(atlas.format(), PixelFormat::RGBA8Unorm);
+    CORRADE_COMPARE(atlas.size(), (Vector3i{16, 8, 2}));
+    CORRADE_VERIFY(atlas.texture().id());
+}
+
+void TextureAtlasGLTest::constructCopy() {
+    CORRADE_VERIFY(!std::is_copy_constructible<TextureAtlasGL>{});
+    CORRADE_VERIFY(!std::is_copy_assignable<TextureAtlasGL>{});
+}
+
+void TextureAtlasGLTest::constructMove() {
+    TextureAtlasGL a{PixelFormat::RGBA8Unorm, {16, 8, 2}};
+    const GLuint id = a.texture().id();
+
+    TextureAtlasGL b = Utility::move(a);
+    CORRADE_COMPARE(b.size(), (Vector3i{16, 8, 2}));
+    CORRADE_COMPARE(b.texture().id(), id);
+
+    TextureAtlasGL c{PixelFormat::R8Unorm, {4, 4, 1}};
+    c = Utility::move(b);
+    CORRADE_COMPARE(c.size(), (Vector3i{16, 8, 2}));
+    CORRADE_COMPARE(c.texture().id(), id);
+
+    CORRADE_VERIFY(std::is_nothrow_move_constructible<TextureAtlasGL>::value);
+    CORRADE_VERIFY(std::is_nothrow_move_assignable<TextureAtlasGL>::value);
+}
+
+void TextureAtlasGLTest::add() {
+    TextureAtlasGL atlas{PixelFormat::R8Unorm, {8, 4, 1}};
+    atlas.atlas().setPadding({});
+    MAGNUM_VERIFY_NO_GL_ERROR();
+
+    /* Clear the texture first so there's something to compare against. Rows
+       are padded to four bytes by default. */
+    const UnsignedByte zeros[8*4]{};
+    atlas.texture().setSubImage(0, {}, ImageView3D{PixelFormat::R8Unorm, {8, 4, 1}, zeros});
+
+    const UnsignedByte data[]{
+        1, 2, 3, 4,
+        5, 6, 7, 8
+    };
+    Containers::Optional<Containers::Pair<Vector3, Vector2>> out = atlas.add(ImageView2D{PixelFormat::R8Unorm, {4, 2}, data});
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    CORRADE_VERIFY(out);
+    CORRADE_COMPARE(out->first(), (Vector3{0.0f, 0.0f, 0.0f}));
+    CORRADE_COMPARE(out->second(), (Vector2{0.5f, 0.5f}));
+
+    #ifndef MAGNUM_TARGET_GLES
+    /* Just the area of the image got uploaded */
+    Image3D image = atlas.texture().image(0, {PixelFormat::R8Unorm});
+    MAGNUM_VERIFY_NO_GL_ERROR();
+    CORRADE_COMPARE_AS(Containers::arrayCast<const UnsignedByte>(image.data()), Containers::arrayView<UnsignedByte>({
+        1, 2, 3, 4, 0, 0, 0, 0,
+        5, 6, 7, 8, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0
+    }), TestSuite::Compare::Container);
+    #else
+    CORRADE_SKIP("Texture image queries not available on ES, can't verify the contents.");
+    #endif
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Ui::Test::TextureAtlasGLTest)
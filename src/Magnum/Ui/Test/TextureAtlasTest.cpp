@@ -0,0 +1,235 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+#include <sstream> /** @todo remove once Debug is stream-free */
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Iterable.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Vector3.h>
+#include <Magnum/TextureTools/Atlas.h>
+
+#include "Magnum/Ui/TextureAtlas.h"
+
+namespace Magnum { namespace Ui { namespace Test { namespace {
+
+struct TextureAtlasTest: TestSuite::Tester {
+    explicit TextureAtlasTest();
+
+    void construct();
+    void constructCopy();
+    void constructMove();
+
+    void add();
+    void addSingle();
+    void addEmptyImage();
+    void addDoesNotFit();
+    void addInvalidViewSize();
+    void addInvalidFormat();
+};
+
+TextureAtlasTest::TextureAtlasTest() {
+    addTests({&TextureAtlasTest::construct,
+              &TextureAtlasTest::constructCopy,
+              &TextureAtlasTest::constructMove,
+
+              &TextureAtlasTest::add,
+              &TextureAtlasTest::addSingle,
+              &TextureAtlasTest::addEmptyImage,
+              &TextureAtlasTest::addDoesNotFit,
+              &TextureAtlasTest::addInvalidViewSize,
+              &TextureAtlasTest::addInvalidFormat});
+}
+
+/* Records offsets and sizes of all images passed to doSetImage() */
+struct Atlas: TextureAtlas {
+    explicit Atlas(PixelFormat format, const Vector3i& size): TextureAtlas{format, size} {
+        /* To have predictable placement */
+        atlas().setPadding({});
+    }
+
+    void doSetImage(const Vector3i& offset, const ImageView2D& image) override {
+        arrayAppend(images, InPlaceInit, offset, image.size());
+    }
+
+    Containers::Array<Containers::Pair<Vector3i, Vector2i>> images;
+};
+
+void TextureAtlasTest::construct() {
+    Atlas atlas{PixelFormat::RGBA8Unorm, {16, 8, 2}};
+    CORRADE_COMPARE(atlas.format(), PixelFormat::RGBA8Unorm);
+    CORRADE_COMPARE(atlas.size(), (Vector3i{16, 8, 2}));
+    CORRADE_COMPARE(atlas.atlas().size(), (Vector3i{16, 8, 2}));
+    /* Rotations are disabled as BaseLayer can't express them */
+    CORRADE_VERIFY(!(atlas.atlas().flags() & (TextureTools::AtlasLandfillFlag::RotatePortrait|TextureTools::AtlasLandfillFlag::RotateLandscape)));
+}
+
+void TextureAtlasTest::constructCopy() {
+    CORRADE_VERIFY(!std::is_copy_constructible<TextureAtlas>{});
+    CORRADE_VERIFY(!std::is_copy_assignable<TextureAtlas>{});
+}
+
+void TextureAtlasTest::constructMove() {
+    Atlas a{PixelFormat::RGBA8Unorm, {16, 8, 2}};
+
+    Atlas b{Utility::move(a)};
+    CORRADE_COMPARE(b.format(), PixelFormat::RGBA8Unorm);
+    CORRADE_COMPARE(b.size(), (Vector3i{16, 8, 2}));
+
+    Atlas c{PixelFormat::R8Unorm, {4, 4, 1}};
+    c = Utility::move(b);
+    CORRADE_COMPARE(c.format(), PixelFormat::RGBA8Unorm);
+    CORRADE_COMPARE(c.size(), (Vector3i{16, 8, 2}));
+
+    CORRADE_VERIFY(std::is_nothrow_move_constructible<TextureAtlas>::value);
+    CORRADE_VERIFY(std::is_nothrow_move_assignable<TextureAtlas>::value);
+}
+
+void TextureAtlasTest::add() {
+    Atlas atlas{PixelFormat::RG8Unorm, {16, 8, 2}};
+
+    const char data[16*8*2]{};
+    ImageView2D images[]{
+        {PixelFormat::RG8Unorm, {4, 2}, data},
+        {PixelFormat::RG8Unorm, {16, 8}, data},
+        {PixelFormat::RG8Unorm, {8, 4}, data},
+    };
+    Vector3 offsets[3];
+    Vector2 sizes[3];
+    CORRADE_VERIFY(atlas.add(images, offsets, sizes));
+
+    /* All images got uploaded, in order */
+    CORRADE_COMPARE(atlas.images.size(), 3);
+    for(std::size_t i = 0; i != 3; ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(atlas.images[i].second(), images[i].size());
+
+        /* The coordinates are normalized to the texture size, with the layer
+           in Z */
+        const Vector3i offset = atlas.images[i].first();
+        CORRADE_COMPARE(offsets[i], (Vector3{Vector2{offset.xy()}/Vector2{16.0f, 8.0f}, Float(offset.z())}));
+        CORRADE_COMPARE(sizes[i], Vector2{images[i].size()}/Vector2{16.0f, 8.0f});
+    }
+
+    /* The full-size image occupies a whole layer, so the other two have to be
+       in the other one */
+    CORRADE_COMPARE(sizes[1], (Vector2{1.0f, 1.0f}));
+    CORRADE_COMPARE(offsets[1].xy(), (Vector2{0.0f, 0.0f}));
+    CORRADE_COMPARE(offsets[0].z(), 1.0f - offsets[1].z());
+    CORRADE_COMPARE(offsets[2].z(), 1.0f - offsets[1].z());
+}
+
+void TextureAtlasTest::addSingle() {
+    Atlas atlas{PixelFormat::RG8Unorm, {16, 8, 2}};
+
+    const char data[4*2*2]{};
+    Containers::Optional<Containers::Pair<Vector3, Vector2>> out = atlas.add(ImageView2D{PixelFormat::RG8Unorm, {4, 2}, data});
+    CORRADE_VERIFY(out);
+    CORRADE_COMPARE(out->first(), (Vector3{0.0f, 0.0f, 0.0f}));
+    CORRADE_COMPARE(out->second(), (Vector2{0.25f, 0.25f}));
+
+    CORRADE_COMPARE(atlas.images.size(), 1);
+    CORRADE_COMPARE(atlas.images[0].first(), (Vector3i{0, 0, 0}));
+    CORRADE_COMPARE(atlas.images[0].second(), (Vector2i{4, 2}));
+}
+
+void TextureAtlasTest::addEmptyImage() {
+    Atlas atlas{PixelFormat::RG8Unorm, {16, 8, 2}};
+
+    /* Images with zero area get zero coordinates and aren't uploaded */
+    Containers::Optional<Containers::Pair<Vector3, Vector2>> out = atlas.add(ImageView2D{PixelFormat::RG8Unorm, {4, 0}, nullptr});
+    CORRADE_VERIFY(out);
+    CORRADE_COMPARE(out->second(), (Vector2{0.25f, 0.0f}));
+    CORRADE_COMPARE(atlas.images.size(), 0);
+}
+
+void TextureAtlasTest::addDoesNotFit() {
+    Atlas atlas{PixelFormat::RG8Unorm, {16, 8, 1}};
+
+    const char data[16*8*2]{};
+    ImageView2D images[]{
+        {PixelFormat::RG8Unorm, {4, 2}, data},
+        {PixelFormat::RG8Unorm, {16, 8}, data},
+    };
+    Vector3 offsets[2];
+    Vector2 sizes[2];
+    CORRADE_VERIFY(!atlas.add(images, offsets, sizes));
+    CORRADE_VERIFY(!atlas.add(ImageView2D{PixelFormat::RG8Unorm, {32, 2}, data}));
+
+    /* Nothing got uploaded */
+    CORRADE_COMPARE(atlas.images.size(), 0);
+}
+
+void TextureAtlasTest::addInvalidViewSize() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    Atlas atlas{PixelFormat::RG8Unorm, {16, 8, 1}};
+
+    const char data[4]{};
+    ImageView2D images[]{
+        {PixelFormat::RG8Unorm, {1, 1}, data},
+        {PixelFormat::RG8Unorm, {1, 1}, data},
+    };
+    Vector3 offsets[2];
+    Vector2 sizes[2];
+    Vector3 offsetsInvalid[3];
+    Vector2 sizesInvalid[1];
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    atlas.add(images, offsetsInvalid, sizes);
+    atlas.add(images, offsets, sizesInvalid);
+    CORRADE_COMPARE(out.str(),
+        "Ui::TextureAtlas::add(): expected offsets and sizes views to have a size of 2 but got 3 and 2\n"
+        "Ui::TextureAtlas::add(): expected offsets and sizes views to have a size of 2 but got 2 and 1\n");
+}
+
+void TextureAtlasTest::addInvalidFormat() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    Atlas atlas{PixelFormat::RG8Unorm, {16, 8, 1}};
+
+    const char data[4]{};
+    ImageView2D images[]{
+        {PixelFormat::RG8Unorm, {1, 1}, data},
+        {PixelFormat::R16Unorm, {1, 1}, data},
+    };
+    Vector3 offsets[2];
+    Vector2 sizes[2];
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    atlas.add(images, offsets, sizes);
+    CORRADE_COMPARE(out.str(), "Ui::TextureAtlas::add(): expected image 1 to be PixelFormat::RG8Unorm but got PixelFormat::R16Unorm\n");
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Ui::Test::TextureAtlasTest)
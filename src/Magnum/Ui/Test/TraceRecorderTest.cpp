@@ -0,0 +1,136 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <type_traits>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "Magnum/Ui/AbstractLayer.h"
+#include "Magnum/Ui/AbstractUserInterface.h"
+#include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/TraceRecorder.h"
+
+namespace Magnum { namespace Ui { namespace Test { namespace {
+
+struct TraceRecorderTest: TestSuite::Tester {
+    explicit TraceRecorderTest();
+
+    void construct();
+    void constructCopy();
+    void constructMove();
+
+    void record();
+    void reset();
+};
+
+TraceRecorderTest::TraceRecorderTest() {
+    addTests({&TraceRecorderTest::construct,
+              &TraceRecorderTest::constructCopy,
+              &TraceRecorderTest::constructMove,
+
+              &TraceRecorderTest::record,
+              &TraceRecorderTest::reset});
+}
+
+void TraceRecorderTest::construct() {
+    TraceRecorder recorder;
+    CORRADE_COMPARE(recorder.eventCount(), 0);
+    CORRADE_COMPARE(recorder.chromeTraceJson(), "{\"traceEvents\":[]}\n");
+}
+
+void TraceRecorderTest::constructCopy() {
+    CORRADE_VERIFY(!std::is_copy_constructible<TraceRecorder>{});
+    CORRADE_VERIFY(!std::is_copy_assignable<TraceRecorder>{});
+}
+
+void TraceRecorderTest::constructMove() {
+    /* Callbacks installed to the UI reference the instance */
+    CORRADE_VERIFY(!std::is_move_constructible<TraceRecorder>{});
+    CORRADE_VERIFY(!std::is_move_assignable<TraceRecorder>{});
+}
+
+void TraceRecorderTest::record() {
+    AbstractUserInterface ui{{100, 100}};
+
+    struct Layer: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+        using AbstractLayer::create;
+
+        LayerFeatures doFeatures() const override { return {}; }
+    };
+    Layer& layer = ui.setLayerInstance(Containers::pointer<Layer>(ui.createLayer()));
+    layer.create(ui.createNode({}, {10.0f, 10.0f}));
+
+    TraceRecorder recorder;
+    CORRADE_COMPARE(&recorder.install(ui), &recorder);
+    CORRADE_VERIFY(ui.phaseCallback());
+    CORRADE_COMPARE(ui.phaseCallbackUserData(), &recorder);
+    CORRADE_VERIFY(ui.traceCallback());
+    CORRADE_COMPARE(ui.traceCallbackUserData(), &recorder);
+
+    /* NodeOrder, Layout, Cull, DataOrder and LayerUpdate phases, with a
+       LayerUpdate scope nested inside if tracing is enabled */
+    ui.update();
+    #ifdef MAGNUM_UI_TRACING
+    CORRADE_COMPARE(recorder.eventCount(), 5*2 + 2);
+    #else
+    CORRADE_COMPARE(recorder.eventCount(), 5*2);
+    #endif
+
+    /* The timestamps vary, check just the structure */
+    Containers::String json = recorder.chromeTraceJson();
+    CORRADE_VERIFY(json.hasPrefix("{\"traceEvents\":[\n{\"name\":\"NodeOrder\",\"cat\":\"phase\",\"ph\":\"B\",\"ts\":"));
+    CORRADE_VERIFY(json.hasSuffix(",\"pid\":0,\"tid\":0}\n]}\n"));
+    CORRADE_VERIFY(json.contains("{\"name\":\"LayerUpdate\",\"cat\":\"phase\",\"ph\":\"E\""));
+    CORRADE_VERIFY(json.contains("{\"name\":\"DataOrder\",\"cat\":\"phase\",\"ph\":\"E\""));
+    #ifdef MAGNUM_UI_TRACING
+    CORRADE_VERIFY(json.contains("{\"name\":\"LayerUpdate\",\"cat\":\"scope\",\"ph\":\"B\""));
+    CORRADE_VERIFY(json.contains(",\"args\":{\"handle\":\"0x100\"}}"));
+    #else
+    CORRADE_VERIFY(!json.contains("\"cat\":\"scope\""));
+    #endif
+}
+
+void TraceRecorderTest::reset() {
+    AbstractUserInterface ui{{100, 100}};
+    ui.createNode({}, {10.0f, 10.0f});
+
+    TraceRecorder recorder;
+    recorder.install(ui);
+    ui.update();
+    CORRADE_VERIFY(recorder.eventCount());
+
+    CORRADE_COMPARE(&recorder.reset(), &recorder);
+    CORRADE_COMPARE(recorder.eventCount(), 0);
+    CORRADE_COMPARE(recorder.chromeTraceJson(), "{\"traceEvents\":[]}\n");
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Ui::Test::TraceRecorderTest)
@@ -0,0 +1,319 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+*/
+
+#include <sstream> /** @todo remove once Debug is stream-free */
+#include <Corrade/Containers/StringStl.h> /** @todo remove once Debug is stream-free */
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+
+#include "Magnum/Animation/Easing.h"
+#include "Magnum/Math/Time.h"
+#include "Magnum/Ui/AbstractLayer.h"
+#include "Magnum/Ui/TypedGenericAnimator.h"
+
+namespace Magnum { namespace Ui { namespace Test { namespace {
+
+struct TypedGenericAnimatorTest: TestSuite::Tester {
+    explicit TypedGenericAnimatorTest();
+
+    void construct();
+    void constructNode();
+    void constructData();
+
+    void createRemove();
+    void createRemoveHandleRecycle();
+    void createInvalid();
+    void propertiesInvalid();
+
+    void clean();
+
+    void advance();
+    void advanceNode();
+    void advanceData();
+};
+
+using namespace Math::Literals;
+
+TypedGenericAnimatorTest::TypedGenericAnimatorTest() {
+    addTests({&TypedGenericAnimatorTest::construct,
+              &TypedGenericAnimatorTest::constructNode,
+              &TypedGenericAnimatorTest::constructData,
+
+              &TypedGenericAnimatorTest::createRemove,
+              &TypedGenericAnimatorTest::createRemoveHandleRecycle,
+              &TypedGenericAnimatorTest::createInvalid,
+              &TypedGenericAnimatorTest::propertiesInvalid,
+
+              &TypedGenericAnimatorTest::clean,
+
+              &TypedGenericAnimatorTest::advance,
+              &TypedGenericAnimatorTest::advanceNode,
+              &TypedGenericAnimatorTest::advanceData});
+}
+
+/* A function object that's not default-constructible, not assignable and
+   records how many times it was destructed */
+struct Accumulate {
+    explicit Accumulate(Float& value, int& destructedCount): value(value), destructedCount(&destructedCount) {}
+
+    Accumulate(const Accumulate&) = delete;
+    Accumulate(Accumulate&& other) noexcept: value(other.value), destructedCount{other.destructedCount} {
+        other.destructedCount = nullptr;
+    }
+    ~Accumulate() {
+        if(destructedCount) ++*destructedCount;
+    }
+    Accumulate& operator=(const Accumulate&) = delete;
+    Accumulate& operator=(Accumulate&&) = delete;
+
+    void operator()(Float factor) {
+        value += factor;
+    }
+
+    Float& value;
+    int* destructedCount;
+};
+
+struct AccumulateNode {
+    void operator()(NodeHandle node, Float factor) {
+        *value += factor;
+        *lastNode = node;
+    }
+
+    Float* value;
+    NodeHandle* lastNode;
+};
+
+struct AccumulateData {
+    void operator()(DataHandle data, Float factor) {
+        *value += factor;
+        *lastData = data;
+    }
+
+    Float* value;
+    DataHandle* lastData;
+};
+
+void TypedGenericAnimatorTest::construct() {
+    TypedGenericAnimator<Accumulate> animator{animatorHandle(0xab, 0x12)};
+    CORRADE_COMPARE(animator.features(), AnimatorFeatures{});
+    CORRADE_COMPARE(animator.handle(), animatorHandle(0xab, 0x12));
+}
+
+void TypedGenericAnimatorTest::constructNode() {
+    TypedGenericNodeAnimator<AccumulateNode> animator{animatorHandle(0xab, 0x12)};
+    CORRADE_COMPARE(animator.features(), AnimatorFeature::NodeAttachment);
+    CORRADE_COMPARE(animator.handle(), animatorHandle(0xab, 0x12));
+}
+
+void TypedGenericAnimatorTest::constructData() {
+    TypedGenericDataAnimator<AccumulateData> animator{animatorHandle(0xab, 0x12)};
+    CORRADE_COMPARE(animator.features(), AnimatorFeature::DataAttachment);
+    CORRADE_COMPARE(animator.handle(), animatorHandle(0xab, 0x12));
+}
+
+void TypedGenericAnimatorTest::createRemove() {
+    TypedGenericAnimator<Accumulate> animator{animatorHandle(0, 1)};
+
+    Float value = 0.0f;
+    int destructedCount = 0;
+    AnimationHandle first = animator.create(Accumulate{value, destructedCount}, Animation::Easing::bounceOut, 137_nsec, 277_nsec, 3, AnimationFlag::KeepOncePlayed);
+    CORRADE_COMPARE(animator.duration(first), 277_nsec);
+    CORRADE_COMPARE(animator.played(first), 137_nsec);
+    CORRADE_COMPARE(animator.repeatCount(first), 3);
+    CORRADE_COMPARE(animator.flags(first), AnimationFlag::KeepOncePlayed);
+    CORRADE_COMPARE(animator.easing(first), Animation::Easing::bounceOut);
+    CORRADE_COMPARE(animator.easing(animationHandleData(first)), Animation::Easing::bounceOut);
+    /* Temporaries got moved from, so nothing was destructed yet */
+    CORRADE_COMPARE(destructedCount, 0);
+
+    AnimationHandle second = animator.create(Accumulate{value, destructedCount}, Animation::Easing::smootherstep, 226_nsec, 191_nsec);
+    CORRADE_COMPARE(animator.easing(second), Animation::Easing::smootherstep);
+    CORRADE_COMPARE(animator.usedCount(), 2);
+
+    /* Removing calls the destructor */
+    animator.remove(first);
+    CORRADE_COMPARE(destructedCount, 1);
+    CORRADE_COMPARE(animator.usedCount(), 1);
+
+    animator.remove(animationHandleData(second));
+    CORRADE_COMPARE(destructedCount, 2);
+    CORRADE_COMPARE(animator.usedCount(), 0);
+}
+
+void TypedGenericAnimatorTest::createRemoveHandleRecycle() {
+    TypedGenericAnimator<Accumulate> animator{animatorHandle(0, 1)};
+    animator.reserve(2);
+
+    Float value = 0.0f;
+    int destructedCount1 = 0, destructedCount2 = 0;
+    AnimationHandle first = animator.create(Accumulate{value, destructedCount1}, Animation::Easing::linear, 0_nsec, 1_nsec);
+    animator.remove(first);
+    CORRADE_COMPARE(destructedCount1, 1);
+
+    /* The slot is reused, with the new function object in it */
+    AnimationHandle first2 = animator.create(Accumulate{value, destructedCount2}, Animation::Easing::step, 0_nsec, 1_nsec);
+    CORRADE_COMPARE(animationHandleId(first2), animationHandleId(first));
+    CORRADE_COMPARE(animator.easing(first2), Animation::Easing::step);
+    CORRADE_COMPARE(destructedCount1, 1);
+    CORRADE_COMPARE(destructedCount2, 0);
+
+    /* Destructing the animator destructs the function objects as well */
+    {
+        TypedGenericAnimator<Accumulate> moved{Utility::move(animator)};
+        CORRADE_COMPARE(destructedCount2, 0);
+    }
+    CORRADE_COMPARE(destructedCount2, 1);
+}
+
+void TypedGenericAnimatorTest::createInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    TypedGenericAnimator<Accumulate> animator{animatorHandle(0, 1)};
+    TypedGenericNodeAnimator<AccumulateNode> nodeAnimator{animatorHandle(0, 1)};
+    TypedGenericDataAnimator<AccumulateData> dataAnimator{animatorHandle(0, 1)};
+
+    Float value = 0.0f;
+    int destructedCount = 0;
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    animator.create(Accumulate{value, destructedCount}, nullptr, 0_nsec, 1_nsec);
+    nodeAnimator.create(AccumulateNode{}, nullptr, 0_nsec, 1_nsec, NodeHandle::Null);
+    dataAnimator.create(AccumulateData{}, nullptr, 0_nsec, 1_nsec, DataHandle::Null);
+    dataAnimator.create(AccumulateData{}, nullptr, 0_nsec, 1_nsec, LayerDataHandle::Null);
+    CORRADE_COMPARE(out.str(),
+        "Ui::TypedGenericAnimator::create(): easing is null\n"
+        "Ui::TypedGenericNodeAnimator::create(): easing is null\n"
+        "Ui::TypedGenericDataAnimator::create(): easing is null\n"
+        "Ui::TypedGenericDataAnimator::create(): easing is null\n");
+}
+
+void TypedGenericAnimatorTest::propertiesInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    TypedGenericAnimator<Accumulate> animator{animatorHandle(0, 1)};
+
+    Float value = 0.0f;
+    int destructedCount = 0;
+    AnimationHandle handle = animator.create(Accumulate{value, destructedCount}, Animation::Easing::linear, 0_nsec, 1_nsec);
+    animator.remove(handle);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    animator.easing(AnimationHandle::Null);
+    animator.easing(handle);
+    animator.easing(animatorDataHandle(0xabcde, 0x123));
+    CORRADE_COMPARE(out.str(),
+        "Ui::TypedGenericAnimator::easing(): invalid handle Ui::AnimationHandle::Null\n"
+        "Ui::TypedGenericAnimator::easing(): invalid handle Ui::AnimationHandle({0x0, 0x1}, {0x0, 0x1})\n"
+        "Ui::TypedGenericAnimator::easing(): invalid handle Ui::AnimatorDataHandle(0xabcde, 0x123)\n");
+}
+
+void TypedGenericAnimatorTest::clean() {
+    TypedGenericAnimator<Accumulate> animator{animatorHandle(0, 1)};
+
+    Float value = 0.0f;
+    int destructedCount1 = 0, destructedCount2 = 0, destructedCount3 = 0;
+    animator.create(Accumulate{value, destructedCount1}, Animation::Easing::linear, 0_nsec, 1_nsec);
+    animator.create(Accumulate{value, destructedCount2}, Animation::Easing::linear, 0_nsec, 1_nsec);
+    animator.create(Accumulate{value, destructedCount3}, Animation::Easing::linear, 0_nsec, 1_nsec);
+
+    /* Only the first and third get destructed */
+    UnsignedByte data[]{(1 << 0)|(1 << 2)};
+    animator.clean(Containers::BitArrayView{data, 0, 3});
+    CORRADE_COMPARE(destructedCount1, 1);
+    CORRADE_COMPARE(destructedCount2, 0);
+    CORRADE_COMPARE(destructedCount3, 1);
+    CORRADE_COMPARE(animator.usedCount(), 1);
+}
+
+void TypedGenericAnimatorTest::advance() {
+    TypedGenericAnimator<Accumulate> animator{animatorHandle(0, 1)};
+
+    Float first = 0.0f, second = 0.0f, third = 0.0f;
+    int destructedCount = 0;
+    animator.create(Accumulate{first, destructedCount}, Animation::Easing::linear, 0_nsec, 10_nsec);
+    animator.create(Accumulate{second, destructedCount}, Animation::Easing::linear, 5_nsec, 15_nsec);
+    /* Easing is applied to the factor */
+    animator.create(Accumulate{third, destructedCount}, Animation::Easing::step, 10_nsec, 5_nsec);
+
+    /* Should call just the first and third with given factors */
+    UnsignedByte data[]{(1 << 0)|(1 << 2)};
+    Float factors[]{0.75f, 0.42f, 0.75f};
+    animator.advance(Containers::BitArrayView{data, 0, 3}, factors);
+    CORRADE_COMPARE(first, 0.75f);
+    CORRADE_COMPARE(second, 0.0f);
+    CORRADE_COMPARE(third, 1.0f);
+}
+
+void TypedGenericAnimatorTest::advanceNode() {
+    TypedGenericNodeAnimator<AccumulateNode> animator{animatorHandle(0, 1)};
+
+    Float first = 0.0f, second = 0.0f;
+    NodeHandle firstNode = nodeHandle(0, 1), secondNode = nodeHandle(0, 1);
+    animator.create(AccumulateNode{&first, &firstNode}, Animation::Easing::linear, 0_nsec, 10_nsec, nodeHandle(0xabcde, 0x123));
+    animator.create(AccumulateNode{&second, &secondNode}, Animation::Easing::linear, 5_nsec, 15_nsec, NodeHandle::Null);
+
+    UnsignedByte data[]{(1 << 0)|(1 << 1)};
+    Float factors[]{0.75f, 0.25f};
+    animator.advance(Containers::BitArrayView{data, 0, 2}, factors);
+    CORRADE_COMPARE(first, 0.75f);
+    CORRADE_COMPARE(firstNode, nodeHandle(0xabcde, 0x123));
+    CORRADE_COMPARE(second, 0.25f);
+    CORRADE_COMPARE(secondNode, NodeHandle::Null);
+}
+
+void TypedGenericAnimatorTest::advanceData() {
+    TypedGenericDataAnimator<AccumulateData> animator{animatorHandle(0, 1)};
+
+    struct: AbstractLayer {
+        using AbstractLayer::AbstractLayer;
+
+        LayerFeatures doFeatures() const override { return {}; }
+    } layer{layerHandle(0xab, 0xcd)};
+    animator.setLayer(layer);
+
+    Float first = 0.0f, second = 0.0f;
+    DataHandle firstData = dataHandle(layerHandle(0, 1), 0, 1), secondData = dataHandle(layerHandle(0, 1), 0, 1);
+    animator.create(AccumulateData{&first, &firstData}, Animation::Easing::linear, 0_nsec, 10_nsec, dataHandle(layer.handle(), 0xabcde, 0x123));
+    animator.create(AccumulateData{&second, &secondData}, Animation::Easing::linear, 5_nsec, 15_nsec, LayerDataHandle::Null);
+
+    UnsignedByte data[]{(1 << 0)|(1 << 1)};
+    Float factors[]{0.75f, 0.25f};
+    animator.advance(Containers::BitArrayView{data, 0, 2}, factors);
+    CORRADE_COMPARE(first, 0.75f);
+    CORRADE_COMPARE(firstData, dataHandle(layerHandle(0xab, 0xcd), 0xabcde, 0x123));
+    CORRADE_COMPARE(second, 0.25f);
+    /* If there's no associated data, the layer handle shouldn't be added to
+       the null LayerDataHandle */
+    CORRADE_COMPARE(secondData, DataHandle::Null);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Ui::Test::TypedGenericAnimatorTest)
@@ -0,0 +1,284 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <sstream> /** @todo remove once Debug is stream-free */
+#include <Corrade/Corrade.h>
+#if defined(CORRADE_BUILD_MULTITHREADED) && !defined(CORRADE_TARGET_EMSCRIPTEN)
+#include <thread>
+#endif
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Function.h>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+
+#include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/UpdateQueue.h"
+
+namespace Magnum { namespace Ui { namespace Test { namespace {
+
+struct UpdateQueueTest: TestSuite::Tester {
+    explicit UpdateQueueTest();
+
+    void construct();
+    void constructZeroCapacity();
+    void constructCopy();
+    void constructMove();
+
+    void push();
+    void pushFull();
+    void pushNull();
+    void pushFromCommand();
+
+    void coalesce();
+
+    void multipleThreads();
+};
+
+UpdateQueueTest::UpdateQueueTest() {
+    addTests({&UpdateQueueTest::construct,
+              &UpdateQueueTest::constructZeroCapacity,
+              &UpdateQueueTest::constructCopy,
+              &UpdateQueueTest::constructMove,
+
+              &UpdateQueueTest::push,
+              &UpdateQueueTest::pushFull,
+              &UpdateQueueTest::pushNull,
+              &UpdateQueueTest::pushFromCommand,
+
+              &UpdateQueueTest::coalesce,
+
+              &UpdateQueueTest::multipleThreads});
+}
+
+void UpdateQueueTest::construct() {
+    UpdateQueue queue{16};
+    CORRADE_COMPARE(queue.capacity(), 16);
+
+    /* Nothing to apply */
+    CORRADE_COMPARE(queue.apply(), 0);
+
+    /* Non-power-of-two capacity gets rounded up */
+    CORRADE_COMPARE(UpdateQueue{1}.capacity(), 1);
+    CORRADE_COMPARE(UpdateQueue{3}.capacity(), 4);
+    CORRADE_COMPARE(UpdateQueue{17}.capacity(), 32);
+}
+
+void UpdateQueueTest::constructZeroCapacity() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    UpdateQueue{0};
+    CORRADE_COMPARE(out.str(), "Ui::UpdateQueue: expected non-zero capacity\n");
+}
+
+void UpdateQueueTest::constructCopy() {
+    CORRADE_VERIFY(!std::is_copy_constructible<UpdateQueue>{});
+    CORRADE_VERIFY(!std::is_copy_assignable<UpdateQueue>{});
+}
+
+void UpdateQueueTest::constructMove() {
+    int called = 0;
+
+    UpdateQueue a{4};
+    CORRADE_VERIFY(a.push([&called]{ ++called; }));
+
+    UpdateQueue b{Utility::move(a)};
+    CORRADE_COMPARE(b.capacity(), 4);
+
+    UpdateQueue c{16};
+    c = Utility::move(b);
+    CORRADE_COMPARE(c.capacity(), 4);
+
+    /* The queued command is moved along */
+    CORRADE_COMPARE(c.apply(), 1);
+    CORRADE_COMPARE(called, 1);
+
+    CORRADE_VERIFY(std::is_nothrow_move_constructible<UpdateQueue>::value);
+    CORRADE_VERIFY(std::is_nothrow_move_assignable<UpdateQueue>::value);
+}
+
+void UpdateQueueTest::push() {
+    UpdateQueue queue{4};
+
+    Containers::Array<int> called;
+    CORRADE_VERIFY(queue.push([&called]{ arrayAppend(called, 0); }));
+    CORRADE_VERIFY(queue.push([&called]{ arrayAppend(called, 1); }));
+    CORRADE_VERIFY(queue.push([&called]{ arrayAppend(called, 2); }));
+
+    /* Nothing is executed until apply() is called, then in push order */
+    CORRADE_COMPARE_AS(called, Containers::arrayView<int>({
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(queue.apply(), 3);
+    CORRADE_COMPARE_AS(called, Containers::arrayView({
+        0, 1, 2
+    }), TestSuite::Compare::Container);
+
+    /* Applying again does nothing */
+    CORRADE_COMPARE(queue.apply(), 0);
+    CORRADE_COMPARE(called.size(), 3);
+
+    /* Pushing more wraps around the ring buffer */
+    CORRADE_VERIFY(queue.push([&called]{ arrayAppend(called, 3); }));
+    CORRADE_VERIFY(queue.push([&called]{ arrayAppend(called, 4); }));
+    CORRADE_VERIFY(queue.push([&called]{ arrayAppend(called, 5); }));
+    CORRADE_VERIFY(queue.push([&called]{ arrayAppend(called, 6); }));
+    CORRADE_COMPARE(queue.apply(), 4);
+    CORRADE_COMPARE_AS(called, Containers::arrayView({
+        0, 1, 2, 3, 4, 5, 6
+    }), TestSuite::Compare::Container);
+}
+
+void UpdateQueueTest::pushFull() {
+    UpdateQueue queue{2};
+
+    int called = 0;
+    CORRADE_VERIFY(queue.push([&called]{ called += 1; }));
+    CORRADE_VERIFY(queue.push([&called]{ called += 10; }));
+
+    /* The queue is full, the command isn't queued */
+    CORRADE_VERIFY(!queue.push([&called]{ called += 100; }));
+    CORRADE_COMPARE(queue.apply(), 2);
+    CORRADE_COMPARE(called, 11);
+
+    /* After applying, there's space again */
+    CORRADE_VERIFY(queue.push([&called]{ called += 1000; }));
+    CORRADE_COMPARE(queue.apply(), 1);
+    CORRADE_COMPARE(called, 1011);
+}
+
+void UpdateQueueTest::pushNull() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    UpdateQueue queue{2};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    queue.push(nullptr);
+    queue.push(dataHandle(layerHandle(1, 1), 1, 1), 0, nullptr);
+    CORRADE_COMPARE(out.str(),
+        "Ui::UpdateQueue::push(): command is null\n"
+        "Ui::UpdateQueue::push(): command is null\n");
+}
+
+void UpdateQueueTest::pushFromCommand() {
+    UpdateQueue queue{4};
+
+    int called = 0;
+    CORRADE_VERIFY(queue.push([&queue, &called]{
+        ++called;
+        /* Pushed from within apply(), executed only in the next call */
+        queue.push([&called]{ called += 10; });
+    }));
+
+    CORRADE_COMPARE(queue.apply(), 1);
+    CORRADE_COMPARE(called, 1);
+    CORRADE_COMPARE(queue.apply(), 1);
+    CORRADE_COMPARE(called, 11);
+}
+
+void UpdateQueueTest::coalesce() {
+    UpdateQueue queue{16};
+
+    const DataHandle first = dataHandle(layerHandle(0, 1), 3, 1);
+    const DataHandle second = dataHandle(layerHandle(1, 1), 3, 1);
+
+    Containers::Array<int> called;
+    /* Same data, different property, not coalesced */
+    CORRADE_VERIFY(queue.push(first, 0, [&called]{ arrayAppend(called, 0); }));
+    CORRADE_VERIFY(queue.push(first, 1, [&called]{ arrayAppend(called, 1); }));
+    /* Different data, same property, not coalesced */
+    CORRADE_VERIFY(queue.push(second, 0, [&called]{ arrayAppend(called, 2); }));
+    /* Not associated with any data, never coalesced */
+    CORRADE_VERIFY(queue.push([&called]{ arrayAppend(called, 3); }));
+    CORRADE_VERIFY(queue.push(DataHandle::Null, 0, [&called]{ arrayAppend(called, 4); }));
+    CORRADE_VERIFY(queue.push([&called]{ arrayAppend(called, 5); }));
+    /* Same data and property as the first, the first isn't executed and this
+       is executed at its position instead */
+    CORRADE_VERIFY(queue.push(first, 0, [&called]{ arrayAppend(called, 6); }));
+    /* Same data and property as the third */
+    CORRADE_VERIFY(queue.push(second, 0, [&called]{ arrayAppend(called, 7); }));
+    /* Same data and property as the first again */
+    CORRADE_VERIFY(queue.push(first, 0, [&called]{ arrayAppend(called, 8); }));
+
+    CORRADE_COMPARE(queue.apply(), 6);
+    CORRADE_COMPARE_AS(called, Containers::arrayView({
+        1, 3, 4, 5, 7, 8
+    }), TestSuite::Compare::Container);
+
+    /* Coalescing happens only among commands applied together */
+    CORRADE_VERIFY(queue.push(first, 0, [&called]{ arrayAppend(called, 9); }));
+    CORRADE_COMPARE(queue.apply(), 1);
+    CORRADE_COMPARE_AS(called, Containers::arrayView({
+        1, 3, 4, 5, 7, 8, 9
+    }), TestSuite::Compare::Container);
+}
+
+void UpdateQueueTest::multipleThreads() {
+    #if !defined(CORRADE_BUILD_MULTITHREADED) || defined(CORRADE_TARGET_EMSCRIPTEN)
+    CORRADE_SKIP("Threads not available on this build.");
+    #else
+    UpdateQueue queue{64};
+
+    enum: std::size_t {
+        ThreadCount = 4,
+        PushCount = 1000
+    };
+
+    /* Each thread increments its own counter, the consumer applies while the
+       threads are pushing. A failed push is retried, so in the end all
+       commands should be executed. */
+    std::size_t counters[ThreadCount]{};
+    std::thread threads[ThreadCount];
+    for(std::size_t i = 0; i != ThreadCount; ++i) {
+        threads[i] = std::thread{[&queue, &counters, i]{
+            for(std::size_t j = 0; j != PushCount; ++j) {
+                while(!queue.push([&counters, i]{ ++counters[i]; }))
+                    std::this_thread::yield();
+            }
+        }};
+    }
+
+    std::size_t applied = 0;
+    while(applied != ThreadCount*PushCount)
+        applied += queue.apply();
+
+    for(std::thread& thread: threads)
+        thread.join();
+
+    CORRADE_COMPARE(applied, ThreadCount*PushCount);
+    for(std::size_t i = 0; i != ThreadCount; ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(counters[i], PushCount);
+    }
+    #endif
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Ui::Test::UpdateQueueTest)
@@ -26,6 +26,7 @@
 
 #include <sstream> /** @todo remove once Debug is stream-free */
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/String.h>
 #include <Corrade/PluginManager/Manager.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
 #include <Magnum/PixelFormat.h>
@@ -71,6 +72,9 @@ struct UserInterfaceGLTest: GL::OpenGLTester {
     void setStyleEventLayerAlreadyPresent();
     void setStyleSnapLayouterAlreadyPresent();
 
+    void setStyleShared();
+    void setStyleSharedInvalid();
+
     private:
         PluginManager::Manager<Trade::AbstractImporter> _importerManager;
         PluginManager::Manager<Text::AbstractFont> _fontManager;
@@ -246,7 +250,10 @@ UserInterfaceGLTest::UserInterfaceGLTest() {
               &UserInterfaceGLTest::setStyleTextLayerArrayGlyphCache,
               &UserInterfaceGLTest::setStyleTextLayerImagesTextLayerNotPresentNotApplied,
               &UserInterfaceGLTest::setStyleEventLayerAlreadyPresent,
-              &UserInterfaceGLTest::setStyleSnapLayouterAlreadyPresent});
+              &UserInterfaceGLTest::setStyleSnapLayouterAlreadyPresent,
+
+              &UserInterfaceGLTest::setStyleShared,
+              &UserInterfaceGLTest::setStyleSharedInvalid});
 }
 
 void UserInterfaceGLTest::construct() {
@@ -877,6 +884,114 @@ void UserInterfaceGLTest::setStyleSnapLayouterAlreadyPresent() {
     CORRADE_COMPARE(out.str(), "Ui::UserInterfaceGL::trySetStyle(): snap layouter already present\n");
 }
 
+void UserInterfaceGLTest::setStyleShared() {
+    StyleFeatures appliedFeatures;
+    struct Style: AbstractStyle {
+        explicit Style(StyleFeatures& appliedFeatures): _appliedFeatures(appliedFeatures) {}
+
+        StyleFeatures doFeatures() const override {
+            return StyleFeature::BaseLayer|StyleFeature::TextLayer|StyleFeature::TextLayerImages|StyleFeature::EventLayer|StyleFeature::SnapLayouter;
+        }
+        UnsignedInt doBaseLayerStyleCount() const override { return 3; }
+        UnsignedInt doTextLayerStyleCount() const override { return 2; }
+        Vector3i doTextLayerGlyphCacheSize(StyleFeatures) const override {
+            return {16, 24, 1};
+        }
+        bool doApply(UserInterface&, StyleFeatures features, PluginManager::Manager<Trade::AbstractImporter>*, PluginManager::Manager<Text::AbstractFont>*) const override {
+            _appliedFeatures = features;
+            return true;
+        }
+
+        StyleFeatures& _appliedFeatures;
+    } style{appliedFeatures};
+
+    UserInterfaceGL first{NoCreate};
+    first.setSize({200, 300})
+         .setStyle(style, &_importerManager, &_fontManager);
+    CORRADE_COMPARE(appliedFeatures, style.features());
+
+    UserInterfaceGL second{NoCreate};
+    second.setSize({400, 300});
+    CORRADE_VERIFY(second.trySetStyle(style, first));
+    CORRADE_VERIFY(second.hasRenderer());
+    CORRADE_COMPARE(second.layerUsedCount(), 3);
+    CORRADE_COMPARE(second.layouterUsedCount(), 1);
+
+    /* The layers are new, but use the same shared instances */
+    CORRADE_VERIFY(second.hasBaseLayer());
+    CORRADE_VERIFY(&second.baseLayer() != &first.baseLayer());
+    CORRADE_COMPARE(&second.baseLayer().shared(), &first.baseLayer().shared());
+    CORRADE_VERIFY(second.hasTextLayer());
+    CORRADE_VERIFY(&second.textLayer() != &first.textLayer());
+    CORRADE_COMPARE(&second.textLayer().shared(), &first.textLayer().shared());
+    CORRADE_COMPARE(&second.textLayer().shared().glyphCache(), &first.textLayer().shared().glyphCache());
+    CORRADE_VERIFY(second.hasEventLayer());
+    CORRADE_VERIFY(second.hasSnapLayouter());
+
+    /* The style is applied only to features that have no shared state */
+    CORRADE_COMPARE(appliedFeatures, StyleFeature::EventLayer|StyleFeature::SnapLayouter);
+
+    /* If only features with shared state are requested, apply() isn't called
+       at all */
+    appliedFeatures = {};
+    UserInterfaceGL third{NoCreate};
+    third.setSize({200, 300})
+         .setStyle(style, StyleFeature::BaseLayer|StyleFeature::TextLayer|StyleFeature::TextLayerImages, first);
+    CORRADE_COMPARE(third.layerUsedCount(), 2);
+    CORRADE_COMPARE(&third.baseLayer().shared(), &first.baseLayer().shared());
+    CORRADE_COMPARE(&third.textLayer().shared(), &first.textLayer().shared());
+    CORRADE_COMPARE(appliedFeatures, StyleFeatures{});
+}
+
+void UserInterfaceGLTest::setStyleSharedInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    struct: AbstractStyle {
+        StyleFeatures doFeatures() const override {
+            return StyleFeature::BaseLayer|StyleFeature::TextLayer|StyleFeature::TextLayerImages|StyleFeature::EventLayer;
+        }
+        UnsignedInt doBaseLayerStyleCount() const override { return 1; }
+        UnsignedInt doTextLayerStyleCount() const override { return 1; }
+        bool doApply(UserInterface&, StyleFeatures, PluginManager::Manager<Trade::AbstractImporter>*, PluginManager::Manager<Text::AbstractFont>*) const override {
+            return true;
+        }
+    } style;
+
+    /* Has only the event layer */
+    UserInterfaceGL first{NoCreate};
+    first.setSize({200, 300})
+         .setStyle(style, StyleFeature::EventLayer);
+
+    UserInterfaceGL second{NoCreate};
+    second.setSize({200, 300});
+
+    UserInterfaceGL noSize{NoCreate};
+
+    /* Capture correct function name */
+    CORRADE_VERIFY(true);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    second.trySetStyle(style, {}, first);
+    second.trySetStyle(style, StyleFeature::SnapLayouter, first);
+    first.trySetStyle(style, StyleFeature::BaseLayer, first);
+    noSize.trySetStyle(style, StyleFeature::EventLayer, first);
+    second.trySetStyle(style, StyleFeature::BaseLayer, first);
+    second.trySetStyle(style, StyleFeature::TextLayer, first);
+    second.trySetStyle(style, StyleFeature::TextLayerImages, first);
+    first.trySetStyle(style, StyleFeature::EventLayer, second);
+    CORRADE_COMPARE_AS(out.str(),
+        "Ui::UserInterfaceGL::trySetStyle(): no features specified\n"
+        "Ui::UserInterfaceGL::trySetStyle(): Ui::StyleFeature::SnapLayouter not a subset of supported Ui::StyleFeature::BaseLayer|Ui::StyleFeature::TextLayer|Ui::StyleFeature::TextLayerImages|Ui::StyleFeature::EventLayer\n"
+        "Ui::UserInterfaceGL::trySetStyle(): can't share with itself\n"
+        "Ui::UserInterfaceGL::trySetStyle(): user interface size wasn't set\n"
+        "Ui::UserInterfaceGL::trySetStyle(): base layer not present in the user interface to share with\n"
+        "Ui::UserInterfaceGL::trySetStyle(): text layer not present in the user interface to share with\n"
+        "Ui::UserInterfaceGL::trySetStyle(): text layer not present and Ui::StyleFeature::TextLayer isn't being applied as well\n"
+        "Ui::UserInterfaceGL::trySetStyle(): event layer already present\n",
+        TestSuite::Compare::String);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Ui::Test::UserInterfaceGLTest)
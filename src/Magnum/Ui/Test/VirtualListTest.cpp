@@ -0,0 +1,280 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <sstream>
+#include <Corrade/Containers/StringStl.h> /** @todo remove once Debug is stream-free */
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/TestSuite/Compare/String.h>
+#include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
+
+#include "Magnum/Ui/Anchor.h"
+#include "Magnum/Ui/NodeFlags.h"
+#include "Magnum/Ui/VirtualList.h"
+#include "Magnum/Ui/Test/WidgetTester.hpp"
+
+namespace Magnum { namespace Ui { namespace Test { namespace {
+
+struct VirtualListTest: WidgetTester {
+    explicit VirtualListTest();
+
+    void construct();
+    void constructFewRows();
+    void constructNoCreate();
+    void constructInvalid();
+
+    void setScrollOffset();
+    void setRowCount();
+    void setMargin();
+    void refresh();
+
+    void rowInvalid();
+};
+
+VirtualListTest::VirtualListTest() {
+    addTests<VirtualListTest>({
+        &VirtualListTest::construct,
+        &VirtualListTest::constructFewRows,
+        &VirtualListTest::constructNoCreate,
+        &VirtualListTest::constructInvalid,
+
+        &VirtualListTest::setScrollOffset,
+        &VirtualListTest::setRowCount,
+        &VirtualListTest::setMargin,
+        &VirtualListTest::refresh,
+
+        &VirtualListTest::rowInvalid
+    }, &WidgetTester::setup,
+       &WidgetTester::teardown);
+}
+
+/* Row texts are "a", "bb", "ccc", "a", ..., counting how many times a row text
+   was fetched, i.e. how many times it got shaped */
+Containers::StringView rowText(UnsignedInt row, void* userData) {
+    ++*static_cast<Int*>(userData);
+    return Containers::StringView{"ccc"}.prefix(row % 3 + 1);
+}
+
+void VirtualListTest::construct() {
+    Int called = 0;
+    VirtualList list{{ui, rootNode, {50, 40}}, 10.0f, 1000, rowText, &called};
+    CORRADE_COMPARE(ui.nodeParent(list), rootNode);
+    CORRADE_COMPARE(ui.nodeFlags(list), NodeFlag::Clip);
+    CORRADE_COMPARE(list.rowHeight(), 10.0f);
+    CORRADE_COMPARE(list.rowCount(), 1000);
+    CORRADE_COMPARE(list.margin(), 1);
+    CORRADE_COMPARE(list.scrollOffset(), 0.0f);
+
+    /* Four rows visible, one more for a partially visible row when scrolled,
+       and one margin row on each side. Only those got fetched. */
+    CORRADE_COMPARE(list.firstMaterializedRow(), 0);
+    CORRADE_COMPARE(list.materializedRowCount(), 7);
+    CORRADE_COMPARE(called, 7);
+    CORRADE_COMPARE(ui.textLayer().usedCount(), 7);
+
+    /* Rows are in a content node that's a child of the widget itself */
+    NodeHandle row3 = list.rowNode(3);
+    CORRADE_VERIFY(ui.isHandleValid(row3));
+    CORRADE_COMPARE(ui.nodeParent(ui.nodeParent(row3)), list.node());
+    CORRADE_COMPARE(ui.nodeOffset(ui.nodeParent(row3)), Vector2{});
+    CORRADE_COMPARE(ui.nodeOffset(row3), (Vector2{0.0f, 30.0f}));
+    CORRADE_COMPARE(ui.nodeSize(row3), (Vector2{50.0f, 10.0f}));
+    CORRADE_COMPARE(list.rowNode(7), NodeHandle::Null);
+
+    CORRADE_COMPARE(ui.textLayer().node(list.rowData(3)), row3);
+    CORRADE_COMPARE(ui.textLayer().glyphCount(list.rowData(3)), 1);
+    CORRADE_COMPARE(ui.textLayer().glyphCount(list.rowData(5)), 3);
+    CORRADE_COMPARE(list.rowData(7), DataHandle::Null);
+}
+
+void VirtualListTest::constructFewRows() {
+    Int called = 0;
+    VirtualList list{{ui, rootNode, {50, 40}}, 10.0f, 3, rowText, &called};
+    CORRADE_COMPARE(list.firstMaterializedRow(), 0);
+    CORRADE_COMPARE(list.materializedRowCount(), 3);
+    CORRADE_COMPARE(called, 3);
+
+    /* The list is smaller than the widget, so it can't be scrolled */
+    list.setScrollOffset(10.0f);
+    CORRADE_COMPARE(list.scrollOffset(), 0.0f);
+    CORRADE_COMPARE(called, 3);
+}
+
+void VirtualListTest::constructNoCreate() {
+    VirtualList list{NoCreate, ui};
+    CORRADE_COMPARE(list.node(), NodeHandle::Null);
+}
+
+void VirtualListTest::constructInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    VirtualList{{ui, rootNode, {50, 40}}, 0.0f, 1000, rowText};
+    VirtualList{{ui, rootNode, {50, 40}}, 10.0f, 1000, nullptr};
+    CORRADE_COMPARE_AS(out.str(),
+        "Ui::VirtualList: expected positive row height but got 0\n"
+        "Ui::VirtualList: row text function expected to be non-null\n",
+        TestSuite::Compare::String);
+}
+
+void VirtualListTest::setScrollOffset() {
+    Int called = 0;
+    VirtualList list{{ui, rootNode, {50, 40}}, 10.0f, 1000, rowText, &called};
+    NodeHandle row0 = list.rowNode(0);
+    DataHandle row0Data = list.rowData(0);
+    CORRADE_COMPARE(called, 7);
+
+    /* Scrolling by two and a half rows makes row 0 go out of the margin,
+       only the row 7 that came into view is fetched, reusing the node and
+       data of row 0 */
+    list.setScrollOffset(25.0f);
+    CORRADE_COMPARE(list.scrollOffset(), 25.0f);
+    CORRADE_COMPARE(list.firstMaterializedRow(), 1);
+    CORRADE_COMPARE(list.materializedRowCount(), 7);
+    CORRADE_COMPARE(called, 8);
+    CORRADE_COMPARE(list.rowNode(0), NodeHandle::Null);
+    CORRADE_COMPARE(list.rowNode(7), row0);
+    CORRADE_COMPARE(list.rowData(7), row0Data);
+    CORRADE_COMPARE(ui.nodeOffset(list.rowNode(7)), (Vector2{0.0f, 70.0f}));
+    CORRADE_COMPARE(ui.nodeOffset(ui.nodeParent(row0)), (Vector2{0.0f, -25.0f}));
+    CORRADE_COMPARE(ui.textLayer().glyphCount(list.rowData(7)), 2);
+    CORRADE_COMPARE(ui.textLayer().usedCount(), 7);
+
+    /* Scrolling within the same row doesn't fetch anything */
+    list.setScrollOffset(28.0f);
+    CORRADE_COMPARE(list.firstMaterializedRow(), 1);
+    CORRADE_COMPARE(called, 8);
+    CORRADE_COMPARE(ui.nodeOffset(ui.nodeParent(row0)), (Vector2{0.0f, -28.0f}));
+
+    /* Scrolling past the end clamps, all rows are new. The first row is
+       chosen so all slots are filled. */
+    list.setScrollOffset(1.0e6f);
+    CORRADE_COMPARE(list.scrollOffset(), 9960.0f);
+    CORRADE_COMPARE(list.firstMaterializedRow(), 993);
+    CORRADE_COMPARE(called, 15);
+    CORRADE_COMPARE(ui.nodeOffset(list.rowNode(999)), (Vector2{0.0f, 9990.0f}));
+
+    /* Scrolling before the beginning clamps as well */
+    list.setScrollOffset(-5.0f);
+    CORRADE_COMPARE(list.scrollOffset(), 0.0f);
+    CORRADE_COMPARE(list.firstMaterializedRow(), 0);
+    CORRADE_COMPARE(called, 22);
+    CORRADE_COMPARE(ui.textLayer().usedCount(), 7);
+}
+
+void VirtualListTest::setRowCount() {
+    Int called = 0;
+    VirtualList list{{ui, rootNode, {50, 40}}, 10.0f, 1000, rowText, &called};
+    list.setScrollOffset(1.0e6f);
+    CORRADE_COMPARE(called, 14);
+
+    /* With fewer rows the scroll offset gets clamped and the extra nodes
+       removed */
+    list.setRowCount(5);
+    CORRADE_COMPARE(list.rowCount(), 5);
+    CORRADE_COMPARE(list.scrollOffset(), 10.0f);
+    CORRADE_COMPARE(list.firstMaterializedRow(), 0);
+    CORRADE_COMPARE(list.materializedRowCount(), 5);
+    CORRADE_COMPARE(called, 19);
+    CORRADE_COMPARE(ui.nodeSize(ui.nodeParent(list.rowNode(0))), (Vector2{50.0f, 50.0f}));
+
+    /* Removed nodes and their data get removed on the next clean */
+    ui.clean();
+    CORRADE_COMPARE(ui.textLayer().usedCount(), 5);
+
+    list.setRowCount(0);
+    CORRADE_COMPARE(list.scrollOffset(), 0.0f);
+    CORRADE_COMPARE(list.materializedRowCount(), 0);
+    CORRADE_COMPARE(called, 19);
+
+    ui.clean();
+    CORRADE_COMPARE(ui.textLayer().usedCount(), 0);
+}
+
+void VirtualListTest::setMargin() {
+    Int called = 0;
+    VirtualList list{{ui, rootNode, {50, 40}}, 10.0f, 1000, rowText, &called};
+    CORRADE_COMPARE(called, 7);
+
+    /* Changing the slot count causes everything to be rebound */
+    list.setMargin(0);
+    CORRADE_COMPARE(list.margin(), 0);
+    CORRADE_COMPARE(list.materializedRowCount(), 5);
+    CORRADE_COMPARE(called, 12);
+
+    /* With no margin, scrolling by a single row fetches the new row */
+    list.setScrollOffset(10.0f);
+    CORRADE_COMPARE(list.firstMaterializedRow(), 1);
+    CORRADE_COMPARE(called, 13);
+}
+
+void VirtualListTest::refresh() {
+    Int called = 0;
+    VirtualList list{{ui, rootNode, {50, 40}}, 10.0f, 1000, rowText, &called};
+    CORRADE_COMPARE(called, 7);
+
+    /* Refreshing a materialized row fetches it again, a row that isn't
+       materialized is left alone */
+    list.refreshRow(2);
+    CORRADE_COMPARE(called, 8);
+    list.refreshRow(500);
+    CORRADE_COMPARE(called, 8);
+
+    /* Refreshing everything fetches all materialized rows */
+    list.refresh();
+    CORRADE_COMPARE(called, 15);
+
+    /* Refreshing after a resize materializes more rows and resizes them */
+    ui.setNodeSize(list, {60, 60});
+    list.refresh();
+    CORRADE_COMPARE(list.materializedRowCount(), 9);
+    CORRADE_COMPARE(called, 24);
+    CORRADE_COMPARE(ui.nodeSize(list.rowNode(0)), (Vector2{60.0f, 10.0f}));
+    CORRADE_COMPARE(ui.nodeSize(list.rowNode(8)), (Vector2{60.0f, 10.0f}));
+    CORRADE_COMPARE(ui.nodeSize(ui.nodeParent(list.rowNode(0))), (Vector2{60.0f, 10000.0f}));
+}
+
+void VirtualListTest::rowInvalid() {
+    CORRADE_SKIP_IF_NO_ASSERT();
+
+    Int called = 0;
+    VirtualList list{{ui, rootNode, {50, 40}}, 10.0f, 3, rowText, &called};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    list.rowNode(3);
+    list.rowData(3);
+    list.refreshRow(3);
+    CORRADE_COMPARE_AS(out.str(),
+        "Ui::VirtualList::rowNode(): index 3 out of range for 3 rows\n"
+        "Ui::VirtualList::rowData(): index 3 out of range for 3 rows\n"
+        "Ui::VirtualList::refreshRow(): index 3 out of range for 3 rows\n",
+        TestSuite::Compare::String);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Ui::Test::VirtualListTest)
@@ -26,30 +26,41 @@
 
 #include "TextLayer.h"
 
+#include <cstring>
 #include <Corrade/Containers/Array.h>
-#include <Corrade/Containers/BitArrayView.h>
+#include <Corrade/Containers/BitArray.h>
 #include <Corrade/Containers/EnumSet.hpp>
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Iterable.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
 #include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringView.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Containers/Triple.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/Unicode.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Constants.h>
 #include <Magnum/Math/Functions.h>
 #include <Magnum/Math/Matrix3.h>
+#include <Magnum/Math/Packing.h>
 #include <Magnum/Math/Swizzle.h>
 #include <Magnum/Math/Time.h>
+#include <Magnum/Text/AbstractFont.h>
 #include <Magnum/Text/AbstractGlyphCache.h>
 #include <Magnum/Text/Direction.h>
 #include <Magnum/Text/Feature.h>
 #include <Magnum/Text/Renderer.h>
+#include <Magnum/TextureTools/Atlas.h>
 
 #include "Magnum/Ui/TextLayerAnimator.h"
 #include "Magnum/Ui/Event.h"
 #include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/MemoryUsage.h"
 #include "Magnum/Ui/TextProperties.h"
+#include "Magnum/Ui/Implementation/memoryUsage.h"
 #include "Magnum/Ui/Implementation/textLayerState.h"
 
 namespace Magnum { namespace Ui {
@@ -67,6 +78,9 @@ Debug& operator<<(Debug& debug, const TextDataFlag value) {
         /* LCOV_EXCL_START */
         #define _c(value) case TextDataFlag::value: return debug << "::" #value;
         _c(Editable)
+        _c(DeferredShaping)
+        _c(SizeToContent)
+        _c(Hibernatable)
         #undef _c
         /* LCOV_EXCL_STOP */
     }
@@ -76,7 +90,10 @@ Debug& operator<<(Debug& debug, const TextDataFlag value) {
 
 Debug& operator<<(Debug& debug, const TextDataFlags value) {
     return Containers::enumSetDebugOutput(debug, value, "Ui::TextDataFlags{}", {
-        TextDataFlag::Editable
+        TextDataFlag::Editable,
+        TextDataFlag::DeferredShaping,
+        TextDataFlag::SizeToContent,
+        TextDataFlag::Hibernatable
     });
 }
 
@@ -112,6 +129,80 @@ TextLayer::Shared::State::State(Shared& self, const Configuration& configuration
         {NoInit, configuration.editingStyleCount(), editingStyles},
         {NoInit, configuration.dynamicStyleCount() ? configuration.editingStyleUniformCount() : 0, editingStyleUniforms},
     };
+
+    shapeCacheSize = configuration.shapeCacheSize();
+    simpleShaping = configuration.hasSimpleShaping();
+    glyphRunReuse = configuration.hasGlyphRunReuse();
+    textInputBatching = configuration.hasTextInputBatching();
+    instancedGlyphs = configuration.hasInstancedGlyphs();
+    distanceFieldGlyphs = configuration.hasDistanceFieldGlyphs();
+    compactVertices = configuration.hasCompactVertices();
+    arrayReserve(shapeCacheHashes, shapeCacheSize);
+    arrayReserve(shapeCache, shapeCacheSize);
+}
+
+UnsignedInt TextLayer::Shared::State::shapeCacheFind(const Containers::ArrayView<const char> key, const UnsignedLong hash) {
+    for(std::size_t i = 0; i != shapeCacheHashes.size(); ++i) {
+        if(shapeCacheHashes[i] != hash)
+            continue;
+        const Containers::ArrayView<const char> entryKey = shapeCache[i].key;
+        if(Containers::StringView{entryKey.data(), entryKey.size()} != Containers::StringView{key.data(), key.size()})
+            continue;
+
+        shapeCacheUse(i);
+        return i;
+    }
+
+    return ~UnsignedInt{};
+}
+
+UnsignedInt TextLayer::Shared::State::shapeCacheAdd(Containers::Array<char>&& key, const UnsignedLong hash, const UnsignedInt glyphCount, const Text::ShapeDirection direction) {
+    UnsignedInt id;
+
+    /* If there's still space, add a new entry to the front of the list ... */
+    if(shapeCache.size() < shapeCacheSize) {
+        id = shapeCache.size();
+        arrayAppend(shapeCacheHashes, hash);
+        Implementation::TextLayerShapeCacheEntry& entry = arrayAppend(shapeCache, InPlaceInit);
+        entry.previous = ~UnsignedInt{};
+        entry.next = shapeCacheFirst;
+        if(shapeCacheFirst == ~UnsignedInt{})
+            shapeCacheLast = id;
+        else
+            shapeCache[shapeCacheFirst].previous = id;
+        shapeCacheFirst = id;
+
+    /* ... otherwise move the least recently used to the front and reuse it */
+    } else {
+        id = shapeCacheLast;
+        shapeCacheUse(id);
+        shapeCacheHashes[id] = hash;
+    }
+
+    Implementation::TextLayerShapeCacheEntry& entry = shapeCache[id];
+    entry.key = Utility::move(key);
+    entry.glyphs = Containers::Array<Implementation::TextLayerShapeCacheGlyph>{NoInit, glyphCount};
+    entry.direction = direction;
+    return id;
+}
+
+void TextLayer::Shared::State::shapeCacheUse(const UnsignedInt id) {
+    if(id == shapeCacheFirst)
+        return;
+
+    /* Unlink the entry. It's not the first, so it has a previous one. */
+    Implementation::TextLayerShapeCacheEntry& entry = shapeCache[id];
+    shapeCache[entry.previous].next = entry.next;
+    if(entry.next == ~UnsignedInt{})
+        shapeCacheLast = entry.previous;
+    else
+        shapeCache[entry.next].previous = entry.previous;
+
+    /* Put it to the front */
+    entry.previous = ~UnsignedInt{};
+    entry.next = shapeCacheFirst;
+    shapeCache[shapeCacheFirst].previous = id;
+    shapeCacheFirst = id;
 }
 
 TextLayer::Shared::Shared(Containers::Pointer<State>&& state): AbstractVisualLayer::Shared{Utility::move(state)} {
@@ -165,10 +256,394 @@ const Text::AbstractGlyphCache& TextLayer::Shared::glyphCache() const {
     return *state.glyphCache;
 }
 
+bool TextLayer::Shared::hasOnDemandGlyphCacheFilling() const {
+    return static_cast<const State&>(*_state).onDemandGlyphCacheFilling;
+}
+
+TextLayer::Shared& TextLayer::Shared::setOnDemandGlyphCacheFilling(const bool enabled) {
+    static_cast<State&>(*_state).onDemandGlyphCacheFilling = enabled;
+    return *this;
+}
+
+namespace {
+
+/* Layout of data produced by TextLayer::Shared::serializeGlyphCache(). The
+   header is followed by glyph count of each font, then properties of each
+   glyph except the invalid one in the order of cache-global IDs and then
+   tightly packed pixel data of each glyph in the same order. */
+struct GlyphCacheDataHeader {
+    char magic[4];
+    UnsignedInt version;
+    PixelFormat format;
+    UnsignedInt fontCount;
+    UnsignedInt glyphCount;
+};
+
+struct GlyphCacheDataGlyph {
+    UnsignedInt font;
+    UnsignedInt fontGlyph;
+    Vector2i offset;
+    Vector2i size;
+};
+
+constexpr char GlyphCacheDataMagic[]{'U', 'i', 'G', 'C'};
+constexpr UnsignedInt GlyphCacheDataVersion = 1;
+
+}
+
+Containers::Array<char> TextLayer::Shared::serializeGlyphCache() const {
+    const State& state = static_cast<const State&>(*_state);
+    CORRADE_ASSERT(state.glyphCache,
+        "Ui::TextLayer::Shared::serializeGlyphCache(): no glyph cache set", {});
+    const Text::AbstractGlyphCache& cache = *state.glyphCache;
+    const std::size_t pixelSize = pixelFormatSize(cache.format());
+
+    /* Cache-global glyph IDs only go one way, so invert the mapping from
+       font-specific IDs first. Every glyph except the invalid one belongs to
+       exactly one font. */
+    const UnsignedInt fontCount = cache.fontCount();
+    const UnsignedInt glyphCount = cache.glyphCount() - 1;
+    Containers::Array<GlyphCacheDataGlyph> glyphs{NoInit, glyphCount};
+    for(UnsignedInt font = 0; font != fontCount; ++font) {
+        for(UnsignedInt fontGlyph = 0, fontGlyphCount = cache.fontGlyphCount(font); fontGlyph != fontGlyphCount; ++fontGlyph) {
+            const UnsignedInt glyphId = cache.glyphId(font, fontGlyph);
+            if(!glyphId)
+                continue;
+
+            const Containers::Triple<Vector2i, Int, Range2Di> glyph = cache.glyph(glyphId);
+            glyphs[glyphId - 1] = {font, fontGlyph, glyph.first(), glyph.third().size()};
+        }
+    }
+
+    std::size_t pixelDataSize = 0;
+    for(const GlyphCacheDataGlyph& glyph: glyphs)
+        pixelDataSize += std::size_t(glyph.size.product())*pixelSize;
+
+    const std::size_t fontOffset = sizeof(GlyphCacheDataHeader);
+    const std::size_t glyphOffset = fontOffset + fontCount*sizeof(UnsignedInt);
+    const std::size_t pixelOffset = glyphOffset + glyphCount*sizeof(GlyphCacheDataGlyph);
+    Containers::Array<char> out{NoInit, pixelOffset + pixelDataSize};
+
+    GlyphCacheDataHeader header;
+    std::memcpy(header.magic, GlyphCacheDataMagic, sizeof(header.magic));
+    header.version = GlyphCacheDataVersion;
+    header.format = cache.format();
+    header.fontCount = fontCount;
+    header.glyphCount = glyphCount;
+    std::memcpy(out.data(), &header, sizeof(header));
+    for(UnsignedInt font = 0; font != fontCount; ++font) {
+        const UnsignedInt fontGlyphCount = cache.fontGlyphCount(font);
+        std::memcpy(out.data() + fontOffset + font*sizeof(UnsignedInt), &fontGlyphCount, sizeof(UnsignedInt));
+    }
+    if(glyphCount)
+        std::memcpy(out.data() + glyphOffset, glyphs.data(), glyphCount*sizeof(GlyphCacheDataGlyph));
+
+    /* Copy out the pixel data of each glyph */
+    const Containers::StridedArrayView4D<const char> src = cache.image().pixels();
+    std::size_t offset = pixelOffset;
+    for(UnsignedInt i = 0; i != glyphCount; ++i) {
+        const Containers::Triple<Vector2i, Int, Range2Di> glyph = cache.glyph(i + 1);
+        const Containers::Size3D size{
+            std::size_t(glyph.third().sizeY()),
+            std::size_t(glyph.third().sizeX()),
+            pixelSize};
+        Utility::copy(
+            src[glyph.second()].sliceSize({std::size_t(glyph.third().bottom()),
+                                           std::size_t(glyph.third().left()),
+                                           0}, size),
+            Containers::StridedArrayView3D<char>{out.sliceSize(offset, size.product()), size});
+        offset += size.product();
+    }
+    CORRADE_INTERNAL_ASSERT(offset == out.size());
+
+    return out;
+}
+
+Containers::Optional<UnsignedInt> TextLayer::Shared::deserializeGlyphCache(const Containers::ArrayView<const char> data, const Containers::ArrayView<const Text::AbstractFont* const> fonts) {
+    State& state = static_cast<State&>(*_state);
+    CORRADE_ASSERT(state.glyphCache,
+        "Ui::TextLayer::Shared::deserializeGlyphCache(): no glyph cache set", {});
+    Text::AbstractGlyphCache& cache = *state.glyphCache;
+
+    /* The data can come from anywhere, so copy everything out to not need
+       to care about alignment */
+    GlyphCacheDataHeader header;
+    if(data.size() < sizeof(header)) {
+        Error{} << "Ui::TextLayer::Shared::deserializeGlyphCache(): expected at least" << sizeof(header) << "bytes but got" << data.size();
+        return {};
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    if(std::memcmp(header.magic, GlyphCacheDataMagic, sizeof(header.magic)) != 0 || header.version != GlyphCacheDataVersion) {
+        Error{} << "Ui::TextLayer::Shared::deserializeGlyphCache(): invalid header";
+        return {};
+    }
+    if(header.format != cache.format()) {
+        Error{} << "Ui::TextLayer::Shared::deserializeGlyphCache(): expected" << cache.format() << "data but got" << header.format;
+        return {};
+    }
+    if(!fonts.isEmpty() && fonts.size() != header.fontCount) {
+        Error{} << "Ui::TextLayer::Shared::deserializeGlyphCache(): expected" << header.fontCount << "fonts but got" << fonts.size();
+        return {};
+    }
+
+    const std::size_t fontOffset = sizeof(GlyphCacheDataHeader);
+    const std::size_t glyphOffset = fontOffset + std::size_t(header.fontCount)*sizeof(UnsignedInt);
+    const std::size_t pixelOffset = glyphOffset + std::size_t(header.glyphCount)*sizeof(GlyphCacheDataGlyph);
+    if(data.size() < pixelOffset) {
+        Error{} << "Ui::TextLayer::Shared::deserializeGlyphCache(): expected at least" << pixelOffset << "bytes for" << header.fontCount << "fonts and" << header.glyphCount << "glyphs but got" << data.size();
+        return {};
+    }
+    Containers::Array<UnsignedInt> fontGlyphCounts{NoInit, header.fontCount};
+    Containers::Array<GlyphCacheDataGlyph> glyphs{NoInit, header.glyphCount};
+    if(header.fontCount)
+        std::memcpy(fontGlyphCounts.data(), data.data() + fontOffset, header.fontCount*sizeof(UnsignedInt));
+    if(header.glyphCount)
+        std::memcpy(glyphs.data(), data.data() + glyphOffset, header.glyphCount*sizeof(GlyphCacheDataGlyph));
+
+    /* Verify that each glyph references a valid font glyph that isn't
+       duplicated, as the glyph cache would assert on that */
+    Containers::Array<std::size_t> fontGlyphOffsets{NoInit, header.fontCount + 1};
+    fontGlyphOffsets[0] = 0;
+    for(UnsignedInt font = 0; font != header.fontCount; ++font)
+        fontGlyphOffsets[font + 1] = fontGlyphOffsets[font] + fontGlyphCounts[font];
+    Containers::BitArray fontGlyphsUsed{ValueInit, fontGlyphOffsets[header.fontCount]};
+    const std::size_t pixelSize = pixelFormatSize(cache.format());
+    std::size_t pixelDataSize = 0;
+    for(UnsignedInt i = 0; i != header.glyphCount; ++i) {
+        const GlyphCacheDataGlyph& glyph = glyphs[i];
+        if(glyph.font >= header.fontCount || glyph.fontGlyph >= fontGlyphCounts[glyph.font] || fontGlyphsUsed[fontGlyphOffsets[glyph.font] + glyph.fontGlyph] || glyph.size.x() < 0 || glyph.size.y() < 0) {
+            Error{} << "Ui::TextLayer::Shared::deserializeGlyphCache(): invalid glyph" << i;
+            return {};
+        }
+        fontGlyphsUsed.set(fontGlyphOffsets[glyph.font] + glyph.fontGlyph);
+        pixelDataSize += std::size_t(glyph.size.product())*pixelSize;
+    }
+    if(data.size() != pixelOffset + pixelDataSize) {
+        Error{} << "Ui::TextLayer::Shared::deserializeGlyphCache(): expected" << pixelOffset + pixelDataSize << "bytes but got" << data.size();
+        return {};
+    }
+
+    /* Place the glyphs into the atlas anew, which means the atlas knows about
+       the space they occupy and the cache can be filled further. Done before
+       adding the fonts so nothing is added if they don't fit. */
+    Containers::Array<Vector3i> offsets{NoInit, header.glyphCount};
+    const Containers::Optional<Range3Di> updated = cache.atlas().add(stridedArrayView(glyphs).slice(&GlyphCacheDataGlyph::size), stridedArrayView(offsets));
+    if(!updated) {
+        Error{} << "Ui::TextLayer::Shared::deserializeGlyphCache(): cannot fit" << header.glyphCount << "glyphs into the glyph cache";
+        return {};
+    }
+
+    const UnsignedInt firstFont = cache.fontCount();
+    for(UnsignedInt font = 0; font != header.fontCount; ++font)
+        cache.addFont(fontGlyphCounts[font], fonts.isEmpty() ? nullptr : fonts[font]);
+
+    const Containers::StridedArrayView4D<char> dst = cache.image().pixels();
+    std::size_t offset = pixelOffset;
+    for(UnsignedInt i = 0; i != header.glyphCount; ++i) {
+        const GlyphCacheDataGlyph& glyph = glyphs[i];
+        cache.addGlyph(firstFont + glyph.font, glyph.fontGlyph, glyph.offset, offsets[i].z(), Range2Di::fromSize(offsets[i].xy(), glyph.size));
+
+        const Containers::Size3D size{
+            std::size_t(glyph.size.y()),
+            std::size_t(glyph.size.x()),
+            pixelSize};
+        Utility::copy(
+            Containers::StridedArrayView3D<const char>{data.sliceSize(offset, size.product()), size},
+            dst[offsets[i].z()].sliceSize({std::size_t(offsets[i].y()),
+                                           std::size_t(offsets[i].x()),
+                                           0}, size));
+        offset += size.product();
+    }
+
+    /* Reflect the image data update to the actual GPU-side texture */
+    if(header.glyphCount)
+        cache.flushImage(*updated);
+
+    return firstFont;
+}
+
+Containers::Optional<UnsignedInt> TextLayer::Shared::deserializeGlyphCache(const Containers::ArrayView<const char> data) {
+    return deserializeGlyphCache(data, nullptr);
+}
+
+namespace {
+
+/* 64-bit FNV-1a */
+UnsignedLong shapeCacheKeyHash(const Containers::ArrayView<const char> key) {
+    UnsignedLong hash = 14695981039346656037ull;
+    for(const char c: key) {
+        hash ^= UnsignedByte(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/* Layout of data produced by TextLayer::Shared::serializeShapeCache(). The
+   header is followed by each entry from the least recently used to the most
+   recently used, with each entry being a ShapeCacheDataEntry followed by
+   the key and then the glyphs. */
+struct ShapeCacheDataHeader {
+    char magic[4];
+    UnsignedInt version;
+    UnsignedInt entryCount;
+};
+
+struct ShapeCacheDataEntry {
+    UnsignedInt keySize;
+    UnsignedInt glyphCount;
+    /* Not Text::ShapeDirection to not have uninitialized padding bytes */
+    UnsignedInt direction;
+};
+
+constexpr char ShapeCacheDataMagic[]{'U', 'i', 'S', 'C'};
+constexpr UnsignedInt ShapeCacheDataVersion = 1;
+
+}
+
+Containers::Array<char> TextLayer::Shared::serializeShapeCache() const {
+    const State& state = static_cast<const State&>(*_state);
+
+    std::size_t size = sizeof(ShapeCacheDataHeader);
+    for(const Implementation::TextLayerShapeCacheEntry& entry: state.shapeCache)
+        size += sizeof(ShapeCacheDataEntry) + entry.key.size() + entry.glyphs.size()*sizeof(Implementation::TextLayerShapeCacheGlyph);
+    Containers::Array<char> out{NoInit, size};
+
+    ShapeCacheDataHeader header;
+    std::memcpy(header.magic, ShapeCacheDataMagic, sizeof(header.magic));
+    header.version = ShapeCacheDataVersion;
+    header.entryCount = state.shapeCache.size();
+    std::memcpy(out.data(), &header, sizeof(header));
+
+    /* Go from the least recently used so the deserialization can add them in
+       order and preserve the use order */
+    std::size_t offset = sizeof(ShapeCacheDataHeader);
+    for(UnsignedInt i = state.shapeCacheLast; i != ~UnsignedInt{}; i = state.shapeCache[i].previous) {
+        const Implementation::TextLayerShapeCacheEntry& entry = state.shapeCache[i];
+        ShapeCacheDataEntry entryHeader;
+        entryHeader.keySize = entry.key.size();
+        entryHeader.glyphCount = entry.glyphs.size();
+        entryHeader.direction = UnsignedInt(entry.direction);
+        std::memcpy(out.data() + offset, &entryHeader, sizeof(entryHeader));
+        offset += sizeof(entryHeader);
+        if(!entry.key.isEmpty())
+            std::memcpy(out.data() + offset, entry.key.data(), entry.key.size());
+        offset += entry.key.size();
+        if(!entry.glyphs.isEmpty())
+            std::memcpy(out.data() + offset, entry.glyphs.data(), entry.glyphs.size()*sizeof(Implementation::TextLayerShapeCacheGlyph));
+        offset += entry.glyphs.size()*sizeof(Implementation::TextLayerShapeCacheGlyph);
+    }
+    CORRADE_INTERNAL_ASSERT(offset == out.size());
+
+    return out;
+}
+
+bool TextLayer::Shared::deserializeShapeCache(const Containers::ArrayView<const char> data) {
+    State& state = static_cast<State&>(*_state);
+
+    /* The data can come from anywhere, so copy everything out to not need
+       to care about alignment */
+    ShapeCacheDataHeader header;
+    if(data.size() < sizeof(header)) {
+        Error{} << "Ui::TextLayer::Shared::deserializeShapeCache(): expected at least" << sizeof(header) << "bytes but got" << data.size();
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    if(std::memcmp(header.magic, ShapeCacheDataMagic, sizeof(header.magic)) != 0 || header.version != ShapeCacheDataVersion) {
+        Error{} << "Ui::TextLayer::Shared::deserializeShapeCache(): invalid header";
+        return false;
+    }
+
+    /* Verify that all entries are in bounds first to not end up with the
+       cache partially filled on error */
+    std::size_t offset = sizeof(ShapeCacheDataHeader);
+    for(UnsignedInt i = 0; i != header.entryCount; ++i) {
+        ShapeCacheDataEntry entry;
+        if(data.size() < offset + sizeof(entry)) {
+            Error{} << "Ui::TextLayer::Shared::deserializeShapeCache(): expected at least" << offset + sizeof(entry) << "bytes for entry" << i << "but got" << data.size();
+            return false;
+        }
+        std::memcpy(&entry, data.data() + offset, sizeof(entry));
+        offset += sizeof(entry) + std::size_t(entry.keySize) + std::size_t(entry.glyphCount)*sizeof(Implementation::TextLayerShapeCacheGlyph);
+        if(data.size() < offset) {
+            Error{} << "Ui::TextLayer::Shared::deserializeShapeCache(): expected at least" << offset << "bytes for entry" << i << "but got" << data.size();
+            return false;
+        }
+    }
+    if(data.size() != offset) {
+        Error{} << "Ui::TextLayer::Shared::deserializeShapeCache(): expected" << offset << "bytes but got" << data.size();
+        return false;
+    }
+
+    /* If the cache is disabled, there's nothing to do. Not an error, the
+       data are valid. */
+    if(!state.shapeCacheSize)
+        return true;
+
+    /* Add the entries. If there's more than what fits, the least recently
+       used ones get replaced by the later ones, if an entry is already
+       present, it's marked as most recently used and kept as-is. */
+    offset = sizeof(ShapeCacheDataHeader);
+    for(UnsignedInt i = 0; i != header.entryCount; ++i) {
+        ShapeCacheDataEntry entry;
+        std::memcpy(&entry, data.data() + offset, sizeof(entry));
+        offset += sizeof(entry);
+
+        const Containers::ArrayView<const char> key = data.sliceSize(offset, entry.keySize);
+        offset += entry.keySize;
+        const std::size_t glyphSize = std::size_t(entry.glyphCount)*sizeof(Implementation::TextLayerShapeCacheGlyph);
+        const Containers::ArrayView<const char> glyphs = data.sliceSize(offset, glyphSize);
+        offset += glyphSize;
+
+        const UnsignedLong hash = shapeCacheKeyHash(key);
+        if(state.shapeCacheFind(key, hash) != ~UnsignedInt{})
+            continue;
+
+        Containers::Array<char> keyCopy{NoInit, key.size()};
+        Utility::copy(key, keyCopy);
+        const UnsignedInt id = state.shapeCacheAdd(Utility::move(keyCopy), hash, entry.glyphCount, Text::ShapeDirection(entry.direction));
+        if(glyphSize)
+            std::memcpy(state.shapeCache[id].glyphs.data(), glyphs.data(), glyphSize);
+    }
+
+    return true;
+}
+
 std::size_t TextLayer::Shared::fontCount() const {
     return static_cast<const State&>(*_state).fonts.size();
 }
 
+UnsignedInt TextLayer::Shared::shapeCacheSize() const {
+    return static_cast<const State&>(*_state).shapeCacheSize;
+}
+
+UnsignedInt TextLayer::Shared::shapeCacheUsedCount() const {
+    return static_cast<const State&>(*_state).shapeCache.size();
+}
+
+bool TextLayer::Shared::hasSimpleShaping() const {
+    return static_cast<const State&>(*_state).simpleShaping;
+}
+
+bool TextLayer::Shared::hasGlyphRunReuse() const {
+    return static_cast<const State&>(*_state).glyphRunReuse;
+}
+
+bool TextLayer::Shared::hasTextInputBatching() const {
+    return static_cast<const State&>(*_state).textInputBatching;
+}
+
+bool TextLayer::Shared::hasInstancedGlyphs() const {
+    return static_cast<const State&>(*_state).instancedGlyphs;
+}
+
+bool TextLayer::Shared::hasDistanceFieldGlyphs() const {
+    return static_cast<const State&>(*_state).distanceFieldGlyphs;
+}
+
+bool TextLayer::Shared::hasCompactVertices() const {
+    return static_cast<const State&>(*_state).compactVertices;
+}
+
 namespace {
     /* TextLayer::setText() uses this too. It has access to the outer Shared
        API via shared() so it could call the public API directly, but this is
@@ -194,7 +669,7 @@ FontHandle TextLayer::Shared::addFont(Text::AbstractFont& font, const Float size
     /** @todo assert that the font is opened? doesn't prevent anybody from
         closing it, tho */
 
-    arrayAppend(state.fonts, InPlaceInit, nullptr, &font, nullptr, size/font.size(), *glyphCacheFontId);
+    arrayAppend(state.fonts, InPlaceInit, nullptr, &font, nullptr, size/font.size(), *glyphCacheFontId, nullptr, nullptr, nullptr, nullptr);
     return fontHandle(state.fonts.size() - 1, 1);
 }
 
@@ -217,7 +692,7 @@ FontHandle TextLayer::Shared::addInstancelessFont(const UnsignedInt glyphCacheFo
     CORRADE_ASSERT(state.fonts.size() < 1 << Implementation::FontHandleIdBits,
         "Ui::TextLayer::Shared::addInstancelessFont(): can only have at most" << (1 << Implementation::FontHandleIdBits) << "fonts", {});
 
-    arrayAppend(state.fonts, InPlaceInit, nullptr, nullptr, nullptr, scale, glyphCacheFontId);
+    arrayAppend(state.fonts, InPlaceInit, nullptr, nullptr, nullptr, scale, glyphCacheFontId, nullptr, nullptr, nullptr, nullptr);
     return fontHandle(state.fonts.size() - 1, 1);
 }
 
@@ -249,6 +724,44 @@ Text::AbstractFont& TextLayer::Shared::font(const FontHandle handle) {
     return const_cast<Text::AbstractFont&>(const_cast<const TextLayer::Shared&>(*this).font(handle));
 }
 
+TextLayer::Shared& TextLayer::Shared::setFontFallbacks(const FontHandle handle, const Containers::ArrayView<const FontHandle> fallbacks) {
+    State& state = static_cast<State&>(*_state);
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::TextLayer::Shared::setFontFallbacks(): invalid handle" << handle, *this);
+    Implementation::TextLayerFont& fontState = state.fonts[fontHandleId(handle)];
+    CORRADE_ASSERT(fontState.font,
+        "Ui::TextLayer::Shared::setFontFallbacks():" << handle << "is an instance-less font", *this);
+    #ifndef CORRADE_NO_ASSERT
+    for(std::size_t i = 0; i != fallbacks.size(); ++i) {
+        const FontHandle fallback = fallbacks[i];
+        CORRADE_ASSERT(isHandleValid(fallback),
+            "Ui::TextLayer::Shared::setFontFallbacks(): invalid fallback handle" << fallback << "at index" << i, *this);
+        CORRADE_ASSERT(fallback != handle,
+            "Ui::TextLayer::Shared::setFontFallbacks(): fallback at index" << i << "is the font itself", *this);
+        const Implementation::TextLayerFont& fallbackState = state.fonts[fontHandleId(fallback)];
+        CORRADE_ASSERT(fallbackState.font,
+            "Ui::TextLayer::Shared::setFontFallbacks(): fallback" << fallback << "at index" << i << "is an instance-less font", *this);
+        CORRADE_ASSERT(fallbackState.scale == fontState.scale,
+            "Ui::TextLayer::Shared::setFontFallbacks(): expected fallback" << fallback << "at index" << i << "to have a scale of" << fontState.scale << "but got" << fallbackState.scale, *this);
+    }
+    #endif
+
+    fontState.fallbacks = Containers::Array<FontHandle>{NoInit, fallbacks.size()};
+    Utility::copy(fallbacks, fontState.fallbacks);
+    return *this;
+}
+
+TextLayer::Shared& TextLayer::Shared::setFontFallbacks(const FontHandle handle, const std::initializer_list<FontHandle> fallbacks) {
+    return setFontFallbacks(handle, Containers::arrayView(fallbacks));
+}
+
+Containers::ArrayView<const FontHandle> TextLayer::Shared::fontFallbacks(const FontHandle handle) const {
+    const State& state = static_cast<const State&>(*_state);
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::TextLayer::Shared::fontFallbacks(): invalid handle" << handle, {});
+    return state.fonts[fontHandleId(handle)].fallbacks;
+}
+
 void TextLayer::Shared::setStyleInternal(const TextLayerCommonStyleUniform& commonUniform, const Containers::ArrayView<const TextLayerStyleUniform> uniforms, const Containers::StridedArrayView1D<const FontHandle>& styleFonts, const Containers::StridedArrayView1D<const Text::Alignment>& styleAlignments, const Containers::ArrayView<const TextFeatureValue> styleFeatures, const Containers::StridedArrayView1D<const UnsignedInt>& styleFeatureOffsets, const Containers::StridedArrayView1D<const UnsignedInt>& styleFeatureCounts, const Containers::StridedArrayView1D<const Int>& styleCursorStyles, const Containers::StridedArrayView1D<const Int>& styleSelectionStyles, const Containers::StridedArrayView1D<const Vector4>& stylePaddings) {
     State& state = static_cast<State&>(*_state);
     CORRADE_ASSERT(uniforms.size() == state.styleUniformCount,
@@ -598,6 +1111,8 @@ void TextLayer::setDynamicStyleInternal(
        style updated. */
     setNeedsUpdate(LayerState::NeedsCommonDataUpdate);
     state.dynamicStyleChanged = true;
+    state.dynamicStyleChangedBegin = Math::min(state.dynamicStyleChangedBegin, id);
+    state.dynamicStyleChangedEnd = Math::max(state.dynamicStyleChangedEnd, id + 1);
 
     /* Mark the layer as changed only if the padding actually changes,
        otherwise it's not needed to trigger an update(). OTOH changing the
@@ -658,6 +1173,8 @@ void TextLayer::setDynamicCursorStyleInternal(
        style updated. */
     setNeedsUpdate(LayerState::NeedsCommonDataUpdate);
     state.dynamicEditingStyleChanged = true;
+    state.dynamicStyleChangedBegin = Math::min(state.dynamicStyleChangedBegin, id);
+    state.dynamicStyleChangedEnd = Math::max(state.dynamicStyleChangedEnd, id + 1);
 
     /* Mark the layer as changed only if the padding actually changes or if the
        style didn't have a cursor style associated before, otherwise it's not
@@ -702,6 +1219,8 @@ void TextLayer::setDynamicSelectionStyleInternal(
        style updated. */
     setNeedsUpdate(LayerState::NeedsCommonDataUpdate);
     state.dynamicEditingStyleChanged = true;
+    state.dynamicStyleChangedBegin = Math::min(state.dynamicStyleChangedBegin, id);
+    state.dynamicStyleChangedEnd = Math::max(state.dynamicStyleChangedEnd, id + 1);
     /* As we updated the non-editing part of the style with the text uniform,
        the regular style needs to update as well, which should be already done
        by setDynamicStyleInternal() that's called together with this function
@@ -843,25 +1362,499 @@ void TextLayer::setDynamicStyleWithSelection(const UnsignedInt id, const TextLay
     setDynamicStyleWithSelection(id, uniform, font, alignment, Containers::arrayView(features), padding, selectionUniform, selectionTextUniform, selectionPadding);
 }
 
-void TextLayer::shapeTextInternal(const UnsignedInt id, const UnsignedInt style, const Containers::StringView text, const TextProperties& properties, const FontHandle font, const TextDataFlags flags) {
+namespace {
+
+/* Serializes everything that affects the shaper output into a single byte
+   array, with sizes of variable-length parts included to make the boundaries
+   unambiguous */
+void shapeCacheKeyInto(Containers::Array<char>& out, const FontHandle font, const TextProperties& properties, const Containers::ArrayView<const Text::FeatureRange> features, const Containers::StringView text) {
+    const auto append = [&out](const void* data, std::size_t size) {
+        arrayAppend(out, Containers::ArrayView<const char>{static_cast<const char*>(data), size});
+    };
+
+    const Containers::StringView language = properties.language();
+    const UnsignedInt languageSize = language.size();
+    const UnsignedInt featureCount = features.size();
+    const Text::Script script = properties.script();
+    const Text::ShapeDirection shapeDirection = properties.shapeDirection();
+    arrayReserve(out, sizeof(FontHandle) + sizeof(Text::Script) + sizeof(Text::ShapeDirection) + 4 + languageSize + 4 + featureCount*16 + text.size());
+    append(&font, sizeof(FontHandle));
+    append(&script, sizeof(Text::Script));
+    append(&shapeDirection, sizeof(Text::ShapeDirection));
+    append(&languageSize, 4);
+    append(language.data(), languageSize);
+    append(&featureCount, 4);
+    for(const Text::FeatureRange& feature: features) {
+        const UnsignedInt values[]{
+            UnsignedInt(feature.feature()),
+            feature.value(),
+            feature.begin(),
+            feature.end()
+        };
+        append(values, sizeof(values));
+    }
+    append(text.data(), text.size());
+}
+
+/* Returns a shaper from the font shaper pool that's configured for script,
+   language and shape direction in given properties. If there's none, a new
+   one is created or, if the pool is full, the least recently used one is
+   reconfigured. */
+Text::AbstractShaper& fontShaper(Implementation::TextLayerFont& fontState, const TextProperties& properties) {
+    const Containers::StringView language = properties.language();
+    const Text::Script script = properties.script();
+    const Text::ShapeDirection direction = properties.shapeDirection();
+
+    Containers::Array<Implementation::TextLayerFontShaper>& shapers = fontState.shapers;
+    std::size_t found = 0;
+    for(; found != shapers.size(); ++found) {
+        const Implementation::TextLayerFontShaper& shaper = shapers[found];
+        if(shaper.script == script && shaper.direction == direction && Containers::StringView{shaper.language} == language)
+            break;
+    }
+
+    if(found == shapers.size()) {
+        if(shapers.size() < Implementation::TextLayerFontShaperPoolSize)
+            arrayAppend(shapers, InPlaceInit, fontState.font->createShaper());
+        found = shapers.size() - 1;
+
+        Implementation::TextLayerFontShaper& shaper = shapers[found];
+        shaper.shaper->setScript(script);
+        shaper.shaper->setLanguage(language);
+        shaper.shaper->setDirection(direction);
+        /* The language is guaranteed to fit by TextProperties */
+        Utility::copy(Containers::ArrayView<const char>{language.data(), language.size()}, Containers::arrayView(shaper.language).prefix(language.size()));
+        shaper.language[language.size()] = '\0';
+        shaper.script = script;
+        shaper.direction = direction;
+    }
+
+    /* Move the shaper to the front to mark it as the most recently used */
+    if(found) {
+        Implementation::TextLayerFontShaper shaper = Utility::move(shapers[found]);
+        for(std::size_t i = found; i != 0; --i)
+            shapers[i] = Utility::move(shapers[i - 1]);
+        shapers[0] = Utility::move(shaper);
+    }
+
+    return *shapers[0].shaper;
+}
+
+/* Shapes a single line of text using the simple shaping table of given font,
+   building the table on first use and shaping character pairs that weren't
+   encountered yet. Appends the glyphs to `out` and returns true on success,
+   returns false if the text, properties or features aren't suitable for it,
+   in which case the caller is expected to use the shaper instead. */
+bool simpleShapeInto(Implementation::TextLayerFont& fontState, const TextProperties& properties, const Containers::ArrayView<const Text::FeatureRange> features, const Containers::StringView text, Containers::Array<Implementation::TextLayerShapeCacheGlyph>& out) {
+    const Text::Script script = properties.script();
+    const Text::ShapeDirection direction = properties.shapeDirection();
+    const Containers::StringView language = properties.language();
+    if(!features.isEmpty() ||
+       (script != Text::Script::Unspecified && script != Text::Script::Latin) ||
+       (direction != Text::ShapeDirection::Unspecified && direction != Text::ShapeDirection::LeftToRight) ||
+       (!language.isEmpty() && language != "en"))
+        return false;
+    for(const char c: text)
+        if(c < ' ' || c > '~')
+            return false;
+
+    constexpr std::size_t CharacterCount = Implementation::TextLayerSimpleShapeCharacterCount;
+
+    /* Shape each character separately to get its glyph ID and advance. The
+       kerning for all pairs is unknown at first. */
+    if(fontState.simpleShapeGlyphs.isEmpty()) {
+        Text::AbstractShaper& shaper = fontShaper(fontState, properties);
+        fontState.simpleShapeGlyphs = Containers::Array<Implementation::TextLayerSimpleShapeGlyph>{NoInit, CharacterCount};
+        for(std::size_t i = 0; i != CharacterCount; ++i) {
+            const char character = ' ' + i;
+            Implementation::TextLayerSimpleShapeGlyph& glyph = fontState.simpleShapeGlyphs[i];
+            if(shaper.shape(Containers::StringView{&character, 1}) != 1) {
+                glyph.id = ~UnsignedInt{};
+                glyph.advance = 0.0f;
+                continue;
+            }
+
+            Vector2 offset, advance;
+            shaper.glyphOffsetsAdvancesInto(Containers::arrayView(&offset, 1), Containers::arrayView(&advance, 1));
+            shaper.glyphIdsInto(Containers::arrayView(&glyph.id, 1));
+            glyph.advance = advance.x();
+        }
+        fontState.simpleShapeKerning = Containers::Array<Float>{DirectInit, CharacterCount*CharacterCount, Constants::nan()};
+    }
+
+    /* Verify that all characters have a glyph and all adjacent pairs shape
+       to two glyphs, shaping the pairs that weren't encountered yet. Done
+       before producing any output so a failure doesn't leave anything in
+       `out`. */
+    for(std::size_t i = 0; i != text.size(); ++i) {
+        const std::size_t first = text[i] - ' ';
+        if(fontState.simpleShapeGlyphs[first].id == ~UnsignedInt{})
+            return false;
+        if(i + 1 == text.size())
+            break;
+
+        const std::size_t second = text[i + 1] - ' ';
+        Float& kerning = fontState.simpleShapeKerning[first*CharacterCount + second];
+        if(Math::isNan(kerning)) {
+            Text::AbstractShaper& shaper = fontShaper(fontState, properties);
+            kerning = Constants::inf();
+            if(shaper.shape(text.sliceSize(i, 2)) == 2) {
+                UnsignedInt ids[2];
+                Vector2 offsets[2];
+                Vector2 advances[2];
+                shaper.glyphIdsInto(ids);
+                shaper.glyphOffsetsAdvancesInto(offsets, advances);
+                /* Contextual alternates would make the pair use different
+                   glyphs than when shaped alone, treat that as unsupported
+                   as well */
+                if(ids[0] == fontState.simpleShapeGlyphs[first].id &&
+                   ids[1] == fontState.simpleShapeGlyphs[second].id)
+                    kerning = advances[0].x() - fontState.simpleShapeGlyphs[first].advance;
+            }
+        }
+        if(kerning == Constants::inf())
+            return false;
+    }
+
+    const Containers::ArrayView<Implementation::TextLayerShapeCacheGlyph> glyphs = arrayAppend(out, NoInit, text.size());
+    for(std::size_t i = 0; i != text.size(); ++i) {
+        const std::size_t first = text[i] - ' ';
+        const Implementation::TextLayerSimpleShapeGlyph& glyph = fontState.simpleShapeGlyphs[first];
+        Float advance = glyph.advance;
+        if(i + 1 != text.size())
+            advance += fontState.simpleShapeKerning[first*CharacterCount + text[i + 1] - ' '];
+        glyphs[i].offset = {};
+        glyphs[i].advance = {advance, 0.0f};
+        glyphs[i].id = glyph.id;
+    }
+
+    return true;
+}
+
+/* Whether given font has a glyph for given codepoint, querying the font only
+   the first time and remembering the result in the coverage bitmap */
+bool fontHasGlyph(Implementation::TextLayerFont& fontState, const char32_t codepoint) {
+    /* Invalid UTF-8 is decoded to a value that's outside of the Unicode
+       range, no font has a glyph for it */
+    if(codepoint >= 0x110000)
+        return false;
+
+    if(fontState.coverage.isEmpty())
+        fontState.coverage = Containers::Array<Containers::BitArray>{0x110000/Implementation::TextLayerFontCoverageBlockSize};
+    Containers::BitArray& block = fontState.coverage[codepoint/Implementation::TextLayerFontCoverageBlockSize];
+    if(block.isEmpty())
+        block = Containers::BitArray{ValueInit, Implementation::TextLayerFontCoverageBlockSize*2};
+
+    const std::size_t bit = (codepoint % Implementation::TextLayerFontCoverageBlockSize)*2;
+    if(!block[bit]) {
+        block.set(bit);
+        if(fontState.font->glyphId(codepoint))
+            block.set(bit + 1);
+    }
+    return block[bit + 1];
+}
+
+/* Splits a single line of text into runs of the same font, taking each
+   character from the font or, if it doesn't have a glyph for it, from the
+   first of its fallbacks that has. Spaces and ASCII punctuation stay in the
+   current run if its font has a glyph for them, so they don't cause extra
+   splits. Characters no font has a glyph for are put into the font itself.
+   Each run is a byte offset where it begins and a font handle, there's
+   always at least one run even for an empty text. */
+void fontRunsInto(const Containers::ArrayView<Implementation::TextLayerFont> fonts, const FontHandle font, const Containers::StringView text, Containers::Array<Containers::Pair<UnsignedInt, FontHandle>>& out) {
+    Implementation::TextLayerFont& fontState = fonts[fontHandleId(font)];
+    FontHandle current = FontHandle::Null;
+    for(std::size_t i = 0; i != text.size(); ) {
+        const Containers::Pair<char32_t, std::size_t> next = Utility::Unicode::nextChar(text, i);
+
+        const bool neutral = next.first() < 128 &&
+            !((next.first() >= '0' && next.first() <= '9') ||
+              (next.first() >= 'A' && next.first() <= 'Z') ||
+              (next.first() >= 'a' && next.first() <= 'z'));
+        FontHandle found = font;
+        if(neutral && current != FontHandle::Null && fontHasGlyph(fonts[fontHandleId(current)], next.first()))
+            found = current;
+        else if(!fontHasGlyph(fontState, next.first())) {
+            for(const FontHandle fallback: fontState.fallbacks) {
+                if(fontHasGlyph(fonts[fontHandleId(fallback)], next.first())) {
+                    found = fallback;
+                    break;
+                }
+            }
+        }
+
+        if(found != current) {
+            arrayAppend(out, InPlaceInit, UnsignedInt(i), found);
+            current = found;
+        }
+        i = next.second();
+    }
+
+    if(out.isEmpty())
+        arrayAppend(out, InPlaceInit, 0u, font);
+}
+
+/* Index of the smallest power of two that's at least glyphCount, with zero
+   glyphs treated as one */
+UnsignedInt glyphRunSizeClass(const UnsignedInt glyphCount) {
+    UnsignedInt sizeClass = 0;
+    while((1u << sizeClass) < glyphCount)
+        ++sizeClass;
+    return sizeClass;
+}
+
+}
+
+Range2D TextLayer::Shared::measureText(const UnsignedInt style, const Containers::StringView text, const TextProperties& properties) {
     State& state = static_cast<State&>(*_state);
-    Shared::State& sharedState = static_cast<Shared::State&>(state.shared);
+    CORRADE_ASSERT(state.setStyleCalled,
+        "Ui::TextLayer::Shared::measureText(): no style data was set", {});
+    CORRADE_ASSERT(style < state.styleCount,
+        "Ui::TextLayer::Shared::measureText(): style" << style << "out of range for" << state.styleCount << "styles", {});
 
-    /* The shapeRememberTextInternal() should originally have checked that the
-       font isn't null and has an instance, editShapeTextInternal() then just
-       passes what has been saved by shapeRememberTextInternal() */
-    Implementation::TextLayerFont& fontState = sharedState.fonts[fontHandleId(font)];
-    CORRADE_INTERNAL_ASSERT(font != FontHandle::Null && fontState.font);
+    /* Decide on a font and alignment, the same as in
+       shapeRememberTextInternal() and shapeTextInternal() but without dynamic
+       styles */
+    const Implementation::TextLayerStyle& styleData = state.styles[style];
+    FontHandle font = properties.font();
+    if(font == FontHandle::Null) {
+        CORRADE_ASSERT(styleData.font != FontHandle::Null,
+            "Ui::TextLayer::Shared::measureText(): style" << style << "has no font set and no custom font was supplied", {});
+        font = styleData.font;
+    } else CORRADE_ASSERT(Ui::isHandleValid(state.fonts, font),
+        "Ui::TextLayer::Shared::measureText(): invalid handle" << font, {});
+    Implementation::TextLayerFont& fontState = state.fonts[fontHandleId(font)];
+    CORRADE_ASSERT(fontState.font,
+        "Ui::TextLayer::Shared::measureText():" << font << "is an instance-less font", {});
+    const Text::Alignment alignment = properties.alignment() ?
+        *properties.alignment() : styleData.alignment;
+
+    /* Put together the features like textFeaturesInternal() does */
+    /** @todo some bump allocator for this, ugh */
+    const Containers::ArrayView<const TextFeatureValue> styleFeatures = state.styleFeatures.sliceSize(styleData.featureOffset, styleData.featureCount);
+    Containers::Array<Text::FeatureRange> features{NoInit, styleFeatures.size() + properties.features().size()};
+    for(std::size_t i = 0; i != styleFeatures.size(); ++i)
+        features[i] = styleFeatures[i];
+    Utility::copy(properties.features(), features.exceptPrefix(styleFeatures.size()));
 
-    /* Decide on alignment */
-    Text::Alignment alignment;
-    if(!properties.alignment()) {
-        if(style < sharedState.styleCount)
-            alignment = sharedState.styles[style].alignment;
+    /* Shape each line or look it up in the shape cache. A single-line text
+       uses the features as-is and thus matches the same cache entry as
+       create() would, for multi-line text or text with font fallbacks the
+       features get clipped to each run like in shapeTextInternal(). Only
+       offsets and advances are needed for the layout, glyph IDs aren't
+       queried at all. */
+    const bool hasFallbacks = !fontState.fallbacks.isEmpty();
+    const bool multiRun = hasFallbacks || !text.find('\n').isEmpty();
+    /** @todo some bump allocator for these */
+    Containers::Array<Text::FeatureRange> clippedFeatures;
+    Containers::Array<Containers::Pair<UnsignedInt, FontHandle>> fontRuns;
+    Containers::Array<Vector2> positions;
+    Containers::Array<Vector2> advances;
+    Containers::Array<Implementation::TextLayerShapeCacheGlyph> simpleGlyphs;
+    Range2D blockRectangle;
+    Text::ShapeDirection shapeDirection = Text::ShapeDirection::Unspecified;
+    /* Alignment can be resolved only after the first line is shaped, so the
+       lines are first laid out and remembered, then aligned */
+    Containers::Array<Containers::Pair<UnsignedInt, Range2D>> lines;
+    std::size_t lineBegin = 0;
+    for(;;) {
+        const Containers::StringView lineBreak = text.exceptPrefix(lineBegin).find('\n');
+        const std::size_t lineEnd = lineBreak.isEmpty() ? text.size() : lineBreak.data() - text.data();
+        const Containers::StringView line = text.slice(lineBegin, lineEnd);
+
+        /* Split the line into runs of the same font if the font has
+           fallbacks, same as in shapeTextInternal() */
+        arrayResize(fontRuns, 0);
+        if(hasFallbacks)
+            fontRunsInto(state.fonts, font, line, fontRuns);
         else
-            alignment = state.dynamicStyles[style - sharedState.styleCount].alignment;
-    } else
-        alignment = *properties.alignment();
+            arrayAppend(fontRuns, InPlaceInit, 0u, font);
+
+        const UnsignedInt lineGlyphOffset = positions.size();
+        for(std::size_t i = 0; i != fontRuns.size(); ++i) {
+            const std::size_t runBegin = lineBegin + fontRuns[i].first();
+            const std::size_t runEnd = i + 1 == fontRuns.size() ? lineEnd : lineBegin + fontRuns[i + 1].first();
+            const Containers::StringView run = text.slice(runBegin, runEnd);
+            const FontHandle runFont = fontRuns[i].second();
+            Implementation::TextLayerFont& runFontState = state.fonts[fontHandleId(runFont)];
+
+            Containers::ArrayView<const Text::FeatureRange> runFeatures = features;
+            if(multiRun) {
+                arrayResize(clippedFeatures, 0);
+                for(const Text::FeatureRange& feature: features) {
+                    const UnsignedInt begin = Math::max(feature.begin(), UnsignedInt(runBegin));
+                    const UnsignedInt end = Math::min(feature.end(), UnsignedInt(runEnd));
+                    if(begin < end)
+                        arrayAppend(clippedFeatures, InPlaceInit, feature.feature(), feature.value(), UnsignedInt(begin - runBegin), UnsignedInt(end - runBegin));
+                }
+                runFeatures = clippedFeatures;
+            }
+
+            /* Simple text is shaped the same way as in shapeTextInternal(),
+               bypassing the shape cache */
+            arrayResize(simpleGlyphs, 0);
+            const bool runSimpleShaped = state.simpleShaping && simpleShapeInto(runFontState, properties, runFeatures, run, simpleGlyphs);
+
+            Containers::Array<char> shapeCacheKey;
+            UnsignedLong shapeCacheHash{};
+            UnsignedInt shapeCacheEntry = ~UnsignedInt{};
+            if(!runSimpleShaped && state.shapeCacheSize) {
+                shapeCacheKeyInto(shapeCacheKey, runFont, properties, runFeatures, run);
+                shapeCacheHash = shapeCacheKeyHash(shapeCacheKey);
+                shapeCacheEntry = state.shapeCacheFind(shapeCacheKey, shapeCacheHash);
+            }
+
+            Text::ShapeDirection runDirection;
+            if(runSimpleShaped) {
+                const Containers::StridedArrayView1D<const Implementation::TextLayerShapeCacheGlyph> glyphs = stridedArrayView(simpleGlyphs);
+                Utility::copy(glyphs.slice(&Implementation::TextLayerShapeCacheGlyph::offset), arrayAppend(positions, NoInit, glyphs.size()));
+                Utility::copy(glyphs.slice(&Implementation::TextLayerShapeCacheGlyph::advance), arrayAppend(advances, NoInit, glyphs.size()));
+                runDirection = Text::ShapeDirection::LeftToRight;
+            } else if(shapeCacheEntry != ~UnsignedInt{}) {
+                const Implementation::TextLayerShapeCacheEntry& entry = state.shapeCache[shapeCacheEntry];
+                const Containers::StridedArrayView1D<const Implementation::TextLayerShapeCacheGlyph> glyphs = stridedArrayView(entry.glyphs);
+                const Containers::StridedArrayView1D<Vector2> runOffsets = arrayAppend(positions, NoInit, glyphs.size());
+                const Containers::StridedArrayView1D<Vector2> runAdvances = arrayAppend(advances, NoInit, glyphs.size());
+                Utility::copy(glyphs.slice(&Implementation::TextLayerShapeCacheGlyph::offset), runOffsets);
+                Utility::copy(glyphs.slice(&Implementation::TextLayerShapeCacheGlyph::advance), runAdvances);
+                runDirection = entry.direction;
+            } else {
+                Text::AbstractShaper& shaper = fontShaper(runFontState, properties);
+                const UnsignedInt glyphCount = shaper.shape(run, runFeatures);
+                const Containers::StridedArrayView1D<Vector2> runOffsets = arrayAppend(positions, NoInit, glyphCount);
+                const Containers::StridedArrayView1D<Vector2> runAdvances = arrayAppend(advances, NoInit, glyphCount);
+                shaper.glyphOffsetsAdvancesInto(runOffsets, runAdvances);
+                runDirection = shaper.direction();
+
+                /* Put the whole shaper output to the cache so a subsequent
+                   create() doesn't have to shape again */
+                if(state.shapeCacheSize) {
+                    shapeCacheEntry = state.shapeCacheAdd(Utility::move(shapeCacheKey), shapeCacheHash, glyphCount, runDirection);
+                    const Containers::StridedArrayView1D<Implementation::TextLayerShapeCacheGlyph> cachedGlyphs = stridedArrayView(state.shapeCache[shapeCacheEntry].glyphs);
+                    Utility::copy(runOffsets, cachedGlyphs.slice(&Implementation::TextLayerShapeCacheGlyph::offset));
+                    Utility::copy(runAdvances, cachedGlyphs.slice(&Implementation::TextLayerShapeCacheGlyph::advance));
+                    shaper.glyphIdsInto(cachedGlyphs.slice(&Implementation::TextLayerShapeCacheGlyph::id));
+                }
+            }
+
+            /* The direction of the first run of the first line decides the
+               alignment of the whole text */
+            if(lines.isEmpty() && i == 0)
+                shapeDirection = runDirection;
+        }
+
+        /* Lay out the line with the cursor moving down by the font line
+           height for each */
+        const Containers::ArrayView<Vector2> linePositions = positions.exceptPrefix(lineGlyphOffset);
+        Vector2 cursor{0.0f, -Float(lines.size())*fontState.scale*fontState.font->lineHeight()};
+        arrayAppend(lines, InPlaceInit, lineGlyphOffset, Text::renderLineGlyphPositionsInto(
+            *fontState.font,
+            fontState.scale*fontState.font->size(),
+            properties.layoutDirection(),
+            linePositions,
+            advances.exceptPrefix(lineGlyphOffset),
+            cursor,
+            linePositions));
+
+        if(lineEnd == text.size())
+            break;
+        lineBegin = lineEnd + 1;
+    }
+
+    /* Align each line and then the whole block */
+    const Text::Alignment resolvedAlignment = Text::alignmentForDirection(alignment,
+        properties.layoutDirection(),
+        shapeDirection);
+    for(std::size_t i = 0; i != lines.size(); ++i) {
+        const UnsignedInt lineGlyphEnd = i + 1 == lines.size() ? positions.size() : lines[i + 1].first();
+        blockRectangle = Math::join(blockRectangle, Text::alignRenderedLine(
+            lines[i].second(),
+            properties.layoutDirection(),
+            resolvedAlignment,
+            positions.slice(lines[i].first(), lineGlyphEnd)));
+    }
+    return Text::alignRenderedBlock(
+        blockRectangle,
+        properties.layoutDirection(),
+        resolvedAlignment,
+        positions);
+}
+
+UnsignedInt TextLayer::allocateGlyphRunInternal(const UnsignedInt id, const UnsignedInt previousGlyphRun, const UnsignedInt glyphCount) {
+    State& state = static_cast<State&>(*_state);
+    const Shared::State& sharedState = static_cast<const Shared::State&>(state.shared);
+
+    /* Without reuse, mark the previous run as unused, it'll be removed during
+       the next recompaction in doUpdate(). The new run goes at the end, which
+       makes the often-updated data clustered to the end of the buffer. */
+    if(!sharedState.glyphRunReuse) {
+        if(previousGlyphRun != ~UnsignedInt{})
+            state.glyphRuns[previousGlyphRun].glyphOffset = ~UnsignedInt{};
+        const UnsignedInt glyphRun = state.glyphRuns.size();
+        arrayAppend(state.glyphRuns, InPlaceInit, UnsignedInt(state.glyphData.size()), glyphCount, glyphCount, id, ~UnsignedInt{});
+        arrayAppend(state.glyphData, NoInit, glyphCount);
+        return glyphRun;
+    }
+
+    /* Otherwise, if the new glyphs fit into the previous run, reuse it in
+       place. If not, put it to the free list. */
+    if(previousGlyphRun != ~UnsignedInt{}) {
+        Implementation::TextLayerGlyphRun& run = state.glyphRuns[previousGlyphRun];
+        if(glyphCount <= run.glyphCapacity) {
+            run.glyphCount = glyphCount;
+            run.pendingGlyphIdFont = ~UnsignedInt{};
+            return previousGlyphRun;
+        }
+        freeGlyphRunInternal(previousGlyphRun);
+    }
+
+    /* Take a free run of the same capacity if there's any. Its position in
+       the run list isn't changed, so the runs stay ordered by offset. */
+    const UnsignedInt sizeClass = glyphRunSizeClass(glyphCount);
+    Containers::Array<UnsignedInt>& freeGlyphRuns = state.freeGlyphRuns[sizeClass];
+    if(!freeGlyphRuns.isEmpty()) {
+        const UnsignedInt glyphRun = freeGlyphRuns.back();
+        arrayRemoveSuffix(freeGlyphRuns);
+        Implementation::TextLayerGlyphRun& run = state.glyphRuns[glyphRun];
+        CORRADE_INTERNAL_DEBUG_ASSERT(run.data == ~UnsignedInt{} && run.glyphCapacity == 1u << sizeClass);
+        run.glyphCount = glyphCount;
+        run.data = id;
+        run.pendingGlyphIdFont = ~UnsignedInt{};
+        state.freeGlyphCount -= run.glyphCapacity;
+        return glyphRun;
+    }
+
+    /* Otherwise put a new run with a power-of-two capacity at the end */
+    const UnsignedInt glyphCapacity = 1u << sizeClass;
+    const UnsignedInt glyphRun = state.glyphRuns.size();
+    arrayAppend(state.glyphRuns, InPlaceInit, UnsignedInt(state.glyphData.size()), glyphCount, glyphCapacity, id, ~UnsignedInt{});
+    arrayAppend(state.glyphData, NoInit, glyphCapacity);
+    return glyphRun;
+}
+
+void TextLayer::freeGlyphRunInternal(const UnsignedInt glyphRun) {
+    State& state = static_cast<State&>(*_state);
+    const Shared::State& sharedState = static_cast<const Shared::State&>(state.shared);
+    Implementation::TextLayerGlyphRun& run = state.glyphRuns[glyphRun];
+
+    /* Without reuse, mark the run as unused. It'll be removed during the next
+       recompaction in doUpdate(). */
+    if(!sharedState.glyphRunReuse) {
+        run.glyphOffset = ~UnsignedInt{};
+        return;
+    }
+
+    /* Otherwise put it to a free list for given capacity. The glyph data stay
+       where they are until the next recompaction. */
+    CORRADE_INTERNAL_DEBUG_ASSERT(run.data != ~UnsignedInt{});
+    run.data = ~UnsignedInt{};
+    arrayAppend(state.freeGlyphRuns[glyphRunSizeClass(run.glyphCapacity)], glyphRun);
+    state.freeGlyphCount += run.glyphCapacity;
+}
+
+Containers::Array<Text::FeatureRange> TextLayer::textFeaturesInternal(const UnsignedInt style, const TextProperties& properties) const {
+    const State& state = static_cast<const State&>(*_state);
+    const Shared::State& sharedState = static_cast<const Shared::State&>(state.shared);
 
     /* Put together features from the style and TextProperties. Style goes
        first to make it possible to override it. */
@@ -881,43 +1874,266 @@ void TextLayer::shapeTextInternal(const UnsignedInt id, const UnsignedInt style,
     for(std::size_t i = 0; i != styleFeatures.size(); ++i)
         features[i] = styleFeatures[i];
     Utility::copy(properties.features(), features.exceptPrefix(styleFeatures.size()));
+    return features;
+}
+
+void TextLayer::shapeTextInternal(const UnsignedInt id, const UnsignedInt previousGlyphRun, const UnsignedInt style, const Containers::StringView text, const TextProperties& properties, const FontHandle font, const TextDataFlags flags, const Implementation::TextLayerDeferredShape* const shaped) {
+    State& state = static_cast<State&>(*_state);
+    Shared::State& sharedState = static_cast<Shared::State&>(state.shared);
+
+    /* The shapeRememberTextInternal() should originally have checked that the
+       font isn't null and has an instance, editShapeTextInternal() then just
+       passes what has been saved by shapeRememberTextInternal() */
+    Implementation::TextLayerFont& fontState = sharedState.fonts[fontHandleId(font)];
+    CORRADE_INTERNAL_ASSERT(font != FontHandle::Null && fontState.font);
+
+    /* Decide on alignment */
+    Text::Alignment alignment;
+    if(!properties.alignment()) {
+        if(style < sharedState.styleCount)
+            alignment = sharedState.styles[style].alignment;
+        else
+            alignment = state.dynamicStyles[style - sharedState.styleCount].alignment;
+    } else
+        alignment = *properties.alignment();
+
+    const Containers::Array<Text::FeatureRange> features = textFeaturesInternal(style, properties);
+
+    /* Non-editable text with line breaks is shaped line by line, with each
+       line looked up in the shape cache separately, so changing or appending
+       a single line of a long multi-line text reshapes just that line. Texts
+       shaped by a shape executor task are never multi-line, see
+       shapeDeferredInternal(). */
+    /** @todo editable multi-line text, which needs the cluster IDs offset
+        for each line */
+    const bool multiLine = !(flags >= TextDataFlag::Editable) && !text.find('\n').isEmpty();
+    /* Non-editable text using a font with fallbacks is split into runs of the
+       same font, which are then put together the same way as lines of a
+       multi-line text. Such text is never shaped by a shape executor task
+       either. */
+    /** @todo editable text with fallbacks, which needs the cluster IDs offset
+        for each run */
+    const bool hasFallbacks = !(flags >= TextDataFlag::Editable) && !fontState.fallbacks.isEmpty();
+    const bool multiRun = multiLine || hasFallbacks;
+    CORRADE_INTERNAL_DEBUG_ASSERT(!multiRun || !shaped);
+
+    /* If simple shaping is enabled, try it first. It's cheaper than even the
+       shape cache lookup, so such text isn't put into the cache. Text shaped
+       by a shape executor task has its glyphs already. */
+    /** @todo some bump allocator for this */
+    Containers::Array<Implementation::TextLayerShapeCacheGlyph> simpleGlyphs;
+    const bool simpleShaped = sharedState.simpleShaping && !multiRun && !shaped && simpleShapeInto(fontState, properties, features, text, simpleGlyphs);
+
+    /* If the shape cache is enabled, look the text up there. Editable text
+       isn't cached as it's assumed to change often and would only evict
+       other entries. */
+    const bool useShapeCache = !simpleShaped && sharedState.shapeCacheSize && !(flags >= TextDataFlag::Editable) && !multiRun;
+    Containers::Array<char> shapeCacheKey;
+    UnsignedLong shapeCacheHash{};
+    UnsignedInt shapeCacheEntry = ~UnsignedInt{};
+    if(useShapeCache) {
+        shapeCacheKeyInto(shapeCacheKey, font, properties, features, text);
+        shapeCacheHash = shapeCacheKeyHash(shapeCacheKey);
+        shapeCacheEntry = sharedState.shapeCacheFind(shapeCacheKey, shapeCacheHash);
+    }
+    const bool shapeCacheHit = shapeCacheEntry != ~UnsignedInt{};
 
     /** @todo once the TextProperties combine multiple fonts, scripts etc, this
         all should probably get wrapped in some higher level API in Text
         directly (AbstractLayouter?), which cuts the text to parts depending
         on font, script etc. and then puts all shaped runs together again? */
-    /* Get a shaper instance */
-    if(!fontState.shaper)
-        fontState.shaper = fontState.font->createShaper();
-    Text::AbstractShaper& shaper = *fontState.shaper;
+    /* Get a shaper instance and shape the text, unless it was found in the
+       cache or already shaped by a shape executor task */
+    Text::AbstractShaper* shaper = nullptr;
+    Containers::StridedArrayView1D<const Implementation::TextLayerShapeCacheGlyph> shapedGlyphs;
+    UnsignedInt glyphCount;
+    Text::ShapeDirection shapeDirection;
+    /* Used only for multi-line text or text with font fallbacks. Glyphs of
+       all lines and offsets where each line starts, with the last item being
+       the total glyph count. The glyphs are copied out of the shape cache as
+       shaping a later run may evict an entry used by an earlier run. */
+    /** @todo some bump allocator for these */
+    Containers::Array<Implementation::TextLayerShapeCacheGlyph> lineGlyphs;
+    Containers::Array<UnsignedInt> lineGlyphOffsets;
+    /* Used only for text with font fallbacks. Font IDs for ranges of
+       glyphs, with the first being offset where the range ends. */
+    /** @todo some bump allocator for this */
+    Containers::Array<Containers::Pair<UnsignedInt, UnsignedInt>> glyphFonts;
+    if(multiRun) {
+        Containers::Array<Text::FeatureRange> runFeatures;
+        Containers::Array<Containers::Pair<UnsignedInt, FontHandle>> fontRuns;
+        arrayAppend(lineGlyphOffsets, 0u);
+        std::size_t lineBegin = 0;
+        for(;;) {
+            const Containers::StringView lineBreak = text.exceptPrefix(lineBegin).find('\n');
+            const std::size_t lineEnd = lineBreak.isEmpty() ? text.size() : lineBreak.data() - text.data();
+
+            /* Split the line into runs of the same font if the font has
+               fallbacks, otherwise the whole line is a single run */
+            arrayResize(fontRuns, 0);
+            if(hasFallbacks)
+                fontRunsInto(sharedState.fonts, font, text.slice(lineBegin, lineEnd), fontRuns);
+            else
+                arrayAppend(fontRuns, InPlaceInit, 0u, font);
+
+            for(std::size_t i = 0; i != fontRuns.size(); ++i) {
+                const std::size_t runBegin = lineBegin + fontRuns[i].first();
+                const std::size_t runEnd = i + 1 == fontRuns.size() ? lineEnd : lineBegin + fontRuns[i + 1].first();
+                const Containers::StringView run = text.slice(runBegin, runEnd);
+                const FontHandle runFont = fontRuns[i].second();
+                Implementation::TextLayerFont& runFontState = sharedState.fonts[fontHandleId(runFont)];
+
+                /* Clip the feature ranges to the run and make them relative
+                   to it, so the same line with the same features matches the
+                   same cache entry wherever it is in the text */
+                arrayResize(runFeatures, 0);
+                for(const Text::FeatureRange& feature: features) {
+                    const UnsignedInt begin = Math::max(feature.begin(), UnsignedInt(runBegin));
+                    const UnsignedInt end = Math::min(feature.end(), UnsignedInt(runEnd));
+                    if(begin < end)
+                        arrayAppend(runFeatures, InPlaceInit, feature.feature(), feature.value(), UnsignedInt(begin - runBegin), UnsignedInt(end - runBegin));
+                }
+
+                /* Simple runs bypass the shape cache, same as single-line
+                   text */
+                const bool runSimpleShaped = sharedState.simpleShaping && simpleShapeInto(runFontState, properties, runFeatures, run, lineGlyphs);
+
+                Containers::Array<char> runShapeCacheKey;
+                UnsignedLong runShapeCacheHash{};
+                UnsignedInt runShapeCacheEntry = ~UnsignedInt{};
+                if(!runSimpleShaped && sharedState.shapeCacheSize) {
+                    shapeCacheKeyInto(runShapeCacheKey, runFont, properties, runFeatures, run);
+                    runShapeCacheHash = shapeCacheKeyHash(runShapeCacheKey);
+                    runShapeCacheEntry = sharedState.shapeCacheFind(runShapeCacheKey, runShapeCacheHash);
+                }
 
-    /* Shape the text */
-    shaper.setScript(properties.script());
-    shaper.setLanguage(properties.language());
-    shaper.setDirection(properties.shapeDirection());
-    const UnsignedInt glyphCount = shaper.shape(text, features);
+                const UnsignedInt runGlyphOffset = lineGlyphs.size();
+                Text::ShapeDirection runDirection;
+                if(runSimpleShaped) {
+                    runDirection = Text::ShapeDirection::LeftToRight;
+                } else if(runShapeCacheEntry != ~UnsignedInt{}) {
+                    const Implementation::TextLayerShapeCacheEntry& entry = sharedState.shapeCache[runShapeCacheEntry];
+                    arrayAppend(lineGlyphs, entry.glyphs);
+                    runDirection = entry.direction;
+                } else {
+                    Text::AbstractShaper& runShaper = fontShaper(runFontState, properties);
+                    const UnsignedInt runGlyphCount = runShaper.shape(run, runFeatures);
+                    const Containers::StridedArrayView1D<Implementation::TextLayerShapeCacheGlyph> shapedRunGlyphs = stridedArrayView(arrayAppend(lineGlyphs, NoInit, runGlyphCount));
+                    runShaper.glyphOffsetsAdvancesInto(
+                        shapedRunGlyphs.slice(&Implementation::TextLayerShapeCacheGlyph::offset),
+                        shapedRunGlyphs.slice(&Implementation::TextLayerShapeCacheGlyph::advance));
+                    runShaper.glyphIdsInto(shapedRunGlyphs.slice(&Implementation::TextLayerShapeCacheGlyph::id));
+                    runDirection = runShaper.direction();
+
+                    if(sharedState.shapeCacheSize) {
+                        runShapeCacheEntry = sharedState.shapeCacheAdd(Utility::move(runShapeCacheKey), runShapeCacheHash, runGlyphCount, runDirection);
+                        Utility::copy(shapedRunGlyphs, stridedArrayView(sharedState.shapeCache[runShapeCacheEntry].glyphs));
+                    }
+                }
+
+                /* The direction of the first run of the first line decides
+                   the alignment of the whole text */
+                if(lineGlyphOffsets.size() == 1 && i == 0)
+                    shapeDirection = runDirection;
+
+                /* Remember the font of the glyphs, extending the previous
+                   range if it's the same font */
+                if(hasFallbacks && runGlyphOffset != lineGlyphs.size()) {
+                    if(!glyphFonts.isEmpty() && glyphFonts.back().second() == fontHandleId(runFont))
+                        glyphFonts.back().first() = lineGlyphs.size();
+                    else
+                        arrayAppend(glyphFonts, InPlaceInit, UnsignedInt(lineGlyphs.size()), fontHandleId(runFont));
+                }
+            }
+
+            arrayAppend(lineGlyphOffsets, UnsignedInt(lineGlyphs.size()));
+
+            if(lineEnd == text.size())
+                break;
+            lineBegin = lineEnd + 1;
+        }
+
+        shapedGlyphs = stridedArrayView(lineGlyphs);
+        glyphCount = lineGlyphs.size();
+    } else if(simpleShaped) {
+        shapedGlyphs = stridedArrayView(simpleGlyphs);
+        glyphCount = simpleGlyphs.size();
+        shapeDirection = Text::ShapeDirection::LeftToRight;
+    } else if(shapeCacheHit) {
+        const Implementation::TextLayerShapeCacheEntry& entry = sharedState.shapeCache[shapeCacheEntry];
+        shapedGlyphs = stridedArrayView(entry.glyphs);
+        glyphCount = entry.glyphs.size();
+        shapeDirection = entry.direction;
+    } else if(shaped) {
+        CORRADE_INTERNAL_DEBUG_ASSERT(shaped->shaped);
+        shapedGlyphs = stridedArrayView(shaped->glyphs);
+        glyphCount = shaped->glyphs.size();
+        shapeDirection = shaped->shapedDirection;
+    } else {
+        shaper = &fontShaper(fontState, properties);
+        glyphCount = shaper->shape(text, features);
+        shapeDirection = shaper->direction();
+    }
 
     /* Resolve the alignment based on direction */
     const Text::Alignment resolvedAlignment = Text::alignmentForDirection(alignment,
         properties.layoutDirection(),
-        shaper.direction());
+        shapeDirection);
 
-    /* Add a new glyph run. Any previous run for this data was marked as unused
-       in previous remove() or in setText() right before calling this
-       function. */
-    const UnsignedInt glyphRun = state.glyphRuns.size();
-    const UnsignedInt glyphOffset = state.glyphData.size();
-    const Containers::StridedArrayView1D<Implementation::TextLayerGlyphData> glyphData = arrayAppend(state.glyphData, NoInit, glyphCount);
-    arrayAppend(state.glyphRuns, InPlaceInit, glyphOffset, glyphCount, id);
+    /* Allocate a glyph run, replacing the previous one, if any */
+    const UnsignedInt glyphRun = allocateGlyphRunInternal(id, previousGlyphRun, glyphCount);
+    const Containers::StridedArrayView1D<Implementation::TextLayerGlyphData> glyphData = state.glyphData.sliceSize(state.glyphRuns[glyphRun].glyphOffset, glyphCount);
 
     /* Query glyph offsets and advances, abuse the glyphData fields for those;
        then convert those in-place to absolute glyph positions and align
        them */
     const Containers::StridedArrayView1D<Vector2> glyphOffsetsPositions = glyphData.slice(&Implementation::TextLayerGlyphData::position);
     const Containers::StridedArrayView1D<Vector2> glyphAdvances = Containers::arrayCast<Vector2>(glyphData.slice(&Implementation::TextLayerGlyphData::glyphId));
-    shaper.glyphOffsetsAdvancesInto(glyphOffsetsPositions, glyphAdvances);
+    if(shaper)
+        shaper->glyphOffsetsAdvancesInto(glyphOffsetsPositions, glyphAdvances);
+    else {
+        Utility::copy(shapedGlyphs.slice(&Implementation::TextLayerShapeCacheGlyph::offset), glyphOffsetsPositions);
+        Utility::copy(shapedGlyphs.slice(&Implementation::TextLayerShapeCacheGlyph::advance), glyphAdvances);
+    }
+
+    /* If the text wasn't in the cache, remember the offsets and advances
+       before they get converted to positions, the glyph IDs are saved
+       below */
+    if(useShapeCache && !shapeCacheHit) {
+        shapeCacheEntry = sharedState.shapeCacheAdd(Utility::move(shapeCacheKey), shapeCacheHash, glyphCount, shapeDirection);
+        const Containers::StridedArrayView1D<Implementation::TextLayerShapeCacheGlyph> cachedGlyphs = stridedArrayView(sharedState.shapeCache[shapeCacheEntry].glyphs);
+        Utility::copy(glyphOffsetsPositions, cachedGlyphs.slice(&Implementation::TextLayerShapeCacheGlyph::offset));
+        Utility::copy(glyphAdvances, cachedGlyphs.slice(&Implementation::TextLayerShapeCacheGlyph::advance));
+    }
     Range2D rectangle{NoInit};
-    {
+    if(multiRun) {
+        /* Lay out each line separately, with the cursor moving down by the
+           font line height for each, and then align them all as a block */
+        const Float lineAdvance = fontState.scale*fontState.font->lineHeight();
+        Range2D blockRectangle;
+        for(std::size_t i = 0; i + 1 < lineGlyphOffsets.size(); ++i) {
+            const Containers::StridedArrayView1D<Vector2> lineGlyphOffsetsPositions = glyphOffsetsPositions.slice(lineGlyphOffsets[i], lineGlyphOffsets[i + 1]);
+            Vector2 cursor{0.0f, -Float(i)*lineAdvance};
+            const Range2D lineRectangle = Text::renderLineGlyphPositionsInto(
+                *fontState.font,
+                fontState.scale*fontState.font->size(),
+                properties.layoutDirection(),
+                lineGlyphOffsetsPositions,
+                glyphAdvances.slice(lineGlyphOffsets[i], lineGlyphOffsets[i + 1]),
+                cursor,
+                lineGlyphOffsetsPositions);
+            blockRectangle = Math::join(blockRectangle, Text::alignRenderedLine(
+                lineRectangle,
+                properties.layoutDirection(),
+                resolvedAlignment,
+                lineGlyphOffsetsPositions));
+        }
+        rectangle = Text::alignRenderedBlock(
+            blockRectangle,
+            properties.layoutDirection(),
+            resolvedAlignment,
+            glyphOffsetsPositions);
+    } else {
         Vector2 cursor;
         const Range2D lineRectangle = Text::renderLineGlyphPositionsInto(
             *fontState.font,
@@ -945,11 +2161,62 @@ void TextLayer::shapeTextInternal(const UnsignedInt id, const UnsignedInt style,
     const Text::AbstractGlyphCache* const glyphCache = sharedState.glyphCache;
     CORRADE_INTERNAL_ASSERT(glyphCache);
 
-    /* Query font-specific glyph IDs and convert them to cache-global */
-    shaper.glyphIdsInto(glyphData.slice(&Implementation::TextLayerGlyphData::glyphId));
-    {
-        for(Implementation::TextLayerGlyphData& glyph: glyphData)
-            glyph.glyphId = glyphCache->glyphId(fontState.glyphCacheFontId, glyph.glyphId);
+    /* Query font-specific glyph IDs, or fetch them from the shape cache or
+       the deferred shape output, and convert them to cache-global */
+    const Containers::StridedArrayView1D<UnsignedInt> glyphIds = glyphData.slice(&Implementation::TextLayerGlyphData::glyphId);
+    if(shaper)
+        shaper->glyphIdsInto(glyphIds);
+    else
+        Utility::copy(shapedGlyphs.slice(&Implementation::TextLayerShapeCacheGlyph::id), glyphIds);
+    if(useShapeCache && !shapeCacheHit)
+        Utility::copy(glyphIds, stridedArrayView(sharedState.shapeCache[shapeCacheEntry].glyphs).slice(&Implementation::TextLayerShapeCacheGlyph::id));
+
+    /* If filling the glyph cache on demand, remember glyphs that aren't in
+       the cache yet. The font-specific glyph 0 is the invalid glyph, which
+       isn't expected to be in the cache. The run then keeps the
+       font-specific IDs until the glyphs are added and the IDs converted in
+       the next doUpdate(), which allows all missing glyphs to be added in a
+       single batch. */
+    /* Text that isn't using font fallbacks is all a single font */
+    const Containers::Pair<UnsignedInt, UnsignedInt> singleGlyphFont{glyphCount, fontHandleId(font)};
+    const Containers::ArrayView<const Containers::Pair<UnsignedInt, UnsignedInt>> glyphFontRanges = glyphFonts.isEmpty() ?
+        Containers::arrayView(&singleGlyphFont, 1) : Containers::arrayView(glyphFonts);
+    bool missingGlyphs = false;
+    if(sharedState.onDemandGlyphCacheFilling) {
+        UnsignedInt rangeBegin = 0;
+        for(const Containers::Pair<UnsignedInt, UnsignedInt>& range: glyphFontRanges) {
+            const UnsignedInt rangeGlyphCacheFontId = sharedState.fonts[range.second()].glyphCacheFontId;
+            for(const UnsignedInt glyphId: glyphIds.slice(rangeBegin, range.first())) {
+                if(glyphId && !glyphCache->glyphId(rangeGlyphCacheFontId, glyphId)) {
+                    arrayAppend(sharedState.missingGlyphs, InPlaceInit, range.second(), glyphId);
+                    missingGlyphs = true;
+                }
+            }
+            rangeBegin = range.first();
+        }
+    }
+    if(missingGlyphs) {
+        /* If there's more than one font, remember the font of each glyph */
+        if(glyphFontRanges.size() == 1)
+            state.glyphRuns[glyphRun].pendingGlyphIdFont = glyphFontRanges[0].second();
+        else {
+            state.glyphRuns[glyphRun].pendingGlyphIdFont = Implementation::TextLayerGlyphRunPendingGlyphIdFontPerGlyph;
+            UnsignedInt rangeBegin = 0;
+            for(const Containers::Pair<UnsignedInt, UnsignedInt>& range: glyphFontRanges) {
+                for(Implementation::TextLayerGlyphData& glyph: glyphData.slice(rangeBegin, range.first()))
+                    glyph.glyphCluster = range.second();
+                rangeBegin = range.first();
+            }
+        }
+        arrayAppend(state.glyphRunsWithPendingGlyphIds, glyphRun);
+    } else {
+        UnsignedInt rangeBegin = 0;
+        for(const Containers::Pair<UnsignedInt, UnsignedInt>& range: glyphFontRanges) {
+            const UnsignedInt rangeGlyphCacheFontId = sharedState.fonts[range.second()].glyphCacheFontId;
+            for(Implementation::TextLayerGlyphData& glyph: glyphData.slice(rangeBegin, range.first()))
+                glyph.glyphId = glyphCache->glyphId(rangeGlyphCacheFontId, glyph.glyphId);
+            rangeBegin = range.first();
+        }
     }
 
     /* Save scale, size, direction-resolved alignment and the glyph run
@@ -965,8 +2232,15 @@ void TextLayer::shapeTextInternal(const UnsignedInt id, const UnsignedInt style,
        member documentation for details why they're stored here and not in
        dedicated edit-only structures. */
     if(flags >= TextDataFlag::Editable) {
-        data.usedDirection = shaper.direction();
-        shaper.glyphClustersInto(glyphData.slice(&Implementation::TextLayerGlyphData::glyphCluster));
+        /* Editable text never goes through the shape cache. If it went
+           through the simple shaping path, each glyph corresponds to exactly
+           one byte of the text. */
+        CORRADE_INTERNAL_DEBUG_ASSERT(shaper || simpleShaped);
+        data.usedDirection = shapeDirection;
+        if(shaper)
+            shaper->glyphClustersInto(glyphData.slice(&Implementation::TextLayerGlyphData::glyphCluster));
+        else for(std::size_t i = 0; i != glyphCount; ++i)
+            glyphData[i].glyphCluster = i;
 
     /* If the text is not editable, reset the direction to prevent other code
        accidentally relying on some random value. The clusters aren't reset
@@ -978,7 +2252,7 @@ void TextLayer::shapeRememberTextInternal(
     #ifndef CORRADE_NO_ASSERT
     const char* const messagePrefix,
     #endif
-    const UnsignedInt id, const UnsignedInt style, const Containers::StringView text, const TextProperties& properties, const TextDataFlags flags)
+    const UnsignedInt id, const UnsignedInt previousGlyphRun, const UnsignedInt style, const Containers::StringView text, const TextProperties& properties, const TextDataFlags flags)
 {
     State& state = static_cast<State&>(*_state);
     Shared::State& sharedState = static_cast<Shared::State&>(state.shared);
@@ -1002,9 +2276,70 @@ void TextLayer::shapeRememberTextInternal(
     CORRADE_ASSERT(sharedState.fonts[fontHandleId(font)].font,
         messagePrefix << font << "is an instance-less font", );
 
-    shapeTextInternal(id, style, text, properties, font, flags);
-
     Implementation::TextLayerData& data = state.data[id];
+
+    /* If the text is sized to content now or was before, the node size has to
+       be recalculated. For newly created data the flags aren't initialized
+       yet, which is signalized by the previous glyph run not being set. */
+    if(flags >= TextDataFlag::SizeToContent || (previousGlyphRun != ~UnsignedInt{} && data.flags >= TextDataFlag::SizeToContent))
+        setNeedsUpdate(LayerState::NeedsIntrinsicSizeUpdate);
+
+    /* If the text is hibernatable, remember the input for reshaping after
+       hibernate(), with the font again saved already resolved. Any previous
+       source for this data was marked as unused in previous remove() or in
+       setText() before calling this function. */
+    if(flags >= TextDataFlag::Hibernatable) {
+        CORRADE_ASSERT(!(flags >= TextDataFlag::Editable),
+            messagePrefix << "hibernation of an editable text is not implemented yet, sorry", );
+
+        data.hibernationSource = state.hibernationSources.size();
+        Implementation::TextLayerHibernationSource& source = arrayAppend(state.hibernationSources, InPlaceInit);
+        source.data = id;
+        source.style = style;
+        source.textOffset = state.hibernationSourceTextData.size();
+        source.textSize = text.size();
+        arrayAppend(state.hibernationSourceTextData, text);
+        source.featureOffset = state.hibernationSourceFeatures.size();
+        source.featureCount = properties.features().size();
+        arrayAppend(state.hibernationSourceFeatures, properties.features());
+        Utility::copy(properties._language, source.language);
+        source.script = properties._script;
+        source.font = font;
+        source.alignment = properties._alignment;
+        source.direction = properties._direction;
+        source.hibernated = false;
+    } else data.hibernationSource = ~UnsignedInt{};
+
+    /* If shaping is deferred, only remember the input for doUpdate(). The
+       font is saved already resolved to not need to do the above again. */
+    if(flags >= TextDataFlag::DeferredShaping) {
+        CORRADE_ASSERT(!(flags >= TextDataFlag::Editable),
+            messagePrefix << "deferred shaping of an editable text is not implemented yet, sorry", );
+
+        data.deferredShape = state.deferredShapes.size();
+        Implementation::TextLayerDeferredShape& deferred = arrayAppend(state.deferredShapes, InPlaceInit);
+        deferred.data = id;
+        deferred.style = style;
+        deferred.textOffset = state.deferredShapeTextData.size();
+        deferred.textSize = text.size();
+        arrayAppend(state.deferredShapeTextData, text);
+        deferred.featureOffset = state.deferredShapeFeatures.size();
+        deferred.featureCount = properties.features().size();
+        arrayAppend(state.deferredShapeFeatures, properties.features());
+        Utility::copy(properties._language, deferred.language);
+        deferred.script = properties._script;
+        deferred.font = font;
+        deferred.alignment = properties._alignment;
+        deferred.direction = properties._direction;
+        deferred.shaped = false;
+
+        data.flags = flags;
+        data.textRun = ~UnsignedInt{};
+        return;
+    }
+
+    shapeTextInternal(id, previousGlyphRun, style, text, properties, font, flags);
+    data.deferredShape = ~UnsignedInt{};
     data.flags = flags;
 
     /* If the text is meant to be editable, remember the input string */
@@ -1021,10 +2356,16 @@ void TextLayer::shapeRememberTextInternal(
            function. */
         const UnsignedInt textRun = state.textRuns.size();
         const UnsignedInt textOffset = state.textData.size();
+        /* With reuse, the capacity is rounded up to a power of two like with
+           glyph runs, so subsequent edits can be done in place */
+        const UnsignedInt textCapacity = sharedState.glyphRunReuse ?
+            1u << glyphRunSizeClass(text.size()) : text.size();
         arrayAppend(state.textData, text);
+        arrayAppend(state.textData, NoInit, textCapacity - text.size());
         Implementation::TextLayerTextRun& run = arrayAppend(state.textRuns, NoInit, 1).front();
         run.textOffset = textOffset;
         run.textSize = text.size();
+        run.textCapacity = textCapacity;
         run.data = id;
         run.cursor = run.selection = text.size();
 
@@ -1050,7 +2391,7 @@ void TextLayer::shapeGlyphInternal(
     #ifndef CORRADE_NO_ASSERT
     const char* const messagePrefix,
     #endif
-    const UnsignedInt id, const UnsignedInt style, const UnsignedInt glyphId, const TextProperties& properties)
+    const UnsignedInt id, const UnsignedInt previousGlyphRun, const UnsignedInt style, const UnsignedInt glyphId, const TextProperties& properties)
 {
     State& state = static_cast<State&>(*_state);
     Shared::State& sharedState = static_cast<Shared::State&>(state.shared);
@@ -1121,24 +2462,325 @@ void TextLayer::shapeGlyphInternal(
             glyphPosition);
     }
 
-    /* Add a new run containing just that one glyph. Any previous run for this
-       data was marked as unused in previous remove(), or in setGlyph() right
-       before calling this function. */
-    const UnsignedInt glyphRun = state.glyphRuns.size();
-    const UnsignedInt glyphOffset = state.glyphData.size();
-    arrayAppend(state.glyphData, InPlaceInit,
-        *glyphPosition, cacheGlobalGlyphId, 0u /* (Unused) cluster ID */);
-    arrayAppend(state.glyphRuns, InPlaceInit, glyphOffset, 1u, id);
+    /* Allocate a run containing just that one glyph, replacing the previous
+       one, if any */
+    const UnsignedInt glyphRun = allocateGlyphRunInternal(id, previousGlyphRun, 1);
+    Implementation::TextLayerGlyphData& glyphData = state.glyphData[state.glyphRuns[glyphRun].glyphOffset];
+    glyphData.position = *glyphPosition;
+    glyphData.glyphId = cacheGlobalGlyphId;
+    glyphData.glyphCluster = 0u; /* (Unused) cluster ID */
+
+    /* Save scale, size, direction-resolved alignment and the glyph run
+       reference for use in doUpdate() later */
+    Implementation::TextLayerData& data = state.data[id];
+    data.scale = fontState.scale;
+    data.rectangle = rectangle;
+    data.alignment = resolvedAlignment;
+    data.glyphRun = glyphRun;
+    data.textRun = ~UnsignedInt{};
+    data.deferredShape = ~UnsignedInt{};
+    data.hibernationSource = ~UnsignedInt{};
+    data.flags = {};
+}
+
+TextProperties TextLayer::deferredShapePropertiesInternal(const Implementation::TextLayerDeferredShape& deferred) const {
+    const State& state = static_cast<const State&>(*_state);
+
+    TextProperties properties{NoInit};
+    Utility::copy(deferred.language, properties._language);
+    properties._script = deferred.script;
+    properties._font = deferred.font;
+    properties._alignment = deferred.alignment;
+    properties._direction = deferred.direction;
+    if(deferred.featureCount)
+        properties.setFeatures(state.deferredShapeFeatures.sliceSize(deferred.featureOffset, deferred.featureCount));
+    return properties;
+}
+
+TextProperties TextLayer::hibernationSourcePropertiesInternal(const Implementation::TextLayerHibernationSource& source) const {
+    const State& state = static_cast<const State&>(*_state);
+
+    TextProperties properties{NoInit};
+    Utility::copy(source.language, properties._language);
+    properties._script = source.script;
+    properties._font = source.font;
+    properties._alignment = source.alignment;
+    properties._direction = source.direction;
+    if(source.featureCount)
+        properties.setFeatures(state.hibernationSourceFeatures.sliceSize(source.featureOffset, source.featureCount));
+    return properties;
+}
+
+void TextLayer::freeHibernationSourceInternal(const UnsignedInt id) {
+    State& state = static_cast<State&>(*_state);
+    const UnsignedInt sourceId = state.data[id].hibernationSource;
+    if(sourceId == ~UnsignedInt{})
+        return;
+
+    Implementation::TextLayerHibernationSource& source = state.hibernationSources[sourceId];
+    if(source.hibernated)
+        --state.hibernatedCount;
+    source.data = ~UnsignedInt{};
+}
+
+/* Reshapes hibernated texts among given visible data, returns whether there
+   was any */
+bool TextLayer::wakeHibernatedInternal(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds) {
+    State& state = static_cast<State&>(*_state);
+
+    bool woken = false;
+    for(const UnsignedInt id: dataIds) {
+        Implementation::TextLayerData& data = state.data[id];
+        if(data.hibernationSource == ~UnsignedInt{})
+            continue;
+
+        Implementation::TextLayerHibernationSource& source = state.hibernationSources[data.hibernationSource];
+        if(!source.hibernated)
+            continue;
+
+        /* The rectangle stays the same as before hibernation, so there's no
+           need to recalculate the node size even if it's sized to content */
+        shapeTextInternal(id, data.glyphRun, source.style,
+            state.hibernationSourceTextData.sliceSize(source.textOffset, source.textSize),
+            hibernationSourcePropertiesInternal(source),
+            source.font, data.flags);
+        source.hibernated = false;
+        --state.hibernatedCount;
+        woken = true;
+    }
+
+    return woken;
+}
+
+/* Adds glyphs collected in Shared::State::missingGlyphs to the glyph cache,
+   with a single fillGlyphCache() call for each font, and clears the list.
+   Duplicates and glyphs that got added to the cache in the meantime are
+   skipped. If the font fails to fill the cache, the glyphs stay missing and
+   get rendered as the invalid glyph. */
+void TextLayer::fillMissingGlyphsInternal() {
+    Shared::State& sharedState = static_cast<Shared::State&>(static_cast<State&>(*_state).shared);
+    Text::AbstractGlyphCache& glyphCache = *sharedState.glyphCache;
+    Containers::Array<UnsignedInt> glyphs;
+    /* There's usually just one or a few fonts, so simply go through the list
+       once for each, keeping only glyphs for other fonts in it */
+    while(!sharedState.missingGlyphs.isEmpty()) {
+        const UnsignedInt font = sharedState.missingGlyphs.front().first();
+        const Implementation::TextLayerFont& fontState = sharedState.fonts[font];
+        Containers::BitArray added{ValueInit, glyphCache.fontGlyphCount(fontState.glyphCacheFontId)};
+        arrayResize(glyphs, 0);
+        std::size_t outputOffset = 0;
+        for(std::size_t i = 0; i != sharedState.missingGlyphs.size(); ++i) {
+            const Containers::Pair<UnsignedInt, UnsignedInt> glyph = sharedState.missingGlyphs[i];
+            if(glyph.first() != font) {
+                sharedState.missingGlyphs[outputOffset++] = glyph;
+                continue;
+            }
+            if(added[glyph.second()] || glyphCache.glyphId(fontState.glyphCacheFontId, glyph.second()))
+                continue;
+            added.set(glyph.second());
+            arrayAppend(glyphs, glyph.second());
+        }
+        arrayResize(sharedState.missingGlyphs, outputOffset);
+
+        /** @todo propagate the failure somehow? the font prints a message
+            on its own already */
+        if(!glyphs.isEmpty())
+            fontState.font->fillGlyphCache(glyphCache, Containers::stridedArrayView(glyphs));
+    }
+}
+
+void TextLayer::shapeDeferredInternal() {
+    State& state = static_cast<State&>(*_state);
+    Shared::State& sharedState = static_cast<Shared::State&>(state.shared);
+
+    /* If there's a budget, process only deferred shapes up to the one that
+       exhausts it. Entries whose data were removed or had the text set again
+       don't count towards it. */
+    std::size_t end = state.deferredShapes.size();
+    if(state.deferredShapeBudget) {
+        UnsignedInt count = 0;
+        for(std::size_t i = 0; i != state.deferredShapes.size(); ++i) {
+            if(state.deferredShapes[i].data == ~UnsignedInt{})
+                continue;
+            if(++count == state.deferredShapeBudget) {
+                end = i + 1;
+                break;
+            }
+        }
+    }
+
+    /* If there's an executor, first shape all texts that aren't in the shape
+       cache in parallel, each with its own shaper instance. Putting the
+       glyphs together, aligning them and updating the shape cache is then
+       done sequentially below. */
+    if(state.shapeExecutor) {
+        /** @todo some bump allocator for this */
+        Containers::Array<UnsignedInt> tasks;
+        arrayReserve(tasks, end);
+        for(std::size_t i = 0; i != end; ++i) {
+            const Implementation::TextLayerDeferredShape& deferred = state.deferredShapes[i];
+            if(deferred.data == ~UnsignedInt{})
+                continue;
+
+            /* Multi-line texts are shaped line by line in shapeTextInternal()
+               to make use of the shape cache for each line */
+            if(!state.deferredShapeTextData.sliceSize(deferred.textOffset, deferred.textSize).find('\n').isEmpty())
+                continue;
+
+            /* Same for texts using a font with fallbacks, which get split
+               into runs of the same font there */
+            if(!sharedState.fonts[fontHandleId(deferred.font)].fallbacks.isEmpty())
+                continue;
+
+            /* Texts that are in the cache don't need to be shaped. If they get
+               evicted by the time they're processed below, they get shaped
+               in shapeTextInternal() directly instead. */
+            if(sharedState.shapeCacheSize) {
+                const TextProperties properties = deferredShapePropertiesInternal(deferred);
+                Containers::Array<char> key;
+                shapeCacheKeyInto(key, deferred.font, properties, textFeaturesInternal(deferred.style, properties), state.deferredShapeTextData.sliceSize(deferred.textOffset, deferred.textSize));
+                if(sharedState.shapeCacheFind(key, shapeCacheKeyHash(key)) != ~UnsignedInt{})
+                    continue;
+            }
+
+            arrayAppend(tasks, i);
+        }
+
+        /* Shaping a single text in parallel makes no sense, it's done in
+           shapeTextInternal() below instead */
+        if(tasks.size() > 1) {
+            /* Ensure there's a shaper for every task, created for the font
+               the text is using. Shaper instances are created here
+               instead of in the tasks to not require the font plugins to
+               support concurrent shaper creation. */
+            if(state.deferredShapers.size() < tasks.size())
+                arrayResize(state.deferredShapers, tasks.size());
+            for(std::size_t i = 0; i != tasks.size(); ++i) {
+                Text::AbstractFont& font = *sharedState.fonts[fontHandleId(state.deferredShapes[tasks[i]].font)].font;
+                Containers::Pointer<Text::AbstractShaper>& shaper = state.deferredShapers[i];
+                if(!shaper || &shaper->font() != &font)
+                    shaper = font.createShaper();
+            }
+
+            struct TaskState {
+                TextLayer& self;
+                Containers::ArrayView<const UnsignedInt> tasks;
+            } taskState{*this, tasks};
+            state.shapeExecutor(UnsignedInt(tasks.size()), [](void* taskStatePointer, UnsignedInt index) {
+                const TaskState& taskState = *static_cast<const TaskState*>(taskStatePointer);
+                State& state = static_cast<State&>(*taskState.self._state);
+                Implementation::TextLayerDeferredShape& deferred = state.deferredShapes[taskState.tasks[index]];
+                Text::AbstractShaper& shaper = *state.deferredShapers[index];
+
+                const TextProperties properties = taskState.self.deferredShapePropertiesInternal(deferred);
+                shaper.setScript(properties.script());
+                shaper.setLanguage(properties.language());
+                shaper.setDirection(properties.shapeDirection());
+                const UnsignedInt glyphCount = shaper.shape(
+                    state.deferredShapeTextData.sliceSize(deferred.textOffset, deferred.textSize),
+                    taskState.self.textFeaturesInternal(deferred.style, properties));
+
+                deferred.glyphs = Containers::Array<Implementation::TextLayerShapeCacheGlyph>{NoInit, glyphCount};
+                const Containers::StridedArrayView1D<Implementation::TextLayerShapeCacheGlyph> glyphs = stridedArrayView(deferred.glyphs);
+                shaper.glyphOffsetsAdvancesInto(
+                    glyphs.slice(&Implementation::TextLayerShapeCacheGlyph::offset),
+                    glyphs.slice(&Implementation::TextLayerShapeCacheGlyph::advance));
+                shaper.glyphIdsInto(glyphs.slice(&Implementation::TextLayerShapeCacheGlyph::id));
+                deferred.shapedDirection = shaper.direction();
+                deferred.shaped = true;
+            }, &taskState, state.shapeExecutorUserData);
+        }
+    }
+
+    /* Replace the previous glyph run of each data with the newly shaped
+       text */
+    for(std::size_t i = 0; i != end; ++i) {
+        const Implementation::TextLayerDeferredShape& deferred = state.deferredShapes[i];
+        if(deferred.data == ~UnsignedInt{})
+            continue;
+
+        Implementation::TextLayerData& data = state.data[deferred.data];
+        CORRADE_INTERNAL_DEBUG_ASSERT(data.deferredShape == i);
+        shapeTextInternal(deferred.data, data.glyphRun, deferred.style,
+            state.deferredShapeTextData.sliceSize(deferred.textOffset, deferred.textSize),
+            deferredShapePropertiesInternal(deferred),
+            deferred.font, data.flags, deferred.shaped ? &deferred : nullptr);
+        data.deferredShape = ~UnsignedInt{};
+
+        /* The size is known only now, so the node size has to be
+           recalculated in the next update */
+        if(data.flags >= TextDataFlag::SizeToContent)
+            setNeedsUpdate(LayerState::NeedsIntrinsicSizeUpdate);
+    }
+
+    /* Move the shapes that didn't fit into the budget to the front, together
+       with their text and features. The entries are in the order they were
+       added, so moving the data towards the front never overwrites data of
+       entries that weren't moved yet. */
+    std::size_t outputOffset = 0;
+    std::size_t textOffset = 0;
+    std::size_t featureOffset = 0;
+    for(std::size_t i = end; i != state.deferredShapes.size(); ++i) {
+        Implementation::TextLayerDeferredShape& deferred = state.deferredShapes[i];
+        if(deferred.data == ~UnsignedInt{})
+            continue;
+
+        std::memmove(state.deferredShapeTextData.data() + textOffset, state.deferredShapeTextData.data() + deferred.textOffset, deferred.textSize);
+        deferred.textOffset = textOffset;
+        textOffset += deferred.textSize;
+        for(std::size_t j = 0; j != deferred.featureCount; ++j)
+            state.deferredShapeFeatures[featureOffset + j] = state.deferredShapeFeatures[deferred.featureOffset + j];
+        deferred.featureOffset = featureOffset;
+        featureOffset += deferred.featureCount;
+
+        state.data[deferred.data].deferredShape = outputOffset;
+        if(outputOffset != i)
+            state.deferredShapes[outputOffset] = Utility::move(deferred);
+        ++outputOffset;
+    }
+
+    arrayResize(state.deferredShapes, outputOffset);
+    arrayResize(state.deferredShapeTextData, textOffset);
+    arrayResize(state.deferredShapeFeatures, featureOffset);
+}
+
+auto TextLayer::shapeExecutor() const -> void(*)(UnsignedInt, void(*)(void*, UnsignedInt), void*, void*) {
+    return static_cast<const State&>(*_state).shapeExecutor;
+}
+
+void* TextLayer::shapeExecutorUserData() const {
+    return static_cast<const State&>(*_state).shapeExecutorUserData;
+}
+
+TextLayer& TextLayer::setShapeExecutor(void(*const executor)(UnsignedInt, void(*)(void*, UnsignedInt), void*, void*), void* const userData) {
+    State& state = static_cast<State&>(*_state);
+    state.shapeExecutor = executor;
+    state.shapeExecutorUserData = userData;
+    return *this;
+}
+
+UnsignedInt TextLayer::deferredShapeBudget() const {
+    return static_cast<const State&>(*_state).deferredShapeBudget;
+}
 
-    /* Save scale, size, direction-resolved alignment and the glyph run
-       reference for use in doUpdate() later */
-    Implementation::TextLayerData& data = state.data[id];
-    data.scale = fontState.scale;
-    data.rectangle = rectangle;
-    data.alignment = resolvedAlignment;
-    data.glyphRun = glyphRun;
-    data.textRun = ~UnsignedInt{};
-    data.flags = {};
+TextLayer& TextLayer::setDeferredShapeBudget(const UnsignedInt budget) {
+    static_cast<State&>(*_state).deferredShapeBudget = budget;
+    return *this;
+}
+
+auto TextLayer::vertexExecutor() const -> void(*)(UnsignedInt, void(*)(void*, UnsignedInt), void*, void*) {
+    return static_cast<const State&>(*_state).vertexExecutor;
+}
+
+void* TextLayer::vertexExecutorUserData() const {
+    return static_cast<const State&>(*_state).vertexExecutorUserData;
+}
+
+TextLayer& TextLayer::setVertexExecutor(void(*const executor)(UnsignedInt, void(*)(void*, UnsignedInt), void*, void*), void* const userData) {
+    State& state = static_cast<State&>(*_state);
+    state.vertexExecutor = executor;
+    state.vertexExecutorUserData = userData;
+    return *this;
 }
 
 DataHandle TextLayer::createInternal(const NodeHandle node) {
@@ -1176,8 +2818,17 @@ DataHandle TextLayer::create(const UnsignedInt style, const Containers::StringVi
         #ifndef CORRADE_NO_ASSERT
         "Ui::TextLayer::create():",
         #endif
-        id, style, text, properties, flags);
+        id, ~UnsignedInt{}, style, text, properties, flags);
     Implementation::TextLayerData& data = state.data[id];
+    /* If shaping is deferred, the data has no glyphs until the next
+       doUpdate() */
+    if(flags >= TextDataFlag::DeferredShaping) {
+        data.scale = 1.0f;
+        data.rectangle = {};
+        data.alignment = Text::Alignment::MiddleCenter;
+        data.usedDirection = Text::ShapeDirection::Unspecified;
+        data.glyphRun = allocateGlyphRunInternal(id, ~UnsignedInt{}, 0);
+    }
     data.padding = {};
     /* glyphRun, textRun and flags is filled by shapeTextInternal() */
     data.style = style;
@@ -1206,7 +2857,7 @@ DataHandle TextLayer::createGlyph(const UnsignedInt style, const UnsignedInt gly
         #ifndef CORRADE_NO_ASSERT
         "Ui::TextLayer::createGlyph():",
         #endif
-        id, style, glyph, properties);
+        id, ~UnsignedInt{}, style, glyph, properties);
     Implementation::TextLayerData& data = state.data[id];
     data.padding = {};
     /* glyphRun, textRun and flags is filled by shapeGlyphInternal() */
@@ -1231,14 +2882,26 @@ void TextLayer::removeInternal(const UnsignedInt id) {
     State& state = static_cast<State&>(*_state);
 
     /* Mark the glyph run as unused. It'll be removed during the next
-       recompaction in doUpdate(). */
-    state.glyphRuns[state.data[id].glyphRun].glyphOffset = ~UnsignedInt{};
+       recompaction in doUpdate() or reused by another data. */
+    freeGlyphRunInternal(state.data[id].glyphRun);
 
     /* If there's a text run, mark it as unused as well; it'll be removed in
        doUpdate() too */
     if(state.data[id].textRun != ~UnsignedInt{})
         state.textRuns[state.data[id].textRun].textOffset = ~UnsignedInt{};
 
+    /* If the text is waiting to be shaped, cancel that */
+    if(state.data[id].deferredShape != ~UnsignedInt{})
+        state.deferredShapes[state.data[id].deferredShape].data = ~UnsignedInt{};
+    cancelPendingEditShapeInternal(id);
+
+    /* If there's a hibernation source, mark it as unused as well */
+    freeHibernationSourceInternal(id);
+
+    /* If the text was sized to content, the node may need to shrink back */
+    if(state.data[id].flags >= TextDataFlag::SizeToContent)
+        setNeedsUpdate(LayerState::NeedsIntrinsicSizeUpdate);
+
     /* Data removal doesn't need anything to be reuploaded to continue working
        correctly, thus setNeedsUpdate() isn't called.
 
@@ -1292,6 +2955,119 @@ Vector2 TextLayer::size(const LayerDataHandle handle) const {
     return state.data[layerDataHandleId(handle)].rectangle.size();
 }
 
+void TextLayer::hibernate(const DataHandle handle) {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::TextLayer::hibernate(): invalid handle" << handle, );
+    hibernateInternal(dataHandleId(handle));
+}
+
+void TextLayer::hibernate(const LayerDataHandle handle) {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::TextLayer::hibernate(): invalid handle" << handle, );
+    hibernateInternal(layerDataHandleId(handle));
+}
+
+void TextLayer::hibernateInternal(const UnsignedInt id) {
+    State& state = static_cast<State&>(*_state);
+    Implementation::TextLayerData& data = state.data[id];
+    CORRADE_ASSERT(data.flags >= TextDataFlag::Hibernatable,
+        "Ui::TextLayer::hibernate(): text doesn't have" << TextDataFlag::Hibernatable << "set", );
+
+    /* If the text is waiting to be shaped, or reshaped after batched text
+       input, it'll be shaped in the next update() regardless, and if it's
+       hibernated already, there's nothing to free */
+    Implementation::TextLayerHibernationSource& source = state.hibernationSources[data.hibernationSource];
+    if(data.deferredShape != ~UnsignedInt{} || source.hibernated)
+        return;
+    for(const UnsignedInt pending: state.pendingEditShapes)
+        if(pending == id) return;
+
+    /* Replace the glyph run with an empty one. Freeing it explicitly instead
+       of passing it to allocateGlyphRunInternal(), as with glyph run reuse
+       the empty glyphs would otherwise fit into the original run in place and
+       nothing would get freed. The rectangle and alignment are kept so the
+       size and layout stay the same. */
+    freeGlyphRunInternal(data.glyphRun);
+    data.glyphRun = allocateGlyphRunInternal(id, ~UnsignedInt{}, 0);
+    source.hibernated = true;
+    ++state.hibernatedCount;
+    setNeedsUpdate(LayerState::NeedsDataUpdate);
+}
+
+bool TextLayer::isHibernated(const DataHandle handle) const {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::TextLayer::isHibernated(): invalid handle" << handle, {});
+    const State& state = static_cast<const State&>(*_state);
+    const Implementation::TextLayerData& data = state.data[dataHandleId(handle)];
+    return data.hibernationSource != ~UnsignedInt{} && state.hibernationSources[data.hibernationSource].hibernated;
+}
+
+bool TextLayer::isHibernated(const LayerDataHandle handle) const {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::TextLayer::isHibernated(): invalid handle" << handle, {});
+    const State& state = static_cast<const State&>(*_state);
+    const Implementation::TextLayerData& data = state.data[layerDataHandleId(handle)];
+    return data.hibernationSource != ~UnsignedInt{} && state.hibernationSources[data.hibernationSource].hibernated;
+}
+
+void TextLayer::glyphCacheUseCountsInto(const Containers::StridedArrayView1D<UnsignedInt>& counts) const {
+    const State& state = static_cast<const State&>(*_state);
+    const Shared::State& sharedState = static_cast<const Shared::State&>(state.shared);
+    CORRADE_ASSERT(sharedState.glyphCache,
+        "Ui::TextLayer::glyphCacheUseCountsInto(): no glyph cache set", );
+    CORRADE_ASSERT(counts.size() == sharedState.glyphCache->glyphCount(),
+        "Ui::TextLayer::glyphCacheUseCountsInto(): expected a view with" << sharedState.glyphCache->glyphCount() << "elements but got" << counts.size(), );
+
+    for(const Implementation::TextLayerGlyphRun& run: state.glyphRuns) {
+        /* Skip runs that are unused, either waiting for a recompaction or in
+           a free list, and runs that still have font-specific glyph IDs */
+        if(run.glyphOffset == ~UnsignedInt{} || run.data == ~UnsignedInt{} || run.pendingGlyphIdFont != ~UnsignedInt{})
+            continue;
+        for(const Implementation::TextLayerGlyphData& glyph: state.glyphData.sliceSize(run.glyphOffset, run.glyphCount))
+            ++counts[glyph.glyphId];
+    }
+}
+
+namespace {
+
+/* Offset of the (aligned) glyph run origin relative to the node area, with
+   padding applied. Used for vertex generation and for mapping positions back
+   to the text in cursorForPosition(). */
+Vector2 alignedOffset(const Vector2& nodeOffset, const Vector2& nodeSize, const Vector4& padding, const Text::Alignment alignment) {
+    Vector2 offset = nodeOffset + padding.xy();
+    const Vector2 size = nodeSize - padding.xy() - Math::gather<'z', 'w'>(padding);
+    const UnsignedByte alignmentHorizontal = (UnsignedByte(alignment) & Text::Implementation::AlignmentHorizontal);
+    if(alignmentHorizontal == Text::Implementation::AlignmentLeft) {
+        offset.x() += 0.0f;
+    } else if(alignmentHorizontal == Text::Implementation::AlignmentRight) {
+        offset.x() += size.x();
+    } else if(alignmentHorizontal == Text::Implementation::AlignmentCenter) {
+        if(UnsignedByte(alignment) & Text::Implementation::AlignmentIntegral)
+            offset.x() += Math::round(size.x()*0.5f);
+        else
+            offset.x() += size.x()*0.5f;
+    }
+    const UnsignedByte alignmentVertical = (UnsignedByte(alignment) & Text::Implementation::AlignmentVertical);
+    /* For Line/Middle it's aligning either the line or bounding box
+       middle (which is already at y=0 by the Text::alignRenderedLine())
+       to node middle */
+    if(alignmentVertical == Text::Implementation::AlignmentTop) {
+        offset.y() += 0.0f;
+    } else if(alignmentVertical == Text::Implementation::AlignmentBottom) {
+        offset.y() += size.y();
+    } else if(alignmentVertical == Text::Implementation::AlignmentLine ||
+              alignmentVertical == Text::Implementation::AlignmentMiddle) {
+        if(UnsignedByte(alignment) & Text::Implementation::AlignmentIntegral)
+            offset.y() += Math::round(size.y()*0.5f);
+        else
+            offset.y() += size.y()*0.5f;
+    }
+
+    return offset;
+}
+
+}
+
 Containers::Pair<UnsignedInt, UnsignedInt> TextLayer::cursor(const DataHandle handle) const {
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::TextLayer::cursor(): invalid handle" << handle, {});
@@ -1345,6 +3121,77 @@ void TextLayer::setCursorInternal(const UnsignedInt id, const UnsignedInt positi
     }
 }
 
+UnsignedInt TextLayer::cursorForPosition(const DataHandle handle, const Vector2& position, const Vector2& nodeSize) const {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::TextLayer::cursorForPosition(): invalid handle" << handle, {});
+    return cursorForPositionInternal(dataHandleId(handle), position, nodeSize);
+}
+
+UnsignedInt TextLayer::cursorForPosition(const LayerDataHandle handle, const Vector2& position, const Vector2& nodeSize) const {
+    CORRADE_ASSERT(isHandleValid(handle),
+        "Ui::TextLayer::cursorForPosition(): invalid handle" << handle, {});
+    return cursorForPositionInternal(layerDataHandleId(handle), position, nodeSize);
+}
+
+UnsignedInt TextLayer::cursorForPositionInternal(const UnsignedInt id, const Vector2& position, const Vector2& nodeSize) const {
+    const State& state = static_cast<const State&>(*_state);
+    const Shared::State& sharedState = static_cast<const Shared::State&>(state.shared);
+    const Implementation::TextLayerData& data = state.data[id];
+    CORRADE_ASSERT(data.textRun != ~UnsignedInt{},
+        "Ui::TextLayer::cursorForPosition(): text doesn't have" << TextDataFlag::Editable << "set", {});
+    const Implementation::TextLayerTextRun& textRun = state.textRuns[data.textRun];
+    const Implementation::TextLayerGlyphRun& glyphRun = state.glyphRuns[data.glyphRun];
+
+    /* Calculate the glyph run origin the same way as updateVerticesInternal()
+       does, except that the node offset is zero as the position is
+       node-relative. The calculated style is what was used in the last
+       update(), same as for the vertices. */
+    Vector4 padding = data.padding;
+    if(data.calculatedStyle < sharedState.styleCount)
+        padding += sharedState.styles[data.calculatedStyle].padding;
+    else {
+        CORRADE_INTERNAL_DEBUG_ASSERT(data.calculatedStyle < sharedState.styleCount + sharedState.dynamicStyleCount);
+        padding += state.dynamicStyles[data.calculatedStyle - sharedState.styleCount].padding;
+    }
+    const Float x = position.x() - alignedOffset({}, nodeSize, padding, data.alignment).x();
+
+    /* Editable text is always a single line with glyphs in visual order, i.e.
+       the glyph positions are already a monotonic prefix sum of the advances
+       and the edge after the last glyph is the rectangle max. Binary search
+       for the last glyph whose position is not after the pointer, giving an
+       O(log n) lookup without any extra per-run index. */
+    const Containers::StridedArrayView1D<const Implementation::TextLayerGlyphData> glyphData = state.glyphData.sliceSize(glyphRun.glyphOffset, glyphRun.glyphCount);
+    const auto edgePosition = [&data, &glyphData](const std::size_t edge) {
+        return edge == glyphData.size() ? data.rectangle.max().x() : glyphData[edge].position.x();
+    };
+    std::size_t edge = glyphData.size();
+    if(!glyphData.isEmpty() && x < edgePosition(glyphData.size())) {
+        std::size_t begin = 0;
+        std::size_t end = glyphData.size();
+        while(end - begin > 1) {
+            const std::size_t middle = begin + (end - begin)/2;
+            if(edgePosition(middle) <= x)
+                begin = middle;
+            else
+                end = middle;
+        }
+
+        /* Snap to the closer edge of the glyph that got hit. Positions before
+           the first glyph snap to its left edge. */
+        edge = x - edgePosition(begin) < edgePosition(begin + 1) - x ? begin : begin + 1;
+    }
+
+    /* Convert the visual edge to a byte position. In LTR text the edge
+       before a glyph is at its cluster; in RTL text the clusters are in
+       descending order and the edge before a glyph (visually) is after the
+       glyph (logically), thus at the cluster of the glyph visually before
+       it. */
+    const Containers::StridedArrayView1D<const UnsignedInt> glyphClusters = glyphData.slice(&Implementation::TextLayerGlyphData::glyphCluster);
+    if(data.usedDirection == Text::ShapeDirection::RightToLeft)
+        return edge == 0 ? textRun.textSize : glyphClusters[edge - 1];
+    return edge == glyphData.size() ? textRun.textSize : glyphClusters[edge];
+}
+
 TextProperties TextLayer::textProperties(const DataHandle handle) const {
     CORRADE_ASSERT(isHandleValid(handle),
         "Ui::TextLayer::textProperties(): invalid handle" << handle, {});
@@ -1429,22 +3276,29 @@ void TextLayer::setTextInternal(const UnsignedInt id, const Containers::StringVi
     State& state = static_cast<State&>(*_state);
     Implementation::TextLayerData& data = state.data[id];
 
-    /* Mark the original glyph run as unused. It'll be removed during the next
-       recompaction in doUpdate(). */
-    state.glyphRuns[data.glyphRun].glyphOffset = ~UnsignedInt{};
-
     /* If there's a text run, mark it as unused as well; it'll be removed in
        doUpdate() too */
     if(state.data[id].textRun != ~UnsignedInt{})
         state.textRuns[state.data[id].textRun].textOffset = ~UnsignedInt{};
 
+    /* If the previous text is still waiting to be shaped, cancel that */
+    if(data.deferredShape != ~UnsignedInt{})
+        state.deferredShapes[data.deferredShape].data = ~UnsignedInt{};
+    cancelPendingEditShapeInternal(id);
+
+    /* Same for a hibernation source of the previous text */
+    freeHibernationSourceInternal(id);
+
     /* Shape the text, save its properties and optionally also the source
-       string if it's editable; mark the layer as needing an update */
+       string if it's editable; mark the layer as needing an update. The
+       original glyph run gets replaced by the new one. If the new text has
+       deferred shaping, the original run stays shown until it gets replaced in
+       doUpdate(). */
     shapeRememberTextInternal(
         #ifndef CORRADE_NO_ASSERT
         "Ui::TextLayer::setText():",
         #endif
-        id, data.style, text, properties, flags);
+        id, data.glyphRun, data.style, text, properties, flags);
     setNeedsUpdate(LayerState::NeedsDataUpdate);
 }
 
@@ -1460,7 +3314,7 @@ void TextLayer::updateText(const LayerDataHandle handle, const UnsignedInt remov
     updateTextInternal(layerDataHandleId(handle), removeOffset, removeSize, insertOffset, insertText, cursor, selection);
 }
 
-void TextLayer::updateTextInternal(const UnsignedInt id, const UnsignedInt removeOffset, const UnsignedInt removeSize, const UnsignedInt insertOffset, const Containers::StringView insertText, const UnsignedInt cursor, const UnsignedInt selection) {
+void TextLayer::updateTextInternal(const UnsignedInt id, const UnsignedInt removeOffset, const UnsignedInt removeSize, const UnsignedInt insertOffset, const Containers::StringView insertText, const UnsignedInt cursor, const UnsignedInt selection, const bool deferShaping) {
     State& state = static_cast<State&>(*_state);
     Implementation::TextLayerData& data = state.data[id];
     CORRADE_ASSERT(data.textRun != ~UnsignedInt{},
@@ -1501,85 +3355,146 @@ void TextLayer::updateTextInternal(const UnsignedInt id, const UnsignedInt remov
     if(insertTextRelocateOffset >= arrayCapacity(state.textData))
         insertTextRelocateOffset = ~std::size_t{};
 
-    /* Add a new text run for the modified contents */
-    const UnsignedInt textRun = state.textRuns.size();
-    const UnsignedInt textOffset = state.textData.size();
-    Containers::ArrayView<char> text = arrayAppend(state.textData, NoInit, textSize);
-    Implementation::TextLayerTextRun& run = arrayAppend(state.textRuns, NoInit, 1).front();
-
-    /* Fill the new run properties */
-    run.textOffset = textOffset;
-    run.textSize = textSize;
-    run.data = id;
-    /* run.cursor updated by setCursorInternal() at the end */
-
-    /* Copy the TextProperties internals verbatim */
-    Utility::copy(previousRun.language, run.language);
-    run.script = previousRun.script;
-    run.font = previousRun.font;
-    run.alignment = previousRun.alignment;
-    run.direction = previousRun.direction;
-
-    /* We can insert either before the removed range, in which case the copy
-       before the removed range has to be split */
-    UnsignedInt copySrcBegin[3];
-    UnsignedInt copyDstBegin[3];
-    UnsignedInt copySrcEnd[3];
-    copySrcBegin[0] = 0;
-    copyDstBegin[0] = 0;
-    if(insertOffset < removeOffset) {
-        copySrcEnd[0] = insertOffset;
-
-        copySrcBegin[1] = insertOffset;
-        copyDstBegin[1] = insertOffset + insertText.size();
-        copySrcEnd[1] = removeOffset;
-
-        copySrcBegin[2] = removeOffset + removeSize;
-        copyDstBegin[2] = removeOffset + insertText.size();
-
-    /* Or insert after the removed range, in which case the copy after the
-       removed range has to be split (and the offsets there include the removed
-       size as well because the source doesn't have it removed yet) */
+    /* If glyph run reuse is enabled, the modified text fits into the capacity
+       of the previous run and the inserted text isn't coming from our own
+       text array (where it could get overwritten by the edit), modify the
+       text in place. Only the part after the removed / inserted range gets
+       shifted. */
+    const Shared::State& sharedState = static_cast<const Shared::State&>(state.shared);
+    if(sharedState.glyphRunReuse && textSize <= previousRun.textCapacity && insertTextRelocateOffset == ~std::size_t{}) {
+        Implementation::TextLayerTextRun& run = state.textRuns[data.textRun];
+        char* const runText = state.textData.data() + run.textOffset;
+        /* The removal range is relative to the original text, the insertion
+           offset to the text after removal, so do them in that order */
+        if(removeSize) std::memmove(
+            runText + removeOffset,
+            runText + removeOffset + removeSize,
+            previousRun.textSize - removeOffset - removeSize);
+        if(insertText) {
+            std::memmove(
+                runText + insertOffset + insertText.size(),
+                runText + insertOffset,
+                textSizeBeforeInsert - insertOffset);
+            Utility::copy(insertText, Containers::arrayView(runText + insertOffset, insertText.size()));
+        }
+        run.textSize = textSize;
+
+    /* Otherwise add a new run */
     } else {
-        copySrcEnd[0] = removeOffset;
+        /* Add a new text run for the modified contents */
+        const UnsignedInt textRun = state.textRuns.size();
+        const UnsignedInt textOffset = state.textData.size();
+        /* With reuse, grow the capacity to the next power of two like with
+           glyph runs so a sequence of insertions doesn't allocate a new run
+           each time */
+        const UnsignedInt textCapacity = sharedState.glyphRunReuse ?
+            1u << glyphRunSizeClass(textSize) : textSize;
+        const Containers::ArrayView<char> text = arrayAppend(state.textData, NoInit, textCapacity).prefix(textSize);
+        Implementation::TextLayerTextRun& run = arrayAppend(state.textRuns, NoInit, 1).front();
+
+        /* Fill the new run properties */
+        run.textOffset = textOffset;
+        run.textSize = textSize;
+        run.textCapacity = textCapacity;
+        run.data = id;
+        /* run.cursor updated by setCursorInternal() at the end */
+
+        /* Copy the TextProperties internals verbatim */
+        Utility::copy(previousRun.language, run.language);
+        run.script = previousRun.script;
+        run.font = previousRun.font;
+        run.alignment = previousRun.alignment;
+        run.direction = previousRun.direction;
+
+        /* We can insert either before the removed range, in which case the
+           copy before the removed range has to be split */
+        UnsignedInt copySrcBegin[3];
+        UnsignedInt copyDstBegin[3];
+        UnsignedInt copySrcEnd[3];
+        copySrcBegin[0] = 0;
+        copyDstBegin[0] = 0;
+        if(insertOffset < removeOffset) {
+            copySrcEnd[0] = insertOffset;
+
+            copySrcBegin[1] = insertOffset;
+            copyDstBegin[1] = insertOffset + insertText.size();
+            copySrcEnd[1] = removeOffset;
+
+            copySrcBegin[2] = removeOffset + removeSize;
+            copyDstBegin[2] = removeOffset + insertText.size();
+
+        /* Or insert after the removed range, in which case the copy after
+           the removed range has to be split (and the offsets there include
+           the removed size as well because the source doesn't have it
+           removed yet) */
+        } else {
+            copySrcEnd[0] = removeOffset;
+
+            copySrcBegin[1] = removeOffset + removeSize;
+            copyDstBegin[1] = removeOffset;
+            copySrcEnd[1] = removeSize + insertOffset;
+
+            copySrcBegin[2] = removeSize + insertOffset;
+            copyDstBegin[2] = insertOffset + insertText.size();
+        }
+        copySrcEnd[2] = previousRun.textSize;
+
+        /* Copy the bits of the previous text, if not empty */
+        const Containers::StringView previousText = state.textData.sliceSize(previousRun.textOffset, previousRun.textSize);
+        for(std::size_t i: {0, 1, 2}) {
+            const UnsignedInt size = copySrcEnd[i] - copySrcBegin[i];
+            if(size) Utility::copy(
+                previousText.slice(copySrcBegin[i], copySrcEnd[i]),
+                text.sliceSize(copyDstBegin[i], size));
+        }
 
-        copySrcBegin[1] = removeOffset + removeSize;
-        copyDstBegin[1] = removeOffset;
-        copySrcEnd[1] = removeSize + insertOffset;
+        /* Copy the inserted text, if not empty */
+        if(insertText) {
+            Utility::copy(
+                /* If text to insert was a slice of our textData array,
+                   relocate the view relative to the (potentially) reallocated
+                   array */
+                insertTextRelocateOffset != ~std::size_t{} ? state.textData.sliceSize(insertTextRelocateOffset, insertText.size())
+                    : insertText,
+                text.sliceSize(insertOffset, insertText.size()));
+        }
 
-        copySrcBegin[2] = removeSize + insertOffset;
-        copyDstBegin[2] = insertOffset + insertText.size();
+        /* Mark the previous run (potentially reallocated somewhere) as
+           unused. It'll be removed during the next recompaction run in
+           doUpdate(). Save the new run reference. */
+        state.textRuns[data.textRun].textOffset = ~UnsignedInt{};
+        data.textRun = textRun;
     }
-    copySrcEnd[2] = previousRun.textSize;
 
-    /* Copy the bits of the previous text, if not empty */
-    const Containers::StringView previousText = state.textData.sliceSize(previousRun.textOffset, previousRun.textSize);
-    for(std::size_t i: {0, 1, 2}) {
-        const UnsignedInt size = copySrcEnd[i] - copySrcBegin[i];
-        if(size) Utility::copy(
-            previousText.slice(copySrcBegin[i], copySrcEnd[i]),
-            text.sliceSize(copyDstBegin[i], size));
+    /* Shape the new text, or remember it for shaping in the next doUpdate()
+       if the edit comes from batched text input. If the text was waiting for
+       that already and this edit isn't deferred, it's shaped right away and
+       the pending entry is not needed anymore. */
+    if(deferShaping) {
+        bool pending = false;
+        for(const UnsignedInt i: state.pendingEditShapes)
+            if(i == id) pending = true;
+        if(!pending)
+            arrayAppend(state.pendingEditShapes, id);
+    } else {
+        cancelPendingEditShapeInternal(id);
+        shapeEditedTextInternal(id);
     }
 
-    /* Copy the inserted text, if not empty */
-    if(insertText) {
-        Utility::copy(
-            /* If text to insert was a slice of our textData array, relocate
-               the view relative to the (potentially) reallocated array */
-            insertTextRelocateOffset != ~std::size_t{} ? state.textData.sliceSize(insertTextRelocateOffset, insertText.size())
-                : insertText,
-            text.sliceSize(insertOffset, insertText.size()));
-    }
-
-    /* Mark the previous run (potentially reallocated somewhere) as unused.
-       It'll be removed during the next recompaction run in doUpdate(). Save
-       the new run reference. */
-    state.textRuns[data.textRun].textOffset = ~UnsignedInt{};
-    data.textRun = textRun;
-
-    /* Shape the new text using properties saved in the run and mark the layer
-       as needing an update. Forming a TextProperties from the internal state
-       that was saved earlier in shapeRememberTextInternal() above. */
+    /* Update the cursor position and all related state */
+    setCursorInternal(id, cursor, selection);
+
+    setNeedsUpdate(LayerState::NeedsDataUpdate|(data.flags >= TextDataFlag::SizeToContent ? LayerState::NeedsIntrinsicSizeUpdate : LayerStates{}));
+}
+
+void TextLayer::shapeEditedTextInternal(const UnsignedInt id) {
+    State& state = static_cast<State&>(*_state);
+    const Implementation::TextLayerData& data = state.data[id];
+    const Implementation::TextLayerTextRun& run = state.textRuns[data.textRun];
+
+    /* Shape the text using properties saved in the run. Forming a
+       TextProperties from the internal state that was saved earlier in
+       shapeRememberTextInternal(). */
     TextProperties properties{NoInit};
     Utility::copy(run.language, properties._language);
     properties._script = run.script;
@@ -1591,12 +3506,21 @@ void TextLayer::updateTextInternal(const UnsignedInt id, const UnsignedInt remov
     /* Similarly, the direction is both the layout and shape directions
        together, verbatim copy them back */
     properties._direction = run.direction;
-    shapeTextInternal(id, data.style, text, properties, run.font, data.flags);
+    shapeTextInternal(id, data.glyphRun, data.style, state.textData.sliceSize(run.textOffset, run.textSize), properties, run.font, data.flags);
+}
 
-    /* Update the cursor position and all related state */
-    setCursorInternal(id, cursor, selection);
+void TextLayer::shapePendingEditsInternal() {
+    State& state = static_cast<State&>(*_state);
+    for(const UnsignedInt id: state.pendingEditShapes)
+        if(id != ~UnsignedInt{})
+            shapeEditedTextInternal(id);
+    arrayResize(state.pendingEditShapes, 0);
+}
 
-    setNeedsUpdate(LayerState::NeedsDataUpdate);
+void TextLayer::cancelPendingEditShapeInternal(const UnsignedInt id) {
+    State& state = static_cast<State&>(*_state);
+    for(UnsignedInt& i: state.pendingEditShapes)
+        if(i == id) i = ~UnsignedInt{};
 }
 
 void TextLayer::editText(const DataHandle handle, const TextEdit edit, const Containers::StringView insert) {
@@ -1611,7 +3535,7 @@ void TextLayer::editText(const LayerDataHandle handle, const TextEdit edit, cons
     return editTextInternal(layerDataHandleId(handle), edit, insert);
 }
 
-void TextLayer::editTextInternal(const UnsignedInt id, const TextEdit edit, const Containers::StringView insert) {
+void TextLayer::editTextInternal(const UnsignedInt id, const TextEdit edit, const Containers::StringView insert, const bool deferShaping) {
     CORRADE_ASSERT(!insert ||
         edit == TextEdit::InsertBeforeCursor ||
         edit == TextEdit::InsertAfterCursor,
@@ -1741,7 +3665,7 @@ void TextLayer::editTextInternal(const UnsignedInt id, const TextEdit edit, cons
         }
 
         /* All edit operations discard the selection */
-        updateTextInternal(id, removeOffset, removeSize, insertOffset, insert, cursor, cursor);
+        updateTextInternal(id, removeOffset, removeSize, insertOffset, insert, cursor, cursor, deferShaping);
 
     } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
 }
@@ -1762,24 +3686,31 @@ void TextLayer::setGlyphInternal(const UnsignedInt id, const UnsignedInt glyph,
     State& state = static_cast<State&>(*_state);
     Implementation::TextLayerData& data = state.data[id];
 
-    /* Mark the original glyph run as unused. It'll be removed during the next
-       recompaction in doUpdate(). We could also just reuse the offset in case
-       the original run was 1 glyph or more (and setTextInternal() could do
-       that too), but this way makes the often-updated data clustered to the
-       end, allowing potential savings in data upload. */
-    state.glyphRuns[data.glyphRun].glyphOffset = ~UnsignedInt{};
-
     /* If there's a text run, mark it as unused as well; it'll be removed in
        doUpdate() too */
     if(state.data[id].textRun != ~UnsignedInt{})
         state.textRuns[state.data[id].textRun].textOffset = ~UnsignedInt{};
 
-    /* Shape the glyph, mark the layer as needing an update */
+    /* If the previous text is still waiting to be shaped, cancel that */
+    if(data.deferredShape != ~UnsignedInt{})
+        state.deferredShapes[data.deferredShape].data = ~UnsignedInt{};
+    cancelPendingEditShapeInternal(id);
+
+    /* Same for a hibernation source of the previous text */
+    freeHibernationSourceInternal(id);
+
+    /* If the text was sized to content, the node size has to be recalculated
+       as glyphs never are */
+    if(data.flags >= TextDataFlag::SizeToContent)
+        setNeedsUpdate(LayerState::NeedsIntrinsicSizeUpdate);
+
+    /* Shape the glyph, replacing the original glyph run, mark the layer as
+       needing an update */
     shapeGlyphInternal(
         #ifndef CORRADE_NO_ASSERT
         "Ui::TextLayer::setGlyph():",
         #endif
-        id, data.style, glyph, properties);
+        id, data.glyphRun, data.style, glyph, properties);
     setNeedsUpdate(LayerState::NeedsDataUpdate);
 }
 
@@ -1837,12 +3768,36 @@ void TextLayer::setPadding(const LayerDataHandle handle, const Vector4& padding)
 }
 
 void TextLayer::setPaddingInternal(const UnsignedInt id, const Vector4& padding) {
-    static_cast<State&>(*_state).data[id].padding = padding;
-    setNeedsUpdate(LayerState::NeedsDataUpdate);
+    Implementation::TextLayerData& data = static_cast<State&>(*_state).data[id];
+    data.padding = padding;
+    setNeedsUpdate(LayerState::NeedsDataUpdate|(data.flags >= TextDataFlag::SizeToContent ? LayerState::NeedsIntrinsicSizeUpdate : LayerStates{}));
 }
 
 LayerFeatures TextLayer::doFeatures() const {
-    return AbstractVisualLayer::doFeatures()|(static_cast<const Shared::State&>(_state->shared).dynamicStyleCount ? LayerFeature::AnimateStyles : LayerFeatures{})|LayerFeature::Draw;
+    return AbstractVisualLayer::doFeatures()|(static_cast<const Shared::State&>(_state->shared).dynamicStyleCount ? LayerFeature::AnimateStyles : LayerFeatures{})|LayerFeature::Draw|LayerFeature::IntrinsicSize;
+}
+
+void TextLayer::doIntrinsicSizes(const Containers::StridedArrayView1D<Vector2>& nodeSizes) {
+    const State& state = static_cast<const State&>(*_state);
+
+    /* Sizes of texts with batched text input are known only after they're
+       reshaped */
+    if(!state.pendingEditShapes.isEmpty())
+        shapePendingEditsInternal();
+    const Containers::StridedArrayView1D<const NodeHandle> nodes = this->nodes();
+
+    /* Removed data have the node set to null, so the flags of those aren't
+       accessed */
+    for(std::size_t i = 0; i != state.data.size(); ++i) {
+        if(nodes[i] == NodeHandle::Null)
+            continue;
+        const Implementation::TextLayerData& data = state.data[i];
+        if(!(data.flags >= TextDataFlag::SizeToContent))
+            continue;
+
+        Vector2& nodeSize = nodeSizes[nodeHandleId(nodes[i])];
+        nodeSize = Math::max(nodeSize, data.rectangle.size() + data.padding.xy() + data.padding.zw());
+    }
 }
 
 LayerStates TextLayer::doState() const {
@@ -1860,9 +3815,104 @@ LayerStates TextLayer::doState() const {
         if(sharedState.dynamicStyleCount)
             states |= LayerState::NeedsCommonDataUpdate;
     }
+
+    /* Deferred texts that didn't fit into the budget in the previous update
+       need another one */
+    if(state.deferredShapeBudget && !state.deferredShapes.isEmpty())
+        states |= LayerState::NeedsDataUpdate;
     return states;
 }
 
+void TextLayer::doReserve(const std::size_t capacity) {
+    State& state = static_cast<State&>(*_state);
+    arrayReserve(state.data, capacity);
+    /* The views need to be updated as the reserve may have reallocated */
+    state.styles = stridedArrayView(state.data).slice(&Implementation::TextLayerData::style);
+    state.calculatedStyles = stridedArrayView(state.data).slice(&Implementation::TextLayerData::calculatedStyle);
+}
+
+void TextLayer::doCompact(const Containers::StridedArrayView1D<const UnsignedInt>& previousDataIds) {
+    State& state = static_cast<State&>(*_state);
+
+    /* The pending entries reference data IDs that are about to change, shape
+       them now instead of redirecting them */
+    if(!state.pendingEditShapes.isEmpty())
+        shapePendingEditsInternal();
+
+    for(std::size_t i = 0; i != previousDataIds.size(); ++i) {
+        Implementation::TextLayerData& data = state.data[i];
+
+        /* Slots with disabled handles may still reference runs of data that
+           were moved away from them, reset those to not alias the moved
+           data */
+        if(previousDataIds[i] == ~UnsignedInt{}) {
+            data.glyphRun = ~UnsignedInt{};
+            data.textRun = ~UnsignedInt{};
+            data.deferredShape = ~UnsignedInt{};
+            data.hibernationSource = ~UnsignedInt{};
+            continue;
+        }
+
+        if(previousDataIds[i] != i)
+            data = state.data[previousDataIds[i]];
+
+        /* Glyph runs, text runs and deferred shapes reference the data they
+           belong to in order to update them when recompacting, redirect them
+           to the new ID. Those belonging to removed data are already marked
+           as unused and aren't referenced from any data, so they can be left
+           as they are. */
+        if(data.glyphRun != ~UnsignedInt{})
+            state.glyphRuns[data.glyphRun].data = i;
+        if(data.textRun != ~UnsignedInt{})
+            state.textRuns[data.textRun].data = i;
+        if(data.deferredShape != ~UnsignedInt{})
+            state.deferredShapes[data.deferredShape].data = i;
+        if(data.hibernationSource != ~UnsignedInt{})
+            state.hibernationSources[data.hibernationSource].data = i;
+    }
+    arrayResize(state.data, NoInit, previousDataIds.size());
+    arrayShrink(state.data);
+    /* The views need to be updated as the shrink reallocated */
+    state.styles = stridedArrayView(state.data).slice(&Implementation::TextLayerData::style);
+    state.calculatedStyles = stridedArrayView(state.data).slice(&Implementation::TextLayerData::calculatedStyle);
+}
+
+void TextLayer::doMemoryUsage(MemoryUsage& usage) const {
+    const State& state = static_cast<const State&>(*_state);
+    std::size_t byteCount =
+        /* The base struct has its own dynamic style storage */
+        static_cast<const AbstractVisualLayer::State&>(state).dynamicStyleStorage.size() +
+        Implementation::arrayByteCount(state.glyphData) +
+        Implementation::arrayByteCount(state.textData) +
+        Implementation::arrayByteCount(state.glyphRuns) +
+        Implementation::arrayByteCount(state.textRuns) +
+        Implementation::arrayByteCount(state.glyphRunsWithPendingGlyphIds) +
+        Implementation::arrayByteCount(state.data) +
+        Implementation::arrayByteCount(state.deferredShapes) +
+        Implementation::arrayByteCount(state.deferredShapeTextData) +
+        Implementation::arrayByteCount(state.deferredShapeFeatures) +
+        Implementation::arrayByteCount(state.deferredShapers) +
+        Implementation::arrayByteCount(state.hibernationSources) +
+        Implementation::arrayByteCount(state.hibernationSourceTextData) +
+        Implementation::arrayByteCount(state.hibernationSourceFeatures) +
+        Implementation::arrayByteCount(state.vertices) +
+        Implementation::arrayByteCount(state.editingVertices) +
+        Implementation::arrayByteCount(state.vertexTasks) +
+        Implementation::arrayByteCount(state.glyphInstances) +
+        Implementation::arrayByteCount(state.indices) +
+        Implementation::arrayByteCount(state.editingIndices) +
+        Implementation::arrayByteCount(state.indexDrawOffsets) +
+        Implementation::arrayByteCount(state.dynamicStyleFeatures) +
+        state.dynamicStyleStorage.size();
+    for(const Containers::Array<UnsignedInt>& freeGlyphRuns: state.freeGlyphRuns)
+        byteCount += Implementation::arrayByteCount(freeGlyphRuns);
+    for(const Implementation::TextLayerVertexTask& task: state.vertexTasks)
+        byteCount +=
+            Implementation::arrayByteCount(task.vertexScratch) +
+            Implementation::arrayByteCount(task.glyphInstanceScratch);
+    usage.cpuByteCount += byteCount;
+}
+
 void TextLayer::doClean(const Containers::BitArrayView dataIdsToRemove) {
     State& state = static_cast<State&>(*_state);
 
@@ -1873,11 +3923,20 @@ void TextLayer::doClean(const Containers::BitArrayView dataIdsToRemove) {
         if(!dataIdsToRemove[i])
             continue;
 
-        state.glyphRuns[state.data[i].glyphRun].glyphOffset = ~UnsignedInt{};
+        freeGlyphRunInternal(state.data[i].glyphRun);
         if(state.data[i].textRun != ~UnsignedInt{})
             state.textRuns[state.data[i].textRun].textOffset = ~UnsignedInt{};
+        if(state.data[i].deferredShape != ~UnsignedInt{})
+            state.deferredShapes[state.data[i].deferredShape].data = ~UnsignedInt{};
+        freeHibernationSourceInternal(i);
     }
 
+    /* Batched text input edits of removed data don't need to be shaped
+       anymore */
+    for(UnsignedInt& id: state.pendingEditShapes)
+        if(id != ~UnsignedInt{} && dataIdsToRemove[id])
+            id = ~UnsignedInt{};
+
     /* Data removal doesn't need anything to be reuploaded to continue working
        correctly, thus setNeedsUpdate() isn't called, and neither is in
        remove(). See a comment there for more information. */
@@ -1915,6 +3974,17 @@ void TextLayer::doAdvanceAnimations(const Nanoseconds time, const Containers::Mu
 
     if(animations & (TextLayerStyleAnimation::Style|TextLayerStyleAnimation::Padding|TextLayerStyleAnimation::EditingPadding))
         setNeedsUpdate(LayerState::NeedsDataUpdate);
+    /* The animators write only to dynamic styles they have allocated, so the
+       changed range is at most the range of currently used dynamic styles. It
+       includes also styles allocated in the advance() calls above. */
+    if(animations & (TextLayerStyleAnimation::Uniform|TextLayerStyleAnimation::EditingUniform)) {
+        for(std::size_t i = 0; i != state.dynamicStylesUsed.size(); ++i) {
+            if(!state.dynamicStylesUsed[i])
+                continue;
+            state.dynamicStyleChangedBegin = Math::min(state.dynamicStyleChangedBegin, UnsignedInt(i));
+            state.dynamicStyleChangedEnd = Math::max(state.dynamicStyleChangedEnd, UnsignedInt(i + 1));
+        }
+    }
     if(animations >= TextLayerStyleAnimation::Uniform) {
         setNeedsUpdate(LayerState::NeedsCommonDataUpdate);
         state.dynamicStyleChanged = true;
@@ -1925,7 +3995,7 @@ void TextLayer::doAdvanceAnimations(const Nanoseconds time, const Containers::Mu
     }
 }
 
-void TextLayer::doUpdate(const LayerStates states, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, const Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes) {
+void TextLayer::doUpdate(LayerStates states, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, const Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes) {
     /* The base implementation populates data.calculatedStyle */
     AbstractVisualLayer::doUpdate(states, dataIds, clipRectIds, clipRectDataCounts, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, clipRectOffsets, clipRectSizes, compositeRectOffsets, compositeRectSizes);
 
@@ -1940,6 +4010,66 @@ void TextLayer::doUpdate(const LayerStates states, const Containers::StridedArra
     CORRADE_ASSERT(!sharedState.hasEditingStyles || sharedState.setEditingStyleCalled,
         "Ui::TextLayer::update(): no editing style data was set", );
 
+    /* Everything until the recompaction below shapes text or fills the glyph
+       cache, modifying state shared with other layers, which means layers
+       sharing the same Shared can't be updated concurrently if they do any
+       of that. There's no way to know what the layer update executor does
+       so at least detect the case in debug builds. */
+    #ifndef CORRADE_NO_ASSERT
+    const bool shapes = state.hibernatedCount || (states >= LayerState::NeedsDataUpdate && !state.deferredShapes.isEmpty()) || !state.pendingEditShapes.isEmpty() || !state.glyphRunsWithPendingGlyphIds.isEmpty();
+    CORRADE_ASSERT(!shapes || !sharedState.updateShapingInProgress.exchange(true),
+        "Ui::TextLayer::update(): another layer using the same shared state is shaping at the same time, layers sharing a TextLayer::Shared can't be updated in parallel", );
+    #endif
+
+    /* Reshape hibernated texts that are visible again. Same as with deferred
+       shaping below this replaces their previous glyph runs, and the glyphs
+       and vertices have to be regenerated, so treat it as a data update. */
+    if(state.hibernatedCount && wakeHibernatedInternal(dataIds))
+        states |= LayerState::NeedsDataUpdate;
+
+    /* Shape texts with deferred shaping. This replaces their previous glyph
+       runs, so has to be done before the recompaction below. */
+    if(states >= LayerState::NeedsDataUpdate && !state.deferredShapes.isEmpty())
+        shapeDeferredInternal();
+
+    /* Reshape texts modified by batched text input. Same as above, replaces
+       their glyph runs so has to be before the recompaction. The edit itself
+       marked the layer with NeedsDataUpdate already. */
+    if(!state.pendingEditShapes.isEmpty())
+        shapePendingEditsInternal();
+
+    /* Add glyphs missing from the glyph cache, if any, and convert glyph IDs
+       of runs that were waiting for them to cache-global. Has to be done
+       before the recompaction below as the runs are referenced by their
+       index. */
+    if(!state.glyphRunsWithPendingGlyphIds.isEmpty()) {
+        fillMissingGlyphsInternal();
+        for(const UnsignedInt glyphRun: state.glyphRunsWithPendingGlyphIds) {
+            Implementation::TextLayerGlyphRun& run = state.glyphRuns[glyphRun];
+            /* Skip runs that were removed or reshaped since */
+            if(run.glyphOffset == ~UnsignedInt{} || run.data == ~UnsignedInt{} || run.pendingGlyphIdFont == ~UnsignedInt{})
+                continue;
+
+            /* Text with font fallbacks has the font ID saved for each
+               glyph */
+            if(run.pendingGlyphIdFont == Implementation::TextLayerGlyphRunPendingGlyphIdFontPerGlyph) {
+                for(Implementation::TextLayerGlyphData& glyph: state.glyphData.sliceSize(run.glyphOffset, run.glyphCount))
+                    glyph.glyphId = sharedState.glyphCache->glyphId(sharedState.fonts[glyph.glyphCluster].glyphCacheFontId, glyph.glyphId);
+            } else {
+                const UnsignedInt glyphCacheFontId = sharedState.fonts[run.pendingGlyphIdFont].glyphCacheFontId;
+                for(Implementation::TextLayerGlyphData& glyph: state.glyphData.sliceSize(run.glyphOffset, run.glyphCount))
+                    glyph.glyphId = sharedState.glyphCache->glyphId(glyphCacheFontId, glyph.glyphId);
+            }
+            run.pendingGlyphIdFont = ~UnsignedInt{};
+        }
+        arrayResize(state.glyphRunsWithPendingGlyphIds, 0);
+    }
+
+    #ifndef CORRADE_NO_ASSERT
+    if(shapes)
+        sharedState.updateShapingInProgress = false;
+    #endif
+
     /* Recompact the glyph / text data by removing unused runs. Do this only if
        data actually change, this isn't affected by anything node-related */
     /** @todo further restrict this to just NeedsCommonDataUpdate which gets
@@ -1948,12 +4078,16 @@ void TextLayer::doUpdate(const LayerStates states, const Containers::StridedArra
         update the actual index buffer etc anyway, so a dedicated state won't
         make that update any smaller, and we'd now trigger it from clean() and
         remove() as well, which we didn't need to before */
-    if(states >= LayerState::NeedsDataUpdate) {
+    /* With glyph run reuse, the unused runs are kept for reuse and the
+       recompaction is done only once they're over half of the glyph data, to
+       amortize the cost. The free lists are then cleared as all unused runs
+       get removed. */
+    if(states >= LayerState::NeedsDataUpdate && (!sharedState.glyphRunReuse || state.freeGlyphCount*2 > state.glyphData.size())) {
         std::size_t outputGlyphDataOffset = 0;
         std::size_t outputGlyphRunOffset = 0;
         for(std::size_t i = 0; i != state.glyphRuns.size(); ++i) {
             Implementation::TextLayerGlyphRun& run = state.glyphRuns[i];
-            if(run.glyphOffset == ~UnsignedInt{})
+            if(run.glyphOffset == ~UnsignedInt{} || run.data == ~UnsignedInt{})
                 continue;
 
             /* Move the glyph data earlier if there were skipped runs before,
@@ -1964,10 +4098,10 @@ void TextLayer::doUpdate(const LayerStates states, const Containers::StridedArra
 
                 std::memmove(state.glyphData.data() + outputGlyphDataOffset,
                              state.glyphData.data() + run.glyphOffset,
-                             run.glyphCount*sizeof(Implementation::TextLayerGlyphData));
+                             run.glyphCapacity*sizeof(Implementation::TextLayerGlyphData));
                 run.glyphOffset = outputGlyphDataOffset;
             }
-            outputGlyphDataOffset += run.glyphCount;
+            outputGlyphDataOffset += run.glyphCapacity;
 
             /* Move the glyph run info earlier if there were skipped runs
                before, update the reference to it in the data */
@@ -1984,6 +4118,9 @@ void TextLayer::doUpdate(const LayerStates states, const Containers::StridedArra
         CORRADE_INTERNAL_ASSERT(outputGlyphRunOffset <= state.glyphRuns.size());
         arrayResize(state.glyphData, outputGlyphDataOffset);
         arrayResize(state.glyphRuns, outputGlyphRunOffset);
+        for(Containers::Array<UnsignedInt>& freeGlyphRuns: state.freeGlyphRuns)
+            arrayResize(freeGlyphRuns, 0);
+        state.freeGlyphCount = 0;
     }
     /* Another scope to avoid accidental variable reuse, flattening it to avoid
        excessive indentation */
@@ -2006,7 +4143,8 @@ void TextLayer::doUpdate(const LayerStates states, const Containers::StridedArra
                              run.textSize);
                 run.textOffset = outputTextDataOffset;
             }
-            outputTextDataOffset += run.textSize;
+            /* Preserving the capacity so in-place edits can continue */
+            outputTextDataOffset += run.textCapacity;
 
             /* Move the text run info earlier if there were skipped runs
                before, update the reference to it in the data */
@@ -2025,12 +4163,78 @@ void TextLayer::doUpdate(const LayerStates states, const Containers::StridedArra
         arrayResize(state.textData, outputTextDataOffset);
         arrayResize(state.textRuns, outputTextRunOffset);
     }
+    /* And another for hibernation sources. These are never edited in place,
+       so the text and features are packed tightly. */
+    if(states & LayerState::NeedsDataUpdate) {
+        std::size_t outputTextDataOffset = 0;
+        std::size_t outputFeatureOffset = 0;
+        std::size_t outputSourceOffset = 0;
+        for(std::size_t i = 0; i != state.hibernationSources.size(); ++i) {
+            Implementation::TextLayerHibernationSource& source = state.hibernationSources[i];
+            if(source.data == ~UnsignedInt{})
+                continue;
+
+            /* Move the text and feature data earlier if there were skipped
+               sources before, update the references to them in the source */
+            if(source.textOffset != outputTextDataOffset) {
+                CORRADE_INTERNAL_DEBUG_ASSERT(source.textOffset > outputTextDataOffset);
+                std::memmove(state.hibernationSourceTextData.data() + outputTextDataOffset,
+                             state.hibernationSourceTextData.data() + source.textOffset,
+                             source.textSize);
+                source.textOffset = outputTextDataOffset;
+            }
+            outputTextDataOffset += source.textSize;
+            if(source.featureOffset != outputFeatureOffset) {
+                CORRADE_INTERNAL_DEBUG_ASSERT(source.featureOffset > outputFeatureOffset);
+                std::memmove(state.hibernationSourceFeatures.data() + outputFeatureOffset,
+                             state.hibernationSourceFeatures.data() + source.featureOffset,
+                             source.featureCount*sizeof(Text::FeatureRange));
+                source.featureOffset = outputFeatureOffset;
+            }
+            outputFeatureOffset += source.featureCount;
+
+            /* Move the source info earlier if there were skipped sources
+               before, update the reference to it in the data */
+            if(i != outputSourceOffset) {
+                CORRADE_INTERNAL_DEBUG_ASSERT(i > outputSourceOffset);
+                CORRADE_INTERNAL_DEBUG_ASSERT(state.data[source.data].hibernationSource == i);
+                state.data[source.data].hibernationSource = outputSourceOffset;
+                state.hibernationSources[outputSourceOffset] = source;
+            }
+            ++outputSourceOffset;
+        }
+
+        /* Remove the now-unused data from the end */
+        CORRADE_INTERNAL_ASSERT(outputTextDataOffset <= state.hibernationSourceTextData.size());
+        CORRADE_INTERNAL_ASSERT(outputFeatureOffset <= state.hibernationSourceFeatures.size());
+        CORRADE_INTERNAL_ASSERT(outputSourceOffset <= state.hibernationSources.size());
+        arrayResize(state.hibernationSourceTextData, outputTextDataOffset);
+        arrayResize(state.hibernationSourceFeatures, outputFeatureOffset);
+        arrayResize(state.hibernationSources, outputSourceOffset);
+    }
+
+    /* If any data are clipped, glyphs that are fully outside of the clip
+       rect are culled from the index buffer after the vertex data are
+       generated below. Instanced glyphs are drawn by a contiguous range of
+       instances for each data, so there it's left to the scissor. */
+    bool cullGlyphs = false;
+    if(!sharedState.instancedGlyphs) for(const UnsignedInt clipRectId: clipRectIds) {
+        if(!clipRectSizes[clipRectId].isZero()) {
+            cullGlyphs = true;
+            break;
+        }
+    }
 
     /* Fill in indices in desired order if either the data themselves or the
-       node order changed */
-    if(states >= LayerState::NeedsNodeOrderUpdate ||
-       states >= LayerState::NeedsDataUpdate)
-    {
+       node order changed. With culling, the glyph indices depend on the
+       vertex positions, which can additionally change with node enablement
+       (and thus calculated styles and their padding). Offset and size changes
+       imply a node order update already. */
+    const bool updateIndices =
+        states >= LayerState::NeedsNodeOrderUpdate ||
+        states >= LayerState::NeedsDataUpdate ||
+        (cullGlyphs && states >= LayerState::NeedsNodeEnabledUpdate);
+    if(updateIndices) {
         /* Index offsets for each run, plus one more for the last run */
         arrayResize(state.indexDrawOffsets, NoInit, dataIds.size() + 1);
 
@@ -2063,8 +4267,10 @@ void TextLayer::doUpdate(const LayerStates states, const Containers::StridedArra
             }
         }
 
-        /* Generate index data */
-        arrayResize(state.indices, NoInit, drawGlyphCount*6);
+        /* Generate index data. With instanced glyphs there are no glyph
+           indices, but the draw offsets are still calculated in the same
+           units. */
+        arrayResize(state.indices, NoInit, sharedState.instancedGlyphs ? 0 : drawGlyphCount*6);
         arrayResize(state.editingIndices, NoInit, drawEditingRectCount*6);
         UnsignedInt indexOffset = 0;
         UnsignedInt editingRectOffset = 0;
@@ -2075,9 +4281,9 @@ void TextLayer::doUpdate(const LayerStates states, const Containers::StridedArra
             /* Generate indices in draw order. Remeber the offset for each data
                to draw from later. */
             state.indexDrawOffsets[i] = {indexOffset, editingRectOffset*6};
-            const Containers::ArrayView<UnsignedInt> indexData = state.indices.sliceSize(indexOffset, glyphRun.glyphCount*6);
-            Text::renderGlyphQuadIndicesInto(glyphRun.glyphOffset, indexData);
-            indexOffset += indexData.size();
+            if(!sharedState.instancedGlyphs)
+                Text::renderGlyphQuadIndicesInto(glyphRun.glyphOffset, state.indices.sliceSize(indexOffset, glyphRun.glyphCount*6));
+            indexOffset += glyphRun.glyphCount*6;
 
             /* If the text is editable, generate indices for cursor and
                selection as well. They're currently both drawn in the same
@@ -2146,30 +4352,173 @@ void TextLayer::doUpdate(const LayerStates states, const Containers::StridedArra
     if(states >= LayerState::NeedsNodeOffsetSizeUpdate ||
        states >= LayerState::NeedsNodeEnabledUpdate ||
        states >= LayerState::NeedsNodeOpacityUpdate ||
-       states >= LayerState::NeedsDataUpdate)
+       states >= LayerState::NeedsDataUpdate ||
+       /* Instances are in draw order, so they have to be regenerated if the
+          order changes */
+       (sharedState.instancedGlyphs && states >= LayerState::NeedsNodeOrderUpdate))
     {
-        /* Calculate how many glyphs there are in total */
-        UnsignedInt totalGlyphCount = 0;
-        for(const Implementation::TextLayerGlyphRun& run: state.glyphRuns)
-            totalGlyphCount += run.glyphCount;
-
-        const Containers::StridedArrayView1D<const Ui::NodeHandle> nodes = this->nodes();
+        /* With instanced glyphs there's one instance for each drawn glyph, in
+           draw order. If the count changes, all instances need to be
+           updated. */
+        if(sharedState.instancedGlyphs) {
+            UnsignedInt drawGlyphCount = 0;
+            for(const UnsignedInt dataId: dataIds)
+                drawGlyphCount += state.glyphRuns[state.data[dataId].glyphRun].glyphCount;
+            if(state.glyphInstances.size() != drawGlyphCount) {
+                arrayResize(state.glyphInstances, NoInit, drawGlyphCount);
+                state.vertexUpdateBegin = 0;
+                state.vertexUpdateEnd = state.glyphInstances.size();
+            }
 
-        /* Generate vertex data */
-        arrayResize(state.vertices, NoInit, totalGlyphCount*4);
+        /* Otherwise calculate how many glyphs there are in total. With glyph
+           run reuse the glyph data contain unused capacity and free runs, and
+           glyph offsets are used to index the vertex data as well, so it has
+           to be the whole size. If the size changes, the whole vertex data
+           need to be updated. */
+        } else {
+            UnsignedInt totalGlyphCount = 0;
+            if(sharedState.glyphRunReuse)
+                totalGlyphCount = state.glyphData.size();
+            else for(const Implementation::TextLayerGlyphRun& run: state.glyphRuns)
+                totalGlyphCount += run.glyphCount;
+
+            if(state.vertices.size() != totalGlyphCount*4) {
+                arrayResize(state.vertices, NoInit, totalGlyphCount*4);
+                state.vertexUpdateBegin = 0;
+                state.vertexUpdateEnd = state.vertices.size();
+            }
+        }
         if(sharedState.hasEditingStyles)
             arrayResize(state.editingVertices, NoInit, state.textRuns.size()*2*4);
-        for(const UnsignedInt dataId: dataIds) {
-            const UnsignedInt nodeId = nodeHandleId(nodes[dataId]);
-            const Implementation::TextLayerData& data = state.data[dataId];
-            const Implementation::TextLayerGlyphRun& glyphRun = state.glyphRuns[data.glyphRun];
 
-            /* Fill in quad vertices in the same order as the original text
-               runs */
-            /** @todo ideally this would only be done if some text actually
-                changes, not on every visibility change */
-            const Containers::StridedArrayView1D<const Implementation::TextLayerGlyphData> glyphData = state.glyphData.sliceSize(glyphRun.glyphOffset, glyphRun.glyphCount);
-            const Containers::StridedArrayView1D<Implementation::TextLayerVertex> vertexData = state.vertices.sliceSize(glyphRun.glyphOffset*4, glyphRun.glyphCount*4);
+        /* Each data writes to a disjoint part of the vertex or instance array
+           and the editing vertex array, so if there's an executor and enough
+           data, the work is split into tasks that can run in parallel. Each
+           task has its own scratch memory and updated range, which are merged
+           together after. */
+        const UnsignedInt taskCount = state.vertexExecutor && dataIds.size() > Implementation::TextLayerVertexTaskDataCount ?
+            UnsignedInt((dataIds.size() + Implementation::TextLayerVertexTaskDataCount - 1)/Implementation::TextLayerVertexTaskDataCount) : 1;
+        if(state.vertexTasks.size() < taskCount)
+            arrayResize(state.vertexTasks, taskCount);
+        UnsignedInt instanceOffset = 0;
+        for(UnsignedInt i = 0; i != taskCount; ++i) {
+            Implementation::TextLayerVertexTask& task = state.vertexTasks[i];
+            task.dataBegin = std::size_t{i}*Implementation::TextLayerVertexTaskDataCount;
+            task.dataEnd = i + 1 == taskCount ? dataIds.size() : task.dataBegin + Implementation::TextLayerVertexTaskDataCount;
+            task.vertexUpdateBegin = ~UnsignedInt{};
+            task.vertexUpdateEnd = 0;
+
+            /* Instances are in draw order, so each task needs to know where
+               its instances start */
+            task.instanceOffset = instanceOffset;
+            if(sharedState.instancedGlyphs && i + 1 != taskCount)
+                for(const UnsignedInt dataId: dataIds.slice(task.dataBegin, task.dataEnd))
+                    instanceOffset += state.glyphRuns[state.data[dataId].glyphRun].glyphCount;
+        }
+
+        if(taskCount > 1) {
+            struct TaskState {
+                TextLayer& self;
+                const Containers::StridedArrayView1D<const UnsignedInt>& dataIds;
+                const Containers::StridedArrayView1D<const Vector2>& nodeOffsets;
+                const Containers::StridedArrayView1D<const Vector2>& nodeSizes;
+                const Containers::StridedArrayView1D<const Float>& nodeOpacities;
+            } taskState{*this, dataIds, nodeOffsets, nodeSizes, nodeOpacities};
+            state.vertexExecutor(taskCount, [](void* taskStatePointer, UnsignedInt index) {
+                const TaskState& taskState = *static_cast<const TaskState*>(taskStatePointer);
+                taskState.self.updateVerticesInternal(taskState.dataIds, taskState.nodeOffsets, taskState.nodeSizes, taskState.nodeOpacities, index);
+            }, &taskState, state.vertexExecutorUserData);
+        } else updateVerticesInternal(dataIds, nodeOffsets, nodeSizes, nodeOpacities, 0);
+
+        for(const Implementation::TextLayerVertexTask& task: state.vertexTasks.prefix(taskCount)) {
+            state.vertexUpdateBegin = Math::min(state.vertexUpdateBegin, task.vertexUpdateBegin);
+            state.vertexUpdateEnd = Math::max(state.vertexUpdateEnd, task.vertexUpdateEnd);
+        }
+    }
+
+    /* Cull glyphs that are fully outside of their clip rect from the index
+       buffer, now that the vertex positions are known. Done in place in draw
+       order, adjusting the per-data draw offsets. */
+    if(updateIndices && cullGlyphs) {
+        UnsignedInt indexOffset = 0;
+        std::size_t dataOffset = 0;
+        for(std::size_t i = 0; i != clipRectIds.size(); ++i) {
+            const Vector2 clipRectSize = clipRectSizes[clipRectIds[i]];
+            const Range2D clipRect = Range2D::fromSize(clipRectOffsets[clipRectIds[i]], clipRectSize);
+            for(std::size_t j = dataOffset, jMax = dataOffset + clipRectDataCounts[i]; j != jMax; ++j) {
+                const UnsignedInt indexBegin = state.indexDrawOffsets[j].first();
+                const UnsignedInt indexEnd = state.indexDrawOffsets[j + 1].first();
+                state.indexDrawOffsets[j].first() = indexOffset;
+                for(UnsignedInt k = indexBegin; k != indexEnd; k += 6) {
+                    /* The first index of each glyph quad is its first
+                       vertex, the quad is the four vertices after */
+                    if(!clipRectSize.isZero()) {
+                        const Containers::ArrayView<const Implementation::TextLayerVertex> quad = state.vertices.sliceSize(state.indices[k] & ~3u, 4);
+                        Range2D quadRect{quad[0].position, quad[0].position};
+                        for(const Implementation::TextLayerVertex& vertex: quad.exceptPrefix(1)) {
+                            quadRect.min() = Math::min(quadRect.min(), vertex.position);
+                            quadRect.max() = Math::max(quadRect.max(), vertex.position);
+                        }
+                        if(!Math::intersects(clipRect, quadRect))
+                            continue;
+                    }
+
+                    if(k != indexOffset) for(UnsignedInt l = 0; l != 6; ++l)
+                        state.indices[indexOffset + l] = state.indices[k + l];
+                    indexOffset += 6;
+                }
+            }
+            dataOffset += clipRectDataCounts[i];
+        }
+
+        CORRADE_INTERNAL_ASSERT(dataOffset == dataIds.size());
+        state.indexDrawOffsets[dataIds.size()].first() = indexOffset;
+        arrayResize(state.indices, indexOffset);
+    }
+
+    /* Sync the style update stamp to not have doState() return NeedsDataUpdate
+       / NeedsCommonDataUpdate again next time it's asked */
+    if(states >= LayerState::NeedsDataUpdate ||
+       states >= LayerState::NeedsCommonDataUpdate) {
+        state.styleUpdateStamp = sharedState.styleUpdateStamp;
+        state.editingStyleUpdateStamp = sharedState.editingStyleUpdateStamp;
+    }
+}
+
+void TextLayer::updateVerticesInternal(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, const UnsignedInt taskId) {
+    State& state = static_cast<State&>(*_state);
+    const Shared::State& sharedState = static_cast<const Shared::State&>(state.shared);
+    Implementation::TextLayerVertexTask& task = state.vertexTasks[taskId];
+    const Containers::StridedArrayView1D<const Ui::NodeHandle> nodes = this->nodes();
+
+    UnsignedInt instanceOffset = task.instanceOffset;
+    for(const UnsignedInt dataId: dataIds.slice(task.dataBegin, task.dataEnd)) {
+        const UnsignedInt nodeId = nodeHandleId(nodes[dataId]);
+        const Implementation::TextLayerData& data = state.data[dataId];
+        const Implementation::TextLayerGlyphRun& glyphRun = state.glyphRuns[data.glyphRun];
+
+        /* Fill in quad vertices in the same order as the original text
+           runs */
+        /** @todo ideally this would only be done if some text actually
+            changes, not on every visibility change */
+        const Containers::StridedArrayView1D<const Implementation::TextLayerGlyphData> glyphData = state.glyphData.sliceSize(glyphRun.glyphOffset, glyphRun.glyphCount);
+        /* Generate into a scratch array first, which is then compared to
+           the previous contents to know what changed. Instances only
+           reference the glyph in the cache, vertices contain the actual
+           quad. */
+        Containers::StridedArrayView1D<Implementation::TextLayerVertex> vertexData;
+        Containers::ArrayView<Implementation::TextLayerGlyphInstance> instanceData;
+        if(sharedState.instancedGlyphs) {
+            arrayResize(task.glyphInstanceScratch, NoInit, glyphRun.glyphCount);
+            instanceData = task.glyphInstanceScratch;
+            for(std::size_t i = 0; i != glyphData.size(); ++i) {
+                instanceData[i].position = glyphData[i].position;
+                instanceData[i].scale = data.scale;
+                instanceData[i].glyphId = glyphData[i].glyphId;
+            }
+        } else {
+            arrayResize(task.vertexScratch, NoInit, glyphRun.glyphCount*4);
+            vertexData = task.vertexScratch;
             Text::renderGlyphQuadsInto(
                 *sharedState.glyphCache,
                 data.scale,
@@ -2177,189 +4526,197 @@ void TextLayer::doUpdate(const LayerStates states, const Containers::StridedArra
                 glyphData.slice(&Implementation::TextLayerGlyphData::glyphId),
                 vertexData.slice(&Implementation::TextLayerVertex::position),
                 vertexData.slice(&Implementation::TextLayerVertex::textureCoordinates));
+        }
 
-            /* Align the glyph run relative to the node area */
-            Vector4 padding = data.padding;
-            if(data.calculatedStyle < sharedState.styleCount)
-                padding += sharedState.styles[data.calculatedStyle].padding;
-            else {
-                CORRADE_INTERNAL_DEBUG_ASSERT(data.calculatedStyle < sharedState.styleCount + sharedState.dynamicStyleCount);
-                padding += state.dynamicStyles[data.calculatedStyle - sharedState.styleCount].padding;
-            }
-            Vector2 offset = nodeOffsets[nodeId] + padding.xy();
-            const Vector2 size = nodeSizes[nodeId] - padding.xy() - Math::gather<'z', 'w'>(padding);
-            const UnsignedByte alignmentHorizontal = (UnsignedByte(data.alignment) & Text::Implementation::AlignmentHorizontal);
-            if(alignmentHorizontal == Text::Implementation::AlignmentLeft) {
-                offset.x() += 0.0f;
-            } else if(alignmentHorizontal == Text::Implementation::AlignmentRight) {
-                offset.x() += size.x();
-            } else if(alignmentHorizontal == Text::Implementation::AlignmentCenter) {
-                if(UnsignedByte(data.alignment) & Text::Implementation::AlignmentIntegral)
-                    offset.x() += Math::round(size.x()*0.5f);
-                else
-                    offset.x() += size.x()*0.5f;
-            }
-            const UnsignedByte alignmentVertical = (UnsignedByte(data.alignment) & Text::Implementation::AlignmentVertical);
-            /* For Line/Middle it's aligning either the line or bounding box
-               middle (which is already at y=0 by the Text::alignRenderedLine())
-               to node middle */
-            if(alignmentVertical == Text::Implementation::AlignmentTop) {
-                offset.y() += 0.0f;
-            } else if(alignmentVertical == Text::Implementation::AlignmentBottom) {
-                offset.y() += size.y();
-            } else if(alignmentVertical == Text::Implementation::AlignmentLine ||
-                      alignmentVertical == Text::Implementation::AlignmentMiddle) {
-                if(UnsignedByte(data.alignment) & Text::Implementation::AlignmentIntegral)
-                    offset.y() += Math::round(size.y()*0.5f);
-                else
-                    offset.y() += size.y()*0.5f;
+        /* Align the glyph run relative to the node area */
+        Vector4 padding = data.padding;
+        if(data.calculatedStyle < sharedState.styleCount)
+            padding += sharedState.styles[data.calculatedStyle].padding;
+        else {
+            CORRADE_INTERNAL_DEBUG_ASSERT(data.calculatedStyle < sharedState.styleCount + sharedState.dynamicStyleCount);
+            padding += state.dynamicStyles[data.calculatedStyle - sharedState.styleCount].padding;
+        }
+        const Vector2 offset = alignedOffset(nodeOffsets[nodeId], nodeSizes[nodeId], padding, data.alignment);
+
+        /* Translate the (aligned) glyph run, fill color and style. For
+           dynamic styles the uniform mapping is implicit and they're
+           placed right after all non-dynamic styles. */
+        const Float opacity = nodeOpacities[nodeId];
+        const UnsignedInt styleUniform = data.calculatedStyle < sharedState.styleCount ?
+            sharedState.styles[data.calculatedStyle].uniform :
+            sharedState.styleUniformCount + data.calculatedStyle - sharedState.styleCount;
+        for(Implementation::TextLayerVertex& vertex: vertexData) {
+            vertex.position = vertex.position*Vector2::yScale(-1.0f) + offset;
+            vertex.color = data.color*opacity;
+            vertex.styleUniform = styleUniform;
+        }
+        if(!instanceData.isEmpty()) {
+            const Color4ub color = Math::pack<Color4ub>(Math::clamp(data.color*opacity, 0.0f, 1.0f));
+            for(Implementation::TextLayerGlyphInstance& instance: instanceData) {
+                instance.position = instance.position*Vector2::yScale(-1.0f) + offset;
+                instance.color = color;
+                instance.styleUniform = styleUniform;
             }
+        }
 
-            /* Translate the (aligned) glyph run, fill color and style */
-            const Float opacity = nodeOpacities[nodeId];
-            for(Implementation::TextLayerVertex& vertex: vertexData) {
-                vertex.position = vertex.position*Vector2::yScale(-1.0f) + offset;
-                vertex.color = data.color*opacity;
-                /* For dynamic styles the uniform mapping is implicit and they're
-                   placed right after all non-dynamic styles */
-                vertex.styleUniform = data.calculatedStyle < sharedState.styleCount ?
-                    sharedState.styles[data.calculatedStyle].uniform :
-                    sharedState.styleUniformCount + data.calculatedStyle - sharedState.styleCount;
+        /* If the text is editable, generate also the cursor and selection
+           mesh, unless they don't have any style */
+        if(data.textRun != ~UnsignedInt{}) {
+            Int cursorStyle, selectionStyle;
+            /** @todo ugh, this is duplicated three times */
+            if(data.calculatedStyle < sharedState.styleCount) {
+                const Implementation::TextLayerStyle& style = sharedState.styles[data.calculatedStyle];
+                cursorStyle = style.cursorStyle;
+                selectionStyle = style.selectionStyle;
+            } else {
+                CORRADE_INTERNAL_DEBUG_ASSERT(data.calculatedStyle < sharedState.styleCount + sharedState.dynamicStyleCount);
+                const UnsignedInt dynamicStyleId = data.calculatedStyle - sharedState.styleCount;
+                cursorStyle = state.dynamicStyleCursorStyles[dynamicStyleId] ? Implementation::cursorStyleForDynamicStyle(dynamicStyleId) : -1;
+                selectionStyle = state.dynamicStyleSelectionStyles[dynamicStyleId] ? Implementation::selectionStyleForDynamicStyle(dynamicStyleId) : -1;
             }
-
-            /* If the text is editable, generate also the cursor and selection
-               mesh, unless they don't have any style */
-            if(data.textRun != ~UnsignedInt{}) {
-                Int cursorStyle, selectionStyle;
-                /** @todo ugh, this is duplicated three times */
-                if(data.calculatedStyle < sharedState.styleCount) {
-                    const Implementation::TextLayerStyle& style = sharedState.styles[data.calculatedStyle];
-                    cursorStyle = style.cursorStyle;
-                    selectionStyle = style.selectionStyle;
+            const Implementation::TextLayerTextRun& textRun = state.textRuns[data.textRun];
+            const Containers::Pair<UnsignedInt, UnsignedInt> glyphRangeForCursorSelection = Text::glyphRangeForBytes(glyphData.slice(&Implementation::TextLayerGlyphData::glyphCluster), textRun.cursor, textRun.selection);
+
+            /* The rectangle is Y-up, which means the max() is the top and
+               we need to subtract it from the offset, and min() is bottom,
+               negative, and thus we need to subtract it also */
+            /** @todo use the other coordinate if the shape direction is
+                vertical */
+            const Vector2 lineBottom = offset - Vector2::yAxis(data.rectangle.min().y());
+            const Vector2 lineTop = offset - Vector2::yAxis(data.rectangle.max().y());
+            const auto cursorPositionForGlyph = [&data, &glyphData](const UnsignedInt glyph) {
+                /** @todo The glyph position includes also the additional
+                    shaper offset, which isn't desirable for cursor
+                    placement. Often it's just 0, but sometimes it could be
+                    different e.g. for diacritics placement, and then the
+                    cursor could be weirdly shifted. Ideally the offset
+                    would be stored separately and not included here, but
+                    that's one extra float per glyph :/ The Y offset is
+                    already ignored as only the X is taken. */
+                return Vector2::xAxis(glyph == glyphData.size() ?
+                    data.rectangle.max().x() : glyphData[glyph].position.x());
+            };
+            const auto createEditingQuad = [&state, &sharedState, &lineTop, &lineBottom, &cursorPositionForGlyph, &vertexData, &instanceData](const bool dynamicEditingStyle, const UnsignedInt editingStyleId, const UnsignedInt glyphBegin, const UnsignedInt glyphEnd, const UnsignedInt vertexOffset, Text::ShapeDirection direction, Float opacity) {
+                Vector4 padding{NoInit};
+                UnsignedInt uniform;
+                Int textUniform;
+                if(!dynamicEditingStyle) {
+                    CORRADE_INTERNAL_DEBUG_ASSERT(editingStyleId < sharedState.editingStyles.size());
+                    const Implementation::TextLayerEditingStyle& editingStyle = sharedState.editingStyles[editingStyleId];
+                    padding = editingStyle.padding;
+                    uniform = editingStyle.uniform;
+                    textUniform = editingStyle.textUniform;
                 } else {
-                    CORRADE_INTERNAL_DEBUG_ASSERT(data.calculatedStyle < sharedState.styleCount + sharedState.dynamicStyleCount);
-                    const UnsignedInt dynamicStyleId = data.calculatedStyle - sharedState.styleCount;
-                    cursorStyle = state.dynamicStyleCursorStyles[dynamicStyleId] ? Implementation::cursorStyleForDynamicStyle(dynamicStyleId) : -1;
-                    selectionStyle = state.dynamicStyleSelectionStyles[dynamicStyleId] ? Implementation::selectionStyleForDynamicStyle(dynamicStyleId) : -1;
+                    CORRADE_INTERNAL_DEBUG_ASSERT(editingStyleId < sharedState.dynamicStyleCount*2);
+                    /* Contrary to data.calculatedStyle, dynamic
+                       editingStyleId doesn't have any extra offset because
+                       it's never controlled from outside where it could
+                       get mixed up with static styles */
+                    padding = state.dynamicEditingStylePaddings[editingStyleId];
+                    /* Thus it's ID is also directly the uniform index
+                       *after* static styles */
+                    uniform = sharedState.editingStyleUniformCount + editingStyleId;
+                    /* And the text uniform also points after static
+                       styles */
+                    textUniform = sharedState.styleUniformCount + Implementation::textUniformForEditingStyle(sharedState.dynamicStyleCount, editingStyleId);
                 }
-                const Implementation::TextLayerTextRun& textRun = state.textRuns[data.textRun];
-                const Containers::Pair<UnsignedInt, UnsignedInt> glyphRangeForCursorSelection = Text::glyphRangeForBytes(glyphData.slice(&Implementation::TextLayerGlyphData::glyphCluster), textRun.cursor, textRun.selection);
-
-                /* The rectangle is Y-up, which means the max() is the top and
-                   we need to subtract it from the offset, and min() is bottom,
-                   negative, and thus we need to subtract it also */
-                /** @todo use the other coordinate if the shape direction is
-                    vertical */
-                const Vector2 lineBottom = offset - Vector2::yAxis(data.rectangle.min().y());
-                const Vector2 lineTop = offset - Vector2::yAxis(data.rectangle.max().y());
-                const auto cursorPositionForGlyph = [&data, &glyphData](const UnsignedInt glyph) {
-                    /** @todo The glyph position includes also the additional
-                        shaper offset, which isn't desirable for cursor
-                        placement. Often it's just 0, but sometimes it could be
-                        different e.g. for diacritics placement, and then the
-                        cursor could be weirdly shifted. Ideally the offset
-                        would be stored separately and not included here, but
-                        that's one extra float per glyph :/ The Y offset is
-                        already ignored as only the X is taken. */
-                    return Vector2::xAxis(glyph == glyphData.size() ?
-                        data.rectangle.max().x() : glyphData[glyph].position.x());
-                };
-                const auto createEditingQuad = [&state, &sharedState, &lineTop, &lineBottom, &cursorPositionForGlyph, &vertexData](const bool dynamicEditingStyle, const UnsignedInt editingStyleId, const UnsignedInt glyphBegin, const UnsignedInt glyphEnd, const UnsignedInt vertexOffset, Text::ShapeDirection direction, Float opacity) {
-                    Vector4 padding{NoInit};
-                    UnsignedInt uniform;
-                    Int textUniform;
-                    if(!dynamicEditingStyle) {
-                        CORRADE_INTERNAL_DEBUG_ASSERT(editingStyleId < sharedState.editingStyles.size());
-                        const Implementation::TextLayerEditingStyle& editingStyle = sharedState.editingStyles[editingStyleId];
-                        padding = editingStyle.padding;
-                        uniform = editingStyle.uniform;
-                        textUniform = editingStyle.textUniform;
-                    } else {
-                        CORRADE_INTERNAL_DEBUG_ASSERT(editingStyleId < sharedState.dynamicStyleCount*2);
-                        /* Contrary to data.calculatedStyle, dynamic
-                           editingStyleId doesn't have any extra offset because
-                           it's never controlled from outside where it could
-                           get mixed up with static styles */
-                        padding = state.dynamicEditingStylePaddings[editingStyleId];
-                        /* Thus it's ID is also directly the uniform index
-                           *after* static styles */
-                        uniform = sharedState.editingStyleUniformCount + editingStyleId;
-                        /* And the text uniform also points after static
-                           styles */
-                        textUniform = sharedState.styleUniformCount + Implementation::textUniformForEditingStyle(sharedState.dynamicStyleCount, editingStyleId);
-                    }
 
-                    /* LTR text interprets padding as left, top, right, bottom,
-                       RTL as right, top, left, bottom */
-                    if(direction == Text::ShapeDirection::RightToLeft)
-                        padding = Math::gather<'z', 'y', 'x', 'w'>(padding);
-
-                    /* 0---1
-                       |   |
-                       |   |
-                       |   |
-                       2---3 */
-                    const Vector2 min = lineTop + cursorPositionForGlyph(glyphBegin) - padding.xy();
-                    const Vector2 max = lineBottom + cursorPositionForGlyph(glyphEnd) + Math::gather<'z', 'w'>(padding);
-                    const Vector2 sizeHalf = (max - min)*0.5f;
-                    const Vector2 sizeHalfNegative = -sizeHalf;
-
-                    for(UnsignedByte j = 0; j != 4; ++j) {
-                        Implementation::TextLayerEditingVertex& vertex = state.editingVertices[vertexOffset + j];
-
-                        /* ✨ */
-                        vertex.position = Math::lerp(min, max, BitVector2{j});
-                        vertex.centerDistance = Math::lerp(sizeHalfNegative, sizeHalf, BitVector2{j});
-                        vertex.opacity = opacity;
-                        vertex.styleUniform = uniform;
-                    }
+                /* LTR text interprets padding as left, top, right, bottom,
+                   RTL as right, top, left, bottom */
+                if(direction == Text::ShapeDirection::RightToLeft)
+                    padding = Math::gather<'z', 'y', 'x', 'w'>(padding);
+
+                /* 0---1
+                   |   |
+                   |   |
+                   |   |
+                   2---3 */
+                const Vector2 min = lineTop + cursorPositionForGlyph(glyphBegin) - padding.xy();
+                const Vector2 max = lineBottom + cursorPositionForGlyph(glyphEnd) + Math::gather<'z', 'w'>(padding);
+                const Vector2 sizeHalf = (max - min)*0.5f;
+                const Vector2 sizeHalfNegative = -sizeHalf;
+
+                for(UnsignedByte j = 0; j != 4; ++j) {
+                    Implementation::TextLayerEditingVertex& vertex = state.editingVertices[vertexOffset + j];
+
+                    /* ✨ */
+                    vertex.position = Math::lerp(min, max, BitVector2{j});
+                    vertex.centerDistance = Math::lerp(sizeHalfNegative, sizeHalf, BitVector2{j});
+                    vertex.opacity = opacity;
+                    vertex.styleUniform = uniform;
+                }
 
-                    /* If the editing style has an override for the text
-                       uniform, apply it to the selected range */
-                    if(textUniform != -1) {
+                /* If the editing style has an override for the text
+                   uniform, apply it to the selected range */
+                if(textUniform != -1) {
+                    if(sharedState.instancedGlyphs) {
+                        for(Implementation::TextLayerGlyphInstance& instance: instanceData.slice(glyphBegin, glyphEnd))
+                            instance.styleUniform = textUniform;
+                    } else {
                         for(Implementation::TextLayerVertex& vertex: vertexData.slice(glyphBegin*4, glyphEnd*4))
                             vertex.styleUniform = textUniform;
                     }
-                };
-
-                /* Create a selection quad, if it has a style and there's a
-                   non-empty selection. It's drawn below the cursor, so it's
-                   first in the vertex buffer for given run (and first in the
-                   index buffer also). */
-                if(selectionStyle != -1 && textRun.selection != textRun.cursor) {
-                    const Containers::Pair<UnsignedInt, UnsignedInt> selection = Math::minmax(glyphRangeForCursorSelection.first(), glyphRangeForCursorSelection.second());
-                    createEditingQuad(
-                        data.calculatedStyle >= sharedState.styleCount,
-                        selectionStyle,
-                        selection.first(),
-                        selection.second(),
-                        data.textRun*2*4,
-                        data.usedDirection,
-                        nodeOpacities[nodeId]);
-                }
-                /* Create a cursor quad, if it has a style. It's drawn on top
-                   of the selection, so it's later in the vertex buffer for
-                   given run (and later in index buffer also) */
-                if(cursorStyle != -1) {
-                    createEditingQuad(
-                        data.calculatedStyle >= sharedState.styleCount,
-                        cursorStyle,
-                        glyphRangeForCursorSelection.first(),
-                        glyphRangeForCursorSelection.first(),
-                        data.textRun*2*4 + 4,
-                        data.usedDirection,
-                        nodeOpacities[nodeId]);
                 }
+            };
+
+            /* Create a selection quad, if it has a style and there's a
+               non-empty selection. It's drawn below the cursor, so it's
+               first in the vertex buffer for given run (and first in the
+               index buffer also). */
+            if(selectionStyle != -1 && textRun.selection != textRun.cursor) {
+                const Containers::Pair<UnsignedInt, UnsignedInt> selection = Math::minmax(glyphRangeForCursorSelection.first(), glyphRangeForCursorSelection.second());
+                createEditingQuad(
+                    data.calculatedStyle >= sharedState.styleCount,
+                    selectionStyle,
+                    selection.first(),
+                    selection.second(),
+                    data.textRun*2*4,
+                    data.usedDirection,
+                    nodeOpacities[nodeId]);
+            }
+            /* Create a cursor quad, if it has a style. It's drawn on top
+               of the selection, so it's later in the vertex buffer for
+               given run (and later in index buffer also) */
+            if(cursorStyle != -1) {
+                createEditingQuad(
+                    data.calculatedStyle >= sharedState.styleCount,
+                    cursorStyle,
+                    glyphRangeForCursorSelection.first(),
+                    glyphRangeForCursorSelection.first(),
+                    data.textRun*2*4 + 4,
+                    data.usedDirection,
+                    nodeOpacities[nodeId]);
             }
         }
-    }
 
-    /* Sync the style update stamp to not have doState() return NeedsDataUpdate
-       / NeedsCommonDataUpdate again next time it's asked */
-    if(states >= LayerState::NeedsDataUpdate ||
-       states >= LayerState::NeedsCommonDataUpdate) {
-        state.styleUpdateStamp = sharedState.styleUpdateStamp;
-        state.editingStyleUpdateStamp = sharedState.editingStyleUpdateStamp;
+        /* Copy the vertices or instances if they differ from what was
+           there before, extend the updated range. Done in fixed-size glyph
+           chunks so a long text with only a part of it changed updates just
+           the changed chunks. */
+        if(sharedState.instancedGlyphs) {
+            const Containers::ArrayView<Implementation::TextLayerGlyphInstance> instances = state.glyphInstances.sliceSize(instanceOffset, glyphRun.glyphCount);
+            for(UnsignedInt chunkBegin = 0; chunkBegin < glyphRun.glyphCount; chunkBegin += Implementation::TextLayerGlyphChunkSize) {
+                const UnsignedInt chunkSize = Math::min(Implementation::TextLayerGlyphChunkSize, glyphRun.glyphCount - chunkBegin);
+                if(std::memcmp(instances.data() + chunkBegin, instanceData.data() + chunkBegin, chunkSize*sizeof(Implementation::TextLayerGlyphInstance)) == 0)
+                    continue;
+
+                Utility::copy(instanceData.sliceSize(chunkBegin, chunkSize), instances.sliceSize(chunkBegin, chunkSize));
+                task.vertexUpdateBegin = Math::min(task.vertexUpdateBegin, instanceOffset + chunkBegin);
+                task.vertexUpdateEnd = Math::max(task.vertexUpdateEnd, instanceOffset + chunkBegin + chunkSize);
+            }
+            instanceOffset += glyphRun.glyphCount;
+        } else {
+            const Containers::ArrayView<Implementation::TextLayerVertex> vertices = state.vertices.sliceSize(glyphRun.glyphOffset*4, glyphRun.glyphCount*4);
+            for(UnsignedInt chunkBegin = 0; chunkBegin < glyphRun.glyphCount; chunkBegin += Implementation::TextLayerGlyphChunkSize) {
+                const UnsignedInt chunkSize = Math::min(Implementation::TextLayerGlyphChunkSize, glyphRun.glyphCount - chunkBegin);
+                if(std::memcmp(vertices.data() + chunkBegin*4, task.vertexScratch.data() + chunkBegin*4, chunkSize*4*sizeof(Implementation::TextLayerVertex)) == 0)
+                    continue;
+
+                Utility::copy(task.vertexScratch.sliceSize(chunkBegin*4, chunkSize*4), vertices.sliceSize(chunkBegin*4, chunkSize*4));
+                task.vertexUpdateBegin = Math::min(task.vertexUpdateBegin, (glyphRun.glyphOffset + chunkBegin)*4);
+                task.vertexUpdateEnd = Math::max(task.vertexUpdateEnd, (glyphRun.glyphOffset + chunkBegin + chunkSize)*4);
+            }
+        }
     }
 }
 
@@ -2409,7 +4766,10 @@ void TextLayer::doTextInputEvent(const UnsignedInt dataId, TextInputEvent& event
     if(!(data.flags >= TextDataFlag::Editable))
         return;
 
-    editTextInternal(dataId, TextEdit::InsertBeforeCursor, event.text());
+    /* With batching, the text is reshaped only once in the next doUpdate()
+       no matter how many events come until then */
+    const Shared::State& sharedState = static_cast<const Shared::State&>(state.shared);
+    editTextInternal(dataId, TextEdit::InsertBeforeCursor, event.text(), sharedState.textInputBatching);
 
     event.setAccepted();
 }
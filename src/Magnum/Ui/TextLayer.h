@@ -281,6 +281,9 @@ namespace Implementation {
         FontHandleIdBits = 15,
         FontHandleGenerationBits = 1
     };
+
+    struct TextLayerDeferredShape;
+    struct TextLayerHibernationSource;
 }
 
 /**
@@ -358,6 +361,58 @@ enum class TextDataFlag: UnsignedByte {
      *      @ref TextLayer::Shared::setEditingStyle()
      */
     Editable = 1 << 0,
+
+    /**
+     * Deferred shaping. The text isn't shaped directly in
+     * @ref TextLayer::create() or @ref TextLayer::setText() but only in the
+     * next @ref TextLayer::update(), optionally in parallel with other
+     * deferred texts if @ref TextLayer::setShapeExecutor() is set. Until
+     * then, a newly created text has no glyphs and a zero
+     * @ref TextLayer::size(), while text that's set with
+     * @ref TextLayer::setText() keeps showing the previous contents. Can't be
+     * combined with @ref TextDataFlag::Editable.
+     *
+     * The shaping uses and updates state in @ref TextLayer::Shared, such as
+     * the shape cache. Layers sharing the same @ref TextLayer::Shared
+     * instance thus can't be updated concurrently by an executor set in
+     * @ref AbstractUserInterface::setLayerUpdateExecutor() while they have
+     * deferred texts to shape, which is checked with an assertion in debug
+     * builds. Put such layers on a dedicated @ref TextLayer::Shared each if
+     * they should be updated in parallel.
+     * @m_since_latest
+     */
+    DeferredShaping = 1 << 1,
+
+    /**
+     * Size the node to the text. In @ref AbstractUserInterface::update(),
+     * right before layouters are run, the node the data is attached to is
+     * enlarged to fit @ref TextLayer::size() together with
+     * @ref TextLayer::padding(), so layouters can position the node and its
+     * neighbors based on the actual text size without a second update. The
+     * node size set with @ref AbstractUserInterface::setNodeSize() acts as a
+     * minimum. Style padding isn't included, as style transitions may change
+     * it on hover or press and the node size would change with it.
+     *
+     * Changing the text with @ref TextLayer::setText(),
+     * @relativeref{TextLayer,editText()} or
+     * @relativeref{TextLayer,updateText()}, changing the padding or removing
+     * the data causes the layout to be recalculated. If combined with
+     * @ref TextDataFlag::DeferredShaping, the size is known only after the
+     * text gets shaped in @ref TextLayer::update(), and the node gets resized
+     * in the update after.
+     * @m_since_latest
+     */
+    SizeToContent = 1 << 2,
+
+    /**
+     * Hibernatable text. The layer keeps a copy of the source string and
+     * @ref TextProperties, which allows @ref TextLayer::hibernate() to free
+     * the glyphs of a text that isn't visible and reshape it again in the
+     * next @ref TextLayer::update() in which it's visible. Can't be combined
+     * with @ref TextDataFlag::Editable.
+     * @m_since_latest
+     */
+    Hibernatable = 1 << 3,
 };
 
 /**
@@ -1124,6 +1179,131 @@ class MAGNUM_UI_EXPORT TextLayer: public AbstractVisualLayer {
         /** @overload */
         void setDynamicStyleWithSelection(UnsignedInt id, const TextLayerStyleUniform& uniform, FontHandle font, Text::Alignment alignment, std::initializer_list<TextFeatureValue> features, const Vector4& padding, const TextLayerEditingStyleUniform& selectionUniform, const Containers::Optional<TextLayerStyleUniform>& selectionTextUniform, const Vector4& selectionPadding);
 
+        /**
+         * @brief Deferred text shape executor
+         * @m_since_latest
+         *
+         * @cpp nullptr @ce by default, meaning texts with
+         * @ref TextDataFlag::DeferredShaping are shaped sequentially.
+         * @see @ref shapeExecutorUserData(), @ref setShapeExecutor()
+         */
+        auto shapeExecutor() const -> void(*)(UnsignedInt, void(*)(void*, UnsignedInt), void*, void*);
+
+        /**
+         * @brief Deferred text shape executor user data
+         * @m_since_latest
+         *
+         * Contents of the @p userData parameter passed to
+         * @ref setShapeExecutor().
+         */
+        void* shapeExecutorUserData() const;
+
+        /**
+         * @brief Set a deferred text shape executor
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * By default, texts with @ref TextDataFlag::DeferredShaping are
+         * shaped one after another in the next @ref update(). If an
+         * @p executor is set and there's more than one text to shape, the
+         * @p executor is called with the text count, a @p task function, its
+         * @p taskState and the @p userData pointer passed to this function.
+         * The executor is expected to call @p task with @p taskState and each
+         * index in range @cpp [0, count) @ce exactly once, in an arbitrary
+         * order and possibly from multiple threads concurrently, and return
+         * only after all calls finished. Each task call shapes a single text
+         * with a dedicated @relativeref{Magnum,Text::AbstractShaper} instance,
+         * which means the font plugins are expected to support concurrent
+         * shaping with multiple shaper instances. The shaped glyphs are then
+         * put together and positioned on the calling thread.
+         *
+         * Texts found in the shape cache, if enabled with
+         * @ref Shared::Configuration::setShapeCacheSize(), and multi-line
+         * texts, which are shaped line by line, aren't passed to the
+         * executor. Set the @p executor to @cpp nullptr @ce to go back to
+         * the default sequential behavior.
+         * @see @ref AbstractUserInterface::setLayerUpdateExecutor(),
+         *      @ref SnapLayouter::setUpdateExecutor()
+         */
+        TextLayer& setShapeExecutor(void(*executor)(UnsignedInt count, void(*task)(void* taskState, UnsignedInt index), void* taskState, void* userData), void* userData = nullptr);
+
+        /**
+         * @brief Max count of deferred texts shaped in a single update
+         * @m_since_latest
+         *
+         * @cpp 0 @ce by default, meaning all texts with
+         * @ref TextDataFlag::DeferredShaping are shaped in the next
+         * @ref update().
+         * @see @ref setDeferredShapeBudget()
+         */
+        UnsignedInt deferredShapeBudget() const;
+
+        /**
+         * @brief Set a max count of deferred texts shaped in a single update
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * Building a large screen at once may create thousands of texts with
+         * @ref TextDataFlag::DeferredShaping, which are then all shaped in a
+         * single @ref update(), causing a long frame. If @p budget is
+         * non-zero, at most @p budget texts get shaped in each
+         * @ref update() in the order they were created, together with adding
+         * their glyphs to the glyph cache if it's filled on demand. The
+         * remaining texts are shaped in the following updates, with
+         * @ref state() reporting @ref LayerState::NeedsDataUpdate until all
+         * are processed. Until then, a newly created text has no glyphs and
+         * thus isn't visible, while a text changed with @ref setText() keeps
+         * showing the previous contents, same as if its shaping wasn't done
+         * yet. Set the @p budget to @cpp 0 @ce to go back to the default
+         * behavior.
+         */
+        TextLayer& setDeferredShapeBudget(UnsignedInt budget);
+
+        /**
+         * @brief Vertex generation executor
+         * @m_since_latest
+         *
+         * @cpp nullptr @ce by default, meaning glyph quads are generated
+         * sequentially.
+         * @see @ref vertexExecutorUserData(), @ref setVertexExecutor()
+         */
+        auto vertexExecutor() const -> void(*)(UnsignedInt, void(*)(void*, UnsignedInt), void*, void*);
+
+        /**
+         * @brief Vertex generation executor user data
+         * @m_since_latest
+         *
+         * Contents of the @p userData parameter passed to
+         * @ref setVertexExecutor().
+         */
+        void* vertexExecutorUserData() const;
+
+        /**
+         * @brief Set a vertex generation executor
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * By default, glyph quads and cursor and selection quads for all
+         * visible texts are generated one after another in @ref update(). If
+         * an @p executor is set and there's more than 256 texts to update,
+         * the work is split into batches of 256 texts and the @p executor is
+         * called with the batch count, a @p task function, its @p taskState
+         * and the @p userData pointer passed to this function. The executor
+         * is expected to call @p task with @p taskState and each index in
+         * range @cpp [0, count) @ce exactly once, in an arbitrary order and
+         * possibly from multiple threads concurrently, and return only after
+         * all calls finished. Each batch writes to a disjoint range of the
+         * vertex data, the result is the same as with the sequential
+         * generation.
+         *
+         * Shaping, glyph cache filling and index generation isn't affected by
+         * this executor. Set the @p executor to @cpp nullptr @ce to go back
+         * to the default sequential behavior.
+         * @see @ref setShapeExecutor(), @ref BaseLayer::setVertexExecutor(),
+         *      @ref AbstractUserInterface::setLayerUpdateExecutor()
+         */
+        TextLayer& setVertexExecutor(void(*executor)(UnsignedInt count, void(*task)(void* taskState, UnsignedInt index), void* taskState, void* userData), void* userData = nullptr);
+
         /**
          * @brief Create a text
          * @param style         Style index
@@ -1145,6 +1325,15 @@ class MAGNUM_UI_EXPORT TextLayer: public AbstractVisualLayer {
          * single glyphs (such as various icons or images) with
          * @ref createGlyph().
          *
+         * If @p text contains @cpp '\n' @ce and @p flags don't contain
+         * @ref TextDataFlag::Editable, each line is shaped separately and
+         * the lines are placed below each other by
+         * @ref Text::AbstractFont::lineHeight(), aligned according to the
+         * alignment coming from @p style or @p properties. The direction of
+         * the first line decides the direction-dependent alignment of the
+         * whole text. Editable text is currently always laid out as a single
+         * line.
+         *
          * If @p flags contain @ref TextDataFlag::Editable, the @p text and
          * @p properties are remembered and subsequently accessible through
          * @ref text() and @ref textProperties(), @ref cursor() position and
@@ -1152,6 +1341,10 @@ class MAGNUM_UI_EXPORT TextLayer: public AbstractVisualLayer {
          * text, the @p properties are expected to have empty
          * @ref TextProperties::features() --- only the features supplied by
          * the style are used for editable text.
+         *
+         * If @p flags contain @ref TextDataFlag::DeferredShaping, the text is
+         * shaped only in the next @ref update() and until then has no glyphs.
+         * It's not possible to combine it with @ref TextDataFlag::Editable.
          * @see @ref Shared::hasFontInstance(), @ref setText(),
          *      @ref setColor(), @ref setPadding(), @ref setCursor(),
          *      @ref updateText(), @ref editText()
@@ -1375,6 +1568,79 @@ class MAGNUM_UI_EXPORT TextLayer: public AbstractVisualLayer {
          */
         Vector2 size(LayerDataHandle handle) const;
 
+        /**
+         * @brief Hibernate a text
+         * @m_since_latest
+         *
+         * Frees glyphs of the text, which then get regenerated from the source
+         * string and properties remembered in @ref create() or @ref setText()
+         * in the next @ref update() in which the data are visible. Meant to be
+         * called for data in hidden subtrees, such as inactive screens, to
+         * reduce their memory use. The @ref size() is kept, so the layout
+         * isn't affected. If the text has @ref TextDataFlag::DeferredShaping
+         * and wasn't shaped yet, the function does nothing.
+         *
+         * Expects that @p handle is valid and the text has
+         * @ref TextDataFlag::Hibernatable set. Calling this function causes
+         * @ref LayerState::NeedsDataUpdate to be set.
+         * @see @ref isHandleValid(DataHandle) const, @ref isHibernated()
+         */
+        void hibernate(DataHandle handle);
+
+        /**
+         * @brief Hibernate a text assuming it belongs to this layer
+         * @m_since_latest
+         *
+         * Like @ref hibernate(DataHandle) but without checking that @p handle
+         * indeed belongs to this layer. See its documentation for more
+         * information.
+         */
+        void hibernate(LayerDataHandle handle);
+
+        /**
+         * @brief Whether a text is hibernated
+         * @m_since_latest
+         *
+         * Returns @cpp true @ce if @ref hibernate() was called for the text
+         * and it wasn't reshaped in @ref update() or set with @ref setText()
+         * or @ref setGlyph() since, @cpp false @ce otherwise. Expects that
+         * @p handle is valid.
+         * @see @ref isHandleValid(DataHandle) const
+         */
+        bool isHibernated(DataHandle handle) const;
+
+        /**
+         * @brief Whether a text is hibernated assuming it belongs to this layer
+         * @m_since_latest
+         *
+         * Like @ref isHibernated(DataHandle) const but without checking that
+         * @p handle indeed belongs to this layer. See its documentation for
+         * more information.
+         */
+        bool isHibernated(LayerDataHandle handle) const;
+
+        /**
+         * @brief Count glyph cache glyph use
+         * @m_since_latest
+         *
+         * Adds the count of how many times each glyph in the
+         * @ref Shared::glyphCache() is used by texts and single glyphs in
+         * this layer to given view, indexed by the cache-global glyph ID.
+         * Expects that the size of @p counts is the same as
+         * @ref Text::AbstractGlyphCache::glyphCount(). The view isn't cleared
+         * before, so calling this function on all layers sharing the same
+         * @ref Shared instance gives the use counts for the whole glyph
+         * cache. Glyphs of texts that are waiting to be added to the cache
+         * with @ref Shared::setOnDemandGlyphCacheFilling() enabled are
+         * counted only after the next @ref update().
+         *
+         * As the glyph cache doesn't support removing glyphs, this can be
+         * used for example to decide when the cache is filled mostly with
+         * glyphs that are no longer used and it's worth recreating the
+         * user interface with a fresh glyph cache.
+         */
+        void glyphCacheUseCountsInto(const Containers::StridedArrayView1D<UnsignedInt>& counts) const;
+
         /**
          * @brief Cursor and selection position in an editable text
          *
@@ -1457,6 +1723,41 @@ class MAGNUM_UI_EXPORT TextLayer: public AbstractVisualLayer {
             setCursor(handle, position, position);
         }
 
+        /**
+         * @brief Cursor position corresponding to a node-relative position in an editable text
+         * @m_since_latest
+         *
+         * Expects that @p handle is valid and the text was created or set with
+         * @ref TextDataFlag::Editable enabled. The @p position is relative to
+         * the node the data is attached to, such as
+         * @ref PointerEvent::position() or @ref PointerMoveEvent::position(),
+         * and @p nodeSize is its size, which is needed to account for the
+         * text alignment and padding. Returns a byte position within
+         * @ref text() that's the closest glyph boundary to the position,
+         * suitable to be passed to @ref setCursor(). Only the horizontal
+         * component of @p position is used, positions before the first or
+         * after the last glyph map to the text begin or end, respectively,
+         * taking the text direction into account.
+         *
+         * The lookup is a binary search over the existing glyph positions and
+         * is thus cheap enough to be called on every pointer move during,
+         * for example, a selection drag. The result reflects the padding and
+         * style used in the last @ref update().
+         * @see @ref isHandleValid(DataHandle) const,
+         *      @ref flags(DataHandle) const
+         */
+        UnsignedInt cursorForPosition(DataHandle handle, const Vector2& position, const Vector2& nodeSize) const;
+
+        /**
+         * @brief Cursor position corresponding to a node-relative position in an editable text assuming it belongs to this layer
+         * @m_since_latest
+         *
+         * Like @ref cursorForPosition(DataHandle, const Vector2&, const Vector2&) const
+         * but without checking that @p handle indeed belongs to this layer.
+         * See its documentation for more information.
+         */
+        UnsignedInt cursorForPosition(LayerDataHandle handle, const Vector2& position, const Vector2& nodeSize) const;
+
         /**
          * @brief Properties used for shaping an editable text
          *
@@ -1527,6 +1828,11 @@ class MAGNUM_UI_EXPORT TextLayer: public AbstractVisualLayer {
          * @ref TextProperties::features() --- only the features supplied by
          * the style are used for editable text.
          *
+         * If @ref flags() contain @ref TextDataFlag::DeferredShaping, the
+         * text is shaped only in the next @ref update() and until then the
+         * previous text stays shown. Calling @ref setText() again before that
+         * replaces the pending text.
+         *
          * Calling this function causes @ref LayerState::NeedsDataUpdate to be
          * set.
          * @see @ref isHandleValid(DataHandle) const,
@@ -1856,6 +2162,8 @@ class MAGNUM_UI_EXPORT TextLayer: public AbstractVisualLayer {
         LayerFeatures doFeatures() const override;
 
         LayerStates doState() const override;
+        void doMemoryUsage(MemoryUsage& usage) const override;
+        void doIntrinsicSizes(const Containers::StridedArrayView1D<Vector2>& nodeSizes) override;
         void doUpdate(LayerStates states, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes) override;
 
     private:
@@ -1875,32 +2183,49 @@ class MAGNUM_UI_EXPORT TextLayer: public AbstractVisualLayer {
             #endif
             UnsignedInt id, const TextLayerEditingStyleUniform& uniform, const Containers::Optional<TextLayerStyleUniform>& textUniform, const Vector4& padding);
         MAGNUM_UI_LOCAL DataHandle createInternal(NodeHandle node);
-        MAGNUM_UI_LOCAL void shapeTextInternal(UnsignedInt id, UnsignedInt style, Containers::StringView text, const TextProperties& properties, FontHandle font, TextDataFlags flags);
+        MAGNUM_UI_LOCAL Containers::Array<Text::FeatureRange> textFeaturesInternal(UnsignedInt style, const TextProperties& properties) const;
+        MAGNUM_UI_LOCAL UnsignedInt allocateGlyphRunInternal(UnsignedInt id, UnsignedInt previousGlyphRun, UnsignedInt glyphCount);
+        MAGNUM_UI_LOCAL void freeGlyphRunInternal(UnsignedInt glyphRun);
+        MAGNUM_UI_LOCAL void shapeTextInternal(UnsignedInt id, UnsignedInt previousGlyphRun, UnsignedInt style, Containers::StringView text, const TextProperties& properties, FontHandle font, TextDataFlags flags, const Implementation::TextLayerDeferredShape* shaped = nullptr);
+        MAGNUM_UI_LOCAL TextProperties deferredShapePropertiesInternal(const Implementation::TextLayerDeferredShape& deferred) const;
+        MAGNUM_UI_LOCAL TextProperties hibernationSourcePropertiesInternal(const Implementation::TextLayerHibernationSource& source) const;
+        MAGNUM_UI_LOCAL bool wakeHibernatedInternal(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds);
+        MAGNUM_UI_LOCAL void hibernateInternal(UnsignedInt id);
+        MAGNUM_UI_LOCAL void freeHibernationSourceInternal(UnsignedInt id);
+        MAGNUM_UI_LOCAL void fillMissingGlyphsInternal();
+        MAGNUM_UI_LOCAL void shapeDeferredInternal();
+        MAGNUM_UI_LOCAL void shapeEditedTextInternal(UnsignedInt id);
+        MAGNUM_UI_LOCAL void shapePendingEditsInternal();
+        MAGNUM_UI_LOCAL void cancelPendingEditShapeInternal(UnsignedInt id);
         MAGNUM_UI_LOCAL void shapeRememberTextInternal(
             #ifndef CORRADE_NO_ASSERT
             const char* messagePrefix,
             #endif
-            UnsignedInt id, UnsignedInt style, Containers::StringView text, const TextProperties& properties, TextDataFlags flags);
+            UnsignedInt id, UnsignedInt previousGlyphRun, UnsignedInt style, Containers::StringView text, const TextProperties& properties, TextDataFlags flags);
         MAGNUM_UI_LOCAL void shapeGlyphInternal(
             #ifndef CORRADE_NO_ASSERT
             const char* messagePrefix,
             #endif
-            UnsignedInt id, UnsignedInt style, UnsignedInt glyphId, const TextProperties& properties);
+            UnsignedInt id, UnsignedInt previousGlyphRun, UnsignedInt style, UnsignedInt glyphId, const TextProperties& properties);
         MAGNUM_UI_LOCAL void removeInternal(UnsignedInt id);
         MAGNUM_UI_LOCAL Containers::Pair<UnsignedInt, UnsignedInt> cursorInternal(UnsignedInt id) const;
         MAGNUM_UI_LOCAL void setCursorInternal(UnsignedInt id, UnsignedInt position, UnsignedInt selection);
+        MAGNUM_UI_LOCAL UnsignedInt cursorForPositionInternal(UnsignedInt id, const Vector2& position, const Vector2& nodeSize) const;
         MAGNUM_UI_LOCAL TextProperties textPropertiesInternal(UnsignedInt id) const;
         MAGNUM_UI_LOCAL Containers::StringView textInternal(UnsignedInt id) const;
         MAGNUM_UI_LOCAL void setTextInternal(UnsignedInt id, Containers::StringView text, const TextProperties& properties, TextDataFlags flags);
-        MAGNUM_UI_LOCAL void updateTextInternal(UnsignedInt id, UnsignedInt removeOffset, UnsignedInt removeSize, UnsignedInt insertOffset, Containers::StringView text, UnsignedInt cursor, UnsignedInt selection);
-        MAGNUM_UI_LOCAL void editTextInternal(UnsignedInt id, TextEdit edit, Containers::StringView text);
+        MAGNUM_UI_LOCAL void updateTextInternal(UnsignedInt id, UnsignedInt removeOffset, UnsignedInt removeSize, UnsignedInt insertOffset, Containers::StringView text, UnsignedInt cursor, UnsignedInt selection, bool deferShaping = false);
+        MAGNUM_UI_LOCAL void editTextInternal(UnsignedInt id, TextEdit edit, Containers::StringView text, bool deferShaping = false);
         MAGNUM_UI_LOCAL void setGlyphInternal(UnsignedInt id, UnsignedInt glyph, const TextProperties& properties);
         MAGNUM_UI_LOCAL void setColorInternal(UnsignedInt id, const Color4& color);
         MAGNUM_UI_LOCAL void setPaddingInternal(UnsignedInt id, const Vector4& padding);
+        MAGNUM_UI_LOCAL void updateVerticesInternal(const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, UnsignedInt taskId);
 
         /* Can't be MAGNUM_UI_LOCAL otherwise deriving from this class in
            tests causes linker errors */
         void doClean(Containers::BitArrayView dataIdsToRemove) override;
+        void doReserve(std::size_t capacity) override;
+        void doCompact(const Containers::StridedArrayView1D<const UnsignedInt>& previousDataIds) override;
         void doAdvanceAnimations(Nanoseconds time, Containers::MutableBitArrayView activeStorage, const Containers::StridedArrayView1D<Float>& factorStorage, Containers::MutableBitArrayView removeStorage, const Containers::Iterable<AbstractStyleAnimator>& animators) override;
         void doKeyPressEvent(UnsignedInt dataId, KeyEvent& event) override;
         void doTextInputEvent(UnsignedInt dataId, TextInputEvent& event) override;
@@ -1915,8 +2240,9 @@ font was added with @ref addFont(). In order to update or draw the layer it's
 expected that @ref setStyle() was called.
 
 Pre-filling the glyph cache with appropriate glyphs for a particular font is
-the user responsibility, the implementation currently won't perform that on its
-own, neither it does any on-demand cache filling.
+the user responsibility by default. Alternatively, glyphs missing from the
+cache can be added on demand when texts get shaped, see
+@ref setOnDemandGlyphCacheFilling() for details.
 */
 class MAGNUM_UI_EXPORT TextLayer::Shared: public AbstractVisualLayer::Shared {
     public:
@@ -1986,6 +2312,131 @@ class MAGNUM_UI_EXPORT TextLayer::Shared: public AbstractVisualLayer::Shared {
         Text::AbstractGlyphCache& glyphCache();
         const Text::AbstractGlyphCache& glyphCache() const; /**< @overload */
 
+        /**
+         * @brief Whether glyphs missing from the glyph cache are added on demand
+         * @m_since_latest
+         *
+         * @see @ref setOnDemandGlyphCacheFilling()
+         */
+        bool hasOnDemandGlyphCacheFilling() const;
+
+        /**
+         * @brief Set whether glyphs missing from the glyph cache are added on demand
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * By default, glyphs that aren't present in the @ref glyphCache() are
+         * rendered as the invalid glyph, which means the cache has to be
+         * filled with all glyphs that may ever be needed upfront. If enabled,
+         * @ref TextLayer::create() and @ref TextLayer::setText() remember
+         * glyphs that are missing from the cache, and the next
+         * @ref TextLayer::update() adds them with a single
+         * @ref Text::AbstractFont::fillGlyphCache() call for each font,
+         * causing just a single glyph cache image upload. Only fonts added
+         * with @ref addFont() can be used to fill the cache,
+         * @ref TextLayer::createGlyph() and @ref TextLayer::setGlyph() still
+         * expect the glyphs to be present in the cache. Initial value is
+         * @cpp false @ce.
+         *
+         * Filling the cache uploads to the glyph cache texture, which means
+         * that with this option enabled, @ref TextLayer::update() and thus
+         * @ref AbstractUserInterface::update() have to be called on the
+         * thread owning the GPU context. Additionally, layers sharing this
+         * instance can't be updated concurrently by an executor set in
+         * @ref AbstractUserInterface::setLayerUpdateExecutor() as the
+         * missing glyph list is in this instance. The builtin styles thus
+         * don't enable this option and fill the cache upfront instead.
+         */
+        Shared& setOnDemandGlyphCacheFilling(bool enabled);
+
+        /**
+         * @brief Serialize glyph cache contents
+         * @m_since_latest
+         *
+         * Saves glyph counts of all fonts in the @ref glyphCache() together
+         * with offsets, sizes and pixel data of all glyphs except the invalid
+         * glyph into a binary blob that can be later loaded back with
+         * @ref deserializeGlyphCache(), for example to avoid rasterizing
+         * glyphs again on every application startup. Expects that a glyph
+         * cache is set. The data are in a platform-specific endianness and
+         * contain only the CPU-side @ref Text::AbstractGlyphCache::image(),
+         * i.e. the input of a distance field processing, not its output.
+         * @see @ref hasGlyphCache()
+         */
+        Containers::Array<char> serializeGlyphCache() const;
+
+        /**
+         * @brief Deserialize glyph cache contents
+         * @m_since_latest
+         *
+         * Adds fonts and glyphs from @p data produced by
+         * @ref serializeGlyphCache() to the @ref glyphCache() and uploads
+         * the glyph pixel data. Expects that a glyph cache is set. The fonts
+         * are added after fonts that are already in the cache, with the
+         * glyphs placed at new positions in the cache atlas, so it's possible
+         * to fill the cache further afterwards. The @p fonts view is expected
+         * to be either empty, in which case all fonts are added without an
+         * instance and are meant to be used with @ref addInstancelessFont(),
+         * or have the same size as the serialized font count, in which case
+         * the non-null items are associated with the fonts in the cache and
+         * can be passed to @ref addFont() without having to fill the cache
+         * using them.
+         *
+         * Returns the glyph cache ID of the first added font. If the data are
+         * invalid, have a different pixel format than the glyph cache or the
+         * glyphs don't fit into the glyph cache, prints a message to
+         * @relativeref{Magnum,Error} and returns
+         * @relativeref{Corrade,Containers::NullOpt} without adding any fonts
+         * or glyphs to the glyph cache.
+         * @see @ref hasGlyphCache(),
+         *      @ref Text::AbstractGlyphCache::fontCount()
+         */
+        Containers::Optional<UnsignedInt> deserializeGlyphCache(Containers::ArrayView<const char> data, Containers::ArrayView<const Text::AbstractFont* const> fonts);
+
+        /**
+         * @brief Deserialize glyph cache contents with all fonts instanceless
+         * @m_since_latest
+         *
+         * Same as calling @ref deserializeGlyphCache(Containers::ArrayView<const char>, Containers::ArrayView<const Text::AbstractFont* const>)
+         * with an empty @p fonts view.
+         */
+        Containers::Optional<UnsignedInt> deserializeGlyphCache(Containers::ArrayView<const char> data);
+
+        /**
+         * @brief Serialize shape cache contents
+         * @m_since_latest
+         *
+         * Saves all entries of the shape cache set up with
+         * @ref Configuration::setShapeCacheSize() into a binary blob that can
+         * be later loaded back with @ref deserializeShapeCache(). Useful for
+         * example to make recreating a previously shown screen, or shaping
+         * the text of an application on startup, not need to shape any text
+         * that was shaped before. The entries reference font handles and
+         * font-specific glyph IDs, so the data are only meaningful for a
+         * @ref Shared instance that has the same fonts added in the same
+         * order. The data are in a platform-specific endianness. If the shape
+         * cache is disabled or empty, the returned data contain no entries.
+         * @see @ref shapeCacheUsedCount(), @ref serializeGlyphCache()
+         */
+        Containers::Array<char> serializeShapeCache() const;
+
+        /**
+         * @brief Deserialize shape cache contents
+         * @m_since_latest
+         *
+         * Adds entries from @p data produced by @ref serializeShapeCache()
+         * to the shape cache, in the same order of use as they were saved.
+         * Entries that are already present are only marked as most recently
+         * used, if there's more entries than @ref shapeCacheSize(), the least
+         * recently used ones get replaced as with any other shaping. If the
+         * shape cache is disabled, the data are only checked for validity.
+         *
+         * If the data are invalid, prints a message to
+         * @relativeref{Magnum,Error} and returns @cpp false @ce without
+         * adding anything to the cache, otherwise returns @cpp true @ce.
+         */
+        bool deserializeShapeCache(Containers::ArrayView<const char> data);
+
         /**
          * @brief Count of added fonts
          *
@@ -1993,6 +2444,101 @@ class MAGNUM_UI_EXPORT TextLayer::Shared: public AbstractVisualLayer::Shared {
          */
         std::size_t fontCount() const;
 
+        /**
+         * @brief Shape cache size
+         * @m_since_latest
+         *
+         * Same as the value passed to
+         * @ref Configuration::setShapeCacheSize().
+         * @see @ref shapeCacheUsedCount()
+         */
+        UnsignedInt shapeCacheSize() const;
+
+        /**
+         * @brief Count of used shape cache entries
+         * @m_since_latest
+         *
+         * Always at most @ref shapeCacheSize().
+         */
+        UnsignedInt shapeCacheUsedCount() const;
+
+        /**
+         * @brief Measure a text
+         * @m_since_latest
+         *
+         * Shapes and lays out @p text the same way as
+         * @ref TextLayer::create() would with given @p style and
+         * @p properties, but without creating any layer data. The returned
+         * rectangle is relative to the alignment origin and its size is what
+         * @ref TextLayer::size() would return for such data. Texts with line
+         * breaks are laid out as multiple lines.
+         *
+         * The shape cache is used if enabled, so measuring a text that's
+         * subsequently created with the same properties or vice versa shapes
+         * it only once. Glyphs aren't looked up in the glyph cache, so the
+         * text can be measured even if its glyphs aren't there yet.
+         *
+         * Expects that @p style is less than @ref styleCount(). Dynamic styles
+         * are specific to each layer and thus can't be used here. Unless
+         * @ref TextProperties::font() is set, the style is expected to have a
+         * font with an instance assigned.
+         */
+        Range2D measureText(UnsignedInt style, Containers::StringView text, const TextProperties& properties);
+
+        /**
+         * @brief Whether simple text is shaped without the font shaper
+         * @m_since_latest
+         *
+         * Same as the value passed to
+         * @ref Configuration::setSimpleShaping().
+         */
+        bool hasSimpleShaping() const;
+
+        /**
+         * @brief Whether glyph runs are reused
+         * @m_since_latest
+         *
+         * Same as the value passed to
+         * @ref Configuration::setGlyphRunReuse().
+         */
+        bool hasGlyphRunReuse() const;
+
+        /**
+         * @brief Whether text input is batched
+         * @m_since_latest
+         *
+         * Same as the value passed to
+         * @ref Configuration::setTextInputBatching().
+         */
+        bool hasTextInputBatching() const;
+
+        /**
+         * @brief Whether glyphs are rendered instanced
+         * @m_since_latest
+         *
+         * Same as the value passed to
+         * @ref Configuration::setInstancedGlyphs().
+         */
+        bool hasInstancedGlyphs() const;
+
+        /**
+         * @brief Whether glyphs are rendered from a distance field
+         * @m_since_latest
+         *
+         * Same as the value passed to
+         * @ref Configuration::setDistanceFieldGlyphs().
+         */
+        bool hasDistanceFieldGlyphs() const;
+
+        /**
+         * @brief Whether glyph vertices are stored in a compact format
+         * @m_since_latest
+         *
+         * Same as the value passed to
+         * @ref Configuration::setCompactVertices().
+         */
+        bool hasCompactVertices() const;
+
         /**
          * @brief Whether a font handle is valid
          *
@@ -2096,6 +2642,53 @@ class MAGNUM_UI_EXPORT TextLayer::Shared: public AbstractVisualLayer::Shared {
         Text::AbstractFont& font(FontHandle handle);
         const Text::AbstractFont& font(FontHandle handle) const; /**< @overload */
 
+        /**
+         * @brief Set fallback fonts for a font
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * When shaping text with @p handle, each character the font doesn't
+         * have a glyph for is taken from the first font in @p fallbacks that
+         * has it. The text is then split into runs of consecutive characters
+         * using the same font, and each run is shaped separately, so a single
+         * data can show for example a mix of Latin, CJK and emoji without
+         * the application having to split the text. Spaces and ASCII
+         * punctuation stay in the current run if its font has a glyph for
+         * them, so they don't cause extra splits. Characters that no font
+         * has a glyph for are shaped with @p handle. Fonts are queried for each
+         * character only once, the result is cached per font.
+         *
+         * Expects that both @p handle and all @p fallbacks are valid and have
+         * a font instance, and that @p fallbacks don't contain @p handle
+         * itself. As all glyphs of a single data get rendered with the same
+         * scale, the fallback fonts are expected to have the same ratio of
+         * the size passed to @ref addFont() and @ref Text::AbstractFont::size()
+         * as @p handle. Fallbacks of fallback fonts aren't used. Fallbacks
+         * aren't used for @ref TextDataFlag::Editable text. Texts with
+         * @ref TextDataFlag::DeferredShaping using a font with fallbacks
+         * aren't shaped by the shape executor. Fonts have no fallbacks by
+         * default. Pass an empty view to remove them. Existing texts are not
+         * reshaped.
+         * @see @ref fontFallbacks()
+         */
+        Shared& setFontFallbacks(FontHandle handle, Containers::ArrayView<const FontHandle> fallbacks);
+
+        /**
+         * @overload
+         * @m_since_latest
+         */
+        Shared& setFontFallbacks(FontHandle handle, std::initializer_list<FontHandle> fallbacks);
+
+        /**
+         * @brief Fallback fonts for a font
+         * @m_since_latest
+         *
+         * Expects that @p handle is valid. Returns an empty view if no
+         * fallbacks were set.
+         * @see @ref setFontFallbacks()
+         */
+        Containers::ArrayView<const FontHandle> fontFallbacks(FontHandle handle) const;
+
         /**
          * @brief Set style data with implicit mapping between styles and uniforms
          * @param commonUniform Common style uniform data
@@ -2495,11 +3088,249 @@ class MAGNUM_UI_EXPORT TextLayer::Shared::Configuration {
          */
         Configuration& setDynamicStyleCount(UnsignedInt count, bool withEditingStyles);
 
+        /**
+         * @brief Shape cache size
+         * @m_since_latest
+         */
+        UnsignedInt shapeCacheSize() const { return _shapeCacheSize; }
+
+        /**
+         * @brief Set shape cache size
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * If non-zero, output of @ref Text::AbstractShaper::shape() for up to
+         * @p size distinct combinations of a text, font, script, language,
+         * shape direction and font features is remembered, and subsequent
+         * @ref TextLayer::create() and @ref TextLayer::setText() calls with
+         * the same combination reuse it instead of shaping the text again.
+         * If the cache is full, the least recently used entry is replaced.
+         * Non-editable text containing line breaks is shaped and cached line
+         * by line, so changing or appending a single line of a long
+         * multi-line text reshapes just that line. Editable text isn't
+         * cached as it's assumed to change often. The
+         * lookup is a linear search over hashes of all entries, so the size
+         * is meant to be in the order of hundreds at most. Initial size is
+         * @cpp 0 @ce, i.e. the cache is disabled.
+         * @see @ref TextLayer::Shared::shapeCacheUsedCount()
+         */
+        Configuration& setShapeCacheSize(UnsignedInt size) {
+            _shapeCacheSize = size;
+            return *this;
+        }
+
+        /**
+         * @brief Whether simple text is shaped without the font shaper
+         * @m_since_latest
+         */
+        bool hasSimpleShaping() const { return _simpleShaping; }
+
+        /**
+         * @brief Set whether simple text is shaped without the font shaper
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * By default, all text goes through @ref Text::AbstractShaper::shape()
+         * with full OpenType processing. If enabled, a line of text that
+         * consists of just printable ASCII characters, has no font features
+         * from either the style or @ref TextProperties::features() and has
+         * the script, language and shape direction unspecified or set to
+         * @ref Text::Script::Latin, @cpp "en" @ce and
+         * @ref Text::ShapeDirection::LeftToRight, respectively, is instead
+         * mapped to glyphs directly using a per-font table of glyph IDs and
+         * advances. Kerning is applied for each pair of adjacent characters.
+         *
+         * The table is built from the font shaper output on first use, with
+         * each character and each encountered pair of characters shaped
+         * once and remembered. If a character or a pair doesn't map to
+         * exactly one glyph per character, such as with ligatures, the text
+         * falls back to the shaper. Shaping done this way bypasses the
+         * shape cache set with @ref setShapeCacheSize(). Initial value is
+         * @cpp false @ce.
+         */
+        Configuration& setSimpleShaping(bool simple) {
+            _simpleShaping = simple;
+            return *this;
+        }
+
+        /**
+         * @brief Whether glyph runs are reused
+         * @m_since_latest
+         */
+        bool hasGlyphRunReuse() const { return _glyphRunReuse; }
+
+        /**
+         * @brief Whether text input is batched
+         * @m_since_latest
+         */
+        bool hasTextInputBatching() const { return _textInputBatching; }
+
+        /**
+         * @brief Set whether text input is batched
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * By default, each @ref TextInputEvent directed to a
+         * @ref TextDataFlag::Editable text inserts the text and reshapes it
+         * right away. IME composition and pasting may however deliver text
+         * in many small chunks during a single frame, each of which then
+         * results in reshaping the whole text.
+         *
+         * If enabled, text input events only insert the text and update the
+         * cursor, and the text is reshaped just once in the next
+         * @ref TextLayer::update(), regardless of how many events arrived in
+         * the meantime. Key events, @ref TextLayer::setText(),
+         * @ref TextLayer::updateText(), @ref TextLayer::editText() and
+         * @ref TextLayer::hibernate() see the already inserted text. Until
+         * the next @ref TextLayer::update(), @ref TextLayer::glyphCount(),
+         * @ref TextLayer::size() and @ref TextLayer::cursorForPosition()
+         * however report values for the text before the batched input.
+         * Initial value is @cpp false @ce.
+         */
+        Configuration& setTextInputBatching(bool batching) {
+            _textInputBatching = batching;
+            return *this;
+        }
+
+        /**
+         * @brief Set whether glyph runs are reused
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * By default, each @ref TextLayer::setText() puts the shaped glyphs at
+         * the end of the layer glyph storage, and every @ref TextLayer::update()
+         * that follows a text change or removal moves all glyphs that come
+         * after the changed or removed text, so the storage stays contiguous.
+         * That's a lot of copying if a text at the start of a large layer
+         * changes often.
+         *
+         * If enabled, glyph storage for each text is allocated with a
+         * capacity rounded up to the next power of two. A new text is
+         * shaped in place if it fits into the capacity of the previous one.
+         * Storage of removed texts is put into free lists by capacity and
+         * reused by new texts of the same capacity class. The storage is then
+         * compacted in @ref TextLayer::update() only if more than half of
+         * it is unused, which amortizes the copying over many updates, at the
+         * cost of higher memory use. Initial value is @cpp false @ce.
+         *
+         * Text of @ref TextDataFlag::Editable data is allocated with a
+         * power-of-two capacity as well, and @ref TextLayer::updateText() and
+         * @ref TextLayer::editText() modify it in place if the result fits,
+         * instead of copying the whole text to a new location on every
+         * keystroke.
+         */
+        Configuration& setGlyphRunReuse(bool reuse) {
+            _glyphRunReuse = reuse;
+            return *this;
+        }
+
+        /**
+         * @brief Whether glyphs are rendered instanced
+         * @m_since_latest
+         */
+        bool hasInstancedGlyphs() const { return _instancedGlyphs; }
+
+        /**
+         * @brief Set whether glyphs are rendered instanced
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * By default, @ref TextLayer::update() generates four vertices with
+         * a position, texture coordinates, color and style for each glyph,
+         * together with six indices. If enabled, it generates just a single
+         * instance for each drawn glyph containing the glyph origin, scale,
+         * glyph cache ID, color and style, in draw order, and the renderer
+         * expands it to a quad using glyph properties from the glyph cache.
+         * That's 24 instead of 184 bytes per glyph to upload on every
+         * change, at the cost of the instance data being regenerated also
+         * when the draw order changes. Initial value is @cpp false @ce.
+         *
+         * In @ref TextLayerGL this needs the
+         * @gl_extension{ARB,base_instance} extension and thus isn't
+         * available on OpenGL ES and WebGL.
+         */
+        Configuration& setInstancedGlyphs(bool instanced) {
+            _instancedGlyphs = instanced;
+            return *this;
+        }
+
+        /**
+         * @brief Whether glyphs are rendered from a distance field
+         * @m_since_latest
+         */
+        bool hasDistanceFieldGlyphs() const { return _distanceFieldGlyphs; }
+
+        /**
+         * @brief Set whether glyphs are rendered from a distance field
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * By default, the glyph cache is expected to contain glyph coverage,
+         * which is sampled directly and thus looks blurry or aliased when
+         * scaled far from the size it was rasterized at. If enabled, the glyph
+         * cache is expected to contain a signed distance field, such as
+         * produced by @ref Text::DistanceFieldGlyphCacheGL, and the renderer
+         * reconstructs antialiased glyph edges from it at any scale. A single
+         * small glyph cache can then serve all text sizes and DPI scaling
+         * factors. Initial value is @cpp false @ce.
+         *
+         * As the distance field glyph cache is a
+         * @ref Text::GlyphCacheGL subclass, it can be passed to
+         * @ref TextLayerGL::Shared::setGlyphCache(Text::GlyphCacheGL&)
+         * directly. The
+         * implementation uses a threshold of @cpp 0.5 @ce, which matches the
+         * distance field glyph cache output.
+         */
+        Configuration& setDistanceFieldGlyphs(bool distanceField) {
+            _distanceFieldGlyphs = distanceField;
+            return *this;
+        }
+
+        /**
+         * @brief Whether glyph vertices are stored in a compact format
+         * @m_since_latest
+         */
+        bool hasCompactVertices() const { return _compactVertices; }
+
+        /**
+         * @brief Set whether glyph vertices are stored in a compact format
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * If enabled, the glyph vertices are stored on the GPU with positions
+         * as 16-bit fixed-point values relative to the UI size, texture
+         * coordinates as 16-bit normalized values and the color as 8-bit
+         * normalized, which is 20 instead of 40 bytes per vertex. The layer
+         * itself still generates the vertex data as floats, the conversion
+         * is done by @ref TextLayerGL on upload. Initial value is
+         * @cpp false @ce.
+         *
+         * The format can represent positions in the @f$ [-2, 2) @f$ multiple
+         * of the UI size with a precision of @f$ \frac{1}{16384} @f$ of the
+         * UI size, anything outside is clamped. Similarly, color values
+         * outside of the @f$ [0, 1] @f$ range are clamped. Because the
+         * fixed-point values depend on the UI size, the whole vertex data get
+         * uploaded again on every UI size change. Has no effect if
+         * @ref setInstancedGlyphs() is enabled, as the glyph instances are
+         * already compact.
+         */
+        Configuration& setCompactVertices(bool compact) {
+            _compactVertices = compact;
+            return *this;
+        }
+
     private:
         UnsignedInt _styleUniformCount, _styleCount;
         UnsignedInt _editingStyleUniformCount = 0, _editingStyleCount = 0;
         UnsignedInt _dynamicStyleCount = 0;
+        UnsignedInt _shapeCacheSize = 0;
         bool _dynamicEditingStyles = false;
+        bool _simpleShaping = false;
+        bool _glyphRunReuse = false;
+        bool _textInputBatching = false;
+        bool _instancedGlyphs = false;
+        bool _distanceFieldGlyphs = false;
+        bool _compactVertices = false;
 };
 
 inline TextLayer::Shared& TextLayer::shared() {
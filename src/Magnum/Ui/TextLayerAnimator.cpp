@@ -116,6 +116,11 @@ struct Animation {
 
 struct TextLayerStyleAnimator::State: AbstractVisualLayerStyleAnimator::State {
     Containers::Array<Animation> animations;
+
+    /* IDs and eased factors of animations to interpolate in advance(), kept
+       across calls to avoid allocating every time */
+    Containers::Array<UnsignedInt> advanceIds;
+    Containers::Array<Float> advanceFactors;
 };
 
 TextLayerStyleAnimator::TextLayerStyleAnimator(AnimatorHandle handle): AbstractVisualLayerStyleAnimator{handle, Containers::pointer<State>()} {}
@@ -447,7 +452,17 @@ TextLayerStyleAnimations TextLayerStyleAnimator::advance(const Containers::BitAr
     const TextLayer::Shared::State& layerSharedState = static_cast<const TextLayer::Shared::State&>(*state.layerSharedState);
     const Containers::StridedArrayView1D<const LayerDataHandle> layerData = this->layerData();
 
+    /* Make sure the scratch arrays are large enough for all animations */
+    if(state.advanceIds.size() < capacity()) {
+        arrayResize(state.advanceIds, NoInit, capacity());
+        arrayResize(state.advanceFactors, NoInit, capacity());
+    }
+
+    /* 1. Go through all active animations, process the ones that are
+       scheduled for removal, allocate dynamic styles for the running ones and
+       put them to a list to be interpolated below */
     TextLayerStyleAnimations animations;
+    std::size_t count = 0;
     /** @todo some way to iterate set bits */
     for(std::size_t i = 0; i != active.size(); ++i) {
         if(!active[i]) continue;
@@ -533,7 +548,22 @@ TextLayerStyleAnimations TextLayerStyleAnimator::advance(const Containers::BitAr
             dynamicStyleSelectionStyles.set(animation.dynamicStyle, animation.hasSelectionStyle);
         }
 
-        const Float factor = animation.easing(factors[i]);
+        state.advanceIds[count] = i;
+        state.advanceFactors[count] = factors[i];
+        ++count;
+    }
+
+    const Containers::ArrayView<const UnsignedInt> ids = state.advanceIds.prefix(count);
+    const Containers::ArrayView<Float> easedFactors = state.advanceFactors.prefix(count);
+
+    /* 2. Evaluate the easing for all running animations in a batch */
+    for(std::size_t i = 0; i != ids.size(); ++i)
+        easedFactors[i] = state.animations[ids[i]].easing(easedFactors[i]);
+
+    /* 3. Interpolate the uniforms and paddings of all running animations */
+    for(std::size_t i = 0; i != ids.size(); ++i) {
+        const Animation& animation = state.animations[ids[i]];
+        const Float factor = easedFactors[i];
 
         /* Interpolate the uniform. If the source and target uniforms were the
            same, just copy one of them and don't report that the uniforms got
@@ -27,10 +27,14 @@
 #include "TextLayerGL.h"
 
 #include <Corrade/Containers/BitArrayView.h>
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Iterable.h>
 #include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Utility/Format.h>
 #include <Corrade/Utility/Resource.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
 #include <Magnum/Math/Matrix3.h>
 #include <Magnum/Math/Range.h>
 #include <Magnum/GL/AbstractShaderProgram.h>
@@ -39,12 +43,16 @@
 #include <Magnum/GL/Extensions.h>
 #include <Magnum/GL/Mesh.h>
 #include <Magnum/GL/Renderer.h>
+#include <Magnum/GL/Sampler.h>
 #include <Magnum/GL/Shader.h>
 #include <Magnum/GL/Texture.h>
+#include <Magnum/GL/TextureFormat.h>
 #include <Magnum/GL/Version.h>
 #include <Magnum/Text/GlyphCacheGL.h>
 
+#include "Magnum/Ui/MemoryUsage.h"
 #include "Magnum/Ui/Implementation/textLayerState.h"
+#include "Magnum/Ui/Implementation/StreamingBufferGL.h"
 
 #ifdef MAGNUM_BUILD_STATIC
 static void importShaderResources() {
@@ -62,6 +70,7 @@ class TextShaderGL: public GL::AbstractShaderProgram {
     private:
         enum: Int {
             GlyphTextureBinding = 0,
+            GlyphPropertiesTextureBinding = 1,
             StyleBufferBinding = 0
         };
 
@@ -70,14 +79,29 @@ class TextShaderGL: public GL::AbstractShaderProgram {
         typedef GL::Attribute<1, Vector3> TextureCoordinates;
         typedef GL::Attribute<2, Vector4> Color4;
         typedef GL::Attribute<3, UnsignedInt> Style;
+        /* Only if instanced glyphs are enabled, Position is then the glyph
+           origin and TextureCoordinates aren't used */
+        typedef GL::Attribute<1, Float> InstanceScale;
+        typedef GL::Attribute<4, UnsignedInt> InstanceGlyphId;
 
-        explicit TextShaderGL(UnsignedInt styleCount);
+        explicit TextShaderGL(UnsignedInt styleCount, bool instancedGlyphs, bool distanceField, bool compactVertices);
+
+        /* The constructor only submits the compilation and linking, which
+           with KHR_parallel_shader_compile then happens in the background
+           while the style is applied and fonts get loaded. This waits for
+           the link to finish, checks it and queries uniform locations. Has
+           to be called before setGlyphCacheSize() and the first draw, does
+           nothing if already called. */
+        void finalize();
 
         TextShaderGL& setProjection(const Vector2& scaling) {
             /* Y-flipped scale from the UI size to the 2x2 unit square, the
                shader then translates by (-1, 1) on its own to put the origin
-               at center */
-            setUniform(_projectionUniform, Vector2{2.0f, -2.0f}/scaling);
+               at center. If not finalized yet, uploaded only in finalize() to
+               not wait for the link here. */
+            _projection = Vector2{2.0f, -2.0f}/scaling;
+            if(!_vert.id())
+                setUniform(_projectionUniform, _projection);
             return *this;
         }
 
@@ -86,19 +110,44 @@ class TextShaderGL: public GL::AbstractShaderProgram {
             return *this;
         }
 
+        TextShaderGL& setGlyphCacheSize(const Vector2i& size) {
+            CORRADE_INTERNAL_ASSERT(_instancedGlyphs && !_vert.id());
+            setUniform(_glyphCacheSizeUniform, Vector2{size});
+            return *this;
+        }
+
+        TextShaderGL& bindGlyphPropertiesTexture(GL::Texture2D& texture) {
+            CORRADE_INTERNAL_ASSERT(_instancedGlyphs);
+            texture.bind(GlyphPropertiesTextureBinding);
+            return *this;
+        }
+
         TextShaderGL& bindStyleBuffer(GL::Buffer& buffer) {
             buffer.bind(GL::Buffer::Target::Uniform, StyleBufferBinding);
             return *this;
         }
 
     private:
-        Int _projectionUniform = 0;
+        bool _instancedGlyphs;
+        #if defined(MAGNUM_TARGET_GLES) && !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+        GL::Version _version;
+        #endif
+        Int _projectionUniform = 0,
+            _glyphCacheSizeUniform = 1;
+        Vector2 _projection;
+        /* Present only until finalize() is called */
+        GL::Shader _vert{NoCreate}, _frag{NoCreate};
 };
 
-TextShaderGL::TextShaderGL(const UnsignedInt styleCount) {
+TextShaderGL::TextShaderGL(const UnsignedInt styleCount, const bool instancedGlyphs, const bool distanceField, const bool compactVertices): _instancedGlyphs{instancedGlyphs} {
     GL::Context& context = GL::Context::current();
     #ifndef MAGNUM_TARGET_GLES
     MAGNUM_ASSERT_GL_EXTENSION_SUPPORTED(GL::Extensions::ARB::explicit_attrib_location);
+    if(instancedGlyphs)
+        MAGNUM_ASSERT_GL_EXTENSION_SUPPORTED(GL::Extensions::ARB::base_instance);
+    #else
+    CORRADE_ASSERT(!instancedGlyphs,
+        "Ui::TextLayerGL::Shared: instanced glyphs are not supported on OpenGL ES", );
     #endif
 
     #ifdef MAGNUM_BUILD_STATIC
@@ -119,19 +168,42 @@ TextShaderGL::TextShaderGL(const UnsignedInt styleCount) {
         #endif
     });
 
-    GL::Shader vert{version, GL::Shader::Type::Vertex};
-    vert.addSource(Utility::format("#define STYLE_COUNT {}\n", styleCount))
+    _vert = GL::Shader{version, GL::Shader::Type::Vertex};
+    _vert.addSource(Utility::format("#define STYLE_COUNT {}\n", styleCount))
+        .addSource(instancedGlyphs ? "#define INSTANCED_GLYPHS\n"_s : ""_s)
+        .addSource(compactVertices ? "#define COMPACT_VERTICES\n"_s : ""_s)
         .addSource(rs.getString("compatibility.glsl"_s))
         .addSource(rs.getString("TextShader.vert"_s));
 
-    GL::Shader frag{version, GL::Shader::Type::Fragment};
-    frag.addSource(rs.getString("compatibility.glsl"_s))
+    _frag = GL::Shader{version, GL::Shader::Type::Fragment};
+    _frag.addSource(distanceField ? "#define DISTANCE_FIELD\n"_s : ""_s)
+        .addSource(rs.getString("compatibility.glsl"_s))
         .addSource(rs.getString("TextShader.frag"_s));
 
-    CORRADE_INTERNAL_ASSERT(vert.compile() && frag.compile());
+    #if defined(MAGNUM_TARGET_GLES) && !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+    _version = version;
+    #endif
+
+    _vert.submitCompile();
+    _frag.submitCompile();
 
-    attachShaders({vert, frag});
-    CORRADE_INTERNAL_ASSERT(link());
+    attachShaders({_vert, _frag});
+    submitLink();
+}
+
+void TextShaderGL::finalize() {
+    if(!_vert.id())
+        return;
+
+    CORRADE_INTERNAL_ASSERT_OUTPUT(checkLink({_vert, _frag}));
+    _vert = GL::Shader{NoCreate};
+    _frag = GL::Shader{NoCreate};
+
+    #ifndef MAGNUM_TARGET_GLES
+    GL::Context& context = GL::Context::current();
+    #elif !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+    const GL::Version version = _version;
+    #endif
 
     #ifndef MAGNUM_TARGET_GLES
     if(!context.isExtensionSupported<GL::Extensions::ARB::explicit_uniform_location>())
@@ -140,6 +212,8 @@ TextShaderGL::TextShaderGL(const UnsignedInt styleCount) {
     #endif
     {
         _projectionUniform = uniformLocation("projection"_s);
+        if(_instancedGlyphs)
+            _glyphCacheSizeUniform = uniformLocation("glyphCacheSize"_s);
     }
 
     #ifndef MAGNUM_TARGET_GLES
@@ -149,8 +223,12 @@ TextShaderGL::TextShaderGL(const UnsignedInt styleCount) {
     #endif
     {
         setUniform(uniformLocation("glyphTextureData"_s), GlyphTextureBinding);
+        if(_instancedGlyphs)
+            setUniform(uniformLocation("glyphPropertiesData"_s), GlyphPropertiesTextureBinding);
         setUniformBlockBinding(uniformBlockIndex("Style"_s), StyleBufferBinding);
     }
+
+    setUniform(_projectionUniform, _projection);
 }
 
 class TextEditingShaderGL: public GL::AbstractShaderProgram {
@@ -170,12 +248,19 @@ class TextEditingShaderGL: public GL::AbstractShaderProgram {
         explicit TextEditingShaderGL(NoCreateT): GL::AbstractShaderProgram{NoCreate} {}
         explicit TextEditingShaderGL(UnsignedInt styleCount);
 
+        /* Same as TextShaderGL::finalize() */
+        void finalize();
+
         TextEditingShaderGL& setProjection(const Vector2& scaling, const Float pixelScaling) {
             /* XY is Y-flipped scale from the UI size to the 2x2 unit square,
                the shader then translates by (-1, 1) on its own to put the
                origin at center. Z is multiplied with the pixel smoothness
-               value to get the smoothness in actual UI units. */
-            setUniform(_projectionUniform, Vector3{Vector2{2.0f, -2.0f}/scaling, pixelScaling});
+               value to get the smoothness in actual UI units. If not
+               finalized yet, uploaded only in finalize() to not wait for the
+               link here. */
+            _projection = Vector3{Vector2{2.0f, -2.0f}/scaling, pixelScaling};
+            if(!_vert.id())
+                setUniform(_projectionUniform, _projection);
             return *this;
         }
 
@@ -185,7 +270,13 @@ class TextEditingShaderGL: public GL::AbstractShaderProgram {
         }
 
     private:
+        #if defined(MAGNUM_TARGET_GLES) && !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+        GL::Version _version;
+        #endif
         Int _projectionUniform = 0;
+        Vector3 _projection;
+        /* Present only until finalize() is called */
+        GL::Shader _vert{NoCreate}, _frag{NoCreate};
 };
 
 TextEditingShaderGL::TextEditingShaderGL(const UnsignedInt styleCount) {
@@ -212,20 +303,40 @@ TextEditingShaderGL::TextEditingShaderGL(const UnsignedInt styleCount) {
         #endif
     });
 
-    GL::Shader vert{version, GL::Shader::Type::Vertex};
-    vert.addSource(Utility::format("#define STYLE_COUNT {}\n", styleCount))
+    _vert = GL::Shader{version, GL::Shader::Type::Vertex};
+    _vert.addSource(Utility::format("#define STYLE_COUNT {}\n", styleCount))
         .addSource(rs.getString("compatibility.glsl"_s))
         .addSource(rs.getString("TextEditingShader.vert"_s));
 
-    GL::Shader frag{version, GL::Shader::Type::Fragment};
-    frag.addSource(Utility::format("#define STYLE_COUNT {}\n", styleCount))
+    _frag = GL::Shader{version, GL::Shader::Type::Fragment};
+    _frag.addSource(Utility::format("#define STYLE_COUNT {}\n", styleCount))
         .addSource(rs.getString("compatibility.glsl"_s))
         .addSource(rs.getString("TextEditingShader.frag"_s));
 
-    CORRADE_INTERNAL_ASSERT(vert.compile() && frag.compile());
+    #if defined(MAGNUM_TARGET_GLES) && !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+    _version = version;
+    #endif
+
+    _vert.submitCompile();
+    _frag.submitCompile();
 
-    attachShaders({vert, frag});
-    CORRADE_INTERNAL_ASSERT(link());
+    attachShaders({_vert, _frag});
+    submitLink();
+}
+
+void TextEditingShaderGL::finalize() {
+    if(!_vert.id())
+        return;
+
+    CORRADE_INTERNAL_ASSERT_OUTPUT(checkLink({_vert, _frag}));
+    _vert = GL::Shader{NoCreate};
+    _frag = GL::Shader{NoCreate};
+
+    #ifndef MAGNUM_TARGET_GLES
+    GL::Context& context = GL::Context::current();
+    #elif !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+    const GL::Version version = _version;
+    #endif
 
     #ifndef MAGNUM_TARGET_GLES
     if(!context.isExtensionSupported<GL::Extensions::ARB::explicit_uniform_location>())
@@ -244,6 +355,8 @@ TextEditingShaderGL::TextEditingShaderGL(const UnsignedInt styleCount) {
     {
         setUniformBlockBinding(uniformBlockIndex("Style"_s), StyleBufferBinding);
     }
+
+    setUniform(_projectionUniform, _projection);
 }
 
 }
@@ -263,6 +376,12 @@ struct TextLayerGL::Shared::State: TextLayer::Shared::State {
        layer has its own copies instead */
     GL::Buffer styleBuffer{NoCreate};
     GL::Buffer editingStyleBuffer{NoCreate};
+    /* Used only if instancedGlyphs is set. Offsets, sizes, rectangles and
+       layers of all glyphs in the glyph cache, two RGBA32F texels for each
+       glyph. Gets recreated in doDraw() of any layer that finds out the glyph
+       cache has a different glyph count than what was uploaded. */
+    GL::Texture2D glyphPropertiesTexture{NoCreate};
+    UnsignedInt glyphPropertiesGlyphCount = 0;
 };
 
 TextLayerGL::Shared::State::State(Shared& self, const Configuration& configuration):
@@ -271,7 +390,8 @@ TextLayerGL::Shared::State::State(Shared& self, const Configuration& configurati
         dynamic style, one reserved for under-cursor text and one for selected
         text. If there are no dynamic styles, the editing styles pick those
         from the regular styleUniformCount range. */
-    shader{configuration.styleUniformCount() + configuration.dynamicStyleCount()*(configuration.hasEditingStyles() ? 3 : 1)}
+    /* Compact vertices have no effect with instanced glyphs */
+    shader{configuration.styleUniformCount() + configuration.dynamicStyleCount()*(configuration.hasEditingStyles() ? 3 : 1), configuration.hasInstancedGlyphs(), configuration.hasDistanceFieldGlyphs(), configuration.hasCompactVertices() && !configuration.hasInstancedGlyphs()}
 {
     if(!dynamicStyleCount) {
         styleBuffer = GL::Buffer{GL::Buffer::TargetHint::Uniform, {nullptr, sizeof(TextLayerCommonStyleUniform) + sizeof(TextLayerStyleUniform)*styleUniformCount}};
@@ -334,13 +454,72 @@ void TextLayerGL::Shared::doSetEditingStyle(const TextLayerCommonEditingStyleUni
     state.editingStyleBuffer.setSubData(sizeof(TextLayerCommonEditingStyleUniform), uniforms);
 }
 
+namespace {
+
+/* Attaches the vertex buffer to the mesh. With instanced glyphs it's
+   attached as a per-instance buffer and the mesh is a non-indexed four-vertex
+   triangle strip, otherwise the index buffer is attached as well. Compact
+   vertices have no effect with instanced glyphs. */
+void setupMesh(GL::Mesh& mesh, GL::Buffer& buffer, GL::Buffer& indexBuffer, const bool instancedGlyphs, const bool compactVertices) {
+    if(instancedGlyphs) {
+        mesh.setPrimitive(GL::MeshPrimitive::TriangleStrip)
+            .setCount(4)
+            .addVertexBufferInstanced(buffer, 1, 0,
+                TextShaderGL::Position{},
+                TextShaderGL::InstanceScale{},
+                TextShaderGL::InstanceGlyphId{},
+                TextShaderGL::Color4{TextShaderGL::Color4::DataType::UnsignedByte, TextShaderGL::Color4::DataOption::Normalized},
+                TextShaderGL::Style{});
+        return;
+    }
+
+    /* With compact vertices the fixed-point values are passed as
+       non-normalized integers to the shader, which scales them back */
+    if(compactVertices) {
+        mesh.addVertexBuffer(buffer, 0,
+                TextShaderGL::Position{TextShaderGL::Position::DataType::Short},
+                TextShaderGL::TextureCoordinates{TextShaderGL::TextureCoordinates::DataType::UnsignedShort},
+                TextShaderGL::Color4{TextShaderGL::Color4::DataType::UnsignedByte, TextShaderGL::Color4::DataOption::Normalized},
+                2,
+                TextShaderGL::Style{})
+            .setIndexBuffer(indexBuffer, 0, GL::MeshIndexType::UnsignedInt);
+        return;
+    }
+
+    mesh.addVertexBuffer(buffer, 0,
+            TextShaderGL::Position{},
+            TextShaderGL::TextureCoordinates{},
+            TextShaderGL::Color4{},
+            TextShaderGL::Style{})
+        .setIndexBuffer(indexBuffer, 0, GL::MeshIndexType::UnsignedInt);
+}
+
+}
+
 struct TextLayerGL::State: TextLayer::State {
     explicit State(Shared::State& shared): TextLayer::State{shared} {}
 
     GL::Buffer vertexBuffer{GL::Buffer::TargetHint::Array}, indexBuffer{GL::Buffer::TargetHint::ElementArray};
     GL::Mesh mesh;
+    /* Vertex count in vertexBuffer. If it matches the size of `vertices`,
+       only the range that changed is uploaded. */
+    std::size_t vertexBufferSize = 0;
+    /* Used only if compact vertices are enabled, contains the converted
+       vertex data for the last upload */
+    Containers::Array<Implementation::TextLayerCompactVertex> compactVertexScratch;
+
+    #ifndef MAGNUM_TARGET_GLES
+    /* Used instead of vertexBuffer if setVertexBufferStreaming() is enabled */
+    Containers::Pointer<Implementation::StreamingBufferGL> streamingVertexBuffer;
+    /* Offset of the current streaming buffer segment in instances, used for
+       the base instance with instanced glyphs. Without instancing the base
+       vertex is set on the mesh directly. */
+    UnsignedInt streamingBaseInstance = 0;
+    #endif
     Vector2 clipScale;
     Vector2i framebufferSize;
+    /* Used for converting to compact vertices */
+    Vector2 uiSize;
 
     /* Used only if shared.hasEditingStyles is set */
     GL::Buffer editingVertexBuffer{NoCreate}, editingIndexBuffer{NoCreate};
@@ -348,22 +527,25 @@ struct TextLayerGL::State: TextLayer::State {
 
     /* Used only if shared.dynamicStyleCount is non-zero (and then also
        shared.hasEditingStyles is set in case of editingStyleBuffer), in which
-       case it's created during the first doUpdate(). Even though the size is
-       known in advance, the NoCreate'd state is used to correctly perform the
-       first ever style upload without having to implicitly set any
-       LayerStates. */
+       case it's created during the first upload in doDraw(). Even though the
+       size is known in advance, the NoCreate'd state is used to correctly
+       perform the first ever style upload without having to implicitly set
+       any LayerStates. */
     GL::Buffer styleBuffer{NoCreate};
     GL::Buffer editingStyleBuffer{NoCreate};
+
+    /* States passed to doUpdate() calls since the last upload, and whether
+       the shared styles changed in any of them. The GPU upload is deferred to
+       the next doDraw() so doUpdate() doesn't touch GL and can be called from
+       a different thread. */
+    LayerStates pendingUploadStates;
+    bool pendingSharedStyleChanged = false;
+    bool pendingSharedEditingStyleChanged = false;
 };
 
 TextLayerGL::TextLayerGL(const LayerHandle handle, Shared& sharedState): TextLayer{handle, Containers::pointer<State>(static_cast<Shared::State&>(*sharedState._state))} {
     auto& state = static_cast<State&>(*_state);
-    state.mesh.addVertexBuffer(state.vertexBuffer, 0,
-        TextShaderGL::Position{},
-        TextShaderGL::TextureCoordinates{},
-        TextShaderGL::Color4{},
-        TextShaderGL::Style{});
-    state.mesh.setIndexBuffer(state.indexBuffer, 0, GL::MeshIndexType::UnsignedInt);
+    setupMesh(state.mesh, state.vertexBuffer, state.indexBuffer, static_cast<Shared::State&>(state.shared).instancedGlyphs, static_cast<Shared::State&>(state.shared).compactVertices);
 
     if(static_cast<Shared::State&>(state.shared).hasEditingStyles) {
         state.editingVertexBuffer = GL::Buffer{GL::Buffer::TargetHint::Array};
@@ -378,6 +560,38 @@ TextLayerGL::TextLayerGL(const LayerHandle handle, Shared& sharedState): TextLay
     }
 }
 
+#ifndef MAGNUM_TARGET_GLES
+bool TextLayerGL::isVertexBufferStreaming() const {
+    return !!static_cast<const State&>(*_state).streamingVertexBuffer;
+}
+
+TextLayerGL& TextLayerGL::setVertexBufferStreaming(const bool enabled) {
+    auto& state = static_cast<State&>(*_state);
+    CORRADE_ASSERT(!enabled || Implementation::StreamingBufferGL::isSupported(),
+        "Ui::TextLayerGL::setVertexBufferStreaming():" << GL::Extensions::ARB::buffer_storage::string() << "is not supported", *this);
+    if(enabled == !!state.streamingVertexBuffer)
+        return *this;
+
+    /* The streaming buffer replaces the regular buffer in the mesh on the
+       first non-empty upload, until then the mesh has the regular buffer
+       attached to have a consistent state. When disabling, the regular buffer
+       gets fully uploaded again. */
+    state.mesh = GL::Mesh{};
+    setupMesh(state.mesh, state.vertexBuffer, state.indexBuffer, static_cast<Shared::State&>(state.shared).instancedGlyphs, static_cast<Shared::State&>(state.shared).compactVertices);
+    if(enabled) {
+        state.streamingVertexBuffer.emplace();
+    } else {
+        state.streamingVertexBuffer = nullptr;
+        state.streamingBaseInstance = 0;
+        state.vertexBufferSize = ~std::size_t{};
+    }
+
+    /* Make the next draw upload the vertex and index data again */
+    state.pendingUploadStates |= LayerState::NeedsDataUpdate;
+    return *this;
+}
+#endif
+
 LayerFeatures TextLayerGL::doFeatures() const {
     return TextLayer::doFeatures()|LayerFeature::DrawUsesBlending|LayerFeature::DrawUsesScissor;
 }
@@ -394,6 +608,15 @@ void TextLayerGL::doSetSize(const Vector2& size, const Vector2i& framebufferSize
     /* For scaling and Y-flipping the clip rects in doDraw() */
     state.clipScale = Vector2{framebufferSize}/size;
     state.framebufferSize = framebufferSize;
+
+    /* Compact vertices are relative to the UI size, so they have to be all
+       converted and uploaded again. The float vertices stay the same, so
+       there's no need to regenerate them. */
+    state.uiSize = size;
+    if(sharedState.compactVertices && !sharedState.instancedGlyphs) {
+        state.vertexBufferSize = ~std::size_t{};
+        state.pendingUploadStates |= LayerState::NeedsNodeOffsetSizeUpdate;
+    }
 }
 
 void TextLayerGL::doUpdate(const LayerStates states, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, const Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes) {
@@ -403,20 +626,64 @@ void TextLayerGL::doUpdate(const LayerStates states, const Containers::StridedAr
     /* Check whether the shared styles changed before calling into the base
        doUpdate() that syncs the stamps. For dynamic styles, if the style
        changed, it should be accompanied by NeedsCommonDataUpdate being set in
-       order to be correctly handled below. */
+       order to be correctly handled below. The dynamic style change may be
+       also a leftover from a previous update that wasn't uploaded yet. */
     const bool sharedStyleChanged = sharedState.styleUpdateStamp != state.styleUpdateStamp;
     const bool sharedEditingStyleChanged = sharedState.editingStyleUpdateStamp != state.editingStyleUpdateStamp;
-    CORRADE_INTERNAL_ASSERT(!sharedState.dynamicStyleCount || (!sharedStyleChanged && !sharedEditingStyleChanged && !state.dynamicStyleChanged && !state.dynamicEditingStyleChanged) || states >= LayerState::NeedsCommonDataUpdate);
+    CORRADE_INTERNAL_ASSERT(!sharedState.dynamicStyleCount || (!sharedStyleChanged && !sharedEditingStyleChanged && !state.dynamicStyleChanged && !state.dynamicEditingStyleChanged) || states >= LayerState::NeedsCommonDataUpdate || state.pendingUploadStates >= LayerState::NeedsCommonDataUpdate);
 
     TextLayer::doUpdate(states, dataIds, clipRectIds, clipRectDataCounts, nodeOffsets, nodeSizes, nodeOpacities, nodesEnabled, clipRectOffsets, clipRectSizes, compositeRectOffsets, compositeRectSizes);
 
+    /* Only remember what needs to be uploaded, the actual upload is done in
+       uploadPendingData() on the next draw */
+    state.pendingUploadStates |= states;
+    state.pendingSharedStyleChanged = state.pendingSharedStyleChanged || sharedStyleChanged;
+    state.pendingSharedEditingStyleChanged = state.pendingSharedEditingStyleChanged || sharedEditingStyleChanged;
+}
+
+void TextLayerGL::doMemoryUsage(MemoryUsage& usage) const {
+    TextLayer::doMemoryUsage(usage);
+
+    State& state = static_cast<State&>(*_state);
+    /* Buffer sizes are queried from GL. The glyph cache is in the shared
+       state, so it's not counted. */
+    const auto bufferSize = [](GL::Buffer& buffer) -> std::size_t {
+        return buffer.id() ? buffer.size() : 0;
+    };
+    usage.gpuByteCount +=
+        bufferSize(state.vertexBuffer) +
+        bufferSize(state.indexBuffer) +
+        bufferSize(state.editingVertexBuffer) +
+        bufferSize(state.editingIndexBuffer) +
+        bufferSize(state.styleBuffer) +
+        bufferSize(state.editingStyleBuffer);
+    usage.cpuByteCount += state.compactVertexScratch.size()*sizeof(Implementation::TextLayerCompactVertex);
+    #ifndef MAGNUM_TARGET_GLES
+    if(state.streamingVertexBuffer)
+        usage.gpuByteCount += bufferSize(state.streamingVertexBuffer->buffer());
+    #endif
+}
+
+void TextLayerGL::uploadPendingData() {
+    State& state = static_cast<State&>(*_state);
+    Shared::State& sharedState = static_cast<Shared::State&>(state.shared);
+    const LayerStates states = state.pendingUploadStates;
+
     /* The branching here mirrors how TextLayer::doUpdate() restricts the
-       updates */
+       updates. With instanced glyphs there are no glyph indices, the instance
+       data update on a node order change instead. */
+    const bool instanced = sharedState.instancedGlyphs;
+    const bool compact = sharedState.compactVertices && !sharedState.instancedGlyphs;
     if(states >= LayerState::NeedsNodeOrderUpdate ||
-       states >= LayerState::NeedsDataUpdate)
+       states >= LayerState::NeedsDataUpdate ||
+       /* Glyphs outside of clip rects are culled from the index buffer,
+          which may change with node enablement as well */
+       (!instanced && states >= LayerState::NeedsNodeEnabledUpdate))
     {
-        state.indexBuffer.setData(state.indices);
-        state.mesh.setCount(state.indices.size());
+        if(!instanced) {
+            state.indexBuffer.setData(state.indices);
+            state.mesh.setCount(state.indices.size());
+        }
         if(sharedState.hasEditingStyles) {
             state.editingIndexBuffer.setData(state.editingIndices);
             state.editingMesh.setCount(state.editingIndices.size());
@@ -424,13 +691,73 @@ void TextLayerGL::doUpdate(const LayerStates states, const Containers::StridedAr
     }
     if(states >= LayerState::NeedsNodeOffsetSizeUpdate ||
        states >= LayerState::NeedsNodeEnabledUpdate ||
-       states >= LayerState::NeedsDataUpdate)
+       states >= LayerState::NeedsDataUpdate ||
+       (instanced && states >= LayerState::NeedsNodeOrderUpdate))
     {
-        state.vertexBuffer.setData(state.vertices);
+        /* Instances and vertices are uploaded the same way, just with a
+           different type. Compact vertices are converted from the whole
+           vertex data or just the changed range below. */
+        const Containers::ArrayView<const char> vertexData = instanced ?
+            Containers::arrayCast<const char>(Containers::arrayView(state.glyphInstances)) :
+            Containers::arrayCast<const char>(Containers::arrayView(state.vertices));
+        const std::size_t typeSize = instanced ?
+            sizeof(Implementation::TextLayerGlyphInstance) :
+            sizeof(Implementation::TextLayerVertex);
+        const std::size_t bufferTypeSize = compact ?
+            sizeof(Implementation::TextLayerCompactVertex) : typeSize;
+        const auto bufferVertexData = [&](const std::size_t begin, const std::size_t end) -> Containers::ArrayView<const char> {
+            if(!compact)
+                return vertexData.slice(begin*typeSize, end*typeSize);
+            if(state.compactVertexScratch.size() < end - begin)
+                state.compactVertexScratch = Containers::Array<Implementation::TextLayerCompactVertex>{NoInit, end - begin};
+            const Containers::ArrayView<Implementation::TextLayerCompactVertex> out = state.compactVertexScratch.prefix(end - begin);
+            Implementation::compactTextLayerVerticesInto(state.vertices.slice(begin, end), out, state.uiSize);
+            return Containers::arrayCast<const char>(out);
+        };
+
+        #ifndef MAGNUM_TARGET_GLES
+        /* With streaming, the whole vertex data are copied to the next
+           segment of the persistently mapped buffer, which is then drawn from
+           by offsetting the base vertex or base instance. If the buffer got
+           recreated, the mesh has to be set up again. */
+        if(state.streamingVertexBuffer) {
+            if(state.streamingVertexBuffer->write(bufferVertexData(0, vertexData.size()/typeSize), bufferTypeSize)) {
+                state.mesh = GL::Mesh{};
+                setupMesh(state.mesh, state.streamingVertexBuffer->buffer(), state.indexBuffer, instanced, compact);
+            }
+            if(instanced)
+                state.streamingBaseInstance = state.streamingVertexBuffer->segmentOffset()/typeSize;
+            else
+                state.mesh.setBaseVertex(Int(state.streamingVertexBuffer->segmentOffset()/bufferTypeSize));
+        } else
+        #endif
+        /* Upload the whole vertex data only if their size changed, otherwise
+           just the range that TextLayer::doUpdate() actually changed */
+        if(state.vertexBufferSize != vertexData.size()/typeSize) {
+            state.vertexBuffer.setData(bufferVertexData(0, vertexData.size()/typeSize));
+            state.vertexBufferSize = vertexData.size()/typeSize;
+        } else if(state.vertexUpdateBegin < state.vertexUpdateEnd) {
+            state.vertexBuffer.setSubData(state.vertexUpdateBegin*bufferTypeSize, bufferVertexData(state.vertexUpdateBegin, state.vertexUpdateEnd));
+        }
+        state.vertexUpdateBegin = ~UnsignedInt{};
+        state.vertexUpdateEnd = 0;
+
+        /** @todo track changed ranges for the editing vertices as well, it's
+            just two quads per editable text so far less important */
         if(sharedState.hasEditingStyles)
             state.editingVertexBuffer.setData(state.editingVertices);
     }
 
+    /* Range of dynamic styles to upload. If it's empty, which can happen only
+       if the dynamic style changed flags were set from outside, upload all of
+       them. */
+    UnsignedInt dynamicStyleBegin = state.dynamicStyleChangedBegin;
+    UnsignedInt dynamicStyleEnd = state.dynamicStyleChangedEnd;
+    if(dynamicStyleBegin >= dynamicStyleEnd) {
+        dynamicStyleBegin = 0;
+        dynamicStyleEnd = sharedState.dynamicStyleCount;
+    }
+
     /* If we have dynamic styles and either NeedsCommonDataUpdate is set
        (meaning either the static style or the dynamic style changed) or
        they haven't been uploaded yet at all, upload them. */
@@ -443,7 +770,7 @@ void TextLayerGL::doUpdate(const LayerStates states, const Containers::StridedAr
             /** @todo check if DynamicDraw has any effect on perf */
             state.styleBuffer = GL::Buffer{GL::Buffer::TargetHint::Uniform, {nullptr, sizeof(TextLayerCommonStyleUniform) + sizeof(TextLayerStyleUniform)*(sharedState.styleUniformCount + sharedState.dynamicStyleCount*(sharedState.hasEditingStyles ? 3 : 1))}, GL::BufferUsage::DynamicDraw};
         }
-        if(needsFirstUpload || sharedStyleChanged) {
+        if(needsFirstUpload || state.pendingSharedStyleChanged) {
             state.styleBuffer.setSubData(0, {&sharedState.commonStyleUniform, 1});
             /* If dynamic styles include editing styles, styleUniforms contain
                also uniforms used for text selection. If there are no dynamic
@@ -452,9 +779,20 @@ void TextLayerGL::doUpdate(const LayerStates states, const Containers::StridedAr
             if(!sharedState.styleUniforms.isEmpty())
                 state.styleBuffer.setSubData(sizeof(TextLayerCommonStyleUniform), sharedState.styleUniforms);
         }
-        if(needsFirstUpload || state.dynamicStyleChanged) {
+        if(needsFirstUpload) {
             state.styleBuffer.setSubData(sizeof(TextLayerCommonStyleUniform) + sizeof(TextLayerStyleUniform)*sharedState.styleUniformCount, state.dynamicStyleUniforms);
             state.dynamicStyleChanged = false;
+        } else if(state.dynamicStyleChanged) {
+            /* Upload only the range of dynamic styles that changed, and if
+               there are editing styles, also the corresponding range of the
+               uniforms for selected text, which are after */
+            state.styleBuffer.setSubData(sizeof(TextLayerCommonStyleUniform) + sizeof(TextLayerStyleUniform)*(sharedState.styleUniformCount + dynamicStyleBegin), state.dynamicStyleUniforms.slice(dynamicStyleBegin, dynamicStyleEnd));
+            if(sharedState.hasEditingStyles) {
+                const UnsignedInt textUniformBegin = sharedState.dynamicStyleCount + 2*dynamicStyleBegin;
+                const UnsignedInt textUniformEnd = sharedState.dynamicStyleCount + 2*dynamicStyleEnd;
+                state.styleBuffer.setSubData(sizeof(TextLayerCommonStyleUniform) + sizeof(TextLayerStyleUniform)*(sharedState.styleUniformCount + textUniformBegin), state.dynamicStyleUniforms.slice(textUniformBegin, textUniformEnd));
+            }
+            state.dynamicStyleChanged = false;
         }
     }
 
@@ -469,17 +807,33 @@ void TextLayerGL::doUpdate(const LayerStates states, const Containers::StridedAr
             /** @todo check if DynamicDraw has any effect on perf */
             state.editingStyleBuffer = GL::Buffer{GL::Buffer::TargetHint::Uniform, {nullptr, sizeof(TextLayerCommonEditingStyleUniform) + sizeof(TextLayerEditingStyleUniform)*(sharedState.editingStyleUniformCount + 2*sharedState.dynamicStyleCount)}, GL::BufferUsage::DynamicDraw};
         }
-        if(needsFirstUpload || sharedEditingStyleChanged) {
+        if(needsFirstUpload || state.pendingSharedEditingStyleChanged) {
             state.editingStyleBuffer.setSubData(0, {&sharedState.commonEditingStyleUniform, 1});
             /* Skip empty upload if there are just dynamic styles */
             if(!sharedState.editingStyleUniforms.isEmpty())
                 state.editingStyleBuffer.setSubData(sizeof(TextLayerCommonEditingStyleUniform), sharedState.editingStyleUniforms);
         }
-        if(needsFirstUpload || state.dynamicEditingStyleChanged) {
+        if(needsFirstUpload) {
             state.editingStyleBuffer.setSubData(sizeof(TextLayerCommonEditingStyleUniform) + sizeof(TextLayerEditingStyleUniform)*sharedState.editingStyleUniformCount, state.dynamicEditingStyleUniforms);
             state.dynamicEditingStyleChanged = false;
+        } else if(state.dynamicEditingStyleChanged) {
+            /* Each dynamic style has two editing styles, upload only the
+               range that changed */
+            state.editingStyleBuffer.setSubData(sizeof(TextLayerCommonEditingStyleUniform) + sizeof(TextLayerEditingStyleUniform)*(sharedState.editingStyleUniformCount + 2*dynamicStyleBegin), state.dynamicEditingStyleUniforms.slice(2*dynamicStyleBegin, 2*dynamicStyleEnd));
+            state.dynamicEditingStyleChanged = false;
         }
     }
+
+    /* Reset the changed range once both the dynamic styles and dynamic editing
+       styles are uploaded */
+    if(!state.dynamicStyleChanged && !state.dynamicEditingStyleChanged) {
+        state.dynamicStyleChangedBegin = ~UnsignedInt{};
+        state.dynamicStyleChangedEnd = 0;
+    }
+
+    state.pendingUploadStates = {};
+    state.pendingSharedStyleChanged = false;
+    state.pendingSharedEditingStyleChanged = false;
 }
 
 void TextLayerGL::doDraw(const Containers::StridedArrayView1D<const UnsignedInt>&, const std::size_t offset, const std::size_t count, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const std::size_t clipRectOffset, const std::size_t clipRectCount, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Vector2>&, const Containers::StridedArrayView1D<const Float>&, Containers::BitArrayView, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes) {
@@ -491,6 +845,44 @@ void TextLayerGL::doDraw(const Containers::StridedArrayView1D<const UnsignedInt>
     CORRADE_ASSERT(sharedState.setStyleCalled,
         "Ui::TextLayerGL::draw(): no style data was set", );
 
+    uploadPendingData();
+
+    /* Wait for the shader compilation submitted in the Shared constructor
+       to finish, if not already */
+    sharedState.shader.finalize();
+    if(sharedState.hasEditingStyles)
+        sharedState.editingShader.finalize();
+
+    /* With instanced glyphs, upload the glyph properties if the glyph cache
+       has more glyphs than last time. The texture is shared among all layers,
+       so this happens only in the first layer that's drawn after the glyph
+       cache changes. */
+    if(sharedState.instancedGlyphs) {
+        const Text::AbstractGlyphCache& cache = *sharedState.glyphCache;
+        const UnsignedInt glyphCount = cache.glyphCount();
+        if(glyphCount != sharedState.glyphPropertiesGlyphCount) {
+            const Vector2i size{512, Int((glyphCount + 255)/256)};
+            Containers::Array<Vector4> properties{ValueInit, std::size_t(size.product())};
+            const Containers::StridedArrayView1D<const Vector2i> offsets = cache.glyphOffsets();
+            const Containers::StridedArrayView1D<const Int> layers = cache.glyphLayers();
+            const Containers::StridedArrayView1D<const Range2Di> rectangles = cache.glyphRectangles();
+            for(UnsignedInt i = 0; i != glyphCount; ++i) {
+                properties[i*2 + 0] = {Float(offsets[i].x()), Float(offsets[i].y()), Float(rectangles[i].sizeX()), Float(rectangles[i].sizeY())};
+                properties[i*2 + 1] = {Float(rectangles[i].left()), Float(rectangles[i].bottom()), Float(layers[i]), 0.0f};
+            }
+
+            (sharedState.glyphPropertiesTexture = GL::Texture2D{})
+                .setMinificationFilter(GL::SamplerFilter::Nearest)
+                .setMagnificationFilter(GL::SamplerFilter::Nearest)
+                .setStorage(1, GL::TextureFormat::RGBA32F, size)
+                .setSubImage(0, {}, ImageView2D{PixelFormat::RGBA32F, size, properties});
+            sharedState.glyphPropertiesGlyphCount = glyphCount;
+        }
+        sharedState.shader
+            .setGlyphCacheSize(cache.size().xy())
+            .bindGlyphPropertiesTexture(sharedState.glyphPropertiesTexture);
+    }
+
     sharedState.shader.bindGlyphTexture(static_cast<Text::GlyphCacheGL&>(*sharedState.glyphCache).texture());
 
     /* If there are dynamic styles, bind the layer-specific buffer that
@@ -504,17 +896,27 @@ void TextLayerGL::doDraw(const Containers::StridedArrayView1D<const UnsignedInt>
         sharedState.editingShader.bindStyleBuffer(sharedState.dynamicStyleCount ?
             state.editingStyleBuffer : sharedState.editingStyleBuffer);
 
-    std::size_t clipDataOffset = offset;
-    for(std::size_t i = 0; i != clipRectCount; ++i) {
+    const auto scissorRectangle = [&](const std::size_t i) {
         const UnsignedInt clipRectId = clipRectIds[clipRectOffset + i];
-        const UnsignedInt clipRectDataCount = clipRectDataCounts[clipRectOffset + i];
         const Vector2i clipRectOffset_ = Vector2i{clipRectOffsets[clipRectId]*state.clipScale};
         const Vector2i clipRectSize = clipRectSizes[clipRectId].isZero() ?
             state.framebufferSize : Vector2i{clipRectSizes[clipRectId]*state.clipScale};
-
-        GL::Renderer::setScissor(Range2Di::fromSize(
+        return Range2Di::fromSize(
             {clipRectOffset_.x(), state.framebufferSize.y() - clipRectOffset_.y() - clipRectSize.y()},
-            clipRectSize));
+            clipRectSize);
+    };
+
+    std::size_t clipDataOffset = offset;
+    for(std::size_t i = 0; i != clipRectCount; ) {
+        /* Consecutive clip rects that result in the same scissor rectangle,
+           such as unclipped top-level nodes that got merged into a single
+           draw, are drawn together */
+        const Range2Di scissor = scissorRectangle(i);
+        UnsignedInt clipRectDataCount = clipRectDataCounts[clipRectOffset + i];
+        for(++i; i != clipRectCount && scissorRectangle(i) == scissor; ++i)
+            clipRectDataCount += clipRectDataCounts[clipRectOffset + i];
+
+        GL::Renderer::setScissor(scissor);
 
         /* If there are any selection / cursor quads for texts in this clip
            rect, draw them before the actual text. The assumption is that
@@ -534,9 +936,20 @@ void TextLayerGL::doDraw(const Containers::StridedArrayView1D<const UnsignedInt>
                 .draw(state.editingMesh);
         }
 
-        state.mesh
-            .setIndexOffset(state.indexDrawOffsets[clipDataOffset].first())
-            .setCount(state.indexDrawOffsets[clipDataOffset + clipRectDataCount].first() - state.indexDrawOffsets[clipDataOffset].first());
+        /* With instanced glyphs the draw offsets are still calculated in
+           indices, six for each glyph */
+        #ifndef MAGNUM_TARGET_GLES
+        if(sharedState.instancedGlyphs)
+            state.mesh
+                .setBaseInstance(state.streamingBaseInstance + state.indexDrawOffsets[clipDataOffset].first()/6)
+                .setInstanceCount((state.indexDrawOffsets[clipDataOffset + clipRectDataCount].first() - state.indexDrawOffsets[clipDataOffset].first())/6);
+        else
+        #endif
+        {
+            state.mesh
+                .setIndexOffset(state.indexDrawOffsets[clipDataOffset].first())
+                .setCount(state.indexDrawOffsets[clipDataOffset + clipRectDataCount].first() - state.indexDrawOffsets[clipDataOffset].first());
+        }
         sharedState.shader
             .draw(state.mesh);
 
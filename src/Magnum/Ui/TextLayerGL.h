@@ -77,6 +77,33 @@ class MAGNUM_UI_EXPORT TextLayerGL: public TextLayer {
         /** @overload */
         inline const Shared& shared() const;
 
+        #ifndef MAGNUM_TARGET_GLES
+        /**
+         * @brief Whether the vertex buffer is streamed
+         * @m_since_latest
+         *
+         * @requires_gl Persistently mapped buffers are not available in
+         *      OpenGL ES or WebGL.
+         * @see @ref setVertexBufferStreaming()
+         */
+        bool isVertexBufferStreaming() const;
+
+        /**
+         * @brief Set whether the vertex buffer is streamed
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * Same as @ref BaseLayerGL::setVertexBufferStreaming(), see its
+         * documentation for more information. Affects only the glyph vertex
+         * data, vertex data for cursor and selection quads are always uploaded
+         * using @ref GL::Buffer::setData().
+         * @requires_gl44 Extension @gl_extension{ARB,buffer_storage}
+         * @requires_gl Persistently mapped buffers are not available in
+         *      OpenGL ES or WebGL.
+         */
+        TextLayerGL& setVertexBufferStreaming(bool enabled);
+        #endif
+
     protected:
         /**
          * @copybrief AbstractLayer::doDraw()
@@ -102,7 +129,11 @@ class MAGNUM_UI_EXPORT TextLayerGL: public TextLayer {
 
         void doSetSize(const Vector2& size, const Vector2i& framebufferSize) override;
 
+        void doMemoryUsage(MemoryUsage& usage) const override;
+
         void doUpdate(LayerStates states, const Containers::StridedArrayView1D<const UnsignedInt>& dataIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectIds, const Containers::StridedArrayView1D<const UnsignedInt>& clipRectDataCounts, const Containers::StridedArrayView1D<const Vector2>& nodeOffsets, const Containers::StridedArrayView1D<const Vector2>& nodeSizes, const Containers::StridedArrayView1D<const Float>& nodeOpacities, Containers::BitArrayView nodesEnabled, const Containers::StridedArrayView1D<const Vector2>& clipRectOffsets, const Containers::StridedArrayView1D<const Vector2>& clipRectSizes, const Containers::StridedArrayView1D<const Vector2>& compositeRectOffsets, const Containers::StridedArrayView1D<const Vector2>& compositeRectSizes) override;
+
+        MAGNUM_UI_LOCAL void uploadPendingData();
 };
 
 /**
@@ -112,6 +143,11 @@ Contains fonts, shader instances and style data. In order to use the layer it's
 expected that @ref setGlyphCache() was called and at least one font was added
 with @ref addFont(). In order to update or draw the layer it's expected that
 @ref setStyle() was called.
+
+The shaders are compiled and linked asynchronously if
+@gl_extension{KHR,parallel_shader_compile} is supported, with the constructor
+only submitting the work and the first draw of a layer using this instance
+waiting for it to finish.
 */
 class MAGNUM_UI_EXPORT TextLayerGL::Shared: public TextLayer::Shared {
     public:
@@ -144,7 +180,10 @@ class MAGNUM_UI_EXPORT TextLayerGL::Shared: public TextLayer::Shared {
          *
          * Like @ref setGlyphCache(Text::GlyphCacheGL&), but the shared state
          * takes over the glyph cache ownership. You can access the instance
-         * using @ref glyphCache() later.
+         * using @ref glyphCache() later. As the instance is moved into a
+         * @ref Text::GlyphCacheGL, subclasses such as
+         * @ref Text::DistanceFieldGlyphCacheGL have to be passed to
+         * @ref setGlyphCache(Text::GlyphCacheGL&) instead.
          */
         Shared& setGlyphCache(Text::GlyphCacheGL&& cache);
 
@@ -35,5 +35,15 @@ NOPERSPECTIVE in lowp vec4 interpolatedColor;
 out lowp vec4 fragmentColor;
 
 void main() {
+    #ifdef DISTANCE_FIELD
+    /* The edge is at 0.5, antialias it over about one pixel on the screen
+       based on how fast the distance changes there. Not using fwidth() as
+       the length is more precise for rotated edges, the max() avoids a
+       division by zero in smoothstep() if the distance is constant. */
+    lowp float distance = texture(glyphTextureData, interpolatedTextureCoordinates.xy).r;
+    mediump float smoothness = max(0.7*length(vec2(dFdx(distance), dFdy(distance))), 0.0001);
+    fragmentColor = interpolatedColor*smoothstep(0.5 - smoothness, 0.5 + smoothness, distance);
+    #else
     fragmentColor = interpolatedColor*texture(glyphTextureData, interpolatedTextureCoordinates.xy).r;
+    #endif
 }
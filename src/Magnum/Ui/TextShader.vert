@@ -45,8 +45,37 @@ layout(location = 0)
 #endif
 uniform highp vec2 projection;
 
+#ifdef INSTANCED_GLYPHS
+/* Glyph cache size in pixels, which the glyph properties are relative to.
+   Not queried from the glyph cache texture as it can be smaller than the
+   cache in case of a distance field glyph cache. */
+#ifdef EXPLICIT_UNIFORM_LOCATION
+layout(location = 1)
+#endif
+uniform highp vec2 glyphCacheSize;
+
+/* Two texels for each glyph in the cache, 256 glyphs in a row. The first is
+   glyph offset and size, the second is the bottom left corner of the glyph
+   rectangle and the texture layer, all in pixels. */
+#ifdef EXPLICIT_BINDING
+layout(binding = 1)
+#endif
+uniform highp sampler2D glyphPropertiesData;
+
+/* Glyph origin, already aligned and Y-flipped */
+layout(location = 0) in highp vec2 instancePosition;
+layout(location = 1) in mediump float instanceScale;
+layout(location = 4) in highp uint instanceGlyphId;
+#elif !defined(COMPACT_VERTICES)
 layout(location = 0) in highp vec2 position;
 layout(location = 1) in mediump vec3 textureCoordinates;
+#else
+/* Position is a 16-bit fixed-point value in units of 1/16384 of the UI size,
+   texture coordinate XY in units of 1/65535 and Z is the layer, converted
+   back in main() */
+layout(location = 0) in highp vec2 compactPosition;
+layout(location = 1) in highp vec3 compactTextureCoordinates;
+#endif
 layout(location = 2) in lowp vec4 color;
 layout(location = 3) in mediump uint style;
 
@@ -54,7 +83,31 @@ NOPERSPECTIVE out mediump vec3 interpolatedTextureCoordinates;
 NOPERSPECTIVE out lowp vec4 interpolatedColor;
 
 void main() {
+    /* With instanced glyphs, expand the corners from the vertex ID, which
+       goes from 0 to 3 for a triangle strip in the same order as
+       Text::renderGlyphQuadsInto() produces vertices. The glyph properties
+       are Y-up, so the position is Y-flipped to be relative to the origin.
+
+        2---3
+        |   |
+        |   |
+        |   |
+        0---1 */
+    #ifdef INSTANCED_GLYPHS
+    highp ivec2 glyphTexel = ivec2(int(instanceGlyphId & 255u)*2, int(instanceGlyphId >> 8u));
+    highp vec4 glyphOffsetSize = texelFetch(glyphPropertiesData, glyphTexel, 0);
+    highp vec4 glyphRectangleLayer = texelFetch(glyphPropertiesData, glyphTexel + ivec2(1, 0), 0);
+    mediump vec2 corner = vec2(float(gl_VertexID & 1), float((gl_VertexID >> 1) & 1));
+    highp vec2 position = instancePosition + (glyphOffsetSize.xy + corner*glyphOffsetSize.zw)*instanceScale*vec2(1.0, -1.0);
+    interpolatedTextureCoordinates = vec3((glyphRectangleLayer.xy + corner*glyphOffsetSize.zw)/glyphCacheSize, glyphRectangleLayer.z);
+    #elif !defined(COMPACT_VERTICES)
     interpolatedTextureCoordinates = textureCoordinates;
+    #else
+    /* The projection is 2/size, so the UI size is derived from it instead of
+       having to supply it in another uniform */
+    highp vec2 position = compactPosition/(8192.0*abs(projection));
+    interpolatedTextureCoordinates = vec3(compactTextureCoordinates.xy/65535.0, compactTextureCoordinates.z);
+    #endif
     /* Calculate the combined color here already to save a vec4 load in each
        fragment shader invocation */
     interpolatedColor = styles[style].color*color;
@@ -0,0 +1,115 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "TextureAtlas.h"
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Iterable.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Vector3.h>
+#include <Magnum/TextureTools/Atlas.h>
+
+namespace Magnum { namespace Ui {
+
+struct TextureAtlas::State {
+    explicit State(PixelFormat format, const Vector3i& size): format{format}, atlas{size} {}
+
+    PixelFormat format;
+    TextureTools::AtlasLandfill atlas;
+};
+
+TextureAtlas::TextureAtlas(const PixelFormat format, const Vector3i& size): _state{InPlaceInit, format, size} {
+    /* BaseLayer texture coordinates have just an offset and a size, so there's
+       no way to express rotated images */
+    _state->atlas.clearFlags(TextureTools::AtlasLandfillFlag::RotatePortrait|
+                             TextureTools::AtlasLandfillFlag::RotateLandscape);
+}
+
+TextureAtlas::TextureAtlas(TextureAtlas&&) noexcept = default;
+
+TextureAtlas::~TextureAtlas() = default;
+
+TextureAtlas& TextureAtlas::operator=(TextureAtlas&&) noexcept = default;
+
+PixelFormat TextureAtlas::format() const {
+    return _state->format;
+}
+
+Vector3i TextureAtlas::size() const {
+    return _state->atlas.size();
+}
+
+TextureTools::AtlasLandfill& TextureAtlas::atlas() {
+    return _state->atlas;
+}
+
+const TextureTools::AtlasLandfill& TextureAtlas::atlas() const {
+    return _state->atlas;
+}
+
+bool TextureAtlas::add(const Containers::Iterable<const ImageView2D>& images, const Containers::StridedArrayView1D<Vector3>& offsets, const Containers::StridedArrayView1D<Vector2>& sizes) {
+    CORRADE_ASSERT(offsets.size() == images.size() && sizes.size() == images.size(),
+        "Ui::TextureAtlas::add(): expected offsets and sizes views to have a size of" << images.size() << "but got" << offsets.size() << "and" << sizes.size(), {});
+    State& state = *_state;
+
+    Containers::Array<Vector2i> imageSizes{NoInit, images.size()};
+    for(std::size_t i = 0; i != images.size(); ++i) {
+        const ImageView2D& image = images[i];
+        CORRADE_ASSERT(image.format() == state.format,
+            "Ui::TextureAtlas::add(): expected image" << i << "to be" << state.format << "but got" << image.format(), {});
+        imageSizes[i] = image.size();
+    }
+
+    /* If the images don't fit, the atlas stays unchanged */
+    Containers::Array<Vector3i> imageOffsets{NoInit, images.size()};
+    if(!state.atlas.add(imageSizes, imageOffsets))
+        return false;
+
+    const Vector2 scale = 1.0f/Vector2{state.atlas.size().xy()};
+    for(std::size_t i = 0; i != images.size(); ++i) {
+        if(imageSizes[i].product())
+            doSetImage(imageOffsets[i], images[i]);
+        offsets[i] = {Vector2{imageOffsets[i].xy()}*scale, Float(imageOffsets[i].z())};
+        sizes[i] = Vector2{imageSizes[i]}*scale;
+    }
+
+    return true;
+}
+
+Containers::Optional<Containers::Pair<Vector3, Vector2>> TextureAtlas::add(const ImageView2D& image) {
+    Vector3 offset;
+    Vector2 size;
+    if(!add(Containers::arrayView(&image, 1), Containers::stridedArrayView(&offset, 1), Containers::stridedArrayView(&size, 1)))
+        return {};
+    return Containers::pair(offset, size);
+}
+
+}}
@@ -0,0 +1,164 @@
+#ifndef Magnum_Ui_TextureAtlas_h
+#define Magnum_Ui_TextureAtlas_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+/** @file
+ * @brief Class @ref Magnum::Ui::TextureAtlas
+ * @m_since_latest
+ */
+
+#include <Corrade/Containers/Pointer.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/TextureTools/TextureTools.h>
+
+#include "Magnum/Ui/Ui.h"
+#include "Magnum/Ui/visibility.h"
+
+namespace Magnum { namespace Ui {
+
+/**
+@brief Texture atlas for base layer data
+@m_since_latest
+
+Packs images incrementally into layers of a texture array using
+@ref TextureTools::AtlasLandfill and returns texture coordinates for
+@ref BaseLayer::setTextureCoordinates(). Meant to be used with layers that have
+@ref BaseLayerSharedFlag::Textured enabled, so images from many sources can be
+drawn with a single layer and a single texture instead of each ending up in a
+separate one. Each image is uploaded just once when it's added, the rest of
+the texture isn't touched.
+
+This class only manages the placement, the upload is done by a subclass. For
+use with @ref BaseLayerGL see the @ref TextureAtlasGL subclass.
+
+@section Ui-TextureAtlas-subclassing Subclassing
+
+A subclass is expected to implement @ref doSetImage(), which gets called for
+every added image with its placement in the texture array.
+*/
+class MAGNUM_UI_EXPORT TextureAtlas {
+    public:
+        /**
+         * @brief Constructor
+         * @param format    Pixel format of the texture array
+         * @param size      Size of the texture array, with the Z coordinate
+         *      being the layer count
+         *
+         * Image rotations are disabled in the underlying @ref atlas(), as the
+         * texture coordinates in @ref BaseLayer can't express them.
+         */
+        explicit TextureAtlas(PixelFormat format, const Vector3i& size);
+
+        /** @brief Copying is not allowed */
+        TextureAtlas(const TextureAtlas&) = delete;
+
+        /**
+         * @brief Move constructor
+         *
+         * Performs a destructive move, i.e. the original object isn't usable
+         * afterwards anymore.
+         */
+        TextureAtlas(TextureAtlas&&) noexcept;
+
+        virtual ~TextureAtlas();
+
+        /** @brief Copying is not allowed */
+        TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+        /** @brief Move assignment */
+        TextureAtlas& operator=(TextureAtlas&&) noexcept;
+
+        /** @brief Pixel format */
+        PixelFormat format() const;
+
+        /**
+         * @brief Size
+         *
+         * The Z coordinate is the texture array layer count.
+         */
+        Vector3i size() const;
+
+        /**
+         * @brief Atlas packer instance
+         *
+         * Can be used to adjust padding between the images or to query how
+         * much of the texture is filled. Adding images to it directly will
+         * make the space reserved but no image data uploaded.
+         */
+        TextureTools::AtlasLandfill& atlas();
+        const TextureTools::AtlasLandfill& atlas() const; /**< @overload */
+
+        /**
+         * @brief Add images
+         * @param[in]  images   Images to add
+         * @param[out] offsets  Texture coordinate offsets, with the Z
+         *      coordinate being the texture array layer
+         * @param[out] sizes    Texture coordinate sizes
+         * @return Whether the images fit
+         *
+         * Places all @p images into the atlas at once, which results in
+         * better packing than adding them one by one, and calls
+         * @ref doSetImage() for each of them. The @p offsets and @p sizes can
+         * be passed directly to @ref BaseLayer::setTextureCoordinates(). If
+         * the images don't fit, returns @cpp false @ce and nothing is added or
+         * uploaded.
+         *
+         * Expects that the @p offsets and @p sizes views have the same size as
+         * @p images and that all images have the same pixel format as
+         * @ref format().
+         */
+        bool add(const Containers::Iterable<const ImageView2D>& images, const Containers::StridedArrayView1D<Vector3>& offsets, const Containers::StridedArrayView1D<Vector2>& sizes);
+
+        /**
+         * @brief Add a single image
+         *
+         * Same as calling @ref add(const Containers::Iterable<const ImageView2D>&, const Containers::StridedArrayView1D<Vector3>&, const Containers::StridedArrayView1D<Vector2>&)
+         * with a single image. Returns the texture coordinate offset and
+         * size or @relativeref{Corrade,Containers::NullOpt} if the image
+         * doesn't fit.
+         */
+        Containers::Optional<Containers::Pair<Vector3, Vector2>> add(const ImageView2D& image);
+
+    private:
+        /**
+         * @brief Implementation for @ref add()
+         * @param offset    Offset in the texture array, with the Z
+         *      coordinate being the layer
+         * @param image     Image to upload
+         *
+         * Called for every image that got placed into the atlas, with
+         * @p image having the same pixel format as @ref format(). Not called
+         * for images with zero area.
+         */
+        virtual void doSetImage(const Vector3i& offset, const ImageView2D& image) = 0;
+
+        struct State;
+        Containers::Pointer<State> _state;
+};
+
+}}
+
+#endif
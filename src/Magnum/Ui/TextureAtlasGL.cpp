@@ -0,0 +1,68 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "TextureAtlasGL.h"
+
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/GL/TextureArray.h>
+#include <Magnum/GL/TextureFormat.h>
+#include <Magnum/Math/Vector3.h>
+
+namespace Magnum { namespace Ui {
+
+struct TextureAtlasGL::State {
+    GL::Texture2DArray texture;
+};
+
+TextureAtlasGL::TextureAtlasGL(const PixelFormat format, const Vector3i& size): TextureAtlasGL{GL::textureFormat(format), format, size} {}
+
+TextureAtlasGL::TextureAtlasGL(const GL::TextureFormat internalFormat, const PixelFormat format, const Vector3i& size): TextureAtlas{format, size}, _state{InPlaceInit} {
+    _state->texture
+        .setMinificationFilter(GL::SamplerFilter::Linear, GL::SamplerMipmap::Base)
+        .setMagnificationFilter(GL::SamplerFilter::Linear)
+        .setWrapping(GL::SamplerWrapping::ClampToEdge)
+        .setStorage(1, internalFormat, size);
+}
+
+TextureAtlasGL::TextureAtlasGL(TextureAtlasGL&&) noexcept = default;
+
+TextureAtlasGL::~TextureAtlasGL() = default;
+
+TextureAtlasGL& TextureAtlasGL::operator=(TextureAtlasGL&&) noexcept = default;
+
+GL::Texture2DArray& TextureAtlasGL::texture() {
+    return _state->texture;
+}
+
+void TextureAtlasGL::doSetImage(const Vector3i& offset, const ImageView2D& image) {
+    /* Upload just the area of the image, the rest of the texture is left
+       untouched */
+    _state->texture.setSubImage(0, offset, ImageView3D{image.storage(), image.format(), {image.size(), 1}, image.data()});
+}
+
+}}
@@ -0,0 +1,117 @@
+#ifndef Magnum_Ui_TextureAtlasGL_h
+#define Magnum_Ui_TextureAtlasGL_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+/** @file
+ * @brief Class @ref Magnum::Ui::TextureAtlasGL
+ * @m_since_latest
+ */
+
+#include "Magnum/configure.h"
+
+#ifdef MAGNUM_TARGET_GL
+#include <Magnum/GL/GL.h>
+
+#include "Magnum/Ui/TextureAtlas.h"
+
+namespace Magnum { namespace Ui {
+
+/**
+@brief OpenGL implementation of the texture atlas
+@m_since_latest
+
+Owns a @ref GL::Texture2DArray with a single mip level, linear filtering and
+clamp-to-edge wrapping, which gets the images uploaded as they're added. Pass
+the @ref texture() to @ref BaseLayerGL::setTexture() and use the coordinates
+returned from @ref add() with @ref BaseLayer::setTextureCoordinates():
+
+@snippet Ui-gl.cpp TextureAtlasGL
+
+@note This class is available only if Magnum is compiled with
+    @ref MAGNUM_TARGET_GL enabled (done by default). See @ref building-features
+    for more information.
+*/
+class MAGNUM_UI_EXPORT TextureAtlasGL: public TextureAtlas {
+    public:
+        /**
+         * @brief Constructor
+         * @param format    Pixel format of the texture array
+         * @param size      Size of the texture array, with the Z coordinate
+         *      being the layer count
+         *
+         * The texture storage is created with a format matching @p format
+         * using @ref GL::textureFormat().
+         */
+        explicit TextureAtlasGL(PixelFormat format, const Vector3i& size);
+
+        /**
+         * @brief Construct with a specific internal texture format
+         *
+         * Useful for example to use a @ref GL::TextureFormat::SRGB8Alpha8
+         * texture with @ref PixelFormat::RGBA8Unorm images.
+         */
+        explicit TextureAtlasGL(GL::TextureFormat internalFormat, PixelFormat format, const Vector3i& size);
+
+        /** @brief Copying is not allowed */
+        TextureAtlasGL(const TextureAtlasGL&) = delete;
+
+        /**
+         * @brief Move constructor
+         *
+         * Performs a destructive move, i.e. the original object isn't usable
+         * afterwards anymore.
+         */
+        TextureAtlasGL(TextureAtlasGL&&) noexcept;
+
+        ~TextureAtlasGL();
+
+        /** @brief Copying is not allowed */
+        TextureAtlasGL& operator=(const TextureAtlasGL&) = delete;
+
+        /** @brief Move assignment */
+        TextureAtlasGL& operator=(TextureAtlasGL&&) noexcept;
+
+        /**
+         * @brief Texture array instance
+         *
+         * Meant to be passed to @ref BaseLayerGL::setTexture(GL::Texture2DArray&).
+         * The atlas has to stay in scope for as long as the layer uses it.
+         */
+        GL::Texture2DArray& texture();
+
+    private:
+        MAGNUM_UI_LOCAL void doSetImage(const Vector3i& offset, const ImageView2D& image) override;
+
+        struct State;
+        Containers::Pointer<State> _state;
+};
+
+}}
+#else
+#error this header is available only in the OpenGL build
+#endif
+
+#endif
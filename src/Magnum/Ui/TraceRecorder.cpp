@@ -0,0 +1,139 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "TraceRecorder.h"
+
+#include <chrono>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringIterable.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/Utility/Format.h>
+
+#include "Magnum/Ui/AbstractUserInterface.h"
+
+namespace Magnum { namespace Ui {
+
+namespace {
+
+struct Event {
+    Long time;
+    UnsignedLong handle;
+    UnsignedByte value;
+    bool scope;
+    bool end;
+};
+
+/* Has to match the UserInterfacePhase and UserInterfaceTraceScope enum
+   order */
+constexpr const char* PhaseNames[]{
+    "Clean",
+    "NodeOrder",
+    "Layout",
+    "Cull",
+    "DataOrder",
+    "LayerUpdate",
+    "Draw",
+    "Composite"
+};
+constexpr const char* TraceScopeNames[]{
+    "LayerUpdate",
+    "LayerComposite",
+    "LayerDraw",
+    "LayouterUpdate",
+    "AnimatorAdvance",
+    "LayerAdvanceAnimations",
+    "Event"
+};
+
+}
+
+struct TraceRecorder::State {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    Containers::Array<Event> events;
+
+    void record(const UnsignedByte value, const UnsignedLong handle, const bool scope, const bool end) {
+        arrayAppend(events, InPlaceInit,
+            Long(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()),
+            handle, value, scope, end);
+    }
+};
+
+TraceRecorder::TraceRecorder(): _state{InPlaceInit} {}
+
+TraceRecorder::~TraceRecorder() = default;
+
+TraceRecorder& TraceRecorder::install(AbstractUserInterface& ui) {
+    ui.setPhaseCallback(phaseCallback, this)
+      .setTraceCallback(traceCallback, this);
+    return *this;
+}
+
+std::size_t TraceRecorder::eventCount() const {
+    return _state->events.size();
+}
+
+TraceRecorder& TraceRecorder::reset() {
+    State& state = *_state;
+    arrayClear(state.events);
+    state.start = std::chrono::steady_clock::now();
+    return *this;
+}
+
+Containers::String TraceRecorder::chromeTraceJson() const {
+    using namespace Containers::Literals;
+
+    const State& state = *_state;
+
+    Containers::Array<Containers::String> events;
+    arrayReserve(events, state.events.size());
+    for(const Event& event: state.events) {
+        /* The timestamp is in microseconds, keeping the nanosecond
+           precision */
+        const char* const name = event.scope ?
+            TraceScopeNames[event.value] : PhaseNames[event.value];
+        if(event.scope)
+            arrayAppend(events, Utility::format(R"({{"name":"{}","cat":"scope","ph":"{}","ts":{:.3f},"pid":0,"tid":0,"args":{{"handle":"0x{:x}"}}}})",
+                name, event.end ? "E" : "B", Double(event.time)/1000.0, event.handle));
+        else
+            arrayAppend(events, Utility::format(R"({{"name":"{}","cat":"phase","ph":"{}","ts":{:.3f},"pid":0,"tid":0}})",
+                name, event.end ? "E" : "B", Double(event.time)/1000.0));
+    }
+
+    return events.isEmpty() ?
+        Containers::String{R"({"traceEvents":[]})" "\n"} :
+        Utility::format("{{\"traceEvents\":[\n{}\n]}}\n", ",\n"_s.join(events));
+}
+
+void TraceRecorder::phaseCallback(const UserInterfacePhase phase, const bool end, void* const userData) {
+    static_cast<TraceRecorder*>(userData)->_state->record(UnsignedByte(phase), 0, false, end);
+}
+
+void TraceRecorder::traceCallback(const UserInterfaceTraceScope scope, const UnsignedLong handle, const bool end, void* const userData) {
+    static_cast<TraceRecorder*>(userData)->_state->record(UnsignedByte(scope), handle, true, end);
+}
+
+}}
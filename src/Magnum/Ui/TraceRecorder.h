@@ -0,0 +1,148 @@
+#ifndef Magnum_Ui_TraceRecorder_h
+#define Magnum_Ui_TraceRecorder_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+/** @file
+ * @brief Class @ref Magnum::Ui::TraceRecorder
+ * @m_since_latest
+ */
+
+#include <Corrade/Containers/Pointer.h>
+#include <Magnum/Magnum.h>
+
+#include "Magnum/Ui/Ui.h"
+#include "Magnum/Ui/visibility.h"
+
+namespace Magnum { namespace Ui {
+
+/**
+@brief User interface trace recorder
+@m_since_latest
+
+Records beginnings and ends of @ref UserInterfacePhase and
+@ref UserInterfaceTraceScope reported by an @ref AbstractUserInterface
+together with a timestamp, and exports them as a
+[Chrome trace event JSON](https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU/preview),
+which can be opened in `chrome://tracing` or the [Perfetto UI](https://ui.perfetto.dev/).
+Compared to aggregate timings from for example
+@relativeref{Magnum,DebugTools::FrameProfiler} it allows seeing individual
+stalls in a timeline.
+
+@code{.cpp}
+Ui::TraceRecorder recorder;
+recorder.install(ui);
+
+// draw a few frames ...
+
+Utility::Path::write("trace.json", recorder.chromeTraceJson());
+@endcode
+
+Timestamps are taken with @ref std::chrono::steady_clock, relative to when
+the recorder was constructed or last @ref reset(). The phases are always
+recorded, the finer-grained @ref UserInterfaceTraceScope events only if the
+library is built with `MAGNUM_UI_TRACING` enabled. Events are only ever
+appended, so call @ref reset() periodically for long sessions.
+*/
+class MAGNUM_UI_EXPORT TraceRecorder {
+    public:
+        /** @brief Constructor */
+        explicit TraceRecorder();
+
+        /**
+         * @brief Copying is not allowed
+         *
+         * The instance is referenced from callbacks installed with
+         * @ref install().
+         */
+        TraceRecorder(const TraceRecorder&) = delete;
+
+        /**
+         * @brief Moving is not allowed
+         *
+         * The instance is referenced from callbacks installed with
+         * @ref install().
+         */
+        TraceRecorder(TraceRecorder&&) = delete;
+
+        ~TraceRecorder();
+
+        /** @brief Copying is not allowed */
+        TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+        /** @brief Moving is not allowed */
+        TraceRecorder& operator=(TraceRecorder&&) = delete;
+
+        /**
+         * @brief Install to a user interface
+         * @return Reference to self (for method chaining)
+         *
+         * Replaces the @ref AbstractUserInterface::setPhaseCallback() and
+         * @relativeref{AbstractUserInterface,setTraceCallback()} on @p ui
+         * with callbacks that record to this instance. The recorder is
+         * expected to stay alive for as long as the callbacks are set.
+         * Installing to multiple user interfaces records all of them into
+         * the same timeline.
+         */
+        TraceRecorder& install(AbstractUserInterface& ui);
+
+        /**
+         * @brief Count of recorded events
+         *
+         * Beginning and end of each phase or scope are counted as separate
+         * events.
+         */
+        std::size_t eventCount() const;
+
+        /**
+         * @brief Discard all recorded events
+         * @return Reference to self (for method chaining)
+         *
+         * Timestamps of subsequently recorded events are relative to the
+         * time this function is called.
+         */
+        TraceRecorder& reset();
+
+        /**
+         * @brief Export recorded events as a Chrome trace event JSON
+         *
+         * Each event is a duration event with the phase or scope name,
+         * @cpp "phase" @ce or @cpp "scope" @ce in the category and a
+         * timestamp in microseconds. Scope events have the layer, layouter
+         * or animator handle in a @cpp "handle" @ce argument.
+         */
+        Containers::String chromeTraceJson() const;
+
+    private:
+        MAGNUM_UI_LOCAL static void phaseCallback(UserInterfacePhase phase, bool end, void* userData);
+        MAGNUM_UI_LOCAL static void traceCallback(UserInterfaceTraceScope scope, UnsignedLong handle, bool end, void* userData);
+
+        struct State;
+        Containers::Pointer<State> _state;
+};
+
+}}
+
+#endif
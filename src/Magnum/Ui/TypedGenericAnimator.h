@@ -0,0 +1,463 @@
+#ifndef Magnum_Ui_TypedGenericAnimator_h
+#define Magnum_Ui_TypedGenericAnimator_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Class @ref Magnum::Ui::TypedGenericAnimator, @ref Magnum::Ui::TypedGenericNodeAnimator, @ref Magnum::Ui::TypedGenericDataAnimator
+ * @m_since_latest
+ */
+
+#include <Corrade/Containers/BitArrayView.h>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StridedArrayView.h>
+
+#include "Magnum/Ui/AbstractAnimator.h"
+#include "Magnum/Ui/Handle.h"
+
+namespace Magnum { namespace Ui {
+
+namespace Implementation {
+
+/* Storage shared by all typed generic animators. Slots are indexed by
+   animation ID and recycled together with the animator handles, so once the
+   capacity is reached no allocations happen on animation creation. The
+   Optional is here to not require the function type to be default
+   constructible, which lambdas aren't. */
+template<class F> struct TypedGenericAnimatorStorage {
+    struct Animation {
+        Containers::Optional<F> animation;
+        Float(*easing)(Float);
+    };
+
+    void reserve(std::size_t capacity) {
+        arrayReserve(animations, capacity);
+    }
+
+    void create(const UnsignedInt id, F&& animation, Float(*const easing)(Float)) {
+        if(id >= animations.size())
+            arrayResize(animations, id + 1);
+        Animation& animationData = animations[id];
+        /* Not assigning as function objects such as lambdas with captures
+           may not be assignable */
+        animationData.animation.emplace(Utility::move(animation));
+        animationData.easing = easing;
+    }
+
+    void remove(const UnsignedInt id) {
+        /* Reset the Optional to call any captured state destructors */
+        animations[id].animation = Containers::NullOpt;
+    }
+
+    void clean(const Containers::BitArrayView animationIdsToRemove) {
+        /** @todo some way to iterate bits */
+        for(std::size_t i = 0; i != animationIdsToRemove.size(); ++i) {
+            if(!animationIdsToRemove[i])
+                continue;
+            remove(i);
+        }
+    }
+
+    Containers::Array<Animation> animations;
+};
+
+}
+
+/**
+@brief Generic animator with a compile-time animation function type
+@m_since_latest
+
+Like @ref GenericAnimator, but instead of storing each animation function in a
+type-erased @relativeref{Corrade,Containers::Function}, which allocates for
+captured state that's too large or not trivially copyable, the function type
+@p F is known at compile time and the function objects are stored directly in
+a contiguous array. Animation slots are recycled, so creating an animation
+doesn't allocate once enough capacity is reached, which can be ensured upfront
+with @ref reserve(). The function is called directly, allowing the compiler
+to inline it into the advance loop.
+
+The @p F type is meant to be a function object callable with a @ref Float
+interpolation factor, for example a lambda. As lambda types can't be named
+directly, one way to use this class is to make a named function object or to
+use @cpp decltype @ce on a lambda declared beforehand:
+
+@code{.cpp}
+struct FadeIn {
+    Ui::DataHandle data;
+    Color4 color;
+
+    void operator()(Float factor) { … }
+};
+
+Ui::TypedGenericAnimator<FadeIn>& animator = ui.setGenericAnimatorInstance(
+    Containers::pointer<Ui::TypedGenericAnimator<FadeIn>>(ui.createAnimator()));
+animator.create(FadeIn{data, 0x2f83cc_rgbf}, Animation::Easing::cubicOut,
+    now, 0.5_sec);
+@endcode
+
+Apart from that, behavior and constraints are the same as with
+@ref GenericAnimator, see its documentation for more information.
+@see @ref TypedGenericNodeAnimator, @ref TypedGenericDataAnimator
+*/
+template<class F> class TypedGenericAnimator: public AbstractGenericAnimator {
+    public:
+        /**
+         * @brief Constructor
+         * @param handle    Handle returned by
+         *      @ref AbstractUserInterface::createAnimator()
+         */
+        explicit TypedGenericAnimator(AnimatorHandle handle): AbstractGenericAnimator{handle} {}
+
+        /**
+         * @brief Create an animation
+         *
+         * Expects that @p easing is not @cpp nullptr @ce. The @p animation
+         * is called with the @p easing applied to the animation factor.
+         * Delegates to @ref AbstractAnimator::create(Nanoseconds, Nanoseconds, UnsignedInt, AnimationFlags),
+         * see its documentation and @ref GenericAnimator::create() for more
+         * information.
+         */
+        AnimationHandle create(F animation, Float(*easing)(Float), Nanoseconds played, Nanoseconds duration, UnsignedInt repeatCount = 1, AnimationFlags flags = {}) {
+            CORRADE_ASSERT(easing,
+                "Ui::TypedGenericAnimator::create(): easing is null", {});
+            const AnimationHandle handle = AbstractGenericAnimator::create(played, duration, repeatCount, flags);
+            _storage.create(animationHandleId(handle), Utility::move(animation), easing);
+            return handle;
+        }
+
+        /**
+         * @brief Remove an animation
+         *
+         * Expects that @p handle is valid. Delegates to
+         * @ref AbstractAnimator::remove(AnimationHandle), see its
+         * documentation for more information.
+         */
+        void remove(AnimationHandle handle) {
+            AbstractGenericAnimator::remove(handle);
+            _storage.remove(animationHandleId(handle));
+        }
+
+        /**
+         * @brief Remove an animation assuming it belongs to this animator
+         *
+         * Compared to @ref remove(AnimationHandle) delegates to
+         * @ref AbstractAnimator::remove(AnimatorDataHandle) instead.
+         */
+        void remove(AnimatorDataHandle handle) {
+            AbstractGenericAnimator::remove(handle);
+            _storage.remove(animatorDataHandleId(handle));
+        }
+
+        /**
+         * @brief Animation easing function
+         *
+         * Expects that @p handle is valid. The returned pointer is never
+         * @cpp nullptr @ce.
+         */
+        auto easing(AnimationHandle handle) const -> Float(*)(Float) {
+            CORRADE_ASSERT(isHandleValid(handle),
+                "Ui::TypedGenericAnimator::easing(): invalid handle" << handle, {});
+            return _storage.animations[animationHandleId(handle)].easing;
+        }
+
+        /**
+         * @brief Animation easing function assuming it belongs to this animator
+         *
+         * Like @ref easing(AnimationHandle) const but without checking that
+         * @p handle indeed belongs to this animator.
+         */
+        auto easing(AnimatorDataHandle handle) const -> Float(*)(Float) {
+            CORRADE_ASSERT(isHandleValid(handle),
+                "Ui::TypedGenericAnimator::easing(): invalid handle" << handle, {});
+            return _storage.animations[animatorDataHandleId(handle)].easing;
+        }
+
+    private:
+        AnimatorFeatures doFeatures() const override { return {}; }
+        void doReserve(std::size_t capacity) override {
+            _storage.reserve(capacity);
+        }
+        void doClean(Containers::BitArrayView animationIdsToRemove) override {
+            _storage.clean(animationIdsToRemove);
+        }
+        void doAdvance(Containers::BitArrayView active, const Containers::StridedArrayView1D<const Float>& factors) override {
+            /** @todo some way to iterate set bits */
+            for(std::size_t i = 0; i != active.size(); ++i) {
+                if(!active[i])
+                    continue;
+                typename Implementation::TypedGenericAnimatorStorage<F>::Animation& animation = _storage.animations[i];
+                (*animation.animation)(animation.easing(factors[i]));
+            }
+        }
+
+        Implementation::TypedGenericAnimatorStorage<F> _storage;
+};
+
+/**
+@brief Generic animator with a compile-time animation function type animating nodes
+@m_since_latest
+
+Like @ref GenericNodeAnimator, but with the function type @p F known at
+compile time, which makes the animation creation allocation-free. The @p F
+type is meant to be callable with a @ref NodeHandle and a @ref Float
+interpolation factor. See @ref TypedGenericAnimator for more information.
+*/
+template<class F> class TypedGenericNodeAnimator: public AbstractGenericAnimator {
+    public:
+        /**
+         * @brief Constructor
+         * @param handle    Handle returned by
+         *      @ref AbstractUserInterface::createAnimator()
+         */
+        explicit TypedGenericNodeAnimator(AnimatorHandle handle): AbstractGenericAnimator{handle} {}
+
+        /**
+         * @brief Create an animation
+         *
+         * Expects that @p easing is not @cpp nullptr @ce. Delegates to
+         * @ref AbstractAnimator::create(Nanoseconds, Nanoseconds, NodeHandle, UnsignedInt, AnimationFlags),
+         * see its documentation and @ref GenericNodeAnimator::create() for
+         * more information.
+         */
+        AnimationHandle create(F animation, Float(*easing)(Float), Nanoseconds played, Nanoseconds duration, NodeHandle node, UnsignedInt repeatCount = 1, AnimationFlags flags = {}) {
+            CORRADE_ASSERT(easing,
+                "Ui::TypedGenericNodeAnimator::create(): easing is null", {});
+            const AnimationHandle handle = AbstractGenericAnimator::create(played, duration, node, repeatCount, flags);
+            _storage.create(animationHandleId(handle), Utility::move(animation), easing);
+            return handle;
+        }
+
+        /**
+         * @brief Remove an animation
+         *
+         * Expects that @p handle is valid. Delegates to
+         * @ref AbstractAnimator::remove(AnimationHandle), see its
+         * documentation for more information.
+         */
+        void remove(AnimationHandle handle) {
+            AbstractGenericAnimator::remove(handle);
+            _storage.remove(animationHandleId(handle));
+        }
+
+        /**
+         * @brief Remove an animation assuming it belongs to this animator
+         *
+         * Compared to @ref remove(AnimationHandle) delegates to
+         * @ref AbstractAnimator::remove(AnimatorDataHandle) instead.
+         */
+        void remove(AnimatorDataHandle handle) {
+            AbstractGenericAnimator::remove(handle);
+            _storage.remove(animatorDataHandleId(handle));
+        }
+
+        /**
+         * @brief Animation easing function
+         *
+         * Expects that @p handle is valid. The returned pointer is never
+         * @cpp nullptr @ce.
+         */
+        auto easing(AnimationHandle handle) const -> Float(*)(Float) {
+            CORRADE_ASSERT(isHandleValid(handle),
+                "Ui::TypedGenericNodeAnimator::easing(): invalid handle" << handle, {});
+            return _storage.animations[animationHandleId(handle)].easing;
+        }
+
+        /**
+         * @brief Animation easing function assuming it belongs to this animator
+         *
+         * Like @ref easing(AnimationHandle) const but without checking that
+         * @p handle indeed belongs to this animator.
+         */
+        auto easing(AnimatorDataHandle handle) const -> Float(*)(Float) {
+            CORRADE_ASSERT(isHandleValid(handle),
+                "Ui::TypedGenericNodeAnimator::easing(): invalid handle" << handle, {});
+            return _storage.animations[animatorDataHandleId(handle)].easing;
+        }
+
+    private:
+        AnimatorFeatures doFeatures() const override {
+            return AnimatorFeature::NodeAttachment;
+        }
+        void doReserve(std::size_t capacity) override {
+            _storage.reserve(capacity);
+        }
+        void doClean(Containers::BitArrayView animationIdsToRemove) override {
+            _storage.clean(animationIdsToRemove);
+        }
+        void doAdvance(Containers::BitArrayView active, const Containers::StridedArrayView1D<const Float>& factors) override {
+            const Containers::StridedArrayView1D<const NodeHandle> nodes = this->nodes();
+            /** @todo some way to iterate set bits */
+            for(std::size_t i = 0; i != active.size(); ++i) {
+                if(!active[i])
+                    continue;
+                typename Implementation::TypedGenericAnimatorStorage<F>::Animation& animation = _storage.animations[i];
+                (*animation.animation)(nodes[i], animation.easing(factors[i]));
+            }
+        }
+
+        Implementation::TypedGenericAnimatorStorage<F> _storage;
+};
+
+/**
+@brief Generic animator with a compile-time animation function type animating data
+@m_since_latest
+
+Like @ref GenericDataAnimator, but with the function type @p F known at
+compile time, which makes the animation creation allocation-free. The @p F
+type is meant to be callable with a @ref DataHandle and a @ref Float
+interpolation factor. See @ref TypedGenericAnimator for more information.
+*/
+template<class F> class TypedGenericDataAnimator: public AbstractGenericAnimator {
+    public:
+        /**
+         * @brief Constructor
+         * @param handle    Handle returned by
+         *      @ref AbstractUserInterface::createAnimator()
+         */
+        explicit TypedGenericDataAnimator(AnimatorHandle handle): AbstractGenericAnimator{handle} {}
+
+        /**
+         * @brief Set a layer associated with this animator
+         *
+         * Expects that this function hasn't been called yet. The associated
+         * layer handle is subsequently available in @ref layer() const.
+         */
+        void setLayer(const AbstractLayer& layer) {
+            AbstractGenericAnimator::setLayer(layer);
+        }
+
+        /**
+         * @brief Create an animation
+         *
+         * Expects that @p easing is not @cpp nullptr @ce. Delegates to
+         * @ref AbstractAnimator::create(Nanoseconds, Nanoseconds, DataHandle, UnsignedInt, AnimationFlags),
+         * see its documentation and @ref GenericDataAnimator::create() for
+         * more information.
+         */
+        AnimationHandle create(F animation, Float(*easing)(Float), Nanoseconds played, Nanoseconds duration, DataHandle data, UnsignedInt repeatCount = 1, AnimationFlags flags = {}) {
+            CORRADE_ASSERT(easing,
+                "Ui::TypedGenericDataAnimator::create(): easing is null", {});
+            const AnimationHandle handle = AbstractGenericAnimator::create(played, duration, data, repeatCount, flags);
+            _storage.create(animationHandleId(handle), Utility::move(animation), easing);
+            return handle;
+        }
+
+        /**
+         * @brief Create an animation assuming the data it's attached to belongs to the layer the animator is registered with
+         *
+         * Compared to @ref create(F, Float(*)(Float), Nanoseconds, Nanoseconds, DataHandle, UnsignedInt, AnimationFlags)
+         * delegates to @ref AbstractAnimator::create(Nanoseconds, Nanoseconds, LayerDataHandle, UnsignedInt, AnimationFlags)
+         * instead.
+         */
+        AnimationHandle create(F animation, Float(*easing)(Float), Nanoseconds played, Nanoseconds duration, LayerDataHandle data, UnsignedInt repeatCount = 1, AnimationFlags flags = {}) {
+            CORRADE_ASSERT(easing,
+                "Ui::TypedGenericDataAnimator::create(): easing is null", {});
+            const AnimationHandle handle = AbstractGenericAnimator::create(played, duration, data, repeatCount, flags);
+            _storage.create(animationHandleId(handle), Utility::move(animation), easing);
+            return handle;
+        }
+
+        /**
+         * @brief Remove an animation
+         *
+         * Expects that @p handle is valid. Delegates to
+         * @ref AbstractAnimator::remove(AnimationHandle), see its
+         * documentation for more information.
+         */
+        void remove(AnimationHandle handle) {
+            AbstractGenericAnimator::remove(handle);
+            _storage.remove(animationHandleId(handle));
+        }
+
+        /**
+         * @brief Remove an animation assuming it belongs to this animator
+         *
+         * Compared to @ref remove(AnimationHandle) delegates to
+         * @ref AbstractAnimator::remove(AnimatorDataHandle) instead.
+         */
+        void remove(AnimatorDataHandle handle) {
+            AbstractGenericAnimator::remove(handle);
+            _storage.remove(animatorDataHandleId(handle));
+        }
+
+        /**
+         * @brief Animation easing function
+         *
+         * Expects that @p handle is valid. The returned pointer is never
+         * @cpp nullptr @ce.
+         */
+        auto easing(AnimationHandle handle) const -> Float(*)(Float) {
+            CORRADE_ASSERT(isHandleValid(handle),
+                "Ui::TypedGenericDataAnimator::easing(): invalid handle" << handle, {});
+            return _storage.animations[animationHandleId(handle)].easing;
+        }
+
+        /**
+         * @brief Animation easing function assuming it belongs to this animator
+         *
+         * Like @ref easing(AnimationHandle) const but without checking that
+         * @p handle indeed belongs to this animator.
+         */
+        auto easing(AnimatorDataHandle handle) const -> Float(*)(Float) {
+            CORRADE_ASSERT(isHandleValid(handle),
+                "Ui::TypedGenericDataAnimator::easing(): invalid handle" << handle, {});
+            return _storage.animations[animatorDataHandleId(handle)].easing;
+        }
+
+    private:
+        AnimatorFeatures doFeatures() const override {
+            return AnimatorFeature::DataAttachment;
+        }
+        void doReserve(std::size_t capacity) override {
+            _storage.reserve(capacity);
+        }
+        void doClean(Containers::BitArrayView animationIdsToRemove) override {
+            _storage.clean(animationIdsToRemove);
+        }
+        void doAdvance(Containers::BitArrayView active, const Containers::StridedArrayView1D<const Float>& factors) override {
+            const Containers::StridedArrayView1D<const LayerDataHandle> layerData = this->layerData();
+            const LayerHandle layer = this->layer();
+            /** @todo some way to iterate set bits */
+            for(std::size_t i = 0; i != active.size(); ++i) {
+                if(!active[i])
+                    continue;
+                typename Implementation::TypedGenericAnimatorStorage<F>::Animation& animation = _storage.animations[i];
+                /* If not associated with any data, pass a null instead of
+                   combining it with the layer handle */
+                (*animation.animation)(
+                    layerData[i] == LayerDataHandle::Null ?
+                        DataHandle::Null : dataHandle(layer, layerData[i]),
+                    animation.easing(factors[i]));
+            }
+        }
+
+        Implementation::TypedGenericAnimatorStorage<F> _storage;
+};
+
+}}
+
+#endif
@@ -58,6 +58,8 @@ class AbstractLayer;
 class AbstractLayouter;
 class AbstractRenderer;
 class AbstractUserInterface;
+enum class UserInterfacePhase: UnsignedByte;
+enum class UserInterfaceTraceScope: UnsignedByte;
 
 class AbstractVisualLayer;
 class AbstractVisualLayerStyleAnimator;
@@ -69,12 +71,18 @@ class BaseLayerStyleAnimator;
 #ifdef MAGNUM_TARGET_GL
 class BaseLayerGL;
 #endif
-enum class BaseLayerSharedFlag: UnsignedByte;
+enum class BaseLayerSharedFlag: UnsignedShort;
 typedef Containers::EnumSet<BaseLayerSharedFlag> BaseLayerSharedFlags;
 
 class EventConnection;
 class EventLayer;
 
+enum class PerformanceOverlayMode: UnsignedByte;
+class PerformanceOverlayLayer;
+#ifdef MAGNUM_TARGET_GL
+class PerformanceOverlayLayerGL;
+#endif
+
 enum class FontHandle: UnsignedShort;
 class TextLayer;
 struct TextLayerCommonStyleUniform;
@@ -88,9 +96,25 @@ class TextLayerGL;
 class TextFeatureValue;
 class TextProperties;
 
+class TextureAtlas;
+#ifdef MAGNUM_TARGET_GL
+class TextureAtlasGL;
+#endif
+
+struct MemoryUsage;
+
+class TraceRecorder;
+
+class UpdateQueue;
+
 class GenericAnimator;
 class GenericNodeAnimator;
 class GenericDataAnimator;
+template<class> class TypedGenericAnimator;
+template<class> class TypedGenericNodeAnimator;
+template<class> class TypedGenericDataAnimator;
+class NodeOffsetAnimator;
+class NodeSizeAnimator;
 
 class RendererGL;
 
@@ -115,6 +139,9 @@ class AbstractSnapLayout;
 template<class> class BasicSnapLayout;
 typedef BasicSnapLayout<UserInterface> SnapLayout;
 
+enum class StackDirection: UnsignedByte;
+class StackLayouter;
+
 enum class Pointer: UnsignedByte;
 typedef Containers::EnumSet<Pointer> Pointers;
 class PointerEvent;
@@ -130,6 +157,9 @@ class TextInputEvent;
 
 class VisibilityLostEvent;
 
+enum class InputEventType: UnsignedByte;
+class InputEvent;
+
 }}
 #endif
 
@@ -0,0 +1,202 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "UpdateQueue.h"
+
+#include <atomic>
+#include <algorithm> /* std::sort() */
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Function.h>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Utility/Move.h>
+
+#include "Magnum/Ui/Handle.h"
+
+namespace Magnum { namespace Ui {
+
+namespace {
+
+/* A slot of the ring buffer. The sequence number is what synchronizes the
+   producers with the consumer, with the scheme being the bounded queue from
+   Dmitry Vyukov: a slot at position `pos` is free for a producer if its
+   sequence is `pos`, filled and ready for the consumer if it's `pos + 1`, and
+   after consuming it's set to `pos + capacity`, i.e. free for the producer on
+   the next wraparound. */
+struct Slot {
+    std::atomic<std::size_t> sequence;
+    DataHandle data;
+    UnsignedInt property;
+    Containers::Function<void()> command;
+};
+
+/* A command taken out of the ring buffer in apply(), with its order so the
+   coalescing can find the last command for each data and property */
+struct Pending {
+    DataHandle data;
+    UnsignedInt property;
+    UnsignedInt order;
+    bool coalesced;
+    Containers::Function<void()> command;
+};
+
+}
+
+struct UpdateQueue::State {
+    explicit State(std::size_t capacity): slots{capacity} {
+        for(std::size_t i = 0; i != capacity; ++i)
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    Containers::Array<Slot> slots;
+    /* Position producers push to, shared among them */
+    std::atomic<std::size_t> pushPosition{0};
+    /* Position the consumer takes from, accessed only in apply() */
+    std::size_t applyPosition = 0;
+
+    /* Kept around to avoid allocating in every apply() */
+    Containers::Array<Pending> pending;
+    Containers::Array<UnsignedInt> sorted;
+};
+
+UpdateQueue::UpdateQueue(const UnsignedInt capacity) {
+    CORRADE_ASSERT(capacity,
+        "Ui::UpdateQueue: expected non-zero capacity", );
+    /* Round up to the next power of two to be able to use a mask for the
+       ring buffer position */
+    std::size_t roundedCapacity = 1;
+    while(roundedCapacity < capacity)
+        roundedCapacity <<= 1;
+    _state.emplace(roundedCapacity);
+}
+
+UpdateQueue::UpdateQueue(UpdateQueue&&) noexcept = default;
+
+UpdateQueue::~UpdateQueue() = default;
+
+UpdateQueue& UpdateQueue::operator=(UpdateQueue&&) noexcept = default;
+
+UnsignedInt UpdateQueue::capacity() const {
+    return _state->slots.size();
+}
+
+bool UpdateQueue::push(Containers::Function<void()>&& command) {
+    return push(DataHandle::Null, 0, Utility::move(command));
+}
+
+bool UpdateQueue::push(const DataHandle data, const UnsignedInt property, Containers::Function<void()>&& command) {
+    CORRADE_ASSERT(command,
+        "Ui::UpdateQueue::push(): command is null", {});
+
+    State& state = *_state;
+    const std::size_t mask = state.slots.size() - 1;
+    std::size_t position = state.pushPosition.load(std::memory_order_relaxed);
+    Slot* slot;
+    for(;;) {
+        slot = &state.slots[position & mask];
+        const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        const std::ptrdiff_t difference = std::ptrdiff_t(sequence) - std::ptrdiff_t(position);
+        /* The slot is free, try to claim it. If another producer was faster,
+           the position gets updated and we try again. */
+        if(difference == 0) {
+            if(state.pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                break;
+        /* The slot wasn't consumed yet since the last wraparound, the queue is
+           full */
+        } else if(difference < 0) {
+            return false;
+        /* Another producer claimed the slot already, reload the position */
+        } else position = state.pushPosition.load(std::memory_order_relaxed);
+    }
+
+    slot->data = data;
+    slot->property = property;
+    slot->command = Utility::move(command);
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+UnsignedInt UpdateQueue::apply() {
+    State& state = *_state;
+    const std::size_t mask = state.slots.size() - 1;
+
+    /* Take out everything that's ready. The command is moved out of the slot
+       so the slot can be reused by producers while the commands execute. */
+    arrayResize(state.pending, 0);
+    bool hasCoalesced = false;
+    for(;;) {
+        Slot& slot = state.slots[state.applyPosition & mask];
+        if(slot.sequence.load(std::memory_order_acquire) != state.applyPosition + 1)
+            break;
+
+        arrayAppend(state.pending, InPlaceInit, slot.data, slot.property, UnsignedInt(state.pending.size()), false, Utility::move(slot.command));
+        if(slot.data != DataHandle::Null)
+            hasCoalesced = true;
+        slot.sequence.store(state.applyPosition + mask + 1, std::memory_order_release);
+        ++state.applyPosition;
+    }
+
+    /* If there are commands with a data handle, sort them by the data,
+       property and order, and mark all but the last one for each data and
+       property as coalesced */
+    if(hasCoalesced) {
+        arrayResize(state.sorted, 0);
+        for(const Pending& pending: state.pending)
+            if(pending.data != DataHandle::Null)
+                arrayAppend(state.sorted, pending.order);
+        std::sort(state.sorted.begin(), state.sorted.end(), [&state](UnsignedInt a, UnsignedInt b) {
+            const Pending& pa = state.pending[a];
+            const Pending& pb = state.pending[b];
+            if(pa.data != pb.data)
+                return pa.data < pb.data;
+            if(pa.property != pb.property)
+                return pa.property < pb.property;
+            return pa.order < pb.order;
+        });
+        for(std::size_t i = 0; i + 1 < state.sorted.size(); ++i) {
+            const Pending& current = state.pending[state.sorted[i]];
+            const Pending& next = state.pending[state.sorted[i + 1]];
+            if(current.data == next.data && current.property == next.property)
+                state.pending[state.sorted[i]].coalesced = true;
+        }
+    }
+
+    /* Execute the rest in order. Commands executed here may push further
+       commands, they end up in the ring buffer and are executed in the next
+       call. */
+    UnsignedInt count = 0;
+    for(Pending& pending: state.pending) {
+        if(!pending.coalesced) {
+            pending.command();
+            ++count;
+        }
+        /* Release whatever the command captured right away */
+        pending.command = nullptr;
+    }
+
+    return count;
+}
+
+}}
@@ -0,0 +1,153 @@
+#ifndef Magnum_Ui_UpdateQueue_h
+#define Magnum_Ui_UpdateQueue_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+/** @file
+ * @brief Class @ref Magnum::Ui::UpdateQueue
+ * @m_since_latest
+ */
+
+#include <Corrade/Containers/Pointer.h>
+#include <Magnum/Magnum.h>
+
+#include "Magnum/Ui/Ui.h"
+#include "Magnum/Ui/visibility.h"
+
+namespace Magnum { namespace Ui {
+
+/**
+@brief Thread-safe queue of user interface updates
+@m_since_latest
+
+Accepts commands such as @ref TextLayer::setText() or
+@ref BaseLayer::setColor() calls wrapped in a function from any thread and
+executes them on the thread that calls @ref apply(). It's meant to be used for
+example by network or worker threads that produce frequent value changes which
+have to be applied on the thread owning the user interface.
+
+The queue is a fixed-capacity ring buffer, and @ref push() is lock-free and can
+be called from arbitrary many threads concurrently. The @ref apply() function
+has to be called only from a single thread at a time, and not concurrently with
+destruction of the queue. When set up with
+@ref AbstractUserInterface::setUpdateQueueInstance(), the user interface
+owns the queue and calls @ref apply() at the start of each
+@ref AbstractUserInterface::update().
+
+@section Ui-UpdateQueue-coalescing Coalescing repeated updates
+
+Commands pushed with @ref push(DataHandle, UnsignedInt, Containers::Function<void()>&&)
+are identified by a data handle and an application-defined property ID, such
+as a different value for text and for color updates. If more than one command
+with the same data handle and property is queued by the time @ref apply() is
+called, only the last pushed one is executed, so a counter that's updated
+thousands of times a second reshapes its text just once per frame. Commands
+that aren't coalesced are executed in the order they were pushed, coalesced
+commands are executed at the position of the last command with the same data
+handle and property.
+*/
+class MAGNUM_UI_EXPORT UpdateQueue {
+    public:
+        /**
+         * @brief Constructor
+         * @param capacity  Count of commands that can be queued at a time
+         *
+         * The @p capacity is rounded up to the next power of two. Expects that
+         * it's not zero.
+         */
+        explicit UpdateQueue(UnsignedInt capacity);
+
+        /** @brief Copying is not allowed */
+        UpdateQueue(const UpdateQueue&) = delete;
+
+        /**
+         * @brief Move constructor
+         *
+         * Performs a destructive move, i.e. the original object isn't usable
+         * afterwards anymore. Not thread-safe.
+         */
+        UpdateQueue(UpdateQueue&&) noexcept;
+
+        ~UpdateQueue();
+
+        /** @brief Copying is not allowed */
+        UpdateQueue& operator=(const UpdateQueue&) = delete;
+
+        /** @brief Move assignment */
+        UpdateQueue& operator=(UpdateQueue&&) noexcept;
+
+        /**
+         * @brief Capacity
+         *
+         * Count of commands that can be queued at a time. Always a power of
+         * two.
+         */
+        UnsignedInt capacity() const;
+
+        /**
+         * @brief Push a command
+         * @return Whether the command was queued
+         *
+         * Thread-safe and lock-free. The @p command is executed in the next
+         * @ref apply() call, after all commands pushed before. If the queue is
+         * full, returns @cpp false @ce and @p command is left untouched, it's
+         * then up to the caller to either drop it or retry later. Expects that
+         * @p command is not null.
+         */
+        bool push(Containers::Function<void()>&& command);
+
+        /**
+         * @brief Push a command that coalesces with commands of the same data and property
+         * @return Whether the command was queued
+         *
+         * Like @ref push(Containers::Function<void()>&&), but if any other
+         * command with the same @p data and @p property values is queued by
+         * the time @ref apply() is called, only the last pushed of them is
+         * executed. See @ref Ui-UpdateQueue-coalescing for more information.
+         * If @p data is @ref DataHandle::Null, the command isn't coalesced
+         * with anything.
+         */
+        bool push(DataHandle data, UnsignedInt property, Containers::Function<void()>&& command);
+
+        /**
+         * @brief Execute queued commands
+         * @return Count of commands that were executed
+         *
+         * Takes all commands that are queued at the time of the call,
+         * coalesces them and executes them on the calling thread. Commands
+         * pushed from within the executed commands or from other threads
+         * during this call are executed in the next call. Can be called only
+         * from a single thread at a time.
+         */
+        UnsignedInt apply();
+
+    private:
+        struct State;
+        Containers::Pointer<State> _state;
+};
+
+}}
+
+#endif
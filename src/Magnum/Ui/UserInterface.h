@@ -208,6 +208,9 @@ class MAGNUM_UI_EXPORT UserInterface: public AbstractUserInterface {
         UserInterface& draw() {
             return static_cast<UserInterface&>(AbstractUserInterface::draw());
         }
+        UserInterface& submit() {
+            return static_cast<UserInterface&>(AbstractUserInterface::submit());
+        }
         #endif
 
     #ifdef DOXYGEN_GENERATING_OUTPUT
@@ -222,6 +222,81 @@ UserInterfaceGL& UserInterfaceGL::setStyle(const AbstractStyle& style, PluginMan
     return setStyle(style, style.features(), importerManager, fontManager);
 }
 
+bool UserInterfaceGL::trySetStyle(const AbstractStyle& style, const StyleFeatures features, UserInterfaceGL& shareWith) {
+    CORRADE_ASSERT(features,
+        "Ui::UserInterfaceGL::trySetStyle(): no features specified", {});
+    CORRADE_ASSERT(features <= style.features(),
+        "Ui::UserInterfaceGL::trySetStyle():" << features << "not a subset of supported" << style.features(), {});
+    CORRADE_ASSERT(&shareWith != this,
+        "Ui::UserInterfaceGL::trySetStyle(): can't share with itself", {});
+    /* Checking the integer property to be sure we don't accidentally do a too
+       fuzzy comparison like could happen with .isZero() */
+    CORRADE_ASSERT(framebufferSize() != Vector2i{},
+        "Ui::UserInterfaceGL::trySetStyle(): user interface size wasn't set",
+        /* Has to return true with CORRADE_GRACEFUL_ASSERT so when tested
+           through setStyle() it doesn't std::exit() the whole executable */
+        true);
+
+    #ifndef CORRADE_NO_ASSERT
+    State& state = static_cast<State&>(*_state);
+    #endif
+
+    /* Create a renderer, if not already */
+    if(!hasRenderer())
+        setRendererInstance(Containers::pointer<RendererGL>());
+
+    /* Create layers referencing the shared state of the other instance. The
+       style, fonts, glyph cache and images are already in it, so these
+       features don't get applied again below. */
+    if(features >= StyleFeature::BaseLayer) {
+        CORRADE_ASSERT(!state.baseLayer,
+            "Ui::UserInterfaceGL::trySetStyle(): base layer already present", {});
+        CORRADE_ASSERT(shareWith.hasBaseLayer(),
+            "Ui::UserInterfaceGL::trySetStyle(): base layer not present in the user interface to share with", {});
+        setBaseLayerInstance(Containers::pointer<BaseLayerGL>(createLayer(), static_cast<BaseLayerGL&>(shareWith.baseLayer()).shared()));
+    }
+    if(features >= StyleFeature::TextLayer) {
+        CORRADE_ASSERT(!state.textLayer,
+            "Ui::UserInterfaceGL::trySetStyle(): text layer already present", {});
+        CORRADE_ASSERT(shareWith.hasTextLayer(),
+            "Ui::UserInterfaceGL::trySetStyle(): text layer not present in the user interface to share with", {});
+        setTextLayerInstance(Containers::pointer<TextLayerGL>(createLayer(), static_cast<TextLayerGL&>(shareWith.textLayer()).shared()));
+    }
+    if(features >= StyleFeature::TextLayerImages) {
+        CORRADE_ASSERT(state.textLayer,
+            "Ui::UserInterfaceGL::trySetStyle(): text layer not present and" << StyleFeature::TextLayer << "isn't being applied as well", {});
+    }
+    /* The event layer and snap layouter have no shared state, they're created
+       and styled the same way as in the other overload */
+    if(features >= StyleFeature::EventLayer) {
+        CORRADE_ASSERT(!state.eventLayer,
+            "Ui::UserInterfaceGL::trySetStyle(): event layer already present", {});
+        setEventLayerInstance(Containers::pointer<EventLayer>(createLayer()));
+    }
+    if(features >= StyleFeature::SnapLayouter) {
+        CORRADE_ASSERT(!state.snapLayouter,
+            "Ui::UserInterfaceGL::trySetStyle(): snap layouter already present", {});
+        setSnapLayouterInstance(Containers::pointer<SnapLayouter>(createLayouter()));
+    }
+
+    const StyleFeatures applyFeatures = features & ~(StyleFeature::BaseLayer|StyleFeature::TextLayer|StyleFeature::TextLayerImages);
+    return !applyFeatures || style.apply(*this, applyFeatures, nullptr, nullptr);
+}
+
+bool UserInterfaceGL::trySetStyle(const AbstractStyle& style, UserInterfaceGL& shareWith) {
+    return trySetStyle(style, style.features(), shareWith);
+}
+
+UserInterfaceGL& UserInterfaceGL::setStyle(const AbstractStyle& style, const StyleFeatures features, UserInterfaceGL& shareWith) {
+    if(!trySetStyle(style, features, shareWith))
+        std::exit(1); /* LCOV_EXCL_LINE */
+    return *this;
+}
+
+UserInterfaceGL& UserInterfaceGL::setStyle(const AbstractStyle& style, UserInterfaceGL& shareWith) {
+    return setStyle(style, style.features(), shareWith);
+}
+
 UserInterfaceGL& UserInterfaceGL::setBaseLayerInstance(Containers::Pointer<BaseLayerGL>&& instance) {
     return static_cast<UserInterfaceGL&>(UserInterface::setBaseLayerInstance(Utility::move(instance)));
 }
@@ -346,6 +346,71 @@ class MAGNUM_UI_EXPORT UserInterfaceGL: public UserInterface {
          */
         bool trySetStyle(const AbstractStyle& style, PluginManager::Manager<Trade::AbstractImporter>* importerManager = nullptr, PluginManager::Manager<Text::AbstractFont>* fontManager = nullptr);
 
+        /**
+         * @brief Set features from a style, sharing layer state with another user interface
+         * @param style             Style instance
+         * @param features          Style features to apply
+         * @param shareWith         User interface to share the layer state
+         *      with
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * Meant for applications with multiple windows that show the same
+         * style. Compared to @ref setStyle(const AbstractStyle&, StyleFeatures, PluginManager::Manager<Trade::AbstractImporter>*, PluginManager::Manager<Text::AbstractFont>*),
+         * if @p features contain @ref StyleFeature::BaseLayer or
+         * @ref StyleFeature::TextLayer, the layers are created with the
+         * @ref BaseLayerGL::Shared and @ref TextLayerGL::Shared instances of
+         * @p shareWith instead of new ones, thus reusing their compiled
+         * shaders, style uniform buffers, fonts and the glyph cache. The
+         * style isn't applied to them again, and neither is
+         * @ref StyleFeature::TextLayerImages, as the images are already in the
+         * shared glyph cache. A renderer, @ref StyleFeature::EventLayer and
+         * @ref StyleFeature::SnapLayouter are created and applied the same
+         * way as in the other overload. If it fails, the program exits, see
+         * @ref trySetStyle(const AbstractStyle&, StyleFeatures, UserInterfaceGL&)
+         * for an alternative.
+         *
+         * Expects that @p shareWith is a different instance that contains the
+         * layers corresponding to @p features, had @p style applied to them
+         * and outlives this instance, in addition to the expectations listed
+         * in the other overload. Both user interfaces have to be drawn with
+         * the same GL context or with contexts from the same share group.
+         * Framebuffers used by @ref BaseLayerSharedFlag::BackgroundBlur can't
+         * be shared among contexts, so with that flag only the same context
+         * is supported.
+         */
+        UserInterfaceGL& setStyle(const AbstractStyle& style, StyleFeatures features, UserInterfaceGL& shareWith);
+
+        /**
+         * @brief Set all features from a style, sharing layer state with another user interface
+         * @return Reference to self (for method chaining)
+         * @m_since_latest
+         *
+         * Equivalent to calling @ref setStyle(const AbstractStyle&, StyleFeatures, UserInterfaceGL&)
+         * with @p features set to @ref AbstractStyle::features() of @p style.
+         */
+        UserInterfaceGL& setStyle(const AbstractStyle& style, UserInterfaceGL& shareWith);
+
+        /**
+         * @brief Try to set features from a style, sharing layer state with another user interface
+         * @m_since_latest
+         *
+         * Unlike @ref setStyle(const AbstractStyle&, StyleFeatures, UserInterfaceGL&)
+         * returns @cpp false @ce if @ref AbstractStyle::apply() failed instead
+         * of exiting, @cpp true @ce otherwise.
+         */
+        bool trySetStyle(const AbstractStyle& style, StyleFeatures features, UserInterfaceGL& shareWith);
+
+        /**
+         * @brief Try to set all features from a style, sharing layer state with another user interface
+         * @m_since_latest
+         *
+         * Unlike @ref setStyle(const AbstractStyle&, UserInterfaceGL&)
+         * returns @cpp false @ce if @ref AbstractStyle::apply() failed instead
+         * of exiting, @cpp true @ce otherwise.
+         */
+        bool trySetStyle(const AbstractStyle& style, UserInterfaceGL& shareWith);
+
         /**
          * @brief Set a base layer instance
          * @return Reference to self (for method chaining)
@@ -394,6 +459,9 @@ class MAGNUM_UI_EXPORT UserInterfaceGL: public UserInterface {
         UserInterfaceGL& draw() {
             return static_cast<UserInterfaceGL&>(UserInterface::draw());
         }
+        UserInterfaceGL& submit() {
+            return static_cast<UserInterfaceGL&>(UserInterface::submit());
+        }
         #endif
 
     private:
@@ -0,0 +1,232 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "VirtualList.h"
+
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Vector2.h>
+
+#include "Magnum/Ui/Anchor.h"
+#include "Magnum/Ui/Handle.h"
+#include "Magnum/Ui/NodeFlags.h"
+#include "Magnum/Ui/Style.h"
+#include "Magnum/Ui/Style.hpp"
+#include "Magnum/Ui/TextLayer.h"
+#include "Magnum/Ui/TextProperties.h"
+#include "Magnum/Ui/UserInterface.h"
+
+namespace Magnum { namespace Ui {
+
+namespace {
+
+struct Slot {
+    NodeHandle node;
+    LayerDataHandle text;
+    /* Row the slot currently shows, ~UnsignedInt{} if none */
+    UnsignedInt row;
+};
+
+}
+
+struct VirtualList::State {
+    Containers::StringView(*rowText)(UnsignedInt, void*);
+    void* userData;
+    Float rowHeight;
+    UnsignedInt rowCount;
+    UnsignedInt margin = 1;
+    Float scrollOffset = 0.0f;
+    /* Parent of all row nodes, offset by the negative scroll offset */
+    NodeHandle content;
+    /* Row `i` is always shown by slot `i % slots.size()`, i.e. when
+       scrolling, only slots of rows that went out of view get reused */
+    Containers::Array<Slot> slots;
+    UnsignedInt firstRow = 0;
+};
+
+VirtualList::VirtualList(const Anchor& anchor, const Float rowHeight, const UnsignedInt rowCount, Containers::StringView(*const rowText)(UnsignedInt, void*), void* const userData): Widget{anchor}, _state{InPlaceInit} {
+    CORRADE_ASSERT(rowHeight > 0.0f,
+        "Ui::VirtualList: expected positive row height but got" << rowHeight, );
+    CORRADE_ASSERT(rowText,
+        "Ui::VirtualList: row text function expected to be non-null", );
+    State& state = *_state;
+    state.rowText = rowText;
+    state.userData = userData;
+    state.rowHeight = rowHeight;
+    state.rowCount = rowCount;
+
+    UserInterface& ui = this->ui();
+    ui.addNodeFlags(node(), NodeFlag::Clip);
+    state.content = ui.createNode(node(), {}, {ui.nodeSize(node()).x(), rowCount*rowHeight});
+
+    materialize(true);
+}
+
+VirtualList::VirtualList(NoCreateT, UserInterface& ui): Widget{NoCreate, ui} {}
+
+VirtualList::VirtualList(VirtualList&&) noexcept = default;
+
+VirtualList::~VirtualList() = default;
+
+VirtualList& VirtualList::operator=(VirtualList&&) noexcept = default;
+
+Float VirtualList::rowHeight() const { return _state->rowHeight; }
+
+UnsignedInt VirtualList::rowCount() const { return _state->rowCount; }
+
+VirtualList& VirtualList::setRowCount(const UnsignedInt count) {
+    State& state = *_state;
+    state.rowCount = count;
+    UserInterface& ui = this->ui();
+    ui.setNodeSize(state.content, {ui.nodeSize(node()).x(), count*state.rowHeight});
+    materialize(false);
+    return *this;
+}
+
+UnsignedInt VirtualList::margin() const { return _state->margin; }
+
+VirtualList& VirtualList::setMargin(const UnsignedInt margin) {
+    _state->margin = margin;
+    materialize(false);
+    return *this;
+}
+
+Float VirtualList::scrollOffset() const { return _state->scrollOffset; }
+
+VirtualList& VirtualList::setScrollOffset(const Float offset) {
+    _state->scrollOffset = offset;
+    materialize(false);
+    return *this;
+}
+
+UnsignedInt VirtualList::firstMaterializedRow() const { return _state->firstRow; }
+
+UnsignedInt VirtualList::materializedRowCount() const { return _state->slots.size(); }
+
+NodeHandle VirtualList::rowNode(const UnsignedInt row) const {
+    const State& state = *_state;
+    CORRADE_ASSERT(row < state.rowCount,
+        "Ui::VirtualList::rowNode(): index" << row << "out of range for" << state.rowCount << "rows", {});
+    if(row < state.firstRow || row >= state.firstRow + state.slots.size())
+        return NodeHandle::Null;
+    return state.slots[row % state.slots.size()].node;
+}
+
+DataHandle VirtualList::rowData(const UnsignedInt row) const {
+    const State& state = *_state;
+    CORRADE_ASSERT(row < state.rowCount,
+        "Ui::VirtualList::rowData(): index" << row << "out of range for" << state.rowCount << "rows", {});
+    if(row < state.firstRow || row >= state.firstRow + state.slots.size())
+        return DataHandle::Null;
+    /* The data is implicitly from the text layer */
+    return dataHandle(ui().textLayer().handle(), state.slots[row % state.slots.size()].text);
+}
+
+VirtualList& VirtualList::refreshRow(const UnsignedInt row) {
+    const State& state = *_state;
+    CORRADE_ASSERT(row < state.rowCount,
+        "Ui::VirtualList::refreshRow(): index" << row << "out of range for" << state.rowCount << "rows", *this);
+    if(row >= state.firstRow && row < state.firstRow + state.slots.size())
+        updateRowText(row % state.slots.size(), row);
+    return *this;
+}
+
+VirtualList& VirtualList::refresh() {
+    State& state = *_state;
+    UserInterface& ui = this->ui();
+    const Float width = ui.nodeSize(node()).x();
+    ui.setNodeSize(state.content, {width, state.rowCount*state.rowHeight});
+    for(const Slot& slot: state.slots)
+        ui.setNodeSize(slot.node, {width, state.rowHeight});
+    materialize(true);
+    return *this;
+}
+
+void VirtualList::updateRowText(const UnsignedInt slot, const UnsignedInt row) {
+    State& state = *_state;
+    TextLayer& textLayer = ui().textLayer();
+    const Containers::StringView text = state.rowText(row, state.userData);
+
+    /* Unlike Label, the data is kept even for an empty text so it doesn't
+       need to be recreated once the slot is reused for a non-empty row */
+    Slot& s = state.slots[slot];
+    if(s.text == LayerDataHandle::Null)
+        /** @todo make the style configurable */
+        s.text = dataHandleData(textLayer.create(Implementation::TextStyle::LabelDefaultText, text, {}, s.node));
+    else
+        textLayer.setText(s.text, text, {});
+    s.row = row;
+}
+
+void VirtualList::materialize(const bool refreshAll) {
+    State& state = *_state;
+    UserInterface& ui = this->ui();
+    const Vector2 size = ui.nodeSize(node());
+
+    /* Clamp the scroll offset to the list height */
+    state.scrollOffset = Math::clamp(state.scrollOffset, 0.0f, Math::max(0.0f, state.rowCount*state.rowHeight - size.y()));
+    ui.setNodeOffset(state.content, {0.0f, -state.scrollOffset});
+
+    /* Rows intersecting the widget area, +1 for a row that's partially
+       visible at both ends when scrolled, plus the margin on each side */
+    const UnsignedInt slotCount = Math::min(UnsignedInt(Math::ceil(size.y()/state.rowHeight)) + 1 + 2*state.margin, state.rowCount);
+
+    /* If the slot count changed, the row to slot mapping changes for all
+       rows, so everything has to be rebound. Create new slots or remove the
+       extra ones, the text data attached to removed nodes gets removed
+       along with them. */
+    bool rebindAll = refreshAll;
+    if(slotCount != state.slots.size()) {
+        for(std::size_t i = slotCount; i < state.slots.size(); ++i)
+            ui.removeNode(state.slots[i].node);
+        if(slotCount < state.slots.size())
+            arrayRemoveSuffix(state.slots, state.slots.size() - slotCount);
+        else for(std::size_t i = state.slots.size(); i != slotCount; ++i)
+            arrayAppend(state.slots, Slot{
+                ui.createNode(state.content, {}, {size.x(), state.rowHeight}),
+                LayerDataHandle::Null,
+                ~UnsignedInt{}});
+        rebindAll = true;
+    }
+
+    /* First materialized row, with the margin above, but not so far down
+       that there wouldn't be enough rows to fill all slots */
+    const UnsignedInt firstVisibleRow = UnsignedInt(state.scrollOffset/state.rowHeight);
+    state.firstRow = Math::min(firstVisibleRow > state.margin ? firstVisibleRow - state.margin : 0, state.rowCount - slotCount);
+
+    /* Rebind only slots that show a different row now */
+    for(UnsignedInt row = state.firstRow, rowEnd = state.firstRow + slotCount; row != rowEnd; ++row) {
+        const UnsignedInt slot = row % slotCount;
+        if(!rebindAll && state.slots[slot].row == row)
+            continue;
+        ui.setNodeOffset(state.slots[slot].node, {0.0f, row*state.rowHeight});
+        updateRowText(slot, row);
+    }
+}
+
+}}
@@ -0,0 +1,200 @@
+#ifndef Magnum_Ui_VirtualList_h
+#define Magnum_Ui_VirtualList_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+/** @file
+ * @brief Class @ref Magnum::Ui::VirtualList
+ * @m_since_latest
+ */
+
+#include <Corrade/Containers/Pointer.h>
+
+#include "Magnum/Ui/Widget.h"
+
+namespace Magnum { namespace Ui {
+
+/**
+@brief Virtualized list widget
+@m_since_latest
+
+A vertical list of text rows of a fixed height, meant for logs, tables and
+other cases where there's too many rows to have a node and a
+@ref TextLayer data for each. Only the rows that are visible in the widget
+area plus @ref margin() rows above and below are materialized, and as the
+list scrolls, nodes and text data of rows that went out of view are reused
+for rows that came into view. Text of a row gets fetched from the callback
+passed to the constructor and shaped only when the row gets materialized or
+when explicitly refreshed with @ref refreshRow() or @ref refresh(),
+scrolling by less than the @ref margin() doesn't reshape any text at all.
+
+The widget node has @ref NodeFlag::Clip set, the rows are placed in a
+content node whose offset is the negative @ref scrollOffset(), which means
+scrolling is just a single node offset change and rows outside of the
+widget area get culled by the user interface.
+@see @ref Label
+*/
+class MAGNUM_UI_EXPORT VirtualList: public Widget {
+    public:
+        /**
+         * @brief Constructor
+         * @param anchor        Positioning anchor
+         * @param rowHeight     Row height. Expected to be positive.
+         * @param rowCount      Row count
+         * @param rowText       Function returning text for given row
+         * @param userData      User data passed to @p rowText
+         *
+         * The returned string view is only used during the call, it doesn't
+         * need to stay in scope afterwards. Visible rows get materialized
+         * right away, with @ref scrollOffset() being @cpp 0.0f @ce. The
+         * widget area is taken from the @p anchor node size, if it changes
+         * later, call @ref refresh() to update the row set.
+         */
+        explicit VirtualList(const Anchor& anchor, Float rowHeight, UnsignedInt rowCount, Containers::StringView(*rowText)(UnsignedInt row, void* userData), void* userData = nullptr);
+
+        /**
+         * @brief Construct with no underlying node
+         *
+         * The instance is equivalent to a moved-out state, i.e. not usable
+         * for anything.
+         */
+        explicit VirtualList(NoCreateT, UserInterface& ui);
+
+        /** @brief Move constructor */
+        VirtualList(VirtualList&&) noexcept;
+
+        ~VirtualList();
+
+        /** @brief Move assignment */
+        VirtualList& operator=(VirtualList&&) noexcept;
+
+        /** @brief Row height */
+        Float rowHeight() const;
+
+        /** @brief Row count */
+        UnsignedInt rowCount() const;
+
+        /**
+         * @brief Set row count
+         * @return Reference to self (for method chaining)
+         *
+         * Clamps @ref scrollOffset() to the new list height. Rows that stay
+         * materialized aren't reshaped, call @ref refreshRow() or
+         * @ref refresh() if their contents changed as well.
+         */
+        VirtualList& setRowCount(UnsignedInt count);
+
+        /** @brief Count of rows materialized above and below the visible area */
+        UnsignedInt margin() const;
+
+        /**
+         * @brief Set count of rows materialized above and below the visible area
+         * @return Reference to self (for method chaining)
+         *
+         * A higher margin means more nodes and text data are kept around,
+         * but scrolling within the margin doesn't need to reshape any text.
+         * Initially the margin is @cpp 1 @ce. Changing the margin causes all
+         * materialized rows to be reshaped.
+         */
+        VirtualList& setMargin(UnsignedInt margin);
+
+        /** @brief Scroll offset */
+        Float scrollOffset() const;
+
+        /**
+         * @brief Set scroll offset
+         * @return Reference to self (for method chaining)
+         *
+         * The @p offset is clamped to a range between @cpp 0.0f @ce and
+         * total height of all rows minus the widget area height. Only rows
+         * that newly came into view are reshaped, their nodes and text data
+         * get recycled from rows that went out of view.
+         */
+        VirtualList& setScrollOffset(Float offset);
+
+        /** @brief First materialized row */
+        UnsignedInt firstMaterializedRow() const;
+
+        /**
+         * @brief Count of materialized rows
+         *
+         * Count of rows visible in the widget area plus the @ref margin()
+         * above and below, at most @ref rowCount().
+         */
+        UnsignedInt materializedRowCount() const;
+
+        /**
+         * @brief Node of given row
+         *
+         * Expects that @p row is less than @ref rowCount(). Returns
+         * @ref NodeHandle::Null if the row isn't materialized. Note that the
+         * same node may get used for a different row when the list scrolls.
+         */
+        NodeHandle rowNode(UnsignedInt row) const;
+
+        /**
+         * @brief Text data of given row
+         *
+         * Expects that @p row is less than @ref rowCount(). Returns
+         * @ref DataHandle::Null if the row isn't materialized. Note that the
+         * same data may get used for a different row when the list scrolls.
+         */
+        DataHandle rowData(UnsignedInt row) const;
+
+        /**
+         * @brief Refresh text of given row
+         * @return Reference to self (for method chaining)
+         *
+         * Expects that @p row is less than @ref rowCount(). If the row is
+         * materialized, its text is fetched again and reshaped, otherwise
+         * the function does nothing as the text will be fetched once the row
+         * gets materialized.
+         */
+        VirtualList& refreshRow(UnsignedInt row);
+
+        /**
+         * @brief Refresh all rows
+         * @return Reference to self (for method chaining)
+         *
+         * Takes the current widget node size into account, materializing
+         * more rows or removing extra ones if it changed, and fetches and
+         * reshapes text of all materialized rows.
+         */
+        VirtualList& refresh();
+
+        #ifndef DOXYGEN_GENERATING_OUTPUT
+        _MAGNUM_UI_WIDGET_SUBCLASS_IMPLEMENTATION(VirtualList) /* LCOV_EXCL_LINE */
+        #endif
+
+    private:
+        MAGNUM_UI_LOCAL void updateRowText(UnsignedInt slot, UnsignedInt row);
+        MAGNUM_UI_LOCAL void materialize(bool refreshAll);
+
+        struct State;
+        Containers::Pointer<State> _state;
+};
+
+}}
+
+#endif
@@ -25,3 +25,5 @@
 */
 
 #cmakedefine MAGNUM_UI_BUILD_STATIC
+#cmakedefine MAGNUM_UI_LARGE_HANDLES
+#cmakedefine MAGNUM_UI_TRACING
@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+
+#
+#   This file is part of Magnum.
+#
+#   Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+#               2020, 2021, 2022, 2023, 2024
+#             Vladimír Vondruš <mosra@centrum.cz>
+#
+#   Permission is hereby granted, free of charge, to any person obtaining a
+#   copy of this software and associated documentation files (the "Software"),
+#   to deal in the Software without restriction, including without limitation
+#   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+#   and/or sell copies of the Software, and to permit persons to whom the
+#   Software is furnished to do so, subject to the following conditions:
+#
+#   The above copyright notice and this permission notice shall be included
+#   in all copies or substantial portions of the Software.
+#
+#   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+#   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+#   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+#   DEALINGS IN THE SOFTWARE.
+#
+
+# Converts icons.png to icons.bin, which is embedded in the MagnumUi resources
+# and copied to the glyph cache in McssDarkStyle::apply(). The output is raw
+# R8Unorm pixels, bottom row first. Run after editing icons.png:
+#
+#   ./icons.py [icons.png] [icons.bin]
+#
+# Only 8-bit grayscale non-interlaced PNGs are supported, which is what
+# icons.png is saved as. Depends on nothing except the Python standard library
+# so it can be run anywhere without installing an image library.
+
+import struct
+import sys
+import zlib
+
+def decode_grayscale_png(data):
+    assert data[:8] == b'\x89PNG\r\n\x1a\n', "not a PNG file"
+
+    offset = 8
+    idat = b''
+    while offset < len(data):
+        length, type = struct.unpack('>I4s', data[offset:offset + 8])
+        chunk = data[offset + 8:offset + 8 + length]
+        offset += 12 + length
+        if type == b'IHDR':
+            width, height, depth, color, _, _, interlace = struct.unpack('>IIBBBBB', chunk)
+            assert depth == 8 and color == 0 and interlace == 0, "expected an 8-bit grayscale non-interlaced PNG"
+        elif type == b'IDAT':
+            idat += chunk
+        elif type == b'IEND':
+            break
+
+    # Undo the per-row filters, with one byte per pixel the previous pixel is
+    # the previous byte
+    raw = zlib.decompress(idat)
+    rows = []
+    previous = bytearray(width)
+    for y in range(height):
+        filter = raw[y*(width + 1)]
+        row = bytearray(raw[y*(width + 1) + 1:(y + 1)*(width + 1)])
+        for x in range(width):
+            a = row[x - 1] if x else 0
+            b = previous[x]
+            c = previous[x - 1] if x else 0
+            if filter == 1:
+                row[x] = (row[x] + a) & 0xff
+            elif filter == 2:
+                row[x] = (row[x] + b) & 0xff
+            elif filter == 3:
+                row[x] = (row[x] + (a + b)//2) & 0xff
+            elif filter == 4:
+                p = a + b - c
+                pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+                predictor = a if pa <= pb and pa <= pc else (b if pb <= pc else c)
+                row[x] = (row[x] + predictor) & 0xff
+            else:
+                assert filter == 0, "invalid PNG filter"
+        rows += [row]
+        previous = row
+
+    return rows
+
+if __name__ == '__main__':
+    input = sys.argv[1] if len(sys.argv) > 1 else 'icons.png'
+    output = sys.argv[2] if len(sys.argv) > 2 else 'icons.bin'
+
+    with open(input, 'rb') as f:
+        rows = decode_grayscale_png(f.read())
+
+    # PNG rows are top to bottom, Magnum images are bottom to top
+    with open(output, 'wb') as f:
+        f.write(b''.join(reversed(rows)))
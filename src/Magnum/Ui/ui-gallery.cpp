@@ -44,6 +44,7 @@
 #include "Magnum/Ui/Input.h"
 #include "Magnum/Ui/Label.h"
 #include "Magnum/Ui/NodeFlags.h"
+#include "Magnum/Ui/PerformanceOverlayLayerGL.h"
 #include "Magnum/Ui/SnapLayouter.h"
 #include "Magnum/Ui/Style.h"
 #include "Magnum/Ui/TextLayer.h" /** @todo remove once Input has cursor APIs */
@@ -89,6 +90,11 @@ Arguments:
 -   `--no-vsync` --- disable VSync for frame profiling
 -   `--magnum-...` --- engine-specific options (see
     @ref GL-Context-usage-command-line for details)
+
+Pressing @m_class{m-label m-default} **F3** shows a
+@ref Ui::PerformanceOverlayLayerGL and cycles through the
+@ref Ui::PerformanceOverlayMode values, hiding the overlay again after the
+last one.
 */
 
 namespace {
@@ -110,7 +116,13 @@ class UiGallery: public Platform::Application {
         void keyReleaseEvent(KeyEvent& event) override;
         void textInputEvent(TextInputEvent& event) override;
 
+        void cyclePerformanceOverlay();
+
         Ui::UserInterfaceGL _ui{NoCreate};
+        /* Created on first use to not gather node update statistics
+           unless needed */
+        Ui::PerformanceOverlayLayerGL* _performanceOverlay{};
+        Ui::NodeHandle _performanceOverlayNode = Ui::NodeHandle::Null;
 
         DebugTools::FrameProfilerGL _profiler;
 };
@@ -308,6 +320,28 @@ void UiGallery::viewportEvent(ViewportEvent& event) {
     GL::defaultFramebuffer.setViewport({{}, event.framebufferSize()});
 
     _ui.setSize(Vector2{windowSize()}/dpiScaling(), Vector2{windowSize()}, framebufferSize());
+    if(_performanceOverlay)
+        _ui.setNodeSize(_performanceOverlayNode, _ui.size());
+}
+
+void UiGallery::cyclePerformanceOverlay() {
+    /* The overlay is created last so it's drawn on top of everything, with
+       the node being frontmost as well */
+    if(!_performanceOverlay) {
+        _performanceOverlay = &_ui.setLayerInstance(Containers::pointer<Ui::PerformanceOverlayLayerGL>(_ui.createLayer(), _ui));
+        _performanceOverlayNode = _ui.createNode({}, _ui.size(), Ui::NodeFlag::NoEvents);
+        _performanceOverlay->create(_performanceOverlayNode);
+    } else if(_ui.nodeFlags(_performanceOverlayNode) >= Ui::NodeFlag::Hidden) {
+        _ui.clearNodeFlags(_performanceOverlayNode, Ui::NodeFlag::Hidden);
+        _performanceOverlay->setMode(Ui::PerformanceOverlayMode::DataUpdates);
+    } else if(_performanceOverlay->mode() == Ui::PerformanceOverlayMode::Overdraw) {
+        _ui.addNodeFlags(_performanceOverlayNode, Ui::NodeFlag::Hidden);
+        return;
+    } else {
+        _performanceOverlay->setMode(Ui::PerformanceOverlayMode(UnsignedByte(_performanceOverlay->mode()) + 1));
+    }
+
+    Debug{} << "Showing" << _performanceOverlay->mode();
 }
 
 void UiGallery::drawEvent() {
@@ -344,6 +378,13 @@ void UiGallery::pointerMoveEvent(PointerMoveEvent& event) {
 }
 
 void UiGallery::keyPressEvent(KeyEvent& event) {
+    if(event.key() == Key::F3 && !event.modifiers()) {
+        cyclePerformanceOverlay();
+        event.setAccepted();
+        redraw();
+        return;
+    }
+
     _ui.keyPressEvent(event);
 
     if(_ui.state()) redraw();
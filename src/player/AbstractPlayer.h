@@ -26,6 +26,7 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <Corrade/Containers/EnumSet.h>
 #include <Magnum/DebugTools/FrameProfiler.h>
 #ifdef CORRADE_TARGET_EMSCRIPTEN
 #include <Magnum/Platform/EmscriptenApplication.h>
@@ -48,10 +49,55 @@ class AbstractPlayer: public Platform::Screen {
         friend Player;
 
         virtual void load(Containers::StringView filename, Trade::AbstractImporter& importer, Int id) = 0;
+
+        /* Called when the file changed in the --watch mode. Expected to keep
+           the view state and reuse what didn't change, does a full load() by
+           default. */
+        virtual void reload(Containers::StringView filename, Trade::AbstractImporter& importer, Int id) {
+            load(filename, importer, id);
+        }
+
+        /* Called before the importer passed to the last load() or reload()
+           gets destroyed. Expected to drop all references to it. Does nothing
+           by default. */
+        virtual void releaseImporter() {}
+
+        /* Called before drawing each frame in the --benchmark mode. Expected
+           to animate the contents in some deterministic way, such as moving
+           the camera along a path. Does nothing by default. */
+        virtual void benchmarkFrame(UnsignedInt, UnsignedInt) {}
 };
 
+enum class ScenePlayerFlag: UnsignedShort {
+    /* Compress textures on upload, see loadImage() */
+    CompressTextures = 1 << 0,
+    /* Use a MeshCache for processed meshes */
+    MeshCache = 1 << 1,
+    /* Generate simplified levels of detail for heavy meshes */
+    GenerateLods = 1 << 2,
+    /* Reorder mesh indices and vertices for vertex cache and fetch
+       efficiency */
+    OptimizeMeshes = 1 << 3,
+    /* Pack normals, tangents, texture coordinates and positions into smaller
+       vertex formats */
+    QuantizeMeshes = 1 << 4,
+    /* Shade each mesh only with lights whose range reaches its bounds */
+    LightCulling = 1 << 5,
+    /* Hash textures on load so unchanged ones can be reused on reload */
+    IncrementalReload = 1 << 6,
+    /* Sample animation tracks at fixed intervals for constant-time seeking */
+    BakeAnimations = 1 << 7,
+    /* Show the scene with placeholder textures first and decode the images
+       over the following frames, keeping the importer alive until then */
+    StreamTextures = 1 << 8
+};
+
+typedef Containers::EnumSet<ScenePlayerFlag> ScenePlayerFlags;
+
+CORRADE_ENUMSET_OPERATORS(ScenePlayerFlags)
+
 /* Extreme PIMPL. */
-Containers::Pointer<AbstractPlayer> createScenePlayer(Platform::ScreenedApplication& application, Ui::UserInterface& ui, Ui::NodeHandle controls, const DebugTools::FrameProfilerGL::Values profilerValues);
+Containers::Pointer<AbstractPlayer> createScenePlayer(Platform::ScreenedApplication& application, Ui::UserInterface& ui, Ui::NodeHandle controls, const DebugTools::FrameProfilerGL::Values profilerValues, ScenePlayerFlags flags = {});
 Containers::Pointer<AbstractPlayer> createImagePlayer(Platform::ScreenedApplication& application, Ui::UserInterface& ui, Ui::NodeHandle controls);
 
 }}
@@ -24,14 +24,21 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <chrono>
 #include <sstream>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Containers/StringStl.h> /** @todo drop once Debug is stream-free */
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/Format.h>
 #include <Corrade/Utility/FormatStl.h> /** @todo drop once Debug is stream-free */
 #include <Corrade/Utility/Path.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Math/Matrix3.h>
+#include <Magnum/Math/Range.h>
 #include <Magnum/GL/DefaultFramebuffer.h>
 #include <Magnum/GL/Mesh.h>
 #include <Magnum/GL/Renderer.h>
@@ -52,6 +59,9 @@
 
 #include "AbstractPlayer.h"
 #include "LoadImage.h"
+#ifndef MAGNUM_TARGET_GLES
+#include "ImageStatistics.h"
+#endif
 
 namespace Magnum { namespace Player {
 
@@ -60,6 +70,16 @@ namespace {
 constexpr const Float LabelHeight{36.0f};
 constexpr const Vector2 LabelSize{72.0f, LabelHeight};
 
+/* Images larger than this (or than the GL texture size limit) are drawn in
+   tiles, streamed in from successively halved levels depending on the zoom.
+   At most MaxTileUploadsPerFrame tiles get uploaded per frame, the rest in
+   subsequent frames, and at most TileCacheSize tiles are resident on the GPU,
+   which is enough to cover a 4K framebuffer. */
+constexpr const Int MaxUntiledSize = 8192;
+constexpr const Int TileSize = 1024;
+constexpr const UnsignedInt TileCacheSize = 96;
+constexpr const UnsignedInt MaxTileUploadsPerFrame = 4;
+
 class ImagePlayer: public AbstractPlayer {
     public:
         explicit ImagePlayer(Platform::ScreenedApplication& application, Ui::UserInterface& ui, Ui::NodeHandle controls);
@@ -76,6 +96,9 @@ class ImagePlayer: public AbstractPlayer {
         Vector2 unproject(const Vector2& windowPosition) const;
         Vector2 unprojectRelative(const Vector2& relativeWindowPosition) const;
 
+        void drawTiles();
+        void uploadTile(UnsignedInt slot, UnsignedInt level, const Vector2i& tile);
+
         Shaders::FlatGL2D _coloredShader;
 
         /* UI */
@@ -89,12 +112,32 @@ class ImagePlayer: public AbstractPlayer {
         Ui::Label _imageInfo;
 
         GL::Texture2D _texture{NoCreate};
+        ImageUploadBuffers _imageUploadBuffers;
+        #ifndef MAGNUM_TARGET_GLES
+        /* Calculated from _texture, NullOpt if it failed to upload */
+        Containers::Optional<ImageStatistics> _statistics;
+        #endif
         GL::Mesh _square;
         Shaders::FlatGL2D _shader{Shaders::FlatGL2D::Configuration{}
             .setFlags(Shaders::FlatGL2D::Flag::Textured)};
         Vector2i _imageSize;
         Matrix3 _transformation;
         Matrix3 _projection;
+
+        /* Tiled mode. The full image and its successively halved levels are
+           kept on the CPU, down to a level that fits into a single tile, which
+           is then in _texture and drawn underneath while the tiles of the
+           level matching current zoom are being streamed in. Empty if the
+           image is small enough to be drawn directly from _texture. */
+        struct Tile {
+            GL::Texture2D texture{NoCreate};
+            /* Level and X / Y tile index, -1 if the slot is unused */
+            Vector3i id{-1};
+            UnsignedLong lastUsedFrame{};
+        };
+        Containers::Array<Trade::ImageData2D> _levels;
+        Containers::Array<Tile> _tiles{TileCacheSize};
+        UnsignedLong _frame{};
 };
 
 ImagePlayer::ImagePlayer(Platform::ScreenedApplication& application, Ui::UserInterface& ui, Ui::NodeHandle controls):
@@ -113,9 +156,6 @@ void ImagePlayer::drawEvent() {
     #endif
     GL::defaultFramebuffer.clear(GL::FramebufferClear::Color|GL::FramebufferClear::Depth);
 
-    _shader.bindTexture(_texture)
-        .setTransformationProjectionMatrix(_projection*_transformation);
-
     /* Enable blending, disable depth test */
     GL::Renderer::enable(GL::Renderer::Feature::Blending);
     GL::Renderer::disable(GL::Renderer::Feature::DepthTest);
@@ -123,12 +163,118 @@ void ImagePlayer::drawEvent() {
     /* Draw the image with non-premultiplied alpha blending as that's the
        common format */
     GL::Renderer::setBlendFunction(GL::Renderer::BlendFunction::SourceAlpha, GL::Renderer::BlendFunction::OneMinusSourceAlpha);
-    _shader.draw(_square);
+    if(_levels.isEmpty()) {
+        _shader.bindTexture(_texture)
+            .setTransformationProjectionMatrix(_projection*_transformation)
+            .draw(_square);
+    } else drawTiles();
 
     GL::Renderer::enable(GL::Renderer::Feature::DepthTest);
     GL::Renderer::disable(GL::Renderer::Feature::Blending);
 }
 
+void ImagePlayer::drawTiles() {
+    ++_frame;
+    const Matrix3 transformationProjection = _projection*_transformation;
+
+    /* Pick the coarsest level that still has at least one pixel per
+       framebuffer pixel. The transformation is scaling the [-1, 1] square to
+       half the image size in framebuffer pixels. */
+    const Float pixelScale = 2.0f*_transformation.scaling().x()/Float(_imageSize.x());
+    UnsignedInt level = 0;
+    while(level + 1 < _levels.size() && pixelScale*Float(1 << (level + 1)) <= 1.0f)
+        ++level;
+
+    /* Find tiles of given level that are visible in the view, ensure they're
+       resident. The last level is what's in _texture, which is drawn
+       directly. */
+    Containers::Array<Containers::Pair<UnsignedInt, Range2D>> draws;
+    bool incomplete = level + 1 == _levels.size();
+    if(!incomplete) {
+        const Vector2i levelSize = _levels[level].size();
+        const Vector2i tileCount = (levelSize + Vector2i{TileSize - 1})/TileSize;
+        const Matrix3 inverted = transformationProjection.inverted();
+        const Vector2 viewMin = (inverted.transformPoint({-1.0f, -1.0f}) + Vector2{1.0f})*0.5f*Vector2{levelSize};
+        const Vector2 viewMax = (inverted.transformPoint({ 1.0f,  1.0f}) + Vector2{1.0f})*0.5f*Vector2{levelSize};
+        const Vector2i tileMin = Math::clamp(Vector2i{Math::floor(viewMin/Float(TileSize))}, Vector2i{0}, tileCount);
+        const Vector2i tileMax = Math::clamp(Vector2i{Math::ceil(viewMax/Float(TileSize))}, Vector2i{0}, tileCount);
+
+        UnsignedInt uploadCount = 0;
+        for(Int y = tileMin.y(); y < tileMax.y(); ++y) for(Int x = tileMin.x(); x < tileMax.x(); ++x) {
+            /* Find the tile in the cache, and also the least recently used
+               slot that isn't needed in this frame to replace if it's not
+               there */
+            const Vector3i id{Int(level), x, y};
+            Int slot = -1;
+            Int leastRecentlyUsed = -1;
+            for(UnsignedInt i = 0; i != _tiles.size(); ++i) {
+                if(_tiles[i].id == id) {
+                    slot = i;
+                    break;
+                }
+                if(_tiles[i].lastUsedFrame != _frame && (leastRecentlyUsed == -1 || _tiles[i].lastUsedFrame < _tiles[leastRecentlyUsed].lastUsedFrame))
+                    leastRecentlyUsed = i;
+            }
+
+            if(slot == -1) {
+                if(uploadCount == MaxTileUploadsPerFrame || leastRecentlyUsed == -1) {
+                    incomplete = true;
+                    continue;
+                }
+
+                slot = leastRecentlyUsed;
+                uploadTile(slot, level, {x, y});
+                ++uploadCount;
+            }
+
+            _tiles[slot].lastUsedFrame = _frame;
+            arrayAppend(draws, InPlaceInit, UnsignedInt(slot), Range2D{
+                Vector2{id.yz()*TileSize}/Vector2{levelSize}*2.0f - Vector2{1.0f},
+                Vector2{Math::min((id.yz() + Vector2i{1})*TileSize, levelSize)}/Vector2{levelSize}*2.0f - Vector2{1.0f}
+            });
+        }
+    }
+
+    /* If some visible tiles aren't resident yet, draw the coarsest level
+       underneath and schedule a redraw to stream in the rest */
+    if(incomplete) {
+        _shader.bindTexture(_texture)
+            .setTransformationProjectionMatrix(transformationProjection)
+            .draw(_square);
+        if(level + 1 != _levels.size())
+            redraw();
+    }
+
+    for(const Containers::Pair<UnsignedInt, Range2D>& draw: draws) {
+        _shader.bindTexture(_tiles[draw.first()].texture)
+            .setTransformationProjectionMatrix(transformationProjection*
+                Matrix3::translation(draw.second().center())*
+                Matrix3::scaling(draw.second().size()*0.5f))
+            .draw(_square);
+    }
+}
+
+void ImagePlayer::uploadTile(const UnsignedInt slot, const UnsignedInt level, const Vector2i& tile) {
+    const Trade::ImageData2D& image = _levels[level];
+    const Vector2i offset = tile*TileSize;
+    const Vector2i size = Math::min(offset + Vector2i{TileSize}, image.size()) - offset;
+
+    Trade::ImageData2D tileImage{PixelStorage{}.setAlignment(1), image.format(), size, Containers::Array<char>{NoInit, std::size_t(size.product())*image.pixelSize()}};
+    Utility::copy(image.pixels().sliceSize(
+        {std::size_t(offset.y()), std::size_t(offset.x()), 0},
+        {std::size_t(size.y()), std::size_t(size.x()), image.pixelSize()}),
+        tileImage.mutablePixels());
+
+    Tile& out = _tiles[slot];
+    out.texture = GL::Texture2D{};
+    out.texture
+        .setMagnificationFilter(GL::SamplerFilter::Nearest)
+        .setMinificationFilter(GL::SamplerFilter::Linear)
+        .setWrapping(GL::SamplerWrapping::ClampToEdge);
+    loadImage(out.texture, tileImage, false, &_imageUploadBuffers);
+    out.id = {Int(level), tile.x(), tile.y()};
+}
+
 void ImagePlayer::viewportEvent(ViewportEvent& event) {
     _projection = Matrix3::projection(Vector2{event.framebufferSize()});
 }
@@ -139,6 +285,29 @@ void ImagePlayer::keyPressEvent(KeyEvent& event) {
             _transformation = Matrix3::scaling(Vector2{_imageSize}/2.0f);
         else
             _transformation = Matrix3::scaling(application().framebufferSize().min()*0.9f*Vector2{1.0f, 1.0f/Vector2{_imageSize}.aspectRatio()});
+
+    /* Print the value range and a coarse histogram of each channel, with the
+       bins merged to 16 and shown as a percentage of all pixels */
+    #ifndef MAGNUM_TARGET_GLES
+    } else if(event.key() == Key::H && _statistics) {
+        Debug{} << "Value range:" << _statistics->minimum() << "to" << _statistics->maximum();
+        const char* const ChannelNames[]{"R", "G", "B", "A"};
+        for(UnsignedInt channel = 0; channel != 4; ++channel) {
+            const Containers::ArrayView<const Float> histogram = _statistics->histogram(channel);
+            Float total = 0.0f;
+            for(const Float count: histogram)
+                total += count;
+
+            Debug d;
+            d << ChannelNames[channel] << Debug::nospace << ":";
+            for(UnsignedInt i = 0; i != ImageStatistics::BinCount; i += ImageStatistics::BinCount/16) {
+                Float count = 0.0f;
+                for(const Float binCount: histogram.sliceSize(i, ImageStatistics::BinCount/16))
+                    count += binCount;
+                d << UnsignedInt(Math::round(100.0f*count/total));
+            }
+        }
+    #endif
     } else return;
 
     event.setAccepted();
@@ -193,8 +362,10 @@ void ImagePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
 
     Debug{} << "Loading image" << id << importer.image2DName(id);
 
+    const std::chrono::steady_clock::time_point decodeStart = std::chrono::steady_clock::now();
     Containers::Optional<Trade::ImageData2D> image = importer.image2D(id);
     if(!image) return;
+    const std::chrono::steady_clock::time_point uploadStart = std::chrono::steady_clock::now();
 
     _texture = GL::Texture2D{};
     _texture
@@ -202,19 +373,8 @@ void ImagePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
         .setMinificationFilter(GL::SamplerFilter::Linear)
         .setWrapping(GL::SamplerWrapping::ClampToEdge);
 
-    loadImage(_texture, *image);
-
-    /* Set up default transformation. Centered, 1:1 scale if more than 50% of
-       the view, otherwise scaled up to 90% of the view. */
-    _imageSize = image->size();
-    if(_transformation == Matrix3{}) {
-        if((_imageSize > application().framebufferSize()*0.5f).any())
-            _transformation = Matrix3::scaling(Vector2{_imageSize}/2.0f);
-        else
-            _transformation = Matrix3::scaling(application().framebufferSize().min()*0.9f*Vector2{1.0f, 1.0f/Vector2{_imageSize}.aspectRatio()}/2.0f);
-    }
-
-    /* Populate the model info */
+    /* Remember the format for the info, the image may get moved into the
+       levels below */
     /** @todo ugh debug->format converter?! */
     std::ostringstream out;
     if(!image->isCompressed())
@@ -222,14 +382,68 @@ void ImagePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
     else
         Debug{&out, Debug::Flag::NoNewlineAtTheEnd} << image->compressedFormat();
 
+    /* If the image is too large, build the levels for tiled drawing, each
+       half the size of the previous, until it fits into a single tile. The
+       levels are nearest-neighbor downsampled, with the linear filtering done
+       when drawing smoothing that out for the zoom levels in between. */
+    /** @todo handle compressed images as well, tile on block boundaries */
+    _levels = Containers::Array<Trade::ImageData2D>{};
+    for(Tile& tile: _tiles) tile.id = Vector3i{-1};
+    _imageSize = image->size();
+    if(!image->isCompressed() && !isPixelFormatImplementationSpecific(image->format()) && (image->size() > Math::min(Vector2i{MaxUntiledSize}, GL::Texture2D::maxSize())).any()) {
+        Debug{} << "Image is too large, drawing it in" << TileSize << Debug::nospace << "x" << Debug::nospace << TileSize << "tiles";
+
+        arrayAppend(_levels, *Utility::move(image));
+        while((_levels.back().size() > Vector2i{TileSize}).any()) {
+            const Trade::ImageData2D& previous = _levels.back();
+            const Vector2i size = (previous.size() + Vector2i{1})/2;
+            Trade::ImageData2D level{PixelStorage{}.setAlignment(1), previous.format(), size, Containers::Array<char>{NoInit, std::size_t(size.product())*previous.pixelSize()}};
+            Utility::copy(previous.pixels().every({2, 2, 1}), level.mutablePixels());
+            arrayAppend(_levels, Utility::move(level));
+        }
+
+        loadImage(_texture, _levels.back(), false, &_imageUploadBuffers);
+    } else loadImage(_texture, *image, false, &_imageUploadBuffers);
+
+    /* Calculate value range and histogram of what got uploaded, which for
+       tiled images is the coarsest level */
+    Containers::String valueRange;
+    #ifndef MAGNUM_TARGET_GLES
+    _statistics = Containers::NullOpt;
+    if(_texture.imageSize(0).product()) {
+        _statistics.emplace(_texture);
+        valueRange = Utility::format(", values {:.3} to {:.3}",
+            _statistics->minimum().xyz().min(),
+            _statistics->maximum().xyz().max());
+    }
+    #endif
+
+    /* Populate the model info, together with the decode and upload times.
+       The upload time includes building the tile levels. */
+    const std::chrono::steady_clock::time_point uploadEnd = std::chrono::steady_clock::now();
+    const Double decodeDuration = std::chrono::duration<Double, std::milli>(uploadStart - decodeStart).count();
+    const Double uploadDuration = std::chrono::duration<Double, std::milli>(uploadEnd - uploadStart).count();
+    if(importer.flags() >= Trade::ImporterFlag::Verbose)
+        Debug{} << Utility::format("Image decoded in {:.2f} ms, uploaded in {:.2f} ms", decodeDuration, uploadDuration);
     _imageInfo.setText(Utility::format(
-        "{}: {}x{}, {}",
+        "{}: {}x{}, {}{}, decoded in {:.0f} ms, uploaded in {:.0f} ms",
         Utility::Path::split(filename).second(),
-        image->size().x(), image->size().y(),
-        out.str()),
+        _imageSize.x(), _imageSize.y(),
+        out.str(),
+        valueRange,
+        decodeDuration, uploadDuration),
         /** @todo ugh, having to specify this every time is NASTY, what to do
             besides supplying extra style variants? */
         Text::Alignment::MiddleLeft);
+
+    /* Set up default transformation. Centered, 1:1 scale if more than 50% of
+       the view, otherwise scaled up to 90% of the view. */
+    if(_transformation == Matrix3{}) {
+        if((_imageSize > application().framebufferSize()*0.5f).any())
+            _transformation = Matrix3::scaling(Vector2{_imageSize}/2.0f);
+        else
+            _transformation = Matrix3::scaling(application().framebufferSize().min()*0.9f*Vector2{1.0f, 1.0f/Vector2{_imageSize}.aspectRatio()}/2.0f);
+    }
 }
 
 }
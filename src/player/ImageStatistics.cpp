@@ -0,0 +1,189 @@
+/*
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "ImageStatistics.h"
+
+#include <Corrade/Containers/Iterable.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/Move.h>
+#include <Corrade/Utility/Resource.h>
+#include <Magnum/Image.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/GL/DefaultFramebuffer.h>
+#include <Magnum/GL/Framebuffer.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/Renderbuffer.h>
+#include <Magnum/GL/RenderbufferFormat.h>
+#include <Magnum/GL/Renderer.h>
+#include <Magnum/GL/Shader.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/GL/TextureFormat.h>
+#include <Magnum/GL/Version.h>
+#include <Magnum/Math/Color.h>
+
+namespace Magnum { namespace Player {
+
+using namespace Containers::Literals;
+
+namespace {
+
+GL::Shader compileShader(GL::Shader::Type type, Containers::StringView filename) {
+    Utility::Resource rs{"image-statistics"_s};
+    GL::Shader shader{GL::Version::GL330, type};
+    shader.addSource(rs.getString(filename));
+    CORRADE_INTERNAL_ASSERT_OUTPUT(shader.compile());
+    return shader;
+}
+
+class ReduceShader: public GL::AbstractShaderProgram {
+    public:
+        explicit ReduceShader() {
+            attachShaders({
+                compileShader(GL::Shader::Type::Vertex, "ImageStatistics.vert"_s),
+                compileShader(GL::Shader::Type::Fragment, "ImageStatisticsReduce.frag"_s)});
+            CORRADE_INTERNAL_ASSERT_OUTPUT(link());
+
+            setUniform(uniformLocation("minimumTexture"_s), 0);
+            setUniform(uniformLocation("maximumTexture"_s), 1);
+        }
+
+        ReduceShader& bindTextures(GL::Texture2D& minimum, GL::Texture2D& maximum) {
+            minimum.bind(0);
+            maximum.bind(1);
+            return *this;
+        }
+};
+
+class HistogramShader: public GL::AbstractShaderProgram {
+    public:
+        explicit HistogramShader() {
+            attachShaders({
+                compileShader(GL::Shader::Type::Vertex, "ImageStatisticsHistogram.vert"_s),
+                compileShader(GL::Shader::Type::Fragment, "ImageStatisticsHistogram.frag"_s)});
+            CORRADE_INTERNAL_ASSERT_OUTPUT(link());
+
+            setUniform(uniformLocation("imageTexture"_s), 0);
+            setUniform(uniformLocation("minimumTexture"_s), 1);
+            setUniform(uniformLocation("maximumTexture"_s), 2);
+            setUniform(uniformLocation("binCount"_s), Int(ImageStatistics::BinCount));
+        }
+
+        HistogramShader& bindTextures(GL::Texture2D& image, GL::Texture2D& minimum, GL::Texture2D& maximum) {
+            image.bind(0);
+            minimum.bind(1);
+            maximum.bind(2);
+            return *this;
+        }
+};
+
+GL::Texture2D reductionTexture(const Vector2i& size) {
+    GL::Texture2D texture;
+    texture.setStorage(1, GL::TextureFormat::RGBA32F, size);
+    return texture;
+}
+
+}
+
+ImageStatistics::ImageStatistics(GL::Texture2D& texture) {
+    const Vector2i size = texture.imageSize(0);
+
+    GL::Renderer::disable(GL::Renderer::Feature::DepthTest);
+    GL::Renderer::disable(GL::Renderer::Feature::Blending);
+
+    /* Reduce the image to 1x1, each pass reading the output of the previous
+       one. Done at least once so a 1x1 input gets converted to the float
+       format as well. */
+    ReduceShader reduceShader;
+    GL::Mesh triangle;
+    triangle.setCount(3);
+    GL::Texture2D rangeMinimum{NoCreate}, rangeMaximum{NoCreate};
+    GL::Framebuffer framebuffer{NoCreate};
+    Vector2i levelSize = size;
+    do {
+        levelSize = (levelSize + Vector2i{3})/4;
+        GL::Texture2D levelMinimum = reductionTexture(levelSize);
+        GL::Texture2D levelMaximum = reductionTexture(levelSize);
+        GL::Framebuffer levelFramebuffer{{{}, levelSize}};
+        levelFramebuffer
+            .attachTexture(GL::Framebuffer::ColorAttachment{0}, levelMinimum, 0)
+            .attachTexture(GL::Framebuffer::ColorAttachment{1}, levelMaximum, 0)
+            .mapForDraw({
+                {0, GL::Framebuffer::ColorAttachment{0}},
+                {1, GL::Framebuffer::ColorAttachment{1}}})
+            .bind();
+
+        if(rangeMinimum.id())
+            reduceShader.bindTextures(rangeMinimum, rangeMaximum);
+        else
+            reduceShader.bindTextures(texture, texture);
+        reduceShader.draw(triangle);
+
+        rangeMinimum = Utility::move(levelMinimum);
+        rangeMaximum = Utility::move(levelMaximum);
+        framebuffer = Utility::move(levelFramebuffer);
+    } while(levelSize != Vector2i{1});
+
+    framebuffer.mapForRead(GL::Framebuffer::ColorAttachment{0});
+    const Image2D minimumImage = framebuffer.read({{}, Vector2i{1}}, {PixelFormat::RGBA32F});
+    _minimum = minimumImage.pixels<Vector4>()[0][0];
+    framebuffer.mapForRead(GL::Framebuffer::ColorAttachment{1});
+    const Image2D maximumImage = framebuffer.read({{}, Vector2i{1}}, {PixelFormat::RGBA32F});
+    _maximum = maximumImage.pixels<Vector4>()[0][0];
+
+    /* Scatter four points per pixel into a row of bins for each channel. The
+       range is taken directly from the reduction textures, so the histogram
+       doesn't need to wait for the readback above. */
+    GL::Renderbuffer bins;
+    bins.setStorage(GL::RenderbufferFormat::R32F, {BinCount, 4});
+    GL::Framebuffer histogramFramebuffer{{{}, {BinCount, 4}}};
+    histogramFramebuffer
+        .attachRenderbuffer(GL::Framebuffer::ColorAttachment{0}, bins)
+        .clearColor(0, Color4{0.0f})
+        .bind();
+
+    GL::Renderer::enable(GL::Renderer::Feature::Blending);
+    GL::Renderer::setBlendFunction(GL::Renderer::BlendFunction::One, GL::Renderer::BlendFunction::One);
+    GL::Mesh points{GL::MeshPrimitive::Points};
+    points.setCount(size.product()*4);
+    HistogramShader histogramShader;
+    histogramShader
+        .bindTextures(texture, rangeMinimum, rangeMaximum)
+        .draw(points);
+    GL::Renderer::disable(GL::Renderer::Feature::Blending);
+
+    const Image2D histogramImage = histogramFramebuffer.read({{}, {BinCount, 4}}, {PixelFormat::R32F});
+    _histogram = Containers::Array<Float>{NoInit, BinCount*4};
+    Utility::copy(histogramImage.pixels<Float>(), Containers::StridedArrayView2D<Float>{_histogram, {4, BinCount}});
+
+    /* Restore the state expected by the rest of the player */
+    GL::Renderer::enable(GL::Renderer::Feature::DepthTest);
+    GL::defaultFramebuffer.bind();
+}
+
+}}
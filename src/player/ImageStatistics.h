@@ -0,0 +1,66 @@
+#ifndef Magnum_Player_ImageStatistics_h
+#define Magnum_Player_ImageStatistics_h
+/*
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Containers/Array.h>
+#include <Magnum/Math/Vector4.h>
+#include <Magnum/GL/GL.h>
+
+namespace Magnum { namespace Player {
+
+/* Per-channel value range and histogram of a texture, calculated on the GPU.
+   The range is a min/max reduction done with a fragment shader, 4x4 pixels
+   at a time, down to a single pixel, the histogram then scatters a point for
+   each pixel channel into a bin relative to the range, counting them with
+   additive blending. Only the final range and the histogram are read back.
+   Needs desktop GL 3.3 and isn't available on ES. */
+class ImageStatistics {
+    public:
+        enum: UnsignedInt { BinCount = 256 };
+
+        /* Calculates statistics of the base level of the texture */
+        explicit ImageStatistics(GL::Texture2D& texture);
+
+        Vector4 minimum() const { return _minimum; }
+        Vector4 maximum() const { return _maximum; }
+
+        /* Pixel counts in each bin, the bins are evenly distributed between
+           minimum() and maximum() of given channel. The counts are exact only
+           up to 2^24 as they're accumulated in a 32-bit float. */
+        Containers::ArrayView<const Float> histogram(UnsignedInt channel) const {
+            return Containers::arrayView(_histogram).sliceSize(channel*BinCount, BinCount);
+        }
+
+    private:
+        Vector4 _minimum, _maximum;
+        Containers::Array<Float> _histogram;
+};
+
+}}
+
+#endif
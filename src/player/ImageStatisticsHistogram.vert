@@ -0,0 +1,49 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+uniform highp sampler2D imageTexture;
+/* 1x1 results of the reduction pass */
+uniform highp sampler2D minimumTexture;
+uniform highp sampler2D maximumTexture;
+uniform int binCount;
+
+/* There are four points for each pixel, one for each channel. The point is
+   placed into the column corresponding to the bin of the channel value
+   relative to the value range, and into the row corresponding to the
+   channel. Additive blending then counts the points in each bin. */
+void main() {
+    highp ivec2 size = textureSize(imageTexture, 0);
+    highp int pixel = gl_VertexID/4;
+    int channel = gl_VertexID - pixel*4;
+    highp float value = texelFetch(imageTexture, ivec2(pixel % size.x, pixel/size.x), 0)[channel];
+    highp float minimum = texelFetch(minimumTexture, ivec2(0), 0)[channel];
+    highp float maximum = texelFetch(maximumTexture, ivec2(0), 0)[channel];
+    highp float range = maximum - minimum;
+    int bin = range > 0.0 ? min(int((value - minimum)/range*float(binCount)), binCount - 1) : 0;
+    gl_Position = vec4((float(bin) + 0.5)/float(binCount)*2.0 - 1.0,
+                       (float(channel) + 0.5)/4.0*2.0 - 1.0, 0.0, 1.0);
+}
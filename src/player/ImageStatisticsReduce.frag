@@ -0,0 +1,49 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+/* For the first pass both are the input image, for the subsequent passes the
+   outputs of the previous pass */
+uniform highp sampler2D minimumTexture;
+uniform highp sampler2D maximumTexture;
+
+layout(location = 0) out highp vec4 minimum;
+layout(location = 1) out highp vec4 maximum;
+
+/* Each output pixel is a minimum and maximum of a 4x4 block of the input.
+   Blocks on the right and bottom edge are clamped, which doesn't affect the
+   result as the duplicated texels are already in the block. */
+void main() {
+    highp ivec2 size = textureSize(minimumTexture, 0);
+    highp ivec2 origin = ivec2(gl_FragCoord.xy)*4;
+    minimum = vec4(3.402823e38);
+    maximum = vec4(-3.402823e38);
+    for(int y = 0; y != 4; ++y) for(int x = 0; x != 4; ++x) {
+        highp ivec2 position = min(origin + ivec2(x, y), size - ivec2(1));
+        minimum = min(minimum, texelFetch(minimumTexture, position, 0));
+        maximum = max(maximum, texelFetch(maximumTexture, position, 0));
+    }
+}
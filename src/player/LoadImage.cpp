@@ -27,10 +27,12 @@
 #include "LoadImage.h"
 
 #include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Utility/Move.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Math/Functions.h>
+#include <Magnum/GL/BufferImage.h>
 #include <Magnum/GL/Context.h>
 #include <Magnum/GL/Extensions.h>
 #include <Magnum/GL/Texture.h>
@@ -39,14 +41,72 @@
 
 namespace Magnum { namespace Player {
 
-void loadImage(GL::Texture2D& texture, const Trade::ImageData2D& image) {
+ImageUploadBuffers::ImageUploadBuffers()
+    #if !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+    : buffers{
+        GL::Buffer{GL::Buffer::TargetHint::PixelUnpack},
+        GL::Buffer{GL::Buffer::TargetHint::PixelUnpack},
+        GL::Buffer{GL::Buffer::TargetHint::PixelUnpack}}
+    #endif
+    {}
+
+namespace {
+
+/* Expands a row of one- or two-channel pixels to three- or four-channel ones.
+   Pixels in a row are contiguous, so it's a plain loop that the compiler can
+   vectorize, unlike a generic strided copy with a broadcasted view, which
+   goes element by element. */
+template<class T> void expandChannelsRow(const T* const src, T* const dst, const std::size_t count, const bool alpha) {
+    if(alpha) for(std::size_t i = 0; i != count; ++i) {
+        const T r = src[i*2 + 0];
+        const T a = src[i*2 + 1];
+        dst[i*4 + 0] = r;
+        dst[i*4 + 1] = r;
+        dst[i*4 + 2] = r;
+        dst[i*4 + 3] = a;
+    } else for(std::size_t i = 0; i != count; ++i) {
+        const T r = src[i];
+        dst[i*3 + 0] = r;
+        dst[i*3 + 1] = r;
+        dst[i*3 + 2] = r;
+    }
+}
+
+/* Expands a one- or two-channel image to a three- or four-channel one of the
+   same size, broadcasting the red channel to RGB */
+void expandChannels(const ImageView2D& src, const MutableImageView2D& dst) {
+    const bool alpha = pixelFormatChannelCount(src.format()) == 2;
+    const Containers::StridedArrayView3D<const char> srcPixels = src.pixels();
+    const Containers::StridedArrayView3D<char> dstPixels = dst.pixels();
+    const std::size_t width = src.size().x();
+    for(std::size_t y = 0; y != srcPixels.size()[0]; ++y) {
+        const void* const srcRow = srcPixels[y].data();
+        void* const dstRow = dstPixels[y].data();
+        switch(pixelFormatSize(pixelFormatChannelFormat(src.format()))) {
+            case 1:
+                expandChannelsRow(static_cast<const UnsignedByte*>(srcRow), static_cast<UnsignedByte*>(dstRow), width, alpha);
+                break;
+            case 2:
+                expandChannelsRow(static_cast<const UnsignedShort*>(srcRow), static_cast<UnsignedShort*>(dstRow), width, alpha);
+                break;
+            case 4:
+                expandChannelsRow(static_cast<const UnsignedInt*>(srcRow), static_cast<UnsignedInt*>(dstRow), width, alpha);
+                break;
+            default: CORRADE_INTERNAL_ASSERT_UNREACHABLE();
+        }
+    }
+}
+
+}
+
+void loadImage(GL::Texture2D& texture, const Trade::ImageData2D& image, const bool compress, ImageUploadBuffers* const buffers) {
     if(!image.isCompressed()) {
         /* Single-channel images are probably meant to represent grayscale,
            two-channel grayscale + alpha. Probably, there's no way to know, but
            given we're using them for *colors*, it makes more sense than
            displaying them just red or red+green. */
-        Containers::Array<char> usedImageStorage;
-        ImageView2D usedImage = image;
+        PixelFormat usedFormat = image.format();
+        bool expand = false;
         const UnsignedInt channelCount = pixelFormatChannelCount(image.format());
         if(channelCount == 1 || channelCount == 2) {
             #ifndef MAGNUM_TARGET_WEBGL
@@ -65,43 +125,18 @@ void loadImage(GL::Texture2D& texture, const Trade::ImageData2D& image) {
             #endif
             #endif
             {
-                /* Without texture swizzle support, allocate a copy of the image
-                   and expand the channels manually */
-                /** @todo make this a utility in TextureTools, with the channel
-                    expansion being an optimized routine in Math/PackingBatch.h */
-                const PixelFormat imageFormat = pixelFormat(image.format(), channelCount == 2 ? 4 : 3, isPixelFormatSrgb(image.format()));
-                Debug{} << "Texture swizzle not supported, expanding a" << image.format() << "image to" << imageFormat;
-
-                /* Pad to four-byte rows to not have to use non-optimal
-                   alignment */
-                const std::size_t rowStride = 4*((pixelFormatSize(imageFormat)*image.size().x() + 3)/4);
-                usedImageStorage = Containers::Array<char>{NoInit, std::size_t(rowStride*image.size().y())};
-                const MutableImageView2D usedMutableImage{imageFormat, image.size(), usedImageStorage};
-                usedImage = usedMutableImage;
-
-                /* Create 4D pixel views (rows, pixels, channels, channel
-                   bytes) */
-                const std::size_t channelSize = pixelFormatSize(pixelFormatChannelFormat(imageFormat));
-                const std::size_t dstChannelCount = pixelFormatChannelCount(imageFormat);
-                const Containers::StridedArrayView4D<const char> src = image.pixels().expanded<2>(Containers::Size2D{channelCount, channelSize});
-                const Containers::StridedArrayView4D<char> dst = usedMutableImage.pixels().expanded<2>(Containers::Size2D{dstChannelCount, channelSize});
-
-                /* Broadcast the red channel of the input to RRR and copy to
-                   the RGB channels of the output */
-                Utility::copy(
-                    src.exceptSuffix({0, 0, channelCount == 2 ? 1 : 0, 0}).broadcasted<2>(3),
-                    dst.exceptSuffix({0, 0, channelCount == 2 ? 1 : 0, 0}));
-                /* If there's an alpha channel, copy it over as well */
-                if(channelCount == 2) Utility::copy(
-                    src.exceptPrefix({0, 0, 1, 0}),
-                    dst.exceptPrefix({0, 0, 3, 0}));
+                /* Without texture swizzle support, expand the channels
+                   manually during the upload below */
+                usedFormat = pixelFormat(image.format(), channelCount == 2 ? 4 : 3, isPixelFormatSrgb(image.format()));
+                expand = true;
+                Debug{} << "Texture swizzle not supported, expanding a" << image.format() << "image to" << usedFormat;
             }
         }
 
         /* Whitelist only things we *can* display */
         /** @todo signed formats, exposure knob for float formats */
         GL::TextureFormat format;
-        switch(usedImage.format()) {
+        switch(usedFormat) {
             case PixelFormat::R8Unorm:
             case PixelFormat::RG8Unorm:
             /* can't really do sRGB R/RG as there are no widely available
@@ -125,17 +160,74 @@ void loadImage(GL::Texture2D& texture, const Trade::ImageData2D& image) {
             case PixelFormat::RG32F:
             case PixelFormat::RGB32F:
             case PixelFormat::RGBA32F:
-                format = GL::textureFormat(usedImage.format());
+                format = GL::textureFormat(usedFormat);
                 break;
             default:
-                Warning{} << "Cannot load an image of format" << usedImage.format();
+                Warning{} << "Cannot load an image of format" << usedFormat;
                 return;
         }
 
-        texture
-            .setStorage(Math::log2(usedImage.size().max()) + 1, format, usedImage.size())
-            .setSubImage(0, {}, usedImage)
-            .generateMipmap();
+        /* If requested, let the driver compress 8-bit RGB and RGBA images to
+           S3TC on upload to save GPU memory. Only desktop GL allows uploading
+           uncompressed data to a compressed texture. */
+        /** @todo sRGB variants, RGTC for one- and two-channel images */
+        #ifndef MAGNUM_TARGET_GLES
+        if(compress && GL::Context::current().isExtensionSupported<GL::Extensions::EXT::texture_compression_s3tc>()) {
+            if(usedFormat == PixelFormat::RGB8Unorm)
+                format = GL::TextureFormat::CompressedRGBS3tcDxt1;
+            else if(usedFormat == PixelFormat::RGBA8Unorm)
+                format = GL::TextureFormat::CompressedRGBAS3tcDxt5;
+        }
+        #else
+        static_cast<void>(compress);
+        #endif
+
+        texture.setStorage(Math::log2(image.size().max()) + 1, format, image.size());
+
+        /* Pad to four-byte rows to not have to use non-optimal alignment */
+        const std::size_t rowStride = 4*((pixelFormatSize(usedFormat)*image.size().x() + 3)/4);
+        const std::size_t dataSize = rowStride*image.size().y();
+
+        /* If upload buffers are passed, copy or expand the pixels directly
+           into a mapped buffer from the ring, orphaning its previous contents
+           so the map doesn't wait for the previous upload from it to finish.
+           The texture upload from the buffer is then asynchronous. */
+        #if !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+        if(buffers) {
+            GL::Buffer& buffer = buffers->buffers[buffers->next];
+            buffers->next = (buffers->next + 1) % Containers::arraySize(buffers->buffers);
+            buffer.setData({nullptr, dataSize}, GL::BufferUsage::StreamDraw);
+
+            const MutableImageView2D mapped{usedFormat, image.size(), buffer.map(0, dataSize, GL::Buffer::MapFlag::Write|GL::Buffer::MapFlag::InvalidateBuffer)};
+            if(expand)
+                expandChannels(image, mapped);
+            else
+                Utility::copy(image.pixels(), mapped.pixels());
+            buffer.unmap();
+
+            GL::BufferImage2D bufferImage{usedFormat, image.size(), Utility::move(buffer), dataSize};
+            texture.setSubImage(0, {}, bufferImage);
+            buffer = bufferImage.release();
+        } else
+        #else
+        static_cast<void>(buffers);
+        #endif
+        {
+            /* Otherwise, without texture swizzle support allocate a copy of
+               the image with the channels expanded */
+            Containers::Array<char> usedImageStorage;
+            ImageView2D usedImage = image;
+            if(expand) {
+                usedImageStorage = Containers::Array<char>{NoInit, dataSize};
+                const MutableImageView2D usedMutableImage{usedFormat, image.size(), usedImageStorage};
+                expandChannels(image, usedMutableImage);
+                usedImage = usedMutableImage;
+            }
+
+            texture.setSubImage(0, {}, usedImage);
+        }
+
+        texture.generateMipmap();
 
     } else {
         /* Blacklist things we *cannot* display */
@@ -27,11 +27,30 @@
 */
 
 #include <Magnum/GL/GL.h>
+#if !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+#include <Magnum/GL/Buffer.h>
+#endif
 #include <Magnum/Trade/Trade.h>
 
 namespace Magnum { namespace Player {
 
-void loadImage(GL::Texture2D& texture, const Trade::ImageData2D& image);
+/* Ring of pixel unpack buffers for loadImage(), allowing the copy of one
+   image to overlap with the GPU transfer of the previous one. Empty on ES2
+   and WebGL, where buffer mapping isn't available and the images are
+   uploaded directly. */
+struct ImageUploadBuffers {
+    explicit ImageUploadBuffers();
+
+    #if !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+    GL::Buffer buffers[3];
+    UnsignedInt next = 0;
+    #endif
+};
+
+/* If compress is set, 8-bit RGB and RGBA images are compressed to S3TC by the
+   driver on upload, where supported. If buffers are passed, uncompressed
+   images are uploaded through them. */
+void loadImage(GL::Texture2D& texture, const Trade::ImageData2D& image, bool compress = false, ImageUploadBuffers* buffers = nullptr);
 
 }}
 
@@ -0,0 +1,243 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "MeshCache.h"
+
+#include <cstring>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/Utility/Format.h>
+#include <Corrade/Utility/Move.h>
+#include <Magnum/Mesh.h>
+#include <Magnum/VertexFormat.h>
+#include <Magnum/Trade/MeshData.h>
+
+namespace Magnum { namespace Player {
+
+namespace {
+
+/* Bump the version on any change in the layout below */
+constexpr char Magic[8]{'M', 'P', 'M', 'E', 'S', 'H', 'C', '1'};
+
+struct Header {
+    char magic[8];
+    UnsignedLong sourceSize;
+    UnsignedLong sourceHash;
+    UnsignedInt meshCount;
+    UnsignedInt reserved;
+    /* Followed by meshCount UnsignedLong offsets to MeshHeader, zero for
+       meshes that aren't cached */
+};
+
+struct MeshHeader {
+    UnsignedInt primitive;
+    /* Zero for non-indexed meshes */
+    UnsignedInt indexType;
+    UnsignedInt indexCount;
+    Int indexStride;
+    UnsignedLong indexOffset;
+    /* Absolute offsets in the file */
+    UnsignedLong indexDataOffset;
+    UnsignedLong indexDataSize;
+    UnsignedLong vertexDataOffset;
+    UnsignedLong vertexDataSize;
+    UnsignedInt vertexCount;
+    UnsignedInt attributeCount;
+    /* Followed by attributeCount AttributeHeader instances */
+};
+
+struct AttributeHeader {
+    UnsignedShort name;
+    UnsignedShort arraySize;
+    UnsignedInt format;
+    UnsignedLong offset;
+    Long stride;
+};
+
+/* 64-bit FNV-1a. Not cryptographically secure, but good enough for
+   detecting that the source file changed. */
+UnsignedLong hash(Containers::ArrayView<const char> data) {
+    UnsignedLong out = 14695981039346656037ull;
+    for(const char c: data) {
+        out ^= UnsignedByte(c);
+        out *= 1099511628211ull;
+    }
+    return out;
+}
+
+/* Data blobs are aligned to 16 bytes so vertex and index data can be used
+   directly from the mapped memory */
+void appendAligned(Containers::Array<char>& out, Containers::ArrayView<const char> data) {
+    arrayAppend(out, ValueInit, (16 - out.size() % 16) % 16);
+    arrayAppend(out, data);
+}
+
+template<class T> void append(Containers::Array<char>& out, const T& value) {
+    arrayAppend(out, Containers::arrayView(reinterpret_cast<const char*>(&value), sizeof(T)));
+}
+
+}
+
+MeshCache::MeshCache(const Containers::StringView filename, const UnsignedInt meshCount): _filename{Utility::format("{}.mesh-cache", filename)}, _meshCount{meshCount} {
+    {
+        Containers::Optional<Containers::Array<const char, Utility::Path::MapDeleter>> source = Utility::Path::mapRead(filename);
+        if(!source) return;
+        _sourceSize = source->size();
+        _sourceHash = hash(*source);
+    }
+
+    if(!Utility::Path::exists(_filename)) return;
+
+    Containers::Optional<Containers::Array<const char, Utility::Path::MapDeleter>> cache = Utility::Path::mapRead(_filename);
+    if(!cache) return;
+
+    /* Check that the cache matches the source file and that all offsets are
+       in bounds, so a truncated or corrupted file doesn't crash anything */
+    const std::size_t tableSize = sizeof(Header) + meshCount*sizeof(UnsignedLong);
+    if(cache->size() < tableSize) {
+        Warning{} << "Mesh cache" << _filename << "is corrupted, ignoring";
+        return;
+    }
+    const Header& header = *reinterpret_cast<const Header*>(cache->data());
+    if(std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 ||
+       header.sourceSize != _sourceSize ||
+       header.sourceHash != _sourceHash ||
+       header.meshCount != meshCount) {
+        Debug{} << "Mesh cache" << _filename << "is outdated, ignoring";
+        return;
+    }
+    const UnsignedLong* const offsets = reinterpret_cast<const UnsignedLong*>(cache->data() + sizeof(Header));
+    for(UnsignedInt i = 0; i != meshCount; ++i) {
+        if(!offsets[i]) continue;
+        if(offsets[i] < tableSize || offsets[i] + sizeof(MeshHeader) > cache->size()) {
+            Warning{} << "Mesh cache" << _filename << "is corrupted, ignoring";
+            return;
+        }
+        const MeshHeader& mesh = *reinterpret_cast<const MeshHeader*>(cache->data() + offsets[i]);
+        if(offsets[i] + sizeof(MeshHeader) + mesh.attributeCount*sizeof(AttributeHeader) > cache->size() ||
+           mesh.indexDataOffset + mesh.indexDataSize > cache->size() ||
+           mesh.vertexDataOffset + mesh.vertexDataSize > cache->size()) {
+            Warning{} << "Mesh cache" << _filename << "is corrupted, ignoring";
+            return;
+        }
+    }
+
+    Debug{} << "Using mesh cache" << _filename;
+    _cache = Utility::move(cache);
+}
+
+Containers::Optional<Trade::MeshData> MeshCache::mesh(const UnsignedInt id) const {
+    if(!_cache || id >= _meshCount)
+        return {};
+
+    const char* const data = _cache->data();
+    const UnsignedLong offset = reinterpret_cast<const UnsignedLong*>(data + sizeof(Header))[id];
+    if(!offset)
+        return {};
+
+    const MeshHeader& header = *reinterpret_cast<const MeshHeader*>(data + offset);
+    const AttributeHeader* const attributeHeaders = reinterpret_cast<const AttributeHeader*>(data + offset + sizeof(MeshHeader));
+    Containers::Array<Trade::MeshAttributeData> attributes{header.attributeCount};
+    for(UnsignedInt i = 0; i != header.attributeCount; ++i) {
+        const AttributeHeader& attribute = attributeHeaders[i];
+        attributes[i] = Trade::MeshAttributeData{Trade::MeshAttribute(attribute.name), VertexFormat(attribute.format), std::size_t(attribute.offset), header.vertexCount, std::ptrdiff_t(attribute.stride), attribute.arraySize};
+    }
+
+    const Containers::ArrayView<const char> vertexData{data + header.vertexDataOffset, std::size_t(header.vertexDataSize)};
+    if(!header.indexType)
+        return Trade::MeshData{MeshPrimitive(header.primitive), {}, vertexData, Utility::move(attributes), header.vertexCount};
+
+    const Containers::ArrayView<const char> indexData{data + header.indexDataOffset, std::size_t(header.indexDataSize)};
+    const Trade::MeshIndexData indices{MeshIndexType(header.indexType), Containers::StridedArrayView1D<const void>{indexData, indexData.data() + header.indexOffset, header.indexCount, header.indexStride}};
+    return Trade::MeshData{MeshPrimitive(header.primitive), {}, indexData, indices, {}, vertexData, Utility::move(attributes), header.vertexCount};
+}
+
+void MeshCache::setMesh(const UnsignedInt id, const Trade::MeshData& mesh) {
+    CORRADE_INTERNAL_ASSERT(id < _meshCount);
+
+    /* Reserve space for the header and offset table on first use, filled in
+       save() */
+    if(_data.isEmpty()) {
+        arrayAppend(_data, ValueInit, sizeof(Header) + _meshCount*sizeof(UnsignedLong));
+        _offsets = Containers::Array<UnsignedLong>{ValueInit, _meshCount};
+    }
+
+    /* Put the data first so their offsets are known when writing the header.
+       The header itself is 8-byte aligned for the UnsignedLong members. */
+    MeshHeader header{};
+    header.primitive = UnsignedInt(mesh.primitive());
+    header.vertexCount = mesh.vertexCount();
+    header.attributeCount = mesh.attributeCount();
+    if(mesh.isIndexed()) {
+        header.indexType = UnsignedInt(mesh.indexType());
+        header.indexCount = mesh.indexCount();
+        header.indexStride = mesh.indexStride();
+        header.indexOffset = mesh.indexOffset();
+        appendAligned(_data, mesh.indexData());
+        header.indexDataOffset = _data.size() - mesh.indexData().size();
+        header.indexDataSize = mesh.indexData().size();
+    }
+    appendAligned(_data, mesh.vertexData());
+    header.vertexDataOffset = _data.size() - mesh.vertexData().size();
+    header.vertexDataSize = mesh.vertexData().size();
+
+    arrayAppend(_data, ValueInit, (8 - _data.size() % 8) % 8);
+    _offsets[id] = _data.size();
+    append(_data, header);
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+        AttributeHeader attribute{};
+        attribute.name = UnsignedShort(mesh.attributeName(i));
+        attribute.arraySize = mesh.attributeArraySize(i);
+        attribute.format = UnsignedInt(mesh.attributeFormat(i));
+        attribute.offset = mesh.attributeOffset(i);
+        attribute.stride = mesh.attributeStride(i);
+        append(_data, attribute);
+    }
+}
+
+bool MeshCache::save() {
+    if(_data.isEmpty())
+        return true;
+
+    Header header{};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.sourceSize = _sourceSize;
+    header.sourceHash = _sourceHash;
+    header.meshCount = _meshCount;
+    std::memcpy(_data.data(), &header, sizeof(Header));
+    std::memcpy(_data.data() + sizeof(Header), _offsets.data(), _offsets.size()*sizeof(UnsignedLong));
+
+    if(!Utility::Path::write(_filename, _data)) {
+        Warning{} << "Cannot write mesh cache" << _filename;
+        return false;
+    }
+
+    Debug{} << "Saved mesh cache to" << _filename;
+    return true;
+}
+
+}}
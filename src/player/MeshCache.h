@@ -0,0 +1,71 @@
+#ifndef Magnum_Player_MeshCache_h
+#define Magnum_Player_MeshCache_h
+#define Magnum_Player_LoadImage_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022, 2023, 2024
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Utility/Path.h>
+#include <Magnum/Trade/Trade.h>
+
+namespace Magnum { namespace Player {
+
+/* Cache of processed meshes stored in a file next to the scene file. On
+   construction the cache is memory-mapped and used only if it was created
+   from a source file of the same size and contents hash and with the same
+   mesh count, otherwise it's ignored and gets overwritten on save(). Meshes
+   returned from mesh() reference the mapped memory directly and thus are
+   valid only as long as the cache instance. */
+class MeshCache {
+    public:
+        explicit MeshCache(Containers::StringView filename, UnsignedInt meshCount);
+
+        /* Whether the cache was opened and is up-to-date */
+        bool isValid() const { return !!_cache; }
+
+        /* Cached mesh, or NullOpt if it's not present */
+        Containers::Optional<Trade::MeshData> mesh(UnsignedInt id) const;
+
+        /* Add a mesh to be written on save(). Expected to be called only if
+           the cache isn't valid. */
+        void setMesh(UnsignedInt id, const Trade::MeshData& mesh);
+
+        /* Writes the cache file if any meshes were added with setMesh() */
+        bool save();
+
+    private:
+        Containers::String _filename;
+        UnsignedInt _meshCount;
+        UnsignedLong _sourceSize{}, _sourceHash{};
+        Containers::Optional<Containers::Array<const char, Utility::Path::MapDeleter>> _cache;
+        Containers::Array<char> _data;
+        Containers::Array<UnsignedLong> _offsets;
+};
+
+}}
+
+#endif
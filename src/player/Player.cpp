@@ -24,16 +24,22 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <algorithm> /* std::sort() */
+#include <chrono>
 #include <unordered_map>
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Function.h>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StringIterable.h>
+#include <Corrade/Containers/StringStl.h>
 #include <Corrade/Containers/StringStlHash.h>
 #include <Corrade/PluginManager/Manager.h>
 #include <Corrade/PluginManager/PluginMetadata.h>
 #include <Corrade/Utility/Arguments.h>
 #include <Corrade/Utility/Configuration.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once file callbacks are STL-free */
+#include <Corrade/Utility/Format.h>
 #include <Corrade/Utility/Path.h>
 #include <Corrade/Utility/Resource.h>
 #include <Corrade/Utility/String.h>
@@ -42,6 +48,10 @@
 #include <Magnum/GL/DefaultFramebuffer.h>
 #include <Magnum/GL/Extensions.h>
 #include <Magnum/GL/Renderer.h>
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+#include <sys/stat.h>
+#include <Magnum/GL/TimeQuery.h>
+#endif
 #include <Magnum/Platform/Screen.h>
 #include <Magnum/Platform/ScreenedApplication.h>
 #include <Magnum/Text/AbstractFont.h> /** @todo remove once extra glyph cache fill is done better */
@@ -118,6 +128,54 @@ struct Overlay: public Platform::Screen {
         #endif
 };
 
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+/* State for the --benchmark mode. All durations are in milliseconds. */
+struct Benchmark {
+    explicit Benchmark(UnsignedInt frameCount, Containers::StringView output): frameCount{frameCount}, output{output} {}
+
+    UnsignedInt frameCount, frame{};
+    Containers::String output;
+    Double openDuration{}, loadDuration{};
+    std::chrono::steady_clock::time_point frameStart, lastSwap;
+    Containers::Array<Double> frameTimes, cpuDurations, gpuDurations;
+    /* A ring of queries to not stall on the GPU, empty if timer queries
+       aren't supported */
+    Containers::Array<GL::TimeQuery> timeQueries;
+};
+
+Double milliseconds(std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration<Double, std::milli>(duration).count();
+}
+
+struct Percentiles {
+    Double mean, p50, p90, p99, max;
+};
+
+/* Sorts the values in-place */
+Percentiles percentiles(const Containers::ArrayView<Double> values) {
+    if(values.isEmpty())
+        return {};
+
+    std::sort(values.begin(), values.end());
+    Double sum = 0.0;
+    for(const Double value: values)
+        sum += value;
+    const auto at = [&values](Double fraction) {
+        return values[std::size_t(fraction*(values.size() - 1) + 0.5)];
+    };
+    return {sum/values.size(), at(0.5), at(0.9), at(0.99), values.back()};
+}
+
+/* Modification time of a file in seconds, or -1 if it can't be queried. Used
+   for detecting changes in the --watch mode. */
+Long fileModificationTime(const Containers::StringView filename) {
+    struct stat info;
+    if(stat(Containers::String::nullTerminatedView(filename).data(), &info) != 0)
+        return -1;
+    return info.st_mtime;
+}
+#endif
+
 }
 
 class Player: public Platform::ScreenedApplication {
@@ -132,16 +190,26 @@ class Player: public Platform::ScreenedApplication {
         /* Accessed from Overlay */
         void toggleControls();
         #ifndef CORRADE_TARGET_EMSCRIPTEN
-        void reload();
+        /* If incremental is set, the player is asked to keep the view state
+           and reuse what didn't change */
+        void reload(bool incremental = false);
         #endif
 
     private:
         void globalViewportEvent(ViewportEvent& size) override;
+        #ifndef CORRADE_TARGET_EMSCRIPTEN
+        void globalBeforeDrawEvent() override;
+        #endif
         void globalDrawEvent() override;
-        #if !defined(CORRADE_TARGET_EMSCRIPTEN) && defined(CORRADE_IS_DEBUG_BUILD)
+        #ifndef CORRADE_TARGET_EMSCRIPTEN
         void tickEvent() override;
         #endif
 
+        #ifndef CORRADE_TARGET_EMSCRIPTEN
+        bool openFile(Trade::AbstractImporter& importer);
+        void printBenchmark();
+        #endif
+
         PluginManager::Manager<Trade::AbstractImporter> _manager;
 
         /* Screens */
@@ -155,9 +223,25 @@ class Player: public Platform::ScreenedApplication {
         #ifndef CORRADE_TARGET_EMSCRIPTEN
         Containers::String _importer, _file;
         #if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+        /* If set, the top-level file and all files it references are
+           memory-mapped and kept alive for as long as the importer needs
+           them */
+        bool _map{};
         Containers::Array<const char, Utility::Path::MapDeleter> mapped;
+        std::unordered_map<Containers::String, Containers::Array<const char, Utility::Path::MapDeleter>> _mappedFiles;
         #endif
+        /* Importer the scene was loaded with, kept alive for the player to
+           stream textures from. Declared after the memory-mapped files so
+           it's destroyed before them. */
+        Containers::Pointer<Trade::AbstractImporter> _sceneImporter;
         Int _id{-1};
+        /* Set only in the --watch mode, the file is checked for changes in
+           tickEvent() */
+        bool _watch{};
+        Long _watchedModificationTime{-1};
+        std::chrono::steady_clock::time_point _watchLastCheck;
+        /* Set only in the --benchmark mode */
+        Containers::Optional<Benchmark> _benchmark;
         #endif
 
         DebugTools::FrameProfilerGL::Values _profilerValues;
@@ -350,9 +434,19 @@ Player::Player(const Arguments& arguments): Platform::ScreenedApplication{argume
         .addOption('I', "importer", "AnySceneImporter").setHelp("importer", "importer plugin to use")
         .addOption('i', "importer-options").setHelp("importer-options", "configuration options to pass to the importer", "key=val,key2=val2,…")
         #if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
-        .addBooleanOption("map").setHelp("map", "memory-map the input for zero-copy import (works only for standalone files)")
+        .addBooleanOption("map").setHelp("map", "memory-map the input and files it references for zero-copy import")
         #endif
-        .addOption("id").setHelp("id", "image or scene ID to import");
+        .addBooleanOption("mesh-cache").setHelp("mesh-cache", "cache processed meshes next to the file and use them on subsequent opens if the file didn't change")
+        .addBooleanOption("lod").setHelp("lod", "generate simplified levels of detail for heavy meshes using MeshOptimizerSceneConverter")
+        .addBooleanOption("optimize-meshes").setHelp("optimize-meshes", "reorder mesh indices and vertices for vertex cache and fetch efficiency using MeshOptimizerSceneConverter")
+        .addBooleanOption("quantize-meshes").setHelp("quantize-meshes", "pack normals, tangents, texture coordinates and positions into 8- and 16-bit vertex formats to save memory")
+        .addBooleanOption("light-culling").setHelp("light-culling", "shade each mesh only with lights whose range reaches its bounds")
+        .addBooleanOption("bake-animations").setHelp("bake-animations", "sample animation tracks at fixed intervals so seeking and playback don't need to search for keyframes")
+        .addBooleanOption("watch").setHelp("watch", "reload the file when it changes, keeping the view and reusing unchanged meshes and textures")
+        .addBooleanOption("stream-textures").setHelp("stream-textures", "show the scene with placeholder textures right away and load the real ones over the following frames")
+        .addOption("id").setHelp("id", "image or scene ID to import")
+        .addOption("benchmark", "0").setHelp("benchmark", "render given count of frames without vsync, print load and frame time statistics and exit", "N")
+        .addOption("benchmark-output").setHelp("benchmark-output", "save the benchmark statistics to a JSON file", "FILE");
     #endif
     args.addBooleanOption("no-merge-animations").setHelp("no-merge-animations", "don't merge glTF animations into a single clip")
         .addOption("msaa").setHelp("msaa", "MSAA level to use (if not set, defaults to 8x or 2x for HiDPI)", "N")
@@ -361,6 +455,9 @@ Player::Player(const Arguments& arguments): Platform::ScreenedApplication{argume
         .addBooleanOption("tweakable").setHelp("tweakable", "enable live source tweakability")
         #endif
         .addBooleanOption('v', "verbose").setHelp("verbose", "verbose output from importer plugins")
+        #ifndef MAGNUM_TARGET_GLES
+        .addBooleanOption("compress-textures").setHelp("compress-textures", "compress 8-bit RGB and RGBA scene textures to S3TC on upload to save GPU memory")
+        #endif
         .addSkippedPrefix("magnum", "engine-specific options")
         .setGlobalHelp(R"(Displays a 3D scene file provided on command line.
 
@@ -371,7 +468,12 @@ subgroups using a slash.
 
 The --profile option accepts a space-separated list of measured values.
 Available values are FrameTime, CpuDuration, GpuDuration, VertexFetchRatio and
-PrimitiveClipRatio.)")
+PrimitiveClipRatio.
+
+The --benchmark option plays the animation in a loop or, if there's none,
+orbits the camera around the scene origin for given count of frames. Then it
+prints mean and percentile frame time, CPU and GPU duration together with
+the time it took to open and load the file.)")
         .parse(arguments.argc, arguments.argv);
 
     /* Try 8x MSAA, fall back to zero samples if not possible. Enable only 2x
@@ -397,6 +499,19 @@ PrimitiveClipRatio.)")
     }
 
     _profilerValues = args.value<DebugTools::FrameProfilerGL::Values>("profile");
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    if(const UnsignedInt benchmarkFrameCount = args.value<UnsignedInt>("benchmark")) {
+        _benchmark.emplace(benchmarkFrameCount, args.value<Containers::StringView>("benchmark-output"));
+        #ifndef MAGNUM_TARGET_GLES
+        if(GL::Context::current().isExtensionSupported<GL::Extensions::ARB::timer_query>())
+        #else
+        if(GL::Context::current().isExtensionSupported<GL::Extensions::EXT::disjoint_timer_query>())
+        #endif
+        {
+            _benchmark->timeQueries = Containers::Array<GL::TimeQuery>{DirectInit, 3, GL::TimeQuery::Target::TimeElapsed};
+        } else Warning{} << "Timer queries not supported, GPU duration won't be measured";
+    }
+    #endif
 
     #ifdef CORRADE_IS_DEBUG_BUILD
     if(args.isSet("tweakable")) _tweakable.enable();
@@ -422,6 +537,10 @@ PrimitiveClipRatio.)")
         metadata->configuration().setValue("mergeAnimationClips",
             !args.isSet("no-merge-animations"));
     }
+    /* Decode EXR files on all cores instead of just one */
+    if(PluginManager::PluginMetadata* const metadata = _manager.metadata("OpenExrImporter")) {
+        metadata->configuration().setValue("threads", 0);
+    }
 
     /* Set Basis target format, but only if it wasn't forced on command line
        (which isn't possible on the web) */
@@ -548,38 +667,72 @@ PrimitiveClipRatio.)")
     /* Load file. If fails and this was not a custom importer, try loading it
        as an image instead */
     /** @todo redo once canOpen*() is implemented */
-    bool success;
-    if(args.isSet("map")) {
-        Containers::Optional<Containers::Array<const char, Utility::Path::MapDeleter>> maybeMapped;
-        success = importer && (maybeMapped = Utility::Path::mapRead(args.value("file"))) && importer->openMemory(*maybeMapped);
-        mapped = *Utility::move(maybeMapped);
-    } else {
-        success = importer && importer->openFile(_file);
-    }
-    if(success) {
+    #if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+    _map = args.isSet("map");
+    #endif
+    std::chrono::steady_clock::time_point openStart = std::chrono::steady_clock::now();
+    if(importer && openFile(*importer)) {
+        const std::chrono::steady_clock::time_point loadStart = std::chrono::steady_clock::now();
         /* If we passed a custom importer, try to figure out if it's an image
            or a scene */
         /** @todo ugh the importer should have an API for that */
         if(args.value("importer") != "AnySceneImporter" && !importer->objectCount() && !importer->meshCount() && importer->image2DCount() >= 1)
             _player = createImagePlayer(*this, _overlay->ui, _overlay->controls);
-        else
-            _player = createScenePlayer(*this, _overlay->ui, _overlay->controls, _profilerValues);
+        else {
+            ScenePlayerFlags flags;
+            #ifndef MAGNUM_TARGET_GLES
+            if(args.isSet("compress-textures"))
+                flags |= ScenePlayerFlag::CompressTextures;
+            #endif
+            if(args.isSet("mesh-cache"))
+                flags |= ScenePlayerFlag::MeshCache;
+            if(args.isSet("lod"))
+                flags |= ScenePlayerFlag::GenerateLods;
+            if(args.isSet("optimize-meshes"))
+                flags |= ScenePlayerFlag::OptimizeMeshes;
+            if(args.isSet("quantize-meshes"))
+                flags |= ScenePlayerFlag::QuantizeMeshes;
+            if(args.isSet("light-culling"))
+                flags |= ScenePlayerFlag::LightCulling;
+            if(args.isSet("bake-animations"))
+                flags |= ScenePlayerFlag::BakeAnimations;
+            if(args.isSet("watch"))
+                flags |= ScenePlayerFlag::IncrementalReload;
+            if(args.isSet("stream-textures"))
+                flags |= ScenePlayerFlag::StreamTextures;
+            _player = createScenePlayer(*this, _overlay->ui, _overlay->controls, _profilerValues, flags);
+        }
         _player->load(_file, *importer, _id);
         _importer = args.value("importer");
+        _sceneImporter = Utility::move(importer);
+        if(_benchmark) {
+            _benchmark->openDuration = milliseconds(loadStart - openStart);
+            _benchmark->loadDuration = milliseconds(std::chrono::steady_clock::now() - loadStart);
+        }
     } else if(args.value("importer") == "AnySceneImporter") {
         Debug{} << "Opening as a scene failed, trying as an image...";
         Containers::Pointer<Trade::AbstractImporter> imageImporter = _manager.loadAndInstantiate("AnyImageImporter");
         if(imageImporter) imageImporter->addFlags(_importerFlags);
+        openStart = std::chrono::steady_clock::now();
         if(imageImporter && imageImporter->openFile(_file)) {
             if(!imageImporter->image2DCount()) {
                 Error{} << "No 2D images found in the file";
                 std::exit(3);
             }
+            const std::chrono::steady_clock::time_point loadStart = std::chrono::steady_clock::now();
             _player = createImagePlayer(*this, _overlay->ui, _overlay->controls);
             _player->load(_file, *imageImporter, _id);
             _importer = "AnyImageImporter";
+            if(_benchmark) {
+                _benchmark->openDuration = milliseconds(loadStart - openStart);
+                _benchmark->loadDuration = milliseconds(std::chrono::steady_clock::now() - loadStart);
+            }
         } else std::exit(2);
     } else std::exit(1);
+
+    /* Only the top-level file is watched, not the files it references */
+    if((_watch = args.isSet("watch")))
+        _watchedModificationTime = fileModificationTime(_file);
     #else
     Containers::Pointer<Trade::AbstractImporter> importer =
         _manager.loadAndInstantiate("GltfImporter");
@@ -591,7 +744,9 @@ PrimitiveClipRatio.)")
     #endif
 
     #ifndef CORRADE_TARGET_EMSCRIPTEN
-    setSwapInterval(1);
+    /* Render as fast as possible when benchmarking */
+    setSwapInterval(_benchmark ? 0 : 1);
+    if(_benchmark) redraw();
     #endif
 
     #ifdef CORRADE_TARGET_EMSCRIPTEN
@@ -600,11 +755,105 @@ PrimitiveClipRatio.)")
 }
 
 #ifndef CORRADE_TARGET_EMSCRIPTEN
-void Player::reload() {
+bool Player::openFile(Trade::AbstractImporter& importer) {
+    #if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+    if(_map) {
+        /* Drop mappings from a previous open, if any, as the files might have
+           changed since */
+        _mappedFiles.clear();
+
+        /* Memory-map also files referenced from the top-level one, resolving
+           them relative to it as openMemory() has no notion of a base path.
+           Temporary files are unmapped once the importer closes them,
+           permanent ones stay mapped until the next open. */
+        importer.setFileCallback([](const std::string& filename,
+            InputFileCallbackPolicy policy, Player& player)
+                -> Containers::Optional<Containers::ArrayView<const char>>
+            {
+                auto found = player._mappedFiles.find(filename);
+                if(policy == InputFileCallbackPolicy::Close) {
+                    if(found != player._mappedFiles.end())
+                        player._mappedFiles.erase(found);
+                    return {};
+                }
+
+                if(found == player._mappedFiles.end()) {
+                    Containers::Optional<Containers::Array<const char, Utility::Path::MapDeleter>> file = Utility::Path::mapRead(Utility::Path::join(Utility::Path::split(player._file).first(), filename));
+                    if(!file) return {};
+                    found = player._mappedFiles.emplace(filename, *Utility::move(file)).first;
+                }
+                return Containers::ArrayView<const char>{found->second};
+            }, *this);
+
+        Containers::Optional<Containers::Array<const char, Utility::Path::MapDeleter>> maybeMapped = Utility::Path::mapRead(_file);
+        if(!maybeMapped || !importer.openMemory(*maybeMapped))
+            return false;
+        mapped = *Utility::move(maybeMapped);
+        return true;
+    }
+    #endif
+
+    return importer.openFile(_file);
+}
+
+void Player::printBenchmark() {
+    /* Collect the remaining in-flight GPU durations */
+    for(UnsignedInt i = _benchmark->frameCount > 2 ? _benchmark->frameCount - 2 : 0; i < _benchmark->frameCount && !_benchmark->timeQueries.isEmpty(); ++i)
+        arrayAppend(_benchmark->gpuDurations, _benchmark->timeQueries[i % _benchmark->timeQueries.size()].result<UnsignedLong>()/1.0e6);
+
+    const Percentiles frameTime = percentiles(_benchmark->frameTimes);
+    const Percentiles cpuDuration = percentiles(_benchmark->cpuDurations);
+    const Percentiles gpuDuration = percentiles(_benchmark->gpuDurations);
+
+    Debug{} << "Benchmark of" << _benchmark->frameCount << "frames:";
+    Debug{} << Utility::format("  Open: {:.2f} ms, load: {:.2f} ms", _benchmark->openDuration, _benchmark->loadDuration);
+    const Containers::StringView names[]{"Frame time"_s, "CPU duration"_s, "GPU duration"_s};
+    const Percentiles* values[]{&frameTime, &cpuDuration, &gpuDuration};
+    for(std::size_t i = 0; i != Containers::arraySize(values); ++i) {
+        if(i == 2 && _benchmark->gpuDurations.isEmpty()) continue;
+        Debug{} << Utility::format("  {}: mean {:.3f} ms, 50% {:.3f} ms, 90% {:.3f} ms, 99% {:.3f} ms, max {:.3f} ms", names[i], values[i]->mean, values[i]->p50, values[i]->p90, values[i]->p99, values[i]->max);
+    }
+
+    if(!_benchmark->output)
+        return;
+
+    const auto json = [](const Percentiles& values) {
+        return Utility::format(R"({{"mean": {}, "50": {}, "90": {}, "99": {}, "max": {}}})", values.mean, values.p50, values.p90, values.p99, values.max);
+    };
+    const Containers::String out = Utility::format(R"({{
+  "file": "{}",
+  "frames": {},
+  "open": {},
+  "load": {},
+  "frameTime": {},
+  "cpuDuration": {},
+  "gpuDuration": {}
+}}
+)", Utility::Path::split(_file).second(), _benchmark->frameCount,
+        _benchmark->openDuration, _benchmark->loadDuration,
+        json(frameTime), json(cpuDuration),
+        _benchmark->gpuDurations.isEmpty() ? Containers::String{"null"_s} : json(gpuDuration));
+    if(!Utility::Path::write(_benchmark->output, out))
+        Error{} << "Cannot write the benchmark output to" << _benchmark->output;
+    else
+        Debug{} << "Benchmark output saved to" << _benchmark->output;
+}
+
+void Player::reload(const bool incremental) {
+    /* Opening the file again drops the memory-mapped files the previous
+       importer may still be using, so it has to be released first */
+    _player->releaseImporter();
+    _sceneImporter = nullptr;
+
     Containers::Pointer<Trade::AbstractImporter> importer =
         _manager.loadAndInstantiate(_importer);
-    if(importer && importer->openFile(_file))
-        _player->load(_file, *importer, _id);
+    if(importer && openFile(*importer)) {
+        if(incremental)
+            _player->reload(_file, *importer, _id);
+        else
+            _player->load(_file, *importer, _id);
+        _sceneImporter = Utility::move(importer);
+    }
 }
 #endif
 
@@ -719,20 +968,86 @@ void Player::globalViewportEvent(ViewportEvent& event) {
     GL::defaultFramebuffer.setViewport({{}, event.framebufferSize()});
 }
 
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+void Player::globalBeforeDrawEvent() {
+    if(!_benchmark) return;
+
+    _player->benchmarkFrame(_benchmark->frame, _benchmark->frameCount);
+    _benchmark->frameStart = std::chrono::steady_clock::now();
+    if(!_benchmark->timeQueries.isEmpty())
+        _benchmark->timeQueries[_benchmark->frame % _benchmark->timeQueries.size()].begin();
+}
+#endif
+
 void Player::globalDrawEvent() {
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    if(_benchmark) {
+        arrayAppend(_benchmark->cpuDurations, milliseconds(std::chrono::steady_clock::now() - _benchmark->frameStart));
+
+        /* Read back a query from two frames ago, which is likely available
+           already, and can then be reused for the next frame */
+        if(!_benchmark->timeQueries.isEmpty()) {
+            const std::size_t count = _benchmark->timeQueries.size();
+            _benchmark->timeQueries[_benchmark->frame % count].end();
+            if(_benchmark->frame >= count - 1)
+                arrayAppend(_benchmark->gpuDurations, _benchmark->timeQueries[(_benchmark->frame + 1) % count].result<UnsignedLong>()/1.0e6);
+        }
+    }
+    #endif
+
     swapBuffers();
+
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    if(_benchmark) {
+        /* The first frame has no previous swap to measure against */
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if(_benchmark->frame)
+            arrayAppend(_benchmark->frameTimes, milliseconds(now - _benchmark->lastSwap));
+        _benchmark->lastSwap = now;
+
+        if(++_benchmark->frame == _benchmark->frameCount) {
+            printBenchmark();
+            exit();
+        } else redraw();
+    }
+    #endif
 }
 
-#if !defined(CORRADE_TARGET_EMSCRIPTEN) && defined(CORRADE_IS_DEBUG_BUILD)
+#ifndef CORRADE_TARGET_EMSCRIPTEN
 void Player::tickEvent() {
-    /* If tweakable is not enabled, call the base tick event implementation,
-       which effectively stops it from being called again */
-    if(!_tweakable.isEnabled()) {
+    #ifdef CORRADE_IS_DEBUG_BUILD
+    const bool tweakable = _tweakable.isEnabled();
+    #else
+    constexpr bool tweakable = false;
+    #endif
+
+    /* If neither tweakable nor file watching is enabled, call the base tick
+       event implementation, which effectively stops it from being called
+       again */
+    if(!tweakable && !_watch) {
         Platform::ScreenedApplication::tickEvent();
         return;
     }
 
-    _tweakable.update();
+    #ifdef CORRADE_IS_DEBUG_BUILD
+    if(tweakable)
+        _tweakable.update();
+    #endif
+
+    /* Check for file changes at most twice a second. If the file is
+       currently being written, the import may fail, in which case it gets
+       retried on the next change. */
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if(_watch && now - _watchLastCheck >= std::chrono::milliseconds{500}) {
+        _watchLastCheck = now;
+        const Long modificationTime = fileModificationTime(_file);
+        if(modificationTime != -1 && modificationTime != _watchedModificationTime) {
+            _watchedModificationTime = modificationTime;
+            Debug{} << "File" << _file << "changed, reloading";
+            reload(true);
+            redraw();
+        }
+    }
 }
 #endif
 
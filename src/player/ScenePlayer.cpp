@@ -36,6 +36,7 @@
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Containers/Triple.h>
 #include <Corrade/PluginManager/Manager.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/Arguments.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Format.h>
@@ -47,6 +48,7 @@
 #include <Magnum/Animation/Player.h>
 #include <Magnum/DebugTools/ColorMap.h>
 #include <Magnum/DebugTools/FrameProfiler.h>
+#include <Magnum/GL/BufferImage.h>
 #include <Magnum/GL/Context.h>
 #include <Magnum/GL/DefaultFramebuffer.h>
 #include <Magnum/GL/Extensions.h>
@@ -59,10 +61,17 @@
 #include <Magnum/GL/Texture.h>
 #include <Magnum/GL/TextureFormat.h>
 #include <Magnum/Math/CubicHermite.h>
+#include <Magnum/Math/Frustum.h>
 #include <Magnum/Math/FunctionsBatch.h>
+#include <Magnum/Math/Intersection.h>
+#include <Magnum/Math/PackingBatch.h>
+#include <Magnum/Math/Range.h>
 #include <Magnum/Math/Swizzle.h>
 #include <Magnum/MeshTools/Compile.h>
+#include <Magnum/MeshTools/Duplicate.h>
 #include <Magnum/MeshTools/GenerateIndices.h>
+#include <Magnum/MeshTools/GenerateNormals.h>
+#include <Magnum/MeshTools/Interleave.h>
 #include <Magnum/MeshTools/Transform.h>
 #include <Magnum/Primitives/Axis.h>
 #include <Magnum/Primitives/Crosshair.h>
@@ -79,6 +88,7 @@
 #include <Magnum/Shaders/MeshVisualizerGL.h>
 #include <Magnum/Text/Alignment.h>
 #include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/AbstractSceneConverter.h>
 #include <Magnum/Trade/AnimationData.h>
 #include <Magnum/Trade/CameraData.h>
 #include <Magnum/Trade/ImageData.h>
@@ -114,6 +124,9 @@
 
 #include "AbstractPlayer.h"
 #include "LoadImage.h"
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+#include "MeshCache.h"
+#endif
 
 #ifdef CORRADE_IS_DEBUG_BUILD
 #include <Corrade/Utility/Tweakable.h>
@@ -169,8 +182,35 @@ constexpr const Vector2 ControlSize{56.0f, WidgetHeight};
 constexpr const Vector2 HalfControlSize{28.0f, WidgetHeight};
 constexpr const Vector2 LabelSize{72.0f, LabelHeight};
 
+/* A simplified variant of a mesh, ordered from the most detailed */
+struct MeshLod {
+    GL::Mesh mesh{NoCreate};
+    UnsignedInt primitives;
+};
+
+enum class Visualization: UnsignedByte {
+    Begin = 0,
+    Wireframe = 0,
+    #ifndef MAGNUM_TARGET_GLES
+    WireframeTbn,
+    #endif
+    WireframeObjectId,
+    WireframeVertexId,
+    #ifndef MAGNUM_TARGET_GLES
+    WireframePrimitiveId,
+    #endif
+    ObjectId,
+    VertexId,
+    #ifndef MAGNUM_TARGET_GLES
+    PrimitiveId,
+    #endif
+    End
+};
+
 struct MeshInfo {
     Containers::Optional<GL::Mesh> mesh;
+    /* Generated only with ScenePlayerFlag::GenerateLods, empty otherwise */
+    Containers::Array<MeshLod> lods;
     UnsignedInt attributes;
     UnsignedInt vertices;
     UnsignedInt primitives;
@@ -178,7 +218,23 @@ struct MeshInfo {
     UnsignedInt perVertexJointCount, secondaryPerVertexJointCount;
     std::size_t size;
     Containers::String name;
+    /* Bounding box of vertex positions used for frustum culling, NullOpt if
+       the mesh has no positions */
+    Containers::Optional<Range3D> bounds;
+    /* Hash of the processed data, for detecting duplicates and unchanged
+       meshes on reload */
+    UnsignedLong hash;
+    /* Average cache miss ratio before and after the optimization with
+       ScenePlayerFlag::OptimizeMeshes, zero if the mesh wasn't optimized */
+    Float acmr, optimizedAcmr;
+    /* Transformation from quantized positions to the original space with
+       ScenePlayerFlag::QuantizeMeshes, identity otherwise */
+    Matrix4 dequantization;
     bool hasTangents, hasSeparateBitangents;
+    /* Mesh visualizer shader resolved for each visualization, filled lazily
+       by meshVisualizerShader(std::size_t, bool) on first use. Second index
+       is whether the shader is the skinned variant. */
+    Shaders::MeshVisualizerGL3D* visualizerShaders[UnsignedByte(Visualization::End)][2]{};
 };
 
 struct LightInfo {
@@ -199,10 +255,74 @@ struct ObjectInfo {
 
 class MeshVisualizerDrawable;
 
+/* Joint matrices uploaded to given shader since the start of the current
+   frame, to not upload the same matrices again for every drawable sharing
+   both the shader and the skin */
+typedef Containers::Array<Containers::Pair<const GL::AbstractShaderProgram*, Containers::ArrayView<const Matrix4>>> JointMatrixUploads;
+
+/* Light properties for picking just the lights that affect given drawable
+   with ScenePlayerFlag::LightCulling */
+struct LightCulling {
+    /* Camera-relative, updated every frame */
+    Containers::ArrayView<const Vector4> positions;
+    /* Colors with brightness applied */
+    Containers::Array<Color3> colors;
+    Containers::Array<Float> ranges;
+    /* Lights affecting the currently drawn mesh, reused across draws to avoid
+       allocations */
+    Containers::Array<Vector4> culledPositions;
+    Containers::Array<Color3> culledColors;
+    Containers::Array<Float> culledRanges;
+};
+
+/* Animation track sampled at fixed intervals with
+   ScenePlayerFlag::BakeAnimations */
+struct BakedAnimationTrack {
+    Object3D* object;
+    Trade::AnimationTrackTarget target;
+    /* Offset of the first sample in BakedAnimation::vectors or rotations */
+    std::size_t offset;
+    /* Last applied value, to update the object only if it changed */
+    Vector3 vector{Constants::nan()};
+    Quaternion rotation{Vector3{Constants::nan()}, Constants::nan()};
+};
+
+struct BakedAnimation {
+    Float begin, rate;
+    /* At least two for every track */
+    UnsignedInt sampleCount;
+    Containers::Array<BakedAnimationTrack> tracks;
+    Containers::Array<Vector3> vectors;
+    Containers::Array<Quaternion> rotations;
+    /* Track that's put into the player instead of the original ones, its
+       value is the animation time */
+    std::pair<Float, Float> timeData[2];
+    Float time{Constants::nan()};
+};
+
+/* Duration and imported data size of a section of ScenePlayer::load() */
+struct LoadSection {
+    Containers::StringView name;
+    std::chrono::steady_clock::duration duration;
+    std::size_t size;
+};
+
 struct Data {
     Containers::Array<MeshInfo> meshes;
     Containers::Array<LightInfo> lights;
     Containers::Array<Containers::Optional<GL::Texture2D>> textures;
+    /* Hash of the image data and sampler properties for each texture with
+       ScenePlayerFlag::IncrementalReload, zero otherwise */
+    Containers::Array<UnsignedLong> textureHashes;
+    /* With ScenePlayerFlag::StreamTextures, the importer to decode the
+       remaining images from and pairs of image and texture IDs sorted by the
+       image, with streamedTextureImageOffset being the first pair that's not
+       uploaded yet. Until then the textures contain just a placeholder. The
+       importer is null once everything is streamed or when it went away. */
+    Trade::AbstractImporter* streamingImporter{};
+    Containers::Array<Containers::Pair<UnsignedInt, UnsignedInt>> streamedTextureImages;
+    Containers::Array<Containers::Optional<Trade::TextureData>> streamedTextures;
+    std::size_t streamedTextureImageOffset{};
 
     Scene3D scene;
     Object3D* cameraObject{};
@@ -214,47 +334,63 @@ struct Data {
     SceneGraph::DrawableGroup3D opaqueDrawables, transparentDrawables,
         selectedObjectDrawables, objectVisualizationDrawables, lightDrawables,
         jointDrawables;
+    /* Transparent drawables with their camera-relative transformations in
+       the order they were drawn last time, reused across frames to avoid
+       allocations and a full sort, see drawTransparentDrawables() */
+    std::vector<std::pair<std::reference_wrapper<SceneGraph::Drawable3D>, Matrix4>> transparentDrawableTransformations;
     Vector3 previousPosition;
 
+    /* All objects in the scene sorted so parents are before their children,
+       together with an index of the parent in this array or 0xffffffffu for
+       objects directly in the scene root. Absolute transformations of these
+       are recalculated in updateTransformations() only for objects marked as
+       dirty by SceneGraph and then reused by all drawable group passes in the
+       frame instead of each pass traversing the hierarchy again. See
+       setupTransformations(). */
+    Containers::Array<Containers::Pair<Object3D*, UnsignedInt>> transformationObjects;
+    Containers::Array<Matrix4> absoluteTransformations;
+    /* Indices into absoluteTransformations for each drawable in given group,
+       in the order in which they are in the group. The transparent ones are
+       permuted together with transparentDrawableTransformations. */
+    Containers::Array<UnsignedInt> lightDrawableTransformations,
+        jointDrawableTransformations, opaqueDrawableTransformations,
+        transparentDrawableTransformationIds,
+        objectVisualizationDrawableTransformations;
+    /* Reused across passes and frames to avoid allocations */
+    std::vector<std::pair<std::reference_wrapper<SceneGraph::Drawable3D>, Matrix4>> drawableTransformations;
+    std::vector<std::reference_wrapper<Object3D>> dirtyObjects;
+
     Containers::Array<ObjectInfo> objects;
     bool visualizeObjects = false;
     MeshVisualizerDrawable* selectedObject{};
 
     Containers::Array<char> animationData;
     Animation::Player<std::chrono::nanoseconds, Float> player;
+    /* Last values of animated translation / scaling and rotation tracks,
+       indexed by track ID, to update object transformations only if the
+       value actually changed */
+    Containers::Array<Vector3> animatedVectors;
+    Containers::Array<Quaternion> animatedRotations;
+    /* With ScenePlayerFlag::BakeAnimations the animation is driven from here
+       instead */
+    BakedAnimation bakedAnimation;
 
     UnsignedInt lightCount{};
     UnsignedInt maxJointCount{};
     Containers::Array<Vector4> lightPositions;
     Containers::Array<Color3> lightColors;
+    LightCulling lightCulling;
 
     Containers::Array<Matrix4> skinJointMatrices;
+    /* Reset every time skinJointMatrices get recalculated */
+    JointMatrixUploads jointMatrixUploads;
 
     Int elapsedTimeAnimationDestination = -1; /* So it gets updated with 0 as well */
 };
 
-enum class Visualization: UnsignedByte {
-    Begin = 0,
-    Wireframe = 0,
-    #ifndef MAGNUM_TARGET_GLES
-    WireframeTbn,
-    #endif
-    WireframeObjectId,
-    WireframeVertexId,
-    #ifndef MAGNUM_TARGET_GLES
-    WireframePrimitiveId,
-    #endif
-    ObjectId,
-    VertexId,
-    #ifndef MAGNUM_TARGET_GLES
-    PrimitiveId,
-    #endif
-    End
-};
-
 class ScenePlayer: public AbstractPlayer {
     public:
-        explicit ScenePlayer(Platform::ScreenedApplication& application, Ui::UserInterface& ui, Ui::NodeHandle controls, const DebugTools::FrameProfilerGL::Values profilerValues);
+        explicit ScenePlayer(Platform::ScreenedApplication& application, Ui::UserInterface& ui, Ui::NodeHandle controls, const DebugTools::FrameProfilerGL::Values profilerValues, ScenePlayerFlags flags);
 
     private:
         void drawEvent() override;
@@ -266,6 +402,16 @@ class ScenePlayer: public AbstractPlayer {
         void scrollEvent(ScrollEvent& event) override;
 
         void load(Containers::StringView filename, Trade::AbstractImporter& importer, Int id) override;
+        void reload(Containers::StringView filename, Trade::AbstractImporter& importer, Int id) override;
+        void releaseImporter() override;
+        /* If previous is set, GL meshes and textures with matching hashes are
+           taken from it instead of being compiled and uploaded again, and the
+           camera is kept where it was */
+        void loadInternal(Containers::StringView filename, Trade::AbstractImporter& importer, Int id, Containers::Pointer<Data> previous);
+        void benchmarkFrame(UnsignedInt frame, UnsignedInt frameCount) override;
+        /* Decodes the next image with ScenePlayerFlag::StreamTextures and
+           uploads it to all textures that use it */
+        void streamTexture();
 
         Shaders::MeshVisualizerGL3D::Flags setupVisualization(std::size_t meshId);
 
@@ -276,12 +422,23 @@ class ScenePlayer: public AbstractPlayer {
         void updateAnimationTime(Int deciseconds);
         void updateLightColorBrightness();
 
+        void selectObject(UnsignedInt selectedId);
+
         Float depthAt(const Vector2& windowPosition);
         Vector3 unproject(const Vector2& windowPosition, Float depth) const;
 
         Shaders::FlatGL3D& flatShader(Shaders::FlatGL3D::Flags flags);
         Shaders::PhongGL& phongShader(Shaders::PhongGL::Flags flags);
         Shaders::MeshVisualizerGL3D& meshVisualizerShader(Shaders::MeshVisualizerGL3D::Flags flags);
+        /* Calls setupVisualization() and returns a shader for the resulting
+           visualization, cached in MeshInfo::visualizerShaders */
+        Shaders::MeshVisualizerGL3D& meshVisualizerShader(std::size_t meshId, bool skinned);
+        Shaders::MeshVisualizerGL3D::Configuration meshVisualizerShaderConfiguration(Shaders::MeshVisualizerGL3D::Flags flags) const;
+        Shaders::MeshVisualizerGL3D& addMeshVisualizerShader(Shaders::MeshVisualizerGL3D::Flags flags, Shaders::MeshVisualizerGL3D&& shader);
+        /* Compiles all mesh visualizer variants the selection can need for
+           the currently loaded scene so selecting objects and cycling
+           through visualizations doesn't stall */
+        void precompileMeshVisualizerShaders();
 
         /* Global rendering stuff */
         /* Indexed by Shaders::FlatGL3D::Flags, PhongGL::Flags or
@@ -303,7 +460,7 @@ class ScenePlayer: public AbstractPlayer {
         Visualization _visualization = Visualization::Wireframe;
 
         /* Data loading */
-        Containers::Optional<Data> _data;
+        Containers::Pointer<Data> _data;
 
         /* UI. What's just a NodeHandle only needs to be hidden / disabled,
            don't need a whole widget for that. */
@@ -335,6 +492,12 @@ class ScenePlayer: public AbstractPlayer {
         /* Offscreen framebuffer with object ID attachment */
         GL::Renderbuffer _selectionDepth, _selectionObjectId;
         GL::Framebuffer _selectionFramebuffer{NoCreate};
+        #if !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+        /* Object ID readback and the count of frames left until it's
+           resolved in drawEvent(), 0 if there's none pending */
+        GL::BufferImage2D _selectionReadback{PixelFormat::R16UI};
+        UnsignedInt _selectionReadbackFrames{};
+        #endif
 
         /* Mouse interaction */
         Float _lastDepth;
@@ -349,6 +512,9 @@ class ScenePlayer: public AbstractPlayer {
         DepthReinterpretShader _reinterpretShader{NoCreate};
         #endif
 
+        ScenePlayerFlags _flags;
+        ImageUploadBuffers _imageUploadBuffers;
+
         /* Profiling */
         DebugTools::FrameProfilerGL _profiler;
         Debug _profilerOut{Debug::Flag::NoNewlineAtTheEnd|
@@ -359,6 +525,36 @@ class FlatDrawable: public SceneGraph::Drawable3D {
     public:
         explicit FlatDrawable(Object3D& object, Shaders::FlatGL3D& shader, GL::Mesh& mesh, UnsignedInt objectId, const Color4& color, const Vector3& scale, Containers::ArrayView<const Matrix4> jointMatrices, UnsignedInt perVertexJointCount, UnsignedInt secondaryPerVertexJointCount, SceneGraph::DrawableGroup3D& group): SceneGraph::Drawable3D{object, &group}, _shader(shader), _mesh(mesh), _objectId{objectId}, _color{color}, _scale{scale}, _jointMatrices{jointMatrices}, _perVertexJointCount{perVertexJointCount}, _secondaryPerVertexJointCount{secondaryPerVertexJointCount} {}
 
+        /* If set, the drawable is skipped if the bounds are outside of
+           the camera frustum. Ignored for skinned meshes. */
+        FlatDrawable& setCullingBounds(const Containers::Optional<Range3D>& bounds) {
+            _cullingBounds = bounds;
+            return *this;
+        }
+
+        /* If set, a simplified mesh is drawn instead when the object gets
+           small on the screen. Used only together with culling bounds and
+           ignored for skinned meshes. */
+        FlatDrawable& setLods(Containers::ArrayView<MeshLod> lods) {
+            _lods = lods;
+            return *this;
+        }
+
+        /* If set, joint matrices are uploaded only if they weren't uploaded
+           to the same shader already in this frame */
+        FlatDrawable& setJointMatrixUploads(JointMatrixUploads& uploads) {
+            _jointMatrixUploads = &uploads;
+            return *this;
+        }
+
+        /* Applied to the transformation passed to the shader if the mesh has
+           quantized positions. Culling bounds and LODs are in the original
+           space and thus use the transformation without it. */
+        FlatDrawable& setDequantization(const Matrix4& dequantization) {
+            _dequantization = dequantization;
+            return *this;
+        }
+
     private:
         void draw(const Matrix4& transformationMatrix, SceneGraph::Camera3D& camera) override;
 
@@ -367,6 +563,10 @@ class FlatDrawable: public SceneGraph::Drawable3D {
         UnsignedInt _objectId;
         Color4 _color;
         Vector3 _scale;
+        Containers::Optional<Range3D> _cullingBounds;
+        Containers::ArrayView<MeshLod> _lods;
+        JointMatrixUploads* _jointMatrixUploads{};
+        Matrix4 _dequantization;
         Containers::ArrayView<const Matrix4> _jointMatrices;
         UnsignedInt _perVertexJointCount,
             #ifdef MAGNUM_TARGET_WEBGL
@@ -381,6 +581,38 @@ class PhongDrawable: public SceneGraph::Drawable3D {
 
         explicit PhongDrawable(Object3D& object, Shaders::PhongGL& shader, GL::Mesh& mesh, UnsignedInt objectId, const Color4& color, Containers::ArrayView<const Matrix4> jointMatrices, UnsignedInt perVertexJointCount, UnsignedInt secondaryPerVertexJointCount, const bool& shadeless, SceneGraph::DrawableGroup3D& group): SceneGraph::Drawable3D{object, &group}, _shader(shader), _mesh(mesh), _objectId{objectId}, _color{color}, _diffuseTexture{nullptr}, _normalTexture{nullptr}, _alphaMask{0.5f}, _jointMatrices{jointMatrices}, _perVertexJointCount{perVertexJointCount}, _secondaryPerVertexJointCount{secondaryPerVertexJointCount}, _shadeless{shadeless} {}
 
+        /* Same as FlatDrawable::setCullingBounds() */
+        PhongDrawable& setCullingBounds(const Containers::Optional<Range3D>& bounds) {
+            _cullingBounds = bounds;
+            return *this;
+        }
+
+        /* Same as FlatDrawable::setLods() */
+        PhongDrawable& setLods(Containers::ArrayView<MeshLod> lods) {
+            _lods = lods;
+            return *this;
+        }
+
+        /* Same as FlatDrawable::setJointMatrixUploads() */
+        PhongDrawable& setJointMatrixUploads(JointMatrixUploads& uploads) {
+            _jointMatrixUploads = &uploads;
+            return *this;
+        }
+
+        /* Same as FlatDrawable::setDequantization() */
+        PhongDrawable& setDequantization(const Matrix4& dequantization) {
+            _dequantization = dequantization;
+            return *this;
+        }
+
+        /* If set, only lights with range reaching the culling bounds are
+           uploaded and used for the draw. Skinned meshes and meshes without
+           culling bounds use all lights. */
+        PhongDrawable& setLightCulling(LightCulling* culling) {
+            _lightCulling = culling;
+            return *this;
+        }
+
     private:
         void draw(const Matrix4& transformationMatrix, SceneGraph::Camera3D& camera) override;
 
@@ -388,6 +620,11 @@ class PhongDrawable: public SceneGraph::Drawable3D {
         GL::Mesh& _mesh;
         UnsignedInt _objectId;
         Color4 _color;
+        Containers::Optional<Range3D> _cullingBounds;
+        Containers::ArrayView<MeshLod> _lods;
+        JointMatrixUploads* _jointMatrixUploads{};
+        Matrix4 _dequantization;
+        LightCulling* _lightCulling{};
         GL::Texture2D* _diffuseTexture;
         GL::Texture2D* _normalTexture;
         Float _normalTextureScale;
@@ -421,12 +658,19 @@ class MeshVisualizerDrawable: public SceneGraph::Drawable3D {
         std::size_t meshId() const { return _meshId; }
         std::size_t jointCount() const { return _jointMatrices.size(); }
 
+        /* Same as FlatDrawable::setDequantization() */
+        MeshVisualizerDrawable& setDequantization(const Matrix4& dequantization) {
+            _dequantization = dequantization;
+            return *this;
+        }
+
     private:
         void draw(const Matrix4& transformationMatrix, SceneGraph::Camera3D& camera) override;
 
         Containers::Reference<Shaders::MeshVisualizerGL3D> _shader;
         GL::Mesh& _mesh;
         std::size_t _meshId;
+        Matrix4 _dequantization;
         UnsignedInt _objectIdCount, _vertexCount;
         #ifndef MAGNUM_TARGET_GLES
         UnsignedInt _primitiveCount;
@@ -475,7 +719,7 @@ class JointDrawable: public SceneGraph::Drawable3D {
         Matrix4& _jointMatrix;
 };
 
-ScenePlayer::ScenePlayer(Platform::ScreenedApplication& application, Ui::UserInterface& ui, Ui::NodeHandle controls, DebugTools::FrameProfilerGL::Values profilerValues):
+ScenePlayer::ScenePlayer(Platform::ScreenedApplication& application, Ui::UserInterface& ui, Ui::NodeHandle controls, DebugTools::FrameProfilerGL::Values profilerValues, const ScenePlayerFlags flags):
     AbstractPlayer{application, PropagatedEvent::Draw|PropagatedEvent::Input},
     _ui(ui),
     _screen{Ui::snap(ui, Ui::Snap::Fill|Ui::Snap::NoPad, controls, {})},
@@ -557,8 +801,7 @@ ScenePlayer::ScenePlayer(Platform::ScreenedApplication& application, Ui::UserInt
         /* Advance through the options */
         _visualization = Visualization(UnsignedByte(_visualization) + 1);
 
-        Shaders::MeshVisualizerGL3D::Flags flags = setupVisualization( _data->selectedObject->meshId())|(_data->selectedObject->jointCount() ? Shaders::MeshVisualizerGL3D::Flag::DynamicPerVertexJointCount : Shaders::MeshVisualizerGL3D::Flags{});
-        _data->selectedObject->setShader(meshVisualizerShader(flags));
+        _data->selectedObject->setShader(meshVisualizerShader(_data->selectedObject->meshId(), _data->selectedObject->jointCount() != 0));
     });
 
     /* Connect animation controls */
@@ -637,6 +880,8 @@ ScenePlayer::ScenePlayer(Platform::ScreenedApplication& application, Ui::UserInt
     }
     #endif
 
+    _flags = flags;
+
     /* Disable profiler by default */
     _profiler = DebugTools::FrameProfilerGL{profilerValues, 50};
     _profiler.disable();
@@ -706,49 +951,124 @@ Shaders::PhongGL& ScenePlayer::phongShader(Shaders::PhongGL::Flags flags) {
     return found->second;
 }
 
+Shaders::MeshVisualizerGL3D::Configuration ScenePlayer::meshVisualizerShaderConfiguration(Shaders::MeshVisualizerGL3D::Flags flags) const {
+    Shaders::MeshVisualizerGL3D::Configuration configuration;
+    configuration
+        .setFlags(flags);
+    /* To avoid too many variants there's just one skinned version of the
+       shader with the static joint and per-vertex joint count as high as
+       needed, and only a subset is used for each draw. The code requests a
+       skinned version of the shader with the DynamicPerVertexJointCount
+       flag. */
+    if(flags & Shaders::MeshVisualizerGL3D::Flag::DynamicPerVertexJointCount)
+        configuration.setJointCount(_data->maxJointCount, 4,
+            /* See flatShader() above for details */
+            #ifndef MAGNUM_TARGET_WEBGL
+            4
+            #else
+            0
+            #endif
+        );
+    return configuration;
+}
+
+Shaders::MeshVisualizerGL3D& ScenePlayer::addMeshVisualizerShader(Shaders::MeshVisualizerGL3D::Flags flags, Shaders::MeshVisualizerGL3D&& shader) {
+    Shaders::MeshVisualizerGL3D& out = _meshVisualizerShaders.emplace(enumCastUnderlyingType(flags), Utility::move(shader)).first->second;
+
+    out.setViewportSize(Vector2{application().framebufferSize()});
+    if(flags & Shaders::MeshVisualizerGL3D::Flag::Wireframe)
+        out.setWireframeColor(_(0xdcdcdcff_rgbaf));
+    #ifndef MAGNUM_TARGET_GLES
+    if(flags & Shaders::MeshVisualizerGL3D::Flag::NormalDirection)
+        out
+            .setLineLength(_lineLength)
+            .setLineWidth(2.0f);
+    #endif
+
+    if(flags & (Shaders::MeshVisualizerGL3D::Flag::InstancedObjectId|
+        Shaders::MeshVisualizerGL3D::Flag::VertexId
+        #ifndef MAGNUM_TARGET_GLES
+        |Shaders::MeshVisualizerGL3D::Flag::PrimitiveId
+        #endif
+    ))
+        out.bindColorMapTexture(_colorMapTexture);
+
+    return out;
+}
+
 Shaders::MeshVisualizerGL3D& ScenePlayer::meshVisualizerShader(Shaders::MeshVisualizerGL3D::Flags flags) {
     auto found = _meshVisualizerShaders.find(enumCastUnderlyingType(flags));
-    if(found == _meshVisualizerShaders.end()) {
-        Shaders::MeshVisualizerGL3D::Configuration configuration;
-        configuration
-            .setFlags(flags);
-        /* To avoid too many variants there's just one skinned version of the
-           shader with the static joint and per-vertex joint count as high as
-           needed, and only a subset is used for each draw. The code requests a
-           skinned version of the shader with the DynamicPerVertexJointCount
-           flag. */
-        if(flags & Shaders::MeshVisualizerGL3D::Flag::DynamicPerVertexJointCount)
-            configuration.setJointCount(_data->maxJointCount, 4,
-                /* See flatShader() above for details */
-                #ifndef MAGNUM_TARGET_WEBGL
-                4
-                #else
-                0
-                #endif
-            );
-        found = _meshVisualizerShaders.emplace(enumCastUnderlyingType(flags),
-            Shaders::MeshVisualizerGL3D{configuration}).first;
+    if(found == _meshVisualizerShaders.end())
+        return addMeshVisualizerShader(flags, Shaders::MeshVisualizerGL3D{meshVisualizerShaderConfiguration(flags)});
+    return found->second;
+}
 
-        found->second
-            .setViewportSize(Vector2{application().framebufferSize()});
-        if(flags & Shaders::MeshVisualizerGL3D::Flag::Wireframe)
-            found->second.setWireframeColor(_(0xdcdcdcff_rgbaf));
+Shaders::MeshVisualizerGL3D& ScenePlayer::meshVisualizerShader(const std::size_t meshId, const bool skinned) {
+    /* Resolve the visualization first, as it may skip modes the mesh can't
+       use and it updates the button label */
+    const Shaders::MeshVisualizerGL3D::Flags flags = setupVisualization(meshId);
+
+    /* Cycling through the visualizations then only goes through the shader
+       map once for each mode, further cycles reuse what's cached */
+    Shaders::MeshVisualizerGL3D*& shader = _data->meshes[meshId].visualizerShaders[UnsignedByte(_visualization)][skinned];
+    if(!shader)
+        shader = &meshVisualizerShader(flags|(skinned ? Shaders::MeshVisualizerGL3D::Flag::DynamicPerVertexJointCount : Shaders::MeshVisualizerGL3D::Flags{}));
+    return *shader;
+}
+
+void ScenePlayer::precompileMeshVisualizerShaders() {
+    /* Gather which visualizations the meshes in the scene can use, the same
+       way as setupVisualization() decides */
+    bool hasObjectIds = false;
+    #ifndef MAGNUM_TARGET_GLES
+    bool hasSeparateBitangents = false;
+    bool hasBitangentsFromTangents = false;
+    #endif
+    for(const MeshInfo& info: _data->meshes) {
+        if(!info.mesh) continue;
+        if(info.objectIdCount) hasObjectIds = true;
         #ifndef MAGNUM_TARGET_GLES
-        if(flags & Shaders::MeshVisualizerGL3D::Flag::NormalDirection)
-            found->second
-                .setLineLength(_lineLength)
-                .setLineWidth(2.0f);
+        if(info.primitives < 100000)
+            (info.hasSeparateBitangents ? hasSeparateBitangents : hasBitangentsFromTangents) = true;
         #endif
-
-        if(flags & (Shaders::MeshVisualizerGL3D::Flag::InstancedObjectId|
-            Shaders::MeshVisualizerGL3D::Flag::VertexId
-            #ifndef MAGNUM_TARGET_GLES
-            |Shaders::MeshVisualizerGL3D::Flag::PrimitiveId
-            #endif
-        ))
-            found->second.bindColorMapTexture(_colorMapTexture);
     }
-    return found->second;
+
+    Containers::Array<Shaders::MeshVisualizerGL3D::Flags> variants;
+    arrayAppend(variants, {
+        Shaders::MeshVisualizerGL3D::Flags{Shaders::MeshVisualizerGL3D::Flag::Wireframe},
+        Shaders::MeshVisualizerGL3D::Flag::Wireframe|Shaders::MeshVisualizerGL3D::Flag::VertexId,
+        Shaders::MeshVisualizerGL3D::Flags{Shaders::MeshVisualizerGL3D::Flag::VertexId},
+        #ifndef MAGNUM_TARGET_GLES
+        Shaders::MeshVisualizerGL3D::Flag::Wireframe|Shaders::MeshVisualizerGL3D::Flag::PrimitiveId,
+        Shaders::MeshVisualizerGL3D::Flags{Shaders::MeshVisualizerGL3D::Flag::PrimitiveId},
+        #endif
+    });
+    if(hasObjectIds) arrayAppend(variants, {
+        Shaders::MeshVisualizerGL3D::Flag::Wireframe|Shaders::MeshVisualizerGL3D::Flag::InstancedObjectId,
+        Shaders::MeshVisualizerGL3D::Flags{Shaders::MeshVisualizerGL3D::Flag::InstancedObjectId}
+    });
+    #ifndef MAGNUM_TARGET_GLES
+    const Shaders::MeshVisualizerGL3D::Flags tbn =
+        Shaders::MeshVisualizerGL3D::Flag::Wireframe|
+        Shaders::MeshVisualizerGL3D::Flag::TangentDirection|
+        Shaders::MeshVisualizerGL3D::Flag::NormalDirection;
+    if(hasSeparateBitangents)
+        arrayAppend(variants, tbn|Shaders::MeshVisualizerGL3D::Flag::BitangentDirection);
+    if(hasBitangentsFromTangents)
+        arrayAppend(variants, tbn|Shaders::MeshVisualizerGL3D::Flag::BitangentFromTangentDirection);
+    #endif
+    if(_data->maxJointCount) for(std::size_t i = 0, size = variants.size(); i != size; ++i)
+        arrayAppend(variants, variants[i]|Shaders::MeshVisualizerGL3D::Flag::DynamicPerVertexJointCount);
+
+    /* Submit all variants that aren't created yet for compilation first and
+       only then wait for each, so they can be compiled in parallel if
+       KHR_parallel_shader_compile is supported */
+    Containers::Array<Containers::Pair<Shaders::MeshVisualizerGL3D::Flags, Shaders::MeshVisualizerGL3D::CompileState>> states;
+    for(const Shaders::MeshVisualizerGL3D::Flags flags: variants)
+        if(_meshVisualizerShaders.find(enumCastUnderlyingType(flags)) == _meshVisualizerShaders.end())
+            arrayAppend(states, InPlaceInit, flags, Shaders::MeshVisualizerGL3D::compile(meshVisualizerShaderConfiguration(flags)));
+    for(Containers::Pair<Shaders::MeshVisualizerGL3D::Flags, Shaders::MeshVisualizerGL3D::CompileState>& state: states)
+        addMeshVisualizerShader(state.first(), Shaders::MeshVisualizerGL3D{Utility::move(state.second())});
 }
 
 Shaders::MeshVisualizerGL3D::Flags ScenePlayer::setupVisualization(std::size_t meshId) {
@@ -888,18 +1208,372 @@ void ScenePlayer::updateLightColorBrightness() {
         lightColorsBrightness[i] = _data->lightColors[i]*_brightness;
     for(auto& shader: _phongShaders)
         shader.second.setLightColors(lightColorsBrightness);
+    _data->lightCulling.colors = Utility::move(lightColorsBrightness);
+}
+
+namespace {
+
+/* Average cache miss ratio, i.e. the count of vertex shader invocations per
+   triangle, simulated with a FIFO post-transform vertex cache of 16 entries.
+   The best achievable value is around 0.5, 3 means the cache isn't used at
+   all. */
+Float averageCacheMissRatio(const Containers::ArrayView<const UnsignedInt> indices, const UnsignedInt vertexCount) {
+    constexpr UnsignedInt CacheSize = 16;
+    if(indices.size() < 3)
+        return 0.0f;
+
+    /* A vertex is in the cache if it was added at most CacheSize misses
+       ago. The timestamps start at zero so the first use of each vertex is
+       always a miss. */
+    Containers::Array<UnsignedInt> timestamps{ValueInit, vertexCount};
+    UnsignedInt timestamp = CacheSize + 1;
+    for(const UnsignedInt index: indices)
+        if(timestamp - timestamps[index] > CacheSize)
+            timestamps[index] = timestamp++;
+
+    return Float(timestamp - CacheSize - 1)/(indices.size()/3);
+}
+
+/* Packs floating-point normals, tangents and bitangents into normalized 8-bit
+   formats and texture coordinates into half-floats. If dequantization is
+   non-null, floating-point 3D positions are packed into normalized 16-bit
+   values as well, transformed by its inverse. Other attributes are copied
+   unchanged. Returns NullOpt if the mesh contains implementation-specific
+   formats. */
+Containers::Optional<Trade::MeshData> quantizeMesh(const Trade::MeshData& mesh, const Matrix4* const dequantization) {
+    if(mesh.isIndexed() && isMeshIndexTypeImplementationSpecific(mesh.indexType()))
+        return {};
+
+    /* Decide the new format of each attribute, morph targets and array
+       attributes are left as they are */
+    Containers::Array<Trade::MeshAttributeData> attributes{NoInit, mesh.attributeCount()};
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+        const Trade::MeshAttribute name = mesh.attributeName(i);
+        const VertexFormat format = mesh.attributeFormat(i);
+        if(isVertexFormatImplementationSpecific(format))
+            return {};
+
+        VertexFormat quantizedFormat = format;
+        if(!mesh.attributeArraySize(i) && mesh.attributeMorphTargetId(i) == -1) {
+            if(name == Trade::MeshAttribute::Position && format == VertexFormat::Vector3 && dequantization && mesh.attributeId(name) == i)
+                quantizedFormat = VertexFormat::Vector3sNormalized;
+            else if((name == Trade::MeshAttribute::Normal ||
+                     name == Trade::MeshAttribute::Tangent ||
+                     name == Trade::MeshAttribute::Bitangent) && format == VertexFormat::Vector3)
+                quantizedFormat = VertexFormat::Vector3bNormalized;
+            else if(name == Trade::MeshAttribute::Tangent && format == VertexFormat::Vector4)
+                quantizedFormat = VertexFormat::Vector4bNormalized;
+            else if(name == Trade::MeshAttribute::TextureCoordinates && format == VertexFormat::Vector2)
+                quantizedFormat = VertexFormat::Vector2h;
+        }
+        attributes[i] = Trade::MeshAttributeData{name, quantizedFormat, nullptr, mesh.attributeArraySize(i), mesh.attributeMorphTargetId(i)};
+    }
+
+    /* Only the layout of the attributes is taken from the list, fill the
+       data afterwards */
+    Trade::MeshData layout = MeshTools::interleavedLayout(Trade::MeshData{mesh.primitive(), 0}, mesh.vertexCount(), attributes);
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+        const VertexFormat format = layout.attributeFormat(i);
+        const Containers::StridedArrayView2D<char> dst = layout.mutableAttribute(i);
+        if(format == mesh.attributeFormat(i))
+            Utility::copy(mesh.attribute(i), dst);
+        else if(format == VertexFormat::Vector2h)
+            Math::packHalfInto(Containers::arrayCast<const Float>(mesh.attribute(i)), Containers::arrayCast<UnsignedShort>(dst));
+        else if(format == VertexFormat::Vector3sNormalized) {
+            const Matrix4 quantization = dequantization->inverted();
+            const Containers::StridedArrayView1D<const Vector3> positions = mesh.attribute<Vector3>(i);
+            Containers::Array<Vector3> quantized{NoInit, positions.size()};
+            for(std::size_t j = 0; j != positions.size(); ++j)
+                quantized[j] = quantization.transformPoint(positions[j]);
+            Math::packInto(Containers::arrayCast<2, Float>(Containers::stridedArrayView(quantized)), Containers::arrayCast<Short>(dst));
+        } else
+            Math::packInto(Containers::arrayCast<const Float>(mesh.attribute(i)), Containers::arrayCast<Byte>(dst));
+    }
+
+    Containers::Array<char> indexData;
+    Trade::MeshIndexData indices;
+    if(mesh.isIndexed()) {
+        indexData = Containers::Array<char>{NoInit, mesh.indexData().size()};
+        Utility::copy(mesh.indexData(), indexData);
+        indices = Trade::MeshIndexData{mesh.indexType(), Containers::StridedArrayView1D<const void>{indexData, indexData.data() + mesh.indexOffset(), mesh.indexCount(), mesh.indexStride()}};
+    }
+
+    const UnsignedInt vertexCount = layout.vertexCount();
+    Containers::Array<char> vertexData = layout.releaseVertexData();
+    return Trade::MeshData{mesh.primitive(),
+        Utility::move(indexData), indices,
+        Utility::move(vertexData), layout.releaseAttributeData(),
+        vertexCount};
+}
+
+/* 64-bit FNV-1a, the same as used for the source file in MeshCache. Used for
+   detecting byte-identical meshes and, on reload, unchanged meshes and
+   textures. */
+constexpr UnsignedLong HashSeed = 14695981039346656037ull;
+
+void hashInto(UnsignedLong& hash, const Containers::ArrayView<const char> data) {
+    for(const char c: data) {
+        hash ^= UnsignedByte(c);
+        hash *= 1099511628211ull;
+    }
+}
+
+void hashInto(UnsignedLong& hash, const UnsignedLong value) {
+    hashInto(hash, Containers::arrayView(reinterpret_cast<const char*>(&value), sizeof(value)));
+}
+
+/* Hash of the mesh data and layout */
+UnsignedLong meshHash(const Trade::MeshData& mesh) {
+    UnsignedLong hash = HashSeed;
+    hashInto(hash, UnsignedLong(mesh.primitive()));
+    hashInto(hash, mesh.vertexCount());
+    if(mesh.isIndexed()) {
+        hashInto(hash, UnsignedLong(mesh.indexType()));
+        hashInto(hash, mesh.indexOffset());
+        hashInto(hash, mesh.indexStride());
+        hashInto(hash, mesh.indexData());
+    }
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+        hashInto(hash, UnsignedLong(mesh.attributeName(i)));
+        hashInto(hash, UnsignedLong(mesh.attributeFormat(i)));
+        hashInto(hash, mesh.attributeOffset(i));
+        hashInto(hash, mesh.attributeStride(i));
+        hashInto(hash, mesh.attributeArraySize(i));
+        hashInto(hash, mesh.attributeMorphTargetId(i));
+    }
+    hashInto(hash, mesh.vertexData());
+    return hash;
+}
+
+/* Hash of the image data and format, combined with the sampler properties in
+   ScenePlayer::load() */
+UnsignedLong imageHash(const Trade::ImageData2D& image) {
+    UnsignedLong hash = HashSeed;
+    hashInto(hash, image.isCompressed());
+    hashInto(hash, UnsignedLong(image.isCompressed() ?
+        UnsignedInt(image.compressedFormat()) : UnsignedInt(image.format())));
+    hashInto(hash, image.size().x());
+    hashInto(hash, image.size().y());
+    hashInto(hash, image.data());
+    return hash;
+}
+
+void configureTexture(GL::Texture2D& texture, const Trade::TextureData& textureData) {
+    texture
+        .setMagnificationFilter(textureData.magnificationFilter())
+        .setMinificationFilter(textureData.minificationFilter(), textureData.mipmapFilter())
+        .setWrapping(textureData.wrapping().xy());
+}
+
+Containers::Array<UnsignedInt> drawableTransformationIds(const std::unordered_map<const SceneGraph::AbstractObject3D*, UnsignedInt>& objectIds, SceneGraph::DrawableGroup3D& group) {
+    Containers::Array<UnsignedInt> out{NoInit, group.size()};
+    for(std::size_t i = 0; i != group.size(); ++i) {
+        const auto found = objectIds.find(&group[i].object());
+        CORRADE_INTERNAL_ASSERT(found != objectIds.end());
+        out[i] = found->second;
+    }
+    return out;
+}
+
+/* Samples the supported tracks of an animation at fixed intervals so the
+   pose for any time can be looked up directly instead of searching for
+   keyframes in each track */
+BakedAnimation bakeAnimation(const Trade::AnimationData& animation, const Containers::ArrayView<const ObjectInfo> objects) {
+    /* Twice the usual display refresh rate, so linear interpolation between
+       the samples is indistinguishable from the original spline and slerp
+       interpolation */
+    constexpr Float SamplesPerSecond = 120.0f;
+
+    BakedAnimation out;
+    const Range1D duration = animation.duration();
+    out.begin = duration.min();
+    out.sampleCount = Math::max(UnsignedInt(Math::ceil(duration.size()*SamplesPerSecond)) + 1, 2u);
+    out.rate = duration.size() > 0.0f ? (out.sampleCount - 1)/duration.size() : 0.0f;
+    out.timeData[0] = {duration.min(), duration.min()};
+    out.timeData[1] = {duration.max(), duration.max()};
+
+    for(UnsignedInt i = 0; i != animation.trackCount(); ++i) {
+        if(animation.trackTarget(i) >= objects.size() || !objects[animation.trackTarget(i)].object)
+            continue;
+
+        BakedAnimationTrack track;
+        track.object = objects[animation.trackTarget(i)].object;
+        track.target = animation.trackTargetName(i);
+
+        /* The samples are taken in increasing time, so the hint makes each
+           lookup constant-time */
+        std::size_t hint{};
+        if(track.target == Trade::AnimationTrackTarget::Rotation3D) {
+            track.offset = out.rotations.size();
+            Quaternion* samples = arrayAppend(out.rotations, NoInit, out.sampleCount).data();
+            if(animation.trackType(i) == Trade::AnimationTrackType::CubicHermiteQuaternion) {
+                const auto view = animation.track<CubicHermiteQuaternion>(i);
+                for(UnsignedInt j = 0; j != out.sampleCount; ++j)
+                    samples[j] = view.at(out.begin + j*duration.size()/(out.sampleCount - 1), hint);
+            } else {
+                CORRADE_INTERNAL_ASSERT(animation.trackType(i) == Trade::AnimationTrackType::Quaternion);
+                const auto view = animation.track<Quaternion>(i);
+                for(UnsignedInt j = 0; j != out.sampleCount; ++j)
+                    samples[j] = view.at(out.begin + j*duration.size()/(out.sampleCount - 1), hint);
+            }
+        } else {
+            CORRADE_INTERNAL_ASSERT(track.target == Trade::AnimationTrackTarget::Translation3D || track.target == Trade::AnimationTrackTarget::Scaling3D);
+            track.offset = out.vectors.size();
+            Vector3* samples = arrayAppend(out.vectors, NoInit, out.sampleCount).data();
+            if(animation.trackType(i) == Trade::AnimationTrackType::CubicHermite3D) {
+                const auto view = animation.track<CubicHermite3D>(i);
+                for(UnsignedInt j = 0; j != out.sampleCount; ++j)
+                    samples[j] = view.at(out.begin + j*duration.size()/(out.sampleCount - 1), hint);
+            } else {
+                CORRADE_INTERNAL_ASSERT(animation.trackType(i) == Trade::AnimationTrackType::Vector3);
+                const auto view = animation.track<Vector3>(i);
+                for(UnsignedInt j = 0; j != out.sampleCount; ++j)
+                    samples[j] = view.at(out.begin + j*duration.size()/(out.sampleCount - 1), hint);
+            }
+        }
+
+        arrayAppend(out.tracks, track);
+    }
+
+    return out;
+}
+
+/* Interpolates between the two samples closest to given time, independently
+   of how far the time jumped since the last call */
+void applyBakedAnimation(BakedAnimation& animation, const Float time) {
+    const Float position = Math::clamp((time - animation.begin)*animation.rate, 0.0f, Float(animation.sampleCount - 1));
+    const UnsignedInt sample = Math::min(UnsignedInt(position), animation.sampleCount - 2);
+    const Float t = position - sample;
+
+    for(BakedAnimationTrack& track: animation.tracks) {
+        if(track.target == Trade::AnimationTrackTarget::Rotation3D) {
+            const Quaternion* samples = animation.rotations.data() + track.offset + sample;
+            const Quaternion rotation = Math::slerpShortestPath(samples[0], samples[1], t);
+            if(rotation == track.rotation) continue;
+            track.rotation = rotation;
+            track.object->setRotation(rotation);
+        } else {
+            const Vector3* samples = animation.vectors.data() + track.offset + sample;
+            const Vector3 vector = Math::lerp(samples[0], samples[1], t);
+            if(vector == track.vector) continue;
+            track.vector = vector;
+            if(track.target == Trade::AnimationTrackTarget::Translation3D)
+                track.object->setTranslation(vector);
+            else
+                track.object->setScaling(vector);
+        }
+    }
+}
+
+/* Called at the end of ScenePlayer::load() once the hierarchy and all
+   drawables except the selected object visualization are created */
+void setupTransformations(Data& data) {
+    arrayResize(data.transformationObjects, 0);
+    for(Object3D* child = data.scene.children().first(); child; child = child->nextSibling())
+        arrayAppend(data.transformationObjects, InPlaceInit, child, 0xffffffffu);
+    for(std::size_t i = 0; i != data.transformationObjects.size(); ++i)
+        for(Object3D* child = data.transformationObjects[i].first()->children().first(); child; child = child->nextSibling())
+            arrayAppend(data.transformationObjects, InPlaceInit, child, UnsignedInt(i));
+
+    std::unordered_map<const SceneGraph::AbstractObject3D*, UnsignedInt> objectIds;
+    for(std::size_t i = 0; i != data.transformationObjects.size(); ++i)
+        objectIds.emplace(data.transformationObjects[i].first(), i);
+
+    /* All objects are initially dirty so everything gets calculated in the
+       first updateTransformations() */
+    data.absoluteTransformations = Containers::Array<Matrix4>{data.transformationObjects.size()};
+    data.lightDrawableTransformations = drawableTransformationIds(objectIds, data.lightDrawables);
+    data.jointDrawableTransformations = drawableTransformationIds(objectIds, data.jointDrawables);
+    data.opaqueDrawableTransformations = drawableTransformationIds(objectIds, data.opaqueDrawables);
+    data.transparentDrawableTransformationIds = drawableTransformationIds(objectIds, data.transparentDrawables);
+    data.objectVisualizationDrawableTransformations = drawableTransformationIds(objectIds, data.objectVisualizationDrawables);
+}
+
+}
+
+void ScenePlayer::releaseImporter() {
+    /* Textures that weren't streamed in yet stay with the placeholder */
+    if(!_data) return;
+    _data->streamingImporter = nullptr;
+    _data->streamedTextureImages = {};
+    _data->streamedTextures = {};
+    _data->streamedTextureImageOffset = 0;
+}
+
+void ScenePlayer::streamTexture() {
+    Data& data = *_data;
+    const UnsignedInt image = data.streamedTextureImages[data.streamedTextureImageOffset].first();
+    Containers::Optional<Trade::ImageData2D> imageData = data.streamingImporter->image2D(image);
+    if(!imageData)
+        Warning{} << "Cannot load image" << image << data.streamingImporter->image2DName(image);
+
+    /* Upload to all textures using this image. The drawables reference the
+       textures directly, so the new ones are moved over the placeholders in
+       place. If the image failed to load, the placeholders stay. */
+    for(; data.streamedTextureImageOffset != data.streamedTextureImages.size() && data.streamedTextureImages[data.streamedTextureImageOffset].first() == image; ++data.streamedTextureImageOffset) {
+        if(!imageData)
+            continue;
+
+        const UnsignedInt textureId = data.streamedTextureImages[data.streamedTextureImageOffset].second();
+        GL::Texture2D texture;
+        configureTexture(texture, *data.streamedTextures[textureId]);
+        loadImage(texture, *imageData, _flags >= ScenePlayerFlag::CompressTextures, &_imageUploadBuffers);
+        *data.textures[textureId] = Utility::move(texture);
+    }
+
+    if(data.streamedTextureImageOffset == data.streamedTextureImages.size()) {
+        Debug{} << "Streamed" << data.streamedTextureImages.size() << "textures";
+        releaseImporter();
+    }
 }
 
 void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter& importer, Int id) {
+    loadInternal(filename, importer, id, nullptr);
+}
+
+void ScenePlayer::reload(Containers::StringView filename, Trade::AbstractImporter& importer, Int id) {
+    loadInternal(filename, importer, id, Utility::move(_data));
+}
+
+void ScenePlayer::loadInternal(Containers::StringView filename, Trade::AbstractImporter& importer, Int id, Containers::Pointer<Data> previous) {
     if(id >= 0 && UnsignedInt(id) >= importer.sceneCount()) {
         Fatal{} << "Cannot load a scene with ID" << id << "as there's only" << importer.sceneCount() << "scenes";
     }
 
     _data.emplace();
+    #if !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+    _selectionReadbackFrames = 0;
+    #endif
+
+    /* Measure how long each section takes and how much data it imports,
+       printed with verbose output and summarized in the model info */
+    Containers::Array<LoadSection> sections;
+    std::chrono::steady_clock::time_point sectionStart = std::chrono::steady_clock::now();
+    std::size_t sectionSize = 0;
+    const auto endSection = [&](Containers::StringView name) {
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        arrayAppend(sections, InPlaceInit, name, now - sectionStart, sectionSize);
+        sectionStart = now;
+        sectionSize = 0;
+    };
 
-    /* Load all textures. Textures that fail to load will be NullOpt. */
+    /* Load all textures. Textures that fail to load will be NullOpt. Multiple
+       textures can reference the same image, for example with different
+       sampler settings, so first gather the texture data and then decode
+       each referenced image just once, uploading it to all textures that use
+       it. */
     Debug{} << "Loading" << importer.textureCount() << "textures";
     _data->textures = Containers::Array<Containers::Optional<GL::Texture2D>>{importer.textureCount()};
+    _data->textureHashes = Containers::Array<UnsignedLong>{ValueInit, importer.textureCount()};
+    /* On reload, unchanged textures are taken from the previous data */
+    std::unordered_map<UnsignedLong, UnsignedInt> previousTextures;
+    if(previous) for(UnsignedInt i = 0; i != previous->textures.size(); ++i)
+        if(previous->textures[i] && previous->textureHashes[i])
+            previousTextures.emplace(previous->textureHashes[i], i);
+    UnsignedInt reusedTextureCount = 0;
+    Containers::Array<Containers::Optional<Trade::TextureData>> textures{importer.textureCount()};
+    Containers::Array<Containers::Pair<UnsignedInt, UnsignedInt>> textureImages;
+    arrayReserve(textureImages, importer.textureCount());
     for(UnsignedInt i = 0; i != importer.textureCount(); ++i) {
         Containers::Optional<Trade::TextureData> textureData = importer.texture(i);
         if(!textureData || textureData->type() != Trade::TextureType::Texture2D) {
@@ -907,23 +1581,82 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
             continue;
         }
 
-        Containers::Optional<Trade::ImageData2D> imageData = importer.image2D(textureData->image());
-        if(!imageData) {
-            Warning{} << "Cannot load image" << textureData->image() << importer.image2DName(textureData->image());
+        arrayAppend(textureImages, InPlaceInit, textureData->image(), i);
+        textures[i] = Utility::move(textureData);
+    }
+
+    /* Sort by the image ID so textures using the same image are next to each
+       other, and in the original order otherwise to have the warnings
+       printed in a predictable order */
+    std::sort(textureImages.begin(), textureImages.end(), [](const Containers::Pair<UnsignedInt, UnsignedInt>& a, const Containers::Pair<UnsignedInt, UnsignedInt>& b) {
+        return a.first() < b.first() || (a.first() == b.first() && a.second() < b.second());
+    });
+
+    /* With texture streaming, create just the configured textures here, get
+       a placeholder uploaded to them after the materials are known and decode
+       the images one by one in drawEvent(). Moving textureImages away makes
+       the loop below do nothing. Reusing textures from a previous load
+       isn't done in this case. */
+    if(_flags >= ScenePlayerFlag::StreamTextures && !textureImages.isEmpty()) {
+        for(const Containers::Pair<UnsignedInt, UnsignedInt>& textureImage: textureImages)
+            configureTexture(_data->textures[textureImage.second()].emplace(), *textures[textureImage.second()]);
+        Debug{} << "Streaming" << textureImages.size() << "textures after the first frame";
+        _data->streamingImporter = &importer;
+        _data->streamedTextureImages = Utility::move(textureImages);
+        _data->streamedTextures = Utility::move(textures);
+    }
+
+    Containers::Optional<Trade::ImageData2D> imageData;
+    UnsignedLong imageDataHash{};
+    for(std::size_t i = 0; i != textureImages.size(); ++i) {
+        const UnsignedInt image = textureImages[i].first();
+        const UnsignedInt textureId = textureImages[i].second();
+
+        /* Decode the image only if it's different from the previous one. If
+           it failed to load, print just one warning for it. */
+        if(i == 0 || textureImages[i - 1].first() != image) {
+            imageData = importer.image2D(image);
+            if(!imageData)
+                Warning{} << "Cannot load image" << image << importer.image2DName(image);
+            else {
+                sectionSize += imageData->data().size();
+                if(_flags >= ScenePlayerFlag::IncrementalReload)
+                    imageDataHash = imageHash(*imageData);
+            }
+        }
+        if(!imageData)
             continue;
+
+        /* If the image and the sampler didn't change since the previous
+           load, reuse the texture */
+        const Trade::TextureData& textureData = *textures[textureId];
+        if(_flags >= ScenePlayerFlag::IncrementalReload) {
+            UnsignedLong hash = imageDataHash;
+            hashInto(hash, UnsignedLong(textureData.magnificationFilter()));
+            hashInto(hash, UnsignedLong(textureData.minificationFilter()));
+            hashInto(hash, UnsignedLong(textureData.mipmapFilter()));
+            hashInto(hash, UnsignedLong(textureData.wrapping().x()));
+            hashInto(hash, UnsignedLong(textureData.wrapping().y()));
+            _data->textureHashes[textureId] = hash;
+
+            const auto found = previousTextures.find(hash);
+            if(found != previousTextures.end()) {
+                _data->textures[textureId] = Utility::move(previous->textures[found->second]);
+                previousTextures.erase(found);
+                ++reusedTextureCount;
+                continue;
+            }
         }
 
-        /* Configure the texture */
         GL::Texture2D texture;
-        texture
-            .setMagnificationFilter(textureData->magnificationFilter())
-            .setMinificationFilter(textureData->minificationFilter(), textureData->mipmapFilter())
-            .setWrapping(textureData->wrapping().xy());
-
-        loadImage(texture, *imageData);
+        configureTexture(texture, textureData);
+        loadImage(texture, *imageData, _flags >= ScenePlayerFlag::CompressTextures, &_imageUploadBuffers);
 
-        _data->textures[i] = Utility::move(texture);
+        _data->textures[textureId] = Utility::move(texture);
     }
+    if(reusedTextureCount)
+        Debug{} << "Reused" << reusedTextureCount << "unchanged textures";
+    endSection("textures"_s);
 
     /* Load all lights. Lights that fail to load will be NullOpt, saving the
        whole imported data so we can populate the selection info later. */
@@ -956,7 +1689,9 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
         }
 
         _data->lights[i].light = Utility::move(light);
+        sectionSize += sizeof(Trade::LightData);
     }
+    endSection("lights"_s);
 
     /* Load all skins. Skins that fail to load will be NullOpt. The data will
        be stored directly in objects later, so save them only temporarily. */
@@ -977,12 +1712,14 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
 
         skins[i].offset = totalJointCount;
         totalJointCount += skinData->joints().size();
+        sectionSize += skinData->joints().size()*(sizeof(UnsignedInt) + sizeof(Matrix4));
         skins[i].skin = Utility::move(skinData);
     }
     Debug{} << "Loaded" << importer.skin3DCount() << "skins with" << totalJointCount << "joints in total and at most" << _data->maxJointCount << "joints per skin";
 
     /* Allocate an array where absolute joint matrices will be stored */
     _data->skinJointMatrices = Containers::Array<Matrix4>{NoInit, totalJointCount};
+    endSection("skins"_s);
 
     /* Load all materials. Materials that fail to load will be NullOpt. The
        data will be stored directly in objects later, so save them only
@@ -996,17 +1733,80 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
             continue;
         }
 
+        sectionSize += materialData->attributeData().size()*sizeof(Trade::MaterialAttributeData);
         materials[i] = Utility::move(*materialData).as<Trade::PhongMaterialData>();
     }
 
+    /* With texture streaming, upload a single-pixel placeholder to all
+       textures so the scene can be drawn before the images arrive. Normal
+       maps get a flat normal, everything else white so the material colors
+       show through. */
+    if(_data->streamingImporter) {
+        Containers::BitArray isNormalTexture{ValueInit, _data->textures.size()};
+        for(const Containers::Optional<Trade::PhongMaterialData>& material: materials)
+            if(material && material->hasAttribute(Trade::MaterialAttribute::NormalTexture) && material->normalTexture() < isNormalTexture.size())
+                isNormalTexture.set(material->normalTexture());
+        for(UnsignedInt i = 0; i != _data->textures.size(); ++i) {
+            if(!_data->textures[i])
+                continue;
+            const Color4ub placeholder = isNormalTexture[i] ? 0x8080ffff_rgba : 0xffffffff_rgba;
+            loadImage(*_data->textures[i], Trade::ImageData2D{PixelFormat::RGBA8Unorm, {1, 1}, Trade::DataFlags{}, Containers::ArrayView<const void>{&placeholder, sizeof(placeholder)}}, false, nullptr);
+        }
+    }
+    endSection("materials"_s);
+
     /* Load all meshes. Meshes that fail to load will be NullOpt. Remember
        which have vertex colors, so in case there's no material we can use that
-       instead. */
+       instead. If the mesh cache is enabled and up-to-date, meshes are taken
+       from there directly, already processed, without going through the
+       importer. */
     Debug{} << "Loading" << importer.meshCount() << "meshes";
     _data->meshes = Containers::Array<MeshInfo>{importer.meshCount()};
     Containers::BitArray hasVertexColors{ValueInit, importer.meshCount()};
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    Containers::Optional<MeshCache> meshCache;
+    if(_flags >= ScenePlayerFlag::MeshCache && filename)
+        meshCache.emplace(filename, importer.meshCount());
+    #endif
+    PluginManager::Manager<Trade::AbstractSceneConverter> converterManager;
+    Containers::Pointer<Trade::AbstractSceneConverter> simplifier;
+    if(_flags >= ScenePlayerFlag::GenerateLods) {
+        if((simplifier = converterManager.loadAndInstantiate("MeshOptimizerSceneConverter")))
+            simplifier->configuration().setValue("simplify", true);
+        else Warning{} << "Cannot generate mesh LODs without MeshOptimizerSceneConverter";
+    }
+    /* The plugin does vertex cache, overdraw and vertex fetch optimization
+       by default if not simplifying */
+    Containers::Pointer<Trade::AbstractSceneConverter> optimizer;
+    if(_flags >= ScenePlayerFlag::OptimizeMeshes && !(optimizer = converterManager.loadAndInstantiate("MeshOptimizerSceneConverter")))
+        Warning{} << "Cannot optimize meshes without MeshOptimizerSceneConverter";
+    /* Some exporters write identical data for each object referencing a mesh.
+       Such duplicates are detected by a hash of the processed data and
+       remapped to the first occurrence, which gets compiled only once and then
+       drawn by all objects referencing any of them. Hash collisions are
+       considered unlikely enough to not compare the data byte-by-byte, which
+       would need all meshes kept in memory until the end of the loading. */
+    std::unordered_map<UnsignedLong, UnsignedInt> meshHashes;
+    Containers::Array<UnsignedInt> meshDuplicates{NoInit, importer.meshCount()};
+    for(UnsignedInt i = 0; i != meshDuplicates.size(); ++i)
+        meshDuplicates[i] = i;
+    UnsignedInt duplicateMeshCount = 0;
+    /* On reload, unchanged meshes are taken from the previous data */
+    std::unordered_map<UnsignedLong, UnsignedInt> previousMeshes;
+    if(previous) for(UnsignedInt i = 0; i != previous->meshes.size(); ++i)
+        if(previous->meshes[i].mesh)
+            previousMeshes.emplace(previous->meshes[i].hash, i);
+    UnsignedInt reusedMeshCount = 0;
     for(UnsignedInt i = 0; i != importer.meshCount(); ++i) {
-        Containers::Optional<Trade::MeshData> meshData = importer.mesh(i);
+        Containers::Optional<Trade::MeshData> meshData;
+        #ifndef CORRADE_TARGET_EMSCRIPTEN
+        if(meshCache && meshCache->isValid())
+            meshData = meshCache->mesh(i);
+        else
+        #endif
+        {
+            meshData = importer.mesh(i);
+        }
         if(!meshData) {
             Warning{} << "Cannot load mesh" << i << importer.meshName(i);
             continue;
@@ -1015,11 +1815,10 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
         Containers::String meshName = importer.meshName(i);
         if(!meshName) meshName = Utility::format("#{}", i);
 
-        /* Disable warnings on custom attributes, as we printed them with
-           actual string names below. Generate normals for triangle meshes
-           (and don't do anything for line/point meshes, there it makes no
-           sense). */
-        MeshTools::CompileFlags flags = MeshTools::CompileFlag::NoWarnOnCustomAttributes;
+        /* Generate normals for triangle meshes (and don't do anything for
+           line/point meshes, there it makes no sense). It's done here instead
+           of via MeshTools::CompileFlag::GenerateSmoothNormals etc. so the
+           result can be put into the mesh cache. */
         if((meshData->primitive() == MeshPrimitive::Triangles ||
             meshData->primitive() == MeshPrimitive::TriangleStrip ||
             meshData->primitive() == MeshPrimitive::TriangleFan) &&
@@ -1031,14 +1830,15 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
                generate smooth normals. If it's not, generate flat ones as
                otherwise the smoothing would be only along the strip and not at
                the seams, looking weird. */
+            bool smooth;
             if(meshData->primitive() == MeshPrimitive::TriangleStrip ||
                meshData->primitive() == MeshPrimitive::TriangleFan) {
                 if(meshData->isIndexed()) {
                     Debug{} << "Mesh" << meshName << "doesn't have normals, generating smooth ones using information from the index buffer for a" << meshData->primitive();
-                    flags |= MeshTools::CompileFlag::GenerateSmoothNormals;
+                    smooth = true;
                 } else {
                     Debug{} << "Mesh" << meshName << "doesn't have normals, generating flat ones for a" << meshData->primitive();
-                    flags |= MeshTools::CompileFlag::GenerateFlatNormals;
+                    smooth = false;
                 }
 
                 meshData = MeshTools::generateIndices(*Utility::move(meshData));
@@ -1047,10 +1847,62 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
                telling us neighboring faces */
             } else if(meshData->isIndexed()) {
                 Debug{} << "Mesh" << meshName << "doesn't have normals, generating smooth ones using information from the index buffer";
-                flags |= MeshTools::CompileFlag::GenerateSmoothNormals;
+                smooth = true;
             } else {
                 Debug{} << "Mesh" << meshName << "doesn't have normals, generating flat ones";
-                flags |= MeshTools::CompileFlag::GenerateFlatNormals;
+                smooth = false;
+            }
+
+            /* Flat normals need each triangle to have its own vertices */
+            Containers::Array<Vector3> normals;
+            if(smooth) {
+                normals = MeshTools::generateSmoothNormals(meshData->indicesAsArray(), meshData->positions3DAsArray());
+            } else {
+                if(meshData->isIndexed())
+                    meshData = MeshTools::duplicate(*meshData);
+                normals = MeshTools::generateFlatNormals(meshData->positions3DAsArray());
+            }
+            meshData = MeshTools::interleave(*Utility::move(meshData), {
+                Trade::MeshAttributeData{Trade::MeshAttribute::Normal, Containers::arrayView(normals)}
+            });
+        }
+
+        /* Reorder indexed triangle meshes for vertex cache efficiency and
+           vertices for fetch locality. Done before putting the mesh into the
+           cache, so meshes coming from the cache are already optimized and
+           have no statistics to show. If the optimization fails, the
+           original mesh is used. */
+        if(optimizer &&
+           #ifndef CORRADE_TARGET_EMSCRIPTEN
+           !(meshCache && meshCache->isValid()) &&
+           #endif
+           meshData->primitive() == MeshPrimitive::Triangles &&
+           meshData->isIndexed() &&
+           !isMeshIndexTypeImplementationSpecific(meshData->indexType())) {
+            const Float acmr = averageCacheMissRatio(meshData->indicesAsArray(), meshData->vertexCount());
+            if(Containers::Optional<Trade::MeshData> optimized = optimizer->convert(*meshData)) {
+                meshData = Utility::move(optimized);
+                _data->meshes[i].acmr = acmr;
+                _data->meshes[i].optimizedAcmr = averageCacheMissRatio(meshData->indicesAsArray(), meshData->vertexCount());
+                Debug{} << "Optimized mesh" << meshName << Debug::nospace << ", ACMR" << acmr << "->" << _data->meshes[i].optimizedAcmr;
+            }
+        }
+
+        #ifndef CORRADE_TARGET_EMSCRIPTEN
+        if(meshCache && !meshCache->isValid())
+            meshCache->setMesh(i, *meshData);
+        #endif
+
+        /* If the same mesh was compiled already, reuse it. The name is kept
+           for the duplicate even though nothing references it afterwards. */
+        {
+            _data->meshes[i].hash = meshHash(*meshData);
+            const auto inserted = meshHashes.emplace(_data->meshes[i].hash, i);
+            if(!inserted.second) {
+                meshDuplicates[i] = inserted.first->second;
+                ++duplicateMeshCount;
+                _data->meshes[i].name = Utility::move(meshName);
+                continue;
             }
         }
 
@@ -1093,12 +1945,104 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
         if(meshData->hasAttribute(Trade::MeshAttribute::ObjectId)) {
             _data->meshes[i].objectIdCount = Math::max(meshData->objectIdsAsArray());
         } else _data->meshes[i].objectIdCount = 0;
+        if(meshData->hasAttribute(Trade::MeshAttribute::Position) &&
+           !isVertexFormatImplementationSpecific(meshData->attributeFormat(Trade::MeshAttribute::Position)) &&
+           meshData->vertexCount()) {
+            const Containers::Pair<Vector3, Vector3> minmax = Math::minmax(meshData->positions3DAsArray());
+            _data->meshes[i].bounds = Range3D{minmax.first(), minmax.second()};
+        }
         _data->meshes[i].perVertexJointCount = perVertexJointCount.first();
         _data->meshes[i].secondaryPerVertexJointCount = perVertexJointCount.second();
-        _data->meshes[i].mesh = MeshTools::compile(*meshData, flags);
+
+        /* If the mesh didn't change since the previous load, reuse it
+           together with everything derived from it on the GPU side */
+        if(previous) {
+            const auto found = previousMeshes.find(_data->meshes[i].hash);
+            if(found != previousMeshes.end()) {
+                MeshInfo& previousMesh = previous->meshes[found->second];
+                _data->meshes[i].mesh = Utility::move(previousMesh.mesh);
+                _data->meshes[i].lods = Utility::move(previousMesh.lods);
+                _data->meshes[i].dequantization = previousMesh.dequantization;
+                _data->meshes[i].size = previousMesh.size;
+                _data->meshes[i].name = Utility::move(meshName);
+                sectionSize += _data->meshes[i].size;
+                ++reusedMeshCount;
+                continue;
+            }
+        }
+
+        /* Pack the attributes into smaller formats for the GPU. The mesh
+           cache and the LOD simplification below still operate on the
+           original data. Positions are mapped to the bounding box with a
+           uniform scale, so the normal matrix calculated from the
+           dequantization stays correct. The bounds stay in the original
+           space, which means culling and LOD selection don't need to take the
+           dequantization into account. Positions of skinned meshes are kept
+           as-is, as the joint matrices map them directly. */
+        Containers::Optional<Matrix4> dequantization;
+        Containers::Optional<Trade::MeshData> quantized;
+        if(_flags >= ScenePlayerFlag::QuantizeMeshes) {
+            if(_data->meshes[i].bounds && meshData->attributeFormat(Trade::MeshAttribute::Position) == VertexFormat::Vector3 && !perVertexJointCount.first() && !perVertexJointCount.second()) {
+                const Float scale = (_data->meshes[i].bounds->size()*0.5f).max();
+                dequantization = Matrix4::translation(_data->meshes[i].bounds->center())*Matrix4::scaling(Vector3{scale ? scale : 1.0f});
+            }
+            if((quantized = quantizeMesh(*meshData, dequantization ? &*dequantization : nullptr))) {
+                const std::size_t size = quantized->vertexData().size() + quantized->indexData().size();
+                Debug{} << "Quantized mesh" << meshName << "from" << _data->meshes[i].size/1024.0f << "kB to" << size/1024.0f << "kB";
+                _data->meshes[i].size = size;
+                if(dequantization)
+                    _data->meshes[i].dequantization = *dequantization;
+            }
+        }
+
+        /* Disable warnings on custom attributes, as we printed them with
+           actual string names above */
+        _data->meshes[i].mesh = MeshTools::compile(quantized ? *quantized : *meshData, MeshTools::CompileFlag::NoWarnOnCustomAttributes);
+
+        /* Generate LODs for large enough indexed triangle meshes. The
+           simplification only replaces the index buffer, so all attributes
+           are kept. Skinned meshes are always drawn at full detail, so
+           don't bother with them. */
+        if(simplifier &&
+           meshData->primitive() == MeshPrimitive::Triangles &&
+           meshData->isIndexed() &&
+           _data->meshes[i].primitives >= 65536 &&
+           !perVertexJointCount.first() && !perVertexJointCount.second()) {
+            UnsignedInt indexCount = meshData->indexCount();
+            for(const Float threshold: {0.25f, 0.0625f}) {
+                simplifier->configuration().setValue("simplifyTargetIndexCountThreshold", threshold);
+                Containers::Optional<Trade::MeshData> simplified = simplifier->convert(*meshData);
+                if(!simplified || simplified->indexCount() >= indexCount)
+                    break;
+
+                indexCount = simplified->indexCount();
+                /* The vertex data are the same, so quantize them the same way
+                   as the original to share the dequantization */
+                if(quantized)
+                    simplified = quantizeMesh(*simplified, dequantization ? &*dequantization : nullptr);
+                MeshLod lod;
+                lod.mesh = MeshTools::compile(*simplified, MeshTools::CompileFlag::NoWarnOnCustomAttributes);
+                lod.primitives = indexCount/3;
+                arrayAppend(_data->meshes[i].lods, Utility::move(lod));
+            }
+            if(!_data->meshes[i].lods.isEmpty())
+                Debug{} << "Generated" << _data->meshes[i].lods.size() << "LODs for mesh" << meshName;
+        }
+
         _data->meshes[i].name = Utility::move(meshName);
+        sectionSize += _data->meshes[i].size;
     }
 
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    if(meshCache && !meshCache->isValid())
+        meshCache->save();
+    #endif
+    if(duplicateMeshCount)
+        Debug{} << "Found" << duplicateMeshCount << "duplicate meshes, sharing them";
+    if(reusedMeshCount)
+        Debug{} << "Reused" << reusedMeshCount << "unchanged meshes";
+    endSection("meshes"_s);
+
     /* Load the scene. Save the object pointers in an array for easier mapping
        of animations later. */
     if((id < 0 && importer.sceneCount()) || id >= 0) {
@@ -1114,6 +2058,7 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
             Error{} << "Cannot load the scene, aborting";
             return;
         }
+        sectionSize += scene->data().size();
 
         /* Allocate objects that are part of the hierarchy and fill their
            implicit info */
@@ -1186,6 +2131,7 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
                add that directly. */
             new LightDrawable{*object, light->type() == Trade::LightType::Directional ? true : false, _data->lightPositions, _data->lightDrawables};
             arrayAppend(_data->lightColors, InPlaceInit, light->color()*light->intensity());
+            arrayAppend(_data->lightCulling.ranges, light->range());
 
             /* Visualization of the center */
             new FlatDrawable{*object, flatShader({}), _lightCenterMesh, objectId, light->color(), Vector3{0.25f}, nullptr, 0, 0, _data->objectVisualizationDrawables};
@@ -1268,7 +2214,38 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
         /* Add drawables for objects that have a mesh, again ignoring objects
            that are not part of the hierarchy. There can be multiple mesh
            assignments for one object, simply add one drawable for each. */
-        if(scene->hasField(Trade::SceneField::Mesh)) for(const Containers::Pair<UnsignedInt, Containers::Pair<UnsignedInt, Int>>& meshMaterial: scene->meshesMaterialsAsArray()) {
+        Containers::Array<Containers::Pair<UnsignedInt, Containers::Pair<UnsignedInt, Int>>> meshesMaterials;
+        if(scene->hasField(Trade::SceneField::Mesh))
+            meshesMaterials = scene->meshesMaterialsAsArray();
+
+        /* Draw duplicate meshes with the first occurrence. The sort below then
+           puts all objects using them next to each other. */
+        for(Containers::Pair<UnsignedInt, Containers::Pair<UnsignedInt, Int>>& meshMaterial: meshesMaterials)
+            meshMaterial.second().first() = meshDuplicates[meshMaterial.second().first()];
+
+        /* Save the mesh pointer as well, so we know what to draw for object
+           selection. Done in the original order, before the sort below. */
+        for(const Containers::Pair<UnsignedInt, Containers::Pair<UnsignedInt, Int>>& meshMaterial: meshesMaterials) {
+            const UnsignedInt objectId = meshMaterial.first();
+            const UnsignedInt meshId = meshMaterial.second().first();
+            if(_data->objects[objectId].object && _data->meshes[meshId].mesh)
+                _data->objects[objectId].meshId = meshId;
+        }
+
+        /* Drawables are drawn in the order they're added, so add them sorted
+           by the material and then by the mesh. Drawables sharing a material
+           then use the same shader and textures, and the GL state tracker
+           can skip redundant shader, texture and mesh binding between
+           them. */
+        std::sort(meshesMaterials.begin(), meshesMaterials.end(), [](const Containers::Pair<UnsignedInt, Containers::Pair<UnsignedInt, Int>>& a, const Containers::Pair<UnsignedInt, Containers::Pair<UnsignedInt, Int>>& b) {
+            if(a.second().second() != b.second().second())
+                return a.second().second() < b.second().second();
+            if(a.second().first() != b.second().first())
+                return a.second().first() < b.second().first();
+            return a.first() < b.first();
+        });
+
+        for(const Containers::Pair<UnsignedInt, Containers::Pair<UnsignedInt, Int>>& meshMaterial: meshesMaterials) {
             const UnsignedInt objectId = meshMaterial.first();
             Object3D* const object = _data->objects[objectId].object;
             const UnsignedInt meshId = meshMaterial.second().first();
@@ -1276,10 +2253,6 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
             Containers::Optional<GL::Mesh>& mesh = _data->meshes[meshId].mesh;
             if(!object || !mesh) continue;
 
-            /* Save the mesh pointer as well, so we know what to draw for object
-               selection */
-            _data->objects[objectId].meshId = meshId;
-
             Containers::ArrayView<const Matrix4> skinJointMatrices = _data->objects[objectId].skinJointMatrices;
 
             Shaders::PhongGL::Flags flags;
@@ -1295,9 +2268,18 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
                 if(mesh->primitive() == GL::MeshPrimitive::Triangles ||
                    mesh->primitive() == GL::MeshPrimitive::TriangleStrip ||
                    mesh->primitive() == GL::MeshPrimitive::TriangleFan)
-                    new PhongDrawable{*object, phongShader(flags|(skinJointMatrices.isEmpty() ? Shaders::PhongGL::Flags{} : Shaders::PhongGL::Flag::DynamicPerVertexJointCount)), *mesh, objectId, 0xffffff_rgbf, skinJointMatrices, _data->meshes[meshId].perVertexJointCount, _data->meshes[meshId].secondaryPerVertexJointCount,  _shadeless, _data->opaqueDrawables};
+                    (new PhongDrawable{*object, phongShader(flags|(skinJointMatrices.isEmpty() ? Shaders::PhongGL::Flags{} : Shaders::PhongGL::Flag::DynamicPerVertexJointCount)), *mesh, objectId, 0xffffff_rgbf, skinJointMatrices, _data->meshes[meshId].perVertexJointCount, _data->meshes[meshId].secondaryPerVertexJointCount,  _shadeless, _data->opaqueDrawables})
+                        ->setCullingBounds(_data->meshes[meshId].bounds)
+                        .setLods(_data->meshes[meshId].lods)
+                        .setJointMatrixUploads(_data->jointMatrixUploads)
+                        .setDequantization(_data->meshes[meshId].dequantization)
+                        .setLightCulling(_flags >= ScenePlayerFlag::LightCulling ? &_data->lightCulling : nullptr);
                 else
-                    new FlatDrawable{*object, flatShader((hasVertexColors[meshId] ? Shaders::FlatGL3D::Flag::VertexColor : Shaders::FlatGL3D::Flags{})|(skinJointMatrices.isEmpty() ? Shaders::FlatGL3D::Flags{} : Shaders::FlatGL3D::Flag::DynamicPerVertexJointCount)), *mesh, objectId, 0xffffff_rgbf, Vector3{Constants::nan()}, skinJointMatrices, _data->meshes[meshId].perVertexJointCount, _data->meshes[meshId].secondaryPerVertexJointCount, _data->opaqueDrawables};
+                    (new FlatDrawable{*object, flatShader((hasVertexColors[meshId] ? Shaders::FlatGL3D::Flag::VertexColor : Shaders::FlatGL3D::Flags{})|(skinJointMatrices.isEmpty() ? Shaders::FlatGL3D::Flags{} : Shaders::FlatGL3D::Flag::DynamicPerVertexJointCount)), *mesh, objectId, 0xffffff_rgbf, Vector3{Constants::nan()}, skinJointMatrices, _data->meshes[meshId].perVertexJointCount, _data->meshes[meshId].secondaryPerVertexJointCount, _data->opaqueDrawables})
+                        ->setCullingBounds(_data->meshes[meshId].bounds)
+                        .setLods(_data->meshes[meshId].lods)
+                        .setJointMatrixUploads(_data->jointMatrixUploads)
+                        .setDequantization(_data->meshes[meshId].dequantization);
 
             /* Material available */
             } else {
@@ -1342,12 +2324,17 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
                     }
                 }
 
-                new PhongDrawable{*object, phongShader(flags|(skinJointMatrices.isEmpty() ? Shaders::PhongGL::Flags{} : Shaders::PhongGL::Flag::DynamicPerVertexJointCount)),
+                (new PhongDrawable{*object, phongShader(flags|(skinJointMatrices.isEmpty() ? Shaders::PhongGL::Flags{} : Shaders::PhongGL::Flag::DynamicPerVertexJointCount)),
                     *mesh, objectId,
                     material.diffuseColor(), diffuseTexture, normalTexture, normalTextureScale,
                     material.alphaMask(), material.commonTextureMatrix(), skinJointMatrices, _data->meshes[meshId].perVertexJointCount, _data->meshes[meshId].secondaryPerVertexJointCount, _shadeless,
                     material.alphaMode() == Trade::MaterialAlphaMode::Blend ?
-                        _data->transparentDrawables : _data->opaqueDrawables};
+                        _data->transparentDrawables : _data->opaqueDrawables})
+                    ->setCullingBounds(_data->meshes[meshId].bounds)
+                    .setLods(_data->meshes[meshId].lods)
+                    .setJointMatrixUploads(_data->jointMatrixUploads)
+                    .setDequantization(_data->meshes[meshId].dequantization)
+                    .setLightCulling(_flags >= ScenePlayerFlag::LightCulling ? &_data->lightCulling : nullptr);
             }
         }
 
@@ -1360,7 +2347,11 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
         _data->objects[0].object = &_data->scene;
         _data->objects[0].meshId = 0;
         _data->objects[0].name = "object #0";
-        new PhongDrawable{_data->scene, phongShader(hasVertexColors[0] ? Shaders::PhongGL::Flag::VertexColor : Shaders::PhongGL::Flags{}), *_data->meshes[0].mesh, 0, 0xffffff_rgbf, nullptr, 0, 0, _shadeless, _data->opaqueDrawables};
+        (new PhongDrawable{_data->scene, phongShader(hasVertexColors[0] ? Shaders::PhongGL::Flag::VertexColor : Shaders::PhongGL::Flags{}), *_data->meshes[0].mesh, 0, 0xffffff_rgbf, nullptr, 0, 0, _shadeless, _data->opaqueDrawables})
+            ->setCullingBounds(_data->meshes[0].bounds)
+            .setLods(_data->meshes[0].lods)
+            .setDequantization(_data->meshes[0].dequantization)
+            .setLightCulling(_flags >= ScenePlayerFlag::LightCulling ? &_data->lightCulling : nullptr);
     }
 
     /* Add joint drawables for all skins to fill the skinJointMatrices array */
@@ -1409,6 +2400,11 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
             0xffcccc_rgbf,
             0xccccff_rgbf
         });
+        _data->lightCulling.ranges = Containers::array({
+            Constants::inf(),
+            Constants::inf(),
+            Constants::inf()
+        });
     }
 
     /* Initialize light colors for all instantiated shaders */
@@ -1432,6 +2428,12 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
         Containers::Optional<Trade::CameraData> camera = importer.camera(0);
         if(camera) _data->camera->setProjectionMatrix(Matrix4::perspectiveProjection(camera->fov(), 1.0f, camera->near(), camera->far()));
     }
+    /* On reload keep the view as it was */
+    if(previous) {
+        _data->cameraObject->setTransformation(previous->cameraObject->transformation());
+        _data->visualizeObjects = previous->visualizeObjects;
+    }
+    endSection("scene"_s);
 
     /* Import animations */
     if(importer.animationCount())
@@ -1443,6 +2445,33 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
             continue;
         }
 
+        /* Instead of adding all tracks to the player, add just a single one
+           with the animation time, and look up the pose from the baked
+           samples */
+        if(_flags >= ScenePlayerFlag::BakeAnimations) {
+            _data->bakedAnimation = bakeAnimation(*animation, _data->objects);
+            Debug{} << "Baked" << _data->bakedAnimation.tracks.size() << "animation tracks into" << _data->bakedAnimation.sampleCount << "samples each";
+            if(!_data->bakedAnimation.tracks.isEmpty())
+                _data->player.addWithCallbackOnChange(
+                    Animation::TrackView<const Float, const Float>{_data->bakedAnimation.timeData, Math::lerp},
+                    [](Float, const Float& time, BakedAnimation& animation) {
+                        applyBakedAnimation(animation, time);
+                    }, _data->bakedAnimation.time, _data->bakedAnimation);
+            sectionSize += animation->data().size();
+
+            /* Load only the first animation at the moment */
+            break;
+        }
+
+        /* Tracks are added with callbacks called only if the value changes,
+           which avoids marking the object and its whole subtree dirty
+           every frame for tracks that have a constant value or for
+           animations that finished playing. Initializing the values to NaN
+           makes the callback called on the first advance as NaN never
+           compares equal. */
+        _data->animatedVectors = Containers::Array<Vector3>{DirectInit, animation->trackCount(), Constants::nan()};
+        _data->animatedRotations = Containers::Array<Quaternion>{DirectInit, animation->trackCount(), Vector3{Constants::nan()}, Constants::nan()};
+
         for(UnsignedInt j = 0; j != animation->trackCount(); ++j) {
             if(animation->trackTarget(j) >= _data->objects.size() || !_data->objects[animation->trackTarget(j)].object)
                 continue;
@@ -1454,48 +2483,70 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
                     object.setTranslation(translation);
                 };
                 if(animation->trackType(j) == Trade::AnimationTrackType::CubicHermite3D) {
-                    _data->player.addWithCallback(animation->track<CubicHermite3D>(j),
-                        callback, animatedObject);
+                    _data->player.addWithCallbackOnChange(animation->track<CubicHermite3D>(j),
+                        callback, _data->animatedVectors[j], animatedObject);
                 } else {
                     CORRADE_INTERNAL_ASSERT(animation->trackType(j) == Trade::AnimationTrackType::Vector3);
-                    _data->player.addWithCallback(animation->track<Vector3>(j),
-                        callback, animatedObject);
+                    _data->player.addWithCallbackOnChange(animation->track<Vector3>(j),
+                        callback, _data->animatedVectors[j], animatedObject);
                 }
             } else if(animation->trackTargetName(j) == Trade::AnimationTrackTarget::Rotation3D) {
                 const auto callback = [](Float, const Quaternion& rotation, Object3D& object) {
                     object.setRotation(rotation);
                 };
                 if(animation->trackType(j) == Trade::AnimationTrackType::CubicHermiteQuaternion) {
-                    _data->player.addWithCallback(animation->track<CubicHermiteQuaternion>(j),
-                        callback, animatedObject);
+                    _data->player.addWithCallbackOnChange(animation->track<CubicHermiteQuaternion>(j),
+                        callback, _data->animatedRotations[j], animatedObject);
                 } else {
                     CORRADE_INTERNAL_ASSERT(animation->trackType(j) == Trade::AnimationTrackType::Quaternion);
-                    _data->player.addWithCallback(animation->track<Quaternion>(j),
-                        callback, animatedObject);
+                    _data->player.addWithCallbackOnChange(animation->track<Quaternion>(j),
+                        callback, _data->animatedRotations[j], animatedObject);
                 }
             } else if(animation->trackTargetName(j) == Trade::AnimationTrackTarget::Scaling3D) {
                 const auto callback = [](Float, const Vector3& scaling, Object3D& object) {
                     object.setScaling(scaling);
                 };
                 if(animation->trackType(j) == Trade::AnimationTrackType::CubicHermite3D) {
-                    _data->player.addWithCallback(animation->track<CubicHermite3D>(j),
-                        callback, animatedObject);
+                    _data->player.addWithCallbackOnChange(animation->track<CubicHermite3D>(j),
+                        callback, _data->animatedVectors[j], animatedObject);
                 } else {
                     CORRADE_INTERNAL_ASSERT(animation->trackType(j) == Trade::AnimationTrackType::Vector3);
-                    _data->player.addWithCallback(animation->track<Vector3>(j),
-                        callback, animatedObject);
+                    _data->player.addWithCallbackOnChange(animation->track<Vector3>(j),
+                        callback, _data->animatedVectors[j], animatedObject);
                 }
             } else CORRADE_INTERNAL_ASSERT_UNREACHABLE();
         }
+        sectionSize += animation->data().size();
         _data->animationData = animation->release();
 
         /* Load only the first animation at the moment */
         break;
     }
 
-    /* Populate the model info */
+    endSection("animations"_s);
+
+    setupTransformations(*_data);
+
+    precompileMeshVisualizerShaders();
+    endSection("shaders"_s);
+
+    std::chrono::steady_clock::duration totalDuration{};
+    for(const LoadSection& section: sections)
+        totalDuration += section.duration;
+    if(importer.flags() >= Trade::ImporterFlag::Verbose) {
+        Debug{} << "Load timings:";
+        for(const LoadSection& section: sections)
+            Debug{} << Utility::format("  {}: {:.2f} ms, {:.1f} kB", section.name, std::chrono::duration<Double, std::milli>(section.duration).count(), section.size/1024.0);
+        Debug{} << Utility::format("  total: {:.2f} ms", std::chrono::duration<Double, std::milli>(totalDuration).count());
+    }
+
+    /* Populate the model info, together with the total load time and the two
+       slowest sections */
+    std::sort(sections.begin(), sections.end(), [](const LoadSection& a, const LoadSection& b) {
+        return a.duration > b.duration;
+    });
     _modelInfo.setText(Containers::ArrayView<const char>{Utility::format(
-        "{}: {} objs, {} cams, {} meshes, {} mats, {}/{} texs, {} anims",
+        "{}: {} objs, {} cams, {} meshes, {} mats, {}/{} texs, {} anims, loaded in {:.0f} ms ({} {:.0f}, {} {:.0f})",
         Utility::Path::split(filename).second(),
         importer.objectCount(),
         importer.cameraCount(),
@@ -1503,7 +2554,10 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
         importer.materialCount(),
         importer.textureCount(),
         importer.image2DCount(),
-        importer.animationCount())},
+        importer.animationCount(),
+        std::chrono::duration<Double, std::milli>(totalDuration).count(),
+        sections[0].name, std::chrono::duration<Double, std::milli>(sections[0].duration).count(),
+        sections[1].name, std::chrono::duration<Double, std::milli>(sections[1].duration).count())},
         /** @todo ugh, having to specify this every time is NASTY, what to do
             besides supplying extra style variants? */
         Text::Alignment::MiddleLeft);
@@ -1527,7 +2581,65 @@ void ScenePlayer::load(Containers::StringView filename, Trade::AbstractImporter&
     }
 }
 
+namespace {
+
+bool jointMatricesNeedUpload(JointMatrixUploads* const uploads, const GL::AbstractShaderProgram& shader, const Containers::ArrayView<const Matrix4> jointMatrices) {
+    if(!uploads)
+        return true;
+
+    /* There's usually just a handful of distinct shaders, so a linear search
+       is fine */
+    for(Containers::Pair<const GL::AbstractShaderProgram*, Containers::ArrayView<const Matrix4>>& upload: *uploads) {
+        if(upload.first() != &shader)
+            continue;
+        if(upload.second().data() == jointMatrices.data() &&
+           upload.second().size() == jointMatrices.size())
+            return false;
+        upload.second() = jointMatrices;
+        return true;
+    }
+
+    arrayAppend(*uploads, InPlaceInit, &shader, jointMatrices);
+    return true;
+}
+
+/* Picks a LOD based on an approximate screen-space size of the bounding
+   sphere, relative to the viewport height. Each successive level has roughly
+   a quarter of the primitives, so it's used once the object gets four times
+   smaller. */
+GL::Mesh& lodMesh(GL::Mesh& mesh, const Containers::ArrayView<MeshLod> lods, const Range3D& bounds, const Matrix4& transformationMatrix, const Matrix4& projectionMatrix) {
+    if(lods.isEmpty())
+        return mesh;
+
+    const Float radius = (bounds.size()*transformationMatrix.scaling()).length()*0.5f;
+    Float size = radius*projectionMatrix[1][1];
+    /* For a perspective projection divide by the distance, clamped to the
+       radius to not pick a LOD when the camera is inside the bounds */
+    if(projectionMatrix[3][3] == 0.0f)
+        size /= Math::max(-transformationMatrix.transformPoint(bounds.center()).z(), radius);
+
+    GL::Mesh* out = &mesh;
+    Float threshold = 0.5f;
+    for(MeshLod& lod: lods) {
+        if(size >= threshold)
+            break;
+        out = &lod.mesh;
+        threshold *= 0.25f;
+    }
+    return *out;
+}
+
+}
+
 void FlatDrawable::draw(const Matrix4& transformationMatrix, SceneGraph::Camera3D& camera) {
+    /* Skip the draw if the mesh is fully outside of the camera frustum. The
+       frustum is transformed to the mesh space instead of transforming the
+       bounding box to the camera space, which is simpler to calculate. For a
+       skinned mesh the positions don't correspond to the bounds, so it's
+       always drawn. */
+    if(_cullingBounds && !_jointMatrices && !Math::Intersection::rangeFrustum(*_cullingBounds, Frustum::fromMatrix(camera.projectionMatrix()*transformationMatrix)))
+        return;
+
     /* Override the inherited scale, if requested */
     Matrix4 transformation;
     if(_scale == _scale) transformation =
@@ -1537,11 +2649,12 @@ void FlatDrawable::draw(const Matrix4& transformationMatrix, SceneGraph::Camera3
 
     _shader
         .setColor(_color)
-        .setTransformationProjectionMatrix(camera.projectionMatrix()*transformation)
+        .setTransformationProjectionMatrix(camera.projectionMatrix()*transformation*_dequantization)
         .setObjectId(_objectId);
 
+    if(_jointMatrices && jointMatricesNeedUpload(_jointMatrixUploads, _shader, _jointMatrices))
+        _shader.setJointMatrices(_jointMatrices);
     if(_jointMatrices) _shader
-        .setJointMatrices(_jointMatrices)
         .setPerVertexJointCount(_perVertexJointCount,
             /* see ScenePlayer::flatShader() above for details */
             #ifndef MAGNUM_TARGET_WEBGL
@@ -1551,10 +2664,15 @@ void FlatDrawable::draw(const Matrix4& transformationMatrix, SceneGraph::Camera3
             #endif
         );
 
-    _shader.draw(_mesh);
+    _shader.draw(_cullingBounds && !_jointMatrices ?
+        lodMesh(_mesh, _lods, *_cullingBounds, transformation, camera.projectionMatrix()) : _mesh);
 }
 
 void PhongDrawable::draw(const Matrix4& transformationMatrix, SceneGraph::Camera3D& camera) {
+    /* Same as in FlatDrawable::draw() */
+    if(_cullingBounds && !_jointMatrices && !Math::Intersection::rangeFrustum(*_cullingBounds, Frustum::fromMatrix(camera.projectionMatrix()*transformationMatrix)))
+        return;
+
     /* If the mesh is skinned, its root-relative transformation is coming fully
        from the joint transforms alone, thus we only need the camera-relative
        transform here. Transformation of the object is used only for
@@ -1565,7 +2683,7 @@ void PhongDrawable::draw(const Matrix4& transformationMatrix, SceneGraph::Camera
     if(_jointMatrices)
         usedTransformationMatrix = camera.cameraMatrix();
     else
-        usedTransformationMatrix = transformationMatrix;
+        usedTransformationMatrix = transformationMatrix*_dequantization;
 
     _shader
         .setTransformationMatrix(usedTransformationMatrix)
@@ -1573,8 +2691,44 @@ void PhongDrawable::draw(const Matrix4& transformationMatrix, SceneGraph::Camera
         .setProjectionMatrix(camera.projectionMatrix())
         .setObjectId(_objectId);
 
+    /* Pick lights that can reach a bounding sphere of the mesh, directional
+       lights and lights with infinite range always pass. The shader is
+       created with enough lights for all of them, so the subset is uploaded
+       to the front and the rest disabled via the per-draw light count. */
+    if(_lightCulling) {
+        LightCulling& culling = *_lightCulling;
+        arrayResize(culling.culledPositions, 0);
+        arrayResize(culling.culledColors, 0);
+        arrayResize(culling.culledRanges, 0);
+        const bool cull = _cullingBounds && !_jointMatrices;
+        Vector3 center;
+        Float radius{};
+        if(cull) {
+            center = transformationMatrix.transformPoint(_cullingBounds->center());
+            radius = (_cullingBounds->size()*0.5f).length()*transformationMatrix.scaling().max();
+        }
+        for(std::size_t i = 0; i != culling.positions.size(); ++i) {
+            const Vector4& position = culling.positions[i];
+            const Float range = culling.ranges[i];
+            if(cull && position.w() && range != Constants::inf() &&
+               (position.xyz() - center).dot() > Math::pow<2>(range + radius))
+                continue;
+
+            arrayAppend(culling.culledPositions, position);
+            arrayAppend(culling.culledColors, culling.colors[i]);
+            arrayAppend(culling.culledRanges, range);
+        }
+
+        _shader
+            .setLightPositions(0, culling.culledPositions)
+            .setLightColors(0, culling.culledColors)
+            .setLightRanges(0, culling.culledRanges)
+            .setPerDrawLightCount(culling.culledPositions.size());
+    }
+
+    if(_jointMatrices && jointMatricesNeedUpload(_jointMatrixUploads, _shader, _jointMatrices))
+        _shader.setJointMatrices(_jointMatrices);
     if(_jointMatrices) _shader
-        .setJointMatrices(_jointMatrices)
         .setPerVertexJointCount(_perVertexJointCount,
             /* see ScenePlayer::flatShader() above for details */
             #ifndef MAGNUM_TARGET_WEBGL
@@ -1607,7 +2761,8 @@ void PhongDrawable::draw(const Matrix4& transformationMatrix, SceneGraph::Camera
     if(_shader.flags() & Shaders::PhongGL::Flag::DoubleSided)
         GL::Renderer::disable(GL::Renderer::Feature::FaceCulling);
 
-    _shader.draw(_mesh);
+    _shader.draw(_cullingBounds && !_jointMatrices ?
+        lodMesh(_mesh, _lods, *_cullingBounds, transformationMatrix, camera.projectionMatrix()) : _mesh);
 
     if(_shader.flags() & Shaders::PhongGL::Flag::DoubleSided)
         GL::Renderer::enable(GL::Renderer::Feature::FaceCulling);
@@ -1627,7 +2782,7 @@ void MeshVisualizerDrawable::draw(const Matrix4& transformationMatrix, SceneGrap
     if(_jointMatrices)
         usedTransformationMatrix = camera.cameraMatrix();
     else
-        usedTransformationMatrix = transformationMatrix;
+        usedTransformationMatrix = transformationMatrix*_dequantization;
 
     (*_shader)
         .setProjectionMatrix(camera.projectionMatrix())
@@ -1674,9 +2829,119 @@ void MeshVisualizerDrawable::draw(const Matrix4& transformationMatrix, SceneGrap
     GL::Renderer::disable(GL::Renderer::Feature::PolygonOffsetFill);
 }
 
+namespace {
+
+/* Has to be called before any camera draw in the frame, as those clean the
+   camera object and its parents */
+void updateTransformations(Data& data) {
+    data.dirtyObjects.clear();
+    for(std::size_t i = 0; i != data.transformationObjects.size(); ++i) {
+        Object3D& object = *data.transformationObjects[i].first();
+        if(!object.isDirty())
+            continue;
+
+        /* Dirtiness propagates to all children, so if the parent wasn't dirty
+           its cached transformation is up-to-date */
+        const UnsignedInt parent = data.transformationObjects[i].second();
+        data.absoluteTransformations[i] = parent == 0xffffffffu ?
+            object.transformationMatrix() :
+            data.absoluteTransformations[parent]*object.transformationMatrix();
+        data.dirtyObjects.emplace_back(object);
+    }
+
+    if(!data.dirtyObjects.empty())
+        Object3D::setClean(data.dirtyObjects);
+}
+
+/* Draws given group with transformations calculated in
+   updateTransformations(). If the set of drawables doesn't match the cache,
+   such as when the load was aborted, falls back to a regular draw. */
+void drawGroup(Data& data, SceneGraph::Camera3D& camera, const Matrix4& cameraMatrix, SceneGraph::DrawableGroup3D& group, const Containers::ArrayView<const UnsignedInt> transformationIds) {
+    if(transformationIds.size() != group.size()) {
+        camera.draw(group);
+        return;
+    }
+
+    data.drawableTransformations.clear();
+    for(std::size_t i = 0; i != group.size(); ++i)
+        data.drawableTransformations.emplace_back(group[i], cameraMatrix*data.absoluteTransformations[transformationIds[i]]);
+    camera.draw(data.drawableTransformations);
+}
+
+void drawTransparentDrawables(Data& data) {
+    std::vector<std::pair<std::reference_wrapper<SceneGraph::Drawable3D>, Matrix4>>& drawableTransformations = data.transparentDrawableTransformations;
+    const Containers::ArrayView<UnsignedInt> transformationIds = data.transparentDrawableTransformationIds;
+
+    /* If the set of drawables changed, populate the list from scratch.
+       Otherwise keep the order from the previous frame and update just the
+       transformations. */
+    if(drawableTransformations.size() != data.transparentDrawables.size()) {
+        drawableTransformations.clear();
+        for(std::size_t i = 0; i != data.transparentDrawables.size(); ++i)
+            drawableTransformations.emplace_back(data.transparentDrawables[i], Matrix4{});
+    }
+    const Matrix4 cameraMatrix = data.camera->cameraMatrix();
+    const bool cached = transformationIds.size() == drawableTransformations.size();
+    for(std::size_t i = 0; i != drawableTransformations.size(); ++i)
+        drawableTransformations[i].second = cameraMatrix*(cached ?
+            data.absoluteTransformations[transformationIds[i]] :
+            drawableTransformations[i].first.get().object().absoluteTransformationMatrix());
+
+    /* Sort back-to-front. The order usually changes only slightly between
+       frames, for which an insertion sort is close to linear. */
+    for(std::size_t i = 1; i < drawableTransformations.size(); ++i) {
+        std::pair<std::reference_wrapper<SceneGraph::Drawable3D>, Matrix4> current = drawableTransformations[i];
+        const UnsignedInt currentId = cached ? transformationIds[i] : 0;
+        const Float z = current.second.translation().z();
+        std::size_t j = i;
+        for(; j > 0 && drawableTransformations[j - 1].second.translation().z() < z; --j) {
+            drawableTransformations[j] = drawableTransformations[j - 1];
+            if(cached) transformationIds[j] = transformationIds[j - 1];
+        }
+        drawableTransformations[j] = current;
+        if(cached) transformationIds[j] = currentId;
+    }
+
+    data.camera->draw(drawableTransformations);
+}
+
+}
+
+void ScenePlayer::benchmarkFrame(const UnsignedInt frame, const UnsignedInt frameCount) {
+    if(!_data) return;
+
+    /* If there's an animation, play it in a loop from the start */
+    if(!_data->player.isEmpty()) {
+        if(!frame) {
+            _data->player.stop();
+            _data->player.setPlayCount(0);
+            _data->player.play(std::chrono::system_clock::now().time_since_epoch());
+        }
+        return;
+    }
+
+    /* Otherwise orbit the camera around the scene origin, doing a full turn
+       over the whole benchmark */
+    const Quaternion rotation = Quaternion::rotation(Rad{Constants::tau()/frameCount}, Vector3::yAxis());
+    (*_data->cameraObject)
+        .setTranslation(rotation.transformVector(_data->cameraObject->translation()))
+        .setRotation(rotation*_data->cameraObject->rotation());
+}
+
 void ScenePlayer::drawEvent() {
     _profiler.beginFrame();
 
+    /* Resolve a pending object selection first so the visualizer is drawn
+       already in this frame */
+    #if !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+    if(_selectionReadbackFrames && !--_selectionReadbackFrames) {
+        const Containers::ArrayView<const char> data = _selectionReadback.buffer().map(0, sizeof(UnsignedShort), GL::Buffer::MapFlag::Read);
+        const UnsignedInt selectedId = data.isEmpty() ? 0xffff : Containers::arrayCast<const UnsignedShort>(data)[0];
+        _selectionReadback.buffer().unmap();
+        if(_data) selectObject(selectedId);
+    } else if(_selectionReadbackFrames) redraw();
+    #endif
+
     /* Another FB could be bound from a depth / object ID read (moreover with
        color output disabled), set it back to the default framebuffer */
     GL::defaultFramebuffer.bind(); /** @todo mapForDraw() should bind implicitly */
@@ -1689,23 +2954,30 @@ void ScenePlayer::drawEvent() {
     if(_data) {
         _data->player.advance(std::chrono::system_clock::now().time_since_epoch());
 
+        /* Recalculate transformations of objects that changed since the last
+           frame, they're then reused by all passes below */
+        updateTransformations(*_data);
+        const Matrix4 cameraMatrix = _data->camera->cameraMatrix();
+
         /* Calculate light positions first, upload them to all shaders -- all
            of them are there only if they are actually used, so it's not doing
            any wasteful work */
         arrayResize(_data->lightPositions, 0);
-        _data->camera->draw(_data->lightDrawables);
+        drawGroup(*_data, *_data->camera, cameraMatrix, _data->lightDrawables, _data->lightDrawableTransformations);
         CORRADE_INTERNAL_ASSERT(_data->lightPositions.size() == _data->lightCount);
         for(auto&& shader: _phongShaders)
             shader.second.setLightPositions(_data->lightPositions);
+        _data->lightCulling.positions = _data->lightPositions;
 
         /* Calculate animated joint positions, filling the
            _data->skinJointMatrices with them, which is then referenced by
            skinned meshes. These should be relative to scene root so it's drawn
            with a camera that has an identity transformation. */
-        _data->rootCamera->draw(_data->jointDrawables);
+        drawGroup(*_data, *_data->rootCamera, Matrix4{}, _data->jointDrawables, _data->jointDrawableTransformations);
+        arrayResize(_data->jointMatrixUploads, 0);
 
         /* Draw opaque stuff as usual */
-        _data->camera->draw(_data->opaqueDrawables);
+        drawGroup(*_data, *_data->camera, cameraMatrix, _data->opaqueDrawables, _data->opaqueDrawableTransformations);
 
         /* Draw transparent stuff back-to-front with blending enabled */
         if(!_data->transparentDrawables.isEmpty()) {
@@ -1714,14 +2986,7 @@ void ScenePlayer::drawEvent() {
             /* Ugh non-premultiplied alpha */
             GL::Renderer::setBlendFunction(GL::Renderer::BlendFunction::SourceAlpha, GL::Renderer::BlendFunction::OneMinusSourceAlpha);
 
-            std::vector<std::pair<std::reference_wrapper<SceneGraph::Drawable3D>, Matrix4>>
-                drawableTransformations = _data->camera->drawableTransformations(_data->transparentDrawables);
-            std::sort(drawableTransformations.begin(), drawableTransformations.end(),
-                [](const std::pair<std::reference_wrapper<SceneGraph::Drawable3D>, Matrix4>& a,
-                   const std::pair<std::reference_wrapper<SceneGraph::Drawable3D>, Matrix4>& b) {
-                    return a.second.translation().z() > b.second.translation().z();
-                });
-            _data->camera->draw(drawableTransformations);
+            drawTransparentDrawables(*_data);
 
             GL::Renderer::setBlendFunction(GL::Renderer::BlendFunction::One, GL::Renderer::BlendFunction::Zero);
             GL::Renderer::disable(GL::Renderer::Feature::Blending);
@@ -1744,18 +3009,23 @@ void ScenePlayer::drawEvent() {
         /* Draw object visualization w/o a depth buffer */
         if(_data->visualizeObjects) {
             GL::Renderer::disable(GL::Renderer::Feature::DepthTest);
-            _data->camera->draw(_data->objectVisualizationDrawables);
+            drawGroup(*_data, *_data->camera, cameraMatrix, _data->objectVisualizationDrawables, _data->objectVisualizationDrawableTransformations);
             GL::Renderer::enable(GL::Renderer::Feature::DepthTest);
         }
+
+        /* Stream in the next image only after the frame is drawn, so the
+           first frame after a load shows up with placeholders right away */
+        if(_data->streamingImporter)
+            streamTexture();
     }
 
     /* Don't profile UI drawing */
     _profiler.endFrame();
     _profiler.printStatistics(_profilerOut, 10);
 
-    /* Schedule a redraw only if profiling is enabled or the player is playing
-       to avoid hogging the CPU */
-    if(_profiler.isEnabled() || (_data && _data->player.state() == Animation::State::Playing))
+    /* Schedule a redraw only if profiling is enabled, the player is playing
+       or there are textures left to stream to avoid hogging the CPU */
+    if(_profiler.isEnabled() || (_data && (_data->player.state() == Animation::State::Playing || _data->streamingImporter)))
         redraw();
 
     #ifdef MAGNUM_TARGET_WEBGL
@@ -1914,6 +3184,104 @@ void ScenePlayer::keyPressEvent(KeyEvent& event) {
     redraw();
 }
 
+void ScenePlayer::selectObject(const UnsignedInt selectedId) {
+    /* Show either global or object-specific widgets */
+    if(selectedId < _data->objects.size()) {
+        _ui.clearNodeFlags(_objectInfo, Ui::NodeFlag::Hidden);
+        _ui.clearNodeFlags(_cycleMeshVisualization, Ui::NodeFlag::Hidden);
+        _ui.addNodeFlags(_modelInfo, Ui::NodeFlag::Hidden);
+        _ui.addNodeFlags(_toggleObjectVisualization, Ui::NodeFlag::Hidden);
+    } else {
+        _ui.addNodeFlags(_objectInfo, Ui::NodeFlag::Hidden);
+        _ui.addNodeFlags(_cycleMeshVisualization, Ui::NodeFlag::Hidden);
+        _ui.clearNodeFlags(_modelInfo, Ui::NodeFlag::Hidden);
+        _ui.clearNodeFlags(_toggleObjectVisualization, Ui::NodeFlag::Hidden);
+    }
+
+    /* If nothing is selected, the global info is shown */
+    if(selectedId >= _data->objects.size()) {
+        /* 0xffff is the background, but anything else is just wrong */
+        if(selectedId != 0xffff)
+            Warning{} << "Selected ID" << selectedId << "out of range for" << _data->objects.size() << "objects, ignoring";
+
+    /* Otherwise add a visualizer and update the info */
+    } else {
+        CORRADE_INTERNAL_ASSERT(!_data->selectedObject);
+        CORRADE_INTERNAL_ASSERT(selectedId < _data->objects.size());
+        CORRADE_INTERNAL_ASSERT(_data->objects[selectedId].object);
+
+        const ObjectInfo& objectInfo = _data->objects[selectedId];
+
+        /* A mesh is selected */
+        Containers::String objectInfoString;
+        if(objectInfo.meshId != 0xffffffffu) {
+            CORRADE_INTERNAL_ASSERT(_data->meshes[objectInfo.meshId].mesh);
+            MeshInfo& meshInfo = _data->meshes[objectInfo.meshId];
+
+            /* Create a visualizer for the selected object */
+            _data->selectedObject = new MeshVisualizerDrawable{
+                *objectInfo.object, meshVisualizerShader(objectInfo.meshId, !objectInfo.skinJointMatrices.isEmpty()),
+                *meshInfo.mesh, objectInfo.meshId,
+                meshInfo.objectIdCount, meshInfo.vertices,
+                #ifndef MAGNUM_TARGET_GLES
+                meshInfo.primitives,
+                #endif
+                objectInfo.skinJointMatrices, meshInfo.perVertexJointCount, meshInfo.secondaryPerVertexJointCount,
+                _shadeless, _data->selectedObjectDrawables};
+            _data->selectedObject->setDequantization(meshInfo.dequantization);
+
+            /* Show mesh info */
+            objectInfoString = Utility::format(
+                /** @todo wait, what about non-indexed? */
+                "{}: mesh {}, indexed, {} attribs, {} verts, {} prims, {:.1f} kB",
+                objectInfo.name,
+                meshInfo.name,
+                meshInfo.attributes,
+                meshInfo.vertices,
+                meshInfo.primitives,
+                meshInfo.size/1024.0f);
+            for(std::size_t i = 0; i != meshInfo.lods.size(); ++i)
+                objectInfoString = Utility::format("{}{}{}{}",
+                    objectInfoString,
+                    i ? ", " : ", LODs with ",
+                    meshInfo.lods[i].primitives,
+                    i + 1 == meshInfo.lods.size() ? " prims" : "");
+            if(meshInfo.optimizedAcmr)
+                objectInfoString = Utility::format("{}, ACMR {:.2f} -> {:.2f}",
+                    objectInfoString,
+                    meshInfo.acmr,
+                    meshInfo.optimizedAcmr);
+
+        /* A light is selected */
+        } else if(_data->objects[selectedId].lightId != 0xffffffffu) {
+            CORRADE_INTERNAL_ASSERT(_data->lights[_data->objects[selectedId].lightId].light);
+            LightInfo& lightInfo = _data->lights[_data->objects[selectedId].lightId];
+
+            objectInfoString = Utility::format(
+                "{}: {} {}, range {}, intensity {}",
+                objectInfo.name,
+                lightInfo.type,
+                lightInfo.name,
+                lightInfo.light->range(),
+                lightInfo.light->intensity());
+
+        /* Something else is selected from object visualization, display
+           just generic info */
+        } else {
+            objectInfoString = Utility::format(
+                "{}: {}, {} children",
+                objectInfo.name,
+                objectInfo.type,
+                objectInfo.childCount);
+        }
+
+        _objectInfo.setText(objectInfoString,
+            /** @todo ugh, having to specify this every time is NASTY, what
+                to do besides supplying extra style variants? */
+            Text::Alignment::MiddleLeft);
+    }
+}
+
 void ScenePlayer::pointerPressEvent(PointerEvent& event) {
     if(!event.isPrimary())
         return;
@@ -1938,8 +3306,12 @@ void ScenePlayer::pointerPressEvent(PointerEvent& event) {
 
         /** @todo reduce duplication in the below code */
 
+        /* The camera could have moved since the last frame */
+        updateTransformations(*_data);
+        const Matrix4 cameraMatrix = _data->camera->cameraMatrix();
+
         /* Draw opaque stuff as usual */
-        _data->camera->draw(_data->opaqueDrawables);
+        drawGroup(*_data, *_data->camera, cameraMatrix, _data->opaqueDrawables, _data->opaqueDrawableTransformations);
 
         /* Draw transparent stuff back-to-front with blending enabled */
         if(!_data->transparentDrawables.isEmpty()) {
@@ -1948,14 +3320,7 @@ void ScenePlayer::pointerPressEvent(PointerEvent& event) {
             /* Ugh non-premultiplied alpha */
             GL::Renderer::setBlendFunction(GL::Renderer::BlendFunction::SourceAlpha, GL::Renderer::BlendFunction::OneMinusSourceAlpha);
 
-            std::vector<std::pair<std::reference_wrapper<SceneGraph::Drawable3D>, Matrix4>>
-                drawableTransformations = _data->camera->drawableTransformations(_data->transparentDrawables);
-            std::sort(drawableTransformations.begin(), drawableTransformations.end(),
-                [](const std::pair<std::reference_wrapper<SceneGraph::Drawable3D>, Matrix4>& a,
-                   const std::pair<std::reference_wrapper<SceneGraph::Drawable3D>, Matrix4>& b) {
-                    return a.second.translation().z() > b.second.translation().z();
-                });
-            _data->camera->draw(drawableTransformations);
+            drawTransparentDrawables(*_data);
 
             GL::Renderer::setBlendFunction(GL::Renderer::BlendFunction::One, GL::Renderer::BlendFunction::Zero);
             GL::Renderer::disable(GL::Renderer::Feature::Blending);
@@ -1965,7 +3330,7 @@ void ScenePlayer::pointerPressEvent(PointerEvent& event) {
         /* Draw object visualization w/o a depth buffer */
         if(_data->visualizeObjects) {
             GL::Renderer::disable(GL::Renderer::Feature::DepthTest);
-            _data->camera->draw(_data->objectVisualizationDrawables);
+            drawGroup(*_data, *_data->camera, cameraMatrix, _data->objectVisualizationDrawables, _data->objectVisualizationDrawableTransformations);
             GL::Renderer::enable(GL::Renderer::Feature::DepthTest);
         }
 
@@ -1980,6 +3345,17 @@ void ScenePlayer::pointerPressEvent(PointerEvent& event) {
         const Vector2i fbPosition{position.x(), _selectionFramebuffer.viewport().sizeY() - position.y() - 1};
         const Range2Di area = Range2Di::fromSize(fbPosition, Vector2i{1});
 
+        /* On platforms that support it, read the ID asynchronously into a
+           pixel pack buffer, which is then mapped in drawEvent() two frames
+           later, when the GPU should be done with it, instead of stalling
+           the pipeline right here */
+        #if !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+        _selectionFramebuffer.read(area, _selectionReadback, GL::BufferUsage::StreamRead);
+        _selectionReadbackFrames = 2;
+        /* The previous selection is gone already, so hide the visualization
+           cycling button until the new one is resolved */
+        _ui.addNodeFlags(_cycleMeshVisualization, Ui::NodeFlag::Hidden);
+        #else
         const UnsignedInt selectedId =
             /* WebGL requires the read format to be RGBA and UNSIGNED_INT.
                Okay, sure, but it feels extremely silly to do on all other
@@ -1989,91 +3365,8 @@ void ScenePlayer::pointerPressEvent(PointerEvent& event) {
             #else
             _selectionFramebuffer.read(area, {PixelFormat::RGBA32UI}).pixels<Vector4ui>()[0][0][0];
             #endif
-
-        /* Show either global or object-specific widgets */
-        if(selectedId < _data->objects.size()) {
-            _ui.clearNodeFlags(_objectInfo, Ui::NodeFlag::Hidden);
-            _ui.clearNodeFlags(_cycleMeshVisualization, Ui::NodeFlag::Hidden);
-            _ui.addNodeFlags(_modelInfo, Ui::NodeFlag::Hidden);
-            _ui.addNodeFlags(_toggleObjectVisualization, Ui::NodeFlag::Hidden);
-        } else {
-            _ui.addNodeFlags(_objectInfo, Ui::NodeFlag::Hidden);
-            _ui.addNodeFlags(_cycleMeshVisualization, Ui::NodeFlag::Hidden);
-            _ui.clearNodeFlags(_modelInfo, Ui::NodeFlag::Hidden);
-            _ui.clearNodeFlags(_toggleObjectVisualization, Ui::NodeFlag::Hidden);
-        }
-
-        /* If nothing is selected, the global info is shown */
-        if(selectedId >= _data->objects.size()) {
-            /* 0xffff is the background, but anything else is just wrong */
-            if(selectedId != 0xffff)
-                Warning{} << "Selected ID" << selectedId << "out of range for" << _data->objects.size() << "objects, ignoring";
-
-        /* Otherwise add a visualizer and update the info */
-        } else {
-            CORRADE_INTERNAL_ASSERT(!_data->selectedObject);
-            CORRADE_INTERNAL_ASSERT(selectedId < _data->objects.size());
-            CORRADE_INTERNAL_ASSERT(_data->objects[selectedId].object);
-
-            const ObjectInfo& objectInfo = _data->objects[selectedId];
-
-            /* A mesh is selected */
-            Containers::String objectInfoString;
-            if(objectInfo.meshId != 0xffffffffu) {
-                CORRADE_INTERNAL_ASSERT(_data->meshes[objectInfo.meshId].mesh);
-                MeshInfo& meshInfo = _data->meshes[objectInfo.meshId];
-
-                /* Create a visualizer for the selected object */
-                const Shaders::MeshVisualizerGL3D::Flags flags = setupVisualization(objectInfo.meshId);
-                _data->selectedObject = new MeshVisualizerDrawable{
-                    *objectInfo.object, meshVisualizerShader(flags|(objectInfo.skinJointMatrices.isEmpty() ? Shaders::MeshVisualizerGL3D::Flags{} : Shaders::MeshVisualizerGL3D::Flag::DynamicPerVertexJointCount)),
-                    *meshInfo.mesh, objectInfo.meshId,
-                    meshInfo.objectIdCount, meshInfo.vertices,
-                    #ifndef MAGNUM_TARGET_GLES
-                    meshInfo.primitives,
-                    #endif
-                    objectInfo.skinJointMatrices, meshInfo.perVertexJointCount, meshInfo.secondaryPerVertexJointCount,
-                    _shadeless, _data->selectedObjectDrawables};
-
-                /* Show mesh info */
-                objectInfoString = Utility::format(
-                    /** @todo wait, what about non-indexed? */
-                    "{}: mesh {}, indexed, {} attribs, {} verts, {} prims, {:.1f} kB",
-                    objectInfo.name,
-                    meshInfo.name,
-                    meshInfo.attributes,
-                    meshInfo.vertices,
-                    meshInfo.primitives,
-                    meshInfo.size/1024.0f);
-
-            /* A light is selected */
-            } else if(_data->objects[selectedId].lightId != 0xffffffffu) {
-                CORRADE_INTERNAL_ASSERT(_data->lights[_data->objects[selectedId].lightId].light);
-                LightInfo& lightInfo = _data->lights[_data->objects[selectedId].lightId];
-
-                objectInfoString = Utility::format(
-                    "{}: {} {}, range {}, intensity {}",
-                    objectInfo.name,
-                    lightInfo.type,
-                    lightInfo.name,
-                    lightInfo.light->range(),
-                    lightInfo.light->intensity());
-
-            /* Something else is selected from object visualization, display
-               just generic info */
-            } else {
-                objectInfoString = Utility::format(
-                    "{}: {}, {} children",
-                    objectInfo.name,
-                    objectInfo.type,
-                    objectInfo.childCount);
-            }
-
-            _objectInfo.setText(objectInfoString,
-                /** @todo ugh, having to specify this every time is NASTY, what
-                    to do besides supplying extra style variants? */
-                Text::Alignment::MiddleLeft);
-        }
+        selectObject(selectedId);
+        #endif
 
         event.setAccepted();
         redraw();
@@ -2169,8 +3462,8 @@ void ScenePlayer::scrollEvent(ScrollEvent& event) {
 
 }
 
-Containers::Pointer<AbstractPlayer> createScenePlayer(Platform::ScreenedApplication& application, Ui::UserInterface& ui, Ui::NodeHandle controls, const DebugTools::FrameProfilerGL::Values profilerValues) {
-    return Containers::Pointer<ScenePlayer>{InPlaceInit, application, ui, controls, profilerValues};
+Containers::Pointer<AbstractPlayer> createScenePlayer(Platform::ScreenedApplication& application, Ui::UserInterface& ui, Ui::NodeHandle controls, const DebugTools::FrameProfilerGL::Values profilerValues, const ScenePlayerFlags flags) {
+    return Containers::Pointer<ScenePlayer>{InPlaceInit, application, ui, controls, profilerValues, flags};
 }
 
 }}